@@ -28,6 +28,8 @@
 #include <velox/type/Type.h>
 #include <velox/type/Variant.h>
 #include <velox/vector/FlatVector.h>
+#include <velox/vector/arrow/Abi.h>
+#include <velox/vector/arrow/Bridge.h>
 #include "folly/json.h"
 
 namespace facebook::velox::py {
@@ -362,6 +364,64 @@ inline void addDataTypeBindings(
   rowType.def("names", &RowType::names, "Return the names of the columns");
 }
 
+// Releases Arrow C data structures that were not moved to a new owner.
+struct ArrowReleaser {
+  ArrowArray& array;
+  ArrowSchema& schema;
+
+  ~ArrowReleaser() {
+    if (array.release) {
+      array.release(&array);
+    }
+    if (schema.release) {
+      schema.release(&schema);
+    }
+  }
+};
+
+/// Exports 'vector' to pyarrow through the Arrow C data interface. Returns a
+/// pyarrow.RecordBatch for a RowVector and a pyarrow.Array otherwise. The
+/// buffers of flat vectors are shared with pyarrow instead of being copied.
+inline py::object exportToPyArrow(const VectorPtr& vector) {
+  auto pyarrow = py::module_::import("pyarrow");
+  auto* pool = PyVeloxContext::getInstance().pool();
+  ArrowArray array{};
+  ArrowSchema schema{};
+  ArrowReleaser releaser{array, schema};
+  {
+    py::gil_scoped_release release;
+    auto loaded = BaseVector::loadedVectorShared(vector);
+    exportToArrow(loaded, array, pool);
+    exportToArrow(loaded, schema);
+  }
+  auto cls = vector->type()->isRow() && !vector->mayHaveNulls()
+      ? pyarrow.attr("RecordBatch")
+      : pyarrow.attr("Array");
+  return cls.attr("_import_from_c")(
+      reinterpret_cast<uintptr_t>(&array),
+      reinterpret_cast<uintptr_t>(&schema));
+}
+
+/// Imports a pyarrow.Array or pyarrow.RecordBatch as a Velox vector that owns
+/// the Arrow buffers. Other objects, e.g. numpy arrays, are first converted
+/// with pyarrow.array(), which does not copy primitive numpy arrays.
+inline VectorPtr importFromPyArrow(const py::handle& obj) {
+  py::object arrowObj = py::reinterpret_borrow<py::object>(obj);
+  if (!py::hasattr(arrowObj, "_export_to_c")) {
+    arrowObj = py::module_::import("pyarrow").attr("array")(obj);
+  }
+  auto* pool = PyVeloxContext::getInstance().pool();
+  ArrowArray array{};
+  ArrowSchema schema{};
+  ArrowReleaser releaser{array, schema};
+  arrowObj.attr("_export_to_c")(
+      reinterpret_cast<uintptr_t>(&array),
+      reinterpret_cast<uintptr_t>(&schema));
+
+  py::gil_scoped_release release;
+  return importFromArrowAsOwner(schema, array, pool);
+}
+
 inline void addVectorBindings(
     py::module& m,
     bool asModuleLocalDefinitions = true) {
@@ -412,10 +472,18 @@ inline void addVectorBindings(
             return v->hashValueAt(idx);
           })
       .def("encoding", &BaseVector::encoding)
-      .def("append", [](VectorPtr& u, VectorPtr& v) { appendVectors(u, v); });
+      .def("append", [](VectorPtr& u, VectorPtr& v) { appendVectors(u, v); })
+      .def(
+          "to_arrow",
+          &exportToPyArrow,
+          "Exports the vector to a pyarrow Array or RecordBatch");
   m.def("from_list", [](const py::list& list) mutable {
     return pyListToVector(list, PyVeloxContext::getInstance().pool());
   });
+  m.def(
+      "from_arrow",
+      &importFromPyArrow,
+      "Imports a pyarrow Array or RecordBatch, or a numpy array");
 }
 
 static void addExpressionBindings(
@@ -15,6 +15,12 @@
 import pyvelox.pyvelox as pv
 import unittest
 
+try:
+    import numpy as np
+    import pyarrow as pa
+except ImportError:
+    pa = None
+
 
 class TestVeloxVector(unittest.TestCase):
     def test_from_list(self):
@@ -156,3 +162,31 @@ class TestVeloxVector(unittest.TestCase):
 
         with self.assertRaises(TypeError):
             ints2.append(strs2)
+
+    @unittest.skipIf(pa is None, "requires pyarrow and numpy")
+    def test_arrow(self):
+        ints = pv.from_list([1, None, 3])
+        arr = ints.to_arrow()
+        self.assertTrue(isinstance(arr, pa.Array))
+        self.assertEqual(arr.to_pylist(), [1, None, 3])
+
+        strs = pv.from_list(["hello", "world"])
+        self.assertEqual(strs.to_arrow().to_pylist(), ["hello", "world"])
+
+        imported = pv.from_arrow(pa.array([1.5, None, 2.5]))
+        self.assertEqual(imported.dtype(), pv.DoubleType())
+        self.assertEqual(len(imported), 3)
+        self.assertTrue(imported.isNullAt(1))
+        self.assertEqual(imported[2], 2.5)
+
+        batch = pa.RecordBatch.from_pydict({"a": [1, 2], "b": ["x", None]})
+        rows = pv.from_arrow(batch)
+        self.assertEqual(rows.typeKind(), pv.TypeKind.ROW)
+        self.assertEqual(rows.to_arrow().to_pydict(), batch.to_pydict())
+
+        numbers = pv.from_arrow(np.arange(1000, dtype=np.int64))
+        self.assertEqual(numbers.dtype(), pv.BigintType())
+        self.assertEqual(numbers[999], 999)
+        self.assertEqual(
+            numbers.to_arrow().to_numpy().tolist(), list(range(1000))
+        )
@@ -48,6 +48,19 @@ class DecodedVectorBenchmark : public functions::test::FunctionBenchmarkBase {
     for (size_t i = 0; i < 5; ++i) {
       dictionaryNestedVector_ = fuzzer.fuzzDictionary(dictionaryNestedVector_);
     }
+
+    // Dictionary and sequence vectors with runs of 100 rows of the same value,
+    // as read from sorted data.
+    auto runBase = fuzzer.fuzzFlat(BIGINT(), vectorSize_ / kRunLength);
+    sortedDictionaryVector_ = BaseVector::wrapInDictionary(
+        nullptr,
+        makeIndices(vectorSize_, [](auto row) { return row / kRunLength; }),
+        vectorSize_,
+        runBase);
+    sequenceVector_ = BaseVector::wrapInSequence(
+        makeIndices(vectorSize_ / kRunLength, [](auto) { return kRunLength; }),
+        vectorSize_,
+        runBase);
   }
 
   // Runs a fast path over a flat vector (no decoding).
@@ -98,6 +111,42 @@ class DecodedVectorBenchmark : public functions::test::FunctionBenchmarkBase {
     return vectorSize_;
   }
 
+  // Runs over the rows of a decoded dictionary vector with long runs.
+  size_t decodedRunSortedDict() {
+    folly::BenchmarkSuspender suspender;
+    DecodedVector decodedVector(*sortedDictionaryVector_, rows_);
+    suspender.dismiss();
+    decodedRun(decodedVector);
+    return vectorSize_;
+  }
+
+  // Runs over the runs of a decoded dictionary vector with long runs.
+  size_t decodedRunsSortedDict() {
+    folly::BenchmarkSuspender suspender;
+    DecodedVector decodedVector(*sortedDictionaryVector_, rows_);
+    suspender.dismiss();
+    decodedRuns(decodedVector);
+    return vectorSize_;
+  }
+
+  // Runs over the rows of a decoded sequence vector.
+  size_t decodedRunSequence() {
+    folly::BenchmarkSuspender suspender;
+    DecodedVector decodedVector(*sequenceVector_, rows_);
+    suspender.dismiss();
+    decodedRun(decodedVector);
+    return vectorSize_;
+  }
+
+  // Runs over the runs of a decoded sequence vector.
+  size_t decodedRunsSequence() {
+    folly::BenchmarkSuspender suspender;
+    DecodedVector decodedVector(*sequenceVector_, rows_);
+    suspender.dismiss();
+    decodedRuns(decodedVector);
+    return vectorSize_;
+  }
+
   // Measure time to decode a flat vector.
   void decodeFlat() {
     DecodedVector decodedVector(*flatVector_, rows_);
@@ -119,6 +168,16 @@ class DecodedVectorBenchmark : public functions::test::FunctionBenchmarkBase {
   }
 
  private:
+  template <typename Func>
+  BufferPtr makeIndices(vector_size_t size, Func indexAt) {
+    auto indices = allocateIndices(size, pool());
+    auto* rawIndices = indices->asMutable<vector_size_t>();
+    for (vector_size_t i = 0; i < size; ++i) {
+      rawIndices[i] = indexAt(i);
+    }
+    return indices;
+  }
+
   void decodedRun(const DecodedVector& decodedVector) {
     size_t sum = 0;
     for (auto i = 0; i < vectorSize_; i++) {
@@ -127,12 +186,26 @@ class DecodedVectorBenchmark : public functions::test::FunctionBenchmarkBase {
     folly::doNotOptimizeAway(sum);
   }
 
+  // Sums the values of the runs of 'decodedVector', including finding the
+  // runs.
+  void decodedRuns(DecodedVector& decodedVector) {
+    size_t sum = 0;
+    for (const auto& run : decodedVector.runs(rows_)) {
+      sum += decodedVector.valueAt<int64_t>(run.begin) * run.size;
+    }
+    folly::doNotOptimizeAway(sum);
+  }
+
+  static constexpr vector_size_t kRunLength = 100;
+
   const size_t vectorSize_;
 
   VectorPtr flatVector_;
   VectorPtr constantVector_;
   VectorPtr dictionaryVector_;
   VectorPtr dictionaryNestedVector_;
+  VectorPtr sortedDictionaryVector_;
+  VectorPtr sequenceVector_;
 
   SelectivityVector rows_;
 };
@@ -168,6 +241,24 @@ BENCHMARK(scanDecodedDict5Nested) {
 
 BENCHMARK_DRAW_LINE();
 
+BENCHMARK(scanDecodedSortedDict) {
+  run([&] { benchmark->decodedRunSortedDict(); });
+}
+
+BENCHMARK_RELATIVE(scanRunsSortedDict) {
+  run([&] { benchmark->decodedRunsSortedDict(); });
+}
+
+BENCHMARK(scanDecodedSequence) {
+  run([&] { benchmark->decodedRunSequence(); });
+}
+
+BENCHMARK_RELATIVE(scanRunsSequence) {
+  run([&] { benchmark->decodedRunsSequence(); });
+}
+
+BENCHMARK_DRAW_LINE();
+
 // For those we alwast report total runtime.
 BENCHMARK(decodeFlat) {
   run([&] { benchmark->decodeFlat(); });
@@ -91,6 +91,13 @@ class LikeFunctionsBenchmark : public FunctionBaseTest,
         auto fixedPatternString = inputString.substr(fixedPatternStartIdx, 10);
         return generateRandomString(kAnyWildcardCharacter) + fixedPatternString;
       }
+      case PatternKind::kSubstring: {
+        auto fixedPatternStartIdx = inputString.size() / 4;
+        auto fixedPatternString =
+            inputString.substr(fixedPatternStartIdx, inputString.size() / 2);
+        return generateRandomString(kAnyWildcardCharacter) +
+            fixedPatternString + generateRandomString(kAnyWildcardCharacter);
+      }
       default:
         return inputString;
     }
@@ -199,6 +206,10 @@ BENCHMARK(suffixPattern) {
   benchmark->run(PatternKind::kSuffix);
 }
 
+BENCHMARK(substringPattern) {
+  benchmark->run(PatternKind::kSubstring);
+}
+
 BENCHMARK_DRAW_LINE();
 
 BENCHMARK(tpchQuery2) {
@@ -213,6 +224,11 @@ BENCHMARK(tpchQuery13) {
   benchmark->run(TpchBenchmarkCase::TpchQuery13, "%special%requests%");
 }
 
+// Generic pattern with '_', which checks for 'requests' before running RE2.
+BENCHMARK(tpchQuery13SingleCharacterWildcard) {
+  benchmark->run(TpchBenchmarkCase::TpchQuery13, "%special_requests%");
+}
+
 BENCHMARK(tpchQuery14) {
   benchmark->run(TpchBenchmarkCase::TpchQuery14, "PROMO%");
 }
@@ -19,6 +19,7 @@
 
 #include <gflags/gflags.h>
 
+#include "velox/common/base/SimdUtil.h"
 #include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
 #include "velox/vector/DecodedVector.h"
 #include "velox/vector/fuzzer/VectorFuzzer.h"
@@ -108,6 +109,21 @@ class SelectivityVectorBenchmark
     return run(rows99PerCent_);
   }
 
+  // Converts the selected rows to indices with or without the AVX-512 path.
+  size_t runIndices(int32_t percent, bool avx512) {
+    const auto& rows = percent == 100 ? rowsAll_
+        : percent == 50               ? rows50PerCent_
+                                      : rows10PerCent_;
+    const bool useAvx512 = simd::detail::useAvx512;
+    simd::detail::useAvx512 = avx512 && useAvx512;
+    indices_.resize(vectorSize_);
+    auto numIndices = simd::indicesOfSetBits(
+        rows.asRange().bits(), 0, vectorSize_, indices_.data());
+    simd::detail::useAvx512 = useAvx512;
+    folly::doNotOptimizeAway(numIndices);
+    return vectorSize_;
+  }
+
  private:
   size_t run(const SelectivityVector& rows) {
     const int64_t* flatBuffer = flatVector_->values()->as<int64_t>();
@@ -126,6 +142,8 @@ class SelectivityVectorBenchmark
   SelectivityVector rows50PerCent_;
   SelectivityVector rows10PerCent_;
   SelectivityVector rows1PerCent_;
+
+  std::vector<int32_t> indices_;
 };
 
 std::unique_ptr<SelectivityVectorBenchmark> benchmark;
@@ -161,6 +179,33 @@ BENCHMARK(sumSelectivity1PerCent) {
   run([] { benchmark->runSelectivity1PerCent(); });
 }
 
+BENCHMARK_DRAW_LINE();
+
+// The relative cases use AVX-512 if the CPU has it.
+BENCHMARK(indicesAll) {
+  run([] { benchmark->runIndices(100, false); });
+}
+
+BENCHMARK_RELATIVE(indicesAllAvx512) {
+  run([] { benchmark->runIndices(100, true); });
+}
+
+BENCHMARK(indices50PerCent) {
+  run([] { benchmark->runIndices(50, false); });
+}
+
+BENCHMARK_RELATIVE(indices50PerCentAvx512) {
+  run([] { benchmark->runIndices(50, true); });
+}
+
+BENCHMARK(indices10PerCent) {
+  run([] { benchmark->runIndices(10, false); });
+}
+
+BENCHMARK_RELATIVE(indices10PerCentAvx512) {
+  run([] { benchmark->runIndices(10, true); });
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
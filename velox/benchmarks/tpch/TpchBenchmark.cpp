@@ -15,12 +15,21 @@
  */
 
 #include <folly/Benchmark.h>
+#include <folly/String.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/init/Init.h>
+#include <folly/json.h>
 #include <gflags/gflags.h>
 
+#include <fstream>
+#include <mutex>
+#include <thread>
+
 #include "velox/common/base/SuccinctPrinter.h"
+#include "velox/common/caching/SsdCache.h"
 #include "velox/common/file/FileSystems.h"
 #include "velox/common/memory/MmapAllocator.h"
+#include "velox/common/time/Timer.h"
 #include "velox/connectors/hive/HiveConnector.h"
 #include "velox/dwio/common/Options.h"
 #include "velox/dwio/dwrf/reader/DwrfReader.h"
@@ -28,6 +37,7 @@
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/Split.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/exec/tests/utils/TpchQueryBuilder.h"
 #include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
 #include "velox/functions/prestosql/registration/RegistrationFunctions.h"
@@ -81,6 +91,8 @@ DEFINE_string(
     data_path,
     "",
     "Root path of TPC-H data. Data layout must follow Hive-style partitioning. "
+    "A comma separated list of paths, e.g. of different scale factors, runs "
+    "the --json_report workload on each in turn. "
     "Example layout for '-data_path=/data/tpch10'\n"
     "       /data/tpch10/customer\n"
     "       /data/tpch10/lineitem\n"
@@ -110,6 +122,45 @@ DEFINE_int32(
     "GB of process memory for cache and query.. if "
     "non-0, uses mmap to allocator and in-process data cache.");
 DEFINE_int32(num_repeats, 1, "Number of times to run each query");
+DEFINE_string(
+    json_report,
+    "",
+    "If set, runs --queries in --num_streams concurrent streams instead of the "
+    "folly benchmarks and writes the stats of each query run to this file as "
+    "JSON");
+DEFINE_string(
+    queries,
+    "",
+    "Comma separated TPC-H query numbers for --json_report, all if empty");
+DEFINE_int32(
+    num_streams,
+    1,
+    "Number of streams that run --queries at the same time, sharing the "
+    "executor and the cache. Stream i starts at the i-th query");
+DEFINE_int32(
+    query_memory_mb,
+    0,
+    "If non-0, caps the memory of each query in --json_report runs");
+DEFINE_int32(
+    spill_threshold_mb,
+    0,
+    "If non-0, enables spilling of aggregations, joins and order bys in "
+    "--json_report runs once they use this much memory");
+DEFINE_string(
+    spill_path,
+    "",
+    "Directory for spill files, a temporary directory if empty");
+DEFINE_string(
+    cache_passes,
+    "warm",
+    "Comma separated passes over the --json_report workload. A 'cold' pass "
+    "clears the memory and SSD caches before it starts, a 'warm' pass does "
+    "not");
+DEFINE_string(
+    ssd_path,
+    "",
+    "File prefix for SSD cache. Requires --cache_gb and --ssd_cache_gb");
+DEFINE_int32(ssd_cache_gb, 0, "Size of the SSD cache in GB");
 
 DEFINE_validator(data_path, &notEmpty);
 DEFINE_validator(data_format, &validateDataFormat);
@@ -125,10 +176,25 @@ class TpchBenchmark {
       options.mmapArenaCapacityRatio = 1;
 
       auto allocator = std::make_shared<memory::MmapAllocator>(options);
-      allocator_ = std::make_shared<cache::AsyncDataCache>(
-          allocator, memoryBytes, nullptr);
+      std::unique_ptr<cache::SsdCache> ssdCache;
+      if (FLAGS_ssd_cache_gb) {
+        VELOX_USER_CHECK(
+            !FLAGS_ssd_path.empty(), "--ssd_cache_gb requires --ssd_path");
+        ssdExecutor_ = std::make_unique<folly::IOThreadPoolExecutor>(8);
+        ssdCache = std::make_unique<cache::SsdCache>(
+            FLAGS_ssd_path,
+            FLAGS_ssd_cache_gb * (1LL << 30),
+            16,
+            ssdExecutor_.get());
+      }
+      auto cache = std::make_shared<cache::AsyncDataCache>(
+          allocator, memoryBytes, std::move(ssdCache));
+      cache_ = cache.get();
+      allocator_ = std::move(cache);
       memory::MemoryAllocator::setDefaultInstance(allocator_.get());
     }
+    executor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+        std::thread::hardware_concurrency());
     functions::prestosql::registerAllScalarFunctions();
     aggregate::prestosql::registerAllAggregateFunctions();
     parse::registerTypeResolver();
@@ -187,8 +253,192 @@ class TpchBenchmark {
     }
   }
 
+  /// Runs the --json_report workload on the data of 'queryBuilder' once for
+  /// each of --cache_passes and appends the stats of each query run to
+  /// 'queryRuns' and those of each pass to 'passes'.
+  void runReport(
+      const std::string& dataPath,
+      const TpchQueryBuilder& queryBuilder,
+      folly::dynamic& queryRuns,
+      folly::dynamic& passes) {
+    std::vector<int32_t> queries;
+    if (FLAGS_queries.empty()) {
+      queries = {
+          1, 3, 5, 6, 7, 8, 9, 10, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22};
+    } else {
+      folly::splitTo<int32_t>(',', FLAGS_queries, std::back_inserter(queries));
+    }
+    std::vector<TpchPlan> plans;
+    for (auto query : queries) {
+      plans.push_back(queryBuilder.getQueryPlan(query));
+    }
+
+    std::vector<std::string> cachePasses;
+    folly::split(',', FLAGS_cache_passes, cachePasses);
+    for (const auto& pass : cachePasses) {
+      VELOX_USER_CHECK(
+          pass == "cold" || pass == "warm", "Unknown cache pass: {}", pass);
+      if (pass == "cold" && cache_ != nullptr) {
+        cache_->clear();
+        if (auto* ssdCache = cache_->ssdCache()) {
+          ssdCache->clear();
+        }
+      }
+      std::mutex mutex;
+      std::vector<std::thread> streams;
+      const auto passStartMs = getCurrentTimeMs();
+      for (auto stream = 0; stream < FLAGS_num_streams; ++stream) {
+        streams.emplace_back([&, stream]() {
+          for (auto i = 0; i < plans.size(); ++i) {
+            const auto index = (stream + i) % plans.size();
+            auto stats = runQuery(plans[index]);
+            stats["dataPath"] = dataPath;
+            stats["pass"] = pass;
+            stats["stream"] = stream;
+            stats["query"] = queries[index];
+            stats["startMs"] = stats["startMs"].asInt() -
+                static_cast<int64_t>(passStartMs);
+            std::lock_guard<std::mutex> l(mutex);
+            queryRuns.push_back(std::move(stats));
+          }
+        });
+      }
+      for (auto& stream : streams) {
+        stream.join();
+      }
+      auto passStats = folly::dynamic::object("dataPath", dataPath)(
+          "pass", pass)("numStreams", FLAGS_num_streams)(
+          "wallMs", getCurrentTimeMs() - passStartMs);
+      if (cache_ != nullptr) {
+        const auto cacheStats = cache_->refreshStats();
+        passStats["cacheHits"] = cacheStats.numHit;
+        passStats["cacheHitBytes"] = cacheStats.hitBytes;
+        passStats["cacheNewEntries"] = cacheStats.numNew;
+        passStats["cacheEvictions"] = cacheStats.numEvict;
+      }
+      passes.push_back(std::move(passStats));
+    }
+  }
+
   std::unique_ptr<folly::IOThreadPoolExecutor> ioExecutor_;
+  std::unique_ptr<folly::IOThreadPoolExecutor> ssdExecutor_;
   std::shared_ptr<memory::MemoryAllocator> allocator_;
+
+  // The cache in 'allocator_' if --cache_gb is set.
+  cache::AsyncDataCache* cache_{nullptr};
+
+  // Runs the Drivers of --json_report queries.
+  std::unique_ptr<folly::CPUThreadPoolExecutor> executor_;
+
+ private:
+  // Runs 'tpchPlan' with the memory and spill settings of --json_report on
+  // 'executor_' and returns its stats.
+  folly::dynamic runQuery(const TpchPlan& tpchPlan) {
+    CursorParameters params;
+    params.maxDrivers = FLAGS_num_drivers;
+    params.planNode = tpchPlan.plan;
+    std::unordered_map<std::string, std::string> config;
+    std::shared_ptr<TempDirectoryPath> spillDirectory;
+    if (FLAGS_query_memory_mb || FLAGS_spill_threshold_mb) {
+      // Under the cap, the operators spill when they fail to grow their
+      // reservation.
+      config[core::QueryConfig::kSpillEnabled] = "true";
+      config[core::QueryConfig::kAggregationSpillEnabled] = "true";
+      config[core::QueryConfig::kJoinSpillEnabled] = "true";
+      config[core::QueryConfig::kOrderBySpillEnabled] = "true";
+      if (FLAGS_spill_threshold_mb) {
+        const auto threshold =
+            std::to_string(FLAGS_spill_threshold_mb * (1LL << 20));
+        config[core::QueryConfig::kAggregationSpillMemoryThreshold] = threshold;
+        config[core::QueryConfig::kJoinSpillMemoryThreshold] = threshold;
+        config[core::QueryConfig::kOrderBySpillMemoryThreshold] = threshold;
+      }
+      if (FLAGS_spill_path.empty()) {
+        spillDirectory = TempDirectoryPath::create();
+        params.spillDirectory = spillDirectory->path;
+      } else {
+        params.spillDirectory = FLAGS_spill_path;
+      }
+    }
+    params.queryCtx = std::make_shared<core::QueryCtx>(
+        executor_.get(), std::make_shared<core::MemConfig>(std::move(config)));
+    if (FLAGS_query_memory_mb) {
+      params.queryCtx->testingOverrideMemoryPool(
+          memory::getProcessDefaultMemoryManager().getPool(
+              params.queryCtx->queryId(),
+              memory::MemoryPool::Kind::kAggregate,
+              FLAGS_query_memory_mb * (1LL << 20)));
+    }
+
+    bool noMoreSplits = false;
+    auto addSplits = [&](exec::Task* task) {
+      if (!noMoreSplits) {
+        for (const auto& entry : tpchPlan.dataFiles) {
+          for (const auto& path : entry.second) {
+            auto const splits = HiveConnectorTestBase::makeHiveConnectorSplits(
+                path, FLAGS_num_splits_per_file, tpchPlan.dataFileFormat);
+            for (const auto& split : splits) {
+              task->addSplit(entry.first, exec::Split(split));
+            }
+          }
+          task->noMoreSplits(entry.first);
+        }
+      }
+      noMoreSplits = true;
+    };
+
+    const auto startMs = getCurrentTimeMs();
+    auto stats = folly::dynamic::object("startMs", startMs);
+    try {
+      auto result = readCursor(params, addSplits);
+      auto task = result.first->task();
+      if (!waitForTaskCompletion(task.get())) {
+        stats["error"] = "Task did not complete";
+      }
+      stats["wallMs"] = getCurrentTimeMs() - startMs;
+      stats["peakMemoryBytes"] = task->pool()->getMaxBytes();
+      addTaskStats(task->taskStats(), stats);
+    } catch (const std::exception& e) {
+      stats["wallMs"] = getCurrentTimeMs() - startMs;
+      stats["error"] = e.what();
+    }
+    return stats;
+  }
+
+  // Adds the totals of the operator stats in 'taskStats' to 'stats'.
+  static void addTaskStats(const TaskStats& taskStats, folly::dynamic& stats) {
+    uint64_t cpuNanos = 0;
+    uint64_t spilledBytes = 0;
+    uint64_t rawInputBytes = 0;
+    std::unordered_map<std::string, int64_t> ioStats = {
+        {"numRamRead", 0},
+        {"numLocalRead", 0},
+        {"numStorageRead", 0},
+        {"ioWaitNanos", 0}};
+    for (const auto& pipeline : taskStats.pipelineStats) {
+      for (const auto& op : pipeline.operatorStats) {
+        cpuNanos += op.addInputTiming.cpuNanos + op.getOutputTiming.cpuNanos +
+            op.finishTiming.cpuNanos;
+        spilledBytes += op.spilledBytes;
+        if (op.operatorType == "TableScan") {
+          rawInputBytes += op.rawInputBytes;
+          for (auto& [name, value] : ioStats) {
+            auto it = op.runtimeStats.find(name);
+            if (it != op.runtimeStats.end()) {
+              value += it->second.sum;
+            }
+          }
+        }
+      }
+    }
+    stats["cpuNanos"] = cpuNanos;
+    stats["spilledBytes"] = spilledBytes;
+    stats["rawInputBytes"] = rawInputBytes;
+    stats["numSplits"] = taskStats.numTotalSplits;
+    for (const auto& [name, value] : ioStats) {
+      stats[name] = value;
+    }
+  }
 };
 
 TpchBenchmark benchmark;
@@ -295,10 +545,30 @@ int main(int argc, char** argv) {
   gflags::SetUsageMessage(kUsage);
   folly::init(&argc, &argv, false);
   benchmark.initialize();
+  std::vector<std::string> dataPaths;
+  folly::split(',', FLAGS_data_path, dataPaths);
   queryBuilder =
       std::make_shared<TpchQueryBuilder>(toFileFormat(FLAGS_data_format));
-  queryBuilder->initialize(FLAGS_data_path);
-  if (FLAGS_run_query_verbose == -1) {
+  queryBuilder->initialize(dataPaths[0]);
+  if (!FLAGS_json_report.empty() && FLAGS_run_query_verbose == -1) {
+    folly::dynamic queryRuns = folly::dynamic::array;
+    folly::dynamic passes = folly::dynamic::array;
+    for (auto i = 0; i < dataPaths.size(); ++i) {
+      if (i > 0) {
+        queryBuilder =
+            std::make_shared<TpchQueryBuilder>(toFileFormat(FLAGS_data_format));
+        queryBuilder->initialize(dataPaths[i]);
+      }
+      benchmark.runReport(dataPaths[i], *queryBuilder, queryRuns, passes);
+    }
+    auto report = folly::dynamic::object("numDrivers", FLAGS_num_drivers)(
+        "numStreams", FLAGS_num_streams)(
+        "queryMemoryMb", FLAGS_query_memory_mb)(
+        "spillThresholdMb", FLAGS_spill_threshold_mb)(
+        "passes", std::move(passes))("queries", std::move(queryRuns));
+    std::ofstream out(FLAGS_json_report);
+    out << folly::toPrettyJson(report) << std::endl;
+  } else if (FLAGS_run_query_verbose == -1) {
     folly::runBenchmarks();
   } else {
     const auto queryPlan = queryBuilder->getQueryPlan(FLAGS_run_query_verbose);
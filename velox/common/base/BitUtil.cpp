@@ -18,8 +18,32 @@
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/process/ProcessBase.h"
 
+#include <folly/CpuId.h>
+
+#if defined(__x86_64__) && !defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
 namespace facebook::velox::bits {
 
+#if defined(__x86_64__) && !defined(__BMI2__)
+namespace detail {
+bool hasBmi2 = folly::CpuId().bmi2();
+
+__attribute__((target("bmi2"))) uint32_t extractBitsBmi2(
+    uint32_t a,
+    uint32_t mask) {
+  return _pext_u32(a, mask);
+}
+
+__attribute__((target("bmi2"))) uint64_t extractBitsBmi2(
+    uint64_t a,
+    uint64_t mask) {
+  return _pext_u64(a, mask);
+}
+} // namespace detail
+#endif
+
 namespace {
 // Naive implementation that does not rely on BMI2.
 void scatterBitsSimple(
@@ -21,6 +21,7 @@
 #include <cstdint>
 #include <cstring>
 #include <string>
+#include <type_traits>
 
 #ifdef __BMI2__
 #include <x86intrin.h>
@@ -904,8 +905,28 @@ inline uint64_t extractBits(uint64_t a, uint64_t mask) {
   return _pext_u64(a, mask);
 }
 #else
+#if defined(__x86_64__)
+namespace detail {
+// True if the CPU has BMI2 although the build does not assume it. Set at
+// startup, so that a binary built for an older baseline uses PEXT on hosts
+// that have it.
+extern bool hasBmi2;
+
+uint32_t extractBitsBmi2(uint32_t a, uint32_t mask);
+uint64_t extractBitsBmi2(uint64_t a, uint64_t mask);
+} // namespace detail
+#endif
+
 template <typename T>
 T extractBits(T a, T mask) {
+#if defined(__x86_64__)
+  if constexpr (
+      std::is_same_v<T, uint32_t> || std::is_same_v<T, uint64_t>) {
+    if (detail::hasBmi2) {
+      return detail::extractBitsBmi2(a, mask);
+    }
+  }
+#endif
   constexpr int kBitsCount = 8 * sizeof(T);
   T dst = 0;
   for (int i = 0, k = 0; i < kBitsCount; ++i) {
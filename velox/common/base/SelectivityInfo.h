@@ -47,6 +47,14 @@ class SelectivityInfo {
     return numOut_;
   }
 
+  // Halves the history so that recent values weigh more than old ones when
+  // the data changes over time. The ratios stay the same.
+  void decay() {
+    numIn_ /= 2;
+    numOut_ /= 2;
+    timeClocks_ /= 2;
+  }
+
  private:
   uint64_t numIn_ = 0;
   uint64_t numOut_ = 0;
@@ -176,6 +176,9 @@ int32_t indicesOfSetBits(
   if (end <= begin) {
     return 0;
   }
+  if (detail::useAvx512) {
+    return detail::indicesOfSetBitsAvx512(bits, begin, end, result);
+  }
   int32_t row = begin & ~63;
   auto originalResult = result;
   int32_t endWord = bits::roundUp(end, 64) / 64;
@@ -15,8 +15,13 @@
  */
 
 #include "velox/common/base/SimdUtil.h"
+#include <folly/CpuId.h>
 #include <folly/Preprocessor.h>
 
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
 namespace facebook::velox::simd {
 
 namespace detail {
@@ -24,6 +29,58 @@ namespace detail {
 alignas(kPadding) int32_t byteSetBits[256][8];
 alignas(kPadding) int32_t permute4x64Indices[16][8];
 
+bool useAvx512 = false;
+
+#if defined(__x86_64__)
+__attribute__((target("avx512f"))) int32_t indicesOfSetBitsAvx512(
+    const uint64_t* bits,
+    int32_t begin,
+    int32_t end,
+    int32_t* result) {
+  if (end <= begin) {
+    return 0;
+  }
+  const __m512i kIota = _mm512_setr_epi32(
+      0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  auto originalResult = result;
+  int32_t endWord = bits::roundUp(end, 64) / 64;
+  auto firstWord = begin / 64;
+  for (auto wordIndex = firstWord; wordIndex < endWord; ++wordIndex) {
+    uint64_t word = bits[wordIndex];
+    if (wordIndex == firstWord && begin != firstWord * 64) {
+      word &= bits::highMask(64 - (begin - firstWord * 64));
+    }
+    if (wordIndex == endWord - 1) {
+      int32_t lastBits = end - (endWord - 1) * 64;
+      if (lastBits < 64) {
+        word &= bits::lowMask(lastBits);
+      }
+    }
+    // Each VPCOMPRESSD stores the positions of the set bits among 16 bits.
+    int32_t row = wordIndex * 64;
+    while (word) {
+      auto mask = static_cast<__mmask16>(word);
+      if (mask) {
+        _mm512_mask_compressstoreu_epi32(
+            result, mask, _mm512_add_epi32(kIota, _mm512_set1_epi32(row)));
+        result += __builtin_popcount(mask);
+      }
+      word >>= 16;
+      row += 16;
+    }
+  }
+  return result - originalResult;
+}
+#else
+int32_t indicesOfSetBitsAvx512(
+    const uint64_t* /*bits*/,
+    int32_t /*begin*/,
+    int32_t /*end*/,
+    int32_t* /*result*/) {
+  VELOX_UNREACHABLE();
+}
+#endif
+
 } // namespace detail
 
 namespace {
@@ -68,6 +125,9 @@ bool initializeSimdUtil() {
   }
   initByteSetBits();
   initPermute4x64Indices();
+#if defined(__x86_64__)
+  detail::useAvx512 = folly::CpuId().avx512f();
+#endif
   inited = true;
   return true;
 }
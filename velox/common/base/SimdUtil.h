@@ -43,10 +43,30 @@ constexpr int32_t kPadding = std::max(32, batchByteSize());
 // called.
 bool initializeSimdUtil();
 
+namespace detail {
+// True if the CPU supports AVX-512F. Set by initializeSimdUtil() from CPU
+// detection, so that a binary built for AVX2 still uses AVX-512 where the
+// hardware has it.
+extern bool useAvx512;
+
+// AVX-512 implementation of indicesOfSetBits() using VPCOMPRESSD. Must only
+// be called if 'useAvx512' is true.
+int32_t indicesOfSetBitsAvx512(
+    const uint64_t* bits,
+    int32_t begin,
+    int32_t end,
+    int32_t* indices);
+} // namespace detail
+
+// Returns true if the AVX-512 paths of the functions in this file are used.
+inline bool hasAvx512() {
+  return detail::useAvx512;
+}
+
 // Returns positions of set bits in 'bits' in 'indices'. Bits from
 // 'begin' to 'end' are considered and the return value is the number
 // of found set bits. For bits 0xff and begin 2 and end 5 we have a return value
-// of 3 and indices is set to {2, 3, 4}.
+// of 3 and indices is set to {2, 3, 4}. Uses AVX-512 if hasAvx512() is true.
 template <typename A = xsimd::default_arch>
 int32_t indicesOfSetBits(
     const uint64_t* bits,
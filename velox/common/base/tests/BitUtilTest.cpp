@@ -21,6 +21,7 @@
 
 #include <boost/crc.hpp>
 #include <fmt/format.h>
+#include <folly/CpuId.h>
 #include <folly/Random.h>
 #include <folly/hash/Checksum.h>
 #include <gflags/gflags.h>
@@ -782,6 +783,37 @@ TEST_F(BitUtilTest, forBatches) {
   test(0, sizeof(bits) * 8);
 }
 
+TEST_F(BitUtilTest, extractBits) {
+  auto reference = [](uint64_t a, uint64_t mask) {
+    uint64_t result = 0;
+    for (int i = 0, k = 0; i < 64; ++i) {
+      if (mask & (1ULL << i)) {
+        result |= ((a >> i) & 1) << k++;
+      }
+    }
+    return result;
+  };
+  auto check = [&]() {
+    folly::Random::DefaultGenerator rng(1);
+    for (auto i = 0; i < 1'000; ++i) {
+      uint64_t a = folly::Random::rand64(rng);
+      uint64_t mask = folly::Random::rand64(rng);
+      ASSERT_EQ(bits::extractBits<uint64_t>(a, mask), reference(a, mask));
+      ASSERT_EQ(
+          bits::extractBits<uint32_t>(a, mask),
+          reference(static_cast<uint32_t>(a), static_cast<uint32_t>(mask)));
+    }
+  };
+  check();
+#if defined(__x86_64__) && !defined(__BMI2__)
+  // Also checks the other side of the runtime dispatch to PEXT.
+  const bool hasBmi2 = bits::detail::hasBmi2;
+  bits::detail::hasBmi2 = !hasBmi2 && folly::CpuId().bmi2();
+  check();
+  bits::detail::hasBmi2 = hasBmi2;
+#endif
+}
+
 TEST_F(BitUtilTest, rotateLeft64) {
   uint64_t data[] = {
       0xff00ff00ffff00ff,
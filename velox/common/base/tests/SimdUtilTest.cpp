@@ -127,6 +127,18 @@ TEST_F(SimdUtilTest, bitIndices) {
   testIndices(999);
 }
 
+TEST_F(SimdUtilTest, indicesOfSetBitsWithoutAvx512) {
+  if (!simd::hasAvx512()) {
+    GTEST_SKIP() << "The AVX-512 path is not used on this CPU";
+  }
+  // Runs the same cases with the AVX2 or SSE path.
+  simd::detail::useAvx512 = false;
+  testIndices(1);
+  testIndices(100);
+  testIndices(999);
+  simd::detail::useAvx512 = true;
+}
+
 TEST_F(SimdUtilTest, gather32) {
   int32_t indices8[8] = {7, 6, 5, 4, 3, 2, 1, 0};
   int32_t indices6[8] = {7, 6, 5, 4, 3, 2, 1 << 31, 1 << 31};
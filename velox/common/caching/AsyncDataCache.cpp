@@ -158,6 +158,7 @@ CachePin CacheShard::findOrCreate(
   {
     std::lock_guard<std::mutex> l(mutex_);
     ++eventCounter_;
+    const auto frequency = recordAccessLocked(key);
     auto it = entryMap_.find(key);
     if (it != entryMap_.end()) {
       auto found = it->second;
@@ -197,6 +198,16 @@ CachePin CacheShard::findOrCreate(
     // Initialize the members that must be set inside 'mutex_'.
     newEntry->numPins_ = AsyncDataCacheEntry::kExclusive;
     newEntry->promise_ = nullptr;
+    // Once the shard is full, an entry for a key that has not been accessed
+    // before is admitted on probation: It is evicted first unless it is hit
+    // again. This keeps a scan of data that is read once from flushing the
+    // frequently used entries.
+    if (full_ && frequency < kMinAdmitFrequency) {
+      newEntry->makeEvictable();
+      ++numRejected_;
+    } else {
+      newEntry->accessStats_.reset();
+    }
     entryToInit = newEntry.get();
     entryMap_[key] = newEntry.get();
     if (emptySlots_.empty()) {
@@ -215,6 +226,17 @@ CachePin CacheShard::findOrCreate(
   return initEntry(key, entryToInit);
 }
 
+int32_t CacheShard::recordAccessLocked(RawFileCacheKey key) {
+  if (entries_.size() > frequencySketch_.capacity()) {
+    // Resizing forgets the frequencies. This is rare since the capacity
+    // doubles.
+    frequencySketch_.resize(2 * entries_.size());
+  }
+  const auto hash = std::hash<RawFileCacheKey>()(key);
+  frequencySketch_.increment(hash);
+  return frequencySketch_.frequency(hash);
+}
+
 bool CacheShard::exists(RawFileCacheKey key) const {
   std::lock_guard<std::mutex> l(mutex_);
   auto it = entryMap_.find(key);
@@ -383,6 +405,9 @@ void CacheShard::evict(uint64_t bytesToFree, bool evictAllUnpinned) {
         freeEntries_.push_back(std::move(*iter));
         emptySlots_.push_back(entryIndex);
         tinyFreed += candidate->tinyData_.size();
+        if (!evictAllUnpinned) {
+          full_ = true;
+        }
         candidate->tinyData_.clear();
         candidate->size_ = 0;
         ++numEvict_;
@@ -465,6 +490,7 @@ void CacheShard::updateStats(CacheStats& stats) {
   stats.hitBytes += hitBytes_;
   stats.numNew += numNew_;
   stats.numEvict += numEvict_;
+  stats.numRejected += numRejected_;
   stats.numEvictChecks += numEvictChecks_;
   stats.numWaitExclusive += numWaitExclusive_;
   stats.sumEvictScore += sumEvictScore_;
@@ -520,6 +546,17 @@ bool AsyncDataCache::exists(RawFileCacheKey key) const {
   return shards_[shard]->exists(key);
 }
 
+bool AsyncDataCache::canPrefetch(MachinePageCount numPages) const {
+  const MachinePageCount maxPages =
+      maxBytes_ / memory::AllocationTraits::kPageSize;
+  const auto allocatedPages = numAllocated();
+  if (allocatedPages < maxPages && numPages < maxPages - allocatedPages) {
+    // There is free space for the prefetch.
+    return true;
+  }
+  return numPages + prefetchPages_ < cachedPages_ / 2;
+}
+
 bool AsyncDataCache::makeSpace(
     MachinePageCount numPages,
     std::function<bool()> allocate) {
@@ -708,7 +745,7 @@ std::string AsyncDataCache::toString() const {
           stats.largePadding
       << " / " << maxBytes_ << " bytes\n"
       << "Miss: " << stats.numNew << " Hit " << stats.numHit << " evict "
-      << stats.numEvict << "\n"
+      << stats.numEvict << " rejected " << stats.numRejected << "\n"
       << " read pins " << stats.numShared << " write pins "
       << stats.numExclusive << " unused prefetch " << stats.numPrefetch
       << " Alloc Megaclocks " << (stats.allocClocks >> 20)
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <deque>
+#include <numeric>
 
 #include <fmt/format.h>
 #include <folly/chrono/Hardware.h>
@@ -26,6 +27,7 @@
 #include "velox/common/base/Portability.h"
 #include "velox/common/base/SelectivityInfo.h"
 #include "velox/common/caching/FileGroupStats.h"
+#include "velox/common/caching/FrequencySketch.h"
 #include "velox/common/caching/ScanTracker.h"
 #include "velox/common/caching/StringIdMap.h"
 #include "velox/common/file/File.h"
@@ -431,6 +433,11 @@ class CoalescedLoad {
     return "<CoalescedLoad>";
   }
 
+  // Returns the number of bytes loaded by 'this'.
+  int64_t size() const {
+    return std::accumulate(sizes_.begin(), sizes_.end(), 0L);
+  }
+
  protected:
   // Makes entries for 'keys_' and loads their content. Elements of
   // 'keys_' that are already loaded or loading are expected to be left
@@ -489,6 +496,9 @@ struct CacheStats {
   int64_t numNew{};
   // Number of times a valid entry was removed in order to make space.
   int64_t numEvict{};
+  // Number of new entries that were not admitted and were made evictable
+  // because their keys were not accessed before.
+  int64_t numRejected{};
   // Number of entries considered for evicting.
   int64_t numEvictChecks{};
   // Number of times a user waited for an entry to transit from exclusive to
@@ -528,10 +538,10 @@ class CacheShard {
   }
 
   // removes 'bytesToFree' worth of entries or as many entries as are
-  // not pinned. This favors first removing older and less frequently
-  // used entries. If 'evictAllUnpinned' is true, anything that is
-  // not pinned is evicted at first sight. This is for out of memory
-  // emergencies.
+  // not pinned. This favors first removing entries that were not
+  // admitted and older and less frequently used entries. If
+  // 'evictAllUnpinned' is true, anything that is not pinned is evicted
+  // at first sight. This is for out of memory emergencies.
   void evict(uint64_t bytesToFree, bool evictAllUnpinned);
 
   // Removes 'entry' from 'this'. Removes a possible promise from the entry
@@ -557,8 +567,19 @@ class CacheShard {
  private:
   static constexpr int32_t kNoThreshold = std::numeric_limits<int32_t>::max();
 
+  // Minimum frequency in 'frequencySketch_' for admitting a new entry once
+  // the shard is full. The lookup that creates the entry counts as one.
+  static constexpr int32_t kMinAdmitFrequency = 2;
+
+  // Initial capacity of 'frequencySketch_'.
+  static constexpr int32_t kMinSketchCapacity = 1024;
+
   void calibrateThreshold();
 
+  // Counts an access to 'key' in 'frequencySketch_'. Returns the estimated
+  // access frequency of 'key', including this access.
+  int32_t recordAccessLocked(RawFileCacheKey key);
+
   void removeEntryLocked(AsyncDataCacheEntry* entry);
 
   // Returns an unused entry if found. 'size' is a hint for selecting an entry
@@ -595,6 +616,14 @@ class CacheShard {
   uint64_t numNew_{};
   // Count of entries evicted.
   uint64_t numEvict_{};
+  // Count of new entries made evictable by admission.
+  uint64_t numRejected_{};
+  // Estimates the access frequency of the keys looked up in 'this', for
+  // TinyLFU admission of new entries.
+  FrequencySketch frequencySketch_{kMinSketchCapacity};
+  // True after an entry has been evicted to make space. New entries are
+  // admitted unconditionally until then.
+  bool full_{false};
   // Count of entries considered for eviction. This divided by
   // 'numEvict_' measured efficiency of eviction.
   uint64_t numEvictChecks_{};
@@ -692,6 +721,13 @@ class AsyncDataCache : public memory::MemoryAllocator {
     return prefetchPages_.fetch_add(pages) + pages;
   }
 
+  // Returns true if 'numPages' more pages can be prefetched. This is
+  // the memory budget for read-ahead within and across splits. There
+  // is budget if the pages fit in the free capacity or if after the
+  // prefetch at most half the cached pages would be prefetched but
+  // not yet accessed.
+  bool canPrefetch(memory::MachinePageCount numPages) const;
+
   uint64_t maxBytes() const {
     return maxBytes_;
   }
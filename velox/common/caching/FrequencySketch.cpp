@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "velox/common/caching/FrequencySketch.h"
+
+#include <algorithm>
+
+#include "velox/common/base/BitUtil.h"
+
+namespace facebook::velox::cache {
+
+namespace {
+constexpr uint64_t kSeeds[] = {
+    0xc3a5c85c97cb3127L,
+    0xb492b66fbe98f273L,
+    0x9ae16a3b2f90404fL,
+    0xcbf29ce484222325L};
+
+// Clears the most significant bit of each 4 bit counter after a shift.
+constexpr uint64_t kHalveMask = 0x7777777777777777L;
+} // namespace
+
+void FrequencySketch::resize(int32_t capacity) {
+  capacity_ = std::max(capacity, 16);
+  table_.assign(bits::nextPowerOfTwo(capacity_), 0);
+  sampleSize_ = 10 * capacity_;
+  numIncrements_ = 0;
+}
+
+int32_t FrequencySketch::wordIndex(uint64_t hash, int32_t i) const {
+  uint64_t word = (hash + kSeeds[i]) * kSeeds[i];
+  word += word >> 32;
+  return word & (table_.size() - 1);
+}
+
+void FrequencySketch::increment(uint64_t hash) {
+  bool added = false;
+  for (auto i = 0; i < 4; ++i) {
+    auto& word = table_[wordIndex(hash, i)];
+    const auto shift = counterShift(hash, i);
+    if (((word >> shift) & 15) < kMaxFrequency) {
+      word += 1UL << shift;
+      added = true;
+    }
+  }
+  if (added && ++numIncrements_ >= sampleSize_) {
+    age();
+  }
+}
+
+int32_t FrequencySketch::frequency(uint64_t hash) const {
+  int32_t frequency = kMaxFrequency;
+  for (auto i = 0; i < 4; ++i) {
+    const auto word = table_[wordIndex(hash, i)];
+    frequency =
+        std::min<int32_t>(frequency, (word >> counterShift(hash, i)) & 15);
+  }
+  return frequency;
+}
+
+void FrequencySketch::age() {
+  for (auto& word : table_) {
+    word = (word >> 1) & kHalveMask;
+  }
+  numIncrements_ /= 2;
+}
+
+} // namespace facebook::velox::cache
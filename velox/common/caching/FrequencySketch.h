@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace facebook::velox::cache {
+
+// Approximates the access frequency of keys in a fixed amount of memory, as
+// used by TinyLFU cache admission. This is a count-min sketch of 4 bit
+// counters, 16 to a word. Each key has one counter in each of 4 words and its
+// frequency is the minimum of the 4. After 10 increments per key of capacity,
+// all counters are halved so that the frequencies follow recent accesses. Not
+// thread safe, synchronization is the caller's responsibility.
+class FrequencySketch {
+ public:
+  // The largest frequency a counter can hold.
+  static constexpr int32_t kMaxFrequency = 15;
+
+  explicit FrequencySketch(int32_t capacity = 0) {
+    resize(capacity);
+  }
+
+  // Sizes 'this' for tracking about 'capacity' distinct keys. Forgets the
+  // frequencies counted so far.
+  void resize(int32_t capacity);
+
+  int32_t capacity() const {
+    return capacity_;
+  }
+
+  // Counts an access to the key with 'hash'.
+  void increment(uint64_t hash);
+
+  // Returns the estimated number of accesses to the key with 'hash', up to
+  // kMaxFrequency.
+  int32_t frequency(uint64_t hash) const;
+
+ private:
+  // Returns the index in 'table_' of the 'i'th counter of 'hash'.
+  int32_t wordIndex(uint64_t hash, int32_t i) const;
+
+  // Returns the bit offset in its word of the 'i'th counter of 'hash'.
+  static int32_t counterShift(uint64_t hash, int32_t i) {
+    return ((hash >> (i * 8)) & 15) * 4;
+  }
+
+  // Halves all the counters.
+  void age();
+
+  int32_t capacity_{0};
+  std::vector<uint64_t> table_;
+  // The number of increments after which the counters are halved.
+  int32_t sampleSize_{0};
+  // The number of increments since the last halving.
+  int32_t numIncrements_{0};
+};
+
+} // namespace facebook::velox::cache
@@ -108,6 +108,10 @@ struct TrackingData {
 // over multiple partitions.
 class ScanTracker {
  public:
+  // Minimum number of references to a stream before shouldAdmit() can refuse
+  // it.
+  static constexpr int32_t kMinReferencesForAdmission = 20;
+
   ScanTracker() : loadQuantum_(1 /*not used*/) {}
 
   // Constructs a tracker with 'id'. The tracker will be owned by
@@ -152,6 +156,17 @@ class ScanTracker {
     return readPct(id) >= minReadPct;
   }
 
+  // Returns false if fewer than 'minReadPct' % of the references to
+  // 'trackingId' are read, once there are enough references to tell. Such
+  // data is read sparsely, e.g. behind a selective filter, and is unlikely to
+  // be read again, so its cache entries are not worth retaining.
+  bool shouldAdmit(TrackingId id, int32_t minReadPct) {
+    std::lock_guard<std::mutex> l(mutex_);
+    const auto& data = data_[id];
+    return data.numReferences < kMinReferencesForAdmission ||
+        100 * data.numReads >= minReadPct * data.numReferences;
+  }
+
   // Returns the percentage of referenced columns that are actually read. 100%
   // if no data.
   int32_t readPct(TrackingId id) {
@@ -17,6 +17,7 @@
 #include <folly/Executor.h>
 #include <folly/portability/SysUio.h>
 #include <numeric>
+#include "velox/common/base/AsyncSource.h"
 #include "velox/common/caching/FileIds.h"
 #include "velox/common/time/Timer.h"
 
@@ -37,12 +38,26 @@ SsdCache::SsdCache(
   // size.
   uint64_t sizeQuantum = numShards_ * SsdFile::kRegionSize;
   int32_t fileMaxRegions = bits::roundUp(maxBytes, sizeQuantum) / sizeQuantum;
+  // The shards are opened in parallel on 'executor_' since each may
+  // have to restore its entries from a checkpoint.
+  std::vector<std::shared_ptr<AsyncSource<SsdFile>>> sources;
+  sources.reserve(numShards_);
   for (auto i = 0; i < numShards_; ++i) {
-    files_.push_back(std::make_unique<SsdFile>(
-        fmt::format("{}{}", filePrefix_, i),
-        i,
-        fileMaxRegions,
-        checkpointIntervalBytes / numShards));
+    sources.push_back(std::make_shared<AsyncSource<SsdFile>>(
+        [this, i, fileMaxRegions, checkpointIntervalBytes]() {
+          return std::make_unique<SsdFile>(
+              fmt::format("{}{}", filePrefix_, i),
+              i,
+              fileMaxRegions,
+              checkpointIntervalBytes / numShards_,
+              executor_);
+        }));
+    if (executor_) {
+      executor_->add([source = sources.back()]() { source->prepare(); });
+    }
+  }
+  for (auto& source : sources) {
+    files_.push_back(source->move());
   }
 }
 
@@ -132,6 +147,9 @@ std::string SsdCache::toString() const {
   out << "Ssd cache IO: Write " << (data.bytesWritten >> 20) << "MB read "
       << (data.bytesRead >> 20) << "MB Size " << (capacity >> 30)
       << "GB Occupied " << (data.bytesCached >> 30) << "GB";
+  if (data.checksumErrors > 0) {
+    out << " " << data.checksumErrors << " checksum errors ";
+  }
   out << (data.entriesCached >> 10) << "K entries.";
   out << "\nGroupStats: " << groupStats_->toString(capacity);
   return out.str();
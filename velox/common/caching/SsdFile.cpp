@@ -18,7 +18,10 @@
 #include <folly/Executor.h>
 #include <folly/portability/SysUio.h>
 #include "velox/common/base/AsyncSource.h"
+#include "velox/common/base/Crc.h"
 #include "velox/common/caching/FileIds.h"
+#include "velox/common/file/UringReadFile.h"
+#include "velox/common/time/Timer.h"
 
 #include <fcntl.h>
 #include <sys/stat.h>
@@ -29,6 +32,15 @@
 
 DEFINE_bool(ssd_odirect, true, "Use O_DIRECT for SSD cache IO");
 DEFINE_bool(ssd_verify_write, false, "Read back data after writing to SSD");
+DEFINE_bool(
+    ssd_io_uring,
+    true,
+    "Read and write SSD cache with io_uring if it is supported");
+DEFINE_bool(
+    ssd_checksum,
+    false,
+    "Keep a checksum of each SSD cache entry in the checkpoint and verify "
+    "the data against it on read");
 
 namespace facebook::velox::cache {
 
@@ -75,6 +87,7 @@ SsdFile::SsdFile(
     folly::Executor* FOLLY_NULLABLE executor)
     : fileName_(filename),
       shardId_(shardId),
+      checksumEnabled_(FLAGS_ssd_checksum),
       maxRegions_(maxRegions),
       filename_(filename),
       checkpointIntervalBytes_(checkpointIntervalBytes),
@@ -88,7 +101,12 @@ SsdFile::SsdFile(
     LOG(ERROR) << "Cannot open or create " << filename << " error " << errno;
     exit(1);
   }
-  readFile_ = std::make_unique<LocalReadFile>(fd_);
+  if (FLAGS_ssd_io_uring && UringReadFile::isSupported()) {
+    readFile_ = std::make_unique<UringReadFile>(fd_);
+    uringContext_ = UringContext::instance();
+  } else {
+    readFile_ = std::make_unique<LocalReadFile>(fd_);
+  }
   uint64_t size = lseek(fd_, 0, SEEK_END);
   numRegions_ = size / kRegionSize;
   if (numRegions_ > maxRegions_) {
@@ -142,6 +160,24 @@ void addEntryToIovecs(AsyncDataCacheEntry& entry, std::vector<iovec>& iovecs) {
     };
   }
 }
+
+// Returns the CRC32 of the first 'entry.size()' bytes of the data of 'entry'.
+uint32_t checksumEntry(const AsyncDataCacheEntry& entry) {
+  bits::Crc32 crc;
+  if (entry.tinyData()) {
+    crc.process_bytes(entry.tinyData(), entry.size());
+    return crc.checksum();
+  }
+  auto& data = entry.data();
+  int64_t bytesLeft = entry.size();
+  for (auto i = 0; i < data.numRuns() && bytesLeft > 0; ++i) {
+    auto run = data.runAt(i);
+    auto size = std::min<int64_t>(bytesLeft, run.numBytes());
+    crc.process_bytes(run.data<char>(), size);
+    bytesLeft -= size;
+  }
+  return crc.checksum();
+}
 } // namespace
 
 SsdPin SsdFile::find(RawFileCacheKey key) {
@@ -200,7 +236,10 @@ CoalesceIoStats SsdFile::load(
   }
   // Do coalesced IO for the pins. For short payloads, the break-even
   // between discrete pread calls and a single preadv that discards
-  // gaps is ~25K per gap. For longer payloads this is ~50-100K.
+  // gaps is ~25K per gap. For longer payloads this is ~50-100K. With
+  // asynchronous reads, all the coalesced reads are in flight together.
+  const bool readAsync = readFile_->hasPreadvAsync();
+  std::vector<ReadFile::ReadRequest> requests;
   auto stats = readPins(
       pins,
       payloadTotal / pins.size() < 10000 ? 25000 : 50000,
@@ -214,8 +253,18 @@ CoalesceIoStats SsdFile::load(
           int32_t /*end*/,
           uint64_t offset,
           const std::vector<folly::Range<char*>>& buffers) {
-        read(offset, buffers);
+        if (readAsync) {
+          requests.push_back({offset, buffers});
+        } else {
+          read(offset, buffers);
+        }
       });
+  if (!requests.empty()) {
+    readFile_->preadvBatchAsync(requests).get();
+  }
+  if (checksumEnabled_) {
+    verifyChecksums(ssdPins, pins);
+  }
 
   for (auto i = 0; i < ssdPins.size(); ++i) {
     pins[i].checkedEntry()->setSsdFile(this, ssdPins[i].run().offset());
@@ -223,6 +272,38 @@ CoalesceIoStats SsdFile::load(
   return stats;
 }
 
+void SsdFile::verifyChecksums(
+    const std::vector<SsdPin>& ssdPins,
+    const std::vector<CachePin>& pins) {
+  std::vector<FileCacheKey> corrupt;
+  for (auto i = 0; i < pins.size(); ++i) {
+    auto entry = pins[i].checkedEntry();
+    auto run = ssdPins[i].run();
+    // A prefix of the run can't be checked against the checksum of the run.
+    if (run.size() != entry->size() ||
+        checksumEntry(*entry) == run.checksum()) {
+      continue;
+    }
+    LOG(ERROR) << "IOERR: Checksum mismatch for SSD cache entry "
+               << ssdPins[i].toString();
+    corrupt.push_back(
+        {entry->key().fileNum, static_cast<uint64_t>(entry->offset())});
+  }
+  if (corrupt.empty()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    for (auto& key : corrupt) {
+      entries_.erase(key);
+    }
+    stats_.checksumErrors += corrupt.size();
+  }
+  VELOX_FAIL(
+      "IOERR: {} SSD cache entries do not match their checksum",
+      corrupt.size());
+}
+
 void SsdFile::read(
     uint64_t offset,
     const std::vector<folly::Range<char*>>& buffers) {
@@ -338,6 +419,7 @@ void SsdFile::write(std::vector<CachePin>& pins) {
     int32_t numWritten = 0;
     int32_t bytes = 0;
     std::vector<iovec> iovecs;
+    std::vector<uint32_t> checksums;
     for (auto i = storeIndex; i < pins.size(); ++i) {
       auto entry = pins[i].checkedEntry();
       auto entrySize = entry->size();
@@ -345,11 +427,23 @@ void SsdFile::write(std::vector<CachePin>& pins) {
         break;
       }
       addEntryToIovecs(*entry, iovecs);
+      if (checksumEnabled_) {
+        checksums.push_back(checksumEntry(*entry));
+      }
       bytes += entrySize;
       ++numWritten;
     }
     VELOX_CHECK_GE(fileSize_, offset + bytes);
-    auto rc = folly::pwritev(fd_, iovecs.data(), iovecs.size(), offset);
+    int64_t rc;
+    if (uringContext_ != nullptr) {
+      // The iovecs are written by concurrent writevs of up to IOV_MAX
+      // iovecs each.
+      auto result =
+          uringContext_->writev(fd_, offset, std::move(iovecs)).getTry();
+      rc = result.hasValue() ? static_cast<int64_t>(result.value()) : -1;
+    } else {
+      rc = folly::pwritev(fd_, iovecs.data(), iovecs.size(), offset);
+    }
     if (rc != bytes) {
       LOG(ERROR) << "Failed to write to SSD " << errno;
       // If the write fails we return without adding the pins to the cache. The
@@ -364,7 +458,8 @@ void SsdFile::write(std::vector<CachePin>& pins) {
         auto size = entry->size();
         FileCacheKey key = {
             entry->key().fileNum, static_cast<uint64_t>(entry->offset())};
-        entries_[std::move(key)] = SsdRun(offset, size);
+        entries_[std::move(key)] = SsdRun(
+            offset, size, checksumEnabled_ ? checksums[i - storeIndex] : 0);
         if (FLAGS_ssd_verify_write) {
           verifyWrite(*entry, SsdRun(offset, size));
         }
@@ -431,6 +526,7 @@ void SsdFile::updateStats(SsdCacheStats& stats) const {
   stats.bytesWritten += stats_.bytesWritten;
   stats.entriesRead += stats_.entriesRead;
   stats.bytesRead += stats_.bytesRead;
+  stats.checksumErrors += stats_.checksumErrors;
   stats.entriesCached += entries_.size();
   for (auto& regionSize : regionSize_) {
     stats.bytesCached += regionSize;
@@ -543,9 +639,12 @@ void SsdFile::checkpoint(bool force) {
     // regionScores from the 'tracker_',
     // {fileId, fileName} pairs,
     // kMapMarker,
-    // {fileId, offset, SSdRun} triples,
+    // {fileId, offset, SSdRun} triples, followed by the checksum of
+    // the entry if the magic is kChecksumCheckpointMagic,
     // kEndMarker.
-    state.write(kCheckpointMagic, sizeof(int32_t));
+    state.write(
+        checksumEnabled_ ? kChecksumCheckpointMagic : kCheckpointMagic,
+        sizeof(int32_t));
     state.write(asChar(&maxRegions_), sizeof(maxRegions_));
     state.write(asChar(&numRegions_), sizeof(numRegions_));
 
@@ -571,6 +670,10 @@ void SsdFile::checkpoint(bool force) {
       state.write(asChar(&pair.first.offset), sizeof(pair.first.offset));
       auto offsetAndSize = pair.second.bits();
       state.write(asChar(&offsetAndSize), sizeof(offsetAndSize));
+      if (checksumEnabled_) {
+        uint64_t checksum = pair.second.checksum();
+        state.write(asChar(&checksum), sizeof(checksum));
+      }
     }
     const auto endMarker = kCheckpointEndMarker;
     state.write(asChar(&endMarker), sizeof(endMarker));
@@ -653,9 +756,15 @@ T readNumber(std::ifstream& stream) {
 } // namespace
 
 void SsdFile::readCheckpoint(std::ifstream& state) {
+  const auto startUs = getCurrentTimeMicro();
   char magic[4];
   state.read(magic, sizeof(magic));
-  VELOX_CHECK(strncmp(magic, kCheckpointMagic, 4) == 0);
+  const bool hasChecksums = strncmp(magic, kChecksumCheckpointMagic, 4) == 0;
+  VELOX_CHECK(hasChecksums || strncmp(magic, kCheckpointMagic, 4) == 0);
+  // Entries without a checksum would all fail verification on read.
+  VELOX_CHECK(
+      hasChecksums || !checksumEnabled_,
+      "Checkpoint has no checksums and --ssd_checksum is set");
   auto maxRegions = readNumber<int32_t>(state);
   VELOX_CHECK_EQ(
       maxRegions,
@@ -684,19 +793,32 @@ void SsdFile::readCheckpoint(std::ifstream& state) {
   for (auto region : evicted) {
     evictedMap.insert(region);
   }
-  for (;;) {
-    uint64_t fileNum = readNumber<uint64_t>(state);
-    if (fileNum == kCheckpointEndMarker) {
-      break;
-    }
-    uint64_t offset = readNumber<uint64_t>(state);
-    auto run = SsdRun(readNumber<uint64_t>(state));
+
+  // The entries are fixed size records up to the end marker. They are read
+  // with a single read instead of a read per field.
+  const auto entriesBegin = state.tellg();
+  state.seekg(0, std::ios_base::end);
+  const uint64_t entriesBytes = state.tellg() - entriesBegin;
+  state.seekg(entriesBegin);
+  VELOX_CHECK_EQ(entriesBytes % sizeof(uint64_t), 0, "Truncated checkpoint");
+  std::vector<uint64_t> words(entriesBytes / sizeof(uint64_t));
+  state.read(asChar(words.data()), entriesBytes);
+  VELOX_CHECK(
+      !words.empty() && words.back() == kCheckpointEndMarker,
+      "Checkpoint has no end marker");
+  const int32_t entryWords = hasChecksums ? 4 : 3;
+  const auto numEntries = (words.size() - 1) / entryWords;
+  VELOX_CHECK_EQ(numEntries * entryWords, words.size() - 1);
+  entries_.reserve(numEntries);
+  for (auto i = 0; i < numEntries; ++i) {
+    const auto* entry = &words[i * entryWords];
+    auto run = SsdRun(entry[2], hasChecksums ? entry[3] : 0);
     // Check that the recovered entry does not fall in an evicted region.
     if (evictedMap.find(regionIndex(run.offset())) == evictedMap.end()) {
       // The file may have a different id on restore.
-      auto it = idMap.find(fileNum);
+      auto it = idMap.find(entry[0]);
       VELOX_CHECK(it != idMap.end());
-      FileCacheKey key{it->second, offset};
+      FileCacheKey key{it->second, entry[1]};
       entries_[std::move(key)] = run;
     }
   }
@@ -710,11 +832,12 @@ void SsdFile::readCheckpoint(std::ifstream& state) {
   }
   tracker_.setRegionScores(scores);
   LOG(INFO) << fmt::format(
-      "Starting shard {} from checkpoint with {} entries, {} regions with {} free.",
+      "Starting shard {} from checkpoint with {} entries, {} regions with {} free in {} us.",
       shardId_,
       entries_.size(),
       numRegions_,
-      writableRegions_.size());
+      writableRegions_.size(),
+      getCurrentTimeMicro() - startUs);
 }
 
 } // namespace facebook::velox::cache
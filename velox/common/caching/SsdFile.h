@@ -19,39 +19,45 @@
 #include "velox/common/caching/AsyncDataCache.h"
 #include "velox/common/caching/SsdFileTracker.h"
 #include "velox/common/file/File.h"
+#include "velox/common/file/UringContext.h"
 
 #include <gflags/gflags.h>
 
 DECLARE_bool(ssd_odirect);
 DECLARE_bool(ssd_verify_write);
+DECLARE_bool(ssd_checksum);
 
 namespace facebook::velox::cache {
 
 // A 64 bit word describing a SSD cache entry in an SsdFile. The low
 // 23 bits are the size, for a maximum entry size of 8MB. The high
-// bits are the offset.
+// bits are the offset. If --ssd_checksum is set, the run also has the
+// CRC32 of the data of the entry.
 class SsdRun {
  public:
   static constexpr int32_t kSizeBits = 23;
 
   SsdRun() : bits_(0) {}
 
-  SsdRun(uint64_t offset, uint32_t size)
-      : bits_((offset << kSizeBits) | ((size - 1))) {
+  SsdRun(uint64_t offset, uint32_t size, uint32_t checksum = 0)
+      : bits_((offset << kSizeBits) | ((size - 1))), checksum_(checksum) {
     VELOX_CHECK_LT(offset, 1L << (64 - kSizeBits));
     VELOX_CHECK_LT(size - 1, 1 << kSizeBits);
   }
 
-  SsdRun(uint64_t bits) : bits_(bits) {}
+  SsdRun(uint64_t bits, uint32_t checksum = 0)
+      : bits_(bits), checksum_(checksum) {}
 
   SsdRun(const SsdRun& other) = default;
   SsdRun(SsdRun&& other) = default;
 
   void operator=(const SsdRun& other) {
     bits_ = other.bits_;
+    checksum_ = other.checksum_;
   }
   void operator=(SsdRun&& other) {
     bits_ = other.bits_;
+    checksum_ = other.checksum_;
   }
 
   uint64_t offset() const {
@@ -67,8 +73,14 @@ class SsdRun {
     return bits_;
   }
 
+  // Returns the CRC32 of the data, 0 if the run has no checksum.
+  uint32_t checksum() const {
+    return checksum_;
+  }
+
  private:
   uint64_t bits_;
+  uint32_t checksum_{0};
 };
 
 // Represents an SsdFile entry that is planned for load or being
@@ -134,6 +146,7 @@ struct SsdCacheStats {
     entriesCached = tsanAtomicValue(other.entriesCached);
     bytesCached = tsanAtomicValue(other.bytesCached);
     numPins = tsanAtomicValue(other.numPins);
+    checksumErrors = tsanAtomicValue(other.checksumErrors);
   }
 
   tsan_atomic<uint64_t> entriesWritten{0};
@@ -143,6 +156,8 @@ struct SsdCacheStats {
   tsan_atomic<uint64_t> entriesCached{0};
   tsan_atomic<uint64_t> bytesCached{0};
   tsan_atomic<int32_t> numPins{0};
+  // Number of entries whose data did not match the checksum on read.
+  tsan_atomic<uint64_t> checksumErrors{0};
 };
 
 // A shard of SsdCache. Corresponds to one file on SSD.  The data
@@ -178,7 +193,9 @@ class SsdFile {
   bool erase(RawFileCacheKey key);
 
   // Copies the data in 'ssdPins' into 'pins'. Coalesces IO for nearby
-  // entries if they are in ascending order and near enough.
+  // entries if they are in ascending order and near enough. If
+  // checksums are on, throws if the data read does not match the
+  // checksum of an entry and erases the mismatching entries.
   CoalesceIoStats load(
       const std::vector<SsdPin>& ssdPins,
       const std::vector<CachePin>& pins);
@@ -234,6 +251,9 @@ class SsdFile {
   // 4 first bytes of a checkpoint file. Allows distinguishing between format
   // versions.
   static constexpr const char* FOLLY_NONNULL kCheckpointMagic = "CPT1";
+  // 4 first bytes of a checkpoint file that has a checksum for each entry.
+  static constexpr const char* FOLLY_NONNULL kChecksumCheckpointMagic =
+      "CPT2";
   // Magic number separating file names from cache entry data in checkpoint
   // file.
   static constexpr int64_t kCheckpointMapMarker = 0xfffffffffffffffe;
@@ -263,6 +283,13 @@ class SsdFile {
   // added to 'writableRegions_'. Returns true if regions could be cleared.
   bool growOrEvictLocked();
 
+  // Checks the data loaded into 'pins' against the checksums of
+  // 'ssdPins'. Erases the mismatching entries and throws if there are
+  // any.
+  void verifyChecksums(
+      const std::vector<SsdPin>& ssdPins,
+      const std::vector<CachePin>& pins);
+
   // Reads the backing file with ReadFile::preadv().
   void read(uint64_t offset, const std::vector<folly::Range<char*>>& buffers);
 
@@ -275,7 +302,10 @@ class SsdFile {
 
   // Reads a checkpoint state file and sets 'this' accordingly if read
   // is successful. Return true for successful read. A failed read
-  // deletes the checkpoint and leaves the log truncated open.
+  // deletes the checkpoint and leaves the log truncated open. The
+  // entries are read in bulk and are served as soon as the constructor
+  // returns. They are verified against their checksum on first read
+  // if the checkpoint has checksums.
   void readCheckpoint(std::ifstream& state);
 
   // Logs an error message, deletes the checkpoint and stop making new
@@ -303,6 +333,10 @@ class SsdFile {
   // Shard index within 'cache_'.
   int32_t shardId_;
 
+  // True if the entries have a checksum that is verified on read. Set
+  // from --ssd_checksum at construction.
+  const bool checksumEnabled_;
+
   // Number of kRegionSize regions in the file.
   int32_t numRegions_{0};
 
@@ -344,6 +378,10 @@ class SsdFile {
   // ReadFile made from 'fd_'.
   std::unique_ptr<ReadFile> readFile_;
 
+  // The io_uring for writing 'fd_' if --ssd_io_uring is set and io_uring is
+  // supported.
+  std::shared_ptr<UringContext> uringContext_;
+
   // Counters.
   SsdCacheStats stats_;
 
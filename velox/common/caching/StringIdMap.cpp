@@ -16,71 +16,113 @@
 
 #include "velox/common/caching/StringIdMap.h"
 
+#include <folly/hash/Hash.h>
+
 namespace facebook::velox {
 
+// static
+int32_t StringIdMap::shardIndex(std::string_view string) {
+  // High bits, the maps of the shard use the low bits of the same hash.
+  return (folly::hasher<std::string_view>()(string) >> 40) & (kNumShards - 1);
+}
+
 uint64_t StringIdMap::id(std::string_view string) {
-  std::lock_guard<std::mutex> l(mutex_);
-  auto it = stringToId_.find(string);
-  if (it != stringToId_.end()) {
-    return it->second;
+  auto& shard = shards_[shardIndex(string)];
+  std::shared_lock<folly::SharedMutex> l(shard.mutex);
+  auto it = shard.stringToEntry.find(string);
+  if (it != shard.stringToEntry.end()) {
+    return it->second->id;
   }
   return kNoId;
 }
 
+std::string StringIdMap::string(uint64_t id) {
+  auto& shard = shards_[shardIndex(id)];
+  std::shared_lock<folly::SharedMutex> l(shard.mutex);
+  auto it = shard.idToEntry.find(id);
+  return it == shard.idToEntry.end() ? "" : it->second->string;
+}
+
 void StringIdMap::release(uint64_t id) {
-  std::lock_guard<std::mutex> l(mutex_);
-  auto it = idToString_.find(id);
-  if (it != idToString_.end()) {
-    VELOX_CHECK_LT(
-        0, it->second.numInUse, "Extra release of id in StringIdMap");
-    if (--it->second.numInUse == 0) {
-      pinnedSize_ -= it->second.string.size();
-      auto strIter = stringToId_.find(it->second.string);
-      assert(strIter != stringToId_.end());
-      stringToId_.erase(strIter);
-      idToString_.erase(it);
+  auto& shard = shards_[shardIndex(id)];
+  {
+    std::shared_lock<folly::SharedMutex> l(shard.mutex);
+    auto it = shard.idToEntry.find(id);
+    if (it == shard.idToEntry.end()) {
+      return;
+    }
+    auto& entry = *it->second;
+    auto numInUse = entry.numInUse.load();
+    do {
+      VELOX_CHECK_LT(0, numInUse, "Extra release of id in StringIdMap");
+    } while (!entry.numInUse.compare_exchange_weak(numInUse, numInUse - 1));
+    if (numInUse > 1) {
+      return;
     }
+    pinnedSize_ -= entry.string.size();
   }
+  // The last use is gone. Erase the entry unless a makeId() or addReference()
+  // revived it before the exclusive lock. An entry is only erased under the
+  // exclusive lock, so the ones found under the shared lock stay valid.
+  std::unique_lock<folly::SharedMutex> l(shard.mutex);
+  auto it = shard.idToEntry.find(id);
+  if (it == shard.idToEntry.end() || it->second->numInUse > 0) {
+    return;
+  }
+  auto strIter = shard.stringToEntry.find(it->second->string);
+  assert(strIter != shard.stringToEntry.end());
+  shard.stringToEntry.erase(strIter);
+  shard.idToEntry.erase(it);
 }
 
 void StringIdMap::addReference(uint64_t id) {
-  std::lock_guard<std::mutex> l(mutex_);
-  auto it = idToString_.find(id);
+  auto& shard = shards_[shardIndex(id)];
+  std::shared_lock<folly::SharedMutex> l(shard.mutex);
+  auto it = shard.idToEntry.find(id);
   VELOX_CHECK(
-      it != idToString_.end(),
+      it != shard.idToEntry.end(),
       "Trying to add a reference to an id that is not in StringIdMap");
+  pin(*it->second);
+}
 
-  ++it->second.numInUse;
+void StringIdMap::pin(Entry& entry) {
+  if (++entry.numInUse == 1) {
+    pinnedSize_ += entry.string.size();
+  }
 }
 
 uint64_t StringIdMap::makeId(std::string_view string) {
-  std::lock_guard<std::mutex> l(mutex_);
-  auto it = stringToId_.find(string);
-  if (it != stringToId_.end()) {
-    auto entry = idToString_.find(it->second);
-    VELOX_CHECK(entry != idToString_.end());
-    if (++entry->second.numInUse == 1) {
-      pinnedSize_ += entry->second.string.size();
+  const auto index = shardIndex(string);
+  auto& shard = shards_[index];
+  {
+    std::shared_lock<folly::SharedMutex> l(shard.mutex);
+    auto it = shard.stringToEntry.find(string);
+    if (it != shard.stringToEntry.end()) {
+      pin(*it->second);
+      return it->second->id;
     }
-
-    return it->second;
   }
-  Entry entry;
-  entry.string = std::string(string);
+  std::unique_lock<folly::SharedMutex> l(shard.mutex);
+  // Another thread may have added the string between the locks.
+  auto it = shard.stringToEntry.find(string);
+  if (it != shard.stringToEntry.end()) {
+    pin(*it->second);
+    return it->second->id;
+  }
   // Check that we do not use an id twice. In practice this never
   // happens because the int64 counter would have to wrap around for
   // this. Even if this happened, the time spent in the loop would
   // have a low cap since the number of mappings would in practice
   // be in the 100K range.
+  uint64_t id;
   do {
-    entry.id = ++lastId_;
-  } while (idToString_.find(entry.id) != idToString_.end());
-  entry.numInUse = 1;
-  pinnedSize_ += entry.string.size();
-  auto id = entry.id;
-  auto& entryInTable = idToString_[id] = std::move(entry);
-  stringToId_[entryInTable.string] = entry.id;
-  return lastId_;
+    id = (++shard.lastId << kShardBits) | index;
+  } while (id == kNoId || shard.idToEntry.count(id) > 0);
+  auto entry = std::make_unique<Entry>(string, id);
+  pin(*entry);
+  shard.stringToEntry[entry->string] = entry.get();
+  shard.idToEntry[id] = std::move(entry);
+  return id;
 }
 
 } // namespace facebook::velox
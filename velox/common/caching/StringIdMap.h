@@ -16,14 +16,24 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <string_view>
 
+#include <folly/SharedMutex.h>
 #include <folly/container/F14Map.h>
+#include <folly/lang/Align.h>
 
 #include "velox/common/base/Exceptions.h"
 
 namespace facebook::velox {
 
+// Maps strings to ids with a use count. The mappings are spread over
+// kNumShards shards by the hash of the string, each with its own lock, and
+// the low bits of an id tell its shard. Lookups and use count changes of
+// existing mappings only take a shard lock in shared mode, so that readers on
+// different threads do not serialize. Only adding a new mapping or erasing
+// one the last use of which was released takes a shard lock exclusively.
 class StringIdMap {
  public:
   static constexpr uint64_t kNoId = ~0UL;
@@ -57,24 +67,41 @@ class StringIdMap {
 
   // Returns a copy of the string associated with id or empty string if id has
   // no string.
-  std::string string(uint64_t id) {
-    std::lock_guard<std::mutex> l(mutex_);
-    auto it = idToString_.find(id);
-    return it == idToString_.end() ? "" : it->second.string;
-  }
+  std::string string(uint64_t id);
 
  private:
+  static constexpr int32_t kShardBits = 4;
+  static constexpr int32_t kNumShards = 1 << kShardBits;
+
   struct Entry {
-    std::string string;
-    uint64_t id;
-    uint32_t numInUse{};
+    Entry(std::string_view _string, uint64_t _id)
+        : string(_string), id(_id) {}
+
+    const std::string string;
+    const uint64_t id;
+    std::atomic<uint32_t> numInUse{0};
+  };
+
+  struct alignas(folly::hardware_destructive_interference_size) Shard {
+    folly::SharedMutex mutex;
+    // Keys point to the strings of the entries in 'idToEntry'.
+    folly::F14FastMap<std::string_view, Entry*> stringToEntry;
+    folly::F14FastMap<uint64_t, std::unique_ptr<Entry>> idToEntry;
+    uint64_t lastId{0};
   };
 
-  std::mutex mutex_;
-  folly::F14FastMap<std::string, uint64_t> stringToId_;
-  folly::F14FastMap<uint64_t, Entry> idToString_;
-  uint64_t lastId_{};
-  uint64_t pinnedSize_{};
+  static int32_t shardIndex(std::string_view string);
+
+  static int32_t shardIndex(uint64_t id) {
+    return id & (kNumShards - 1);
+  }
+
+  // Increments the use count of 'entry' and counts the string as pinned if
+  // this is the first use.
+  void pin(Entry& entry);
+
+  Shard shards_[kNumShards];
+  std::atomic<int64_t> pinnedSize_{0};
 };
 
 // Keeps a string-id association live for the duration of this.
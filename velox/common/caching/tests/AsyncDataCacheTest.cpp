@@ -591,6 +591,73 @@ TEST_F(AsyncDataCacheTest, outOfCapacity) {
   clearAllocations(allocations);
 }
 
+TEST_F(AsyncDataCacheTest, admission) {
+  constexpr int64_t kMaxBytes = 16 << 20;
+  constexpr int32_t kSize = 16 << 10;
+  constexpr int32_t kNumHot = 20;
+  initializeCache(kMaxBytes);
+  auto load = [&](uint64_t offset) {
+    auto pin = newEntry(offset, kSize);
+    ASSERT_FALSE(pin.empty());
+    pin.checkedEntry()->setExclusiveToShared();
+  };
+  auto exists = [&](uint64_t offset) {
+    return cache_->exists(RawFileCacheKey{filenames_[0].id(), offset});
+  };
+
+  // Fill the cache so that it evicts.
+  uint64_t offset = kNumHot;
+  for (auto i = 0; i < 2 * kMaxBytes / kSize; ++i) {
+    load(offset++);
+  }
+  // The hot entries are hit after they are loaded.
+  for (auto i = 0; i < kNumHot; ++i) {
+    load(i);
+    ASSERT_TRUE(exists(i));
+  }
+  // A scan of data that is read once does not flush the hot entries.
+  const auto numRejected = cache_->refreshStats().numRejected;
+  for (auto i = 0; i < 10 * kMaxBytes / kSize; ++i) {
+    load(offset++);
+  }
+  EXPECT_LT(numRejected, cache_->refreshStats().numRejected);
+  int32_t numHotCached = 0;
+  for (auto i = 0; i < kNumHot; ++i) {
+    numHotCached += exists(i);
+  }
+  EXPECT_LE(kNumHot / 2, numHotCached);
+}
+
+TEST_F(AsyncDataCacheTest, prefetchBudget) {
+  constexpr int64_t kMaxBytes = 16 << 20;
+  constexpr int32_t kSize = 16 << 10;
+  constexpr int32_t kCachePages =
+      kMaxBytes / memory::AllocationTraits::kPageSize;
+  constexpr int32_t kNumEntries = 2 * kMaxBytes / kSize;
+  initializeCache(kMaxBytes);
+  // A prefetch fits if there is free space.
+  EXPECT_TRUE(cache_->canPrefetch(kCachePages / 4));
+  EXPECT_FALSE(cache_->canPrefetch(kCachePages));
+
+  for (auto i = 0; i < kNumEntries; ++i) {
+    auto pin = newEntry(i, kSize);
+    ASSERT_FALSE(pin.empty());
+    pin.checkedEntry()->setExclusiveToShared();
+  }
+  // The cache is full of prefetched entries that have not been hit.
+  EXPECT_FALSE(cache_->canPrefetch(kCachePages / 4));
+
+  // Hitting the prefetched entries makes room for more prefetch.
+  for (auto i = 0; i < kNumEntries; ++i) {
+    RawFileCacheKey key{filenames_[0].id(), static_cast<uint64_t>(i)};
+    if (cache_->exists(key)) {
+      auto pin = cache_->findOrCreate(key, kSize);
+      ASSERT_TRUE(pin.checkedEntry()->isShared());
+    }
+  }
+  EXPECT_TRUE(cache_->canPrefetch(kCachePages / 4));
+}
+
 namespace {
 // Cuts off the last 1/10th of file at 'path'.
 void corruptFile(const std::string& path) {
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "velox/common/caching/FrequencySketch.h"
+
+#include <gtest/gtest.h>
+
+#include "velox/common/base/BitUtil.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::cache;
+
+TEST(FrequencySketchTest, frequency) {
+  FrequencySketch sketch(1'000);
+  for (auto i = 0; i < 100; ++i) {
+    const auto hash = bits::hashMix(i, 1);
+    for (auto j = 0; j < i % 4; ++j) {
+      sketch.increment(hash);
+    }
+  }
+  // The sketch can only overestimate.
+  int32_t numExact = 0;
+  for (auto i = 0; i < 100; ++i) {
+    const auto frequency = sketch.frequency(bits::hashMix(i, 1));
+    EXPECT_LE(i % 4, frequency);
+    numExact += frequency == i % 4;
+  }
+  EXPECT_LT(95, numExact);
+
+  // The counters saturate.
+  const auto hot = bits::hashMix(1'000, 1);
+  for (auto i = 0; i < 100; ++i) {
+    sketch.increment(hot);
+  }
+  EXPECT_EQ(FrequencySketch::kMaxFrequency, sketch.frequency(hot));
+}
+
+TEST(FrequencySketchTest, aging) {
+  FrequencySketch sketch(100);
+  const auto hot = bits::hashMix(1, 1);
+  for (auto i = 0; i < 8; ++i) {
+    sketch.increment(hot);
+  }
+  EXPECT_EQ(8, sketch.frequency(hot));
+  // 10 increments per key of capacity halve the counters.
+  for (auto i = 0; i < 10 * sketch.capacity(); ++i) {
+    sketch.increment(bits::hashMix(i + 2, 1));
+  }
+  EXPECT_GT(8, sketch.frequency(hot));
+}
+
+TEST(FrequencySketchTest, resize) {
+  FrequencySketch sketch;
+  EXPECT_EQ(16, sketch.capacity());
+  sketch.increment(1);
+  sketch.resize(1'000);
+  EXPECT_EQ(1'000, sketch.capacity());
+  EXPECT_EQ(0, sketch.frequency(1));
+}
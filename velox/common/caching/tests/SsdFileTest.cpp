@@ -14,10 +14,12 @@
  * limitations under the License.
  */
 
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/caching/FileIds.h"
 #include "velox/common/caching/SsdCache.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
 
+#include <fcntl.h>
 #include <folly/executors/QueuedImmediateExecutor.h>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
@@ -47,7 +49,10 @@ class SsdFileTest : public testing::Test {
     }
   }
 
-  void initializeCache(int64_t maxBytes, int64_t ssdBytes = 0) {
+  void initializeCache(
+      int64_t maxBytes,
+      int64_t ssdBytes = 0,
+      int64_t checkpointIntervalBytes = 0) {
     // tmpfs does not support O_DIRECT, so turn this off for testing.
     FLAGS_ssd_odirect = false;
     cache_ = std::make_shared<AsyncDataCache>(
@@ -57,9 +62,14 @@ class SsdFileTest : public testing::Test {
 
     tempDirectory_ = exec::test::TempDirectoryPath::create();
     ssdFile_ = std::make_unique<SsdFile>(
-        fmt::format("{}/ssdtest", tempDirectory_->path),
+        ssdPath(),
         0,
-        bits::roundUp(ssdBytes, SsdFile::kRegionSize) / SsdFile::kRegionSize);
+        bits::roundUp(ssdBytes, SsdFile::kRegionSize) / SsdFile::kRegionSize,
+        checkpointIntervalBytes);
+  }
+
+  std::string ssdPath() const {
+    return fmt::format("{}/ssdtest", tempDirectory_->path);
   }
 
   static void initializeContents(int64_t sequence, memory::Allocation& alloc) {
@@ -291,3 +301,58 @@ TEST_F(SsdFileTest, writeAndRead) {
     }
   }
 }
+
+TEST_F(SsdFileTest, checkpointWithChecksum) {
+  constexpr int64_t kSsdSize = 4 * SsdFile::kRegionSize;
+  FLAGS_ssd_checksum = true;
+  initializeCache(128 * kMB, kSsdSize, kSsdSize);
+  auto pins = makePins(fileName_.id(), 0, 4096, 2048 * 1025, 62 * kMB);
+  ssdFile_->write(pins);
+  std::vector<uint64_t> offsets;
+  for (auto& pin : pins) {
+    ASSERT_EQ(ssdFile_.get(), pin.entry()->ssdFile());
+    offsets.push_back(pin.entry()->offset());
+  }
+  const auto firstSsdOffset = pins[0].entry()->ssdOffset();
+  pins.clear();
+  ssdFile_->checkpoint(true);
+  cache_->clear();
+
+  // A new file over the same path serves the checkpointed entries.
+  ssdFile_ = std::make_unique<SsdFile>(ssdPath(), 0, 4, kSsdSize);
+  for (auto offset : offsets) {
+    ASSERT_FALSE(
+        ssdFile_->find(RawFileCacheKey{fileName_.id(), offset}).empty());
+  }
+  pins = makePins(fileName_.id(), 0, 4096, 2048 * 1025, 62 * kMB);
+  readAndCheckPins(pins);
+  pins.clear();
+  cache_->clear();
+
+  // Overwrite the start of the first entry on SSD. The read fails on checksum
+  // mismatch and the entry is dropped so that it is next read from storage.
+  const int64_t garbage = -1;
+  auto fd = open(ssdPath().c_str(), O_WRONLY);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(
+      sizeof(garbage), pwrite(fd, &garbage, sizeof(garbage), firstSsdOffset));
+  close(fd);
+  pins = makePins(fileName_.id(), 0, 4096, 2048 * 1025, 62 * kMB);
+  {
+    std::vector<SsdPin> ssdPins;
+    for (auto& pin : pins) {
+      ssdPins.push_back(ssdFile_->find(
+          RawFileCacheKey{fileName_.id(), pin.entry()->key().offset}));
+    }
+    VELOX_ASSERT_THROW(
+        ssdFile_->load(ssdPins, pins), "do not match their checksum");
+  }
+  EXPECT_TRUE(
+      ssdFile_->find(RawFileCacheKey{fileName_.id(), offsets[0]}).empty());
+  EXPECT_FALSE(
+      ssdFile_->find(RawFileCacheKey{fileName_.id(), offsets[1]}).empty());
+  SsdCacheStats stats;
+  ssdFile_->updateStats(stats);
+  EXPECT_EQ(1, stats.checksumErrors);
+  FLAGS_ssd_checksum = false;
+}
@@ -16,6 +16,8 @@
 
 #include "velox/common/caching/StringIdMap.h"
 
+#include <thread>
+
 #include "gtest/gtest.h"
 
 using namespace facebook::velox;
@@ -53,3 +55,49 @@ TEST(StringIdMapTest, rehash) {
     EXPECT_EQ(ids[i].id(), StringIdLease(map, name).id());
   }
 }
+
+TEST(StringIdMapTest, concurrent) {
+  constexpr int32_t kNumThreads = 16;
+  constexpr int32_t kNumNames = 100;
+  constexpr int32_t kNumRounds = 2'000;
+  StringIdMap map;
+  // Half the names stay leased for the whole test, the others come and go.
+  std::vector<StringIdLease> pinned;
+  for (auto i = 0; i < kNumNames; i += 2) {
+    pinned.push_back(StringIdLease(map, fmt::format("filename_{}", i)));
+  }
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, i]() {
+      for (auto round = 0; round < kNumRounds; ++round) {
+        const auto nameIndex = (round * 7 + i) % kNumNames;
+        const auto name = fmt::format("filename_{}", nameIndex);
+        StringIdLease lease(map, name);
+        ASSERT_TRUE(lease.hasValue());
+        EXPECT_EQ(name, map.string(lease.id()));
+        EXPECT_EQ(lease.id(), map.id(name));
+        StringIdLease copy(lease);
+        EXPECT_EQ(lease.id(), copy.id());
+        if (nameIndex % 2 == 0) {
+          EXPECT_EQ(pinned[nameIndex / 2].id(), lease.id());
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  int64_t pinnedSize = 0;
+  for (auto i = 0; i < kNumNames; ++i) {
+    const auto name = fmt::format("filename_{}", i);
+    if (i % 2 == 0) {
+      pinnedSize += name.size();
+      EXPECT_EQ(pinned[i / 2].id(), map.id(name));
+    } else {
+      EXPECT_EQ(StringIdMap::kNoId, map.id(name));
+    }
+  }
+  EXPECT_EQ(pinnedSize, map.pinnedSize());
+  pinned.clear();
+  EXPECT_EQ(0, map.pinnedSize());
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "velox/common/file/DirectWriteFile.h"
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <folly/String.h>
+#include <glog/logging.h>
+
+#include "velox/common/base/BitUtil.h"
+
+namespace facebook::velox {
+
+DirectWriteFile::DirectWriteFile(
+    std::string_view path,
+    uint64_t bufferSize,
+    int32_t maxInFlight)
+    : path_(path),
+      bufferSize_(bufferSize),
+      maxInFlight_(maxInFlight),
+      context_(UringContext::instance()) {
+  VELOX_CHECK_GT(bufferSize_, 0);
+  VELOX_CHECK_EQ(bufferSize_ % kAlignment, 0);
+  VELOX_CHECK_GT(maxInFlight_, 0);
+  constexpr int32_t kFlags = O_WRONLY | O_CREAT | O_EXCL;
+  fd_ = -1;
+#ifdef linux
+  fd_ = open(path_.c_str(), kFlags | O_DIRECT, S_IRUSR | S_IWUSR);
+  if (fd_ < 0 && errno == EINVAL) {
+    // The file system does not support O_DIRECT, e.g. tmpfs.
+    fd_ = open(path_.c_str(), kFlags, S_IRUSR | S_IWUSR);
+  }
+#else
+  fd_ = open(path_.c_str(), kFlags, S_IRUSR | S_IWUSR);
+#endif
+  VELOX_CHECK_GE(
+      fd_,
+      0,
+      "open failure in DirectWriteFile constructor, {} {}.",
+      path,
+      folly::errnoStr(errno));
+  buffer_ = nextBuffer();
+}
+
+DirectWriteFile::~DirectWriteFile() {
+  try {
+    close();
+  } catch (const std::exception& ex) {
+    // We cannot throw an exception from the destructor. Warn instead.
+    LOG(WARNING) << "close failure in DirectWriteFile destructor: "
+                 << ex.what();
+  }
+}
+
+DirectWriteFile::Buffer DirectWriteFile::nextBuffer() {
+  if (!freeBuffers_.empty()) {
+    auto buffer = std::move(freeBuffers_.back());
+    freeBuffers_.pop_back();
+    return buffer;
+  }
+  auto* data = static_cast<char*>(aligned_alloc(kAlignment, bufferSize_));
+  VELOX_CHECK_NOT_NULL(data, "Failed to allocate {} bytes", bufferSize_);
+  return Buffer(data);
+}
+
+void DirectWriteFile::append(std::string_view data) {
+  VELOX_CHECK(!closed_, "file is closed");
+  while (!data.empty()) {
+    const auto bufferFill = size_ - bufferOffset_;
+    const auto bytes =
+        std::min<uint64_t>(data.size(), bufferSize_ - bufferFill);
+    memcpy(buffer_.get() + bufferFill, data.data(), bytes);
+    size_ += bytes;
+    data.remove_prefix(bytes);
+    if (size_ - bufferOffset_ == bufferSize_) {
+      writeBuffer();
+    }
+  }
+}
+
+void DirectWriteFile::writeBuffer() {
+  if (context_ != nullptr) {
+    auto future =
+        context_->writev(fd_, bufferOffset_, {{buffer_.get(), bufferSize_}});
+    pending_.emplace_back(std::move(buffer_), std::move(future));
+    waitForWrites(maxInFlight_);
+    buffer_ = nextBuffer();
+  } else {
+    writeSync(buffer_.get(), bufferSize_, bufferOffset_);
+  }
+  bufferOffset_ += bufferSize_;
+}
+
+void DirectWriteFile::waitForWrites(size_t maxPending) {
+  while (pending_.size() > maxPending) {
+    auto [buffer, future] = std::move(pending_.front());
+    pending_.pop_front();
+    freeBuffers_.push_back(std::move(buffer));
+    const auto bytesWritten = std::move(future).get();
+    VELOX_CHECK_EQ(
+        bytesWritten,
+        bufferSize_,
+        "write failure in DirectWriteFile, {} vs {}.",
+        bytesWritten,
+        bufferSize_);
+  }
+}
+
+void DirectWriteFile::writeSync(
+    const char* data,
+    uint64_t size,
+    uint64_t offset) {
+  const auto bytesWritten = ::pwrite(fd_, data, size, offset);
+  VELOX_CHECK_EQ(
+      bytesWritten,
+      size,
+      "pwrite failure in DirectWriteFile, {} vs {}: {}.",
+      bytesWritten,
+      size,
+      folly::errnoStr(errno));
+}
+
+void DirectWriteFile::flush() {
+  VELOX_CHECK(!closed_, "file is closed");
+  waitForWrites(0);
+  const auto bufferFill = size_ - bufferOffset_;
+  if (bufferFill == 0) {
+    return;
+  }
+  // The partial buffer stays in 'buffer_' and is written again when full.
+  writeSync(
+      buffer_.get(), bits::roundUp(bufferFill, kAlignment), bufferOffset_);
+  const auto rc = ftruncate(fd_, size_);
+  VELOX_CHECK_EQ(
+      rc,
+      0,
+      "ftruncate failure in DirectWriteFile::flush: {}.",
+      folly::errnoStr(errno));
+}
+
+void DirectWriteFile::close() {
+  if (closed_) {
+    return;
+  }
+  flush();
+  closed_ = true;
+  const auto rc = ::close(fd_);
+  VELOX_CHECK_EQ(
+      rc,
+      0,
+      "close failure in DirectWriteFile::close: {}.",
+      folly::errnoStr(errno));
+}
+
+} // namespace facebook::velox
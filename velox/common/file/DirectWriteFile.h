@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#pragma once
+
+#include <deque>
+#include <memory>
+
+#include "velox/common/file/File.h"
+#include "velox/common/file/UringContext.h"
+
+namespace facebook::velox {
+
+/// A local WriteFile that writes with O_DIRECT to bypass the page cache, for
+/// large sequential writes like spilling. append() copies the data into
+/// page aligned buffers of 'bufferSize' bytes. A full buffer is written
+/// asynchronously with io_uring if supported, with at most 'maxInFlight'
+/// buffers being written at a time, and with pwrite(2) otherwise. flush()
+/// writes the last partial buffer padded to the block size and truncates the
+/// padding away. If the file system does not support O_DIRECT, the file is
+/// opened without it.
+class DirectWriteFile final : public WriteFile {
+ public:
+  /// The alignment of the file offsets, sizes and addresses of the writes.
+  static constexpr uint64_t kAlignment = 4096;
+
+  /// An error is thrown if a file already exists at 'path'. 'bufferSize' must
+  /// be a multiple of kAlignment.
+  explicit DirectWriteFile(
+      std::string_view path,
+      uint64_t bufferSize = 1 << 20,
+      int32_t maxInFlight = 4);
+
+  ~DirectWriteFile() override;
+
+  void append(std::string_view data) final;
+
+  void flush() final;
+
+  void close() final;
+
+  uint64_t size() const final {
+    return size_;
+  }
+
+ private:
+  struct FreeDeleter {
+    void operator()(char* data) const {
+      free(data);
+    }
+  };
+
+  using Buffer = std::unique_ptr<char, FreeDeleter>;
+
+  // Returns a free buffer, allocating one if needed.
+  Buffer nextBuffer();
+
+  // Writes the full 'buffer_' at 'bufferOffset_' and moves to the next
+  // buffer.
+  void writeBuffer();
+
+  // Waits until at most 'maxPending' buffers are being written.
+  void waitForWrites(size_t maxPending);
+
+  // Writes 'size' bytes of 'data' at 'offset' with pwrite(2).
+  void writeSync(const char* data, uint64_t size, uint64_t offset);
+
+  const std::string path_;
+  const uint64_t bufferSize_;
+  const int32_t maxInFlight_;
+  const std::shared_ptr<UringContext> context_;
+  int32_t fd_;
+  bool closed_{false};
+  uint64_t size_{0};
+
+  // The buffer being filled and its file offset. The offset is a multiple of
+  // 'bufferSize_'.
+  Buffer buffer_;
+  uint64_t bufferOffset_{0};
+
+  // The buffers being written, oldest first.
+  std::deque<std::pair<Buffer, folly::SemiFuture<uint64_t>>> pending_;
+  std::vector<Buffer> freeBuffers_;
+};
+
+} // namespace facebook::velox
@@ -53,6 +53,19 @@ uint64_t ReadFile::preadv(
   return numRead;
 }
 
+folly::SemiFuture<uint64_t> ReadFile::preadvBatchAsync(
+    const std::vector<ReadRequest>& requests) const {
+  try {
+    uint64_t numRead = 0;
+    for (const auto& request : requests) {
+      numRead += preadv(request.offset, request.buffers);
+    }
+    return folly::SemiFuture<uint64_t>(numRead);
+  } catch (const std::exception& e) {
+    return folly::makeSemiFuture<uint64_t>(e);
+  }
+}
+
 std::string_view
 InMemoryReadFile::pread(uint64_t offset, uint64_t length, void* buf) const {
   bytesRead_ += length;
@@ -32,6 +32,7 @@
 #include <functional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include <folly/Range.h>
 #include <folly/futures/Future.h>
@@ -43,6 +44,12 @@ namespace facebook::velox {
 // A read-only file.
 class ReadFile {
  public:
+  // A preadv of 'buffers' starting at 'offset'.
+  struct ReadRequest {
+    uint64_t offset;
+    std::vector<folly::Range<char*>> buffers;
+  };
+
   virtual ~ReadFile() = default;
 
   // Reads the data at [offset, offset + length) into the provided pre-allocated
@@ -73,8 +80,16 @@ class ReadFile {
     }
   }
 
-  // Returns true if preadvAsync has a native implementation that is
-  // asynchronous. The default implementation is synchronous.
+  // Issues all of 'requests' at once and returns the total read size or the
+  // first exception via SemiFuture. An asynchronous implementation can keep
+  // all the reads in flight together. The default implementation runs the
+  // requests one after the other.
+  virtual folly::SemiFuture<uint64_t> preadvBatchAsync(
+      const std::vector<ReadRequest>& requests) const;
+
+  // Returns true if preadvAsync and preadvBatchAsync have a native
+  // implementation that is asynchronous. The default implementation is
+  // synchronous.
   virtual bool hasPreadvAsync() const {
     return false;
   }
@@ -16,13 +16,20 @@
 
 #include "velox/common/file/FileSystems.h"
 #include <folly/synchronization/CallOnce.h>
+#include <gflags/gflags.h>
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/file/File.h"
+#include "velox/common/file/UringReadFile.h"
 #include "velox/core/Context.h"
 
 #include <cstdio>
 #include <filesystem>
 
+DEFINE_bool(
+    local_file_io_uring,
+    false,
+    "Read local files with io_uring if it is supported");
+
 namespace facebook::velox::filesystems {
 
 namespace {
@@ -84,6 +91,9 @@ class LocalFileSystem : public FileSystem {
   }
 
   std::unique_ptr<ReadFile> openFileForRead(std::string_view path) override {
+    if (FLAGS_local_file_io_uring && UringReadFile::isSupported()) {
+      return std::make_unique<UringReadFile>(extractPath(path));
+    }
     return std::make_unique<LocalReadFile>(extractPath(path));
   }
 
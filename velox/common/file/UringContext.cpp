@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "velox/common/file/UringContext.h"
+
+#include <sys/uio.h>
+
+#include <folly/String.h>
+#include <glog/logging.h>
+
+#ifdef VELOX_ENABLE_IO_URING
+#include <liburing.h>
+#endif
+
+namespace facebook::velox {
+
+namespace {
+// The number of submission queue entries of the ring.
+constexpr uint32_t kQueueDepth = 256;
+
+// The maximum number of operations in flight. The completion queue has twice
+// the entries of the submission queue.
+constexpr int32_t kMaxInFlight = 2 * kQueueDepth;
+
+// The maximum number of iovecs in one readv or writev.
+constexpr int32_t kMaxIovecs = IOV_MAX;
+} // namespace
+
+// One call of read() or writev(). Completes when all of its readvs or
+// writevs have completed.
+struct UringContext::Operation {
+  folly::Promise<uint64_t> promise;
+  // The iovecs referenced by the readvs or writevs. These must not move
+  // until the operation completes.
+  std::vector<struct iovec> iovecs;
+  // The readvs or writevs that have not completed.
+  int32_t numPending{0};
+  uint64_t numBytes{0};
+  // The error of the first failed readv or writev, if any.
+  int32_t error{0};
+};
+
+#ifdef VELOX_ENABLE_IO_URING
+UringContext::UringContext() : ring_(new io_uring()) {
+  const auto rc = io_uring_queue_init(kQueueDepth, ring_, 0);
+  if (rc < 0) {
+    delete ring_;
+    VELOX_FAIL("io_uring_queue_init failed: {}", folly::errnoStr(-rc));
+  }
+  reaper_ = std::thread([this]() { reap(); });
+}
+
+UringContext::~UringContext() {
+  {
+    std::unique_lock<std::mutex> l(mutex_);
+    // A nop with no Operation stops 'reaper_'.
+    auto* sqe = nextSqeLocked(l);
+    io_uring_prep_nop(sqe);
+    io_uring_sqe_set_data(sqe, nullptr);
+    io_uring_submit(ring_);
+  }
+  reaper_.join();
+  io_uring_queue_exit(ring_);
+  delete ring_;
+}
+
+// static
+std::shared_ptr<UringContext> UringContext::instance() {
+  static std::shared_ptr<UringContext> context =
+      []() -> std::shared_ptr<UringContext> {
+    try {
+      return std::shared_ptr<UringContext>(new UringContext());
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "io_uring is not available: " << e.what();
+      return nullptr;
+    }
+  }();
+  return context;
+}
+
+folly::SemiFuture<uint64_t> UringContext::read(
+    int32_t fd,
+    const std::vector<ReadFile::ReadRequest>& requests) {
+  std::vector<std::pair<uint64_t, int32_t>> readvs;
+  auto operation = std::make_unique<Operation>();
+  auto& iovecs = operation->iovecs;
+  for (const auto& request : requests) {
+    auto offset = request.offset;
+    bool inReadv = false;
+    for (const auto& buffer : request.buffers) {
+      if (buffer.data() == nullptr) {
+        // The skipped bytes count as read, like in preadv.
+        operation->numBytes += buffer.size();
+        inReadv = false;
+      } else {
+        if (!inReadv || iovecs.size() - readvs.back().second >= kMaxIovecs) {
+          readvs.emplace_back(offset, iovecs.size());
+          inReadv = true;
+        }
+        iovecs.push_back({buffer.data(), buffer.size()});
+      }
+      offset += buffer.size();
+    }
+  }
+  return submit(std::move(operation), readvs, false);
+}
+
+folly::SemiFuture<uint64_t> UringContext::writev(
+    int32_t fd,
+    uint64_t offset,
+    std::vector<struct iovec> iovecs) {
+  std::vector<std::pair<uint64_t, int32_t>> writevs;
+  for (auto i = 0; i < iovecs.size(); ++i) {
+    if (i % kMaxIovecs == 0) {
+      writevs.emplace_back(offset, i);
+    }
+    offset += iovecs[i].iov_len;
+  }
+  auto operation = std::make_unique<Operation>();
+  operation->iovecs = std::move(iovecs);
+  return submit(std::move(operation), writevs, true);
+}
+
+folly::SemiFuture<uint64_t> UringContext::submit(
+    std::unique_ptr<Operation> operation,
+    const std::vector<std::pair<uint64_t, int32_t>>& segments,
+    bool write) {
+  auto future = operation->promise.getSemiFuture();
+  if (segments.empty()) {
+    operation->promise.setValue(operation->numBytes);
+    return future;
+  }
+
+  auto& iovecs = operation->iovecs;
+  operation->numPending = segments.size();
+  std::unique_lock<std::mutex> l(mutex_);
+  for (auto i = 0; i < segments.size(); ++i) {
+    const int32_t end =
+        i + 1 < segments.size() ? segments[i + 1].second : iovecs.size();
+    const auto [offset, begin] = segments[i];
+    auto* sqe = nextSqeLocked(l);
+    if (write) {
+      io_uring_prep_writev(sqe, fd, &iovecs[begin], end - begin, offset);
+    } else {
+      io_uring_prep_readv(sqe, fd, &iovecs[begin], end - begin, offset);
+    }
+    io_uring_sqe_set_data(sqe, operation.get());
+  }
+  // 'reaper_' owns 'operation' once its entries are prepared.
+  operation.release();
+  const auto rc = io_uring_submit(ring_);
+  VELOX_CHECK_GE(rc, 0, "io_uring_submit failed: {}", folly::errnoStr(-rc));
+  return future;
+}
+
+io_uring_sqe* UringContext::nextSqeLocked(std::unique_lock<std::mutex>& l) {
+  if (inFlight_ >= kMaxInFlight) {
+    io_uring_submit(ring_);
+    inFlightCv_.wait(l, [&]() { return inFlight_ < kMaxInFlight; });
+  }
+  auto* sqe = io_uring_get_sqe(ring_);
+  if (sqe == nullptr) {
+    // The submission queue is full.
+    io_uring_submit(ring_);
+    sqe = io_uring_get_sqe(ring_);
+  }
+  VELOX_CHECK_NOT_NULL(sqe);
+  ++inFlight_;
+  return sqe;
+}
+
+void UringContext::reap() {
+  for (;;) {
+    struct io_uring_cqe* cqe;
+    const auto rc = io_uring_wait_cqe(ring_, &cqe);
+    if (rc == -EINTR) {
+      continue;
+    }
+    VELOX_CHECK_EQ(rc, 0, "io_uring_wait_cqe failed: {}", folly::errnoStr(-rc));
+    auto* operation = static_cast<Operation*>(io_uring_cqe_get_data(cqe));
+    const auto result = cqe->res;
+    io_uring_cqe_seen(ring_, cqe);
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      --inFlight_;
+    }
+    inFlightCv_.notify_one();
+    if (operation == nullptr) {
+      return;
+    }
+    if (result < 0) {
+      if (operation->error == 0) {
+        operation->error = -result;
+      }
+    } else {
+      operation->numBytes += result;
+    }
+    if (--operation->numPending > 0) {
+      continue;
+    }
+    std::unique_ptr<Operation> completed(operation);
+    if (completed->error != 0) {
+      completed->promise.setException(std::runtime_error(fmt::format(
+          "io_uring operation failed: {}",
+          folly::errnoStr(completed->error))));
+    } else {
+      completed->promise.setValue(completed->numBytes);
+    }
+  }
+}
+#else
+UringContext::UringContext() {
+  VELOX_UNSUPPORTED("Velox is built without VELOX_ENABLE_IO_URING");
+}
+
+UringContext::~UringContext() = default;
+
+// static
+std::shared_ptr<UringContext> UringContext::instance() {
+  return nullptr;
+}
+
+folly::SemiFuture<uint64_t> UringContext::read(
+    int32_t /*fd*/,
+    const std::vector<ReadFile::ReadRequest>& /*requests*/) {
+  VELOX_UNREACHABLE();
+}
+
+folly::SemiFuture<uint64_t> UringContext::writev(
+    int32_t /*fd*/,
+    uint64_t /*offset*/,
+    std::vector<struct iovec> /*iovecs*/) {
+  VELOX_UNREACHABLE();
+}
+#endif
+
+} // namespace facebook::velox
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "velox/common/file/File.h"
+
+struct io_uring;
+struct io_uring_sqe;
+struct iovec;
+
+namespace facebook::velox {
+
+/// An io_uring shared by the io_uring backed files of the process. Reads and
+/// writes are submitted from any thread. A reaper thread completes the
+/// returned futures. The number of operations in flight is bounded by the
+/// size of the completion queue, so completions can't overflow.
+class UringContext {
+ public:
+  ~UringContext();
+
+  /// Returns the process wide ring or nullptr if Velox is not built with
+  /// VELOX_ENABLE_IO_URING or the kernel can't set up a ring.
+  static std::shared_ptr<UringContext> instance();
+
+  /// Reads 'requests' from 'fd' and returns the total read size like
+  /// ReadFile::preadvBatchAsync(). Each contiguous range of non-null buffers
+  /// is read by one readv. The gaps are not read but count as read.
+  folly::SemiFuture<uint64_t> read(
+      int32_t fd,
+      const std::vector<ReadFile::ReadRequest>& requests);
+
+  /// Writes the memory referenced by 'iovecs' to 'fd' at 'offset' and
+  /// returns the written size. The memory must stay valid until the future
+  /// completes.
+  folly::SemiFuture<uint64_t>
+  writev(int32_t fd, uint64_t offset, std::vector<struct iovec> iovecs);
+
+ private:
+  struct Operation;
+
+  UringContext();
+
+  // Submits one readv or writev of 'operation' per element of 'segments',
+  // which are the file offset and the first iovec of each readv or writev.
+  folly::SemiFuture<uint64_t> submit(
+      std::unique_ptr<Operation> operation,
+      const std::vector<std::pair<uint64_t, int32_t>>& segments,
+      bool write);
+
+  // Returns a free submission queue entry. Submits the prepared entries and
+  // waits if the maximum number of operations is in flight.
+  io_uring_sqe* nextSqeLocked(std::unique_lock<std::mutex>& lock);
+
+  // Completes the operations until the ring is shut down.
+  void reap();
+
+  // Allocated by the constructor and freed by the destructor.
+  io_uring* ring_{nullptr};
+  std::mutex mutex_;
+  // Signaled when an operation completes.
+  std::condition_variable inFlightCv_;
+  int32_t inFlight_{0};
+  std::thread reaper_;
+};
+
+} // namespace facebook::velox
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "velox/common/file/UringReadFile.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <folly/String.h>
+#include <glog/logging.h>
+
+namespace facebook::velox {
+
+namespace {
+uint64_t fileSize(int32_t fd, std::string_view path) {
+  struct stat st;
+  VELOX_CHECK_EQ(
+      fstat(fd, &st),
+      0,
+      "fstat failure in UringReadFile constructor, {} {}.",
+      path,
+      folly::errnoStr(errno));
+  return st.st_size;
+}
+} // namespace
+
+bool UringReadFile::isSupported() {
+  return UringContext::instance() != nullptr;
+}
+
+UringReadFile::UringReadFile(std::string_view path, bool directIo)
+    : path_(path), context_(UringContext::instance()) {
+  VELOX_CHECK_NOT_NULL(context_, "io_uring is not supported");
+  int32_t flags = O_RDONLY;
+#ifdef linux
+  if (directIo) {
+    flags |= O_DIRECT;
+  }
+#endif
+  fd_ = open(path_.c_str(), flags);
+  VELOX_CHECK_GE(
+      fd_,
+      0,
+      "open failure in UringReadFile constructor, {} {} {}.",
+      fd_,
+      path,
+      folly::errnoStr(errno));
+  size_ = fileSize(fd_, path_);
+}
+
+UringReadFile::UringReadFile(int32_t fd)
+    : context_(UringContext::instance()), fd_(fd) {
+  VELOX_CHECK_NOT_NULL(context_, "io_uring is not supported");
+  size_ = fileSize(fd_, getName());
+}
+
+UringReadFile::~UringReadFile() {
+  const int ret = close(fd_);
+  if (ret < 0) {
+    LOG(WARNING) << "close failure in UringReadFile destructor: " << ret
+                 << ", " << folly::errnoStr(errno);
+  }
+}
+
+std::string_view
+UringReadFile::pread(uint64_t offset, uint64_t length, void* buf) const {
+  bytesRead_ += length;
+  auto bytesRead = ::pread(fd_, buf, length, offset);
+  VELOX_CHECK_EQ(
+      bytesRead,
+      length,
+      "pread failure in UringReadFile::pread, {} vs {}.",
+      bytesRead,
+      length);
+  return {static_cast<char*>(buf), length};
+}
+
+uint64_t UringReadFile::preadv(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  // The gaps are not read, unlike in preadv(2).
+  return preadvAsync(offset, buffers).get();
+}
+
+folly::SemiFuture<uint64_t> UringReadFile::preadvAsync(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  return preadvBatchAsync({ReadRequest{offset, buffers}});
+}
+
+folly::SemiFuture<uint64_t> UringReadFile::preadvBatchAsync(
+    const std::vector<ReadRequest>& requests) const {
+  for (const auto& request : requests) {
+    for (const auto& buffer : request.buffers) {
+      if (buffer.data() != nullptr) {
+        bytesRead_ += buffer.size();
+      }
+    }
+  }
+  try {
+    return context_->read(fd_, requests);
+  } catch (const std::exception& e) {
+    return folly::makeSemiFuture<uint64_t>(e);
+  }
+}
+
+} // namespace facebook::velox
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#pragma once
+
+#include <memory>
+
+#include "velox/common/file/File.h"
+#include "velox/common/file/UringContext.h"
+
+namespace facebook::velox {
+
+/// A local ReadFile that reads asynchronously with io_uring. preadvAsync()
+/// and preadvBatchAsync() submit the reads to the process wide UringContext,
+/// so that many reads can be in flight without blocking a thread per read.
+/// preadv() waits for preadvAsync(). Unlike LocalReadFile, the gaps between
+/// the buffers are not read.
+///
+/// Available only if Velox is built with VELOX_ENABLE_IO_URING and the kernel
+/// supports io_uring, see isSupported().
+class UringReadFile final : public ReadFile {
+ public:
+  /// Opens 'path' for read, with O_DIRECT if 'directIo' is true. With
+  /// O_DIRECT, the offsets, sizes and addresses of all the reads must be
+  /// aligned to the logical block size of the device.
+  explicit UringReadFile(std::string_view path, bool directIo = false);
+
+  /// Reads from 'fd' which is closed on destruction, like LocalReadFile.
+  explicit UringReadFile(int32_t fd);
+
+  ~UringReadFile() override;
+
+  /// Returns true if io_uring is compiled in and can be set up by the
+  /// kernel. The constructors throw otherwise.
+  static bool isSupported();
+
+  std::string_view
+  pread(uint64_t offset, uint64_t length, void* FOLLY_NONNULL buf) const final;
+
+  uint64_t preadv(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const final;
+
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const final;
+
+  folly::SemiFuture<uint64_t> preadvBatchAsync(
+      const std::vector<ReadRequest>& requests) const final;
+
+  bool hasPreadvAsync() const final {
+    return true;
+  }
+
+  uint64_t size() const final {
+    return size_;
+  }
+
+  uint64_t memoryUsage() const final {
+    return sizeof(*this);
+  }
+
+  bool shouldCoalesce() const final {
+    return false;
+  }
+
+  std::string getName() const override {
+    if (path_.empty()) {
+      return "<UringReadFile>";
+    }
+    return path_;
+  }
+
+  uint64_t getNaturalReadSize() const override {
+    return 10 << 20;
+  }
+
+ private:
+  const std::string path_;
+  const std::shared_ptr<UringContext> context_;
+  int32_t fd_;
+  uint64_t size_{0};
+};
+
+} // namespace facebook::velox
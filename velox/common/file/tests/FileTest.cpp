@@ -14,10 +14,14 @@
  * limitations under the License.
  */
 
+#include <array>
 #include <fcntl.h>
 
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/file/DirectWriteFile.h"
 #include "velox/common/file/File.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/file/UringReadFile.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/exec/tests/utils/TempFilePath.h"
 
@@ -216,6 +220,61 @@ TEST(LocalFile, readFileDestructor) {
   }
 }
 
+TEST(LocalFile, uringReadFile) {
+  if (!UringReadFile::isSupported()) {
+    GTEST_SKIP() << "io_uring is not supported";
+  }
+  auto tempFile = ::exec::test::TempFilePath::create();
+  const auto& filename = tempFile->path.c_str();
+  remove(filename);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  UringReadFile readFile(filename);
+  ASSERT_TRUE(readFile.hasPreadvAsync());
+  readData(&readFile);
+
+  // Many reads in flight together, with gaps in between.
+  constexpr int32_t kNumRequests = 1'000;
+  std::vector<std::array<char, 10>> data(kNumRequests);
+  std::vector<ReadFile::ReadRequest> requests;
+  for (auto i = 0; i < kNumRequests; ++i) {
+    requests.push_back(
+        {static_cast<uint64_t>(i % 2 ? 0 : kOneMB),
+         {folly::Range<char*>(nullptr, (char*)(uint64_t)5),
+          folly::Range<char*>(data[i].data(), data[i].size())}});
+  }
+  ASSERT_EQ(readFile.preadvBatchAsync(requests).get(), 15 * kNumRequests);
+  for (auto i = 0; i < kNumRequests; ++i) {
+    ASSERT_EQ(
+        std::string_view(data[i].data(), data[i].size()),
+        i % 2 ? "bbbbbccccc" : "cccccddddd");
+  }
+}
+
+TEST(LocalFile, directWriteFile) {
+  auto tempFile = ::exec::test::TempFilePath::create();
+  const auto& filename = tempFile->path.c_str();
+  remove(filename);
+  {
+    // Small buffers so that the data spans many buffers, with a partial
+    // buffer flushed in the middle.
+    DirectWriteFile writeFile(filename, DirectWriteFile::kAlignment, 2);
+    writeFile.append("aaaaa");
+    writeFile.flush();
+    writeFile.append("bbbbb");
+    writeFile.append(std::string(kOneMB, 'c'));
+    writeFile.flush();
+    writeFile.append("ddddd");
+    ASSERT_EQ(writeFile.size(), 15 + kOneMB);
+  }
+  LocalReadFile readFile(filename);
+  readData(&readFile);
+  VELOX_ASSERT_THROW(
+      std::make_unique<DirectWriteFile>(filename), "open failure");
+}
+
 TEST(LocalFile, mkdir) {
   filesystems::registerLocalFileSystem();
   auto tempFolder = ::exec::test::TempDirectoryPath::create();
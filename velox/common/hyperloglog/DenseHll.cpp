@@ -18,6 +18,7 @@
 #include <exception>
 #include <sstream>
 #include "velox/common/base/IOUtils.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/common/hyperloglog/BiasCorrection.h"
 #include "velox/common/hyperloglog/HllUtils.h"
 
@@ -143,6 +144,14 @@ void DenseHll::insertHash(uint64_t hash) {
   insert(index, value);
 }
 
+void DenseHll::insertHashes(const uint64_t* hashes, int32_t numHashes) {
+  for (auto i = 0; i < numHashes; ++i) {
+    insert(
+        computeIndex(hashes[i], indexBitLength_),
+        computeValue(hashes[i], indexBitLength_));
+  }
+}
+
 void DenseHll::insert(int32_t index, int8_t value) {
   auto delta = value - baseline_;
   auto oldDelta = getDelta(index);
@@ -568,6 +577,11 @@ void DenseHll::mergeWith(
     int16_t otherOverflows,
     const uint16_t* otherOverflowBuckets,
     const int8_t* otherOverflowValues) {
+  if (baseline_ == otherBaseline && overflows_ == 0 && otherOverflows == 0) {
+    mergeDeltas(otherDeltas);
+    return;
+  }
+
   int8_t newBaseline = std::max(baseline_, otherBaseline);
   int32_t baselineCount = 0;
 
@@ -623,6 +637,37 @@ void DenseHll::mergeWith(
   adjustBaselineIfNeeded();
 }
 
+void DenseHll::mergeDeltas(const int8_t* otherDeltas) {
+  // With the same baseline and no overflows the merged value of each bucket
+  // is the max of the 2 deltas. Each byte holds 2 buckets, so take the max of
+  // the high and low nibbles separately.
+  using Batch = xsimd::batch<uint8_t>;
+  const auto highMask = Batch::broadcast(kBucketMask << 4);
+  const auto lowMask = Batch::broadcast(kBucketMask);
+  auto* deltas = reinterpret_cast<uint8_t*>(deltas_.data());
+  auto* other = reinterpret_cast<const uint8_t*>(otherDeltas);
+  const int32_t size = deltas_.size();
+  int32_t i = 0;
+  for (; i + Batch::size <= size; i += Batch::size) {
+    auto left = Batch::load_unaligned(deltas + i);
+    auto right = Batch::load_unaligned(other + i);
+    auto merged = xsimd::max(left & highMask, right & highMask) |
+        xsimd::max(left & lowMask, right & lowMask);
+    merged.store_unaligned(deltas + i);
+  }
+  for (; i < size; ++i) {
+    deltas[i] = std::max<uint8_t>(deltas[i] & 0xF0, other[i] & 0xF0) |
+        std::max<uint8_t>(deltas[i] & kBucketMask, other[i] & kBucketMask);
+  }
+
+  int32_t baselineCount = 0;
+  for (i = 0; i < size; ++i) {
+    baselineCount += ((deltas[i] >> 4) == 0) + ((deltas[i] & kBucketMask) == 0);
+  }
+  baselineCount_ = baselineCount;
+  adjustBaselineIfNeeded();
+}
+
 int8_t
 DenseHll::updateOverflow(int32_t index, int overflowEntry, int8_t delta) {
   if (delta > kMaxDelta) {
@@ -88,6 +88,40 @@ bool SparseHll::insertHash(uint64_t hash) {
   return entries_.size() >= softNumEntriesLimit_;
 }
 
+int32_t SparseHll::insertHashes(const uint64_t* hashes, int32_t numHashes) {
+  std::vector<uint32_t> newEntries;
+  int32_t numInserted = 0;
+  while (numInserted < numHashes && entries_.size() < softNumEntriesLimit_) {
+    // Insert at most as many hashes as fit below the soft limit, so that the
+    // number of entries stays within what the serialized form can hold.
+    const auto batchSize = std::min<int32_t>(
+        numHashes - numInserted, softNumEntriesLimit_ - entries_.size());
+    newEntries.resize(batchSize);
+    for (auto i = 0; i < batchSize; ++i) {
+      const auto hash = hashes[numInserted + i];
+      newEntries[i] = encode(
+          computeIndex(hash, kIndexBitLength),
+          computeValue(hash, kIndexBitLength));
+    }
+    numInserted += batchSize;
+
+    // Sort the new entries and keep the largest value of each bucket, which
+    // sorts last, then merge them with the existing entries in one pass.
+    std::sort(newEntries.begin(), newEntries.end());
+    size_t numEntries = 0;
+    for (auto entry : newEntries) {
+      if (numEntries > 0 &&
+          decodeIndex(newEntries[numEntries - 1]) == decodeIndex(entry)) {
+        newEntries[numEntries - 1] = entry;
+      } else {
+        newEntries[numEntries++] = entry;
+      }
+    }
+    mergeWith(numEntries, newEntries.data());
+  }
+  return numInserted;
+}
+
 int64_t SparseHll::cardinality() const {
   // Estimate the cardinality using linear counting over the theoretical
   // 2^kIndexBitLength buckets available due to the fact that we're
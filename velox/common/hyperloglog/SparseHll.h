@@ -35,6 +35,14 @@ class SparseHll {
   /// Returns true if soft memory limit has been reached. False, otherwise.
   bool insertHash(uint64_t hash);
 
+  /// Inserts hashes from 'hashes' until all 'numHashes' are inserted or the
+  /// soft memory limit is reached. Sorts each batch of hashes and merges it
+  /// with the existing entries in one pass instead of inserting the hashes one
+  /// by one into the sorted list of entries. Returns the number of inserted
+  /// hashes. The caller is expected to switch to DenseHll if this is less than
+  /// 'numHashes'.
+  int32_t insertHashes(const uint64_t* hashes, int32_t numHashes);
+
   int64_t cardinality() const;
 
   /// Returns cardinality estimate from the specified serialized digest.
@@ -139,6 +139,34 @@ TEST_F(SparseHllTest, highCardinality) {
   ASSERT_EQ(1'000, SparseHll::cardinality(serialized.data()));
 }
 
+TEST_F(SparseHllTest, insertHashes) {
+  SparseHll sparseHll{&allocator_};
+  SparseHll expected{&allocator_};
+  sparseHll.setSoftMemoryLimit(4 * 1'000);
+
+  std::vector<uint64_t> hashes;
+  for (int i = 0; i < 1'500; i++) {
+    // Repeat some values within the batch.
+    hashes.push_back(hashOne(i % 700));
+    expected.insertHash(hashes.back());
+  }
+  ASSERT_EQ(sparseHll.insertHashes(hashes.data(), hashes.size()), 1'500);
+  sparseHll.verify();
+  ASSERT_EQ(sparseHll.cardinality(), expected.cardinality());
+  ASSERT_EQ(serialize(11, sparseHll), serialize(11, expected));
+
+  // Stops inserting once the soft memory limit is reached.
+  hashes.clear();
+  for (int i = 700; i < 2'000; i++) {
+    hashes.push_back(hashOne(i));
+  }
+  auto numInserted = sparseHll.insertHashes(hashes.data(), hashes.size());
+  ASSERT_EQ(numInserted, 300);
+  sparseHll.verify();
+  ASSERT_EQ(sparseHll.inMemorySize(), 4 * 1'000);
+  ASSERT_EQ(sparseHll.insertHashes(hashes.data() + numInserted, 1), 0);
+}
+
 namespace {
 template <typename T>
 std::vector<T> sequence(T start, T end) {
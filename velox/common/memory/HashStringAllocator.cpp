@@ -16,6 +16,8 @@
 
 #include "velox/common/memory/HashStringAllocator.h"
 
+#include <fmt/format.h>
+
 namespace facebook::velox {
 
 namespace {
@@ -146,7 +148,32 @@ HashStringAllocator::Position HashStringAllocator::finishWrite(
   return currentPos;
 }
 
+void HashStringAllocator::Stats::addRuntimeStats(
+    const std::string& prefix,
+    std::unordered_map<std::string, RuntimeMetric>& runtimeStats) const {
+  const std::pair<const char*, const Histogram*> histograms[] = {
+      {"allocationSize", &allocationSizes},
+      {"freeListLength", &freeListLengths},
+      {"searchSteps", &searchSteps}};
+  for (const auto& [name, histogram] : histograms) {
+    if (histogram->metric.count == 0) {
+      continue;
+    }
+    runtimeStats[prefix + name] = histogram->metric;
+    for (auto i = 0; i < Histogram::kNumBuckets; ++i) {
+      if (histogram->counts[i] != 0) {
+        runtimeStats[fmt::format("{}{}Bucket{}", prefix, name, 1L << i)] =
+            RuntimeMetric(histogram->counts[i]);
+      }
+    }
+  }
+  runtimeStats[prefix + "numNewSlabs"] = RuntimeMetric(numNewSlabs);
+}
+
 void HashStringAllocator::newSlab(int32_t size) {
+  if (stats_) {
+    ++stats_->numNewSlabs;
+  }
   int32_t needed = std::max<int32_t>(
       bits::roundUp(
           size + 2 * sizeof(Header), memory::AllocationTraits::kPageSize),
@@ -159,6 +186,13 @@ void HashStringAllocator::newSlab(int32_t size) {
   *reinterpret_cast<uint32_t*>(run + available) = Header::kArenaEnd;
   cumulativeBytes_ += available;
 
+  if (appendOnly_) {
+    // The rest of the previous slab, if any, stays unused.
+    tail_ = new (run) Header(available - sizeof(Header));
+    cumulativeBytes_ -= tail_->size();
+    return;
+  }
+
   // Add the new memory to the free list: Placement construct a header
   // that covers the space from start to the end marker and add this
   // to free list.
@@ -206,6 +240,22 @@ StringView HashStringAllocator::contiguousString(
 }
 
 void HashStringAllocator::freeRestOfBlock(Header* header, int32_t keepBytes) {
+  if (appendOnly_) {
+    // Only the rest of the last block of a slab can be allocated again. This
+    // is the case for a block that took all of 'tail_'.
+    if (tail_ != nullptr || header->next() != nullptr) {
+      return;
+    }
+    keepBytes = std::max(keepBytes, kMinAppendOnlyAlloc);
+    const int32_t freeSize = header->size() - keepBytes - sizeof(Header);
+    if (freeSize < kMinAppendOnlyAlloc) {
+      return;
+    }
+    header->setSize(keepBytes);
+    tail_ = new (header->end()) Header(freeSize);
+    cumulativeBytes_ -= freeSize;
+    return;
+  }
   keepBytes = std::max(keepBytes, kMinAlloc);
   int32_t freeSize = header->size() - keepBytes - sizeof(Header);
   if (freeSize <= kMinAlloc) {
@@ -219,6 +269,18 @@ void HashStringAllocator::freeRestOfBlock(Header* header, int32_t keepBytes) {
 
 HashStringAllocator::Header* FOLLY_NULLABLE
 HashStringAllocator::allocate(int32_t size, bool exactSize) {
+  if (stats_) {
+    stats_->allocationSizes.record(size);
+  }
+  if (appendOnly_) {
+    auto header = allocateFromTail(size, exactSize);
+    if (!header) {
+      newSlab(size);
+      header = allocateFromTail(size, exactSize);
+      VELOX_CHECK(header != nullptr);
+    }
+    return header;
+  }
   auto header = allocateFromFreeList(size, exactSize, exactSize);
   if (!header) {
     newSlab(size);
@@ -230,6 +292,25 @@ HashStringAllocator::allocate(int32_t size, bool exactSize) {
   return header;
 }
 
+HashStringAllocator::Header* FOLLY_NULLABLE
+HashStringAllocator::allocateFromTail(int32_t size, bool exactSize) {
+  // A block that is not of final size only needs space for some of the
+  // data. The write continues in a new block.
+  const int32_t minSize = exactSize ? size : std::min(size, kMinContiguous);
+  if (!tail_ || tail_->size() < minSize) {
+    return nullptr;
+  }
+  auto header = tail_;
+  tail_ = nullptr;
+  const int32_t restSize = header->size() - size - sizeof(Header);
+  if (exactSize && restSize >= kMinAppendOnlyAlloc) {
+    header->setSize(size);
+    tail_ = new (header->end()) Header(restSize);
+  }
+  cumulativeBytes_ += header->size();
+  return header;
+}
+
 HashStringAllocator::Header* FOLLY_NULLABLE
 HashStringAllocator::allocateFromFreeList(
     int32_t preferredSize,
@@ -242,9 +323,11 @@ HashStringAllocator::allocateFromFreeList(
   VELOX_CHECK(!free_.empty());
   preferredSize = std::max(kMinAlloc, preferredSize);
   int32_t counter = 0;
+  int32_t numSteps = 0;
   Header* largest = nullptr;
   Header* found = nullptr;
   for (auto* item = free_.next(); item != &free_; item = item->next()) {
+    ++numSteps;
     auto header = headerOf(item);
     VELOX_CHECK(header->isFree());
     auto size = header->size();
@@ -262,6 +345,10 @@ HashStringAllocator::allocateFromFreeList(
   if (!mustHaveSize && !found) {
     found = largest;
   }
+  if (stats_) {
+    stats_->freeListLengths.record(numFree_);
+    stats_->searchSteps.record(numSteps);
+  }
   if (!found) {
     return nullptr;
   }
@@ -283,6 +370,16 @@ HashStringAllocator::allocateFromFreeList(
 
 void HashStringAllocator::free(Header* _header) {
   Header* header = _header;
+  if (appendOnly_) {
+    for (;;) {
+      VELOX_CHECK(!header->isFree());
+      cumulativeBytes_ -= header->size();
+      if (!header->isContinued()) {
+        return;
+      }
+      header = getNextContinued(header);
+    }
+  }
   do {
     Header* continued = nullptr;
     if (header->isContinued()) {
@@ -15,7 +15,11 @@
  */
 #pragma once
 
+#include <array>
+#include <unordered_map>
+
 #include "velox/common/base/CheckedArithmetic.h"
+#include "velox/common/base/RuntimeMetrics.h"
 #include "velox/common/memory/AllocationPool.h"
 #include "velox/common/memory/ByteStream.h"
 #include "velox/common/memory/CompactDoubleList.h"
@@ -37,6 +41,12 @@ namespace facebook::velox {
 // below is free. In this case the uint32_t below the header has the size of the
 // previous free block. The last word of a Allocation::PageRun backing a
 // HashStringAllocator is set to kArenaEnd.
+//
+// In append-only mode, blocks are carved from the end of the last PageRun
+// and free() only updates the accounting. There is no free list and blocks
+// have no padding for free list pointers. The memory is returned by clear().
+// This suits containers that free their contents all at once, e.g. the keys
+// and accumulators of a group by.
 class HashStringAllocator : public StreamArena {
  public:
   // The minimum allocation must have space after the header for the
@@ -44,6 +54,50 @@ class HashStringAllocator : public StreamArena {
   static constexpr int32_t kMinAlloc =
       sizeof(CompactDoubleList) + sizeof(uint32_t);
 
+  // Power of 2 histogram of non-negative values. Bucket i counts the values in
+  // [2^i, 2^(i+1)). The first bucket also counts 0 and the last bucket all
+  // larger values.
+  struct Histogram {
+    static constexpr int32_t kNumBuckets = 24;
+
+    std::array<uint64_t, kNumBuckets> counts{};
+    RuntimeMetric metric;
+
+    void record(int64_t value) {
+      const int32_t bucket = value <= 1
+          ? 0
+          : std::min<int32_t>(kNumBuckets - 1, 63 - __builtin_clzll(value));
+      ++counts[bucket];
+      metric.addValue(value);
+    }
+  };
+
+  // Allocation statistics. Collected only if enabled by setTrackStats().
+  struct Stats {
+    // Requested sizes of new blocks, including the blocks for writes and
+    // their continuations.
+    Histogram allocationSizes;
+
+    // The number of blocks in the free list at the start of each allocation
+    // from the free list.
+    Histogram freeListLengths;
+
+    // The number of free blocks each allocation from the free list looked at.
+    Histogram searchSteps;
+
+    // The number of allocations that did not fit in free memory and added a
+    // slab.
+    uint64_t numNewSlabs{0};
+
+    // Sets '<prefix>allocationSize', '<prefix>freeListLength' and
+    // '<prefix>searchSteps' in 'runtimeStats' to the distributions and
+    // '<name>Bucket<lower bound>', e.g. 'allocationSizeBucket64', to the
+    // counts of their non-empty buckets. Also sets '<prefix>numNewSlabs'.
+    void addRuntimeStats(
+        const std::string& prefix,
+        std::unordered_map<std::string, RuntimeMetric>& runtimeStats) const;
+  };
+
   class Header {
    public:
     static constexpr uint32_t kFree = 1U << 31;
@@ -131,8 +185,10 @@ class HashStringAllocator : public StreamArena {
     char* FOLLY_NULLABLE position;
   };
 
-  explicit HashStringAllocator(memory::MemoryPool* FOLLY_NONNULL pool)
-      : StreamArena(pool), pool_(pool) {}
+  explicit HashStringAllocator(
+      memory::MemoryPool* FOLLY_NONNULL pool,
+      bool appendOnly = false)
+      : StreamArena(pool), appendOnly_(appendOnly), pool_(pool) {}
 
   // Copies a StringView at 'offset' in 'group' to storage owned by
   // the hash table. Updates the StringView.
@@ -183,7 +239,8 @@ class HashStringAllocator : public StreamArena {
   Header* FOLLY_NONNULL allocate(int32_t size) {
     VELOX_CHECK(
         !currentHeader_, "Do not call allocate() when a write is in progress");
-    return allocate(std::max(size, kMinAlloc), true);
+    return allocate(
+        std::max(size, appendOnly_ ? kMinAppendOnlyAlloc : kMinAlloc), true);
   }
 
   // Returns the header immediately below 'data'.
@@ -248,15 +305,20 @@ class HashStringAllocator : public StreamArena {
   }
 
   // Adds the allocation of 'header' and any extensions (if header has
-  // kContinued set) to the free list.
+  // kContinued set) to the free list. In append-only mode the memory is not
+  // reused before clear().
   void free(Header* FOLLY_NONNULL header);
 
   // Returns a lower bound on bytes available without growing
   // 'this'. This is the sum of free block sizes minus size of pointer
   // for each. We subtract the pointer because in the worst case we
   // would have one allocation that chains many small free blocks
-  // together via kContinued.
+  // together via kContinued. In append-only mode this is the space left at
+  // the end of the last slab.
   uint64_t freeSpace() const {
+    if (appendOnly_) {
+      return tail_ ? tail_->size() : 0;
+    }
     int64_t minFree = freeBytes_ - numFree_ * (sizeof(Header) + sizeof(void*));
     VELOX_CHECK_GE(minFree, 0, "Guaranteed free space cannot be negative");
     return minFree;
@@ -266,6 +328,7 @@ class HashStringAllocator : public StreamArena {
   void clear() {
     numFree_ = 0;
     freeBytes_ = 0;
+    tail_ = nullptr;
     new (&free_) CompactDoubleList();
     pool_.clear();
   }
@@ -274,6 +337,10 @@ class HashStringAllocator : public StreamArena {
     return pool_.pool();
   }
 
+  bool isAppendOnly() const {
+    return appendOnly_;
+  }
+
   uint64_t cumulativeBytes() const {
     return cumulativeBytes_;
   }
@@ -282,10 +349,27 @@ class HashStringAllocator : public StreamArena {
   // Headers. Throws when detects corruption.
   void checkConsistency() const;
 
+  // Starts or stops collecting allocation statistics. Stopping drops the
+  // statistics collected so far. Off by default since it adds to the cost of
+  // each allocation.
+  void setTrackStats(bool enable) {
+    stats_ = enable ? std::make_unique<Stats>() : nullptr;
+  }
+
+  // Returns the allocation statistics since setTrackStats(true) or nullptr if
+  // not collected. These survive clear().
+  const Stats* FOLLY_NULLABLE stats() const {
+    return stats_.get();
+  }
+
  private:
   static constexpr int32_t kUnitSize = 16 * memory::AllocationTraits::kPageSize;
   static constexpr int32_t kMinContiguous = 48;
 
+  // The minimum allocation in append-only mode. Leaves space for the pointer
+  // to a continuation block.
+  static constexpr int32_t kMinAppendOnlyAlloc = sizeof(void*);
+
   // Adds 'bytes' worth of contiguous space to the free list. This
   // grows the footprint in MemoryAllocator but does not allocate
   // anything yet. Throws if fails to grow. The caller typically knows
@@ -304,6 +388,10 @@ class HashStringAllocator : public StreamArena {
   /// be smaller or larger. Checks free list before allocating new memory.
   Header* FOLLY_NULLABLE allocate(int32_t size, bool exactSize);
 
+  // Allocates a block from 'tail_' in append-only mode. If exactSize is false,
+  // returns all of 'tail_'.
+  Header* FOLLY_NULLABLE allocateFromTail(int32_t size, bool exactSize);
+
   // Allocates memory from free list. Returns nullptr if no memory in
   // free list, otherwise returns a header of a free block of some
   // size. if 'mustHaveSize' is true, the block will not be smaller
@@ -321,6 +409,13 @@ class HashStringAllocator : public StreamArena {
   // blocks would be below minimum size.
   void freeRestOfBlock(Header* FOLLY_NONNULL header, int32_t keepBytes);
 
+  const bool appendOnly_;
+
+  // The unallocated space at the end of the last slab in append-only
+  // mode. Not marked free and not in 'free_'. nullptr if there is no space
+  // left or if all of it is being written.
+  Header* FOLLY_NULLABLE tail_ = nullptr;
+
   // Circular list of free blocks.
   CompactDoubleList free_;
 
@@ -342,6 +437,9 @@ class HashStringAllocator : public StreamArena {
 
   // Pool for getting new slabs.
   AllocationPool pool_;
+
+  // Allocation statistics. nullptr unless enabled.
+  std::unique_ptr<Stats> stats_;
 };
 
 // Utility for keeping track of allocation between two points in
@@ -35,6 +35,7 @@ constexpr folly::StringPiece kDefaultLeafName("__default_leaf__");
 
 MemoryManager::MemoryManager(const Options& options)
     : allocator_{options.allocator->shared_from_this()},
+      arbitrator_{options.arbitrator},
       memoryQuota_{options.capacity},
       alignment_(std::max(MemoryAllocator::kMinAlignment, options.alignment)),
       poolDestructionCb_([&](MemoryPool* pool) { dropPool(pool); }),
@@ -105,6 +106,9 @@ std::shared_ptr<MemoryPool> MemoryManager::getPool(
       nullptr,
       poolDestructionCb_,
       options);
+  if (arbitrator_ != nullptr) {
+    arbitrator_->registerTracker(pool->getMemoryUsageTracker());
+  }
   folly::SharedMutex::WriteHolder guard{mutex_};
   pools_.push_back(pool.get());
   return pool;
@@ -112,6 +116,9 @@ std::shared_ptr<MemoryPool> MemoryManager::getPool(
 
 void MemoryManager::dropPool(MemoryPool* pool) {
   VELOX_CHECK_NOT_NULL(pool);
+  if (arbitrator_ != nullptr) {
+    arbitrator_->unregisterTracker(pool->getMemoryUsageTracker().get());
+  }
   folly::SharedMutex::WriteHolder guard{mutex_};
   auto it = pools_.begin();
   while (it != pools_.end()) {
@@ -39,6 +39,7 @@
 #include "velox/common/base/SuccinctPrinter.h"
 #include "velox/common/memory/Allocation.h"
 #include "velox/common/memory/MemoryAllocator.h"
+#include "velox/common/memory/MemoryArbitrator.h"
 #include "velox/common/memory/MemoryPool.h"
 #include "velox/common/memory/MemoryUsage.h"
 
@@ -73,6 +74,10 @@ class IMemoryManager {
 
     /// Specifies the backing memory allocator.
     MemoryAllocator* allocator{MemoryAllocator::getInstance()};
+
+    /// Specifies the optional memory arbitrator. If set, the capacity of the
+    /// root memory pools created by getPool() is arbitrated by it.
+    std::shared_ptr<MemoryArbitrator> arbitrator{nullptr};
   };
 
   virtual ~IMemoryManager() = default;
@@ -175,6 +180,11 @@ class MemoryManager final : public IMemoryManager {
 
   MemoryAllocator& getAllocator();
 
+  /// Returns the memory arbitrator of this memory manager or null if not set.
+  MemoryArbitrator* arbitrator() const {
+    return arbitrator_.get();
+  }
+
   /// Returns the memory manger's internal default root memory pool for testing
   /// purpose.
   MemoryPool& testingDefaultRoot() const {
@@ -185,6 +195,7 @@ class MemoryManager final : public IMemoryManager {
   void dropPool(MemoryPool* pool);
 
   const std::shared_ptr<MemoryAllocator> allocator_;
+  const std::shared_ptr<MemoryArbitrator> arbitrator_;
   const int64_t memoryQuota_;
   const uint16_t alignment_;
   // The destruction callback set for the root memory pools created by getPool()
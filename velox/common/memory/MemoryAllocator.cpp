@@ -465,6 +465,9 @@ Stats Stats::operator-(const Stats& other) const {
     result.sizes[i] = sizes[i] - other.sizes[i];
   }
   result.numAdvise = numAdvise - other.numAdvise;
+  // A gauge, not a cumulative count.
+  result.numThreadCachedPages = numThreadCachedPages;
+  result.numThreadCacheHits = numThreadCacheHits - other.numThreadCacheHits;
   return result;
 }
 
@@ -477,10 +480,13 @@ std::string Stats::toString() const {
     totalBytes += sizes[i].totalBytes;
   }
   out << fmt::format(
-      "Alloc: {}MB {} Gigaclocks, {}MB advised\n",
+      "Alloc: {}MB {} Gigaclocks, {}MB advised, {}MB thread cached, {} thread "
+      "cache hits\n",
       totalBytes >> 20,
       totalClocks >> 30,
-      numAdvise >> 8);
+      numAdvise >> 8,
+      numThreadCachedPages >> 8,
+      numThreadCacheHits);
 
   // Sort the size classes by decreasing clocks.
   std::vector<int32_t> indices(sizes.size());
@@ -138,6 +138,13 @@ struct Stats {
 
   /// Cumulative count of pages advised away, if the allocator exposes this.
   int64_t numAdvise{0};
+
+  /// Machine pages held in per-thread caches, if the allocator has them.
+  int64_t numThreadCachedPages{0};
+
+  /// Cumulative count of allocations served from per-thread caches, if the
+  /// allocator has them.
+  int64_t numThreadCacheHits{0};
 };
 
 /// This class provides interface for the actual memory allocations from memory
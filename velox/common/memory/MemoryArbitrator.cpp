@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/memory/MemoryArbitrator.h"
+
+#include <algorithm>
+
+#include "velox/common/base/SuccinctPrinter.h"
+#include "velox/common/memory/Memory.h"
+
+namespace facebook::velox::memory {
+namespace {
+// Set while the current thread runs an arbitration. A memory reservation made
+// by a reclaimer can't be arbitrated again from the same thread.
+thread_local bool tlsArbitrating{false};
+
+class ArbitrationGuard {
+ public:
+  ArbitrationGuard() {
+    tlsArbitrating = true;
+  }
+
+  ~ArbitrationGuard() {
+    tlsArbitrating = false;
+  }
+};
+} // namespace
+
+MemoryArbitrator::MemoryArbitrator(const Config& config)
+    : config_(config), freeCapacity_(config.capacity) {
+  VELOX_CHECK_GE(config_.capacity, 0);
+  VELOX_CHECK_GE(config_.initCapacity, 0);
+  VELOX_CHECK_GE(config_.minGrowCapacity, 0);
+}
+
+MemoryArbitrator::~MemoryArbitrator() {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(
+      trackers_.empty(),
+      "There are {} registered memory usage trackers on memory arbitrator destruction",
+      trackers_.size());
+}
+
+void MemoryArbitrator::registerTracker(
+    const std::shared_ptr<MemoryUsageTracker>& tracker) {
+  VELOX_CHECK_NOT_NULL(tracker);
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK_EQ(
+      trackers_.count(tracker.get()),
+      0,
+      "Memory usage tracker is already registered: {}",
+      tracker->toString());
+  VELOX_CHECK_EQ(
+      tracker->reservedBytes(),
+      0,
+      "Memory usage tracker must not have reservation on registration: {}",
+      tracker->toString());
+  const int64_t maxCapacity = tracker->maxMemory();
+  const int64_t initCapacity =
+      std::min({config_.initCapacity, maxCapacity, freeCapacity_});
+  tracker->shrinkMaxMemory(maxCapacity - initCapacity);
+  freeCapacity_ -= initCapacity;
+  trackers_.emplace(tracker.get(), std::make_pair(tracker, maxCapacity));
+  tracker->setGrowCallback(
+      [this](int64_t size, MemoryUsageTracker& requestor) {
+        return growCapacity(size, requestor);
+      });
+}
+
+void MemoryArbitrator::unregisterTracker(const MemoryUsageTracker* tracker) {
+  // A reclaimer might release the last reference to a query from the
+  // arbitration thread which already holds 'mutex_'.
+  std::unique_lock<std::mutex> l(mutex_, std::defer_lock);
+  if (!tlsArbitrating) {
+    l.lock();
+  }
+  auto it = trackers_.find(tracker);
+  if (it == trackers_.end()) {
+    return;
+  }
+  freeCapacity_ += tracker->maxMemory();
+  trackers_.erase(it);
+}
+
+bool MemoryArbitrator::growCapacity(
+    int64_t size,
+    MemoryUsageTracker& tracker) {
+  if (tlsArbitrating) {
+    // A reclaimer is reserving memory while freeing memory for another
+    // arbitration request.
+    return false;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  ArbitrationGuard guard;
+  ++stats_.numRequests;
+
+  auto it = trackers_.find(&tracker);
+  // The capacity to grow by for 'tracker' to fit 'size' more bytes on top of
+  // its current reservation.
+  const int64_t minGrowBytes = std::max<int64_t>(
+      0, tracker.reservedBytes() + size - tracker.maxMemory());
+  if (it == trackers_.end() ||
+      it->second.second - tracker.maxMemory() < minGrowBytes) {
+    ++stats_.numFailures;
+    return false;
+  }
+  const int64_t targetBytes = std::min(
+      it->second.second - tracker.maxMemory(),
+      std::max(minGrowBytes, config_.minGrowCapacity));
+
+  shrinkCapacityLocked(&tracker, targetBytes);
+  reclaimCapacityLocked(&tracker, targetBytes);
+  if (freeCapacity_ < minGrowBytes) {
+    ++stats_.numFailures;
+    return false;
+  }
+  const int64_t growBytes = std::min(targetBytes, freeCapacity_);
+  freeCapacity_ -= growBytes;
+  tracker.growMaxMemory(growBytes);
+  return true;
+}
+
+void MemoryArbitrator::shrinkCapacityLocked(
+    const MemoryUsageTracker* requestor,
+    int64_t targetBytes) {
+  for (const auto& [rawTracker, entry] : trackers_) {
+    if (freeCapacity_ >= targetBytes) {
+      return;
+    }
+    if (rawTracker == requestor) {
+      continue;
+    }
+    if (auto tracker = entry.first.lock()) {
+      const int64_t shrunkBytes =
+          tracker->shrinkMaxMemory(targetBytes - freeCapacity_);
+      freeCapacity_ += shrunkBytes;
+      stats_.shrunkBytes += shrunkBytes;
+    }
+  }
+}
+
+void MemoryArbitrator::reclaimCapacityLocked(
+    const MemoryUsageTracker* requestor,
+    int64_t targetBytes) {
+  if (freeCapacity_ >= targetBytes) {
+    return;
+  }
+
+  std::vector<Candidate> candidates;
+  for (const auto& [rawTracker, entry] : trackers_) {
+    if (rawTracker == requestor) {
+      continue;
+    }
+    auto tracker = entry.first.lock();
+    if (tracker == nullptr) {
+      continue;
+    }
+    Candidate candidate{tracker, tracker->reclaimers()};
+    for (const auto& reclaimer : candidate.reclaimers) {
+      candidate.reclaimableBytes += reclaimer->reclaimableBytes();
+    }
+    if (candidate.reclaimableBytes > 0) {
+      candidates.push_back(std::move(candidate));
+    }
+  }
+  // Reclaim from the trackers with the most reclaimable memory first to
+  // disturb as few queries as possible.
+  std::sort(
+      candidates.begin(),
+      candidates.end(),
+      [](const Candidate& lhs, const Candidate& rhs) {
+        return lhs.reclaimableBytes > rhs.reclaimableBytes;
+      });
+
+  for (auto& candidate : candidates) {
+    for (auto& reclaimer : candidate.reclaimers) {
+      ++stats_.numReclaims;
+      try {
+        reclaimer->reclaim(targetBytes - freeCapacity_);
+      } catch (const std::exception& e) {
+        VELOX_MEM_LOG(WARNING) << "Failed to reclaim memory: " << e.what();
+      }
+    }
+    if (trackers_.count(candidate.tracker.get()) == 0) {
+      // The tracker has been unregistered while reclaiming and its capacity
+      // has been taken back already.
+      continue;
+    }
+    const int64_t reclaimedBytes = candidate.tracker->shrinkMaxMemory();
+    freeCapacity_ += reclaimedBytes;
+    stats_.reclaimedBytes += reclaimedBytes;
+    if (freeCapacity_ >= targetBytes) {
+      return;
+    }
+  }
+}
+
+int64_t MemoryArbitrator::freeCapacity() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return freeCapacity_;
+}
+
+MemoryArbitrator::Stats MemoryArbitrator::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return stats_;
+}
+
+std::string MemoryArbitrator::Stats::toString() const {
+  return fmt::format(
+      "numRequests:{} numFailures:{} numReclaims:{} shrunkBytes:{} reclaimedBytes:{}",
+      numRequests,
+      numFailures,
+      numReclaims,
+      succinctBytes(shrunkBytes),
+      succinctBytes(reclaimedBytes));
+}
+
+std::string MemoryArbitrator::toString() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return fmt::format(
+      "Memory Arbitrator[capacity {} free {} trackers {} stats {}]",
+      succinctBytes(config_.capacity),
+      succinctBytes(freeCapacity_),
+      trackers_.size(),
+      stats_.toString());
+}
+} // namespace facebook::velox::memory
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "velox/common/memory/MemoryUsageTracker.h"
+
+namespace facebook::velox::memory {
+
+/// Frees memory reserved under a root memory usage tracker on request of the
+/// memory arbitrator, for example by spilling the state of the operators of a
+/// query to disk.
+class MemoryReclaimer {
+ public:
+  virtual ~MemoryReclaimer() = default;
+
+  /// Returns an estimate of the number of bytes that reclaim() can free.
+  virtual int64_t reclaimableBytes() = 0;
+
+  /// Tries to free at least 'targetBytes' of reserved memory. Returns the
+  /// number of bytes freed. This must not throw.
+  virtual int64_t reclaim(int64_t targetBytes) = 0;
+};
+
+/// Arbitrates a fixed memory capacity among the root memory usage trackers of
+/// the queries running in a process. Each registered tracker starts with a
+/// small capacity and grows on demand through its grow callback. If there is
+/// not enough free capacity to grow a tracker, the arbitrator first takes back
+/// the unused capacity of the other trackers, then asks the reclaimers of the
+/// other trackers to free memory by spilling and takes back the freed
+/// capacity. The arbitration requests are serialized.
+class MemoryArbitrator {
+ public:
+  struct Config {
+    /// The total memory capacity shared by the registered trackers.
+    int64_t capacity{kMaxMemory};
+
+    /// The capacity given to a tracker on registration, if available.
+    int64_t initCapacity{128 << 20};
+
+    /// The minimum capacity to grow a tracker by on each arbitration. This
+    /// amortizes the arbitration cost over several memory reservations.
+    int64_t minGrowCapacity{32 << 20};
+  };
+
+  struct Stats {
+    /// The number of capacity grow requests.
+    uint64_t numRequests{0};
+    /// The number of capacity grow requests that failed.
+    uint64_t numFailures{0};
+    /// The number of times a reclaimer was asked to free memory.
+    uint64_t numReclaims{0};
+    /// The capacity in bytes taken back from the unused capacity of trackers.
+    uint64_t shrunkBytes{0};
+    /// The capacity in bytes taken back from trackers after reclaiming.
+    uint64_t reclaimedBytes{0};
+
+    std::string toString() const;
+  };
+
+  explicit MemoryArbitrator(const Config& config);
+
+  ~MemoryArbitrator();
+
+  /// Registers root 'tracker' to have its memory capacity arbitrated. The
+  /// current limit of 'tracker' becomes the maximum capacity that can be
+  /// granted to it. The function sets the grow callback of 'tracker' which
+  /// must outlive the registration.
+  void registerTracker(const std::shared_ptr<MemoryUsageTracker>& tracker);
+
+  /// Unregisters 'tracker' and takes back its capacity. The call is ignored
+  /// if 'tracker' is not registered.
+  void unregisterTracker(const MemoryUsageTracker* tracker);
+
+  /// Grows the capacity of 'tracker' to fit 'size' more bytes on top of its
+  /// current reservation. Returns false if there is not enough free or
+  /// reclaimable capacity. This is invoked as the grow callback of the
+  /// registered trackers.
+  bool growCapacity(int64_t size, MemoryUsageTracker& tracker);
+
+  int64_t capacity() const {
+    return config_.capacity;
+  }
+
+  /// Returns the capacity that is not granted to any tracker.
+  int64_t freeCapacity() const;
+
+  Stats stats() const;
+
+  std::string toString() const;
+
+ private:
+  struct Candidate {
+    std::shared_ptr<MemoryUsageTracker> tracker;
+    std::vector<std::shared_ptr<MemoryReclaimer>> reclaimers;
+    int64_t reclaimableBytes{0};
+  };
+
+  // Takes back the unused capacity of trackers other than 'requestor' until
+  // 'freeCapacity_' is at least 'targetBytes'.
+  void shrinkCapacityLocked(
+      const MemoryUsageTracker* requestor,
+      int64_t targetBytes);
+
+  // Reclaims memory from trackers other than 'requestor', starting from the
+  // one with the most reclaimable memory, until 'freeCapacity_' is at least
+  // 'targetBytes'.
+  void reclaimCapacityLocked(
+      const MemoryUsageTracker* requestor,
+      int64_t targetBytes);
+
+  const Config config_;
+
+  // Serializes the arbitration requests and protects the members below.
+  mutable std::mutex mutex_;
+
+  int64_t freeCapacity_;
+
+  // The registered trackers, with the maximum capacity that can be granted to
+  // each of them.
+  std::unordered_map<
+      const MemoryUsageTracker*,
+      std::pair<std::weak_ptr<MemoryUsageTracker>, int64_t>>
+      trackers_;
+
+  Stats stats_;
+};
+} // namespace facebook::velox::memory
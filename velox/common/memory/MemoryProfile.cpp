@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/memory/MemoryProfile.h"
+
+#include <folly/json.h>
+
+#include "velox/common/time/Timer.h"
+
+namespace facebook::velox::memory {
+
+namespace {
+MemoryProfile createProfile(
+    const MemoryPool& pool,
+    const MemoryProfile* previous,
+    uint64_t timeMs) {
+  MemoryProfile profile;
+  profile.name = pool.name();
+  profile.currentBytes = pool.getCurrentBytes();
+  profile.peakBytes = pool.getMaxBytes();
+  if (const auto& tracker = pool.getMemoryUsageTracker()) {
+    profile.cumulativeBytes = tracker->cumulativeBytes();
+    profile.numAllocs = tracker->numAllocs();
+  }
+  profile.timeMs = timeMs;
+  if (previous != nullptr && timeMs > previous->timeMs) {
+    const auto allocatedBytes = std::max<int64_t>(
+        0, profile.cumulativeBytes - previous->cumulativeBytes);
+    profile.allocationBytesPerSec =
+        allocatedBytes * 1000.0 / (timeMs - previous->timeMs);
+  }
+  pool.visitChildren([&](MemoryPool* child) {
+    const MemoryProfile* previousChild = nullptr;
+    if (previous != nullptr) {
+      for (const auto& candidate : previous->children) {
+        if (candidate.name == child->name()) {
+          previousChild = &candidate;
+          break;
+        }
+      }
+    }
+    profile.children.push_back(createProfile(*child, previousChild, timeMs));
+  });
+  return profile;
+}
+} // namespace
+
+// static
+MemoryProfile MemoryProfile::create(
+    const MemoryPool& pool,
+    const MemoryProfile* previous) {
+  return createProfile(pool, previous, getCurrentTimeMs());
+}
+
+MemoryProfile* MemoryProfile::find(const std::string& poolName) {
+  if (name == poolName) {
+    return this;
+  }
+  for (auto& child : children) {
+    if (auto* found = child.find(poolName)) {
+      return found;
+    }
+  }
+  return nullptr;
+}
+
+folly::dynamic MemoryProfile::toJson() const {
+  folly::dynamic obj = folly::dynamic::object;
+  obj["name"] = name;
+  obj["currentBytes"] = currentBytes;
+  obj["peakBytes"] = peakBytes;
+  obj["cumulativeBytes"] = cumulativeBytes;
+  obj["numAllocs"] = numAllocs;
+  obj["allocationBytesPerSec"] = allocationBytesPerSec;
+  if (!components.empty()) {
+    folly::dynamic componentsObj = folly::dynamic::object;
+    for (const auto& [componentName, bytes] : components) {
+      componentsObj[componentName] = bytes;
+    }
+    obj["components"] = std::move(componentsObj);
+  }
+  if (!children.empty()) {
+    folly::dynamic childrenArray = folly::dynamic::array;
+    for (const auto& child : children) {
+      childrenArray.push_back(child.toJson());
+    }
+    obj["children"] = std::move(childrenArray);
+  }
+  return obj;
+}
+
+std::string MemoryProfile::toJsonString() const {
+  return folly::toJson(toJson());
+}
+
+} // namespace facebook::velox::memory
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/dynamic.h>
+
+#include "velox/common/memory/MemoryPool.h"
+
+namespace facebook::velox::memory {
+
+/// A snapshot of the memory usage of a MemoryPool and its subtree. Taking
+/// the snapshot reads counters the pools already maintain and does not stop
+/// the allocations in the tree.
+struct MemoryProfile {
+  std::string name;
+
+  /// Bytes allocated in the subtree at the time of the snapshot.
+  int64_t currentBytes{0};
+
+  /// The peak of 'currentBytes'.
+  int64_t peakBytes{0};
+
+  /// Sum of the sizes of all allocations and their count, if the pool has a
+  /// MemoryUsageTracker.
+  int64_t cumulativeBytes{0};
+  int64_t numAllocs{0};
+
+  /// Bytes allocated per second since the previous snapshot passed to
+  /// create(). 0 if there was no previous snapshot of the pool.
+  double allocationBytesPerSec{0};
+
+  /// Named parts of 'currentBytes' reported by the user of the pool, e.g.
+  /// the hash table and the rows of a hash join build.
+  std::vector<std::pair<std::string, int64_t>> components;
+
+  std::vector<MemoryProfile> children;
+
+  /// The time of the snapshot.
+  uint64_t timeMs{0};
+
+  /// Returns the profile of 'pool' and its subtree. If 'previous' is a
+  /// profile of the same tree, sets 'allocationBytesPerSec' from the change
+  /// in 'cumulativeBytes' of the pools with the same name.
+  static MemoryProfile create(
+      const MemoryPool& pool,
+      const MemoryProfile* previous = nullptr);
+
+  /// Returns the profile of the pool named 'poolName' in the subtree of
+  /// 'this' or nullptr if not found.
+  MemoryProfile* find(const std::string& poolName);
+
+  folly::dynamic toJson() const;
+
+  std::string toJsonString() const;
+};
+
+} // namespace facebook::velox::memory
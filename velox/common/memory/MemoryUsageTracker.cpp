@@ -25,6 +25,12 @@ DECLARE_bool(velox_memory_leak_check_enabled);
 using facebook::velox::common::testutil::TestValue;
 
 namespace facebook::velox::memory {
+namespace {
+// The quantum of the reservation increments of maybeReserve() and
+// tryReserve().
+constexpr int32_t kGrowthQuantum = 8 << 20;
+} // namespace
+
 std::shared_ptr<MemoryUsageTracker> MemoryUsageTracker::create(
     const std::shared_ptr<MemoryUsageTracker>& parent,
     bool leafTracker,
@@ -70,7 +76,10 @@ void MemoryUsageTracker::reserve(uint64_t size) {
   reserve(size, true);
 }
 
-void MemoryUsageTracker::reserve(uint64_t size, bool reserveOnly) {
+void MemoryUsageTracker::reserve(
+    uint64_t size,
+    bool reserveOnly,
+    bool allowGrow) {
   VELOX_CHECK_GT(size, 0);
 
   int32_t numAttempts = 0;
@@ -91,7 +100,7 @@ void MemoryUsageTracker::reserve(uint64_t size, bool reserveOnly) {
     }
     TestValue::adjust(
         "facebook::velox::memory::MemoryUsageTracker::reserve", this);
-    incrementReservation(increment);
+    incrementReservation(increment, allowGrow);
   }
 
   // NOTE: in case of concurrent reserve and release requests, we might see
@@ -140,7 +149,9 @@ void MemoryUsageTracker::release(uint64_t size) {
   }
 }
 
-bool MemoryUsageTracker::incrementReservation(uint64_t size) {
+bool MemoryUsageTracker::incrementReservation(
+    uint64_t size,
+    bool allowGrow) {
   VELOX_CHECK_GT(size, 0);
 
   // Update parent first. If one of the ancestor's limits are exceeded, it will
@@ -149,7 +160,7 @@ bool MemoryUsageTracker::incrementReservation(uint64_t size) {
   // makeMemoryCapExceededMessage_ is set.
   if (parent_ != nullptr) {
     try {
-      if (!parent_->incrementReservation(size)) {
+      if (!parent_->incrementReservation(size, allowGrow)) {
         return false;
       }
     } catch (const VeloxRuntimeError& e) {
@@ -170,7 +181,7 @@ bool MemoryUsageTracker::incrementReservation(uint64_t size) {
   }
   VELOX_CHECK_NULL(parent_);
 
-  if ((growCallback_ != nullptr) && growCallback_(size, *this)) {
+  if (allowGrow && (growCallback_ != nullptr) && growCallback_(size, *this)) {
     TestValue::adjust(
         "facebook::velox::memory::MemoryUsageTracker::incrementReservation::AfterGrowCallback",
         this);
@@ -188,7 +199,7 @@ bool MemoryUsageTracker::incrementReservation(uint64_t size) {
   std::lock_guard<std::mutex> l(mutex_);
   auto errorMessage = fmt::format(
       MEM_CAP_EXCEEDED_ERROR_FORMAT,
-      succinctBytes(maxMemory_),
+      succinctBytes(maxMemory_.load()),
       succinctBytes(size));
   if (makeMemoryCapExceededMessage_) {
     errorMessage += ". " + makeMemoryCapExceededMessage_(*this);
@@ -235,7 +246,6 @@ bool MemoryUsageTracker::maybeReserve(uint64_t increment) {
   reservationCheck();
   TestValue::adjust(
       "facebook::velox::memory::MemoryUsageTracker::maybeReserve", this);
-  constexpr int32_t kGrowthQuantum = 8 << 20;
   const auto reservationToAdd = bits::roundUp(increment, kGrowthQuantum);
   try {
     reserve(reservationToAdd);
@@ -245,6 +255,60 @@ bool MemoryUsageTracker::maybeReserve(uint64_t increment) {
   return true;
 }
 
+bool MemoryUsageTracker::tryReserve(uint64_t increment) {
+  reservationCheck();
+  if (increment == 0) {
+    return true;
+  }
+  const auto reservationToAdd = bits::roundUp(increment, kGrowthQuantum);
+  try {
+    ++numReserves_;
+    reserve(reservationToAdd, true, false);
+  } catch (const std::exception& e) {
+    return false;
+  }
+  return true;
+}
+
+void MemoryUsageTracker::growMaxMemory(int64_t bytes) {
+  VELOX_CHECK_NULL(parent_, "Only root tracker allows to grow memory limit");
+  VELOX_CHECK_GE(bytes, 0);
+  std::lock_guard<std::mutex> l(mutex_);
+  maxMemory_ += bytes;
+}
+
+int64_t MemoryUsageTracker::shrinkMaxMemory(int64_t targetBytes) {
+  VELOX_CHECK_NULL(parent_, "Only root tracker allows to shrink memory limit");
+  VELOX_CHECK_GE(targetBytes, 0);
+  std::lock_guard<std::mutex> l(mutex_);
+  const int64_t shrunkBytes = std::min<int64_t>(
+      targetBytes, std::max<int64_t>(0, maxMemory_ - reservationBytes_));
+  maxMemory_ -= shrunkBytes;
+  return shrunkBytes;
+}
+
+void MemoryUsageTracker::addReclaimer(
+    std::weak_ptr<MemoryReclaimer> reclaimer) {
+  VELOX_CHECK_NULL(parent_, "Only root tracker allows to add memory reclaimer");
+  std::lock_guard<std::mutex> l(mutex_);
+  reclaimers_.push_back(std::move(reclaimer));
+}
+
+std::vector<std::shared_ptr<MemoryReclaimer>> MemoryUsageTracker::reclaimers() {
+  std::vector<std::shared_ptr<MemoryReclaimer>> reclaimers;
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = reclaimers_.begin();
+  while (it != reclaimers_.end()) {
+    if (auto reclaimer = it->lock()) {
+      reclaimers.push_back(std::move(reclaimer));
+      ++it;
+    } else {
+      it = reclaimers_.erase(it);
+    }
+  }
+  return reclaimers;
+}
+
 void MemoryUsageTracker::maybeUpdatePeakBytesLocked(int64_t newPeak) {
   peakBytes_ = std::max(peakBytes_, newPeak);
 }
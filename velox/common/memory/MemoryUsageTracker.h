@@ -19,12 +19,16 @@
 #include <array>
 #include <atomic>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <vector>
 
 #include "velox/common/base/BitUtil.h"
 #include "velox/common/base/Exceptions.h"
 
 namespace facebook::velox::memory {
+class MemoryReclaimer;
+
 constexpr std::string_view MEM_CAP_EXCEEDED_ERROR_FORMAT =
     "Exceeded memory cap of {} when requesting {}";
 constexpr int64_t kMaxMemory = std::numeric_limits<int64_t>::max();
@@ -124,6 +128,11 @@ class MemoryUsageTracker
   /// the reservation increment and returns true if succeeded.
   bool maybeReserve(uint64_t increment);
 
+  /// Like maybeReserve() but only succeeds if the increment fits within the
+  /// current limit of the root tracker. Never calls the GrowCallback of the
+  /// root tracker, so it does not wait for memory arbitration.
+  bool tryReserve(uint64_t increment);
+
   /// If a minimum reservation has been set with reserve(), resets the minimum
   /// reservation. If the current usage is below the minimum reservation,
   /// decreases reservation and usage down to the rounded actual usage.
@@ -186,7 +195,7 @@ class MemoryUsageTracker
   }
 
   int64_t maxMemory() const {
-    return parent_ != nullptr ? parent_->maxMemory() : maxMemory_;
+    return parent_ != nullptr ? parent_->maxMemory() : maxMemory_.load();
   }
 
   /// Create a child memory usage tracker. 'leafTracker' indicates if the child
@@ -213,6 +222,24 @@ class MemoryUsageTracker
     makeMemoryCapExceededMessage_ = func;
   }
 
+  /// Grows the memory limit of this root tracker by 'bytes'. This is used by
+  /// the memory arbitrator to grant more memory capacity to a query.
+  void growMaxMemory(int64_t bytes);
+
+  /// Shrinks the memory limit of this root tracker by up to 'targetBytes' of
+  /// the unused capacity, that is the limit minus the current reservation.
+  /// Returns the number of bytes the limit was shrunk by. This is used by the
+  /// memory arbitrator to take back the unused memory capacity of a query.
+  int64_t shrinkMaxMemory(int64_t targetBytes = kMaxMemory);
+
+  /// Adds 'reclaimer' to free the memory reserved under this root tracker on
+  /// memory arbitration. The tracker doesn't own the reclaimer and drops it
+  /// once it has expired.
+  void addReclaimer(std::weak_ptr<MemoryReclaimer> reclaimer);
+
+  /// Returns the alive reclaimers added to this root tracker.
+  std::vector<std::shared_ptr<MemoryReclaimer>> reclaimers();
+
   /// Returns the stats of this memory usage tracker.
   Stats stats() const;
 
@@ -254,7 +281,9 @@ class MemoryUsageTracker
         toString());
   }
 
-  void reserve(uint64_t size, bool reserveOnly);
+  // If 'allowGrow' is false, does not call the root tracker's 'growCallback_'
+  // and throws if the reservation exceeds the current limit.
+  void reserve(uint64_t size, bool reserveOnly, bool allowGrow = true);
   void release(uint64_t size);
 
   void maybeUpdatePeakBytesLocked(int64_t newPeak);
@@ -265,8 +294,8 @@ class MemoryUsageTracker
   // succeeds. It returns false if there is concurrent reservation increment
   // requests and need a retry from the leaf memory usage tracker. The function
   // throws if a limit is exceeded and there is no corresponding GrowCallback or
-  // the GrowCallback fails.
-  bool incrementReservation(uint64_t size);
+  // the GrowCallback fails or 'allowGrow' is false.
+  bool incrementReservation(uint64_t size, bool allowGrow = true);
 
   // Tries to increment the reservation 'size' if it is within the limit and
   // returns true, otherwise the function returns false.
@@ -322,8 +351,9 @@ class MemoryUsageTracker
   // counters such as 'peakBytes_' and 'cumulativeBytes_'.
   mutable std::mutex mutex_;
 
-  // The memory limit in bytes to enforce.
-  int64_t maxMemory_;
+  // The memory limit in bytes to enforce. It is only changed at the root
+  // tracker by the memory arbitrator, and is read without holding 'mutex_'.
+  std::atomic<int64_t> maxMemory_;
 
   int64_t peakBytes_{0};
   int64_t cumulativeBytes_{0};
@@ -345,6 +375,10 @@ class MemoryUsageTracker
 
   MakeMemoryCapExceededMessage makeMemoryCapExceededMessage_{};
 
+  // The reclaimers to free memory under the root tracker on memory
+  // arbitration. Protected by 'mutex_'.
+  std::vector<std::weak_ptr<MemoryReclaimer>> reclaimers_;
+
   // Stats counters.
   // The number of memory allocations through update() including the failed
   // ones.
@@ -22,14 +22,31 @@
 #include "velox/common/memory/Memory.h"
 
 namespace facebook::velox::memory {
+namespace {
+// Asks the kernel to back 'bytes' from 'data' with transparent huge pages.
+// Failure is not an error, the range stays backed by default pages.
+void adviseHugePages(void* data, uint64_t bytes) {
+#ifdef MADV_HUGEPAGE
+  if (::madvise(data, bytes, MADV_HUGEPAGE) < 0) {
+    VELOX_MEM_LOG_EVERY_MS(WARNING, 1000)
+        << "madvise MADV_HUGEPAGE got errno " << folly::errnoStr(errno);
+  }
+#endif
+}
+} // namespace
+
 MmapAllocator::MmapAllocator(const Options& options)
     : kind_(MemoryAllocator::Kind::kMmap),
       useMmapArena_(options.useMmapArena),
+      useHugePages_(options.useHugePages),
       capacity_(bits::roundUp(
           options.capacity / AllocationTraits::kPageSize,
-          64 * sizeClassSizes_.back())) {
+          64 * sizeClassSizes_.back())),
+      threadCachePages_(AllocationTraits::numPages(options.threadCacheBytes)),
+      threadCaches_([this]() { return new ThreadCache(this); }) {
   for (const auto& size : sizeClassSizes_) {
-    sizeClasses_.push_back(std::make_unique<SizeClass>(capacity_ / size, size));
+    sizeClasses_.push_back(
+        std::make_unique<SizeClass>(capacity_ / size, size, useHugePages_));
   }
 
   if (useMmapArena_) {
@@ -109,8 +126,11 @@ bool MmapAllocator::allocateNonContiguous(
         AllocationTraits::pageBytes(sizeClassSizes_[mix.sizeIndices[i]]),
         mix.sizeCounts[i],
         [&]() {
-          success = sizeClasses_[mix.sizeIndices[i]]->allocate(
-              mix.sizeCounts[i], newMapsNeeded, out);
+          const auto numCached = allocateFromThreadCache(
+              mix.sizeIndices[i], mix.sizeCounts[i], out);
+          success = numCached == mix.sizeCounts[i] ||
+              sizeClasses_[mix.sizeIndices[i]]->allocate(
+                  mix.sizeCounts[i] - numCached, newMapsNeeded, out);
         });
     if (success && ((i > 0) || (mix.numSizes == 1)) &&
         testingHasInjectedFailure(InjectedFailure::kAllocate)) {
@@ -163,7 +183,11 @@ bool MmapAllocator::ensureEnoughMappedPages(int32_t newMappedNeeded) {
   }
   // We need to advise away a number of pages or we fail the alloc.
   const auto target = totalMaps - capacity_;
-  const auto numAdvised = adviseAway(target);
+  auto numAdvised = adviseAway(target);
+  if (numAdvised < target && flushThreadCaches() > 0) {
+    // The pages returned from the thread caches are mapped and free.
+    numAdvised += adviseAway(target - numAdvised);
+  }
   numAdvisedPages_ += numAdvised;
   if (numAdvised >= target) {
     numMapped_.fetch_sub(numAdvised);
@@ -180,11 +204,21 @@ int64_t MmapAllocator::freeNonContiguous(Allocation& allocation) {
 }
 
 MachinePageCount MmapAllocator::freeInternal(Allocation& allocation) {
-  MachinePageCount numFreed = 0;
   if (allocation.empty()) {
-    return numFreed;
+    return 0;
+  }
+  MachinePageCount numCached = 0;
+  if (threadCachePages_ > 0) {
+    numCached = addToThreadCache(allocation);
+    if (allocation.empty()) {
+      return numCached;
+    }
   }
+  return numCached + freeInSizeClasses(allocation);
+}
 
+MachinePageCount MmapAllocator::freeInSizeClasses(Allocation& allocation) {
+  MachinePageCount numFreed = 0;
   for (auto i = 0; i < sizeClasses_.size(); ++i) {
     auto& sizeClass = sizeClasses_[i];
     int32_t pages = 0;
@@ -207,6 +241,110 @@ MachinePageCount MmapAllocator::freeInternal(Allocation& allocation) {
   return numFreed;
 }
 
+MmapAllocator::ThreadCache::ThreadCache(MmapAllocator* _allocator)
+    : allocator(_allocator), pages(_allocator->sizeClasses_.size()) {}
+
+MmapAllocator::ThreadCache::~ThreadCache() {
+  std::lock_guard<std::mutex> l(mutex);
+  allocator->flushThreadCacheLocked(*this);
+}
+
+int32_t MmapAllocator::sizeClassIndex(uint8_t* address) const {
+  for (auto i = 0; i < sizeClasses_.size(); ++i) {
+    if (sizeClasses_[i]->isInRange(address)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+ClassPageCount MmapAllocator::allocateFromThreadCache(
+    int32_t classIndex,
+    ClassPageCount numPages,
+    Allocation& out) {
+  if (threadCachePages_ == 0) {
+    return 0;
+  }
+  auto& cache = *threadCaches_;
+  std::lock_guard<std::mutex> l(cache.mutex);
+  auto& pages = cache.pages[classIndex];
+  const ClassPageCount numTaken =
+      std::min<ClassPageCount>(numPages, pages.size());
+  if (numTaken == 0) {
+    return 0;
+  }
+  const auto unitSize = sizeClasses_[classIndex]->unitSize();
+  for (auto i = 0; i < numTaken; ++i) {
+    out.append(pages.back(), unitSize);
+    pages.pop_back();
+  }
+  cache.numPages -= numTaken * unitSize;
+  numThreadCachedPages_ -= numTaken * unitSize;
+  numThreadCacheHits_ += numTaken;
+  return numTaken;
+}
+
+MachinePageCount MmapAllocator::addToThreadCache(Allocation& allocation) {
+  auto& cache = *threadCaches_;
+  std::lock_guard<std::mutex> l(cache.mutex);
+  Allocation uncached;
+  MachinePageCount numCached = 0;
+  for (auto i = 0; i < allocation.numRuns(); ++i) {
+    const auto run = allocation.runAt(i);
+    const auto classIndex = cache.numPages + run.numPages() > threadCachePages_
+        ? -1
+        : sizeClassIndex(run.data());
+    if (classIndex < 0) {
+      uncached.append(run.data(), run.numPages());
+      continue;
+    }
+    // A run may consist of adjacent class pages.
+    const auto unitSize = sizeClasses_[classIndex]->unitSize();
+    for (MachinePageCount offset = 0; offset < run.numPages();
+         offset += unitSize) {
+      cache.pages[classIndex].push_back(
+          run.data() + AllocationTraits::pageBytes(offset));
+    }
+    cache.numPages += run.numPages();
+    numCached += run.numPages();
+  }
+  numThreadCachedPages_ += numCached;
+  allocation.clear();
+  allocation = std::move(uncached);
+  return numCached;
+}
+
+MachinePageCount MmapAllocator::flushThreadCacheLocked(ThreadCache& cache) {
+  if (cache.numPages == 0) {
+    return 0;
+  }
+  Allocation allocation;
+  for (auto i = 0; i < cache.pages.size(); ++i) {
+    const auto unitSize = sizeClasses_[i]->unitSize();
+    for (auto* page : cache.pages[i]) {
+      allocation.append(page, unitSize);
+    }
+    cache.pages[i].clear();
+  }
+  const auto numFlushed = cache.numPages;
+  cache.numPages = 0;
+  numThreadCachedPages_ -= numFlushed;
+  freeInSizeClasses(allocation);
+  return numFlushed;
+}
+
+MachinePageCount MmapAllocator::flushThreadCaches() {
+  if (threadCachePages_ == 0) {
+    return 0;
+  }
+  MachinePageCount numFlushed = 0;
+  for (auto& cache : threadCaches_.accessAllThreads()) {
+    std::lock_guard<std::mutex> l(cache.mutex);
+    numFlushed += flushThreadCacheLocked(cache);
+  }
+  return numFlushed;
+}
+
 bool MmapAllocator::allocateContiguousImpl(
     MachinePageCount numPages,
     Allocation* collateral,
@@ -331,6 +469,10 @@ bool MmapAllocator::allocateContiguousImpl(
           0);
     }
   }
+  if (useHugePages_ && data != nullptr && data != MAP_FAILED &&
+      AllocationTraits::pageBytes(numPages) >= kHugePageBytes) {
+    adviseHugePages(data, AllocationTraits::pageBytes(numPages));
+  }
   // TODO: add handling of MAP_FAILED.
   if (data == nullptr) {
     VELOX_MEM_LOG(ERROR) << "Mmap failed with " << numPages
@@ -440,7 +582,10 @@ MachinePageCount MmapAllocator::adviseAway(MachinePageCount target) {
   return numAway;
 }
 
-MmapAllocator::SizeClass::SizeClass(size_t capacity, MachinePageCount unitSize)
+MmapAllocator::SizeClass::SizeClass(
+    size_t capacity,
+    MachinePageCount unitSize,
+    bool useHugePages)
     : capacity_(capacity),
       unitSize_(unitSize),
       byteSize_(AllocationTraits::pageBytes(capacity_ * unitSize_)),
@@ -469,6 +614,9 @@ MmapAllocator::SizeClass::SizeClass(size_t capacity, MachinePageCount unitSize)
         unitSize_);
   }
   address_ = reinterpret_cast<uint8_t*>(ptr);
+  if (useHugePages && unitSize_ >= kMinHugePageClassSize) {
+    adviseHugePages(address_, byteSize_);
+  }
 }
 
 MmapAllocator::SizeClass::~SizeClass() {
@@ -860,11 +1008,13 @@ bool MmapAllocator::checkConsistency() const {
         sizeClass->checkConsistency(mapped, numErrors) * sizeClass->unitSize();
     mappedCount += mapped * sizeClass->unitSize();
   }
-  if (count != numAllocated_ - numExternalMapped_) {
+  // The pages in the thread caches are allocated in the size classes.
+  const int64_t numRecorded =
+      numAllocated_ - numExternalMapped_ + numThreadCachedPages_;
+  if (count != numRecorded) {
     ++numErrors;
     VELOX_MEM_LOG(WARNING) << "Allocated count out of sync. Actual= " << count
-                           << " recorded= "
-                           << numAllocated_ - numExternalMapped_;
+                           << " recorded= " << numRecorded;
   }
   if (mappedCount != numMapped_ - numExternalMapped_) {
     ++numErrors;
@@ -24,6 +24,8 @@
 #include <mutex>
 #include <unordered_set>
 
+#include <folly/ThreadLocal.h>
+
 #include "velox/common/base/SimdUtil.h"
 #include "velox/common/memory/MemoryAllocator.h"
 #include "velox/common/memory/MmapArena.h"
@@ -60,8 +62,30 @@ class MmapAllocator : public MemoryAllocator {
     /// Used to determine MmapArena capacity. The ratio represents system memory
     /// capacity to single MmapArena capacity ratio.
     int32_t mmapArenaCapacityRatio = 10;
+
+    /// If set true, the address ranges of the size classes of at least
+    /// kMinHugePageClassSize machine pages and the contiguous allocations of
+    /// at least kHugePageBytes are advised with MADV_HUGEPAGE, so that the
+    /// kernel backs them with transparent huge pages. This reduces the TLB
+    /// misses over large hash tables and row containers.
+    bool useHugePages = false;
+
+    /// Upper bound in bytes of the freed size class pages that each thread
+    /// keeps to allocate again without taking the locks of the size classes.
+    /// The pages return to their size classes when a thread's cache is full,
+    /// when the thread exits and when advising away free pages does not find
+    /// enough memory. 0 disables the thread caches.
+    uint64_t threadCacheBytes = 0;
   };
 
+  /// The size of a transparent huge page on x86_64 and the default aarch64
+  /// configuration.
+  static constexpr uint64_t kHugePageBytes = 2 << 20;
+
+  /// The smallest size class advised for huge pages with
+  /// Options::useHugePages. A huge page then holds at most 8 class pages.
+  static constexpr MachinePageCount kMinHugePageClassSize = 64;
+
   explicit MmapAllocator(const Options& options);
 
   ~MmapAllocator();
@@ -128,9 +152,15 @@ class MmapAllocator : public MemoryAllocator {
   Stats stats() const override {
     auto stats = stats_;
     stats.numAdvise = numAdvisedPages_;
+    stats.numThreadCachedPages = numThreadCachedPages_;
+    stats.numThreadCacheHits = numThreadCacheHits_;
     return stats;
   }
 
+  /// Returns the pages in the thread caches to their size classes. Returns
+  /// the number of machine pages returned.
+  MachinePageCount flushThreadCaches();
+
   std::string toString() const override;
 
  private:
@@ -140,7 +170,9 @@ class MmapAllocator : public MemoryAllocator {
   // 'unitSize_' machine pages.
   class SizeClass {
    public:
-    SizeClass(size_t capacity, MachinePageCount unitSize);
+    // Advises the address range for huge pages if 'useHugePages' is true and
+    // 'unitSize' is at least kMinHugePageClassSize.
+    SizeClass(size_t capacity, MachinePageCount unitSize, bool useHugePages);
 
     ~SizeClass();
 
@@ -290,6 +322,29 @@ class MmapAllocator : public MemoryAllocator {
     uint64_t numAdvisedAway_ = 0;
   };
 
+  // The size class pages a thread has freed and keeps for its next
+  // allocations. The pages stay allocated and mapped in their size classes.
+  struct ThreadCache {
+    explicit ThreadCache(MmapAllocator* allocator);
+
+    // Returns the pages to their size classes.
+    ~ThreadCache();
+
+    MmapAllocator* const allocator;
+
+    // Serializes the owning thread with flushThreadCaches().
+    std::mutex mutex;
+
+    // The addresses of the cached class pages, one vector per size class.
+    std::vector<std::vector<uint8_t*>> pages;
+
+    // The number of machine pages in 'pages'.
+    MachinePageCount numPages{0};
+  };
+
+  // Tag of 'threadCaches_' for ThreadLocal::accessAllThreads().
+  struct ThreadCacheTag {};
+
   bool allocateContiguousImpl(
       MachinePageCount numPages,
       Allocation* collateral,
@@ -311,6 +366,30 @@ class MmapAllocator : public MemoryAllocator {
   // update 'numAllocated'.
   MachinePageCount freeInternal(Allocation& allocation);
 
+  // Frees the runs of 'allocation' in their size classes and returns the
+  // number of freed pages.
+  MachinePageCount freeInSizeClasses(Allocation& allocation);
+
+  // Moves up to 'numPages' class pages of the size class at 'classIndex' from
+  // the cache of the calling thread to 'out'. Returns the number of class
+  // pages moved.
+  ClassPageCount allocateFromThreadCache(
+      int32_t classIndex,
+      ClassPageCount numPages,
+      Allocation& out);
+
+  // Moves the runs of 'allocation' into the cache of the calling thread while
+  // the cache has space. Leaves the other runs in 'allocation'. Returns the
+  // number of machine pages cached.
+  MachinePageCount addToThreadCache(Allocation& allocation);
+
+  // Returns the pages of 'cache' to their size classes. Call under
+  // cache.mutex.
+  MachinePageCount flushThreadCacheLocked(ThreadCache& cache);
+
+  // Returns the index of the size class that contains 'address' or -1.
+  int32_t sizeClassIndex(uint8_t* address) const;
+
   void markAllMapped(const Allocation& allocation);
 
   // Finds at least  'target' unallocated pages in different size classes and
@@ -324,6 +403,9 @@ class MmapAllocator : public MemoryAllocator {
   // issued for each such allocation.
   const bool useMmapArena_;
 
+  // See Options::useHugePages.
+  const bool useHugePages_;
+
   // Serializes moving capacity between size classes
   std::mutex sizeClassBalanceMutex_;
 
@@ -338,6 +420,16 @@ class MmapAllocator : public MemoryAllocator {
 
   std::vector<std::unique_ptr<SizeClass>> sizeClasses_;
 
+  // See Options::threadCacheBytes.
+  const MachinePageCount threadCachePages_;
+
+  // The number of machine pages in the thread caches. These are allocated in
+  // the size classes but not counted in 'numAllocated_'.
+  std::atomic<MachinePageCount> numThreadCachedPages_{0};
+
+  // Cumulative count of class pages allocated from the thread caches.
+  std::atomic<uint64_t> numThreadCacheHits_{0};
+
   // Statistics.
   std::atomic<uint64_t> numAllocations_ = 0;
   std::atomic<uint64_t> numAllocatedPages_ = 0;
@@ -349,6 +441,10 @@ class MmapAllocator : public MemoryAllocator {
   std::unique_ptr<ManagedMmapArenas> managedArenas_;
 
   Stats stats_;
+
+  // Declared last so that the caches of live threads return their pages
+  // while the size classes and the other members are alive.
+  folly::ThreadLocal<ThreadCache, ThreadCacheTag> threadCaches_;
 };
 
 } // namespace facebook::velox::memory
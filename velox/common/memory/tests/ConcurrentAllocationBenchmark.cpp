@@ -38,6 +38,10 @@ DEFINE_uint32(
     num_runs,
     32,
     "The number of benchmark runs and reports the average results");
+DEFINE_uint64(
+    thread_cache_bytes,
+    0,
+    "The per-thread page cache size in bytes of the mmap allocator");
 
 using namespace facebook::velox;
 using namespace facebook::velox::memory;
@@ -152,6 +156,7 @@ class MemoryAllocationBenchMark {
     uint64_t allocationBytes;
     uint32_t numThreads;
     uint32_t numOpsPerThread;
+    uint64_t threadCacheBytes;
   };
 
   explicit MemoryAllocationBenchMark(const Options& options)
@@ -161,6 +166,7 @@ class MemoryAllocationBenchMark {
       case Type::kMmap: {
         memory::MmapAllocator::Options mmapOptions;
         mmapOptions.capacity = maxMemory;
+        mmapOptions.threadCacheBytes = options_.threadCacheBytes;
         allocator_ = std::make_shared<MmapAllocator>(mmapOptions);
         manager_ = std::make_shared<MemoryManager>(IMemoryManager::Options{
             .capacity = maxMemory, .allocator = allocator_.get()});
@@ -239,6 +245,9 @@ void MemoryAllocationBenchMark::printStats() {
   LOG(INFO) << "\n\t\tSIZE\t\tTIME\t\tCLOCK\n\t\t"
             << succinctBytes(options_.allocationBytes) << "\t\t"
             << succinctMillis(avgRunTimeMs) << "\t\t" << avgClockCount;
+  if (allocator_ != nullptr) {
+    LOG(INFO) << allocator_->stats().toString();
+  }
 }
 } // namespace
 
@@ -252,6 +261,7 @@ int main(int argc, char* argv[]) {
       ? MemoryAllocationBenchMark::Type::kMalloc
       : MemoryAllocationBenchMark::Type::kMmap;
   options.numOpsPerThread = FLAGS_num_allocations_per_thread;
+  options.threadCacheBytes = FLAGS_thread_cache_bytes;
   auto benchmark = std::make_unique<MemoryAllocationBenchMark>(options);
   for (int i = 0; i < FLAGS_num_runs; ++i) {
     benchmark->run();
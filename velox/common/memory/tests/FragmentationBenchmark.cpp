@@ -25,10 +25,16 @@
 #include "folly/Random.h"
 
 #include "velox/common/memory/MmapAllocator.h"
+#include "velox/common/time/Timer.h"
 
 DEFINE_int64(volume_gb, 2048, "Total GB to allocate during test");
 DEFINE_int64(size_cap_gb, 24, "Size cap: total GB resident at one time");
 DEFINE_bool(use_mmap, true, "Use mmap and madvise to manage fragmentation");
+DEFINE_bool(
+    use_huge_pages,
+    false,
+    "Advise the large size classes and contiguous allocations of the mmap "
+    "allocator for transparent huge pages");
 
 using namespace facebook::velox;
 using namespace facebook::velox::memory;
@@ -150,6 +156,7 @@ class FragmentationTest {
   void initMemory(size_t sizeCap) {
     MmapAllocator::Options options;
     options.capacity = sizeCap + (64 << 20);
+    options.useHugePages = FLAGS_use_huge_pages;
     memory_ = std::make_shared<MmapAllocator>(options);
   }
 
@@ -201,7 +208,12 @@ int main(int argc, char* argv[]) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
   auto test = std::make_unique<FragmentationTest>();
   test->SetUp();
-  test->run(FLAGS_volume_gb << 30, FLAGS_size_cap_gb << 30, FLAGS_use_mmap);
+  uint64_t micros = 0;
+  {
+    MicrosecondTimer timer(&micros);
+    test->run(FLAGS_volume_gb << 30, FLAGS_size_cap_gb << 30, FLAGS_use_mmap);
+  }
   test->printStats();
+  std::cout << "Time: " << micros / 1000 << " ms" << std::endl;
   return 0;
 }
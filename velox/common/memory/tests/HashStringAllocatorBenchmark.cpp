@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+#include <vector>
+
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include "velox/common/memory/ByteStream.h"
+#include "velox/common/memory/HashStringAllocator.h"
+
+// Measures the time and the memory efficiency of HashStringAllocator under
+// the allocation patterns of aggregates. After the timed runs, runs each
+// workload once more with allocation statistics and prints the footprint at
+// the peak of the workload and the histograms of allocation sizes, free list
+// lengths and free list search steps.
+
+DEFINE_int32(num_groups, 10'000, "Number of accumulators in each workload");
+DEFINE_int32(values_per_group, 32, "Number of values added per accumulator");
+DEFINE_int32(max_string_size, 200, "Maximum size of the string keys");
+DEFINE_bool(
+    append_only,
+    false,
+    "Use an append-only HashStringAllocator, see "
+    "QueryConfig::kAggregationAppendOnlyStrings");
+
+using namespace facebook::velox;
+
+namespace {
+
+struct Footprint {
+  int64_t liveBytes{0};
+  int64_t retainedBytes{0};
+  int64_t freeBytes{0};
+};
+
+Footprint footprint(const HashStringAllocator& allocator) {
+  return {
+      static_cast<int64_t>(allocator.cumulativeBytes()),
+      allocator.retainedSize(),
+      static_cast<int64_t>(allocator.freeSpace())};
+}
+
+// Appends 8 byte values to a multipart value per group, like the ValueList of
+// array_agg.
+Footprint arrayAgg(HashStringAllocator& allocator) {
+  constexpr int32_t kInitialSize = 44;
+  constexpr int32_t kReserve = 16;
+  struct Group {
+    HashStringAllocator::Position start{nullptr, nullptr};
+    HashStringAllocator::Position current{nullptr, nullptr};
+  };
+  std::vector<Group> groups(FLAGS_num_groups);
+  for (auto round = 0; round < FLAGS_values_per_group; ++round) {
+    for (auto& group : groups) {
+      ByteStream stream(&allocator);
+      if (group.start.header == nullptr) {
+        group.start = allocator.newWrite(stream, kInitialSize);
+      } else {
+        allocator.extendWrite(group.current, stream);
+      }
+      stream.appendOne<int64_t>(round);
+      group.current = allocator.finishWrite(stream, kReserve);
+    }
+  }
+  auto result = footprint(allocator);
+  for (auto& group : groups) {
+    allocator.free(group.start.header);
+  }
+  return result;
+}
+
+// Allocates string keys and values of skewed sizes and replaces a quarter of
+// them in each round, like map_agg over strings or min_by/max_by over
+// changing strings.
+Footprint stringChurn(HashStringAllocator& allocator) {
+  folly::Random::DefaultGenerator rng(1);
+  auto randomSize = [&]() {
+    // Most strings are short, some are up to 'max_string_size'.
+    return folly::Random::oneIn(8, rng)
+        ? 1 + folly::Random::rand32(FLAGS_max_string_size, rng)
+        : 1 + folly::Random::rand32(16, rng);
+  };
+  std::vector<HashStringAllocator::Header*> strings(FLAGS_num_groups);
+  for (auto& string : strings) {
+    string = allocator.allocate(randomSize());
+  }
+  for (auto round = 0; round < FLAGS_values_per_group; ++round) {
+    for (auto i = 0; i < strings.size() / 4; ++i) {
+      auto& string = strings[folly::Random::rand32(strings.size(), rng)];
+      allocator.free(string);
+      string = allocator.allocate(randomSize());
+    }
+  }
+  auto result = footprint(allocator);
+  for (auto* string : strings) {
+    allocator.free(string);
+  }
+  return result;
+}
+
+// Grows a std::vector per group through StlAllocator, like the accumulators
+// of set_agg and approx_percentile.
+Footprint stlGrowth(HashStringAllocator& allocator) {
+  using Vector = std::vector<int64_t, StlAllocator<int64_t>>;
+  std::vector<Vector> groups(
+      FLAGS_num_groups, Vector(StlAllocator<int64_t>(&allocator)));
+  for (auto round = 0; round < FLAGS_values_per_group; ++round) {
+    for (auto& group : groups) {
+      group.push_back(round);
+    }
+  }
+  auto result = footprint(allocator);
+  groups.clear();
+  return result;
+}
+
+struct Workload {
+  const char* name;
+  Footprint (*run)(HashStringAllocator&);
+};
+
+const std::vector<Workload>& workloads() {
+  static const std::vector<Workload> kWorkloads = {
+      {"arrayAgg", arrayAgg},
+      {"stringChurn", stringChurn},
+      {"stlGrowth", stlGrowth}};
+  return kWorkloads;
+}
+
+void runWorkload(const Workload& workload, uint32_t iters) {
+  auto pool = memory::getDefaultMemoryPool();
+  for (auto i = 0; i < iters; ++i) {
+    HashStringAllocator allocator(pool.get(), FLAGS_append_only);
+    folly::doNotOptimizeAway(workload.run(allocator));
+  }
+}
+
+void printHistogram(
+    const char* name,
+    const HashStringAllocator::Histogram& histogram) {
+  if (histogram.metric.count == 0) {
+    return;
+  }
+  std::cout << "  " << name << ": count " << histogram.metric.count
+            << ", avg " << histogram.metric.sum / histogram.metric.count
+            << ", max " << histogram.metric.max << std::endl;
+  for (auto i = 0; i < HashStringAllocator::Histogram::kNumBuckets; ++i) {
+    if (histogram.counts[i] != 0) {
+      std::cout << "    >= " << (1L << i) << ": " << histogram.counts[i]
+                << std::endl;
+    }
+  }
+}
+
+void printReport() {
+  auto pool = memory::getDefaultMemoryPool();
+  for (const auto& workload : workloads()) {
+    HashStringAllocator allocator(pool.get(), FLAGS_append_only);
+    allocator.setTrackStats(true);
+    const auto peak = workload.run(allocator);
+    std::cout << workload.name << ": live " << peak.liveBytes
+              << " bytes, retained " << peak.retainedBytes << " bytes, free "
+              << peak.freeBytes << " bytes, efficiency "
+              << (peak.retainedBytes > 0
+                      ? 100 * peak.liveBytes / peak.retainedBytes
+                      : 100)
+              << "%, new slabs " << allocator.stats()->numNewSlabs
+              << std::endl;
+    printHistogram("allocation size", allocator.stats()->allocationSizes);
+    printHistogram("free list length", allocator.stats()->freeListLengths);
+    printHistogram("search steps", allocator.stats()->searchSteps);
+  }
+}
+} // namespace
+
+BENCHMARK(arrayAgg, iters) {
+  runWorkload(workloads()[0], iters);
+}
+
+BENCHMARK(stringChurn, iters) {
+  runWorkload(workloads()[1], iters);
+}
+
+BENCHMARK(stlGrowth, iters) {
+  runWorkload(workloads()[2], iters);
+}
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  printReport();
+  return 0;
+}
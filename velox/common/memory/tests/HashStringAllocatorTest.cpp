@@ -159,6 +159,54 @@ TEST_F(HashStringAllocatorTest, multipart) {
   instance_->checkConsistency();
 }
 
+TEST_F(HashStringAllocatorTest, appendOnly) {
+  HashStringAllocator appendOnly(pool_.get(), true);
+  ASSERT_TRUE(appendOnly.isAppendOnly());
+
+  // Small allocations are not padded for free list pointers.
+  auto first = appendOnly.allocate(5);
+  EXPECT_EQ(8, first->size());
+  auto second = appendOnly.allocate(100);
+  EXPECT_EQ(100, second->size());
+  EXPECT_EQ(first->end(), reinterpret_cast<char*>(second));
+
+  // Strings are copied back to back, each with a header.
+  std::vector<std::string> strings;
+  std::vector<StringView> views;
+  for (auto i = 0; i < 10'000; ++i) {
+    strings.push_back(randomString());
+  }
+  for (const auto& string : strings) {
+    views.push_back(StringView(string));
+  }
+  for (auto i = 0; i < views.size(); ++i) {
+    appendOnly.copyMultipart(reinterpret_cast<char*>(&views[i]), 0);
+  }
+  appendOnly.checkConsistency();
+  int64_t totalBytes = 0;
+  std::string storage;
+  for (auto i = 0; i < views.size(); ++i) {
+    totalBytes += strings[i].size();
+    EXPECT_EQ(
+        StringView(strings[i]),
+        HashStringAllocator::contiguousString(views[i], storage));
+  }
+  EXPECT_LE(appendOnly.retainedSize(), totalBytes + totalBytes / 10);
+
+  // Freeing updates the accounting but does not reuse the memory.
+  const auto freeSpace = appendOnly.freeSpace();
+  const auto cumulativeBytes = appendOnly.cumulativeBytes();
+  appendOnly.free(second);
+  EXPECT_EQ(cumulativeBytes - 100, appendOnly.cumulativeBytes());
+  EXPECT_EQ(freeSpace, appendOnly.freeSpace());
+  EXPECT_NE(second, appendOnly.allocate(100));
+  appendOnly.checkConsistency();
+
+  appendOnly.clear();
+  EXPECT_EQ(0, appendOnly.retainedSize());
+  EXPECT_EQ(0, appendOnly.freeSpace());
+}
+
 TEST_F(HashStringAllocatorTest, rewrite) {
   ByteStream stream(instance_.get());
   auto header = instance_->allocate(5);
@@ -323,3 +371,48 @@ TEST_F(HashStringAllocatorTest, stlAllocatorOverflow) {
   AlignedStlAllocator<int64_t, 16> alignedAlloc(instance_.get());
   EXPECT_THROW(alignedAlloc.allocate(1ULL << 62), VeloxException);
 }
+
+TEST_F(HashStringAllocatorTest, stats) {
+  ASSERT_EQ(nullptr, instance_->stats());
+  instance_->setTrackStats(true);
+
+  std::vector<HashStringAllocator::Header*> headers;
+  for (auto i = 0; i < 1'000; ++i) {
+    headers.push_back(allocate(100));
+  }
+  // Free every other block so that smaller allocations search the free list.
+  for (auto i = 0; i < headers.size(); i += 2) {
+    instance_->free(headers[i]);
+  }
+  for (auto i = 0; i < 500; ++i) {
+    allocate(40);
+  }
+  instance_->checkConsistency();
+
+  const auto* stats = instance_->stats();
+  ASSERT_NE(nullptr, stats);
+  ASSERT_EQ(1'500, stats->allocationSizes.metric.count);
+  ASSERT_EQ(1'000, stats->allocationSizes.counts[6]);
+  ASSERT_EQ(500, stats->allocationSizes.counts[5]);
+  ASSERT_GE(stats->searchSteps.metric.count, 1'500);
+  ASSERT_GE(stats->searchSteps.metric.min, 1);
+  ASSERT_GT(stats->freeListLengths.metric.max, 100);
+  ASSERT_GT(stats->numNewSlabs, 0);
+
+  std::unordered_map<std::string, RuntimeMetric> runtimeStats;
+  stats->addRuntimeStats("hsa.", runtimeStats);
+  ASSERT_EQ(1'500, runtimeStats.at("hsa.allocationSize").count);
+  ASSERT_EQ(100, runtimeStats.at("hsa.allocationSize").max);
+  ASSERT_EQ(1'000, runtimeStats.at("hsa.allocationSizeBucket64").sum);
+  ASSERT_EQ(500, runtimeStats.at("hsa.allocationSizeBucket32").sum);
+  ASSERT_EQ(0, runtimeStats.count("hsa.allocationSizeBucket128"));
+  ASSERT_EQ(stats->numNewSlabs, runtimeStats.at("hsa.numNewSlabs").sum);
+  ASSERT_EQ(1, runtimeStats.count("hsa.searchSteps"));
+  ASSERT_EQ(1, runtimeStats.count("hsa.freeListLength"));
+
+  // The stats survive clear() and are dropped when tracking stops.
+  instance_->clear();
+  ASSERT_EQ(1'500, instance_->stats()->allocationSizes.metric.count);
+  instance_->setTrackStats(false);
+  ASSERT_EQ(nullptr, instance_->stats());
+}
@@ -1220,6 +1220,77 @@ class MmapArenaTest : public testing::Test {
   folly::Random::DefaultGenerator rng_;
 };
 
+TEST(MmapAllocatorTest, hugePages) {
+  MmapAllocator::Options options;
+  options.capacity = 256 << 20;
+  options.useHugePages = true;
+  MmapAllocator allocator(options);
+
+  // Pages of the largest size class and a contiguous allocation larger than a
+  // huge page.
+  Allocation allocation;
+  const auto largestClassSize = allocator.sizeClasses().back();
+  ASSERT_TRUE(
+      allocator.allocateNonContiguous(16 * largestClassSize, allocation));
+  ContiguousAllocation contiguous;
+  const auto numContiguousPages =
+      2 * MmapAllocator::kHugePageBytes / AllocationTraits::kPageSize;
+  ASSERT_TRUE(
+      allocator.allocateContiguous(numContiguousPages, nullptr, contiguous));
+  for (int32_t i = 0; i < allocation.numRuns(); ++i) {
+    auto run = allocation.runAt(i);
+    std::memset(run.data(), 1, AllocationTraits::pageBytes(run.numPages()));
+  }
+  std::memset(contiguous.data(), 1, contiguous.size());
+  ASSERT_TRUE(allocator.checkConsistency());
+
+  allocator.freeNonContiguous(allocation);
+  allocator.freeContiguous(contiguous);
+  ASSERT_EQ(allocator.numAllocated(), 0);
+  ASSERT_TRUE(allocator.checkConsistency());
+}
+
+TEST(MmapAllocatorTest, threadCache) {
+  MmapAllocator::Options options;
+  options.capacity = 256 << 20;
+  options.threadCacheBytes = 1 << 20;
+  MmapAllocator allocator(options);
+  const auto cachePages = AllocationTraits::numPages(options.threadCacheBytes);
+
+  // The freed pages stay in the cache of this thread up to its limit.
+  Allocation allocation;
+  ASSERT_TRUE(allocator.allocateNonContiguous(4 * cachePages, allocation));
+  allocator.freeNonContiguous(allocation);
+  ASSERT_EQ(allocator.numAllocated(), 0);
+  auto stats = allocator.stats();
+  ASSERT_GT(stats.numThreadCachedPages, 0);
+  ASSERT_LE(stats.numThreadCachedPages, cachePages);
+  ASSERT_TRUE(allocator.checkConsistency());
+
+  // The next allocation takes pages from the cache.
+  ASSERT_TRUE(allocator.allocateNonContiguous(cachePages, allocation));
+  stats = allocator.stats();
+  ASSERT_GT(stats.numThreadCacheHits, 0);
+  ASSERT_TRUE(allocator.checkConsistency());
+  allocator.freeNonContiguous(allocation);
+
+  // Pages freed by another thread go to the cache of that thread and return
+  // to the size classes when the thread exits.
+  const auto numCached = allocator.stats().numThreadCachedPages;
+  std::thread([&]() {
+    Allocation threadAllocation;
+    ASSERT_TRUE(allocator.allocateNonContiguous(cachePages, threadAllocation));
+    allocator.freeNonContiguous(threadAllocation);
+  }).join();
+  ASSERT_EQ(allocator.stats().numThreadCachedPages, numCached);
+  ASSERT_TRUE(allocator.checkConsistency());
+
+  ASSERT_EQ(allocator.flushThreadCaches(), numCached);
+  ASSERT_EQ(allocator.stats().numThreadCachedPages, 0);
+  ASSERT_EQ(allocator.numAllocated(), 0);
+  ASSERT_TRUE(allocator.checkConsistency());
+}
+
 TEST_F(MmapArenaTest, basic) {
   // 0 Byte lower bound for revealing edge cases.
   const uint64_t kAllocLowerBound = 0;
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/memory/MemoryArbitrator.h"
+
+using namespace ::testing;
+using namespace ::facebook::velox::memory;
+using namespace ::facebook::velox;
+
+namespace {
+constexpr int64_t kMB = 1 << 20;
+
+// Frees all the memory of 'tracker' on reclaim, then invokes
+// 'reclaimCallback' if set.
+class FakeReclaimer : public MemoryReclaimer {
+ public:
+  explicit FakeReclaimer(
+      std::shared_ptr<MemoryUsageTracker> tracker,
+      std::function<void()> reclaimCallback = nullptr)
+      : tracker_(std::move(tracker)),
+        reclaimCallback_(std::move(reclaimCallback)) {}
+
+  int64_t reclaimableBytes() override {
+    return tracker_->currentBytes();
+  }
+
+  int64_t reclaim(int64_t /*targetBytes*/) override {
+    ++numReclaims_;
+    const int64_t bytes = tracker_->currentBytes();
+    tracker_->update(-bytes);
+    if (reclaimCallback_ != nullptr) {
+      reclaimCallback_();
+    }
+    return bytes;
+  }
+
+  int32_t numReclaims() const {
+    return numReclaims_;
+  }
+
+ private:
+  const std::shared_ptr<MemoryUsageTracker> tracker_;
+  const std::function<void()> reclaimCallback_;
+  int32_t numReclaims_{0};
+};
+
+MemoryArbitrator::Config makeConfig(int64_t capacity) {
+  MemoryArbitrator::Config config;
+  config.capacity = capacity;
+  config.initCapacity = 64 * kMB;
+  config.minGrowCapacity = 32 * kMB;
+  return config;
+}
+} // namespace
+
+TEST(MemoryArbitratorTest, registration) {
+  MemoryArbitrator arbitrator(makeConfig(256 * kMB));
+  auto tracker1 = MemoryUsageTracker::create();
+  arbitrator.registerTracker(tracker1);
+  ASSERT_EQ(tracker1->maxMemory(), 64 * kMB);
+  ASSERT_EQ(arbitrator.freeCapacity(), 192 * kMB);
+  VELOX_ASSERT_THROW(
+      arbitrator.registerTracker(tracker1),
+      "Memory usage tracker is already registered");
+
+  // The initial capacity is capped by the tracker limit.
+  auto tracker2 = MemoryUsageTracker::create(32 * kMB);
+  arbitrator.registerTracker(tracker2);
+  ASSERT_EQ(tracker2->maxMemory(), 32 * kMB);
+  ASSERT_EQ(arbitrator.freeCapacity(), 160 * kMB);
+
+  arbitrator.unregisterTracker(tracker1.get());
+  arbitrator.unregisterTracker(tracker2.get());
+  ASSERT_EQ(arbitrator.freeCapacity(), 256 * kMB);
+  // Unregistering an unknown tracker is ignored.
+  arbitrator.unregisterTracker(tracker2.get());
+  ASSERT_EQ(arbitrator.freeCapacity(), 256 * kMB);
+}
+
+TEST(MemoryArbitratorTest, grow) {
+  MemoryArbitrator arbitrator(makeConfig(256 * kMB));
+  auto tracker = MemoryUsageTracker::create();
+  arbitrator.registerTracker(tracker);
+  auto leaf = tracker->addChild();
+
+  leaf->update(96 * kMB);
+  ASSERT_EQ(tracker->maxMemory(), 96 * kMB);
+  // The capacity grows by at least 'minGrowCapacity'.
+  leaf->update(8 * kMB);
+  ASSERT_EQ(tracker->maxMemory(), 128 * kMB);
+  ASSERT_EQ(arbitrator.freeCapacity(), 128 * kMB);
+  ASSERT_EQ(arbitrator.stats().numRequests, 2);
+  ASSERT_EQ(arbitrator.stats().numFailures, 0);
+
+  // The capacity can't grow beyond the limit of the tracker on registration.
+  auto limitedTracker = MemoryUsageTracker::create(96 * kMB);
+  arbitrator.registerTracker(limitedTracker);
+  auto limitedLeaf = limitedTracker->addChild();
+  VELOX_ASSERT_THROW(limitedLeaf->update(104 * kMB), "Exceeded memory cap");
+  ASSERT_EQ(limitedTracker->maxMemory(), 64 * kMB);
+  ASSERT_EQ(arbitrator.stats().numFailures, 1);
+
+  leaf->update(-104 * kMB);
+  arbitrator.unregisterTracker(tracker.get());
+  arbitrator.unregisterTracker(limitedTracker.get());
+  ASSERT_EQ(arbitrator.freeCapacity(), 256 * kMB);
+}
+
+TEST(MemoryArbitratorTest, shrinkUnusedCapacity) {
+  MemoryArbitrator arbitrator(makeConfig(128 * kMB));
+  auto tracker1 = MemoryUsageTracker::create();
+  auto tracker2 = MemoryUsageTracker::create();
+  arbitrator.registerTracker(tracker1);
+  arbitrator.registerTracker(tracker2);
+  ASSERT_EQ(arbitrator.freeCapacity(), 0);
+
+  auto leaf1 = tracker1->addChild();
+  leaf1->update(96 * kMB);
+  ASSERT_EQ(tracker1->maxMemory(), 96 * kMB);
+  ASSERT_EQ(tracker2->maxMemory(), 32 * kMB);
+  ASSERT_EQ(arbitrator.stats().shrunkBytes, 32 * kMB);
+  ASSERT_EQ(arbitrator.stats().numReclaims, 0);
+
+  leaf1->update(-96 * kMB);
+  arbitrator.unregisterTracker(tracker1.get());
+  arbitrator.unregisterTracker(tracker2.get());
+  ASSERT_EQ(arbitrator.freeCapacity(), 128 * kMB);
+}
+
+TEST(MemoryArbitratorTest, reclaim) {
+  MemoryArbitrator arbitrator(makeConfig(128 * kMB));
+  auto tracker1 = MemoryUsageTracker::create();
+  auto tracker2 = MemoryUsageTracker::create();
+  arbitrator.registerTracker(tracker1);
+  arbitrator.registerTracker(tracker2);
+  auto leaf1 = tracker1->addChild();
+  auto leaf2 = tracker2->addChild();
+  leaf2->update(64 * kMB);
+
+  auto reclaimer = std::make_shared<FakeReclaimer>(leaf2);
+  tracker2->addReclaimer(reclaimer);
+  leaf1->update(96 * kMB);
+  ASSERT_EQ(reclaimer->numReclaims(), 1);
+  ASSERT_EQ(tracker1->maxMemory(), 96 * kMB);
+  ASSERT_EQ(tracker2->maxMemory(), 0);
+  ASSERT_EQ(arbitrator.freeCapacity(), 32 * kMB);
+  const auto stats = arbitrator.stats();
+  ASSERT_EQ(stats.numReclaims, 1);
+  ASSERT_EQ(stats.reclaimedBytes, 64 * kMB);
+  ASSERT_EQ(stats.numFailures, 0);
+
+  // An expired reclaimer is dropped.
+  reclaimer.reset();
+  ASSERT_TRUE(tracker2->reclaimers().empty());
+
+  leaf1->update(-96 * kMB);
+  arbitrator.unregisterTracker(tracker1.get());
+  arbitrator.unregisterTracker(tracker2.get());
+  ASSERT_EQ(arbitrator.freeCapacity(), 128 * kMB);
+}
+
+TEST(MemoryArbitratorTest, reclaimFailure) {
+  MemoryArbitrator arbitrator(makeConfig(128 * kMB));
+  auto tracker1 = MemoryUsageTracker::create();
+  auto tracker2 = MemoryUsageTracker::create();
+  arbitrator.registerTracker(tracker1);
+  arbitrator.registerTracker(tracker2);
+  auto leaf1 = tracker1->addChild();
+  auto leaf2 = tracker2->addChild();
+  leaf2->update(64 * kMB);
+
+  // A reclaimer can't grow the capacity of its own tracker while
+  // reclaiming, and a failed reclaim doesn't fail the arbitration request.
+  auto reclaimer = std::make_shared<FakeReclaimer>(
+      leaf2, [&]() { leaf2->update(72 * kMB); });
+  tracker2->addReclaimer(reclaimer);
+  leaf1->update(96 * kMB);
+  ASSERT_EQ(reclaimer->numReclaims(), 1);
+  ASSERT_EQ(tracker1->maxMemory(), 96 * kMB);
+  ASSERT_EQ(arbitrator.stats().numFailures, 0);
+
+  // Nothing is left to reclaim.
+  VELOX_ASSERT_THROW(leaf1->update(64 * kMB), "Exceeded memory cap");
+  ASSERT_EQ(arbitrator.stats().numFailures, 1);
+
+  leaf1->update(-96 * kMB);
+  arbitrator.unregisterTracker(tracker1.get());
+  arbitrator.unregisterTracker(tracker2.get());
+  ASSERT_EQ(arbitrator.freeCapacity(), 128 * kMB);
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <folly/json.h>
+
+#include "velox/common/memory/Memory.h"
+#include "velox/common/memory/MemoryProfile.h"
+
+using namespace facebook::velox::memory;
+
+TEST(MemoryProfileTest, tree) {
+  MemoryManager manager{};
+  auto root = manager.getPool("root");
+  auto aggregate = root->addChild("aggregate", MemoryPool::Kind::kAggregate);
+  auto leaf = aggregate->addChild("leaf");
+  constexpr int64_t kSize = 1 << 20;
+  void* buffer = leaf->allocate(kSize);
+
+  auto profile = MemoryProfile::create(*root);
+  ASSERT_EQ(profile.name, "root");
+  ASSERT_EQ(profile.children.size(), 1);
+  auto* leafProfile = profile.find("leaf");
+  ASSERT_NE(leafProfile, nullptr);
+  ASSERT_EQ(leafProfile->currentBytes, kSize);
+  ASSERT_EQ(leafProfile->peakBytes, kSize);
+  ASSERT_EQ(leafProfile->numAllocs, 1);
+  ASSERT_EQ(leafProfile->cumulativeBytes, kSize);
+  ASSERT_EQ(leafProfile->allocationBytesPerSec, 0);
+  ASSERT_EQ(profile.find("aggregate")->currentBytes, kSize);
+  ASSERT_EQ(profile.find("nosuchpool"), nullptr);
+
+  leaf->free(buffer, kSize);
+  buffer = leaf->allocate(2 * kSize);
+  // Make the time between the snapshots non-zero.
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  auto next = MemoryProfile::create(*root, &profile);
+  leafProfile = next.find("leaf");
+  ASSERT_EQ(leafProfile->currentBytes, 2 * kSize);
+  ASSERT_EQ(leafProfile->peakBytes, 2 * kSize);
+  ASSERT_EQ(leafProfile->numAllocs, 2);
+  ASSERT_EQ(leafProfile->cumulativeBytes, 3 * kSize);
+  ASSERT_GT(leafProfile->allocationBytesPerSec, 0);
+
+  leafProfile->components.emplace_back("buffer", 2 * kSize);
+  auto json = folly::parseJson(next.toJsonString());
+  ASSERT_EQ(json["name"].asString(), "root");
+  const auto& leafJson = json["children"][0]["children"][0];
+  ASSERT_EQ(leafJson["name"].asString(), "leaf");
+  ASSERT_EQ(leafJson["currentBytes"].asInt(), 2 * kSize);
+  ASSERT_EQ(leafJson["components"]["buffer"].asInt(), 2 * kSize);
+  leaf->free(buffer, 2 * kSize);
+}
@@ -500,6 +500,38 @@ TEST_F(MemoryUsageTrackerTest, maybeReserve) {
   ASSERT_EQ(stats.numCollisions, 0);
 }
 
+TEST_F(MemoryUsageTrackerTest, tryReserve) {
+  constexpr int64_t kMB = 1 << 20;
+  auto parent = memory::MemoryUsageTracker::create(16 * kMB);
+  int32_t numGrows = 0;
+  parent->setGrowCallback([&](int64_t size, MemoryUsageTracker& tracker) {
+    ++numGrows;
+    tracker.growMaxMemory(size);
+    return true;
+  });
+  auto child = parent->addChild(true);
+  // Fits within the current limit.
+  ASSERT_TRUE(child->tryReserve(kMB));
+  ASSERT_EQ(child->availableReservation(), 8 * kMB);
+  ASSERT_EQ(parent->currentBytes(), 8 * kMB);
+
+  // Exceeds the current limit and doesn't call the grow callback. The
+  // existing reservation is unchanged.
+  ASSERT_FALSE(child->tryReserve(24 * kMB));
+  ASSERT_EQ(numGrows, 0);
+  ASSERT_EQ(child->availableReservation(), 8 * kMB);
+  ASSERT_EQ(parent->maxMemory(), 16 * kMB);
+
+  // maybeReserve() grows the limit.
+  ASSERT_TRUE(child->maybeReserve(24 * kMB));
+  ASSERT_EQ(numGrows, 1);
+  ASSERT_EQ(child->availableReservation(), 24 * kMB);
+  ASSERT_EQ(parent->maxMemory(), 32 * kMB);
+  child->release();
+  ASSERT_EQ(parent->currentBytes(), 0);
+  ASSERT_EQ(child->stats().numReserves, 3);
+}
+
 TEST_F(MemoryUsageTrackerTest, validCheck) {
   constexpr int64_t kMB = 1 << 20;
   auto parent = memory::MemoryUsageTracker::create(10 * kMB);
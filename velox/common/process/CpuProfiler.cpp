@@ -0,0 +1,388 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/process/CpuProfiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+#include <fmt/format.h>
+#include <folly/experimental/symbolizer/StackTrace.h>
+#include <glog/logging.h>
+
+#ifdef __linux__
+#include <signal.h>
+#include <sys/time.h>
+#endif
+
+#include "velox/common/process/StackTrace.h"
+
+namespace facebook::velox::process {
+
+namespace {
+
+constexpr int32_t kNumTagFields = 4;
+
+// A sample as recorded by the signal handler, which can't allocate.
+struct RawSample {
+  int32_t numFrames;
+  uintptr_t frames[CpuProfiler::kMaxFrames];
+  char tagFields[kNumTagFields][CpuProfiler::kMaxTagFieldSize + 1];
+};
+
+struct ProfilerState {
+  // Serializes start() and stop().
+  std::mutex mutex;
+  bool handlerInstalled{false};
+  std::unique_ptr<RawSample[]> samples;
+  int64_t maxSamples{0};
+  std::atomic<int64_t> numSamples{0};
+  std::atomic<bool> running{false};
+  // Number of threads inside the signal handler. stop() waits for this to
+  // drop to 0 before reading 'samples'.
+  std::atomic<int32_t> numInHandler{0};
+};
+
+ProfilerState& profilerState() {
+  static ProfilerState* state = new ProfilerState();
+  return *state;
+}
+
+void copyTagField(const std::string& field, char* out) {
+  const auto size =
+      std::min<size_t>(field.size(), CpuProfiler::kMaxTagFieldSize);
+  memcpy(out, field.data(), size);
+  out[size] = '\0';
+}
+
+#ifdef __linux__
+// The frames of the signal handler and of the signal trampoline.
+constexpr int32_t kHandlerFrames = 2;
+
+void onSigprof(int /*signal*/) {
+  auto& state = profilerState();
+  ++state.numInHandler;
+  const auto savedErrno = errno;
+  if (state.running) {
+    const auto index = state.numSamples++;
+    if (index < state.maxSamples) {
+      auto& sample = state.samples[index];
+      uintptr_t frames[CpuProfiler::kMaxFrames + kHandlerFrames];
+      const auto numFrames = std::max<ssize_t>(
+          0,
+          folly::symbolizer::getStackTraceSafe(
+              frames, CpuProfiler::kMaxFrames + kHandlerFrames) -
+              kHandlerFrames);
+      memcpy(
+          sample.frames,
+          frames + kHandlerFrames,
+          numFrames * sizeof(uintptr_t));
+      sample.numFrames = numFrames;
+      if (const auto* tag = threadTag()) {
+        copyTagField(tag->queryId, sample.tagFields[0]);
+        copyTagField(tag->taskId, sample.tagFields[1]);
+        copyTagField(tag->planNodeId, sample.tagFields[2]);
+        copyTagField(tag->operatorType, sample.tagFields[3]);
+      } else {
+        for (auto i = 0; i < kNumTagFields; ++i) {
+          sample.tagFields[i][0] = '\0';
+        }
+      }
+    }
+  }
+  errno = savedErrno;
+  --state.numInHandler;
+}
+#endif
+
+// Minimal protobuf encoder for the messages of profile.proto.
+class ProtoWriter {
+ public:
+  void varint(uint64_t value) {
+    while (value >= 0x80) {
+      out_.push_back(static_cast<char>(value | 0x80));
+      value >>= 7;
+    }
+    out_.push_back(static_cast<char>(value));
+  }
+
+  // Writes a varint field. Omitted if 0, as proto3 does.
+  void intField(int32_t field, uint64_t value) {
+    if (value != 0) {
+      varint(field << 3);
+      varint(value);
+    }
+  }
+
+  void bytesField(int32_t field, std::string_view value) {
+    varint((field << 3) | 2);
+    varint(value.size());
+    out_.append(value.data(), value.size());
+  }
+
+  void packedField(int32_t field, const std::vector<uint64_t>& values) {
+    ProtoWriter packed;
+    for (auto value : values) {
+      packed.varint(value);
+    }
+    bytesField(field, packed.str());
+  }
+
+  const std::string& str() const {
+    return out_;
+  }
+
+ private:
+  std::string out_;
+};
+
+// The string table of a pprof profile. The first string must be empty.
+class StringTable {
+ public:
+  StringTable() {
+    index("");
+  }
+
+  uint64_t index(const std::string& value) {
+    auto it = indices_.find(value);
+    if (it != indices_.end()) {
+      return it->second;
+    }
+    indices_[value] = strings_.size();
+    strings_.push_back(value);
+    return strings_.size() - 1;
+  }
+
+  const std::vector<std::string>& strings() const {
+    return strings_;
+  }
+
+ private:
+  std::unordered_map<std::string, uint64_t> indices_;
+  std::vector<std::string> strings_;
+};
+
+std::string symbolize(void* address) {
+  return StackTrace::translateFrame(address, false);
+}
+} // namespace
+
+// static
+bool CpuProfiler::start(int32_t frequencyHz, int32_t maxSamples) {
+#ifdef __linux__
+  auto& state = profilerState();
+  std::lock_guard<std::mutex> l(state.mutex);
+  if (state.running || frequencyHz <= 0 || maxSamples <= 0) {
+    return false;
+  }
+  // The handler stays installed after stop() since a SIGPROF may still be
+  // pending and the default action terminates the process.
+  if (!state.handlerInstalled) {
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = onSigprof;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, nullptr) != 0) {
+      LOG(WARNING) << "Failed to install the SIGPROF handler: "
+                   << strerror(errno);
+      return false;
+    }
+    state.handlerInstalled = true;
+  }
+  state.samples = std::make_unique<RawSample[]>(maxSamples);
+  state.maxSamples = maxSamples;
+  state.numSamples = 0;
+  state.running = true;
+
+  const int64_t periodMicros = std::max(1, 1'000'000 / frequencyHz);
+  struct itimerval timer;
+  timer.it_interval.tv_sec = periodMicros / 1'000'000;
+  timer.it_interval.tv_usec = periodMicros % 1'000'000;
+  timer.it_value = timer.it_interval;
+  if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+    LOG(WARNING) << "Failed to start the profiling timer: " << strerror(errno);
+    state.running = false;
+    state.samples.reset();
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+// static
+std::vector<CpuProfiler::Sample> CpuProfiler::stop() {
+  std::vector<Sample> samples;
+#ifdef __linux__
+  auto& state = profilerState();
+  std::lock_guard<std::mutex> l(state.mutex);
+  if (!state.running) {
+    return samples;
+  }
+  struct itimerval timer;
+  memset(&timer, 0, sizeof(timer));
+  setitimer(ITIMER_PROF, &timer, nullptr);
+  state.running = false;
+  while (state.numInHandler > 0) {
+    std::this_thread::yield();
+  }
+
+  const auto numSamples = std::min(state.numSamples.load(), state.maxSamples);
+  samples.resize(numSamples);
+  for (auto i = 0; i < numSamples; ++i) {
+    const auto& raw = state.samples[i];
+    auto& sample = samples[i];
+    sample.frames.reserve(raw.numFrames);
+    for (auto j = 0; j < raw.numFrames; ++j) {
+      sample.frames.push_back(reinterpret_cast<void*>(raw.frames[j]));
+    }
+    sample.tag.queryId = raw.tagFields[0];
+    sample.tag.taskId = raw.tagFields[1];
+    sample.tag.planNodeId = raw.tagFields[2];
+    sample.tag.operatorType = raw.tagFields[3];
+  }
+  state.samples.reset();
+#endif
+  return samples;
+}
+
+// static
+bool CpuProfiler::isRunning() {
+  return profilerState().running;
+}
+
+// static
+std::string CpuProfiler::toPprof(
+    const std::vector<Sample>& samples,
+    int32_t frequencyHz) {
+  StringTable strings;
+  ProtoWriter profile;
+  auto valueType = [&](const std::string& type, const std::string& unit) {
+    ProtoWriter message;
+    message.intField(1, strings.index(type));
+    message.intField(2, strings.index(unit));
+    return message.str();
+  };
+  const uint64_t periodNanos = 1'000'000'000 / std::max(1, frequencyHz);
+
+  // Profile.sample_type.
+  profile.bytesField(1, valueType("samples", "count"));
+  profile.bytesField(1, valueType("cpu", "nanoseconds"));
+
+  // Location ids, starting at 1, in the order of first occurrence.
+  std::unordered_map<void*, uint64_t> locationIds;
+  std::vector<void*> addresses;
+  for (const auto& sample : samples) {
+    std::vector<uint64_t> ids;
+    ids.reserve(sample.frames.size());
+    for (auto* frame : sample.frames) {
+      auto it = locationIds.emplace(frame, addresses.size() + 1);
+      if (it.second) {
+        addresses.push_back(frame);
+      }
+      ids.push_back(it.first->second);
+    }
+    ProtoWriter message;
+    message.packedField(1, ids);
+    message.packedField(2, {1, periodNanos});
+    const std::pair<const char*, const std::string*> labels[] = {
+        {"query", &sample.tag.queryId},
+        {"task", &sample.tag.taskId},
+        {"planNode", &sample.tag.planNodeId},
+        {"operator", &sample.tag.operatorType}};
+    for (const auto& [key, value] : labels) {
+      if (value->empty()) {
+        continue;
+      }
+      ProtoWriter label;
+      label.intField(1, strings.index(key));
+      label.intField(2, strings.index(*value));
+      message.bytesField(3, label.str());
+    }
+    // Profile.sample.
+    profile.bytesField(2, message.str());
+  }
+
+  // One function per location, named after the symbolized frame.
+  for (size_t i = 0; i < addresses.size(); ++i) {
+    const uint64_t id = i + 1;
+    ProtoWriter line;
+    line.intField(1, id);
+    ProtoWriter location;
+    location.intField(1, id);
+    location.intField(3, reinterpret_cast<uint64_t>(addresses[i]));
+    location.bytesField(4, line.str());
+    // Profile.location.
+    profile.bytesField(4, location.str());
+
+    ProtoWriter function;
+    function.intField(1, id);
+    function.intField(2, strings.index(symbolize(addresses[i])));
+    // Profile.function.
+    profile.bytesField(5, function.str());
+  }
+
+  // Profile.period_type and Profile.period.
+  profile.bytesField(11, valueType("cpu", "nanoseconds"));
+  profile.intField(12, periodNanos);
+
+  // Profile.string_table goes last, after all strings are known.
+  for (const auto& string : strings.strings()) {
+    profile.bytesField(6, string);
+  }
+  return profile.str();
+}
+
+// static
+std::string CpuProfiler::toFoldedStacks(const std::vector<Sample>& samples) {
+  std::unordered_map<void*, std::string> names;
+  std::map<std::string, int64_t> counts;
+  for (const auto& sample : samples) {
+    auto stack = sample.tag.toString();
+    for (auto it = sample.frames.rbegin(); it != sample.frames.rend(); ++it) {
+      auto nameIt = names.find(*it);
+      if (nameIt == names.end()) {
+        auto name = symbolize(*it);
+        // ';' separates the frames and the last ' ' precedes the count.
+        std::replace(name.begin(), name.end(), ';', ':');
+        nameIt = names.emplace(*it, std::move(name)).first;
+      }
+      if (!stack.empty()) {
+        stack += ';';
+      }
+      stack += nameIt->second;
+    }
+    ++counts[stack.empty() ? "[unknown]" : stack];
+  }
+
+  std::string out;
+  for (const auto& [stack, count] : counts) {
+    out += fmt::format("{} {}\n", stack, count);
+  }
+  return out;
+}
+
+} // namespace facebook::velox::process
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "velox/common/process/ThreadTag.h"
+
+namespace facebook::velox::process {
+
+/// In-process sampling CPU profiler. Interrupts the threads that consume CPU
+/// with SIGPROF at a fixed frequency of process CPU time and records the stack
+/// and the ThreadTag of the interrupted thread, so that CPU is attributed to
+/// the queries, tasks, plan nodes and operators running on a worker. Only one
+/// profile can be collected at a time. Supported on Linux only.
+class CpuProfiler {
+ public:
+  struct Sample {
+    /// Return addresses, innermost frame first.
+    std::vector<void*> frames;
+
+    /// The tag of the thread when sampled. Fields longer than
+    /// kMaxTagFieldSize are truncated.
+    ThreadTag tag;
+  };
+
+  static constexpr int32_t kMaxFrames = 64;
+  static constexpr int32_t kMaxTagFieldSize = 63;
+
+  /// Starts sampling 'frequencyHz' times per second of CPU time. Keeps at most
+  /// 'maxSamples' samples. Returns false if a profile is being collected or if
+  /// profiling is not supported.
+  static bool start(int32_t frequencyHz = 99, int32_t maxSamples = 100'000);
+
+  /// Stops sampling and returns the samples collected since start(). Returns
+  /// no samples if not started.
+  static std::vector<Sample> stop();
+
+  static bool isRunning();
+
+  /// Serializes 'samples' as an uncompressed pprof profile (profile.proto).
+  /// The values are the sample count and the CPU time, 'frequencyHz' being the
+  /// sampling frequency. The non-empty fields of the tags become the 'query',
+  /// 'task', 'planNode' and 'operator' labels of the samples, so that 'pprof
+  /// -tagroot=query,planNode' shows them as the root frames.
+  static std::string toPprof(
+      const std::vector<Sample>& samples,
+      int32_t frequencyHz);
+
+  /// Returns one line per distinct stack in the folded format consumed by
+  /// flame graph tools, e.g. 'query;task;planNode;operator;main;...;leaf 12'.
+  static std::string toFoldedStacks(const std::vector<Sample>& samples);
+};
+
+} // namespace facebook::velox::process
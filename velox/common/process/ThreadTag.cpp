@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/process/ThreadTag.h"
+
+#include <atomic>
+
+namespace facebook::velox::process {
+
+namespace {
+thread_local const ThreadTag* currentTag{nullptr};
+} // namespace
+
+std::string ThreadTag::toString() const {
+  std::string result;
+  for (const auto* field : {&queryId, &taskId, &planNodeId, &operatorType}) {
+    if (field->empty()) {
+      continue;
+    }
+    if (!result.empty()) {
+      result += ';';
+    }
+    result += *field;
+  }
+  return result;
+}
+
+const ThreadTag* threadTag() {
+  return currentTag;
+}
+
+void setThreadTag(const ThreadTag* tag) {
+  currentTag = tag;
+  // A profiling signal handler running on this thread must see the new tag.
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+} // namespace facebook::velox::process
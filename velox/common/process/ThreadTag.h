@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+
+#include <folly/CPortability.h>
+
+namespace facebook::velox::process {
+
+/// Identifies the query, task, plan node and operator on whose behalf a thread
+/// is running. The Driver sets the tag of the operator around each call into
+/// it, so that CPU samples can be attributed to queries and plan nodes. See
+/// CpuProfiler.
+struct ThreadTag {
+  std::string queryId;
+  std::string taskId;
+  std::string planNodeId;
+  std::string operatorType;
+
+  /// Returns the non-empty fields separated by ';', outermost first, as used
+  /// for the root frames of folded stacks.
+  std::string toString() const;
+};
+
+/// Returns the tag of the calling thread or nullptr if none is set.
+const ThreadTag* FOLLY_NULLABLE threadTag();
+
+void setThreadTag(const ThreadTag* FOLLY_NULLABLE tag);
+
+/// Sets the tag of the calling thread for the lifetime of the guard and
+/// restores the previous one on destruction. 'tag' must outlive the guard.
+class ThreadTagScopeGuard {
+ public:
+  explicit ThreadTagScopeGuard(const ThreadTag* FOLLY_NULLABLE tag)
+      : prevTag_(threadTag()) {
+    setThreadTag(tag);
+  }
+
+  ~ThreadTagScopeGuard() {
+    setThreadTag(prevTag_);
+  }
+
+ private:
+  const ThreadTag* FOLLY_NULLABLE const prevTag_;
+};
+
+} // namespace facebook::velox::process
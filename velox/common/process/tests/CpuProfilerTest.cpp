@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/process/CpuProfiler.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+
+using namespace facebook::velox::process;
+
+namespace {
+// Spins on the CPU for 'millis' of wall time.
+void burnCpu(int32_t millis) {
+  const auto start = std::chrono::steady_clock::now();
+  volatile uint64_t counter = 0;
+  while (std::chrono::steady_clock::now() - start <
+         std::chrono::milliseconds(millis)) {
+    counter = counter + 1;
+  }
+}
+} // namespace
+
+TEST(CpuProfilerTest, threadTag) {
+  ASSERT_EQ(nullptr, threadTag());
+  ThreadTag outer{"query", "task", "0", "TableScan"};
+  ThreadTag inner{"query", "task", "1", "FilterProject"};
+  {
+    ThreadTagScopeGuard outerGuard(&outer);
+    ASSERT_EQ(&outer, threadTag());
+    {
+      ThreadTagScopeGuard innerGuard(&inner);
+      ASSERT_EQ(&inner, threadTag());
+    }
+    ASSERT_EQ(&outer, threadTag());
+  }
+  ASSERT_EQ(nullptr, threadTag());
+
+  ASSERT_EQ("query;task;1;FilterProject", inner.toString());
+  ThreadTag partial{"query", "", "", "TableScan"};
+  ASSERT_EQ("query;TableScan", partial.toString());
+}
+
+#ifdef __linux__
+TEST(CpuProfilerTest, samples) {
+  ASSERT_TRUE(CpuProfiler::start(1'000));
+  ASSERT_TRUE(CpuProfiler::isRunning());
+  ASSERT_FALSE(CpuProfiler::start(1'000));
+
+  ThreadTag tag{"query", "task", "1", "FilterProject"};
+  {
+    ThreadTagScopeGuard guard(&tag);
+    burnCpu(200);
+  }
+  auto samples = CpuProfiler::stop();
+  ASSERT_FALSE(CpuProfiler::isRunning());
+  ASSERT_FALSE(samples.empty());
+
+  int32_t numTagged = 0;
+  for (const auto& sample : samples) {
+    if (sample.tag.planNodeId == "1") {
+      ASSERT_EQ("query", sample.tag.queryId);
+      ASSERT_EQ("FilterProject", sample.tag.operatorType);
+      ++numTagged;
+    }
+  }
+  ASSERT_GT(numTagged, 0);
+
+  const auto folded = CpuProfiler::toFoldedStacks(samples);
+  ASSERT_NE(std::string::npos, folded.find("query;task;1;FilterProject"));
+
+  const auto pprof = CpuProfiler::toPprof(samples, 1'000);
+  ASSERT_FALSE(pprof.empty());
+  ASSERT_NE(std::string::npos, pprof.find("planNode"));
+  ASSERT_NE(std::string::npos, pprof.find("FilterProject"));
+
+  // Nothing is collected after stop().
+  ASSERT_TRUE(CpuProfiler::stop().empty());
+}
+#endif
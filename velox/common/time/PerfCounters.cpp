@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/time/PerfCounters.h"
+
+#include <glog/logging.h>
+#include <iterator>
+#include <memory>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace facebook::velox {
+
+#ifdef __linux__
+namespace {
+struct PerfEvent {
+  uint32_t type;
+  uint64_t config;
+};
+
+constexpr uint64_t kDtlbReadMiss = PERF_COUNT_HW_CACHE_DTLB |
+    (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+    (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+// In the order of PerfCounterValues.
+constexpr PerfEvent kEvents[] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HW_CACHE, kDtlbReadMiss},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+int openEvent(const PerfEvent& event, int groupFd) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = event.type;
+  attr.config = event.config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  // Counts the calling thread on whichever CPU it runs.
+  return syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0);
+}
+} // namespace
+
+PerfCounters::~PerfCounters() {
+  for (auto fd : fds_) {
+    if (fd != -1) {
+      ::close(fd);
+    }
+  }
+}
+
+bool PerfCounters::open() {
+  static_assert(std::size(kEvents) == kNumEvents);
+  for (auto i = 0; i < kNumEvents; ++i) {
+    const int fd = openEvent(kEvents[i], fds_[0]);
+    if (fd == -1) {
+      if (i == 0) {
+        LOG_FIRST_N(WARNING, 1)
+            << "Hardware performance counters are not available: "
+            << strerror(errno);
+        return false;
+      }
+      continue;
+    }
+    fds_[i] = fd;
+    positions_[i] = numOpened_++;
+  }
+  return true;
+}
+
+PerfCounterValues PerfCounters::read() const {
+  // The group read returns the number of events followed by their values.
+  std::array<uint64_t, kNumEvents + 1> buffer{};
+  if (::read(fds_[0], buffer.data(), sizeof(buffer)) <= 0) {
+    return {};
+  }
+  auto value = [&](int32_t event) -> uint64_t {
+    return positions_[event] == -1 ? 0 : buffer[1 + positions_[event]];
+  };
+  return {value(0), value(1), value(2), value(3), value(4)};
+}
+#else
+PerfCounters::~PerfCounters() = default;
+
+bool PerfCounters::open() {
+  return false;
+}
+
+PerfCounterValues PerfCounters::read() const {
+  return {};
+}
+#endif
+
+// static
+PerfCounters* PerfCounters::forThread() {
+  thread_local std::unique_ptr<PerfCounters> counters;
+  thread_local bool opened = false;
+  if (!opened) {
+    opened = true;
+    std::unique_ptr<PerfCounters> newCounters(new PerfCounters());
+    if (newCounters->open()) {
+      counters = std::move(newCounters);
+    }
+  }
+  return counters.get();
+}
+
+} // namespace facebook::velox
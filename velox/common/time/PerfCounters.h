@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <fmt/format.h>
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace facebook::velox {
+
+// Hardware event counts of a thread in user mode, e.g. for the duration of an
+// operation.
+struct PerfCounterValues {
+  uint64_t cycles = 0;
+  uint64_t instructions = 0;
+  // Last level cache misses.
+  uint64_t llcMisses = 0;
+  // Data TLB read misses.
+  uint64_t dtlbMisses = 0;
+  uint64_t branchMisses = 0;
+
+  void add(const PerfCounterValues& other) {
+    cycles += other.cycles;
+    instructions += other.instructions;
+    llcMisses += other.llcMisses;
+    dtlbMisses += other.dtlbMisses;
+    branchMisses += other.branchMisses;
+  }
+
+  // Returns the counts since 'start'.
+  PerfCounterValues since(const PerfCounterValues& start) const {
+    return {
+        cycles - start.cycles,
+        instructions - start.instructions,
+        llcMisses - start.llcMisses,
+        dtlbMisses - start.dtlbMisses,
+        branchMisses - start.branchMisses};
+  }
+
+  std::string toString() const {
+    return fmt::format(
+        "cycles: {}, instructions: {}, llcMisses: {}, dtlbMisses: {}, "
+        "branchMisses: {}",
+        cycles,
+        instructions,
+        llcMisses,
+        dtlbMisses,
+        branchMisses);
+  }
+};
+
+// Group of perf_event hardware counters of the calling thread. The counters
+// run from when they are opened until the thread exits and are read from
+// user space with a single system call.
+class PerfCounters {
+ public:
+  ~PerfCounters();
+
+  // Returns the counters of the calling thread, opening them on the first
+  // call. Returns nullptr if the counters can't be opened, e.g. when not on
+  // Linux, when perf_event_open() is not permitted or when the CPU has no
+  // cycle counter. The result must only be used on the calling thread.
+  static PerfCounters* forThread();
+
+  // Returns the current counts. Events the CPU does not support read as 0.
+  // All events read as 0 while the kernel can't schedule them together on
+  // the PMU.
+  PerfCounterValues read() const;
+
+ private:
+  static constexpr int32_t kNumEvents = 5;
+
+  PerfCounters() = default;
+
+  // Opens the events. Returns false if the leader can't be opened.
+  bool open();
+
+  // File descriptor of each event in the order of PerfCounterValues, -1 if
+  // not opened. The first is the group leader.
+  std::array<int, kNumEvents> fds_{-1, -1, -1, -1, -1};
+
+  // Position of each event in the group read, -1 if not opened.
+  std::array<int32_t, kNumEvents> positions_{-1, -1, -1, -1, -1};
+
+  int32_t numOpened_{0};
+};
+
+// Reads the counters of the calling thread at construction and destruction
+// and passes the counts in between to the user callback.
+template <typename F>
+class DeltaPerfCounters {
+ public:
+  DeltaPerfCounters(const PerfCounters& counters, F&& func)
+      : counters_(counters),
+        start_(counters.read()),
+        func_(std::move(func)) {}
+
+  ~DeltaPerfCounters() {
+    func_(counters_.read().since(start_));
+  }
+
+ private:
+  const PerfCounters& counters_;
+  const PerfCounterValues start_;
+  F func_;
+};
+
+} // namespace facebook::velox
@@ -43,6 +43,26 @@ class MicrosecondTimer {
   uint64_t* FOLLY_NONNULL timer_;
 };
 
+// Same as MicrosecondTimer but increments the counter with the elapsed time in
+// nanoseconds.
+class NanosecondTimer {
+ public:
+  explicit NanosecondTimer(uint64_t* FOLLY_NONNULL timer) : timer_(timer) {
+    start_ = std::chrono::steady_clock::now();
+  }
+
+  ~NanosecondTimer() {
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start_);
+
+    (*timer_) += duration.count();
+  }
+
+ private:
+  std::chrono::steady_clock::time_point start_;
+  uint64_t* FOLLY_NONNULL timer_;
+};
+
 // Measures the time between construction and destruction with
 // CPU clock counter (rdtsc on X86) and increments a user-supplied counter
 // with the cycle count.
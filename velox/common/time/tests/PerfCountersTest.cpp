@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <thread>
+
+#include "velox/common/time/PerfCounters.h"
+
+using namespace facebook::velox;
+
+namespace facebook::velox::test {
+
+TEST(PerfCountersTest, values) {
+  PerfCounterValues start{10, 20, 3, 2, 1};
+  PerfCounterValues end{110, 320, 5, 4, 11};
+  const auto delta = end.since(start);
+  EXPECT_EQ(100, delta.cycles);
+  EXPECT_EQ(300, delta.instructions);
+  EXPECT_EQ(2, delta.llcMisses);
+  EXPECT_EQ(2, delta.dtlbMisses);
+  EXPECT_EQ(10, delta.branchMisses);
+
+  start.add(delta);
+  EXPECT_EQ(end.toString(), start.toString());
+  EXPECT_EQ(
+      "cycles: 110, instructions: 320, llcMisses: 5, dtlbMisses: 4, "
+      "branchMisses: 11",
+      end.toString());
+}
+
+TEST(PerfCountersTest, deltaPerfCounters) {
+  auto* counters = PerfCounters::forThread();
+  if (counters == nullptr) {
+    GTEST_SKIP() << "Hardware performance counters are not available";
+  }
+  // The same counters are returned on the same thread.
+  EXPECT_EQ(counters, PerfCounters::forThread());
+
+  PerfCounterValues total;
+  volatile uint64_t sum = 0;
+  {
+    DeltaPerfCounters delta(
+        *counters, [&](const PerfCounterValues& counts) { total.add(counts); });
+    for (auto i = 0; i < 1'000'000; ++i) {
+      sum += i;
+    }
+  }
+  // The kernel may not schedule the counters, e.g. under virtualization.
+  if (total.cycles > 0) {
+    EXPECT_GT(total.instructions, 1'000'000);
+  }
+
+  // Another thread gets its own counters.
+  PerfCounters* otherCounters;
+  std::thread([&]() { otherCounters = PerfCounters::forThread(); }).join();
+  EXPECT_NE(counters, otherCounters);
+}
+
+} // namespace facebook::velox::test
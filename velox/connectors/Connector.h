@@ -55,6 +55,13 @@ struct ConnectorSplit {
   virtual std::string toString() const {
     return fmt::format("[split: {}]", connectorId);
   }
+
+  /// Returns the bucket of the table the data of the split belongs to, if
+  /// the table is bucketed. In grouped execution, splits added without a
+  /// split group go to the split group of their bucket.
+  virtual std::optional<int32_t> bucketNumber() const {
+    return std::nullopt;
+  }
 };
 
 class ColumnHandle {
@@ -162,6 +169,14 @@ class DataSource {
     return false;
   }
 
+  // Returns false if there is no memory budget for prefetching the data of
+  // more splits, e.g. if the cache the source reads through is filled with
+  // prefetched data that has not been read yet. The caller should then not
+  // start preloading further splits.
+  virtual bool canPrefetch() const {
+    return true;
+  }
+
   // Initializes this from 'source'. 'source' is effectively moved
   // into 'this' Adaptation like dynamic filters stay in effect but
   // the parts dealing with open files, prefetched data etc. are moved. 'source'
@@ -179,6 +194,15 @@ class DataSource {
   virtual int64_t estimatedRowSize() {
     return kUnknownRowSize;
   }
+
+  // Gives up a part of the current split that has not been read yet and
+  // returns a split for reading it, e.g. the remaining stripes of a file.
+  // After this, 'this' reads the rest of its split only. Returns nullptr if
+  // the split can't be divided further. Lets idle drivers of a scan take
+  // over work from a driver that got a large split.
+  virtual std::shared_ptr<ConnectorSplit> splitRemaining() {
+    return nullptr;
+  }
 };
 
 // Exposes expression evaluation functionality of the engine to the
@@ -325,6 +349,14 @@ class Connector {
     return false;
   }
 
+  /// Divides 'split' into splits that can be read in parallel by different
+  /// drivers, for example by the byte ranges of a large file. Returns 'split'
+  /// as is by default.
+  virtual std::vector<std::shared_ptr<ConnectorSplit>> divideSplit(
+      const std::shared_ptr<ConnectorSplit>& split) {
+    return {split};
+  }
+
   virtual std::shared_ptr<DataSink> createDataSink(
       RowTypePtr inputType,
       std::shared_ptr<ConnectorInsertTableHandle> connectorInsertTableHandle,
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/connectors/hive/DecodedDataCache.h"
+
+namespace facebook::velox::connector::hive {
+
+DecodedDataCache::DecodedDataCache(
+    uint64_t maxBytes,
+    std::shared_ptr<memory::MemoryPool> pool)
+    : maxBytes_(maxBytes), pool_(std::move(pool)), cache_(maxBytes) {
+  VELOX_CHECK_NOT_NULL(pool_);
+}
+
+// static
+std::string DecodedDataCache::makeKey(
+    const std::string& filePath,
+    uint64_t start,
+    uint64_t length,
+    const std::string& columnKey) {
+  return fmt::format("{}:{}:{}:{}", filePath, start, length, columnKey);
+}
+
+std::optional<std::vector<VectorPtr>> DecodedDataCache::find(
+    const std::string& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  ++numLookups_;
+  auto* entry = cache_.get(key);
+  if (entry == nullptr) {
+    return std::nullopt;
+  }
+  ++numHits_;
+  auto batches = entry->batches;
+  cache_.release(key);
+  return batches;
+}
+
+bool DecodedDataCache::insert(
+    const std::string& key,
+    const std::vector<VectorPtr>& batches) {
+  // Copy outside of the lock. The copies are flat and do not reference the
+  // memory of the query that read them.
+  auto entry = std::make_unique<Entry>();
+  entry->batches.reserve(batches.size());
+  uint64_t size = 0;
+  for (const auto& batch : batches) {
+    auto copy = BaseVector::create(batch->type(), batch->size(), pool_.get());
+    copy->copy(batch.get(), 0, 0, batch->size());
+    size += copy->retainedSize();
+    if (size > maxEntryBytes()) {
+      return false;
+    }
+    entry->batches.push_back(std::move(copy));
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  if (!cache_.add(key, entry.get(), size)) {
+    return false;
+  }
+  // The cache owns the entry now.
+  entry.release();
+  ++numInserts_;
+  return true;
+}
+
+DecodedDataCache::Stats DecodedDataCache::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return {numLookups_, numHits_, numInserts_, cache_.currentSize()};
+}
+
+} // namespace facebook::velox::connector::hive
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#pragma once
+
+#include <mutex>
+
+#include "velox/common/caching/SimpleLRUCache.h"
+#include "velox/vector/BaseVector.h"
+
+namespace facebook::velox::connector::hive {
+
+/// Caches the decoded vectors of the columns of splits so that repeat scans
+/// of small, frequently read tables skip reading, decompressing and decoding
+/// the file. An entry is keyed on the file, the range of the split and the
+/// column with its required subfields, and holds the batches read for the
+/// column in order. The vectors are copied into a memory pool of the cache
+/// on insertion and are shared with the readers of the entry, which must not
+/// modify them. Only splits read without filters are cached since the
+/// filters decide which rows are in the batches. Thread-safe.
+class DecodedDataCache {
+ public:
+  struct Stats {
+    uint64_t numLookups{0};
+    uint64_t numHits{0};
+    uint64_t numInserts{0};
+    uint64_t cachedBytes{0};
+  };
+
+  /// Creates a cache of at most 'maxBytes' of vectors allocated from 'pool'.
+  DecodedDataCache(uint64_t maxBytes, std::shared_ptr<memory::MemoryPool> pool);
+
+  /// Returns the key of the entry for the column described by 'columnKey' in
+  /// the split over [start, start + length) of 'filePath'.
+  static std::string makeKey(
+      const std::string& filePath,
+      uint64_t start,
+      uint64_t length,
+      const std::string& columnKey);
+
+  /// Returns the batches of 'key' or std::nullopt if 'key' is not cached.
+  std::optional<std::vector<VectorPtr>> find(const std::string& key);
+
+  /// Copies 'batches' into the cache under 'key'. Returns false if 'key' is
+  /// already cached or the copy does not fit.
+  bool insert(const std::string& key, const std::vector<VectorPtr>& batches);
+
+  /// The maximum size of the batches of one split and column. Larger columns
+  /// are not worth evicting several other entries for.
+  uint64_t maxEntryBytes() const {
+    return maxBytes_ / 16;
+  }
+
+  Stats stats() const;
+
+ private:
+  struct Entry {
+    std::vector<VectorPtr> batches;
+  };
+
+  const uint64_t maxBytes_;
+  const std::shared_ptr<memory::MemoryPool> pool_;
+
+  mutable std::mutex mutex_;
+  SimpleLRUCache<std::string, Entry> cache_;
+  uint64_t numLookups_{0};
+  uint64_t numHits_{0};
+  uint64_t numInserts_{0};
+};
+
+} // namespace facebook::velox::connector::hive
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/connectors/hive/DeleteFilter.h"
+
+#include <algorithm>
+
+namespace facebook::velox::connector::hive {
+
+void PositionalDeletes::finish() {
+  std::sort(positions_.begin(), positions_.end());
+  nextPosition_ = 0;
+}
+
+const uint64_t* PositionalDeletes::deletedRows(
+    int64_t rowNumber,
+    uint64_t numRows) {
+  while (nextPosition_ < positions_.size() &&
+         positions_[nextPosition_] < rowNumber) {
+    ++nextPosition_;
+  }
+  const int64_t end = rowNumber + numRows;
+  if (nextPosition_ == positions_.size() ||
+      positions_[nextPosition_] >= end) {
+    return nullptr;
+  }
+  bits_.assign(bits::nwords(numRows), 0);
+  for (auto i = nextPosition_;
+       i < positions_.size() && positions_[i] < end;
+       ++i) {
+    bits::setBit(bits_.data(), positions_[i] - rowNumber);
+  }
+  return bits_.data();
+}
+
+void EqualityDeletes::addRows(const RowVectorPtr& keys) {
+  VELOX_CHECK_EQ(keys->childrenSize(), channels_.size());
+  std::vector<VectorPtr> columns;
+  std::vector<const BaseVector*> rawColumns;
+  for (auto& child : keys->children()) {
+    columns.push_back(BaseVector::loadedVectorShared(child));
+    rawColumns.push_back(columns.back().get());
+  }
+  const uint32_t batch = batches_.size();
+  for (vector_size_t row = 0; row < keys->size(); ++row) {
+    rows_.emplace(hashRow(rawColumns, row), std::make_pair(batch, row));
+  }
+  batches_.push_back(std::move(columns));
+}
+
+vector_size_t EqualityDeletes::removeDeleted(
+    const RowVector& input,
+    vector_size_t* rows,
+    vector_size_t numRows) const {
+  if (rows_.empty()) {
+    return numRows;
+  }
+  std::vector<const BaseVector*> columns;
+  columns.reserve(channels_.size());
+  for (auto channel : channels_) {
+    columns.push_back(input.childAt(channel)->loadedVector());
+  }
+  vector_size_t numPassed = 0;
+  for (vector_size_t i = 0; i < numRows; ++i) {
+    const auto row = rows[i];
+    auto range = rows_.equal_range(hashRow(columns, row));
+    const bool deleted =
+        std::any_of(range.first, range.second, [&](const auto& entry) {
+          auto& batch = batches_[entry.second.first];
+          for (size_t j = 0; j < columns.size(); ++j) {
+            if (!columns[j]->equalValueAt(
+                    batch[j].get(), row, entry.second.second)) {
+              return false;
+            }
+          }
+          return true;
+        });
+    if (!deleted) {
+      rows[numPassed++] = row;
+    }
+  }
+  return numPassed;
+}
+
+// static
+uint64_t EqualityDeletes::hashRow(
+    const std::vector<const BaseVector*>& columns,
+    vector_size_t row) {
+  uint64_t hash = 0;
+  for (size_t i = 0; i < columns.size(); ++i) {
+    const auto columnHash = columns[i]->hashValueAt(row);
+    hash = i == 0 ? columnHash : bits::hashMix(hash, columnHash);
+  }
+  return hash;
+}
+
+} // namespace facebook::velox::connector::hive
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::connector::hive {
+
+/// File row numbers of the deleted rows of a data file, as listed by the
+/// positional delete files of the data file.
+class PositionalDeletes {
+ public:
+  /// Adds the deleted row at 'position'. The positions may come in any order.
+  void add(int64_t position) {
+    positions_.push_back(position);
+  }
+
+  /// Sorts the positions. Must be called after the last add().
+  void finish();
+
+  bool empty() const {
+    return positions_.empty();
+  }
+
+  /// Returns a bit mask of the deleted rows among the 'numRows' rows starting
+  /// at row 'rowNumber' of the file, or nullptr if none of them is deleted.
+  /// The calls must be in increasing 'rowNumber'. The result is valid until
+  /// the next call.
+  const uint64_t* FOLLY_NULLABLE
+  deletedRows(int64_t rowNumber, uint64_t numRows);
+
+ private:
+  std::vector<int64_t> positions_;
+  // Index of the first position not before the last range passed to
+  // deletedRows().
+  size_t nextPosition_{0};
+  std::vector<uint64_t> bits_;
+};
+
+/// The rows of an equality delete file. A data row is deleted if its values of
+/// the key columns are equal to those of any delete row, with null equal to
+/// null. The delete rows are kept in a hash table that the data rows probe,
+/// i.e. an anti join in the scan.
+class EqualityDeletes {
+ public:
+  /// 'channels' are the indices of the key columns in the batches passed to
+  /// removeDeleted().
+  explicit EqualityDeletes(std::vector<column_index_t> channels)
+      : channels_(std::move(channels)) {}
+
+  /// Adds the rows of 'keys', whose children are the key columns in the order
+  /// of 'channels'.
+  void addRows(const RowVectorPtr& keys);
+
+  bool empty() const {
+    return rows_.empty();
+  }
+
+  /// Removes the deleted rows from the 'numRows' indices in 'rows' of the rows
+  /// of 'input'. Returns the number of rows left, which are moved to the
+  /// front of 'rows' in their original order.
+  vector_size_t removeDeleted(
+      const RowVector& input,
+      vector_size_t* FOLLY_NONNULL rows,
+      vector_size_t numRows) const;
+
+ private:
+  static uint64_t hashRow(
+      const std::vector<const BaseVector*>& columns,
+      vector_size_t row);
+
+  const std::vector<column_index_t> channels_;
+  // The key columns of the batches added by addRows().
+  std::vector<std::vector<VectorPtr>> batches_;
+  // Hash of the key values of each delete row to the index of its batch and
+  // its row in the batch.
+  std::unordered_multimap<uint64_t, std::pair<uint32_t, vector_size_t>> rows_;
+};
+
+} // namespace facebook::velox::connector::hive
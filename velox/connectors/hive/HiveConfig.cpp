@@ -52,4 +52,29 @@ uint32_t HiveConfig::maxPartitionsPerWriters(const Config* config) {
   return config->get<uint32_t>(kMaxPartitionsPerWriters, 100);
 }
 
+// static
+uint32_t HiveConfig::maxOpenWriters(const Config* config) {
+  return config->get<uint32_t>(kMaxOpenWriters, 0);
+}
+
+// static
+uint64_t HiveConfig::maxOpenWritersMemory(const Config* config) {
+  return config->get<uint64_t>(kMaxOpenWritersMemory, 0);
+}
+
+// static
+uint64_t HiveConfig::sortByPartitionBufferBytes(const Config* config) {
+  return config->get<uint64_t>(kSortByPartitionBufferBytes, 0);
+}
+
+// static
+uint64_t HiveConfig::maxSplitSize(const Config* config) {
+  return config->get<uint64_t>(kMaxSplitSize, 0);
+}
+
+// static
+bool HiveConfig::promoteRemainingFilters(const Config* config) {
+  return config->get<bool>(kPromoteRemainingFilters, false);
+}
+
 } // namespace facebook::velox::connector::hive
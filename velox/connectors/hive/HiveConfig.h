@@ -35,10 +35,82 @@ class HiveConfig {
   static constexpr const char* kMaxPartitionsPerWriters =
       "max_partitions_per_writers";
 
+  /// Maximum number of partition writers of a table writer instance that are
+  /// open at a time. When a partition without an open writer gets rows beyond
+  /// the limit, the least recently written writer is closed and later rows of
+  /// its partition go to a new file. 0 keeps all writers open.
+  static constexpr const char* kMaxOpenWriters = "max_open_writers";
+
+  /// Maximum memory in bytes used by the open writers of a table writer
+  /// instance. The least recently written writers are closed when it is
+  /// exceeded. With 'max_open_writers' set, each writer also flushes a stripe
+  /// when it reaches its share of the memory. 0 is unlimited.
+  static constexpr const char* kMaxOpenWritersMemory =
+      "max_open_writers_memory";
+
+  /// Input of a partitioned write is buffered up to this many bytes and then
+  /// written one partition after the other, so that the rows of a partition
+  /// from several inputs go to its writer in one run. 0 writes each input as
+  /// it arrives.
+  static constexpr const char* kSortByPartitionBufferBytes =
+      "sort_by_partition_buffer_bytes";
+
+  /// Maximum number of concurrent connections of the S3 client.
+  static constexpr const char* kS3MaxConnections = "hive.s3.max-connections";
+
+  /// Timeout in milliseconds for establishing a connection to S3.
+  static constexpr const char* kS3ConnectTimeout = "hive.s3.connect-timeout";
+
+  /// Timeout in milliseconds for receiving data from S3.
+  static constexpr const char* kS3RequestTimeout = "hive.s3.request-timeout";
+
+  /// Reads from S3 are split into ranged GETs of at most this many bytes that
+  /// are issued in parallel. 0 reads each range with a single GET.
+  static constexpr const char* kS3ReadPartSize = "hive.s3.read-part-size";
+
+  /// Number of threads issuing the parallel ranged GETs of S3 reads. 0 issues
+  /// the GETs of a read one after the other on the reading thread.
+  static constexpr const char* kS3ReadThreads = "hive.s3.read-threads";
+
+  /// Files written to S3 are uploaded in parts of this many bytes as they are
+  /// appended to. S3 requires at least 5MB per part.
+  static constexpr const char* kS3WritePartSize = "hive.s3.write-part-size";
+
+  /// Number of threads uploading the parts of S3 files. 0 uploads the parts
+  /// on the writing thread.
+  static constexpr const char* kS3WriteThreads = "hive.s3.write-threads";
+
+  /// Maximum number of parts of a file being written to S3 that can be in
+  /// flight at a time. This bounds the memory of a file being written to
+  /// (1 + this) times the part size.
+  static constexpr const char* kS3MaxPendingUploads =
+      "hive.s3.max-pending-uploads";
+
+  /// Splits of files are divided into splits of at most this many bytes on
+  /// arrival so that different drivers read the stripes or row groups of a
+  /// large file in parallel. 0 keeps the splits as they are.
+  static constexpr const char* kMaxSplitSize = "max_split_size";
+
+  /// Conjuncts of the remaining filter of a table scan that compare a column
+  /// to constants are evaluated as filters of the column readers. These are
+  /// reordered with the other column filters by their measured cost.
+  static constexpr const char* kPromoteRemainingFilters =
+      "promote_remaining_filters";
+
   static InsertExistingPartitionsBehavior insertExistingPartitionsBehavior(
       const Config* config);
 
   static uint32_t maxPartitionsPerWriters(const Config* config);
+
+  static uint32_t maxOpenWriters(const Config* config);
+
+  static uint64_t maxOpenWritersMemory(const Config* config);
+
+  static uint64_t sortByPartitionBufferBytes(const Config* config);
+
+  static uint64_t maxSplitSize(const Config* config);
+
+  static bool promoteRemainingFilters(const Config* config);
 };
 
 } // namespace facebook::velox::connector::hive
@@ -16,13 +16,16 @@
 
 #include "velox/connectors/hive/HiveConnector.h"
 
+#include "velox/common/base/BitUtil.h"
 #include "velox/common/base/Fs.h"
 #include "velox/dwio/common/InputStream.h"
 #include "velox/dwio/common/ReaderFactory.h"
+#include "velox/expression/ExprToSubfieldFilter.h"
 #include "velox/expression/FieldReference.h"
 #include "velox/type/Conversions.h"
 #include "velox/type/Type.h"
 #include "velox/type/Variant.h"
+#include "velox/vector/ConstantVector.h"
 
 #include <boost/lexical_cast.hpp>
 
@@ -36,10 +39,70 @@ DEFINE_int32(
     16,
     "Amount of space for the file handle cache in mb.");
 
+DEFINE_int32(
+    hive_decoded_data_cache_mb,
+    0,
+    "Amount of space for caching the decoded columns of splits read without "
+    "filters in mb. 0 disables the cache");
+
 namespace facebook::velox::connector::hive {
 namespace {
 static const char* kPath = "$path";
 static const char* kBucket = "$bucket";
+// Columns of positional delete files.
+static const char* kDeleteFilePath = "file_path";
+static const char* kDeletePosition = "pos";
+static constexpr uint64_t kDeleteFileBatchSize = 10'000;
+
+// Moves the conjuncts of 'expr' that compare a column of the files to
+// constants into 'filters'. Returns the remaining conjuncts, nullptr if none
+// are left.
+core::TypedExprPtr extractSubfieldFilters(
+    const core::TypedExprPtr& expr,
+    const std::unordered_map<std::string, std::shared_ptr<HiveColumnHandle>>&
+        partitionKeys,
+    SubfieldFilters& filters) {
+  auto call = std::dynamic_pointer_cast<const core::CallTypedExpr>(expr);
+  if (call == nullptr) {
+    return expr;
+  }
+  if (call->name() == "and") {
+    std::vector<core::TypedExprPtr> remaining;
+    for (const auto& input : call->inputs()) {
+      if (auto conjunct =
+              extractSubfieldFilters(input, partitionKeys, filters)) {
+        remaining.push_back(std::move(conjunct));
+      }
+    }
+    if (remaining.empty()) {
+      return nullptr;
+    }
+    if (remaining.size() == 1) {
+      return remaining[0];
+    }
+    return std::make_shared<core::CallTypedExpr>(
+        BOOLEAN(), std::move(remaining), "and");
+  }
+  common::Subfield subfield;
+  auto filter = exec::leafCallToSubfieldFilter(*call, subfield);
+  if (filter == nullptr) {
+    return expr;
+  }
+  // Partition keys and synthesized columns are constants in the scan.
+  const auto* field = dynamic_cast<const common::Subfield::NestedField*>(
+      subfield.path()[0].get());
+  if (field == nullptr || partitionKeys.count(field->name()) ||
+      field->name() == kPath || field->name() == kBucket) {
+    return expr;
+  }
+  auto it = filters.find(subfield);
+  if (it == filters.end()) {
+    filters.emplace(std::move(subfield), std::move(filter));
+  } else {
+    it->second = it->second->mergeWith(filter.get());
+  }
+  return nullptr;
+}
 } // namespace
 
 HiveTableHandle::HiveTableHandle(
@@ -56,6 +119,38 @@ HiveTableHandle::HiveTableHandle(
 
 HiveTableHandle::~HiveTableHandle() {}
 
+std::unordered_map<std::string, std::shared_ptr<ColumnHandle>>
+addRequiredSubfields(
+    const std::unordered_map<std::string, std::shared_ptr<ColumnHandle>>&
+        assignments,
+    const std::vector<core::TypedExprPtr>& exprs) {
+  auto subfields = exec::extractRequiredSubfields(exprs);
+  auto result = assignments;
+  for (auto& [name, handle] : result) {
+    auto it = subfields.find(name);
+    if (it == subfields.end() || it->second.empty()) {
+      continue;
+    }
+    auto hiveHandle = std::dynamic_pointer_cast<HiveColumnHandle>(handle);
+    VELOX_CHECK_NOT_NULL(hiveHandle);
+    if (!hiveHandle->requiredSubfields().empty()) {
+      continue;
+    }
+    // The subfields start with the name of the scan output column. The reader
+    // expects the name of the table column.
+    for (auto& subfield : it->second) {
+      subfield.path()[0] =
+          std::make_unique<common::Subfield::NestedField>(hiveHandle->name());
+    }
+    handle = std::make_shared<HiveColumnHandle>(
+        hiveHandle->name(),
+        hiveHandle->columnType(),
+        hiveHandle->dataType(),
+        std::move(it->second));
+  }
+  return result;
+}
+
 std::string HiveTableHandle::toString() const {
   std::stringstream out;
   out << "table: " << tableName_;
@@ -256,7 +351,9 @@ HiveDataSource::HiveDataSource(
     ExpressionEvaluator* expressionEvaluator,
     memory::MemoryAllocator* allocator,
     const std::string& scanId,
-    folly::Executor* executor)
+    folly::Executor* executor,
+    DecodedDataCache* decodedDataCache,
+    bool promoteRemainingFilters)
     : outputType_(outputType),
       fileHandleFactory_(fileHandleFactory),
       pool_(pool),
@@ -264,7 +361,8 @@ HiveDataSource::HiveDataSource(
       expressionEvaluator_(expressionEvaluator),
       allocator_(allocator),
       scanId_(scanId),
-      executor_(executor) {
+      executor_(executor),
+      decodedDataCache_(decodedDataCache) {
   // Column handled keyed on the column alias, the name used in the query.
   for (const auto& [canonicalizedName, columnHandle] : columnHandles) {
     auto handle = std::dynamic_pointer_cast<HiveColumnHandle>(columnHandle);
@@ -311,7 +409,15 @@ HiveDataSource::HiveDataSource(
       hiveColumnHandles,
       pool_);
 
-  const auto& remainingFilter = hiveTableHandle->remainingFilter();
+  auto remainingFilter = hiveTableHandle->remainingFilter();
+  if (remainingFilter && promoteRemainingFilters) {
+    SubfieldFilters promotedFilters;
+    remainingFilter = extractSubfieldFilters(
+        remainingFilter, partitionKeys_, promotedFilters);
+    for (auto& [subfield, filter] : promotedFilters) {
+      scanSpec_->getOrCreateChild(subfield)->addFilter(*filter);
+    }
+  }
   if (remainingFilter) {
     metadataFilter_ =
         std::make_shared<common::MetadataFilter>(*scanSpec_, *remainingFilter);
@@ -343,6 +449,24 @@ HiveDataSource::HiveDataSource(
   rowReaderOpts_.setScanSpec(scanSpec_);
   rowReaderOpts_.setMetadataFilter(metadataFilter_);
 
+  // The batches of a split read with filters depend on the filters, which
+  // are not in the cache key.
+  cacheDecodedData_ = decodedDataCache_ != nullptr &&
+      hiveTableHandle->subfieldFilters().empty() &&
+      !hiveTableHandle->remainingFilter() &&
+      readerOutputType_->size() > 0;
+  if (cacheDecodedData_) {
+    for (auto i = 0; i < hiveColumnHandles.size(); ++i) {
+      std::stringstream key;
+      key << hiveColumnHandles[i]->name() << ":"
+          << readerOutputType_->childAt(i)->toString();
+      for (const auto& subfield : hiveColumnHandles[i]->requiredSubfields()) {
+        key << ":" << subfield.toString();
+      }
+      columnCacheKeys_.push_back(key.str());
+    }
+  }
+
   ioStats_ = std::make_shared<dwio::common::IoStatistics>();
 }
 
@@ -400,6 +524,25 @@ velox::variant convertFromString(const std::optional<std::string>& value) {
   return velox::variant(ToKind);
 }
 
+// Tests 'filter' against the single value of the constant vector 'value'.
+// Returns true for the types the filters can't be tested on directly.
+template <TypeKind kind>
+bool testConstantValue(common::Filter& filter, const BaseVector& value) {
+  using T = typename TypeTraits<kind>::NativeType;
+  if (value.isNullAt(0)) {
+    return filter.testNull();
+  }
+  auto constant = value.as<ConstantVector<T>>()->valueAt(0);
+  if constexpr (std::is_same_v<T, Date>) {
+    return filter.testInt64(constant.days());
+  } else if constexpr (
+      std::is_arithmetic_v<T> || std::is_same_v<T, StringView>) {
+    return common::applyFilter(filter, constant);
+  } else {
+    return true;
+  }
+}
+
 } // namespace
 
 void HiveDataSource::addDynamicFilter(
@@ -408,6 +551,9 @@ void HiveDataSource::addDynamicFilter(
   auto& fieldSpec = scanSpec_->getChildByChannel(outputChannel);
   fieldSpec.addFilter(*filter);
   scanSpec_->resetCachedValues();
+  cacheDecodedData_ = false;
+  collectDecoded_ = false;
+  decodedColumns_.clear();
 }
 
 void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
@@ -419,6 +565,36 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
 
   VLOG(1) << "Adding split " << split_->toString();
 
+  readFromCache_ = false;
+  collectDecoded_ = false;
+  decodedColumns_.clear();
+  decodedBytes_ = 0;
+  positionalDeletes_ = PositionalDeletes();
+  equalityDeletes_.clear();
+  // The cached columns of a file are the rows before deletes.
+  if (cacheDecodedData_ && split_->deleteFiles.empty() && findCachedSplit()) {
+    emptySplit_ = false;
+    return;
+  }
+
+  // The partition keys are constant for the split, so filters on them are
+  // evaluated once here, before any I/O.
+  if (!setPartitionValues()) {
+    emptySplit_ = true;
+    ++runtimeStats_.skippedSplits;
+    ++runtimeStats_.skippedPartitionSplits;
+    runtimeStats_.skippedSplitBytes += split_->length;
+    return;
+  }
+
+  if (!testSplitStatistics()) {
+    emptySplit_ = true;
+    ++runtimeStats_.skippedSplits;
+    ++runtimeStats_.skippedSplitsByMetadata;
+    runtimeStats_.skippedSplitBytes += split_->length;
+    return;
+  }
+
   fileHandle_ = fileHandleFactory_->generate(split_->filePath);
   std::unique_ptr<dwio::common::BufferedInput> input;
   if (auto* asyncCache = dynamic_cast<cache::AsyncDataCache*>(allocator_)) {
@@ -475,9 +651,8 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
     auto fieldName = readerOutputType_->nameOf(i);
     auto scanChildSpec = scanSpec_->childByName(fieldName);
 
-    auto keyIt = split_->partitionKeys.find(fieldName);
-    if (keyIt != split_->partitionKeys.end()) {
-      setPartitionValue(scanChildSpec, fieldName, keyIt->second);
+    if (split_->partitionKeys.count(fieldName)) {
+      // Set by setPartitionValues().
     } else if (fieldName == kPath) {
       setConstantValue(
           scanChildSpec, VARCHAR(), velox::variant(split_->filePath));
@@ -496,15 +671,8 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
     }
   }
 
-  // Set constant values for partition keys and $path column. If these are
-  // used in filters only, the loop above will miss them.
-  for (const auto& entry : split_->partitionKeys) {
-    auto childSpec = scanSpec_->childByName(entry.first);
-    if (childSpec) {
-      setPartitionValue(childSpec, entry.first, entry.second);
-    }
-  }
-
+  // Set constant values for $path and $bucket columns. If these are used in
+  // filters only, the loop above will miss them.
   auto pathSpec = scanSpec_->childByName(kPath);
   if (pathSpec) {
     setConstantValue(pathSpec, VARCHAR(), velox::variant(split_->filePath));
@@ -535,6 +703,209 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
 
   rowReader_ = reader_->createRowReader(
       rowReaderOpts_.select(cs).range(split_->start, split_->length));
+
+  readDeleteFiles();
+
+  if (cacheDecodedData_ && split_->deleteFiles.empty()) {
+    collectDecoded_ = true;
+    decodedColumns_.resize(readerOutputType_->size());
+  }
+}
+
+void HiveDataSource::readDeleteFiles() {
+  for (const auto& deleteFile : split_->deleteFiles) {
+    if (deleteFile.content == HiveDeleteFile::Content::kPositionalDeletes) {
+      readDeleteFile(
+          deleteFile,
+          {kDeleteFilePath, kDeletePosition},
+          std::make_unique<common::BytesValues>(
+              std::vector<std::string>{split_->filePath}, false),
+          [&](const RowVectorPtr& batch) {
+            auto* positions = batch->childAt(1)->loadedVector();
+            VELOX_USER_CHECK_EQ(
+                positions->typeKind(),
+                TypeKind::BIGINT,
+                "Wrong type of {} in delete file {}",
+                kDeletePosition,
+                deleteFile.filePath);
+            auto* simplePositions = positions->as<SimpleVector<int64_t>>();
+            for (vector_size_t i = 0; i < batch->size(); ++i) {
+              positionalDeletes_.add(simplePositions->valueAt(i));
+            }
+          });
+      continue;
+    }
+    VELOX_USER_CHECK(
+        !deleteFile.equalityColumns.empty(),
+        "Equality delete file {} has no equality columns",
+        deleteFile.filePath);
+    std::vector<column_index_t> channels;
+    for (const auto& name : deleteFile.equalityColumns) {
+      auto channel = readerOutputType_->getChildIdxIfExists(name);
+      VELOX_USER_CHECK(
+          channel.has_value(),
+          "Equality delete column {} is not read by the scan",
+          name);
+      channels.push_back(channel.value());
+    }
+    EqualityDeletes deletes(channels);
+    readDeleteFile(
+        deleteFile,
+        deleteFile.equalityColumns,
+        nullptr,
+        [&](const RowVectorPtr& batch) {
+          for (size_t i = 0; i < channels.size(); ++i) {
+            VELOX_USER_CHECK(
+                batch->childAt(i)->type()->equivalent(
+                    *readerOutputType_->childAt(channels[i])),
+                "Type of equality delete column {} does not match the table",
+                deleteFile.equalityColumns[i]);
+          }
+          deletes.addRows(batch);
+        });
+    if (!deletes.empty()) {
+      equalityDeletes_.push_back(std::move(deletes));
+    }
+  }
+  positionalDeletes_.finish();
+}
+
+void HiveDataSource::readDeleteFile(
+    const HiveDeleteFile& deleteFile,
+    const std::vector<std::string>& columns,
+    std::unique_ptr<common::Filter> filter,
+    const std::function<void(const RowVectorPtr&)>& consumer) {
+  auto fileHandle = fileHandleFactory_->generate(deleteFile.filePath);
+  dwio::common::ReaderOptions readerOpts(pool_);
+  readerOpts.setFileFormat(deleteFile.fileFormat);
+  auto reader =
+      dwio::common::getReaderFactory(deleteFile.fileFormat)
+          ->createReader(
+              std::make_unique<dwio::common::BufferedInput>(
+                  fileHandle->file,
+                  *pool_,
+                  dwio::common::MetricsLog::voidLog(),
+                  ioStats_.get()),
+              readerOpts);
+
+  auto& fileType = reader->rowType();
+  std::vector<TypePtr> types;
+  for (const auto& name : columns) {
+    VELOX_USER_CHECK(
+        fileType->containsChild(name),
+        "Delete file {} has no column {}",
+        deleteFile.filePath,
+        name);
+    types.push_back(fileType->findChild(name));
+  }
+  auto rowType = ROW(std::vector<std::string>(columns), std::move(types));
+  auto spec = std::make_shared<common::ScanSpec>("root");
+  spec->addAllChildFields(*rowType);
+  if (filter) {
+    spec->childByName(columns[0])->setFilter(std::move(filter));
+  }
+  dwio::common::RowReaderOptions rowReaderOpts;
+  rowReaderOpts.setScanSpec(spec);
+  rowReaderOpts.select(
+      std::make_shared<dwio::common::ColumnSelector>(fileType, columns));
+  auto rowReader = reader->createRowReader(rowReaderOpts);
+  for (;;) {
+    // A new batch per call since 'consumer' may keep the columns.
+    VectorPtr batch = BaseVector::create(rowType, 0, pool_);
+    if (rowReader->next(kDeleteFileBatchSize, batch) == 0) {
+      break;
+    }
+    if (batch->size() > 0) {
+      consumer(std::static_pointer_cast<RowVector>(batch));
+    }
+  }
+}
+
+vector_size_t HiveDataSource::applyEqualityDeletes(
+    const RowVectorPtr& rowVector,
+    vector_size_t numRows,
+    BufferPtr& indices) {
+  if (!indices) {
+    indices = allocateIndices(numRows, pool_);
+    auto* rawIndices = indices->asMutable<vector_size_t>();
+    std::iota(rawIndices, rawIndices + numRows, 0);
+  }
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  for (const auto& deletes : equalityDeletes_) {
+    numRows = deletes.removeDeleted(*rowVector, rawIndices, numRows);
+  }
+  if (numRows == rowVector->size()) {
+    indices = nullptr;
+  }
+  return numRows;
+}
+
+bool HiveDataSource::findCachedSplit() {
+  cachedColumns_.clear();
+  for (const auto& columnKey : columnCacheKeys_) {
+    auto batches = decodedDataCache_->find(DecodedDataCache::makeKey(
+        split_->filePath, split_->start, split_->length, columnKey));
+    if (!batches.has_value() ||
+        (!cachedColumns_.empty() &&
+         batches->size() != cachedColumns_[0].size())) {
+      cachedColumns_.clear();
+      return false;
+    }
+    cachedColumns_.push_back(std::move(batches.value()));
+  }
+  readFromCache_ = true;
+  nextCachedBatch_ = 0;
+  ++numDecodedCacheHits_;
+  return true;
+}
+
+RowVectorPtr HiveDataSource::nextCachedBatch() {
+  if (nextCachedBatch_ == cachedColumns_[0].size()) {
+    readFromCache_ = false;
+    cachedColumns_.clear();
+    return nullptr;
+  }
+  std::vector<VectorPtr> columns;
+  columns.reserve(cachedColumns_.size());
+  for (const auto& batches : cachedColumns_) {
+    columns.push_back(batches[nextCachedBatch_]);
+  }
+  ++nextCachedBatch_;
+  const auto size = columns[0]->size();
+  completedRows_ += size;
+  return std::make_shared<RowVector>(
+      pool_, outputType_, BufferPtr(nullptr), size, std::move(columns));
+}
+
+void HiveDataSource::collectDecodedColumns(const RowVectorPtr& rowVector) {
+  for (auto i = 0; i < rowVector->childrenSize(); ++i) {
+    // Lazy vectors are loaded now since they can't be loaded once the reader
+    // has moved on.
+    auto& child = rowVector->childAt(i);
+    child = BaseVector::loadedVectorShared(child);
+    decodedBytes_ += child->retainedSize();
+    decodedColumns_[i].push_back(child);
+  }
+  if (decodedBytes_ > decodedDataCache_->maxEntryBytes()) {
+    // Too large to cache.
+    collectDecoded_ = false;
+    decodedColumns_.clear();
+  }
+}
+
+void HiveDataSource::cacheDecodedColumns() {
+  for (auto i = 0; i < columnCacheKeys_.size(); ++i) {
+    const auto key = DecodedDataCache::makeKey(
+        split_->filePath, split_->start, split_->length, columnCacheKeys_[i]);
+    decodedDataCache_->insert(key, decodedColumns_[i]);
+  }
+  collectDecoded_ = false;
+  decodedColumns_.clear();
+}
+
+bool HiveDataSource::canPrefetch() const {
+  auto* asyncCache = dynamic_cast<cache::AsyncDataCache*>(allocator_);
+  return asyncCache == nullptr || asyncCache->canPrefetch(0);
 }
 
 void HiveDataSource::setFromDataSource(
@@ -543,13 +914,25 @@ void HiveDataSource::setFromDataSource(
   VELOX_CHECK(source, "Bad DataSource type");
   emptySplit_ = source->emptySplit_;
   split_ = std::move(source->split_);
+  numDecodedCacheHits_ += source->numDecodedCacheHits_;
+  source->numDecodedCacheHits_ = 0;
   if (emptySplit_) {
     return;
   }
+  readFromCache_ = source->readFromCache_;
+  cachedColumns_ = std::move(source->cachedColumns_);
+  nextCachedBatch_ = 0;
+  collectDecoded_ = source->collectDecoded_;
+  decodedColumns_ = std::move(source->decodedColumns_);
+  decodedBytes_ = 0;
   source->scanSpec_->moveAdaptationFrom(*scanSpec_);
   scanSpec_ = std::move(source->scanSpec_);
-  reader_ = std::move(source->reader_);
-  rowReader_ = std::move(source->rowReader_);
+  if (!readFromCache_) {
+    reader_ = std::move(source->reader_);
+    rowReader_ = std::move(source->rowReader_);
+  }
+  positionalDeletes_ = std::move(source->positionalDeletes_);
+  equalityDeletes_ = std::move(source->equalityDeletes_);
   // New io will be accounted on the stats of 'source'. Add the existing
   // balance to that.
   source->ioStats_->merge(*ioStats_);
@@ -558,22 +941,51 @@ void HiveDataSource::setFromDataSource(
 
 std::optional<RowVectorPtr> HiveDataSource::next(
     uint64_t size,
-    velox::ContinueFuture& /*future*/) {
+    velox::ContinueFuture& future) {
   VELOX_CHECK(split_ != nullptr, "No split to process. Call addSplit first.");
   if (emptySplit_) {
     resetSplit();
     return nullptr;
   }
 
+  if (readFromCache_) {
+    auto batch = nextCachedBatch();
+    if (!batch) {
+      resetSplit();
+    }
+    return batch;
+  }
+
   if (!output_) {
     output_ = BaseVector::create(readerOutputType_, 0, pool_);
   }
 
+  // If the data of the next batch is being loaded in the background, the
+  // driver waits on a future instead of blocking its thread in the reader.
+  auto wait = folly::SemiFuture<bool>::makeEmpty();
+  if (!rowReader_->prepareNext(&wait)) {
+    ++numLoadWaits_;
+    future = std::move(wait).deferValue([](bool /*unused*/) {});
+    return std::nullopt;
+  }
+
   // TODO Check if remaining filter has a conjunct that doesn't depend on any
   // column, e.g. rand() < 0.1. Evaluate that conjunct first, then scan only
   // rows that passed.
 
-  auto rowsScanned = rowReader_->next(size, output_);
+  // Positional deletes apply to the rows of the next read, so the read size
+  // is fixed before the deleted rows are looked up.
+  dwio::common::Mutation mutation;
+  auto readSize = size;
+  if (!positionalDeletes_.empty()) {
+    const auto rowNumber = rowReader_->nextRowNumber();
+    if (rowNumber != dwio::common::RowReader::kAtEnd) {
+      readSize = rowReader_->nextReadSize(size);
+      mutation.deletedRows =
+          positionalDeletes_.deletedRows(rowNumber, readSize);
+    }
+  }
+  auto rowsScanned = rowReader_->next(readSize, output_, &mutation);
   completedRows_ += rowsScanned;
 
   if (rowsScanned) {
@@ -581,11 +993,14 @@ std::optional<RowVectorPtr> HiveDataSource::next(
         !output_->mayHaveNulls(), "Top-level row vector cannot have nulls");
     auto rowsRemaining = output_->size();
     if (rowsRemaining == 0) {
-      // no rows passed the pushed down filters.
+      // no rows passed the pushed down filters or all rows are deleted.
       return RowVector::createEmpty(outputType_, pool_);
     }
 
     auto rowVector = std::dynamic_pointer_cast<RowVector>(output_);
+    if (collectDecoded_) {
+      collectDecodedColumns(rowVector);
+    }
 
     // In case there is a remaining filter that excludes some but not all rows,
     // collect the indices of the passing rows. If there is no filter, or it
@@ -606,6 +1021,14 @@ std::optional<RowVectorPtr> HiveDataSource::next(
       }
     }
 
+    if (!equalityDeletes_.empty()) {
+      rowsRemaining =
+          applyEqualityDeletes(rowVector, rowsRemaining, remainingIndices);
+      if (rowsRemaining == 0) {
+        return RowVector::createEmpty(outputType_, pool_);
+      }
+    }
+
     if (outputType_->size() == 0) {
       return exec::wrap(rowsRemaining, remainingIndices, rowVector);
     }
@@ -622,6 +1045,9 @@ std::optional<RowVectorPtr> HiveDataSource::next(
   }
 
   rowReader_->updateRuntimeStats(runtimeStats_);
+  if (collectDecoded_) {
+    cacheDecodedColumns();
+  }
 
   resetSplit();
   return nullptr;
@@ -654,18 +1080,80 @@ void HiveDataSource::setNullConstantValue(
   spec->setConstantValue(BaseVector::createNullConstant(type, 1, pool_));
 }
 
-void HiveDataSource::setPartitionValue(
-    common::ScanSpec* spec,
-    const std::string& partitionKey,
-    const std::optional<std::string>& value) const {
-  auto it = partitionKeys_.find(partitionKey);
-  VELOX_CHECK(
-      it != partitionKeys_.end(),
-      "ColumnHandle is missing for partition key {}",
-      partitionKey);
-  auto constValue = VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
-      convertFromString, it->second->dataType()->kind(), value);
-  setConstantValue(spec, it->second->dataType(), constValue);
+bool HiveDataSource::setPartitionValues() const {
+  for (const auto& [partitionKey, value] : split_->partitionKeys) {
+    auto* spec = scanSpec_->childByName(partitionKey);
+    if (!spec) {
+      continue;
+    }
+    auto it = partitionKeys_.find(partitionKey);
+    VELOX_CHECK(
+        it != partitionKeys_.end(),
+        "ColumnHandle is missing for partition key {}",
+        partitionKey);
+    const auto& type = it->second->dataType();
+    auto constValue = VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+        convertFromString, type->kind(), value);
+    auto constant = BaseVector::createConstant(type, constValue, 1, pool_);
+    auto* filter = spec->filter();
+    if (filter && filter->isDeterministic() &&
+        !VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+            testConstantValue, type->kind(), *filter, *constant)) {
+      VLOG(1) << "Skipping " << split_->filePath
+              << " based on filter for partition key " << partitionKey;
+      return false;
+    }
+    spec->setConstantValue(std::move(constant));
+  }
+  return true;
+}
+
+bool HiveDataSource::testSplitStatistics() const {
+  const auto& statistics = split_->statistics;
+  if (!statistics) {
+    return true;
+  }
+  std::vector<
+      std::pair<common::MetadataFilter::LeafNode*, std::vector<uint64_t>>>
+      metadataFilterResults;
+  for (const auto& child : scanSpec_->children()) {
+    auto it = statistics->columns.find(child->fieldName());
+    if (it == statistics->columns.end() || !it->second.statistics) {
+      continue;
+    }
+    auto* columnStats = it->second.statistics.get();
+    const auto& type = it->second.type;
+    if (child->filter() &&
+        !testFilter(child->filter(), columnStats, statistics->numRows, type)) {
+      VLOG(1) << "Skipping " << split_->filePath
+              << " based on split statistics and filter for column "
+              << child->fieldName();
+      return false;
+    }
+    for (auto i = 0; i < child->numMetadataFilters(); ++i) {
+      // A set bit means that the only 'row group', i.e. the file, is dropped.
+      std::vector<uint64_t> result(1);
+      if (!testFilter(
+              child->metadataFilterAt(i),
+              columnStats,
+              statistics->numRows,
+              type)) {
+        bits::setBit(result.data(), 0);
+      }
+      metadataFilterResults.emplace_back(
+          child->metadataFilterNodeAt(i), std::move(result));
+    }
+  }
+  if (metadataFilter_ && !metadataFilterResults.empty()) {
+    std::vector<uint64_t> dropped(1);
+    metadataFilter_->eval(metadataFilterResults, dropped);
+    if (bits::isBitSet(dropped.data(), 0)) {
+      VLOG(1) << "Skipping " << split_->filePath
+              << " based on split statistics and remaining filter";
+      return false;
+    }
+  }
+  return true;
 }
 
 std::unordered_map<std::string, RuntimeCounter> HiveDataSource::runtimeStats() {
@@ -685,13 +1173,59 @@ std::unordered_map<std::string, RuntimeCounter> HiveDataSource::runtimeStats() {
        {"numRamRead", RuntimeCounter(ioStats_->ramHit().count())},
        {"ramReadBytes",
         RuntimeCounter(ioStats_->ramHit().sum(), RuntimeCounter::Unit::kBytes)},
+       {"numPrefetchHit", RuntimeCounter(ioStats_->prefetchHit().count())},
+       {"prefetchHitBytes",
+        RuntimeCounter(
+            ioStats_->prefetchHit().sum(), RuntimeCounter::Unit::kBytes)},
        {"totalScanTime",
         RuntimeCounter(
             ioStats_->totalScanTime(), RuntimeCounter::Unit::kNanos)},
        {"ioWaitNanos",
         RuntimeCounter(
             ioStats_->queryThreadIoLatency().sum() * 1000,
+            RuntimeCounter::Unit::kNanos)},
+       {"coalescedLoadWaitNanos",
+        RuntimeCounter(
+            ioStats_->coalescedLoadWait().sum() * 1000,
+            RuntimeCounter::Unit::kNanos)},
+       {"cachePinWaitNanos",
+        RuntimeCounter(
+            ioStats_->cachePinWait().sum() * 1000,
             RuntimeCounter::Unit::kNanos)}});
+  // Only the non-empty latency buckets are reported.
+  auto addHistogram = [&](const std::string& prefix,
+                          const dwio::common::IoLatencyHistogram& histogram) {
+    for (auto i = 0; i < dwio::common::IoLatencyHistogram::kNumBuckets; ++i) {
+      if (const auto count = histogram.count(i)) {
+        res.insert(
+            {prefix + dwio::common::IoLatencyHistogram::bucketName(i),
+             RuntimeCounter(count)});
+      }
+    }
+  };
+  addHistogram("storageReads", ioStats_->storageReadLatency());
+  addHistogram("ssdReads", ioStats_->ssdReadLatency());
+  if (numDecodedCacheHits_ > 0) {
+    res.insert({"decodedCacheHits", RuntimeCounter(numDecodedCacheHits_)});
+  }
+  if (numLoadWaits_ > 0) {
+    res.insert({"numLoadWaits", RuntimeCounter(numLoadWaits_)});
+  }
+  auto& storageLatency = ioStats_->storageLatency();
+  if (auto estimate = storageLatency.estimate()) {
+    res.insert(
+        {"storageLatencyNanos",
+         RuntimeCounter(
+             estimate->latencyMicros * 1'000, RuntimeCounter::Unit::kNanos)});
+    if (FLAGS_cache_adaptive_coalesce) {
+      res.insert(
+          {"coalesceDistance",
+           RuntimeCounter(
+               storageLatency.coalesceDistance(
+                   readerOpts_.maxCoalesceDistance()),
+               RuntimeCounter::Unit::kBytes)});
+    }
+  }
   return res;
 }
 
@@ -706,6 +1240,36 @@ int64_t HiveDataSource::estimatedRowSize() {
   return kUnknownRowSize;
 }
 
+std::shared_ptr<ConnectorSplit> HiveDataSource::splitRemaining() {
+  if (split_ == nullptr || emptySplit_ || readFromCache_ || !rowReader_) {
+    return nullptr;
+  }
+  const auto offset = rowReader_->splitRemaining();
+  if (!offset.has_value()) {
+    return nullptr;
+  }
+  VELOX_CHECK_GE(offset.value(), split_->start);
+  uint64_t length = std::numeric_limits<uint64_t>::max();
+  if (split_->length != std::numeric_limits<uint64_t>::max()) {
+    VELOX_CHECK_LT(offset.value(), split_->start + split_->length);
+    length = split_->start + split_->length - offset.value();
+  }
+  // 'this' no longer reads all of 'split_', so its decoded columns are not
+  // the columns of 'split_'.
+  collectDecoded_ = false;
+  decodedColumns_.clear();
+  return std::make_shared<HiveConnectorSplit>(
+      split_->connectorId,
+      split_->filePath,
+      split_->fileFormat,
+      offset.value(),
+      length,
+      split_->partitionKeys,
+      split_->tableBucketNumber,
+      split_->statistics,
+      split_->deleteFiles);
+}
+
 HiveConnector::HiveConnector(
     const std::string& id,
     std::shared_ptr<const Config> properties,
@@ -715,7 +1279,55 @@ HiveConnector::HiveConnector(
           std::make_unique<SimpleLRUCache<std::string, FileHandle>>(
               FLAGS_file_handle_cache_mb << 20),
           std::make_unique<FileHandleGenerator>(std::move(properties))),
-      executor_(executor) {}
+      executor_(executor) {
+  if (FLAGS_hive_decoded_data_cache_mb > 0) {
+    decodedDataCache_ = std::make_unique<DecodedDataCache>(
+        static_cast<uint64_t>(FLAGS_hive_decoded_data_cache_mb) << 20,
+        memory::getDefaultMemoryPool(fmt::format("{}.decodedDataCache", id)));
+  }
+  if (connectorProperties() != nullptr) {
+    maxSplitSize_ = HiveConfig::maxSplitSize(connectorProperties().get());
+  }
+}
+
+std::vector<std::shared_ptr<ConnectorSplit>> HiveConnector::divideSplit(
+    const std::shared_ptr<ConnectorSplit>& split) {
+  auto hiveSplit = std::dynamic_pointer_cast<HiveConnectorSplit>(split);
+  if (maxSplitSize_ == 0 || hiveSplit == nullptr ||
+      hiveSplit->length <= maxSplitSize_) {
+    return {split};
+  }
+  uint64_t end;
+  if (hiveSplit->length == std::numeric_limits<uint64_t>::max()) {
+    try {
+      end = fileHandleFactory_.generate(hiveSplit->filePath)->file->size();
+    } catch (const std::exception& e) {
+      // Leave the split as is for the table scan to report the error.
+      LOG(WARNING) << "Failed to get the size of " << hiveSplit->filePath
+                   << ": " << e.what();
+      return {split};
+    }
+  } else {
+    end = hiveSplit->start + hiveSplit->length;
+  }
+  if (end <= hiveSplit->start + maxSplitSize_) {
+    return {split};
+  }
+  std::vector<std::shared_ptr<ConnectorSplit>> splits;
+  for (auto start = hiveSplit->start; start < end; start += maxSplitSize_) {
+    splits.push_back(std::make_shared<HiveConnectorSplit>(
+        connectorId(),
+        hiveSplit->filePath,
+        hiveSplit->fileFormat,
+        start,
+        std::min(maxSplitSize_, end - start),
+        hiveSplit->partitionKeys,
+        hiveSplit->tableBucketNumber,
+        hiveSplit->statistics,
+        hiveSplit->deleteFiles));
+  }
+  return splits;
+}
 
 VELOX_REGISTER_CONNECTOR_FACTORY(std::make_shared<HiveConnectorFactory>())
 VELOX_REGISTER_CONNECTOR_FACTORY(
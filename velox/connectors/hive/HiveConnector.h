@@ -15,7 +15,10 @@
  */
 #pragma once
 
+#include "velox/connectors/hive/DecodedDataCache.h"
+#include "velox/connectors/hive/DeleteFilter.h"
 #include "velox/connectors/hive/FileHandle.h"
+#include "velox/connectors/hive/HiveConfig.h"
 #include "velox/connectors/hive/HiveConnectorSplit.h"
 #include "velox/connectors/hive/HiveDataSink.h"
 #include "velox/dwio/common/CachedBufferedInput.h"
@@ -85,6 +88,19 @@ class HiveColumnHandle : public ColumnHandle {
   const std::vector<common::Subfield> requiredSubfields_;
 };
 
+/// Returns the 'assignments' of a table scan with the handles of the complex
+/// type columns that 'exprs' use only in part replaced by handles that list
+/// the used subfields, so that the reader decodes only those. For example, of
+/// a map column the reader then decodes only the keys that appear in
+/// subscripts with constant keys. 'exprs' must be all the uses of the scan
+/// output, e.g. the filter and projections of a FilterProject over the scan.
+/// Other handles, including handles that already list subfields, are kept.
+std::unordered_map<std::string, std::shared_ptr<ColumnHandle>>
+addRequiredSubfields(
+    const std::unordered_map<std::string, std::shared_ptr<ColumnHandle>>&
+        assignments,
+    const std::vector<core::TypedExprPtr>& exprs);
+
 using SubfieldFilters =
     std::unordered_map<common::Subfield, std::unique_ptr<common::Filter>>;
 
@@ -135,7 +151,9 @@ class HiveDataSource : public DataSource {
       ExpressionEvaluator* FOLLY_NONNULL expressionEvaluator,
       memory::MemoryAllocator* FOLLY_NONNULL allocator,
       const std::string& scanId,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      DecodedDataCache* FOLLY_NULLABLE decodedDataCache = nullptr,
+      bool promoteRemainingFilters = false);
 
   void addSplit(std::shared_ptr<ConnectorSplit> split) override;
 
@@ -160,10 +178,14 @@ class HiveDataSource : public DataSource {
     return rowReader_ && rowReader_->allPrefetchIssued();
   }
 
+  bool canPrefetch() const override;
+
   void setFromDataSource(std::shared_ptr<DataSource> source) override;
 
   int64_t estimatedRowSize() override;
 
+  std::shared_ptr<ConnectorSplit> splitRemaining() override;
+
   // Internal API, made public to be accessible in unit tests.  Do not use in
   // other places.
   static std::shared_ptr<common::ScanSpec> makeScanSpec(
@@ -188,14 +210,55 @@ class HiveDataSource : public DataSource {
       common::ScanSpec* FOLLY_NONNULL spec,
       const TypePtr& type) const;
 
-  void setPartitionValue(
-      common::ScanSpec* FOLLY_NONNULL spec,
-      const std::string& partitionKey,
-      const std::optional<std::string>& value) const;
+  // Converts the partition values of 'split_' to typed constants once and
+  // sets them on the ScanSpec children of the partition keys. Returns false
+  // if a filter on a partition key rejects its value, in which case the split
+  // can be skipped without opening the file.
+  bool setPartitionValues() const;
+
+  // Returns false if the statistics carried by 'split_' prove that no row
+  // passes the filters of 'scanSpec_' and 'metadataFilter_'.
+  bool testSplitStatistics() const;
+
+  // Reads the delete files of 'split_' into 'positionalDeletes_' and
+  // 'equalityDeletes_'.
+  void readDeleteFiles();
+
+  // Reads 'columns' of 'deleteFile' and passes each non-empty batch to
+  // 'consumer'. If set, 'filter' is applied to the first column.
+  void readDeleteFile(
+      const HiveDeleteFile& deleteFile,
+      const std::vector<std::string>& columns,
+      std::unique_ptr<common::Filter> filter,
+      const std::function<void(const RowVectorPtr&)>& consumer);
+
+  // Removes the rows deleted by 'equalityDeletes_' from the first 'numRows'
+  // rows of 'rowVector' selected by 'indices', or from all rows if 'indices'
+  // is null. Returns the number of rows left and sets 'indices' to them, or
+  // to null if no row is removed.
+  vector_size_t applyEqualityDeletes(
+      const RowVectorPtr& rowVector,
+      vector_size_t numRows,
+      BufferPtr& indices);
 
   /// Clear split_, reader_ and rowReader_ after split has been fully processed.
   void resetSplit();
 
+  // Sets 'cachedColumns_' to the cached batches of the columns of 'split_'.
+  // Returns false if not all columns are cached.
+  bool findCachedSplit();
+
+  // Returns the next batch of 'cachedColumns_', nullptr at the end of the
+  // split.
+  RowVectorPtr nextCachedBatch();
+
+  // Adds the columns of 'rowVector' to 'decodedColumns_' if the split is
+  // still small enough to cache.
+  void collectDecodedColumns(const RowVectorPtr& rowVector);
+
+  // Inserts 'decodedColumns_' for 'split_' into 'decodedDataCache_'.
+  void cacheDecodedColumns();
+
   const RowTypePtr outputType_;
   // Column handles for the partition key columns keyed on partition key column
   // name.
@@ -230,6 +293,34 @@ class HiveDataSource : public DataSource {
   memory::MemoryAllocator* const FOLLY_NONNULL allocator_;
   const std::string& scanId_;
   folly::Executor* FOLLY_NULLABLE executor_;
+
+  // Cache of the decoded columns of splits. nullptr if disabled.
+  DecodedDataCache* FOLLY_NULLABLE const decodedDataCache_;
+  // True if the splits are read without filters, so that their decoded
+  // columns can be cached.
+  bool cacheDecodedData_{false};
+  // The parts of the cache keys of the columns of 'readerOutputType_' that
+  // identify the column and its required subfields.
+  std::vector<std::string> columnCacheKeys_;
+  // True if the current split is read from 'cachedColumns_'.
+  bool readFromCache_{false};
+  // The cached batches of each column of the current split.
+  std::vector<std::vector<VectorPtr>> cachedColumns_;
+  size_t nextCachedBatch_{0};
+  // True while the batches of the current split are collected for caching.
+  bool collectDecoded_{false};
+  // The batches read so far for each column of the current split.
+  std::vector<std::vector<VectorPtr>> decodedColumns_;
+  uint64_t decodedBytes_{0};
+  // Number of splits read from 'decodedDataCache_'.
+  uint64_t numDecodedCacheHits_{0};
+  // Number of times next() returned a future instead of blocking on a
+  // background load.
+  uint64_t numLoadWaits_{0};
+  // The rows of the current split deleted by its positional delete files.
+  PositionalDeletes positionalDeletes_;
+  // The rows of each equality delete file of the current split.
+  std::vector<EqualityDeletes> equalityDeletes_;
 };
 
 class HiveConnector final : public Connector {
@@ -259,13 +350,22 @@ class HiveConnector final : public Connector {
         connectorQueryCtx->expressionEvaluator(),
         connectorQueryCtx->allocator(),
         connectorQueryCtx->scanId(),
-        executor_);
+        executor_,
+        decodedDataCache_.get(),
+        HiveConfig::promoteRemainingFilters(connectorQueryCtx->config()));
   }
 
   bool supportsSplitPreload() override {
     return true;
   }
 
+  /// Divides the splits of files into splits of at most
+  /// HiveConfig::kMaxSplitSize bytes. The readers only read the stripes or
+  /// row groups starting in the byte range of a split, so the divided splits
+  /// together read the same rows as 'split'.
+  std::vector<std::shared_ptr<ConnectorSplit>> divideSplit(
+      const std::shared_ptr<ConnectorSplit>& split) override;
+
   std::shared_ptr<DataSink> createDataSink(
       RowTypePtr inputType,
       std::shared_ptr<ConnectorInsertTableHandle> connectorInsertTableHandle,
@@ -283,6 +383,12 @@ class HiveConnector final : public Connector {
     return executor_;
   }
 
+  /// Returns the cache of the decoded columns of splits, nullptr if disabled
+  /// by --hive_decoded_data_cache_mb.
+  DecodedDataCache* FOLLY_NULLABLE decodedDataCache() const {
+    return decodedDataCache_.get();
+  }
+
   FileHandleCacheStats fileHandleCacheStats() {
     return fileHandleFactory_.cacheStats();
   }
@@ -296,6 +402,9 @@ class HiveConnector final : public Connector {
  private:
   FileHandleFactory fileHandleFactory_;
   folly::Executor* FOLLY_NULLABLE executor_;
+  std::unique_ptr<DecodedDataCache> decodedDataCache_;
+  // Splits are divided into splits of at most this many bytes. 0 if disabled.
+  uint64_t maxSplitSize_{0};
 };
 
 class HiveConnectorFactory : public ConnectorFactory {
@@ -306,11 +415,13 @@ class HiveConnectorFactory : public ConnectorFactory {
 
   HiveConnectorFactory() : ConnectorFactory(kHiveConnectorName) {
     dwio::common::LocalFileSink::registerFactory();
+    dwio::common::WriteFileSink::registerFactory();
   }
 
   HiveConnectorFactory(const char* FOLLY_NONNULL connectorName)
       : ConnectorFactory(connectorName) {
     dwio::common::LocalFileSink::registerFactory();
+    dwio::common::WriteFileSink::registerFactory();
   }
 
   std::shared_ptr<Connector> newConnector(
@@ -17,11 +17,52 @@
 
 #include <optional>
 #include <unordered_map>
+#include <vector>
 #include "velox/connectors/Connector.h"
 #include "velox/dwio/common/Options.h"
+#include "velox/dwio/common/Statistics.h"
 
 namespace facebook::velox::connector::hive {
 
+/// Statistics of the file of a split that are known before the file is
+/// opened, e.g. provided by the coordinator or taken from the manifests of an
+/// external catalog. Used to skip the split without any I/O when no row can
+/// pass the filters of the scan.
+struct HiveSplitStatistics {
+  struct Column {
+    /// Type of the column in the file.
+    TypePtr type;
+    std::shared_ptr<dwio::common::ColumnStatistics> statistics;
+  };
+
+  /// Number of rows in the file.
+  uint64_t numRows{0};
+
+  /// Statistics of top level columns keyed on column name. Columns without
+  /// statistics are not used for skipping.
+  std::unordered_map<std::string, Column> columns;
+};
+
+/// A file listing rows to drop from the data file of a split, as written by
+/// table formats with merge-on-read deletes, e.g. Iceberg.
+struct HiveDeleteFile {
+  enum class Content {
+    /// Rows with columns 'file_path' and 'pos'. Deletes the rows at position
+    /// 'pos' of the data file at 'file_path', counted from 0.
+    kPositionalDeletes,
+    /// Rows with the columns in 'equalityColumns'. Deletes the rows of the
+    /// data file with the same values in these columns.
+    kEqualityDeletes,
+  };
+
+  Content content;
+  std::string filePath;
+  dwio::common::FileFormat fileFormat;
+  /// Columns matched by an equality delete file. They have the same names and
+  /// types in the delete and data files and must be read by the scan.
+  std::vector<std::string> equalityColumns;
+};
+
 struct HiveConnectorSplit : public connector::ConnectorSplit {
   const std::string filePath;
   dwio::common::FileFormat fileFormat;
@@ -30,6 +71,10 @@ struct HiveConnectorSplit : public connector::ConnectorSplit {
   const std::unordered_map<std::string, std::optional<std::string>>
       partitionKeys;
   std::optional<int32_t> tableBucketNumber;
+  /// Optional statistics of the file, nullptr if not known.
+  std::shared_ptr<const HiveSplitStatistics> statistics;
+  /// Delete files applied to the rows of the split.
+  std::vector<HiveDeleteFile> deleteFiles;
 
   HiveConnectorSplit(
       const std::string& connectorId,
@@ -39,14 +84,18 @@ struct HiveConnectorSplit : public connector::ConnectorSplit {
       uint64_t _length = std::numeric_limits<uint64_t>::max(),
       const std::unordered_map<std::string, std::optional<std::string>>&
           _partitionKeys = {},
-      std::optional<int32_t> _tableBucketNumber = std::nullopt)
+      std::optional<int32_t> _tableBucketNumber = std::nullopt,
+      std::shared_ptr<const HiveSplitStatistics> _statistics = nullptr,
+      std::vector<HiveDeleteFile> _deleteFiles = {})
       : ConnectorSplit(connectorId),
         filePath(_filePath),
         fileFormat(_fileFormat),
         start(_start),
         length(_length),
         partitionKeys(_partitionKeys),
-        tableBucketNumber(_tableBucketNumber) {}
+        tableBucketNumber(_tableBucketNumber),
+        statistics(std::move(_statistics)),
+        deleteFiles(std::move(_deleteFiles)) {}
 
   std::string toString() const override {
     if (tableBucketNumber.has_value()) {
@@ -59,6 +108,10 @@ struct HiveConnectorSplit : public connector::ConnectorSplit {
     }
     return fmt::format("[file {} {} - {}]", filePath, start, length);
   }
+
+  std::optional<int32_t> bucketNumber() const override {
+    return tableBucketNumber;
+  }
 };
 
 } // namespace facebook::velox::connector::hive
@@ -80,15 +80,22 @@ HiveDataSink::HiveDataSink(
                                             HiveConfig::maxPartitionsPerWriters(
                                                 connectorQueryCtx_->config()),
                                             connectorQueryCtx_->memoryPool())
-                                      : nullptr) {}
+                                      : nullptr),
+      maxOpenWriters_(
+          HiveConfig::maxOpenWriters(connectorQueryCtx_->config())),
+      maxOpenWritersMemory_(
+          HiveConfig::maxOpenWritersMemory(connectorQueryCtx_->config())),
+      sortByPartitionBufferBytes_(
+          HiveConfig::sortByPartitionBufferBytes(
+              connectorQueryCtx_->config())) {}
 
 void HiveDataSink::appendData(RowVectorPtr input) {
   // Write to unpartitioned table.
   if (partitionChannels_.empty()) {
     ensureSingleWriter();
 
-    writers_[0]->write(input);
-    writerInfo_[0]->numWrittenRows += input->size();
+    write(0, input);
+    closeWritersOverMemoryLimit();
     return;
   }
 
@@ -101,12 +108,26 @@ void HiveDataSink::appendData(RowVectorPtr input) {
     input->childAt(i)->loadedVector();
   }
 
+  if (sortByPartitionBufferBytes_ > 0) {
+    bufferedBytes_ += input->retainedSize();
+    bufferedInputs_.push_back(std::move(input));
+    bufferedPartitionIds_.push_back(partitionIds_);
+    if (bufferedBytes_ >= sortByPartitionBufferBytes_) {
+      flushBufferedInputs();
+    }
+    return;
+  }
+
+  writePartitions(input);
+  closeWritersOverMemoryLimit();
+}
+
+void HiveDataSink::writePartitions(const RowVectorPtr& input) {
   const auto numPartitions = partitionIdGenerator_->numPartitions();
 
   // All inputs belong to a single partition.
   if (numPartitions == 1) {
-    writers_[0]->write(input);
-    writerInfo_[0]->numWrittenRows += input->size();
+    write(0, input);
     return;
   }
 
@@ -121,17 +142,75 @@ void HiveDataSink::appendData(RowVectorPtr input) {
     RowVectorPtr writerInput = partitionSize == input->size()
         ? input
         : exec::wrap(partitionSize, partitionRows_[id], input);
-    writers_[id]->write(writerInput);
-    writerInfo_[id]->numWrittenRows += partitionSize;
+    write(id, writerInput);
+  }
+}
+
+void HiveDataSink::flushBufferedInputs() {
+  if (bufferedInputs_.empty()) {
+    return;
+  }
+
+  // Split every buffered input by partition, then write the pieces of each
+  // partition in one run.
+  const auto numPartitions = partitionIdGenerator_->numPartitions();
+  std::vector<std::vector<RowVectorPtr>> partitionInputs(numPartitions);
+  for (auto i = 0; i < bufferedInputs_.size(); ++i) {
+    const auto& input = bufferedInputs_[i];
+    partitionIds_ = std::move(bufferedPartitionIds_[i]);
+    computePartitionRowCountsAndIndices();
+    for (auto id = 0; id < numPartitions; id++) {
+      const vector_size_t partitionSize = partitionSizes_[id];
+      if (partitionSize == 0) {
+        continue;
+      }
+      if (partitionSize == input->size()) {
+        partitionInputs[id].push_back(input);
+        continue;
+      }
+      partitionInputs[id].push_back(
+          exec::wrap(partitionSize, partitionRows_[id], input));
+      // The wrapped input holds on to the indices, so the next input gets
+      // new ones.
+      partitionRows_[id] = nullptr;
+    }
+  }
+  bufferedInputs_.clear();
+  bufferedPartitionIds_.clear();
+  bufferedBytes_ = 0;
+
+  for (auto id = 0; id < numPartitions; id++) {
+    for (auto& input : partitionInputs[id]) {
+      write(id, input);
+      input.reset();
+    }
+    closeWritersOverMemoryLimit();
   }
 }
 
+void HiveDataSink::write(uint32_t id, const RowVectorPtr& input) {
+  ensureWriter(id);
+  writers_[id]->write(input);
+  writerInfo_[id]->numWrittenRows += input->size();
+  lastWriteSequence_[id] = ++writeSequence_;
+}
+
 std::vector<std::string> HiveDataSink::finish() const {
   std::vector<std::string> partitionUpdates;
   partitionUpdates.reserve(writerInfo_.size());
 
   for (const auto& info : writerInfo_) {
     if (info) {
+      auto fileWriteInfos = folly::dynamic::array(
+          folly::dynamic::object(
+              "writeFileName", info->writerParameters.writeFileName())(
+              "targetFileName", info->writerParameters.targetFileName())(
+              "fileSize", 0));
+      for (const auto& file : info->additionalFiles) {
+        fileWriteInfos.push_back(
+            folly::dynamic::object("writeFileName", file.writeFileName())(
+                "targetFileName", file.targetFileName())("fileSize", 0));
+      }
       // clang-format off
       auto partitionUpdateJson = folly::toJson(
        folly::dynamic::object
@@ -141,11 +220,7 @@ std::vector<std::string> HiveDataSink::finish() const {
               info->writerParameters.updateMode()))
           ("writePath", info->writerParameters.writeDirectory())
           ("targetPath", info->writerParameters.targetDirectory())
-          ("fileWriteInfos", folly::dynamic::array(
-            folly::dynamic::object
-              ("writeFileName", info->writerParameters.writeFileName())
-              ("targetFileName", info->writerParameters.targetFileName())
-              ("fileSize", 0)))
+          ("fileWriteInfos", fileWriteInfos)
           ("rowCount", info->numWrittenRows)
          // TODO(gaoge): track and send the fields when inMemoryDataSizeInBytes, onDiskDataSizeInBytes
          // and containsNumberedFileNames are needed at coordinator when file_renaming_enabled are turned on.
@@ -160,8 +235,13 @@ std::vector<std::string> HiveDataSink::finish() const {
 }
 
 void HiveDataSink::close() {
+  if (partitionIdGenerator_ != nullptr) {
+    flushBufferedInputs();
+  }
   for (const auto& writer : writers_) {
-    writer->close();
+    if (writer != nullptr) {
+      writer->close();
+    }
   }
 }
 
@@ -180,6 +260,7 @@ void HiveDataSink::ensurePartitionWriters() {
   if (numWriters < numPartitions) {
     writers_.reserve(numPartitions);
     writerInfo_.reserve(numPartitions);
+    lastWriteSequence_.reserve(numPartitions);
     for (auto id = numWriters; id < numPartitions; id++) {
       appendWriter(partitionIdGenerator_->partitionName(id));
     }
@@ -188,6 +269,37 @@ void HiveDataSink::ensurePartitionWriters() {
 
 void HiveDataSink::appendWriter(
     const std::optional<std::string>& partitionName) {
+  writers_.push_back(nullptr);
+  writerInfo_.push_back(
+      std::make_shared<HiveWriterInfo>(*getWriterParameters(partitionName)));
+  lastWriteSequence_.push_back(0);
+}
+
+void HiveDataSink::ensureWriter(uint32_t id) {
+  if (writers_[id] != nullptr) {
+    return;
+  }
+  if (maxOpenWriters_ > 0 && numOpenWriters_ >= maxOpenWriters_) {
+    std::optional<uint32_t> leastRecentId;
+    for (auto i = 0; i < writers_.size(); ++i) {
+      if (writers_[i] != nullptr &&
+          (!leastRecentId.has_value() ||
+           lastWriteSequence_[i] < lastWriteSequence_[*leastRecentId])) {
+        leastRecentId = i;
+      }
+    }
+    closeWriter(leastRecentId.value());
+  }
+
+  auto& info = writerInfo_[id];
+  const HiveWriterParameters* writerParameters = &info->writerParameters;
+  if (info->numFiles > 0) {
+    info->additionalFiles.push_back(*getWriterParameters(
+        info->writerParameters.partitionName(), info->numFiles));
+    writerParameters = &info->additionalFiles.back();
+  }
+  ++info->numFiles;
+
   auto config = std::make_shared<WriterConfig>();
   // TODO: Wire up serde properties to writer configs.
 
@@ -195,15 +307,57 @@ void HiveDataSink::appendWriter(
   options.config = config;
   options.schema = inputType_;
   // Without explicitly setting flush policy, the default memory based flush
-  // policy is used.
-  auto writerParameters = getWriterParameters(partitionName);
+  // policy is used. With bounded open writers, each writer flushes a stripe
+  // once it reaches its share of the memory of the open writers.
+  if (maxOpenWriters_ > 0 && maxOpenWritersMemory_ > 0) {
+    const uint64_t stripeSize = std::min<uint64_t>(
+        config->get(WriterConfig::STRIPE_SIZE),
+        maxOpenWritersMemory_ / maxOpenWriters_);
+    const uint64_t dictionarySize =
+        config->get(WriterConfig::MAX_DICTIONARY_SIZE);
+    options.flushPolicyFactory = [stripeSize, dictionarySize]() {
+      return std::make_unique<DefaultFlushPolicy>(stripeSize, dictionarySize);
+    };
+  }
   auto writePath = fs::path(writerParameters->writeDirectory()) /
       writerParameters->writeFileName();
 
   auto sink = dwio::common::DataSink::create(writePath);
-  writers_.push_back(std::make_unique<Writer>(
-      options, std::move(sink), *connectorQueryCtx_->aggregatePool()));
-  writerInfo_.push_back(std::make_shared<HiveWriterInfo>(*writerParameters));
+  writers_[id] = std::make_unique<Writer>(
+      options, std::move(sink), *connectorQueryCtx_->aggregatePool());
+  ++numOpenWriters_;
+}
+
+void HiveDataSink::closeWriter(uint32_t id) {
+  writers_[id]->close();
+  writers_[id].reset();
+  --numOpenWriters_;
+}
+
+void HiveDataSink::closeWritersOverMemoryLimit() {
+  if (maxOpenWritersMemory_ == 0 || numOpenWriters_ <= 1) {
+    return;
+  }
+  std::vector<uint32_t> openIds;
+  uint64_t memoryUsage = 0;
+  for (auto id = 0; id < writers_.size(); ++id) {
+    if (writers_[id] != nullptr) {
+      openIds.push_back(id);
+      memoryUsage += writers_[id]->getContext().getTotalMemoryUsage();
+    }
+  }
+  if (memoryUsage <= maxOpenWritersMemory_) {
+    return;
+  }
+  std::sort(openIds.begin(), openIds.end(), [&](auto left, auto right) {
+    return lastWriteSequence_[left] < lastWriteSequence_[right];
+  });
+  for (auto i = 0;
+       i + 1 < openIds.size() && memoryUsage > maxOpenWritersMemory_;
+       ++i) {
+    memoryUsage -= writers_[openIds[i]]->getContext().getTotalMemoryUsage();
+    closeWriter(openIds[i]);
+  }
 }
 
 void HiveDataSink::computePartitionRowCountsAndIndices() {
@@ -236,7 +390,8 @@ void HiveDataSink::computePartitionRowCountsAndIndices() {
 }
 
 std::shared_ptr<const HiveWriterParameters> HiveDataSink::getWriterParameters(
-    const std::optional<std::string>& partition) const {
+    const std::optional<std::string>& partition,
+    uint32_t fileSequence) const {
   auto updateMode = getUpdateMode();
 
   std::string targetFileName;
@@ -256,7 +411,7 @@ std::shared_ptr<const HiveWriterParameters> HiveDataSink::getWriterParameters(
           "{}_{}_{}",
           connectorQueryCtx_->taskId(),
           connectorQueryCtx_->driverId(),
-          0);
+          fileSequence);
       writeFileName =
           fmt::format(".tmp.velox.{}_{}", targetFileName, makeUuid());
       break;
@@ -75,6 +75,11 @@ class HiveInsertTableHandle : public ConnectorInsertTableHandle {
 
   virtual ~HiveInsertTableHandle() = default;
 
+  /// Each driver writes its own files, which are named after the driver.
+  bool supportsMultiThreading() const override {
+    return true;
+  }
+
   const std::vector<std::shared_ptr<const HiveColumnHandle>>& inputColumns()
       const {
     return inputColumns_;
@@ -176,8 +181,15 @@ struct HiveWriterInfo {
   explicit HiveWriterInfo(HiveWriterParameters parameters)
       : writerParameters(std::move(parameters)) {}
 
+  /// The parameters of the first file written for the partition.
   const HiveWriterParameters writerParameters;
   vector_size_t numWrittenRows = 0;
+  /// Number of files opened for the partition so far.
+  uint32_t numFiles = 0;
+  /// The parameters of the files after the first one. A partition gets more
+  /// than one file when its writer is closed to bound the open writers and
+  /// the partition receives more rows afterwards.
+  std::vector<HiveWriterParameters> additionalFiles;
 };
 
 class HiveDataSink : public DataSink {
@@ -195,10 +207,33 @@ class HiveDataSink : public DataSink {
   void close() override;
 
  private:
-  // Pass 0 as partitionId when creating the single writer for an
-  // unpartitioned table.
+  // Adds the writer info of a new partition. Pass std::nullopt for the single
+  // partition of an unpartitioned table. The writer itself is created on the
+  // first write to the partition, see ensureWriter().
   void appendWriter(const std::optional<std::string>& partitionName);
 
+  // Creates the writer of partition 'id' if it is not open, closing the least
+  // recently written writer first if 'maxOpenWriters_' writers are open.
+  void ensureWriter(uint32_t id);
+
+  // Closes the writer of partition 'id'. Later writes to the partition open a
+  // new file.
+  void closeWriter(uint32_t id);
+
+  // Closes the least recently written writers while the open writers use more
+  // than 'maxOpenWritersMemory_' and more than one is open.
+  void closeWritersOverMemoryLimit();
+
+  // Writes 'input' of partition 'id'.
+  void write(uint32_t id, const RowVectorPtr& input);
+
+  // Writes the rows of 'input' to their partitions as labeled by
+  // partitionIds_.
+  void writePartitions(const RowVectorPtr& input);
+
+  // Writes the buffered inputs one partition after the other.
+  void flushBufferedInputs();
+
   // Make sure to create the one writer for unpartitioned table.
   void ensureSingleWriter();
 
@@ -209,8 +244,10 @@ class HiveDataSink : public DataSink {
   // to every partition ID, based on the ID labeling of partitionIds_.
   void computePartitionRowCountsAndIndices();
 
+  // 'fileSequence' numbers the files of the partition written by this sink.
   std::shared_ptr<const HiveWriterParameters> getWriterParameters(
-      const std::optional<std::string>& partition) const;
+      const std::optional<std::string>& partition,
+      uint32_t fileSequence = 0) const;
 
   HiveWriterParameters::UpdateMode getUpdateMode() const;
 
@@ -220,11 +257,25 @@ class HiveDataSink : public DataSink {
   const CommitStrategy commitStrategy_;
   const std::vector<column_index_t> partitionChannels_;
   const std::unique_ptr<PartitionIdGenerator> partitionIdGenerator_;
+  const uint32_t maxOpenWriters_;
+  const uint64_t maxOpenWritersMemory_;
+  const uint64_t sortByPartitionBufferBytes_;
 
   // Below are structures for partitions from all inputs. writerInfo_ and
   // writers_ are both indexed by partitionId.
   std::vector<std::shared_ptr<HiveWriterInfo>> writerInfo_;
+  // The writers closed to bound the open writers are nullptr.
   std::vector<std::unique_ptr<dwrf::Writer>> writers_;
+  // The value of 'writeSequence_' at the last write of each partition.
+  std::vector<uint64_t> lastWriteSequence_;
+  uint64_t writeSequence_{0};
+  uint32_t numOpenWriters_{0};
+
+  // The inputs buffered for writing one partition after the other, with the
+  // partition ids of their rows.
+  std::vector<RowVectorPtr> bufferedInputs_;
+  std::vector<raw_vector<uint64_t>> bufferedPartitionIds_;
+  uint64_t bufferedBytes_{0};
 
   // Below are structures updated when processing current input. partitionIds_
   // are indexed by the row of input_. partitionRows_, rawPartitionRows_ and
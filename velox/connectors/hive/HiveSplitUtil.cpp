@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/connectors/hive/HiveSplitUtil.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "velox/dwio/common/BufferedInput.h"
+#include "velox/dwio/common/ReaderFactory.h"
+
+namespace facebook::velox::connector::hive {
+
+namespace {
+uint64_t divideRoundUp(uint64_t value, uint64_t divisor) {
+  return value / divisor + (value % divisor != 0);
+}
+} // namespace
+
+std::vector<SplitRange> makeAlignedSplitRanges(
+    const std::vector<dwio::common::FileStripe>& stripes,
+    uint64_t fileSize,
+    uint64_t targetSplitBytes,
+    uint64_t targetSplitRows) {
+  VELOX_CHECK_GT(targetSplitBytes, 0);
+  VELOX_CHECK_GT(targetSplitRows, 0);
+  if (stripes.empty()) {
+    return {{0, fileSize, 0}};
+  }
+  uint64_t totalBytes = 0;
+  uint64_t totalRows = 0;
+  for (auto& stripe : stripes) {
+    VELOX_CHECK_LE(stripe.offset, fileSize);
+    totalBytes += stripe.length;
+    totalRows += stripe.numRows;
+  }
+  const uint64_t numSplits = std::clamp<uint64_t>(
+      std::max(
+          divideRoundUp(totalBytes, targetSplitBytes),
+          divideRoundUp(totalRows, targetSplitRows)),
+      1,
+      stripes.size());
+
+  // A split ends where the fraction of the bytes or rows read so far reaches
+  // a multiple of 1 / 'numSplits' not reached by the previous split. A stripe
+  // larger than the target passes several multiples at once and the splits
+  // after it are balanced over the rest of the file.
+  std::vector<SplitRange> ranges;
+  ranges.reserve(numSplits);
+  uint64_t bytes = 0;
+  uint64_t rows = 0;
+  uint64_t splitRows = 0;
+  uint64_t start = 0;
+  uint64_t reached = 0;
+  for (size_t i = 0; i < stripes.size(); ++i) {
+    bytes += stripes[i].length;
+    rows += stripes[i].numRows;
+    splitRows += stripes[i].numRows;
+    if (i + 1 < stripes.size()) {
+      const double progress = std::max(
+          totalBytes == 0 ? 0 : static_cast<double>(bytes) / totalBytes,
+          totalRows == 0 ? 0 : static_cast<double>(rows) / totalRows);
+      const auto splitsDone = static_cast<uint64_t>(
+          std::floor(progress * numSplits + 1e-9));
+      if (splitsDone <= reached) {
+        continue;
+      }
+      reached = splitsDone;
+    }
+    const uint64_t end =
+        i + 1 < stripes.size() ? stripes[i + 1].offset : fileSize;
+    ranges.push_back({start, end - start, splitRows});
+    start = end;
+    splitRows = 0;
+  }
+  ranges.back().length = fileSize - ranges.back().start;
+  return ranges;
+}
+
+std::vector<SplitRange> makeAlignedSplitRanges(
+    const std::shared_ptr<ReadFile>& file,
+    dwio::common::FileFormat format,
+    memory::MemoryPool& pool,
+    uint64_t targetSplitBytes,
+    uint64_t targetSplitRows) {
+  dwio::common::ReaderOptions options(&pool);
+  options.setFileFormat(format);
+  auto reader = dwio::common::getReaderFactory(format)->createReader(
+      std::make_unique<dwio::common::BufferedInput>(file, pool), options);
+  auto stripes = reader->stripes();
+  auto ranges = makeAlignedSplitRanges(
+      stripes, file->size(), targetSplitBytes, targetSplitRows);
+  if (stripes.empty()) {
+    ranges[0].numRows = reader->numberOfRows().value_or(0);
+  }
+  return ranges;
+}
+
+} // namespace facebook::velox::connector::hive
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "velox/common/file/File.h"
+#include "velox/common/memory/Memory.h"
+#include "velox/dwio/common/Options.h"
+#include "velox/dwio/common/Reader.h"
+
+namespace facebook::velox::connector::hive {
+
+/// Byte range of a file for one HiveConnectorSplit. The range starts at a
+/// stripe or row group, so that the split reads the whole units starting in
+/// it and no reader opens the file to find nothing to read.
+struct SplitRange {
+  uint64_t start;
+  uint64_t length;
+  /// Rows in the stripes or row groups starting in the range.
+  uint64_t numRows;
+};
+
+/// Groups consecutive 'stripes' of a file of 'fileSize' bytes into split
+/// ranges of about 'targetSplitBytes' bytes and at most about
+/// 'targetSplitRows' rows. The number of splits is chosen first and the
+/// stripes are then divided evenly by bytes and rows, so that no split is
+/// left with a small remainder. A stripe larger than the target gets a split
+/// of its own. The ranges are contiguous and cover the whole file: the first
+/// starts at 0 and the last ends at 'fileSize'. Returns a single range for the
+/// file if 'stripes' is empty.
+std::vector<SplitRange> makeAlignedSplitRanges(
+    const std::vector<dwio::common::FileStripe>& stripes,
+    uint64_t fileSize,
+    uint64_t targetSplitBytes,
+    uint64_t targetSplitRows = std::numeric_limits<uint64_t>::max());
+
+/// Reads the footer of 'file' in 'format' and returns its split ranges as
+/// above. The footer comes from and is added to the FileMetadataCache when
+/// the cache is enabled, so the readers of the resulting splits do not parse
+/// it again.
+std::vector<SplitRange> makeAlignedSplitRanges(
+    const std::shared_ptr<ReadFile>& file,
+    dwio::common::FileFormat format,
+    memory::MemoryPool& pool,
+    uint64_t targetSplitBytes,
+    uint64_t targetSplitRows = std::numeric_limits<uint64_t>::max());
+
+} // namespace facebook::velox::connector::hive
@@ -16,13 +16,18 @@
 
 #include "velox/connectors/hive/storage_adapters/s3fs/S3FileSystem.h"
 #include "velox/common/file/File.h"
+#include "velox/connectors/hive/HiveConfig.h"
 #include "velox/connectors/hive/storage_adapters/s3fs/S3Util.h"
 #include "velox/core/Context.h"
 
 #include <fmt/format.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
 #include <glog/logging.h>
+#include <deque>
 #include <memory>
 #include <stdexcept>
+#include <streambuf>
 
 #include <aws/core/Aws.h>
 #include <aws/core/auth/AWSCredentialsProviderChain.h>
@@ -31,8 +36,13 @@
 #include <aws/core/utils/stream/PreallocatedStreamBuf.h>
 #include <aws/identity-management/auth/STSAssumeRoleCredentialsProvider.h>
 #include <aws/s3/S3Client.h>
+#include <aws/s3/model/AbortMultipartUploadRequest.h>
+#include <aws/s3/model/CompleteMultipartUploadRequest.h>
+#include <aws/s3/model/CreateMultipartUploadRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
 #include <aws/s3/model/HeadObjectRequest.h>
+#include <aws/s3/model/PutObjectRequest.h>
+#include <aws/s3/model/UploadPartRequest.h>
 
 namespace facebook::velox {
 namespace {
@@ -51,18 +61,118 @@ class StringViewStream : Aws::Utils::Stream::PreallocatedStreamBuf,
         std::iostream(this) {}
 };
 
-// By default, the AWS SDK reads object data into an auto-growing StringStream.
-// To avoid copies, read directly into a pre-allocated buffer instead.
-// See https://github.com/aws/aws-sdk-cpp/issues/64 for an alternative but
-// functionally similar recipe.
-Aws::IOStreamFactory AwsWriteableStreamFactory(void* data, int64_t nbytes) {
-  return [=]() { return Aws::New<StringViewStream>("", data, nbytes); };
+// A non-copying output stream that writes the bytes of an S3 response into
+// 'ranges' left to right. A range with nullptr data skips its size worth of
+// bytes. This reads the parts of a byte range directly into the caller's
+// buffers.
+class ScatterStreamBuf : public std::streambuf {
+ public:
+  explicit ScatterStreamBuf(std::vector<folly::Range<char*>> ranges)
+      : ranges_(std::move(ranges)) {}
+
+ protected:
+  std::streamsize xsputn(const char* data, std::streamsize size) override {
+    std::streamsize written = 0;
+    while (written < size && index_ < ranges_.size()) {
+      const auto& range = ranges_[index_];
+      const auto bytes =
+          std::min<std::streamsize>(size - written, range.size() - offset_);
+      if (range.data()) {
+        memcpy(range.data() + offset_, data + written, bytes);
+      }
+      written += bytes;
+      offset_ += bytes;
+      if (offset_ == range.size()) {
+        ++index_;
+        offset_ = 0;
+      }
+    }
+    return written;
+  }
+
+  int_type overflow(int_type c) override {
+    if (traits_type::eq_int_type(c, traits_type::eof())) {
+      return traits_type::not_eof(c);
+    }
+    const char data = traits_type::to_char_type(c);
+    return xsputn(&data, 1) == 1 ? c : traits_type::eof();
+  }
+
+ private:
+  const std::vector<folly::Range<char*>> ranges_;
+  size_t index_{0};
+  uint64_t offset_{0};
+};
+
+class ScatterStream : ScatterStreamBuf, public std::iostream {
+ public:
+  explicit ScatterStream(std::vector<folly::Range<char*>> ranges)
+      : ScatterStreamBuf(std::move(ranges)), std::iostream(this) {}
+};
+
+// A ranged GET of [offset, offset + length) into 'ranges'.
+struct ReadPart {
+  uint64_t offset;
+  uint64_t length;
+  std::vector<folly::Range<char*>> ranges;
+};
+
+// Splits a preadv of 'buffers' at 'offset' into ranged GETs of at most
+// 'partSize' bytes. 0 means no limit. The gaps at the ends of the parts are
+// not read and parts that are all gap are left out.
+std::vector<ReadPart> makeReadParts(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers,
+    uint64_t partSize) {
+  if (partSize == 0) {
+    partSize = std::numeric_limits<uint64_t>::max();
+  }
+  std::vector<ReadPart> parts;
+  ReadPart part{offset, 0, {}};
+  auto finishPart = [&]() {
+    while (!part.ranges.empty() && !part.ranges.front().data()) {
+      part.offset += part.ranges.front().size();
+      part.length -= part.ranges.front().size();
+      part.ranges.erase(part.ranges.begin());
+    }
+    while (!part.ranges.empty() && !part.ranges.back().data()) {
+      part.length -= part.ranges.back().size();
+      part.ranges.pop_back();
+    }
+    const auto nextOffset = part.offset + part.length;
+    if (!part.ranges.empty()) {
+      parts.push_back(std::move(part));
+    }
+    part = ReadPart{nextOffset, 0, {}};
+  };
+  for (const auto& buffer : buffers) {
+    uint64_t bufferOffset = 0;
+    while (bufferOffset < buffer.size()) {
+      const auto bytes = std::min<uint64_t>(
+          buffer.size() - bufferOffset, partSize - part.length);
+      part.ranges.emplace_back(
+          buffer.data() ? buffer.data() + bufferOffset : nullptr, bytes);
+      part.length += bytes;
+      bufferOffset += bytes;
+      if (part.length == partSize) {
+        finishPart();
+      }
+    }
+  }
+  finishPart();
+  return parts;
 }
 
 class S3ReadFile final : public ReadFile {
  public:
-  S3ReadFile(const std::string& path, Aws::S3::S3Client* client)
-      : client_(client) {
+  // Reads larger than 'partSize' are split into parallel ranged GETs on
+  // 'executor' if this is not nullptr.
+  S3ReadFile(
+      const std::string& path,
+      Aws::S3::S3Client* client,
+      uint64_t partSize,
+      folly::Executor* executor)
+      : client_(client), partSize_(partSize), executor_(executor) {
     bucketAndKeyFromS3Path(path, bucket_, key_);
   }
 
@@ -87,14 +197,13 @@ class S3ReadFile final : public ReadFile {
 
   std::string_view pread(uint64_t offset, uint64_t length, void* buffer)
       const override {
-    preadInternal(offset, length, static_cast<char*>(buffer));
+    preadv(offset, {{static_cast<char*>(buffer), length}});
     return {static_cast<char*>(buffer), length};
   }
 
   std::string pread(uint64_t offset, uint64_t length) const override {
     std::string result(length, 0);
-    char* position = result.data();
-    preadInternal(offset, length, position);
+    preadv(offset, {{result.data(), length}});
     return result;
   }
 
@@ -105,25 +214,70 @@ class S3ReadFile final : public ReadFile {
     // between. This call must populate the ranges (except gap ranges)
     // sequentially starting from 'offset'. AWS S3 GetObject does not support
     // multi-range. AWS S3 also charges by number of read requests and not size.
-    // The idea here is to use a single read spanning all the ranges and then
-    // populate individual ranges. We pre-allocate a buffer to support this.
-    size_t length = 0;
-    for (const auto range : buffers) {
+    // The idea here is to use a single read spanning all the ranges, or one
+    // read per 'partSize_' bytes for large reads, and to scatter the response
+    // into the ranges.
+    uint64_t length = 0;
+    for (const auto& range : buffers) {
       length += range.size();
     }
-    // TODO: allocate from a memory pool
-    std::string result(length, 0);
-    preadInternal(offset, length, static_cast<char*>(result.data()));
-    size_t resultOffset = 0;
-    for (auto range : buffers) {
-      if (range.data()) {
-        memcpy(range.data(), &(result.data()[resultOffset]), range.size());
+    auto parts = makeReadParts(offset, buffers, partSize_);
+    if (parts.size() <= 1 || !executor_) {
+      for (const auto& part : parts) {
+        getObject(part);
       }
-      resultOffset += range.size();
+      return length;
+    }
+    // The first part is read on this thread.
+    std::vector<folly::SemiFuture<folly::Unit>> reads;
+    for (auto i = 1; i < parts.size(); ++i) {
+      reads.push_back(getObjectAsync(std::move(parts[i])));
+    }
+    std::exception_ptr error;
+    try {
+      getObject(parts[0]);
+    } catch (const std::exception&) {
+      error = std::current_exception();
+    }
+    // All the reads must be done before returning since they write into
+    // 'buffers'.
+    auto results = folly::collectAll(std::move(reads)).get();
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    for (auto& result : results) {
+      result.throwIfFailed();
     }
     return length;
   }
 
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const override {
+    if (!executor_) {
+      return ReadFile::preadvAsync(offset, buffers);
+    }
+    uint64_t length = 0;
+    for (const auto& range : buffers) {
+      length += range.size();
+    }
+    std::vector<folly::SemiFuture<folly::Unit>> reads;
+    for (auto& part : makeReadParts(offset, buffers, partSize_)) {
+      reads.push_back(getObjectAsync(std::move(part)));
+    }
+    return folly::collectAll(std::move(reads))
+        .deferValue([length](std::vector<folly::Try<folly::Unit>> results) {
+          for (auto& result : results) {
+            result.throwIfFailed();
+          }
+          return length;
+        });
+  }
+
+  bool hasPreadvAsync() const override {
+    return executor_ != nullptr;
+  }
+
   uint64_t size() const override {
     return length_;
   }
@@ -147,29 +301,247 @@ class S3ReadFile final : public ReadFile {
   }
 
  private:
-  // The assumption here is that "position" has space for at least "length"
-  // bytes.
-  void preadInternal(uint64_t offset, uint64_t length, char* position) const {
-    // Read the desired range of bytes.
+  // Reads 'part' with a ranged GET.
+  void getObject(const ReadPart& part) const {
     Aws::S3::Model::GetObjectRequest request;
-    Aws::S3::Model::GetObjectResult result;
-
     request.SetBucket(awsString(bucket_));
     request.SetKey(awsString(key_));
     std::stringstream ss;
-    ss << "bytes=" << offset << "-" << offset + length - 1;
+    ss << "bytes=" << part.offset << "-" << part.offset + part.length - 1;
     request.SetRange(awsString(ss.str()));
-    request.SetResponseStreamFactory(
-        AwsWriteableStreamFactory(position, length));
+    request.SetResponseStreamFactory([ranges = part.ranges]() {
+      return Aws::New<ScatterStream>("", ranges);
+    });
     auto outcome = client_->GetObject(request);
     VELOX_CHECK_AWS_OUTCOME(outcome, "Failed to get S3 object", bucket_, key_);
   }
 
+  folly::SemiFuture<folly::Unit> getObjectAsync(ReadPart part) const {
+    return folly::via(
+               executor_, [this, part = std::move(part)]() { getObject(part); })
+        .semi();
+  }
+
   Aws::S3::S3Client* client_;
+  const uint64_t partSize_;
+  folly::Executor* const executor_;
   std::string bucket_;
   std::string key_;
   int64_t length_ = -1;
 };
+// Writes an S3 object with a multipart upload. The appended data is buffered
+// until there is a part worth of it, which is then uploaded on 'executor', or
+// on the writing thread if this is nullptr, while the writer fills the next
+// part. At most 'maxPendingUploads' parts are in flight at a time. Files that
+// are smaller than a part are written with a single PUT on close. Nothing is
+// visible in S3 before close() returns.
+class S3WriteFile final : public WriteFile {
+ public:
+  S3WriteFile(
+      const std::string& path,
+      Aws::S3::S3Client* client,
+      uint64_t partSize,
+      int32_t maxPendingUploads,
+      folly::Executor* executor)
+      : client_(client),
+        partSize_(partSize),
+        maxPendingUploads_(maxPendingUploads),
+        executor_(executor) {
+    VELOX_USER_CHECK_GE(
+        partSize_,
+        kMinPartSize,
+        "S3 upload part size must be at least {} bytes",
+        kMinPartSize);
+    VELOX_USER_CHECK_GE(maxPendingUploads_, 1);
+    bucketAndKeyFromS3Path(path, bucket_, key_);
+  }
+
+  ~S3WriteFile() override {
+    if (!closed_) {
+      // The file has not been closed due to an error. Drop the parts that have
+      // been uploaded.
+      abort();
+    }
+  }
+
+  void append(std::string_view data) override {
+    VELOX_CHECK(
+        !closed_, "Appending to closed S3 file s3://{}/{}", bucket_, key_);
+    size_ += data.size();
+    while (!data.empty()) {
+      if (part_.capacity() < partSize_) {
+        part_.reserve(partSize_);
+      }
+      const auto bytes =
+          std::min<uint64_t>(data.size(), partSize_ - part_.size());
+      part_.append(data.data(), bytes);
+      data.remove_prefix(bytes);
+      if (part_.size() == partSize_) {
+        uploadPart();
+      }
+    }
+  }
+
+  // S3 has no partial writes to flush to. Full parts are uploaded as soon as
+  // they are appended and the rest is uploaded on close.
+  void flush() override {}
+
+  void close() override {
+    if (closed_) {
+      return;
+    }
+    if (uploadId_.empty()) {
+      putObject();
+      closed_ = true;
+      return;
+    }
+    try {
+      if (!part_.empty()) {
+        uploadPart();
+      }
+      waitForUploads(0);
+      completeUpload();
+    } catch (const std::exception&) {
+      closed_ = true;
+      abort();
+      throw;
+    }
+    closed_ = true;
+  }
+
+  uint64_t size() const override {
+    return size_;
+  }
+
+ private:
+  // The minimum size of all but the last part of a multipart upload.
+  static constexpr uint64_t kMinPartSize = 5 << 20;
+
+  // Starts the upload of 'part_'. Waits for the oldest upload if there are
+  // too many in flight.
+  void uploadPart() {
+    if (uploadId_.empty()) {
+      createUpload();
+    }
+    waitForUploads(maxPendingUploads_ - 1);
+    const int32_t partNumber = ++numParts_;
+    auto upload = [this, partNumber, data = std::move(part_)]() {
+      return sendPart(partNumber, data);
+    };
+    part_ = std::string();
+    if (executor_) {
+      pending_.push_back(folly::via(executor_, std::move(upload)).semi());
+    } else {
+      pending_.push_back(folly::makeSemiFutureWith(std::move(upload)));
+    }
+  }
+
+  // Waits for the oldest uploads until at most 'maxPending' are in flight.
+  void waitForUploads(int32_t maxPending) {
+    while (pending_.size() > maxPending) {
+      auto upload = std::move(pending_.front());
+      pending_.pop_front();
+      completedParts_.push_back(std::move(upload).get());
+    }
+  }
+
+  void createUpload() {
+    Aws::S3::Model::CreateMultipartUploadRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    auto outcome = client_->CreateMultipartUpload(request);
+    VELOX_CHECK_AWS_OUTCOME(
+        outcome, "Failed to start the upload of S3 object", bucket_, key_);
+    uploadId_ = outcome.GetResult().GetUploadId();
+  }
+
+  Aws::S3::Model::CompletedPart sendPart(
+      int32_t partNumber,
+      const std::string& data) const {
+    Aws::S3::Model::UploadPartRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetUploadId(uploadId_);
+    request.SetPartNumber(partNumber);
+    request.SetContentLength(data.size());
+    request.SetBody(
+        std::make_shared<StringViewStream>(data.data(), data.size()));
+    auto outcome = client_->UploadPart(request);
+    VELOX_CHECK_AWS_OUTCOME(
+        outcome, "Failed to upload part of S3 object", bucket_, key_);
+    Aws::S3::Model::CompletedPart part;
+    part.SetPartNumber(partNumber);
+    part.SetETag(outcome.GetResult().GetETag());
+    return part;
+  }
+
+  void completeUpload() {
+    Aws::S3::Model::CompletedMultipartUpload upload;
+    upload.SetParts(
+        Aws::Vector<Aws::S3::Model::CompletedPart>(
+            completedParts_.begin(), completedParts_.end()));
+    Aws::S3::Model::CompleteMultipartUploadRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetUploadId(uploadId_);
+    request.SetMultipartUpload(std::move(upload));
+    auto outcome = client_->CompleteMultipartUpload(request);
+    VELOX_CHECK_AWS_OUTCOME(
+        outcome, "Failed to complete the upload of S3 object", bucket_, key_);
+  }
+
+  void putObject() {
+    Aws::S3::Model::PutObjectRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetContentLength(part_.size());
+    request.SetBody(
+        std::make_shared<StringViewStream>(part_.data(), part_.size()));
+    auto outcome = client_->PutObject(request);
+    VELOX_CHECK_AWS_OUTCOME(outcome, "Failed to put S3 object", bucket_, key_);
+    part_ = std::string();
+  }
+
+  // Waits for the uploads in flight, which reference 'this', and drops the
+  // parts uploaded so far. Failures are logged since this runs on error
+  // paths.
+  void abort() {
+    for (auto& upload : pending_) {
+      upload.wait();
+    }
+    pending_.clear();
+    part_ = std::string();
+    if (uploadId_.empty()) {
+      return;
+    }
+    Aws::S3::Model::AbortMultipartUploadRequest request;
+    request.SetBucket(awsString(bucket_));
+    request.SetKey(awsString(key_));
+    request.SetUploadId(uploadId_);
+    auto outcome = client_->AbortMultipartUpload(request);
+    if (!outcome.IsSuccess()) {
+      LOG(WARNING) << "Failed to abort the upload of S3 object s3://"
+                   << bucket_ << "/" << key_ << ": "
+                   << outcome.GetError().GetMessage();
+    }
+  }
+
+  Aws::S3::S3Client* client_;
+  const uint64_t partSize_;
+  const int32_t maxPendingUploads_;
+  folly::Executor* const executor_;
+  std::string bucket_;
+  std::string key_;
+  // The data appended since the last uploaded part.
+  std::string part_;
+  uint64_t size_{0};
+  bool closed_{false};
+  // Set when the first part is uploaded.
+  Aws::String uploadId_;
+  int32_t numParts_{0};
+  std::deque<folly::SemiFuture<Aws::S3::Model::CompletedPart>> pending_;
+  std::vector<Aws::S3::Model::CompletedPart> completedParts_;
+};
 } // namespace
 
 namespace filesystems {
@@ -222,6 +594,46 @@ class S3Config {
         "hive.s3.iam-role-session-name", std::string("velox-session"));
   }
 
+  int32_t maxConnections() const {
+    return config_->get<int32_t>(
+        connector::hive::HiveConfig::kS3MaxConnections, 64);
+  }
+
+  folly::Optional<int64_t> connectTimeoutMs() const {
+    return config_->get<int64_t>(
+        connector::hive::HiveConfig::kS3ConnectTimeout);
+  }
+
+  folly::Optional<int64_t> requestTimeoutMs() const {
+    return config_->get<int64_t>(
+        connector::hive::HiveConfig::kS3RequestTimeout);
+  }
+
+  uint64_t readPartSize() const {
+    return config_->get<uint64_t>(
+        connector::hive::HiveConfig::kS3ReadPartSize, 8 << 20);
+  }
+
+  uint64_t writePartSize() const {
+    return config_->get<uint64_t>(
+        connector::hive::HiveConfig::kS3WritePartSize, 16 << 20);
+  }
+
+  int32_t writeThreads() const {
+    return config_->get<int32_t>(
+        connector::hive::HiveConfig::kS3WriteThreads, 16);
+  }
+
+  int32_t maxPendingUploads() const {
+    return config_->get<int32_t>(
+        connector::hive::HiveConfig::kS3MaxPendingUploads, 4);
+  }
+
+  int32_t readThreads() const {
+    return config_->get<int32_t>(
+        connector::hive::HiveConfig::kS3ReadThreads, 16);
+  }
+
   Aws::Utils::Logging::LogLevel getLogLevel() const {
     auto level = config_->get("hive.s3.log-level", std::string("FATAL"));
     // Convert to upper case.
@@ -354,6 +766,15 @@ class S3FileSystem::Impl {
       clientConfig.scheme = Aws::Http::Scheme::HTTP;
     }
 
+    // The parallel ranged GETs of the reads each need a connection.
+    clientConfig.maxConnections = s3Config_.maxConnections();
+    if (auto timeout = s3Config_.connectTimeoutMs()) {
+      clientConfig.connectTimeoutMs = timeout.value();
+    }
+    if (auto timeout = s3Config_.requestTimeoutMs()) {
+      clientConfig.requestTimeoutMs = timeout.value();
+    }
+
     auto credentialsProvider = getCredentialsProvider();
 
     client_ = std::make_shared<Aws::S3::S3Client>(
@@ -361,6 +782,17 @@ class S3FileSystem::Impl {
         clientConfig,
         Aws::Client::AWSAuthV4Signer::PayloadSigningPolicy::Never,
         s3Config_.useVirtualAddressing());
+
+    if (s3Config_.readThreads() > 0) {
+      readExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+          s3Config_.readThreads(),
+          std::make_shared<folly::NamedThreadFactory>("S3Read"));
+    }
+    if (s3Config_.writeThreads() > 0) {
+      writeExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+          s3Config_.writeThreads(),
+          std::make_shared<folly::NamedThreadFactory>("S3Write"));
+    }
   }
 
   // Make it clear that the S3FileSystem instance owns the S3Client.
@@ -370,6 +802,30 @@ class S3FileSystem::Impl {
     return client_.get();
   }
 
+  // Returns the executor for the parallel ranged GETs of reads, nullptr if
+  // the GETs are issued on the reading thread.
+  folly::Executor* readExecutor() const {
+    return readExecutor_.get();
+  }
+
+  uint64_t readPartSize() const {
+    return s3Config_.readPartSize();
+  }
+
+  // Returns the executor for uploading the parts of written files, nullptr if
+  // the parts are uploaded on the writing thread.
+  folly::Executor* writeExecutor() const {
+    return writeExecutor_.get();
+  }
+
+  uint64_t writePartSize() const {
+    return s3Config_.writePartSize();
+  }
+
+  int32_t maxPendingUploads() const {
+    return s3Config_.maxPendingUploads();
+  }
+
   std::string getLogLevelName() const {
     return GetLogLevelName(s3Config_.getLogLevel());
   }
@@ -377,6 +833,8 @@ class S3FileSystem::Impl {
  private:
   const S3Config s3Config_;
   std::shared_ptr<Aws::S3::S3Client> client_;
+  std::unique_ptr<folly::CPUThreadPoolExecutor> readExecutor_;
+  std::unique_ptr<folly::CPUThreadPoolExecutor> writeExecutor_;
   static std::atomic<size_t> initCounter_;
 };
 
@@ -398,14 +856,21 @@ std::string S3FileSystem::getLogLevelName() const {
 
 std::unique_ptr<ReadFile> S3FileSystem::openFileForRead(std::string_view path) {
   const std::string file = s3Path(path);
-  auto s3file = std::make_unique<S3ReadFile>(file, impl_->s3Client());
+  auto s3file = std::make_unique<S3ReadFile>(
+      file, impl_->s3Client(), impl_->readPartSize(), impl_->readExecutor());
   s3file->initialize();
   return s3file;
 }
 
 std::unique_ptr<WriteFile> S3FileSystem::openFileForWrite(
     std::string_view path) {
-  VELOX_NYI();
+  const std::string file = s3Path(path);
+  return std::make_unique<S3WriteFile>(
+      file,
+      impl_->s3Client(),
+      impl_->writePartSize(),
+      impl_->maxPendingUploads(),
+      impl_->writeExecutor());
 }
 
 std::string S3FileSystem::name() const {
@@ -118,6 +118,78 @@ TEST_F(S3FileSystemTest, writeAndRead) {
   readData(readFile.get());
 }
 
+TEST_F(S3FileSystemTest, parallelRead) {
+  const char* bucketName = "data-parallel";
+  const char* file = "test.txt";
+  const std::string filename = localPath(bucketName) + "/" + file;
+  const std::string s3File = s3URI(bucketName, file);
+  addBucket(bucketName);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  // Reads of more than 64KB are split into parallel ranged GETs.
+  auto hiveConfig = minioServer_->hiveConfig(
+      {{"hive.s3.read-part-size", "65536"}, {"hive.s3.read-threads", "4"}});
+  filesystems::S3FileSystem s3fs(hiveConfig);
+  s3fs.initializeClient();
+  auto readFile = s3fs.openFileForRead(s3File);
+  readData(readFile.get());
+
+  ASSERT_TRUE(readFile->hasPreadvAsync());
+  std::string head(10, 0);
+  std::string tail(kOneMB + 5, 0);
+  std::vector<folly::Range<char*>> buffers = {
+      folly::Range<char*>(head.data(), head.size()),
+      folly::Range<char*>(tail.data(), tail.size())};
+  ASSERT_EQ(readFile->preadvAsync(0, buffers).get(), 15 + kOneMB);
+  ASSERT_EQ(head, "aaaaabbbbb");
+  ASSERT_EQ(tail, std::string(kOneMB, 'c') + "ddddd");
+}
+
+TEST_F(S3FileSystemTest, multipartWrite) {
+  const char* bucketName = "data-write";
+  addBucket(bucketName);
+  auto hiveConfig = minioServer_->hiveConfig(
+      {{"hive.s3.write-part-size", "5242880"},
+       {"hive.s3.max-pending-uploads", "2"}});
+  filesystems::S3FileSystem s3fs(hiveConfig);
+  s3fs.initializeClient();
+
+  // 2.5 parts uploaded with a multipart upload.
+  const std::string largeFile = s3URI(bucketName, "large.txt");
+  std::string data;
+  for (auto i = 0; i < 5; ++i) {
+    data += std::string(kOneMB / 2 * 5, 'a' + i);
+  }
+  {
+    auto writeFile = s3fs.openFileForWrite(largeFile);
+    for (auto i = 0; i < data.size(); i += kOneMB) {
+      writeFile->append(std::string_view(data).substr(i, kOneMB));
+    }
+    ASSERT_EQ(writeFile->size(), data.size());
+    writeFile->close();
+  }
+  auto readFile = s3fs.openFileForRead(largeFile);
+  ASSERT_EQ(readFile->size(), data.size());
+  ASSERT_EQ(readFile->pread(0, data.size()), data);
+
+  // Smaller than a part, written with a single PUT.
+  const std::string smallFile = s3URI(bucketName, "small.txt");
+  {
+    auto writeFile = s3fs.openFileForWrite(smallFile);
+    writeData(writeFile.get());
+    writeFile->close();
+  }
+  readData(s3fs.openFileForRead(smallFile).get());
+
+  VELOX_ASSERT_THROW(
+      filesystems::S3FileSystem(
+          minioServer_->hiveConfig({{"hive.s3.write-part-size", "1024"}}))
+          .openFileForWrite(smallFile),
+      "S3 upload part size must be at least 5242880 bytes");
+}
+
 TEST_F(S3FileSystemTest, viaRegistry) {
   const char* bucketName = "data2";
   const char* file = "test.txt";
@@ -174,5 +174,56 @@ TEST_F(HiveConnectorTest, makeScanSpec_requiredSubfields_allSubscripts) {
   validateNullConstant(*elements->childByName("c0c1"), *BIGINT());
 }
 
+TEST_F(HiveConnectorTest, addRequiredSubfields) {
+  auto mapType = MAP(VARCHAR(), BIGINT());
+  std::unordered_map<std::string, std::shared_ptr<ColumnHandle>> assignments;
+  assignments["features"] = std::make_shared<HiveColumnHandle>(
+      "c0", HiveColumnHandle::ColumnType::kRegular, mapType);
+  assignments["other"] = std::make_shared<HiveColumnHandle>(
+      "c1", HiveColumnHandle::ColumnType::kRegular, mapType);
+
+  // features['a'] + features['b'] and a use of all of 'other'.
+  auto subscript = [&](const std::string& column, const std::string& key) {
+    return std::make_shared<core::CallTypedExpr>(
+        BIGINT(),
+        std::vector<core::TypedExprPtr>{
+            std::make_shared<core::FieldAccessTypedExpr>(mapType, column),
+            std::make_shared<core::ConstantTypedExpr>(VARCHAR(), key)},
+        "subscript");
+  };
+  std::vector<core::TypedExprPtr> exprs = {
+      std::make_shared<core::CallTypedExpr>(
+          BIGINT(),
+          std::vector<core::TypedExprPtr>{
+              subscript("features", "a"), subscript("features", "b")},
+          "plus"),
+      std::make_shared<core::CallTypedExpr>(
+          BIGINT(),
+          std::vector<core::TypedExprPtr>{
+              std::make_shared<core::FieldAccessTypedExpr>(mapType, "other")},
+          "cardinality")};
+
+  auto result = addRequiredSubfields(assignments, exprs);
+  ASSERT_EQ(result.size(), 2);
+  ASSERT_EQ(result["other"], assignments["other"]);
+  auto* features = dynamic_cast<HiveColumnHandle*>(result["features"].get());
+  ASSERT_NE(features, assignments["features"].get());
+  ASSERT_EQ(features->name(), "c0");
+  const auto& subfields = features->requiredSubfields();
+  ASSERT_EQ(subfields.size(), 2);
+  ASSERT_EQ(subfields[0], Subfield("c0[\"a\"]"));
+  ASSERT_EQ(subfields[1], Subfield("c0[\"b\"]"));
+
+  // Only the required keys are read.
+  auto rowType = ROW({"c0"}, {mapType});
+  auto scanSpec =
+      HiveDataSource::makeScanSpec({}, rowType, {features}, pool_.get());
+  auto* keys =
+      scanSpec->childByName("c0")->childByName(ScanSpec::kMapKeysFieldName);
+  ASSERT_TRUE(keys->filter());
+  ASSERT_TRUE(keys->filter()->testBytes("a", 1));
+  ASSERT_FALSE(keys->filter()->testBytes("c", 1));
+}
+
 } // namespace
 } // namespace facebook::velox::connector::hive
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/connectors/hive/HiveSplitUtil.h"
+#include "velox/common/base/tests/GTestUtils.h"
+
+#include "gtest/gtest.h"
+
+using namespace facebook::velox::connector::hive;
+using namespace facebook::velox;
+
+using dwio::common::FileStripe;
+
+namespace {
+void assertContiguous(const std::vector<SplitRange>& ranges, uint64_t size) {
+  ASSERT_FALSE(ranges.empty());
+  ASSERT_EQ(ranges.front().start, 0);
+  for (size_t i = 1; i < ranges.size(); ++i) {
+    ASSERT_EQ(ranges[i].start, ranges[i - 1].start + ranges[i - 1].length);
+  }
+  ASSERT_EQ(ranges.back().start + ranges.back().length, size);
+}
+} // namespace
+
+TEST(HiveSplitUtilTest, balanced) {
+  // 10 stripes of 100 bytes and 1000 rows after a 3 byte header.
+  std::vector<FileStripe> stripes;
+  for (auto i = 0; i < 10; ++i) {
+    stripes.push_back({3 + i * 100ul, 100, 1'000});
+  }
+  const uint64_t fileSize = 1'100;
+
+  // A target of 400 bytes makes 3 splits of 4, 3 and 3 stripes instead of 4,
+  // 4 and 2.
+  auto ranges = makeAlignedSplitRanges(stripes, fileSize, 400);
+  assertContiguous(ranges, fileSize);
+  ASSERT_EQ(ranges.size(), 3);
+  ASSERT_EQ(ranges[0].numRows, 4'000);
+  ASSERT_EQ(ranges[1].numRows, 3'000);
+  ASSERT_EQ(ranges[2].numRows, 3'000);
+  ASSERT_EQ(ranges[1].start, 403);
+  ASSERT_EQ(ranges[2].start, 703);
+
+  // The row target splits more finely than the byte target.
+  ranges = makeAlignedSplitRanges(stripes, fileSize, 1'000, 2'000);
+  assertContiguous(ranges, fileSize);
+  ASSERT_EQ(ranges.size(), 5);
+  for (auto& range : ranges) {
+    ASSERT_EQ(range.numRows, 2'000);
+  }
+
+  // No more splits than stripes.
+  ranges = makeAlignedSplitRanges(stripes, fileSize, 1);
+  assertContiguous(ranges, fileSize);
+  ASSERT_EQ(ranges.size(), 10);
+
+  ranges = makeAlignedSplitRanges(stripes, fileSize, 1ul << 30);
+  ASSERT_EQ(ranges.size(), 1);
+  ASSERT_EQ(ranges[0].numRows, 10'000);
+  assertContiguous(ranges, fileSize);
+}
+
+TEST(HiveSplitUtilTest, largeStripe) {
+  // A large stripe gets a split of its own and the small stripes after it are
+  // not split one per stripe.
+  std::vector<FileStripe> stripes{{0, 800, 800}};
+  for (auto i = 0; i < 8; ++i) {
+    stripes.push_back({800 + i * 100ul, 100, 100});
+  }
+  auto ranges = makeAlignedSplitRanges(stripes, 1'600, 400);
+  assertContiguous(ranges, 1'600);
+  ASSERT_EQ(ranges.size(), 3);
+  ASSERT_EQ(ranges[0].length, 800);
+  ASSERT_EQ(ranges[1].length, 400);
+  ASSERT_EQ(ranges[2].length, 400);
+}
+
+TEST(HiveSplitUtilTest, noStripes) {
+  auto ranges = makeAlignedSplitRanges({}, 1'000, 100);
+  ASSERT_EQ(ranges.size(), 1);
+  ASSERT_EQ(ranges[0].start, 0);
+  ASSERT_EQ(ranges[0].length, 1'000);
+  VELOX_ASSERT_THROW(makeAlignedSplitRanges({}, 1'000, 0), "(0 vs. 0)");
+}
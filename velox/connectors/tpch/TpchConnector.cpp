@@ -63,8 +63,10 @@ TpchDataSource::TpchDataSource(
     const std::unordered_map<
         std::string,
         std::shared_ptr<connector::ColumnHandle>>& columnHandles,
-    velox::memory::MemoryPool* FOLLY_NONNULL pool)
-    : pool_(pool) {
+    velox::memory::MemoryPool* FOLLY_NONNULL pool,
+    folly::Executor* FOLLY_NULLABLE executor,
+    int32_t parallelChunks)
+    : pool_(pool), executor_(executor), parallelChunks_(parallelChunks) {
   auto tpchTableHandle =
       std::dynamic_pointer_cast<TpchTableHandle>(tableHandle);
   VELOX_CHECK_NOT_NULL(
@@ -105,6 +107,10 @@ TpchDataSource::TpchDataSource(
   outputType_ = outputType;
 }
 
+TpchDataSource::~TpchDataSource() {
+  clearPendingChunks();
+}
+
 RowVectorPtr TpchDataSource::projectOutputColumns(RowVectorPtr inputVector) {
   std::vector<VectorPtr> children;
   children.reserve(outputColumnMappings_.size());
@@ -136,26 +142,73 @@ void TpchDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
   splitEnd_ = splitOffset_ + partSize;
 }
 
+RowVectorPtr TpchDataSource::generateChunk(uint64_t size) {
+  size_t maxRows = std::min(size, (splitEnd_ - splitOffset_));
+  auto outputVector =
+      getTpchData(tpchTable_, maxRows, splitOffset_, scaleFactor_, pool_);
+
+  // splitOffset needs to advance based on maxRows passed to getTpchData(), and
+  // not the actual number of returned rows in the output vector, as they are
+  // not the same for lineitem.
+  splitOffset_ += maxRows;
+  return outputVector;
+}
+
+void TpchDataSource::scheduleChunks(uint64_t size) {
+  if (executor_ == nullptr) {
+    return;
+  }
+  // Each chunk is generated with its own DBGenIterator seeded for its offset,
+  // so the chunks are the same as if generated one after the other.
+  const auto numRows = std::min<uint64_t>(splitEnd_, tpchTableRowCount_);
+  while (pendingChunks_.size() + 1 < static_cast<size_t>(parallelChunks_) &&
+         splitOffset_ < numRows) {
+    size_t maxRows = std::min(size, (splitEnd_ - splitOffset_));
+    pendingChunks_.push_back(
+        folly::via(
+            executor_,
+            [table = tpchTable_,
+             maxRows,
+             offset = splitOffset_,
+             scaleFactor = scaleFactor_,
+             pool = pool_]() {
+              return getTpchData(table, maxRows, offset, scaleFactor, pool);
+            })
+            .semi());
+    splitOffset_ += maxRows;
+  }
+}
+
+void TpchDataSource::clearPendingChunks() {
+  for (auto& chunk : pendingChunks_) {
+    std::move(chunk).wait();
+  }
+  pendingChunks_.clear();
+}
+
 std::optional<RowVectorPtr> TpchDataSource::next(
     uint64_t size,
     velox::ContinueFuture& /*future*/) {
   VELOX_CHECK_NOT_NULL(
       currentSplit_, "No split to process. Call addSplit() first.");
 
-  size_t maxRows = std::min(size, (splitEnd_ - splitOffset_));
-  auto outputVector =
-      getTpchData(tpchTable_, maxRows, splitOffset_, scaleFactor_, pool_);
+  RowVectorPtr outputVector;
+  if (!pendingChunks_.empty()) {
+    auto chunk = std::move(pendingChunks_.front());
+    pendingChunks_.pop_front();
+    outputVector = std::move(chunk).get();
+  } else {
+    outputVector = generateChunk(size);
+  }
 
   // If the split is exhausted.
   if (!outputVector || outputVector->size() == 0) {
+    clearPendingChunks();
     currentSplit_ = nullptr;
     return nullptr;
   }
 
-  // splitOffset needs to advance based on maxRows passed to getTpchData(), and
-  // not the actual number of returned rows in the output vector, as they are
-  // not the same for lineitem.
-  splitOffset_ += maxRows;
+  scheduleChunks(size);
   completedRows_ += outputVector->size();
   completedBytes_ += outputVector->retainedSize();
 
@@ -15,6 +15,9 @@
  */
 #pragma once
 
+#include <folly/futures/Future.h>
+#include <deque>
+
 #include "velox/connectors/Connector.h"
 #include "velox/connectors/tpch/TpchConnectorSplit.h"
 #include "velox/tpch/gen/TpchGen.h"
@@ -75,7 +78,11 @@ class TpchDataSource : public DataSource {
       const std::unordered_map<
           std::string,
           std::shared_ptr<connector::ColumnHandle>>& columnHandles,
-      velox::memory::MemoryPool* FOLLY_NONNULL pool);
+      velox::memory::MemoryPool* FOLLY_NONNULL pool,
+      folly::Executor* FOLLY_NULLABLE executor = nullptr,
+      int32_t parallelChunks = 1);
+
+  ~TpchDataSource() override;
 
   void addSplit(std::shared_ptr<ConnectorSplit> split) override;
 
@@ -104,6 +111,17 @@ class TpchDataSource : public DataSource {
  private:
   RowVectorPtr projectOutputColumns(RowVectorPtr vector);
 
+  // Returns the next chunk of up to 'size' rows of the current split and
+  // advances 'splitOffset_'.
+  RowVectorPtr generateChunk(uint64_t size);
+
+  // Starts generating the chunks following the current one on 'executor_'
+  // until 'parallelChunks_' chunks are in flight.
+  void scheduleChunks(uint64_t size);
+
+  // Waits for the chunks generated in the background and drops them.
+  void clearPendingChunks();
+
   velox::tpch::Table tpchTable_;
   double scaleFactor_{1.0};
   size_t tpchTableRowCount_{0};
@@ -124,15 +142,36 @@ class TpchDataSource : public DataSource {
   size_t completedBytes_{0};
 
   memory::MemoryPool* FOLLY_NONNULL pool_;
+
+  // Executor for generating the chunks of a split in parallel, nullptr if
+  // all chunks are generated on the driver thread.
+  folly::Executor* FOLLY_NULLABLE const executor_;
+
+  // Maximum number of chunks of a split generated at the same time,
+  // including the one generated on the driver thread.
+  const int32_t parallelChunks_;
+
+  // Chunks of the current split generated in the background, in split order.
+  std::deque<folly::SemiFuture<RowVectorPtr>> pendingChunks_;
 };
 
 class TpchConnector final : public Connector {
  public:
+  /// Maximum number of chunks of a split generated in parallel on the
+  /// connector executor. 1 generates all chunks on the driver thread.
+  static constexpr const char* kParallelChunks = "tpch.parallel-chunks";
+
   TpchConnector(
       const std::string& id,
       std::shared_ptr<const Config> properties,
-      folly::Executor* FOLLY_NULLABLE /*executor*/)
-      : Connector(id, properties) {}
+      folly::Executor* FOLLY_NULLABLE executor)
+      : Connector(id, properties),
+        executor_(executor),
+        parallelChunks_(
+            properties ? properties->get<int32_t>(kParallelChunks, 1) : 1) {
+    VELOX_USER_CHECK_GE(
+        parallelChunks_, 1, "{} must be at least 1", kParallelChunks);
+  }
 
   std::shared_ptr<DataSource> createDataSource(
       const std::shared_ptr<const RowType>& outputType,
@@ -145,7 +184,9 @@ class TpchConnector final : public Connector {
         outputType,
         tableHandle,
         columnHandles,
-        connectorQueryCtx->memoryPool());
+        connectorQueryCtx->memoryPool(),
+        executor_,
+        parallelChunks_);
   }
 
   std::shared_ptr<DataSink> createDataSink(
@@ -156,6 +197,10 @@ class TpchConnector final : public Connector {
       CommitStrategy /*commitStrategy*/) override final {
     VELOX_NYI("TpchConnector does not support data sink.");
   }
+
+ private:
+  folly::Executor* FOLLY_NULLABLE const executor_;
+  const int32_t parallelChunks_;
 };
 
 class TpchConnectorFactory : public ConnectorFactory {
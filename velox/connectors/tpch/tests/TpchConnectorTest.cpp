@@ -15,6 +15,7 @@
  */
 
 #include "velox/connectors/tpch/TpchConnector.h"
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/init/Init.h>
 #include "gtest/gtest.h"
 #include "velox/common/base/tests/GTestUtils.h"
@@ -283,6 +284,37 @@ TEST_F(TpchConnectorTest, orderDateCount) {
   EXPECT_EQ(9, orderDate->size());
 }
 
+// Generates the chunks of a split in parallel on the connector executor and
+// checks that the result is the same as when generated on the driver thread.
+TEST_F(TpchConnectorTest, parallelChunks) {
+  auto plan = PlanBuilder()
+                  .tableScan(
+                      Table::TBL_LINEITEM,
+                      {"l_orderkey", "l_linenumber", "l_comment"},
+                      0.01)
+                  .planNode();
+  auto runQuery = [&]() {
+    return exec::test::AssertQueryBuilder(plan)
+        .split(makeTpchSplit(2, 1))
+        .config(core::QueryConfig::kPreferredOutputBatchSize, "1000")
+        .copyResults(pool());
+  };
+  auto expected = runQuery();
+
+  auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(4);
+  connector::unregisterConnector(kTpchConnectorId);
+  connector::registerConnector(
+      connector::getConnectorFactory(
+          connector::tpch::TpchConnectorFactory::kTpchConnectorName)
+          ->newConnector(
+              kTpchConnectorId,
+              std::make_shared<core::MemConfig>(
+                  std::unordered_map<std::string, std::string>{
+                      {TpchConnector::kParallelChunks, "4"}}),
+              executor.get()));
+  test::assertEqualVectors(expected, runQuery());
+}
+
 } // namespace
 
 int main(int argc, char** argv) {
@@ -102,6 +102,31 @@ AggregationNode::AggregationNode(
     const std::vector<FieldAccessTypedExprPtr>& aggregateMasks,
     bool ignoreNullKeys,
     PlanNodePtr source)
+    : AggregationNode(
+          id,
+          step,
+          groupingKeys,
+          preGroupedKeys,
+          aggregateNames,
+          aggregates,
+          aggregateMasks,
+          {},
+          {},
+          ignoreNullKeys,
+          std::move(source)) {}
+
+AggregationNode::AggregationNode(
+    const PlanNodeId& id,
+    Step step,
+    const std::vector<FieldAccessTypedExprPtr>& groupingKeys,
+    const std::vector<FieldAccessTypedExprPtr>& preGroupedKeys,
+    const std::vector<std::string>& aggregateNames,
+    const std::vector<CallTypedExprPtr>& aggregates,
+    const std::vector<FieldAccessTypedExprPtr>& aggregateMasks,
+    const std::vector<bool>& distinctAggregates,
+    const std::vector<AggregateOrderBy>& aggregateOrderBy,
+    bool ignoreNullKeys,
+    PlanNodePtr source)
     : PlanNode(id),
       step_(step),
       groupingKeys_(groupingKeys),
@@ -109,6 +134,8 @@ AggregationNode::AggregationNode(
       aggregateNames_(aggregateNames),
       aggregates_(aggregates),
       aggregateMasks_(aggregateMasks),
+      distinctAggregates_(distinctAggregates),
+      aggregateOrderBy_(aggregateOrderBy),
       ignoreNullKeys_(ignoreNullKeys),
       sources_{source},
       outputType_(getAggregationOutputType(
@@ -136,6 +163,40 @@ AggregationNode::AggregationNode(
         "Pre-grouped key must be one of the grouping keys: {}.",
         key->name());
   }
+
+  VELOX_CHECK_LE(
+      distinctAggregates_.size(),
+      aggregates_.size(),
+      "More distinct flags than aggregates");
+  if (std::find(distinctAggregates_.begin(), distinctAggregates_.end(), true) !=
+      distinctAggregates_.end()) {
+    VELOX_USER_CHECK(
+        step_ == Step::kSingle,
+        "Distinct aggregates are only supported in a single step aggregation");
+  }
+
+  VELOX_CHECK_LE(
+      aggregateOrderBy_.size(),
+      aggregates_.size(),
+      "More ORDER BY clauses than aggregates");
+  for (const auto& orderBy : aggregateOrderBy_) {
+    VELOX_CHECK_EQ(
+        orderBy.sortingKeys.size(),
+        orderBy.sortingOrders.size(),
+        "Number of sorting keys and sorting orders of an aggregate must match");
+  }
+  if (hasOrderedAggregates()) {
+    VELOX_USER_CHECK(
+        step_ == Step::kSingle,
+        "Ordered aggregates are only supported in a single step aggregation");
+  }
+}
+
+bool AggregationNode::hasOrderedAggregates() const {
+  return std::any_of(
+      aggregateOrderBy_.begin(),
+      aggregateOrderBy_.end(),
+      [](const auto& orderBy) { return !orderBy.empty(); });
 }
 
 namespace {
@@ -168,6 +229,36 @@ void addKeys(std::stringstream& stream, const std::vector<TypedExprPtr>& keys) {
     }
   }
 }
+
+void addSortingKeys(
+    std::stringstream& stream,
+    const std::vector<FieldAccessTypedExprPtr>& sortingKeys,
+    const std::vector<SortOrder>& sortingOrders) {
+  for (auto i = 0; i < sortingKeys.size(); ++i) {
+    if (i > 0) {
+      stream << ", ";
+    }
+    stream << sortingKeys[i]->name() << " " << sortingOrders[i].toString();
+  }
+}
+
+folly::dynamic serializeSortingOrders(
+    const std::vector<SortOrder>& sortingOrders) {
+  auto array = folly::dynamic::array();
+  for (const auto& order : sortingOrders) {
+    array.push_back(order.serialize());
+  }
+
+  return array;
+}
+
+std::vector<SortOrder> deserializeSortingOrders(const folly::dynamic& array) {
+  std::vector<SortOrder> sortingOrders;
+  for (const auto& order : array) {
+    sortingOrders.push_back(SortOrder::deserialize(order));
+  }
+  return sortingOrders;
+}
 } // namespace
 
 void AggregationNode::addDetails(std::stringstream& stream) const {
@@ -184,6 +275,16 @@ void AggregationNode::addDetails(std::stringstream& stream) const {
       stream << ", ";
     }
     stream << aggregateNames_[i] << " := " << aggregates_[i]->toString();
+    if (isDistinctAggregate(i)) {
+      stream << " distinct";
+    }
+    if (isOrderedAggregate(i)) {
+      stream << " order by: ";
+      addSortingKeys(
+          stream,
+          aggregateOrderBy_[i].sortingKeys,
+          aggregateOrderBy_[i].sortingOrders);
+    }
     if (aggregateMasks_.size() > i && aggregateMasks_[i]) {
       stream << " mask: " << aggregateMasks_[i]->name();
     }
@@ -239,6 +340,24 @@ folly::dynamic AggregationNode::serialize() const {
     }
   }
 
+  if (!distinctAggregates_.empty()) {
+    obj["distinctAggregates"] = folly::dynamic::array;
+    for (bool distinct : distinctAggregates_) {
+      obj["distinctAggregates"].push_back(distinct);
+    }
+  }
+
+  if (hasOrderedAggregates()) {
+    obj["aggregateOrderBy"] = folly::dynamic::array;
+    for (const auto& orderBy : aggregateOrderBy_) {
+      folly::dynamic orderByObj = folly::dynamic::object;
+      orderByObj["sortingKeys"] = ISerializable::serialize(orderBy.sortingKeys);
+      orderByObj["sortingOrders"] =
+          serializeSortingOrders(orderBy.sortingOrders);
+      obj["aggregateOrderBy"].push_back(orderByObj);
+    }
+  }
+
   obj["ignoreNullKeys"] = ignoreNullKeys_;
   return obj;
 }
@@ -251,6 +370,12 @@ std::vector<FieldAccessTypedExprPtr> deserializeFields(
       array, context);
 }
 
+FieldAccessTypedExprPtr deserializeField(
+    const folly::dynamic& obj,
+    void* context) {
+  return ISerializable::deserialize<FieldAccessTypedExpr>(obj, context);
+}
+
 std::vector<std::string> deserializeStrings(const folly::dynamic& array) {
   return ISerializable::deserialize<std::vector<std::string>>(array);
 }
@@ -280,6 +405,22 @@ PlanNodePtr AggregationNode::create(const folly::dynamic& obj, void* context) {
     }
   }
 
+  std::vector<bool> distinctAggregates;
+  if (obj.count("distinctAggregates")) {
+    for (const auto& distinct : obj["distinctAggregates"]) {
+      distinctAggregates.push_back(distinct.asBool());
+    }
+  }
+
+  std::vector<AggregateOrderBy> aggregateOrderBy;
+  if (obj.count("aggregateOrderBy")) {
+    for (const auto& orderBy : obj["aggregateOrderBy"]) {
+      aggregateOrderBy.push_back(
+          {deserializeFields(orderBy["sortingKeys"], context),
+           deserializeSortingOrders(orderBy["sortingOrders"])});
+    }
+  }
+
   return std::make_shared<AggregationNode>(
       deserializePlanNodeId(obj),
       stepFromName(obj["step"].asString()),
@@ -288,6 +429,8 @@ PlanNodePtr AggregationNode::create(const folly::dynamic& obj, void* context) {
       aggregateNames,
       aggregates,
       masks,
+      distinctAggregates,
+      aggregateOrderBy,
       obj["ignoreNullKeys"].asBool(),
       deserializeSingleSource(obj, context));
 }
@@ -850,18 +993,39 @@ CrossJoinNode::CrossJoinNode(
     const PlanNodeId& id,
     PlanNodePtr left,
     PlanNodePtr right,
-    RowTypePtr outputType)
+    RowTypePtr outputType,
+    JoinType joinType,
+    TypedExprPtr filter)
     : PlanNode(id),
       sources_({std::move(left), std::move(right)}),
-      outputType_(std::move(outputType)) {}
+      outputType_(std::move(outputType)),
+      joinType_(joinType),
+      filter_(std::move(filter)) {
+  VELOX_USER_CHECK(
+      isInnerJoin(joinType_) || isLeftJoin(joinType_),
+      "Cross join supports only inner and left joins, not {}",
+      joinTypeName(joinType_));
+}
 
-void CrossJoinNode::addDetails(std::stringstream& /* stream */) const {
-  // Nothing to add.
+void CrossJoinNode::addDetails(std::stringstream& stream) const {
+  if (!isInnerJoin(joinType_)) {
+    stream << joinTypeName(joinType_);
+  }
+  if (filter_) {
+    if (!isInnerJoin(joinType_)) {
+      stream << ", ";
+    }
+    stream << "filter: " << filter_->toString();
+  }
 }
 
 folly::dynamic CrossJoinNode::serialize() const {
   auto obj = PlanNode::serialize();
   obj["outputType"] = outputType_->serialize();
+  obj["joinType"] = joinTypeName(joinType_);
+  if (filter_) {
+    obj["filter"] = filter_->serialize();
+  }
   return obj;
 }
 
@@ -870,10 +1034,95 @@ PlanNodePtr CrossJoinNode::create(const folly::dynamic& obj, void* context) {
   auto sources = deserializeSources(obj, context);
   VELOX_CHECK_EQ(2, sources.size());
 
+  auto joinType = JoinType::kInner;
+  if (obj.count("joinType")) {
+    joinType = joinTypeFromName(obj["joinType"].asString());
+  }
+  TypedExprPtr filter;
+  if (obj.count("filter")) {
+    filter = ISerializable::deserialize<ITypedExpr>(obj["filter"]);
+  }
+
   return std::make_shared<CrossJoinNode>(
       deserializePlanNodeId(obj),
       std::move(sources[0]),
       std::move(sources[1]),
+      deserializeRowType(obj["outputType"]),
+      joinType,
+      std::move(filter));
+}
+
+RangeJoinNode::RangeJoinNode(
+    const PlanNodeId& id,
+    JoinType joinType,
+    FieldAccessTypedExprPtr probeKey,
+    FieldAccessTypedExprPtr lowerKey,
+    FieldAccessTypedExprPtr upperKey,
+    PlanNodePtr left,
+    PlanNodePtr right,
+    RowTypePtr outputType)
+    : PlanNode(id),
+      joinType_(joinType),
+      probeKey_(std::move(probeKey)),
+      lowerKey_(std::move(lowerKey)),
+      upperKey_(std::move(upperKey)),
+      sources_({std::move(left), std::move(right)}),
+      outputType_(std::move(outputType)) {
+  VELOX_USER_CHECK(
+      isInnerJoin(joinType_) || isLeftJoin(joinType_),
+      "Range join supports only inner and left joins, not {}",
+      joinTypeName(joinType_));
+  VELOX_USER_CHECK(
+      probeKey_->type()->isPrimitiveType(),
+      "Range join key must be of a primitive type: {}",
+      probeKey_->type()->toString());
+  VELOX_USER_CHECK(
+      probeKey_->type()->equivalent(*lowerKey_->type()) &&
+          probeKey_->type()->equivalent(*upperKey_->type()),
+      "Range join bounds must be of the same type as the key: {} vs. [{}, {}]",
+      probeKey_->type()->toString(),
+      lowerKey_->type()->toString(),
+      upperKey_->type()->toString());
+  VELOX_USER_CHECK(
+      sources_[0]->outputType()->containsChild(probeKey_->name()),
+      "Range join key not found in left side input: {}",
+      probeKey_->name());
+  VELOX_USER_CHECK(
+      sources_[1]->outputType()->containsChild(lowerKey_->name()) &&
+          sources_[1]->outputType()->containsChild(upperKey_->name()),
+      "Range join bounds not found in right side input: {}, {}",
+      lowerKey_->name(),
+      upperKey_->name());
+}
+
+void RangeJoinNode::addDetails(std::stringstream& stream) const {
+  stream << joinTypeName(joinType_) << " " << probeKey_->name() << " BETWEEN "
+         << lowerKey_->name() << " AND " << upperKey_->name();
+}
+
+folly::dynamic RangeJoinNode::serialize() const {
+  auto obj = PlanNode::serialize();
+  obj["joinType"] = joinTypeName(joinType_);
+  obj["probeKey"] = probeKey_->serialize();
+  obj["lowerKey"] = lowerKey_->serialize();
+  obj["upperKey"] = upperKey_->serialize();
+  obj["outputType"] = outputType_->serialize();
+  return obj;
+}
+
+// static
+PlanNodePtr RangeJoinNode::create(const folly::dynamic& obj, void* context) {
+  auto sources = deserializeSources(obj, context);
+  VELOX_CHECK_EQ(2, sources.size());
+
+  return std::make_shared<RangeJoinNode>(
+      deserializePlanNodeId(obj),
+      joinTypeFromName(obj["joinType"].asString()),
+      deserializeField(obj["probeKey"], context),
+      deserializeField(obj["lowerKey"], context),
+      deserializeField(obj["upperKey"], context),
+      std::move(sources[0]),
+      std::move(sources[1]),
       deserializeRowType(obj["outputType"]));
 }
 
@@ -970,12 +1219,14 @@ WindowNode::WindowNode(
     std::vector<SortOrder> sortingOrders,
     std::vector<std::string> windowColumnNames,
     std::vector<Function> windowFunctions,
+    bool inputsSorted,
     PlanNodePtr source)
     : PlanNode(std::move(id)),
       partitionKeys_(std::move(partitionKeys)),
       sortingKeys_(std::move(sortingKeys)),
       sortingOrders_(std::move(sortingOrders)),
       windowFunctions_(std::move(windowFunctions)),
+      inputsSorted_(inputsSorted),
       sources_{std::move(source)},
       outputType_(getWindowOutputType(
           sources_[0]->outputType(),
@@ -1087,26 +1338,6 @@ WindowNode::Function WindowNode::Function::deserialize(
       obj["ignoreNulls"].asBool()};
 }
 
-namespace {
-folly::dynamic serializeSortingOrders(
-    const std::vector<SortOrder>& sortingOrders) {
-  auto array = folly::dynamic::array();
-  for (const auto& order : sortingOrders) {
-    array.push_back(order.serialize());
-  }
-
-  return array;
-}
-
-std::vector<SortOrder> deserializeSortingOrders(const folly::dynamic& array) {
-  std::vector<SortOrder> sortingOrders;
-  for (const auto& order : array) {
-    sortingOrders.push_back(SortOrder::deserialize(order));
-  }
-  return sortingOrders;
-}
-} // namespace
-
 folly::dynamic WindowNode::serialize() const {
   auto obj = PlanNode::serialize();
   obj["partitionKeys"] = ISerializable::serialize(partitionKeys_);
@@ -1117,6 +1348,7 @@ folly::dynamic WindowNode::serialize() const {
   for (const auto& function : windowFunctions_) {
     obj["functions"].push_back(function.serialize());
   }
+  obj["inputsSorted"] = inputsSorted_;
 
   auto numInputs = sources()[0]->outputType()->size();
   auto numOutputs = outputType()->size();
@@ -1143,6 +1375,8 @@ PlanNodePtr WindowNode::create(const folly::dynamic& obj, void* context) {
   }
 
   auto windowNames = deserializeStrings(obj["names"]);
+  const bool inputsSorted =
+      obj.count("inputsSorted") ? obj["inputsSorted"].asBool() : false;
 
   return std::make_shared<WindowNode>(
       deserializePlanNodeId(obj),
@@ -1151,23 +1385,10 @@ PlanNodePtr WindowNode::create(const folly::dynamic& obj, void* context) {
       sortingOrders,
       windowNames,
       functions,
+      inputsSorted,
       source);
 }
 
-namespace {
-void addSortingKeys(
-    std::stringstream& stream,
-    const std::vector<FieldAccessTypedExprPtr>& sortingKeys,
-    const std::vector<SortOrder>& sortingOrders) {
-  for (auto i = 0; i < sortingKeys.size(); ++i) {
-    if (i > 0) {
-      stream << ", ";
-    }
-    stream << sortingKeys[i]->name() << " " << sortingOrders[i].toString();
-  }
-}
-} // namespace
-
 void LocalMergeNode::addDetails(std::stringstream& stream) const {
   addSortingKeys(stream, sortingKeys_, sortingOrders_);
 }
@@ -1232,7 +1453,9 @@ PlanNodePtr MergeExchangeNode::create(
 
 void LocalPartitionNode::addDetails(std::stringstream& stream) const {
   stream << typeName(type_);
-  if (type_ != Type::kGather) {
+  if (scaleWriter_) {
+    stream << " SCALE_WRITER";
+  } else if (type_ != Type::kGather) {
     stream << " " << partitionFunctionSpec_->toString();
   }
 }
@@ -1241,6 +1464,7 @@ folly::dynamic LocalPartitionNode::serialize() const {
   auto obj = PlanNode::serialize();
   obj["type"] = typeName(type_);
   obj["partitionFunctionSpec"] = partitionFunctionSpec_->serialize();
+  obj["scaleWriter"] = scaleWriter_;
   return obj;
 }
 
@@ -1253,7 +1477,8 @@ PlanNodePtr LocalPartitionNode::create(
       typeFromName(obj["type"].asString()),
       ISerializable::deserialize<PartitionFunctionSpec>(
           obj["partitionFunctionSpec"]),
-      deserializeSources(obj, context));
+      deserializeSources(obj, context),
+      obj.count("scaleWriter") ? obj["scaleWriter"].asBool() : false);
 }
 
 // static
@@ -1456,6 +1681,105 @@ void WindowNode::addDetails(std::stringstream& stream) const {
     stream << outputType_->names()[i] << " := ";
     addWindowFunction(stream, windowFunctions_[i - numInputCols]);
   }
+
+  if (inputsSorted_) {
+    stream << " inputsSorted";
+  }
+}
+
+namespace {
+RowTypePtr getTopNRowNumberOutputType(
+    const RowTypePtr& inputType,
+    const std::optional<std::string>& rowNumberColumnName) {
+  if (!rowNumberColumnName.has_value()) {
+    return inputType;
+  }
+  auto names = inputType->names();
+  auto types = inputType->children();
+  names.push_back(rowNumberColumnName.value());
+  types.push_back(BIGINT());
+  return ROW(std::move(names), std::move(types));
+}
+} // namespace
+
+TopNRowNumberNode::TopNRowNumberNode(
+    PlanNodeId id,
+    std::vector<FieldAccessTypedExprPtr> partitionKeys,
+    std::vector<FieldAccessTypedExprPtr> sortingKeys,
+    std::vector<SortOrder> sortingOrders,
+    const std::optional<std::string>& rowNumberColumnName,
+    int32_t limit,
+    PlanNodePtr source)
+    : PlanNode(std::move(id)),
+      partitionKeys_(std::move(partitionKeys)),
+      sortingKeys_(std::move(sortingKeys)),
+      sortingOrders_(std::move(sortingOrders)),
+      limit_(limit),
+      sources_{std::move(source)},
+      outputType_(getTopNRowNumberOutputType(
+          sources_[0]->outputType(),
+          rowNumberColumnName)) {
+  VELOX_USER_CHECK(
+      !sortingKeys_.empty(), "TopNRowNumber must specify sorting keys");
+  VELOX_USER_CHECK_EQ(
+      sortingKeys_.size(),
+      sortingOrders_.size(),
+      "Number of sorting keys must be equal to the number of sorting orders");
+  VELOX_USER_CHECK_GT(
+      limit_, 0, "TopNRowNumber must keep at least one row per partition");
+}
+
+void TopNRowNumberNode::addDetails(std::stringstream& stream) const {
+  stream << "partition by [";
+  if (!partitionKeys_.empty()) {
+    addFields(stream, partitionKeys_);
+  }
+  stream << "] ";
+
+  stream << "order by [";
+  addSortingKeys(stream, sortingKeys_, sortingOrders_);
+  stream << "] ";
+
+  stream << "limit " << limit_;
+  if (generateRowNumber()) {
+    stream << " " << outputType_->names().back() << " := row_number()";
+  }
+}
+
+folly::dynamic TopNRowNumberNode::serialize() const {
+  auto obj = PlanNode::serialize();
+  obj["partitionKeys"] = ISerializable::serialize(partitionKeys_);
+  obj["sortingKeys"] = ISerializable::serialize(sortingKeys_);
+  obj["sortingOrders"] = serializeSortingOrders(sortingOrders_);
+  if (generateRowNumber()) {
+    obj["rowNumberColumnName"] = outputType_->names().back();
+  }
+  obj["limit"] = limit_;
+  return obj;
+}
+
+// static
+PlanNodePtr TopNRowNumberNode::create(
+    const folly::dynamic& obj,
+    void* context) {
+  auto source = deserializeSingleSource(obj, context);
+  auto partitionKeys = deserializeFields(obj["partitionKeys"], context);
+  auto sortingKeys = deserializeFields(obj["sortingKeys"], context);
+  auto sortingOrders = deserializeSortingOrders(obj["sortingOrders"]);
+
+  std::optional<std::string> rowNumberColumnName;
+  if (obj.count("rowNumberColumnName")) {
+    rowNumberColumnName = obj["rowNumberColumnName"].asString();
+  }
+
+  return std::make_shared<TopNRowNumberNode>(
+      deserializePlanNodeId(obj),
+      std::move(partitionKeys),
+      std::move(sortingKeys),
+      std::move(sortingOrders),
+      rowNumberColumnName,
+      obj["limit"].asInt(),
+      std::move(source));
 }
 
 void PlanNode::toString(
@@ -1522,6 +1846,7 @@ void PlanNode::registerSerDe() {
   registry.Register("AggregationNode", AggregationNode::create);
   registry.Register("AssignUniqueIdNode", AssignUniqueIdNode::create);
   registry.Register("CrossJoinNode", CrossJoinNode::create);
+  registry.Register("RangeJoinNode", RangeJoinNode::create);
   registry.Register("EnforceSingleRowNode", EnforceSingleRowNode::create);
   registry.Register("ExchangeNode", ExchangeNode::create);
   registry.Register("FilterNode", FilterNode::create);
@@ -1538,6 +1863,7 @@ void PlanNode::registerSerDe() {
   registry.Register("TableScanNode", TableScanNode::create);
   registry.Register("TableWriteNode", TableWriteNode::create);
   registry.Register("TopNNode", TopNNode::create);
+  registry.Register("TopNRowNumberNode", TopNRowNumberNode::create);
   registry.Register("UnnestNode", UnnestNode::create);
   registry.Register("ValuesNode", ValuesNode::create);
   registry.Register("WindowNode", WindowNode::create);
@@ -546,6 +546,17 @@ class AggregationNode : public PlanNode {
 
   static Step stepFromName(const std::string& name);
 
+  /// The ORDER BY clause of an ordered aggregate, e.g. array_agg(a ORDER BY
+  /// b). The aggregate receives the input of each group in this order.
+  struct AggregateOrderBy {
+    std::vector<FieldAccessTypedExprPtr> sortingKeys;
+    std::vector<SortOrder> sortingOrders;
+
+    bool empty() const {
+      return sortingKeys.empty();
+    }
+  };
+
   /**
    * @param preGroupedKeys A subset of the 'groupingKeys' on which the input is
    * clustered, i.e. identical sets of values for these keys always appear next
@@ -566,6 +577,26 @@ class AggregationNode : public PlanNode {
       bool ignoreNullKeys,
       PlanNodePtr source);
 
+  /// @param distinctAggregates True for each aggregate that only adds the
+  /// distinct values of its inputs within each group, e.g. count(DISTINCT a).
+  /// Can be empty or shorter than 'aggregates' if the trailing aggregates are
+  /// not distinct. Only allowed in a single step aggregation.
+  /// @param aggregateOrderBy The ORDER BY clause of each aggregate. Can be
+  /// empty or shorter than 'aggregates' if the trailing aggregates are not
+  /// ordered. Only allowed in a single step aggregation.
+  AggregationNode(
+      const PlanNodeId& id,
+      Step step,
+      const std::vector<FieldAccessTypedExprPtr>& groupingKeys,
+      const std::vector<FieldAccessTypedExprPtr>& preGroupedKeys,
+      const std::vector<std::string>& aggregateNames,
+      const std::vector<CallTypedExprPtr>& aggregates,
+      const std::vector<FieldAccessTypedExprPtr>& aggregateMasks,
+      const std::vector<bool>& distinctAggregates,
+      const std::vector<AggregateOrderBy>& aggregateOrderBy,
+      bool ignoreNullKeys,
+      PlanNodePtr source);
+
   const std::vector<PlanNodePtr>& sources() const override {
     return sources_;
   }
@@ -598,6 +629,30 @@ class AggregationNode : public PlanNode {
     return aggregateMasks_;
   }
 
+  const std::vector<bool>& distinctAggregates() const {
+    return distinctAggregates_;
+  }
+
+  /// Returns true if the aggregate at 'index' only adds the distinct values
+  /// of its inputs.
+  bool isDistinctAggregate(size_t index) const {
+    return index < distinctAggregates_.size() && distinctAggregates_[index];
+  }
+
+  const std::vector<AggregateOrderBy>& aggregateOrderBy() const {
+    return aggregateOrderBy_;
+  }
+
+  /// Returns true if the aggregate at 'index' receives its input in the order
+  /// of an ORDER BY clause.
+  bool isOrderedAggregate(size_t index) const {
+    return index < aggregateOrderBy_.size() &&
+        !aggregateOrderBy_[index].empty();
+  }
+
+  /// Returns true if any aggregate has an ORDER BY clause.
+  bool hasOrderedAggregates() const;
+
   bool ignoreNullKeys() const {
     return ignoreNullKeys_;
   }
@@ -610,9 +665,11 @@ class AggregationNode : public PlanNode {
     // NOTE: as for now, we don't allow spilling for distinct aggregation
     // (https://github.com/facebookincubator/velox/issues/3263) and pre-grouped
     // aggregation (https://github.com/facebookincubator/velox/issues/3264). We
-    // will add support later to re-enable.
+    // will add support later to re-enable. Ordered aggregates buffer their raw
+    // input, which has no intermediate form to spill.
     return (isFinal() || isSingle()) && !(aggregates().empty()) &&
-        preGroupedKeys().empty() && queryConfig.aggregationSpillEnabled();
+        preGroupedKeys().empty() && !hasOrderedAggregates() &&
+        queryConfig.aggregationSpillEnabled();
   }
 
   bool isFinal() const {
@@ -638,6 +695,8 @@ class AggregationNode : public PlanNode {
   // Keeps mask/'no mask' for every aggregation. Mask, if given, is a reference
   // to a boolean projection column, used to mask out rows for the aggregation.
   const std::vector<FieldAccessTypedExprPtr> aggregateMasks_;
+  const std::vector<bool> distinctAggregates_;
+  const std::vector<AggregateOrderBy> aggregateOrderBy_;
   const bool ignoreNullKeys_;
   const std::vector<PlanNodePtr> sources_;
   const RowTypePtr outputType_;
@@ -952,15 +1011,21 @@ class LocalPartitionNode : public PlanNode {
 
   static Type typeFromName(const std::string& name);
 
+  /// @param scaleWriter If true, the exchange feeds table writers and sends
+  /// whole inputs to a number of consumers that starts at one and grows while
+  /// the active consumers do not keep up. 'partitionFunctionSpec' is not used
+  /// then. See exec::ScaleWriterState.
   LocalPartitionNode(
       const PlanNodeId& id,
       Type type,
       PartitionFunctionSpecPtr partitionFunctionSpec,
-      std::vector<PlanNodePtr> sources)
+      std::vector<PlanNodePtr> sources,
+      bool scaleWriter = false)
       : PlanNode(id),
         type_{type},
         sources_{std::move(sources)},
-        partitionFunctionSpec_{std::move(partitionFunctionSpec)} {
+        partitionFunctionSpec_{std::move(partitionFunctionSpec)},
+        scaleWriter_{scaleWriter} {
     VELOX_USER_CHECK_GT(
         sources_.size(),
         0,
@@ -968,6 +1033,10 @@ class LocalPartitionNode : public PlanNode {
 
     VELOX_USER_CHECK_NOT_NULL(partitionFunctionSpec_);
 
+    VELOX_USER_CHECK(
+        !scaleWriter_ || type_ == Type::kRepartition,
+        "Scaled writers require a repartitioning local exchange");
+
     for (auto i = 1; i < sources_.size(); ++i) {
       VELOX_USER_CHECK(
           *sources_[i]->outputType() == *sources_[0]->outputType(),
@@ -1018,6 +1087,10 @@ class LocalPartitionNode : public PlanNode {
     return *partitionFunctionSpec_;
   }
 
+  bool scaleWriter() const {
+    return scaleWriter_;
+  }
+
   std::string_view name() const override {
     return "LocalPartition";
   }
@@ -1032,6 +1105,7 @@ class LocalPartitionNode : public PlanNode {
   const Type type_;
   const std::vector<PlanNodePtr> sources_;
   const PartitionFunctionSpecPtr partitionFunctionSpec_;
+  const bool scaleWriter_;
 };
 
 class PartitionedOutputNode : public PlanNode {
@@ -1495,11 +1569,19 @@ class MergeJoinNode : public AbstractJoinNode {
 // Cross join.
 class CrossJoinNode : public PlanNode {
  public:
+  /// @param joinType kInner or kLeft. A left join returns the left rows
+  /// without a right row passing 'filter' once, with nulls in the right side
+  /// columns.
+  /// @param filter Optional join condition over the columns of both sides.
+  /// Evaluated while producing the cross product, so that only the pairs of
+  /// rows that pass are materialized.
   CrossJoinNode(
       const PlanNodeId& id,
       PlanNodePtr left,
       PlanNodePtr right,
-      RowTypePtr outputType);
+      RowTypePtr outputType,
+      JoinType joinType = JoinType::kInner,
+      TypedExprPtr filter = nullptr);
 
   const std::vector<PlanNodePtr>& sources() const override {
     return sources_;
@@ -1509,10 +1591,85 @@ class CrossJoinNode : public PlanNode {
     return outputType_;
   }
 
+  JoinType joinType() const {
+    return joinType_;
+  }
+
+  const TypedExprPtr& filter() const {
+    return filter_;
+  }
+
   std::string_view name() const override {
     return "CrossJoin";
   }
 
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    return queryConfig.joinSpillEnabled();
+  }
+
+  folly::dynamic serialize() const override;
+
+  static PlanNodePtr create(const folly::dynamic& obj, void* context);
+
+ private:
+  void addDetails(std::stringstream& stream) const override;
+
+  const std::vector<PlanNodePtr> sources_;
+  const RowTypePtr outputType_;
+  const JoinType joinType_;
+  const TypedExprPtr filter_;
+};
+
+/// Joins each left row with the right rows whose [lower, upper] range
+/// contains the left row's key, i.e. 'probeKey' BETWEEN 'lowerKey' AND
+/// 'upperKey'. The right side is sorted on 'lowerKey' and the left rows find
+/// their candidates by binary search instead of going through the cross
+/// product. Right rows with a null bound never match.
+class RangeJoinNode : public PlanNode {
+ public:
+  /// @param joinType kInner or kLeft. A left join returns the left rows
+  /// without a matching range once, with nulls in the right side columns.
+  /// @param probeKey Left side column. Must be of the same type as the bounds.
+  /// @param lowerKey Right side column with the inclusive lower bound.
+  /// @param upperKey Right side column with the inclusive upper bound.
+  RangeJoinNode(
+      const PlanNodeId& id,
+      JoinType joinType,
+      FieldAccessTypedExprPtr probeKey,
+      FieldAccessTypedExprPtr lowerKey,
+      FieldAccessTypedExprPtr upperKey,
+      PlanNodePtr left,
+      PlanNodePtr right,
+      RowTypePtr outputType);
+
+  const std::vector<PlanNodePtr>& sources() const override {
+    return sources_;
+  }
+
+  const RowTypePtr& outputType() const override {
+    return outputType_;
+  }
+
+  JoinType joinType() const {
+    return joinType_;
+  }
+
+  const FieldAccessTypedExprPtr& probeKey() const {
+    return probeKey_;
+  }
+
+  const FieldAccessTypedExprPtr& lowerKey() const {
+    return lowerKey_;
+  }
+
+  const FieldAccessTypedExprPtr& upperKey() const {
+    return upperKey_;
+  }
+
+  std::string_view name() const override {
+    return "RangeJoin";
+  }
+
   folly::dynamic serialize() const override;
 
   static PlanNodePtr create(const folly::dynamic& obj, void* context);
@@ -1520,6 +1677,10 @@ class CrossJoinNode : public PlanNode {
  private:
   void addDetails(std::stringstream& stream) const override;
 
+  const JoinType joinType_;
+  const FieldAccessTypedExprPtr probeKey_;
+  const FieldAccessTypedExprPtr lowerKey_;
+  const FieldAccessTypedExprPtr upperKey_;
   const std::vector<PlanNodePtr> sources_;
   const RowTypePtr outputType_;
 };
@@ -1921,6 +2082,10 @@ class WindowNode : public PlanNode {
   /// @param windowColumnNames specifies the output column
   /// names for each window function column. So
   /// windowColumnNames.length() = windowFunctions.length().
+  /// @param inputsSorted specifies whether the input is already sorted by
+  /// the partition keys followed by the sorting keys. If true, the window
+  /// functions are computed in a streaming fashion and each partition is
+  /// output as soon as all its rows have been received.
   WindowNode(
       PlanNodeId id,
       std::vector<FieldAccessTypedExprPtr> partitionKeys,
@@ -1928,6 +2093,7 @@ class WindowNode : public PlanNode {
       std::vector<SortOrder> sortingOrders,
       std::vector<std::string> windowColumnNames,
       std::vector<Function> windowFunctions,
+      bool inputsSorted,
       PlanNodePtr source);
 
   const std::vector<PlanNodePtr>& sources() const override {
@@ -1956,6 +2122,19 @@ class WindowNode : public PlanNode {
     return windowFunctions_;
   }
 
+  bool inputsSorted() const {
+    return inputsSorted_;
+  }
+
+  /// Spilling only applies to windows with partition keys. The rows of a
+  /// single partition must all be in memory to evaluate the window functions.
+  /// A window over sorted input holds only one partition at a time and
+  /// doesn't need to spill.
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    return !partitionKeys_.empty() && !inputsSorted_ &&
+        queryConfig.windowSpillEnabled();
+  }
+
   std::string_view name() const override {
     return "Window";
   }
@@ -1974,6 +2153,80 @@ class WindowNode : public PlanNode {
 
   const std::vector<Function> windowFunctions_;
 
+  const bool inputsSorted_;
+
+  const std::vector<PlanNodePtr> sources_;
+
+  const RowTypePtr outputType_;
+};
+
+/// Keeps the first 'limit' rows of each partition in the order of the sorting
+/// keys. This is the same as filtering the output of a row_number() window
+/// function over the partition and sorting keys on row_number <= limit, but
+/// holds at most 'limit' rows per partition instead of all the input. The
+/// output rows of a partition are in the order of the sorting keys.
+class TopNRowNumberNode : public PlanNode {
+ public:
+  /// @param rowNumberColumnName Optional name of a BIGINT column appended to
+  /// the input columns with the row number of each output row within its
+  /// partition. A partial step before an exchange leaves it out; the final
+  /// step after the exchange then keeps the top rows of the partial results
+  /// and numbers them.
+  TopNRowNumberNode(
+      PlanNodeId id,
+      std::vector<FieldAccessTypedExprPtr> partitionKeys,
+      std::vector<FieldAccessTypedExprPtr> sortingKeys,
+      std::vector<SortOrder> sortingOrders,
+      const std::optional<std::string>& rowNumberColumnName,
+      int32_t limit,
+      PlanNodePtr source);
+
+  const std::vector<PlanNodePtr>& sources() const override {
+    return sources_;
+  }
+
+  const RowTypePtr& outputType() const override {
+    return outputType_;
+  }
+
+  const std::vector<FieldAccessTypedExprPtr>& partitionKeys() const {
+    return partitionKeys_;
+  }
+
+  const std::vector<FieldAccessTypedExprPtr>& sortingKeys() const {
+    return sortingKeys_;
+  }
+
+  const std::vector<SortOrder>& sortingOrders() const {
+    return sortingOrders_;
+  }
+
+  int32_t limit() const {
+    return limit_;
+  }
+
+  bool generateRowNumber() const {
+    return outputType_->size() > sources_[0]->outputType()->size();
+  }
+
+  std::string_view name() const override {
+    return "TopNRowNumber";
+  }
+
+  folly::dynamic serialize() const override;
+
+  static PlanNodePtr create(const folly::dynamic& obj, void* context);
+
+ private:
+  void addDetails(std::stringstream& stream) const override;
+
+  const std::vector<FieldAccessTypedExprPtr> partitionKeys_;
+
+  const std::vector<FieldAccessTypedExprPtr> sortingKeys_;
+  const std::vector<SortOrder> sortingOrders_;
+
+  const int32_t limit_;
+
   const std::vector<PlanNodePtr> sources_;
 
   const RowTypePtr outputType_;
@@ -61,11 +61,79 @@ class QueryConfig {
   static constexpr const char* kExprTrackCpuUsage =
       "expression.track_cpu_usage";
 
+  // When expression.track_cpu_usage is false, times every Nth batch evaluated
+  // by each function call and special form, so that the CPU time of
+  // expressions can be estimated at a negligible cost. 0 disables sampling.
+  static constexpr const char* kExprSampleCpuEvery =
+      "expression.sample_cpu_every";
+
+  // Maximum number of distinct argument values for which a deterministic
+  // function call with a single non-constant VARCHAR or VARBINARY argument
+  // remembers the results across batches. Helps expensive functions, e.g.
+  // regular expressions or JSON and URL parsing, over low cardinality
+  // columns. 0 (default) disables the memo.
+  static constexpr const char* kExprValueMemoMaxEntries =
+      "expression.value_memo_max_entries";
+
+  // Whether to evaluate trees of plus, minus and multiply over REAL or DOUBLE
+  // values, optionally topped by a comparison, in a single loop over
+  // cache-sized chunks of rows instead of materializing a vector per node.
+  // The fused loop assumes the Presto semantics of these functions. False by
+  // default.
+  static constexpr const char* kExprFuseArithmetic =
+      "expression.fuse_arithmetic";
+
+  // Whether the Drivers of a Task share the instances of stateful vector
+  // functions made for calls with the same name, input types and constant
+  // inputs instead of each compiling its own. False by default.
+  static constexpr const char* kExprShareVectorFunctions =
+      "expression.share_vector_functions";
+
+  // The maximum number of batches an ArrowStream operator fetches ahead of
+  // its consumer on the query executor. When 0, the batches are fetched on
+  // the driver thread.
+  static constexpr const char* kArrowStreamPrefetchBatches =
+      "arrow_stream.prefetch_batches";
+
   // Whether to track CPU usage for stages of individual operators. True by
   // default. Can be expensive when processing small batches, e.g. < 10K rows.
   static constexpr const char* kOperatorTrackCpuUsage =
       "driver.track_operator_cpu_usage";
 
+  // Whether to count the cycles, instructions, last level cache misses, data
+  // TLB misses and branch misses of each operator call with perf_event
+  // hardware counters. The counts are added to the runtime stats of the
+  // operator as perfCycles, perfInstructions, perfLlcMisses, perfDtlbMisses
+  // and perfBranchMisses. False by default. Ignored where the counters are
+  // not available, e.g. when kernel.perf_event_paranoid is above 2.
+  static constexpr const char* kOperatorTrackPerfCounters =
+      "driver.track_operator_perf_counters";
+
+  // Maximum wall time in milliseconds a Driver runs on a thread before it
+  // yields at the next operator boundary and goes to the back of the executor
+  // queue. Lets other queries run between the slices of long running ones. 0
+  // means no limit, the default.
+  static constexpr const char* kDriverTimeSliceMs = "driver.time_slice_ms";
+
+  // Percentage of Drivers, 0 to 100, that record a timeline of their runs,
+  // queue waits and blocked waits in TaskStats::driverTimeline. Each Driver
+  // is sampled at random when created. 0, the default, disables the timeline.
+  static constexpr const char* kDriverTimelineSamplePct =
+      "driver.timeline_sample_pct";
+
+  // If true, a table scan driver that runs out of splits waits for the other
+  // drivers of the scan to give it the unread stripes of their splits instead
+  // of finishing while they are still reading.
+  static constexpr const char* kTableScanSplitStealing =
+      "table_scan.split_stealing";
+
+  // If true, a pipeline starting with a table scan starts with one Driver
+  // and adds its other Drivers one at a time while splits are queued for the
+  // scan. Leaves threads to the other pipelines while the scan has little
+  // work.
+  static constexpr const char* kAdaptiveScanDrivers =
+      "driver.adaptive_scan_drivers";
+
   // Flags used to configure the CAST operator:
 
   // This flag makes the Row conversion to by applied
@@ -82,9 +150,39 @@ class QueryConfig {
   static constexpr const char* kMaxLocalExchangeBufferSize =
       "max_local_exchange_buffer_size";
 
+  /// If true, a local exchange consumer combines the small dictionary
+  /// wrapped partitions that are queued together into one batch of up to
+  /// kPreferredOutputBatchSize rows. Copies only the rows of the partitions.
+  static constexpr const char* kLocalExchangeCoalesceBatches =
+      "local_exchange_coalesce_batches";
+
+  /// A local exchange that scales table writers activates one more writer
+  /// only after the active writers got this many bytes each since the last
+  /// activation. Small writes so stay on few writers and make few files.
+  static constexpr const char* kScaleWriterMinProcessedBytes =
+      "scale_writer_min_processed_bytes";
+
   static constexpr const char* kMaxPartialAggregationMemory =
       "max_partial_aggregation_memory";
 
+  /// If true, hash aggregations allocate the variable length keys and the
+  /// accumulator memory of their groups append-only. This saves the free
+  /// list overhead of each allocation but memory freed by accumulators is not
+  /// reused until the groups are cleared.
+  static constexpr const char* kAggregationAppendOnlyStrings =
+      "aggregation_append_only_strings";
+
+  /// If true, hash aggregations collect histograms of the allocation sizes,
+  /// free list lengths and free list search steps of the allocator of their
+  /// variable length keys and accumulators, and report them as 'hsa.*'
+  /// runtime stats. See HashStringAllocator::Stats.
+  static constexpr const char* kAggregationTrackAllocatorStats =
+      "aggregation_track_allocator_stats";
+
+  /// If true, hash join build sides and hash aggregations pack the rows of
+  /// their RowContainers. See RowContainer.
+  static constexpr const char* kCompactRowLayout = "compact_row_layout";
+
   static constexpr const char* kMaxExtendedPartialAggregationMemory =
       "max_extended_partial_aggregation_memory";
 
@@ -94,20 +192,87 @@ class QueryConfig {
   static constexpr const char* kPartialAggregationGoodPct =
       "partial_aggregation_reduction_ratio_threshold";
 
+  /// The number of bits of the grouping key hash used to partition the input
+  /// of a final aggregation. Each partition is aggregated independently on the
+  /// driver executor after all the input is received. 0 disables the parallel
+  /// aggregation.
+  static constexpr const char* kAggregationMergePartitionBits =
+      "aggregation_merge_partition_bits";
+
+  /// The number of input rows over which a partial aggregation estimates the
+  /// number of distinct grouping keys. If the estimate is at least
+  /// kAbandonPartialAggregationMinPct % of the rows, the partial aggregation
+  /// stops grouping and passes each input row through as a group of its own.
+  /// 0 disables the estimate.
+  static constexpr const char* kAbandonPartialAggregationMinRows =
+      "abandon_partial_aggregation_min_rows";
+
+  static constexpr const char* kAbandonPartialAggregationMinPct =
+      "abandon_partial_aggregation_min_pct";
+
+  /// The number of groups at which a final or single aggregation with
+  /// spilling enabled checks whether nearly every input row is a group of its
+  /// own. If the groups are at least kAggregationSortBasedMinPct % of the rows
+  /// added since the last such check, all groups are spilled as sorted runs
+  /// and the aggregation continues with an empty hash table. The output then
+  /// merges the sorted runs instead of growing the hash table with the input.
+  /// 0 disables the check.
+  static constexpr const char* kAggregationSortBasedMinGroups =
+      "aggregation_sort_based_min_groups";
+
+  static constexpr const char* kAggregationSortBasedMinPct =
+      "aggregation_sort_based_min_pct";
+
+  /// The number of runs that an order by sorts in parallel on the driver
+  /// executor before merging them into its output. 0 or 1 disables the
+  /// parallel sort.
+  static constexpr const char* kOrderByParallelSortRuns =
+      "order_by_parallel_sort_runs";
+
   static constexpr const char* kMaxPartitionedOutputBufferSize =
       "driver.max-page-partitioning-buffer-size";
 
+  /// The codec to compress the pages exchanged between tasks with. One of
+  /// 'none', 'lz4' or 'zstd'.
+  static constexpr const char* kExchangeCompressionCodec =
+      "exchange_compression_codec";
+
   /// Preffered number of rows to be returned by operators from
   /// Operator::getOutput.
   static constexpr const char* kPreferredOutputBatchSize =
       "preferred_output_batch_size";
 
+  /// Preferred size in bytes of the batches produced by table scans. The
+  /// number of rows read per batch follows from the average row size, observed
+  /// from the batches produced so far or estimated by the data source before
+  /// the first one. Falls back to kPreferredOutputBatchSize rows when the row
+  /// size is unknown.
+  static constexpr const char* kPreferredOutputBatchBytes =
+      "preferred_output_batch_bytes";
+
+  /// If true, the batches produced by filters and hash joins with fewer than
+  /// a quarter of kPreferredOutputBatchSize rows are accumulated into batches
+  /// of kPreferredOutputBatchSize rows before the next operator.
+  static constexpr const char* kCoalesceSmallBatches = "coalesce_small_batches";
+
   static constexpr const char* kHashAdaptivityEnabled =
       "driver.hash_adaptivity_enabled";
 
   static constexpr const char* kAdaptiveFilterReorderingEnabled =
       "driver.adaptive_filter_reordering_enabled";
 
+  /// The maximum number of distinct build side keys of a hash join to make a
+  /// Bloom filter dynamic filter for. 0 disables the Bloom filters.
+  static constexpr const char* kHashJoinBloomFilterMaxEntries =
+      "hash_join_bloom_filter_max_entries";
+
+  /// If true, the tasks of a query running on the same worker share the hash
+  /// table of a hash join build instead of each building its own copy. This
+  /// assumes the build input is the same for all the tasks, e.g. for a
+  /// broadcast join.
+  static constexpr const char* kHashJoinBuildSharingEnabled =
+      "hash_join_build_sharing_enabled";
+
   static constexpr const char* kCreateEmptyFiles = "driver.create_empty_files";
 
   /// Global enable spilling flag.
@@ -126,6 +291,9 @@ class QueryConfig {
   /// OrderBy spilling flag, only applies if "spill_enabled" flag is set.
   static constexpr const char* kOrderBySpillEnabled = "order_by_spill_enabled";
 
+  /// Window spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kWindowSpillEnabled = "window_spill_enabled";
+
   /// The max memory that a final aggregation can use before spilling. If it 0,
   /// then there is no limit.
   static constexpr const char* kAggregationSpillMemoryThreshold =
@@ -141,6 +309,17 @@ class QueryConfig {
   static constexpr const char* kOrderBySpillMemoryThreshold =
       "order_by_spill_memory_threshold";
 
+  /// If true, an order by that exceeds 'order_by_spill_memory_threshold'
+  /// spills a chunk of its rows on the spill executor while it keeps taking
+  /// input, and only blocks if its memory keeps growing while the chunk is
+  /// written.
+  static constexpr const char* kOrderBySpillAsync = "order_by_spill_async";
+
+  /// The max memory that a window operator can use before spilling. If it 0,
+  /// then there is no limit.
+  static constexpr const char* kWindowSpillMemoryThreshold =
+      "window_spill_memory_threshold";
+
   static constexpr const char* kTestingSpillPct = "testing.spill-pct";
 
   /// The max allowed spilling level with zero being the initial spilling level.
@@ -172,11 +351,32 @@ class QueryConfig {
   static constexpr const char* kSpillableReservationGrowthPct =
       "spillable-reservation-growth-pct";
 
+  /// The codec to compress the spilled pages with. One of 'none', 'lz4' or
+  /// 'zstd'. A page that doesn't compress well is written uncompressed.
+  static constexpr const char* kSpillCompressionCodec =
+      "spill_compression_codec";
+
+  /// The max bytes a query can write to spill files, summed over all its
+  /// tasks, operators and spill paths. If it is zero, there is no limit.
+  static constexpr const char* kMaxSpillBytes = "max_spill_bytes";
+
   uint64_t maxPartialAggregationMemoryUsage() const {
     static constexpr uint64_t kDefault = 1L << 24;
     return get<uint64_t>(kMaxPartialAggregationMemory, kDefault);
   }
 
+  bool aggregationAppendOnlyStrings() const {
+    return get<bool>(kAggregationAppendOnlyStrings, false);
+  }
+
+  bool aggregationTrackAllocatorStats() const {
+    return get<bool>(kAggregationTrackAllocatorStats, false);
+  }
+
+  bool compactRowLayout() const {
+    return get<bool>(kCompactRowLayout, false);
+  }
+
   uint64_t maxExtendedPartialAggregationMemoryUsage() const {
     static constexpr uint64_t kDefault = 1L << 24;
     return get<uint64_t>(kMaxExtendedPartialAggregationMemory, kDefault);
@@ -192,6 +392,47 @@ class QueryConfig {
     return get<double>(kPartialAggregationGoodPct, kDefault);
   }
 
+  /// Returns the number of bits used to calculate the aggregation merge
+  /// partition number. The number of partitions will be power of two.
+  ///
+  /// NOTE: as for now, we only support up to 16-way partitioning.
+  int32_t aggregationMergePartitionBits() const {
+    constexpr int32_t kDefaultBits = 0;
+    constexpr int32_t kMaxBits = 4;
+    return std::min(
+        kMaxBits, get<int32_t>(kAggregationMergePartitionBits, kDefaultBits));
+  }
+
+  int64_t abandonPartialAggregationMinRows() const {
+    static constexpr int64_t kDefault = 100'000;
+    return get<int64_t>(kAbandonPartialAggregationMinRows, kDefault);
+  }
+
+  int32_t abandonPartialAggregationMinPct() const {
+    static constexpr int32_t kDefault = 80;
+    return get<int32_t>(kAbandonPartialAggregationMinPct, kDefault);
+  }
+
+  int64_t aggregationSortBasedMinGroups() const {
+    static constexpr int64_t kDefault = 0;
+    return get<int64_t>(kAggregationSortBasedMinGroups, kDefault);
+  }
+
+  int32_t aggregationSortBasedMinPct() const {
+    static constexpr int32_t kDefault = 90;
+    return get<int32_t>(kAggregationSortBasedMinPct, kDefault);
+  }
+
+  /// Returns the number of runs to sort the order by input in parallel.
+  ///
+  /// NOTE: as for now, we only support up to 64 runs.
+  int32_t orderByParallelSortRuns() const {
+    constexpr int32_t kDefaultRuns = 0;
+    constexpr int32_t kMaxRuns = 64;
+    return std::min(
+        kMaxRuns, get<int32_t>(kOrderByParallelSortRuns, kDefaultRuns));
+  }
+
   uint64_t joinSpillMemoryThreshold() const {
     static constexpr uint64_t kDefault = 0;
     return get<uint64_t>(kJoinSpillMemoryThreshold, kDefault);
@@ -202,6 +443,15 @@ class QueryConfig {
     return get<uint64_t>(kOrderBySpillMemoryThreshold, kDefault);
   }
 
+  bool orderBySpillAsync() const {
+    return get<bool>(kOrderBySpillAsync, false);
+  }
+
+  uint64_t windowSpillMemoryThreshold() const {
+    static constexpr uint64_t kDefault = 0;
+    return get<uint64_t>(kWindowSpillMemoryThreshold, kDefault);
+  }
+
   // Returns the target size for a Task's buffered output. The
   // producer Drivers are blocked when the buffered size exceeds
   // this. The Drivers are resumed when the buffered size goes below
@@ -211,19 +461,50 @@ class QueryConfig {
     return get<uint64_t>(kMaxPartitionedOutputBufferSize, kDefault);
   }
 
+  std::string exchangeCompressionCodec() const {
+    return get<std::string>(kExchangeCompressionCodec, "none");
+  }
+
   uint64_t maxLocalExchangeBufferSize() const {
     static constexpr uint64_t kDefault = 32UL << 20;
     return get<uint64_t>(kMaxLocalExchangeBufferSize, kDefault);
   }
 
+  uint64_t scaleWriterMinProcessedBytes() const {
+    static constexpr uint64_t kDefault = 128UL << 20;
+    return get<uint64_t>(kScaleWriterMinProcessedBytes, kDefault);
+  }
+
+  bool localExchangeCoalesceBatches() const {
+    return get<bool>(kLocalExchangeCoalesceBatches, false);
+  }
+
   uint32_t preferredOutputBatchSize() const {
     return get<uint32_t>(kPreferredOutputBatchSize, 1024);
   }
 
+  uint64_t preferredOutputBatchBytes() const {
+    static constexpr uint64_t kDefault = 10UL << 20;
+    return get<uint64_t>(kPreferredOutputBatchBytes, kDefault);
+  }
+
+  bool coalesceSmallBatches() const {
+    return get<bool>(kCoalesceSmallBatches, false);
+  }
+
   bool hashAdaptivityEnabled() const {
     return get<bool>(kHashAdaptivityEnabled, true);
   }
 
+  uint64_t hashJoinBloomFilterMaxEntries() const {
+    static constexpr uint64_t kDefault = 1UL << 22;
+    return get<uint64_t>(kHashJoinBloomFilterMaxEntries, kDefault);
+  }
+
+  bool hashJoinBuildSharingEnabled() const {
+    return get<bool>(kHashJoinBuildSharingEnabled, false);
+  }
+
   uint32_t writeStrideSize() const {
     static constexpr uint32_t kDefault = 100'000;
     return kDefault;
@@ -308,6 +589,12 @@ class QueryConfig {
     return get<bool>(kOrderBySpillEnabled, true);
   }
 
+  /// Returns 'is window spilling enabled' flag. Must also check the
+  /// spillEnabled()!
+  bool windowSpillEnabled() const {
+    return get<bool>(kWindowSpillEnabled, true);
+  }
+
   // Returns a percentage of aggregation or join input batches that
   // will be forced to spill for testing. 0 means no extra spilling.
   int32_t testingSpillPct() const {
@@ -318,6 +605,14 @@ class QueryConfig {
     return get<int32_t>(kMaxSpillLevel, 4);
   }
 
+  std::string spillCompressionCodec() const {
+    return get<std::string>(kSpillCompressionCodec, "none");
+  }
+
+  uint64_t maxSpillBytes() const {
+    return get<uint64_t>(kMaxSpillBytes, 0);
+  }
+
   /// Returns the start partition bit which is used with 'kSpillPartitionBits'
   /// together to calculate the spilling partition number.
   uint8_t spillStartPartitionBit() const {
@@ -358,10 +653,50 @@ class QueryConfig {
     return get<bool>(kExprTrackCpuUsage, false);
   }
 
+  uint32_t exprSampleCpuEvery() const {
+    return get<uint32_t>(kExprSampleCpuEvery, 100);
+  }
+
+  uint32_t exprValueMemoMaxEntries() const {
+    return get<uint32_t>(kExprValueMemoMaxEntries, 0);
+  }
+
+  bool exprFuseArithmetic() const {
+    return get<bool>(kExprFuseArithmetic, false);
+  }
+
+  bool exprShareVectorFunctions() const {
+    return get<bool>(kExprShareVectorFunctions, false);
+  }
+
+  int32_t arrowStreamPrefetchBatches() const {
+    return get<int32_t>(kArrowStreamPrefetchBatches, 0);
+  }
+
   bool operatorTrackCpuUsage() const {
     return get<bool>(kOperatorTrackCpuUsage, true);
   }
 
+  bool operatorTrackPerfCounters() const {
+    return get<bool>(kOperatorTrackPerfCounters, false);
+  }
+
+  uint32_t driverTimeSliceMs() const {
+    return get<uint32_t>(kDriverTimeSliceMs, 0);
+  }
+
+  uint32_t driverTimelineSamplePct() const {
+    return get<uint32_t>(kDriverTimelineSamplePct, 0);
+  }
+
+  bool tableScanSplitStealing() const {
+    return get<bool>(kTableScanSplitStealing, false);
+  }
+
+  bool adaptiveScanDrivers() const {
+    return get<bool>(kAdaptiveScanDrivers, false);
+  }
+
   template <typename T>
   T get(const std::string& key, const T& defaultValue) const {
     return configManager_->get<T>(key, defaultValue);
@@ -24,6 +24,10 @@
 #include "velox/vector/DecodedVector.h"
 #include "velox/vector/VectorPool.h"
 
+namespace facebook::velox::exec {
+class VectorFunctionCache;
+}
+
 namespace facebook::velox::core {
 
 class QueryCtx : public Context {
@@ -143,6 +147,16 @@ class QueryCtx : public Context {
     return queryId_;
   }
 
+  /// Adds 'bytes' to the bytes the query has written to spill files across
+  /// all its tasks and spill paths. Returns the new total.
+  uint64_t addSpilledBytes(uint64_t bytes) {
+    return spilledBytes_.fetch_add(bytes) + bytes;
+  }
+
+  uint64_t spilledBytes() const {
+    return spilledBytes_;
+  }
+
   void testingOverrideMemoryPool(std::shared_ptr<memory::MemoryPool> pool) {
     pool_ = std::move(pool);
   }
@@ -169,6 +183,7 @@ class QueryCtx : public Context {
   QueryConfig queryConfig_;
   const std::string queryId_;
   std::shared_ptr<folly::Executor> spillExecutor_;
+  std::atomic<uint64_t> spilledBytes_{0};
 };
 
 // Represents the state of one thread of query execution.
@@ -257,6 +272,16 @@ class ExecCtx : public Context {
     return vectorPool_.release(vectors);
   }
 
+  /// Returns the cache of VectorFunctions shared by the expressions compiled
+  /// with 'this' or nullptr if each compilation makes its own functions.
+  exec::VectorFunctionCache* FOLLY_NULLABLE vectorFunctionCache() const {
+    return vectorFunctionCache_;
+  }
+
+  void setVectorFunctionCache(exec::VectorFunctionCache* FOLLY_NULLABLE cache) {
+    vectorFunctionCache_ = cache;
+  }
+
  private:
   // Pool for all Buffers for this thread.
   memory::MemoryPool* FOLLY_NONNULL pool_;
@@ -267,6 +292,7 @@ class ExecCtx : public Context {
   // and operators.
   std::vector<std::unique_ptr<SelectivityVector>> selectivityVectorPool_;
   VectorPool vectorPool_;
+  exec::VectorFunctionCache* FOLLY_NULLABLE vectorFunctionCache_{nullptr};
 };
 
 } // namespace facebook::velox::core
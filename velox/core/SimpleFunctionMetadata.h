@@ -506,6 +506,7 @@ class UDFHolder final
   DECLARE_METHOD_RESOLVER(callNullFree_method_resolver, callNullFree);
   DECLARE_METHOD_RESOLVER(callAscii_method_resolver, callAscii);
   DECLARE_METHOD_RESOLVER(initialize_method_resolver, initialize);
+  DECLARE_METHOD_RESOLVER(callBatch_method_resolver, callBatch);
 
   // Check which flavor of the call() method is provided by the UDF object. UDFs
   // are required to provide at least one of the following methods:
@@ -521,6 +522,7 @@ class UDFHolder final
   //
   // - bool|void callAscii(...)
   // - void initialize(...)
+  // - void callBatch(out*, numRows, const arg*...)
 
   // call():
   static constexpr bool udf_has_call_return_bool = util::has_method<
@@ -612,6 +614,18 @@ class UDFHolder final
       const core::QueryConfig&,
       const exec_arg_type<TArgs>*...>::value;
 
+  // callBatch(): Computes 'numRows' results at once from contiguous arrays
+  // of argument values. Used only for fixed-width types when all arguments
+  // are flat, have no nulls and all rows are selected. 'out' may be the same
+  // array as one of the arguments. Must not throw.
+  static constexpr bool udf_has_callBatch = util::has_method<
+      Fun,
+      callBatch_method_resolver,
+      void,
+      exec_return_type*,
+      int32_t,
+      const exec_arg_type<TArgs>*...>::value;
+
   static_assert(
       udf_has_call || udf_has_callNullable || udf_has_callNullFree,
       "UDF must implement at least one of `call`, `callNullable`, or `callNullFree`");
@@ -728,6 +742,18 @@ class UDFHolder final
     }
   }
 
+  FOLLY_ALWAYS_INLINE void callBatch(
+      exec_return_type* out,
+      int32_t numRows,
+      const typename exec_resolver<TArgs>::in_type*... args) {
+    if constexpr (udf_has_callBatch) {
+      instance_.callBatch(out, numRows, args...);
+    } else {
+      VELOX_UNREACHABLE(
+          "callBatch should never be called if the UDF does not implement callBatch.");
+    }
+  }
+
   // Helper functions to handle void vs bool return type.
 
   FOLLY_ALWAYS_INLINE bool callImpl(
@@ -693,6 +693,38 @@ std::pair<std::shared_ptr<const core::IExpr>, core::SortOrder> parseOrderByExpr(
       core::SortOrder(ascending, nullsFirst)};
 }
 
+AggregateExpr parseAggregateExpr(
+    const std::string& exprString,
+    const ParseOptions& options) {
+  auto parsedExpressions = parseExpression(exprString);
+  if (parsedExpressions.size() != 1) {
+    throw std::invalid_argument(folly::sformat(
+        "Expecting exactly one input expression, found {}.",
+        parsedExpressions.size()));
+  }
+
+  auto& parsedExpr = *parsedExpressions.front();
+  if (parsedExpr.GetExpressionClass() != ExpressionClass::FUNCTION) {
+    throw std::invalid_argument(folly::sformat(
+        "Invalid aggregate function expression, found {}.", exprString));
+  }
+
+  const auto& functionExpr = dynamic_cast<FunctionExpression&>(parsedExpr);
+  AggregateExpr aggregateExpr;
+  aggregateExpr.distinct = functionExpr.distinct;
+  if (functionExpr.order_bys != nullptr) {
+    for (const auto& orderByNode : functionExpr.order_bys->orders) {
+      const bool ascending = isAscending(orderByNode.type, exprString);
+      const bool nullsFirst = isNullsFirst(orderByNode.null_order, exprString);
+      aggregateExpr.orderBy.emplace_back(
+          parseExpr(*orderByNode.expression, options),
+          core::SortOrder(ascending, nullsFirst));
+    }
+  }
+  aggregateExpr.expr = parseExpr(parsedExpr, options);
+  return aggregateExpr;
+}
+
 namespace {
 WindowType parseWindowType(const WindowExpression& expr) {
   auto windowType =
@@ -47,6 +47,22 @@ std::vector<std::shared_ptr<const core::IExpr>> parseMultipleExpressions(
     const std::string& exprString,
     const ParseOptions& options);
 
+// An aggregate function call, e.g. "count(DISTINCT a)" or "array_agg(a ORDER
+// BY b DESC)". The DISTINCT and ORDER BY modifiers are not part of the IExpr
+// of the call, so they are captured separately.
+struct AggregateExpr {
+  std::shared_ptr<const core::IExpr> expr;
+  bool distinct{false};
+  std::vector<std::pair<std::shared_ptr<const core::IExpr>, core::SortOrder>>
+      orderBy;
+};
+
+// Parses a single aggregate function call using DuckDB's internal
+// postgresql-based parser.
+AggregateExpr parseAggregateExpr(
+    const std::string& exprString,
+    const ParseOptions& options);
+
 // Parses an ORDER BY clause using DuckDB's internal postgresql-based parser,
 // converting it to a pair of an IExpr tree and a core::SortOrder. Uses ASC
 // NULLS LAST as the default sort order.
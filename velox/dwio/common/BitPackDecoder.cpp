@@ -16,6 +16,10 @@
 
 #include "velox/dwio/common/BitPackDecoder.h"
 
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
 namespace facebook::velox::dwio::common {
 
 using int128_t = __int128_t;
@@ -327,4 +331,37 @@ template void unpack(
     const char* bufferEnd,
     int16_t* result);
 
+#if defined(__x86_64__) && !XSIMD_WITH_AVX2 && !defined(__BMI2__)
+namespace detail {
+
+__attribute__((target("bmi2"))) void unpackBmi2(
+    const uint8_t* FOLLY_NONNULL& inputBits,
+    uint64_t numValues,
+    uint8_t bitWidth,
+    uint8_t* FOLLY_NONNULL& result) {
+  uint64_t mask = kPdepMask8[bitWidth];
+  uint64_t numBytes = (numValues * bitWidth + 7) / 8;
+  auto readEndOffset = inputBits + numBytes;
+
+  // Same as the AVX2 build of unpack<uint8_t>: deposits 8 values from
+  // 'bitWidth' bytes at a time.
+  while (inputBits <= readEndOffset - 8) {
+    uint64_t val = *reinterpret_cast<const uint64_t*>(inputBits);
+    *(reinterpret_cast<uint64_t*>(result)) = _pdep_u64(val, mask);
+    inputBits += bitWidth;
+    result += 8;
+  }
+
+  uint64_t val = 0;
+  while (inputBits < readEndOffset) {
+    std::memcpy(&val, inputBits, bitWidth);
+    *(reinterpret_cast<uint64_t*>(result)) = _pdep_u64(val, mask);
+    inputBits += bitWidth;
+    result += 8;
+  }
+}
+
+} // namespace detail
+#endif
+
 } // namespace facebook::velox::dwio::common
@@ -97,6 +97,19 @@ void unpack(
     const char* FOLLY_NULLABLE bufferEnd,
     T* FOLLY_NONNULL result);
 
+#if defined(__x86_64__) && !XSIMD_WITH_AVX2 && !defined(__BMI2__)
+namespace detail {
+// Unpacks 'numValues' values of 'bitWidth' <= 8 bits with PDEP. Compiled for
+// BMI2 and used by unpack<uint8_t> if bits::detail::hasBmi2 is true, i.e. on
+// hosts with BMI2 when the build targets an older baseline.
+void unpackBmi2(
+    const uint8_t* FOLLY_NONNULL& inputBits,
+    uint64_t numValues,
+    uint8_t bitWidth,
+    uint8_t* FOLLY_NONNULL& result);
+} // namespace detail
+#endif
+
 /// Unpack numValues number of input values from inputBuffer. The results
 /// will be written to result. numValues must be a multiple of 8. The
 /// caller needs to make sure the inputBufferLen contains at least numValues
@@ -637,6 +650,12 @@ inline void unpack<uint8_t>(
 
 #else
 
+#if defined(__x86_64__) && !defined(__BMI2__)
+  if (bits::detail::hasBmi2) {
+    detail::unpackBmi2(inputBits, numValues, bitWidth, result);
+    return;
+  }
+#endif
   unpackNaive<uint8_t>(inputBits, inputBufferLen, numValues, bitWidth, result);
 
 #endif
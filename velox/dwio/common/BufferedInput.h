@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <folly/futures/Future.h>
+
 #include "velox/dwio/common/DataBuffer.h"
 #include "velox/dwio/common/SeekableInputStream.h"
 #include "velox/dwio/common/StreamIdentifier.h"
@@ -101,6 +103,13 @@ class BufferedInput {
 
   virtual void setNumStripes(int32_t /*numStripes*/) {}
 
+  // Returns true if the data of the loads issued so far can be read without
+  // waiting for a load in progress on another thread. Otherwise sets 'wait'
+  // to a future realized when that load is done and returns false.
+  virtual bool isLoaded(folly::SemiFuture<bool>* FOLLY_NONNULL /*wait*/) {
+    return true;
+  }
+
   // Create a new (clean) instance of BufferedInput sharing the same underlying
   // file and memory pool.  The enqueued regions are NOT copied.
   virtual std::unique_ptr<BufferedInput> clone() const {
@@ -21,12 +21,32 @@
 #include "velox/dwio/common/CacheInputStream.h"
 #include "velox/dwio/common/CachedBufferedInput.h"
 
+DEFINE_int32(
+    cache_admit_min_read_pct,
+    10,
+    "Minimum percentage of reads over references to a column for retaining "
+    "its cache entries. Entries of columns read less are evictable right away");
+
 namespace facebook::velox::dwio::common {
 
 using velox::cache::ScanTracker;
 using velox::cache::TrackingId;
 using velox::memory::MemoryAllocator;
 
+namespace {
+// Keeps a cache entry pinned for the lifetime of a BufferView over its data.
+class PinReleaser {
+ public:
+  explicit PinReleaser(cache::CachePin pin) : pin_(std::move(pin)) {}
+
+  void addRef() const {}
+  void release() const {}
+
+ private:
+  const cache::CachePin pin_;
+};
+} // namespace
+
 CacheInputStream::CacheInputStream(
     CachedBufferedInput* bufferedInput,
     IoStatistics* ioStats,
@@ -187,6 +207,7 @@ void CacheInputStream::loadSync(Region region) {
         std::move(wait).via(&exec).wait();
       }
       ioStats_->queryThreadIoLatency().increment(usec);
+      ioStats_->cachePinWait().increment(usec);
       continue;
     }
     auto entry = pin_.checkedEntry();
@@ -206,11 +227,19 @@ void CacheInputStream::loadSync(Region region) {
       }
       ioStats_->read().increment(region.length);
       ioStats_->queryThreadIoLatency().increment(usec);
+      ioStats_->storageReadLatency().record(usec);
+      if (tracker_ &&
+          !tracker_->shouldAdmit(
+              trackingId_, FLAGS_cache_admit_min_read_pct)) {
+        entry->makeEvictable();
+      }
       entry->setExclusiveToShared();
     } else {
       // Hit memory cache.
       if (!entry->getAndClearFirstUseFlag()) {
         ioStats_->ramHit().increment(entry->size());
+      } else {
+        ioStats_->prefetchHit().increment(entry->size());
       }
       return;
     }
@@ -269,10 +298,18 @@ bool CacheInputStream::loadFromSsd(
   pin_ = std::move(pins[0]);
   ioStats_->ssdRead().increment(entry.size());
   ioStats_->queryThreadIoLatency().increment(usec);
+  ioStats_->ssdReadLatency().record(usec);
   entry.setExclusiveToShared();
   return true;
 }
 
+BufferPtr CacheInputStream::sharedBuffer() {
+  if (pin_.empty() || !run_) {
+    return nullptr;
+  }
+  return BufferView<PinReleaser>::create(run_, runSize_, PinReleaser(pin_));
+}
+
 void CacheInputStream::loadPosition() {
   auto offset = region_.offset;
   if (pin_.empty()) {
@@ -294,6 +331,7 @@ void CacheInputStream::loadPosition() {
         }
       }
       ioStats_->queryThreadIoLatency().increment(usec);
+      ioStats_->coalescedLoadWait().increment(usec);
     }
     auto loadRegion = region_;
     // Quantize position to previous multiple of 'loadQuantum_'.
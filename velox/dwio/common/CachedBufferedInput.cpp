@@ -15,8 +15,11 @@
  */
 
 #include "velox/dwio/common/CachedBufferedInput.h"
+#include <folly/futures/Future.h>
+#include <numeric>
 #include "velox/common/memory/Allocation.h"
 #include "velox/common/process/TraceContext.h"
+#include "velox/common/time/Timer.h"
 #include "velox/dwio/common/CacheInputStream.h"
 
 DEFINE_int32(
@@ -24,6 +27,12 @@ DEFINE_int32(
     80,
     "Minimum percentage of actual uses over references to a column for prefetching. No prefetch if > 100");
 
+DEFINE_bool(
+    cache_adaptive_coalesce,
+    false,
+    "Choose the distance for coalescing storage reads from the measured "
+    "latency and bandwidth of the storage instead of a fixed distance");
+
 namespace facebook::velox::dwio::common {
 
 using cache::CachePin;
@@ -72,6 +81,18 @@ bool CachedBufferedInput::isBuffered(uint64_t /*offset*/, uint64_t /*length*/)
   return false;
 }
 
+bool CachedBufferedInput::isLoaded(folly::SemiFuture<bool>* wait) {
+  // Planned loads are not waited for. They are made by the first reader of
+  // their streams.
+  for (auto& load : allCoalescedLoads_) {
+    if (load->state() == cache::LoadState::kLoading &&
+        !load->loadOrFuture(wait)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool CachedBufferedInput::shouldPreload(int32_t numPages) {
   // True if after scheduling this for preload, half the capacity
   // would be in a loading but not yet accessed state.
@@ -84,19 +105,7 @@ bool CachedBufferedInput::shouldPreload(int32_t numPages) {
                     memory::AllocationTraits::kPageSize) /
         memory::AllocationTraits::kPageSize;
   }
-  auto cachePages = cache_->incrementCachedPages(0);
-  auto maxPages = cache_->maxBytes() / memory::AllocationTraits::kPageSize;
-  auto allocatedPages = cache_->numAllocated();
-  if (numPages < maxPages - allocatedPages) {
-    // There is free space for the read-ahead.
-    return true;
-  }
-  auto prefetchPages = cache_->incrementPrefetchPages(0);
-  if (numPages + prefetchPages < cachePages / 2) {
-    // The planned prefetch plus other prefetches are under half the cache.
-    return true;
-  }
-  return false;
+  return cache_->canPrefetch(numPages);
 }
 
 namespace {
@@ -215,7 +224,7 @@ void CachedBufferedInput::makeLoads(
     return;
   }
   bool isSsd = !requests[0]->ssdPin.empty();
-  int32_t maxDistance = isSsd ? 20000 : maxCoalesceDistance_;
+  int32_t maxDistance = isSsd ? 20000 : coalesceDistance();
   std::sort(
       requests.begin(),
       requests.end(),
@@ -260,6 +269,15 @@ void CachedBufferedInput::makeLoads(
     for (auto i = 0; i < allCoalescedLoads_.size(); ++i) {
       auto& load = allCoalescedLoads_[i];
       if (load->state() == LoadState::kPlanned) {
+        // A load that is over the prefetch budget is left to the first
+        // reader of its data. This bounds the read-ahead of splits
+        // preloaded by the table scan.
+        const auto numPages =
+            bits::roundUp(load->size(), memory::AllocationTraits::kPageSize) /
+            memory::AllocationTraits::kPageSize;
+        if (!cache_->canPrefetch(numPages)) {
+          continue;
+        }
         executor_->add([pendingLoad = load]() {
           process::TraceContext trace("Read Ahead");
           pendingLoad->loadOrFuture(nullptr);
@@ -383,6 +401,12 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
     if (pins.empty()) {
       return pins;
     }
+    // With asynchronous reads, all the coalesced reads are in flight
+    // together.
+    const bool readAsync = input_->hasReadAsync();
+    std::vector<folly::SemiFuture<uint64_t>> reads;
+    std::vector<uint64_t> readSizes;
+    const auto startMicros = getCurrentTimeMicro();
     auto stats = cache::readPins(
         pins,
         maxCoalesceDistance_,
@@ -393,12 +417,45 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
             int32_t /*end*/,
             uint64_t offset,
             const std::vector<folly::Range<char*>>& buffers) {
-          input_->read(buffers, offset, LogType::FILE);
+          uint64_t size = 0;
+          for (const auto& buffer : buffers) {
+            size += buffer.size();
+          }
+          if (!readAsync) {
+            const auto readStartMicros = getCurrentTimeMicro();
+            input_->read(buffers, offset, LogType::FILE);
+            recordLatency(size, getCurrentTimeMicro() - readStartMicros);
+            return;
+          }
+          reads.push_back(input_->readAsync(buffers, offset, LogType::FILE));
+          readSizes.push_back(size);
         });
+    auto results = folly::collectAll(std::move(reads)).get();
+    for (auto i = 0; i < results.size(); ++i) {
+      DWIO_ENSURE_EQ(
+          results[i].value(),
+          readSizes[i],
+          "Should read exactly as requested. File name: ",
+          input_->getName());
+    }
+    if (!readSizes.empty()) {
+      // The asynchronous reads overlap, so they are modeled as one read of
+      // their total size.
+      recordLatency(
+          std::accumulate(readSizes.begin(), readSizes.end(), 0UL),
+          getCurrentTimeMicro() - startMicros);
+    }
     updateStats(stats, isPrefetch, false);
     return pins;
   }
 
+  void recordLatency(uint64_t bytes, uint64_t micros) {
+    if (ioStats_) {
+      ioStats_->storageLatency().record(bytes, micros);
+      ioStats_->storageReadLatency().record(micros);
+    }
+  }
+
   std::shared_ptr<ReadFileInputStream> input_;
   const int32_t maxCoalesceDistance_;
 };
@@ -430,7 +487,11 @@ class SsdLoad : public DwioCoalescedLoadBase {
       return pins;
     }
     assert(!ssdPins.empty()); // for lint.
+    const auto startMicros = getCurrentTimeMicro();
     auto stats = ssdPins[0].file()->load(ssdPins, pins);
+    if (ioStats_) {
+      ioStats_->ssdReadLatency().record(getCurrentTimeMicro() - startMicros);
+    }
     updateStats(stats, isPrefetch, true);
     return pins;
   }
@@ -449,7 +510,7 @@ void CachedBufferedInput::readRegion(
     load = std::make_shared<SsdLoad>(*cache_, ioStats_, groupId_, requests);
   } else {
     load = std::make_shared<DwioCoalescedLoad>(
-        *cache_, input_, ioStats_, groupId_, requests, maxCoalesceDistance_);
+        *cache_, input_, ioStats_, groupId_, requests, coalesceDistance());
   }
   allCoalescedLoads_.push_back(load);
   coalescedLoads_.withWLock([&](auto& loads) {
@@ -493,6 +554,13 @@ std::unique_ptr<SeekableInputStream> CachedBufferedInput::read(
       loadQuantum_);
 }
 
+int32_t CachedBufferedInput::coalesceDistance() const {
+  if (!FLAGS_cache_adaptive_coalesce || !ioStats_) {
+    return maxCoalesceDistance_;
+  }
+  return ioStats_->storageLatency().coalesceDistance(maxCoalesceDistance_);
+}
+
 bool CachedBufferedInput::prefetch(Region region) {
   int32_t numPages =
       bits::roundUp(region.length, memory::AllocationTraits::kPageSize) /
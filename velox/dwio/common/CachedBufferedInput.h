@@ -28,6 +28,7 @@
 #include "velox/dwio/common/Options.h"
 
 DECLARE_int32(cache_load_quantum);
+DECLARE_bool(cache_adaptive_coalesce);
 
 namespace facebook::velox::dwio::common {
 
@@ -124,6 +125,8 @@ class CachedBufferedInput : public BufferedInput {
 
   bool shouldPreload(int32_t numPages = 0) override;
 
+  bool isLoaded(folly::SemiFuture<bool>* FOLLY_NONNULL wait) override;
+
   bool shouldPrefetchStripes() const override {
     return true;
   }
@@ -176,6 +179,11 @@ class CachedBufferedInput : public BufferedInput {
 
   void readRegion(std::vector<CacheRequest*> requests, bool prefetch);
 
+  // Returns the maximum gap between ranges that are read from storage in one
+  // IO. This is 'maxCoalesceDistance_' unless --cache_adaptive_coalesce is
+  // set and the latency model of 'ioStats_' has an estimate.
+  int32_t coalesceDistance() const;
+
   cache::AsyncDataCache* FOLLY_NONNULL cache_;
   const uint64_t fileNum_;
   std::shared_ptr<cache::ScanTracker> tracker_;
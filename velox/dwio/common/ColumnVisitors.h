@@ -140,6 +140,9 @@ class DictionaryColumnVisitor;
 template <typename TFilter, typename ExtractValues, bool isDense>
 class StringDictionaryColumnVisitor;
 
+template <typename T, typename TFilter, typename ExtractValues, bool isDense>
+class DirectRleColumnVisitor;
+
 // Template parameter for controlling filtering and action on a set of rows.
 template <typename T, typename TFilter, typename ExtractValues, bool isDense>
 class ColumnVisitor {
@@ -452,6 +455,9 @@ class ColumnVisitor {
   StringDictionaryColumnVisitor<TFilter, ExtractValues, isDense>
   toStringDictionaryColumnVisitor();
 
+  DirectRleColumnVisitor<T, TFilter, ExtractValues, isDense>
+  toDirectRleColumnVisitor();
+
   // Use for replacing *coall rows with non-null rows for fast path with
   // processRun and processRle.
   void setRows(folly::Range<const int32_t*> newRows) {
@@ -1475,4 +1481,13 @@ class DirectRleColumnVisitor
   }
 };
 
+template <typename T, typename TFilter, typename ExtractValues, bool isDense>
+DirectRleColumnVisitor<T, TFilter, ExtractValues, isDense>
+ColumnVisitor<T, TFilter, ExtractValues, isDense>::toDirectRleColumnVisitor() {
+  auto result = DirectRleColumnVisitor<T, TFilter, ExtractValues, isDense>(
+      filter_, reader_, RowSet(rows_ + rowIndex_, numRows_), values_);
+  result.numValuesBias_ = numValuesBias_;
+  return result;
+}
+
 } // namespace facebook::velox::dwio::common
@@ -17,6 +17,7 @@
 #include "velox/dwio/common/DataSink.h"
 
 #include "velox/common/base/Fs.h"
+#include "velox/common/file/FileSystems.h"
 #include "velox/dwio/common/exception/Exception.h"
 
 #include <fcntl.h>
@@ -77,6 +78,28 @@ void LocalFileSink::write(std::vector<DataBuffer<char>>& buffers) {
   });
 }
 
+WriteFileSink::WriteFileSink(
+    std::unique_ptr<WriteFile> writeFile,
+    std::string name,
+    const MetricsLogPtr& metricLogger,
+    IoStatistics* stats)
+    : DataSink{std::move(name), metricLogger, stats},
+      writeFile_{std::move(writeFile)} {
+  DWIO_ENSURE_NOT_NULL(writeFile_);
+}
+
+void WriteFileSink::write(std::vector<DataBuffer<char>>& buffers) {
+  writeImpl(buffers, [&](auto& buffer) {
+    const auto size = buffer.size();
+    writeFile_->append({buffer.data(), size});
+    return size;
+  });
+}
+
+void WriteFileSink::doClose() {
+  writeFile_->close();
+}
+
 static std::vector<DataSink::Factory>& factories() {
   static std::vector<DataSink::Factory> factories;
   return factories;
@@ -115,4 +138,19 @@ static std::unique_ptr<DataSink> localFileSink(
 
 VELOX_REGISTER_DATA_SINK_METHOD_DEFINITION(LocalFileSink, localFileSink);
 
+static std::unique_ptr<DataSink> writeFileSink(
+    const std::string& filename,
+    const MetricsLogPtr& metricsLog,
+    IoStatistics* stats = nullptr) {
+  if (filename.find("://") == std::string::npos ||
+      strncmp(filename.c_str(), "file:", 5) == 0) {
+    return nullptr;
+  }
+  auto fileSystem = filesystems::getFileSystem(filename, nullptr);
+  return std::make_unique<WriteFileSink>(
+      fileSystem->openFileForWrite(filename), filename, metricsLog, stats);
+}
+
+VELOX_REGISTER_DATA_SINK_METHOD_DEFINITION(WriteFileSink, writeFileSink);
+
 } // namespace facebook::velox::dwio::common
@@ -18,6 +18,7 @@
 
 #include <chrono>
 
+#include "velox/common/file/File.h"
 #include "velox/dwio/common/Closeable.h"
 #include "velox/dwio/common/DataBuffer.h"
 #include "velox/dwio/common/IoStatistics.h"
@@ -159,6 +160,40 @@ class LocalFileSink : public DataSink {
   int file_;
 };
 
+/**
+ * A data sink that appends to a WriteFile of a registered file system, e.g.
+ * S3. The buffers are streamed to the file as they are written.
+ */
+class WriteFileSink : public DataSink {
+ public:
+  WriteFileSink(
+      std::unique_ptr<WriteFile> writeFile,
+      std::string name,
+      const MetricsLogPtr& metricLogger = MetricsLog::voidLog(),
+      IoStatistics* stats = nullptr);
+
+  ~WriteFileSink() override {
+    destroy();
+  }
+
+  using DataSink::write;
+
+  void write(std::vector<DataBuffer<char>>& buffers) override;
+
+  /**
+   * Registers a factory that creates a WriteFileSink for the paths with a
+   * scheme other than file, e.g. s3://bucket/key, on the file system
+   * registered for the scheme.
+   */
+  static void registerFactory();
+
+ protected:
+  void doClose() override;
+
+ private:
+  std::unique_ptr<WriteFile> writeFile_;
+};
+
 class MemorySink : public DataSink {
  public:
   MemorySink(
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/FileMetadataCache.h"
+
+#include <gflags/gflags.h>
+
+DEFINE_uint64(
+    file_metadata_cache_bytes,
+    0,
+    "Capacity in bytes of the process-wide cache of parsed file footers. 0 "
+    "disables the cache");
+
+namespace facebook::velox::dwio::common {
+
+// static
+FileMetadataCache& FileMetadataCache::instance() {
+  static FileMetadataCache cache(FLAGS_file_metadata_cache_bytes);
+  return cache;
+}
+
+FileMetadataCache::FileMetadataCache(uint64_t capacity) {
+  setCapacity(capacity);
+}
+
+void FileMetadataCache::setCapacity(uint64_t capacity) {
+  std::lock_guard<std::mutex> l(mutex_);
+  cache_ = capacity > 0 ? std::make_unique<Cache>(capacity) : nullptr;
+}
+
+bool FileMetadataCache::enabled() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return cache_ != nullptr;
+}
+
+// static
+std::optional<std::string> FileMetadataCache::key(const ReadFile& file) {
+  const auto name = file.getName();
+  // Files without a path are named like <InMemoryReadFile>.
+  if (name.empty() || name[0] == '<') {
+    return std::nullopt;
+  }
+  return fmt::format("{}:{}", name, file.size());
+}
+
+std::shared_ptr<const FileMetadata> FileMetadataCache::get(
+    const std::string& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (cache_ == nullptr) {
+    return nullptr;
+  }
+  auto* metadata = cache_->get(key);
+  if (metadata == nullptr) {
+    return nullptr;
+  }
+  // The copy keeps the metadata alive after eviction, so the entry need not
+  // stay pinned.
+  auto result = *metadata;
+  cache_->release(key);
+  return result;
+}
+
+void FileMetadataCache::put(
+    const std::string& key,
+    std::shared_ptr<const FileMetadata> metadata) {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (cache_ == nullptr) {
+    return;
+  }
+  const auto size = metadata->memoryUsage() + key.size();
+  auto value =
+      std::make_unique<std::shared_ptr<const FileMetadata>>(std::move(metadata));
+  if (cache_->add(key, value.get(), size)) {
+    value.release();
+  }
+}
+
+memory::MemoryPool& FileMetadataCache::pool() {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (pool_ == nullptr) {
+    pool_ = memory::getDefaultMemoryPool("FileMetadataCache");
+  }
+  return *pool_;
+}
+
+SimpleLRUCacheStats FileMetadataCache::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return cache_ != nullptr ? cache_->getStats() : SimpleLRUCacheStats{};
+}
+
+} // namespace facebook::velox::dwio::common
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "velox/common/caching/SimpleLRUCache.h"
+#include "velox/common/file/File.h"
+#include "velox/common/memory/Memory.h"
+
+namespace facebook::velox::dwio::common {
+
+/// Parsed metadata of a file, e.g. its footer, kept in FileMetadataCache.
+class FileMetadata {
+ public:
+  virtual ~FileMetadata() = default;
+
+  /// Approximate memory used by the metadata. Counts against the capacity of
+  /// the cache.
+  virtual uint64_t memoryUsage() const = 0;
+};
+
+/// Process-wide cache of the parsed metadata of files, so that the readers of
+/// the splits of a file in all queries parse its footer once. The entries are
+/// keyed by file name and size and are evicted least recently used when their
+/// memory usage exceeds the capacity. A capacity of 0, the default, disables
+/// the cache. See FLAGS_file_metadata_cache_bytes.
+class FileMetadataCache {
+ public:
+  static FileMetadataCache& instance();
+
+  explicit FileMetadataCache(uint64_t capacity);
+
+  /// Drops all the entries and sets the capacity in bytes.
+  void setCapacity(uint64_t capacity);
+
+  bool enabled() const;
+
+  /// Returns the cache key of 'file' or std::nullopt if the file has no name,
+  /// e.g. is in memory.
+  static std::optional<std::string> key(const ReadFile& file);
+
+  /// Returns the metadata for 'key' or nullptr if it is not cached. The
+  /// result stays valid after the entry is evicted.
+  std::shared_ptr<const FileMetadata> get(const std::string& key);
+
+  /// Adds 'metadata' for 'key' unless it is already cached or does not fit in
+  /// the capacity.
+  void put(
+      const std::string& key,
+      std::shared_ptr<const FileMetadata> metadata);
+
+  /// Pool for the memory of cached metadata that does not belong to any
+  /// query.
+  memory::MemoryPool& pool();
+
+  SimpleLRUCacheStats stats() const;
+
+ private:
+  using Cache =
+      SimpleLRUCache<std::string, std::shared_ptr<const FileMetadata>>;
+
+  mutable std::mutex mutex_;
+  std::unique_ptr<Cache> cache_;
+  std::shared_ptr<memory::MemoryPool> pool_;
+};
+
+} // namespace facebook::velox::dwio::common
@@ -15,13 +15,105 @@
  */
 
 #include <glog/logging.h>
+#include <algorithm>
 #include <atomic>
+#include <limits>
 #include <utility>
 
 #include "velox/dwio/common/IoStatistics.h"
 
 namespace facebook::velox::dwio::common {
 
+void IoLatencyModel::record(uint64_t bytes, uint64_t micros) {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (count_ >= kMaxSamples) {
+    count_ /= 2;
+    sumBytes_ /= 2;
+    sumMicros_ /= 2;
+    sumBytesSquared_ /= 2;
+    sumBytesMicros_ /= 2;
+  }
+  const double x = bytes;
+  const double y = micros;
+  ++count_;
+  sumBytes_ += x;
+  sumMicros_ += y;
+  sumBytesSquared_ += x * x;
+  sumBytesMicros_ += x * y;
+}
+
+std::optional<IoLatencyModel::Estimate> IoLatencyModel::estimate() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (count_ < kMinSamples) {
+    return std::nullopt;
+  }
+  const double meanBytes = sumBytes_ / count_;
+  const double bytesVariance =
+      sumBytesSquared_ / count_ - meanBytes * meanBytes;
+  // With reads of about the same size, the latency can't be told apart from
+  // the transfer time.
+  if (bytesVariance <= meanBytes * meanBytes / 100) {
+    return std::nullopt;
+  }
+  const double meanMicros = sumMicros_ / count_;
+  const double microsPerByte =
+      (sumBytesMicros_ / count_ - meanBytes * meanMicros) / bytesVariance;
+  Estimate estimate;
+  // A non-positive slope or intercept comes from noise. Then the
+  // bandwidth is taken to be unlimited or the latency to be 0.
+  estimate.bytesPerMicro = microsPerByte > 0
+      ? 1 / microsPerByte
+      : std::numeric_limits<double>::infinity();
+  estimate.latencyMicros =
+      std::max<double>(0, meanMicros - microsPerByte * meanBytes);
+  return estimate;
+}
+
+int32_t IoLatencyModel::coalesceDistance(int32_t defaultDistance) const {
+  auto modeled = estimate();
+  if (!modeled.has_value()) {
+    return defaultDistance;
+  }
+  if (modeled->latencyMicros == 0) {
+    return kMinCoalesceDistance;
+  }
+  const double distance = modeled->latencyMicros * modeled->bytesPerMicro;
+  return std::clamp<double>(
+      distance, kMinCoalesceDistance, kMaxCoalesceDistance);
+}
+
+void IoLatencyModel::merge(const IoLatencyModel& other) {
+  std::lock_guard<std::mutex> otherLock(other.mutex_);
+  std::lock_guard<std::mutex> l(mutex_);
+  count_ += other.count_;
+  sumBytes_ += other.sumBytes_;
+  sumMicros_ += other.sumMicros_;
+  sumBytesSquared_ += other.sumBytesSquared_;
+  sumBytesMicros_ += other.sumBytesMicros_;
+}
+
+void IoLatencyHistogram::record(uint64_t micros) {
+  int32_t bucket = 0;
+  for (uint64_t limit = 100; bucket < kNumBuckets - 1 && micros >= limit;
+       limit *= 10) {
+    ++bucket;
+  }
+  ++counts_[bucket];
+}
+
+// static
+const char* IoLatencyHistogram::bucketName(int32_t bucket) {
+  static const char* kNames[kNumBuckets] = {
+      "Under100us", "Under1ms", "Under10ms", "Under100ms", "Under1s", "Over1s"};
+  return kNames[bucket];
+}
+
+void IoLatencyHistogram::merge(const IoLatencyHistogram& other) {
+  for (auto i = 0; i < kNumBuckets; ++i) {
+    counts_[i] += other.counts_[i];
+  }
+}
+
 uint64_t IoStatistics::rawBytesRead() const {
   return rawBytesRead_.load(std::memory_order_relaxed);
 }
@@ -104,7 +196,13 @@ void IoStatistics::merge(const IoStatistics& other) {
   read_.merge(other.read_);
   ramHit_.merge(other.ramHit_);
   ssdRead_.merge(other.ssdRead_);
+  prefetchHit_.merge(other.prefetchHit_);
   queryThreadIoLatency_.merge(other.queryThreadIoLatency_);
+  coalescedLoadWait_.merge(other.coalescedLoadWait_);
+  cachePinWait_.merge(other.cachePinWait_);
+  storageReadLatency_.merge(other.storageReadLatency_);
+  ssdReadLatency_.merge(other.ssdReadLatency_);
+  storageLatency_.merge(other.storageLatency_);
   std::lock_guard<std::mutex> l(operationStatsMutex_);
   for (auto& item : other.operationStats_) {
     operationStats_[item.first].merge(item.second);
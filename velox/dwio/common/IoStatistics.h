@@ -16,9 +16,11 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <unordered_map>
 
@@ -63,6 +65,75 @@ class IoCounter {
   std::atomic<uint64_t> sum_{0};
 };
 
+// Estimates the first byte latency and the bandwidth of a storage from the
+// reads done from it. A read of n bytes is modeled to take 'latency + n /
+// bandwidth'. The estimate is a least squares fit over the recent reads.
+class IoLatencyModel {
+ public:
+  // Minimum number of reads for making an estimate.
+  static constexpr int32_t kMinSamples = 8;
+  // Bounds of the coalesce distance returned by coalesceDistance().
+  static constexpr int32_t kMinCoalesceDistance = 4 << 10;
+  static constexpr int32_t kMaxCoalesceDistance = 16 << 20;
+
+  struct Estimate {
+    double latencyMicros;
+    double bytesPerMicro;
+  };
+
+  // Records a read of 'bytes' that took 'micros'.
+  void record(uint64_t bytes, uint64_t micros);
+
+  // Returns the estimated latency and bandwidth. Returns nullopt if there are
+  // too few reads or if the reads do not have different enough sizes.
+  std::optional<Estimate> estimate() const;
+
+  // Returns the largest gap between two ranges for which reading the ranges
+  // and the gap in one read is modeled to be faster than two reads. This is
+  // the latency times the bandwidth, e.g. several MB for object stores and a
+  // few tens of KB for local flash. Returns 'defaultDistance' if there is no
+  // estimate.
+  int32_t coalesceDistance(int32_t defaultDistance) const;
+
+  void merge(const IoLatencyModel& other);
+
+ private:
+  // The sums are halved when the count gets to this, so that the
+  // estimate follows changes in the storage performance.
+  static constexpr double kMaxSamples = 1'000;
+
+  mutable std::mutex mutex_;
+  double count_{0};
+  double sumBytes_{0};
+  double sumMicros_{0};
+  double sumBytesSquared_{0};
+  double sumBytesMicros_{0};
+};
+
+// Counts reads by latency in buckets that grow by 10x, from under 100us to
+// 1s and over. The buckets of different instances can be added up, unlike
+// percentiles.
+class IoLatencyHistogram {
+ public:
+  static constexpr int32_t kNumBuckets = 6;
+
+  // Records a read that took 'micros'.
+  void record(uint64_t micros);
+
+  // Returns the number of reads in 'bucket'.
+  uint64_t count(int32_t bucket) const {
+    return counts_[bucket];
+  }
+
+  // Returns the name of 'bucket', e.g. "Under1ms" or "Over1s".
+  static const char* bucketName(int32_t bucket);
+
+  void merge(const IoLatencyHistogram& other);
+
+ private:
+  std::array<std::atomic<uint64_t>, kNumBuckets> counts_{};
+};
+
 class IoStatistics {
  public:
   uint64_t rawBytesRead() const;
@@ -95,10 +166,38 @@ class IoStatistics {
     return ramHit_;
   }
 
+  IoCounter& prefetchHit() {
+    return prefetchHit_;
+  }
+
   IoCounter& queryThreadIoLatency() {
     return queryThreadIoLatency_;
   }
 
+  IoCounter& coalescedLoadWait() {
+    return coalescedLoadWait_;
+  }
+
+  IoCounter& cachePinWait() {
+    return cachePinWait_;
+  }
+
+  // Latencies of the reads from storage, including prefetches.
+  IoLatencyHistogram& storageReadLatency() {
+    return storageReadLatency_;
+  }
+
+  // Latencies of the reads from SSD cache, including prefetches.
+  IoLatencyHistogram& ssdReadLatency() {
+    return ssdReadLatency_;
+  }
+
+  // Latency model of the reads from storage. Used for choosing the distance
+  // for coalescing reads.
+  IoLatencyModel& storageLatency() {
+    return storageLatency_;
+  }
+
   void incOperationCounters(
       const std::string& operation,
       const uint64_t resourceThrottleCount,
@@ -135,10 +234,26 @@ class IoStatistics {
   // reads.
   IoCounter ssdRead_;
 
+  // First use of prefetched data from RAM cache.
+  IoCounter prefetchHit_;
+
   // Time spent by a query processing thread waiting for synchronously
   // issued IO or for an in-progress read-ahead to finish.
   IoCounter queryThreadIoLatency_;
 
+  // The part of 'queryThreadIoLatency_' spent in loading a CoalescedLoad or
+  // waiting for another thread to finish loading it, e.g. a prefetch.
+  IoCounter coalescedLoadWait_;
+
+  // The part of 'queryThreadIoLatency_' spent waiting for a cache entry that
+  // another thread is loading.
+  IoCounter cachePinWait_;
+
+  IoLatencyHistogram storageReadLatency_;
+  IoLatencyHistogram ssdReadLatency_;
+
+  IoLatencyModel storageLatency_;
+
   std::unordered_map<std::string, OperationCounters> operationStats_;
   mutable std::mutex operationStatsMutex_;
 };
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace facebook::velox::dwio::common {
+
+/// Changes to the rows of a file applied while reading them, e.g. the rows
+/// removed by the positional delete files of a table format like Iceberg.
+struct Mutation {
+  /// Bit mask of the rows to leave out of the next read, indexed from the
+  /// first row of the read. The deleted rows are not decoded. nullptr if no
+  /// row is deleted.
+  const uint64_t* deletedRows = nullptr;
+};
+
+} // namespace facebook::velox::dwio::common
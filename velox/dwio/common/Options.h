@@ -101,6 +101,11 @@ class RowReaderOptions {
   // operations.
   std::shared_ptr<folly::Executor> decodingExecutor_;
   std::shared_ptr<folly::Executor> ioExecutor_;
+  // The number of compression blocks of each data stream to decompress on
+  // 'decodingExecutor_' ahead of the reader, and the memory budget for the
+  // blocks decompressed ahead by all the streams of the reader.
+  int32_t decompressionReadAheadBlocks_ = 0;
+  uint64_t decompressionReadAheadBytes_ = 0;
   bool appendRowNumberColumn_ = false;
 
  public:
@@ -115,6 +120,10 @@ class RowReaderOptions {
     metadataFilter_ = other.metadataFilter_;
     returnFlatVector_ = other.returnFlatVector_;
     flatmapNodeIdAsStruct_ = other.flatmapNodeIdAsStruct_;
+    decodingExecutor_ = other.decodingExecutor_;
+    ioExecutor_ = other.ioExecutor_;
+    decompressionReadAheadBlocks_ = other.decompressionReadAheadBlocks_;
+    decompressionReadAheadBytes_ = other.decompressionReadAheadBytes_;
     appendRowNumberColumn_ = other.appendRowNumberColumn_;
   }
 
@@ -277,6 +286,25 @@ class RowReaderOptions {
     ioExecutor_ = executor;
   }
 
+  /*
+   * Decompress up to 'numBlocks' compression blocks of each data stream in
+   * parallel on the decoding executor ahead of the reader. The blocks read
+   * ahead by all the streams take at most 'maxBytes' of memory. Requires a
+   * decoding executor.
+   */
+  void setDecompressionReadAhead(int32_t numBlocks, uint64_t maxBytes) {
+    decompressionReadAheadBlocks_ = numBlocks;
+    decompressionReadAheadBytes_ = maxBytes;
+  }
+
+  int32_t getDecompressionReadAheadBlocks() const {
+    return decompressionReadAheadBlocks_;
+  }
+
+  uint64_t getDecompressionReadAheadBytes() const {
+    return decompressionReadAheadBytes_;
+  }
+
   /*
    * Set to true, if you want to add a new column to the results containing the
    * row numbers.
@@ -20,8 +20,12 @@
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <vector>
+
+#include <folly/futures/Future.h>
 
 #include "velox/dwio/common/InputStream.h"
+#include "velox/dwio/common/Mutation.h"
 #include "velox/dwio/common/Options.h"
 #include "velox/dwio/common/Statistics.h"
 #include "velox/dwio/common/TypeWithId.h"
@@ -40,15 +44,36 @@ namespace facebook::velox::dwio::common {
  */
 class RowReader {
  public:
+  static constexpr int64_t kAtEnd = -1;
+
   virtual ~RowReader() = default;
 
   /**
    * Fetch the next portion of rows.
    * @param size Max number of rows to read
    * @param result output vector
-   * @return number of fetched rows, 0 if there are no more rows to read
+   * @param mutation rows to leave out of the read, if any. The bits of
+   * 'mutation' are indexed from nextRowNumber().
+   * @return number of rows read including the ones deleted by 'mutation', 0
+   * if there are no more rows to read
    */
-  virtual uint64_t next(uint64_t size, velox::VectorPtr& result) = 0;
+  virtual uint64_t next(
+      uint64_t size,
+      velox::VectorPtr& result,
+      const Mutation* mutation = nullptr) = 0;
+
+  // Returns the row number in the file of the first row the next call of
+  // next() reads, or kAtEnd if there is nothing more to read. Rows skipped on
+  // statistics are passed over. Used to match rows with positional deletes.
+  virtual int64_t nextRowNumber() {
+    VELOX_UNSUPPORTED("nextRowNumber() is not supported by this reader");
+  }
+
+  // Returns the number of rows the next call of next() with 'size' reads, or
+  // kAtEnd if there is nothing more to read.
+  virtual int64_t nextReadSize(uint64_t /*size*/) {
+    VELOX_UNSUPPORTED("nextReadSize() is not supported by this reader");
+  }
 
   /**
    * Update current reader statistics. The set of updated values is
@@ -75,6 +100,32 @@ class RowReader {
   virtual bool allPrefetchIssued() const {
     return false;
   }
+
+  // Stops reading at about half of the stripes that this has not started
+  // reading yet and returns the file offset of the first stripe given up. The
+  // given up stripes are the ones that start between that offset and the end
+  // of the range of 'this'. Returns std::nullopt if there is nothing to give
+  // up or the format does not support this.
+  virtual std::optional<uint64_t> splitRemaining() {
+    return std::nullopt;
+  }
+
+  // Issues the IO for the next call of next() without decoding anything,
+  // e.g. starts the next stripe. Returns false and sets 'wait' if next()
+  // would block on data that is being loaded on another thread, so that the
+  // caller can wait without holding a thread.
+  virtual bool prepareNext(folly::SemiFuture<bool>* /*wait*/) {
+    return true;
+  }
+};
+
+/// Byte range and row count of a unit of a file that a split reads either
+/// whole or not at all, e.g. a DWRF stripe or a Parquet row group. A split
+/// reads the units whose 'offset' falls in its range.
+struct FileStripe {
+  uint64_t offset;
+  uint64_t length;
+  uint64_t numRows;
 };
 
 /**
@@ -126,6 +177,12 @@ class Reader {
    */
   virtual std::unique_ptr<RowReader> createRowReader(
       const RowReaderOptions& options = {}) const = 0;
+
+  /// Returns the stripes or row groups of the file in file order, or an empty
+  /// vector if the format does not expose them.
+  virtual std::vector<FileStripe> stripes() const {
+    return {};
+  }
 };
 
 } // namespace facebook::velox::dwio::common
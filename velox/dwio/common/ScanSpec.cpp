@@ -67,8 +67,10 @@ uint64_t ScanSpec::newRead() {
   if (!numReads_) {
     reorder();
   } else if (enableFilterReorder_) {
+    // The filtered children are first. These include the children with
+    // filters only on their subfields, e.g. struct members or map keys.
     for (auto i = 1; i < children_.size(); ++i) {
-      if (!children_[i]->filter_) {
+      if (!children_[i]->hasFilter()) {
         break;
       }
       if (children_[i - 1]->selectivity_.timeToDropValue() >
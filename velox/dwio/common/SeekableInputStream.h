@@ -57,6 +57,14 @@ class SeekableInputStream : public google::protobuf::io::ZeroCopyInputStream {
   // ORC/DWRF stream address.
   virtual size_t positionSize() = 0;
 
+  // Returns a Buffer over the memory returned by the last Next() that keeps
+  // the memory valid after 'this' moves on, or nullptr if the memory is only
+  // valid until the next call on 'this'. Readers can then reference the
+  // memory from result vectors instead of copying it.
+  virtual BufferPtr sharedBuffer() {
+    return nullptr;
+  }
+
   void readFully(char* buffer, size_t bufferSize);
 };
 
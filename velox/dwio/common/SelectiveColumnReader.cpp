@@ -294,8 +294,10 @@ void SelectiveColumnReader::compactScalarValues<bool, bool>(
 
 char* SelectiveColumnReader::copyStringValue(folly::StringPiece value) {
   uint64_t size = value.size();
-  if (stringBuffers_.empty() || rawStringUsed_ + size > rawStringSize_) {
-    if (!stringBuffers_.empty()) {
+  // 'stringBuffers_' may hold only pinned buffers, which are not writable.
+  if (stringBuffers_.empty() || !rawStringBuffer_ ||
+      rawStringUsed_ + size > rawStringSize_) {
+    if (!stringBuffers_.empty() && rawStringBuffer_) {
       stringBuffers_.back()->setSize(rawStringUsed_);
     }
     auto bytes = std::max(size, kStringBufferSize);
@@ -313,6 +315,12 @@ char* SelectiveColumnReader::copyStringValue(folly::StringPiece value) {
   return rawStringBuffer_ + start;
 }
 
+void SelectiveColumnReader::pinStringBuffer(BufferPtr buffer) {
+  pinnedStringStart_ = buffer->as<char>();
+  pinnedStringEnd_ = pinnedStringStart_ + buffer->size();
+  stringBuffers_.insert(stringBuffers_.begin(), std::move(buffer));
+}
+
 void SelectiveColumnReader::addStringValue(folly::StringPiece value) {
   auto copy = copyStringValue(value);
   reinterpret_cast<StringView*>(rawValues_)[numValues_++] =
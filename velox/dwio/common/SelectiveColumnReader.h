@@ -20,6 +20,7 @@
 #include "velox/common/process/ProcessBase.h"
 #include "velox/dwio/common/ColumnSelector.h"
 #include "velox/dwio/common/FormatData.h"
+#include "velox/dwio/common/Mutation.h"
 #include "velox/dwio/common/ScanSpec.h"
 #include "velox/type/Filter.h"
 
@@ -139,11 +140,12 @@ class SelectiveColumnReader {
    * Read the next group of values into a RowVector.
    * @param numValues the number of values to read
    * @param vector to read into
+   * @param mutation rows to leave out of the read, if any
    */
   virtual void next(
       uint64_t /*numValues*/,
       VectorPtr& /*result*/,
-      const uint64_t* FOLLY_NULLABLE /*incomingNulls*/ = nullptr) {
+      const Mutation* FOLLY_NULLABLE /*mutation*/ = nullptr) {
     VELOX_UNSUPPORTED("next() is only defined in SelectiveStructColumnReader");
   }
 
@@ -506,6 +508,24 @@ class SelectiveColumnReader {
   // copy.
   char* FOLLY_NONNULL copyStringValue(folly::StringPiece value);
 
+  // Makes the strings inside 'buffer' be referenced by the result instead of
+  // copied. 'buffer' is added to the string buffers of the result. Replaces
+  // the previously pinned buffer, which stays referenced by the result.
+  void pinStringBuffer(BufferPtr buffer);
+
+  // Stops referencing strings in the pinned buffer. Must be called when the
+  // string buffers are handed over to a result.
+  void clearPinnedStringBuffer() {
+    pinnedStringStart_ = nullptr;
+    pinnedStringEnd_ = nullptr;
+  }
+
+  // True if 'value' is inside the pinned buffer.
+  bool isPinnedString(folly::StringPiece value) const {
+    return pinnedStringStart_ && value.data() >= pinnedStringStart_ &&
+        value.data() + value.size() <= pinnedStringEnd_;
+  }
+
   memory::MemoryPool& memoryPool_;
 
   // Requested Velox type
@@ -582,8 +602,12 @@ class SelectiveColumnReader {
   raw_vector<int32_t> innerNonNullRows_;
   // Buffers backing the StringViews in 'values' when reading strings.
   std::vector<BufferPtr> stringBuffers_;
-  // Writable contents of 'stringBuffers_.back()'.
+  // Writable contents of 'stringBuffers_.back()'. The pinned buffers are
+  // inserted in front of the writable one.
   char* FOLLY_NULLABLE rawStringBuffer_ = nullptr;
+  // Range of the buffer given to pinStringBuffer().
+  const char* FOLLY_NULLABLE pinnedStringStart_ = nullptr;
+  const char* FOLLY_NULLABLE pinnedStringEnd_ = nullptr;
   // True if a vector can acquire a pin to a stream's buffer and refer
   // to that as its values.
   bool mayUseStreamBuffer_ = false;
@@ -610,7 +634,7 @@ class SelectiveColumnReader {
 template <>
 inline void SelectiveColumnReader::addValue(const folly::StringPiece value) {
   const uint64_t size = value.size();
-  if (size <= StringView::kInlineSize) {
+  if (size <= StringView::kInlineSize || isPinnedString(value)) {
     reinterpret_cast<StringView*>(rawValues_)[numValues_++] =
         StringView(value.data(), size);
     return;
@@ -55,13 +55,16 @@ uint64_t SelectiveStructColumnReaderBase::skip(uint64_t numValues) {
 void SelectiveStructColumnReaderBase::next(
     uint64_t numValues,
     VectorPtr& result,
-    const uint64_t* incomingNulls) {
-  VELOX_CHECK(!incomingNulls, "next may only be called for the root reader.");
+    const Mutation* mutation) {
+  const uint64_t* deletedRows = mutation ? mutation->deletedRows : nullptr;
   if (children_.empty()) {
     // no readers
     // This can be either count(*) query or a query that select only
     // constant columns (partition keys or columns missing from an old file
     // due to schema evolution)
+    if (deletedRows) {
+      numValues -= bits::countBits(deletedRows, 0, numValues);
+    }
     result->resize(numValues);
 
     auto resultRowVector = std::dynamic_pointer_cast<RowVector>(result);
@@ -74,12 +77,34 @@ void SelectiveStructColumnReaderBase::next(
     }
     return;
   }
-  auto oldSize = rows_.size();
-  rows_.resize(numValues);
-  if (numValues > oldSize) {
-    std::iota(&rows_[oldSize], &rows_[rows_.size()], oldSize);
+  const vector_size_t offset = readOffset_;
+  if (deletedRows) {
+    rows_.resize(numValues);
+    vector_size_t numRows = 0;
+    bits::forEachUnsetBit(
+        deletedRows, 0, numValues, [&](auto row) { rows_[numRows++] = row; });
+    rows_.resize(numRows);
+    if (rows_.empty()) {
+      // The field readers skip the deleted rows on the next read.
+      readOffset_ = offset + numValues;
+      result->resize(0);
+      return;
+    }
+  } else {
+    // 'rows_' has gaps after a read with deleted rows.
+    if (!rows_.empty() &&
+        static_cast<size_t>(rows_.back()) != rows_.size() - 1) {
+      rows_.clear();
+    }
+    auto oldSize = rows_.size();
+    rows_.resize(numValues);
+    if (numValues > oldSize) {
+      std::iota(&rows_[oldSize], &rows_[rows_.size()], oldSize);
+    }
   }
-  read(readOffset_, rows_, nullptr);
+  read(offset, rows_, nullptr);
+  // Trailing deleted rows are not read but are consumed.
+  readOffset_ = offset + numValues;
   getValues(outputRows(), &result);
 }
 
@@ -87,6 +112,13 @@ void SelectiveStructColumnReaderBase::read(
     vector_size_t offset,
     RowSet rows,
     const uint64_t* incomingNulls) {
+  for (const auto& field : lazyFields_) {
+    if (!field.loaded) {
+      ++numLazyNotLoaded_;
+      lazyBytesNotLoaded_ += field.bytes;
+    }
+  }
+  lazyFields_.clear();
   numReads_ = scanSpec_->newRead();
   prepareRead<char>(offset, rows, incomingNulls);
   RowSet activeRows = rows;
@@ -177,7 +209,46 @@ void SelectiveStructColumnReaderBase::recordParentNullsInChildren(
   }
 }
 
+void SelectiveStructColumnReaderBase::recordLazyLoad(
+    const SelectiveColumnReader* fieldReader) {
+  for (auto& field : lazyFields_) {
+    if (field.reader == fieldReader) {
+      field.loaded = true;
+      return;
+    }
+  }
+}
+
+void SelectiveStructColumnReaderBase::updateRuntimeStats(
+    RuntimeStatistics& stats) const {
+  stats.lazyVectorsNotLoaded += numLazyNotLoaded_;
+  stats.lazyBytesNotLoaded += lazyBytesNotLoaded_;
+  for (const auto& field : lazyFields_) {
+    if (!field.loaded) {
+      ++stats.lazyVectorsNotLoaded;
+      stats.lazyBytesNotLoaded += field.bytes;
+    }
+  }
+  for (const auto* child : children_) {
+    if (child && child->type()->kind() == TypeKind::ROW) {
+      static_cast<const SelectiveStructColumnReaderBase*>(child)
+          ->updateRuntimeStats(stats);
+    }
+  }
+}
+
 namespace {
+// Returns the size of the fixed width part of 'numRows' values of 'type'.
+int64_t estimateLazyBytes(const Type& type, vector_size_t numRows) {
+  if (type.isFixedWidth()) {
+    return type.cppSizeInBytes() * numRows;
+  }
+  if (type.isPrimitiveType()) {
+    return sizeof(StringView) * numRows;
+  }
+  return 0;
+}
+
 //   Recursively makes empty RowVectors for positions in 'children'
 //   where the corresponding child type in 'rowType' is a row. The
 //   reader expects RowVector outputs to be initialized so that the
@@ -257,9 +328,14 @@ void SelectiveStructColumnReaderBase::getValues(
           }
           lazyPrepared = true;
         }
+        const auto& childType = resultRow->type()->childAt(channel);
+        lazyFields_.push_back(
+            {children_[index],
+             estimateLazyBytes(*childType, rows.size()),
+             false});
         resultRow->childAt(channel) = std::make_shared<LazyVector>(
             &memoryPool_,
-            resultRow->type()->childAt(channel),
+            childType,
             rows.size(),
             std::make_unique<ColumnLoader>(this, children_[index], numReads_));
       } else {
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "velox/dwio/common/SelectiveColumnReaderInternal.h"
+#include "velox/dwio/common/Statistics.h"
 
 namespace facebook::velox::dwio::common {
 
@@ -30,10 +31,8 @@ class SelectiveStructColumnReaderBase : public SelectiveColumnReader {
 
   uint64_t skip(uint64_t numValues) override;
 
-  void next(
-      uint64_t numValues,
-      VectorPtr& result,
-      const uint64_t* incomingNulls) override;
+  void next(uint64_t numValues, VectorPtr& result, const Mutation* mutation)
+      override;
 
   void filterRowGroups(
       uint64_t rowGroupSize,
@@ -98,6 +97,16 @@ class SelectiveStructColumnReaderBase : public SelectiveColumnReader {
     return debugString_;
   }
 
+  // Called by a ColumnLoader made by 'this' when it loads the LazyVector of
+  // 'fieldReader'.
+  void recordLazyLoad(const SelectiveColumnReader* fieldReader);
+
+  // Adds the number and the estimated size of the LazyVectors made by 'this'
+  // and its struct children that have not been loaded to 'stats'. The
+  // LazyVectors of the last read count as not loaded if they are not loaded
+  // at the time of the call.
+  void updateRuntimeStats(RuntimeStatistics& stats) const;
+
  protected:
   SelectiveStructColumnReaderBase(
       const std::shared_ptr<const dwio::common::TypeWithId>& requestedType,
@@ -125,6 +134,21 @@ class SelectiveStructColumnReaderBase : public SelectiveColumnReader {
 
   vector_size_t lazyVectorReadOffset_;
 
+  // A LazyVector made by getValues() in the current read.
+  struct LazyField {
+    const SelectiveColumnReader* reader;
+    // Estimated size of the values of the LazyVector.
+    int64_t bytes;
+    bool loaded;
+  };
+
+  std::vector<LazyField> lazyFields_;
+
+  // Number and estimated size of the LazyVectors of the previous reads that
+  // were not loaded.
+  int64_t numLazyNotLoaded_{0};
+  int64_t lazyBytesNotLoaded_{0};
+
   // Dense set of rows to read in next().
   raw_vector<vector_size_t> rows_;
 
@@ -520,15 +520,45 @@ struct RuntimeStatistics {
   // Total bytes in splits skipped based on statistics.
   int64_t skippedSplitBytes{0};
 
+  // Number of splits skipped because a filter on a partition key rejects the
+  // partition value. These are also counted in 'skippedSplits' but are
+  // skipped before their file is opened.
+  int64_t skippedPartitionSplits{0};
+
+  // Number of splits skipped based on the statistics carried by the split.
+  // These are also counted in 'skippedSplits' but are skipped before their
+  // file is opened.
+  int64_t skippedSplitsByMetadata{0};
+
   // Number of strides (row groups) skipped based on statistics.
   int64_t skippedStrides{0};
 
+  // Number of rows skipped based on page statistics, i.e. the Parquet page
+  // index.
+  int64_t skippedPageRows{0};
+
+  // Number of LazyVectors made by the readers for non-filter columns that were
+  // never loaded, e.g. because a downstream filter or join dropped all their
+  // rows.
+  int64_t lazyVectorsNotLoaded{0};
+
+  // Estimated size of the values of the never loaded LazyVectors, i.e. the
+  // decoding avoided by late materialization. Only the fixed width part of
+  // the values is counted.
+  int64_t lazyBytesNotLoaded{0};
+
   std::unordered_map<std::string, RuntimeCounter> toMap() {
     return {
         {"skippedSplits", RuntimeCounter(skippedSplits)},
         {"skippedSplitBytes",
          RuntimeCounter(skippedSplitBytes, RuntimeCounter::Unit::kBytes)},
-        {"skippedStrides", RuntimeCounter(skippedStrides)}};
+        {"skippedPartitionSplits", RuntimeCounter(skippedPartitionSplits)},
+        {"skippedSplitsByMetadata", RuntimeCounter(skippedSplitsByMetadata)},
+        {"skippedStrides", RuntimeCounter(skippedStrides)},
+        {"skippedPageRows", RuntimeCounter(skippedPageRows)},
+        {"lazyVectorsNotLoaded", RuntimeCounter(lazyVectorsNotLoaded)},
+        {"lazyBytesNotLoaded",
+         RuntimeCounter(lazyBytesNotLoaded, RuntimeCounter::Unit::kBytes)}};
   }
 };
 
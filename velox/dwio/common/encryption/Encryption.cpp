@@ -27,6 +27,148 @@ bool operator==(const EncryptionProperties& a, const EncryptionProperties& b) {
       (typeid(a) == typeid(b) && a.equals(b));
 }
 
+class CachingDecrypterFactory::Cache {
+ public:
+  Cache(
+      std::shared_ptr<DecrypterFactory> factory,
+      std::chrono::milliseconds ttl,
+      size_t maxEntries)
+      : factory_{std::move(factory)}, ttl_{ttl}, maxEntries_{maxEntries} {
+    DWIO_ENSURE_NOT_NULL(factory_);
+  }
+
+  // Returns a decrypter of 'provider' with 'key' loaded.
+  std::unique_ptr<Decrypter> load(
+      EncryptionProvider provider,
+      const std::string& key) {
+    const auto now = std::chrono::steady_clock::now();
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      auto it = entries_.find({provider, key});
+      if (it != entries_.end() && it->second.expiration > now) {
+        return it->second.decrypter->clone();
+      }
+    }
+
+    // Loads outside of the mutex. Concurrent loads of the same key both go
+    // to the wrapped factory.
+    auto decrypter = factory_->create(provider);
+    DWIO_ENSURE_NOT_NULL(decrypter, "invalid provider");
+    decrypter->setKey(key);
+    std::lock_guard<std::mutex> l(mutex_);
+    ++numLoads_;
+    if (!decrypter->isKeyLoaded()) {
+      return decrypter;
+    }
+    if (entries_.size() >= maxEntries_) {
+      evictLocked(now);
+    }
+    entries_[{provider, key}] = {decrypter->clone(), now + ttl_};
+    return decrypter;
+  }
+
+  uint64_t numLoads() const {
+    std::lock_guard<std::mutex> l(mutex_);
+    return numLoads_;
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> l(mutex_);
+    entries_.clear();
+  }
+
+ private:
+  struct Entry {
+    std::unique_ptr<Decrypter> decrypter;
+    std::chrono::steady_clock::time_point expiration;
+  };
+
+  // Removes the expired entries, or all entries if none has expired.
+  void evictLocked(std::chrono::steady_clock::time_point now) {
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      if (it->second.expiration <= now) {
+        it = entries_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    if (entries_.size() >= maxEntries_) {
+      entries_.clear();
+    }
+  }
+
+  const std::shared_ptr<DecrypterFactory> factory_;
+  const std::chrono::milliseconds ttl_;
+  const size_t maxEntries_;
+  mutable std::mutex mutex_;
+  std::map<std::pair<EncryptionProvider, std::string>, Entry> entries_;
+  uint64_t numLoads_{0};
+};
+
+namespace {
+// Decrypter that takes its keys from a CachingDecrypterFactory::Cache.
+class CachingDecrypter : public Decrypter {
+ public:
+  CachingDecrypter(
+      std::shared_ptr<CachingDecrypterFactory::Cache> cache,
+      EncryptionProvider provider,
+      std::string key,
+      std::unique_ptr<Decrypter> decrypter)
+      : cache_{std::move(cache)},
+        provider_{provider},
+        key_{std::move(key)},
+        decrypter_{std::move(decrypter)} {}
+
+  void setKey(const std::string& key) override {
+    if (decrypter_ && key == key_ && decrypter_->isKeyLoaded()) {
+      return;
+    }
+    decrypter_ = cache_->load(provider_, key);
+    key_ = key;
+  }
+
+  bool isKeyLoaded() const override {
+    return decrypter_ && decrypter_->isKeyLoaded();
+  }
+
+  std::unique_ptr<folly::IOBuf> decrypt(
+      folly::StringPiece input) const override {
+    DWIO_ENSURE_NOT_NULL(decrypter_, "decryption key is not set");
+    return decrypter_->decrypt(input);
+  }
+
+  std::unique_ptr<Decrypter> clone() const override {
+    return std::make_unique<CachingDecrypter>(
+        cache_, provider_, key_, decrypter_ ? decrypter_->clone() : nullptr);
+  }
+
+ private:
+  const std::shared_ptr<CachingDecrypterFactory::Cache> cache_;
+  const EncryptionProvider provider_;
+  std::string key_;
+  std::unique_ptr<Decrypter> decrypter_;
+};
+} // namespace
+
+CachingDecrypterFactory::CachingDecrypterFactory(
+    std::shared_ptr<DecrypterFactory> factory,
+    std::chrono::milliseconds ttl,
+    size_t maxEntries)
+    : cache_{std::make_shared<Cache>(std::move(factory), ttl, maxEntries)} {}
+
+std::unique_ptr<Decrypter> CachingDecrypterFactory::create(
+    EncryptionProvider provider) {
+  return std::make_unique<CachingDecrypter>(cache_, provider, "", nullptr);
+}
+
+uint64_t CachingDecrypterFactory::numLoads() const {
+  return cache_->numLoads();
+}
+
+void CachingDecrypterFactory::clear() {
+  cache_->clear();
+}
+
 } // namespace encryption
 } // namespace common
 } // namespace dwio
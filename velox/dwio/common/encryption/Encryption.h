@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <chrono>
+#include <map>
+#include <mutex>
 #include "folly/Range.h"
 #include "folly/io/IOBuf.h"
 #include "velox/dwio/common/exception/Exception.h"
@@ -99,6 +102,35 @@ class DecrypterFactory {
   virtual std::unique_ptr<Decrypter> create(EncryptionProvider provider) = 0;
 };
 
+// Decrypter factory that shares the keys loaded by the decrypters of another
+// factory between all the readers using it. Loading a key usually unwraps it
+// with a key management service, which is otherwise repeated by every reader
+// and stripe encrypted with the same key. A decrypter is created and its key
+// loaded once per provider and key metadata, and is cloned for later setKey()
+// calls with the same key metadata until 'ttl' after loading. At most
+// 'maxEntries' keys are kept. Keep one instance per process, or per set of
+// credentials if the factories are created per user.
+class CachingDecrypterFactory : public DecrypterFactory {
+ public:
+  CachingDecrypterFactory(
+      std::shared_ptr<DecrypterFactory> factory,
+      std::chrono::milliseconds ttl,
+      size_t maxEntries = 1'000);
+
+  std::unique_ptr<Decrypter> create(EncryptionProvider provider) override;
+
+  // Returns the number of keys loaded through the wrapped factory.
+  uint64_t numLoads() const;
+
+  // Drops all the cached keys.
+  void clear();
+
+  class Cache;
+
+ private:
+  const std::shared_ptr<Cache> cache_;
+};
+
 class DummyDecrypter : public Decrypter {
  public:
   void setKey(const std::string& /* unused */) override {}
@@ -18,6 +18,7 @@
 #include "velox/common/base/Nulls.h"
 #include "velox/dwio/parquet/reader/RleBpDataDecoder.h"
 
+#include <folly/CpuId.h>
 #include <folly/Random.h>
 #include <gtest/gtest.h>
 
@@ -159,6 +160,15 @@ TEST_F(BitPackDecoderTest, uint8AllRows) {
   for (auto width = 1; width <= 8; ++width) {
     testUnpack<uint8_t>(width);
   }
+#if defined(__x86_64__) && !XSIMD_WITH_AVX2 && !defined(__BMI2__)
+  // Also checks the other side of the runtime dispatch to PDEP.
+  const bool hasBmi2 = bits::detail::hasBmi2;
+  bits::detail::hasBmi2 = !hasBmi2 && folly::CpuId().bmi2();
+  for (auto width = 1; width <= 8; ++width) {
+    testUnpack<uint8_t>(width);
+  }
+  bits::detail::hasBmi2 = hasBmi2;
+#endif
 }
 
 TEST_F(BitPackDecoderTest, uint16AllRows) {
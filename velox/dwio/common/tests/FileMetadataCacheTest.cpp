@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/FileMetadataCache.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwio::common;
+
+namespace {
+class TestMetadata : public FileMetadata {
+ public:
+  explicit TestMetadata(uint64_t size) : size_(size) {}
+
+  uint64_t memoryUsage() const override {
+    return size_;
+  }
+
+ private:
+  const uint64_t size_;
+};
+} // namespace
+
+TEST(FileMetadataCacheTest, getAndPut) {
+  FileMetadataCache cache(0);
+  ASSERT_FALSE(cache.enabled());
+  cache.put("a", std::make_shared<TestMetadata>(10));
+  ASSERT_EQ(cache.get("a"), nullptr);
+
+  cache.setCapacity(100);
+  ASSERT_TRUE(cache.enabled());
+  auto a = std::make_shared<TestMetadata>(40);
+  cache.put("a", a);
+  ASSERT_EQ(cache.get("a"), a);
+  ASSERT_EQ(cache.get("b"), nullptr);
+
+  // Adding 'b' evicts 'c', the least recently used.
+  cache.put("c", std::make_shared<TestMetadata>(40));
+  ASSERT_NE(cache.get("a"), nullptr);
+  auto b = std::make_shared<TestMetadata>(40);
+  cache.put("b", b);
+  ASSERT_EQ(cache.get("c"), nullptr);
+  ASSERT_EQ(cache.get("a"), a);
+  ASSERT_EQ(cache.get("b"), b);
+  ASSERT_EQ(cache.stats().numElements, 2);
+
+  // An entry larger than the capacity is not cached.
+  cache.put("d", std::make_shared<TestMetadata>(200));
+  ASSERT_EQ(cache.get("d"), nullptr);
+
+  // Setting the capacity drops the entries.
+  cache.setCapacity(100);
+  ASSERT_EQ(cache.get("a"), nullptr);
+  // The metadata stays alive after it is dropped.
+  ASSERT_EQ(a->memoryUsage(), 40);
+}
+
+TEST(FileMetadataCacheTest, key) {
+  InMemoryReadFile inMemory(std::string(10, 'x'));
+  ASSERT_FALSE(FileMetadataCache::key(inMemory).has_value());
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/dwio/common/IoStatistics.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox::dwio::common;
+
+TEST(IoLatencyModelTest, estimate) {
+  IoLatencyModel model;
+  // 50ms first byte latency and 100 bytes per microsecond.
+  auto readMicros = [](uint64_t bytes) { return 50'000 + bytes / 100; };
+  for (auto i = 0; i < IoLatencyModel::kMinSamples - 1; ++i) {
+    const uint64_t bytes = (i + 1) << 20;
+    model.record(bytes, readMicros(bytes));
+  }
+  ASSERT_FALSE(model.estimate().has_value());
+  EXPECT_EQ(123, model.coalesceDistance(123));
+
+  model.record(100 << 20, readMicros(100 << 20));
+  auto estimate = model.estimate();
+  ASSERT_TRUE(estimate.has_value());
+  EXPECT_NEAR(50'000, estimate->latencyMicros, 10);
+  EXPECT_NEAR(100, estimate->bytesPerMicro, 0.1);
+  // About 5MB can be read in the time of one first byte latency.
+  EXPECT_NEAR(5'000'000, model.coalesceDistance(123), 10'000);
+}
+
+TEST(IoLatencyModelTest, sameSizeReads) {
+  IoLatencyModel model;
+  for (auto i = 0; i < 100; ++i) {
+    model.record(1 << 20, 1'000 + i % 3);
+  }
+  // The latency can't be told apart from transfer time.
+  EXPECT_FALSE(model.estimate().has_value());
+}
+
+TEST(IoLatencyModelTest, coalesceDistanceBounds) {
+  IoLatencyModel fast;
+  IoLatencyModel slow;
+  for (auto i = 1; i <= 20; ++i) {
+    const uint64_t bytes = i << 20;
+    // No latency and 1GB/s.
+    fast.record(bytes, bytes / 1'000);
+    // 1s latency and 1GB/s.
+    slow.record(bytes, 1'000'000 + bytes / 1'000);
+  }
+  EXPECT_EQ(IoLatencyModel::kMinCoalesceDistance, fast.coalesceDistance(0));
+  EXPECT_EQ(IoLatencyModel::kMaxCoalesceDistance, slow.coalesceDistance(0));
+
+  // Merging combines the samples.
+  IoLatencyModel merged;
+  merged.merge(slow);
+  EXPECT_EQ(IoLatencyModel::kMaxCoalesceDistance, merged.coalesceDistance(0));
+}
+
+TEST(IoLatencyHistogramTest, buckets) {
+  IoLatencyHistogram histogram;
+  for (auto micros : {0, 99, 100, 999, 5'000, 99'999, 100'000, 2'000'000}) {
+    histogram.record(micros);
+  }
+  EXPECT_EQ(2, histogram.count(0));
+  EXPECT_EQ(2, histogram.count(1));
+  EXPECT_EQ(1, histogram.count(2));
+  EXPECT_EQ(1, histogram.count(3));
+  EXPECT_EQ(1, histogram.count(4));
+  EXPECT_EQ(1, histogram.count(5));
+  EXPECT_STREQ("Under100us", IoLatencyHistogram::bucketName(0));
+  EXPECT_STREQ("Over1s", IoLatencyHistogram::bucketName(5));
+
+  IoLatencyHistogram other;
+  other.record(50);
+  histogram.merge(other);
+  EXPECT_EQ(3, histogram.count(0));
+}
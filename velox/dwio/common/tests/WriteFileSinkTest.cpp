@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/dwio/common/DataSink.h"
+#include "velox/common/memory/Memory.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using namespace facebook::velox::exec::test;
+
+namespace facebook::velox::dwio::common {
+
+TEST(WriteFileSinkTest, write) {
+  auto root = TempDirectoryPath::create();
+  const auto filePath = root->path + "/test_file";
+  auto pool = memory::getDefaultMemoryPool();
+
+  WriteFileSink sink(std::make_unique<LocalWriteFile>(filePath), filePath);
+  std::vector<DataBuffer<char>> buffers;
+  for (auto i = 0; i < 3; ++i) {
+    DataBuffer<char> buffer(*pool, 10);
+    std::memset(buffer.data(), 'a' + i, 10);
+    buffers.push_back(std::move(buffer));
+  }
+  sink.write(buffers);
+  ASSERT_TRUE(buffers.empty());
+  ASSERT_EQ(sink.size(), 30);
+  sink.close();
+
+  LocalReadFile readFile(filePath);
+  ASSERT_EQ(
+      readFile.pread(0, 30),
+      std::string(10, 'a') + std::string(10, 'b') + std::string(10, 'c'));
+}
+
+TEST(WriteFileSinkTest, factory) {
+  WriteFileSink::registerFactory();
+  // Local paths are not created as WriteFileSinks.
+  auto root = TempDirectoryPath::create();
+  auto sink = DataSink::create(root->path + "/local_file");
+  ASSERT_EQ(dynamic_cast<WriteFileSink*>(sink.get()), nullptr);
+  sink->close();
+}
+
+} // namespace facebook::velox::dwio::common
@@ -479,7 +479,8 @@ std::unique_ptr<dwio::common::SeekableInputStream> createDecompressor(
     uint64_t blockSize,
     MemoryPool& pool,
     const std::string& streamDebugInfo,
-    const Decrypter* decrypter) {
+    const Decrypter* decrypter,
+    const DecompressionReadAhead& readAhead) {
   std::unique_ptr<Decompressor> decompressor;
   switch (static_cast<int64_t>(kind)) {
     case dwio::common::CompressionKind_NONE:
@@ -517,12 +518,16 @@ std::unique_ptr<dwio::common::SeekableInputStream> createDecompressor(
     default:
       DWIO_RAISE("Unknown compression codec ", kind);
   }
+  // The block zlib decompressor used for encrypted streams keeps state and
+  // cannot decompress blocks in parallel.
+  const bool canReadAhead = kind != dwio::common::CompressionKind_ZLIB;
   return std::make_unique<PagedInputStream>(
       std::move(input),
       pool,
       std::move(decompressor),
       decrypter,
-      streamDebugInfo);
+      streamDebugInfo,
+      canReadAhead ? readAhead : DecompressionReadAhead{});
 }
 
 } // namespace facebook::velox::dwrf
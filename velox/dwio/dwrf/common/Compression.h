@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <folly/Executor.h>
+#include <atomic>
+
 #include "velox/dwio/common/Common.h"
 #include "velox/dwio/common/SeekableInputStream.h"
 #include "velox/dwio/dwrf/common/Common.h"
@@ -60,17 +63,69 @@ class Decompressor {
       char* dest,
       uint64_t destLength) = 0;
 
+  // The maximum uncompressed size of a compression block.
+  uint64_t blockSize() const {
+    return blockSize_;
+  }
+
  protected:
   uint64_t blockSize_;
   const std::string streamDebugInfo_;
 };
 
+// Bounds the memory held by the compressed and decompressed blocks that the
+// streams sharing it decompress ahead of their readers.
+class ReadAheadBudget {
+ public:
+  explicit ReadAheadBudget(uint64_t maxBytes) : maxBytes_{maxBytes} {}
+
+  // Reserves 'bytes' if that does not exceed the budget. Returns false
+  // otherwise.
+  bool tryReserve(uint64_t bytes) {
+    auto reserved = reservedBytes_.load();
+    do {
+      if (reserved + bytes > maxBytes_) {
+        return false;
+      }
+    } while (!reservedBytes_.compare_exchange_weak(reserved, reserved + bytes));
+    return true;
+  }
+
+  void release(uint64_t bytes) {
+    reservedBytes_ -= bytes;
+  }
+
+  uint64_t reservedBytes() const {
+    return reservedBytes_;
+  }
+
+  uint64_t maxBytes() const {
+    return maxBytes_;
+  }
+
+ private:
+  const uint64_t maxBytes_;
+  std::atomic<uint64_t> reservedBytes_{0};
+};
+
+// Makes a compressed stream decompress the next 'numBlocks' compression
+// blocks on 'executor' while the reader consumes the current one. The
+// memory for the blocks read ahead is reserved from 'budget'. Only blocks
+// compressed with a stateless codec (ZSTD, LZ4, Snappy, LZO) are read ahead.
+// The blocks of an encrypted stream are also decrypted on 'executor'.
+struct DecompressionReadAhead {
+  folly::Executor* executor{nullptr};
+  int32_t numBlocks{0};
+  std::shared_ptr<ReadAheadBudget> budget;
+};
+
 /**
  * Create a decompressor for the given compression kind.
  * @param kind the compression type to implement
  * @param input the input stream that is the underlying source
  * @param bufferSize the maximum size of the buffer
  * @param pool the memory pool
+ * @param readAhead enables decompressing blocks ahead of the reader
  */
 std::unique_ptr<dwio::common::SeekableInputStream> createDecompressor(
     dwio::common::CompressionKind kind,
@@ -78,7 +133,8 @@ std::unique_ptr<dwio::common::SeekableInputStream> createDecompressor(
     uint64_t bufferSize,
     memory::MemoryPool& pool,
     const std::string& streamDebugInfo,
-    const dwio::common::encryption::Decrypter* decryptr = nullptr);
+    const dwio::common::encryption::Decrypter* decryptr = nullptr,
+    const DecompressionReadAhead& readAhead = {});
 
 /**
  * Create a compressor for the given compression kind.
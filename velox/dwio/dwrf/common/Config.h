@@ -47,6 +47,10 @@ class Config : public common::ConfigBase<Config> {
   static Entry<float> DICTIONARY_NUMERIC_KEY_SIZE_THRESHOLD;
   static Entry<float> DICTIONARY_STRING_KEY_SIZE_THRESHOLD;
   static Entry<bool> DICTIONARY_SORT_KEYS;
+  // Number of rows of the first stripe after which a column abandons
+  // dictionary encoding if its keys are not repeated enough. Zero only checks
+  // when the first stripe is flushed.
+  static Entry<uint32_t> DICTIONARY_EARLY_ABANDON_ROWS;
   static Entry<float> ENTROPY_KEY_STRING_SIZE_THRESHOLD;
   static Entry<uint32_t> ENTROPY_STRING_MIN_SAMPLES;
   static Entry<float> ENTROPY_STRING_DICT_SAMPLE_FRACTION;
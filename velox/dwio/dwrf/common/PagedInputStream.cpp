@@ -15,6 +15,8 @@
  */
 
 #include "velox/dwio/dwrf/common/PagedInputStream.h"
+#include <folly/ScopeGuard.h>
+#include <algorithm>
 #include "velox/dwio/common/SeekableInputStream.h"
 #include "velox/dwio/common/exception/Exception.h"
 
@@ -122,7 +124,14 @@ bool PagedInputStream::Next(const void** data, int32_t* size) {
   decryptionBuffer_ = nullptr;
 
   if (state_ == State::HEADER || remainingLength_ == 0) {
-    readHeader();
+    if (readAhead_.numBlocks > 0) {
+      readAhead();
+    }
+    if (readAheadBlocks_.empty()) {
+      readHeader();
+    } else if (nextReadAheadBlock(data, size)) {
+      return true;
+    }
   }
   if (state_ == State::END) {
     return false;
@@ -189,6 +198,165 @@ bool PagedInputStream::Next(const void** data, int32_t* size) {
   return true;
 }
 
+void PagedInputStream::readAhead() {
+  if (!readAheadBlocks_.empty() && !readAheadBlocks_.back().decompressed) {
+    // The next block after the ones read ahead is read from 'input_'.
+    return;
+  }
+  while (readAheadBlocks_.size() < static_cast<size_t>(readAhead_.numBlocks)) {
+    uint32_t header = readByte(false);
+    if (state_ == State::END) {
+      // readHeader() finds the end of the stream after the blocks read ahead.
+      state_ = State::HEADER;
+      return;
+    }
+    ReadAheadBlock block;
+    block.headerOffset =
+        input_->ByteCount() - (inputBufferPtrEnd_ - inputBufferPtr_) - 1;
+    header |= readByte(true) << 8;
+    header |= readByte(true) << 16;
+    block.state = (header & 1) ? State::ORIGINAL : State::START;
+    block.length = header >> 1;
+    if (block.state == State::ORIGINAL && !decrypter_) {
+      // Uncompressed blocks are returned as views into 'input_'.
+      readAheadBlocks_.push_back(std::move(block));
+      return;
+    }
+
+    // The compressed block is copied since the ranges returned by 'input_'
+    // are not valid after the next call to 'input_->Next()'.
+    auto compressed =
+        std::make_shared<dwio::common::DataBuffer<char>>(pool_, block.length);
+    for (size_t pos = 0; pos < block.length;) {
+      if (inputBufferPtr_ == inputBufferPtrEnd_) {
+        readBuffer(true);
+      }
+      auto length = std::min(
+          static_cast<size_t>(inputBufferPtrEnd_ - inputBufferPtr_),
+          block.length - pos);
+      std::copy(
+          inputBufferPtr_, inputBufferPtr_ + length, compressed->data() + pos);
+      inputBufferPtr_ += length;
+      pos += length;
+    }
+    // Each block is decrypted with its own copy of the decrypter so that
+    // blocks decrypt in parallel without relying on the decrypter being
+    // thread safe. The copy also keeps the key of the current stripe.
+    std::shared_ptr<const dwio::common::encryption::Decrypter> decrypter;
+    uint64_t uncompressedLength = 0;
+    if (decrypter_) {
+      decrypter = decrypter_->clone();
+      // The length is known only after decryption. Reserves for the decrypted
+      // copy and a decompressed block of up to the compression block size.
+      uncompressedLength = block.length +
+          (block.state == State::START ? decompressor_->blockSize() : 0);
+    } else {
+      uncompressedLength = decompressor_->getUncompressedLength(
+          compressed->data(), block.length);
+    }
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    block.cancelled = cancelled;
+    block.decompressed =
+        std::make_shared<AsyncSource<dwio::common::DataBuffer<char>>>(
+            [this,
+             compressed,
+             uncompressedLength,
+             decrypter,
+             state = block.state,
+             cancelled]() -> std::unique_ptr<dwio::common::DataBuffer<char>> {
+              if (*cancelled) {
+                return nullptr;
+              }
+              const char* input = compressed->data();
+              size_t inputLength = compressed->size();
+              auto outputLength = uncompressedLength;
+              std::unique_ptr<folly::IOBuf> decrypted;
+              if (decrypter) {
+                decrypted =
+                    decrypter->decrypt(folly::StringPiece{input, inputLength});
+                input = reinterpret_cast<const char*>(decrypted->data());
+                inputLength = decrypted->length();
+                if (state == State::ORIGINAL) {
+                  auto output =
+                      std::make_unique<dwio::common::DataBuffer<char>>(
+                          pool_, inputLength);
+                  std::copy(input, input + inputLength, output->data());
+                  return output;
+                }
+                outputLength =
+                    decompressor_->getUncompressedLength(input, inputLength);
+              }
+              auto output = std::make_unique<dwio::common::DataBuffer<char>>(
+                  pool_, outputLength);
+              auto length = decompressor_->decompress(
+                  input, inputLength, output->data(), output->capacity());
+              if (length != output->size()) {
+                output->resize(length);
+              }
+              return output;
+            });
+
+    // A block over the budget is decompressed by the reader when it gets to
+    // the block, as without read-ahead.
+    const auto bytes = block.length + uncompressedLength;
+    const bool reserved = readAhead_.budget->tryReserve(bytes);
+    if (reserved) {
+      block.reservedBytes = bytes;
+      readAhead_.executor->add(
+          [source = block.decompressed]() { source->prepare(); });
+    }
+    readAheadBlocks_.push_back(std::move(block));
+    if (!reserved) {
+      return;
+    }
+  }
+}
+
+bool PagedInputStream::nextReadAheadBlock(const void** data, int32_t* size) {
+  auto block = std::move(readAheadBlocks_.front());
+  readAheadBlocks_.pop_front();
+  lastHeaderOffset_ = block.headerOffset;
+  bytesReturnedAtLastHeaderOffset_ = bytesReturned_;
+  if (!block.decompressed) {
+    state_ = block.state;
+    remainingLength_ = block.length;
+    return false;
+  }
+
+  SCOPE_EXIT {
+    readAhead_.budget->release(block.reservedBytes);
+  };
+  outputBuffer_ = block.decompressed->move();
+  DWIO_ENSURE_NOT_NULL(
+      outputBuffer_, "Missing read-ahead block in ", getName());
+  state_ = State::HEADER;
+  remainingLength_ = 0;
+  outputBufferLength_ = 0;
+  *data = outputBuffer_->data();
+  *size = static_cast<int32_t>(outputBuffer_->size());
+  outputBufferPtr_ = outputBuffer_->data() + outputBuffer_->size();
+  bytesReturned_ += *size;
+  lastWindowSize_ = *size;
+  return true;
+}
+
+void PagedInputStream::discardReadAhead(
+    std::deque<ReadAheadBlock>::iterator end) {
+  for (auto it = readAheadBlocks_.begin(); it != end; ++it) {
+    if (!it->decompressed) {
+      continue;
+    }
+    *it->cancelled = true;
+    // Waits for the decompression if it is running on the executor.
+    try {
+      it->decompressed->move();
+    } catch (const std::exception&) {
+    }
+    readAhead_.budget->release(it->reservedBytes);
+  }
+  readAheadBlocks_.erase(readAheadBlocks_.begin(), end);
+}
+
 void PagedInputStream::BackUp(int32_t count) {
   DWIO_ENSURE(
       outputBufferPtr_ != nullptr,
@@ -257,7 +425,26 @@ void PagedInputStream::seekToPosition(
         lastWindowSize_ < alreadyRead - uncompressedOffset;
   };
 
+  if (compressedOffset != lastHeaderOffset_ && !readAheadBlocks_.empty()) {
+    auto it = std::find_if(
+        readAheadBlocks_.begin(),
+        readAheadBlocks_.end(),
+        [&](const auto& block) {
+          return block.headerOffset == compressedOffset;
+        });
+    if (it != readAheadBlocks_.end()) {
+      // Continues from a block read ahead.
+      discardReadAhead(it);
+      state_ = State::HEADER;
+      remainingLength_ = 0;
+      outputBufferLength_ = 0;
+      Skip(uncompressedOffset);
+      return;
+    }
+  }
+
   if (compressedOffset != lastHeaderOffset_ || outsideOriginalWindow()) {
+    clearReadAhead();
     std::vector<uint64_t> positions = {compressedOffset};
     auto provider = dwio::common::PositionProvider(positions);
     input_->seekToPosition(provider);
@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <deque>
+
+#include "velox/common/base/AsyncSource.h"
 #include "velox/dwio/common/SeekableInputStream.h"
 #include "velox/dwio/dwrf/common/Compression.h"
 
@@ -28,16 +31,27 @@ class PagedInputStream : public dwio::common::SeekableInputStream {
       memory::MemoryPool& memPool,
       std::unique_ptr<Decompressor> decompressor,
       const dwio::common::encryption::Decrypter* decrypter,
-      const std::string& streamDebugInfo)
+      const std::string& streamDebugInfo,
+      const DecompressionReadAhead& readAhead = {})
       : input_(std::move(inStream)),
         pool_(memPool),
         inputBuffer_(pool_),
         decompressor_{std::move(decompressor)},
         decrypter_{decrypter},
-        streamDebugInfo_{streamDebugInfo} {
+        streamDebugInfo_{streamDebugInfo},
+        readAhead_{readAhead} {
     DWIO_ENSURE(
         decompressor_ || decrypter_,
         "one of decompressor or decryptor is required");
+    // Encrypted blocks are read ahead only if the stream is also compressed.
+    if ((decrypter_ && !decompressor_) || !readAhead_.executor ||
+        !readAhead_.budget) {
+      readAhead_.numBlocks = 0;
+    }
+  }
+
+  ~PagedInputStream() override {
+    clearReadAhead();
   }
 
   bool Next(const void** data, int32_t* size) override;
@@ -149,8 +163,50 @@ class PagedInputStream : public dwio::common::SeekableInputStream {
   const dwio::common::encryption::Decrypter* decrypter_;
 
  private:
+  // A compression block whose header has been read ahead of the reader.
+  struct ReadAheadBlock {
+    // Offset in 'input_' of the block header.
+    uint64_t headerOffset;
+    // State after reading the header, either START or ORIGINAL.
+    State state;
+    // The length of the block in 'input_'.
+    size_t length;
+    // The block decrypted and decompressed on the executor. nullptr if the
+    // block is not read ahead, in which case the block is read from 'input_'
+    // and this is the last block in 'readAheadBlocks_'.
+    std::shared_ptr<AsyncSource<dwio::common::DataBuffer<char>>>
+        decompressed;
+    // Set to tell the executor not to decompress a discarded block.
+    std::shared_ptr<std::atomic<bool>> cancelled;
+    // The bytes reserved from the read-ahead budget for the block.
+    uint64_t reservedBytes{0};
+  };
+
+  // Reads the headers of the next blocks of 'input_' and schedules the
+  // decryption and decompression of up to 'readAhead_.numBlocks' of them on
+  // the executor while there is budget. Stops at the first block that is
+  // neither compressed nor encrypted or does not fit in the budget. Called
+  // when the reader is at a block boundary.
+  void readAhead();
+
+  // Returns the next block read ahead in 'data' and 'size'. Returns false if
+  // the block is to be read from 'input_'.
+  bool nextReadAheadBlock(const void** data, int32_t* size);
+
+  // Discards the blocks in 'readAheadBlocks_' before 'end', waiting for the
+  // decompression of the ones running on the executor.
+  void discardReadAhead(std::deque<ReadAheadBlock>::iterator end);
+
+  void clearReadAhead() {
+    discardReadAhead(readAheadBlocks_.end());
+  }
+
   // Stream Debug Info
   const std::string streamDebugInfo_;
+
+  DecompressionReadAhead readAhead_;
+
+  std::deque<ReadAheadBlock> readAheadBlocks_;
 };
 
 } // namespace facebook::velox::dwrf
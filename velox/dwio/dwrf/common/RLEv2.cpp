@@ -16,12 +16,24 @@
 
 #include "velox/dwio/dwrf/common/RLEv2.h"
 #include "velox/dwio/common/SeekableInputStream.h"
+#include "velox/dwio/common/StreamUtil.h"
 #include "velox/dwio/dwrf/common/Common.h"
 
+#include <folly/lang/Bits.h>
+
 namespace facebook::velox::dwrf {
 
 using memory::MemoryPool;
 
+namespace {
+// The largest number of bytes of packed values after a run header: 512 values
+// of 64 bits and 31 patches of 64 bits.
+constexpr uint64_t kMaxPackedBytes = 512 * 8 + 31 * 8;
+
+// Padding after the copied packed values for word-at-a-time unpacking.
+constexpr uint64_t kPackedPadding = 8;
+} // namespace
+
 struct FixedBitSizes {
   enum FBS {
     ONE = 0,
@@ -127,23 +139,19 @@ RleDecoderV2<isSigned>::RleDecoderV2(
       firstByte(0),
       runLength(0),
       runRead(0),
+      repeating(false),
       deltaBase(0),
       byteSize(0),
       firstValue(0),
-      prevValue(0),
       bitSize(0),
-      bitsLeft(0),
-      curByte(0),
+      packedBytes(0),
       patchBitSize(0),
-      unpackedIdx(0),
-      patchIdx(0),
+      patchWidth(0),
+      numPatches(0),
       base(0),
-      curGap(0),
-      curPatch(0),
-      patchMask(0),
-      actualGap(0),
-      unpacked(pool, 0),
-      unpackedPatch(pool, 0) {
+      literals(pool, kMaxRunLength),
+      unpackedPatch(pool, 0),
+      packed(pool, 0) {
   // PASS
 }
 
@@ -158,10 +166,9 @@ template <bool isSigned>
 void RleDecoderV2<isSigned>::seekToRowGroup(
     dwio::common::PositionProvider& location) {
   // move the input stream
-  dwio::common::IntDecoder<isSigned>::inputStream->seekToPosition(location);
+  super::inputStream->seekToPosition(location);
   // clear state
-  dwio::common::IntDecoder<isSigned>::bufferEnd =
-      dwio::common::IntDecoder<isSigned>::bufferStart = 0;
+  super::bufferEnd = super::bufferStart = 0;
   runRead = runLength = 0;
   // skip ahead the given number of records
   skip(location.next());
@@ -174,59 +181,71 @@ template void RleDecoderV2<false>::seekToRowGroup(
 
 template <bool isSigned>
 void RleDecoderV2<isSigned>::skip(uint64_t numValues) {
-  // simple for now, until perf tests indicate something encoding specific is
-  // needed
-  const uint64_t N = 64;
-  int64_t dummy[N];
-
-  while (numValues) {
-    uint64_t nRead = std::min(N, numValues);
-    next(dummy, nRead, nullptr);
-    numValues -= nRead;
-  }
+  skipValues(numValues);
 }
 
 template void RleDecoderV2<true>::skip(uint64_t numValues);
 template void RleDecoderV2<false>::skip(uint64_t numValues);
 
+template <bool isSigned>
+void RleDecoderV2<isSigned>::skipValues(uint64_t numValues) {
+  while (numValues > 0) {
+    if (runRead == runLength) {
+      readHeader();
+      if (numValues >= runLength) {
+        // Whole runs are skipped without unpacking.
+        skipRun();
+        numValues -= runLength;
+        continue;
+      }
+      decodeRun();
+    }
+    const uint64_t numSkipped = std::min(runLength - runRead, numValues);
+    runRead += numSkipped;
+    numValues -= numSkipped;
+  }
+}
+
+template void RleDecoderV2<true>::skipValues(uint64_t numValues);
+template void RleDecoderV2<false>::skipValues(uint64_t numValues);
+
 template <bool isSigned>
 void RleDecoderV2<isSigned>::next(
     int64_t* const data,
     const uint64_t numValues,
     const uint64_t* const nulls) {
-  uint64_t nRead = 0;
-
-  while (nRead < numValues) {
+  uint64_t pos = 0;
+  while (pos < numValues) {
     // Skip any nulls before attempting to read first byte.
-    while (nulls && bits::isBitNull(nulls, nRead)) {
-      if (++nRead == numValues) {
+    while (nulls && bits::isBitNull(nulls, pos)) {
+      if (++pos == numValues) {
         return; // ended with null values
       }
     }
 
     if (runRead == runLength) {
-      resetRun();
-      firstByte = readByte();
+      readHeader();
+      decodeRun();
     }
 
-    uint64_t offset = nRead, length = numValues - nRead;
-
-    EncodingType enc = static_cast<EncodingType>((firstByte >> 6) & 0x03);
-    switch (static_cast<int64_t>(enc)) {
-      case SHORT_REPEAT:
-        nRead += nextShortRepeats(data, offset, length, nulls);
-        break;
-      case DIRECT:
-        nRead += nextDirect(data, offset, length, nulls);
-        break;
-      case PATCHED_BASE:
-        nRead += nextPatched(data, offset, length, nulls);
-        break;
-      case DELTA:
-        nRead += nextDelta(data, offset, length, nulls);
-        break;
-      default:
-        DWIO_RAISE("unknown encoding");
+    if (nulls) {
+      for (; pos < numValues && runRead < runLength; ++pos) {
+        if (!bits::isBitNull(nulls, pos)) {
+          data[pos] = valueAt(runRead++);
+        }
+      }
+    } else {
+      const uint64_t numRead = std::min(runLength - runRead, numValues - pos);
+      if (repeating) {
+        for (uint64_t i = 0; i < numRead; ++i) {
+          data[pos + i] = valueAt(runRead + i);
+        }
+      } else {
+        memcpy(
+            data + pos, literals.data() + runRead, numRead * sizeof(int64_t));
+      }
+      pos += numRead;
+      runRead += numRead;
     }
   }
 }
@@ -241,346 +260,323 @@ template void RleDecoderV2<false>::next(
     const uint64_t* const nulls);
 
 template <bool isSigned>
-uint64_t RleDecoderV2<isSigned>::nextShortRepeats(
-    int64_t* const data,
-    uint64_t offset,
-    uint64_t numValues,
-    const uint64_t* const nulls) {
-  if (runRead == runLength) {
-    // extract the number of fixed bytes
-    byteSize = (firstByte >> 3) & 0x07;
-    byteSize += 1;
+void RleDecoderV2<isSigned>::readHeader() {
+  firstByte = readByte();
+  runRead = 0;
+  repeating = false;
+  packedBytes = 0;
+  EncodingType enc = static_cast<EncodingType>((firstByte >> 6) & 0x03);
+  switch (static_cast<int64_t>(enc)) {
+    case SHORT_REPEAT: {
+      // extract the number of fixed bytes
+      byteSize = (firstByte >> 3) & 0x07;
+      byteSize += 1;
+
+      runLength = firstByte & 0x07;
+      // run lengths values are stored only after MIN_REPEAT value is met
+      runLength += RLE_MINIMUM_REPEAT;
+
+      // read the repeated value which is store using fixed bytes
+      firstValue = readLongBE(byteSize);
+
+      if (isSigned) {
+        firstValue = ZigZag::decode(static_cast<uint64_t>(firstValue));
+      }
+      repeating = true;
+      deltaBase = 0;
+      break;
+    }
+    case DIRECT: {
+      // extract the number of fixed bits
+      unsigned char fbo = (firstByte >> 1) & 0x1f;
+      bitSize = decodeBitWidth(fbo);
 
-    runLength = firstByte & 0x07;
-    // run lengths values are stored only after MIN_REPEAT value is met
-    runLength += RLE_MINIMUM_REPEAT;
-    runRead = 0;
+      // extract the run length
+      runLength = static_cast<uint64_t>(firstByte & 0x01) << 8;
+      runLength |= readByte();
+      // runs are one off
+      runLength += 1;
+      packedBytes = bits::nbytes(runLength * bitSize);
+      break;
+    }
+    case PATCHED_BASE: {
+      // extract the number of fixed bits
+      unsigned char fbo = (firstByte >> 1) & 0x1f;
+      bitSize = decodeBitWidth(fbo);
 
-    // read the repeated value which is store using fixed bytes
-    firstValue = readLongBE(byteSize);
+      // extract the run length
+      runLength = static_cast<uint64_t>(firstByte & 0x01) << 8;
+      runLength |= readByte();
+      // runs are one off
+      runLength += 1;
+
+      // extract the number of bytes occupied by base
+      uint64_t thirdByte = readByte();
+      byteSize = (thirdByte >> 5) & 0x07;
+      // base width is one off
+      byteSize += 1;
+
+      // extract patch width
+      uint32_t pwo = thirdByte & 0x1f;
+      patchBitSize = decodeBitWidth(pwo);
+
+      // read fourth byte and extract patch gap width
+      uint64_t fourthByte = readByte();
+      uint32_t pgw = (fourthByte >> 5) & 0x07;
+      // patch gap width is one off
+      pgw += 1;
+
+      // extract the length of the patch list
+      numPatches = fourthByte & 0x1f;
+      DWIO_ENSURE_NE(
+          numPatches,
+          0,
+          "Corrupt PATCHED_BASE encoded data (pl==0)! ",
+          super::inputStream->getName());
+
+      // read the next base width number of bytes to extract base value
+      base = readLongBE(byteSize);
+      int64_t mask = (static_cast<int64_t>(1) << ((byteSize * 8) - 1));
+      // if mask of base value is 1 then base is negative value else positive
+      if ((base & mask) != 0) {
+        base = base & ~mask;
+        base = -base;
+      }
 
-    if (isSigned) {
-      firstValue = ZigZag::decode(static_cast<uint64_t>(firstValue));
+      // TODO: Skip corrupt?
+      //    if ((patchBitSize + pgw) > 64 && !skipCorrupt) {
+      DWIO_ENSURE_LE(
+          (patchBitSize + pgw),
+          64,
+          "Corrupt PATCHED_BASE encoded data (patchBitSize + pgw > 64)! ",
+          super::inputStream->getName());
+      patchWidth = getClosestFixedBits(patchBitSize + pgw);
+      packedBytes = bits::nbytes(runLength * bitSize) +
+          bits::nbytes(numPatches * patchWidth);
+      break;
     }
-  }
+    case DELTA: {
+      // extract the number of fixed bits
+      unsigned char fbo = (firstByte >> 1) & 0x1f;
+      if (fbo != 0) {
+        bitSize = decodeBitWidth(fbo);
+      } else {
+        bitSize = 0;
+      }
 
-  uint64_t nRead = std::min(runLength - runRead, numValues);
+      // extract the run length
+      runLength = static_cast<uint64_t>(firstByte & 0x01) << 8;
+      runLength |= readByte();
+      ++runLength; // account for first value
 
-  if (nulls) {
-    for (uint64_t pos = offset; pos < offset + nRead; ++pos) {
-      if (!bits::isBitNull(nulls, pos)) {
-        data[pos] = firstValue;
-        ++runRead;
+      // read the first value stored as vint
+      if constexpr (isSigned) {
+        firstValue = super::readVsLong();
+      } else {
+        firstValue = static_cast<int64_t>(super::readVuLong());
       }
+
+      // read the fixed delta value stored as vint (deltas can be negative even
+      // if all number are positive)
+      deltaBase = super::readVsLong();
+      if (bitSize == 0) {
+        // fixed deltas
+        repeating = true;
+      } else if (runLength > 2) {
+        packedBytes = bits::nbytes((runLength - 2) * bitSize);
+      }
+      break;
     }
-  } else {
-    for (uint64_t pos = offset; pos < offset + nRead; ++pos) {
-      data[pos] = firstValue;
-      ++runRead;
-    }
+    default:
+      DWIO_RAISE("unknown encoding");
   }
-
-  return nRead;
 }
 
-template uint64_t RleDecoderV2<true>::nextShortRepeats(
-    int64_t* const data,
-    uint64_t offset,
-    uint64_t numValues,
-    const uint64_t* const nulls);
-template uint64_t RleDecoderV2<false>::nextShortRepeats(
-    int64_t* const data,
-    uint64_t offset,
-    uint64_t numValues,
-    const uint64_t* const nulls);
+template void RleDecoderV2<true>::readHeader();
+template void RleDecoderV2<false>::readHeader();
 
 template <bool isSigned>
-uint64_t RleDecoderV2<isSigned>::nextDirect(
-    int64_t* const data,
-    uint64_t offset,
-    uint64_t numValues,
-    const uint64_t* const nulls) {
-  if (runRead == runLength) {
-    // extract the number of fixed bits
-    unsigned char fbo = (firstByte >> 1) & 0x1f;
-    bitSize = decodeBitWidth(fbo);
-
-    // extract the run length
-    runLength = static_cast<uint64_t>(firstByte & 0x01) << 8;
-    runLength |= readByte();
-    // runs are one off
-    runLength += 1;
-    runRead = 0;
-  }
-
-  uint64_t nRead = std::min(runLength - runRead, numValues);
+void RleDecoderV2<isSigned>::skipRun() {
+  dwio::common::skipBytes(
+      packedBytes,
+      super::inputStream.get(),
+      super::bufferStart,
+      super::bufferEnd);
+  runRead = runLength;
+}
 
-  runRead += readLongs(data, offset, nRead, bitSize, nulls);
+template void RleDecoderV2<true>::skipRun();
+template void RleDecoderV2<false>::skipRun();
 
-  if (isSigned) {
-    if (nulls) {
-      for (uint64_t pos = offset; pos < offset + nRead; ++pos) {
-        if (!bits::isBitNull(nulls, pos)) {
-          data[pos] = ZigZag::decode(static_cast<uint64_t>(data[pos]));
+template <bool isSigned>
+void RleDecoderV2<isSigned>::decodeRun() {
+  if (repeating) {
+    return;
+  }
+  int64_t* values = literals.data();
+  uint64_t numAvailable;
+  const char* bytes = readPacked(packedBytes, numAvailable);
+  switch ((firstByte >> 6) & 0x03) {
+    case DIRECT:
+      unpack(bytes, numAvailable, runLength, bitSize, values);
+      if (isSigned) {
+        for (uint64_t i = 0; i < runLength; ++i) {
+          values[i] = ZigZag::decode(static_cast<uint64_t>(values[i]));
         }
       }
-    } else {
-      for (uint64_t pos = offset; pos < offset + nRead; ++pos) {
-        data[pos] = ZigZag::decode(static_cast<uint64_t>(data[pos]));
+      break;
+    case PATCHED_BASE: {
+      unpack(bytes, numAvailable, runLength, bitSize, values);
+      const uint64_t valueBytes = bits::nbytes(runLength * bitSize);
+      unpackedPatch.resize(numPatches);
+      unpack(
+          bytes + valueBytes,
+          numAvailable - valueBytes,
+          numPatches,
+          patchWidth,
+          unpackedPatch.data());
+
+      // Each patch entry has the distance from the previous patched value in
+      // its high bits and the high bits of the patched value in its low bits.
+      // A gap of more than 255 is split over entries with a gap of 255 and a
+      // patch of 0.
+      const int64_t patchMask = (static_cast<int64_t>(1) << patchBitSize) - 1;
+      uint64_t patchIdx = 0;
+      for (uint64_t i = 0; i < numPatches; ++i) {
+        const uint64_t gap =
+            static_cast<uint64_t>(unpackedPatch[i]) >> patchBitSize;
+        const int64_t patch = unpackedPatch[i] & patchMask;
+        patchIdx += gap;
+        if (gap == 255 && patch == 0) {
+          continue;
+        }
+        DWIO_ENSURE_LT(
+            patchIdx,
+            runLength,
+            "Corrupt PATCHED_BASE encoded data (patch past end of run)! ",
+            super::inputStream->getName());
+        values[patchIdx] |= patch << bitSize;
+      }
+      for (uint64_t i = 0; i < runLength; ++i) {
+        values[i] += base;
       }
+      break;
     }
+    case DELTA: {
+      values[0] = firstValue;
+      if (runLength == 1) {
+        break;
+      }
+      values[1] = firstValue + deltaBase;
+      if (runLength == 2) {
+        break;
+      }
+      unpack(bytes, numAvailable, runLength - 2, bitSize, values + 2);
+      // The deltas are magnitudes. The sign of 'deltaBase' tells whether the
+      // sequence is increasing or decreasing. This prefix sum is the only
+      // loop carried dependency of the decoding.
+      int64_t value = values[1];
+      if (deltaBase < 0) {
+        for (uint64_t i = 2; i < runLength; ++i) {
+          value -= values[i];
+          values[i] = value;
+        }
+      } else {
+        for (uint64_t i = 2; i < runLength; ++i) {
+          value += values[i];
+          values[i] = value;
+        }
+      }
+      break;
+    }
+    default:
+      DWIO_RAISE("unknown encoding");
   }
-
-  return nRead;
 }
 
-template uint64_t RleDecoderV2<true>::nextDirect(
-    int64_t* const data,
-    uint64_t offset,
-    uint64_t numValues,
-    const uint64_t* const nulls);
-template uint64_t RleDecoderV2<false>::nextDirect(
-    int64_t* const data,
-    uint64_t offset,
-    uint64_t numValues,
-    const uint64_t* const nulls);
+template void RleDecoderV2<true>::decodeRun();
+template void RleDecoderV2<false>::decodeRun();
 
 template <bool isSigned>
-uint64_t RleDecoderV2<isSigned>::nextPatched(
-    int64_t* const data,
-    uint64_t offset,
-    uint64_t numValues,
-    const uint64_t* const nulls) {
-  if (runRead == runLength) {
-    // extract the number of fixed bits
-    unsigned char fbo = (firstByte >> 1) & 0x1f;
-    bitSize = decodeBitWidth(fbo);
-
-    // extract the run length
-    runLength = static_cast<uint64_t>(firstByte & 0x01) << 8;
-    runLength |= readByte();
-    // runs are one off
-    runLength += 1;
-    runRead = 0;
-
-    // extract the number of bytes occupied by base
-    uint64_t thirdByte = readByte();
-    byteSize = (thirdByte >> 5) & 0x07;
-    // base width is one off
-    byteSize += 1;
-
-    // extract patch width
-    uint32_t pwo = thirdByte & 0x1f;
-    patchBitSize = decodeBitWidth(pwo);
-
-    // read fourth byte and extract patch gap width
-    uint64_t fourthByte = readByte();
-    uint32_t pgw = (fourthByte >> 5) & 0x07;
-    // patch gap width is one off
-    pgw += 1;
-
-    // extract the length of the patch list
-    size_t pl = fourthByte & 0x1f;
-    DWIO_ENSURE_NE(
-        pl,
-        0,
-        "Corrupt PATCHED_BASE encoded data (pl==0)! ",
-        dwio::common::IntDecoder<isSigned>::inputStream->getName());
-
-    // read the next base width number of bytes to extract base value
-    base = readLongBE(byteSize);
-    int64_t mask = (static_cast<int64_t>(1) << ((byteSize * 8) - 1));
-    // if mask of base value is 1 then base is negative value else positive
-    if ((base & mask) != 0) {
-      base = base & ~mask;
-      base = -base;
-    }
-
-    // TODO: something more efficient than resize
-    unpacked.resize(runLength);
-    unpackedIdx = 0;
-    readLongs(unpacked.data(), 0, runLength, bitSize);
-    // any remaining bits are thrown out
-    resetReadLongs();
-
-    // TODO: something more efficient than resize
-    unpackedPatch.resize(pl);
-    patchIdx = 0;
-    // TODO: Skip corrupt?
-    //    if ((patchBitSize + pgw) > 64 && !skipCorrupt) {
-    DWIO_ENSURE_LE(
-        (patchBitSize + pgw),
-        64,
-        "Corrupt PATCHED_BASE encoded data (patchBitSize + pgw > 64)! ",
-        dwio::common::IntDecoder<isSigned>::inputStream->getName());
-    uint32_t cfb = getClosestFixedBits(patchBitSize + pgw);
-    readLongs(unpackedPatch.data(), 0, pl, cfb);
-    // any remaining bits are thrown out
-    resetReadLongs();
-
-    // apply the patch directly when decoding the packed data
-    patchMask = ((static_cast<int64_t>(1) << patchBitSize) - 1);
-
-    adjustGapAndPatch();
+const char* RleDecoderV2<isSigned>::readPacked(
+    uint64_t numBytes,
+    uint64_t& numAvailable) {
+  if (super::bufferEnd - super::bufferStart >= numBytes) {
+    const char* result = super::bufferStart;
+    numAvailable = super::bufferEnd - super::bufferStart;
+    super::bufferStart += numBytes;
+    return result;
   }
-
-  uint64_t nRead = std::min(runLength - runRead, numValues);
-
-  for (uint64_t pos = offset; pos < offset + nRead; ++pos) {
-    // skip null positions
-    if (nulls && bits::isBitNull(nulls, pos)) {
-      continue;
-    }
-    if (static_cast<int64_t>(unpackedIdx) != actualGap) {
-      // no patching required. add base to unpacked value to get final value
-      data[pos] = base + unpacked[unpackedIdx];
-    } else {
-      // extract the patch value
-      int64_t patchedVal = unpacked[unpackedIdx] | (curPatch << bitSize);
-
-      // add base to patched value
-      data[pos] = base + patchedVal;
-
-      // increment the patch to point to next entry in patch list
-      ++patchIdx;
-
-      if (patchIdx < unpackedPatch.size()) {
-        adjustGapAndPatch();
-
-        // next gap is relative to the current gap
-        actualGap += unpackedIdx;
-      }
-    }
-
-    ++runRead;
-    ++unpackedIdx;
-  }
-
-  return nRead;
+  DWIO_ENSURE_LE(numBytes, kMaxPackedBytes);
+  packed.resize(kMaxPackedBytes + kPackedPadding);
+  dwio::common::readBytes(
+      numBytes,
+      super::inputStream.get(),
+      packed.data(),
+      super::bufferStart,
+      super::bufferEnd);
+  numAvailable = packed.size();
+  return packed.data();
 }
 
-template uint64_t RleDecoderV2<true>::nextPatched(
-    int64_t* const data,
-    uint64_t offset,
-    uint64_t numValues,
-    const uint64_t* const nulls);
-
-template uint64_t RleDecoderV2<false>::nextPatched(
-    int64_t* const data,
-    uint64_t offset,
-    uint64_t numValues,
-    const uint64_t* const nulls);
+template const char* RleDecoderV2<true>::readPacked(
+    uint64_t numBytes,
+    uint64_t& numAvailable);
+template const char* RleDecoderV2<false>::readPacked(
+    uint64_t numBytes,
+    uint64_t& numAvailable);
 
+// static
 template <bool isSigned>
-uint64_t RleDecoderV2<isSigned>::nextDelta(
-    int64_t* const data,
-    uint64_t offset,
+void RleDecoderV2<isSigned>::unpack(
+    const char* packed,
+    uint64_t numAvailable,
     uint64_t numValues,
-    const uint64_t* const nulls) {
-  if (runRead == runLength) {
-    // extract the number of fixed bits
-    unsigned char fbo = (firstByte >> 1) & 0x1f;
-    if (fbo != 0) {
-      bitSize = decodeBitWidth(fbo);
-    } else {
-      bitSize = 0;
-    }
-
-    // extract the run length
-    runLength = static_cast<uint64_t>(firstByte & 0x01) << 8;
-    runLength |= readByte();
-    ++runLength; // account for first value
-    runRead = deltaBase = 0;
-
-    // read the first value stored as vint
-    if constexpr (isSigned) {
-      firstValue = dwio::common::IntDecoder<isSigned>::readVsLong();
-    } else {
-      firstValue = static_cast<int64_t>(
-          dwio::common::IntDecoder<isSigned>::readVuLong());
-    }
-
-    prevValue = firstValue;
-
-    // read the fixed delta value stored as vint (deltas can be negative even
-    // if all number are positive)
-    deltaBase = dwio::common::IntDecoder<isSigned>::readVsLong();
-  }
-
-  uint64_t nRead = std::min(runLength - runRead, numValues);
-
-  uint64_t pos = offset;
-  for (; pos < offset + nRead; ++pos) {
-    // skip null positions
-    if (!nulls || !bits::isBitNull(nulls, pos)) {
-      break;
+    uint32_t bitWidth,
+    int64_t* result) {
+  const auto* bytes = reinterpret_cast<const uint8_t*>(packed);
+  if (bitWidth == 64) {
+    for (uint64_t i = 0; i < numValues; ++i) {
+      result[i] = folly::Endian::big(folly::loadUnaligned<int64_t>(bytes));
+      bytes += sizeof(int64_t);
     }
+    return;
   }
-  if (runRead == 0 && pos < offset + nRead) {
-    data[pos++] = firstValue;
-    ++runRead;
+  // The other widths are at most 56 bits, so that a value is always within
+  // the 8 bytes starting at its first byte. Load these as a big endian word
+  // and shift the value out while there are 8 bytes left to load.
+  DCHECK_LE(bitWidth, 56);
+  uint64_t i = 0;
+  uint64_t bitOffset = 0;
+  for (; i < numValues && (bitOffset >> 3) + sizeof(uint64_t) <= numAvailable;
+       ++i, bitOffset += bitWidth) {
+    const auto word = folly::Endian::big(
+        folly::loadUnaligned<uint64_t>(bytes + (bitOffset >> 3)));
+    result[i] =
+        static_cast<int64_t>((word << (bitOffset & 7)) >> (64 - bitWidth));
   }
-
-  if (bitSize == 0) {
-    // add fixed deltas to adjacent values
-    for (; pos < offset + nRead; ++pos) {
-      // skip null positions
-      if (nulls && bits::isBitNull(nulls, pos)) {
-        continue;
-      }
-      prevValue = data[pos] = prevValue + deltaBase;
-      ++runRead;
-    }
-  } else {
-    for (; pos < offset + nRead; ++pos) {
-      // skip null positions
-      if (!nulls || !bits::isBitNull(nulls, pos)) {
-        break;
-      }
-    }
-    if (runRead < 2 && pos < offset + nRead) {
-      // add delta base and first value
-      prevValue = data[pos++] = firstValue + deltaBase;
-      ++runRead;
-    }
-
-    // write the unpacked values, add it to previous value and store final
-    // value to result buffer. if the delta base value is negative then it
-    // is a decreasing sequence else an increasing sequence
-    uint64_t remaining = (offset + nRead) - pos;
-    runRead += readLongs(data, pos, remaining, bitSize, nulls);
-
-    if (deltaBase < 0) {
-      for (; pos < offset + nRead; ++pos) {
-        // skip null positions
-        if (nulls && bits::isBitNull(nulls, pos)) {
-          continue;
-        }
-        prevValue = data[pos] = prevValue - data[pos];
-      }
-    } else {
-      for (; pos < offset + nRead; ++pos) {
-        // skip null positions
-        if (nulls && bits::isBitNull(nulls, pos)) {
-          continue;
-        }
-        prevValue = data[pos] = prevValue + data[pos];
-      }
+  const uint64_t mask = (static_cast<uint64_t>(1) << bitWidth) - 1;
+  for (; i < numValues; ++i, bitOffset += bitWidth) {
+    const uint64_t lastBit = bitOffset + bitWidth - 1;
+    uint64_t word = 0;
+    for (auto byte = bitOffset >> 3; byte <= lastBit >> 3; ++byte) {
+      word = (word << 8) | bytes[byte];
     }
+    result[i] = static_cast<int64_t>((word >> (7 - (lastBit & 7))) & mask);
   }
-  return nRead;
 }
 
-template uint64_t RleDecoderV2<true>::nextDelta(
-    int64_t* const data,
-    uint64_t offset,
+template void RleDecoderV2<true>::unpack(
+    const char* packed,
+    uint64_t numAvailable,
     uint64_t numValues,
-    const uint64_t* const nulls);
-
-template uint64_t RleDecoderV2<false>::nextDelta(
-    int64_t* const data,
-    uint64_t offset,
+    uint32_t bitWidth,
+    int64_t* result);
+template void RleDecoderV2<false>::unpack(
+    const char* packed,
+    uint64_t numAvailable,
     uint64_t numValues,
-    const uint64_t* const nulls);
+    uint32_t bitWidth,
+    int64_t* result);
 
 } // namespace facebook::velox::dwrf
@@ -20,6 +20,7 @@
 #include "velox/common/memory/Memory.h"
 #include "velox/dwio/common/Adaptor.h"
 #include "velox/dwio/common/DataBuffer.h"
+#include "velox/dwio/common/DecoderUtil.h"
 #include "velox/dwio/common/IntDecoder.h"
 #include "velox/dwio/common/exception/Exception.h"
 
@@ -27,9 +28,15 @@
 
 namespace facebook::velox::dwrf {
 
+// Decodes ORC RLEv2. Each run is decoded as a whole into 'literals': the
+// bit-packed values of DIRECT, PATCHED_BASE and DELTA runs are unpacked a
+// machine word at a time. SHORT_REPEAT and fixed delta runs are kept as a
+// value and a delta and are not materialized.
 template <bool isSigned>
 class RleDecoderV2 : public dwio::common::IntDecoder<isSigned> {
  public:
+  using super = dwio::common::IntDecoder<isSigned>;
+
   enum EncodingType {
     SHORT_REPEAT = 0,
     DIRECT = 1,
@@ -37,6 +44,9 @@ class RleDecoderV2 : public dwio::common::IntDecoder<isSigned> {
     DELTA = 3
   };
 
+  // The maximum number of values in a run.
+  static constexpr int32_t kMaxRunLength = 512;
+
   RleDecoderV2(
       std::unique_ptr<dwio::common::SeekableInputStream> input,
       memory::MemoryPool& pool);
@@ -56,135 +66,300 @@ class RleDecoderV2 : public dwio::common::IntDecoder<isSigned> {
    */
   void next(int64_t* data, uint64_t numValues, const uint64_t* nulls) override;
 
+  template <bool hasNulls>
+  inline void skip(int32_t numValues, int32_t current, const uint64_t* nulls) {
+    if (hasNulls) {
+      numValues = bits::countNonNulls(nulls, current, current + numValues);
+    }
+    skipValues(numValues);
+  }
+
+  template <bool hasNulls, typename Visitor>
+  void readWithVisitor(const uint64_t* nulls, Visitor visitor) {
+    if (dwio::common::useFastPath<Visitor, hasNulls>(visitor)) {
+      fastPath<hasNulls>(nulls, visitor);
+      return;
+    }
+    int32_t current = visitor.start();
+    skip<hasNulls>(current, 0, nulls);
+    int32_t toSkip;
+    bool atEnd = false;
+    const bool allowNulls = hasNulls && visitor.allowNulls();
+    for (;;) {
+      if (hasNulls && allowNulls && bits::isBitNull(nulls, current)) {
+        toSkip = visitor.processNull(atEnd);
+      } else {
+        if (hasNulls && !allowNulls) {
+          toSkip = visitor.checkAndSkipNulls(nulls, current, atEnd);
+          if (!Visitor::dense) {
+            skip<false>(toSkip, current, nullptr);
+          }
+          if (atEnd) {
+            return;
+          }
+        }
+
+        // We are at a non-null value on a row to visit.
+        if (runRead == runLength) {
+          readHeader();
+          decodeRun();
+        }
+        toSkip = visitor.process(valueAt(runRead++), atEnd);
+      }
+      ++current;
+      if (toSkip) {
+        skip<hasNulls>(toSkip, current, nulls);
+        current += toSkip;
+      }
+      if (atEnd) {
+        return;
+      }
+    }
+  }
+
  private:
-  // Used by PATCHED_BASE
-  void adjustGapAndPatch() {
-    curGap = static_cast<uint64_t>(unpackedPatch[patchIdx]) >> patchBitSize;
-    curPatch = unpackedPatch[patchIdx] & patchMask;
-    actualGap = 0;
-
-    // special case: gap is >255 then patch value will be 0.
-    // if gap is <=255 then patch value cannot be 0
-    while (curGap == 255 && curPatch == 0) {
-      actualGap += 255;
-      ++patchIdx;
-      curGap = static_cast<uint64_t>(unpackedPatch[patchIdx]) >> patchBitSize;
-      curPatch = unpackedPatch[patchIdx] & patchMask;
+  template <bool hasNulls, typename Visitor>
+  void fastPath(const uint64_t* nulls, Visitor& visitor) {
+    constexpr bool hasFilter =
+        !std::is_same_v<typename Visitor::FilterType, common::AlwaysTrue>;
+    constexpr bool hasHook =
+        !std::is_same_v<typename Visitor::HookType, dwio::common::NoHook>;
+    auto rows = visitor.rows();
+    auto numRows = visitor.numRows();
+    auto rowsAsRange = folly::Range<const int32_t*>(rows, numRows);
+    if (hasNulls) {
+      raw_vector<int32_t>* innerVector = nullptr;
+      auto outerVector = &visitor.outerNonNullRows();
+      if (Visitor::dense) {
+        dwio::common::nonNullRowsFromDense(nulls, numRows, *outerVector);
+        if (outerVector->empty()) {
+          visitor.setAllNull(hasFilter ? 0 : numRows);
+          return;
+        }
+        bulkScan<hasFilter, hasHook, true>(
+            folly::Range<const int32_t*>(rows, outerVector->size()),
+            outerVector->data(),
+            visitor);
+      } else {
+        innerVector = &visitor.innerNonNullRows();
+        int32_t tailSkip = -1;
+        auto anyNulls = dwio::common::nonNullRowsFromSparse < hasFilter,
+             !hasFilter &&
+            !hasHook >
+                (nulls,
+                 rowsAsRange,
+                 *innerVector,
+                 *outerVector,
+                 (hasFilter || hasHook) ? nullptr : visitor.rawNulls(numRows),
+                 tailSkip);
+        if (anyNulls) {
+          visitor.setHasNulls();
+        }
+        if (innerVector->empty()) {
+          skip<false>(tailSkip, 0, nullptr);
+          visitor.setAllNull(hasFilter ? 0 : numRows);
+          return;
+        }
+        bulkScan<hasFilter, hasHook, true>(
+            *innerVector, outerVector->data(), visitor);
+        skip<false>(tailSkip, 0, nullptr);
+      }
+    } else {
+      bulkScan<hasFilter, hasHook, false>(rowsAsRange, nullptr, visitor);
+    }
+  }
+
+  // Returns 1. how many of 'rows' are in the current run 2. the
+  // distance in rows from the current row to the first row after the
+  // last in rows that falls in the current run.
+  template <bool dense>
+  std::pair<int32_t, std::int32_t> findNumInRun(
+      const int32_t* rows,
+      int32_t rowIndex,
+      int32_t numRows,
+      int32_t currentRow) const {
+    DCHECK_LT(rowIndex, numRows);
+    const int32_t remainingValues = runLength - runRead;
+    if (dense) {
+      auto left = std::min<int32_t>(remainingValues, numRows - rowIndex);
+      return std::make_pair(left, left);
+    }
+    if (rows[rowIndex] - currentRow >= remainingValues) {
+      return std::make_pair(0, 0);
+    }
+    if (rows[numRows - 1] - currentRow < remainingValues) {
+      return std::pair(numRows - rowIndex, rows[numRows - 1] - currentRow + 1);
+    }
+    auto range = folly::Range<const int32_t*>(
+        rows + rowIndex,
+        std::min<int32_t>(remainingValues, numRows - rowIndex));
+    auto endOfRun = currentRow + remainingValues;
+    auto bound = std::lower_bound(range.begin(), range.end(), endOfRun);
+    return std::make_pair(bound - range.begin(), bound[-1] - currentRow + 1);
+  }
+
+  template <bool hasFilter, bool hasHook, bool scatter, typename Visitor>
+  void bulkScan(
+      folly::Range<const int32_t*> nonNullRows,
+      const int32_t* scatterRows,
+      Visitor& visitor) {
+    auto numAllRows = visitor.numRows();
+    visitor.setRows(nonNullRows);
+    auto rows = visitor.rows();
+    auto numRows = visitor.numRows();
+    auto rowIndex = 0;
+    int32_t currentRow = 0;
+    auto values = visitor.rawValues(numRows);
+    auto filterHits = hasFilter ? visitor.outputRows(numRows) : nullptr;
+    int32_t numValues = 0;
+    for (;;) {
+      if (runRead == runLength) {
+        readHeader();
+        if (!Visitor::dense && rows[rowIndex] - currentRow >= runLength) {
+          // The next row of interest is after this run.
+          skipRun();
+          currentRow += runLength;
+          continue;
+        }
+        decodeRun();
+      }
+      auto [numInRun, numAdvanced] =
+          findNumInRun<Visitor::dense>(rows, rowIndex, numRows, currentRow);
+      if (!numInRun) {
+        // We are not at end and the next row of interest is after this run.
+        VELOX_CHECK(!numAdvanced, "Would advance past end of RLEv2 run");
+      } else if (repeating) {
+        visitor.template processRle<hasFilter, hasHook, scatter>(
+            valueAt(runRead),
+            deltaBase,
+            numInRun,
+            currentRow,
+            scatterRows,
+            filterHits,
+            values,
+            numValues);
+      } else {
+        copyLiterals<Visitor::dense>(
+            rows + rowIndex, numInRun, currentRow, values + numValues);
+        visitor.template processRun<hasFilter, hasHook, scatter>(
+            values + numValues,
+            numInRun,
+            scatterRows,
+            filterHits,
+            values,
+            numValues);
+      }
+      runRead += numAdvanced;
+      currentRow += numAdvanced;
+      rowIndex += numInRun;
+      if (visitor.atEnd()) {
+        visitor.setNumValues(hasFilter ? numValues : numAllRows);
+        return;
+      }
+      // The rest of the run has no rows of interest.
+      currentRow += runLength - runRead;
+      runRead = runLength;
     }
-    // add the left over gap
-    actualGap += curGap;
   }
 
-  void resetReadLongs() {
-    bitsLeft = 0;
-    curByte = 0;
+  // Copies the values of the current run at 'numRows' of 'rows' to 'result'.
+  // The first value of the run that is not consumed is at 'currentRow'.
+  template <bool dense, typename T>
+  void copyLiterals(
+      const int32_t* rows,
+      int32_t numRows,
+      int32_t currentRow,
+      T* result) const {
+    const auto* run = literals.data() + runRead;
+    if (dense) {
+      for (auto i = 0; i < numRows; ++i) {
+        result[i] = run[i];
+      }
+    } else {
+      for (auto i = 0; i < numRows; ++i) {
+        result[i] = run[rows[i] - currentRow];
+      }
+    }
   }
 
-  void resetRun() {
-    resetReadLongs();
-    bitSize = 0;
+  // Returns the value at 'index' in the current run.
+  int64_t valueAt(uint64_t index) const {
+    if (repeating) {
+      // Wraps around on overflow like the encoder.
+      return static_cast<int64_t>(
+          static_cast<uint64_t>(firstValue) +
+          static_cast<uint64_t>(deltaBase) * index);
+    }
+    return literals[index];
   }
 
   unsigned char readByte() {
-    if (dwio::common::IntDecoder<isSigned>::bufferStart ==
-        dwio::common::IntDecoder<isSigned>::bufferEnd) {
+    if (super::bufferStart == super::bufferEnd) {
       int32_t bufferLength;
       const void* bufferPointer;
       DWIO_ENSURE(
-          dwio::common::IntDecoder<isSigned>::inputStream->Next(
-              &bufferPointer, &bufferLength),
+          super::inputStream->Next(&bufferPointer, &bufferLength),
           "bad read in RleDecoderV2::readByte, ",
-          dwio::common::IntDecoder<isSigned>::inputStream->getName());
-      dwio::common::IntDecoder<isSigned>::bufferStart =
-          static_cast<const char*>(bufferPointer);
-      dwio::common::IntDecoder<isSigned>::bufferEnd =
-          dwio::common::IntDecoder<isSigned>::bufferStart + bufferLength;
+          super::inputStream->getName());
+      super::bufferStart = static_cast<const char*>(bufferPointer);
+      super::bufferEnd = super::bufferStart + bufferLength;
     }
 
-    unsigned char result = static_cast<unsigned char>(
-        *dwio::common::IntDecoder<isSigned>::bufferStart++);
+    unsigned char result = static_cast<unsigned char>(*super::bufferStart++);
     return result;
   }
 
   int64_t readLongBE(uint64_t bsz);
-  uint64_t readLongs(
-      int64_t* data,
-      uint64_t offset,
-      uint64_t len,
-      uint64_t fb,
-      const uint64_t* nulls = nullptr) {
-    uint64_t ret = 0;
-
-    // TODO: unroll to improve performance
-    for (uint64_t i = offset; i < (offset + len); i++) {
-      // skip null positions
-      if (nulls && bits::isBitNull(nulls, i)) {
-        continue;
-      }
-      uint64_t result = 0;
-      uint64_t bitsLeftToRead = fb;
-      while (bitsLeftToRead > bitsLeft) {
-        result <<= bitsLeft;
-        result |= curByte & ((1 << bitsLeft) - 1);
-        bitsLeftToRead -= bitsLeft;
-        curByte = readByte();
-        bitsLeft = 8;
-      }
 
-      // handle the left over bits
-      if (bitsLeftToRead > 0) {
-        result <<= bitsLeftToRead;
-        bitsLeft -= static_cast<uint32_t>(bitsLeftToRead);
-        result |= (curByte >> bitsLeft) & ((1 << bitsLeftToRead) - 1);
-      }
-      data[i] = static_cast<int64_t>(result);
-      ++ret;
-    }
+  // Reads the header of the next run. The bit-packed values of the run,
+  // 'packedBytes' bytes, follow in the stream.
+  void readHeader();
 
-    return ret;
-  }
+  // Decodes the values of the run whose header was just read.
+  void decodeRun();
 
-  uint64_t nextShortRepeats(
-      int64_t* data,
-      uint64_t offset,
-      uint64_t numValues,
-      const uint64_t* nulls);
-  uint64_t nextDirect(
-      int64_t* data,
-      uint64_t offset,
-      uint64_t numValues,
-      const uint64_t* nulls);
-  uint64_t nextPatched(
-      int64_t* data,
-      uint64_t offset,
-      uint64_t numValues,
-      const uint64_t* nulls);
-  uint64_t nextDelta(
-      int64_t* data,
-      uint64_t offset,
+  // Skips the values of the run whose header was just read without decoding
+  // them.
+  void skipRun();
+
+  void skipValues(uint64_t numValues);
+
+  // Returns a pointer to the next 'numBytes' of the stream. The bytes are
+  // copied to 'packed' if they span buffers. Sets 'numAvailable' to the number
+  // of bytes that can be read from the returned pointer, which is at least
+  // 'numBytes'.
+  const char* readPacked(uint64_t numBytes, uint64_t& numAvailable);
+
+  // Unpacks 'numValues' big endian values of 'bitWidth' bits from 'packed'.
+  // 'numAvailable' is the number of readable bytes at 'packed'.
+  static void unpack(
+      const char* packed,
+      uint64_t numAvailable,
       uint64_t numValues,
-      const uint64_t* nulls);
+      uint32_t bitWidth,
+      int64_t* result);
 
   unsigned char firstByte;
   uint64_t runLength;
   uint64_t runRead;
+  // True for SHORT_REPEAT and fixed delta runs: value i of the run is
+  // 'firstValue' + i * 'deltaBase'.
+  bool repeating;
   int64_t deltaBase; // Used by DELTA
   uint64_t byteSize; // Used by SHORT_REPEAT and PATCHED_BASE
   int64_t firstValue; // Used by SHORT_REPEAT and DELTA
-  int64_t prevValue; // Used by DELTA
   uint32_t bitSize; // Used by DIRECT, PATCHED_BASE and DELTA
-  uint32_t bitsLeft; // Used by anything that uses readLongs
-  uint32_t curByte; // Used by anything that uses readLongs
+  // The number of bytes of bit-packed values after the run header.
+  uint64_t packedBytes;
   uint32_t patchBitSize; // Used by PATCHED_BASE
-  uint64_t unpackedIdx; // Used by PATCHED_BASE
-  uint64_t patchIdx; // Used by PATCHED_BASE
+  uint32_t patchWidth; // Used by PATCHED_BASE
+  uint64_t numPatches; // Used by PATCHED_BASE
   int64_t base; // Used by PATCHED_BASE
-  uint64_t curGap; // Used by PATCHED_BASE
-  int64_t curPatch; // Used by PATCHED_BASE
-  int64_t patchMask; // Used by PATCHED_BASE
-  int64_t actualGap; // Used by PATCHED_BASE
-  dwio::common::DataBuffer<int64_t> unpacked; // Used by PATCHED_BASE
+  // The decoded values of the current run unless 'repeating'.
+  dwio::common::DataBuffer<int64_t> literals;
   dwio::common::DataBuffer<int64_t> unpackedPatch; // Used by PATCHED_BASE
+  // Holds the packed values of a run that span stream buffers.
+  dwio::common::DataBuffer<char> packed;
 };
 
 } // namespace facebook::velox::dwrf
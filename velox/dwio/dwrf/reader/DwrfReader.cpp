@@ -59,6 +59,15 @@ DwrfRowReader::DwrfRowReader(
   }
   firstStripe = currentStripe;
 
+  if (opts.getDecodingExecutor() &&
+      opts.getDecompressionReadAheadBlocks() > 0) {
+    setDecompressionReadAhead(
+        {opts.getDecodingExecutor().get(),
+         opts.getDecompressionReadAheadBlocks(),
+         std::make_shared<ReadAheadBudget>(
+             opts.getDecompressionReadAheadBytes())});
+  }
+
   if (currentStripe == 0) {
     previousRow = std::numeric_limits<uint64_t>::max();
   } else if (currentStripe == numberOfStripes) {
@@ -227,66 +236,109 @@ void DwrfRowReader::checkSkipStrides(
   }
 }
 
-uint64_t DwrfRowReader::next(uint64_t size, VectorPtr& result) {
-  DWIO_ENSURE_GT(size, 0);
-  auto& footer = getReader().getFooter();
-  StatsContext context(
-      getReader().getWriterName(), getReader().getWriterVersion());
-
-  for (;;) {
-    if (currentStripe >= lastStripe) {
-      if (lastStripe > 0) {
-        previousRow = firstRowOfStripe[lastStripe - 1] +
-            footer.stripes(lastStripe - 1).numberOfRows();
-      } else {
-        previousRow = 0;
-      }
-      return 0;
-    }
-
+int64_t DwrfRowReader::nextRowNumber() {
+  const auto strideSize = getReader().getFooter().rowIndexStride();
+  while (currentStripe < lastStripe) {
     if (currentRowInStripe == 0) {
       startNextStripe();
     }
-
-    auto strideSize = footer.rowIndexStride();
     if (LIKELY(strideSize > 0) && selectiveColumnReader_) {
+      StatsContext context(
+          getReader().getWriterName(), getReader().getWriterVersion());
       checkSkipStrides(context, strideSize);
     }
+    if (currentRowInStripe < rowsInCurrentStripe) {
+      return firstRowOfStripe[currentStripe] + currentRowInStripe;
+    }
+    // All the remaining strides of the stripe are skipped.
+    previousRow = firstRowOfStripe[currentStripe] + currentRowInStripe;
+    currentStripe += 1;
+    currentRowInStripe = 0;
+    newStripeLoaded = false;
+  }
+  return kAtEnd;
+}
 
-    uint64_t rowsToRead = std::min(
-        static_cast<uint64_t>(size), rowsInCurrentStripe - currentRowInStripe);
+int64_t DwrfRowReader::nextReadSize(uint64_t size) {
+  DWIO_ENSURE_GT(size, 0);
+  if (nextRowNumber() == kAtEnd) {
+    return kAtEnd;
+  }
+  uint64_t rowsToRead =
+      std::min(size, rowsInCurrentStripe - currentRowInStripe);
+  // don't allow read to cross stride
+  const auto strideSize = getReader().getFooter().rowIndexStride();
+  if (LIKELY(strideSize > 0)) {
+    rowsToRead =
+        std::min(rowsToRead, strideSize - currentRowInStripe % strideSize);
+  }
+  return rowsToRead;
+}
 
-    if (rowsToRead > 0) {
-      // don't allow read to cross stride
-      if (LIKELY(strideSize > 0)) {
-        rowsToRead =
-            std::min(rowsToRead, strideSize - currentRowInStripe % strideSize);
-      }
+uint64_t DwrfRowReader::next(
+    uint64_t size,
+    VectorPtr& result,
+    const dwio::common::Mutation* mutation) {
+  const auto rowsToRead = nextReadSize(size);
+  if (rowsToRead == kAtEnd) {
+    if (lastStripe > 0) {
+      previousRow = firstRowOfStripe[lastStripe - 1] +
+          getReader().getFooter().stripes(lastStripe - 1).numberOfRows();
+    } else {
+      previousRow = 0;
+    }
+    return 0;
+  }
 
-      // Record strideIndex for use by the columnReader_ which may delay actual
-      // reading of the data.
-      setStrideIndex(strideSize > 0 ? currentRowInStripe / strideSize : 0);
+  // Record strideIndex for use by the columnReader_ which may delay actual
+  // reading of the data.
+  const auto strideSize = getReader().getFooter().rowIndexStride();
+  setStrideIndex(strideSize > 0 ? currentRowInStripe / strideSize : 0);
 
-      if (selectiveColumnReader_) {
-        selectiveColumnReader_->next(rowsToRead, result);
-      } else {
-        columnReader_->next(rowsToRead, result);
-      }
-    }
+  if (selectiveColumnReader_) {
+    selectiveColumnReader_->next(rowsToRead, result, mutation);
+  } else {
+    DWIO_ENSURE(
+        !mutation || !mutation->deletedRows,
+        "Deleted rows need the selective reader");
+    columnReader_->next(rowsToRead, result);
+  }
 
-    // update row number
-    previousRow = firstRowOfStripe[currentStripe] + currentRowInStripe;
-    currentRowInStripe += rowsToRead;
-    if (currentRowInStripe >= rowsInCurrentStripe) {
-      currentStripe += 1;
-      currentRowInStripe = 0;
-      newStripeLoaded = false;
-    }
+  // update row number
+  previousRow = firstRowOfStripe[currentStripe] + currentRowInStripe;
+  currentRowInStripe += rowsToRead;
+  if (currentRowInStripe >= rowsInCurrentStripe) {
+    currentStripe += 1;
+    currentRowInStripe = 0;
+    newStripeLoaded = false;
+  }
+  return rowsToRead;
+}
 
-    if (rowsToRead > 0) {
-      return rowsToRead;
-    }
+std::optional<uint64_t> DwrfRowReader::splitRemaining() {
+  // A stripe that is loaded or partly read stays with 'this'.
+  const bool stripeStarted = newStripeLoaded || currentRowInStripe > 0;
+  const uint32_t firstUnread = currentStripe + (stripeStarted ? 1 : 0);
+  if (firstUnread >= lastStripe) {
+    return std::nullopt;
+  }
+  const uint32_t numUnread = lastStripe - firstUnread;
+  // Keep the larger half if 'this' has no stripe in progress.
+  const uint32_t numKept = stripeStarted ? numUnread / 2 : (numUnread + 1) / 2;
+  if (numKept == numUnread) {
+    return std::nullopt;
+  }
+  lastStripe = firstUnread + numKept;
+  return getReader().getFooter().stripes(lastStripe).offset();
+}
+
+bool DwrfRowReader::prepareNext(folly::SemiFuture<bool>* wait) {
+  if (currentStripe >= lastStripe) {
+    return true;
   }
+  // No-op if the current stripe is already started.
+  startNextStripe();
+  return getStripeInput().isLoaded(wait);
 }
 
 void DwrfRowReader::resetFilterCaches() {
@@ -351,6 +403,16 @@ size_t DwrfRowReader::estimatedReaderMemory() const {
   return 2 * DwrfReader::getMemoryUse(getReader(), -1, *columnSelector_);
 }
 
+void DwrfRowReader::updateRuntimeStats(
+    dwio::common::RuntimeStatistics& stats) const {
+  stats.skippedStrides += skippedStrides_;
+  if (auto structReader =
+          dynamic_cast<const dwio::common::SelectiveStructColumnReaderBase*>(
+              selectiveColumnReader_.get())) {
+    structReader->updateRuntimeStats(stats);
+  }
+}
+
 std::optional<size_t> DwrfRowReader::estimatedRowSizeHelper(
     const FooterWrapper& footer,
     const dwio::common::Statistics& stats,
@@ -491,6 +553,20 @@ std::unique_ptr<StripeInformation> DwrfReader::getStripe(
       stripeInfo.numberOfRows());
 }
 
+std::vector<dwio::common::FileStripe> DwrfReader::stripes() const {
+  auto& footer = readerBase_->getFooter();
+  std::vector<dwio::common::FileStripe> result;
+  result.reserve(footer.stripesSize());
+  for (auto i = 0; i < footer.stripesSize(); ++i) {
+    auto stripe = footer.stripes(i);
+    result.push_back(
+        {stripe.offset(),
+         stripe.indexLength() + stripe.dataLength() + stripe.footerLength(),
+         stripe.numberOfRows()});
+  }
+  return result;
+}
+
 std::vector<std::string> DwrfReader::getMetadataKeys() const {
   std::vector<std::string> result;
   auto& footer = readerBase_->getFooter();
@@ -82,12 +82,17 @@ class DwrfRowReader : public StrideIndexProvider,
   std::optional<size_t> estimatedRowSize() const override;
 
   // Returns number of rows read. Guaranteed to be less then or equal to size.
-  uint64_t next(uint64_t size, VectorPtr& result) override;
+  uint64_t next(
+      uint64_t size,
+      VectorPtr& result,
+      const dwio::common::Mutation* mutation = nullptr) override;
+
+  int64_t nextRowNumber() override;
+
+  int64_t nextReadSize(uint64_t size) override;
 
   void updateRuntimeStats(
-      dwio::common::RuntimeStatistics& stats) const override {
-    stats.skippedStrides += skippedStrides_;
-  }
+      dwio::common::RuntimeStatistics& stats) const override;
 
   void resetFilterCaches() override;
 
@@ -95,6 +100,10 @@ class DwrfRowReader : public StrideIndexProvider,
     return true;
   }
 
+  std::optional<uint64_t> splitRemaining() override;
+
+  bool prepareNext(folly::SemiFuture<bool>* wait) override;
+
   // Returns the skipped strides for 'stripe'. Used for testing.
   std::optional<std::vector<uint64_t>> stridesToSkip(uint32_t stripe) const {
     auto it = stripeStridesToSkip_.find(stripe);
@@ -210,6 +219,8 @@ class DwrfReader : public dwio::common::Reader {
 
   std::unique_ptr<StripeInformation> getStripe(uint32_t) const;
 
+  std::vector<dwio::common::FileStripe> stripes() const override;
+
   uint64_t getFileLength() const {
     return readerBase_->getFileLength();
   }
@@ -105,6 +105,49 @@ ReaderBase::ReaderBase(
   fileLength_ = input_->getReadFile()->size();
   DWIO_ENSURE(fileLength_ > 0, "ORC file is empty");
 
+  auto& metadataCache = dwio::common::FileMetadataCache::instance();
+  const auto cacheKey = metadataCache.enabled()
+      ? dwio::common::FileMetadataCache::key(*input_->getReadFile())
+      : std::nullopt;
+  std::shared_ptr<const FileTail> tail;
+  if (cacheKey.has_value()) {
+    tail = std::dynamic_pointer_cast<const FileTail>(
+        metadataCache.get(cacheKey.value()));
+  }
+  if (tail == nullptr) {
+    tail = readTail(fileFormat, cacheKey.has_value());
+    if (cacheKey.has_value()) {
+      metadataCache.put(cacheKey.value(), tail);
+    }
+  }
+  psLength_ = tail->psLength;
+  postScript_ = std::shared_ptr<const PostScript>(tail, tail->postScript.get());
+  footer_ = std::shared_ptr<const FooterWrapper>(tail, tail->footer.get());
+  cache_ = tail->stripeMetadataCache;
+  schema_ = tail->schema;
+
+  if (!cache_ && input_->shouldPrefetchStripes()) {
+    auto numStripes = getFooter().stripesSize();
+    for (auto i = 0; i < numStripes; i++) {
+      const auto stripe = getFooter().stripes(i);
+      input_->enqueue(
+          {stripe.offset() + stripe.indexLength() + stripe.dataLength(),
+           stripe.footerLength()});
+    }
+    if (numStripes) {
+      input_->load(LogType::FOOTER);
+    }
+  }
+  // initialize file decrypter
+  handler_ = DecryptionHandler::create(*footer_, decryptorFactory_.get());
+}
+
+std::shared_ptr<FileTail> ReaderBase::readTail(
+    FileFormat fileFormat,
+    bool shared) {
+  auto tail = std::make_shared<FileTail>();
+  tail->arena = std::make_unique<google::protobuf::Arena>();
+
   auto preloadFile = fileLength_ <= filePreloadThreshold_;
   uint64_t readSize =
       preloadFile ? fileLength_ : std::min(fileLength_, directorySizeGuess_);
@@ -120,27 +163,30 @@ ReaderBase::ReaderBase(
     auto lastByteStream = input_->read(fileLength_ - 1, 1, LogType::FOOTER);
     DWIO_ENSURE(lastByteStream->Next(&buf, &ignored), "failed to read");
     // Make sure 'lastByteStream' is live while dereferencing 'buf'.
-    psLength_ = *static_cast<const char*>(buf) & 0xff;
+    tail->psLength = *static_cast<const char*>(buf) & 0xff;
   }
+  const auto psLength = tail->psLength;
   DWIO_ENSURE_LE(
-      psLength_ + 4, // 1 byte for post script len, 3 byte "ORC" header.
+      psLength + 4, // 1 byte for post script len, 3 byte "ORC" header.
       fileLength_,
       "Corrupted file, Post script size is invalid");
 
   if (fileFormat == FileFormat::DWRF) {
     auto postScript = ProtoUtils::readProto<proto::PostScript>(
-        input_->read(fileLength_ - psLength_ - 1, psLength_, LogType::FOOTER));
-    postScript_ = std::make_unique<PostScript>(std::move(postScript));
+        input_->read(fileLength_ - psLength - 1, psLength, LogType::FOOTER));
+    tail->postScript = std::make_unique<PostScript>(std::move(postScript));
   } else {
     auto postScript = ProtoUtils::readProto<proto::orc::PostScript>(
-        input_->read(fileLength_ - psLength_ - 1, psLength_, LogType::FOOTER));
-    postScript_ = std::make_unique<PostScript>(std::move(postScript));
+        input_->read(fileLength_ - psLength - 1, psLength, LogType::FOOTER));
+    tail->postScript = std::make_unique<PostScript>(std::move(postScript));
   }
 
-  uint64_t footerSize = postScript_->footerLength();
-  uint64_t cacheSize =
-      postScript_->hasCacheSize() ? postScript_->cacheSize() : 0;
-  uint64_t tailSize = 1 + psLength_ + footerSize + cacheSize;
+  // The decompression of the footer below is set up from 'postScript_'.
+  postScript_ = std::shared_ptr<const PostScript>(tail, tail->postScript.get());
+  const auto& postScript = *tail->postScript;
+  uint64_t footerSize = postScript.footerLength();
+  uint64_t cacheSize = postScript.hasCacheSize() ? postScript.cacheSize() : 0;
+  uint64_t tailSize = 1 + psLength + footerSize + cacheSize;
 
   // There are cases in warehouse, where RC/text files are stored
   // in ORC partition. This causes the Reader to SIGSEGV. The following
@@ -152,11 +198,11 @@ ReaderBase::ReaderBase(
   DWIO_ENSURE_LE(tailSize, fileLength_, "Corrupted file, tail size is invalid");
 
   DWIO_ENSURE(
-      (format() == DwrfFormat::kDwrf)
-          ? proto::CompressionKind_IsValid(postScript_->compression())
-          : proto::orc::CompressionKind_IsValid(postScript_->compression()),
+      (postScript.format() == DwrfFormat::kDwrf)
+          ? proto::CompressionKind_IsValid(postScript.compression())
+          : proto::orc::CompressionKind_IsValid(postScript.compression()),
       "Corrupted File, invalid compression kind ",
-      postScript_->compression());
+      postScript.compression());
 
   if (tailSize > readSize) {
     input_->enqueue({fileLength_ - tailSize, tailSize});
@@ -164,58 +210,50 @@ ReaderBase::ReaderBase(
   }
 
   auto footerStream = input_->read(
-      fileLength_ - psLength_ - footerSize - 1, footerSize, LogType::FOOTER);
+      fileLength_ - psLength - footerSize - 1, footerSize, LogType::FOOTER);
   if (fileFormat == FileFormat::DWRF) {
-    auto footer =
-        google::protobuf::Arena::CreateMessage<proto::Footer>(arena_.get());
+    auto footer = google::protobuf::Arena::CreateMessage<proto::Footer>(
+        tail->arena.get());
     ProtoUtils::readProtoInto<proto::Footer>(
         createDecompressedStream(std::move(footerStream), "File Footer"),
         footer);
-    footer_ = std::make_unique<FooterWrapper>(footer);
+    tail->footer = std::make_unique<FooterWrapper>(footer);
   } else {
     auto footer = google::protobuf::Arena::CreateMessage<proto::orc::Footer>(
-        arena_.get());
+        tail->arena.get());
     ProtoUtils::readProtoInto<proto::orc::Footer>(
         createDecompressedStream(std::move(footerStream), "File Footer"),
         footer);
-    footer_ = std::make_unique<FooterWrapper>(footer);
+    tail->footer = std::make_unique<FooterWrapper>(footer);
   }
 
-  schema_ = std::dynamic_pointer_cast<const RowType>(convertType(*footer_));
-  DWIO_ENSURE_NOT_NULL(schema_, "invalid schema");
+  tail->schema =
+      std::dynamic_pointer_cast<const RowType>(convertType(*tail->footer));
+  DWIO_ENSURE_NOT_NULL(tail->schema, "invalid schema");
 
   // load stripe index/footer cache
   if (cacheSize > 0) {
-    DWIO_ENSURE_EQ(format(), DwrfFormat::kDwrf);
-    if (input_->shouldPrefetchStripes()) {
-      cache_ = std::make_unique<StripeMetadataCache>(
-          postScript_->cacheMode(),
-          *footer_,
+    DWIO_ENSURE_EQ(postScript.format(), DwrfFormat::kDwrf);
+    // A shared cache reads the stripe metadata into memory of its own
+    // instead of referring to the input of this reader.
+    if (input_->shouldPrefetchStripes() && !shared) {
+      tail->stripeMetadataCache = std::make_shared<StripeMetadataCache>(
+          postScript.cacheMode(),
+          *tail->footer,
           input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER));
       input_->load(LogType::FOOTER);
     } else {
-      auto cacheBuffer =
-          std::make_shared<dwio::common::DataBuffer<char>>(pool, cacheSize);
+      auto cacheBuffer = std::make_shared<dwio::common::DataBuffer<char>>(
+          shared ? dwio::common::FileMetadataCache::instance().pool() : pool_,
+          cacheSize);
       input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER)
           ->readFully(cacheBuffer->data(), cacheSize);
-      cache_ = std::make_unique<StripeMetadataCache>(
-          postScript_->cacheMode(), *footer_, std::move(cacheBuffer));
+      tail->stripeMetadataCache = std::make_shared<StripeMetadataCache>(
+          postScript.cacheMode(), *tail->footer, std::move(cacheBuffer));
+      tail->stripeMetadataCacheSize = cacheSize;
     }
   }
-  if (!cache_ && input_->shouldPrefetchStripes()) {
-    auto numStripes = getFooter().stripesSize();
-    for (auto i = 0; i < numStripes; i++) {
-      const auto stripe = getFooter().stripes(i);
-      input_->enqueue(
-          {stripe.offset() + stripe.indexLength() + stripe.dataLength(),
-           stripe.footerLength()});
-    }
-    if (numStripes) {
-      input_->load(LogType::FOOTER);
-    }
-  }
-  // initialize file decrypter
-  handler_ = DecryptionHandler::create(*footer_, decryptorFactory_.get());
+  return tail;
 }
 
 std::vector<uint64_t> ReaderBase::getRowsPerStripe() const {
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "velox/dwio/common/BufferedInput.h"
+#include "velox/dwio/common/FileMetadataCache.h"
 #include "velox/dwio/common/Options.h"
 #include "velox/dwio/common/SeekableInputStream.h"
 #include "velox/dwio/common/TypeWithId.h"
@@ -30,6 +31,22 @@ namespace facebook::velox::dwrf {
 
 class ReaderBase;
 
+/// The parsed post script and footer of a file and its stripe metadata cache.
+/// Shared by the readers of the file through dwio::common::FileMetadataCache.
+struct FileTail : public dwio::common::FileMetadata {
+  std::unique_ptr<google::protobuf::Arena> arena;
+  std::unique_ptr<PostScript> postScript;
+  std::unique_ptr<FooterWrapper> footer;
+  std::shared_ptr<StripeMetadataCache> stripeMetadataCache;
+  RowTypePtr schema;
+  uint64_t psLength{0};
+  uint64_t stripeMetadataCacheSize{0};
+
+  uint64_t memoryUsage() const override {
+    return sizeof(FileTail) + arena->SpaceUsed() + stripeMetadataCacheSize;
+  }
+};
+
 class FooterStatisticsImpl : public dwio::common::Statistics {
  private:
   std::vector<std::unique_ptr<dwio::common::ColumnStatistics>> colStats_;
@@ -133,7 +150,7 @@ class ReaderBase {
     return *input_;
   }
 
-  const std::unique_ptr<StripeMetadataCache>& getMetadataCache() const {
+  const std::shared_ptr<StripeMetadataCache>& getMetadataCache() const {
     return cache_;
   }
 
@@ -197,14 +214,16 @@ class ReaderBase {
   std::unique_ptr<dwio::common::SeekableInputStream> createDecompressedStream(
       std::unique_ptr<dwio::common::SeekableInputStream> compressed,
       const std::string& streamDebugInfo,
-      const dwio::common::encryption::Decrypter* decrypter = nullptr) const {
+      const dwio::common::encryption::Decrypter* decrypter = nullptr,
+      const DecompressionReadAhead& readAhead = {}) const {
     return createDecompressor(
         getCompressionKind(),
         std::move(compressed),
         getCompressionBlockSize(),
         pool_,
         streamDebugInfo,
-        decrypter);
+        decrypter,
+        readAhead);
   }
 
   template <typename T>
@@ -230,11 +249,19 @@ class ReaderBase {
       const FooterWrapper& footer,
       uint32_t index = 0);
 
+  // Reads and parses the tail of the file. If 'shared', the tail goes to the
+  // FileMetadataCache and must not refer to the memory or input of this
+  // reader.
+  std::shared_ptr<FileTail> readTail(
+      dwio::common::FileFormat fileFormat,
+      bool shared);
+
   memory::MemoryPool& pool_;
   std::unique_ptr<google::protobuf::Arena> arena_;
-  std::unique_ptr<PostScript> postScript_;
-  std::unique_ptr<FooterWrapper> footer_ = nullptr;
-  std::unique_ptr<StripeMetadataCache> cache_;
+  // Point into a FileTail when read through the FileMetadataCache.
+  std::shared_ptr<const PostScript> postScript_;
+  std::shared_ptr<const FooterWrapper> footer_ = nullptr;
+  std::shared_ptr<StripeMetadataCache> cache_;
   // Keeps factory alive for possibly async prefetch.
   std::shared_ptr<dwio::common::encryption::DecrypterFactory> decryptorFactory_;
   std::unique_ptr<encryption::DecryptionHandler> handler_;
@@ -42,12 +42,20 @@ class SelectiveIntegerDirectColumnReader
     auto data = encodingKey.forKind(proto::Stream_Kind_DATA);
     auto& stripe = params.stripeStreams();
     bool dataVInts = stripe.getUseVInts(data);
-    auto decoder = createDirectDecoder</*isSigned*/ true>(
-        stripe.getStream(data, true), dataVInts, numBytes);
-    auto rawDecoder = decoder.release();
-    auto directDecoder =
-        dynamic_cast<dwio::common::DirectDecoder<true>*>(rawDecoder);
-    ints.reset(directDecoder);
+    format_ = stripe.format();
+    if (format_ == DwrfFormat::kDwrf) {
+      ints = createDirectDecoder</*isSigned*/ true>(
+          stripe.getStream(data, true), dataVInts, numBytes);
+    } else {
+      auto encoding = stripe.getEncoding(encodingKey);
+      rleVersion_ = convertRleVersion(encoding.kind());
+      ints = createRleDecoder</*isSigned*/ true>(
+          stripe.getStream(data, true),
+          rleVersion_,
+          memoryPool_,
+          dataVInts,
+          numBytes);
+    }
   }
 
   bool hasBulkPath() const override {
@@ -71,7 +79,22 @@ class SelectiveIntegerDirectColumnReader
   void readWithVisitor(RowSet rows, ColumnVisitor visitor);
 
  private:
-  std::unique_ptr<dwio::common::DirectDecoder</*isSigned*/ true>> ints;
+  template <typename Decoder, typename ColumnVisitor>
+  void decodeWithVisitor(ColumnVisitor visitor) {
+    auto decoder = static_cast<Decoder*>(ints.get());
+    if (nullsInReadRange_) {
+      decoder->template readWithVisitor<true>(
+          nullsInReadRange_->as<uint64_t>(), visitor);
+    } else {
+      decoder->template readWithVisitor<false>(nullptr, visitor);
+    }
+  }
+
+  // DWRF writes integers as varints or fixed width values. ORC writes them
+  // with RLE, see IntegerDirectColumnReader.
+  DwrfFormat format_;
+  RleVersion rleVersion_{RleVersion_1};
+  std::unique_ptr<dwio::common::IntDecoder</*isSigned*/ true>> ints;
 };
 
 template <typename ColumnVisitor>
@@ -79,10 +102,18 @@ void SelectiveIntegerDirectColumnReader::readWithVisitor(
     RowSet rows,
     ColumnVisitor visitor) {
   vector_size_t numRows = rows.back() + 1;
-  if (nullsInReadRange_) {
-    ints->readWithVisitor<true>(nullsInReadRange_->as<uint64_t>(), visitor);
+  if (format_ == DwrfFormat::kDwrf) {
+    decodeWithVisitor<dwio::common::DirectDecoder<true>>(visitor);
+  } else if constexpr (std::is_same_v<
+                           typename ColumnVisitor::DataType,
+                           int128_t>) {
+    VELOX_FAIL("RLE encoded integers can't be read as 128 bit integers");
+  } else if (rleVersion_ == RleVersion_1) {
+    decodeWithVisitor<RleDecoderV1<true>>(
+        visitor.toDirectRleColumnVisitor());
   } else {
-    ints->readWithVisitor<false>(nullptr, visitor);
+    decodeWithVisitor<RleDecoderV2<true>>(
+        visitor.toDirectRleColumnVisitor());
   }
   readOffset_ += numRows;
 }
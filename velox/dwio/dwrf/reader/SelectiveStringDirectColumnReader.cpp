@@ -39,6 +39,30 @@ SelectiveStringDirectColumnReader::SelectiveStringDirectColumnReader(
       dwio::common::INT_BYTE_SIZE);
   blobStream_ =
       stripe.getStream(encodingKey.forKind(proto::Stream_Kind_DATA), true);
+  mayUseStreamBuffer_ = true;
+}
+
+bool SelectiveStringDirectColumnReader::pinCurrentBuffer() {
+  if (!mayUseStreamBuffer_ || !scanSpec_->keepValues() ||
+      bufferStart_ >= bufferEnd_) {
+    return false;
+  }
+  if (isPinnedString(folly::StringPiece(bufferStart_, bufferEnd_))) {
+    return true;
+  }
+  if (bufferEnd_ == unsharedBufferEnd_) {
+    return false;
+  }
+  // A non-empty [bufferStart_, bufferEnd_) is from the last Next() of
+  // 'blobStream_'.
+  auto buffer = blobStream_->sharedBuffer();
+  if (!buffer || bufferStart_ < buffer->as<char>() ||
+      bufferEnd_ > buffer->as<char>() + buffer->size()) {
+    unsharedBufferEnd_ = bufferEnd_;
+    return false;
+  }
+  pinStringBuffer(std::move(buffer));
+  return true;
 }
 
 uint64_t SelectiveStringDirectColumnReader::skip(uint64_t numValues) {
@@ -71,7 +95,7 @@ void SelectiveStringDirectColumnReader::extractCrossBuffers(
       addValue(value);
     } else {
       auto index = outerNonNullRows_[rowIndex + i];
-      if (size <= StringView::kInlineSize) {
+      if (size <= StringView::kInlineSize || isPinnedString(value)) {
         reinterpret_cast<StringView*>(rawValues_)[index] =
             StringView(value.data(), size);
       } else {
@@ -145,6 +169,7 @@ inline bool SelectiveStringDirectColumnReader::try8Consecutive(
   if (!data || bufferEnd_ - data < start + 8 * 12) {
     return false;
   }
+  const bool pinned = pinCurrentBuffer();
   int32_t* result = reinterpret_cast<int32_t*>(rawValues_);
   int32_t resultIndex = numValues_ * 4 - 4;
   auto rawUsed = rawStringUsed_;
@@ -177,6 +202,12 @@ inline bool SelectiveStringDirectColumnReader::try8Consecutive(
           reinterpret_cast<char*>(result + resultIndex + 1) + length) = 0;
       continue;
     }
+    if (pinned) {
+      // Refer to the string in place.
+      *reinterpret_cast<const char**>(result + resultIndex + 2) = data;
+      data += length;
+      continue;
+    }
     if (!rawStringBuffer_ || rawUsed + length > rawStringSize_) {
       // Slow path if no space in raw strings
       return false;
@@ -256,6 +287,11 @@ folly::StringPiece SelectiveStringDirectColumnReader::readValue(
   // we're reading.
   if (bufferEnd_ - bufferStart_ >= length) {
     bytesToSkip_ = length;
+    if (length > StringView::kInlineSize) {
+      // Lets addValue() refer to the string in place if the stream shares
+      // its buffer.
+      pinCurrentBuffer();
+    }
     return folly::StringPiece(bufferStart_, length);
   }
   tempString_.resize(length);
@@ -409,6 +445,10 @@ void SelectiveStringDirectColumnReader::processFilter(
       readHelper<common::NegatedBytesValues, isDense>(
           filter, rows, extractValues);
       break;
+    case common::FilterKind::kHashBloomFilter:
+      readHelper<common::HashBloomFilter, isDense>(
+          filter, rows, extractValues);
+      break;
     default:
       readHelper<common::Filter, isDense>(filter, rows, extractValues);
       break;
@@ -51,6 +51,7 @@ class SelectiveStringDirectColumnReader
     rawStringBuffer_ = nullptr;
     rawStringSize_ = 0;
     rawStringUsed_ = 0;
+    clearPinnedStringBuffer();
     getFlatValues<StringView, StringView>(rows, result, type_);
   }
 
@@ -60,6 +61,12 @@ class SelectiveStringDirectColumnReader
 
   folly::StringPiece readValue(int32_t length);
 
+  // Returns true if the strings in [bufferStart_, bufferEnd_) can be
+  // referenced by the result instead of copied. This is the case if
+  // 'blobStream_' shares its buffers, e.g. an uncompressed stream over cache
+  // entries.
+  bool pinCurrentBuffer();
+
   template <bool hasNulls, typename Visitor>
   void decode(const uint64_t* nulls, Visitor visitor);
 
@@ -98,6 +105,9 @@ class SelectiveStringDirectColumnReader
   std::unique_ptr<dwio::common::SeekableInputStream> blobStream_;
   const char* bufferStart_ = nullptr;
   const char* bufferEnd_ = nullptr;
+  // End of the last buffer 'blobStream_' did not share. Avoids asking again
+  // for every string in the buffer.
+  const char* unsharedBufferEnd_ = nullptr;
   BufferPtr lengths_;
   int32_t lengthIndex_ = 0;
   const uint32_t* rawLengths_ = nullptr;
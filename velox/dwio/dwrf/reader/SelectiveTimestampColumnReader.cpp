@@ -59,30 +59,45 @@ void SelectiveTimestampColumnReader::seekToRowGroup(uint32_t index) {
   VELOX_CHECK(!positionsProvider.hasNext());
 }
 
+namespace {
+// Reads the values of 'decoder', which is RLEv1 or RLEv2.
+template <bool isSigned, typename Visitor>
+void readRle(
+    dwio::common::IntDecoder<isSigned>* decoder,
+    const uint64_t* nulls,
+    Visitor visitor) {
+  auto readWithVisitor = [&](auto* rleDecoder) {
+    if (nulls) {
+      rleDecoder->template readWithVisitor<true>(nulls, visitor);
+    } else {
+      rleDecoder->template readWithVisitor<false>(nullptr, visitor);
+    }
+  };
+  if (auto v1 = dynamic_cast<RleDecoderV1<isSigned>*>(decoder)) {
+    readWithVisitor(v1);
+  } else {
+    auto v2 = dynamic_cast<RleDecoderV2<isSigned>*>(decoder);
+    VELOX_CHECK_NOT_NULL(v2, "Only RLE encoded timestamps are supported");
+    readWithVisitor(v2);
+  }
+}
+} // namespace
+
 template <bool dense>
 void SelectiveTimestampColumnReader::readHelper(RowSet rows) {
   vector_size_t numRows = rows.back() + 1;
   ExtractToReader extractValues(this);
   common::AlwaysTrue filter;
-  auto secondsV1 = dynamic_cast<RleDecoderV1<true>*>(seconds_.get());
-  VELOX_CHECK(secondsV1, "Only RLEv1 is supported");
-  if (nullsInReadRange_) {
-    secondsV1->readWithVisitor<true>(
-        nullsInReadRange_->as<uint64_t>(),
-        DirectRleColumnVisitor<
-            int64_t,
-            common::AlwaysTrue,
-            decltype(extractValues),
-            dense>(filter, this, rows, extractValues));
-  } else {
-    secondsV1->readWithVisitor<false>(
-        nullptr,
-        DirectRleColumnVisitor<
-            int64_t,
-            common::AlwaysTrue,
-            decltype(extractValues),
-            dense>(filter, this, rows, extractValues));
-  }
+  const auto* nulls =
+      nullsInReadRange_ ? nullsInReadRange_->as<uint64_t>() : nullptr;
+  readRle(
+      seconds_.get(),
+      nulls,
+      DirectRleColumnVisitor<
+          int64_t,
+          common::AlwaysTrue,
+          decltype(extractValues),
+          dense>(filter, this, rows, extractValues));
 
   // Save the seconds into their own buffer before reading nanos into
   // 'values_'
@@ -96,25 +111,14 @@ void SelectiveTimestampColumnReader::readHelper(RowSet rows) {
 
   // We read the nanos into 'values_' starting at index 0.
   numValues_ = 0;
-  auto nanosV1 = dynamic_cast<RleDecoderV1<false>*>(nano_.get());
-  VELOX_CHECK(nanosV1, "Only RLEv1 is supported");
-  if (nullsInReadRange_) {
-    nanosV1->readWithVisitor<true>(
-        nullsInReadRange_->as<uint64_t>(),
-        DirectRleColumnVisitor<
-            int64_t,
-            common::AlwaysTrue,
-            decltype(extractValues),
-            dense>(filter, this, rows, extractValues));
-  } else {
-    nanosV1->readWithVisitor<false>(
-        nullptr,
-        DirectRleColumnVisitor<
-            int64_t,
-            common::AlwaysTrue,
-            decltype(extractValues),
-            dense>(filter, this, rows, extractValues));
-  }
+  readRle(
+      nano_.get(),
+      nulls,
+      DirectRleColumnVisitor<
+          int64_t,
+          common::AlwaysTrue,
+          decltype(extractValues),
+          dense>(filter, this, rows, extractValues));
   readOffset_ += numRows;
 }
 
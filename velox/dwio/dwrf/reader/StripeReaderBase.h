@@ -68,6 +68,17 @@ class StripeReaderBase {
     return *handler_;
   }
 
+  // Returns the settings for decompressing the blocks of the data streams
+  // ahead of the column readers.
+  const DecompressionReadAhead& decompressionReadAhead() const {
+    return readAhead_;
+  }
+
+ protected:
+  void setDecompressionReadAhead(DecompressionReadAhead readAhead) {
+    readAhead_ = std::move(readAhead);
+  }
+
  private:
   std::shared_ptr<ReaderBase> reader_;
   std::unique_ptr<dwio::common::BufferedInput> stripeInput_;
@@ -75,6 +86,7 @@ class StripeReaderBase {
   std::unique_ptr<encryption::DecryptionHandler> handler_;
   std::optional<uint32_t> lastStripeIndex_;
   bool canLoad_{true};
+  DecompressionReadAhead readAhead_;
 
   void loadEncryptionKeys(uint32_t index);
 
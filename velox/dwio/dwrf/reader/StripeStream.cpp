@@ -287,7 +287,9 @@ std::unique_ptr<dwio::common::SeekableInputStream> StripeStreamsImpl::getStream(
   return reader_.getReader().createDecompressedStream(
       std::move(streamRead),
       streamDebugInfo,
-      getDecrypter(si.encodingKey().node));
+      getDecrypter(si.encodingKey().node),
+      isIndexStream(si.kind()) ? DecompressionReadAhead{}
+                               : reader_.decompressionReadAhead());
 }
 
 uint32_t StripeStreamsImpl::visitStreamsOfNode(
@@ -378,6 +378,12 @@ class CacheTest : public testing::Test {
       auto currentStripe = std::move(stripes.front());
       stripes.erase(stripes.begin());
       currentStripe->input->load(LogType::TEST);
+      // Waits for the background loads of the stripe, like a reader that
+      // doesn't block its thread in the streams.
+      auto wait = folly::SemiFuture<bool>::makeEmpty();
+      if (!currentStripe->input->isLoaded(&wait)) {
+        std::move(wait).wait();
+      }
       for (auto columnIndex = 0; columnIndex < numColumns; ++columnIndex) {
         if (shouldRead(*currentStripe, columnIndex, readPct, readPctModulo)) {
           readStream(*currentStripe, columnIndex);
@@ -505,6 +511,52 @@ TEST_F(CacheTest, window) {
   EXPECT_FALSE(clone->Next(&buffer, &size));
 }
 
+TEST_F(CacheTest, sharedBuffer) {
+  constexpr int32_t kMB = 1 << 20;
+  initializeCache(64 * kMB);
+  auto tracker = std::make_shared<ScanTracker>(
+      "testTracker",
+      nullptr,
+      dwio::common::ReaderOptions::kDefaultLoadQuantum,
+      groupStats_);
+  uint64_t fileId;
+  uint64_t groupId;
+  auto file = inputByPath("test_for_shared_buffer", fileId, groupId);
+  auto input = std::make_unique<CachedBufferedInput>(
+      file,
+      *pool_,
+      MetricsLog::voidLog(),
+      fileId,
+      cache_.get(),
+      tracker,
+      groupId,
+      ioStats_,
+      executor_.get(),
+      dwio::common::ReaderOptions::kDefaultLoadQuantum,
+      512 << 10);
+  auto stream = input->read(kMB, kMB, LogType::TEST);
+  // Nothing is shared before the first Next().
+  EXPECT_EQ(stream->sharedBuffer(), nullptr);
+  const void* buffer;
+  int32_t size;
+  ASSERT_TRUE(stream->Next(&buffer, &size));
+  auto shared = stream->sharedBuffer();
+  ASSERT_NE(shared, nullptr);
+  auto data = reinterpret_cast<const char*>(buffer);
+  EXPECT_LE(shared->as<char>(), data);
+  EXPECT_GE(shared->as<char>() + shared->size(), data + size);
+  const std::string expected(data, size);
+
+  // The shared buffer keeps the cache entry and its memory after the stream
+  // is gone.
+  stream.reset();
+  input.reset();
+  EXPECT_EQ(cache_->refreshStats().numShared, 1);
+  EXPECT_EQ(std::string_view(data, size), expected);
+  shared.reset();
+  EXPECT_EQ(cache_->refreshStats().numShared, 0);
+}
+
 TEST_F(CacheTest, bufferedInput) {
   // Size 160 MB. Frequent evictions and not everything fits in prefetch window.
   initializeCache(160 << 20);
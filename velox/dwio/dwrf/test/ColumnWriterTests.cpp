@@ -4402,6 +4402,103 @@ TEST(ColumnWriterTests, ColumnWriterDictionarySimple) {
   });
 };
 
+// Writes 'batches' with early dictionary abandonment after
+// 'earlyAbandonRows' rows and verifies the encoding and the data read back.
+// 'abandonAfterFirstBatch' is the expected result of trying to abandon the
+// dictionary after writing the first batch.
+void testEarlyDictionaryAbandonment(
+    const std::vector<VectorPtr>& batches,
+    uint32_t earlyAbandonRows,
+    bool abandonAfterFirstBatch,
+    proto::ColumnEncoding_Kind expectedKind) {
+  auto config = std::make_shared<Config>();
+  config->set(Config::DICTIONARY_EARLY_ABANDON_ROWS, earlyAbandonRows);
+  WriterContext context{config, getProcessDefaultMemoryManager().getPool()};
+  const auto& type = batches[0]->type();
+  auto rowType = ROW({type});
+  auto typeWithId = TypeWithId::create(type, 1);
+  auto writer = BaseColumnWriter::create(context, *typeWithId);
+
+  vector_size_t numRows = 0;
+  for (auto i = 0; i < batches.size(); ++i) {
+    writer->write(batches[i], common::Ranges::of(0, batches[i]->size()));
+    numRows += batches[i]->size();
+    if (i == 0) {
+      ASSERT_EQ(abandonAfterFirstBatch, writer->tryAbandonDictionaries(false));
+    }
+  }
+  writer->createIndexEntry();
+
+  proto::StripeFooter sf;
+  writer->flush([&sf](uint32_t /* unused */) -> proto::ColumnEncoding& {
+    return *sf.add_encoding();
+  });
+  ASSERT_EQ(expectedKind, sf.encoding(0).kind());
+
+  auto pool = getDefaultMemoryPool();
+  TestStripeStreams streams(context, sf, rowType, pool.get());
+  EXPECT_CALL(streams.getMockStrideIndexProvider(), getStrideIndex())
+      .WillRepeatedly(Return(0));
+  auto reqType = TypeWithId::create(rowType)->childAt(0);
+  auto reader = ColumnReader::build(reqType, reqType, streams);
+  VectorPtr out;
+  reader->next(numRows, out);
+  ASSERT_EQ(numRows, out->size());
+  vector_size_t row = 0;
+  for (const auto& batch : batches) {
+    for (auto i = 0; i < batch->size(); ++i, ++row) {
+      ASSERT_TRUE(out->equalValueAt(batch.get(), row, i)) << "at row " << row;
+    }
+  }
+}
+
+TEST(ColumnWriterTests, earlyDictionaryAbandonment) {
+  auto pool = getDefaultMemoryPool();
+  VectorMaker maker{pool.get()};
+  auto makeStrings = [&](vector_size_t offset, auto valueAt) {
+    std::vector<std::string> strings;
+    for (auto i = 0; i < 200; ++i) {
+      strings.push_back(fmt::format("string value {}", valueAt(offset + i)));
+    }
+    return maker.flatVector(strings);
+  };
+  auto unique = [](auto row) { return row; };
+  auto repeated = [](auto row) { return row % 5; };
+
+  for (const auto& batches : std::vector<std::vector<VectorPtr>>{
+           {maker.flatVector<int64_t>(200, unique),
+            maker.flatVector<int64_t>(
+                200, [](auto row) { return row + 200; })},
+           {makeStrings(0, unique), makeStrings(200, unique)}}) {
+    // Unique values abandon the dictionary after 100 rows.
+    testEarlyDictionaryAbandonment(
+        batches, 100, false, proto::ColumnEncoding_Kind_DIRECT);
+    // Without early abandonment the dictionary is kept until checked.
+    testEarlyDictionaryAbandonment(
+        batches, 0, true, proto::ColumnEncoding_Kind_DIRECT);
+  }
+
+  // Repeated values, including dictionary-encoded input, keep the dictionary.
+  auto indices = AlignedBuffer::allocate<vector_size_t>(200, pool.get());
+  auto rawIndices = indices->asMutable<vector_size_t>();
+  for (auto i = 0; i < 200; ++i) {
+    rawIndices[i] = (i * 7) % 50;
+  }
+  for (const auto& batches : std::vector<std::vector<VectorPtr>>{
+           {maker.flatVector<int64_t>(200, repeated),
+            BaseVector::wrapInDictionary(
+                nullptr,
+                indices,
+                200,
+                maker.flatVector<int64_t>(50, repeated))},
+           {makeStrings(0, repeated),
+            BaseVector::wrapInDictionary(
+                nullptr, indices, 200, makeStrings(0, repeated))}}) {
+    testEarlyDictionaryAbandonment(
+        batches, 100, false, proto::ColumnEncoding_Kind_DICTIONARY);
+  }
+}
+
 TEST(ColumnWriterTests, rowDictionary) {
   // For complex data valueAt lambda is not set as the data is generated
   // randomly
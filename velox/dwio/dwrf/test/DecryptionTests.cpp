@@ -256,3 +256,56 @@ TEST(Decryption, GroupOverlap) {
   ASSERT_THROW(
       DecryptionHandler::create(footer, &factory), exception::LoggedException);
 }
+
+TEST(Decryption, CachingDecrypterFactory) {
+  HiveTypeParser parser;
+  auto type = parser.parse("struct<a:int,b:int>");
+  proto::Footer footer;
+  ProtoUtils::writeType(*type, footer);
+  auto enc = footer.mutable_encryption();
+  enc->set_keyprovider(proto::Encryption_KeyProvider_UNKNOWN);
+  for (auto i = 1; i <= 2; ++i) {
+    auto group = enc->add_encryptiongroups();
+    group->add_nodes(i);
+    group->add_statistics();
+  }
+  for (auto i = 0; i < 3; ++i) {
+    auto stripe = footer.add_stripes();
+    *stripe->add_keymetadata() = folly::to<std::string>("key", i % 2);
+    *stripe->add_keymetadata() = "key2";
+  }
+
+  TestEncrypter encrypter;
+  encrypter.setKey("key2");
+  auto encrypted = encrypter.encrypt("foobar");
+
+  CachingDecrypterFactory factory(
+      std::make_shared<TestDecrypterFactory>(), std::chrono::hours(1));
+  // Two readers of the same file load each key once.
+  for (auto reader = 0; reader < 2; ++reader) {
+    auto handler = DecryptionHandler::create(footer, &factory);
+    for (auto i = 0; i < footer.stripes_size(); ++i) {
+      handler->setKeys(footer.stripes(i).keymetadata());
+      for (auto node = 1; node <= 2; ++node) {
+        ASSERT_TRUE(handler->getEncryptionProvider(node).isKeyLoaded());
+      }
+    }
+    auto decrypted = handler->getEncryptionProvider(2).decrypt(
+        folly::StringPiece{
+            reinterpret_cast<const char*>(encrypted->data()),
+            encrypted->length()});
+    ASSERT_EQ(decrypted->moveToFbString(), "foobar");
+    ASSERT_EQ(factory.numLoads(), 3);
+  }
+
+  factory.clear();
+  DecryptionHandler::create(footer, &factory);
+  ASSERT_EQ(factory.numLoads(), 5);
+
+  // Expired keys are loaded again.
+  CachingDecrypterFactory expiringFactory(
+      std::make_shared<TestDecrypterFactory>(), std::chrono::milliseconds(0));
+  DecryptionHandler::create(footer, &expiringFactory);
+  DecryptionHandler::create(footer, &expiringFactory);
+  ASSERT_EQ(expiringFactory.numLoads(), 4);
+}
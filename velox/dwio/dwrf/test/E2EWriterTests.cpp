@@ -15,6 +15,7 @@
  */
 
 #include <folly/Random.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <random>
 #include "velox/dwio/common/Options.h"
 #include "velox/dwio/common/Statistics.h"
@@ -885,6 +886,64 @@ TEST_F(E2EWriterTests, OversizeBatches) {
       false);
 }
 
+TEST_F(E2EWriterTests, parallelEncoding) {
+  HiveTypeParser parser;
+  auto type = parser.parse(
+      "struct<"
+      "bool_val:boolean,"
+      "int_val:int,"
+      "long_val:bigint,"
+      "double_val:double,"
+      "string_val:string,"
+      "array_val:array<float>,"
+      "map_val:map<int,double>,"
+      "flat_map_val:map<bigint,string>,"
+      "struct_val:struct<a:float,b:string>"
+      ">");
+  auto config = std::make_shared<Config>();
+  config->set(Config::ROW_INDEX_STRIDE, static_cast<uint32_t>(1000));
+  config->set(Config::STRIPE_SIZE, 64 * 1024UL);
+  config->set(Config::FLATTEN_MAP, true);
+  config->set(Config::MAP_FLAT_COLS, {7});
+  // The entropy heuristic of the string dictionary encoding samples the
+  // dictionary at random.
+  config->set(Config::ENTROPY_KEY_STRING_SIZE_THRESHOLD, 0.0f);
+
+  auto batches = E2EWriterTestUtil::generateBatches(
+      type, 10, 1100, /* seed */ 1411367325, *leafPool_);
+
+  auto writeFile = [&](folly::Executor* executor) {
+    auto sink = std::make_unique<MemorySink>(*leafPool_, 200 * kSizeMB);
+    auto sinkPtr = sink.get();
+    WriterOptions options;
+    options.config = config;
+    options.schema = type;
+    options.executor = executor;
+    Writer writer{options, std::move(sink), *rootPool_};
+    for (const auto& batch : batches) {
+      writer.write(batch);
+    }
+    writer.close();
+    return std::string(sinkPtr->getData(), sinkPtr->size());
+  };
+
+  auto serialFile = writeFile(nullptr);
+  folly::CPUThreadPoolExecutor executor(4);
+  // The files are the same byte for byte, including the stripe boundaries
+  // chosen by the flush policy.
+  for (auto i = 0; i < 3; ++i) {
+    ASSERT_EQ(serialFile, writeFile(&executor));
+  }
+
+  ReaderOptions readerOpts{defaultPool.get()};
+  DwrfReader reader(
+      readerOpts,
+      std::make_unique<BufferedInput>(
+          std::make_shared<InMemoryReadFile>(serialFile),
+          readerOpts.getMemoryPool()));
+  ASSERT_GT(reader.getNumberOfStripes(), 1);
+}
+
 TEST_F(E2EWriterTests, OverflowLengthIncrements) {
   auto pool = facebook::velox::memory::getDefaultMemoryPool();
 
@@ -18,9 +18,11 @@
 #include <folly/String.h>
 #include <folly/compression/Compression.h>
 #include <folly/compression/Zlib.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 #include "velox/common/base/BitUtil.h"
 #include "velox/dwio/common/InputStream.h"
+#include "velox/dwio/common/encryption/TestProvider.h"
 #include "velox/dwio/dwrf/common/Compression.h"
 #include "velox/dwio/dwrf/test/OrcTest.h"
 
@@ -1099,3 +1101,137 @@ TEST_F(TestSeek, uncompressedLarge) {
     } while (readSize < targetSize);
   }
 }
+
+TEST_F(TestSeek, readAhead) {
+  constexpr int32_t kNumBlocks = 12;
+  constexpr int32_t kBlockSize = 1024;
+  // Block 5 is not compressed.
+  constexpr int32_t kOriginalBlock = 5;
+  auto codec = getCodec(CodecType::ZSTD);
+  std::vector<std::vector<char>> blocks(kNumBlocks);
+  std::vector<uint64_t> offsets;
+  std::vector<char> file(kNumBlocks * (kBlockSize + 64));
+  size_t offset = 0;
+  for (auto i = 0; i < kNumBlocks; ++i) {
+    blocks[i].resize(kBlockSize);
+    fillInput(blocks[i].data(), kBlockSize);
+    offsets.push_back(offset);
+    if (i == kOriginalBlock) {
+      writeHeader(file.data() + offset, kBlockSize, true);
+      std::copy(
+          blocks[i].begin(), blocks[i].end(), file.data() + offset + 3);
+      offset += kBlockSize + 3;
+    } else {
+      offset =
+          compress(blocks[i].data(), kBlockSize, file.data(), offset, *codec);
+    }
+  }
+
+  folly::CPUThreadPoolExecutor executor(4);
+  for (auto maxBytes : {10UL << 20, 3UL * kBlockSize, 0UL}) {
+    SCOPED_TRACE(maxBytes);
+    auto budget = std::make_shared<ReadAheadBudget>(maxBytes);
+    auto stream = createDecompressor(
+        CompressionKind_ZSTD,
+        std::make_unique<SeekableArrayInputStream>(file.data(), offset, 700),
+        kBlockSize,
+        *pool,
+        "Test Decompression",
+        nullptr,
+        {&executor, 3, budget});
+
+    auto expectBlock = [&](int32_t block, int32_t skip) {
+      const void* data;
+      int32_t size;
+      int32_t read = skip;
+      while (read < kBlockSize) {
+        ASSERT_TRUE(stream->Next(&data, &size));
+        ASSERT_EQ(0, memcmp(data, blocks[block].data() + read, size));
+        read += size;
+      }
+      ASSERT_EQ(kBlockSize, read);
+    };
+
+    for (auto i = 0; i < kNumBlocks; ++i) {
+      expectBlock(i, 0);
+    }
+    const void* data;
+    int32_t size;
+    EXPECT_FALSE(stream->Next(&data, &size));
+
+    // Seeks backward, then forward within and beyond the blocks read ahead.
+    for (auto [block, skip] : std::vector<std::pair<int32_t, int32_t>>{
+             {1, 10}, {2, 0}, {3, 100}, {kOriginalBlock, 20}, {9, 0}, {0, 0}}) {
+      std::vector<uint64_t> positions{
+          offsets[block], static_cast<uint64_t>(skip)};
+      PositionProvider provider(positions);
+      stream->seekToPosition(provider);
+      expectBlock(block, skip);
+    }
+    stream.reset();
+    EXPECT_EQ(0, budget->reservedBytes());
+  }
+}
+
+TEST_F(TestSeek, readAheadEncrypted) {
+  constexpr int32_t kNumBlocks = 8;
+  constexpr int32_t kBlockSize = 1024;
+  // Block 3 is not compressed.
+  constexpr int32_t kOriginalBlock = 3;
+  auto codec = getCodec(CodecType::ZSTD);
+  encryption::test::TestEncrypter encrypter;
+  encrypter.setKey("key");
+  encryption::test::TestDecrypter decrypter;
+  decrypter.setKey("key");
+
+  std::vector<std::vector<char>> blocks(kNumBlocks);
+  std::vector<char> file;
+  for (auto i = 0; i < kNumBlocks; ++i) {
+    blocks[i].resize(kBlockSize);
+    fillInput(blocks[i].data(), kBlockSize);
+    std::string block;
+    if (i == kOriginalBlock) {
+      block.assign(blocks[i].begin(), blocks[i].end());
+    } else {
+      auto ioBuf = folly::IOBuf::wrapBuffer(blocks[i].data(), kBlockSize);
+      block = codec->compress(ioBuf.get())->moveToFbString().toStdString();
+    }
+    auto encrypted = encrypter.encrypt(block)->moveToFbString();
+    auto offset = file.size();
+    file.resize(offset + 3 + encrypted.size());
+    writeHeader(file.data() + offset, encrypted.size(), i == kOriginalBlock);
+    std::copy(encrypted.begin(), encrypted.end(), file.data() + offset + 3);
+  }
+
+  folly::CPUThreadPoolExecutor executor(4);
+  for (auto maxBytes : {10UL << 20, 6UL * kBlockSize, 0UL}) {
+    SCOPED_TRACE(maxBytes);
+    auto budget = std::make_shared<ReadAheadBudget>(maxBytes);
+    auto stream = createDecompressor(
+        CompressionKind_ZSTD,
+        std::make_unique<SeekableArrayInputStream>(
+            file.data(), file.size(), 700),
+        kBlockSize,
+        *pool,
+        "Test Decompression",
+        &decrypter,
+        {&executor, 3, budget});
+
+    for (auto i = 0; i < kNumBlocks; ++i) {
+      const void* data;
+      int32_t size;
+      int32_t read = 0;
+      while (read < kBlockSize) {
+        ASSERT_TRUE(stream->Next(&data, &size));
+        ASSERT_EQ(0, memcmp(data, blocks[i].data() + read, size));
+        read += size;
+      }
+      ASSERT_EQ(kBlockSize, read);
+    }
+    const void* data;
+    int32_t size;
+    EXPECT_FALSE(stream->Next(&data, &size));
+    stream.reset();
+    EXPECT_EQ(0, budget->reservedBytes());
+  }
+}
@@ -16,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include <random>
+
 #include "velox/common/base/Nulls.h"
 #include "velox/dwio/common/IntDecoder.h"
 #include "velox/dwio/common/SeekableInputStream.h"
@@ -666,6 +668,110 @@ TEST(RLEv2, bitsLeftByPreviousStream) {
   }
 };
 
+namespace {
+// Appends a DIRECT run of 'values' packed in 'bitWidth' bits to 'bytes'.
+void appendDirectRun(
+    const std::vector<uint64_t>& values,
+    uint32_t bitWidth,
+    std::vector<unsigned char>& bytes) {
+  uint32_t encodedWidth;
+  if (bitWidth <= 24) {
+    encodedWidth = bitWidth - 1;
+  } else {
+    const std::vector<uint32_t> widths = {26, 28, 30, 32, 40, 48, 56, 64};
+    encodedWidth = 24 +
+        (std::find(widths.begin(), widths.end(), bitWidth) - widths.begin());
+  }
+  const auto length = values.size() - 1;
+  bytes.push_back(0x40 | (encodedWidth << 1) | (length >> 8));
+  bytes.push_back(length & 0xff);
+  uint64_t bitOffset = bytes.size() * 8;
+  bytes.resize(bytes.size() + bits::nbytes(values.size() * bitWidth));
+  for (auto value : values) {
+    for (int32_t bit = bitWidth - 1; bit >= 0; --bit, ++bitOffset) {
+      if ((value >> bit) & 1) {
+        bytes[bitOffset / 8] |= 0x80 >> (bitOffset % 8);
+      }
+    }
+  }
+}
+} // namespace
+
+TEST(RLEv2, directBitWidths) {
+  auto pool = memory::getDefaultMemoryPool();
+  std::mt19937 rng(1);
+  for (uint32_t bitWidth :
+       {1, 2, 3, 7, 8, 11, 16, 24, 26, 28, 30, 32, 40, 48, 56, 64}) {
+    // Two runs, one of the maximum length and a short one.
+    std::vector<uint64_t> values;
+    std::vector<unsigned char> bytes;
+    for (auto runLength : {512, 5}) {
+      std::vector<uint64_t> run;
+      for (auto i = 0; i < runLength; ++i) {
+        uint64_t value = (static_cast<uint64_t>(rng()) << 32) | rng();
+        run.push_back(
+            bitWidth == 64 ? value : value & ((1UL << bitWidth) - 1));
+      }
+      appendDirectRun(run, bitWidth, bytes);
+      values.insert(values.end(), run.begin(), run.end());
+    }
+
+    // Read in batches while skipping, with the packed runs spanning stream
+    // buffers.
+    for (auto blockSize : {0, 13}) {
+      auto rle = createRleDecoder<false>(
+          std::make_unique<dwio::common::SeekableArrayInputStream>(
+              bytes.data(), bytes.size(), blockSize),
+          RleVersion_2,
+          *pool,
+          true /* doesn't matter */,
+          dwio::common::INT_BYTE_SIZE /* doesn't matter */);
+      std::vector<int64_t> data(100);
+      size_t row = 0;
+      while (row < values.size()) {
+        const auto numRead = std::min<size_t>(100, values.size() - row);
+        rle->next(data.data(), numRead, nullptr);
+        for (auto i = 0; i < numRead; ++i) {
+          ASSERT_EQ(values[row + i], data[i])
+              << "bitWidth " << bitWidth << " row " << row + i;
+        }
+        row += numRead;
+        const auto numSkipped = std::min<size_t>(37, values.size() - row);
+        rle->skip(numSkipped);
+        row += numSkipped;
+      }
+    }
+  }
+}
+
+TEST(RLEv2, skipRuns) {
+  // 0,1 repeated 10 times (signed ints) followed by
+  // 0,2 repeated 10 times (signed ints)
+  const unsigned char bytes[] = {
+      0x42, 0x13, 0x22, 0x22, 0x22, 0x22, 0x22, 0x46, 0x13, 0x04,
+      0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04};
+  std::vector<int64_t> values;
+  for (size_t i = 0; i < 40; ++i) {
+    values.push_back(i < 20 ? i % 2 : (i % 2) * 2);
+  }
+  auto pool = memory::getDefaultMemoryPool();
+  for (auto numSkipped : {0, 1, 19, 20, 21, 39}) {
+    auto rle = createRleDecoder<true>(
+        std::make_unique<dwio::common::SeekableArrayInputStream>(
+            bytes, VELOX_ARRAY_SIZE(bytes)),
+        RleVersion_2,
+        *pool,
+        true /* doesn't matter */,
+        dwio::common::INT_BYTE_SIZE /* doesn't matter */);
+    rle->skip(numSkipped);
+    std::vector<int64_t> data(values.size() - numSkipped);
+    rle->next(data.data(), data.size(), nullptr);
+    for (size_t i = 0; i < data.size(); ++i) {
+      EXPECT_EQ(values[numSkipped + i], data[i]) << "skipped " << numSkipped;
+    }
+  }
+}
+
 TEST(RLEv1, simpleTest) {
   auto pool = memory::getDefaultMemoryPool();
   const unsigned char buffer[] = {
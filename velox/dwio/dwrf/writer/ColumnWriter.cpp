@@ -16,6 +16,7 @@
 
 #include "velox/dwio/dwrf/writer/ColumnWriter.h"
 #include <velox/dwio/common/exception/Exception.h>
+#include "velox/common/base/AsyncSource.h"
 #include "velox/dwio/common/ChainedBuffer.h"
 #include "velox/dwio/dwrf/common/EncoderUtil.h"
 #include "velox/dwio/dwrf/writer/DictionaryEncodingUtils.h"
@@ -35,7 +36,8 @@ namespace facebook::velox::dwrf {
 WriterContext::LocalDecodedVector BaseColumnWriter::decode(
     const VectorPtr& slice,
     const common::Ranges& ranges) {
-  auto& selected = context_.getSharedSelectivityVector(slice->size());
+  auto localSelected = context_.getLocalSelectivityVector(slice->size());
+  auto& selected = localSelected.get();
   // initialize
   selected.clearAll();
   for (auto& range : ranges.getRanges()) {
@@ -183,6 +185,44 @@ uint64_t ByteRleColumnWriter<bool>::write(
   return ranges.size();
 }
 
+// Dictionary and constant encoded inputs repeat the values of their base.
+// Remembers the dictionary key index of each base row so that every distinct
+// base value is hashed only once per write.
+class BaseKeyIndices {
+ public:
+  BaseKeyIndices(
+      const DecodedVector& decodedVector,
+      const common::Ranges& ranges)
+      : decodedVector_{decodedVector} {
+    if (!decodedVector.isIdentityMapping() &&
+        decodedVector.base()->size() <= ranges.size()) {
+      indices_.resize(decodedVector.base()->size(), kNoIndex);
+    }
+  }
+
+  // Returns the key index for the value at 'pos'. Calls 'addKey' if the base
+  // row was not seen before and only bumps the count of the key otherwise.
+  template <typename Encoder, typename AddKey>
+  uint32_t addKey(Encoder& encoder, vector_size_t pos, AddKey addKey) {
+    if (indices_.empty()) {
+      return addKey();
+    }
+    auto& index = indices_[decodedVector_.index(pos)];
+    if (index == kNoIndex) {
+      index = addKey();
+    } else {
+      encoder.addCount(index);
+    }
+    return index;
+  }
+
+ private:
+  static constexpr uint32_t kNoIndex = std::numeric_limits<uint32_t>::max();
+
+  const DecodedVector& decodedVector_;
+  std::vector<uint32_t> indices_;
+};
+
 // The integer writer class that tries to use dictionary encoding to write
 // the given integer values. If dictionary encoding is determined to be
 // inefficient for the column, we would write the column with direct encoding
@@ -209,6 +249,7 @@ class IntegerColumnWriter : public BaseColumnWriter {
         dictionaryKeySizeThreshold_{
             getConfig(Config::DICTIONARY_NUMERIC_KEY_SIZE_THRESHOLD)},
         sort_{getConfig(Config::DICTIONARY_SORT_KEYS)},
+        earlyAbandonRows_{getConfig(Config::DICTIONARY_EARLY_ABANDON_ROWS)},
         useDictionaryEncoding_{useDictionaryEncoding()},
         strideOffsets_{getMemoryPool(MemoryUsageCategory::GENERAL)} {
     DWIO_ENSURE_GE(dictionaryKeySizeThreshold_, 0.0);
@@ -401,6 +442,17 @@ class IntegerColumnWriter : public BaseColumnWriter {
     ensureValidStreamWriters(dictEncoding);
   }
 
+  // Checks the dictionary efficiency once the first stripe has
+  // 'earlyAbandonRows_' rows instead of only at flush. Columns with few
+  // repeated values then stop hashing every value early in the stripe.
+  void tryAbandonDictionariesEarly() {
+    if (earlyAbandonRows_ > 0 && !earlyAbandonChecked_ &&
+        rows_.size() >= earlyAbandonRows_) {
+      earlyAbandonChecked_ = true;
+      tryAbandonDictionaries(false);
+    }
+  }
+
   // NOTE: This should be called *before* clearing the rows_ buffer.
   bool shouldKeepDictionary() const {
     // TODO(T91508412): Move the dictionary efficiency based decision into
@@ -462,6 +514,8 @@ class IntegerColumnWriter : public BaseColumnWriter {
   size_t finalDictionarySize_;
   const float dictionaryKeySizeThreshold_;
   const bool sort_;
+  const uint32_t earlyAbandonRows_;
+  bool earlyAbandonChecked_{false};
   // This value could change if we are writing with low memory mode or if we
   // determine with the first stripe that the data is not fit for dictionary
   // encoding.
@@ -478,7 +532,9 @@ uint64_t IntegerColumnWriter<T>::write(
     // Decode and then write
     auto localDecoded = decode(slice, ranges);
     auto& decodedVector = localDecoded.get();
-    return writeDict(decodedVector, ranges);
+    auto rawSize = writeDict(decodedVector, ranges);
+    tryAbandonDictionariesEarly();
+    return rawSize;
   } else {
     // If the input is not a flat vector we make a complete copy and convert
     // it to flat vector
@@ -506,9 +562,11 @@ uint64_t IntegerColumnWriter<T>::writeDict(
   writeNulls(decodedVector, ranges);
   // make sure we have enough space
   rows_.reserve(rows_.size() + ranges.size());
+  BaseKeyIndices baseKeyIndices{decodedVector, ranges};
   auto processRow = [&](vector_size_t pos) {
     T value = decodedVector.valueAt<T>(pos);
-    rows_.unsafeAppend(dictEncoder_.addKey(value));
+    rows_.unsafeAppend(baseKeyIndices.addKey(
+        dictEncoder_, pos, [&]() { return dictEncoder_.addKey(value); }));
     statsBuilder.addValues(value);
   };
 
@@ -804,6 +862,7 @@ class StringColumnWriter : public BaseColumnWriter {
             getConfig(Config::ENTROPY_STRING_DICT_SAMPLE_FRACTION),
             getConfig(Config::ENTROPY_STRING_THRESHOLD)},
         sort_{getConfig(Config::DICTIONARY_SORT_KEYS)},
+        earlyAbandonRows_{getConfig(Config::DICTIONARY_EARLY_ABANDON_ROWS)},
         useDictionaryEncoding_{useDictionaryEncoding()},
         strideOffsets_{getMemoryPool(MemoryUsageCategory::GENERAL)} {
     DWIO_ENSURE(firstStripe_);
@@ -1017,6 +1076,17 @@ class StringColumnWriter : public BaseColumnWriter {
     ensureValidStreamWriters(dictEncoding);
   }
 
+  // Checks the dictionary efficiency once the first stripe has
+  // 'earlyAbandonRows_' rows instead of only at flush. Columns with few
+  // repeated values then stop hashing every value early in the stripe.
+  void tryAbandonDictionariesEarly() {
+    if (earlyAbandonRows_ > 0 && !earlyAbandonChecked_ &&
+        rows_.size() >= earlyAbandonRows_) {
+      earlyAbandonChecked_ = true;
+      tryAbandonDictionaries(false);
+    }
+  }
+
   // NOTE: This should be called *before* clearing the rows_ buffer.
   bool shouldKeepDictionary() const {
     return rows_.size() != 0 &&
@@ -1078,6 +1148,8 @@ class StringColumnWriter : public BaseColumnWriter {
   size_t finalDictionarySize_;
   EntropyEncodingSelector encodingSelector_;
   const bool sort_;
+  const uint32_t earlyAbandonRows_;
+  bool earlyAbandonChecked_{false};
   // This value could change if we are writing with low memory mode or if we
   // determine with the first stripe that the data is not fit for dictionary
   // encoding.
@@ -1093,7 +1165,9 @@ uint64_t StringColumnWriter::write(
   auto& decodedVector = localDecoded.get();
 
   if (useDictionaryEncoding_) {
-    return writeDict(decodedVector, ranges);
+    auto rawSize = writeDict(decodedVector, ranges);
+    tryAbandonDictionariesEarly();
+    return rawSize;
   } else {
     return writeDirect(decodedVector, ranges);
   }
@@ -1109,9 +1183,12 @@ uint64_t StringColumnWriter::writeDict(
   rows_.reserve(rows_.size() + ranges.size());
   size_t strideIndex = strideOffsets_.size() - 1;
   uint64_t rawSize = 0;
+  BaseKeyIndices baseKeyIndices{decodedVector, ranges};
   auto processRow = [&](size_t pos) {
     auto sp = decodedVector.valueAt<StringView>(pos);
-    rows_.unsafeAppend(dictEncoder_.addKey(sp, strideIndex));
+    rows_.unsafeAppend(baseKeyIndices.addKey(dictEncoder_, pos, [&]() {
+      return dictEncoder_.addKey(sp, strideIndex);
+    }));
     statsBuilder.addValues(sp);
     rawSize += sp.size();
   };
@@ -1586,26 +1663,107 @@ class StructColumnWriter : public BaseColumnWriter {
 
   void flush(
       std::function<proto::ColumnEncoding&(uint32_t)> encodingFactory,
-      std::function<void(proto::ColumnEncoding&)> encodingOverride) override {
-    BaseColumnWriter::flush(encodingFactory, encodingOverride);
-    for (auto& c : children_) {
-      c->flush(encodingFactory);
-    }
-  }
+      std::function<void(proto::ColumnEncoding&)> encodingOverride) override;
 
  private:
+  // The encodings added by a child writer on flush, in order.
+  using Encodings =
+      std::vector<std::pair<uint32_t, std::unique_ptr<proto::ColumnEncoding>>>;
+
+  // True if the children of the root are written on the executor of the
+  // context.
+  bool isParallel() const {
+    return isRoot() && context_.executor() != nullptr && children_.size() > 1;
+  }
+
+  // Runs 'func' with the index of each child writer on the executor of the
+  // context and returns the results in child order. The caller thread runs
+  // the children not yet picked up by the executor.
+  template <typename Item>
+  std::vector<std::unique_ptr<Item>> runOnChildren(
+      const std::function<std::unique_ptr<Item>(size_t)>& func);
+
   uint64_t writeChildrenAndStats(
       const RowVector* rowSlice,
       const common::Ranges& ranges,
       uint64_t nullCount);
 };
 
+template <typename Item>
+std::vector<std::unique_ptr<Item>> StructColumnWriter::runOnChildren(
+    const std::function<std::unique_ptr<Item>(size_t)>& func) {
+  std::vector<std::shared_ptr<AsyncSource<Item>>> tasks;
+  tasks.reserve(children_.size());
+  for (size_t i = 0; i < children_.size(); ++i) {
+    tasks.push_back(std::make_shared<AsyncSource<Item>>(
+        [&func, i]() { return func(i); }));
+    context_.executor()->add([task = tasks.back()]() { task->prepare(); });
+  }
+  // Waits for all the children before rethrowing the first error since the
+  // tasks reference 'func' and the child writers.
+  std::vector<std::unique_ptr<Item>> results;
+  results.reserve(tasks.size());
+  std::exception_ptr error;
+  for (auto& task : tasks) {
+    try {
+      results.push_back(task->move());
+    } catch (const std::exception&) {
+      if (!error) {
+        error = std::current_exception();
+      }
+      results.push_back(nullptr);
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return results;
+}
+
+void StructColumnWriter::flush(
+    std::function<proto::ColumnEncoding&(uint32_t)> encodingFactory,
+    std::function<void(proto::ColumnEncoding&)> encodingOverride) {
+  BaseColumnWriter::flush(encodingFactory, encodingOverride);
+  if (!isParallel()) {
+    for (auto& c : children_) {
+      c->flush(encodingFactory);
+    }
+    return;
+  }
+
+  // The children collect their encodings locally, which are then added in
+  // child order so that the stripe footer is the same as when flushing
+  // serially.
+  auto childEncodings = runOnChildren<Encodings>([&](size_t child) {
+    auto encodings = std::make_unique<Encodings>();
+    children_[child]->flush([&](uint32_t nodeId) -> proto::ColumnEncoding& {
+      encodings->emplace_back(
+          nodeId, std::make_unique<proto::ColumnEncoding>());
+      return *encodings->back().second;
+    });
+    return encodings;
+  });
+  for (auto& encodings : childEncodings) {
+    for (auto& [nodeId, encoding] : *encodings) {
+      encodingFactory(nodeId).CopyFrom(*encoding);
+    }
+  }
+}
+
 uint64_t StructColumnWriter::writeChildrenAndStats(
     const RowVector* rowSlice,
     const common::Ranges& ranges,
     uint64_t nullCount) {
   uint64_t rawSize = 0;
-  if (ranges.size() > 0) {
+  if (ranges.size() > 0 && isParallel()) {
+    auto childSizes = runOnChildren<uint64_t>([&](size_t child) {
+      return std::make_unique<uint64_t>(
+          children_[child]->write(rowSlice->childAt(child), ranges));
+    });
+    for (auto& size : childSizes) {
+      rawSize += *size;
+    }
+  } else if (ranges.size() > 0) {
     for (size_t i = 0; i < children_.size(); ++i) {
       rawSize += children_.at(i)->write(rowSlice->childAt(i), ranges);
     }
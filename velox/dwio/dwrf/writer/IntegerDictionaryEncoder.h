@@ -147,6 +147,12 @@ class IntegerDictionaryEncoder : public AbstractIntegerDictionaryEncoder {
     return newIndex;
   }
 
+  // Adds 'count' occurrences of the key at 'index' without looking it up.
+  void addCount(uint32_t index, uint32_t count = 1) {
+    totalCount_ += count;
+    counts_[index] += count;
+  }
+
   // Returns the num elements in the dictionary. Helps determine if we
   // should use dictionary encoding at all.
   uint32_t size() const override {
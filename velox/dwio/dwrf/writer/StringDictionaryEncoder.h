@@ -116,6 +116,11 @@ class StringDictionaryEncoder {
     return counts_.size();
   }
 
+  // Adds 'count' occurrences of the key at 'index' without looking it up.
+  void addCount(uint32_t index, uint32_t count = 1) {
+    counts_[index] += count;
+  }
+
   uint32_t
   addKey(folly::StringPiece sp, uint32_t strideIndex, uint32_t count = 1) {
     auto newIndex = size();
@@ -124,6 +124,10 @@ struct WriterOptions {
       WriterContext& context,
       const velox::dwio::common::TypeWithId& type)>
       columnWriterFactory;
+  // Executor to encode and compress the top level columns in parallel on.
+  // The stripes written are the same as without an executor. Must outlive
+  // the writer.
+  folly::Executor* executor{nullptr};
 };
 
 class Writer : public WriterBase {
@@ -144,6 +148,7 @@ class Writer : public WriterBase {
     initContext(options.config, std::move(pool), std::move(handler));
     auto& context = getContext();
     context.buildPhysicalSizeAggregators(*schema_);
+    context.setExecutor(options.executor);
     if (!options.flushPolicyFactory) {
       flushPolicy_ = std::make_unique<DefaultFlushPolicy>(
           context.stripeSizeFlushThreshold,
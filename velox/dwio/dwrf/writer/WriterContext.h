@@ -16,7 +16,9 @@
 
 #pragma once
 
+#include <folly/Executor.h>
 #include <limits>
+#include <mutex>
 #include "velox/common/base/GTestMacros.h"
 #include "velox/common/time/CpuWallTimer.h"
 #include "velox/dwio/dwrf/common/Common.h"
@@ -72,8 +74,7 @@ class WriterContext : public CompressionBufferPool {
     }
     validateConfigs();
     VLOG(1) << fmt::format("Compression config: {}", compression);
-    compressionBuffer_ = std::make_unique<dwio::common::DataBuffer<char>>(
-        *generalPool_, compressionBlockSize + PAGE_HEADER_SIZE);
+    compressionBuffers_.push_back(newCompressionBuffer());
   }
 
   bool hasStream(const DwrfStreamIdentifier& stream) const {
@@ -100,6 +101,9 @@ class WriterContext : public CompressionBufferPool {
   // flush policy evaluation and would be more accurate after flush.
   std::unique_ptr<BufferedOutputStream> newStream(
       const DwrfStreamIdentifier& stream) {
+    // Column writers of different columns may add streams concurrently when
+    // encoding in parallel, e.g. flat map writers on new keys.
+    std::unique_lock<std::mutex> l(streamsMutex_);
     DWIO_ENSURE(
         !hasStream(stream), "Stream already exists ", stream.toString());
     streams_.emplace(
@@ -111,6 +115,7 @@ class WriterContext : public CompressionBufferPool {
             getConfig(Config::COMPRESSION_BLOCK_SIZE_MIN),
             getConfig(Config::COMPRESSION_BLOCK_SIZE_EXTEND_RATIO)));
     auto& holder = streams_.at(stream);
+    l.unlock();
     auto encrypter = handler_->isEncrypted(stream.encodingKey().node)
         ? std::addressof(
               handler_->getEncryptionProvider(stream.encodingKey().node))
@@ -140,6 +145,7 @@ class WriterContext : public CompressionBufferPool {
       const EncodingKey& ek,
       velox::memory::MemoryPool& dictionaryPool,
       velox::memory::MemoryPool& generalPool) {
+    std::lock_guard<std::mutex> l(dictEncodersMutex_);
     auto result = dictEncoders_.find(ek);
     if (result == dictEncoders_.end()) {
       auto emplaceResult = dictEncoders_.emplace(
@@ -299,18 +305,48 @@ class WriterContext : public CompressionBufferPool {
     }
   }
 
+  // Streams hold a compression buffer only while compressing a page. A
+  // single buffer is enough when the columns are encoded serially, more are
+  // allocated on demand when encoding in parallel. Only one buffer is kept
+  // on return so that the memory usage seen by the flush policy does not
+  // depend on the parallelism.
   std::unique_ptr<dwio::common::DataBuffer<char>> getBuffer(
       uint64_t size) override {
-    DWIO_ENSURE_NOT_NULL(compressionBuffer_);
-    DWIO_ENSURE_GE(compressionBuffer_->size(), size);
-    return std::move(compressionBuffer_);
+    std::unique_ptr<dwio::common::DataBuffer<char>> buffer;
+    {
+      std::lock_guard<std::mutex> l(compressionBuffersMutex_);
+      if (!compressionBuffers_.empty()) {
+        buffer = std::move(compressionBuffers_.back());
+        compressionBuffers_.pop_back();
+      }
+    }
+    if (!buffer) {
+      buffer = newCompressionBuffer();
+    }
+    DWIO_ENSURE_GE(buffer->size(), size);
+    return buffer;
   }
 
   void returnBuffer(
       std::unique_ptr<dwio::common::DataBuffer<char>> buffer) override {
     DWIO_ENSURE_NOT_NULL(buffer);
-    DWIO_ENSURE(!compressionBuffer_);
-    compressionBuffer_ = std::move(buffer);
+    std::lock_guard<std::mutex> l(compressionBuffersMutex_);
+    if (compressionBuffers_.empty()) {
+      compressionBuffers_.push_back(std::move(buffer));
+    }
+  }
+
+  // Sets the executor to encode and compress the top level columns in
+  // parallel on. The column writers run on the caller thread if not set.
+  void setExecutor(folly::Executor* executor) {
+    executor_ = executor;
+  }
+
+  // Returns the executor to encode the top level columns on, or nullptr if
+  // they are encoded serially. Encrypted files are always encoded serially
+  // since columns of an encryption group share their encrypter.
+  folly::Executor* executor() const {
+    return handler_->isEncrypted() ? nullptr : executor_;
   }
 
   void incrementNodeSize(uint32_t node, uint64_t size) {
@@ -487,19 +523,47 @@ class WriterContext : public CompressionBufferPool {
     return LocalDecodedVector{*this};
   }
 
-  SelectivityVector& getSharedSelectivityVector(velox::vector_size_t size) {
-    if (UNLIKELY(!selectivityVector_)) {
-      selectivityVector_ = std::make_unique<velox::SelectivityVector>(size);
-    } else {
-      selectivityVector_->resize(size);
+  class LocalSelectivityVector {
+   public:
+    LocalSelectivityVector(WriterContext& context, velox::vector_size_t size)
+        : context_(context), vector_(context_.getSelectivityVector(size)) {}
+
+    LocalSelectivityVector(LocalSelectivityVector&& other) noexcept
+        : context_{other.context_}, vector_{std::move(other.vector_)} {}
+
+    LocalSelectivityVector& operator=(LocalSelectivityVector&& other) =
+        delete;
+
+    ~LocalSelectivityVector() {
+      if (vector_) {
+        context_.releaseSelectivityVector(std::move(vector_));
+      }
+    }
+
+    SelectivityVector& get() {
+      return *vector_;
     }
-    return *selectivityVector_;
+
+   private:
+    WriterContext& context_;
+    std::unique_ptr<velox::SelectivityVector> vector_;
+  };
+
+  LocalSelectivityVector getLocalSelectivityVector(
+      velox::vector_size_t size) {
+    return LocalSelectivityVector{*this, size};
   }
 
  private:
   void validateConfigs() const;
 
+  std::unique_ptr<dwio::common::DataBuffer<char>> newCompressionBuffer() {
+    return std::make_unique<dwio::common::DataBuffer<char>>(
+        *generalPool_, compressionBlockSize + PAGE_HEADER_SIZE);
+  }
+
   std::unique_ptr<velox::DecodedVector> getDecodedVector() {
+    std::lock_guard<std::mutex> l(vectorPoolMutex_);
     if (decodedVectorPool_.empty()) {
       return std::make_unique<velox::DecodedVector>();
     }
@@ -509,9 +573,33 @@ class WriterContext : public CompressionBufferPool {
   }
 
   void releaseDecodedVector(std::unique_ptr<velox::DecodedVector>&& vector) {
+    std::lock_guard<std::mutex> l(vectorPoolMutex_);
     decodedVectorPool_.push_back(std::move(vector));
   }
 
+  std::unique_ptr<velox::SelectivityVector> getSelectivityVector(
+      velox::vector_size_t size) {
+    std::unique_ptr<velox::SelectivityVector> vector;
+    {
+      std::lock_guard<std::mutex> l(vectorPoolMutex_);
+      if (!selectivityVectorPool_.empty()) {
+        vector = std::move(selectivityVectorPool_.back());
+        selectivityVectorPool_.pop_back();
+      }
+    }
+    if (!vector) {
+      return std::make_unique<velox::SelectivityVector>(size);
+    }
+    vector->resize(size);
+    return vector;
+  }
+
+  void releaseSelectivityVector(
+      std::unique_ptr<velox::SelectivityVector>&& vector) {
+    std::lock_guard<std::mutex> l(vectorPoolMutex_);
+    selectivityVectorPool_.push_back(std::move(vector));
+  }
+
   std::shared_ptr<const Config> config_;
   std::shared_ptr<memory::MemoryPool> pool_;
   std::shared_ptr<memory::MemoryPool> dictionaryPool_;
@@ -524,6 +612,8 @@ class WriterContext : public CompressionBufferPool {
       DataBufferHolder,
       dwio::common::StreamIdentifierHash>
       streams_;
+  // Serializes the insertions into 'streams_'.
+  std::mutex streamsMutex_;
   folly::F14NodeMap<uint32_t, std::unique_ptr<PhysicalSizeAggregator>>
       physicalSizeAggregators_;
   folly::F14FastMap<
@@ -531,14 +621,20 @@ class WriterContext : public CompressionBufferPool {
       std::unique_ptr<AbstractIntegerDictionaryEncoder>,
       EncodingKeyHash>
       dictEncoders_;
+  std::mutex dictEncodersMutex_;
   std::function<std::unique_ptr<IndexBuilder>(
       std::unique_ptr<BufferedOutputStream>)>
       indexBuilderFactory_;
-  std::unique_ptr<dwio::common::DataBuffer<char>> compressionBuffer_;
-  // A pool of reusable DecodedVectors.
+  // The compression buffers not in use.
+  std::vector<std::unique_ptr<dwio::common::DataBuffer<char>>>
+      compressionBuffers_;
+  std::mutex compressionBuffersMutex_;
+  // Pools of reusable DecodedVectors and SelectivityVectors.
   std::vector<std::unique_ptr<velox::DecodedVector>> decodedVectorPool_;
-  // Reusable SelectivityVector
-  std::unique_ptr<velox::SelectivityVector> selectivityVector_;
+  std::vector<std::unique_ptr<velox::SelectivityVector>>
+      selectivityVectorPool_;
+  std::mutex vectorPoolMutex_;
+  folly::Executor* executor_{nullptr};
 
   std::unique_ptr<encryption::EncryptionHandler> handler_;
   folly::F14FastMap<uint32_t, uint64_t> nodeSize;
@@ -257,7 +257,13 @@ ParquetRowReader::ParquetRowReader(
       state_, std::move(columnIds), std::move(groups), &filters_);
 }
 
-uint64_t ParquetRowReader::next(uint64_t /*size*/, velox::VectorPtr& result) {
+uint64_t ParquetRowReader::next(
+    uint64_t /*size*/,
+    velox::VectorPtr& result,
+    const dwio::common::Mutation* mutation) {
+  VELOX_CHECK(
+      !mutation || !mutation->deletedRows,
+      "Deleted rows are not supported by the DuckDB Parquet reader");
   ::duckdb::DataChunk output;
   // TODO: We are using the default duckdb allocator which uses Velox's default
   // memory manager, not the one specified in the ReaderOptions.
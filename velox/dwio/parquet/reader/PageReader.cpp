@@ -44,6 +44,9 @@ void PageReader::seekToPage(int64_t row) {
       numRowsInPage_ = 0;
       break;
     }
+    if (row != kRepDefOnly) {
+      seekToPageByLocation(row);
+    }
     PageHeader pageHeader = readPageHeader();
     pageStart_ = pageDataStart_ + pageHeader.compressed_page_size;
 
@@ -75,6 +78,59 @@ void PageReader::seekToPage(int64_t row) {
   }
 }
 
+void PageReader::setPageLocations(
+    std::vector<thrift::PageLocation> locations,
+    int64_t chunkOffset) {
+  if (locations.empty() || locations[0].first_row_index != 0) {
+    return;
+  }
+  int64_t previousOffset = 0;
+  int64_t previousRow = 0;
+  for (auto& location : locations) {
+    location.offset -= chunkOffset;
+    if (location.offset < previousOffset || location.offset >= chunkSize_ ||
+        location.first_row_index < previousRow) {
+      return;
+    }
+    previousOffset = location.offset;
+    previousRow = location.first_row_index;
+  }
+  pageLocations_ = std::move(locations);
+}
+
+bool PageReader::seekToPageByLocation(int64_t row) {
+  // Row numbers in the OffsetIndex are top level rows. These are the same as
+  // the value numbers only if the column is not repeated.
+  if (pageLocations_.empty() || maxRepeat_ > 0 || hasChunkRepDefs_) {
+    return false;
+  }
+  // A dictionary page precedes the first data page and is not in the index.
+  // It is read before seeking beyond the first data page.
+  if (pageStart_ < pageLocations_[0].offset) {
+    return false;
+  }
+  auto it = std::upper_bound(
+      pageLocations_.begin(),
+      pageLocations_.end(),
+      row,
+      [](int64_t row, const thrift::PageLocation& location) {
+        return row < location.first_row_index;
+      });
+  VELOX_CHECK(it != pageLocations_.begin());
+  const auto& location = *(it - 1);
+  if (location.offset <= pageStart_) {
+    return false;
+  }
+  std::vector<uint64_t> position = {static_cast<uint64_t>(location.offset)};
+  dwio::common::PositionProvider positionProvider(position);
+  inputStream_->seekToPosition(positionProvider);
+  bufferStart_ = bufferEnd_ = nullptr;
+  pageStart_ = location.offset;
+  rowOfPage_ = location.first_row_index;
+  numRowsInPage_ = 0;
+  return true;
+}
+
 PageHeader PageReader::readPageHeader() {
   if (bufferEnd_ == bufferStart_) {
     const void* buffer;
@@ -587,6 +643,18 @@ void PageReader::decodeRepDefs(int32_t numTopLevelRows) {
   int32_t topFound = 0;
   int32_t i = repDefBegin_;
   if (maxRepeat_ > 0) {
+    // Counts the top level row starts a vector of repetition levels at a time
+    // and finishes the batch with the terminating row start one by one.
+    using Batch = xsimd::batch<int16_t>;
+    const auto* repetitionLevels = repetitionLevels_.data();
+    for (; i + Batch::size <= numLevels; i += Batch::size) {
+      auto numStarts = __builtin_popcount(simd::toBitMask(
+          Batch::load_unaligned(repetitionLevels + i) == Batch(0)));
+      if (topFound + numStarts > numTopLevelRows) {
+        break;
+      }
+      topFound += numStarts;
+    }
     for (; i < numLevels; ++i) {
       if (repetitionLevels_[i] == 0) {
         ++topFound;
@@ -623,6 +691,11 @@ int32_t PageReader::getLengthsAndNulls(
           definitionLevels_.data() + begin, end - begin, info, &bits);
       break;
     case LevelMode::kList: {
+      if (info.rep_level == 1 && maxRepeat_ == 1 && begin < end &&
+          repetitionLevels_[begin] == 0) {
+        return getSingleListLengthsAndNulls(
+            info, begin, end, maxItems, lengths, nulls, nullsStartIndex);
+      }
       ::parquet::internal::DefRepLevelsToList(
           definitionLevels_.data() + begin,
           repetitionLevels_.data() + begin,
@@ -649,6 +722,41 @@ int32_t PageReader::getLengthsAndNulls(
   return bits.values_read;
 }
 
+int32_t PageReader::getSingleListLengthsAndNulls(
+    const ::parquet::internal::LevelInfo& info,
+    int32_t begin,
+    int32_t end,
+    int32_t maxItems,
+    int32_t* lengths,
+    uint64_t* nulls,
+    int32_t nullsStartIndex) const {
+  // With a single repetition level every level either starts a list (rep 0)
+  // or appends an element to the last started one (rep 1), so lengths are
+  // produced directly instead of going through cumulative offsets. A started
+  // list has its first element if def reaches 'info.def_level', is empty at
+  // 'info.def_level' - 1 and null below that.
+  const auto* definitionLevels = definitionLevels_.data();
+  const auto* repetitionLevels = repetitionLevels_.data();
+  const int16_t elementLevel = info.def_level;
+  const int16_t emptyLevel = info.def_level - 1;
+  int32_t numLists = 0;
+  for (auto i = begin; i < end; ++i) {
+    const auto def = definitionLevels[i];
+    if (repetitionLevels[i] == 0) {
+      VELOX_CHECK_LT(
+          numLists, maxItems, "Definition levels exceeded upper bound");
+      lengths[numLists] = def >= elementLevel;
+      if (nulls) {
+        bits::setBit(nulls, nullsStartIndex + numLists, def >= emptyLevel);
+      }
+      ++numLists;
+    } else {
+      ++lengths[numLists - 1];
+    }
+  }
+  return numLists;
+}
+
 void PageReader::makeDecoder() {
   auto parquetType = type_->parquetType_.value();
   switch (encoding_) {
@@ -66,6 +66,16 @@ class PageReader {
         chunkSize_(chunkSize),
         nullConcatenation_(pool_) {}
 
+  /// Sets the locations of the data pages of the ColumnChunk from its
+  /// OffsetIndex. 'chunkOffset' is the offset of the first page of the
+  /// ColumnChunk in the file. Seeking forward by more than a page then
+  /// positions the stream at the page directly instead of reading the headers
+  /// of the pages in between. Ignores 'locations' that are not within the
+  /// ColumnChunk.
+  void setPageLocations(
+      std::vector<thrift::PageLocation> locations,
+      int64_t chunkOffset);
+
   /// Advances 'numRows' top level rows.
   void skip(int64_t numRows);
 
@@ -151,6 +161,18 @@ class PageReader {
   // Initializes a filter result cache for the dictionary in 'state'.
   void makeFilterCache(dwio::common::ScanState& state);
 
+  // Fast path of getLengthsAndNulls() in mode kList for a list that is the
+  // only repeated level of the column, e.g. array<primitive>. 'begin' must be
+  // the start of a top level row.
+  int32_t getSingleListLengthsAndNulls(
+      const ::parquet::internal::LevelInfo& info,
+      int32_t begin,
+      int32_t end,
+      int32_t maxItems,
+      int32_t* lengths,
+      uint64_t* nulls,
+      int32_t nullsStartIndex) const;
+
   // Makes a decoder based on 'encoding_' for bytes from ''pageData_' to
   // 'pageData_' + 'encodedDataSize_'.
   void makedecoder();
@@ -164,6 +186,12 @@ class PageReader {
   // allowed for non-top level columns.
   void seekToPage(int64_t row);
 
+  // Positions 'inputStream_' at the start of the page that contains
+  // 'row' using 'pageLocations_' if the page is after the next
+  // page. Sets 'pageStart_' and 'rowOfPage_' to refer to the
+  // page. Returns false if no seek was made.
+  bool seekToPageByLocation(int64_t row);
+
   // Preloads the repdefs for the column chunk. To avoid preloading,
   // would need a way too clone the input stream so that one stream
   // reads ahead for repdefs and the other tracks the data. This is
@@ -422,6 +450,11 @@ class PageReader {
   // Offset of first byte after current page' header.
   uint64_t pageDataStart_{0};
 
+  // Data page locations from the OffsetIndex of the ColumnChunk, with offsets
+  // relative to the start of the ColumnChunk. Empty if there is no
+  // OffsetIndex.
+  std::vector<thrift::PageLocation> pageLocations_;
+
   // Number of bytes starting at pageData_ for current encoded data.
   int32_t encodedDataSize_{0};
 
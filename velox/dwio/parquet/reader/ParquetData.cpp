@@ -21,10 +21,48 @@ namespace facebook::velox::parquet {
 
 using thrift::RowGroup;
 
+namespace {
+// Returns the offset of the first page of the column chunk of 'metaData' in
+// the file.
+uint64_t chunkReadOffset(const thrift::ColumnMetaData& metaData) {
+  uint64_t offset = metaData.data_page_offset;
+  if (metaData.__isset.dictionary_page_offset &&
+      metaData.dictionary_page_offset >= 4) {
+    // this assumes the data pages follow the dict pages directly.
+    offset = metaData.dictionary_page_offset;
+  }
+  VELOX_CHECK_GE(offset, 0);
+  return offset;
+}
+
+// Number of bytes read for the header of a Bloom filter. The header is
+// usually less than 20 bytes.
+constexpr int32_t kBloomFilterHeaderSizeGuess = 256;
+
+// The maximum size of a Bloom filter bitset according to the Parquet format.
+constexpr int32_t kMaxBloomFilterBytes = 128 << 20;
+
+template <typename T>
+T readThrift(dwio::common::SeekableInputStream& stream, int32_t length) {
+  std::vector<char> copy(length);
+  const char* bufferStart = nullptr;
+  const char* bufferEnd = nullptr;
+  dwio::common::readBytes(length, &stream, copy.data(), bufferStart, bufferEnd);
+  std::shared_ptr<thrift::ThriftTransport> transport =
+      std::make_shared<thrift::ThriftBufferedTransport>(copy.data(), length);
+  apache::thrift::protocol::TCompactProtocolT<thrift::ThriftTransport> protocol(
+      transport);
+  T result;
+  result.read(&protocol);
+  return result;
+}
+} // namespace
+
 std::unique_ptr<dwio::common::FormatData> ParquetParams::toFormatData(
     const std::shared_ptr<const dwio::common::TypeWithId>& type,
-    const common::ScanSpec& /*scanSpec*/) {
-  return std::make_unique<ParquetData>(type, metaData_.row_groups, pool());
+    const common::ScanSpec& scanSpec) {
+  return std::make_unique<ParquetData>(
+      type, metaData_.row_groups, scanSpec, pool());
 }
 
 void ParquetData::filterRowGroups(
@@ -82,6 +120,131 @@ bool ParquetData::rowGroupMatches(
   return true;
 }
 
+bool ParquetData::bloomFilterMatches(
+    uint32_t index,
+    dwio::common::BufferedInput& input) {
+  auto* filter = scanSpec_.filter();
+  if (!filter || filter->testNull() || !type_->parquetType_.has_value()) {
+    return true;
+  }
+  switch (type_->type->kind()) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      break;
+    default:
+      return true;
+  }
+  const auto& chunk = rowGroups_[index].columns[type_->column];
+  if (!chunk.__isset.meta_data ||
+      !chunk.meta_data.__isset.bloom_filter_offset) {
+    return true;
+  }
+  auto bloomFilter =
+      readBloomFilter(chunk.meta_data.bloom_filter_offset, input);
+  if (!bloomFilter) {
+    return true;
+  }
+  return bloomFilter->mayPass(*filter, type_->parquetType_.value());
+}
+
+std::unique_ptr<SplitBlockBloomFilter> ParquetData::readBloomFilter(
+    int64_t offset,
+    dwio::common::BufferedInput& input) {
+  const uint64_t fileLength = input.getReadFile()->size();
+  if (offset <= 0 || offset >= fileLength) {
+    return nullptr;
+  }
+  const int32_t headerReadSize =
+      std::min<uint64_t>(kBloomFilterHeaderSizeGuess, fileLength - offset);
+  auto stream =
+      input.read(offset, headerReadSize, dwio::common::LogType::STREAM);
+  std::vector<char> copy(headerReadSize);
+  const char* bufferStart = nullptr;
+  const char* bufferEnd = nullptr;
+  dwio::common::readBytes(
+      headerReadSize, stream.get(), copy.data(), bufferStart, bufferEnd);
+  std::shared_ptr<thrift::ThriftTransport> transport =
+      std::make_shared<thrift::ThriftBufferedTransport>(
+          copy.data(), headerReadSize);
+  apache::thrift::protocol::TCompactProtocolT<thrift::ThriftTransport> protocol(
+      transport);
+  thrift::BloomFilterHeader header;
+  const uint64_t headerSize = header.read(&protocol);
+  if (!header.algorithm.__isset.BLOCK || !header.hash.__isset.XXHASH ||
+      !header.compression.__isset.UNCOMPRESSED || header.numBytes <= 0 ||
+      header.numBytes > kMaxBloomFilterBytes ||
+      header.numBytes % SplitBlockBloomFilter::kBytesPerBlock != 0 ||
+      offset + headerSize + header.numBytes > fileLength) {
+    return nullptr;
+  }
+  stream = input.read(
+      offset + headerSize, header.numBytes, dwio::common::LogType::STREAM);
+  std::string bitset(header.numBytes, '\0');
+  bufferStart = nullptr;
+  bufferEnd = nullptr;
+  dwio::common::readBytes(
+      header.numBytes, stream.get(), bitset.data(), bufferStart, bufferEnd);
+  return std::make_unique<SplitBlockBloomFilter>(std::move(bitset));
+}
+
+bool ParquetData::usePageIndex() const {
+  return maxRepeat_ == 0;
+}
+
+// static
+std::vector<RowRange> ParquetData::filterPages(
+    common::Filter* filter,
+    const TypePtr& type,
+    const thrift::ColumnIndex& columnIndex,
+    const thrift::OffsetIndex& offsetIndex,
+    int64_t numRows) {
+  std::vector<RowRange> ranges;
+  const auto& locations = offsetIndex.page_locations;
+  const auto numPages = locations.size();
+  if (columnIndex.null_pages.size() != numPages ||
+      columnIndex.min_values.size() != numPages ||
+      columnIndex.max_values.size() != numPages ||
+      (columnIndex.__isset.null_counts &&
+       columnIndex.null_counts.size() != numPages)) {
+    return ranges;
+  }
+  for (auto i = 0; i < numPages; ++i) {
+    const int64_t begin = locations[i].first_row_index;
+    const int64_t end =
+        i + 1 < numPages ? locations[i + 1].first_row_index : numRows;
+    if (begin >= end || end > numRows) {
+      return {};
+    }
+    // The page statistics have the same layout as the column chunk
+    // statistics. A page with only nulls has no min and max values.
+    thrift::Statistics pageStats;
+    if (columnIndex.__isset.null_counts) {
+      pageStats.__set_null_count(columnIndex.null_counts[i]);
+    }
+    if (columnIndex.null_pages[i]) {
+      pageStats.__set_null_count(end - begin);
+    } else {
+      pageStats.__set_min_value(columnIndex.min_values[i]);
+      pageStats.__set_max_value(columnIndex.max_values[i]);
+    }
+    auto columnStats =
+        buildColumnStatisticsFromThrift(pageStats, *type, end - begin);
+    if (testFilter(filter, columnStats.get(), end - begin, type)) {
+      continue;
+    }
+    if (!ranges.empty() && ranges.back().end == begin) {
+      ranges.back().end = end;
+    } else {
+      ranges.push_back({begin, end});
+    }
+  }
+  return ranges;
+}
+
 void ParquetData::enqueueRowGroup(
     uint32_t index,
     dwio::common::BufferedInput& input) {
@@ -93,20 +256,32 @@ void ParquetData::enqueueRowGroup(
       type_->column);
   auto& metaData = chunk.meta_data;
 
-  uint64_t chunkReadOffset = metaData.data_page_offset;
-  if (metaData.__isset.dictionary_page_offset &&
-      metaData.dictionary_page_offset >= 4) {
-    // this assumes the data pages follow the dict pages directly.
-    chunkReadOffset = metaData.dictionary_page_offset;
-  }
-  VELOX_CHECK_GE(chunkReadOffset, 0);
-
   uint64_t readSize = (metaData.codec == thrift::CompressionCodec::UNCOMPRESSED)
       ? metaData.total_uncompressed_size
       : metaData.total_compressed_size;
 
   auto id = dwio::common::StreamIdentifier(type_->column);
-  streams_[index] = input.enqueue({chunkReadOffset, readSize}, &id);
+  streams_[index] = input.enqueue({chunkReadOffset(metaData), readSize}, &id);
+
+  if (!usePageIndex() || !chunk.__isset.offset_index_offset ||
+      chunk.offset_index_length <= 0) {
+    return;
+  }
+  // The OffsetIndex is used for seeking to a page without reading the headers
+  // of the pages in between. The ColumnIndex is only needed for filtering.
+  offsetIndexStreams_.resize(rowGroups_.size());
+  columnIndexStreams_.resize(rowGroups_.size());
+  offsetIndexStreams_[index] = input.enqueue(
+      {static_cast<uint64_t>(chunk.offset_index_offset),
+       static_cast<uint64_t>(chunk.offset_index_length)},
+      &id);
+  if (scanSpec_.filter() && chunk.__isset.column_index_offset &&
+      chunk.column_index_length > 0) {
+    columnIndexStreams_[index] = input.enqueue(
+        {static_cast<uint64_t>(chunk.column_index_offset),
+         static_cast<uint64_t>(chunk.column_index_length)},
+        &id);
+  }
 }
 
 dwio::common::PositionProvider ParquetData::seekToRowGroup(uint32_t index) {
@@ -120,6 +295,29 @@ dwio::common::PositionProvider ParquetData::seekToRowGroup(uint32_t index) {
       type_,
       metadata.codec,
       metadata.total_compressed_size);
+
+  prunedRowRanges_.clear();
+  if (index < offsetIndexStreams_.size() && offsetIndexStreams_[index]) {
+    auto& chunk = rowGroups_[index].columns[type_->column];
+    auto offsetIndex = readThrift<thrift::OffsetIndex>(
+        *offsetIndexStreams_[index], chunk.offset_index_length);
+    offsetIndexStreams_[index].reset();
+    if (columnIndexStreams_[index]) {
+      auto columnIndex = readThrift<thrift::ColumnIndex>(
+          *columnIndexStreams_[index], chunk.column_index_length);
+      columnIndexStreams_[index].reset();
+      if (auto* filter = scanSpec_.filter()) {
+        prunedRowRanges_ = filterPages(
+            filter,
+            type_->type,
+            columnIndex,
+            offsetIndex,
+            rowGroups_[index].num_rows);
+      }
+    }
+    reader_->setPageLocations(
+        std::move(offsetIndex.page_locations), chunkReadOffset(metadata));
+  }
   return dwio::common::PositionProvider(empty);
 }
 
@@ -22,6 +22,7 @@
 #include "velox/dwio/common/BufferedInput.h"
 #include "velox/dwio/common/ScanSpec.h"
 #include "velox/dwio/parquet/reader/PageReader.h"
+#include "velox/dwio/parquet/reader/SplitBlockBloomFilter.h"
 #include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
 #include "velox/dwio/parquet/thrift/ThriftTransport.h"
 
@@ -38,21 +39,35 @@ class ParquetParams : public dwio::common::FormatParams {
   const thrift::FileMetaData& metaData_;
 };
 
+/// A range of rows from 'begin' to 'end' (exclusive) from the start of a row
+/// group.
+struct RowRange {
+  int64_t begin;
+  int64_t end;
+
+  bool operator==(const RowRange& other) const {
+    return begin == other.begin && end == other.end;
+  }
+};
+
 /// Format-specific data created for each leaf column of a Parquet rowgroup.
 class ParquetData : public dwio::common::FormatData {
  public:
   ParquetData(
       const std::shared_ptr<const dwio::common::TypeWithId>& type,
       const std::vector<thrift::RowGroup>& rowGroups,
+      const common::ScanSpec& scanSpec,
       memory::MemoryPool& pool)
       : pool_(pool),
         type_(std::static_pointer_cast<const ParquetTypeWithId>(type)),
         rowGroups_(rowGroups),
+        scanSpec_(scanSpec),
         maxDefine_(type_->maxDefine_),
         maxRepeat_(type_->maxRepeat_),
         rowsInRowGroup_(-1) {}
 
-  /// Prepares to read data for 'index'th row group.
+  /// Prepares to read data for 'index'th row group. Also prepares to read the
+  /// page index of the column chunk if there is one.
   void enqueueRowGroup(uint32_t index, dwio::common::BufferedInput& input);
 
   /// Positions 'this' at 'index'th row group. enqueueRowGroup must be called
@@ -66,6 +81,31 @@ class ParquetData : public dwio::common::FormatData {
       const dwio::common::StatsContext& writerContext,
       FilterRowGroupsResult&) override;
 
+  /// Returns false if the Bloom filter of the column chunk in the 'index'th
+  /// row group shows that no value passes the filter of the column. Reads the
+  /// Bloom filter from 'input'. Returns true if there is no Bloom filter or
+  /// the filter can't be checked against it.
+  bool bloomFilterMatches(uint32_t index, dwio::common::BufferedInput& input);
+
+  /// Returns the ranges of rows of the row group given to the last
+  /// seekToRowGroup() for which the page index shows that the filter of the
+  /// column cannot pass. The ranges are ascending and do not overlap.
+  const std::vector<RowRange>& prunedRowRanges() const {
+    return prunedRowRanges_;
+  }
+
+  /// Returns the ranges of rows in the pages described by 'offsetIndex' and
+  /// 'columnIndex' where 'filter' cannot pass according to the min/max values
+  /// and null counts of the pages. Adjacent ranges are merged. 'numRows' is
+  /// the number of rows in the row group. Returns no ranges if the indices are
+  /// inconsistent.
+  static std::vector<RowRange> filterPages(
+      common::Filter* filter,
+      const TypePtr& type,
+      const thrift::ColumnIndex& columnIndex,
+      const thrift::OffsetIndex& offsetIndex,
+      int64_t numRows);
+
   PageReader* FOLLY_NONNULL reader() const {
     return reader_.get();
   }
@@ -176,14 +216,39 @@ class ParquetData : public dwio::common::FormatData {
   /// stats in 'rowGroup'.
   bool rowGroupMatches(uint32_t rowGroupId, common::Filter* filter);
 
+  // Reads the Bloom filter at 'offset' in 'input'. Returns nullptr if the
+  // Bloom filter is not a split block Bloom filter that is uncompressed and
+  // hashed with XXH64.
+  std::unique_ptr<SplitBlockBloomFilter> readBloomFilter(
+      int64_t offset,
+      dwio::common::BufferedInput& input);
+
+  // True if the page index of the column chunk may be used for seeking to
+  // pages and for filtering pages. This is limited to top level columns,
+  // where the row numbers in the index are the same as the value numbers.
+  bool usePageIndex() const;
+
  protected:
   memory::MemoryPool& pool_;
   std::shared_ptr<const ParquetTypeWithId> type_;
   const std::vector<thrift::RowGroup>& rowGroups_;
+  const common::ScanSpec& scanSpec_;
   // Streams for this column in each of 'rowGroups_'. Will be created on or
   // ahead of first use, not at construction.
   std::vector<std::unique_ptr<dwio::common::SeekableInputStream>> streams_;
 
+  // Streams for the OffsetIndex and ColumnIndex of this column in each of
+  // 'rowGroups_'. Not set if the file has no page index or if it is not
+  // needed.
+  std::vector<std::unique_ptr<dwio::common::SeekableInputStream>>
+      offsetIndexStreams_;
+  std::vector<std::unique_ptr<dwio::common::SeekableInputStream>>
+      columnIndexStreams_;
+
+  // Ranges of rows in the current row group that do not pass the filter
+  // according to the page index.
+  std::vector<RowRange> prunedRowRanges_;
+
   const uint32_t maxDefine_;
   const uint32_t maxRepeat_;
   int64_t rowsInRowGroup_;
@@ -16,6 +16,7 @@
 
 #include "velox/dwio/parquet/reader/ParquetReader.h"
 #include <thrift/protocol/TCompactProtocol.h> //@manual
+#include "velox/dwio/common/FileMetadataCache.h"
 #include "velox/dwio/common/MetricsLog.h"
 #include "velox/dwio/common/TypeUtils.h"
 #include "velox/dwio/parquet/reader/StructColumnReader.h"
@@ -23,6 +24,26 @@
 
 namespace facebook::velox::parquet {
 
+namespace {
+
+// The parsed footer of a file in the FileMetadataCache.
+struct ParquetFileMetadata : public dwio::common::FileMetadata {
+  ParquetFileMetadata(
+      std::shared_ptr<const thrift::FileMetaData> metadata,
+      uint64_t footerLength)
+      : metadata(std::move(metadata)), footerLength(footerLength) {}
+
+  // The Thrift structs take about twice the size of their compact encoding.
+  uint64_t memoryUsage() const override {
+    return sizeof(ParquetFileMetadata) + 2 * footerLength;
+  }
+
+  const std::shared_ptr<const thrift::FileMetaData> metadata;
+  const uint64_t footerLength;
+};
+
+} // namespace
+
 ReaderBase::ReaderBase(
     std::unique_ptr<dwio::common::BufferedInput> input,
     const dwio::common::ReaderOptions& options)
@@ -40,6 +61,18 @@ ReaderBase::ReaderBase(
 }
 
 void ReaderBase::loadFileMetaData() {
+  auto& metadataCache = dwio::common::FileMetadataCache::instance();
+  const auto cacheKey = metadataCache.enabled()
+      ? dwio::common::FileMetadataCache::key(*input_->getReadFile())
+      : std::nullopt;
+  if (cacheKey.has_value()) {
+    if (auto cached = std::dynamic_pointer_cast<const ParquetFileMetadata>(
+            metadataCache.get(cacheKey.value()))) {
+      fileMetaData_ = cached->metadata;
+      return;
+    }
+  }
+
   bool preloadFile_ = fileLength_ <= filePreloadThreshold_;
   uint64_t readSize =
       preloadFile_ ? fileLength_ : std::min(fileLength_, directorySizeGuess_);
@@ -81,8 +114,14 @@ void ReaderBase::loadFileMetaData() {
   auto thriftProtocol = std::make_unique<
       apache::thrift::protocol::TCompactProtocolT<thrift::ThriftTransport>>(
       thriftTransport);
-  fileMetaData_ = std::make_unique<thrift::FileMetaData>();
-  fileMetaData_->read(thriftProtocol.get());
+  auto fileMetaData = std::make_shared<thrift::FileMetaData>();
+  fileMetaData->read(thriftProtocol.get());
+  fileMetaData_ = fileMetaData;
+  if (cacheKey.has_value()) {
+    metadataCache.put(
+        cacheKey.value(),
+        std::make_shared<ParquetFileMetadata>(fileMetaData_, footerLength));
+  }
 }
 
 void ReaderBase::initializeSchema() {
@@ -553,6 +592,11 @@ void ParquetRowReader::filterRowGroups() {
     if (rowGroupInRange) {
       if (i < res.totalCount && bits::isBitSet(res.filterResult.data(), i)) {
         ++skippedRowGroups_;
+      } else if (!dynamic_cast<StructColumnReader&>(*columnReader_)
+                      .bloomFiltersMatch(i, readerBase_->bufferedInput())) {
+        // The Bloom filters are only read for the row groups that pass the
+        // statistics.
+        ++skippedRowGroups_;
       } else {
         rowGroupIds_.push_back(i);
       }
@@ -560,24 +604,47 @@ void ParquetRowReader::filterRowGroups() {
   }
 }
 
-uint64_t ParquetRowReader::next(uint64_t size, velox::VectorPtr& result) {
-  VELOX_CHECK_GT(size, 0);
-
-  if (currentRowInGroup_ >= rowsInCurrentRowGroup_) {
-    // attempt to advance to next row group
-    if (!advanceToNextRowGroup()) {
-      return 0;
+int64_t ParquetRowReader::nextRowNumber() {
+  for (;;) {
+    if (currentRowInGroup_ >= rowsInCurrentRowGroup_) {
+      // attempt to advance to next row group
+      if (!advanceToNextRowGroup()) {
+        return kAtEnd;
+      }
+    }
+    skipPrunedRows();
+    if (currentRowInGroup_ < rowsInCurrentRowGroup_) {
+      return firstRowOfRowGroup_ + currentRowInGroup_;
     }
   }
+}
 
+int64_t ParquetRowReader::nextReadSize(uint64_t size) {
+  VELOX_CHECK_GT(size, 0);
+  if (nextRowNumber() == kAtEnd) {
+    return kAtEnd;
+  }
   uint64_t rowsToRead = std::min(
       static_cast<uint64_t>(size), rowsInCurrentRowGroup_ - currentRowInGroup_);
-
-  if (rowsToRead > 0) {
-    columnReader_->next(rowsToRead, result, nullptr);
-    currentRowInGroup_ += rowsToRead;
+  if (nextPrunedRange_ < prunedRowRanges_.size()) {
+    // Stop at the next range of rows that can be skipped.
+    rowsToRead = std::min<uint64_t>(
+        rowsToRead,
+        prunedRowRanges_[nextPrunedRange_].begin - currentRowInGroup_);
   }
+  return rowsToRead;
+}
 
+uint64_t ParquetRowReader::next(
+    uint64_t size,
+    velox::VectorPtr& result,
+    const dwio::common::Mutation* mutation) {
+  const auto rowsToRead = nextReadSize(size);
+  if (rowsToRead == kAtEnd) {
+    return 0;
+  }
+  columnReader_->next(rowsToRead, result, mutation);
+  currentRowInGroup_ += rowsToRead;
   return rowsToRead;
 }
 
@@ -593,15 +660,45 @@ bool ParquetRowReader::advanceToNextRowGroup() {
       dynamic_cast<StructColumnReader&>(*columnReader_));
   currentRowGroupPtr_ = &rowGroups_[rowGroupIds_[currentRowGroupIdsIdx_]];
   rowsInCurrentRowGroup_ = currentRowGroupPtr_->num_rows;
+  firstRowOfRowGroup_ = 0;
+  for (uint32_t i = 0; i < nextRowGroupIndex; ++i) {
+    firstRowOfRowGroup_ += rowGroups_[i].num_rows;
+  }
   currentRowInGroup_ = 0;
   currentRowGroupIdsIdx_++;
   columnReader_->seekToRowGroup(nextRowGroupIndex);
+  prunedRowRanges_ =
+      dynamic_cast<StructColumnReader&>(*columnReader_).prunedRowRanges();
+  nextPrunedRange_ = 0;
   return true;
 }
 
+void ParquetRowReader::skipPrunedRows() {
+  if (nextPrunedRange_ == prunedRowRanges_.size()) {
+    return;
+  }
+  const auto& range = prunedRowRanges_[nextPrunedRange_];
+  if (range.begin > currentRowInGroup_) {
+    return;
+  }
+  VELOX_CHECK_EQ(range.begin, currentRowInGroup_);
+  ++nextPrunedRange_;
+  skippedPageRows_ += range.end - range.begin;
+  currentRowInGroup_ = range.end;
+  if (currentRowInGroup_ < rowsInCurrentRowGroup_) {
+    // The pages of the columns in the range are not decompressed or decoded.
+    columnReader_->seekTo(currentRowInGroup_, false);
+  }
+}
+
 void ParquetRowReader::updateRuntimeStats(
     dwio::common::RuntimeStatistics& stats) const {
   stats.skippedStrides += skippedRowGroups_;
+  stats.skippedPageRows += skippedPageRows_;
+  if (columnReader_) {
+    dynamic_cast<const StructColumnReader&>(*columnReader_)
+        .updateRuntimeStats(stats);
+  }
 }
 
 void ParquetRowReader::resetFilterCaches() {
@@ -625,4 +722,30 @@ std::unique_ptr<dwio::common::RowReader> ParquetReader::createRowReader(
     const dwio::common::RowReaderOptions& options) const {
   return std::make_unique<ParquetRowReader>(readerBase_, options);
 }
+
+std::vector<dwio::common::FileStripe> ParquetReader::stripes() const {
+  const auto& rowGroups = readerBase_->fileMetaData().row_groups;
+  std::vector<dwio::common::FileStripe> result;
+  result.reserve(rowGroups.size());
+  for (const auto& rowGroup : rowGroups) {
+    VELOX_CHECK_GT(rowGroup.columns.size(), 0);
+    // Same offset as ParquetRowReader uses to assign row groups to splits.
+    auto offset = rowGroup.__isset.file_offset
+        ? rowGroup.file_offset
+        : rowGroup.columns[0].file_offset;
+    int64_t length = 0;
+    if (rowGroup.__isset.total_compressed_size) {
+      length = rowGroup.total_compressed_size;
+    } else {
+      for (const auto& column : rowGroup.columns) {
+        length += column.meta_data.total_compressed_size;
+      }
+    }
+    result.push_back(
+        {static_cast<uint64_t>(offset),
+         static_cast<uint64_t>(length),
+         static_cast<uint64_t>(rowGroup.num_rows)});
+  }
+  return result;
+}
 } // namespace facebook::velox::parquet
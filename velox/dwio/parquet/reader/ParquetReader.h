@@ -20,6 +20,7 @@
 #include "velox/dwio/common/Reader.h"
 #include "velox/dwio/common/ReaderFactory.h"
 #include "velox/dwio/common/SelectiveColumnReader.h"
+#include "velox/dwio/parquet/reader/ParquetData.h"
 #include "velox/dwio/parquet/reader/ParquetTypeWithId.h"
 #include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
 
@@ -105,7 +106,8 @@ class ReaderBase {
   const dwio::common::ReaderOptions& options_;
   std::unique_ptr<velox::dwio::common::BufferedInput> input_;
   uint64_t fileLength_;
-  std::unique_ptr<thrift::FileMetaData> fileMetaData_;
+  // Shared with the other readers of the file through the FileMetadataCache.
+  std::shared_ptr<const thrift::FileMetaData> fileMetaData_;
   RowTypePtr schema_;
   std::shared_ptr<const dwio::common::TypeWithId> schemaWithId_;
 
@@ -124,7 +126,14 @@ class ParquetRowReader : public dwio::common::RowReader {
       const dwio::common::RowReaderOptions& options);
   ~ParquetRowReader() override = default;
 
-  uint64_t next(uint64_t size, velox::VectorPtr& result) override;
+  uint64_t next(
+      uint64_t size,
+      velox::VectorPtr& result,
+      const dwio::common::Mutation* mutation = nullptr) override;
+
+  int64_t nextRowNumber() override;
+
+  int64_t nextReadSize(uint64_t size) override;
 
   void updateRuntimeStats(
       dwio::common::RuntimeStatistics& stats) const override;
@@ -151,6 +160,9 @@ class ParquetRowReader : public dwio::common::RowReader {
   // by filterRowGroups().
   bool advanceToNextRowGroup();
 
+  // Skips the rows at the current position that are in 'prunedRowRanges_'.
+  void skipPrunedRows();
+
   memory::MemoryPool& pool_;
   const std::shared_ptr<ReaderBase> readerBase_;
   const dwio::common::RowReaderOptions& options_;
@@ -164,10 +176,22 @@ class ParquetRowReader : public dwio::common::RowReader {
   const thrift::RowGroup* FOLLY_NULLABLE currentRowGroupPtr_{nullptr};
   uint64_t rowsInCurrentRowGroup_;
   uint64_t currentRowInGroup_;
+  // Row number in the file of the first row of the current row group.
+  int64_t firstRowOfRowGroup_{0};
 
   // Number of row groups skipped based on stats.
   int32_t skippedRowGroups_{0};
 
+  // Ranges of rows in the current row group that can be skipped based on the
+  // page indices of the filtered columns.
+  std::vector<RowRange> prunedRowRanges_;
+
+  // Index of the first range in 'prunedRowRanges_' that is not skipped yet.
+  size_t nextPrunedRange_{0};
+
+  // Number of rows skipped based on page stats.
+  int64_t skippedPageRows_{0};
+
   std::unique_ptr<dwio::common::SelectiveColumnReader> columnReader_;
 
   RowTypePtr requestedType_;
@@ -203,6 +227,8 @@ class ParquetReader : public dwio::common::Reader {
   std::unique_ptr<dwio::common::RowReader> createRowReader(
       const dwio::common::RowReaderOptions& options = {}) const override;
 
+  std::vector<dwio::common::FileStripe> stripes() const override;
+
  private:
   std::shared_ptr<ReaderBase> readerBase_;
 };
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/SplitBlockBloomFilter.h"
+
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
+namespace facebook::velox::parquet {
+
+namespace {
+// The salts for setting the bit in each word of a block, from the Parquet
+// format specification.
+constexpr uint32_t kSalt[] = {
+    0x47b6137bU,
+    0x44974d91U,
+    0x8824ad5bU,
+    0xa2b7289dU,
+    0x705495c7U,
+    0x2df1424bU,
+    0x9efc4947U,
+    0x5c6bfb31U};
+} // namespace
+
+SplitBlockBloomFilter::SplitBlockBloomFilter(std::string bitset)
+    : bitset_(std::move(bitset)), numBlocks_(bitset_.size() / kBytesPerBlock) {
+  VELOX_CHECK_GT(numBlocks_, 0);
+  VELOX_CHECK_EQ(bitset_.size() % kBytesPerBlock, 0);
+}
+
+void SplitBlockBloomFilter::insert(uint64_t hash) {
+  auto* block = reinterpret_cast<uint32_t*>(bitset_.data() + blockOffset(hash));
+  const auto key = static_cast<uint32_t>(hash);
+  for (auto i = 0; i < kWordsPerBlock; ++i) {
+    block[i] |= 1U << ((key * kSalt[i]) >> 27);
+  }
+}
+
+bool SplitBlockBloomFilter::mayContain(uint64_t hash) const {
+  const auto* block =
+      reinterpret_cast<const uint32_t*>(bitset_.data() + blockOffset(hash));
+  const auto key = static_cast<uint32_t>(hash);
+  for (auto i = 0; i < kWordsPerBlock; ++i) {
+    if (!(block[i] & (1U << ((key * kSalt[i]) >> 27)))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// static
+uint64_t SplitBlockBloomFilter::hashInt32(int32_t value) {
+  return XXH64(&value, sizeof(value), 0);
+}
+
+// static
+uint64_t SplitBlockBloomFilter::hashInt64(int64_t value) {
+  return XXH64(&value, sizeof(value), 0);
+}
+
+// static
+uint64_t SplitBlockBloomFilter::hashBytes(const char* data, size_t size) {
+  return XXH64(data, size, 0);
+}
+
+bool SplitBlockBloomFilter::mayContainInt(
+    int64_t value,
+    thrift::Type::type physicalType) const {
+  if (physicalType == thrift::Type::INT64) {
+    return mayContain(hashInt64(value));
+  }
+  if (value < std::numeric_limits<int32_t>::min() ||
+      value > std::numeric_limits<int32_t>::max()) {
+    // The value can't occur in an INT32 column.
+    return false;
+  }
+  return mayContain(hashInt32(value));
+}
+
+bool SplitBlockBloomFilter::mayPass(
+    const common::Filter& filter,
+    thrift::Type::type physicalType) const {
+  if (filter.testNull()) {
+    return true;
+  }
+  const bool isInt = physicalType == thrift::Type::INT32 ||
+      physicalType == thrift::Type::INT64;
+  const bool isBytes = physicalType == thrift::Type::BYTE_ARRAY ||
+      physicalType == thrift::Type::FIXED_LEN_BYTE_ARRAY;
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange: {
+      auto* range = static_cast<const common::BigintRange*>(&filter);
+      if (!isInt || !range->isSingleValue()) {
+        return true;
+      }
+      return mayContainInt(range->lower(), physicalType);
+    }
+    case common::FilterKind::kBigintValuesUsingHashTable: {
+      if (!isInt) {
+        return true;
+      }
+      auto* values =
+          static_cast<const common::BigintValuesUsingHashTable*>(&filter);
+      for (auto value : values->values()) {
+        if (mayContainInt(value, physicalType)) {
+          return true;
+        }
+      }
+      return false;
+    }
+    case common::FilterKind::kBigintValuesUsingBitmask: {
+      if (!isInt) {
+        return true;
+      }
+      auto* values =
+          static_cast<const common::BigintValuesUsingBitmask*>(&filter);
+      for (auto value : values->values()) {
+        if (mayContainInt(value, physicalType)) {
+          return true;
+        }
+      }
+      return false;
+    }
+    case common::FilterKind::kBytesRange: {
+      auto* range = static_cast<const common::BytesRange*>(&filter);
+      if (!isBytes || !range->isSingleValue()) {
+        return true;
+      }
+      const auto& value = range->lower();
+      return mayContain(hashBytes(value.data(), value.size()));
+    }
+    case common::FilterKind::kBytesValues: {
+      if (!isBytes) {
+        return true;
+      }
+      auto* values = static_cast<const common::BytesValues*>(&filter);
+      for (const auto& value : values->values()) {
+        if (mayContain(hashBytes(value.data(), value.size()))) {
+          return true;
+        }
+      }
+      return false;
+    }
+    default:
+      return true;
+  }
+}
+
+} // namespace facebook::velox::parquet
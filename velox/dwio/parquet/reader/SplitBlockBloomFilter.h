@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
+#include "velox/type/Filter.h"
+
+namespace facebook::velox::parquet {
+
+/// Split block Bloom filter of a Parquet column chunk. The bitset consists of
+/// 256-bit blocks of eight 32-bit words. A value sets one bit in each word of
+/// one block. Values are hashed with XXH64 with seed 0 over their plain
+/// encoding.
+class SplitBlockBloomFilter {
+ public:
+  static constexpr int32_t kBytesPerBlock = 32;
+
+  /// Makes a filter over 'bitset'. The size of 'bitset' must be a positive
+  /// multiple of kBytesPerBlock.
+  explicit SplitBlockBloomFilter(std::string bitset);
+
+  /// Adds the value with 'hash' to the filter.
+  void insert(uint64_t hash);
+
+  /// Returns false if no value with 'hash' has been added to the filter.
+  bool mayContain(uint64_t hash) const;
+
+  /// Returns false if no value in the filter passes 'filter', given that the
+  /// values of the column are of 'physicalType'. Only equality and IN filters
+  /// over integers and strings are checked, for other filters returns true.
+  bool mayPass(
+      const common::Filter& filter,
+      thrift::Type::type physicalType) const;
+
+  static uint64_t hashInt32(int32_t value);
+
+  static uint64_t hashInt64(int64_t value);
+
+  static uint64_t hashBytes(const char* data, size_t size);
+
+  const std::string& bitset() const {
+    return bitset_;
+  }
+
+ private:
+  static constexpr int32_t kWordsPerBlock = 8;
+
+  // Returns true if the value of 'value' may be in the filter for a column of
+  // 'physicalType'.
+  bool mayContainInt(int64_t value, thrift::Type::type physicalType) const;
+
+  // Returns the offset of the first byte of the block for 'hash' in
+  // 'bitset_'.
+  uint64_t blockOffset(uint64_t hash) const {
+    return (((hash >> 32) * numBlocks_) >> 32) * kBytesPerBlock;
+  }
+
+  std::string bitset_;
+  const uint32_t numBlocks_;
+};
+
+} // namespace facebook::velox::parquet
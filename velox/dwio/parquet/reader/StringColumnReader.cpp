@@ -80,6 +80,10 @@ void StringColumnReader::processFilter(
       readHelper<common::NegatedBytesValues, isDense>(
           filter, rows, extractValues);
       break;
+    case common::FilterKind::kHashBloomFilter:
+      readHelper<common::HashBloomFilter, isDense>(
+          filter, rows, extractValues);
+      break;
     default:
       readHelper<common::Filter, isDense>(filter, rows, extractValues);
       break;
@@ -139,6 +143,10 @@ void StringColumnReader::getValues(RowSet rows, VectorPtr* result) {
         numValues_,
         dictionaryValues,
         values_);
+    if (scanSpec_->makeFlat()) {
+      BaseVector::ensureWritable(
+          SelectivityVector::empty(), (*result)->type(), &memoryPool_, *result);
+    }
     return;
   }
   rawStringBuffer_ = nullptr;
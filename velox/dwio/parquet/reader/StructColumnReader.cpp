@@ -160,6 +160,53 @@ void StructColumnReader::setNullsFromRepDefs(PageReader& pageReader) {
   formatData_->as<ParquetData>().setNulls(nullsInReadRange(), numStructs);
 }
 
+bool StructColumnReader::bloomFiltersMatch(
+    uint32_t index,
+    dwio::common::BufferedInput& input) const {
+  for (const auto& child : children_) {
+    if (auto structChild = dynamic_cast<StructColumnReader*>(child)) {
+      if (!structChild->bloomFiltersMatch(index, input)) {
+        return false;
+      }
+    } else if (child->type()->isPrimitiveType()) {
+      auto& data = child->formatData().as<ParquetData>();
+      if (!data.bloomFilterMatches(index, input)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+std::vector<RowRange> StructColumnReader::prunedRowRanges() const {
+  std::vector<RowRange> ranges;
+  for (const auto& child : children_) {
+    if (!child->type()->isPrimitiveType()) {
+      return {};
+    }
+    const auto& childRanges =
+        child->formatData().as<ParquetData>().prunedRowRanges();
+    ranges.insert(ranges.end(), childRanges.begin(), childRanges.end());
+  }
+  if (ranges.empty()) {
+    return ranges;
+  }
+  // A row can be skipped if any of the filters fails on it.
+  std::sort(
+      ranges.begin(), ranges.end(), [](const auto& left, const auto& right) {
+        return left.begin < right.begin;
+      });
+  std::vector<RowRange> merged = {ranges[0]};
+  for (auto i = 1; i < ranges.size(); ++i) {
+    if (ranges[i].begin <= merged.back().end) {
+      merged.back().end = std::max(merged.back().end, ranges[i].end);
+    } else {
+      merged.push_back(ranges[i]);
+    }
+  }
+  return merged;
+}
+
 void StructColumnReader::filterRowGroups(
     uint64_t rowGroupSize,
     const dwio::common::StatsContext& context,
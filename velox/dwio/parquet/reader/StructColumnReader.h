@@ -57,6 +57,20 @@ class StructColumnReader : public dwio::common::SelectiveStructColumnReader {
   /// positioned at the end of the last set of nulls/lengths.
   void seekToEndOfPresetNulls();
 
+  /// Returns false if the Bloom filter of a filtered primitive type child
+  /// shows that no row in the 'index'th row group passes. Reads the Bloom
+  /// filters from 'input'.
+  bool bloomFiltersMatch(
+      uint32_t index,
+      dwio::common::BufferedInput& input) const;
+
+  /// Returns the ranges of rows in the current row group that no child filter
+  /// can pass according to the page indices of the children. The ranges are
+  /// ascending and do not overlap. Returns no ranges if a child is not a
+  /// primitive type column since skipping needs to be coordinated with
+  /// repdefs for these.
+  std::vector<RowRange> prunedRowRanges() const;
+
   void filterRowGroups(
       uint64_t rowGroupSize,
       const dwio::common::StatsContext&,
@@ -193,3 +193,94 @@ TEST_F(ParquetReaderTest, parseIntDecimal) {
     EXPECT_EQ(b[index + 1].unscaledValue(), expectValues[i]);
   }
 }
+
+TEST_F(ParquetReaderTest, filterPages) {
+  // A BIGINT column chunk of 400 rows in 4 pages of 100 rows. The last page
+  // is all nulls.
+  auto encode = [](int64_t value) {
+    return std::string(reinterpret_cast<const char*>(&value), sizeof(value));
+  };
+  thrift::OffsetIndex offsetIndex;
+  thrift::ColumnIndex columnIndex;
+  std::vector<std::pair<int64_t, int64_t>> minMax = {
+      {0, 9}, {10, 15}, {30, 40}};
+  for (auto i = 0; i < 4; ++i) {
+    thrift::PageLocation location;
+    location.__set_offset(1000 * i);
+    location.__set_compressed_page_size(1000);
+    location.__set_first_row_index(100 * i);
+    offsetIndex.page_locations.push_back(location);
+    const bool nullPage = i == 3;
+    columnIndex.null_pages.push_back(nullPage);
+    columnIndex.min_values.push_back(nullPage ? "" : encode(minMax[i].first));
+    columnIndex.max_values.push_back(nullPage ? "" : encode(minMax[i].second));
+  }
+  columnIndex.__set_null_counts({0, 0, 0, 100});
+
+  common::BigintRange range(10, 20, false);
+  EXPECT_EQ(
+      ParquetData::filterPages(&range, BIGINT(), columnIndex, offsetIndex, 400),
+      (std::vector<RowRange>{{0, 100}, {200, 400}}));
+
+  common::IsNull isNull;
+  EXPECT_EQ(
+      ParquetData::filterPages(
+          &isNull, BIGINT(), columnIndex, offsetIndex, 400),
+      (std::vector<RowRange>{{0, 300}}));
+
+  common::BigintRange anyValue(0, 100, true);
+  EXPECT_TRUE(ParquetData::filterPages(
+                  &anyValue, BIGINT(), columnIndex, offsetIndex, 400)
+                  .empty());
+
+  // Inconsistent indices are ignored.
+  columnIndex.min_values.pop_back();
+  EXPECT_TRUE(
+      ParquetData::filterPages(&range, BIGINT(), columnIndex, offsetIndex, 400)
+          .empty());
+}
+
+TEST_F(ParquetReaderTest, splitBlockBloomFilter) {
+  SplitBlockBloomFilter bloomFilter(std::string(1024, '\0'));
+  for (int64_t i = 0; i < 100; ++i) {
+    bloomFilter.insert(SplitBlockBloomFilter::hashInt64(i * 7));
+  }
+  bloomFilter.insert(SplitBlockBloomFilter::hashBytes("apple", 5));
+  for (int64_t i = 0; i < 100; ++i) {
+    EXPECT_TRUE(
+        bloomFilter.mayContain(SplitBlockBloomFilter::hashInt64(i * 7)));
+  }
+
+  auto int64Type = thrift::Type::INT64;
+  EXPECT_TRUE(
+      bloomFilter.mayPass(common::BigintRange(14, 14, false), int64Type));
+  EXPECT_FALSE(
+      bloomFilter.mayPass(common::BigintRange(1000, 1000, false), int64Type));
+  // Nulls and ranges are not checked.
+  EXPECT_TRUE(
+      bloomFilter.mayPass(common::BigintRange(1000, 1000, true), int64Type));
+  EXPECT_TRUE(
+      bloomFilter.mayPass(common::BigintRange(1000, 2000, false), int64Type));
+
+  EXPECT_TRUE(bloomFilter.mayPass(
+      common::BigintValuesUsingHashTable(1, 2000, {1, 1000, 2000, 21}, false),
+      int64Type));
+  EXPECT_FALSE(bloomFilter.mayPass(
+      common::BigintValuesUsingHashTable(1, 2000, {1, 1000, 2000}, false),
+      int64Type));
+  // The values are hashed as 32 bit integers for an INT32 column.
+  EXPECT_FALSE(bloomFilter.mayPass(
+      common::BigintRange(14, 14, false), thrift::Type::INT32));
+
+  auto bytesType = thrift::Type::BYTE_ARRAY;
+  EXPECT_TRUE(bloomFilter.mayPass(
+      common::BytesValues({"apple", "banana"}, false), bytesType));
+  EXPECT_FALSE(bloomFilter.mayPass(
+      common::BytesValues({"cherry", "banana"}, false), bytesType));
+  EXPECT_FALSE(bloomFilter.mayPass(
+      common::BytesRange("cherry", false, false, "cherry", false, false, false),
+      bytesType));
+  // An integer filter is not checked against a string column.
+  EXPECT_TRUE(
+      bloomFilter.mayPass(common::BigintRange(1000, 1000, false), bytesType));
+}
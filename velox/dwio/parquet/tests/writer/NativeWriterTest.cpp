@@ -0,0 +1,361 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/dwio/parquet/writer/NativeWriter.h"
+
+#include <thrift/protocol/TCompactProtocol.h>
+
+#include "velox/dwio/parquet/reader/ParquetReader.h"
+#include "velox/dwio/parquet/reader/SplitBlockBloomFilter.h"
+#include "velox/dwio/parquet/tests/ParquetReaderTestBase.h"
+#include "velox/dwio/parquet/thrift/ThriftTransport.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::common;
+using namespace facebook::velox::dwio::common;
+using namespace facebook::velox::dwio::parquet;
+using namespace facebook::velox::parquet;
+
+class NativeWriterTest : public ParquetReaderTestBase {
+ protected:
+  // Writes 'batches' and returns the file.
+  std::string write(
+      const std::vector<RowVectorPtr>& batches,
+      int32_t rowsInRowGroup,
+      NativeWriterOptions options = {}) {
+    auto sink = std::make_unique<MemorySink>(*pool_, 64 << 20);
+    auto* sinkPtr = sink.get();
+    NativeWriter writer(
+        std::move(sink), *pool_, rowsInRowGroup, std::move(options));
+    for (const auto& batch : batches) {
+      writer.write(batch);
+    }
+    writer.close();
+    return std::string(sinkPtr->getData(), sinkPtr->size());
+  }
+
+  std::unique_ptr<ParquetReader> makeReader(const std::string& file) {
+    ReaderOptions readerOptions{pool_.get()};
+    return std::make_unique<ParquetReader>(
+        std::make_unique<BufferedInput>(
+            std::make_shared<InMemoryReadFile>(file),
+            readerOptions.getMemoryPool()),
+        readerOptions);
+  }
+
+  void assertRoundTrip(const std::string& file, const RowVectorPtr& expected) {
+    auto reader = makeReader(file);
+    EXPECT_EQ(reader->numberOfRows(), expected->size());
+    auto rowType = asRowType(expected->type());
+    auto rowReaderOpts = getReaderOpts(rowType);
+    rowReaderOpts.setScanSpec(makeScanSpec(rowType));
+    auto rowReader = reader->createRowReader(rowReaderOpts);
+    assertReadExpected(*rowReader, expected);
+  }
+
+  static thrift::FileMetaData readFooter(const std::string& file) {
+    uint32_t length;
+    memcpy(&length, file.data() + file.size() - 8, sizeof(length));
+    EXPECT_EQ(file.substr(0, 4), "PAR1");
+    EXPECT_EQ(file.substr(file.size() - 4), "PAR1");
+    std::shared_ptr<thrift::ThriftTransport> transport =
+        std::make_shared<thrift::ThriftBufferedTransport>(
+            file.data() + file.size() - 8 - length, length);
+    apache::thrift::protocol::TCompactProtocolT<thrift::ThriftTransport>
+        protocol(transport);
+    thrift::FileMetaData metaData;
+    metaData.read(&protocol);
+    return metaData;
+  }
+
+  // Reads a thrift object of at most 'size' bytes at 'offset'. Sets
+  // 'readSize' to the size of the object if not null.
+  template <typename T>
+  static T readThrift(
+      const std::string& file,
+      int64_t offset,
+      int64_t size,
+      uint32_t* readSize = nullptr) {
+    std::shared_ptr<thrift::ThriftTransport> transport =
+        std::make_shared<thrift::ThriftBufferedTransport>(
+            file.data() + offset, size);
+    apache::thrift::protocol::TCompactProtocolT<thrift::ThriftTransport>
+        protocol(transport);
+    T object;
+    const auto objectSize = object.read(&protocol);
+    if (readSize) {
+      *readSize = objectSize;
+    }
+    return object;
+  }
+
+  static bool hasEncoding(
+      const thrift::ColumnMetaData& metaData,
+      thrift::Encoding::type encoding) {
+    return std::find(
+               metaData.encodings.begin(),
+               metaData.encodings.end(),
+               encoding) != metaData.encodings.end();
+  }
+
+  RowVectorPtr makeData(vector_size_t size) {
+    auto isNull = [](auto row) { return row % 11 == 0; };
+    return vectorMaker_->rowVector(
+        {"b", "t", "s", "i", "l", "r", "d", "v", "date"},
+        {
+            vectorMaker_->flatVector<bool>(
+                size, [](auto row) { return row % 3 == 0; }, isNull),
+            vectorMaker_->flatVector<int8_t>(
+                size, [](auto row) { return row % 100; }, isNull),
+            vectorMaker_->flatVector<int16_t>(
+                size, [](auto row) { return row * 3; }, isNull),
+            vectorMaker_->flatVector<int32_t>(
+                size, [](auto row) { return row * 7 - 1000; }, isNull),
+            vectorMaker_->flatVector<int64_t>(
+                size, [](auto row) { return row * 1'000'003L; }, isNull),
+            vectorMaker_->flatVector<float>(
+                size, [](auto row) { return row / 4.0; }, isNull),
+            vectorMaker_->flatVector<double>(
+                size, [](auto row) { return row * 1.5; }, isNull),
+            vectorMaker_->flatVector<StringView>(
+                size,
+                [](auto row) { return StringView(fmt::format("s{}", row)); },
+                isNull),
+            vectorMaker_->flatVector<Date>(
+                size, [](auto row) { return Date(row + 18'000); }, isNull),
+        });
+  }
+
+  // Returns a DictionaryVector over 'base' with 'size' rows cycling through
+  // its values. Every 7th row is null.
+  VectorPtr makeDictionary(const VectorPtr& base, vector_size_t size) {
+    auto indices = AlignedBuffer::allocate<vector_size_t>(size, pool_.get());
+    auto nulls = AlignedBuffer::allocate<bool>(size, pool_.get(), true);
+    auto* rawIndices = indices->asMutable<vector_size_t>();
+    auto* rawNulls = nulls->asMutable<uint64_t>();
+    for (auto i = 0; i < size; ++i) {
+      rawIndices[i] = (i * 13) % base->size();
+      bits::setNull(rawNulls, i, i % 7 == 0);
+    }
+    return BaseVector::wrapInDictionary(nulls, indices, size, base);
+  }
+};
+
+TEST_F(NativeWriterTest, flat) {
+  auto data = makeData(2'500);
+  NativeWriterOptions options;
+  options.maxRowsInPage = 100;
+  auto file = write({data}, 1'000, options);
+  assertRoundTrip(file, data);
+
+  auto metaData = readFooter(file);
+  EXPECT_EQ(metaData.num_rows, 2'500);
+  ASSERT_EQ(metaData.row_groups.size(), 3);
+  EXPECT_EQ(metaData.row_groups[2].num_rows, 500);
+  for (const auto& chunk : metaData.row_groups[0].columns) {
+    EXPECT_FALSE(chunk.meta_data.__isset.dictionary_page_offset);
+    EXPECT_TRUE(hasEncoding(chunk.meta_data, thrift::Encoding::PLAIN));
+    EXPECT_EQ(chunk.meta_data.statistics.null_count, 91);
+  }
+  auto& bigintStats = metaData.row_groups[1].columns[4].meta_data.statistics;
+  int64_t min;
+  int64_t max;
+  memcpy(&min, bigintStats.min_value.data(), sizeof(min));
+  memcpy(&max, bigintStats.max_value.data(), sizeof(max));
+  EXPECT_EQ(min, 1'000 * 1'000'003L);
+  EXPECT_EQ(max, 1'999 * 1'000'003L);
+}
+
+TEST_F(NativeWriterTest, batches) {
+  // Batches that straddle row group boundaries and a forced boundary.
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 4; ++i) {
+    batches.push_back(makeData(1'000));
+  }
+  auto sink = std::make_unique<MemorySink>(*pool_, 64 << 20);
+  auto* sinkPtr = sink.get();
+  NativeWriter writer(std::move(sink), *pool_, 1'500);
+  writer.write(batches[0]);
+  writer.newRowGroup();
+  writer.write(batches[1]);
+  writer.write(batches[2]);
+  writer.write(batches[3]);
+  writer.close();
+  std::string file(sinkPtr->getData(), sinkPtr->size());
+
+  auto metaData = readFooter(file);
+  ASSERT_EQ(metaData.row_groups.size(), 3);
+  EXPECT_EQ(metaData.row_groups[0].num_rows, 1'000);
+  EXPECT_EQ(metaData.row_groups[1].num_rows, 1'500);
+  EXPECT_EQ(metaData.row_groups[2].num_rows, 1'500);
+
+  auto expected =
+      BaseVector::create<RowVector>(batches[0]->type(), 0, pool_.get());
+  for (const auto& batch : batches) {
+    expected->append(batch.get());
+  }
+  assertRoundTrip(file, expected);
+}
+
+TEST_F(NativeWriterTest, dictionary) {
+  const vector_size_t size = 3'000;
+  auto strings = vectorMaker_->flatVector<StringView>(
+      50,
+      [](auto row) { return StringView(fmt::format("value{}", row % 40)); },
+      [](auto row) { return row == 3; });
+  auto bigints = vectorMaker_->flatVector<int64_t>(
+      20, [](auto row) { return row * 100; });
+  auto data = vectorMaker_->rowVector(
+      {"v", "l", "flat"},
+      {makeDictionary(strings, size),
+       makeDictionary(bigints, size),
+       vectorMaker_->flatVector<int64_t>(size, [](auto row) { return row; })});
+  NativeWriterOptions options;
+  options.maxRowsInPage = 500;
+  auto file = write({data}, 2'000, options);
+  assertRoundTrip(file, data);
+
+  auto metaData = readFooter(file);
+  ASSERT_EQ(metaData.row_groups.size(), 2);
+  for (const auto& rowGroup : metaData.row_groups) {
+    for (auto i = 0; i < 2; ++i) {
+      const auto& chunk = rowGroup.columns[i].meta_data;
+      EXPECT_TRUE(chunk.__isset.dictionary_page_offset);
+      EXPECT_TRUE(hasEncoding(chunk, thrift::Encoding::RLE_DICTIONARY));
+      // The dictionary page comes first.
+      EXPECT_LT(chunk.dictionary_page_offset, chunk.data_page_offset);
+    }
+    EXPECT_FALSE(rowGroup.columns[2].meta_data.__isset.dictionary_page_offset);
+  }
+  // Values that are equal in the base vector share a dictionary entry.
+  const auto& stringChunk = metaData.row_groups[0].columns[0].meta_data;
+  auto header = readThrift<thrift::PageHeader>(
+      file,
+      stringChunk.dictionary_page_offset,
+      stringChunk.data_page_offset - stringChunk.dictionary_page_offset);
+  EXPECT_EQ(header.dictionary_page_header.num_values, 40);
+}
+
+TEST_F(NativeWriterTest, dictionaryFallback) {
+  const vector_size_t size = 2'000;
+  auto base = vectorMaker_->flatVector<int64_t>(
+      200, [](auto row) { return row * 3; });
+  auto data = vectorMaker_->rowVector({"l"}, {makeDictionary(base, size)});
+  NativeWriterOptions options;
+  options.maxRowsInPage = 100;
+  options.maxDictionaryEntries = 50;
+  auto file = write({data}, size, options);
+  assertRoundTrip(file, data);
+
+  auto metaData = readFooter(file);
+  ASSERT_EQ(metaData.row_groups.size(), 1);
+  const auto& chunk = metaData.row_groups[0].columns[0].meta_data;
+  EXPECT_TRUE(hasEncoding(chunk, thrift::Encoding::RLE_DICTIONARY));
+  EXPECT_TRUE(hasEncoding(chunk, thrift::Encoding::PLAIN));
+}
+
+TEST_F(NativeWriterTest, pageIndexAndBloomFilter) {
+  const vector_size_t size = 5'000;
+  auto data = vectorMaker_->rowVector(
+      {"l", "v"},
+      {vectorMaker_->flatVector<int64_t>(
+           size, [](auto row) { return row * 2; }),
+       vectorMaker_->flatVector<StringView>(size, [](auto row) {
+         return StringView(fmt::format("s{}", row % 300));
+       })});
+  NativeWriterOptions options;
+  options.maxRowsInPage = 1'000;
+  options.bloomFilterColumns = {"l", "v"};
+  auto file = write({data}, size, options);
+
+  auto metaData = readFooter(file);
+  ASSERT_EQ(metaData.row_groups.size(), 1);
+  const auto& chunk = metaData.row_groups[0].columns[0];
+  ASSERT_TRUE(chunk.__isset.column_index_offset);
+  ASSERT_TRUE(chunk.__isset.offset_index_offset);
+  auto columnIndex = readThrift<thrift::ColumnIndex>(
+      file, chunk.column_index_offset, chunk.column_index_length);
+  auto offsetIndex = readThrift<thrift::OffsetIndex>(
+      file, chunk.offset_index_offset, chunk.offset_index_length);
+  ASSERT_EQ(offsetIndex.page_locations.size(), 5);
+  ASSERT_EQ(columnIndex.min_values.size(), 5);
+  EXPECT_EQ(
+      offsetIndex.page_locations[0].offset, chunk.meta_data.data_page_offset);
+  for (auto i = 0; i < 5; ++i) {
+    EXPECT_EQ(offsetIndex.page_locations[i].first_row_index, i * 1'000);
+    EXPECT_FALSE(columnIndex.null_pages[i]);
+    int64_t min;
+    memcpy(&min, columnIndex.min_values[i].data(), sizeof(min));
+    EXPECT_EQ(min, i * 2'000);
+  }
+
+  std::vector<std::unique_ptr<SplitBlockBloomFilter>> bloomFilters;
+  for (const auto& column : metaData.row_groups[0].columns) {
+    ASSERT_TRUE(column.meta_data.__isset.bloom_filter_offset);
+    const auto offset = column.meta_data.bloom_filter_offset;
+    uint32_t headerSize;
+    auto header = readThrift<thrift::BloomFilterHeader>(
+        file, offset, file.size() - offset, &headerSize);
+    EXPECT_TRUE(header.algorithm.__isset.BLOCK);
+    EXPECT_EQ(header.numBytes % SplitBlockBloomFilter::kBytesPerBlock, 0);
+    bloomFilters.push_back(std::make_unique<SplitBlockBloomFilter>(
+        file.substr(offset + headerSize, header.numBytes)));
+  }
+  for (auto row = 0; row < size; ++row) {
+    EXPECT_TRUE(bloomFilters[0]->mayContain(
+        SplitBlockBloomFilter::hashInt64(row * 2)));
+    const auto value = fmt::format("s{}", row % 300);
+    EXPECT_TRUE(bloomFilters[1]->mayContain(
+        SplitBlockBloomFilter::hashBytes(value.data(), value.size())));
+  }
+
+  // Point lookups are answered from the page index and the Bloom filter.
+  auto rowType = asRowType(data->type());
+  FilterMap filters;
+  filters["l"] = std::make_unique<BigintRange>(2'468, 2'468, false);
+  auto expected = vectorMaker_->rowVector(
+      {"l", "v"},
+      {vectorMaker_->flatVector<int64_t>({2'468}),
+       vectorMaker_->flatVector<StringView>({StringView("s34")})});
+  assertReadWithReaderAndFilters(
+      makeReader(file), "", rowType, std::move(filters), expected);
+
+  FilterMap missing;
+  missing["v"] = std::make_unique<BytesValues>(
+      std::vector<std::string>{"t1", "t2"}, false);
+  assertReadWithReaderAndFilters(
+      makeReader(file),
+      "",
+      rowType,
+      std::move(missing),
+      BaseVector::create<RowVector>(rowType, 0, pool_.get()));
+}
+
+TEST_F(NativeWriterTest, memoryFromPool) {
+  auto data = makeData(10'000);
+  const auto before = pool_->getCurrentBytes();
+  {
+    auto sink = std::make_unique<MemorySink>(*pool_, 64 << 20);
+    const auto withSink = pool_->getCurrentBytes();
+    NativeWriter writer(std::move(sink), *pool_, 100'000);
+    writer.write(data);
+    // The buffered row group is in the pool.
+    EXPECT_GT(pool_->getCurrentBytes(), withSink);
+    writer.close();
+  }
+  EXPECT_EQ(pool_->getCurrentBytes(), before);
+}
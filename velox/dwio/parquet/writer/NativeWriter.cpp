@@ -0,0 +1,1015 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/dwio/parquet/writer/NativeWriter.h"
+
+#include <cmath>
+
+#include <thrift/protocol/TCompactProtocol.h>
+
+#include "velox/dwio/parquet/reader/SplitBlockBloomFilter.h"
+#include "velox/dwio/parquet/thrift/ThriftTransport.h"
+#include "velox/dwio/parquet/writer/RleBpEncoder.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::parquet {
+
+using dwio::common::DataBuffer;
+
+namespace {
+
+constexpr char kMagic[] = {'P', 'A', 'R', '1'};
+constexpr int32_t kInitialDictionarySlots = 1024;
+constexpr int64_t kMinBloomFilterBytes = SplitBlockBloomFilter::kBytesPerBlock;
+constexpr int64_t kMaxBloomFilterBytes = 128 << 20;
+// Number of Bloom filter hashes collected before removing the duplicates.
+constexpr int64_t kMinHashesToDedup = 64 << 10;
+
+template <typename T>
+void serialize(const T& object, DataBuffer<char>& out) {
+  auto transport = std::make_shared<thrift::ThriftBufferSink>(out);
+  apache::thrift::protocol::TCompactProtocolT<thrift::ThriftBufferSink>
+      protocol(transport);
+  object.write(&protocol);
+}
+
+template <typename T>
+void append(DataBuffer<char>& out, const T* data, uint64_t size) {
+  out.extendAppend(out.size(), reinterpret_cast<const char*>(data), size);
+}
+
+// Empties 'buffer' keeping its memory. A buffer that has been moved out of
+// has no memory and is left as is.
+template <typename T>
+void reset(DataBuffer<T>& buffer) {
+  if (buffer.capacity() > 0) {
+    buffer.resize(0);
+  }
+}
+
+// The Parquet physical type holding the values of a Velox type.
+template <typename T>
+struct PhysicalType {
+  using type = T;
+};
+
+template <>
+struct PhysicalType<int8_t> {
+  using type = int32_t;
+};
+
+template <>
+struct PhysicalType<int16_t> {
+  using type = int32_t;
+};
+
+template <>
+struct PhysicalType<Date> {
+  using type = int32_t;
+};
+
+template <typename T, typename S>
+T toPhysical(S value) {
+  if constexpr (std::is_same_v<S, Date>) {
+    return value.days();
+  } else {
+    return value;
+  }
+}
+
+thrift::SchemaElement makeSchemaElement(
+    const std::string& name,
+    const Type& type) {
+  thrift::SchemaElement element;
+  element.__set_name(name);
+  element.__set_repetition_type(thrift::FieldRepetitionType::OPTIONAL);
+  switch (type.kind()) {
+    case TypeKind::BOOLEAN:
+      element.__set_type(thrift::Type::BOOLEAN);
+      break;
+    case TypeKind::TINYINT:
+      element.__set_type(thrift::Type::INT32);
+      element.__set_converted_type(thrift::ConvertedType::INT_8);
+      break;
+    case TypeKind::SMALLINT:
+      element.__set_type(thrift::Type::INT32);
+      element.__set_converted_type(thrift::ConvertedType::INT_16);
+      break;
+    case TypeKind::INTEGER:
+      element.__set_type(thrift::Type::INT32);
+      break;
+    case TypeKind::BIGINT:
+      element.__set_type(thrift::Type::INT64);
+      break;
+    case TypeKind::REAL:
+      element.__set_type(thrift::Type::FLOAT);
+      break;
+    case TypeKind::DOUBLE:
+      element.__set_type(thrift::Type::DOUBLE);
+      break;
+    case TypeKind::VARCHAR:
+      element.__set_type(thrift::Type::BYTE_ARRAY);
+      element.__set_converted_type(thrift::ConvertedType::UTF8);
+      break;
+    case TypeKind::VARBINARY:
+      element.__set_type(thrift::Type::BYTE_ARRAY);
+      break;
+    case TypeKind::DATE:
+      element.__set_type(thrift::Type::INT32);
+      element.__set_converted_type(thrift::ConvertedType::DATE);
+      break;
+    default:
+      VELOX_UNSUPPORTED(
+          "Type {} is not supported by the native Parquet writer",
+          type.toString());
+  }
+  return element;
+}
+
+template <typename T>
+uint64_t hashValue(T value) {
+  if constexpr (std::is_same_v<T, StringView>) {
+    return SplitBlockBloomFilter::hashBytes(value.data(), value.size());
+  } else if constexpr (sizeof(T) <= sizeof(int32_t)) {
+    int32_t bits = 0;
+    memcpy(&bits, &value, sizeof(T));
+    return SplitBlockBloomFilter::hashInt32(bits);
+  } else {
+    int64_t bits;
+    memcpy(&bits, &value, sizeof(T));
+    return SplitBlockBloomFilter::hashInt64(bits);
+  }
+}
+
+// Appends the PLAIN encoding of 'value' to 'out'. Booleans take a byte each
+// and are bit-packed when the page is finished.
+template <typename T>
+void appendPlain(T value, DataBuffer<char>& out) {
+  if constexpr (std::is_same_v<T, StringView>) {
+    const int32_t size = value.size();
+    append(out, &size, sizeof(size));
+    append(out, value.data(), size);
+  } else {
+    append(out, &value, sizeof(T));
+  }
+}
+
+template <typename T>
+int64_t plainSize(T value) {
+  if constexpr (std::is_same_v<T, StringView>) {
+    return sizeof(int32_t) + value.size();
+  } else {
+    return sizeof(T);
+  }
+}
+
+// Min and max of the values of a page or column chunk, in the order of the
+// Parquet physical type. NaNs are not counted.
+template <typename T>
+class MinMax {
+ public:
+  using Stored =
+      std::conditional_t<std::is_same_v<T, StringView>, std::string, T>;
+
+  void add(T value) {
+    if constexpr (std::is_floating_point_v<T>) {
+      if (std::isnan(value)) {
+        return;
+      }
+    }
+    if (!hasValue_ || lessThan(value, min_)) {
+      min_ = store(value);
+    }
+    if (!hasValue_ || greaterThan(value, max_)) {
+      max_ = store(value);
+    }
+    hasValue_ = true;
+  }
+
+  void merge(const MinMax& other) {
+    if (!other.hasValue_) {
+      return;
+    }
+    if (!hasValue_ || other.min_ < min_) {
+      min_ = other.min_;
+    }
+    if (!hasValue_ || max_ < other.max_) {
+      max_ = other.max_;
+    }
+    hasValue_ = true;
+  }
+
+  bool hasValue() const {
+    return hasValue_;
+  }
+
+  // Returns the PLAIN encoding of the min or max without the length of a
+  // BYTE_ARRAY, as used in Statistics and ColumnIndex.
+  std::string min() const {
+    return encode(min_);
+  }
+
+  std::string max() const {
+    return encode(max_);
+  }
+
+  void clear() {
+    hasValue_ = false;
+  }
+
+ private:
+  static bool lessThan(T value, const Stored& stored) {
+    if constexpr (std::is_same_v<T, StringView>) {
+      return std::string_view(value.data(), value.size()) < stored;
+    } else {
+      return value < stored;
+    }
+  }
+
+  static bool greaterThan(T value, const Stored& stored) {
+    if constexpr (std::is_same_v<T, StringView>) {
+      return stored < std::string_view(value.data(), value.size());
+    } else {
+      return stored < value;
+    }
+  }
+
+  static Stored store(T value) {
+    if constexpr (std::is_same_v<T, StringView>) {
+      return std::string(value.data(), value.size());
+    } else {
+      return value;
+    }
+  }
+
+  static std::string encode(const Stored& value) {
+    if constexpr (std::is_same_v<T, StringView>) {
+      return value;
+    } else {
+      return std::string(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+  }
+
+  bool hasValue_{false};
+  Stored min_{};
+  Stored max_{};
+};
+
+// Returns the size of a split block Bloom filter for 'numDistinct' values
+// with false positive probability 'fpp'.
+int64_t bloomFilterBytes(int64_t numDistinct, double fpp) {
+  const double numBits =
+      -8.0 * numDistinct / std::log(1 - std::pow(fpp, 1.0 / 8));
+  int64_t numBytes = std::min<double>(numBits / 8, kMaxBloomFilterBytes);
+  numBytes = std::max(numBytes, kMinBloomFilterBytes);
+  return bits::nextPowerOfTwo(numBytes);
+}
+
+} // namespace
+
+// Encodes the values of a column into the pages of a column chunk. The pages
+// are buffered until the row group is finished.
+class ColumnChunkWriter {
+ public:
+  virtual ~ColumnChunkWriter() = default;
+
+  // Appends rows [begin, end) of 'vector'.
+  virtual void
+  append(const VectorPtr& vector, vector_size_t begin, vector_size_t end) = 0;
+
+  // Appends the column chunk and its Bloom filter to 'out', which starts at
+  // 'fileOffset' in the file, and sets the metadata and page index of the
+  // chunk. 'columnIndex' is left empty if the pages have no valid min and
+  // max. Resets 'this' for the next row group.
+  virtual void finish(
+      int64_t fileOffset,
+      DataBuffer<char>& out,
+      thrift::ColumnChunk& chunk,
+      thrift::ColumnIndex& columnIndex,
+      thrift::OffsetIndex& offsetIndex) = 0;
+};
+
+namespace {
+
+// 'S' is the C++ type of the Velox values.
+template <typename S>
+class TypedColumnChunkWriter : public ColumnChunkWriter {
+ public:
+  using T = typename PhysicalType<S>::type;
+
+  TypedColumnChunkWriter(
+      std::string name,
+      thrift::Type::type type,
+      const NativeWriterOptions& options,
+      memory::MemoryPool& pool)
+      : name_(std::move(name)),
+        type_(type),
+        options_(options),
+        bloomFilter_(
+            options.bloomFilterColumns.count(name_) > 0 &&
+            (type == thrift::Type::INT32 || type == thrift::Type::INT64 ||
+             type == thrift::Type::BYTE_ARRAY)),
+        pool_(pool),
+        defineLevels_(pool),
+        values_(pool),
+        indices_(pool),
+        encoded_(pool),
+        pages_(pool),
+        dictionary_(pool),
+        dictionaryOffsets_(pool),
+        dictionaryHashes_(pool),
+        slots_(pool),
+        baseIds_(pool),
+        hashes_(pool) {}
+
+  void append(const VectorPtr& vector, vector_size_t begin, vector_size_t end)
+      override {
+    auto loaded = BaseVector::loadedVectorShared(vector);
+    switch (loaded->encoding()) {
+      case VectorEncoding::Simple::FLAT:
+        appendFlat(*loaded->asUnchecked<FlatVector<S>>(), begin, end);
+        return;
+      case VectorEncoding::Simple::DICTIONARY: {
+        auto base = BaseVector::loadedVectorShared(loaded->valueVector());
+        if (base->encoding() == VectorEncoding::Simple::FLAT) {
+          appendDictionary(*loaded, base, begin, end);
+          return;
+        }
+        break;
+      }
+      default:
+        break;
+    }
+    // Other encodings are flattened first.
+    const auto numRows = end - begin;
+    auto flat = BaseVector::create(loaded->type(), numRows, &pool_);
+    flat->copy(loaded.get(), 0, begin, numRows);
+    appendFlat(*flat->asUnchecked<FlatVector<S>>(), 0, numRows);
+  }
+
+  void finish(
+      int64_t fileOffset,
+      DataBuffer<char>& out,
+      thrift::ColumnChunk& chunk,
+      thrift::ColumnIndex& columnIndex,
+      thrift::OffsetIndex& offsetIndex) override;
+
+ private:
+  void startChunk(bool dictionaryInput) {
+    if (chunkStarted_) {
+      return;
+    }
+    chunkStarted_ = true;
+    useDictionary_ = dictionaryInput && options_.enableDictionary &&
+        type_ != thrift::Type::BOOLEAN;
+    if (useDictionary_) {
+      slots_.resize(kInitialDictionarySlots);
+      std::fill(slots_.data(), slots_.data() + slots_.size(), -1);
+    }
+  }
+
+  void appendFlat(
+      const FlatVector<S>& vector,
+      vector_size_t begin,
+      vector_size_t end) {
+    startChunk(false);
+    const auto* nulls = vector.rawNulls();
+    for (auto row = begin; row < end; ++row) {
+      if (nulls && bits::isBitNull(nulls, row)) {
+        addNull();
+      } else {
+        addValue(toPhysical<T>(vector.valueAtFast(row)), nullptr);
+      }
+    }
+  }
+
+  // Looks up the values of a DictionaryVector in the chunk dictionary once
+  // for each distinct index into 'base'.
+  void appendDictionary(
+      const BaseVector& vector,
+      const VectorPtr& base,
+      vector_size_t begin,
+      vector_size_t end) {
+    startChunk(true);
+    if (base != lastBase_) {
+      lastBase_ = base;
+      if (baseIds_.size() < base->size()) {
+        baseIds_.resize(base->size());
+      }
+      std::fill(baseIds_.data(), baseIds_.data() + base->size(), -1);
+    }
+    const auto* indices = vector.wrapInfo()->as<vector_size_t>();
+    const auto* nulls = vector.rawNulls();
+    const auto& values = *base->asUnchecked<FlatVector<S>>();
+    const auto* baseNulls = values.rawNulls();
+    for (auto row = begin; row < end; ++row) {
+      if (nulls && bits::isBitNull(nulls, row)) {
+        addNull();
+        continue;
+      }
+      const auto index = indices[row];
+      if (baseNulls && bits::isBitNull(baseNulls, index)) {
+        addNull();
+        continue;
+      }
+      addValue(toPhysical<T>(values.valueAtFast(index)), &baseIds_[index]);
+    }
+  }
+
+  void addNull() {
+    defineLevels_.append(0);
+    ++pageNulls_;
+    endRow();
+  }
+
+  // Adds a non-null value. 'cachedId' is the dictionary id of 'value' if
+  // known, or set to it otherwise.
+  void addValue(T value, int32_t* cachedId) {
+    if (useDictionary_) {
+      int32_t id = cachedId && *cachedId >= 0 ? *cachedId : findOrAdd(value);
+      if (id >= 0) {
+        if (cachedId) {
+          *cachedId = id;
+        }
+        indices_.append(id);
+      } else {
+        // The dictionary is full. The rest of the chunk is written plain.
+        finishPage();
+        useDictionary_ = false;
+        lastBase_ = nullptr;
+      }
+    }
+    if (!useDictionary_) {
+      appendPlain(value, values_);
+      if (bloomFilter_) {
+        addHash(hashValue(value));
+      }
+    }
+    defineLevels_.append(1);
+    pageStats_.add(value);
+    pageBytes_ += plainSize(value);
+    endRow();
+  }
+
+  void endRow() {
+    if (++pageRows_ >= options_.maxRowsInPage ||
+        pageBytes_ >= options_.dataPageSize) {
+      finishPage();
+    }
+  }
+
+  // Returns the dictionary id of 'value', adding it to the dictionary if
+  // new. Returns -1 if the dictionary is full.
+  int32_t findOrAdd(T value) {
+    const uint64_t hash = hashValue(value);
+    const uint64_t mask = slots_.size() - 1;
+    auto slot = hash & mask;
+    for (; slots_[slot] >= 0; slot = (slot + 1) & mask) {
+      const auto id = slots_[slot];
+      if (dictionaryHashes_[id] == hash && dictionaryEquals(id, value)) {
+        return id;
+      }
+    }
+    if (dictionaryHashes_.size() >= options_.maxDictionaryEntries ||
+        dictionary_.size() + plainSize(value) > options_.maxDictionaryBytes) {
+      return -1;
+    }
+    const int32_t id = dictionaryHashes_.size();
+    dictionaryOffsets_.append(dictionary_.size());
+    appendPlain(value, dictionary_);
+    dictionaryHashes_.append(hash);
+    slots_[slot] = id;
+    if (dictionaryHashes_.size() * 2 > slots_.size()) {
+      rehash();
+    }
+    return id;
+  }
+
+  bool dictionaryEquals(int32_t id, T value) const {
+    const char* entry = dictionary_.data() + dictionaryOffsets_[id];
+    if constexpr (std::is_same_v<T, StringView>) {
+      int32_t size;
+      memcpy(&size, entry, sizeof(size));
+      return size == value.size() &&
+          memcmp(entry + sizeof(size), value.data(), size) == 0;
+    } else {
+      return memcmp(entry, &value, sizeof(T)) == 0;
+    }
+  }
+
+  void rehash() {
+    slots_.resize(slots_.size() * 2);
+    std::fill(slots_.data(), slots_.data() + slots_.size(), -1);
+    const uint64_t mask = slots_.size() - 1;
+    for (int32_t id = 0; id < dictionaryHashes_.size(); ++id) {
+      auto slot = dictionaryHashes_[id] & mask;
+      while (slots_[slot] >= 0) {
+        slot = (slot + 1) & mask;
+      }
+      slots_[slot] = id;
+    }
+  }
+
+  void addHash(uint64_t hash) {
+    hashes_.append(hash);
+    if (hashes_.size() >= hashesToDedup_) {
+      dedupHashes();
+      hashesToDedup_ = std::max<int64_t>(hashesToDedup_, hashes_.size() * 2);
+    }
+  }
+
+  void dedupHashes() {
+    if (hashes_.size() == 0) {
+      return;
+    }
+    auto* begin = hashes_.data();
+    auto* end = begin + hashes_.size();
+    std::sort(begin, end);
+    hashes_.resize(std::unique(begin, end) - begin);
+  }
+
+  // Encodes the buffered rows into a data page.
+  void finishPage();
+
+  void writeDictionaryPage(DataBuffer<char>& out);
+
+  // Writes the Bloom filter of the distinct values of the chunk to 'out'.
+  // Returns false if there are no values.
+  bool writeBloomFilter(DataBuffer<char>& out);
+
+  const std::string name_;
+  const thrift::Type::type type_;
+  const NativeWriterOptions& options_;
+  const bool bloomFilter_;
+  memory::MemoryPool& pool_;
+
+  bool chunkStarted_{false};
+  bool useDictionary_{false};
+  bool hasDictionaryPages_{false};
+  bool hasPlainPages_{false};
+
+  // The rows of the current page.
+  DataBuffer<uint8_t> defineLevels_;
+  DataBuffer<char> values_;
+  DataBuffer<int32_t> indices_;
+  int32_t pageRows_{0};
+  int32_t pageNulls_{0};
+  int64_t pageBytes_{0};
+  MinMax<T> pageStats_;
+
+  // Temporary for encoding a page.
+  DataBuffer<char> encoded_;
+
+  // The finished data pages of the chunk.
+  DataBuffer<char> pages_;
+  int64_t chunkRows_{0};
+  int64_t chunkNulls_{0};
+  MinMax<T> chunkStats_;
+
+  // The page index of the chunk. The page offsets are relative to the first
+  // data page until the chunk is finished.
+  std::vector<thrift::PageLocation> pageLocations_;
+  std::vector<bool> nullPages_;
+  std::vector<std::string> minValues_;
+  std::vector<std::string> maxValues_;
+  std::vector<int64_t> nullCounts_;
+  bool validColumnIndex_{true};
+
+  // PLAIN encoded dictionary of the chunk, with the offset and hash of each
+  // entry and an open addressing hash table of entry ids.
+  DataBuffer<char> dictionary_;
+  DataBuffer<int64_t> dictionaryOffsets_;
+  DataBuffer<uint64_t> dictionaryHashes_;
+  DataBuffer<int32_t> slots_;
+
+  // The dictionary id of each index of 'lastBase_', or -1 if not looked up.
+  VectorPtr lastBase_;
+  DataBuffer<int32_t> baseIds_;
+
+  // Hashes of the plain encoded values for the Bloom filter.
+  DataBuffer<uint64_t> hashes_;
+  int64_t hashesToDedup_{kMinHashesToDedup};
+};
+
+template <typename S>
+void TypedColumnChunkWriter<S>::finishPage() {
+  if (pageRows_ == 0) {
+    return;
+  }
+  // The definition levels are prefixed by their length in a DataPage V1.
+  reset(encoded_);
+  const int32_t zero = 0;
+  append(encoded_, &zero, sizeof(zero));
+  RleBpEncoder::encode(defineLevels_.data(), pageRows_, 1, encoded_);
+  const int32_t levelsSize = encoded_.size() - sizeof(int32_t);
+  memcpy(encoded_.data(), &levelsSize, sizeof(levelsSize));
+
+  thrift::DataPageHeader dataHeader;
+  if (useDictionary_) {
+    const int32_t maxId = dictionaryHashes_.size() - 1;
+    const int32_t bitWidth = 32 - __builtin_clz(std::max(1, maxId));
+    encoded_.append(static_cast<char>(bitWidth));
+    RleBpEncoder::encode(
+        indices_.data(), indices_.size(), bitWidth, encoded_);
+    dataHeader.__set_encoding(thrift::Encoding::RLE_DICTIONARY);
+    hasDictionaryPages_ = true;
+  } else {
+    if constexpr (std::is_same_v<T, bool>) {
+      const auto numValues = values_.size();
+      const auto offset = encoded_.size();
+      encoded_.resize(offset + bits::nbytes(numValues));
+      auto* packed = reinterpret_cast<uint8_t*>(encoded_.data() + offset);
+      for (auto i = 0; i < numValues; ++i) {
+        if (values_[i]) {
+          bits::setBit(packed, i);
+        }
+      }
+    } else {
+      append(encoded_, values_.data(), values_.size());
+    }
+    dataHeader.__set_encoding(thrift::Encoding::PLAIN);
+    hasPlainPages_ = true;
+  }
+  dataHeader.__set_num_values(pageRows_);
+  dataHeader.__set_definition_level_encoding(thrift::Encoding::RLE);
+  dataHeader.__set_repetition_level_encoding(thrift::Encoding::RLE);
+
+  thrift::PageHeader header;
+  header.__set_type(thrift::PageType::DATA_PAGE);
+  header.__set_uncompressed_page_size(encoded_.size());
+  header.__set_compressed_page_size(encoded_.size());
+  header.__set_data_page_header(dataHeader);
+
+  const int64_t pageOffset = pages_.size();
+  serialize(header, pages_);
+  append(pages_, encoded_.data(), encoded_.size());
+
+  thrift::PageLocation location;
+  location.__set_offset(pageOffset);
+  location.__set_compressed_page_size(pages_.size() - pageOffset);
+  location.__set_first_row_index(chunkRows_);
+  pageLocations_.push_back(location);
+  const bool nullPage = pageNulls_ == pageRows_;
+  nullPages_.push_back(nullPage);
+  if (!nullPage && !pageStats_.hasValue()) {
+    // All the values are NaN.
+    validColumnIndex_ = false;
+  }
+  minValues_.push_back(pageStats_.hasValue() ? pageStats_.min() : "");
+  maxValues_.push_back(pageStats_.hasValue() ? pageStats_.max() : "");
+  nullCounts_.push_back(pageNulls_);
+
+  chunkStats_.merge(pageStats_);
+  chunkRows_ += pageRows_;
+  chunkNulls_ += pageNulls_;
+  pageStats_.clear();
+  pageRows_ = 0;
+  pageNulls_ = 0;
+  pageBytes_ = 0;
+  reset(defineLevels_);
+  reset(values_);
+  reset(indices_);
+}
+
+template <typename S>
+void TypedColumnChunkWriter<S>::writeDictionaryPage(DataBuffer<char>& out) {
+  thrift::DictionaryPageHeader dictionaryHeader;
+  dictionaryHeader.__set_num_values(dictionaryHashes_.size());
+  dictionaryHeader.__set_encoding(thrift::Encoding::PLAIN);
+
+  thrift::PageHeader header;
+  header.__set_type(thrift::PageType::DICTIONARY_PAGE);
+  header.__set_uncompressed_page_size(dictionary_.size());
+  header.__set_compressed_page_size(dictionary_.size());
+  header.__set_dictionary_page_header(dictionaryHeader);
+  serialize(header, out);
+  append(out, dictionary_.data(), dictionary_.size());
+}
+
+template <typename S>
+bool TypedColumnChunkWriter<S>::writeBloomFilter(DataBuffer<char>& out) {
+  // The dictionary entries are the distinct values of the dictionary encoded
+  // pages.
+  for (auto i = 0; i < dictionaryHashes_.size(); ++i) {
+    hashes_.append(dictionaryHashes_[i]);
+  }
+  dedupHashes();
+  if (hashes_.size() == 0) {
+    return false;
+  }
+  const auto numBytes =
+      bloomFilterBytes(hashes_.size(), options_.bloomFilterFpp);
+  SplitBlockBloomFilter filter(std::string(numBytes, '\0'));
+  for (auto i = 0; i < hashes_.size(); ++i) {
+    filter.insert(hashes_[i]);
+  }
+  thrift::BloomFilterHeader header;
+  header.__set_numBytes(numBytes);
+  thrift::BloomFilterAlgorithm algorithm;
+  algorithm.__set_BLOCK(thrift::SplitBlockAlgorithm());
+  header.__set_algorithm(algorithm);
+  thrift::BloomFilterHash hash;
+  hash.__set_XXHASH(thrift::XxHash());
+  header.__set_hash(hash);
+  thrift::BloomFilterCompression compression;
+  compression.__set_UNCOMPRESSED(thrift::Uncompressed());
+  header.__set_compression(compression);
+  serialize(header, out);
+  append(out, filter.bitset().data(), numBytes);
+  return true;
+}
+
+template <typename S>
+void TypedColumnChunkWriter<S>::finish(
+    int64_t fileOffset,
+    DataBuffer<char>& out,
+    thrift::ColumnChunk& chunk,
+    thrift::ColumnIndex& columnIndex,
+    thrift::OffsetIndex& offsetIndex) {
+  finishPage();
+  const int64_t chunkOffset = fileOffset + out.size();
+  thrift::ColumnMetaData metaData;
+  metaData.__set_type(type_);
+  metaData.__set_path_in_schema({name_});
+  metaData.__set_codec(thrift::CompressionCodec::UNCOMPRESSED);
+  metaData.__set_num_values(chunkRows_);
+
+  std::vector<thrift::Encoding::type> encodings{thrift::Encoding::RLE};
+  if (hasDictionaryPages_) {
+    metaData.__set_dictionary_page_offset(chunkOffset);
+    writeDictionaryPage(out);
+    encodings.push_back(thrift::Encoding::PLAIN);
+    encodings.push_back(thrift::Encoding::RLE_DICTIONARY);
+  } else if (hasPlainPages_) {
+    encodings.push_back(thrift::Encoding::PLAIN);
+  }
+  metaData.__set_encodings(encodings);
+
+  const int64_t dataOffset = fileOffset + out.size();
+  metaData.__set_data_page_offset(dataOffset);
+  append(out, pages_.data(), pages_.size());
+  const int64_t chunkSize = fileOffset + out.size() - chunkOffset;
+  metaData.__set_total_uncompressed_size(chunkSize);
+  metaData.__set_total_compressed_size(chunkSize);
+
+  thrift::Statistics statistics;
+  statistics.__set_null_count(chunkNulls_);
+  if (chunkStats_.hasValue()) {
+    statistics.__set_min_value(chunkStats_.min());
+    statistics.__set_max_value(chunkStats_.max());
+  }
+  metaData.__set_statistics(statistics);
+
+  if (bloomFilter_) {
+    const int64_t bloomFilterOffset = fileOffset + out.size();
+    if (writeBloomFilter(out)) {
+      metaData.__set_bloom_filter_offset(bloomFilterOffset);
+    }
+  }
+
+  chunk.__set_file_offset(chunkOffset);
+  chunk.__set_meta_data(metaData);
+
+  for (auto& location : pageLocations_) {
+    location.offset += dataOffset;
+  }
+  offsetIndex.__set_page_locations(std::move(pageLocations_));
+  if (validColumnIndex_ && !nullPages_.empty()) {
+    columnIndex.__set_null_pages(std::move(nullPages_));
+    columnIndex.__set_min_values(std::move(minValues_));
+    columnIndex.__set_max_values(std::move(maxValues_));
+    columnIndex.__set_boundary_order(thrift::BoundaryOrder::UNORDERED);
+    columnIndex.__set_null_counts(std::move(nullCounts_));
+  }
+
+  // Reset for the next row group.
+  chunkStarted_ = false;
+  useDictionary_ = false;
+  hasDictionaryPages_ = false;
+  hasPlainPages_ = false;
+  reset(pages_);
+  chunkRows_ = 0;
+  chunkNulls_ = 0;
+  chunkStats_.clear();
+  pageLocations_.clear();
+  nullPages_.clear();
+  minValues_.clear();
+  maxValues_.clear();
+  nullCounts_.clear();
+  validColumnIndex_ = true;
+  reset(dictionary_);
+  reset(dictionaryOffsets_);
+  reset(dictionaryHashes_);
+  reset(slots_);
+  lastBase_ = nullptr;
+  reset(hashes_);
+  hashesToDedup_ = kMinHashesToDedup;
+}
+
+std::unique_ptr<ColumnChunkWriter> makeColumnChunkWriter(
+    const std::string& name,
+    const Type& veloxType,
+    thrift::Type::type type,
+    const NativeWriterOptions& options,
+    memory::MemoryPool& pool) {
+  switch (veloxType.kind()) {
+    case TypeKind::BOOLEAN:
+      return std::make_unique<TypedColumnChunkWriter<bool>>(
+          name, type, options, pool);
+    case TypeKind::TINYINT:
+      return std::make_unique<TypedColumnChunkWriter<int8_t>>(
+          name, type, options, pool);
+    case TypeKind::SMALLINT:
+      return std::make_unique<TypedColumnChunkWriter<int16_t>>(
+          name, type, options, pool);
+    case TypeKind::INTEGER:
+      return std::make_unique<TypedColumnChunkWriter<int32_t>>(
+          name, type, options, pool);
+    case TypeKind::BIGINT:
+      return std::make_unique<TypedColumnChunkWriter<int64_t>>(
+          name, type, options, pool);
+    case TypeKind::REAL:
+      return std::make_unique<TypedColumnChunkWriter<float>>(
+          name, type, options, pool);
+    case TypeKind::DOUBLE:
+      return std::make_unique<TypedColumnChunkWriter<double>>(
+          name, type, options, pool);
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return std::make_unique<TypedColumnChunkWriter<StringView>>(
+          name, type, options, pool);
+    case TypeKind::DATE:
+      return std::make_unique<TypedColumnChunkWriter<Date>>(
+          name, type, options, pool);
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+} // namespace
+
+NativeWriter::NativeWriter(
+    std::unique_ptr<dwio::common::DataSink> sink,
+    memory::MemoryPool& pool,
+    int32_t rowsInRowGroup,
+    NativeWriterOptions options)
+    : rowsInRowGroup_(rowsInRowGroup),
+      options_(std::move(options)),
+      pool_(pool),
+      sink_(std::move(sink)) {
+  VELOX_CHECK_GT(rowsInRowGroup_, 0);
+  VELOX_CHECK_GT(options_.maxRowsInPage, 0);
+}
+
+NativeWriter::~NativeWriter() = default;
+
+void NativeWriter::initialize(const RowTypePtr& type) {
+  type_ = type;
+  thrift::SchemaElement root;
+  root.__set_name("schema");
+  root.__set_repetition_type(thrift::FieldRepetitionType::REQUIRED);
+  root.__set_num_children(type_->size());
+  std::vector<thrift::SchemaElement> schema{root};
+  for (auto i = 0; i < type_->size(); ++i) {
+    const auto& name = type_->nameOf(i);
+    schema.push_back(makeSchemaElement(name, *type_->childAt(i)));
+    columns_.push_back(makeColumnChunkWriter(
+        name, *type_->childAt(i), schema.back().type, options_, pool_));
+  }
+  fileMetaData_.__set_version(1);
+  fileMetaData_.__set_schema(std::move(schema));
+  fileMetaData_.__set_created_by("velox");
+
+  DataBuffer<char> magic(pool_);
+  append(magic, kMagic, sizeof(kMagic));
+  sink_->write(std::move(magic));
+  offset_ = sizeof(kMagic);
+}
+
+void NativeWriter::write(const RowVectorPtr& data) {
+  VELOX_CHECK(!closed_, "Parquet writer is closed");
+  if (!type_) {
+    initialize(asRowType(data->type()));
+  }
+  VELOX_CHECK(
+      type_->equivalent(*data->type()),
+      "Data type {} does not match the type {} of the Parquet writer",
+      data->type()->toString(),
+      type_->toString());
+  vector_size_t begin = 0;
+  while (begin < data->size()) {
+    const vector_size_t end = std::min<int64_t>(
+        data->size(), begin + rowsInRowGroup_ - numRowsInGroup_);
+    for (auto i = 0; i < columns_.size(); ++i) {
+      columns_[i]->append(data->childAt(i), begin, end);
+    }
+    numRowsInGroup_ += end - begin;
+    begin = end;
+    if (numRowsInGroup_ >= rowsInRowGroup_) {
+      flush();
+    }
+  }
+}
+
+void NativeWriter::flush() {
+  if (numRowsInGroup_ == 0) {
+    return;
+  }
+  const auto numColumns = columns_.size();
+  thrift::RowGroup rowGroup;
+  std::vector<thrift::ColumnChunk> chunks(numColumns);
+  auto& columnIndexes = columnIndexes_.emplace_back(numColumns);
+  auto& offsetIndexes = offsetIndexes_.emplace_back(numColumns);
+  DataBuffer<char> out(pool_);
+  int64_t totalSize = 0;
+  for (auto i = 0; i < numColumns; ++i) {
+    columns_[i]->finish(
+        offset_, out, chunks[i], columnIndexes[i], offsetIndexes[i]);
+    totalSize += chunks[i].meta_data.total_uncompressed_size;
+  }
+  rowGroup.__set_file_offset(chunks[0].file_offset);
+  rowGroup.__set_columns(std::move(chunks));
+  rowGroup.__set_num_rows(numRowsInGroup_);
+  rowGroup.__set_total_byte_size(totalSize);
+  rowGroup.__set_total_compressed_size(totalSize);
+  rowGroup.__set_ordinal(fileMetaData_.row_groups.size());
+  fileMetaData_.row_groups.push_back(std::move(rowGroup));
+  fileMetaData_.num_rows += numRowsInGroup_;
+  numRowsInGroup_ = 0;
+
+  offset_ += out.size();
+  sink_->write(std::move(out));
+}
+
+void NativeWriter::newRowGroup() {
+  flush();
+}
+
+void NativeWriter::writePageIndexes(DataBuffer<char>& out) {
+  // All the column indexes come before all the offset indexes.
+  for (auto i = 0; i < fileMetaData_.row_groups.size(); ++i) {
+    auto& columns = fileMetaData_.row_groups[i].columns;
+    for (auto j = 0; j < columns.size(); ++j) {
+      const auto& columnIndex = columnIndexes_[i][j];
+      if (columnIndex.null_pages.empty()) {
+        continue;
+      }
+      const auto start = out.size();
+      serialize(columnIndex, out);
+      columns[j].__set_column_index_offset(offset_ + start);
+      columns[j].__set_column_index_length(out.size() - start);
+    }
+  }
+  for (auto i = 0; i < fileMetaData_.row_groups.size(); ++i) {
+    auto& columns = fileMetaData_.row_groups[i].columns;
+    for (auto j = 0; j < columns.size(); ++j) {
+      const auto start = out.size();
+      serialize(offsetIndexes_[i][j], out);
+      columns[j].__set_offset_index_offset(offset_ + start);
+      columns[j].__set_offset_index_length(out.size() - start);
+    }
+  }
+  columnIndexes_.clear();
+  offsetIndexes_.clear();
+}
+
+void NativeWriter::close() {
+  if (closed_) {
+    return;
+  }
+  closed_ = true;
+  if (!type_) {
+    // Nothing was written.
+    sink_->close();
+    return;
+  }
+  flush();
+  DataBuffer<char> out(pool_);
+  if (options_.writePageIndex) {
+    writePageIndexes(out);
+  }
+  const auto footerStart = out.size();
+  serialize(fileMetaData_, out);
+  const uint32_t footerLength = out.size() - footerStart;
+  append(out, &footerLength, sizeof(footerLength));
+  append(out, kMagic, sizeof(kMagic));
+  offset_ += out.size();
+  sink_->write(std::move(out));
+  sink_->close();
+}
+
+} // namespace facebook::velox::parquet
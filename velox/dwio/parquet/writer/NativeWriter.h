@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <unordered_set>
+
+#include "velox/dwio/common/DataBuffer.h"
+#include "velox/dwio/common/DataSink.h"
+#include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::parquet {
+
+struct NativeWriterOptions {
+  // Target size of the values of a data page before encoding.
+  int64_t dataPageSize{1 << 20};
+
+  // Maximum number of rows in a data page. Smaller pages make the page index
+  // more selective.
+  int32_t maxRowsInPage{20'000};
+
+  // Keeps the dictionary encoding of DictionaryVector input. The dictionary
+  // is per column chunk. The chunk falls back to plain encoding for the rest
+  // of its values if the dictionary grows beyond 'maxDictionaryEntries' or
+  // 'maxDictionaryBytes'.
+  bool enableDictionary{true};
+  int32_t maxDictionaryEntries{1 << 16};
+  int64_t maxDictionaryBytes{1 << 20};
+
+  // Writes the ColumnIndex and OffsetIndex of each column chunk.
+  bool writePageIndex{true};
+
+  // Names of the top level columns to write Bloom filters for. Bloom filters
+  // are written for INT32, INT64 and BYTE_ARRAY physical types.
+  std::unordered_set<std::string> bloomFilterColumns;
+
+  // False positive probability the Bloom filters are sized for.
+  double bloomFilterFpp{0.01};
+};
+
+class ColumnChunkWriter;
+
+// Writes Velox vectors into a DataSink in Parquet format without going
+// through Arrow. FlatVectors and DictionaryVectors are encoded directly.
+// Dictionary encoded input is written with dictionary encoding. Supports top
+// level columns of primitive types, which are all written as OPTIONAL. Data
+// pages are uncompressed. Each row group is written to the sink once
+// complete and all the memory for buffering a row group comes from 'pool'.
+class NativeWriter {
+ public:
+  // Constructs a writer with output to 'sink'. A new row group is started
+  // every 'rowsInRowGroup' top level rows.
+  NativeWriter(
+      std::unique_ptr<dwio::common::DataSink> sink,
+      memory::MemoryPool& pool,
+      int32_t rowsInRowGroup,
+      NativeWriterOptions options = {});
+
+  ~NativeWriter();
+
+  // Appends 'data' into the writer.
+  void write(const RowVectorPtr& data);
+
+  // Writes out the current row group.
+  void flush();
+
+  // Forces a row group boundary before the data added by next write().
+  void newRowGroup();
+
+  // Writes out the remaining data and the footer and closes the sink. After
+  // close, data can no longer be added. 'sink' stays live until destruction
+  // of 'this'.
+  void close();
+
+ private:
+  void initialize(const RowTypePtr& type);
+
+  // Writes the column and offset indexes of all row groups before the
+  // footer.
+  void writePageIndexes(dwio::common::DataBuffer<char>& out);
+
+  const int32_t rowsInRowGroup_;
+  const NativeWriterOptions options_;
+  memory::MemoryPool& pool_;
+  std::unique_ptr<dwio::common::DataSink> sink_;
+
+  RowTypePtr type_;
+  std::vector<std::unique_ptr<ColumnChunkWriter>> columns_;
+
+  // Number of rows in the current row group.
+  int64_t numRowsInGroup_{0};
+
+  // Number of bytes written to 'sink_'.
+  int64_t offset_{0};
+
+  thrift::FileMetaData fileMetaData_;
+
+  // The page indexes of the columns of each row group.
+  std::vector<std::vector<thrift::ColumnIndex>> columnIndexes_;
+  std::vector<std::vector<thrift::OffsetIndex>> offsetIndexes_;
+
+  bool closed_{false};
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/dwio/common/DataBuffer.h"
+
+namespace facebook::velox::parquet {
+
+// Encodes integers of 'bitWidth' bits with the RLE/bit-packing hybrid
+// encoding of Parquet. Runs of at least kMinRepeat equal values are written
+// as RLE runs and the values in between as groups of 8 bit-packed values.
+class RleBpEncoder {
+ public:
+  static constexpr int32_t kMinRepeat = 8;
+
+  // Appends the encoding of 'numValues' values to 'out'. The last group of
+  // bit-packed values is padded with zeros.
+  template <typename T>
+  static void encode(
+      const T* values,
+      int32_t numValues,
+      int32_t bitWidth,
+      dwio::common::DataBuffer<char>& out) {
+    int32_t literalStart = 0;
+    int32_t i = 0;
+    while (i < numValues) {
+      int32_t runEnd = i + 1;
+      while (runEnd < numValues && values[runEnd] == values[i]) {
+        ++runEnd;
+      }
+      // Bit-packed groups are 8 values, so the values before an RLE run must
+      // be a multiple of 8. The missing values are taken from the run.
+      const int32_t pad = (8 - (i - literalStart) % 8) % 8;
+      if (runEnd - i - pad >= kMinRepeat) {
+        writeLiterals(
+            values + literalStart, i + pad - literalStart, bitWidth, out);
+        writeRun(values[i], runEnd - i - pad, bitWidth, out);
+        literalStart = runEnd;
+      }
+      i = runEnd;
+    }
+    writeLiterals(
+        values + literalStart, numValues - literalStart, bitWidth, out);
+  }
+
+ private:
+  static void writeVarint(uint32_t value, dwio::common::DataBuffer<char>& out) {
+    while (value >= 0x80) {
+      out.append(static_cast<char>(value | 0x80));
+      value >>= 7;
+    }
+    out.append(static_cast<char>(value));
+  }
+
+  template <typename T>
+  static void writeRun(
+      T value,
+      int32_t count,
+      int32_t bitWidth,
+      dwio::common::DataBuffer<char>& out) {
+    writeVarint(count << 1, out);
+    uint32_t word = value;
+    for (auto i = 0; i < bits::nbytes(bitWidth); ++i) {
+      out.append(static_cast<char>(word >> (i * 8)));
+    }
+  }
+
+  template <typename T>
+  static void writeLiterals(
+      const T* values,
+      int32_t count,
+      int32_t bitWidth,
+      dwio::common::DataBuffer<char>& out) {
+    if (count == 0) {
+      return;
+    }
+    const int32_t numGroups = bits::roundUp(count, 8) / 8;
+    writeVarint((numGroups << 1) | 1, out);
+    out.extend(numGroups * bitWidth);
+    uint64_t accumulator = 0;
+    int32_t numBits = 0;
+    for (auto i = 0; i < numGroups * 8; ++i) {
+      const uint64_t value = i < count ? values[i] : 0;
+      accumulator |= value << numBits;
+      numBits += bitWidth;
+      while (numBits >= 8) {
+        out.unsafeAppend(static_cast<char>(accumulator));
+        accumulator >>= 8;
+        numBits -= 8;
+      }
+    }
+  }
+};
+
+} // namespace facebook::velox::parquet
@@ -149,6 +149,23 @@ class Aggregate {
       const std::vector<VectorPtr>& args,
       bool mayPushdown) = 0;
 
+  // Same as addRawInput() with an additional dense id below 'numGroupIds' for
+  // the group of each row. Rows with the same id go into the same group. This
+  // is called instead of addRawInput() when the groups are few and map to a
+  // small array, e.g. in the array mode of the hash table, so that the
+  // aggregate can accumulate the input into arrays indexed by the group id
+  // and then update each group row once. The default ignores the ids.
+  // @param groupIds The dense group id of each row, aligned with 'groups'.
+  // @param numGroupIds The upper bound of 'groupIds'.
+  virtual void addRawInputDense(
+      char** groups,
+      const uint64_t* groupIds,
+      uint64_t numGroupIds,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args) {
+    addRawInput(groups, rows, args, false);
+  }
+
   // Updates the single partial accumulator from raw input data for global
   // aggregation.
   // @param group Pointer to the start of the group row.
@@ -315,8 +332,10 @@ class Aggregate {
 
   // When selectivity vector has holes, in the pushdown, we need to generate a
   // different indices vector as the one we get from the DecodedVector is simply
-  // sequential.
+  // sequential. The groups of the selected rows are compacted alongside as the
+  // ValueHook is called with the positions in the indices vector.
   std::vector<vector_size_t> pushdownCustomIndices_;
+  std::vector<char*> pushdownCustomGroups_;
 };
 
 using AggregateFunctionFactory = std::function<std::unique_ptr<Aggregate>(
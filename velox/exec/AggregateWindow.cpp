@@ -21,14 +21,32 @@
 #include "velox/expression/FunctionSignature.h"
 #include "velox/vector/FlatVector.h"
 
+#include <unordered_set>
+
 namespace facebook::velox::exec {
 
 namespace {
 
+// Aggregates whose intermediate results can be merged in any grouping of
+// adjacent ranges and which therefore can be evaluated over a segment tree.
+bool supportsSegmentTree(
+    const std::string& name,
+    const std::vector<TypePtr>& argTypes) {
+  static const std::unordered_set<std::string> kFunctions = {
+      "sum", "count", "avg", "min", "max"};
+  // min(x, n) and max(x, n) return arrays and are excluded.
+  return argTypes.size() <= 1 && kFunctions.count(name) > 0;
+}
+
 // A generic way to compute any aggregation used as a window function.
 // Creates an Aggregate function object for the window function invocation.
 // At each row, computes the aggregation across all rows from the frameStart
 // to frameEnd boundaries at that row using singleGroup.
+//
+// For sum, count, avg, min and max, frames that do not share a fixed start
+// are computed from a segment tree of intermediate results built over the
+// whole partition. Each frame then merges O(log n) tree nodes instead of
+// re-aggregating all of its rows.
 class AggregateWindowFunction : public exec::WindowFunction {
  public:
   AggregateWindowFunction(
@@ -59,6 +77,10 @@ class AggregateWindowFunction : public exec::WindowFunction {
         name, core::AggregationNode::Step::kSingle, argTypes_, resultType);
     aggregate_->setAllocator(stringAllocator_);
 
+    if (supportsSegmentTree(name, argTypes_)) {
+      intermediateType_ = exec::Aggregate::intermediateType(name, argTypes_);
+    }
+
     // Aggregate initialization.
     // Row layout is:
     //  - null flags - one bit per aggregate.
@@ -80,6 +102,9 @@ class AggregateWindowFunction : public exec::WindowFunction {
         exec::RowContainer::nullMask(kNullOffset),
         /* needed for out of line allocations */ kRowSizeOffset);
     singleGroupRowSize_ += aggregate_->accumulatorFixedWidthSize();
+    // Stride between consecutive group rows used to build the segment tree.
+    groupRowStride_ = bits::roundUp(
+        singleGroupRowSize_, aggregate_->accumulatorAlignmentSize());
 
     // Construct the single row in the MemoryPool.
     singleGroupRowBufferPtr_ =
@@ -104,6 +129,7 @@ class AggregateWindowFunction : public exec::WindowFunction {
     partition_ = partition;
 
     previousFrameMetadata_.reset();
+    segmentTree_.clear();
   }
 
   void apply(
@@ -137,10 +163,7 @@ class AggregateWindowFunction : public exec::WindowFunction {
 
         // This is the start of a new incremental aggregation. So the
         // aggregate_ function object should be initialized.
-        auto singleGroup = std::vector<vector_size_t>{0};
-        aggregate_->clear();
-        aggregate_->initializeNewGroups(&rawSingleGroupRow_, singleGroup);
-        aggregateInitialized_ = true;
+        resetSingleGroup();
       }
 
       fillArgVectors(startRow, frameMetadata.lastRow);
@@ -151,6 +174,9 @@ class AggregateWindowFunction : public exec::WindowFunction {
           rawFrameEnds,
           resultOffset,
           result);
+    } else if (intermediateType_ != nullptr) {
+      segmentTreeAggregation(
+          validRows, rawFrameStarts, rawFrameEnds, resultOffset, result);
     } else {
       fillArgVectors(frameMetadata.firstRow, frameMetadata.lastRow);
       simpleAggregation(
@@ -183,6 +209,18 @@ class AggregateWindowFunction : public exec::WindowFunction {
     bool usePreviousAggregate;
   };
 
+  // Frees out-of-line storage held by the single group accumulator, if any,
+  // and initializes it for a new aggregation.
+  void resetSingleGroup() {
+    static const std::vector<vector_size_t> kSingleGroup = {0};
+    if (aggregateInitialized_) {
+      aggregate_->destroy(folly::Range(&rawSingleGroupRow_, 1));
+    }
+    aggregate_->clear();
+    aggregate_->initializeNewGroups(&rawSingleGroupRow_, kSingleGroup);
+    aggregateInitialized_ = true;
+  }
+
   bool handleAllEmptyFrames(
       const SelectivityVector& validRows,
       vector_size_t resultOffset,
@@ -313,7 +351,6 @@ class AggregateWindowFunction : public exec::WindowFunction {
       const VectorPtr& result) {
     SelectivityVector rows;
     rows.resize(maxFrame + 1 - minFrame);
-    static auto kSingleGroup = std::vector<vector_size_t>{0};
 
     validRows.applyToSelected([&](auto i) {
       // This is a very naive algorithm.
@@ -322,9 +359,7 @@ class AggregateWindowFunction : public exec::WindowFunction {
       // TODO : Try to re-use previous computations by advancing and retracting
       // the aggregation based on the frame changes with each row. This would
       // require adding new APIs to the Aggregate framework.
-      aggregate_->clear();
-      aggregate_->initializeNewGroups(&rawSingleGroupRow_, kSingleGroup);
-      aggregateInitialized_ = true;
+      resetSingleGroup();
 
       auto frameStartIndex = frameStartsVector[i] - minFrame;
       auto frameEndIndex = frameEndsVector[i] - minFrame + 1;
@@ -336,6 +371,143 @@ class AggregateWindowFunction : public exec::WindowFunction {
     setEmptyFramesResults(validRows, resultOffset, result);
   }
 
+  // Initializes 'numGroups' group rows in 'treeGroupRows_', calls 'addInput'
+  // to update them and extracts their intermediate results into 'result'.
+  template <typename TAddInput>
+  void aggregateTreeGroups(
+      vector_size_t numGroups,
+      TAddInput addInput,
+      VectorPtr& result) {
+    const auto bufferSize = numGroups * groupRowStride_;
+    if (treeGroupRowsBuffer_ == nullptr ||
+        treeGroupRowsBuffer_->capacity() < bufferSize) {
+      treeGroupRowsBuffer_ = AlignedBuffer::allocate<char>(bufferSize, pool_);
+    }
+    auto* rawGroupRows = treeGroupRowsBuffer_->asMutable<char>();
+    treeGroups_.resize(numGroups);
+    treeGroupIndices_.resize(numGroups);
+    for (auto i = 0; i < numGroups; ++i) {
+      treeGroups_[i] = rawGroupRows + i * groupRowStride_;
+      treeGroupIndices_[i] = i;
+    }
+
+    aggregate_->clear();
+    aggregate_->initializeNewGroups(treeGroups_.data(), treeGroupIndices_);
+    addInput(treeGroups_.data());
+    aggregate_->extractAccumulators(treeGroups_.data(), numGroups, &result);
+    aggregate_->destroy(folly::Range(treeGroups_.data(), numGroups));
+  }
+
+  // Builds the segment tree over all rows of the current partition.
+  // segmentTree_[0] holds an intermediate result per partition row, and each
+  // entry of segmentTree_[i] merges kTreeFanout consecutive entries of
+  // segmentTree_[i - 1]. The last level has a single entry.
+  void buildSegmentTree() {
+    const auto numRows = partition_->numRows();
+    auto leaves = BaseVector::create(intermediateType_, numRows, pool_);
+
+    // Leaves are computed in batches to bound the memory used for group rows.
+    VectorPtr batchLeaves = BaseVector::create(intermediateType_, 0, pool_);
+    for (vector_size_t start = 0; start < numRows;
+         start += kTreeLeavesBatchSize) {
+      const auto numGroups = std::min(kTreeLeavesBatchSize, numRows - start);
+      fillArgVectors(start, start + numGroups - 1);
+      SelectivityVector rows(numGroups);
+      aggregateTreeGroups(
+          numGroups,
+          [&](char** groups) {
+            aggregate_->addRawInput(groups, rows, argVectors_, false);
+          },
+          batchLeaves);
+      leaves->copy(batchLeaves.get(), start, 0, numGroups);
+    }
+    segmentTree_.push_back(std::move(leaves));
+
+    std::vector<char*> childGroups;
+    while (segmentTree_.back()->size() > 1) {
+      const auto& children = segmentTree_.back();
+      const auto numChildren = children->size();
+      const auto numParents =
+          bits::roundUp(numChildren, kTreeFanout) / kTreeFanout;
+      VectorPtr parents = BaseVector::create(intermediateType_, 0, pool_);
+      SelectivityVector rows(numChildren);
+      aggregateTreeGroups(
+          numParents,
+          [&](char** groups) {
+            childGroups.resize(numChildren);
+            for (auto i = 0; i < numChildren; ++i) {
+              childGroups[i] = groups[i / kTreeFanout];
+            }
+            aggregate_->addIntermediateResults(
+                childGroups.data(), rows, {children}, false);
+          },
+          parents);
+      segmentTree_.push_back(std::move(parents));
+    }
+  }
+
+  // Copies the segment tree nodes covering partition rows [begin, end) into
+  // 'treeNodes_' and returns the number of nodes copied.
+  vector_size_t gatherTreeNodes(vector_size_t begin, vector_size_t end) {
+    vector_size_t numNodes = 0;
+    auto addNodes = [&](int32_t level, vector_size_t from, vector_size_t to) {
+      if (from < to) {
+        treeNodes_->copy(segmentTree_[level].get(), numNodes, from, to - from);
+        numNodes += to - from;
+      }
+    };
+
+    for (auto level = 0; level < segmentTree_.size() && begin < end; ++level) {
+      if (level == segmentTree_.size() - 1) {
+        addNodes(level, begin, end);
+        break;
+      }
+      // Add the nodes up to the first and after the last node boundary of
+      // the next level, then continue with the range of whole parent nodes.
+      const auto alignedBegin =
+          std::min<vector_size_t>(bits::roundUp(begin, kTreeFanout), end);
+      const auto alignedEnd = std::max<vector_size_t>(
+          end / kTreeFanout * kTreeFanout, alignedBegin);
+      addNodes(level, begin, alignedBegin);
+      addNodes(level, alignedEnd, end);
+      begin = alignedBegin / kTreeFanout;
+      end = alignedEnd / kTreeFanout;
+    }
+    return numNodes;
+  }
+
+  void segmentTreeAggregation(
+      const SelectivityVector& validRows,
+      const vector_size_t* rawFrameStarts,
+      const vector_size_t* rawFrameEnds,
+      vector_size_t resultOffset,
+      const VectorPtr& result) {
+    if (segmentTree_.empty()) {
+      buildSegmentTree();
+      // A range decomposes into at most 2 * (kTreeFanout - 1) nodes per
+      // level.
+      treeNodes_ = BaseVector::create(
+          intermediateType_, 2 * kTreeFanout * segmentTree_.size(), pool_);
+    }
+
+    SelectivityVector rows;
+    validRows.applyToSelected([&](auto i) {
+      const auto numNodes =
+          gatherTreeNodes(rawFrameStarts[i], rawFrameEnds[i] + 1);
+      resetSingleGroup();
+      rows.resizeFill(numNodes, true);
+      BaseVector::prepareForReuse(aggregateResultVector_, 1);
+      aggregate_->addSingleGroupIntermediateResults(
+          rawSingleGroupRow_, rows, {treeNodes_}, false);
+      aggregate_->extractValues(
+          &rawSingleGroupRow_, 1, &aggregateResultVector_);
+      result->copy(aggregateResultVector_.get(), resultOffset + i, 0, 1);
+    });
+
+    // Set null values for empty (non valid) frames in the output block.
+    setEmptyFramesResults(validRows, resultOffset, result);
+  }
+
   void setEmptyFramesResults(
       const SelectivityVector& validRows,
       vector_size_t resultOffset,
@@ -349,6 +521,12 @@ class AggregateWindowFunction : public exec::WindowFunction {
     invalidRows_.applyToSelected(
         [&](auto i) { result->setNull(resultOffset + i, true); });
   }
+  // Number of children of each inner node of the segment tree.
+  static constexpr vector_size_t kTreeFanout = 16;
+
+  // Number of segment tree leaves aggregated at a time.
+  static constexpr vector_size_t kTreeLeavesBatchSize = 1024;
+
   // Aggregate function object required for this window function evaluation.
   std::unique_ptr<exec::Aggregate> aggregate_;
 
@@ -382,6 +560,23 @@ class AggregateWindowFunction : public exec::WindowFunction {
 
   // Used for setting null for empty frames.
   SelectivityVector invalidRows_;
+
+  // Intermediate type of the aggregate. Only set if the aggregate can be
+  // evaluated over a segment tree.
+  TypePtr intermediateType_;
+
+  // Segment tree levels of intermediate results for the current partition.
+  // Built on first use and cleared when the partition changes.
+  std::vector<VectorPtr> segmentTree_;
+
+  // Nodes of the segment tree covering the frame of the current row.
+  VectorPtr treeNodes_;
+
+  // Memory and pointers for the group rows used to build the segment tree.
+  vector_size_t groupRowStride_;
+  BufferPtr treeGroupRowsBuffer_;
+  std::vector<char*> treeGroups_;
+  std::vector<vector_size_t> treeGroupIndices_;
 };
 
 } // namespace
@@ -223,4 +223,48 @@ class MinMaxHook final : public AggregationHook {
   }
 };
 
+// Adds 1 to the count of the group for each value. Hooks only see non-null
+// values and the values themselves are not looked at, so this works for any
+// type whose reader supports ValueHooks. The count is never null.
+class CountHook final : public AggregationHook {
+ public:
+  CountHook(
+      int32_t offset,
+      int32_t nullByte,
+      uint8_t nullMask,
+      char** groups,
+      uint64_t* numNulls)
+      : AggregationHook(offset, nullByte, nullMask, groups, numNulls) {}
+
+  Kind kind() const override {
+    return kGeneric;
+  }
+
+  void addValue(vector_size_t row, const void* /*value*/) override {
+    ++*reinterpret_cast<int64_t*>(findGroup(row) + offset_);
+  }
+};
+
+// Adds 1 to the count of the group for each true boolean value.
+class CountIfHook final : public AggregationHook {
+ public:
+  CountIfHook(
+      int32_t offset,
+      int32_t nullByte,
+      uint8_t nullMask,
+      char** groups,
+      uint64_t* numNulls)
+      : AggregationHook(offset, nullByte, nullMask, groups, numNulls) {}
+
+  Kind kind() const override {
+    return kGeneric;
+  }
+
+  void addValue(vector_size_t row, const void* value) override {
+    if (*reinterpret_cast<const bool*>(value)) {
+      ++*reinterpret_cast<int64_t*>(findGroup(row) + offset_);
+    }
+  }
+};
+
 } // namespace facebook::velox::aggregate
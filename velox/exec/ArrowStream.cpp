@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 #include "velox/exec/ArrowStream.h"
+#include "velox/exec/Task.h"
+#include "velox/vector/arrow/Bridge.h"
 
 namespace facebook::velox::exec {
 
@@ -26,8 +28,13 @@ ArrowStream::ArrowStream(
           arrowStreamNode->outputType(),
           operatorId,
           arrowStreamNode->id(),
-          "ArrowStream") {
+          "ArrowStream"),
+      maxPrefetchBatches_(std::max<int32_t>(
+          0, driverCtx->queryConfig().arrowStreamPrefetchBatches())) {
   arrowStream_ = arrowStreamNode->arrowStream();
+  if (maxPrefetchBatches_ > 0) {
+    prefetch_ = std::make_shared<Prefetch>();
+  }
 }
 
 ArrowStream::~ArrowStream() {
@@ -35,6 +42,119 @@ ArrowStream::~ArrowStream() {
 }
 
 RowVectorPtr ArrowStream::getOutput() {
+  if (prefetch_ == nullptr) {
+    auto batch = fetchBatch();
+    finished_ = batch == nullptr;
+    return batch;
+  }
+
+  RowVectorPtr batch;
+  bool shouldFetch;
+  {
+    std::lock_guard<std::mutex> l(prefetch_->mutex);
+    if (prefetch_->error) {
+      std::rethrow_exception(prefetch_->error);
+    }
+    if (prefetch_->batches.empty()) {
+      finished_ = prefetch_->atEnd;
+    } else {
+      batch = std::move(prefetch_->batches.front());
+      prefetch_->batches.pop_front();
+    }
+    shouldFetch = shouldStartFetchLocked();
+  }
+  if (shouldFetch) {
+    startFetch();
+  }
+  return batch;
+}
+
+BlockingReason ArrowStream::isBlocked(ContinueFuture* future) {
+  if (prefetch_ == nullptr) {
+    return BlockingReason::kNotBlocked;
+  }
+  bool shouldFetch;
+  {
+    std::lock_guard<std::mutex> l(prefetch_->mutex);
+    if (!prefetch_->batches.empty() || prefetch_->atEnd || prefetch_->error) {
+      return BlockingReason::kNotBlocked;
+    }
+    auto [promise, blockingFuture] =
+        makeVeloxContinuePromiseContract("ArrowStream::isBlocked");
+    prefetch_->consumerPromise = std::move(promise);
+    *future = std::move(blockingFuture);
+    shouldFetch = shouldStartFetchLocked();
+  }
+  if (shouldFetch) {
+    startFetch();
+  }
+  return BlockingReason::kWaitForConnector;
+}
+
+bool ArrowStream::shouldStartFetchLocked() {
+  if (prefetch_->fetching || prefetch_->atEnd || prefetch_->closed ||
+      prefetch_->error || prefetch_->batches.size() >= maxPrefetchBatches_) {
+    return false;
+  }
+  prefetch_->fetching = true;
+  return true;
+}
+
+void ArrowStream::startFetch() {
+  operatorCtx_->task()->queryCtx()->executor()->add(
+      [this]() { fetchBatches(); });
+}
+
+void ArrowStream::fetchBatches() {
+  for (;;) {
+    {
+      std::lock_guard<std::mutex> l(prefetch_->mutex);
+      if (prefetch_->closed ||
+          prefetch_->batches.size() >= maxPrefetchBatches_) {
+        prefetch_->fetching = false;
+        prefetch_->fetchDone.notify_all();
+        return;
+      }
+    }
+
+    RowVectorPtr batch;
+    std::exception_ptr error;
+    try {
+      batch = fetchBatch();
+    } catch (const std::exception&) {
+      error = std::current_exception();
+    }
+
+    std::optional<ContinuePromise> promise;
+    bool done = false;
+    {
+      std::lock_guard<std::mutex> l(prefetch_->mutex);
+      if (error) {
+        prefetch_->error = error;
+        done = true;
+      } else if (batch == nullptr) {
+        prefetch_->atEnd = true;
+        done = true;
+      } else {
+        prefetch_->batches.push_back(std::move(batch));
+      }
+      promise = std::move(prefetch_->consumerPromise);
+      prefetch_->consumerPromise.reset();
+      if (done) {
+        prefetch_->fetching = false;
+        prefetch_->fetchDone.notify_all();
+      }
+    }
+    if (promise.has_value()) {
+      promise->setValue();
+    }
+    if (done) {
+      return;
+    }
+  }
+}
+
+RowVectorPtr ArrowStream::fetchBatch() {
   // Get Arrow array.
   struct ArrowArray arrowArray;
   if (arrowStream_->get_next(arrowStream_.get(), &arrowArray)) {
@@ -46,7 +166,6 @@ RowVectorPtr ArrowStream::getOutput() {
   }
   if (arrowArray.release == nullptr) {
     // End of Stream.
-    finished_ = true;
     return nullptr;
   }
 
@@ -65,8 +184,27 @@ RowVectorPtr ArrowStream::getOutput() {
   }
 
   // Convert Arrow Array into RowVector and return.
-  return std::dynamic_pointer_cast<RowVector>(
-      importFromArrowAsOwner(arrowSchema, arrowArray, pool()));
+  return project(std::dynamic_pointer_cast<RowVector>(
+      importFromArrowAsOwner(arrowSchema, arrowArray, pool())));
+}
+
+RowVectorPtr ArrowStream::project(RowVectorPtr batch) const {
+  const auto& inputType = batch->type()->asRow();
+  if (inputType.size() == outputType_->size() &&
+      inputType.names() == outputType_->names()) {
+    return batch;
+  }
+  std::vector<VectorPtr> children;
+  children.reserve(outputType_->size());
+  for (const auto& name : outputType_->names()) {
+    children.push_back(batch->childAt(inputType.getChildIdx(name)));
+  }
+  return std::make_shared<RowVector>(
+      pool(),
+      outputType_,
+      batch->nulls(),
+      batch->size(),
+      std::move(children));
 }
 
 bool ArrowStream::isFinished() {
@@ -80,6 +218,13 @@ const char* ArrowStream::getError() const {
 }
 
 void ArrowStream::close() {
+  if (prefetch_ != nullptr) {
+    // Waits for a running fetch to stop before releasing the stream.
+    std::unique_lock<std::mutex> l(prefetch_->mutex);
+    prefetch_->closed = true;
+    prefetch_->fetchDone.wait(l, [&]() { return !prefetch_->fetching; });
+    prefetch_->batches.clear();
+  }
   if (arrowStream_->release) {
     arrowStream_->release(arrowStream_.get());
   }
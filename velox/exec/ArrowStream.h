@@ -20,6 +20,12 @@
 
 namespace facebook::velox::exec {
 
+/// Reads the batches of an ArrowArrayStream. If the
+/// 'arrow_stream.prefetch_batches' query config is set, the batches are
+/// fetched on the query executor into a bounded queue, so that a slow
+/// producer blocks the Driver instead of the driver thread. The output type
+/// of the plan node may be a subset of the columns of the stream, which are
+/// matched by name.
 class ArrowStream : public SourceOperator {
  public:
   ArrowStream(
@@ -31,20 +37,57 @@ class ArrowStream : public SourceOperator {
 
   RowVectorPtr getOutput() override;
 
-  BlockingReason isBlocked(ContinueFuture* /* unused */) override {
-    return BlockingReason::kNotBlocked;
-  }
+  BlockingReason isBlocked(ContinueFuture* future) override;
 
   bool isFinished() override;
 
   void close() override;
 
  private:
+  // Batches fetched ahead of the consumer. Shared with the fetch running on
+  // the executor.
+  struct Prefetch {
+    std::mutex mutex;
+    std::deque<RowVectorPtr> batches;
+    // True while a fetch is running on the executor.
+    bool fetching{false};
+    // Set by the fetch at the end of the stream.
+    bool atEnd{false};
+    // Set by close() to stop the fetch.
+    bool closed{false};
+    std::exception_ptr error;
+    // Fulfilled when a batch, the end of the stream or an error arrives.
+    std::optional<ContinuePromise> consumerPromise;
+    // Notified when the fetch stops.
+    std::condition_variable fetchDone;
+  };
+
+  // Returns the next batch or nullptr at the end of the stream.
+  RowVectorPtr fetchBatch();
+
+  // Returns true and marks a fetch as running unless one is running, the
+  // queue is full or the stream has ended. The caller then calls startFetch()
+  // after releasing 'prefetch_->mutex'.
+  bool shouldStartFetchLocked();
+
+  // Runs fetchBatches() on the query executor.
+  void startFetch();
+
+  // Fetches batches until the queue is full or the stream ends.
+  void fetchBatches();
+
   /// Return last error in Arrow array stream.
   const char* getError() const;
 
+  // Selects the columns of the output type from 'batch' unless they are the
+  // same.
+  RowVectorPtr project(RowVectorPtr batch) const;
+
+  const uint32_t maxPrefetchBatches_;
+
   bool finished_ = false;
   std::shared_ptr<ArrowArrayStream> arrowStream_;
+  std::shared_ptr<Prefetch> prefetch_;
 };
 
 } // namespace facebook::velox::exec
@@ -82,25 +82,29 @@ void AssignUniqueId::generateIdColumn(vector_size_t size) {
   auto rawResults =
       result->asUnchecked<FlatVector<int64_t>>()->mutableRawValues();
 
+  // Fills the ids of the block reserved by the last requestRowIds() and
+  // reserves another one when it runs out. A block covers many batches, so
+  // this is typically a single iota over the whole batch.
   vector_size_t start = 0;
   while (start < size) {
     if (rowIdCounter_ >= maxRowIdCounterValue_) {
       requestRowIds();
     }
 
-    auto batchSize =
-        std::min(maxRowIdCounterValue_ - rowIdCounter_ + 1, kRowIdsPerRequest);
-    auto end = (int32_t)std::min((int64_t)size, start + batchSize);
-    VELOX_CHECK_EQ((rowIdCounter_ + end - 1) & uniqueValueMask_, 0);
+    const auto numIds = std::min<int64_t>(
+        maxRowIdCounterValue_ - rowIdCounter_, size - start);
+    const auto end = start + static_cast<vector_size_t>(numIds);
     std::iota(
         rawResults + start, rawResults + end, uniqueValueMask_ | rowIdCounter_);
-    rowIdCounter_ += end;
+    rowIdCounter_ += numIds;
     start = end;
   }
 }
 
 void AssignUniqueId::requestRowIds() {
   rowIdCounter_ = rowIdPool_->fetch_add(kRowIdsPerRequest);
+  VELOX_CHECK_LT(
+      rowIdCounter_, kMaxRowId, "Ran out of unique row ids for the task");
   maxRowIdCounterValue_ =
       std::min(rowIdCounter_ + kRowIdsPerRequest, kMaxRowId);
 }
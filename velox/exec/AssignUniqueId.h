@@ -60,6 +60,8 @@ class AssignUniqueId : public Operator {
   const int64_t kTaskUniqueIdLimit = 1L << 24;
 
   int64_t uniqueValueMask_;
+  // Next id to assign and the end of the block of ids reserved from
+  // 'rowIdPool_'.
   int64_t rowIdCounter_;
   int64_t maxRowIdCounterValue_;
 
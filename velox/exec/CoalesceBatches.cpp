@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/CoalesceBatches.h"
+#include "velox/exec/OperatorUtils.h"
+
+namespace facebook::velox::exec {
+
+CoalesceBatches::CoalesceBatches(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    RowTypePtr outputType)
+    : Operator(driverCtx, outputType, operatorId, "N/A", "CoalesceBatches"),
+      targetRows_(driverCtx->queryConfig().preferredOutputBatchSize()),
+      smallBatchRows_(std::max<vector_size_t>(1, targetRows_ / 4)) {
+  isIdentityProjection_ = true;
+
+  const auto numColumns = outputType->size();
+  identityProjections_.reserve(numColumns);
+  for (column_index_t i = 0; i < numColumns; ++i) {
+    identityProjections_.emplace_back(i, i);
+  }
+}
+
+void CoalesceBatches::addInput(RowVectorPtr input) {
+  VELOX_CHECK_NULL(output_);
+  if (batches_.empty() && input->size() >= smallBatchRows_) {
+    output_ = std::move(input);
+    return;
+  }
+
+  // The upstream operator may produce its next batch from the same source
+  // before 'input' is copied.
+  loadColumns(input, *operatorCtx_->execCtx());
+  const bool isSmall = input->size() < smallBatchRows_;
+  numRows_ += input->size();
+  retainedBytes_ += input->retainedSize();
+  batches_.push_back(std::move(input));
+  if (!isSmall || numRows_ >= targetRows_ ||
+      retainedBytes_ >= kMaxRetainedBytes) {
+    flush();
+  }
+}
+
+RowVectorPtr CoalesceBatches::getOutput() {
+  if (output_ == nullptr && noMoreInput_ && !batches_.empty()) {
+    flush();
+  }
+  return std::move(output_);
+}
+
+void CoalesceBatches::flush() {
+  if (batches_.size() > 1) {
+    addRuntimeStat("coalescedBatches", RuntimeCounter(batches_.size()));
+  }
+  output_ = coalesceBatches(outputType_, batches_, pool());
+  batches_.clear();
+  numRows_ = 0;
+  retainedBytes_ = 0;
+}
+} // namespace facebook::velox::exec
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/exec/Operator.h"
+
+namespace facebook::velox::exec {
+
+/// Accumulates the small batches of a selective upstream operator into
+/// batches of about QueryConfig::preferredOutputBatchSize() rows, so that the
+/// downstream operators pay their per batch overhead per thousand rows, not
+/// per tens of rows. Batches that are not small pass through as is. Small
+/// batches are held until enough rows are accumulated and are copied into one
+/// flat batch only then. Inserted by the LocalPlanner after filters and hash
+/// joins if QueryConfig::coalesceSmallBatches() is true.
+class CoalesceBatches : public Operator {
+ public:
+  CoalesceBatches(
+      int32_t operatorId,
+      DriverCtx* driverCtx,
+      RowTypePtr outputType);
+
+  bool needsInput() const override {
+    return !noMoreInput_ && output_ == nullptr;
+  }
+
+  void addInput(RowVectorPtr input) override;
+
+  RowVectorPtr getOutput() override;
+
+  BlockingReason isBlocked(ContinueFuture* /*future*/) override {
+    return BlockingReason::kNotBlocked;
+  }
+
+  bool isFinished() override {
+    return noMoreInput_ && batches_.empty() && output_ == nullptr;
+  }
+
+ private:
+  // The held batches are flushed once they retain this many bytes, even if
+  // they have fewer than 'targetRows_' rows. Small dictionary wrapped
+  // batches can retain large base vectors.
+  static constexpr uint64_t kMaxRetainedBytes = 16 << 20;
+
+  // Moves the rows of 'batches_' into 'output_'.
+  void flush();
+
+  // The number of rows to accumulate.
+  const vector_size_t targetRows_;
+
+  // Batches with fewer rows are held and coalesced.
+  const vector_size_t smallBatchRows_;
+
+  // The held small batches. Their lazy vectors are loaded.
+  std::vector<RowVectorPtr> batches_;
+
+  // The number of rows and retained bytes of 'batches_'.
+  vector_size_t numRows_{0};
+  uint64_t retainedBytes_{0};
+
+  RowVectorPtr output_;
+};
+} // namespace facebook::velox::exec
@@ -18,12 +18,15 @@
 
 namespace facebook::velox::exec {
 
-void CrossJoinBridge::setData(std::vector<VectorPtr> data) {
+void CrossJoinBridge::setData(
+    std::vector<VectorPtr> data,
+    std::vector<std::shared_ptr<const SpillFile>> spillFiles) {
   std::vector<ContinuePromise> promises;
   {
     std::lock_guard<std::mutex> l(mutex_);
     VELOX_CHECK(!data_.has_value(), "setData may be called only once");
     data_ = std::move(data);
+    spillFiles_ = std::move(spillFiles);
     promises = std::move(promises_);
   }
   notify(std::move(promises));
@@ -41,6 +44,12 @@ std::optional<std::vector<VectorPtr>> CrossJoinBridge::dataOrFuture(
   return std::nullopt;
 }
 
+std::vector<std::shared_ptr<const SpillFile>> CrossJoinBridge::spillFiles() {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(data_.has_value());
+  return spillFiles_;
+}
+
 CrossJoinBuild::CrossJoinBuild(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -50,7 +59,15 @@ CrossJoinBuild::CrossJoinBuild(
           nullptr,
           operatorId,
           joinNode->id(),
-          "CrossJoinBuild") {}
+          "CrossJoinBuild"),
+      // The cross join build writes the spill files directly and only uses the
+      // file path and size settings of the spill config.
+      spillConfig_(
+          joinNode->canSpill(driverCtx->queryConfig())
+              ? operatorCtx_->makeSpillConfig(Spiller::Type::kHashJoinBuild)
+              : std::nullopt),
+      spillMemoryThreshold_(
+          driverCtx->queryConfig().joinSpillMemoryThreshold()) {}
 
 void CrossJoinBuild::addInput(RowVectorPtr input) {
   if (input->size() > 0) {
@@ -58,10 +75,73 @@ void CrossJoinBuild::addInput(RowVectorPtr input) {
     for (auto& child : input->children()) {
       child->loadedVector();
     }
+    dataBytes_ += input->estimateFlatSize();
     data_.emplace_back(std::move(input));
+    maybeSpill();
+  }
+}
+
+void CrossJoinBuild::maybeSpill() {
+  if (!spillEnabled()) {
+    return;
+  }
+  // Test-only spill path.
+  const auto testSpillPct = spillConfig_->testSpillPct;
+  if (testSpillPct != 0 &&
+      folly::hasher<uint64_t>()(++spillTestCounter_) % 100 <= testSpillPct) {
+    spill();
+    return;
+  }
+  if (spillMemoryThreshold_ != 0 && dataBytes_ > spillMemoryThreshold_) {
+    spill();
   }
 }
 
+void CrossJoinBuild::spill() {
+  if (spillFileList_ == nullptr) {
+    spillFileList_ = std::make_unique<SpillFileList>(
+        asRowType(data_.front()->type()),
+        0,
+        std::vector<CompareFlags>{},
+        spillConfig_->filePath,
+        spillConfig_->maxFileSize,
+        Spiller::spillPool(),
+        spillConfig_->compressionKind,
+        spillConfig_->writeCallback);
+  }
+  uint64_t numRows = 0;
+  for (const auto& vector : data_) {
+    IndexRange range{0, vector->size()};
+    spillFileList_->write(
+        std::static_pointer_cast<RowVector>(vector),
+        folly::Range<IndexRange*>(&range, 1));
+    numRows += vector->size();
+  }
+  {
+    auto lockedStats = stats_.wlock();
+    lockedStats->spilledRows += numRows;
+  }
+  data_.clear();
+  dataBytes_ = 0;
+}
+
+std::vector<std::shared_ptr<const SpillFile>> CrossJoinBuild::finishSpill() {
+  std::vector<std::shared_ptr<const SpillFile>> spillFiles;
+  if (spillFileList_ == nullptr) {
+    return spillFiles;
+  }
+  {
+    auto lockedStats = stats_.wlock();
+    lockedStats->spilledBytes += spillFileList_->spilledBytes();
+    lockedStats->spilledFiles += spillFileList_->spilledFiles();
+  }
+  for (auto& file : spillFileList_->files()) {
+    spillFiles.push_back(std::move(file));
+  }
+  spillFileList_.reset();
+  return spillFiles;
+}
+
 BlockingReason CrossJoinBuild::isBlocked(ContinueFuture* future) {
   if (!future_.valid()) {
     return BlockingReason::kNotBlocked;
@@ -84,11 +164,15 @@ void CrossJoinBuild::noMoreInput() {
     return;
   }
 
+  auto spillFiles = finishSpill();
   for (auto& peer : peers) {
     auto op = peer->findOperator(planNodeId());
     auto* build = dynamic_cast<CrossJoinBuild*>(op);
     VELOX_CHECK(build);
     data_.insert(data_.begin(), build->data_.begin(), build->data_.end());
+    for (auto& file : build->finishSpill()) {
+      spillFiles.push_back(std::move(file));
+    }
   }
 
   // Realize the promises so that the other Drivers (which were not
@@ -101,7 +185,7 @@ void CrossJoinBuild::noMoreInput() {
   operatorCtx_->task()
       ->getCrossJoinBridge(
           operatorCtx_->driverCtx()->splitGroupId, planNodeId())
-      ->setData(std::move(data_));
+      ->setData(std::move(data_), std::move(spillFiles));
 }
 
 bool CrossJoinBuild::isFinished() {
@@ -17,17 +17,28 @@
 
 #include "velox/exec/JoinBridge.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/Spill.h"
 
 namespace facebook::velox::exec {
 
 class CrossJoinBridge : public JoinBridge {
  public:
-  void setData(std::vector<VectorPtr> data);
+  /// Sets the build side data: the batches kept in memory in 'data' and the
+  /// spill files of the spilled batches in 'spillFiles'.
+  void setData(
+      std::vector<VectorPtr> data,
+      std::vector<std::shared_ptr<const SpillFile>> spillFiles = {});
 
   std::optional<std::vector<VectorPtr>> dataOrFuture(ContinueFuture* future);
 
+  /// Returns the spill files of the spilled build side batches. The probe side
+  /// reads each file once per probe batch. Must be called after dataOrFuture()
+  /// has returned the data.
+  std::vector<std::shared_ptr<const SpillFile>> spillFiles();
+
  private:
   std::optional<std::vector<VectorPtr>> data_;
+  std::vector<std::shared_ptr<const SpillFile>> spillFiles_;
 };
 
 class CrossJoinBuild : public Operator {
@@ -55,12 +66,43 @@ class CrossJoinBuild : public Operator {
 
   void close() override {
     data_.clear();
+    spillFileList_.reset();
     Operator::close();
   }
 
  private:
+  bool spillEnabled() const {
+    return spillConfig_.has_value();
+  }
+
+  // Spills all the batches in 'data_' if disk spilling is enabled and the
+  // batches take more than 'spillMemoryThreshold_' bytes.
+  void maybeSpill();
+
+  // Spills all the batches in 'data_' to 'spillFileList_'.
+  void spill();
+
+  // Returns the spill files written by this operator.
+  std::vector<std::shared_ptr<const SpillFile>> finishSpill();
+
+  const std::optional<Spiller::Config> spillConfig_;
+
+  // The max bytes of the batches in 'data_' before spilling. If it is 0, there
+  // is no limit.
+  const uint64_t spillMemoryThreshold_;
+
   std::vector<VectorPtr> data_;
 
+  // The estimated flat size of the batches in 'data_'.
+  int64_t dataBytes_{0};
+
+  // The spill files of the spilled batches. Created on first spill.
+  std::unique_ptr<SpillFileList> spillFileList_;
+
+  // Counts input batches and triggers spilling if folly hash of this % 100 <=
+  // 'testSpillPct'.
+  uint64_t spillTestCounter_{0};
+
   // Future for synchronizing with other Drivers of the same pipeline. All build
   // Drivers must be completed before making data available for the probe side.
   ContinueFuture future_{ContinueFuture::makeEmpty()};
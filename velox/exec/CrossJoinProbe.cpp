@@ -28,7 +28,8 @@ CrossJoinProbe::CrossJoinProbe(
           operatorId,
           joinNode->id(),
           "CrossJoinProbe"),
-      outputBatchSize_{driverCtx->queryConfig().preferredOutputBatchSize()} {
+      outputBatchSize_{driverCtx->queryConfig().preferredOutputBatchSize()},
+      joinType_{joinNode->joinType()} {
   bool isIdentityProjection = true;
 
   auto probeType = joinNode->sources()[0]->outputType();
@@ -51,30 +52,74 @@ CrossJoinProbe::CrossJoinProbe(
     }
   }
 
-  if (isIdentityProjection && buildProjections_.empty()) {
+  if (joinNode->filter()) {
+    initializeFilter(joinNode->filter(), probeType, buildType);
+  }
+
+  if (isIdentityProjection && buildProjections_.empty() && !filter_ &&
+      isInnerJoin(joinType_)) {
     isIdentityProjection_ = true;
   }
 }
 
+void CrossJoinProbe::initializeFilter(
+    const core::TypedExprPtr& filter,
+    const RowTypePtr& probeType,
+    const RowTypePtr& buildType) {
+  std::vector<core::TypedExprPtr> filters = {filter};
+  filter_ =
+      std::make_unique<ExprSet>(std::move(filters), operatorCtx_->execCtx());
+
+  column_index_t filterChannel = 0;
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  auto numFields = filter_->expr(0)->distinctFields().size();
+  names.reserve(numFields);
+  types.reserve(numFields);
+  for (const auto& field : filter_->expr(0)->distinctFields()) {
+    const auto& name = field->field();
+    auto channel = probeType->getChildIdxIfExists(name);
+    if (channel.has_value()) {
+      auto channelValue = channel.value();
+      filterProbeInputs_.emplace_back(channelValue, filterChannel++);
+      names.emplace_back(probeType->nameOf(channelValue));
+      types.emplace_back(probeType->childAt(channelValue));
+      continue;
+    }
+    channel = buildType->getChildIdxIfExists(name);
+    if (channel.has_value()) {
+      auto channelValue = channel.value();
+      filterBuildInputs_.emplace_back(channelValue, filterChannel++);
+      names.emplace_back(buildType->nameOf(channelValue));
+      types.emplace_back(buildType->childAt(channelValue));
+      continue;
+    }
+    VELOX_FAIL(
+        "Cross join filter field not found in either probe or build input: {}",
+        field->toString());
+  }
+
+  filterInputType_ = ROW(std::move(names), std::move(types));
+}
+
 BlockingReason CrossJoinProbe::isBlocked(ContinueFuture* future) {
   if (buildData_.has_value()) {
     return BlockingReason::kNotBlocked;
   }
 
-  auto buildData =
-      operatorCtx_->task()
-          ->getCrossJoinBridge(
-              operatorCtx_->driverCtx()->splitGroupId, planNodeId())
-          ->dataOrFuture(future);
+  auto bridge = operatorCtx_->task()->getCrossJoinBridge(
+      operatorCtx_->driverCtx()->splitGroupId, planNodeId());
+  auto buildData = bridge->dataOrFuture(future);
   if (!buildData.has_value()) {
     return BlockingReason::kWaitForJoinBuild;
   }
 
   buildData_ = std::move(buildData);
+  buildSpillFiles_ = bridge->spillFiles();
 
-  if (buildData_->empty()) {
+  if (buildData_->empty() && buildSpillFiles_.empty()) {
     // Build side is empty. Return empty set of rows and  terminate the pipeline
-    // early.
+    // early. A left join returns the probe rows with nulls instead.
     buildSideEmpty_ = true;
   }
 
@@ -89,6 +134,54 @@ void CrossJoinProbe::addInput(RowVectorPtr input) {
     child->loadedVector();
   }
   input_ = std::move(input);
+  if (buildSideEmpty_) {
+    return;
+  }
+  if (buildData_->empty()) {
+    // All the build side vectors have been spilled.
+    VELOX_CHECK(nextSpilledBuildVector());
+  }
+  if (isLeftJoin(joinType_) && filter_) {
+    probeMatched_.resize(input_->size());
+    probeMatched_.clearAll();
+  }
+}
+
+bool CrossJoinProbe::nextSpilledBuildVector() {
+  while (buildSpillFileIndex_ < buildSpillFiles_.size()) {
+    if (buildSpillReader_ == nullptr) {
+      buildSpillReader_ =
+          buildSpillFiles_[buildSpillFileIndex_]->makeReader(*pool());
+    }
+    RowVectorPtr batch;
+    if (buildSpillReader_->nextBatch(batch)) {
+      if (batch->size() > 0) {
+        spilledBuildVector_ = std::move(batch);
+        return true;
+      }
+      continue;
+    }
+    buildSpillReader_.reset();
+    ++buildSpillFileIndex_;
+  }
+  return false;
+}
+
+bool CrossJoinProbe::advanceBuildVector() {
+  if (buildIndex_ < buildData_->size()) {
+    ++buildIndex_;
+    if (buildIndex_ < buildData_->size()) {
+      return true;
+    }
+  }
+  if (nextSpilledBuildVector()) {
+    return true;
+  }
+  // Restarts from the first build side vector for the next input.
+  buildIndex_ = 0;
+  buildSpillFileIndex_ = 0;
+  spilledBuildVector_.reset();
+  return false;
 }
 
 RowVectorPtr CrossJoinProbe::getOutput() {
@@ -96,9 +189,35 @@ RowVectorPtr CrossJoinProbe::getOutput() {
     return nullptr;
   }
 
+  if (buildSideEmpty_) {
+    // Left join with an empty build side.
+    auto output = fillMissOutput(input_->size(), nullptr);
+    input_.reset();
+    return output;
+  }
+
+  for (;;) {
+    if (probeFinished_) {
+      // All pairs for 'input_' have been produced. Return the probe rows for
+      // which no pair passed the filter.
+      probeFinished_ = false;
+      auto output = getMissOutput();
+      input_.reset();
+      return output;
+    }
+
+    auto output = getCrossProductOutput();
+    if (output != nullptr || input_ == nullptr) {
+      return output;
+    }
+  }
+}
+
+RowVectorPtr CrossJoinProbe::getCrossProductOutput() {
   const auto inputSize = input_->size();
 
-  auto buildSize = buildData_.value()[buildIndex_]->size();
+  const auto& currentBuild = currentBuildVector();
+  auto buildSize = currentBuild->size();
   vector_size_t probeCnt;
   if (buildSize > outputBatchSize_) {
     probeCnt = 1;
@@ -116,10 +235,9 @@ RowVectorPtr CrossJoinProbe::getOutput() {
         rawIndices + (i + 1) * buildSize,
         probeRow_ + i);
   }
-  auto output = fillOutput(size, indices);
 
   BufferPtr buildIndices = nullptr;
-  if (probeCnt > 1) {
+  if (probeCnt > 1 || filter_) {
     buildIndices = allocateIndices(size, pool());
     auto* rawBuildIndices = buildIndices->asMutable<vector_size_t>();
     for (auto i = 0; i < probeCnt; ++i) {
@@ -130,36 +248,130 @@ RowVectorPtr CrossJoinProbe::getOutput() {
     }
   }
 
-  auto buildRowVector =
-      buildData_.value()[buildIndex_]->asUnchecked<RowVector>();
-  for (const auto& projection : buildProjections_) {
-    VectorPtr buildVector = buildRowVector->childAt(projection.inputChannel);
+  auto buildRowVector = currentBuild->asUnchecked<RowVector>();
+  if (filter_) {
+    // Keep only the pairs that pass the filter. The filter sees the block of
+    // pairs through dictionaries over the probe and build vectors, so that
+    // the pairs which do not pass are never copied.
+    size = evalFilter(size, indices, buildIndices, *buildRowVector);
+    if (isLeftJoin(joinType_)) {
+      for (auto i = 0; i < size; ++i) {
+        probeMatched_.setValid(rawIndices[i], true);
+      }
+    }
+  }
 
-    if (buildIndices) {
-      buildVector = BaseVector::wrapInDictionary(
-          BufferPtr(nullptr), buildIndices, size, buildVector);
+  RowVectorPtr output;
+  if (size > 0) {
+    output = fillOutput(size, indices);
+    for (const auto& projection : buildProjections_) {
+      VectorPtr buildVector = buildRowVector->childAt(projection.inputChannel);
+
+      if (buildIndices) {
+        buildVector = BaseVector::wrapInDictionary(
+            BufferPtr(nullptr), buildIndices, size, buildVector);
+      }
+      output->childAt(projection.outputChannel) = buildVector;
     }
-    output->childAt(projection.outputChannel) = buildVector;
   }
 
   probeRow_ += probeCnt;
   if (probeRow_ == inputSize) {
     probeRow_ = 0;
-    ++buildIndex_;
-    if (buildIndex_ == buildData_->size()) {
-      buildIndex_ = 0;
-      input_.reset();
+    if (!advanceBuildVector()) {
+      if (isLeftJoin(joinType_) && filter_) {
+        probeFinished_ = true;
+      } else {
+        input_.reset();
+      }
+    }
+  }
+  return output;
+}
+
+vector_size_t CrossJoinProbe::evalFilter(
+    vector_size_t size,
+    BufferPtr& probeIndices,
+    BufferPtr& buildIndices,
+    const RowVector& build) {
+  std::vector<VectorPtr> filterColumns(filterInputType_->size());
+  for (const auto& projection : filterProbeInputs_) {
+    filterColumns[projection.outputChannel] = BaseVector::wrapInDictionary(
+        BufferPtr(nullptr),
+        probeIndices,
+        size,
+        input_->childAt(projection.inputChannel));
+  }
+  for (const auto& projection : filterBuildInputs_) {
+    filterColumns[projection.outputChannel] = BaseVector::wrapInDictionary(
+        BufferPtr(nullptr),
+        buildIndices,
+        size,
+        build.childAt(projection.inputChannel));
+  }
+  auto filterInput = std::make_shared<RowVector>(
+      pool(), filterInputType_, nullptr, size, std::move(filterColumns));
+
+  filterRows_.resize(size);
+  filterRows_.setAll();
+  EvalCtx evalCtx(operatorCtx_->execCtx(), filter_.get(), filterInput.get());
+  filter_->eval(0, 1, true, filterRows_, evalCtx, filterResult_);
+  decodedFilterResult_.decode(*filterResult_[0], filterRows_);
+
+  // Compact the indices of the passing pairs in place.
+  auto* rawProbeIndices = probeIndices->asMutable<vector_size_t>();
+  auto* rawBuildIndices = buildIndices->asMutable<vector_size_t>();
+  vector_size_t numPassed = 0;
+  for (auto i = 0; i < size; ++i) {
+    if (!decodedFilterResult_.isNullAt(i) &&
+        decodedFilterResult_.valueAt<bool>(i)) {
+      rawProbeIndices[numPassed] = rawProbeIndices[i];
+      rawBuildIndices[numPassed] = rawBuildIndices[i];
+      ++numPassed;
+    }
+  }
+  return numPassed;
+}
+
+RowVectorPtr CrossJoinProbe::getMissOutput() {
+  const auto inputSize = input_->size();
+  probeMatched_.updateBounds();
+  const auto numMisses = inputSize - probeMatched_.countSelected();
+  if (numMisses == 0) {
+    return nullptr;
+  }
+  BufferPtr indices = allocateIndices(numMisses, pool());
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  vector_size_t numOut = 0;
+  for (auto i = 0; i < inputSize; ++i) {
+    if (!probeMatched_.isValid(i)) {
+      rawIndices[numOut++] = i;
     }
   }
+  return fillMissOutput(numMisses, indices);
+}
+
+RowVectorPtr CrossJoinProbe::fillMissOutput(
+    vector_size_t size,
+    BufferPtr indices) {
+  auto output = fillOutput(size, std::move(indices));
+  for (const auto& projection : buildProjections_) {
+    output->childAt(projection.outputChannel) = BaseVector::createNullConstant(
+        outputType_->childAt(projection.outputChannel), size, pool());
+  }
   return output;
 }
 
 bool CrossJoinProbe::isFinished() {
-  return buildSideEmpty_ || (noMoreInput_ && input_ == nullptr);
+  return (buildSideEmpty_ && isInnerJoin(joinType_)) ||
+      (noMoreInput_ && input_ == nullptr);
 }
 
 void CrossJoinProbe::close() {
   buildData_.reset();
+  buildSpillFiles_.clear();
+  buildSpillReader_.reset();
+  spilledBuildVector_.reset();
   Operator::close();
 }
 } // namespace facebook::velox::exec
@@ -31,7 +31,8 @@ class CrossJoinProbe : public Operator {
   RowVectorPtr getOutput() override;
 
   bool needsInput() const override {
-    return !noMoreInput_ && !input_ && !buildSideEmpty_;
+    return !noMoreInput_ && !input_ &&
+        !(buildSideEmpty_ && core::isInnerJoin(joinType_));
   }
 
   BlockingReason isBlocked(ContinueFuture* future) override;
@@ -41,17 +42,101 @@ class CrossJoinProbe : public Operator {
   void close() override;
 
  private:
+  // Sets up 'filter_' and the mapping of its inputs to probe and build
+  // columns.
+  void initializeFilter(
+      const core::TypedExprPtr& filter,
+      const RowTypePtr& probeType,
+      const RowTypePtr& buildType);
+
+  // Produces the next block of the cross product of 'input_' and the current
+  // build vector, keeping only the pairs passing 'filter_' if set. Returns
+  // nullptr if no pair in the block passes. Advances to the next block and
+  // resets 'input_' or sets 'probeFinished_' after the last one.
+  RowVectorPtr getCrossProductOutput();
+
+  // Evaluates 'filter_' over 'size' pairs of rows of 'input_' in
+  // 'probeIndices' and rows of 'build' in 'buildIndices'. Compacts both
+  // index buffers to the passing pairs and returns their number.
+  vector_size_t evalFilter(
+      vector_size_t size,
+      BufferPtr& probeIndices,
+      BufferPtr& buildIndices,
+      const RowVector& build);
+
+  // Returns the rows of 'input_' not set in 'probeMatched_' with nulls in the
+  // build side columns, or nullptr if all rows have a match. Used for left
+  // joins with a filter.
+  RowVectorPtr getMissOutput();
+
+  // Returns 'size' rows of 'input_' selected by 'indices' with nulls in the
+  // build side columns.
+  RowVectorPtr fillMissOutput(vector_size_t size, BufferPtr indices);
+
   /// Maximum number of rows in the output batch.
   const uint32_t outputBatchSize_;
 
+  const core::JoinType joinType_;
+
+  // Optional join condition. Evaluated over the pairs of probe and build rows
+  // of each block of the cross product.
+  std::unique_ptr<ExprSet> filter_;
+
+  // Input type of 'filter_' and the mappings of probe and build columns to
+  // its channels.
+  RowTypePtr filterInputType_;
+  std::vector<IdentityProjection> filterProbeInputs_;
+  std::vector<IdentityProjection> filterBuildInputs_;
+
+  // Reusable memory for filter evaluation.
+  SelectivityVector filterRows_;
+  std::vector<VectorPtr> filterResult_;
+  DecodedVector decodedFilterResult_;
+
+  // Left join with a filter: the rows of 'input_' that have at least one
+  // pair passing the filter.
+  SelectivityVector probeMatched_;
+
+  // Left join with a filter: true if all pairs for 'input_' have been
+  // produced and the rows without a match remain to be returned.
+  bool probeFinished_{false};
+
   std::vector<IdentityProjection> buildProjections_;
 
+  // Returns the build side vector to process on next call to getOutput().
+  const VectorPtr& currentBuildVector() const {
+    return buildIndex_ < buildData_->size() ? buildData_.value()[buildIndex_]
+                                            : spilledBuildVector_;
+  }
+
+  // Moves to the next build side vector. Returns false if all the build side
+  // vectors have been processed for the current input.
+  bool advanceBuildVector();
+
+  // Reads the next spilled build side vector into 'spilledBuildVector_'.
+  // Returns false if all the spill files have been read.
+  bool nextSpilledBuildVector();
+
   std::optional<std::vector<VectorPtr>> buildData_;
 
+  // The spill files of the build side batches which didn't fit in memory.
+  // These are read once for each input after the batches in 'buildData_'.
+  std::vector<std::shared_ptr<const SpillFile>> buildSpillFiles_;
+
   // Index into buildData_ for the build side vector to process on next call to
-  // getOutput().
+  // getOutput(). Set to the size of 'buildData_' while processing the spilled
+  // build side vectors.
   size_t buildIndex_{0};
 
+  // Index into 'buildSpillFiles_' for the spill file being read.
+  size_t buildSpillFileIndex_{0};
+
+  // Reads the spill file at 'buildSpillFileIndex_'.
+  std::unique_ptr<BatchStream> buildSpillReader_;
+
+  // The spilled build side vector being processed.
+  VectorPtr spilledBuildVector_;
+
   // Input row to process on next call to getOutput().
   vector_size_t probeRow_{0};
 
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <folly/Random.h>
 #include <folly/ScopeGuard.h>
 #include <folly/executors/QueuedImmediateExecutor.h>
 #include <folly/executors/task_queue/UnboundedBlockingQueue.h>
@@ -81,6 +82,11 @@ void BlockingState::setResume(std::shared_ptr<BlockingState> state) {
         if (!driver->state().isTerminated) {
           state->operator_->recordBlockingTime(
               state->sinceMicros_, state->reason_);
+          driver->addTimelineEvent(
+              DriverTimelineEvent::Kind::kBlocked,
+              state->sinceMicros_,
+              StopReason::kNone,
+              state->reason_);
         }
         VELOX_CHECK(!driver->state().isSuspended);
         VELOX_CHECK(driver->state().hasBlockingFuture);
@@ -177,8 +183,15 @@ void Driver::enqueue(std::shared_ptr<Driver> driver) {
   if (driver->closed_) {
     return;
   }
-  driver->task()->queryCtx()->executor()->add(
-      [driver]() { Driver::run(driver); });
+  auto* executor = driver->task()->queryCtx()->executor();
+  const auto numPriorities = executor->getNumPriorities();
+  if (numPriorities > 1) {
+    executor->addWithPriority(
+        [driver]() { Driver::run(driver); },
+        driver->task()->schedulingPriority(numPriorities));
+  } else {
+    executor->add([driver]() { Driver::run(driver); });
+  }
 }
 
 Driver::Driver(
@@ -189,9 +202,26 @@ Driver::Driver(
   // Operators need access to their Driver for adaptation.
   ctx_->driver = this;
   trackOperatorCpuUsage_ = ctx_->queryConfig().operatorTrackCpuUsage();
+  trackOperatorPerfCounters_ = ctx_->queryConfig().operatorTrackPerfCounters();
+  timeSliceMicros_ = ctx_->queryConfig().driverTimeSliceMs() * 1'000UL;
+  const auto samplePct = ctx_->queryConfig().driverTimelineSamplePct();
+  sampleTimeline_ = samplePct > 0 && folly::Random::rand32(100) < samplePct;
 }
 
 namespace {
+void addPerfCounterStats(Operator* op, const PerfCounterValues& counts) {
+  auto lockedStats = op->stats().wlock();
+  lockedStats->addRuntimeStat("perfCycles", RuntimeCounter(counts.cycles));
+  lockedStats->addRuntimeStat(
+      "perfInstructions", RuntimeCounter(counts.instructions));
+  lockedStats->addRuntimeStat(
+      "perfLlcMisses", RuntimeCounter(counts.llcMisses));
+  lockedStats->addRuntimeStat(
+      "perfDtlbMisses", RuntimeCounter(counts.dtlbMisses));
+  lockedStats->addRuntimeStat(
+      "perfBranchMisses", RuntimeCounter(counts.branchMisses));
+}
+
 /// Checks if output channel is produced using identity projection and returns
 /// input channel if so.
 std::optional<column_index_t> getIdentityProjection(
@@ -258,7 +288,10 @@ RowVectorPtr Driver::next(std::shared_ptr<BlockingState>& blockingState) {
 
   auto self = shared_from_this();
   RowVectorPtr result;
+  runStartMicros_ = getCurrentTimeMicro();
   auto stop = runInternal(self, blockingState, result);
+  addTimelineEvent(DriverTimelineEvent::Kind::kRun, runStartMicros_, stop);
+  runStartMicros_ = 0;
 
   // We get kBlock if 'result' was produced; kAtEnd if pipeline has finished
   // processing and no more results will be produced; kAlreadyTerminated on
@@ -270,6 +303,11 @@ RowVectorPtr Driver::next(std::shared_ptr<BlockingState>& blockingState) {
   return result;
 }
 
+bool Driver::timeSliceExpired() const {
+  return timeSliceMicros_ > 0 && timeSliceStartMicros_ > 0 &&
+      getCurrentTimeMicro() - timeSliceStartMicros_ >= timeSliceMicros_;
+}
+
 void Driver::enqueueInternal() {
   VELOX_CHECK(!state_.isEnqueued);
   state_.isEnqueued = true;
@@ -282,6 +320,7 @@ StopReason Driver::runInternal(
     std::shared_ptr<BlockingState>& blockingState,
     RowVectorPtr& result) {
   auto queuedTime = (getCurrentTimeMicro() - queueTimeStartMicros_) * 1'000;
+  addTimelineEvent(DriverTimelineEvent::Kind::kQueued, queueTimeStartMicros_);
   // Update the next operator's queueTime.
   auto stop = closed_ ? StopReason::kTerminate : task()->enter(state_);
   if (stop != StopReason::kNone) {
@@ -337,12 +376,18 @@ StopReason Driver::runInternal(
           guard.notThrown();
           return stop;
         }
+        if (timeSliceExpired()) {
+          task()->addTimeSliceYield();
+          guard.notThrown();
+          return StopReason::kYield;
+        }
 
         auto op = operators_[i].get();
         // In case we are blocked, this index will point to the operator, whose
         // queuedTime we should update.
         curOpIndex_ = i;
         RuntimeStatWriterScopeGuard statsWriterGuard(op);
+        process::ThreadTagScopeGuard tagGuard(&op->threadTag());
 
         blockingReason_ = op->isBlocked(&future);
         if (blockingReason_ != BlockingReason::kNotBlocked) {
@@ -355,6 +400,7 @@ StopReason Driver::runInternal(
         if (i < operators_.size() - 1) {
           nextOp = operators_[i + 1].get();
           RuntimeStatWriterScopeGuard statsWriterGuard(nextOp);
+          process::ThreadTagScopeGuard tagGuard(&nextOp->threadTag());
           blockingReason_ = nextOp->isBlocked(&future);
           if (blockingReason_ != BlockingReason::kNotBlocked) {
             blockingState = std::make_shared<BlockingState>(
@@ -370,7 +416,12 @@ StopReason Driver::runInternal(
                   [op](const CpuWallTiming& deltaTiming) {
                     op->stats().wlock()->getOutputTiming.add(deltaTiming);
                   });
+              auto perfCounters = createDeltaPerfCounters(
+                  [op](const PerfCounterValues& counts) {
+                    addPerfCounterStats(op, counts);
+                  });
               RuntimeStatWriterScopeGuard statsWriterGuard(op);
+              process::ThreadTagScopeGuard tagGuard(&op->threadTag());
               result = op->getOutput();
               if (result) {
                 VELOX_CHECK(
@@ -391,11 +442,16 @@ StopReason Driver::runInternal(
                   [nextOp](const CpuWallTiming& timing) {
                     nextOp->stats().wlock()->addInputTiming.add(timing);
                   });
+              auto perfCounters = createDeltaPerfCounters(
+                  [nextOp](const PerfCounterValues& counts) {
+                    addPerfCounterStats(nextOp, counts);
+                  });
               {
                 auto lockedStats = nextOp->stats().wlock();
                 lockedStats->addInputVector(resultBytes, result->size());
               }
               RuntimeStatWriterScopeGuard statsWriterGuard(nextOp);
+              process::ThreadTagScopeGuard tagGuard(&nextOp->threadTag());
               nextOp->addInput(result);
               // The next iteration will see if operators_[i + 1] has
               // output now that it got input.
@@ -421,12 +477,18 @@ StopReason Driver::runInternal(
                 return StopReason::kBlock;
               }
               RuntimeStatWriterScopeGuard statsWriterGuard(op);
+              process::ThreadTagScopeGuard tagGuard(&op->threadTag());
               if (op->isFinished()) {
                 auto timer =
                     createDeltaCpuWallTimer([op](const CpuWallTiming& timing) {
                       op->stats().wlock()->finishTiming.add(timing);
                     });
+                auto perfCounters = createDeltaPerfCounters(
+                    [op](const PerfCounterValues& counts) {
+                      addPerfCounterStats(op, counts);
+                    });
                 RuntimeStatWriterScopeGuard statsWriterGuard(nextOp);
+                process::ThreadTagScopeGuard tagGuard(&nextOp->threadTag());
                 nextOp->noMoreInput();
                 break;
               }
@@ -442,6 +504,10 @@ StopReason Driver::runInternal(
                 createDeltaCpuWallTimer([op](const CpuWallTiming& timing) {
                   op->stats().wlock()->getOutputTiming.add(timing);
                 });
+            auto perfCounters = createDeltaPerfCounters(
+                [op](const PerfCounterValues& counts) {
+                  addPerfCounterStats(op, counts);
+                });
             result = op->getOutput();
             if (result) {
               VELOX_CHECK(
@@ -486,7 +552,15 @@ StopReason Driver::runInternal(
 void Driver::run(std::shared_ptr<Driver> self) {
   std::shared_ptr<BlockingState> blockingState;
   RowVectorPtr nullResult;
+  self->timeSliceStartMicros_ = getCurrentTimeMicro();
+  self->runStartMicros_ = self->timeSliceStartMicros_;
   auto reason = self->runInternal(self, blockingState, nullResult);
+  self->task()->addOnThreadTime(
+      (getCurrentTimeMicro() - self->timeSliceStartMicros_) * 1'000);
+  self->addTimelineEvent(
+      DriverTimelineEvent::Kind::kRun, self->runStartMicros_, reason);
+  self->timeSliceStartMicros_ = 0;
+  self->runStartMicros_ = 0;
 
   // When Driver runs on an executor, the last operator (sink) must not produce
   // any results.
@@ -548,6 +622,34 @@ void Driver::addStatsToTask() {
     stats.numDrivers = 1;
     task()->addOperatorStats(stats);
   }
+  if (sampleTimeline_) {
+    // The run that closes 'this' ends here.
+    if (runStartMicros_ > 0) {
+      addTimelineEvent(
+          DriverTimelineEvent::Kind::kRun, runStartMicros_, StopReason::kAtEnd);
+    }
+    task()->addDriverTimeline(std::move(timeline_));
+    sampleTimeline_ = false;
+  }
+}
+
+void Driver::addTimelineEvent(
+    DriverTimelineEvent::Kind kind,
+    uint64_t startMicros,
+    StopReason stopReason,
+    BlockingReason blockingReason) {
+  if (!sampleTimeline_ || timeline_.size() >= kMaxTimelineEvents) {
+    return;
+  }
+  const auto now = getCurrentTimeMicro();
+  timeline_.push_back(
+      {kind,
+       ctx_->pipelineId,
+       ctx_->driverId,
+       startMicros,
+       now > startMicros ? now - startMicros : 0,
+       stopReason,
+       blockingReason});
 }
 
 void Driver::close() {
@@ -581,7 +683,7 @@ bool Driver::mayPushdownAggregation(Operator* aggregation) const {
     if (aggregation == op) {
       return true;
     }
-    if (!op->isFilter() || !op->preservesOrder()) {
+    if (!op->mayPassThroughLazyVectors()) {
       return false;
     }
   }
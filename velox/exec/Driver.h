@@ -21,6 +21,7 @@
 
 #include "velox/common/future/VeloxPromise.h"
 #include "velox/common/time/CpuWallTimer.h"
+#include "velox/common/time/PerfCounters.h"
 #include "velox/connectors/Connector.h"
 #include "velox/core/PlanNode.h"
 #include "velox/core/QueryCtx.h"
@@ -146,6 +147,28 @@ enum class BlockingReason {
 
 std::string blockingReasonToString(BlockingReason reason);
 
+/// An interval in the life of a Driver. Recorded for the Drivers sampled by
+/// QueryConfig::kDriverTimelineSamplePct and reported in TaskStats.
+struct DriverTimelineEvent {
+  enum class Kind {
+    /// Waiting in the executor queue to run.
+    kQueued,
+    /// Running on a thread. 'stopReason' tells why the run ended, e.g. kBlock
+    /// or kYield.
+    kRun,
+    /// Off thread waiting for 'blockingReason'.
+    kBlocked,
+  };
+
+  Kind kind;
+  int32_t pipelineId;
+  int32_t driverId;
+  uint64_t startMicros;
+  uint64_t durationMicros;
+  StopReason stopReason{StopReason::kNone};
+  BlockingReason blockingReason{BlockingReason::kNotBlocked};
+};
+
 class BlockingState {
  public:
   BlockingState(
@@ -259,8 +282,9 @@ class Driver : public std::enable_shared_from_this<Driver> {
 
   void addStatsToTask();
 
-  // Returns true if all operators between the source and 'aggregation' are
-  // order-preserving and do not increase cardinality.
+  // Returns true if all operators between the source and 'aggregation' pass
+  // through unloaded LazyVectors in the order of their input rows. See
+  // Operator::mayPassThroughLazyVectors().
   bool mayPushdownAggregation(Operator* FOLLY_NONNULL aggregation) const;
 
   // Returns a subset of channels for which there are operators upstream from
@@ -297,7 +321,18 @@ class Driver : public std::enable_shared_from_this<Driver> {
     return blockingReason_;
   }
 
+  /// Adds the interval from 'startMicros' to now to the timeline of 'this' if
+  /// 'this' is sampled. See QueryConfig::kDriverTimelineSamplePct.
+  void addTimelineEvent(
+      DriverTimelineEvent::Kind kind,
+      uint64_t startMicros,
+      StopReason stopReason = StopReason::kNone,
+      BlockingReason blockingReason = BlockingReason::kNotBlocked);
+
  private:
+  // Maximum number of timeline events kept per Driver.
+  static constexpr size_t kMaxTimelineEvents = 10'000;
+
   void enqueueInternal();
 
   static void run(std::shared_ptr<Driver> self);
@@ -309,6 +344,10 @@ class Driver : public std::enable_shared_from_this<Driver> {
 
   void close();
 
+  // Returns true if 'this' runs on an executor with a time slice and has been
+  // on thread for longer than the slice.
+  bool timeSliceExpired() const;
+
   // Push down dynamic filters produced by the operator at the specified
   // position in the pipeline.
   void pushdownFilters(int operatorIndex);
@@ -324,6 +363,21 @@ class Driver : public std::enable_shared_from_this<Driver> {
         : nullptr;
   }
 
+  /// If 'trackOperatorPerfCounters_' is true and the hardware counters are
+  /// available on the calling thread, returns an object that passes the
+  /// counts of an operation to 'func' upon destruction. Returns null
+  /// otherwise.
+  template <typename F>
+  std::unique_ptr<DeltaPerfCounters<F>> createDeltaPerfCounters(F&& func) {
+    if (!trackOperatorPerfCounters_) {
+      return nullptr;
+    }
+    auto* counters = PerfCounters::forThread();
+    return counters
+        ? std::make_unique<DeltaPerfCounters<F>>(*counters, std::move(func))
+        : nullptr;
+  }
+
   std::unique_ptr<DriverCtx> ctx_;
   std::atomic_bool closed_{false};
 
@@ -341,6 +395,26 @@ class Driver : public std::enable_shared_from_this<Driver> {
   BlockingReason blockingReason_{BlockingReason::kNotBlocked};
 
   bool trackOperatorCpuUsage_;
+
+  // See QueryConfig::kOperatorTrackPerfCounters.
+  bool trackOperatorPerfCounters_;
+
+  // See QueryConfig::kDriverTimeSliceMs. 0 if there is no limit.
+  uint64_t timeSliceMicros_{0};
+
+  // Time when the current run on an executor thread started. 0 when 'this'
+  // is not run by an executor, e.g. by next().
+  uint64_t timeSliceStartMicros_{0};
+
+  // True if 'this' records its timeline. See
+  // QueryConfig::kDriverTimelineSamplePct.
+  bool sampleTimeline_{false};
+
+  // Time when the current run by run() or next() started, 0 if not running.
+  uint64_t runStartMicros_{0};
+
+  // Timeline events of 'this' that are not yet added to the Task's stats.
+  std::vector<DriverTimelineEvent> timeline_;
 };
 
 using OperatorSupplier = std::function<std::unique_ptr<Operator>(
@@ -451,6 +525,19 @@ struct DriverFactory {
 
     return joinNodeIds;
   }
+
+  /// Returns plan node IDs of all RangeJoinNode's in the pipeline.
+  std::vector<core::PlanNodeId> needsRangeJoinBridges() const {
+    std::vector<core::PlanNodeId> joinNodeIds;
+    for (const auto& planNode : planNodes) {
+      if (auto joinNode =
+              std::dynamic_pointer_cast<const core::RangeJoinNode>(planNode)) {
+        joinNodeIds.emplace_back(joinNode->id());
+      }
+    }
+
+    return joinNodeIds;
+  }
 };
 
 // Begins and ends a section where a thread is running but not
@@ -16,9 +16,12 @@
 #include "velox/exec/Exchange.h"
 #include <velox/common/base/Exceptions.h>
 #include <velox/common/memory/Memory.h>
+#include "velox/common/time/Timer.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/vector/VectorStream.h"
 
+DECLARE_bool(velox_exchange_colocated_tasks_shortcut);
+
 namespace facebook::velox::exec {
 
 SerializedPage::SerializedPage(
@@ -56,20 +59,6 @@ void SerializedPage::prepareStreamForDeserialize(ByteStream* input) {
   input->resetInput(std::move(ranges_));
 }
 
-std::shared_ptr<ExchangeSource> ExchangeSource::create(
-    const std::string& taskId,
-    int destination,
-    std::shared_ptr<ExchangeQueue> queue,
-    memory::MemoryPool* pool) {
-  for (auto& factory : factories()) {
-    auto result = factory(taskId, destination, queue, pool);
-    if (result) {
-      return result;
-    }
-  }
-  VELOX_FAIL("No ExchangeSource factory matches {}", taskId);
-}
-
 // static
 std::vector<ExchangeSource::Factory>& ExchangeSource::factories() {
   static std::vector<Factory> factories;
@@ -94,19 +83,24 @@ class LocalExchangeSource : public ExchangeSource {
   }
 
   void request() override {
+    request(kMaxBytes);
+  }
+
+  void request(uint32_t maxBytes) override {
     auto buffers = PartitionedOutputBufferManager::getInstance().lock();
     VELOX_CHECK_NOT_NULL(buffers, "invalid PartitionedOutputBufferManager");
     VELOX_CHECK(requestPending_);
     auto requestedSequence = sequence_;
     auto self = shared_from_this();
+    const auto requestMicros = getCurrentTimeMicro();
     buffers->getData(
         taskId_,
         destination_,
-        kMaxBytes,
+        maxBytes,
         sequence_,
         // Since this lambda may outlive 'this', we need to capture a
         // shared_ptr to the current object (self).
-        [self, requestedSequence, buffers, this](
+        [self, requestedSequence, requestMicros, buffers, this](
             std::vector<std::unique_ptr<folly::IOBuf>> data, int64_t sequence) {
           if (requestedSequence > sequence) {
             VLOG(2) << "Receives earlier sequence than requested: task "
@@ -137,6 +131,12 @@ class LocalExchangeSource : public ExchangeSource {
             {
               std::lock_guard<std::mutex> l(queue_->mutex());
               requestPending_ = false;
+              uint64_t receivedBytes = 0;
+              for (const auto& page : pages) {
+                receivedBytes += page->size();
+              }
+              recordResponseLocked(
+                  receivedBytes, getCurrentTimeMicro() - requestMicros);
               for (auto& page : pages) {
                 queue_->enqueueLocked(std::move(page), promises);
               }
@@ -180,8 +180,56 @@ std::unique_ptr<ExchangeSource> createLocalExchangeSource(
   return nullptr;
 }
 
+// Returns the id of the task at 'location' if the output buffer of the task
+// is in this process. 'location' is either a task id or a task URL of the
+// form <scheme>://<host>:<port>/v1/task/<task id>[/...].
+std::optional<std::string> colocatedTaskId(const std::string& location) {
+  auto buffers = PartitionedOutputBufferManager::getInstance().lock();
+  if (buffers == nullptr) {
+    return std::nullopt;
+  }
+  if (buffers->hasTask(location)) {
+    return location;
+  }
+  static const std::string kTaskPath = "/v1/task/";
+  const auto pathPos = location.find(kTaskPath);
+  if (pathPos == std::string::npos) {
+    return std::nullopt;
+  }
+  const auto idPos = pathPos + kTaskPath.size();
+  const auto idEnd = location.find_first_of("/?", idPos);
+  auto taskId = location.substr(
+      idPos, idEnd == std::string::npos ? std::string::npos : idEnd - idPos);
+  if (taskId.empty() || !buffers->hasTask(taskId)) {
+    return std::nullopt;
+  }
+  return taskId;
+}
+
 } // namespace
 
+std::shared_ptr<ExchangeSource> ExchangeSource::create(
+    const std::string& taskId,
+    int destination,
+    std::shared_ptr<ExchangeQueue> queue,
+    memory::MemoryPool* pool) {
+  // A producer in the same process hands over its pages without going
+  // through the network.
+  if (FLAGS_velox_exchange_colocated_tasks_shortcut) {
+    if (auto localTaskId = colocatedTaskId(taskId)) {
+      return std::make_shared<LocalExchangeSource>(
+          localTaskId.value(), destination, std::move(queue), pool);
+    }
+  }
+  for (auto& factory : factories()) {
+    auto result = factory(taskId, destination, queue, pool);
+    if (result) {
+      return result;
+    }
+  }
+  VELOX_FAIL("No ExchangeSource factory matches {}", taskId);
+}
+
 void ExchangeClient::addRemoteTaskId(const std::string& taskId) {
   std::shared_ptr<ExchangeSource> toRequest;
   std::shared_ptr<ExchangeSource> toClose;
@@ -202,6 +250,9 @@ void ExchangeClient::addRemoteTaskId(const std::string& taskId) {
       sources_.push_back(source);
       queue_->addSourceLocked();
       if (source->shouldRequestLocked()) {
+        // The first request of a source asks for the minimum credit. Later
+        // requests are sized by the data rate of the source.
+        source->setRequestedBytesLocked(kMinRequestBytes);
         toRequest = source;
       }
     }
@@ -211,7 +262,7 @@ void ExchangeClient::addRemoteTaskId(const std::string& taskId) {
   if (toClose) {
     toClose->close();
   } else if (toRequest) {
-    toRequest->request();
+    toRequest->request(kMinRequestBytes);
   }
 }
 
@@ -241,6 +292,7 @@ std::unique_ptr<SerializedPage> ExchangeClient::next(
     bool* atEnd,
     ContinueFuture* future) {
   std::vector<std::shared_ptr<ExchangeSource>> toRequest;
+  std::vector<uint32_t> credits;
   std::unique_ptr<SerializedPage> page;
   {
     std::lock_guard<std::mutex> l(queue_->mutex());
@@ -254,20 +306,86 @@ std::unique_ptr<SerializedPage> ExchangeClient::next(
     }
     // There is space for more data, send requests to sources with no pending
     // request.
+    uint64_t outstandingBytes = 0;
     for (auto& source : sources_) {
-      if (source->shouldRequestLocked()) {
+      if (source->isRequestPending()) {
+        outstandingBytes += source->requestedBytesLocked();
+      } else if (source->shouldRequestLocked()) {
         toRequest.push_back(source);
       }
     }
+    setCreditsLocked(toRequest, outstandingBytes);
+    for (const auto& source : toRequest) {
+      credits.push_back(source->requestedBytesLocked());
+    }
   }
 
   // Outside of lock
-  for (auto& source : toRequest) {
-    source->request();
+  for (auto i = 0; i < toRequest.size(); ++i) {
+    toRequest[i]->request(credits[i]);
   }
   return page;
 }
 
+void ExchangeClient::setCreditsLocked(
+    const std::vector<std::shared_ptr<ExchangeSource>>& sources,
+    uint64_t outstandingBytes) {
+  if (sources.empty()) {
+    return;
+  }
+  const uint64_t usedBytes = queue_->totalBytes() + outstandingBytes;
+  const uint64_t freeBytes =
+      usedBytes < queue_->minBytes() ? queue_->minBytes() - usedBytes : 0;
+  addStatLocked(
+      "exchangePrefetchBytes", usedBytes, RuntimeCounter::Unit::kBytes);
+
+  // Sources with no observed rate yet count as average.
+  double knownRate = 0;
+  int32_t numKnown = 0;
+  for (const auto& source : sources) {
+    if (source->bytesPerSecondLocked() > 0) {
+      knownRate += source->bytesPerSecondLocked();
+      ++numKnown;
+    }
+    if (source->roundTripMicrosLocked() > 0) {
+      addStatLocked(
+          "exchangeRoundTripNanos",
+          source->roundTripMicrosLocked() * 1'000,
+          RuntimeCounter::Unit::kNanos);
+    }
+  }
+  const double averageRate = numKnown > 0 ? knownRate / numKnown : 1;
+  const double totalRate =
+      knownRate + averageRate * (sources.size() - numKnown);
+  for (const auto& source : sources) {
+    const double rate = source->bytesPerSecondLocked() > 0
+        ? source->bytesPerSecondLocked()
+        : averageRate;
+    const auto credit = std::clamp<uint64_t>(
+        freeBytes * (rate / totalRate), kMinRequestBytes, kMaxRequestBytes);
+    source->setRequestedBytesLocked(credit);
+    addStatLocked("exchangeRequestBytes", credit, RuntimeCounter::Unit::kBytes);
+  }
+}
+
+void ExchangeClient::addStatLocked(
+    const std::string& name,
+    int64_t value,
+    RuntimeCounter::Unit unit) {
+  auto it = stats_.find(name);
+  if (it == stats_.end()) {
+    it = stats_.emplace(name, RuntimeMetric(unit)).first;
+  }
+  it->second.addValue(value);
+}
+
+std::unordered_map<std::string, RuntimeMetric> ExchangeClient::stats() {
+  std::lock_guard<std::mutex> l(queue_->mutex());
+  std::unordered_map<std::string, RuntimeMetric> stats;
+  stats.swap(stats_);
+  return stats;
+}
+
 ExchangeClient::~ExchangeClient() {
   close();
 }
@@ -330,6 +448,7 @@ BlockingReason Exchange::isBlocked(ContinueFuture* future) {
   ContinueFuture dataFuture;
   currentPage_ = exchangeClient_->next(&atEnd_, &dataFuture);
   if (currentPage_ || atEnd_) {
+    addClientStats();
     if (atEnd_ && noMoreSplits_) {
       const auto numSplits = stats_.rlock()->numSplits;
       operatorCtx_->task()->multipleSplitsFinished(numSplits);
@@ -371,7 +490,11 @@ RowVectorPtr Exchange::getOutput() {
   }
 
   getSerde()->deserialize(
-      inputStream_.get(), operatorCtx_->pool(), outputType_, &result_);
+      inputStream_.get(),
+      operatorCtx_->pool(),
+      outputType_,
+      &result_,
+      serdeOptions_.get());
 
   {
     auto lockedStats = stats_.wlock();
@@ -387,6 +510,22 @@ RowVectorPtr Exchange::getOutput() {
   return result_;
 }
 
+void Exchange::addClientStats() {
+  auto clientStats = exchangeClient_->stats();
+  if (clientStats.empty()) {
+    return;
+  }
+  auto lockedStats = stats_.wlock();
+  for (const auto& [name, metric] : clientStats) {
+    auto it = lockedStats->runtimeStats.find(name);
+    if (it == lockedStats->runtimeStats.end()) {
+      lockedStats->runtimeStats.emplace(name, metric);
+    } else {
+      it->second.merge(metric);
+    }
+  }
+}
+
 VectorSerde* Exchange::getSerde() {
   return getVectorSerde();
 }
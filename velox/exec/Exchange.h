@@ -20,6 +20,7 @@
 #include <memory>
 #include "velox/common/memory/ByteStream.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/OperatorUtils.h"
 
 namespace facebook::velox::exec {
 
@@ -291,6 +292,38 @@ class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
   // shared_from_this() pointer if needed.
   virtual void request() = 0;
 
+  // Like request() but asks for at most 'maxBytes'. 'maxBytes' is the credit
+  // the ExchangeClient gives 'this' from the free space of the queue. Sources
+  // that do not size their requests ignore it.
+  virtual void request(uint32_t maxBytes) {
+    request();
+  }
+
+  bool isRequestPending() const {
+    return requestPending_;
+  }
+
+  // The credit of the last request. Accessed under queue_->mutex().
+  uint64_t requestedBytesLocked() const {
+    return requestedBytes_;
+  }
+
+  void setRequestedBytesLocked(uint64_t bytes) {
+    requestedBytes_ = bytes;
+  }
+
+  // Bytes per second received over the recent requests, 0 if not known.
+  // Accessed under queue_->mutex().
+  double bytesPerSecondLocked() const {
+    return bytesPerSecond_;
+  }
+
+  // Time from request to response of the last request, 0 if not known.
+  // Accessed under queue_->mutex().
+  uint64_t roundTripMicrosLocked() const {
+    return roundTripMicros_;
+  }
+
   // Close the exchange source. May be called before all data
   // has been received and proessed. This can happen in case
   // of an error or an operator like Limit aborting the query
@@ -323,6 +356,18 @@ class ExchangeSource : public std::enable_shared_from_this<ExchangeSource> {
   bool atEnd_ = false;
 
  protected:
+  // Records that a request returned 'bytes' after 'roundTripMicros'. Call
+  // under queue_->mutex().
+  void recordResponseLocked(uint64_t bytes, uint64_t roundTripMicros) {
+    roundTripMicros_ = std::max<uint64_t>(1, roundTripMicros);
+    const double rate = bytes * 1'000'000.0 / roundTripMicros_;
+    bytesPerSecond_ =
+        bytesPerSecond_ == 0 ? rate : (bytesPerSecond_ + rate) / 2;
+  }
+
+  uint64_t requestedBytes_{0};
+  double bytesPerSecond_{0};
+  uint64_t roundTripMicros_{0};
   memory::MemoryPool* pool_;
 };
 
@@ -338,6 +383,9 @@ struct RemoteConnectorSplit : public connector::ConnectorSplit {
 class ExchangeClient {
  public:
   static constexpr int32_t kDefaultMinSize = 32 << 20; // 32 MB.
+  // Bounds of the credit given to a source for one request.
+  static constexpr uint32_t kMinRequestBytes = 1 << 20; // 1 MB.
+  static constexpr uint32_t kMaxRequestBytes = 32 << 20; // 32 MB.
 
   ExchangeClient(
       int destination,
@@ -378,13 +426,34 @@ class ExchangeClient {
 
   std::string toString();
 
+  // Returns the flow control stats collected since the last call:
+  // 'exchangeRequestBytes' is the credit of each request,
+  // 'exchangePrefetchBytes' the queued and requested bytes when requesting
+  // and 'exchangeRoundTripNanos' the round trip time of the sources.
+  std::unordered_map<std::string, RuntimeMetric> stats();
+
  private:
+  // Sets the credits of 'sources' from the space below queue_->minBytes()
+  // not taken by queued data or by 'outstandingBytes' of pending requests.
+  // The credits are proportional to the data rates of the sources, so that
+  // fast sources get more of the memory of the consumer.
+  void setCreditsLocked(
+      const std::vector<std::shared_ptr<ExchangeSource>>& sources,
+      uint64_t outstandingBytes);
+
+  void addStatLocked(
+      const std::string& name,
+      int64_t value,
+      RuntimeCounter::Unit unit);
+
   const int destination_;
   memory::MemoryPool* const pool_;
   std::shared_ptr<ExchangeQueue> queue_;
   std::unordered_set<std::string> taskIds_;
   std::vector<std::shared_ptr<ExchangeSource>> sources_;
   bool closed_{false};
+  // Accessed under queue_->mutex().
+  std::unordered_map<std::string, RuntimeMetric> stats_;
 };
 
 class Exchange : public SourceOperator {
@@ -402,6 +471,7 @@ class Exchange : public SourceOperator {
             exchangeNode->id(),
             operatorType),
         planNodeId_(exchangeNode->id()),
+        serdeOptions_(makeExchangeSerdeOptions(ctx->queryConfig())),
         exchangeClient_(std::move(exchangeClient)) {}
 
   ~Exchange() override {
@@ -437,7 +507,15 @@ class Exchange : public SourceOperator {
   /// exchangeClient_.
   bool getSplits(ContinueFuture* future);
 
+  // Adds the flow control stats of 'exchangeClient_' to the runtime stats.
+  void addClientStats();
+
   const core::PlanNodeId planNodeId_;
+
+  // Options to decompress the received pages. Null if the pages are not
+  // compressed.
+  const std::unique_ptr<VectorSerde::Options> serdeOptions_;
+
   bool noMoreSplits_ = false;
 
   /// A future received from Task::getSplitOrFuture(). It will be complete when
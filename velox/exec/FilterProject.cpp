@@ -75,6 +75,10 @@ FilterProject::FilterProject(
     isIdentityProjection_ = true;
   }
   numExprs_ = allExprs.size();
+  // The filter and the projections are compiled into one ExprSet, so common
+  // subexpressions are shared between them. project() evaluates the
+  // projections without resetting the values computed by the filter, which
+  // cover the rows that passed.
   exprs_ = makeExprSetFromFlag(std::move(allExprs), operatorCtx_->execCtx());
 
   if (numExprs_ > 0 && !identityProjections_.empty()) {
@@ -85,9 +89,23 @@ FilterProject::FilterProject(
       auto fieldIndex = inputType->getChildIdx(field->name());
       distinctFieldIndices.insert(fieldIndex);
     }
+    std::unordered_set<uint32_t> filterFieldIndices;
+    if (hasFilter_) {
+      for (auto field : exprs_->expr(0)->distinctFields()) {
+        filterFieldIndices.insert(inputType->getChildIdx(field->name()));
+      }
+    }
     for (auto identityField : identityProjections_) {
-      if (distinctFieldIndices.find(identityField.inputChannel) !=
+      if (distinctFieldIndices.find(identityField.inputChannel) ==
           distinctFieldIndices.end()) {
+        continue;
+      }
+      if (hasFilter_ &&
+          filterFieldIndices.find(identityField.inputChannel) ==
+              filterFieldIndices.end()) {
+        projectionReferencedFieldIndices_.push_back(
+            identityField.inputChannel);
+      } else {
         multiplyReferencedFieldIndices_.push_back(identityField.inputChannel);
       }
     }
@@ -109,6 +127,28 @@ void FilterProject::addInput(RowVectorPtr input) {
   }
 }
 
+void FilterProject::noMoreInput() {
+  if (noMoreInput_) {
+    return;
+  }
+  Operator::noMoreInput();
+  // needsInput() is false while there is unprocessed input, so all rows have
+  // been evaluated by now.
+  addExprStats();
+}
+
+void FilterProject::addExprStats() {
+  for (const auto& [signature, exprStats] : exprs_->statsBySignature()) {
+    addRuntimeStat(
+        fmt::format("expr.{}.cpuNanos", signature),
+        RuntimeCounter(
+            exprStats.estimatedCpuNanos(), RuntimeCounter::Unit::kNanos));
+    addRuntimeStat(
+        fmt::format("expr.{}.rows", signature),
+        RuntimeCounter(exprStats.numProcessedRows));
+  }
+}
+
 bool FilterProject::allInputProcessed() {
   if (!input_) {
     return true;
@@ -136,8 +176,8 @@ RowVectorPtr FilterProject::getOutput() {
   rows->setAll();
   EvalCtx evalCtx(operatorCtx_->execCtx(), exprs_.get(), input_.get());
 
-  // Pre-load lazy vectors which are referenced by both expressions and identity
-  // projections.
+  // Pre-load lazy vectors which are referenced by both the filter (or the
+  // projections if there is no filter) and identity projections.
   for (auto fieldIdx : multiplyReferencedFieldIndices_) {
     evalCtx.ensureFieldLoaded(fieldIdx, *rows);
   }
@@ -176,6 +216,10 @@ RowVectorPtr FilterProject::getOutput() {
     if (!allRowsSelected) {
       rows->setFromBits(filterEvalCtx_.selectedBits->as<uint64_t>(), size);
     }
+    // Identity projections only need the rows that passed the filter.
+    for (auto fieldIdx : projectionReferencedFieldIndices_) {
+      evalCtx.ensureFieldLoaded(fieldIdx, *rows);
+    }
     project(*rows, evalCtx);
   }
 
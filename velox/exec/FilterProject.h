@@ -43,6 +43,8 @@ class FilterProject : public Operator {
 
   void addInput(RowVectorPtr input) override;
 
+  void noMoreInput() override;
+
   RowVectorPtr getOutput() override;
 
   BlockingReason isBlocked(ContinueFuture* /* unused */) override {
@@ -62,6 +64,12 @@ class FilterProject : public Operator {
   // should return nullptr.
   bool allInputProcessed();
 
+  // Adds the per-function stats of 'exprs_' to the runtime stats of this
+  // operator as 'expr.<function signature>.cpuNanos' and '.rows'. The CPU
+  // time is extrapolated from the sampled batches unless
+  // QueryConfig::kExprTrackCpuUsage is set.
+  void addExprStats();
+
   // Evaluate filter on all rows. Return number of rows that passed the filter.
   // Populate filterEvalCtx_.selectedBits and selectedIndices with the indices
   // of the passing rows if only some rows pass the filter. If all or no rows
@@ -91,5 +99,10 @@ class FilterProject : public Operator {
   // will load c1 only for rows where f(c0) is true. However, c1 identity
   // projection needs all rows.
   std::vector<column_index_t> multiplyReferencedFieldIndices_;
+
+  // Fields referenced by identity projections and by projection expressions
+  // but not by the filter. These are loaded after the filter, only for the
+  // rows that passed.
+  std::vector<column_index_t> projectionReferencedFieldIndices_;
 };
 } // namespace facebook::velox::exec
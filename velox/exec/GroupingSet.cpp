@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 #include "velox/exec/GroupingSet.h"
+
+#include <numeric>
+
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
 
@@ -45,6 +48,7 @@ GroupingSet::GroupingSet(
     std::vector<std::vector<column_index_t>>&& channelLists,
     std::vector<std::vector<VectorPtr>>&& constantLists,
     std::vector<TypePtr>&& intermediateTypes,
+    std::vector<bool>&& distinctAggregates,
     bool ignoreNullKeys,
     bool isPartial,
     bool isRawInput,
@@ -60,10 +64,17 @@ GroupingSet::GroupingSet(
       channelLists_(std::move(channelLists)),
       constantLists_(std::move(constantLists)),
       intermediateTypes_(std::move(intermediateTypes)),
+      distinctAggregates_(std::move(distinctAggregates)),
       ignoreNullKeys_(ignoreNullKeys),
       spillMemoryThreshold_(operatorCtx->driverCtx()
                                 ->queryConfig()
                                 .aggregationSpillMemoryThreshold()),
+      sortBasedMinGroups_(operatorCtx->driverCtx()
+                              ->queryConfig()
+                              .aggregationSortBasedMinGroups()),
+      sortBasedMinPct_(operatorCtx->driverCtx()
+                           ->queryConfig()
+                           .aggregationSortBasedMinPct()),
       spillConfig_(spillConfig),
       stringAllocator_(operatorCtx->pool()),
       rows_(operatorCtx->pool()),
@@ -71,7 +82,16 @@ GroupingSet::GroupingSet(
                       ->queryCtx()
                       ->queryConfig()
                       .hashAdaptivityEnabled()),
+      appendOnlyStrings_(operatorCtx->driverCtx()
+                             ->queryConfig()
+                             .aggregationAppendOnlyStrings()),
+      compactLayout_(
+          operatorCtx->driverCtx()->queryConfig().compactRowLayout()),
+      trackAllocatorStats_(operatorCtx->driverCtx()
+                               ->queryConfig()
+                               .aggregationTrackAllocatorStats()),
       pool_(*operatorCtx->pool()) {
+  stringAllocator_.setTrackStats(trackAllocatorStats_);
   for (auto& hasher : hashers_) {
     keyChannels_.push_back(hasher->channel());
   }
@@ -84,6 +104,13 @@ GroupingSet::GroupingSet(
   for (const std::vector<column_index_t>& argList : channelLists_) {
     mayPushdown_.push_back(allAreSinglyReferenced(argList, channelUseCount));
   }
+  if (std::find(distinctAggregates_.begin(), distinctAggregates_.end(), true) !=
+      distinctAggregates_.end()) {
+    VELOX_USER_CHECK(
+        isRawInput_ && !isPartial_,
+        "Distinct aggregates are only supported in a single step aggregation");
+    distinctSets_.resize(aggregates_.size());
+  }
 }
 
 GroupingSet::~GroupingSet() {
@@ -157,6 +184,10 @@ void GroupingSet::addInputForActiveRows(
     const RowVectorPtr& input,
     bool mayPushdown) {
   VELOX_CHECK(!isGlobal_);
+  if (passThrough_) {
+    addPassThroughInput(input, mayPushdown);
+    return;
+  }
   bool rehash = false;
   if (!table_) {
     rehash = true;
@@ -204,15 +235,64 @@ void GroupingSet::addInputForActiveRows(
   }
 
   table_->groupProbe(*lookup_);
+  numInputRowsSinceSortedSpill_ += lookup_->rows.size();
+  masks_.addInput(input, activeRows_);
+  if (table_->hashMode() == BaseHashTable::HashMode::kArray &&
+      table_->capacity() <= kMaxDenseGroupIds) {
+    // In array mode the hashes are the indices of the groups in the table.
+    updateAggregates(
+        input, mayPushdown, lookup_->hashes.data(), table_->capacity());
+  } else {
+    updateAggregates(input, mayPushdown);
+  }
+}
+
+void GroupingSet::addPassThroughInput(
+    const RowVectorPtr& input,
+    bool mayPushdown) {
+  if (!table_) {
+    createHashTable();
+  }
+  auto& hashers = lookup_->hashers;
+  lookup_->reset(activeRows_.end());
+  for (auto i = 0; i < hashers.size(); ++i) {
+    auto key = input->childAt(hashers[i]->channel())->loadedVector();
+    hashers[i]->decode(*key, activeRows_);
+  }
+
+  if (ignoreNullKeys_) {
+    deselectRowsWithNulls(hashers, activeRows_);
+  }
+
+  // Each row gets a group of its own. The groups are not added to the hash
+  // table, they are only listed from its row container on output.
+  auto* rows = table_->rows();
+  activeRows_.applyToSelected([&](auto row) {
+    auto* group = rows->newRow();
+    for (auto i = 0; i < hashers.size(); ++i) {
+      rows->store(hashers[i]->decodedVector(), row, group, i);
+    }
+    lookup_->hits[row] = group;
+    lookup_->newGroups.push_back(row);
+  });
   masks_.addInput(input, activeRows_);
+  updateAggregates(input, mayPushdown);
+}
 
+void GroupingSet::updateAggregates(
+    const RowVectorPtr& input,
+    bool mayPushdown,
+    const uint64_t* groupIds,
+    uint64_t numGroupIds) {
   for (auto i = 0; i < aggregates_.size(); ++i) {
     if (!lookup_->newGroups.empty()) {
       aggregates_[i]->initializeNewGroups(
           lookup_->hits.data(), lookup_->newGroups);
     }
 
-    const auto& rows = getSelectivityVector(i);
+    const auto& rows = isDistinctAggregate(i)
+        ? distinctRows(i, input, getSelectivityVector(i))
+        : getSelectivityVector(i);
     // Check is mask is false for all rows.
     if (!rows.hasSelections()) {
       continue;
@@ -224,7 +304,10 @@ void GroupingSet::addInputForActiveRows(
     // this.
     const bool canPushdown = (&rows == &activeRows_) && mayPushdown &&
         mayPushdown_[i] && areAllLazyNotLoaded(tempVectors_);
-    if (isRawInput_) {
+    if (isRawInput_ && groupIds != nullptr && !canPushdown) {
+      aggregates_[i]->addRawInputDense(
+          lookup_->hits.data(), groupIds, numGroupIds, rows, tempVectors_);
+    } else if (isRawInput_) {
       aggregates_[i]->addRawInput(
           lookup_->hits.data(), rows, tempVectors_, canPushdown);
     } else {
@@ -248,12 +331,21 @@ void GroupingSet::addRemainingInput() {
 void GroupingSet::createHashTable() {
   if (ignoreNullKeys_) {
     table_ = HashTable<true>::createForAggregation(
-        std::move(hashers_), aggregates_, &pool_);
+        std::move(hashers_),
+        aggregates_,
+        &pool_,
+        appendOnlyStrings_,
+        compactLayout_);
   } else {
     table_ = HashTable<false>::createForAggregation(
-        std::move(hashers_), aggregates_, &pool_);
+        std::move(hashers_),
+        aggregates_,
+        &pool_,
+        appendOnlyStrings_,
+        compactLayout_);
   }
   lookup_ = std::make_unique<HashLookup>(table_->hashers());
+  table_->rows()->stringAllocator().setTrackStats(trackAllocatorStats_);
   if (!isAdaptive_ && table_->hashMode() != BaseHashTable::HashMode::kHash) {
     table_->forceGenericHashMode();
   }
@@ -313,7 +405,9 @@ void GroupingSet::addGlobalAggregationInput(
 
   masks_.addInput(input, activeRows_);
   for (auto i = 0; i < aggregates_.size(); ++i) {
-    const auto& rows = getSelectivityVector(i);
+    const auto& rows = isDistinctAggregate(i)
+        ? distinctRows(i, input, getSelectivityVector(i))
+        : getSelectivityVector(i);
 
     // Check is mask is false for all rows.
     if (!rows.hasSelections()) {
@@ -399,6 +493,71 @@ const SelectivityVector& GroupingSet::getSelectivityVector(
   return *rows;
 }
 
+const SelectivityVector& GroupingSet::distinctRows(
+    size_t aggregateIndex,
+    const RowVectorPtr& input,
+    const SelectivityVector& rows) {
+  if (!rows.hasSelections()) {
+    return rows;
+  }
+  auto& distinctSet = distinctSets_[aggregateIndex];
+  if (distinctSet.table == nullptr) {
+    std::vector<std::unique_ptr<VectorHasher>> hashers;
+    for (auto channel : keyChannels_) {
+      hashers.push_back(
+          VectorHasher::create(input->childAt(channel)->type(), channel));
+    }
+    for (auto channel : channelLists_[aggregateIndex]) {
+      if (channel != kConstantChannel) {
+        hashers.push_back(
+            VectorHasher::create(input->childAt(channel)->type(), channel));
+      }
+    }
+    VELOX_USER_CHECK(
+        !hashers.empty(),
+        "Distinct global aggregate must have a non-constant input");
+    // Nulls are distinct values of their own. The aggregate decides whether
+    // to ignore them.
+    distinctSet.table =
+        HashTable<false>::createForGrouping(std::move(hashers), {}, &pool_);
+    distinctSet.table->forceGenericHashMode();
+    distinctSet.lookup =
+        std::make_unique<HashLookup>(distinctSet.table->hashers());
+  }
+
+  auto& lookup = *distinctSet.lookup;
+  auto& hashers = lookup.hashers;
+  lookup.reset(rows.end());
+  for (auto i = 0; i < hashers.size(); ++i) {
+    auto key = input->childAt(hashers[i]->channel())->loadedVector();
+    hashers[i]->decode(*key, rows);
+    hashers[i]->hash(rows, i > 0, lookup.hashes);
+  }
+  lookup.rows.clear();
+  rows.applyToSelected([&](auto row) { lookup.rows.push_back(row); });
+  distinctSet.table->groupProbe(lookup);
+
+  // The new groups of the distinct set are the first occurrences of their
+  // values.
+  distinctSet.rows.resize(rows.end());
+  distinctSet.rows.clearAll();
+  for (auto row : lookup.newGroups) {
+    distinctSet.rows.setValid(row, true);
+  }
+  distinctSet.rows.updateBounds();
+  return distinctSet.rows;
+}
+
+uint64_t GroupingSet::distinctSetBytes() const {
+  uint64_t bytes = 0;
+  for (const auto& distinctSet : distinctSets_) {
+    if (distinctSet.table != nullptr) {
+      bytes += distinctSet.table->allocatedBytes();
+    }
+  }
+  return bytes;
+}
+
 bool GroupingSet::getOutput(
     int32_t batchSize,
     RowContainerIterator& iterator,
@@ -418,6 +577,13 @@ bool GroupingSet::getOutput(
     if (table_) {
       table_->clear();
     }
+    // The groups are flushed, so are the values seen by their distinct
+    // aggregates.
+    for (auto& distinctSet : distinctSets_) {
+      if (distinctSet.table != nullptr) {
+        distinctSet.table->clear();
+      }
+    }
     if (remainingInput_) {
       addRemainingInput();
     }
@@ -452,6 +618,13 @@ void GroupingSet::extractGroups(
   }
 }
 
+void GroupingSet::enablePassThrough() {
+  VELOX_CHECK(isPartial_);
+  VELOX_CHECK(!isGlobal_);
+  VELOX_CHECK_EQ(numRows(), 0, "Groups must be flushed before pass-through");
+  passThrough_ = true;
+}
+
 void GroupingSet::resetPartial() {
   if (table_ != nullptr) {
     table_->clear();
@@ -460,10 +633,27 @@ void GroupingSet::resetPartial() {
 
 uint64_t GroupingSet::allocatedBytes() const {
   if (table_) {
-    return table_->allocatedBytes();
+    return table_->allocatedBytes() + distinctSetBytes();
   }
 
-  return stringAllocator_.retainedSize() + rows_.allocatedBytes();
+  return stringAllocator_.retainedSize() + rows_.allocatedBytes() +
+      distinctSetBytes();
+}
+
+std::vector<std::pair<std::string, int64_t>> GroupingSet::memoryComponents()
+    const {
+  const RowContainer* rows = table_ ? table_->rows() : nullptr;
+  if (rows == nullptr) {
+    return {
+        {"rows", rows_.allocatedBytes()},
+        {"strings", stringAllocator_.retainedSize()}};
+  }
+  const int64_t stringBytes = rows->stringAllocator().retainedSize();
+  const int64_t rowBytes = rows->allocatedBytes();
+  return {
+      {"hashTable", table_->allocatedBytes() - rowBytes},
+      {"rows", rowBytes - stringBytes},
+      {"strings", stringBytes}};
 }
 
 const HashLookup& GroupingSet::hashLookup() const {
@@ -504,6 +694,17 @@ void GroupingSet::ensureInputFits(const RowVectorPtr& input) {
     return;
   }
 
+  if (sortBasedMinGroups_ > 0 && numDistinct >= sortBasedMinGroups_ &&
+      numDistinct * 100 >= numInputRowsSinceSortedSpill_ * sortBasedMinPct_) {
+    // Nearly every input row is a group of its own, so the hash table only
+    // grows with the input. Spills all the groups as sorted runs and
+    // continues with an empty table. The output merges the runs, which
+    // bounds the table at about 'sortBasedMinGroups_' groups.
+    spill(0, 0);
+    numInputRowsSinceSortedSpill_ = 0;
+    return;
+  }
+
   auto tracker = pool_.getMemoryUsageTracker();
   const auto currentUsage = tracker->currentBytes();
   if (spillMemoryThreshold_ != 0 && currentUsage > spillMemoryThreshold_) {
@@ -576,7 +777,9 @@ void GroupingSet::spill(int64_t targetRows, int64_t targetBytes) {
         spillConfig_->maxFileSize,
         spillConfig_->minSpillRunSize,
         Spiller::spillPool(),
-        spillConfig_->executor);
+        spillConfig_->executor,
+        spillConfig_->compressionKind,
+        spillConfig_->writeCallback);
   }
   spiller_->spill(targetRows, targetBytes);
 }
@@ -639,6 +842,7 @@ bool GroupingSet::mergeNext(int32_t batchSize, const RowVectorPtr& result) {
     auto next = merge_->nextWithEquals();
     if (!next.first) {
       extractSpillResult(result);
+      mergeBatches_.clear();
       return result->size() > 0;
     }
     if (!nextKeyIsEqual_) {
@@ -661,14 +865,59 @@ void GroupingSet::initializeRow(
   for (auto i = 0; i < keyChannels_.size(); ++i) {
     mergeRows_->store(keys.decoded(i), keys.currentIndex(), mergeState_, i);
   }
-  vector_size_t zero = 0;
+  newMergeGroups_.push_back(row);
+}
+
+void GroupingSet::initializeMergeGroups() {
+  if (newMergeGroups_.empty()) {
+    return;
+  }
+  const auto numGroups = newMergeGroups_.size();
+  if (newMergeGroupIndices_.size() < numGroups) {
+    const auto oldSize = newMergeGroupIndices_.size();
+    newMergeGroupIndices_.resize(numGroups);
+    std::iota(
+        newMergeGroupIndices_.begin() + oldSize,
+        newMergeGroupIndices_.end(),
+        oldSize);
+  }
   for (auto& aggregate : aggregates_) {
     aggregate->initializeNewGroups(
-        &row, folly::Range<const vector_size_t*>(&zero, 1));
+        newMergeGroups_.data(),
+        folly::Range<const vector_size_t*>(
+            newMergeGroupIndices_.data(), numGroups));
+  }
+  newMergeGroups_.clear();
+}
+
+void GroupingSet::flushMergeBatch(const SpillMergeStream& stream) {
+  auto it = mergeBatches_.find(&stream);
+  if (it == mergeBatches_.end()) {
+    return;
   }
+  auto& batch = it->second;
+  batch.rows.updateBounds();
+  if (!batch.rows.hasSelections()) {
+    return;
+  }
+  initializeMergeGroups();
+  for (auto i = 0; i < aggregates_.size(); ++i) {
+    mergeArgs_[0] = stream.current().childAt(i + keyChannels_.size());
+    aggregates_[i]->addIntermediateResults(
+        batch.groups.data(), batch.rows, mergeArgs_, false);
+  }
+  batch.rows.clearAll();
+}
+
+void GroupingSet::flushMergeBatches() {
+  for (auto& [stream, batch] : mergeBatches_) {
+    flushMergeBatch(*stream);
+  }
+  initializeMergeGroups();
 }
 
 void GroupingSet::extractSpillResult(const RowVectorPtr& result) {
+  flushMergeBatches();
   std::vector<char*> rows(mergeRows_->numRows());
   RowContainerIterator iter;
   if (!rows.empty()) {
@@ -680,18 +929,20 @@ void GroupingSet::extractSpillResult(const RowVectorPtr& result) {
 }
 
 void GroupingSet::updateRow(SpillMergeStream& input, char* FOLLY_NONNULL row) {
-  if (input.currentIndex() >= mergeSelection_.size()) {
-    mergeSelection_.resize(bits::roundUp(input.currentIndex() + 1, 64));
-    mergeSelection_.clearAll();
-  }
-  mergeSelection_.setValid(input.currentIndex(), true);
-  mergeSelection_.updateBounds();
-  for (auto i = 0; i < aggregates_.size(); ++i) {
-    mergeArgs_[0] = input.current().childAt(i + keyChannels_.size());
-    aggregates_[i]->addSingleGroupIntermediateResults(
-        row, mergeSelection_, mergeArgs_, false);
+  bool isLastRow;
+  const auto index = input.currentIndex(&isLastRow);
+  auto& batch = mergeBatches_[&input];
+  if (index >= batch.rows.size()) {
+    const auto size = input.current().size();
+    batch.groups.resize(size);
+    batch.rows.resize(size, false);
+  }
+  batch.groups[index] = row;
+  batch.rows.setValid(index, true);
+  if (isLastRow) {
+    // The stream moves to its next vector on pop().
+    flushMergeBatch(input);
   }
-  mergeSelection_.setValid(input.currentIndex(), false);
 }
 
 } // namespace facebook::velox::exec
@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <folly/container/F14Map.h>
+
 #include "velox/exec/AggregationMasks.h"
 #include "velox/exec/HashTable.h"
 #include "velox/exec/Spiller.h"
@@ -35,6 +37,7 @@ class GroupingSet {
       std::vector<std::vector<column_index_t>>&& channelLists,
       std::vector<std::vector<VectorPtr>>&& constantLists,
       std::vector<TypePtr>&& intermediateTypes,
+      std::vector<bool>&& distinctAggregates,
       bool ignoreNullKeys,
       bool isPartial,
       bool isRawInput,
@@ -64,8 +67,22 @@ class GroupingSet {
 
   uint64_t allocatedBytes() const;
 
+  /// Returns the parts of allocatedBytes() used by the hash table, the fixed
+  /// width part of the rows and the out of line data of the rows.
+  std::vector<std::pair<std::string, int64_t>> memoryComponents() const;
+
   void resetPartial();
 
+  /// Makes each subsequent input row a group of its own instead of looking it
+  /// up in the hash table. A partial aggregation turns this on when its input
+  /// has so many distinct keys that the hash table can't reduce it. The
+  /// existing groups must have been flushed by resetPartial().
+  void enablePassThrough();
+
+  bool isPassThrough() const {
+    return passThrough_;
+  }
+
   const HashLookup& hashLookup() const;
 
   /// Spills content until under 'targetRows' and under 'targetBytes'
@@ -77,6 +94,12 @@ class GroupingSet {
   /// of this will be in a paused state and off thread.
   void spill(int64_t targetRows, int64_t targetBytes);
 
+  /// Returns true if this is a final or single grouped aggregation with
+  /// spilling enabled.
+  bool canSpill() const {
+    return !isPartial_ && !isGlobal_ && spillConfig_ != nullptr;
+  }
+
   /// Returns the spiller stats including total bytes and rows spilled so far.
   Spiller::Stats spilledStats() const {
     return spiller_ != nullptr ? spiller_->stats() : Spiller::Stats{};
@@ -87,16 +110,41 @@ class GroupingSet {
     return table_ ? table_->stats() : HashTableStats{};
   }
 
+  /// Returns the statistics of the allocator of the variable length keys and
+  /// accumulators or nullptr if not collected. See
+  /// QueryConfig::kAggregationTrackAllocatorStats.
+  const HashStringAllocator::Stats* FOLLY_NULLABLE allocatorStats() const {
+    return table_ ? table_->rows()->stringAllocator().stats()
+                  : stringAllocator_.stats();
+  }
+
   /// Return the number of rows kept in memory.
   int64_t numRows() const {
     return table_ ? table_->rows()->numRows() : 0;
   }
 
  private:
+  // The maximum capacity of an array mode hash table for adding the input
+  // to the aggregates by dense group id.
+  static constexpr uint64_t kMaxDenseGroupIds = 4096;
+
   void addInputForActiveRows(const RowVectorPtr& input, bool mayPushdown);
 
   void addRemainingInput();
 
+  // Adds the active rows of 'input' in pass-through mode, one group per row.
+  void addPassThroughInput(const RowVectorPtr& input, bool mayPushdown);
+
+  // Updates the accumulators of 'lookup_->hits' with the active rows of
+  // 'input'. Initializes the accumulators of 'lookup_->newGroups' first. If
+  // 'groupIds' is set, the raw input is added with
+  // Aggregate::addRawInputDense() unless it can be pushed down.
+  void updateAggregates(
+      const RowVectorPtr& input,
+      bool mayPushdown,
+      const uint64_t* FOLLY_NULLABLE groupIds = nullptr,
+      uint64_t numGroupIds = 0);
+
   void initializeGlobalAggregation();
 
   void destroyGlobalAggregations();
@@ -118,6 +166,22 @@ class GroupingSet {
   // index for this aggregation), otherwise it returns reference to activeRows_.
   const SelectivityVector& getSelectivityVector(size_t aggregateIndex) const;
 
+  bool isDistinctAggregate(size_t aggregateIndex) const {
+    return aggregateIndex < distinctAggregates_.size() &&
+        distinctAggregates_[aggregateIndex];
+  }
+
+  // Returns the subset of 'rows' whose values of the grouping keys and the
+  // inputs of the distinct aggregate at 'aggregateIndex' have not been seen
+  // before, and records these values in the distinct set of the aggregate.
+  const SelectivityVector& distinctRows(
+      size_t aggregateIndex,
+      const RowVectorPtr& input,
+      const SelectivityVector& rows);
+
+  // Returns the bytes allocated by the distinct sets of all aggregates.
+  uint64_t distinctSetBytes() const;
+
   // Checks if input will fit in the existing memory and increases
   // reservation if not. If reservation cannot be increased, spills
   // enough to make 'input' fit.
@@ -141,21 +205,35 @@ class GroupingSet {
   bool mergeNext(int32_t batchSize, const RowVectorPtr& result);
 
   // Initializes a new row in 'mergeRows' with the keys from the
-  // current element from 'keys'. Accumulators are left in the initial
-  // state with no data accumulated. This is called each time a new
-  // key is received from a merge of spilled data. After this
-  // updateRow() is called on the same element and on every subsequent
-  // element read from the stream until a new key is seen, at which
-  // time we again call initializeRow(). When enough rows have been
-  // accumulated and we have a new key, we produce the output and
-  // clear 'mergeRows_' with extractSpillResult() and only then do
-  // initializeRow().
+  // current element from 'keys'. The accumulators are initialized in
+  // batches by initializeMergeGroups() before any data is added to
+  // them. This is called each time a new key is received from a merge
+  // of spilled data. After this updateRow() is called on the same
+  // element and on every subsequent element read from the stream
+  // until a new key is seen, at which time we again call
+  // initializeRow(). When enough rows have been accumulated and we
+  // have a new key, we produce the output and clear 'mergeRows_' with
+  // extractSpillResult() and only then do initializeRow().
   void initializeRow(SpillMergeStream& keys, char* FOLLY_NONNULL row);
 
-  // Updates the accumulators in 'row' with the intermediate type data from
-  // 'keys'. This is called for each row received from a merge of spilled data.
+  // Adds the current element of 'keys' to the merge batch of its stream for
+  // updating the accumulators in 'row' with its intermediate type data. The
+  // batch is added to the accumulators before the stream moves past its
+  // current vector. This is called for each row received from a merge of
+  // spilled data.
   void updateRow(SpillMergeStream& keys, char* FOLLY_NONNULL row);
 
+  // Initializes the accumulators of the rows added by initializeRow() since
+  // the last call.
+  void initializeMergeGroups();
+
+  // Adds the intermediate results in the merge batch of 'stream' to their
+  // groups with one addIntermediateResults() call per aggregate.
+  void flushMergeBatch(const SpillMergeStream& stream);
+
+  // Flushes the merge batches of all streams.
+  void flushMergeBatches();
+
   // Copies the finalized state from 'mergeRows' to 'result' and clears
   // 'mergeRows'. Used for producing a batch of results when aggregating spilled
   // groups.
@@ -182,12 +260,28 @@ class GroupingSet {
   // Types for extracting accumulators for spilling.
   const std::vector<TypePtr> intermediateTypes_;
 
+  // True for each aggregate that only adds the distinct values of its inputs
+  // within each group. Can be shorter than 'aggregates_'.
+  const std::vector<bool> distinctAggregates_;
+
   const bool ignoreNullKeys_;
 
   // The maximum memory usage that a final aggregation can hold before spilling.
   // If it is zero, then there is no such limit.
   const uint64_t spillMemoryThreshold_;
 
+  // The number of groups at which nearly unique grouping keys make the
+  // aggregation spill all of its groups. 0 if disabled. See
+  // QueryConfig::kAggregationSortBasedMinGroups.
+  const int64_t sortBasedMinGroups_;
+
+  // Minimum percentage of groups per input row for spilling all groups.
+  const int32_t sortBasedMinPct_;
+
+  // Number of input rows added to 'table_' since the last spill of all groups
+  // for nearly unique grouping keys.
+  int64_t numInputRowsSinceSortedSpill_{0};
+
   const Spiller::Config* FOLLY_NULLABLE const spillConfig_; // Not owned.
 
   // Boolean indicating whether accumulators for a global aggregation (i.e.
@@ -208,8 +302,21 @@ class GroupingSet {
   AllocationPool rows_;
   const bool isAdaptive_;
 
+  // Allocate the variable length data of the groups append-only. See
+  // QueryConfig::kAggregationAppendOnlyStrings.
+  const bool appendOnlyStrings_;
+
+  // Pack the rows of the hash table. See QueryConfig::kCompactRowLayout.
+  const bool compactLayout_;
+
+  // See QueryConfig::kAggregationTrackAllocatorStats.
+  const bool trackAllocatorStats_;
+
   bool noMoreInput_{false};
 
+  // True if the input rows bypass the hash table. See enablePassThrough().
+  bool passThrough_{false};
+
   /// In case of partial streaming aggregation, the input vector passed to
   /// addInput(). A set of rows that belong to the last group of pre-grouped
   /// keys need to be processed after flushing the hash table and accumulators.
@@ -237,9 +344,34 @@ class GroupingSet {
   // Intermediate vector for passing arguments to aggregate in merging spill.
   std::vector<VectorPtr> mergeArgs_;
 
-  // Indicates the element in mergeArgs_[0] that corresponds to the accumulator
-  // to merge.
-  SelectivityVector mergeSelection_;
+  // The values seen so far by a distinct aggregate. The keys of 'table' are
+  // the grouping keys followed by the non-constant inputs of the aggregate,
+  // so that each distinct value of each group is added to the aggregate
+  // once. The sets are not spilled: a spilled group continues to receive
+  // only the values it has not seen.
+  struct DistinctSet {
+    std::unique_ptr<BaseHashTable> table;
+    std::unique_ptr<HashLookup> lookup;
+    // The rows of the last input added to the aggregate.
+    SelectivityVector rows;
+  };
+
+  // One per aggregate. Created on first input to a distinct aggregate.
+  std::vector<DistinctSet> distinctSets_;
+
+  // The rows of the current vector of a merge stream whose intermediate
+  // results are not yet added to their groups in 'mergeRows_'.
+  struct MergeBatch {
+    // The group in 'mergeRows_' of each selected row.
+    std::vector<char*> groups;
+    SelectivityVector rows;
+  };
+
+  folly::F14FastMap<const SpillMergeStream*, MergeBatch> mergeBatches_;
+
+  // The rows of 'mergeRows_' whose accumulators are not initialized yet.
+  std::vector<char*> newMergeGroups_;
+  std::vector<vector_size_t> newMergeGroupIndices_;
 
   // True if 'merge_' indicates that the next key is the same as the current
   // one.
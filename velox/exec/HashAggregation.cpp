@@ -14,12 +14,35 @@
  * limitations under the License.
  */
 #include "velox/exec/HashAggregation.h"
+#include <folly/ScopeGuard.h>
+#include <folly/hash/Hash.h>
 #include <optional>
+#include "velox/common/base/AsyncSource.h"
 #include "velox/exec/Aggregate.h"
 #include "velox/exec/OperatorUtils.h"
+#include "velox/exec/SortedAggregate.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
+namespace {
+// Waits for all 'steps' to finish, also in case of error, because the steps
+// reference the grouping sets of the operator. Sets 'error' to the last error.
+void syncMergeSteps(
+    std::vector<std::shared_ptr<AsyncSource<bool>>>& steps,
+    std::exception_ptr& error,
+    bool log = false) {
+  for (auto& step : steps) {
+    try {
+      step->move();
+    } catch (const std::exception& e) {
+      if (log) {
+        LOG(ERROR) << "Error in parallel aggregation merge: " << e.what();
+      }
+      error = std::current_exception();
+    }
+  }
+}
+} // namespace
 
 HashAggregation::HashAggregation(
     int32_t operatorId,
@@ -42,6 +65,10 @@ HashAggregation::HashAggregation(
           driverCtx->queryConfig().partialAggregationGoodPct()),
       maxExtendedPartialAggregationMemoryUsage_(
           driverCtx->queryConfig().maxExtendedPartialAggregationMemoryUsage()),
+      abandonPartialAggregationMinRows_(
+          driverCtx->queryConfig().abandonPartialAggregationMinRows()),
+      abandonPartialAggregationMinPct_(
+          driverCtx->queryConfig().abandonPartialAggregationMinPct()),
       spillConfig_(
           aggregationNode->canSpill(driverCtx->queryConfig())
               ? operatorCtx_->makeSpillConfig(Spiller::Type::kAggregate)
@@ -49,12 +76,70 @@ HashAggregation::HashAggregation(
       maxPartialAggregationMemoryUsage_(
           driverCtx->queryConfig().maxPartialAggregationMemoryUsage()) {
   VELOX_CHECK_NOT_NULL(memoryTracker_, "Memory usage tracker is not set");
-  auto inputType = aggregationNode->sources()[0]->outputType();
+  const auto& inputType = aggregationNode->sources()[0]->outputType();
+  groupingSet_ = createGroupingSet(*aggregationNode);
+
+  std::vector<column_index_t> keyChannels;
+  keyChannels.reserve(aggregationNode->groupingKeys().size());
+  for (const auto& key : aggregationNode->groupingKeys()) {
+    keyChannels.push_back(exprToChannel(key.get(), inputType));
+  }
+
+  if (isDistinct_) {
+    for (auto i = 0; i < keyChannels.size(); ++i) {
+      identityProjections_.emplace_back(keyChannels[i], i);
+    }
+  }
+
+  if (isPartialOutput_ && !isGlobal_ && !isDistinct_ &&
+      aggregationNode->preGroupedKeys().empty() &&
+      abandonPartialAggregationMinRows_ > 0) {
+    for (auto channel : keyChannels) {
+      sampleHashers_.push_back(
+          VectorHasher::create(inputType->childAt(channel), channel));
+    }
+    sampleAllocator_ = std::make_unique<HashStringAllocator>(pool());
+    sampleHll_ = std::make_unique<common::hll::DenseHll>(
+        kSampleHllIndexBitLength, sampleAllocator_.get());
+  }
+
+  const auto mergePartitionBits =
+      driverCtx->queryConfig().aggregationMergePartitionBits();
+  if (mergePartitionBits > 0 && canMergeInParallel(*aggregationNode)) {
+    partitionFunction_ = std::make_unique<HashPartitionFunction>(
+        HashBitRange(
+            kMergePartitionStartBit,
+            kMergePartitionStartBit + mergePartitionBits),
+        inputType,
+        keyChannels);
+    const auto numPartitions = partitionFunction_->numPartitions();
+    otherGroupingSets_.reserve(numPartitions - 1);
+    for (auto i = 1; i < numPartitions; ++i) {
+      otherGroupingSets_.push_back(createGroupingSet(*aggregationNode));
+    }
+    partitionInputs_.resize(numPartitions);
+  }
+}
+
+bool HashAggregation::canMergeInParallel(
+    const core::AggregationNode& aggregationNode) const {
+  // The partial aggregation flushes its output while receiving input and the
+  // distinct aggregation produces output for each input, so neither can defer
+  // the aggregation to the end of the input. The spilling aggregation already
+  // merges its input by spill partition.
+  return !isPartialOutput_ && !isGlobal_ && !isDistinct_ &&
+      aggregationNode.preGroupedKeys().empty() && !spillConfig_.has_value() &&
+      operatorCtx_->task()->queryCtx()->executor() != nullptr;
+}
+
+std::unique_ptr<GroupingSet> HashAggregation::createGroupingSet(
+    const core::AggregationNode& aggregationNode) {
+  const auto& inputType = aggregationNode.sources()[0]->outputType();
 
-  auto numHashers = aggregationNode->groupingKeys().size();
+  auto numHashers = aggregationNode.groupingKeys().size();
   std::vector<std::unique_ptr<VectorHasher>> hashers;
   hashers.reserve(numHashers);
-  for (const auto& key : aggregationNode->groupingKeys()) {
+  for (const auto& key : aggregationNode.groupingKeys()) {
     auto channel = exprToChannel(key.get(), inputType);
     VELOX_CHECK_NE(
         channel,
@@ -64,23 +149,24 @@ HashAggregation::HashAggregation(
   }
 
   std::vector<column_index_t> preGroupedChannels;
-  preGroupedChannels.reserve(aggregationNode->preGroupedKeys().size());
-  for (const auto& key : aggregationNode->preGroupedKeys()) {
+  preGroupedChannels.reserve(aggregationNode.preGroupedKeys().size());
+  for (const auto& key : aggregationNode.preGroupedKeys()) {
     auto channel = exprToChannel(key.get(), inputType);
     preGroupedChannels.push_back(channel);
   }
 
-  auto numAggregates = aggregationNode->aggregates().size();
+  auto numAggregates = aggregationNode.aggregates().size();
   std::vector<std::unique_ptr<Aggregate>> aggregates;
   aggregates.reserve(numAggregates);
   std::vector<std::optional<column_index_t>> aggrMaskChannels;
   aggrMaskChannels.reserve(numAggregates);
-  auto numMasks = aggregationNode->aggregateMasks().size();
+  auto numMasks = aggregationNode.aggregateMasks().size();
   std::vector<std::vector<column_index_t>> args;
   std::vector<std::vector<VectorPtr>> constantLists;
   std::vector<TypePtr> intermediateTypes;
+  std::vector<bool> distinctAggregates;
   for (auto i = 0; i < numAggregates; i++) {
-    const auto& aggregate = aggregationNode->aggregates()[i];
+    const auto& aggregate = aggregationNode.aggregates()[i];
 
     std::vector<column_index_t> channels;
     std::vector<VectorPtr> constants;
@@ -95,7 +181,7 @@ HashAggregation::HashAggregation(
         constants.push_back(nullptr);
       }
     }
-    if (isRawInput(aggregationNode->step())) {
+    if (isRawInput(aggregationNode.step())) {
       intermediateTypes.push_back(
           Aggregate::intermediateType(aggregate->name(), argTypes));
     } else {
@@ -109,7 +195,7 @@ HashAggregation::HashAggregation(
     // Setup aggregation mask: convert the Variable Reference name to the
     // channel (projection) index, if there is a mask.
     if (i < numMasks) {
-      const auto& aggrMask = aggregationNode->aggregateMasks()[i];
+      const auto& aggrMask = aggregationNode.aggregateMasks()[i];
       if (aggrMask == nullptr) {
         aggrMaskChannels.emplace_back(std::nullopt);
       } else {
@@ -121,10 +207,28 @@ HashAggregation::HashAggregation(
     }
 
     const auto& resultType = outputType_->childAt(numHashers + i);
-    aggregates.push_back(Aggregate::create(
-        aggregate->name(), aggregationNode->step(), argTypes, resultType));
+    auto function = Aggregate::create(
+        aggregate->name(), aggregationNode.step(), argTypes, resultType);
+    if (aggregationNode.isOrderedAggregate(i)) {
+      // The sorting keys follow the inputs of the aggregate.
+      const auto& orderBy = aggregationNode.aggregateOrderBy()[i];
+      std::vector<TypePtr> sortingKeyTypes;
+      for (const auto& key : orderBy.sortingKeys) {
+        sortingKeyTypes.push_back(key->type());
+        channels.push_back(exprToChannel(key.get(), inputType));
+        constants.push_back(nullptr);
+      }
+      function = std::make_unique<SortedAggregate>(
+          std::move(function),
+          argTypes,
+          sortingKeyTypes,
+          orderBy.sortingOrders,
+          pool());
+    }
+    aggregates.push_back(std::move(function));
     args.push_back(channels);
     constantLists.push_back(constants);
+    distinctAggregates.push_back(aggregationNode.isDistinctAggregate(i));
   }
 
   // Check that aggregate result type match the output type
@@ -136,16 +240,10 @@ HashAggregation::HashAggregation(
         "Unexpected result type for an aggregation: {}, expected {}, step {}",
         aggResultType->toString(),
         expectedType->toString(),
-        core::AggregationNode::stepName(aggregationNode->step()));
-  }
-
-  if (isDistinct_) {
-    for (auto i = 0; i < hashers.size(); ++i) {
-      identityProjections_.emplace_back(hashers[i]->channel(), i);
-    }
+        core::AggregationNode::stepName(aggregationNode.step()));
   }
 
-  groupingSet_ = std::make_unique<GroupingSet>(
+  return std::make_unique<GroupingSet>(
       std::move(hashers),
       std::move(preGroupedChannels),
       std::move(aggregates),
@@ -153,46 +251,87 @@ HashAggregation::HashAggregation(
       std::move(args),
       std::move(constantLists),
       std::move(intermediateTypes),
-      aggregationNode->ignoreNullKeys(),
+      std::move(distinctAggregates),
+      aggregationNode.ignoreNullKeys(),
       isPartialOutput_,
-      isRawInput(aggregationNode->step()),
+      isRawInput(aggregationNode.step()),
       spillConfig_.has_value() ? &spillConfig_.value() : nullptr,
       operatorCtx_.get());
 }
 
+void HashAggregation::recordSpillStats() {
+  const auto spillStats = groupingSet_->spilledStats();
+  const auto hashTableStats = groupingSet_->hashTableStats();
+  auto lockedStats = stats_.wlock();
+  lockedStats->spilledBytes = spillStats.spilledBytes;
+  lockedStats->spilledRows = spillStats.spilledRows;
+  lockedStats->spilledPartitions = spillStats.spilledPartitions;
+  lockedStats->spilledFiles = spillStats.spilledFiles;
+  spillStats.setRuntimeStats(lockedStats->runtimeStats);
+
+  lockedStats->runtimeStats["hashtable.capacity"] =
+      RuntimeMetric(hashTableStats.capacity);
+  lockedStats->runtimeStats["hashtable.numRehashes"] =
+      RuntimeMetric(hashTableStats.numRehashes);
+  lockedStats->runtimeStats["hashtable.numDistinct"] =
+      RuntimeMetric(hashTableStats.numDistinct);
+  if (hashTableStats.numTombstones != 0) {
+    lockedStats->runtimeStats["hashtable.numTombstones"] =
+        RuntimeMetric(hashTableStats.numTombstones);
+  }
+  if (const auto* allocatorStats = groupingSet_->allocatorStats()) {
+    allocatorStats->addRuntimeStats("hsa.", lockedStats->runtimeStats);
+  }
+  lockedStats.unlock();
+  for (const auto& [component, bytes] : groupingSet_->memoryComponents()) {
+    setMemoryComponent(component, bytes);
+  }
+}
+
+bool HashAggregation::canReclaim() const {
+  // The spilled partitions are merged after the input is complete, so spill is
+  // only possible while the input is being received.
+  return groupingSet_ != nullptr && groupingSet_->canSpill() && !noMoreInput_;
+}
+
+void HashAggregation::reclaim(uint64_t /*targetBytes*/) {
+  VELOX_CHECK(canReclaim());
+  if (groupingSet_->numRows() == 0) {
+    return;
+  }
+  groupingSet_->spill(0, 0);
+  recordSpillStats();
+  memoryTracker_->release();
+}
+
 void HashAggregation::addInput(RowVectorPtr input) {
+  if (partitionFunction_ != nullptr) {
+    addPartitionedInput(input);
+    numInputRows_ += input->size();
+    return;
+  }
   if (!pushdownChecked_) {
     mayPushdown_ = operatorCtx_->driver()->mayPushdownAggregation(this);
     pushdownChecked_ = true;
   }
+  if (sampleHll_ != nullptr) {
+    sampleKeys(input);
+  }
   groupingSet_->addInput(input, mayPushdown_);
   numInputRows_ += input->size();
-  {
-    const auto spillStats = groupingSet_->spilledStats();
-    const auto hashTableStats = groupingSet_->hashTableStats();
-    auto lockedStats = stats_.wlock();
-    lockedStats->spilledBytes = spillStats.spilledBytes;
-    lockedStats->spilledRows = spillStats.spilledRows;
-    lockedStats->spilledPartitions = spillStats.spilledPartitions;
-    lockedStats->spilledFiles = spillStats.spilledFiles;
-
-    lockedStats->runtimeStats["hashtable.capacity"] =
-        RuntimeMetric(hashTableStats.capacity);
-    lockedStats->runtimeStats["hashtable.numRehashes"] =
-        RuntimeMetric(hashTableStats.numRehashes);
-    lockedStats->runtimeStats["hashtable.numDistinct"] =
-        RuntimeMetric(hashTableStats.numDistinct);
-    if (hashTableStats.numTombstones != 0) {
-      lockedStats->runtimeStats["hashtable.numTombstones"] =
-          RuntimeMetric(hashTableStats.numTombstones);
-    }
+  recordSpillStats();
+  if (sampleHll_ != nullptr &&
+      numSampledRows_ >= abandonPartialAggregationMinRows_) {
+    maybeAbandonPartialAggregation();
   }
 
   // NOTE: we should not trigger partial output flush in case of global
   // aggregation as the final aggregator will handle it the same way as the
   // partial aggregator. Hence, we have to use more memory anyway.
   if (isPartialOutput_ && !isGlobal_ &&
-      groupingSet_->allocatedBytes() > maxPartialAggregationMemoryUsage_) {
+      (passThrough_ ||
+       groupingSet_->allocatedBytes() > maxPartialAggregationMemoryUsage_)) {
+    // In pass-through mode, the groups of each input are flushed right away.
     partialFull_ = true;
   }
 
@@ -206,6 +345,132 @@ void HashAggregation::addInput(RowVectorPtr input) {
   }
 }
 
+void HashAggregation::addPartitionedInput(const RowVectorPtr& input) {
+  // The input is aggregated after the end of the input, so the lazy vectors
+  // must be loaded before the producer moves on.
+  std::vector<VectorPtr> children;
+  children.reserve(input->childrenSize());
+  for (const auto& child : input->children()) {
+    children.push_back(BaseVector::loadedVectorShared(child));
+  }
+
+  const auto numRows = input->size();
+  const auto numPartitions = partitionInputs_.size();
+  partitionFunction_->partition(*input, partitions_);
+  partitionSizes_.assign(numPartitions, 0);
+  for (auto row = 0; row < numRows; ++row) {
+    ++partitionSizes_[partitions_[row]];
+  }
+  for (auto i = 0; i < numPartitions; ++i) {
+    if (partitionSizes_[i] == numRows) {
+      partitionInputs_[i].push_back(std::make_shared<RowVector>(
+          pool(), input->type(), nullptr, numRows, std::move(children)));
+      return;
+    }
+  }
+
+  std::vector<BufferPtr> indices(numPartitions);
+  std::vector<vector_size_t*> rawIndices(numPartitions);
+  for (auto i = 0; i < numPartitions; ++i) {
+    if (partitionSizes_[i] > 0) {
+      indices[i] = allocateIndices(partitionSizes_[i], pool());
+      rawIndices[i] = indices[i]->asMutable<vector_size_t>();
+    }
+  }
+  partitionSizes_.assign(numPartitions, 0);
+  for (auto row = 0; row < numRows; ++row) {
+    const auto partition = partitions_[row];
+    rawIndices[partition][partitionSizes_[partition]++] = row;
+  }
+  const auto rowType = asRowType(input->type());
+  for (auto i = 0; i < numPartitions; ++i) {
+    if (partitionSizes_[i] > 0) {
+      partitionInputs_[i].push_back(wrap(
+          partitionSizes_[i],
+          std::move(indices[i]),
+          rowType,
+          children,
+          pool()));
+    }
+  }
+}
+
+void HashAggregation::noMoreInput() {
+  if (partitionFunction_ != nullptr) {
+    mergePartitions();
+  } else {
+    groupingSet_->noMoreInput();
+  }
+  Operator::noMoreInput();
+}
+
+void HashAggregation::mergePartitions() {
+  auto* executor = operatorCtx_->task()->queryCtx()->executor();
+  std::vector<std::shared_ptr<AsyncSource<bool>>> mergeSteps;
+  auto sync = folly::makeGuard([&]() {
+    // This is executed on returning path, possibly in unwinding, so must not
+    // throw.
+    std::exception_ptr error;
+    syncMergeSteps(mergeSteps, error, true);
+  });
+
+  for (auto i = 0; i < partitionInputs_.size(); ++i) {
+    auto* groupingSet =
+        i == 0 ? groupingSet_.get() : otherGroupingSets_[i - 1].get();
+    mergeSteps.push_back(std::make_shared<AsyncSource<bool>>(
+        [groupingSet, inputs = std::move(partitionInputs_[i])]() {
+          for (const auto& input : inputs) {
+            groupingSet->addInput(input, false);
+          }
+          groupingSet->noMoreInput();
+          return std::make_unique<bool>(true);
+        }));
+    executor->add([step = mergeSteps.back()]() { step->prepare(); });
+  }
+  std::exception_ptr error;
+  syncMergeSteps(mergeSteps, error);
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  addRuntimeStat("numMergePartitions", RuntimeCounter(partitionInputs_.size()));
+  partitionInputs_.clear();
+}
+
+void HashAggregation::sampleKeys(const RowVectorPtr& input) {
+  const auto numRows = input->size();
+  sampleRows_.resize(numRows);
+  sampleRows_.setAll();
+  sampleHashes_.resize(numRows);
+  for (auto i = 0; i < sampleHashers_.size(); ++i) {
+    auto& hasher = sampleHashers_[i];
+    auto key = input->childAt(hasher->channel())->loadedVector();
+    hasher->decode(*key, sampleRows_);
+    hasher->hash(sampleRows_, i > 0, sampleHashes_);
+  }
+  for (auto i = 0; i < numRows; ++i) {
+    // The top bits select the HyperLogLog bucket, so the hashes are mixed
+    // again to spread them.
+    sampleHll_->insertHash(folly::hasher<uint64_t>()(sampleHashes_[i]));
+  }
+  numSampledRows_ += numRows;
+}
+
+void HashAggregation::maybeAbandonPartialAggregation() {
+  const auto numDistinct = sampleHll_->cardinality();
+  addRuntimeStat("sampledDistinctKeys", RuntimeCounter(numDistinct));
+  sampleHll_.reset();
+  sampleAllocator_.reset();
+  sampleHashers_.clear();
+  if (numDistinct * 100 < numSampledRows_ * abandonPartialAggregationMinPct_) {
+    return;
+  }
+  // Flushes the groups so far before switching 'groupingSet_' to
+  // pass-through.
+  passThrough_ = true;
+  partialFull_ = true;
+  addRuntimeStat("abandonedPartialAggregation", RuntimeCounter(1));
+}
+
 void HashAggregation::prepareOutput(vector_size_t size) {
   if (output_) {
     VectorPtr output = std::move(output_);
@@ -235,6 +500,12 @@ void HashAggregation::resetPartialOutputIfNeed() {
   partialFull_ = false;
   numOutputRows_ = 0;
   numInputRows_ = 0;
+  if (passThrough_) {
+    if (!groupingSet_->isPassThrough()) {
+      groupingSet_->enablePassThrough();
+    }
+    return;
+  }
   if (!finished_) {
     maybeIncreasePartialAggregationMemoryUsage(aggregationPct);
   }
@@ -319,6 +590,13 @@ RowVectorPtr HashAggregation::getOutput() {
   prepareOutput(batchSize);
 
   bool hasData = groupingSet_->getOutput(batchSize, resultIterator_, output_);
+  while (!hasData && nextOutputGroupingSet_ < otherGroupingSets_.size()) {
+    // Moves on to the next merge partition. This frees the memory of the
+    // exhausted grouping set.
+    groupingSet_ = std::move(otherGroupingSets_[nextOutputGroupingSet_++]);
+    resultIterator_.reset();
+    hasData = groupingSet_->getOutput(batchSize, resultIterator_, output_);
+  }
   if (!hasData) {
     resultIterator_.reset();
     if (noMoreInput_) {
@@ -15,7 +15,9 @@
  */
 #pragma once
 
+#include "velox/common/hyperloglog/DenseHll.h"
 #include "velox/exec/GroupingSet.h"
+#include "velox/exec/HashPartitionFunction.h"
 #include "velox/exec/Operator.h"
 
 namespace facebook::velox::exec {
@@ -35,10 +37,7 @@ class HashAggregation : public Operator {
     return !noMoreInput_ && !partialFull_;
   }
 
-  void noMoreInput() override {
-    groupingSet_->noMoreInput();
-    Operator::noMoreInput();
-  }
+  void noMoreInput() override;
 
   BlockingReason isBlocked(ContinueFuture* /* unused */) override {
     return BlockingReason::kNotBlocked;
@@ -49,9 +48,53 @@ class HashAggregation : public Operator {
   void close() override {
     Operator::close();
     groupingSet_.reset();
+    otherGroupingSets_.clear();
+    partitionInputs_.clear();
   }
 
+  bool canReclaim() const override;
+
+  void reclaim(uint64_t targetBytes) override;
+
  private:
+  // The start bit of the grouping key hash bits that select the merge
+  // partition. The bits below are used by the hash tables of the partitions.
+  static constexpr uint8_t kMergePartitionStartBit = 40;
+
+  // The HyperLogLog index bit length for estimating the number of distinct
+  // grouping keys of a partial aggregation. The standard error is 0.023.
+  static constexpr int8_t kSampleHllIndexBitLength = 12;
+
+  // Creates a grouping set for 'aggregationNode'. There is one grouping set
+  // per merge partition.
+  std::unique_ptr<GroupingSet> createGroupingSet(
+      const core::AggregationNode& aggregationNode);
+
+  // Returns true if the input of 'aggregationNode' can be partitioned by the
+  // grouping keys and the partitions aggregated in parallel.
+  bool canMergeInParallel(const core::AggregationNode& aggregationNode) const;
+
+  // Splits 'input' by merge partition and buffers the partitions until
+  // noMoreInput().
+  void addPartitionedInput(const RowVectorPtr& input);
+
+  // Aggregates the buffered input of each merge partition into its grouping
+  // set. The partitions are aggregated in parallel on the driver executor.
+  void mergePartitions();
+
+  // Adds the grouping key hashes of 'input' to 'sampleHll_'.
+  void sampleKeys(const RowVectorPtr& input);
+
+  // Invoked when 'abandonPartialAggregationMinRows_' input rows have been
+  // sampled. Switches the partial aggregation to pass-through if the estimated
+  // number of distinct keys is too high for the hash table to reduce the
+  // input.
+  void maybeAbandonPartialAggregation();
+
+  // Updates the operator stats with the spiller and hash table stats and the
+  // memory components with the memory of 'groupingSet_'.
+  void recordSpillStats();
+
   void prepareOutput(vector_size_t size);
 
   // Invoked to reset partial aggregation state if it was full and has been
@@ -73,11 +116,42 @@ class HashAggregation : public Operator {
   const std::shared_ptr<memory::MemoryUsageTracker> memoryTracker_;
   const double partialAggregationGoodPct_;
   const int64_t maxExtendedPartialAggregationMemoryUsage_;
+  const int64_t abandonPartialAggregationMinRows_;
+  const int32_t abandonPartialAggregationMinPct_;
   const std::optional<Spiller::Config> spillConfig_;
 
   int64_t maxPartialAggregationMemoryUsage_;
   std::unique_ptr<GroupingSet> groupingSet_;
 
+  // Set if the input is partitioned by the grouping keys for parallel merge.
+  // 'groupingSet_' aggregates the first partition and 'otherGroupingSets_' the
+  // rest. When the output of 'groupingSet_' is exhausted, it is replaced by
+  // the next grouping set in 'otherGroupingSets_'.
+  std::unique_ptr<HashPartitionFunction> partitionFunction_;
+  std::vector<std::unique_ptr<GroupingSet>> otherGroupingSets_;
+  size_t nextOutputGroupingSet_{0};
+
+  // The buffered input of each merge partition.
+  std::vector<std::vector<RowVectorPtr>> partitionInputs_;
+
+  // Reusable memory for partitioning the input.
+  std::vector<uint32_t> partitions_;
+  std::vector<vector_size_t> partitionSizes_;
+
+  // Set while sampling the grouping keys of the first
+  // 'abandonPartialAggregationMinRows_' input rows of a partial aggregation.
+  std::vector<std::unique_ptr<VectorHasher>> sampleHashers_;
+  std::unique_ptr<HashStringAllocator> sampleAllocator_;
+  std::unique_ptr<common::hll::DenseHll> sampleHll_;
+  int64_t numSampledRows_{0};
+  SelectivityVector sampleRows_;
+  raw_vector<uint64_t> sampleHashes_;
+
+  // True if the partial aggregation passes its input rows through without
+  // grouping them. 'groupingSet_' is switched to pass-through on the next
+  // flush.
+  bool passThrough_{false};
+
   bool partialFull_ = false;
   bool newDistincts_ = false;
   bool finished_ = false;
@@ -34,9 +34,13 @@ BlockingReason fromStateToBlockingReason(HashBuild::State state) {
     case HashBuild::State::kWaitForSpill:
       return BlockingReason::kWaitForSpill;
     case HashBuild::State::kWaitForBuild:
+      FOLLY_FALLTHROUGH;
+    case HashBuild::State::kWaitForSharedBuild:
       return BlockingReason::kWaitForJoinBuild;
     case HashBuild::State::kWaitForProbe:
       return BlockingReason::kWaitForJoinProbe;
+    case HashBuild::State::kWaitForMemory:
+      return BlockingReason::kWaitForMemory;
     default:
       VELOX_UNREACHABLE(HashBuild::stateName(state));
   }
@@ -50,6 +54,8 @@ HashBuild::HashBuild(
     : Operator(driverCtx, nullptr, operatorId, joinNode->id(), "HashBuild"),
       joinNode_(std::move(joinNode)),
       joinType_{joinNode_->joinType()},
+      maxBloomFilterEntries_(
+          driverCtx->queryConfig().hashJoinBloomFilterMaxEntries()),
       nullAware_{joinNode_->isNullAware()},
       joinBridge_(operatorCtx_->task()->getHashJoinBridgeLocked(
           operatorCtx_->driverCtx()->splitGroupId,
@@ -66,6 +72,16 @@ HashBuild::HashBuild(
   VELOX_CHECK_NOT_NULL(joinBridge_);
   joinBridge_->addBuilder();
 
+  if (driverCtx->queryConfig().hashJoinBuildSharingEnabled() &&
+      canShareBuild()) {
+    sharedBuild_ = SharedHashJoinBuild::getOrCreate(
+        operatorCtx_->task()->queryCtx(),
+        operatorCtx_->driverCtx()->splitGroupId,
+        planNodeId());
+    isSharedBuilder_ = sharedBuild_->tryBecomeBuilder(operatorCtx_->taskId());
+    joinBridge_->setSharedBuild(sharedBuild_);
+  }
+
   auto outputType = joinNode_->sources()[1]->outputType();
 
   auto numKeys = joinNode_->rightKeys().size();
@@ -124,6 +140,9 @@ void HashBuild::setupTable() {
   for (int i = numKeys; i < tableType_->size(); ++i) {
     dependentTypes.emplace_back(tableType_->childAt(i));
   }
+  const bool compactLayout =
+      operatorCtx_->driverCtx()->queryConfig().compactRowLayout();
+  dropDuplicates_ = false;
   if (joinNode_->isRightJoin() || joinNode_->isFullJoin() ||
       joinNode_->isRightSemiProjectJoin()) {
     // Do not ignore null keys.
@@ -132,7 +151,8 @@ void HashBuild::setupTable() {
         dependentTypes,
         true, // allowDuplicates
         true, // hasProbedFlag
-        pool());
+        pool(),
+        compactLayout);
   } else {
     // (Left) semi and anti join with no extra filter only needs to know whether
     // there is a match. Hence, no need to store entries with duplicate keys.
@@ -141,6 +161,7 @@ void HashBuild::setupTable() {
          joinNode_->isLeftSemiProjectJoin() || isAntiJoin(joinType_));
     // Right semi join needs to tag build rows that were probed.
     const bool needProbedFlag = joinNode_->isRightSemiFilterJoin();
+    dropDuplicates_ = dropDuplicates && !spillEnabled();
     if (isLeftNullAwareJoinWithFilter(joinNode_)) {
       // We need to check null key rows in build side in case of null-aware anti
       // or left semi project join with filter set.
@@ -149,7 +170,8 @@ void HashBuild::setupTable() {
           dependentTypes,
           !dropDuplicates, // allowDuplicates
           needProbedFlag, // hasProbedFlag
-          pool());
+          pool(),
+          compactLayout);
     } else {
       // Ignore null keys
       table_ = HashTable<true>::createForJoin(
@@ -157,10 +179,14 @@ void HashBuild::setupTable() {
           dependentTypes,
           !dropDuplicates, // allowDuplicates
           needProbedFlag, // hasProbedFlag
-          pool());
+          pool(),
+          compactLayout);
     }
   }
   analyzeKeys_ = table_->hashMode() != BaseHashTable::HashMode::kHash;
+  if (dropDuplicates_) {
+    lookup_ = std::make_unique<HashLookup>(table_->hashers());
+  }
 }
 
 void HashBuild::setupSpiller(SpillPartition* spillPartition) {
@@ -185,6 +211,7 @@ void HashBuild::setupSpiller(SpillPartition* spillPartition) {
     // Disable spilling if exceeding the max spill level and the query might run
     // out of memory if the restored partition still can't fit in memory.
     if (spillConfig.exceedSpillLevelLimit(startBit)) {
+      exceededMaxSpillLevelLimit_ = true;
       return;
     }
     hashBits =
@@ -203,7 +230,9 @@ void HashBuild::setupSpiller(SpillPartition* spillPartition) {
       spillConfig.maxFileSize,
       spillConfig.minSpillRunSize,
       Spiller::spillPool(),
-      spillConfig.executor);
+      spillConfig.executor,
+      spillConfig.compressionKind,
+      spillConfig.writeCallback);
 
   const int32_t numPartitions = spiller_->hashBits().numPartitions();
   spillInputIndicesBuffers_.resize(numPartitions);
@@ -275,9 +304,30 @@ void HashBuild::removeInputRowsForAntiJoinFilter() {
   }
 }
 
+bool HashBuild::canShareBuild() const {
+  // The probe side marks the probed rows of the table for these join types.
+  return !spillEnabled() && !nullAware_ && !isRightJoin(joinType_) &&
+      !isFullJoin(joinType_) && !isRightSemiFilterJoin(joinType_) &&
+      !isRightSemiProjectJoin(joinType_);
+}
+
 void HashBuild::addInput(RowVectorPtr input) {
   checkRunning();
 
+  if (sharedBuild_ != nullptr && !isSharedBuilder_) {
+    // The input is the same as the one of the builder task.
+    return;
+  }
+
+  if (isAntiJoin(joinType_) && nullAware_ && !joinNode_->filter() &&
+      joinBridge_->buildSideHasNullKeys()) {
+    // A peer has seen a null join key. The join returns no rows, so the rest
+    // of the input is not needed.
+    joinHasNullKeys_ = true;
+    noMoreInput();
+    return;
+  }
+
   if (!ensureInputFits(input)) {
     VELOX_CHECK_NOT_NULL(input_);
     VELOX_CHECK(future_.valid());
@@ -314,6 +364,8 @@ void HashBuild::addInput(RowVectorPtr input) {
     if (isAntiJoin(joinType_)) {
       // Null-aware anti join with no extra filter returns no rows if build side
       // has nulls in join keys. Hence, we can stop processing on first null.
+      // Let the peers stop too.
+      joinBridge_->setBuildSideHasNullKeys();
       noMoreInput();
       return;
     }
@@ -324,6 +376,12 @@ void HashBuild::addInput(RowVectorPtr input) {
     return;
   }
 
+  if (dropDuplicates_) {
+    addDistinctInput();
+    recordMemoryComponents();
+    return;
+  }
+
   if (analyzeKeys_ && hashes_.size() < activeRows_.end()) {
     hashes_.resize(activeRows_.end());
   }
@@ -358,6 +416,52 @@ void HashBuild::addInput(RowVectorPtr input) {
       rows->store(*decoders_[i], rowIndex, newRow, i + hashers.size());
     }
   });
+  recordMemoryComponents();
+}
+
+void HashBuild::addDistinctInput() {
+  auto& hashers = table_->hashers();
+  lookup_->reset(activeRows_.end());
+  const auto mode = table_->hashMode();
+  bool rehash = false;
+  for (auto i = 0; i < hashers.size(); ++i) {
+    if (mode != BaseHashTable::HashMode::kHash) {
+      if (!hashers[i]->computeValueIds(activeRows_, lookup_->hashes)) {
+        rehash = true;
+      }
+    } else {
+      hashers[i]->hash(activeRows_, i > 0, lookup_->hashes);
+    }
+  }
+
+  if (rehash) {
+    if (table_->hashMode() != BaseHashTable::HashMode::kHash) {
+      table_->decideHashMode(activeRows_.end());
+    }
+    addDistinctInput();
+    return;
+  }
+
+  lookup_->rows.clear();
+  activeRows_.applyToSelected([&](auto row) { lookup_->rows.push_back(row); });
+  table_->groupProbe(*lookup_);
+
+  auto* rows = table_->rows();
+  for (auto row : lookup_->newGroups) {
+    char* newRow = lookup_->hits[row];
+    for (auto i = 0; i < dependentChannels_.size(); ++i) {
+      rows->store(*decoders_[i], row, newRow, i + hashers.size());
+    }
+  }
+}
+
+void HashBuild::recordMemoryComponents() {
+  const auto* rows = table_->rows();
+  const int64_t stringBytes = rows->stringAllocator().retainedSize();
+  const int64_t rowBytes = rows->allocatedBytes();
+  setMemoryComponent("hashTable", table_->allocatedBytes() - rowBytes);
+  setMemoryComponent("rows", rowBytes - stringBytes);
+  setMemoryComponent("strings", stringBytes);
 }
 
 bool HashBuild::ensureInputFits(RowVectorPtr& input) {
@@ -372,6 +476,10 @@ bool HashBuild::ensureInputFits(RowVectorPtr& input) {
   // in the operator's memory pool, and won't make any new reservation if there
   // is already sufficient reservations.
   if (!reserveMemory(input)) {
+    if (state_ == State::kWaitForMemory) {
+      input_ = std::move(input);
+      return false;
+    }
     if (!requestSpill(input)) {
       return false;
     }
@@ -438,8 +546,15 @@ bool HashBuild::reserveMemory(const RowVectorPtr& input) {
       increment * 2,
       tracker->currentBytes() * spillConfig()->spillableReservationGrowthPct /
           100);
-  if (tracker->maybeReserve(targetIncrement)) {
-    return true;
+  switch (reserveMemoryAsync(targetIncrement, future_)) {
+    case ReservationResult::kReserved:
+      return true;
+    case ReservationResult::kPending:
+      VELOX_CHECK(future_.valid());
+      setState(State::kWaitForMemory);
+      return false;
+    case ReservationResult::kFailed:
+      break;
   }
   numSpillRows_ = std::max<int64_t>(
       1, targetIncrement / (rows->fixedRowSize() + outOfLineBytesPerRow));
@@ -639,6 +754,40 @@ void HashBuild::runSpill(const std::vector<Operator*>& spillOperators) {
   }
 }
 
+bool HashBuild::canReclaim() const {
+  // The spill group runs the spill on all the build operators together, so
+  // spill is only possible if all of them are still receiving the build input.
+  if (!spillEnabled() || state_ != State::kRunning || noMoreInput_ ||
+      spiller_ == nullptr || spiller_->state().isAllPartitionSpilled() ||
+      isInputFromSpill() || spillGroup_->needSpill() ||
+      spillGroup_->state() != SpillOperatorGroup::State::kRunning) {
+    return false;
+  }
+  for (auto* op : spillGroup_->operators()) {
+    auto* build = dynamic_cast<HashBuild*>(op);
+    VELOX_CHECK_NOT_NULL(build);
+    if (build->state_ != State::kRunning || build->noMoreInput_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HashBuild::reclaim(uint64_t targetBytes) {
+  VELOX_CHECK(canReclaim());
+  auto rows = table_->rows();
+  if (rows->numRows() == 0) {
+    return;
+  }
+  numSpillRows_ = rows->numRows();
+  numSpillBytes_ = std::max<uint64_t>(1, targetBytes);
+  const auto operators = spillGroup_->operators();
+  runSpill(operators);
+  for (auto* op : operators) {
+    op->pool()->getMemoryUsageTracker()->release();
+  }
+}
+
 void HashBuild::addAndClearSpillTarget(uint64_t& numRows, uint64_t& numBytes) {
   numRows += numSpillRows_;
   numSpillRows_ = 0;
@@ -672,6 +821,12 @@ void HashBuild::noMoreInputInternal() {
 bool HashBuild::finishHashBuild() {
   checkRunning();
 
+  // The table outlives this operator, so its hashers must not keep the input
+  // vectors alive.
+  for (auto& hasher : table_->hashers()) {
+    hasher->releaseCachedBase();
+  }
+
   std::vector<ContinuePromise> promises;
   std::vector<std::shared_ptr<Driver>> peers;
   // The last Driver to hit HashBuild::finish gathers the data from
@@ -685,8 +840,19 @@ bool HashBuild::finishHashBuild() {
     return false;
   }
 
+  if (sharedBuild_ != nullptr && !isSharedBuilder_) {
+    peers.clear();
+    for (auto& promise : promises) {
+      promise.setValue();
+    }
+    return finishSharedHashBuild();
+  }
+
   std::vector<std::unique_ptr<BaseHashTable>> otherTables;
   otherTables.reserve(peers.size());
+  // The memory pools of the peer tables merged into 'table_' when sharing the
+  // build with the other tasks.
+  std::vector<std::shared_ptr<memory::MemoryPool>> tablePools;
   SpillPartitionSet spillPartitions;
   Spiller::Stats spillStats;
   if (joinHasNullKeys_ && (isAntiJoin(joinType_) && nullAware_)) {
@@ -703,8 +869,11 @@ bool HashBuild::finishHashBuild() {
         }
       }
       otherTables.push_back(std::move(build->table_));
+      if (sharedBuild_ != nullptr) {
+        tablePools.push_back(build->pool()->shared_from_this());
+      }
+      spillStats += build->spillerStats();
       if (build->spiller_ != nullptr) {
-        spillStats += build->spiller_->stats();
         build->spiller_->finishSpill(spillPartitions);
       }
     }
@@ -712,17 +881,36 @@ bool HashBuild::finishHashBuild() {
     if (joinHasNullKeys_ && (isAntiJoin(joinType_) && nullAware_)) {
       joinBridge_->setAntiJoinHasNullKeys();
     } else {
-      if (spiller_ != nullptr) {
-        spillStats += spiller_->stats();
-
-        {
-          auto lockedStats = stats_.wlock();
-          lockedStats->spilledBytes += spillStats.spilledBytes;
-          lockedStats->spilledRows += spillStats.spilledRows;
-          lockedStats->spilledPartitions += spillStats.spilledPartitions;
-          lockedStats->spilledFiles += spillStats.spilledFiles;
+      spillStats += spillerStats();
+      {
+        auto lockedStats = stats_.wlock();
+        lockedStats->spilledBytes += spillStats.spilledBytes;
+        lockedStats->spilledRows += spillStats.spilledRows;
+        lockedStats->spilledPartitions += spillStats.spilledPartitions;
+        lockedStats->spilledFiles += spillStats.spilledFiles;
+        if (spillStats.numMaxSpillLevelExceeded != 0) {
+          lockedStats->addRuntimeStat(
+              "exceededMaxSpillLevel",
+              RuntimeCounter(spillStats.numMaxSpillLevelExceeded));
+        }
+        // The build of each restored spill partition adds its own timings.
+        // The spilled rows of a hash join are not sorted.
+        if (spillStats.spillSerializationNanos != 0) {
+          lockedStats->addRuntimeStat(
+              "spillSerializationNanos",
+              RuntimeCounter(
+                  spillStats.spillSerializationNanos,
+                  RuntimeCounter::Unit::kNanos));
+        }
+        if (spillStats.spillWriteNanos != 0) {
+          lockedStats->addRuntimeStat(
+              "spillWriteNanos",
+              RuntimeCounter(
+                  spillStats.spillWriteNanos, RuntimeCounter::Unit::kNanos));
         }
+      }
 
+      if (spiller_ != nullptr) {
         spiller_->finishSpill(spillPartitions);
 
         // Verify all the spilled partitions are not empty as we won't spill on
@@ -741,9 +929,16 @@ bool HashBuild::finishHashBuild() {
           allowPrallelJoinBuild ? operatorCtx_->task()->queryCtx()->executor()
                                 : nullptr);
 
+      maybeSetupBloomFilter();
       addRuntimeStats();
+      recordMemoryComponents();
+      std::shared_ptr<BaseHashTable> table = std::move(table_);
+      if (sharedBuild_ != nullptr) {
+        tablePools.push_back(pool()->shared_from_this());
+        sharedBuild_->setTable(table, joinHasNullKeys_, std::move(tablePools));
+      }
       if (joinBridge_->setHashTable(
-              std::move(table_),
+              std::move(table),
               std::move(spillPartitions),
               joinHasNullKeys_)) {
         spillGroup_->restart();
@@ -760,6 +955,22 @@ bool HashBuild::finishHashBuild() {
   return true;
 }
 
+bool HashBuild::finishSharedHashBuild() {
+  checkRunning();
+  VELOX_CHECK(sharedBuild_ != nullptr && !isSharedBuilder_);
+
+  auto buildResult = sharedBuild_->tableOrFuture(&future_);
+  if (!buildResult.has_value()) {
+    VELOX_CHECK(future_.valid());
+    setState(State::kWaitForSharedBuild);
+    return false;
+  }
+  joinBridge_->setHashTable(
+      std::move(buildResult->table), {}, buildResult->hasNullKeys);
+  stats_.wlock()->addRuntimeStat("sharedHashTable", RuntimeCounter(1));
+  return true;
+}
+
 void HashBuild::postHashBuildProcess() {
   checkRunning();
 
@@ -791,6 +1002,7 @@ void HashBuild::setupSpillInput(HashJoinBridge::SpillInput spillInput) {
 
   table_.reset();
   spiller_.reset();
+  exceededMaxSpillLevelLimit_ = false;
   spillInputReader_.reset();
 
   // Reset the key and dependent channels as the spilled data columns have
@@ -820,6 +1032,45 @@ void HashBuild::processSpillInput() {
   noMoreInputInternal();
 }
 
+void HashBuild::maybeSetupBloomFilter() {
+  // The probe side can only drop the rows without a match for these join
+  // types. The keys are pushed down as ranges or value sets if the table is
+  // not in kHash mode.
+  if (!(isInnerJoin(joinType_) || isRightJoin(joinType_) ||
+        isLeftSemiFilterJoin(joinType_) || isRightSemiFilterJoin(joinType_) ||
+        isRightSemiProjectJoin(joinType_)) ||
+      table_->hashMode() != BaseHashTable::HashMode::kHash) {
+    return;
+  }
+  const auto numRows = table_->numDistinct();
+  if (numRows == 0 || numRows > maxBloomFilterEntries_ ||
+      numRows > std::numeric_limits<int32_t>::max()) {
+    return;
+  }
+
+  auto bloomFilter = std::make_shared<BloomFilter<>>();
+  bloomFilter->reset(numRows);
+  constexpr int32_t kBatch = 1024;
+  raw_vector<char*> rows(kBatch);
+  raw_vector<uint64_t> hashes(kBatch);
+  const auto numKeys = table_->hashers().size();
+  BaseHashTable::RowsIterator iter;
+  while (auto numListed = table_->listAllRows(
+             &iter, kBatch, RowContainer::kUnlimited, rows.data())) {
+    // Hashes the keys the same way as HashProbe does in kHash mode.
+    for (auto i = 0; i < numKeys; ++i) {
+      table_->rows()->hash(
+          i, folly::Range(rows.data(), numListed), i > 0, hashes.data());
+    }
+    for (auto i = 0; i < numListed; ++i) {
+      bloomFilter->insert(hashes[i]);
+    }
+  }
+  table_->setJoinKeyBloomFilter(std::move(bloomFilter));
+  stats_.wlock()->addRuntimeStat(
+      "bloomFilterEntries", RuntimeCounter(numRows));
+}
+
 void HashBuild::addRuntimeStats() {
   // Report range sizes and number of distinct values for the join keys.
   const auto& hashers = table_->hashers();
@@ -854,12 +1105,25 @@ void HashBuild::addRuntimeStats() {
   // Add max spilling level stats if spilling has been triggered.
   if (spiller_ != nullptr && spiller_->isAnySpilled()) {
     lockedStats->addRuntimeStat(
-        "maxSpillLevel",
-        RuntimeCounter(
-            spillConfig()->spillLevel(spiller_->hashBits().begin())));
+        "maxSpillLevel", RuntimeCounter(spillerStats().maxSpillLevel));
   }
 }
 
+Spiller::Stats HashBuild::spillerStats() const {
+  Spiller::Stats stats;
+  if (spiller_ != nullptr) {
+    stats = spiller_->stats();
+    if (spiller_->isAnySpilled()) {
+      stats.maxSpillLevel =
+          spillConfig()->spillLevel(spiller_->hashBits().begin());
+    }
+  }
+  if (exceededMaxSpillLevelLimit_) {
+    stats.numMaxSpillLevelExceeded = 1;
+  }
+  return stats;
+}
+
 BlockingReason HashBuild::isBlocked(ContinueFuture* future) {
   switch (state_) {
     case State::kRunning:
@@ -870,6 +1134,8 @@ BlockingReason HashBuild::isBlocked(ContinueFuture* future) {
     case State::kFinish:
       break;
     case State::kWaitForSpill:
+      FOLLY_FALLTHROUGH;
+    case State::kWaitForMemory:
       if (!future_.valid()) {
         setRunning();
         VELOX_CHECK_NOT_NULL(input_);
@@ -884,6 +1150,14 @@ BlockingReason HashBuild::isBlocked(ContinueFuture* future) {
         postHashBuildProcess();
       }
       break;
+    case State::kWaitForSharedBuild:
+      if (!future_.valid()) {
+        setRunning();
+        if (finishSharedHashBuild()) {
+          postHashBuildProcess();
+        }
+      }
+      break;
     default:
       VELOX_UNREACHABLE("Unexpected state: {}", stateName(state_));
       break;
@@ -921,15 +1195,22 @@ void HashBuild::checkStateTransition(State state) {
   switch (state) {
     case State::kRunning:
       if (!spillEnabled()) {
-        VELOX_CHECK_EQ(state_, State::kWaitForBuild);
+        VELOX_CHECK(
+            state_ == State::kWaitForBuild ||
+                state_ == State::kWaitForSharedBuild,
+            stateName(state_));
       } else {
         VELOX_CHECK_NE(state_, State::kFinish);
       }
       break;
     case State::kWaitForBuild:
       FOLLY_FALLTHROUGH;
+    case State::kWaitForSharedBuild:
+      FOLLY_FALLTHROUGH;
     case State::kWaitForSpill:
       FOLLY_FALLTHROUGH;
+    case State::kWaitForMemory:
+      FOLLY_FALLTHROUGH;
     case State::kWaitForProbe:
       FOLLY_FALLTHROUGH;
     case State::kFinish:
@@ -953,11 +1234,24 @@ std::string HashBuild::stateName(State state) {
       return "WAIT_FOR_PROBE";
     case State::kFinish:
       return "FINISH";
+    case State::kWaitForSharedBuild:
+      return "WAIT_FOR_SHARED_BUILD";
+    case State::kWaitForMemory:
+      return "WAIT_FOR_MEMORY";
     default:
       return fmt::format("UNKNOWN: {}", static_cast<int>(state));
   }
 }
 
+void HashBuild::close() {
+  if (isSharedBuilder_) {
+    // Fails the other tasks waiting for the table if this task fails to build
+    // it.
+    sharedBuild_->abandon();
+  }
+  Operator::close();
+}
+
 bool HashBuild::testingTriggerSpill() {
   // Test-only spill path.
   if (spillConfig()->testSpillPct == 0) {
@@ -53,6 +53,13 @@ class HashBuild final : public Operator {
     kWaitForProbe = 4,
     /// The finishing state.
     kFinish = 5,
+    /// The state that waits for another task of the same query to build the
+    /// shared hash table. This state only applies if the hash join build
+    /// sharing is enabled.
+    kWaitForSharedBuild = 6,
+    /// The state that waits for a memory reservation to complete off the
+    /// driver thread. This state only applies if disk spilling is enabled.
+    kWaitForMemory = 7,
   };
   static std::string stateName(State state);
 
@@ -77,6 +84,12 @@ class HashBuild final : public Operator {
 
   bool isFinished() override;
 
+  bool canReclaim() const override;
+
+  void reclaim(uint64_t targetBytes) override;
+
+  void close() override;
+
  private:
   void setState(State state);
   void checkStateTransition(State state);
@@ -104,6 +117,16 @@ class HashBuild final : public Operator {
   // process which will be set by the join probe side.
   void postHashBuildProcess();
 
+  // Returns true if the hash table built by this operator can be shared with
+  // the other tasks of the same query.
+  bool canShareBuild() const;
+
+  // Invoked by a task which is not the builder of the shared hash table to
+  // hand over the shared table to 'joinBridge_'. The function returns false
+  // if the shared table is not built yet, and the operator transitions to
+  // 'kWaitForSharedBuild' state to wait for it.
+  bool finishSharedHashBuild();
+
   bool spillEnabled() const {
     return spillConfig_.has_value();
   }
@@ -142,11 +165,14 @@ class HashBuild final : public Operator {
   // also requested group spill and this driver is the last one to reach the
   // group spill barrier. Otherwise, the function returns false to wait for the
   // group spill to run. The operator will transition to 'kWaitForSpill' state
-  // accordingly.
+  // accordingly. If the memory reservation waits for the memory arbitration,
+  // the function returns false in 'kWaitForMemory' state instead.
   bool ensureInputFits(RowVectorPtr& input);
 
   // Invoked to reserve memory for 'input' if disk spilling is enabled. The
-  // function returns true on success, otherwise false.
+  // function returns true on success, otherwise false. If the reservation
+  // needs to grow the query memory capacity, it is made off the driver thread
+  // and the operator transitions to 'kWaitForMemory' state with 'future_' set.
   bool reserveMemory(const RowVectorPtr& input);
 
   // Invoked to compute spill partitions numbers for each row 'input' and spill
@@ -208,6 +234,9 @@ class HashBuild final : public Operator {
   // Invoked to process data from spill input reader on restoring.
   void processSpillInput();
 
+  // Returns the stats of 'spiller_' with the spill level stats set.
+  Spiller::Stats spillerStats() const;
+
   // Set up for null-aware and regular anti-join with filter processing.
   void setupFilterForAntiJoins(
       const folly::F14FastMap<column_index_t, column_index_t>& keyChannelMap);
@@ -220,8 +249,22 @@ class HashBuild final : public Operator {
   // will be added to the joined output.
   void removeInputRowsForAntiJoinFilter();
 
+  // Inserts the rows of 'activeRows_' with keys not yet in 'table_' into
+  // 'table_' and stores their dependent columns. Rows with already seen keys
+  // are not stored. Used if 'dropDuplicates_' is set.
+  void addDistinctInput();
+
+  // Makes a Bloom filter over the key hashes of the built table if the keys
+  // can't be pushed down to the probe side as ranges or value sets. HashProbe
+  // uses it as a dynamic filter to drop probe rows without a match early.
+  void maybeSetupBloomFilter();
+
   void addRuntimeStats();
 
+  // Records the memory of the hash table, the rows and the out of line data of
+  // 'table_' as the memory components of 'this'.
+  void recordMemoryComponents();
+
   // Invoked to check if it needs to trigger spilling for test purpose only.
   bool testingTriggerSpill();
 
@@ -229,6 +272,9 @@ class HashBuild final : public Operator {
 
   const core::JoinType joinType_;
 
+  // The maximum number of distinct keys to make a Bloom filter for.
+  const uint64_t maxBloomFilterEntries_;
+
   const bool nullAware_;
 
   const std::shared_ptr<HashJoinBridge> joinBridge_;
@@ -237,6 +283,14 @@ class HashBuild final : public Operator {
 
   const std::shared_ptr<SpillOperatorGroup> spillGroup_;
 
+  // The hash table build shared with the other tasks of the same query. Null
+  // if the build is not shared.
+  std::shared_ptr<SharedHashJoinBuild> sharedBuild_;
+
+  // True if this task builds the shared hash table for the other tasks. The
+  // operators of the other tasks discard their input.
+  bool isSharedBuilder_{false};
+
   State state_{State::kRunning};
 
   // The row type used for hash table build and disk spilling.
@@ -265,6 +319,15 @@ class HashBuild final : public Operator {
   // Temporary space for hash numbers.
   raw_vector<uint64_t> hashes_;
 
+  // True if only the first build row of each key needs to be kept, i.e. for
+  // left semi and anti joins without filter. The input is then inserted into
+  // 'table_' as it arrives so that rows with duplicate keys are never stored.
+  // Not set if spilling is enabled since spilling moves rows out of 'table_'.
+  bool dropDuplicates_{false};
+
+  // Lookup for inserting the input into 'table_' if 'dropDuplicates_' is set.
+  std::unique_ptr<HashLookup> lookup_;
+
   // Set of active rows during addInput().
   SelectivityVector activeRows_;
 
@@ -282,6 +345,10 @@ class HashBuild final : public Operator {
 
   std::unique_ptr<Spiller> spiller_;
 
+  // Set if the restored spill partition can't be spilled again as that would
+  // exceed the max spill level. 'spiller_' is not set in this case.
+  bool exceededMaxSpillLevelLimit_{false};
+
   // Used to read input from previously spilled data for restoring.
   std::unique_ptr<UnorderedStreamReader<BatchStream>> spillInputReader_;
 
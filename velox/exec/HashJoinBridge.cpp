@@ -16,7 +16,25 @@
 
 #include "velox/exec/HashJoinBridge.h"
 
+#include <map>
+
 namespace facebook::velox::exec {
+namespace {
+using SharedBuildKey =
+    std::tuple<const core::QueryCtx*, uint32_t, core::PlanNodeId>;
+
+// The hash join builds shared among the tasks of the queries running in this
+// process. The entries are owned by the hash join bridges of the tasks.
+struct SharedBuildRegistry {
+  std::mutex mutex;
+  std::map<SharedBuildKey, std::weak_ptr<SharedHashJoinBuild>> builds;
+};
+
+SharedBuildRegistry& sharedBuildRegistry() {
+  static SharedBuildRegistry registry;
+  return registry;
+}
+} // namespace
 
 void HashJoinBridge::start() {
   std::lock_guard<std::mutex> l(mutex_);
@@ -31,7 +49,7 @@ void HashJoinBridge::addBuilder() {
 }
 
 bool HashJoinBridge::setHashTable(
-    std::unique_ptr<BaseHashTable> table,
+    std::shared_ptr<BaseHashTable> table,
     SpillPartitionSet spillPartitionSet,
     bool hasNullKeys) {
   VELOX_CHECK_NOT_NULL(table, "setHashTable called with null table");
@@ -90,6 +108,13 @@ void HashJoinBridge::setAntiJoinHasNullKeys() {
   notify(std::move(promises));
 }
 
+void HashJoinBridge::setSharedBuild(
+    std::shared_ptr<SharedHashJoinBuild> sharedBuild) {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(sharedBuild_ == nullptr || sharedBuild_ == sharedBuild);
+  sharedBuild_ = std::move(sharedBuild);
+}
+
 std::optional<HashJoinBridge::HashBuildResult> HashJoinBridge::tableOrFuture(
     ContinueFuture* future) {
   std::lock_guard<std::mutex> l(mutex_);
@@ -164,6 +189,96 @@ std::optional<HashJoinBridge::SpillInput> HashJoinBridge::spillInputOrFuture(
   return SpillInput(std::move(spillShard));
 }
 
+std::shared_ptr<SharedHashJoinBuild> SharedHashJoinBuild::getOrCreate(
+    const std::shared_ptr<core::QueryCtx>& queryCtx,
+    uint32_t splitGroupId,
+    const core::PlanNodeId& planNodeId) {
+  auto& registry = sharedBuildRegistry();
+  std::lock_guard<std::mutex> l(registry.mutex);
+  // Purge the builds of the finished queries.
+  for (auto it = registry.builds.begin(); it != registry.builds.end();) {
+    if (it->second.expired()) {
+      it = registry.builds.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  auto& entry =
+      registry.builds[SharedBuildKey{queryCtx.get(), splitGroupId, planNodeId}];
+  auto build = entry.lock();
+  if (build == nullptr) {
+    build = std::make_shared<SharedHashJoinBuild>();
+    entry = build;
+  }
+  return build;
+}
+
+bool SharedHashJoinBuild::tryBecomeBuilder(const std::string& taskId) {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (builderTaskId_.empty()) {
+    builderTaskId_ = taskId;
+  }
+  return builderTaskId_ == taskId;
+}
+
+void SharedHashJoinBuild::setTable(
+    std::shared_ptr<BaseHashTable> table,
+    bool hasNullKeys,
+    std::vector<std::shared_ptr<memory::MemoryPool>> pools) {
+  VELOX_CHECK_NOT_NULL(table);
+  auto tableHolder = std::make_shared<TableHolder>();
+  tableHolder->pools = std::move(pools);
+  tableHolder->table = std::move(table);
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK_NULL(tableHolder_);
+    VELOX_CHECK(!abandoned_);
+    tableHolder_ = std::move(tableHolder);
+    hasNullKeys_ = hasNullKeys;
+    promises = std::move(promises_);
+  }
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
+void SharedHashJoinBuild::abandon() {
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (tableHolder_ != nullptr || abandoned_) {
+      return;
+    }
+    abandoned_ = true;
+    promises = std::move(promises_);
+  }
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
+std::optional<HashJoinBridge::HashBuildResult>
+SharedHashJoinBuild::tableOrFuture(ContinueFuture* future) {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (abandoned_) {
+    VELOX_FAIL(
+        "The shared hash join build of task {} has failed", builderTaskId_);
+  }
+  if (tableHolder_ != nullptr) {
+    // The returned table shares the ownership of the memory pools.
+    return HashJoinBridge::HashBuildResult(
+        std::shared_ptr<BaseHashTable>(
+            tableHolder_, tableHolder_->table.get()),
+        std::nullopt,
+        {},
+        hasNullKeys_);
+  }
+  promises_.emplace_back("SharedHashJoinBuild::tableOrFuture");
+  *future = promises_.back().getSemiFuture();
+  return std::nullopt;
+}
+
 bool isLeftNullAwareJoinWithFilter(
     const std::shared_ptr<const core::HashJoinNode>& joinNode) {
   return (joinNode->isAntiJoin() || joinNode->isLeftSemiProjectJoin() ||
@@ -15,12 +15,16 @@
  */
 #pragma once
 
+#include "velox/core/PlanNode.h"
+#include "velox/core/QueryCtx.h"
 #include "velox/exec/HashTable.h"
 #include "velox/exec/JoinBridge.h"
 #include "velox/exec/Spill.h"
 
 namespace facebook::velox::exec {
 
+class SharedHashJoinBuild;
+
 /// Hands over a hash table from a multi-threaded build pipeline to a
 /// multi-threaded probe pipeline. This is owned by shared_ptr by all the build
 /// and probe Operator instances concerned. Corresponds to the Presto concept of
@@ -39,12 +43,30 @@ class HashJoinBridge : public JoinBridge {
   /// after HashProbe operators process 'table', otherwise false. This only
   /// applies if the disk spilling is enabled.
   bool setHashTable(
-      std::unique_ptr<BaseHashTable> table,
+      std::shared_ptr<BaseHashTable> table,
       SpillPartitionSet spillPartitionSet,
       bool hasNullKeys);
 
   void setAntiJoinHasNullKeys();
 
+  /// Invoked by a HashBuild operator of a null-aware anti join without a
+  /// filter when it sees a null join key. Such a join returns no rows, so the
+  /// other HashBuild operators can stop processing input as soon as one of
+  /// them has seen a null key. May be called by any of the HashBuild
+  /// operators before the table is built.
+  void setBuildSideHasNullKeys() {
+    buildSideHasNullKeys_ = true;
+  }
+
+  /// Returns true if setBuildSideHasNullKeys() has been called.
+  bool buildSideHasNullKeys() const {
+    return buildSideHasNullKeys_;
+  }
+
+  /// Invoked by HashBuild operator ctor to keep the hash table build shared
+  /// with the other tasks of the same query alive as long as this bridge.
+  void setSharedBuild(std::shared_ptr<SharedHashJoinBuild> sharedBuild);
+
   /// Represents the result of HashBuild operators: a hash table, an optional
   /// restored spill partition id associated with the table, and the spilled
   /// partitions while building the table if not empty. In case of an anti join,
@@ -107,8 +129,14 @@ class HashJoinBridge : public JoinBridge {
  private:
   uint32_t numBuilders_{0};
 
+  std::shared_ptr<SharedHashJoinBuild> sharedBuild_;
+
   std::optional<HashBuildResult> buildResult_;
 
+  // Set without holding 'mutex_' by the HashBuild operators of a null-aware
+  // anti join, see setBuildSideHasNullKeys().
+  std::atomic_bool buildSideHasNullKeys_{false};
+
   // restoringSpillPartitionXxx member variables are populated by the
   // bridge itself. When probe side finished processing, the bridge picks the
   // first partition from 'spillPartitionSets_', splits it into "even" shards
@@ -130,6 +158,68 @@ class HashJoinBridge : public JoinBridge {
   SpillPartitionSet spillPartitionSets_;
 };
 
+/// Shares the hash table of a hash join build among the tasks of a query
+/// running on the same worker. The HashBuild operators of the first task to
+/// create the build are the builders and hand over the built table to the
+/// HashBuild operators of the other tasks, which discard their own build side
+/// input. This is used if the build side input is the same for all the tasks,
+/// e.g. for a broadcast join, and the probe side doesn't modify the table.
+class SharedHashJoinBuild {
+ public:
+  /// Returns the build shared by the tasks of 'queryCtx' for plan node
+  /// 'planNodeId' and split group 'splitGroupId'. A new build is created if
+  /// there is none or if all the tasks holding the previous one are gone.
+  static std::shared_ptr<SharedHashJoinBuild> getOrCreate(
+      const std::shared_ptr<core::QueryCtx>& queryCtx,
+      uint32_t splitGroupId,
+      const core::PlanNodeId& planNodeId);
+
+  /// Returns true if the task 'taskId' builds the table for the other tasks.
+  /// The first task to call this becomes the builder.
+  bool tryBecomeBuilder(const std::string& taskId);
+
+  /// Invoked by the builder task to hand over the built 'table'. 'pools' are
+  /// the memory pools of 'table' which are kept alive for as long as the
+  /// other tasks use 'table'.
+  void setTable(
+      std::shared_ptr<BaseHashTable> table,
+      bool hasNullKeys,
+      std::vector<std::shared_ptr<memory::MemoryPool>> pools);
+
+  /// Invoked by the builder task on close. If the table has not been set,
+  /// the waiting tasks fail since nobody else builds the table.
+  void abandon();
+
+  /// Invoked by the HashBuild operators of the other tasks to get the table
+  /// built by the builder task. If the table is not built yet, 'future' is set
+  /// to wait for it. Throws if the builder task has failed.
+  std::optional<HashJoinBridge::HashBuildResult> tableOrFuture(
+      ContinueFuture* FOLLY_NONNULL future);
+
+ private:
+  // Keeps the memory pools of 'table' alive. 'table' is declared last to be
+  // destroyed before the pools.
+  struct TableHolder {
+    std::vector<std::shared_ptr<memory::MemoryPool>> pools;
+    std::shared_ptr<BaseHashTable> table;
+  };
+
+  std::mutex mutex_;
+
+  // The task which builds the table. Empty until the first call to
+  // tryBecomeBuilder().
+  std::string builderTaskId_;
+
+  std::shared_ptr<TableHolder> tableHolder_;
+
+  bool hasNullKeys_{false};
+
+  // Set if the builder task is closed without setting the table.
+  bool abandoned_{false};
+
+  std::vector<ContinuePromise> promises_;
+};
+
 // Indicates if 'joinNode' is null-aware anti or left semi project join type and
 // has filter set.
 bool isLeftNullAwareJoinWithFilter(
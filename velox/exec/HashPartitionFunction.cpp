@@ -21,8 +21,11 @@ HashPartitionFunction::HashPartitionFunction(
     int numPartitions,
     const RowTypePtr& inputType,
     const std::vector<column_index_t>& keyChannels,
-    const std::vector<VectorPtr>& constValues)
-    : numPartitions_{numPartitions} {
+    const std::vector<VectorPtr>& constValues,
+    bool spreadHeavyHitters)
+    : numPartitions_{numPartitions},
+      modulo_(numPartitions),
+      spreadHeavyHitters_{spreadHeavyHitters} {
   init(inputType, keyChannels, constValues);
 }
 
@@ -30,9 +33,12 @@ HashPartitionFunction::HashPartitionFunction(
     const HashBitRange& hashBitRange,
     const RowTypePtr& inputType,
     const std::vector<column_index_t>& keyChannels,
-    const std::vector<VectorPtr>& constValues)
+    const std::vector<VectorPtr>& constValues,
+    bool spreadHeavyHitters)
     : numPartitions_{hashBitRange.numPartitions()},
-      hashBitRange_(hashBitRange) {
+      modulo_(numPartitions_),
+      hashBitRange_(hashBitRange),
+      spreadHeavyHitters_{spreadHeavyHitters} {
   init(inputType, keyChannels, constValues);
 }
 
@@ -80,8 +86,41 @@ void HashPartitionFunction::partition(
     }
   } else {
     for (auto i = 0; i < size; ++i) {
-      partitions[i] = hashes_[i] % numPartitions_;
+      partitions[i] = modulo_(hashes_[i]);
     }
   }
+
+  if (!spreadHeavyHitters_) {
+    return;
+  }
+  if (numSampledRows_ < kNumSampleRows) {
+    sampleHeavyHitters(size);
+  }
+  if (!heavyHitters_.empty()) {
+    for (auto i = 0; i < size; ++i) {
+      if (heavyHitters_.count(hashes_[i])) {
+        partitions[i] = nextHeavyHitterPartition_;
+        nextHeavyHitterPartition_ =
+            (nextHeavyHitterPartition_ + 1) % numPartitions_;
+      }
+    }
+  }
+}
+
+void HashPartitionFunction::sampleHeavyHitters(vector_size_t size) {
+  const auto numRows = std::min(size, kNumSampleRows - numSampledRows_);
+  for (auto i = 0; i < numRows; ++i) {
+    ++sampledHashes_[hashes_[i]];
+  }
+  numSampledRows_ += numRows;
+  if (numSampledRows_ < kNumSampleRows) {
+    return;
+  }
+  for (const auto& [hash, count] : sampledHashes_) {
+    if (count * kHeavyHitterFactor * numPartitions_ > numSampledRows_) {
+      heavyHitters_.insert(hash);
+    }
+  }
+  sampledHashes_ = {};
 }
 } // namespace facebook::velox::exec
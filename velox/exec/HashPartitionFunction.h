@@ -15,25 +15,71 @@
  */
 #pragma once
 
+#include <folly/container/F14Map.h>
+#include <folly/container/F14Set.h>
 #include <velox/exec/HashBitRange.h>
 #include <velox/exec/VectorHasher.h>
 #include "velox/core/PlanNode.h"
 
 namespace facebook::velox::exec {
 
+/// Computes 'x % divisor' for a 64 bit 'x' and a fixed 32 bit divisor with
+/// multiplications instead of a division. The result is the same as with
+/// '%'. See Lemire, Kaser and Kurz, "Faster Remainder by Direct Computation".
+class FastModulo {
+ public:
+  explicit FastModulo(uint32_t divisor)
+      : divisor_{divisor},
+        multiplier_{~static_cast<__uint128_t>(0) / divisor + 1} {}
+
+  uint32_t operator()(uint64_t x) const {
+    // The remainder is the high 128 bits of (multiplier_ * x mod 2^128) *
+    // divisor_, computed from the two 64 bit halves of the product.
+    const __uint128_t fraction = multiplier_ * x;
+    const auto high = static_cast<__uint128_t>(static_cast<uint64_t>(
+                          fraction >> 64)) *
+        divisor_;
+    const auto low =
+        (static_cast<__uint128_t>(static_cast<uint64_t>(fraction)) *
+         divisor_) >>
+        64;
+    return static_cast<uint32_t>((high + low) >> 64);
+  }
+
+ private:
+  const uint64_t divisor_;
+  const __uint128_t multiplier_;
+};
+
 class HashPartitionFunction : public core::PartitionFunction {
  public:
+  /// The number of input rows sampled to detect heavy hitter keys.
+  static constexpr int32_t kNumSampleRows = 4'096;
+
+  /// A key is a heavy hitter if it has more than 1 / (kHeavyHitterFactor *
+  /// numPartitions) of the sampled rows.
+  static constexpr int32_t kHeavyHitterFactor = 2;
+
+  /// If 'spreadHeavyHitters' is true, the function samples the key hashes of
+  /// the first kNumSampleRows rows and then assigns the rows of the heavy
+  /// hitter keys round-robin to all the partitions instead of sending them all
+  /// to the same partition. This is meant for the local exchange in front of a
+  /// hash join probe. All the probe drivers of a task share the same hash
+  /// table, so the rows of a key do not need to go to the same driver and the
+  /// skewed keys are probed by all the drivers in parallel.
   HashPartitionFunction(
       int numPartitions,
       const RowTypePtr& inputType,
       const std::vector<column_index_t>& keyChannels,
-      const std::vector<VectorPtr>& constValues = {});
+      const std::vector<VectorPtr>& constValues = {},
+      bool spreadHeavyHitters = false);
 
   HashPartitionFunction(
       const HashBitRange& hashBitRange,
       const RowTypePtr& inputType,
       const std::vector<column_index_t>& keyChannels,
-      const std::vector<VectorPtr>& constValues = {});
+      const std::vector<VectorPtr>& constValues = {},
+      bool spreadHeavyHitters = false);
 
   ~HashPartitionFunction() override = default;
 
@@ -44,16 +90,38 @@ class HashPartitionFunction : public core::PartitionFunction {
     return numPartitions_;
   }
 
+  /// Returns the number of heavy hitter keys found by sampling. This is 0
+  /// until kNumSampleRows rows have been partitioned.
+  int32_t numHeavyHitters() const {
+    return heavyHitters_.size();
+  }
+
  private:
   void init(
       const RowTypePtr& inputType,
       const std::vector<column_index_t>& keyChannels,
       const std::vector<VectorPtr>& constValues);
 
+  // Adds the first 'size' entries of 'hashes_' to the sample and sets
+  // 'heavyHitters_' once the sample is complete.
+  void sampleHeavyHitters(vector_size_t size);
+
   const int numPartitions_;
+  const FastModulo modulo_;
   const std::optional<HashBitRange> hashBitRange_ = std::nullopt;
+  const bool spreadHeavyHitters_;
   std::vector<std::unique_ptr<VectorHasher>> hashers_;
 
+  // The number of occurrences of each key hash in the sampled rows.
+  folly::F14FastMap<uint64_t, int32_t> sampledHashes_;
+  int32_t numSampledRows_{0};
+
+  // The hashes of the heavy hitter keys.
+  folly::F14FastSet<uint64_t> heavyHitters_;
+
+  // The partition of the next heavy hitter row.
+  uint32_t nextHeavyHitterPartition_{0};
+
   // Reusable memory.
   SelectivityVector rows_;
   raw_vector<uint64_t> hashes_;
@@ -263,7 +263,9 @@ void HashProbe::maybeSetupSpillInput(
       spillConfig.maxFileSize,
       spillConfig.minSpillRunSize,
       Spiller::spillPool(),
-      spillConfig.executor);
+      spillConfig.executor,
+      spillConfig.compressionKind,
+      spillConfig.writeCallback);
   // Set the spill partitions to the corresponding ones at the build side. The
   // hash probe operator itself won't trigger any spilling.
   spiller_->setPartitionsSpilled(toPartitionNumSet(spillInputPartitionIds_));
@@ -305,6 +307,9 @@ void HashProbe::asyncWaitForHashTable() {
 
   table_ = std::move(hashBuildResult->table);
   VELOX_CHECK_NOT_NULL(table_);
+  // The Bloom filter over the key hashes is only made for the join types
+  // which drop the probe rows without a match.
+  bloomFilter_ = table_->joinKeyBloomFilter();
 
   maybeSetupSpillInput(
       hashBuildResult->restoredPartitionId, hashBuildResult->spillPartitionIds);
@@ -318,8 +323,7 @@ void HashProbe::asyncWaitForHashTable() {
   } else if (
       (isInnerJoin(joinType_) || isLeftSemiFilterJoin(joinType_) ||
        isRightSemiFilterJoin(joinType_) || isRightSemiProjectJoin(joinType_)) &&
-      table_->hashMode() != BaseHashTable::HashMode::kHash && !isSpillInput() &&
-      !hasMoreSpillData()) {
+      !isSpillInput() && !hasMoreSpillData()) {
     // Find out whether there are any upstream operators that can accept
     // dynamic filters on all or a subset of the join keys. Create dynamic
     // filters to push down.
@@ -331,12 +335,28 @@ void HashProbe::asyncWaitForHashTable() {
     const auto& buildHashers = table_->hashers();
     auto channels = operatorCtx_->driverCtx()->driver->canPushdownFilters(
         this, keyChannels_);
-    for (auto i = 0; i < keyChannels_.size(); i++) {
-      if (channels.find(keyChannels_[i]) != channels.end()) {
-        if (auto filter = buildHashers[i]->getFilter(false)) {
-          dynamicFilters_.emplace(keyChannels_[i], std::move(filter));
+    if (table_->hashMode() != BaseHashTable::HashMode::kHash) {
+      for (auto i = 0; i < keyChannels_.size(); i++) {
+        if (channels.find(keyChannels_[i]) != channels.end()) {
+          if (auto filter = buildHashers[i]->getFilter(false)) {
+            dynamicFilters_.emplace(keyChannels_[i], std::move(filter));
+          }
         }
       }
+    } else if (
+        bloomFilter_ != nullptr && keyChannels_.size() == 1 &&
+        channels.find(keyChannels_[0]) != channels.end() &&
+        common::HashBloomFilter::isSupportedKind(
+            buildHashers[0]->typeKind())) {
+      // The hash of a single key is the hash of the key value, so the Bloom
+      // filter can be tested by the table scan while decoding. Multiple keys
+      // are tested against the Bloom filter on the hash of the combined key
+      // before probing.
+      dynamicFilters_.emplace(
+          keyChannels_[0],
+          std::make_shared<common::HashBloomFilter>(
+              bloomFilter_, buildHashers[0]->typeKind(), false));
+      bloomFilter_ = nullptr;
     }
   }
 }
@@ -495,9 +515,11 @@ void HashProbe::clearDynamicFilters() {
   // The join can be completely replaced with a pushed down
   // filter when the following conditions are met:
   //  * hash table has a single key with unique values,
-  //  * build side has no dependent columns.
+  //  * build side has no dependent columns,
+  //  * the pushed down filter is exact, i.e. not a Bloom filter.
   if (keyChannels_.size() == 1 && !table_->hasDuplicateKeys() &&
-      tableOutputProjections_.empty() && !filter_ && !dynamicFilters_.empty()) {
+      tableOutputProjections_.empty() && !filter_ && !dynamicFilters_.empty() &&
+      table_->hashMode() != BaseHashTable::HashMode::kHash) {
     canReplaceWithDynamicFilter_ = true;
   }
 
@@ -616,6 +638,9 @@ void HashProbe::addInput(RowVectorPtr input) {
     rows.resize(numInput);
     std::iota(rows.begin(), rows.end(), 0);
   } else {
+    if (bloomFilter_ != nullptr) {
+      applyBloomFilter();
+    }
     if (lookup_->rows.empty()) {
       input_ = nullptr;
       return;
@@ -626,6 +651,23 @@ void HashProbe::addInput(RowVectorPtr input) {
   results_.reset(*lookup_);
 }
 
+void HashProbe::applyBloomFilter() {
+  VELOX_CHECK_EQ(table_->hashMode(), BaseHashTable::HashMode::kHash);
+  auto& rows = lookup_->rows;
+  const auto& hashes = lookup_->hashes;
+  vector_size_t numPassed = 0;
+  for (auto row : rows) {
+    if (bloomFilter_->mayContain(hashes[row])) {
+      rows[numPassed++] = row;
+    }
+  }
+  if (numPassed < rows.size()) {
+    addRuntimeStat(
+        "bloomFilterDroppedRows", RuntimeCounter(rows.size() - numPassed));
+    rows.resize(numPassed);
+  }
+}
+
 void HashProbe::prepareOutput(vector_size_t size) {
   // Try to re-use memory for the output vectors that contain build-side data.
   // We expect output vectors containing probe-side data to be null (reset in
@@ -921,6 +963,16 @@ RowVectorPtr HashProbe::getOutput() {
           }
         }
       }
+    } else if (isLeftSemiFilterJoin(joinType_) && !filter_) {
+      // The build side has no duplicate keys, so the probe found at most one
+      // match per row and 'hits' has it. Return the probe rows with a match
+      // without listing the join results.
+      for (auto row : lookup_->rows) {
+        if (lookup_->hits[row]) {
+          mapping[numOut] = row;
+          ++numOut;
+        }
+      }
     } else {
       numOut = table_->listJoinResults(
           results_,
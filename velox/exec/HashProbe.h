@@ -58,6 +58,12 @@ class HashProbe : public Operator {
   };
   static std::string stateName(State state);
 
+  /// The probe rows are output in input order, each possibly repeated once per
+  /// match.
+  bool mayPassThroughLazyVectors() const override {
+    return true;
+  }
+
   bool needsInput() const override {
     if (state_ == State::kFinish || noMoreInput_ || noMoreSpillInput_ ||
         input_ != nullptr) {
@@ -135,6 +141,10 @@ class HashProbe : public Operator {
   // for right join and full join.
   RowVectorPtr getBuildSideOutput();
 
+  // Removes the rows from 'lookup_->rows' whose key hashes are not in
+  // 'bloomFilter_'. These rows have no match in the table.
+  void applyBloomFilter();
+
   // Applies 'filter_' to 'outputTableRows_' and updates 'outputRowMapping_'.
   // Returns the number of passing rows.
   vector_size_t evalFilter(vector_size_t numRows);
@@ -312,6 +322,11 @@ class HashProbe : public Operator {
   // same pipeline.
   std::shared_ptr<BaseHashTable> table_;
 
+  // Bloom filter over the key hashes of 'table_' to test the probe rows
+  // against before probing. Not set if the filter was pushed down to the
+  // table scan, or 'table_' has none.
+  std::shared_ptr<const BloomFilter<>> bloomFilter_;
+
   // Indicates whether there was no input. Used for right semi join project.
   bool noInput_{true};
 
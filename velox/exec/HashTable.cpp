@@ -53,7 +53,9 @@ HashTable<ignoreNullKeys>::HashTable(
     bool allowDuplicates,
     bool isJoinBuild,
     bool hasProbedFlag,
-    memory::MemoryPool* pool)
+    memory::MemoryPool* pool,
+    bool appendOnlyStrings,
+    bool compactLayout)
     : BaseHashTable(std::move(hashers)), isJoinBuild_(isJoinBuild) {
   std::vector<TypePtr> keys;
   for (auto& hasher : hashers_) {
@@ -72,7 +74,9 @@ HashTable<ignoreNullKeys>::HashTable(
       hasProbedFlag,
       hashMode_ != HashMode::kHash,
       pool,
-      ContainerRowSerde::instance());
+      ContainerRowSerde::instance(),
+      appendOnlyStrings,
+      compactLayout);
   nextOffset_ = rows_->nextOffset();
 }
 
@@ -100,6 +104,17 @@ class ProbeState {
     return row_;
   }
 
+  // Prefetches the tags and the row pointers that preProbe() and firstProbe()
+  // read for 'hash'.
+  static inline void
+  prefetch(uint8_t* tags, char** table, uint64_t sizeMask, uint64_t hash) {
+    const auto tagIndex = tagsByteOffset(hash, sizeMask);
+    __builtin_prefetch(tags + tagIndex);
+    // The row pointers for a tag vector span two cache lines.
+    __builtin_prefetch(table + tagIndex);
+    __builtin_prefetch(table + tagIndex + sizeof(BaseHashTable::TagVector) / 2);
+  }
+
   // Use one instruction to load 16 tags
   // Use another instruction to make 16 copies of the tag being searched for
   inline void
@@ -300,10 +315,18 @@ char* HashTable<ignoreNullKeys>::insertEntry(
     HashLookup& lookup,
     int32_t index,
     vector_size_t row) {
+  char* group = newGroup(lookup, row);
+  storeRowPointer(index, lookup.hashes[row], group);
+  return group;
+}
+
+template <bool ignoreNullKeys>
+char* HashTable<ignoreNullKeys>::newGroup(
+    HashLookup& lookup,
+    vector_size_t row) {
   char* group = rows_->newRow();
   lookup.hits[row] = group; // NOLINT
   storeKeys(lookup, row);
-  storeRowPointer(index, lookup.hashes[row], group);
   if (hashMode_ == HashMode::kNormalizedKey) {
     // We store the unique digest of key values (normalized key) in
     // the word below the row. Space was reserved in the allocation
@@ -388,6 +411,45 @@ FOLLY_ALWAYS_INLINE void HashTable<ignoreNullKeys>::fullProbe(
       !isJoin && extraCheck);
 }
 
+template <bool ignoreNullKeys>
+FOLLY_ALWAYS_INLINE void HashTable<ignoreNullKeys>::partitionedFullProbe(
+    HashLookup& lookup,
+    ProbeState& state,
+    GroupByPartition& partition) {
+  auto insert = [&](int32_t row, int32_t index) {
+    auto group = newGroup(lookup, row);
+    partition.tags[index] = hashTag(lookup.hashes[row]);
+    partition.table[index] = group;
+    ++partition.numDistinct;
+    return group;
+  };
+  if (hashMode_ == HashMode::kNormalizedKey) {
+    lookup.hits[state.row()] =
+        state.fullProbe<ProbeState::Operation::kInsert>(
+            partition.tags,
+            partition.table,
+            partition.sizeMask,
+            -static_cast<int32_t>(sizeof(normalized_key_t)),
+            [&](char* group, int32_t row) INLINE_LAMBDA {
+              return RowContainer::normalizedKey(group) ==
+                  lookup.normalizedKeys[row];
+            },
+            insert,
+            partition.numTombstones,
+            false);
+    return;
+  }
+  lookup.hits[state.row()] = state.fullProbe<ProbeState::Operation::kInsert>(
+      partition.tags,
+      partition.table,
+      partition.sizeMask,
+      0,
+      [&](char* group, int32_t row) { return compareKeys(group, lookup, row); },
+      insert,
+      partition.numTombstones,
+      false);
+}
+
 namespace {
 // Normalized keys have non0-random bits. Bits need to be propagated
 // up to make a tag byte and down so that non-lowest bits of
@@ -425,12 +487,18 @@ void HashTable<ignoreNullKeys>::groupProbe(HashLookup& lookup) {
     arrayGroupProbe(lookup);
     return;
   }
-  // Do size-based rehash before mixing hashes from normalized keys
-  // because the size of the table affects the mixing.
-  checkSize(lookup.rows.size());
+  if (groupByPartitions_.empty()) {
+    // Do size-based rehash before mixing hashes from normalized keys
+    // because the size of the table affects the mixing.
+    checkSize(lookup.rows.size());
+  }
   if (hashMode_ == HashMode::kNormalizedKey) {
     populateNormalizedKeys(lookup, sizeBits_);
   }
+  if (!groupByPartitions_.empty()) {
+    partitionedGroupProbe(lookup);
+    return;
+  }
   ProbeState state1;
   ProbeState state2;
   ProbeState state3;
@@ -464,6 +532,19 @@ void HashTable<ignoreNullKeys>::groupProbe(HashLookup& lookup) {
   }
 }
 
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::partitionedGroupProbe(HashLookup& lookup) {
+  checkGroupByPartitionSizes(lookup);
+  ProbeState state;
+  for (auto row : lookup.rows) {
+    const auto hash = lookup.hashes[row];
+    auto& partition = groupByPartitions_[groupByPartition(hash)];
+    state.preProbe(partition.tags, partition.sizeMask, hash, row);
+    state.firstProbe<ProbeState::Operation::kInsert>(partition.table, 0);
+    partitionedFullProbe(lookup, state, partition);
+  }
+}
+
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::arrayGroupProbe(HashLookup& lookup) {
   VELOX_DCHECK(!lookup.hashes.empty());
@@ -525,9 +606,27 @@ void HashTable<ignoreNullKeys>::joinProbe(HashLookup& lookup) {
     }
     return;
   }
+  const bool prefetch = allocatedBytes() >= minBytesForPrefetchProbe_;
+  // The tags and row pointers take 9 bytes per slot.
+  const bool partitioned =
+      capacity_ * (1 + sizeof(char*)) >= minBytesForPartitionedProbe_;
   if (hashMode_ == HashMode::kNormalizedKey) {
     populateNormalizedKeys(lookup, sizeBits_);
-    joinNormalizedKeyProbe(lookup);
+    if (partitioned) {
+      joinProbePartitioned<true>(lookup);
+    } else if (prefetch) {
+      joinProbeWithPrefetch<true>(lookup);
+    } else {
+      joinNormalizedKeyProbe(lookup);
+    }
+    return;
+  }
+  if (partitioned) {
+    joinProbePartitioned<false>(lookup);
+    return;
+  }
+  if (prefetch) {
+    joinProbeWithPrefetch<false>(lookup);
     return;
   }
   int32_t probeIndex = 0;
@@ -606,6 +705,87 @@ void HashTable<ignoreNullKeys>::joinNormalizedKeyProbe(HashLookup& lookup) {
   }
 }
 
+template <bool ignoreNullKeys>
+template <bool normalizedKeys>
+void HashTable<ignoreNullKeys>::joinProbeWithPrefetch(HashLookup& lookup) {
+  const int32_t numProbes = lookup.rows.size();
+  const vector_size_t* rows = lookup.rows.data();
+  const uint64_t* keys = lookup.normalizedKeys.data();
+  const uint64_t* hashes = lookup.hashes.data();
+  char** hits = lookup.hits.data();
+  ProbeState states[kPrefetchProbeBatchSize];
+  for (int32_t batchStart = 0; batchStart < numProbes;
+       batchStart += kPrefetchProbeBatchSize) {
+    const int32_t batchSize =
+        std::min(kPrefetchProbeBatchSize, numProbes - batchStart);
+    const vector_size_t* batchRows = rows + batchStart;
+    // The loads of each stage are independent across the rows of the batch,
+    // so their cache misses overlap instead of being taken one row at a time.
+    for (auto i = 0; i < batchSize; ++i) {
+      ProbeState::prefetch(tags_, table_, sizeMask_, hashes[batchRows[i]]);
+    }
+    // Compares the tags and prefetches the first matching row.
+    for (auto i = 0; i < batchSize; ++i) {
+      const auto row = batchRows[i];
+      states[i].preProbe(tags_, sizeMask_, hashes[row], row);
+      states[i].firstProbe(table_, 0);
+    }
+    // Compares the keys.
+    for (auto i = 0; i < batchSize; ++i) {
+      if constexpr (normalizedKeys) {
+        hits[states[i].row()] = states[i].joinNormalizedKeyFullProbe(
+            tags_, table_, sizeMask_, keys);
+      } else {
+        fullProbe<true>(lookup, states[i], false);
+      }
+    }
+  }
+}
+
+template <bool ignoreNullKeys>
+template <bool normalizedKeys>
+void HashTable<ignoreNullKeys>::joinProbePartitioned(HashLookup& lookup) {
+  const int32_t numProbes = lookup.rows.size();
+  const int64_t tableBytes = capacity_ * (1 + sizeof(char*));
+  // Each partition probes a range of at least 'probePartitionBytes_' and has
+  // enough rows to amortize the partitioning.
+  int32_t numBits = 0;
+  while (numBits < sizeBits_ &&
+         (tableBytes >> (numBits + 1)) >= probePartitionBytes_ &&
+         (numProbes >> (numBits + 1)) >= kMinRowsPerProbePartition) {
+    ++numBits;
+  }
+  if (numBits == 0) {
+    joinProbeWithPrefetch<normalizedKeys>(lookup);
+    return;
+  }
+
+  // Counting sort of the rows by the high bits of the tags offset they probe.
+  const int32_t shift = sizeBits_ - numBits;
+  const uint64_t* hashes = lookup.hashes.data();
+  auto partitionOf = [&](vector_size_t row) {
+    return ProbeState::tagsByteOffset(hashes[row], sizeMask_) >> shift;
+  };
+  std::vector<int32_t> offsets((1 << numBits) + 1, 0);
+  for (auto row : lookup.rows) {
+    ++offsets[partitionOf(row) + 1];
+  }
+  for (auto i = 1; i < offsets.size(); ++i) {
+    offsets[i] += offsets[i - 1];
+  }
+  auto& partitionedRows = lookup.partitionedRows;
+  partitionedRows.resize(numProbes);
+  for (auto row : lookup.rows) {
+    partitionedRows[offsets[partitionOf(row)]++] = row;
+  }
+
+  // The hits are set by row number, so the probe order doesn't matter.
+  std::swap(lookup.rows, partitionedRows);
+  auto restoreRows =
+      folly::makeGuard([&]() { std::swap(lookup.rows, partitionedRows); });
+  joinProbeWithPrefetch<normalizedKeys>(lookup);
+}
+
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::allocateTables(uint64_t size) {
   VELOX_CHECK(bits::isPowerOfTwo(size), "Size is not a power of two: {}", size);
@@ -635,11 +815,18 @@ void HashTable<ignoreNullKeys>::clear() {
   if (table_) {
     memset(table_, 0, sizeof(char*) * capacity_);
   }
+  for (auto& partition : groupByPartitions_) {
+    memset(partition.tags, 0, partition.capacity);
+    memset(partition.table, 0, sizeof(char*) * partition.capacity);
+    partition.numDistinct = 0;
+    partition.numTombstones = 0;
+  }
   numDistinct_ = 0;
 }
 
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::checkSize(int32_t numNew) {
+  VELOX_CHECK(groupByPartitions_.empty());
   // NOTE: the way we decide the table size and trigger rehash, guarantees the
   // table should always have free slots after the insertion.
   VELOX_CHECK(
@@ -661,6 +848,10 @@ void HashTable<ignoreNullKeys>::checkSize(int32_t numNew) {
     if (newNumDistincts > rehashSize(newSize)) {
       newSize *= 2;
     }
+    if (shouldPartitionGroupBy(newSize)) {
+      initGroupByPartitions(newSize);
+      return;
+    }
 
     allocateTables(newSize);
     if (numDistinct_ > 0) {
@@ -676,11 +867,178 @@ void HashTable<ignoreNullKeys>::checkSize(int32_t numNew) {
     // NOTE: we need to plus one here as number itself could be power of two.
     const auto newCapacity = bits::nextPowerOfTwo(
         std::max(newNumDistincts, capacity_ - numTombstones_) + 1);
+    if (shouldPartitionGroupBy(newCapacity)) {
+      initGroupByPartitions(newCapacity);
+      return;
+    }
     allocateTables(newCapacity);
     rehash();
   }
 }
 
+template <bool ignoreNullKeys>
+bool HashTable<ignoreNullKeys>::shouldPartitionGroupBy(uint64_t size) const {
+  return !isJoinBuild_ && hashMode_ != HashMode::kArray &&
+      size * (1 + sizeof(char*)) >= minBytesForPartitionedGroupBy_;
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::initGroupByPartitions(uint64_t size) {
+  if (tableAllocation_.data() != nullptr) {
+    rows_->pool()->freeContiguous(tableAllocation_);
+  }
+  tags_ = nullptr;
+  table_ = nullptr;
+  sizeMask_ = 0;
+  numTombstones_ = 0;
+  capacity_ = 0;
+  const auto partitionSize = std::max<uint64_t>(
+      size / kNumGroupByPartitions, kMinGroupByPartitionSize);
+  groupByPartitions_.resize(kNumGroupByPartitions);
+  for (auto& partition : groupByPartitions_) {
+    allocateGroupByPartition(partition, partitionSize);
+    capacity_ += partitionSize;
+  }
+  if (numDistinct_ > 0) {
+    rehash();
+  }
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::allocateGroupByPartition(
+    GroupByPartition& partition,
+    uint64_t size) {
+  VELOX_CHECK(bits::isPowerOfTwo(size), "Size is not a power of two: {}", size);
+  VELOX_CHECK_GE(size, sizeof(TagVector));
+  constexpr auto kPageSize = memory::AllocationTraits::kPageSize;
+  // 9 bytes per slot, as in allocateTables().
+  auto numPages = bits::roundUp(size * 9, kPageSize) / kPageSize;
+  rows_->pool()->allocateContiguous(numPages, partition.allocation);
+  partition.table = partition.allocation.data<char*>();
+  partition.tags = reinterpret_cast<uint8_t*>(partition.table + size);
+  partition.capacity = size;
+  partition.sizeMask = size - 1;
+  partition.numDistinct = 0;
+  partition.numTombstones = 0;
+  memset(partition.tags, 0, size);
+  memset(partition.table, 0, size * sizeof(char*));
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::freeGroupByPartitions() {
+  // The destructor of each allocation returns its memory to the pool.
+  groupByPartitions_.clear();
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::checkGroupByPartitionSizes(
+    const HashLookup& lookup) {
+  std::array<int32_t, kNumGroupByPartitions> numNew{};
+  for (auto row : lookup.rows) {
+    ++numNew[groupByPartition(lookup.hashes[row])];
+  }
+  for (auto i = 0; i < kNumGroupByPartitions; ++i) {
+    auto& partition = groupByPartitions_[i];
+    const int64_t newNumDistinct = partition.numDistinct + numNew[i];
+    const int64_t available = partition.capacity - partition.numTombstones;
+    if (newNumDistinct > rehashSize(available)) {
+      rehashGroupByPartition(
+          partition,
+          bits::nextPowerOfTwo(std::max(newNumDistinct, available) + 1));
+    }
+  }
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::rehashGroupByPartition(
+    GroupByPartition& partition,
+    uint64_t newSize) {
+  ++numRehashes_;
+  constexpr int32_t kHashBatchSize = 1024;
+  GroupByPartition newPartition;
+  allocateGroupByPartition(newPartition, newSize);
+  raw_vector<uint64_t> hashes;
+  hashes.resize(kHashBatchSize);
+  char* groups[kHashBatchSize];
+  int32_t numGroups = 0;
+  auto insertGroups = [&]() {
+    // The stored rows are hashed again. In kNormalizedKey mode this reuses
+    // the normalized key below the row.
+    VELOX_CHECK(hashRows(folly::Range(groups, numGroups), false, hashes));
+    for (auto i = 0; i < numGroups; ++i) {
+      insertIntoGroupByPartition(newPartition, groups[i], hashes[i]);
+    }
+    numGroups = 0;
+  };
+  for (auto i = 0; i < partition.capacity; ++i) {
+    // Empty and tombstone tags have the high bit clear.
+    if (partition.tags[i] & 0x80) {
+      groups[numGroups++] = partition.table[i];
+      if (numGroups == kHashBatchSize) {
+        insertGroups();
+      }
+    }
+  }
+  insertGroups();
+  VELOX_CHECK_EQ(newPartition.numDistinct, partition.numDistinct);
+  capacity_ += newPartition.capacity - partition.capacity;
+  rows_->pool()->freeContiguous(partition.allocation);
+  partition = std::move(newPartition);
+}
+
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::insertIntoGroupByPartition(
+    GroupByPartition& partition,
+    char* group,
+    uint64_t hash) {
+  auto tagIndex = ProbeState::tagsByteOffset(hash, partition.sizeMask);
+  auto tagsInTable = loadTags(partition.tags, tagIndex);
+  for (;;) {
+    MaskType free =
+        ~simd::toBitMask(
+            BaseHashTable::TagVector::batch_bool_type(tagsInTable)) &
+        ProbeState::kFullMask;
+    if (free) {
+      auto freeOffset = bits::getAndClearLastSetBit(free);
+      partition.tags[tagIndex + freeOffset] = hashTag(hash);
+      partition.table[tagIndex + freeOffset] = group;
+      ++partition.numDistinct;
+      return;
+    }
+    tagIndex = (tagIndex + sizeof(TagVector)) & partition.sizeMask;
+    tagsInTable = loadTags(partition.tags, tagIndex);
+  }
+}
+
+template <bool ignoreNullKeys>
+uint64_t HashTable<ignoreNullKeys>::partitionedSizeIncrease(
+    int32_t numNewDistinct) const {
+  const int64_t numNewPerPartition =
+      bits::roundUp(numNewDistinct, kNumGroupByPartitions) /
+      kNumGroupByPartitions;
+  uint64_t increase = 0;
+  for (const auto& partition : groupByPartitions_) {
+    if (partition.numDistinct + numNewPerPartition >
+        rehashSize(partition.capacity - partition.numTombstones)) {
+      // A rehashed partition doubles.
+      increase += partition.capacity * (sizeof(void*) + 1);
+    }
+  }
+  return increase;
+}
+
+template <bool ignoreNullKeys>
+int64_t HashTable<ignoreNullKeys>::numTombstones() const {
+  if (groupByPartitions_.empty()) {
+    return numTombstones_;
+  }
+  int64_t numTombstones = 0;
+  for (const auto& partition : groupByPartitions_) {
+    numTombstones += partition.numTombstones;
+  }
+  return numTombstones;
+}
+
 template <bool ignoreNullKeys>
 bool HashTable<ignoreNullKeys>::hashRows(
     folly::Range<char**> rows,
@@ -942,6 +1300,13 @@ void HashTable<ignoreNullKeys>::insertForGroupBy(
       VELOX_CHECK_NULL(table_[index]);
       table_[index] = groups[i];
     }
+  } else if (!groupByPartitions_.empty()) {
+    for (int32_t i = 0; i < numGroups; ++i) {
+      insertIntoGroupByPartition(
+          groupByPartitions_[groupByPartition(hashes[i])],
+          groups[i],
+          hashes[i]);
+    }
   } else {
     for (int32_t i = 0; i < numGroups; ++i) {
       auto hash = hashes[i];
@@ -1116,6 +1481,8 @@ void HashTable<ignoreNullKeys>::rehash() {
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::setHashMode(HashMode mode, int32_t numNew) {
   VELOX_CHECK_NE(hashMode_, HashMode::kHash);
+  // The partitions are sized and rehashed for the new mode as needed.
+  freeGroupByPartitions();
   if (mode == HashMode::kArray) {
     auto bytes = capacity_ * sizeof(char*);
     constexpr auto kPageSize = memory::AllocationTraits::kPageSize;
@@ -1353,10 +1720,17 @@ std::string HashTable<ignoreNullKeys>::toString() {
       occupied += table_[i] != nullptr;
     }
   }
+  for (const auto& partition : groupByPartitions_) {
+    for (auto i = 0; i < partition.capacity; ++i) {
+      occupied += partition.table[i] != nullptr;
+    }
+  }
   out << "[HashTable  size: " << capacity_ << " occupied: " << occupied
       << " distinct count: " << numDistinct_
-      << " tombstone count: " << numTombstones_ << "]";
-  if (table_ == nullptr) {
+      << " tombstone count: " << numTombstones() << "]";
+  if (!groupByPartitions_.empty()) {
+    out << "(" << groupByPartitions_.size() << " partitions) ";
+  } else if (table_ == nullptr) {
     out << "(no table) ";
   }
   for (auto& hasher : hashers_) {
@@ -1420,6 +1794,12 @@ void HashTable<ignoreNullKeys>::prepareJoinTable(
     if (hashMode_ != HashMode::kHash) {
       setHashMode(HashMode::kHash, 0);
     } else {
+      // The rows of 'this' may already be in the table if the build inserted
+      // its input with groupProbe() to drop duplicate keys. Reallocate so that
+      // the rows of 'otherTables_' are inserted as well.
+      if (!otherTables_.empty()) {
+        capacity_ = 0;
+      }
       checkSize(0);
     }
   } else {
@@ -1641,17 +2021,29 @@ void HashTable<ignoreNullKeys>::eraseWithHashes(
 
     ProbeState state;
     for (auto i = 0; i < numRows; ++i) {
-      state.preProbe(tags_, sizeMask_, hashes[i], i);
+      auto tags = tags_;
+      auto table = table_;
+      auto sizeMask = sizeMask_;
+      auto* numTombstones = &numTombstones_;
+      if (!groupByPartitions_.empty()) {
+        auto& partition = groupByPartitions_[groupByPartition(hashes[i])];
+        tags = partition.tags;
+        table = partition.table;
+        sizeMask = partition.sizeMask;
+        numTombstones = &partition.numTombstones;
+        --partition.numDistinct;
+      }
+      state.preProbe(tags, sizeMask, hashes[i], i);
 
-      state.firstProbe<ProbeState::Operation::kErase>(table_, 0);
+      state.firstProbe<ProbeState::Operation::kErase>(table, 0);
       state.fullProbe<ProbeState::Operation::kErase>(
-          tags_,
-          table_,
-          sizeMask_,
+          tags,
+          table,
+          sizeMask,
           0,
           [&](const char* group, int32_t row) { return rows[row] == group; },
           [&](int32_t /*index*/, int32_t /*row*/) { return nullptr; },
-          numTombstones_,
+          *numTombstones,
           false);
     }
   }
@@ -1665,6 +2057,27 @@ void HashTable<ignoreNullKeys>::checkConsistency() const {
   if (hashMode_ == BaseHashTable::HashMode::kArray) {
     return;
   }
+  if (!groupByPartitions_.empty()) {
+    int64_t capacity = 0;
+    int64_t numDistinct = 0;
+    for (const auto& partition : groupByPartitions_) {
+      uint64_t numEmpty = 0;
+      uint64_t numTombstone = 0;
+      for (auto i = 0; i < partition.capacity; ++i) {
+        numTombstone += partition.tags[i] == ProbeState::kTombstoneTag;
+        numEmpty += partition.tags[i] == ProbeState::kEmptyTag;
+      }
+      VELOX_CHECK_EQ(numTombstone, partition.numTombstones);
+      VELOX_CHECK_EQ(
+          numEmpty + numTombstone + partition.numDistinct,
+          partition.capacity);
+      capacity += partition.capacity;
+      numDistinct += partition.numDistinct;
+    }
+    VELOX_CHECK_EQ(capacity, capacity_);
+    VELOX_CHECK_EQ(numDistinct, numDistinct_);
+    return;
+  }
   uint64_t numEmpty = 0;
   uint64_t numTombstone = 0;
   for (auto i = 0; i < capacity_; ++i) {
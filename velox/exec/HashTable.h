@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "velox/common/base/BloomFilter.h"
 #include "velox/common/memory/MemoryAllocator.h"
 #include "velox/exec/Aggregate.h"
 #include "velox/exec/Operator.h"
@@ -46,6 +47,9 @@ struct HashLookup {
   // corresponding group row.
   raw_vector<char*> hits;
   std::vector<vector_size_t> newGroups;
+  // Scratch for 'rows' reordered by the range of the table they probe in a
+  // partitioned join probe.
+  raw_vector<vector_size_t> partitionedRows;
 };
 
 struct HashTableStats {
@@ -239,6 +243,17 @@ class BaseHashTable {
     return std::move(rows_);
   }
 
+  /// Returns a Bloom filter over the hashes of the keys in 'this' or nullptr
+  /// if there is none. The hashes are computed as for probing in kHash mode.
+  /// This is set by the hash join build.
+  const std::shared_ptr<const BloomFilter<>>& joinKeyBloomFilter() const {
+    return joinKeyBloomFilter_;
+  }
+
+  void setJoinKeyBloomFilter(std::shared_ptr<const BloomFilter<>> filter) {
+    joinKeyBloomFilter_ = std::move(filter);
+  }
+
   // Static functions for processing internals. Public because used in
   // structs that define probe and insert algorithms. These are
   // concentrated here to abstract away data layout, e.g tags and
@@ -282,6 +297,7 @@ class BaseHashTable {
 
   std::vector<std::unique_ptr<VectorHasher>> hashers_;
   std::unique_ptr<RowContainer> rows_;
+  std::shared_ptr<const BloomFilter<>> joinKeyBloomFilter_;
 };
 
 FOLLY_ALWAYS_INLINE std::ostream& operator<<(
@@ -303,6 +319,9 @@ class HashTable : public BaseHashTable {
   // not occur. In this case the row does not need a link to the next
   // match. 'hasProbedFlag' adds an extra bit in every row for tracking rows
   // that matches join condition for right and full outer joins.
+  // 'appendOnlyStrings' makes the RowContainer allocate variable length
+  // data append-only and 'compactLayout' makes it pack its rows, see
+  // RowContainer.
   HashTable(
       std::vector<std::unique_ptr<VectorHasher>>&& hashers,
       const std::vector<std::unique_ptr<Aggregate>>& aggregates,
@@ -310,12 +329,16 @@ class HashTable : public BaseHashTable {
       bool allowDuplicates,
       bool isJoinBuild,
       bool hasProbedFlag,
-      memory::MemoryPool* FOLLY_NULLABLE pool);
+      memory::MemoryPool* FOLLY_NULLABLE pool,
+      bool appendOnlyStrings = false,
+      bool compactLayout = false);
 
   static std::unique_ptr<HashTable> createForAggregation(
       std::vector<std::unique_ptr<VectorHasher>>&& hashers,
       const std::vector<std::unique_ptr<Aggregate>>& aggregates,
-      memory::MemoryPool* FOLLY_NULLABLE pool) {
+      memory::MemoryPool* FOLLY_NULLABLE pool,
+      bool appendOnlyStrings = false,
+      bool compactLayout = false) {
     return std::make_unique<HashTable>(
         std::move(hashers),
         aggregates,
@@ -323,7 +346,9 @@ class HashTable : public BaseHashTable {
         false, // allowDuplicates
         false, // isJoinBuild
         false, // hasProbedFlag
-        pool);
+        pool,
+        appendOnlyStrings,
+        compactLayout);
   }
 
   static std::unique_ptr<HashTable> createForJoin(
@@ -331,7 +356,8 @@ class HashTable : public BaseHashTable {
       const std::vector<TypePtr>& dependentTypes,
       bool allowDuplicates,
       bool hasProbedFlag,
-      memory::MemoryPool* FOLLY_NULLABLE pool) {
+      memory::MemoryPool* FOLLY_NULLABLE pool,
+      bool compactLayout = false) {
     static const std::vector<std::unique_ptr<Aggregate>> kNoAggregates;
     return std::make_unique<HashTable>(
         std::move(hashers),
@@ -340,6 +366,26 @@ class HashTable : public BaseHashTable {
         allowDuplicates,
         true, // isJoinBuild
         hasProbedFlag,
+        pool,
+        false, // appendOnlyStrings
+        compactLayout);
+  }
+
+  /// Creates a table for groupProbe() with no aggregates. Each group row has
+  /// 'dependentTypes' columns after the keys for per-group state kept by the
+  /// caller.
+  static std::unique_ptr<HashTable> createForGrouping(
+      std::vector<std::unique_ptr<VectorHasher>>&& hashers,
+      const std::vector<TypePtr>& dependentTypes,
+      memory::MemoryPool* FOLLY_NULLABLE pool) {
+    static const std::vector<std::unique_ptr<Aggregate>> kNoAggregates;
+    return std::make_unique<HashTable>(
+        std::move(hashers),
+        kNoAggregates,
+        dependentTypes,
+        false, // allowDuplicates
+        false, // isJoinBuild
+        false, // hasProbedFlag
         pool);
   }
 
@@ -395,7 +441,7 @@ class HashTable : public BaseHashTable {
 
   HashTableStats stats() const override {
     return HashTableStats{
-        capacity_, numRehashes_, numDistinct_, numTombstones_};
+        capacity_, numRehashes_, numDistinct_, numTombstones()};
   }
 
   bool hasDuplicateKeys() const override {
@@ -425,6 +471,9 @@ class HashTable : public BaseHashTable {
       folly::Executor* FOLLY_NULLABLE executor = nullptr) override;
 
   uint64_t hashTableSizeIncrease(int32_t numNewDistinct) const override {
+    if (!groupByPartitions_.empty()) {
+      return partitionedSizeIncrease(numNewDistinct);
+    }
     if (numDistinct_ + numNewDistinct > rehashSize()) {
       // If rehashed, the table adds size_ entries (i.e. doubles),
       // adding one pointer and one tag byte for each new position.
@@ -452,7 +501,74 @@ class HashTable : public BaseHashTable {
     setHashMode(mode, numNew);
   }
 
+  void testingSetMinBytesForPrefetchProbe(int64_t bytes) {
+    minBytesForPrefetchProbe_ = bytes;
+  }
+
+  void testingSetPartitionedProbe(int64_t minTableBytes, int64_t bytes) {
+    minBytesForPartitionedProbe_ = minTableBytes;
+    probePartitionBytes_ = bytes;
+  }
+
+  void testingSetMinBytesForPartitionedGroupBy(int64_t bytes) {
+    minBytesForPartitionedGroupBy_ = bytes;
+  }
+
+  /// Returns the number of independently sized partitions of a group by
+  /// table, 0 if the table is a single array of tags and row pointers.
+  int32_t numGroupByPartitions() const {
+    return groupByPartitions_.size();
+  }
+
  private:
+  // The number of rows that go through each stage of a prefetching join probe
+  // together.
+  static constexpr int32_t kPrefetchProbeBatchSize = 16;
+
+  // The minimum size of a join table for prefetching in probe. Smaller tables
+  // mostly fit in the cache.
+  static constexpr int64_t kMinBytesForPrefetchProbe = 32 << 20;
+
+  // The minimum size of the tags and row pointers of a join table for
+  // partitioning the probe rows. The random accesses to larger tables miss the
+  // TLB on most rows.
+  static constexpr int64_t kMinBytesForPartitionedProbe = 256 << 20;
+
+  // The size of the range of the table probed by each partition of the probe
+  // rows, e.g. the memory mapped by a huge page.
+  static constexpr int64_t kProbePartitionBytes = 2 << 20;
+
+  // The minimum average number of probe rows per partition. Fewer rows don't
+  // amortize the partitioning.
+  static constexpr int32_t kMinRowsPerProbePartition = 32;
+
+  // The minimum size of the tags and row pointers of a group by table for
+  // splitting it into independently sized partitions. Growing a larger
+  // table as a whole pauses the probe for a long time and briefly needs
+  // space for both the old and the new table.
+  static constexpr int64_t kMinBytesForPartitionedGroupBy = 64 << 20;
+
+  // The number of high bits of the hash number that select the partition of
+  // a partitioned group by table.
+  static constexpr int32_t kGroupByPartitionBits = 4;
+  static constexpr int32_t kNumGroupByPartitions = 1 << kGroupByPartitionBits;
+
+  // The minimum number of slots in a partition of a group by table.
+  static constexpr int64_t kMinGroupByPartitionSize = 2048;
+
+  // The tags, row pointers and slot counts of one partition of a partitioned
+  // group by table. Each partition is an open addressing table of its own
+  // and is rehashed independently of the others when it fills up.
+  struct GroupByPartition {
+    memory::ContiguousAllocation allocation;
+    uint8_t* FOLLY_NULLABLE tags{nullptr};
+    char* FOLLY_NULLABLE* FOLLY_NULLABLE table{nullptr};
+    int64_t capacity{0};
+    int64_t sizeMask{0};
+    int64_t numDistinct{0};
+    int64_t numTombstones{0};
+  };
+
   // Returns the number of entries after which the table gets rehashed.
   static uint64_t rehashSize(int64_t size) {
     // This implements the F14 load factor: Resize if less than 1/8 unoccupied.
@@ -510,6 +626,56 @@ class HashTable : public BaseHashTable {
 
   void checkSize(int32_t numNew);
 
+  // Returns the partition of a partitioned group by table for 'hash'.
+  static int32_t groupByPartition(uint64_t hash) {
+    return hash >> (64 - kGroupByPartitionBits);
+  }
+
+  // True if a group by table of 'size' slots should be split into
+  // 'groupByPartitions_'.
+  bool shouldPartitionGroupBy(uint64_t size) const;
+
+  // Replaces the single array of tags and row pointers with
+  // kNumGroupByPartitions partitions of 'size' slots in total and inserts
+  // the existing rows.
+  void initGroupByPartitions(uint64_t size);
+
+  // Allocates 'size' slots for 'partition'. The size must be a power of 2.
+  void allocateGroupByPartition(GroupByPartition& partition, uint64_t size);
+
+  // Frees 'groupByPartitions_'.
+  void freeGroupByPartitions();
+
+  // Grows the partitions that would exceed their load factor after inserting
+  // the rows in 'lookup' that hash to them.
+  void checkGroupByPartitionSizes(const HashLookup& lookup);
+
+  // Moves the entries of 'partition' into a new allocation of 'newSize'
+  // slots. The other partitions are not affected.
+  void rehashGroupByPartition(GroupByPartition& partition, uint64_t newSize);
+
+  // Inserts 'group' with 'hash' into the first free slot of 'partition'.
+  void insertIntoGroupByPartition(
+      GroupByPartition& partition,
+      char* FOLLY_NULLABLE group,
+      uint64_t hash);
+
+  // groupProbe() for a table with 'groupByPartitions_'.
+  void partitionedGroupProbe(HashLookup& lookup);
+
+  // Like fullProbe() for group by but probes 'partition'.
+  void partitionedFullProbe(
+      HashLookup& lookup,
+      ProbeState& state,
+      GroupByPartition& partition);
+
+  // hashTableSizeIncrease() for a table with 'groupByPartitions_'. Assumes
+  // the new entries are evenly spread over the partitions.
+  uint64_t partitionedSizeIncrease(int32_t numNewDistinct) const;
+
+  // Returns the number of tombstone slots in all partitions of the table.
+  int64_t numTombstones() const;
+
   // Computes hash numbers of the appropriate hash mode for 'groups',
   // stores these in 'hashes' and inserts the groups using
   // insertForJoin or insertForGroupBy.
@@ -587,6 +753,10 @@ class HashTable : public BaseHashTable {
   char* FOLLY_NULLABLE
   insertEntry(HashLookup& lookup, int32_t index, vector_size_t row);
 
+  // Creates a row for the key at 'row' in 'lookup' without recording it in
+  // the tags and row pointers of the table.
+  char* FOLLY_NULLABLE newGroup(HashLookup& lookup, vector_size_t row);
+
   bool compareKeys(
       const char* FOLLY_NULLABLE group,
       HashLookup& lookup,
@@ -602,6 +772,21 @@ class HashTable : public BaseHashTable {
   // Shortcut for probe with normalized keys.
   void joinNormalizedKeyProbe(HashLookup& lookup);
 
+  // Probes a join table that is much larger than the cache. Processes the
+  // rows in batches of 'kPrefetchProbeBatchSize' in stages: prefetch the tags
+  // and row pointers, compare the tags and prefetch the rows, compare the
+  // keys. 'normalizedKeys' is true in kNormalizedKey mode.
+  template <bool normalizedKeys>
+  void joinProbeWithPrefetch(HashLookup& lookup);
+
+  // Probes a join table that is much larger than the TLB reach. Partitions
+  // the rows by their hash bits into the ranges of the table they probe, then
+  // probes one partition at a time with joinProbeWithPrefetch() so that the
+  // accesses of each partition stay within a range of about
+  // 'probePartitionBytes_'. 'lookup.rows' is unchanged on return.
+  template <bool normalizedKeys>
+  void joinProbePartitioned(HashLookup& lookup);
+
   // Adds a row to a hash join table in kArray hash mode. Returns true
   // if a new entry was made and false if the row was added to an
   // existing set of rows with the same key.
@@ -677,6 +862,22 @@ class HashTable : public BaseHashTable {
   // execute the parallel build steps.
   folly::Executor* FOLLY_NULLABLE buildExecutor_{nullptr};
 
+  // See kMinBytesForPrefetchProbe.
+  int64_t minBytesForPrefetchProbe_{kMinBytesForPrefetchProbe};
+
+  // See kMinBytesForPartitionedProbe and kProbePartitionBytes.
+  int64_t minBytesForPartitionedProbe_{kMinBytesForPartitionedProbe};
+  int64_t probePartitionBytes_{kProbePartitionBytes};
+
+  // See kMinBytesForPartitionedGroupBy.
+  int64_t minBytesForPartitionedGroupBy_{kMinBytesForPartitionedGroupBy};
+
+  // The partitions of a group by table that has outgrown
+  // kMinBytesForPartitionedGroupBy, selected by the high bits of the hash
+  // number. When set, 'tags_' and 'table_' are not used and 'capacity_' is
+  // the total size of the partitions. Not used in kArray mode nor for join.
+  std::vector<GroupByPartition> groupByPartitions_;
+
   //  Counts parallel build rows. Used for consistency check.
   std::atomic<int64_t> numParallelBuildRows_{0};
 };
@@ -15,6 +15,7 @@
  */
 
 #include "velox/exec/LocalPartition.h"
+#include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
@@ -29,32 +30,59 @@ void notify(std::vector<ContinuePromise>& promises) {
 bool LocalExchangeMemoryManager::increaseMemoryUsage(
     ContinueFuture* future,
     int64_t added) {
-  std::lock_guard<std::mutex> l(mutex_);
-  bufferedBytes_ += added;
-
-  if (bufferedBytes_ >= maxBufferSize_) {
-    promises_.emplace_back("LocalExchangeMemoryManager::updateMemoryUsage");
-    *future = promises_.back().getSemiFuture();
-    return true;
+  if (bufferedBytes_.fetch_add(added) + added < maxBufferSize_) {
+    return false;
   }
 
-  return false;
+  std::lock_guard<std::mutex> l(mutex_);
+  hasPromises_ = true;
+  if (bufferedBytes_ < maxBufferSize_) {
+    // A consumer made room after the increase.
+    hasPromises_ = !promises_.empty();
+    return false;
+  }
+  promises_.emplace_back("LocalExchangeMemoryManager::updateMemoryUsage");
+  *future = promises_.back().getSemiFuture();
+  return true;
 }
 
 std::vector<ContinuePromise> LocalExchangeMemoryManager::decreaseMemoryUsage(
     int64_t removed) {
+  if (bufferedBytes_.fetch_sub(removed) - removed >= maxBufferSize_ ||
+      !hasPromises_) {
+    return {};
+  }
+
   std::vector<ContinuePromise> promises;
   {
     std::lock_guard<std::mutex> l(mutex_);
-    bufferedBytes_ -= removed;
-
     if (bufferedBytes_ < maxBufferSize_) {
       promises = std::move(promises_);
+      promises_.clear();
+      hasPromises_ = false;
     }
   }
   return promises;
 }
 
+int ScaleWriterState::nextWriter(int64_t inputBytes) {
+  const auto processedBytes =
+      processedBytes_.fetch_add(inputBytes) + inputBytes;
+  auto numActiveWriters = numActiveWriters_.load();
+  if (numActiveWriters < numWriters_ &&
+      processedBytes >= minProcessedBytes_ * numActiveWriters &&
+      memoryManager_->bufferedBytes() * 2 >= memoryManager_->maxBufferSize()) {
+    // On failure, another producer activated a writer and the load updates
+    // 'numActiveWriters'.
+    if (numActiveWriters_.compare_exchange_strong(
+            numActiveWriters, numActiveWriters + 1)) {
+      ++numActiveWriters;
+      processedBytes_ = 0;
+    }
+  }
+  return counter_++ % numActiveWriters;
+}
+
 void LocalExchangeQueue::addProducer() {
   queue_.withWLock([&](auto& /*queue*/) {
     VELOX_CHECK(!noMoreProducers_, "addProducer called after noMoreProducers");
@@ -113,7 +141,7 @@ BlockingReason LocalExchangeQueue::enqueue(
 void LocalExchangeQueue::noMoreData() {
   std::vector<ContinuePromise> consumerPromises;
   std::vector<ContinuePromise> producerPromises;
-  queue_.withWLock([&](auto queue) {
+  queue_.withWLock([&](auto& queue) {
     VELOX_CHECK_GT(pendingProducers_, 0);
     --pendingProducers_;
     if (noMoreProducers_ && pendingProducers_ == 0) {
@@ -146,11 +174,51 @@ BlockingReason LocalExchangeQueue::next(
       return BlockingReason::kWaitForExchange;
     }
 
-    *data = queue.front();
+    *data = std::move(queue.front());
     queue.pop();
 
+    if (noMoreProducers_ && pendingProducers_ == 0 && queue.empty()) {
+      producerPromises = std::move(producerPromises_);
+    }
+
+    return BlockingReason::kNotBlocked;
+  });
+  // The memory usage is updated outside of the lock of the queue, so that
+  // producers of the queue do not wait for other queues.
+  if (*data != nullptr) {
     memoryPromises =
         memoryManager_->decreaseMemoryUsage((*data)->retainedSize());
+  }
+  notify(memoryPromises);
+  notify(producerPromises);
+  return blockingReason;
+}
+
+BlockingReason LocalExchangeQueue::next(
+    ContinueFuture* future,
+    vector_size_t maxRows,
+    std::vector<RowVectorPtr>& data) {
+  std::vector<ContinuePromise> producerPromises;
+  std::vector<ContinuePromise> memoryPromises;
+  data.clear();
+  auto blockingReason = queue_.withWLock([&](auto& queue) {
+    if (queue.empty()) {
+      if (isFinishedLocked(queue)) {
+        return BlockingReason::kNotBlocked;
+      }
+
+      consumerPromises_.emplace_back("LocalExchangeQueue::next");
+      *future = consumerPromises_.back().getSemiFuture();
+
+      return BlockingReason::kWaitForExchange;
+    }
+
+    vector_size_t numRows = 0;
+    do {
+      numRows += queue.front()->size();
+      data.push_back(std::move(queue.front()));
+      queue.pop();
+    } while (!queue.empty() && numRows + queue.front()->size() <= maxRows);
 
     if (noMoreProducers_ && pendingProducers_ == 0 && queue.empty()) {
       producerPromises = std::move(producerPromises_);
@@ -158,6 +226,13 @@ BlockingReason LocalExchangeQueue::next(
 
     return BlockingReason::kNotBlocked;
   });
+  int64_t removedBytes = 0;
+  for (const auto& vector : data) {
+    removedBytes += vector->retainedSize();
+  }
+  if (removedBytes > 0) {
+    memoryPromises = memoryManager_->decreaseMemoryUsage(removedBytes);
+  }
   notify(memoryPromises);
   notify(producerPromises);
   return blockingReason;
@@ -193,25 +268,28 @@ bool LocalExchangeQueue::isFinished() {
   return queue_.withWLock([&](auto& queue) { return isFinishedLocked(queue); });
 }
 
+bool LocalExchangeQueue::isClosed() {
+  return queue_.withRLock([&](auto& /*queue*/) { return closed_; });
+}
+
 void LocalExchangeQueue::close() {
   std::vector<ContinuePromise> producerPromises;
   std::vector<ContinuePromise> consumerPromises;
   std::vector<ContinuePromise> memoryPromises;
+  uint64_t freedBytes = 0;
   queue_.withWLock([&](auto& queue) {
-    uint64_t freedBytes = 0;
     while (!queue.empty()) {
       freedBytes += queue.front()->retainedSize();
       queue.pop();
     }
 
-    if (freedBytes) {
-      memoryPromises = memoryManager_->decreaseMemoryUsage(freedBytes);
-    }
-
     producerPromises = std::move(producerPromises_);
     consumerPromises = std::move(consumerPromises_);
     closed_ = true;
   });
+  if (freedBytes) {
+    memoryPromises = memoryManager_->decreaseMemoryUsage(freedBytes);
+  }
   notify(producerPromises);
   notify(consumerPromises);
   notify(memoryPromises);
@@ -233,7 +311,12 @@ LocalExchange::LocalExchange(
       queue_{operatorCtx_->task()->getLocalExchangeQueue(
           ctx->splitGroupId,
           planNodeId,
-          partition)} {}
+          partition)},
+      coalesceRows_{
+          ctx->queryConfig().localExchangeCoalesceBatches()
+              ? static_cast<vector_size_t>(
+                    ctx->queryConfig().preferredOutputBatchSize())
+              : 0} {}
 
 BlockingReason LocalExchange::isBlocked(ContinueFuture* future) {
   if (blockingReason_ != BlockingReason::kNotBlocked) {
@@ -248,6 +331,19 @@ BlockingReason LocalExchange::isBlocked(ContinueFuture* future) {
 
 RowVectorPtr LocalExchange::getOutput() {
   RowVectorPtr data;
+  if (coalesceRows_ > 0) {
+    blockingReason_ = queue_->next(&future_, coalesceRows_, batches_);
+    if (blockingReason_ != BlockingReason::kNotBlocked) {
+      return nullptr;
+    }
+    if (!batches_.empty()) {
+      auto lockedStats = stats_.wlock();
+      for (const auto& batch : batches_) {
+        lockedStats->addInputVector(batch->estimateFlatSize(), batch->size());
+      }
+    }
+    return coalesceBatches();
+  }
   blockingReason_ = queue_->next(&future_, pool(), &data);
   if (blockingReason_ != BlockingReason::kNotBlocked) {
     return nullptr;
@@ -259,6 +355,14 @@ RowVectorPtr LocalExchange::getOutput() {
   return data;
 }
 
+RowVectorPtr LocalExchange::coalesceBatches() {
+  // The copy resolves the dictionaries over the input of the producers, so
+  // that only the rows of the partition are copied.
+  auto result = exec::coalesceBatches(outputType_, batches_, pool());
+  batches_.clear();
+  return result;
+}
+
 bool LocalExchange::isFinished() {
   return queue_->isFinished();
 }
@@ -276,12 +380,18 @@ LocalPartition::LocalPartition(
       queues_{
           ctx->task->getLocalExchangeQueues(ctx->splitGroupId, planNode->id())},
       numPartitions_{queues_.size()},
+      scaleWriterState_{
+          planNode->scaleWriter() ? ctx->task->getScaleWriterState(
+                                        ctx->splitGroupId, planNode->id())
+                                  : nullptr},
       partitionFunction_(
-          numPartitions_ == 1
+          numPartitions_ == 1 || scaleWriterState_ != nullptr
               ? nullptr
               : planNode->partitionFunctionSpec().create(numPartitions_)),
       blockingReasons_{numPartitions_} {
-  VELOX_CHECK(numPartitions_ == 1 || partitionFunction_ != nullptr);
+  VELOX_CHECK(
+      numPartitions_ == 1 || scaleWriterState_ != nullptr ||
+      partitionFunction_ != nullptr);
 
   for (auto& queue : queues_) {
     queue->addProducer();
@@ -338,9 +448,12 @@ void LocalPartition::addInput(RowVectorPtr input) {
 
   input_ = std::move(input);
 
-  if (numPartitions_ == 1) {
+  if (numPartitions_ == 1 || scaleWriterState_ != nullptr) {
+    const auto partition = numPartitions_ == 1
+        ? 0
+        : scaleWriterState_->nextWriter(input_->retainedSize());
     ContinueFuture future;
-    auto blockingReason = queues_[0]->enqueue(input_, &future);
+    auto blockingReason = queues_[partition]->enqueue(input_, &future);
     if (blockingReason != BlockingReason::kNotBlocked) {
       blockingReasons_.push_back(blockingReason);
       futures_.push_back(std::move(future));
@@ -393,16 +506,32 @@ BlockingReason LocalPartition::isBlocked(ContinueFuture* future) {
 
 void LocalPartition::noMoreInput() {
   Operator::noMoreInput();
+  if (scaleWriterState_ != nullptr) {
+    auto lockedStats = stats_.wlock();
+    lockedStats->runtimeStats["numActiveWriters"] =
+        RuntimeMetric(scaleWriterState_->numActiveWriters());
+  }
   for (const auto& queue : queues_) {
     queue->noMoreData();
   }
 }
 
 bool LocalPartition::isFinished() {
-  if (!futures_.empty() || !noMoreInput_) {
+  if (!futures_.empty()) {
     return false;
   }
+  if (noMoreInput_) {
+    return true;
+  }
 
+  // Finish early if all consumers are closed, e.g. a downstream Limit has
+  // all its rows. This closes the Driver and with it the upstream operators
+  // of the pipeline, so that a TableScan stops reading its splits.
+  for (const auto& queue : queues_) {
+    if (!queue->isClosed()) {
+      return false;
+    }
+  }
   return true;
 }
 } // namespace facebook::velox::exec
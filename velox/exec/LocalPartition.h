@@ -36,13 +36,63 @@ class LocalExchangeMemoryManager {
   /// caller to fulfill.
   std::vector<ContinuePromise> decreaseMemoryUsage(int64_t removed);
 
+  int64_t bufferedBytes() const {
+    return bufferedBytes_;
+  }
+
+  int64_t maxBufferSize() const {
+    return maxBufferSize_;
+  }
+
  private:
   const int64_t maxBufferSize_;
+  // Updated without 'mutex_' while below the limit, so that producers and
+  // consumers of different queues do not serialize on 'mutex_'.
+  std::atomic<int64_t> bufferedBytes_{0};
+  // True while 'promises_' is not empty. Set under 'mutex_' before the
+  // producer checks 'bufferedBytes_' again, so that a consumer that brings
+  // the usage below the limit sees either this or the producer sees the new
+  // usage.
+  std::atomic<bool> hasPromises_{false};
   std::mutex mutex_;
-  int64_t bufferedBytes_{0};
   std::vector<ContinuePromise> promises_;
 };
 
+/// Shared by the producers of a local exchange that feeds table writers and
+/// scales their number with the amount of data. Inputs go round-robin to the
+/// first numActiveWriters() consumers, starting with one. Another consumer is
+/// activated when the exchange buffers at least half of its memory limit, so
+/// that the active writers do not keep up, and the active writers got at
+/// least 'minProcessedBytes' each since the last activation. Small writes so
+/// make few files while large ones still use all the writers.
+class ScaleWriterState {
+ public:
+  ScaleWriterState(
+      std::shared_ptr<LocalExchangeMemoryManager> memoryManager,
+      int numWriters,
+      int64_t minProcessedBytes)
+      : memoryManager_(std::move(memoryManager)),
+        numWriters_(numWriters),
+        minProcessedBytes_(minProcessedBytes) {}
+
+  /// Returns the consumer for an input of 'inputBytes', activating another
+  /// consumer first if needed.
+  int nextWriter(int64_t inputBytes);
+
+  int numActiveWriters() const {
+    return numActiveWriters_;
+  }
+
+ private:
+  const std::shared_ptr<LocalExchangeMemoryManager> memoryManager_;
+  const int numWriters_;
+  const int64_t minProcessedBytes_;
+  std::atomic<int> numActiveWriters_{1};
+  // Bytes of the inputs sent since the last activation.
+  std::atomic<int64_t> processedBytes_{0};
+  std::atomic<uint64_t> counter_{0};
+};
+
 /// Buffers data for a single partition produced by local exchange. Allows
 /// multiple producers to enqueue data and multiple consumers fetch data. Each
 /// producer must be registered with a call to 'addProducer'. 'noMoreProducers'
@@ -82,6 +132,14 @@ class LocalExchangeQueue {
   BlockingReason
   next(ContinueFuture* future, memory::MemoryPool* pool, RowVectorPtr* data);
 
+  /// Like next() but also appends to 'data' the vectors queued behind the
+  /// first one as long as the total number of rows stays at or below
+  /// 'maxRows'. Does not wait for more vectors after the first one.
+  BlockingReason next(
+      ContinueFuture* future,
+      vector_size_t maxRows,
+      std::vector<RowVectorPtr>& data);
+
   /// Used by producers to get notified when all data has been fetched. Returns
   /// kNotBlocked if all data has been fetched. Otherwise, returns
   /// kWaitForConsumer and sets future that will be competed when all data is
@@ -92,10 +150,19 @@ class LocalExchangeQueue {
 
   bool isFinished();
 
+  /// Returns true if the consumer has closed the queue, e.g. because it got
+  /// all the rows it needed. Producers can stop producing data for it.
+  bool isClosed();
+
   /// Drop remaining data from the queue and notify consumers and producers if
   /// called before all the data has been processed. No-op otherwise.
   void close();
 
+  /// Returns the memory manager shared by the queues of the exchange.
+  const std::shared_ptr<LocalExchangeMemoryManager>& memoryManager() const {
+    return memoryManager_;
+  }
+
  private:
   bool isFinishedLocked(const std::queue<RowVectorPtr>& queue) const;
 
@@ -146,8 +213,16 @@ class LocalExchange : public SourceOperator {
   }
 
  private:
+  // Returns the vectors in 'batches_' combined into one.
+  RowVectorPtr coalesceBatches();
+
   const int partition_;
   const std::shared_ptr<LocalExchangeQueue> queue_{nullptr};
+  // Maximum number of rows in a combined batch if small batches are combined,
+  // 0 otherwise. See QueryConfig::kLocalExchangeCoalesceBatches.
+  const vector_size_t coalesceRows_;
+  // Reusable list of the batches to combine.
+  std::vector<RowVectorPtr> batches_;
   ContinueFuture future_;
   BlockingReason blockingReason_{BlockingReason::kNotBlocked};
 };
@@ -181,11 +256,21 @@ class LocalPartition : public Operator {
 
   void noMoreInput() override;
 
+  /// Returns true after noMoreInput() or when all the queues have been closed
+  /// by their consumers.
   bool isFinished() override;
 
+  /// Returns the memory manager that limits the data buffered in the queues.
+  LocalExchangeMemoryManager* memoryManager() const {
+    return queues_[0]->memoryManager().get();
+  }
+
  private:
   const std::vector<std::shared_ptr<LocalExchangeQueue>> queues_;
   const size_t numPartitions_;
+  // Set if the exchange scales table writers. The inputs then go whole to
+  // the queue it picks instead of being partitioned.
+  const std::shared_ptr<ScaleWriterState> scaleWriterState_;
   std::unique_ptr<core::PartitionFunction> partitionFunction_;
 
   std::vector<BlockingReason> blockingReasons_;
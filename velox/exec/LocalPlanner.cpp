@@ -18,6 +18,7 @@
 #include "velox/exec/ArrowStream.h"
 #include "velox/exec/AssignUniqueId.h"
 #include "velox/exec/CallbackSink.h"
+#include "velox/exec/CoalesceBatches.h"
 #include "velox/exec/CrossJoinBuild.h"
 #include "velox/exec/CrossJoinProbe.h"
 #include "velox/exec/EnforceSingleRow.h"
@@ -32,10 +33,13 @@
 #include "velox/exec/MergeJoin.h"
 #include "velox/exec/OrderBy.h"
 #include "velox/exec/PartitionedOutput.h"
+#include "velox/exec/RangeJoinBuild.h"
+#include "velox/exec/RangeJoinProbe.h"
 #include "velox/exec/StreamingAggregation.h"
 #include "velox/exec/TableScan.h"
 #include "velox/exec/TableWriter.h"
 #include "velox/exec/TopN.h"
+#include "velox/exec/TopNRowNumber.h"
 #include "velox/exec/Unnest.h"
 #include "velox/exec/Values.h"
 #include "velox/exec/Window.h"
@@ -110,6 +114,13 @@ OperatorSupplier makeConsumerSupplier(
     };
   }
 
+  if (auto join =
+          std::dynamic_pointer_cast<const core::RangeJoinNode>(planNode)) {
+    return [join](int32_t operatorId, DriverCtx* ctx) {
+      return std::make_unique<RangeJoinBuild>(operatorId, ctx, join);
+    };
+  }
+
   if (auto join =
           std::dynamic_pointer_cast<const core::MergeJoinNode>(planNode)) {
     auto planNodeId = planNode->id();
@@ -177,6 +188,14 @@ uint32_t maxDrivers(const DriverFactory& driverFactory) {
         // final topN must run single-threaded
         return 1;
       }
+    } else if (
+        auto topNRowNumber =
+            std::dynamic_pointer_cast<const core::TopNRowNumberNode>(node)) {
+      if (topNRowNumber->partitionKeys().empty() &&
+          topNRowNumber->generateRowNumber()) {
+        // Numbering the rows of a single partition must run single-threaded.
+        return 1;
+      }
     } else if (
         auto values = std::dynamic_pointer_cast<const core::ValuesNode>(node)) {
       // values node must run single-threaded, unless in test context
@@ -242,12 +261,13 @@ uint32_t maxDrivers(const DriverFactory& driverFactory) {
 }
 } // namespace detail
 
-// static
-void LocalPlanner::plan(
+namespace {
+// Splits the plan into pipelines and sets the properties that do not depend
+// on the task's driver count.
+void planPipelines(
     const core::PlanFragment& planFragment,
     ConsumerSupplier consumerSupplier,
-    std::vector<std::unique_ptr<DriverFactory>>* driverFactories,
-    uint32_t maxDrivers) {
+    std::vector<std::unique_ptr<DriverFactory>>* driverFactories) {
   detail::plan(
       planFragment.planNode,
       nullptr,
@@ -294,9 +314,17 @@ void LocalPlanner::plan(
     }
   }
 
-  // Determine number of drivers for each pipeline.
   for (auto& factory : *driverFactories) {
     factory->maxDrivers = detail::maxDrivers(*factory);
+  }
+}
+
+void setNumDrivers(
+    const core::PlanFragment& planFragment,
+    std::vector<std::unique_ptr<DriverFactory>>* driverFactories,
+    uint32_t maxDrivers) {
+  // Determine number of drivers for each pipeline.
+  for (auto& factory : *driverFactories) {
     factory->numDrivers = std::min(factory->maxDrivers, maxDrivers);
 
     // Pipelines running grouped/bucketed execution would have separate groups
@@ -311,6 +339,43 @@ void LocalPlanner::plan(
     }
   }
 }
+} // namespace
+
+// static
+void LocalPlanner::plan(
+    const core::PlanFragment& planFragment,
+    ConsumerSupplier consumerSupplier,
+    std::vector<std::unique_ptr<DriverFactory>>* driverFactories,
+    uint32_t maxDrivers) {
+  planPipelines(planFragment, consumerSupplier, driverFactories);
+  setNumDrivers(planFragment, driverFactories, maxDrivers);
+}
+
+// static
+std::shared_ptr<const PlannedFragment> PlannedFragment::create(
+    core::PlanFragment planFragment) {
+  return std::make_shared<const PlannedFragment>(std::move(planFragment));
+}
+
+PlannedFragment::PlannedFragment(core::PlanFragment planFragment)
+    : planFragment_(std::move(planFragment)) {
+  VELOX_CHECK_NOT_NULL(planFragment_.planNode);
+  planPipelines(planFragment_, nullptr, &driverFactories_);
+}
+
+void PlannedFragment::instantiate(
+    ConsumerSupplier consumerSupplier,
+    std::vector<std::unique_ptr<DriverFactory>>* driverFactories,
+    uint32_t maxDrivers) const {
+  VELOX_CHECK(driverFactories->empty());
+  driverFactories->reserve(driverFactories_.size());
+  for (const auto& factory : driverFactories_) {
+    driverFactories->push_back(std::make_unique<DriverFactory>(*factory));
+  }
+  driverFactories->front()->consumerSupplier =
+      detail::makeConsumerSupplier(consumerSupplier);
+  setNumDrivers(planFragment_, driverFactories, maxDrivers);
+}
 
 std::shared_ptr<Driver> DriverFactory::createDriver(
     std::unique_ptr<DriverCtx> ctx,
@@ -319,6 +384,15 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
   std::vector<std::unique_ptr<Operator>> operators;
   operators.reserve(planNodes.size());
 
+  // Adds a CoalesceBatches after an operator that may produce small batches.
+  const bool coalesceSmallBatches = ctx->queryConfig().coalesceSmallBatches();
+  auto addCoalesceBatches = [&](const core::PlanNodePtr& planNode) {
+    if (coalesceSmallBatches) {
+      operators.push_back(std::make_unique<CoalesceBatches>(
+          operators.size(), ctx.get(), planNode->outputType()));
+    }
+  };
+
   for (int32_t i = 0; i < planNodes.size(); i++) {
     // Id of the Operator being made. This is not the same as 'i'
     // because some PlanNodes may get fused.
@@ -332,12 +406,14 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
                 std::dynamic_pointer_cast<const core::ProjectNode>(next)) {
           operators.push_back(std::make_unique<FilterProject>(
               id, ctx.get(), filterNode, projectNode));
+          addCoalesceBatches(projectNode);
           i++;
           continue;
         }
       }
       operators.push_back(
           std::make_unique<FilterProject>(id, ctx.get(), filterNode, nullptr));
+      addCoalesceBatches(filterNode);
     } else if (
         auto projectNode =
             std::dynamic_pointer_cast<const core::ProjectNode>(planNode)) {
@@ -385,11 +461,17 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
         auto joinNode =
             std::dynamic_pointer_cast<const core::HashJoinNode>(planNode)) {
       operators.push_back(std::make_unique<HashProbe>(id, ctx.get(), joinNode));
+      addCoalesceBatches(joinNode);
     } else if (
         auto joinNode =
             std::dynamic_pointer_cast<const core::CrossJoinNode>(planNode)) {
       operators.push_back(
           std::make_unique<CrossJoinProbe>(id, ctx.get(), joinNode));
+    } else if (
+        auto joinNode =
+            std::dynamic_pointer_cast<const core::RangeJoinNode>(planNode)) {
+      operators.push_back(
+          std::make_unique<RangeJoinProbe>(id, ctx.get(), joinNode));
     } else if (
         auto aggregationNode =
             std::dynamic_pointer_cast<const core::AggregationNode>(planNode)) {
@@ -411,6 +493,12 @@ std::shared_ptr<Driver> DriverFactory::createDriver(
         auto topNNode =
             std::dynamic_pointer_cast<const core::TopNNode>(planNode)) {
       operators.push_back(std::make_unique<TopN>(id, ctx.get(), topNNode));
+    } else if (
+        auto topNRowNumberNode =
+            std::dynamic_pointer_cast<const core::TopNRowNumberNode>(
+                planNode)) {
+      operators.push_back(
+          std::make_unique<TopNRowNumber>(id, ctx.get(), topNRowNumberNode));
     } else if (
         auto limitNode =
             std::dynamic_pointer_cast<const core::LimitNode>(planNode)) {
@@ -15,12 +15,9 @@
  */
 #pragma once
 
+#include "velox/core/PlanFragment.h"
 #include "velox/exec/Operator.h"
 
-namespace facebook::velox::core {
-struct PlanFragment;
-} // namespace facebook::velox::core
-
 namespace facebook::velox::exec {
 
 class LocalPlanner {
@@ -31,4 +28,35 @@ class LocalPlanner {
       std::vector<std::unique_ptr<DriverFactory>>* driverFactories,
       uint32_t maxDrivers);
 };
+
+/// A plan fragment split into pipelines once and shared by all tasks that run
+/// it, e.g. a streaming query that runs the same fragment for each
+/// micro-batch. Tasks created from a PlannedFragment copy its pipelines
+/// instead of running the LocalPlanner. Each task still has its own drivers,
+/// operators, memory pools and splits. Immutable and thread-safe.
+class PlannedFragment {
+ public:
+  static std::shared_ptr<const PlannedFragment> create(
+      core::PlanFragment planFragment);
+
+  explicit PlannedFragment(core::PlanFragment planFragment);
+
+  const core::PlanFragment& planFragment() const {
+    return planFragment_;
+  }
+
+  /// Fills 'driverFactories' with copies of the planned pipelines, as
+  /// LocalPlanner::plan() would for the same arguments.
+  void instantiate(
+      ConsumerSupplier consumerSupplier,
+      std::vector<std::unique_ptr<DriverFactory>>* driverFactories,
+      uint32_t maxDrivers) const;
+
+ private:
+  const core::PlanFragment planFragment_;
+
+  // Pipelines with 'maxDrivers' and 'groupedExecution' set and without a
+  // consumer for the output pipeline.
+  std::vector<std::unique_ptr<DriverFactory>> driverFactories_;
+};
 } // namespace facebook::velox::exec
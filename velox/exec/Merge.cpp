@@ -145,13 +145,18 @@ RowVectorPtr Merge::getOutput() {
       return std::move(output_);
     }
 
-    if (stream->setOutputRow(outputSize_)) {
+    // Take all the rows of 'stream' that precede the first row of the next
+    // best stream at once. Sorted inputs often come in long runs, e.g. when
+    // the sources cover disjoint key ranges.
+    const auto numRows = stream->runLength(
+        treeOfLosers_->runnerUp(), outputBatchSize_ - outputSize_);
+    if (stream->setOutputRows(outputSize_, numRows)) {
       // The stream is at end of input batch. Need to copy out the rows before
       // fetching next batch in 'pop'.
       stream->copyToOutput(output_);
     }
 
-    ++outputSize_;
+    outputSize_ += numRows;
 
     // Advance the stream.
     stream->pop(sourceBlockingFutures_);
@@ -179,7 +184,13 @@ void Merge::close() {
 }
 
 bool SourceStream::operator<(const MergeStream& other) const {
-  const auto& otherCursor = static_cast<const SourceStream&>(other);
+  return compareRow(
+             currentSourceRow_, static_cast<const SourceStream&>(other)) < 0;
+}
+
+int32_t SourceStream::compareRow(
+    vector_size_t row,
+    const SourceStream& otherCursor) const {
   for (auto i = 0; i < sortingKeys_.size(); ++i) {
     const auto& [_, compareFlags] = sortingKeys_[i];
     VELOX_DCHECK(
@@ -188,14 +199,46 @@ bool SourceStream::operator<(const MergeStream& other) const {
     if (auto result = keyColumns_[i]
                           ->compare(
                               otherCursor.keyColumns_[i],
-                              currentSourceRow_,
+                              row,
                               otherCursor.currentSourceRow_,
                               compareFlags)
                           .value()) {
-      return result < 0;
+      return result;
     }
   }
-  return false;
+  return 0;
+}
+
+vector_size_t SourceStream::runLength(
+    const SourceStream* other,
+    vector_size_t maxRows) const {
+  const auto limit =
+      std::min<vector_size_t>(maxRows, data_->size() - currentSourceRow_);
+  if (other == nullptr || limit <= 1) {
+    return std::max<vector_size_t>(limit, 1);
+  }
+  auto inRun = [&](vector_size_t offset) {
+    return compareRow(currentSourceRow_ + offset, *other) <= 0;
+  };
+  // The current row is in the run. Double the step until a row past the run
+  // is found, then binary search between the last row known to be in the run
+  // and that row.
+  vector_size_t last = 0;
+  vector_size_t step = 1;
+  while (last + step < limit && inRun(last + step)) {
+    last += step;
+    step *= 2;
+  }
+  auto end = std::min<vector_size_t>(last + step, limit);
+  while (end - last > 1) {
+    const auto middle = last + (end - last) / 2;
+    if (inRun(middle)) {
+      last = middle;
+    } else {
+      end = middle;
+    }
+  }
+  return last + 1;
 }
 
 bool SourceStream::pop(std::vector<ContinueFuture>& futures) {
@@ -296,7 +339,8 @@ MergeExchange::MergeExchange(
           mergeExchangeNode->sortingKeys(),
           mergeExchangeNode->sortingOrders(),
           mergeExchangeNode->id(),
-          "MergeExchange") {}
+          "MergeExchange"),
+      serdeOptions_(makeExchangeSerdeOptions(driverCtx->queryConfig())) {}
 
 BlockingReason MergeExchange::addMergeSources(ContinueFuture* future) {
   if (operatorCtx_->driverCtx()->driverId != 0) {
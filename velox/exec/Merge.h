@@ -112,6 +112,15 @@ class SourceStream final : public MergeStream {
   /// 'other'.
   bool operator<(const MergeStream& other) const override;
 
+  /// Returns the number of consecutive rows starting at the current row that
+  /// are not greater than the current row of 'other' and can be taken
+  /// without consulting the merge tree. The result is at least 1 and at most
+  /// 'maxRows' and does not extend past the current batch. 'other' is
+  /// nullptr if no other stream has data. Uses galloping search, so a run of
+  /// n rows takes O(log(n)) comparisons.
+  vector_size_t runLength(const SourceStream* other, vector_size_t maxRows)
+      const;
+
   /// Advances to the next row. Returns true and appends a future to 'futures'
   /// if runs out of rows in the current batch and needs to wait for the
   /// source to produce the next batch. The return flag has the meaning of
@@ -128,6 +137,16 @@ class SourceStream final : public MergeStream {
     return currentSourceRow_ == data_->size() - 1;
   }
 
+  /// Records output rows [row, row + count) for the current row and the
+  /// 'count' - 1 rows after it and makes the last of these the current row.
+  /// 'count' is typically the result of runLength(). Has the same contract
+  /// as setOutputRow() otherwise.
+  bool setOutputRows(vector_size_t row, vector_size_t count) {
+    outputRows_.setValidRange(row, row + count, true);
+    currentSourceRow_ += count - 1;
+    return currentSourceRow_ == data_->size() - 1;
+  }
+
   /// Called if either current row is the last row in the current batch or the
   /// caller accumulated enough output rows across all sources to produce an
   /// output batch.
@@ -136,6 +155,9 @@ class SourceStream final : public MergeStream {
  private:
   bool fetchMoreData(std::vector<ContinueFuture>& futures);
 
+  // Compares row 'row' of 'this' with the current row of 'other'.
+  int32_t compareRow(vector_size_t row, const SourceStream& other) const;
+
   MergeSource* source_;
 
   const std::vector<std::pair<column_index_t, CompareFlags>>& sortingKeys_;
@@ -191,10 +213,17 @@ class MergeExchange : public Merge {
       DriverCtx* driverCtx,
       const std::shared_ptr<const core::MergeExchangeNode>& orderByNode);
 
+  /// Returns the options to decompress the received pages, or null if the
+  /// pages are not compressed.
+  const VectorSerde::Options* serdeOptions() const {
+    return serdeOptions_.get();
+  }
+
  protected:
   BlockingReason addMergeSources(ContinueFuture* future) override;
 
  private:
+  const std::unique_ptr<VectorSerde::Options> serdeOptions_;
   bool noMoreSplits_ = false;
   size_t numSplits_{0}; // Number of splits we took to process so far.
 };
@@ -156,6 +156,77 @@ int32_t MergeJoin::compare(
   return 0;
 }
 
+namespace {
+// Returns the first row in [begin, end) for which 'predicate' is false. The
+// rows for which 'predicate' is true must form a prefix of the range. Probes
+// rows at exponentially growing distances from 'begin' and then binary
+// searches the last step, so finding a prefix of n rows takes O(log(n))
+// calls to 'predicate'.
+template <typename TPredicate>
+vector_size_t gallop(
+    vector_size_t begin,
+    vector_size_t end,
+    TPredicate predicate) {
+  // Rows in [begin, low) satisfy 'predicate'.
+  vector_size_t low = begin;
+  vector_size_t high = end;
+  for (vector_size_t step = 1;; step *= 2) {
+    const auto probe = low + step - 1;
+    if (probe >= end) {
+      break;
+    }
+    if (!predicate(probe)) {
+      high = probe;
+      break;
+    }
+    low = probe + 1;
+  }
+  while (low < high) {
+    const auto middle = low + (high - low) / 2;
+    if (predicate(middle)) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+bool keysMayHaveNulls(
+    const RowVectorPtr& batch,
+    const std::vector<column_index_t>& keys) {
+  for (auto key : keys) {
+    if (batch->childAt(key)->mayHaveNulls()) {
+      return true;
+    }
+  }
+  return false;
+}
+} // namespace
+
+vector_size_t MergeJoin::skipLeft() const {
+  if (keysMayHaveNulls(input_, leftKeys_)) {
+    // Rows with null keys may be placed anywhere and break the ordering
+    // 'compare' relies on for the search. Advance one row at a time.
+    return index_ + 1;
+  }
+  return gallop(index_ + 1, input_->size(), [&](auto row) {
+    return compare(
+               leftKeys_, input_, row, rightKeys_, rightInput_, rightIndex_) <
+        0;
+  });
+}
+
+vector_size_t MergeJoin::skipRight() const {
+  if (keysMayHaveNulls(rightInput_, rightKeys_)) {
+    return rightIndex_ + 1;
+  }
+  return gallop(rightIndex_ + 1, rightInput_->size(), [&](auto row) {
+    return compare(
+               leftKeys_, input_, index_, rightKeys_, rightInput_, row) > 0;
+  });
+}
+
 bool MergeJoin::findEndOfMatch(
     Match& match,
     const RowVectorPtr& input,
@@ -169,11 +240,9 @@ bool MergeJoin::findEndOfMatch(
 
   auto numInput = input->size();
 
-  vector_size_t endIndex = 0;
-  while (endIndex < numInput &&
-         compare(keys, input, endIndex, keys, prevInput, prevIndex) == 0) {
-    ++endIndex;
-  }
+  const auto endIndex = gallop(0, numInput, [&](auto row) {
+    return compare(keys, input, row, keys, prevInput, prevIndex) == 0;
+  });
 
   if (endIndex == numInput) {
     // Inputs are kept past getting a new batch of inputs. LazyVectors
@@ -206,6 +275,38 @@ void copyRow(
     targetChild->copy(sourceChild.get(), targetIndex, sourceIndex, 1);
   }
 }
+
+// Copies 'count' consecutive rows of 'source' starting at 'sourceIndex' to
+// 'target' starting at 'targetIndex'. If 'repeat' is true, copies row
+// 'sourceIndex' 'count' times instead. 'ranges' is reusable memory.
+void copyRows(
+    const RowVectorPtr& source,
+    vector_size_t sourceIndex,
+    vector_size_t count,
+    bool repeat,
+    const RowVectorPtr& target,
+    vector_size_t targetIndex,
+    const std::vector<IdentityProjection>& projections,
+    std::vector<BaseVector::CopyRange>& ranges) {
+  if (!repeat || count == 1) {
+    for (const auto& projection : projections) {
+      const auto& sourceChild = source->childAt(projection.inputChannel);
+      const auto& targetChild = target->childAt(projection.outputChannel);
+      targetChild->copy(sourceChild.get(), targetIndex, sourceIndex, count);
+    }
+    return;
+  }
+  ranges.resize(count);
+  for (auto i = 0; i < count; ++i) {
+    ranges[i] = {sourceIndex, targetIndex + i, 1};
+  }
+  for (const auto& projection : projections) {
+    const auto& sourceChild = source->childAt(projection.inputChannel);
+    const auto& targetChild = target->childAt(projection.outputChannel);
+    targetChild->copyRanges(
+        sourceChild.get(), folly::Range(ranges.data(), ranges.size()));
+  }
+}
 } // namespace
 
 void MergeJoin::addOutputRowForLeftJoin(
@@ -226,27 +327,61 @@ void MergeJoin::addOutputRowForLeftJoin(
   ++outputSize_;
 }
 
-void MergeJoin::addOutputRow(
+void MergeJoin::addOutputRows(
     const RowVectorPtr& left,
     vector_size_t leftIndex,
     const RowVectorPtr& right,
-    vector_size_t rightIndex) {
-  copyRow(left, leftIndex, output_, outputSize_, leftProjections_);
-  copyRow(right, rightIndex, output_, outputSize_, rightProjections_);
+    vector_size_t rightIndex,
+    vector_size_t count,
+    bool repeatLeft) {
+  copyRows(
+      left,
+      leftIndex,
+      count,
+      repeatLeft,
+      output_,
+      outputSize_,
+      leftProjections_,
+      copyRanges_);
+  copyRows(
+      right,
+      rightIndex,
+      count,
+      !repeatLeft,
+      output_,
+      outputSize_,
+      rightProjections_,
+      copyRanges_);
 
   if (filter_) {
-    // TODO Re-use output_ columns when possible.
-
-    copyRow(left, leftIndex, filterInput_, outputSize_, filterLeftInputs_);
-    copyRow(right, rightIndex, filterInput_, outputSize_, filterRightInputs_);
+    copyRows(
+        left,
+        leftIndex,
+        count,
+        repeatLeft,
+        filterInput_,
+        outputSize_,
+        filterLeftInputs_,
+        copyRanges_);
+    copyRows(
+        right,
+        rightIndex,
+        count,
+        !repeatLeft,
+        filterInput_,
+        outputSize_,
+        filterRightInputs_,
+        copyRanges_);
 
     if (leftJoinTracker_) {
-      // Record left-side row with a match on the right-side.
-      leftJoinTracker_->addMatch(left, leftIndex, outputSize_);
+      for (auto i = 0; i < count; ++i) {
+        leftJoinTracker_->addMatch(
+            left, repeatLeft ? leftIndex : leftIndex + i, outputSize_ + i);
+      }
     }
   }
 
-  ++outputSize_;
+  outputSize_ += count;
 }
 
 void MergeJoin::prepareOutput() {
@@ -313,6 +448,36 @@ bool MergeJoin::addToOutput() {
   }
 
   size_t numLefts = leftMatch_->inputs.size();
+  if (rightMatch_->inputs.size() == 1 &&
+      rightMatch_->endIndex - rightMatch_->startIndex == 1) {
+    // A single row on the right. Add runs of consecutive left rows paired
+    // with that row.
+    const auto& right = rightMatch_->inputs[0];
+    const auto rightIndex = rightMatch_->startIndex;
+    for (size_t l = firstLeftBatch; l < numLefts; ++l) {
+      auto left = leftMatch_->inputs[l];
+      auto leftStart = l == firstLeftBatch ? leftStartIndex : 0;
+      auto leftEnd = l == numLefts - 1 ? leftMatch_->endIndex : left->size();
+
+      for (auto i = leftStart; i < leftEnd;) {
+        if (outputSize_ == outputBatchSize_) {
+          leftMatch_->setCursor(l, i);
+          rightMatch_->setCursor(0, rightIndex);
+          return true;
+        }
+        const auto count = std::min<vector_size_t>(
+            leftEnd - i, outputBatchSize_ - outputSize_);
+        addOutputRows(left, i, right, rightIndex, count, false);
+        i += count;
+      }
+    }
+
+    leftMatch_.reset();
+    rightMatch_.reset();
+
+    return outputSize_ == outputBatchSize_;
+  }
+
   for (size_t l = firstLeftBatch; l < numLefts; ++l) {
     auto left = leftMatch_->inputs[l];
     auto leftStart = l == firstLeftBatch ? leftStartIndex : 0;
@@ -336,13 +501,17 @@ bool MergeJoin::addToOutput() {
         auto rightEnd =
             r == numRights - 1 ? rightMatch_->endIndex : right->size();
 
-        for (auto j = rightStart; j < rightEnd; ++j) {
+        // Pair the left row with runs of consecutive right rows.
+        for (auto j = rightStart; j < rightEnd;) {
           if (outputSize_ == outputBatchSize_) {
             leftMatch_->setCursor(l, i);
             rightMatch_->setCursor(r, j);
             return true;
           }
-          addOutputRow(left, i, right, j);
+          const auto count = std::min<vector_size_t>(
+              rightEnd - j, outputBatchSize_ - outputSize_);
+          addOutputRows(left, i, right, j, count, true);
+          j += count;
         }
       }
     }
@@ -553,7 +722,9 @@ RowVectorPtr MergeJoin::doGetOutput() {
         addOutputRowForLeftJoin(input_, index_);
       }
 
-      ++index_;
+      // Left rows without a match are not needed for inner joins and can be
+      // skipped in bulk.
+      index_ = isLeftJoin(joinType_) ? index_ + 1 : skipLeft();
       if (index_ == input_->size()) {
         // Ran out of rows on the left side.
         input_ = nullptr;
@@ -564,7 +735,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
 
     // Catch up rightInput_ with input_.
     while (compareResult > 0) {
-      rightIndex_ = firstNonNull(rightInput_, rightKeys_, rightIndex_ + 1);
+      rightIndex_ = firstNonNull(rightInput_, rightKeys_, skipRight());
       if (rightIndex_ == rightInput_->size()) {
         // Ran out of rows on the right side.
         rightInput_ = nullptr;
@@ -576,10 +747,9 @@ RowVectorPtr MergeJoin::doGetOutput() {
     if (compareResult == 0) {
       // Found a match. Identify all rows on the left and right that have the
       // matching keys.
-      vector_size_t endIndex = index_ + 1;
-      while (endIndex < input_->size() && compareLeft(endIndex) == 0) {
-        ++endIndex;
-      }
+      const auto endIndex = gallop(index_ + 1, input_->size(), [&](auto row) {
+        return compareLeft(row) == 0;
+      });
 
       if (endIndex == input_->size()) {
         // Matches continue in subsequent input. Load all lazies.
@@ -588,11 +758,10 @@ RowVectorPtr MergeJoin::doGetOutput() {
       leftMatch_ = Match{
           {input_}, index_, endIndex, endIndex < input_->size(), std::nullopt};
 
-      vector_size_t endRightIndex = rightIndex_ + 1;
-      while (endRightIndex < rightInput_->size() &&
-             compareRight(endRightIndex) == 0) {
-        ++endRightIndex;
-      }
+      const auto endRightIndex =
+          gallop(rightIndex_ + 1, rightInput_->size(), [&](auto row) {
+            return compareRight(row) == 0;
+          });
 
       rightMatch_ = Match{
           {rightInput_},
@@ -147,6 +147,18 @@ class MergeJoin : public Operator {
       const RowVectorPtr& input,
       const std::vector<column_index_t>& keys);
 
+  /// Returns the first row of 'input_' after 'index_' that is not less than
+  /// row 'rightIndex_' of 'rightInput_', or the size of 'input_' if there is
+  /// none. Uses galloping search over the sorted keys, so skipping n rows
+  /// takes O(log(n)) comparisons. Returns 'index_' + 1 if the keys may have
+  /// nulls.
+  vector_size_t skipLeft() const;
+
+  /// Same as skipLeft() for the right side: returns the first row of
+  /// 'rightInput_' after 'rightIndex_' that is not less than row 'index_' of
+  /// 'input_'.
+  vector_size_t skipRight() const;
+
   /// Initialize 'output_' vector using 'ouputType_' and 'outputBatchSize_' if
   /// it is null.
   void prepareOutput();
@@ -160,18 +172,19 @@ class MergeJoin : public Operator {
   // rightMatchCursor_ if output_ filled up before all rows were added.
   bool addToOutput();
 
-  // Adds one row of output by copying values from left and right batches at the
-  // specified rows. Advances outputSize_. Assumes that output_ has room.
-  //
-  // TODO: Copying is inefficient especially for complex type values. Consider
-  // an optimization of using dictionary wrapping when full batch of output can
-  // be produced using single batch of input from the left side and single batch
-  // of input from the right side.
-  void addOutputRow(
+  // Adds 'count' rows of output by copying values from left and right
+  // batches. If 'repeatLeft' is true, pairs row 'leftIndex' of 'left' with
+  // 'count' consecutive rows of 'right' starting at 'rightIndex'. Otherwise,
+  // pairs 'count' consecutive rows of 'left' starting at 'leftIndex' with row
+  // 'rightIndex' of 'right'. Copies each run with a single call per column.
+  // Advances outputSize_. Assumes that output_ has room for 'count' rows.
+  void addOutputRows(
       const RowVectorPtr& left,
       vector_size_t leftIndex,
       const RowVectorPtr& right,
-      vector_size_t rightIndex);
+      vector_size_t rightIndex,
+      vector_size_t count,
+      bool repeatLeft);
 
   /// Adds one row of output for a left-side row with no right-side match.
   /// Copies values from the 'leftIndex' row of 'left' and fills in nulls
@@ -367,6 +380,9 @@ class MergeJoin : public Operator {
   std::vector<VectorPtr> filterResult_;
   DecodedVector decodedFilterResult_;
 
+  /// Reusable memory for copying repeated rows to the output.
+  std::vector<BaseVector::CopyRange> copyRanges_;
+
   /// An instance of MergeJoinSource to pull batches of right side input from.
   std::shared_ptr<MergeJoinSource> rightSource_;
 
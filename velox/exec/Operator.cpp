@@ -20,6 +20,7 @@
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
 #include "velox/expression/Expr.h"
+#include "velox/serializers/PrestoSerializer.h"
 
 namespace facebook::velox::exec {
 namespace {
@@ -80,6 +81,7 @@ core::ExecCtx* OperatorCtx::execCtx() const {
   if (!execCtx_) {
     execCtx_ = std::make_unique<core::ExecCtx>(
         pool_, driverCtx_->task->queryCtx().get());
+    execCtx_->setVectorFunctionCache(driverCtx_->task->vectorFunctionCache());
   }
   return execCtx_.get();
 }
@@ -116,6 +118,20 @@ std::optional<Spiller::Config> OperatorCtx::makeSpillConfig(
   if (driverCtx_->task->spillDirectory().empty()) {
     return std::nullopt;
   }
+  SpillWriteCallback writeCallback;
+  if (const auto maxSpillBytes = queryConfig.maxSpillBytes();
+      maxSpillBytes > 0) {
+    writeCallback = [queryCtx = driverCtx_->task->queryCtx(),
+                     maxSpillBytes](uint64_t bytes) {
+      const auto spilledBytes = queryCtx->addSpilledBytes(bytes);
+      if (spilledBytes > maxSpillBytes) {
+        VELOX_USER_FAIL(
+            "Query exceeded its spill limit of {}: {} spilled",
+            succinctBytes(maxSpillBytes),
+            succinctBytes(spilledBytes));
+      }
+    };
+  }
   return Spiller::Config(
       makeOperatorSpillPath(
           driverCtx_->task->spillDirectory(),
@@ -131,7 +147,10 @@ std::optional<Spiller::Config> OperatorCtx::makeSpillConfig(
           queryConfig.spillStartPartitionBit() +
               queryConfig.spillPartitionBits()),
       queryConfig.maxSpillLevel(),
-      queryConfig.testingSpillPct());
+      queryConfig.testingSpillPct(),
+      serializer::presto::PrestoVectorSerde::compressionKindFromName(
+          queryConfig.spillCompressionCodec()),
+      std::move(writeCallback));
 }
 
 Operator::Operator(
@@ -145,6 +164,11 @@ Operator::Operator(
           planNodeId,
           operatorId,
           operatorType)),
+      threadTag_{
+          driverCtx->task ? driverCtx->task->queryCtx()->queryId() : "",
+          driverCtx->task ? driverCtx->task->taskId() : "",
+          planNodeId,
+          operatorType},
       stats_(OperatorStats{
           operatorId,
           driverCtx->pipelineId,
@@ -307,6 +331,54 @@ void Operator::recordBlockingTime(uint64_t start, BlockingReason reason) {
       statName, RuntimeCounter(wallNanos, RuntimeCounter::Unit::kNanos));
 }
 
+int64_t Operator::reclaimableBytes() const {
+  if (!canReclaim()) {
+    return 0;
+  }
+  const auto& tracker = operatorCtx_->pool()->getMemoryUsageTracker();
+  return tracker != nullptr ? tracker->reservedBytes() : 0;
+}
+
+std::vector<std::pair<std::string, int64_t>> Operator::memoryComponents()
+    const {
+  auto components = memoryComponents_.rlock();
+  return {components->begin(), components->end()};
+}
+
+Operator::ReservationResult Operator::reserveMemoryAsync(
+    uint64_t bytes,
+    ContinueFuture& future) {
+  if (asyncReservation_ != nullptr) {
+    VELOX_CHECK(
+        asyncReservation_->done, "Memory reservation is still in progress");
+    const bool reserved = asyncReservation_->reserved;
+    asyncReservation_.reset();
+    return reserved ? ReservationResult::kReserved
+                    : ReservationResult::kFailed;
+  }
+  std::shared_ptr<memory::MemoryUsageTracker> tracker =
+      pool()->getMemoryUsageTracker();
+  if (tracker->tryReserve(bytes)) {
+    return ReservationResult::kReserved;
+  }
+  asyncReservation_ = std::make_shared<AsyncReservation>();
+  ContinuePromise promise(fmt::format(
+      "Operator::reserveMemoryAsync {}/{}",
+      operatorCtx_->taskId(),
+      operatorId()));
+  future = promise.getSemiFuture();
+  operatorCtx_->task()->queryCtx()->executor()->add(
+      [tracker = std::move(tracker),
+       reservation = asyncReservation_,
+       promise = std::move(promise),
+       bytes]() mutable {
+        reservation->reserved = tracker->maybeReserve(bytes);
+        reservation->done = true;
+        promise.setValue();
+      });
+  return ReservationResult::kPending;
+}
+
 std::string Operator::toString() const {
   std::stringstream out;
   if (auto task = operatorCtx_->task()) {
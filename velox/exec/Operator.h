@@ -16,6 +16,7 @@
 #pragma once
 #include <folly/Synchronized.h>
 #include "velox/common/base/RuntimeMetrics.h"
+#include "velox/common/process/ThreadTag.h"
 #include "velox/common/time/CpuWallTimer.h"
 #include "velox/core/PlanNode.h"
 #include "velox/exec/Driver.h"
@@ -387,6 +388,26 @@ class Operator : public BaseRuntimeStatWriter {
     }
   }
 
+  // Returns true if 'this' can free its memory on request by spilling its
+  // state to disk. The memory arbitrator picks such operators as victims to
+  // grow the memory capacity of other queries.
+  virtual bool canReclaim() const {
+    return false;
+  }
+
+  // Returns an estimate of the memory in bytes that reclaim() can free.
+  virtual int64_t reclaimableBytes() const;
+
+  // Returns the named parts of the memory of 'this', e.g. the hash table and
+  // the rows of a hash build, as last reported by setMemoryComponent(). May
+  // be called from any thread while 'this' is running.
+  std::vector<std::pair<std::string, int64_t>> memoryComponents() const;
+
+  // Spills the state of 'this' to free at least 'targetBytes' of memory if
+  // possible. Called only if canReclaim() returns true and while the Task of
+  // 'this' is paused, so that no other method of 'this' runs concurrently.
+  virtual void reclaim(uint64_t /*targetBytes*/) {}
+
   // Returns true if 'this' never has more output rows than input rows.
   virtual bool isFilter() const {
     return false;
@@ -396,6 +417,16 @@ class Operator : public BaseRuntimeStatWriter {
     return false;
   }
 
+  // Returns true if an aggregation downstream of 'this' may push down into
+  // the unloaded LazyVectors that 'this' passes through from its input,
+  // possibly wrapped in dictionaries. This requires the output rows made from
+  // an input batch to be in the order of the input rows. If an input row may
+  // repeat in the output, the aggregation detects this and loads the
+  // LazyVector instead.
+  virtual bool mayPassThroughLazyVectors() const {
+    return isFilter() && preservesOrder();
+  }
+
   /// Returns copy of operator stats. If 'clear' is true, the function also
   /// clears the operator stats after retrieval.
   OperatorStats stats(bool clear);
@@ -433,6 +464,12 @@ class Operator : public BaseRuntimeStatWriter {
     return operatorCtx_->operatorType();
   }
 
+  /// The query, task, plan node and operator type of 'this'. Set as the tag of
+  /// the Driver thread while it calls into 'this'.
+  const process::ThreadTag& threadTag() const {
+    return threadTag_;
+  }
+
   // Registers 'translator' for mapping user defined PlanNode subclass instances
   // to user-defined Operators.
   static void registerOperator(std::unique_ptr<PlanNodeTranslator> translator);
@@ -476,8 +513,45 @@ class Operator : public BaseRuntimeStatWriter {
   // 'identityProjections_' and 'resultProjections_'.
   RowVectorPtr fillOutput(vector_size_t size, BufferPtr mapping);
 
+  // The outcome of reserveMemoryAsync().
+  enum class ReservationResult {
+    // The memory is reserved.
+    kReserved,
+    // The reservation is in progress. The operator should return
+    // BlockingReason::kWaitForMemory with the future and call
+    // reserveMemoryAsync() again when the future is realized.
+    kPending,
+    // The memory could not be reserved. The operator should spill.
+    kFailed,
+  };
+
+  // Increments the memory reservation of the pool of 'this' by 'bytes'. If
+  // the increment fits the current memory capacity of the query, reserves
+  // right away. Otherwise starts the reservation on the query executor, where
+  // it may wait for the memory arbitrator to grow the capacity by reclaiming
+  // memory from other operators, and sets 'future' to be realized when done.
+  // This keeps the Driver off thread while the memory is freed. The first call
+  // after the future is realized returns the outcome of that reservation.
+  ReservationResult reserveMemoryAsync(uint64_t bytes, ContinueFuture& future);
+
+  // Records that 'bytes' of the memory of 'this' are used by 'component'.
+  // Reported by memoryComponents() and in the memory profile of the Task.
+  void setMemoryComponent(const std::string& component, int64_t bytes) {
+    (*memoryComponents_.wlock())[component] = bytes;
+  }
+
   std::unique_ptr<OperatorCtx> operatorCtx_;
+  const process::ThreadTag threadTag_;
   folly::Synchronized<OperatorStats> stats_;
+  folly::Synchronized<std::map<std::string, int64_t>> memoryComponents_;
+
+  // The state of the reservation started by reserveMemoryAsync(). Shared with
+  // the executor thread that makes the reservation.
+  struct AsyncReservation {
+    std::atomic<bool> done{false};
+    std::atomic<bool> reserved{false};
+  };
+  std::shared_ptr<AsyncReservation> asyncReservation_;
   const RowTypePtr outputType_;
 
   // Holds the last data from addInput until it is processed. Reset after the
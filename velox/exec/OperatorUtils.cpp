@@ -17,6 +17,7 @@
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/VectorHasher.h"
 #include "velox/expression/EvalCtx.h"
+#include "velox/serializers/PrestoSerializer.h"
 #include "velox/vector/ConstantVector.h"
 #include "velox/vector/FlatVector.h"
 
@@ -85,12 +86,20 @@ void complexGatherCopy(
     const std::vector<const RowVector*>& sources,
     const std::vector<vector_size_t>& sourceIndices,
     column_index_t sourceChannel) {
-  for (int i = 0; i < count; ++i) {
-    target->copy(
-        sources[i]->childAt(sourceChannel).get(),
-        targetIndex + i,
-        sourceIndices[i],
-        1);
+  // Gathers each run of rows from the same source with one call, so that
+  // nested children are copied in bulk.
+  vector_size_t begin = 0;
+  while (begin < count) {
+    vector_size_t end = begin + 1;
+    while (end < count && sources[end] == sources[begin]) {
+      ++end;
+    }
+    target->gather(
+        sources[begin]->childAt(sourceChannel).get(),
+        targetIndex + begin,
+        &sourceIndices[begin],
+        end - begin);
+    begin = end;
   }
 }
 
@@ -335,6 +344,28 @@ void gatherCopy(
   }
 }
 
+RowVectorPtr coalesceBatches(
+    const RowTypePtr& rowType,
+    const std::vector<RowVectorPtr>& batches,
+    memory::MemoryPool* pool) {
+  if (batches.size() <= 1) {
+    return batches.empty() ? nullptr : batches[0];
+  }
+  vector_size_t numRows = 0;
+  for (const auto& batch : batches) {
+    numRows += batch->size();
+  }
+  // The copy resolves the dictionaries of the batches, so that only their
+  // rows are copied.
+  auto result = BaseVector::create<RowVector>(rowType, numRows, pool);
+  vector_size_t offset = 0;
+  for (const auto& batch : batches) {
+    result->copy(batch.get(), offset, 0, batch->size());
+    offset += batch->size();
+  }
+  return result;
+}
+
 std::string makeOperatorSpillPath(
     const std::string& spillDir,
     int pipelineId,
@@ -356,4 +387,16 @@ void addOperatorRuntimeStats(
   stats.at(name).addValue(value.value);
 }
 
+std::unique_ptr<VectorSerde::Options> makeExchangeSerdeOptions(
+    const core::QueryConfig& config) {
+  using PrestoVectorSerde = serializer::presto::PrestoVectorSerde;
+  const auto compressionKind = PrestoVectorSerde::compressionKindFromName(
+      config.exchangeCompressionCodec());
+  if (compressionKind == folly::io::CodecType::NO_COMPRESSION) {
+    return nullptr;
+  }
+  return std::make_unique<PrestoVectorSerde::PrestoOptions>(
+      /*useLosslessTimestamp=*/false, compressionKind);
+}
+
 } // namespace facebook::velox::exec
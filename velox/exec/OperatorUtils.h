@@ -17,6 +17,7 @@
 
 #include "velox/exec/Operator.h"
 #include "velox/exec/Spiller.h"
+#include "velox/vector/VectorStream.h"
 
 namespace facebook::velox::exec {
 
@@ -106,6 +107,14 @@ void gatherCopy(
     const std::vector<vector_size_t>& sourceIndices,
     const std::vector<IdentityProjection>& columnMap = {});
 
+/// Returns the rows of 'batches' in one flat batch of 'rowType' allocated from
+/// 'pool'. Returns the batch as is if there is only one and nullptr if there
+/// is none.
+RowVectorPtr coalesceBatches(
+    const RowTypePtr& rowType,
+    const std::vector<RowVectorPtr>& batches,
+    memory::MemoryPool* FOLLY_NONNULL pool);
+
 /// Generates the system-wide unique disk spill file path for an operator. It
 /// will be the directory on fs with namespace support or common file prefix if
 /// not. It is assumed that the disk spilling file hierarchy for an operator is
@@ -121,4 +130,10 @@ void addOperatorRuntimeStats(
     const std::string& name,
     const RuntimeCounter& value,
     std::unordered_map<std::string, RuntimeMetric>& stats);
+
+/// Returns the serde options to compress and decompress the pages exchanged
+/// between the tasks of a query with the codec set in 'config', or null if the
+/// pages are not compressed.
+std::unique_ptr<VectorSerde::Options> makeExchangeSerdeOptions(
+    const core::QueryConfig& config);
 } // namespace facebook::velox::exec
@@ -14,8 +14,15 @@
  * limitations under the License.
  */
 #include "velox/exec/OrderBy.h"
+
+#include <folly/ScopeGuard.h>
+#include <numeric>
+
+#include "velox/common/base/AsyncSource.h"
 #include "velox/exec/OperatorUtils.h"
+#include "velox/exec/RadixSort.h"
 #include "velox/exec/Task.h"
+#include "velox/exec/TreeOfLosers.h"
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::exec {
@@ -24,6 +31,62 @@ namespace {
 CompareFlags fromSortOrderToCompareFlags(const core::SortOrder& sortOrder) {
   return {sortOrder.isNullsFirst(), sortOrder.isAscending(), false, false};
 }
+
+// A sorted run of rows of a parallel sort, merged with the other runs by a
+// TreeOfLosers.
+class SortedRun : public MergeStream {
+ public:
+  SortedRun(
+      folly::Range<char**> rows,
+      const RowContainer& data,
+      const std::vector<CompareFlags>& keyCompareFlags,
+      bool hasSortKeyPrefix)
+      : rows_(rows),
+        data_(data),
+        keyCompareFlags_(keyCompareFlags),
+        hasSortKeyPrefix_(hasSortKeyPrefix) {}
+
+  bool hasData() const override {
+    return next_ < rows_.size();
+  }
+
+  bool operator<(const MergeStream& other) const override {
+    return compare(other) < 0;
+  }
+
+  int32_t compare(const MergeStream& other) const override {
+    const auto* left = current();
+    const auto* right = static_cast<const SortedRun&>(other).current();
+    if (hasSortKeyPrefix_) {
+      const auto leftPrefix = RowContainer::normalizedKey(left);
+      const auto rightPrefix = RowContainer::normalizedKey(right);
+      if (leftPrefix != rightPrefix) {
+        return leftPrefix < rightPrefix ? -1 : 1;
+      }
+    }
+    for (auto i = 0; i < keyCompareFlags_.size(); ++i) {
+      if (auto result = data_.compare(left, right, i, keyCompareFlags_[i])) {
+        return result;
+      }
+    }
+    return 0;
+  }
+
+  char* current() const {
+    return rows_[next_];
+  }
+
+  void pop() {
+    ++next_;
+  }
+
+ private:
+  const folly::Range<char**> rows_;
+  const RowContainer& data_;
+  const std::vector<CompareFlags>& keyCompareFlags_;
+  const bool hasSortKeyPrefix_;
+  size_t next_{0};
+};
 } // namespace
 
 OrderBy::OrderBy(
@@ -37,9 +100,12 @@ OrderBy::OrderBy(
           orderByNode->id(),
           "OrderBy"),
       numSortKeys_(orderByNode->sortingKeys().size()),
+      numParallelSortRuns_(
+          driverCtx->queryConfig().orderByParallelSortRuns()),
       spillMemoryThreshold_(operatorCtx_->driverCtx()
                                 ->queryConfig()
                                 .orderBySpillMemoryThreshold()),
+      spillAsync_(driverCtx->queryConfig().orderBySpillAsync()),
       spillConfig_(
           orderByNode->canSpill(driverCtx->queryConfig())
               ? operatorCtx_->makeSpillConfig(Spiller::Type::kOrderBy)
@@ -82,8 +148,19 @@ OrderBy::OrderBy(
     names.push_back(outputType_->nameOf(outputChannel));
   }
 
-  // Create row container.
-  data_ = std::make_unique<RowContainer>(keyTypes, dependentTypes, pool());
+  // Create row container. If the leading sort key allows, each row gets a sort
+  // key prefix in its normalized key word.
+  if (SortKeyPrefix::isSupported(keyTypes[0])) {
+    std::vector<column_index_t> keyChannels(numSortKeys_);
+    std::iota(keyChannels.begin(), keyChannels.end(), 0);
+    sortKeyPrefix_.emplace(keyTypes, keyChannels, keyCompareFlags_);
+    // A string prefix holds only the leading bytes of the strings, which
+    // leaves too many ties to radix sort.
+    radixSort_ = keyTypes[0]->kind() != TypeKind::VARCHAR &&
+        keyTypes[0]->kind() != TypeKind::VARBINARY;
+  }
+  data_ = std::make_unique<RowContainer>(
+      keyTypes, dependentTypes, sortKeyPrefix_.has_value(), pool());
   internalStoreType_ = ROW(std::move(names), std::move(types));
 #ifndef NDEBUG
   for (int i = 0; i < internalStoreType_->children().size(); ++i) {
@@ -114,17 +191,44 @@ void OrderBy::addInput(RowVectorPtr input) {
       data_->store(decoded, i, rows[i], columnProjection.inputChannel);
     }
   }
+  if (sortKeyPrefix_.has_value()) {
+    for (auto* row : rows) {
+      RowContainer::normalizedKey(row) = sortKeyPrefix_->encode(*data_, row);
+    }
+  }
 
   numRows_ += allRows.size();
-  if (spiller_ != nullptr) {
-    const auto spillStats = spiller_->stats();
-    auto lockedStats = stats_.wlock();
-    lockedStats->spilledBytes = spillStats.spilledBytes;
-    lockedStats->spilledRows = spillStats.spilledRows;
-    lockedStats->spilledPartitions = spillStats.spilledPartitions;
-    lockedStats->spilledFiles = spillStats.spilledFiles;
-    VELOX_DCHECK_LE(lockedStats->spilledPartitions, 1);
+  recordSpillStats();
+}
+
+void OrderBy::recordSpillStats() {
+  if (spiller_ == nullptr) {
+    return;
+  }
+  const auto spillStats = spiller_->stats();
+  auto lockedStats = stats_.wlock();
+  lockedStats->spilledBytes = spillStats.spilledBytes;
+  lockedStats->spilledRows = spillStats.spilledRows;
+  lockedStats->spilledPartitions = spillStats.spilledPartitions;
+  lockedStats->spilledFiles = spillStats.spilledFiles;
+  spillStats.setRuntimeStats(lockedStats->runtimeStats);
+  VELOX_DCHECK_LE(lockedStats->spilledPartitions, 1);
+}
+
+bool OrderBy::canReclaim() const {
+  // The rows can only be spilled while the input is being received.
+  return spillConfig_.has_value() && !noMoreInput_;
+}
+
+void OrderBy::reclaim(uint64_t /*targetBytes*/) {
+  VELOX_CHECK(canReclaim());
+  if (data_->numRows() == 0) {
+    return;
   }
+  // Spill all the rows as the spilled runs are merged on output anyway.
+  spill(0, 0);
+  recordSpillStats();
+  pool()->getMemoryUsageTracker()->release();
 }
 
 void OrderBy::ensureInputFits(const RowVectorPtr& input) {
@@ -162,6 +266,10 @@ void OrderBy::ensureInputFits(const RowVectorPtr& input) {
   if (spillMemoryThreshold_ != 0 && currentUsage > spillMemoryThreshold_) {
     const int64_t bytesToSpill =
         currentUsage * spillConfig.spillableReservationGrowthPct / 100;
+    if (spillAsync_) {
+      spillAsync(bytesToSpill);
+      return;
+    }
     auto rowsToSpill = std::max<int64_t>(
         1, bytesToSpill / (data_->fixedRowSize() + outOfLineBytesPerRow));
     spill(
@@ -210,6 +318,45 @@ void OrderBy::spill(int64_t targetRows, int64_t targetBytes) {
   VELOX_CHECK_GE(targetRows, 0);
   VELOX_CHECK_GE(targetBytes, 0);
 
+  ensureSpiller();
+  spiller_->spill(targetRows, targetBytes);
+}
+
+void OrderBy::spillAsync(int64_t bytesToSpill) {
+  ensureSpiller();
+  if (spiller_->isAsyncSpillPending()) {
+    // The previous chunk is still being written. isBlocked() applies the
+    // backpressure if the memory usage grows too much meanwhile.
+    return;
+  }
+  spiller_->spillAsync(std::max<int64_t>(1, bytesToSpill));
+}
+
+BlockingReason OrderBy::isBlocked(ContinueFuture* future) {
+  if (spiller_ == nullptr || !spiller_->isAsyncSpillPending()) {
+    return BlockingReason::kNotBlocked;
+  }
+  if (spiller_->asyncSpillFinished()) {
+    spiller_->finishAsyncSpill();
+    recordSpillStats();
+    return BlockingReason::kNotBlocked;
+  }
+  // Keep taking input while the chunk is written unless the memory usage grew
+  // by another reservation growth step above the threshold.
+  const auto maxUsage = spillMemoryThreshold_ *
+      (100 + spillConfig_->spillableReservationGrowthPct) / 100;
+  if (pool()->getMemoryUsageTracker()->currentBytes() <= maxUsage) {
+    return BlockingReason::kNotBlocked;
+  }
+  if (spiller_->asyncSpillFinished(future)) {
+    spiller_->finishAsyncSpill();
+    recordSpillStats();
+    return BlockingReason::kNotBlocked;
+  }
+  return BlockingReason::kWaitForSpill;
+}
+
+void OrderBy::ensureSpiller() {
   if (spiller_ == nullptr) {
     VELOX_DCHECK_NOT_NULL(pool()->getMemoryUsageTracker());
     const auto& spillConfig = spillConfig_.value();
@@ -224,10 +371,11 @@ void OrderBy::spill(int64_t targetRows, int64_t targetBytes) {
         spillConfig.maxFileSize,
         spillConfig.minSpillRunSize,
         Spiller::spillPool(),
-        spillConfig.executor);
+        spillConfig.executor,
+        spillConfig.compressionKind,
+        spillConfig.writeCallback);
     VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
   }
-  spiller_->spill(targetRows, targetBytes);
 }
 
 void OrderBy::noMoreInput() {
@@ -246,24 +394,21 @@ void OrderBy::noMoreInput() {
     returningRows_.resize(numRows_);
     RowContainerIterator iter;
     data_->listRows(&iter, numRows_, returningRows_.data());
-    std::sort(
-        returningRows_.begin(),
-        returningRows_.end(),
-        [this](const char* leftRow, const char* rightRow) {
-          for (vector_size_t index = 0; index < numSortKeys_; ++index) {
-            if (auto result = data_->compare(
-                    leftRow, rightRow, index, keyCompareFlags_[index])) {
-              return result < 0;
-            }
-          }
-          return false;
-        });
-
+    const auto numRuns = std::min<int64_t>(
+        numParallelSortRuns_, numRows_ / kMinParallelSortRunRows);
+    if (numRuns > 1 &&
+        operatorCtx_->task()->queryCtx()->executor() != nullptr) {
+      parallelSortRows(numRuns);
+    } else {
+      sortRows(folly::Range<char**>(returningRows_.data(), numRows_));
+    }
   } else {
     // Finish spill, and we shouldn't get any rows from non-spilled partition as
     // there is only one hash partition for orderBy operator.
+    // This also finishes a pending async spill.
     Spiller::SpillRows nonSpilledRows = spiller_->finishSpill();
     VELOX_CHECK(nonSpilledRows.empty());
+    recordSpillStats();
     VELOX_CHECK_NULL(spillMerge_);
 
     spillMerge_ = spiller_->startMerge(0);
@@ -272,6 +417,121 @@ void OrderBy::noMoreInput() {
   }
 }
 
+bool OrderBy::lessThan(const char* leftRow, const char* rightRow) const {
+  for (vector_size_t index = 0; index < numSortKeys_; ++index) {
+    if (auto result = data_->compare(
+            leftRow, rightRow, index, keyCompareFlags_[index])) {
+      return result < 0;
+    }
+  }
+  return false;
+}
+
+void OrderBy::sortRows(folly::Range<char**> rows) const {
+  if (radixSort_ && rows.size() >= kMinRadixSortRows) {
+    radixSortRows(rows);
+    return;
+  }
+  std::sort(
+      rows.begin(),
+      rows.end(),
+      [this](const char* leftRow, const char* rightRow) {
+        if (sortKeyPrefix_.has_value()) {
+          const auto leftPrefix = RowContainer::normalizedKey(leftRow);
+          const auto rightPrefix = RowContainer::normalizedKey(rightRow);
+          if (leftPrefix != rightPrefix) {
+            return leftPrefix < rightPrefix;
+          }
+        }
+        return lessThan(leftRow, rightRow);
+      });
+}
+
+void OrderBy::radixSortRows(folly::Range<char**> rows) const {
+  std::vector<RadixSortEntry> entries(rows.size());
+  for (auto i = 0; i < rows.size(); ++i) {
+    entries[i] = {RowContainer::normalizedKey(rows[i]), rows[i]};
+  }
+  std::vector<RadixSortEntry> scratch;
+  radixSort(entries, scratch);
+  for (auto i = 0; i < entries.size(); ++i) {
+    rows[i] = entries[i].row;
+  }
+
+  if (!sortKeyPrefix_->isComplete()) {
+    // Sorts each run of rows with equal prefixes by the keys.
+    for (size_t begin = 0; begin < entries.size();) {
+      const auto prefix = entries[begin].key;
+      auto end = begin + 1;
+      while (end < entries.size() && entries[end].key == prefix) {
+        ++end;
+      }
+      if (end - begin > 1) {
+        std::sort(
+            rows.begin() + begin,
+            rows.begin() + end,
+            [this](const char* leftRow, const char* rightRow) {
+              return lessThan(leftRow, rightRow);
+            });
+      }
+      begin = end;
+    }
+  }
+}
+
+void OrderBy::parallelSortRows(int32_t numRuns) {
+  auto* executor = operatorCtx_->task()->queryCtx()->executor();
+  std::vector<std::unique_ptr<SortedRun>> runs;
+  std::vector<std::shared_ptr<AsyncSource<bool>>> sortSteps;
+  auto sync = folly::makeGuard([&]() {
+    // This is executed on returning path, possibly in unwinding, so must not
+    // throw.
+    for (auto& step : sortSteps) {
+      try {
+        step->move();
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "Error in parallel order by sort: " << e.what();
+      }
+    }
+  });
+
+  const auto runSize = bits::roundUp(numRows_, numRuns) / numRuns;
+  for (size_t begin = 0; begin < numRows_; begin += runSize) {
+    folly::Range<char**> rows(
+        returningRows_.data() + begin,
+        std::min<size_t>(runSize, numRows_ - begin));
+    runs.push_back(std::make_unique<SortedRun>(
+        rows, *data_, keyCompareFlags_, sortKeyPrefix_.has_value()));
+    sortSteps.push_back(std::make_shared<AsyncSource<bool>>([this, rows]() {
+      sortRows(rows);
+      return std::make_unique<bool>(true);
+    }));
+    executor->add([step = sortSteps.back()]() { step->prepare(); });
+  }
+  std::exception_ptr error;
+  for (auto& step : sortSteps) {
+    try {
+      step->move();
+    } catch (const std::exception& e) {
+      error = std::current_exception();
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  std::vector<char*> sortedRows;
+  sortedRows.reserve(numRows_);
+  TreeOfLosers<SortedRun> merge(std::move(runs));
+  while (auto* run = merge.next()) {
+    sortedRows.push_back(run->current());
+    run->pop();
+  }
+  VELOX_CHECK_EQ(sortedRows.size(), numRows_);
+  returningRows_ = std::move(sortedRows);
+  addRuntimeStat("numParallelSortRuns", RuntimeCounter(numRuns));
+}
+
 RowVectorPtr OrderBy::getOutput() {
   if (finished_ || !noMoreInput_ || numRows_ == numRowsReturned_) {
     return nullptr;
@@ -18,6 +18,7 @@
 #include "velox/exec/ContainerRowSerde.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/SortKeyPrefix.h"
 #include "velox/exec/Spiller.h"
 
 namespace facebook::velox::exec {
@@ -48,17 +49,26 @@ class OrderBy : public Operator {
 
   RowVectorPtr getOutput() override;
 
-  BlockingReason isBlocked(ContinueFuture* FOLLY_NULLABLE /*future*/) override {
-    return BlockingReason::kNotBlocked;
-  }
+  BlockingReason isBlocked(ContinueFuture* FOLLY_NULLABLE future) override;
 
   bool isFinished() override {
     return finished_;
   }
 
+  bool canReclaim() const override;
+
+  void reclaim(uint64_t targetBytes) override;
+
  private:
   static const int32_t kBatchSizeInBytes{2 * 1024 * 1024};
 
+  // The minimum number of rows to radix sort. Fewer rows are sorted with the
+  // comparator.
+  static const int32_t kMinRadixSortRows{1'024};
+
+  // The minimum number of rows in each run of a parallel sort.
+  static const int32_t kMinParallelSortRunRows{10'000};
+
   // Checks if input will fit in the existing memory and increases
   // reservation if not. If reservation cannot be increased, spills enough to
   // make 'input' fit.
@@ -68,6 +78,22 @@ class OrderBy : public Operator {
   // remaining rows to return.
   void prepareOutput();
 
+  // Returns true if 'leftRow' sorts before 'rightRow' by the keys, not looking
+  // at the sort key prefixes.
+  bool lessThan(const char* leftRow, const char* rightRow) const;
+
+  // Sorts 'rows' by their keys.
+  void sortRows(folly::Range<char**> rows) const;
+
+  // Sorts 'rows' by their sort key prefixes with a radix sort. Rows with equal
+  // prefixes are then sorted by their keys unless the prefix encodes all the
+  // keys.
+  void radixSortRows(folly::Range<char**> rows) const;
+
+  // Splits 'returningRows_' into 'numRuns' runs, sorts the runs in parallel on
+  // the driver executor and merges them back into 'returningRows_'.
+  void parallelSortRows(int32_t numRuns);
+
   void getOutputWithoutSpill();
   void getOutputWithSpill();
 
@@ -78,12 +104,31 @@ class OrderBy : public Operator {
   // in a paused state and off thread.
   void spill(int64_t targetRows, int64_t targetBytes);
 
+  // Starts spilling about 'bytesToSpill' of rows on the spill executor without
+  // waiting for the writes. See 'spillAsync_'.
+  void spillAsync(int64_t bytesToSpill);
+
+  // Creates 'spiller_' on first spill.
+  void ensureSpiller();
+
+  // Updates the operator stats with the spiller stats.
+  void recordSpillStats();
+
   const int32_t numSortKeys_;
 
+  // The number of runs to sort in parallel if there are enough rows. 0 or 1 if
+  // the rows are sorted by the driver thread.
+  const int32_t numParallelSortRuns_;
+
   // The maximum memory usage that an order by can hold before spilling.
   // If it is zero, then there is no such limit.
   const uint64_t spillMemoryThreshold_;
 
+  // If true, exceeding 'spillMemoryThreshold_' spills a chunk of rows on the
+  // spill executor while this keeps taking input. isBlocked() only waits for
+  // the chunk if the memory usage keeps growing while it is being written.
+  const bool spillAsync_;
+
   // Filesystem path for spill files, empty if spilling is disabled.
   // The disk spilling related configs if spilling is enabled, otherwise null.
   const std::optional<Spiller::Config> spillConfig_;
@@ -95,6 +140,14 @@ class OrderBy : public Operator {
 
   std::vector<CompareFlags> keyCompareFlags_;
 
+  // Encodes the sort key prefix stored in the normalized key word of each row
+  // in 'data_'. Not set if the leading sort key type is not supported.
+  std::optional<SortKeyPrefix> sortKeyPrefix_;
+
+  // True if the rows are radix sorted by their sort key prefixes. This is the
+  // case if the leading sort key is of a fixed width type.
+  bool radixSort_{false};
+
   std::unique_ptr<RowContainer> data_;
 
   // The row type used to store input data in row container and for spilling
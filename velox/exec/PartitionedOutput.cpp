@@ -15,7 +15,9 @@
  */
 
 #include "velox/exec/PartitionedOutput.h"
+#include "velox/exec/OperatorUtils.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
+#include "velox/serializers/PrestoSerializer.h"
 
 namespace facebook::velox::exec {
 
@@ -70,7 +72,9 @@ void Destination::serialize(
     for (vector_size_t i = begin; i < end; i++) {
       numRows += rows_[i].size;
     }
-    current_->createStreamTree(rowType, numRows);
+    skipCompression_ = skipCompressionPages_ > 0;
+    current_->createStreamTree(
+        rowType, numRows, skipCompression_ ? nullptr : serdeOptions_);
   }
   current_->append(output, folly::Range(&rows_[begin], end - begin));
 }
@@ -90,6 +94,9 @@ BlockingReason Destination::flush(
       listener.get(),
       std::max<int64_t>(kMinMessageSize, current_->size()));
   current_->flush(&stream);
+  if (serdeOptions_ != nullptr) {
+    updateCompressionStats(stream.tellp());
+  }
   current_.reset();
   bytesInCurrent_ = 0;
   setTargetSizePct();
@@ -101,6 +108,36 @@ BlockingReason Destination::flush(
       future);
 }
 
+void Destination::updateCompressionStats(int64_t pageBytes) {
+  if (skipCompression_) {
+    --skipCompressionPages_;
+    compressionStats_.skippedBytes += pageBytes;
+    return;
+  }
+  using PrestoVectorSerde = serializer::presto::PrestoVectorSerde;
+  const auto stats = current_->runtimeStats();
+  auto statValue = [&](const char* name) -> int64_t {
+    auto it = stats.find(name);
+    return it == stats.end() ? 0 : it->second.value;
+  };
+  compressionStats_.inputBytes +=
+      statValue(PrestoVectorSerde::kCompressionInputBytes);
+  compressionStats_.compressedBytes +=
+      statValue(PrestoVectorSerde::kCompressedBytes);
+  const auto skippedBytes =
+      statValue(PrestoVectorSerde::kCompressionSkippedBytes);
+  compressionStats_.skippedBytes += skippedBytes;
+  if (skippedBytes > 0) {
+    // The data of this destination compresses poorly. Skip the compression
+    // of the next pages, the longer the more often this happens.
+    numSkipCompressionPages_ = std::min(
+        kMaxSkipCompressionPages, std::max(1, numSkipCompressionPages_ * 2));
+    skipCompressionPages_ = numSkipCompressionPages_;
+  } else {
+    numSkipCompressionPages_ = 0;
+  }
+}
+
 PartitionedOutput::PartitionedOutput(
     int32_t operatorId,
     DriverCtx* FOLLY_NONNULL ctx,
@@ -130,13 +167,41 @@ PartitionedOutput::PartitionedOutput(
       bufferReleaseFn_([task = operatorCtx_->task()]() {}),
       maxBufferedBytes_(ctx->task->queryCtx()
                             ->queryConfig()
-                            .maxPartitionedOutputBufferSize()) {
+                            .maxPartitionedOutputBufferSize()),
+      serdeOptions_(makeExchangeSerdeOptions(ctx->queryConfig())) {
   if (numDestinations_ == 1 || planNode->isBroadcast()) {
     VELOX_CHECK(keyChannels_.empty());
     VELOX_CHECK_NULL(partitionFunction_);
   }
 }
 
+void PartitionedOutput::close() {
+  if (serdeOptions_ != nullptr && !destinations_.empty()) {
+    Destination::CompressionStats compressionStats;
+    for (const auto& destination : destinations_) {
+      const auto& stats = destination->compressionStats();
+      compressionStats.inputBytes += stats.inputBytes;
+      compressionStats.compressedBytes += stats.compressedBytes;
+      compressionStats.skippedBytes += stats.skippedBytes;
+    }
+    using PrestoVectorSerde = serializer::presto::PrestoVectorSerde;
+    auto lockedStats = stats_.wlock();
+    lockedStats->addRuntimeStat(
+        PrestoVectorSerde::kCompressionInputBytes,
+        RuntimeCounter(
+            compressionStats.inputBytes, RuntimeCounter::Unit::kBytes));
+    lockedStats->addRuntimeStat(
+        PrestoVectorSerde::kCompressedBytes,
+        RuntimeCounter(
+            compressionStats.compressedBytes, RuntimeCounter::Unit::kBytes));
+    lockedStats->addRuntimeStat(
+        PrestoVectorSerde::kCompressionSkippedBytes,
+        RuntimeCounter(
+            compressionStats.skippedBytes, RuntimeCounter::Unit::kBytes));
+  }
+  destinations_.clear();
+}
+
 void PartitionedOutput::initializeInput(RowVectorPtr input) {
   input_ = std::move(input);
   if (outputChannels_.empty()) {
@@ -162,7 +227,8 @@ void PartitionedOutput::initializeDestinations() {
   if (destinations_.empty()) {
     auto taskId = operatorCtx_->taskId();
     for (int i = 0; i < numDestinations_; ++i) {
-      destinations_.push_back(std::make_unique<Destination>(taskId, i, pool()));
+      destinations_.push_back(std::make_unique<Destination>(
+          taskId, i, pool(), serdeOptions_.get()));
     }
   }
 }
@@ -24,11 +24,16 @@ namespace facebook::velox::exec {
 
 class Destination {
  public:
+  // Compresses the pages with 'serdeOptions' if not null.
   Destination(
       const std::string& taskId,
       int destination,
-      memory::MemoryPool* FOLLY_NONNULL pool)
-      : taskId_(taskId), destination_(destination), pool_(pool) {
+      memory::MemoryPool* FOLLY_NONNULL pool,
+      const VectorSerde::Options* FOLLY_NULLABLE serdeOptions = nullptr)
+      : taskId_(taskId),
+        destination_(destination),
+        pool_(pool),
+        serdeOptions_(serdeOptions) {
     setTargetSizePct();
   }
 
@@ -38,7 +43,13 @@ class Destination {
     row_ = 0;
   }
 
+  // Extends the last range if 'row' follows it, so that runs of rows going
+  // to the same destination are serialized as one range.
   void addRow(vector_size_t row) {
+    if (!rows_.empty() && rows_.back().begin + rows_.back().size == row) {
+      ++rows_.back().size;
+      return;
+    }
     rows_.push_back(IndexRange{row, 1});
   }
 
@@ -73,7 +84,30 @@ class Destination {
     return bytesInCurrent_;
   }
 
+  // The page compression byte counts of this destination.
+  struct CompressionStats {
+    // The uncompressed bytes of the pages that have been compressed.
+    int64_t inputBytes{0};
+    // The compressed bytes of the pages that have been compressed.
+    int64_t compressedBytes{0};
+    // The bytes of the pages sent uncompressed because of a poor compression
+    // ratio, including the pages for which compression was skipped.
+    int64_t skippedBytes{0};
+  };
+
+  const CompressionStats& compressionStats() const {
+    return compressionStats_;
+  }
+
  private:
+  // The maximum number of pages to skip compression for after a page that
+  // didn't compress well.
+  static constexpr int32_t kMaxSkipCompressionPages = 64;
+
+  // Updates the compression stats and the number of pages to skip compression
+  // for after flushing 'current_' to a page of 'pageBytes'.
+  void updateCompressionStats(int64_t pageBytes);
+
   void
   serialize(const RowVectorPtr& input, vector_size_t begin, vector_size_t end);
 
@@ -93,6 +127,18 @@ class Destination {
   const std::string taskId_;
   const int destination_;
   memory::MemoryPool* FOLLY_NONNULL const pool_;
+  const VectorSerde::Options* FOLLY_NULLABLE const serdeOptions_;
+
+  // The number of pages to skip compression for after the last page that
+  // didn't compress well, doubled on each such page up to
+  // 'kMaxSkipCompressionPages' and reset by a page that compressed well.
+  int32_t numSkipCompressionPages_{0};
+  // The remaining number of pages to skip compression for.
+  int32_t skipCompressionPages_{0};
+  // Set if compression is skipped for 'current_'.
+  bool skipCompression_{false};
+  CompressionStats compressionStats_;
+
   uint64_t bytesInCurrent_{0};
   std::vector<IndexRange> rows_;
 
@@ -158,9 +204,7 @@ class PartitionedOutput : public Operator {
 
   bool isFinished() override;
 
-  void close() override {
-    destinations_.clear();
-  }
+  void close() override;
 
  private:
   void initializeInput(RowVectorPtr input);
@@ -183,6 +227,8 @@ class PartitionedOutput : public Operator {
   const std::weak_ptr<exec::PartitionedOutputBufferManager> bufferManager_;
   const std::function<void()> bufferReleaseFn_;
   const int64_t maxBufferedBytes_;
+  // Options to compress the pages with. Null if the pages are not compressed.
+  const std::unique_ptr<VectorSerde::Options> serdeOptions_;
 
   BlockingReason blockingReason_{BlockingReason::kNotBlocked};
   ContinueFuture future_;
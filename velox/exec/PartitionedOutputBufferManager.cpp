@@ -18,6 +18,23 @@
 
 namespace facebook::velox::exec {
 
+int64_t DestinationBuffer::numPages() const {
+  if (broadcastPages_ == nullptr) {
+    return data_.size();
+  }
+  return broadcastPages_->pages.size() -
+      (sequence_ - broadcastPages_->firstSequence);
+}
+
+const std::shared_ptr<SerializedPage>& DestinationBuffer::page(
+    int64_t index) const {
+  if (broadcastPages_ == nullptr) {
+    return data_[index];
+  }
+  return broadcastPages_
+      ->pages[sequence_ - broadcastPages_->firstSequence + index];
+}
+
 std::vector<std::unique_ptr<folly::IOBuf>> DestinationBuffer::getData(
     uint64_t maxBytes,
     int64_t sequence,
@@ -25,7 +42,8 @@ std::vector<std::unique_ptr<folly::IOBuf>> DestinationBuffer::getData(
   VELOX_CHECK_GE(
       sequence, sequence_, "Get received for an already acknowledged item");
 
-  if (sequence - sequence_ > data_.size()) {
+  const auto numAvailable = numPages();
+  if (sequence - sequence_ > numAvailable) {
     VLOG(0) << this << " Out of order get: " << sequence << " over "
             << sequence_ << " Setting second notify " << notifySequence_
             << " / " << sequence;
@@ -34,7 +52,7 @@ std::vector<std::unique_ptr<folly::IOBuf>> DestinationBuffer::getData(
     notifyMaxBytes_ = maxBytes;
     return {};
   }
-  if (sequence - sequence_ == data_.size()) {
+  if (sequence - sequence_ == numAvailable) {
     notify_ = notify;
     notifySequence_ = sequence;
     notifyMaxBytes_ = maxBytes;
@@ -43,15 +61,16 @@ std::vector<std::unique_ptr<folly::IOBuf>> DestinationBuffer::getData(
 
   std::vector<std::unique_ptr<folly::IOBuf>> result;
   uint64_t resultBytes = 0;
-  for (auto i = sequence - sequence_; i < data_.size(); i++) {
+  for (auto i = sequence - sequence_; i < numAvailable; i++) {
+    const auto& data = page(i);
     // nullptr is used as end marker
-    if (!data_[i]) {
-      VELOX_CHECK_EQ(i, data_.size() - 1, "null marker found in the middle");
+    if (!data) {
+      VELOX_CHECK_EQ(i, numAvailable - 1, "null marker found in the middle");
       result.push_back(nullptr);
       break;
     }
-    result.push_back(data_[i]->getIOBuf());
-    resultBytes += data_[i]->size();
+    result.push_back(data->getIOBuf());
+    resultBytes += data->size();
     if (resultBytes >= maxBytes) {
       break;
     }
@@ -95,7 +114,11 @@ std::vector<std::shared_ptr<SerializedPage>> DestinationBuffer::acknowledge(
   }
 
   VELOX_CHECK_LE(
-      numDeleted, data_.size(), "Ack received for a not yet produced item");
+      numDeleted, numPages(), "Ack received for a not yet produced item");
+  if (broadcastPages_ != nullptr) {
+    sequence_ += numDeleted;
+    return {};
+  }
   std::vector<std::shared_ptr<SerializedPage>> freed;
   for (auto i = 0; i < numDeleted; ++i) {
     if (!data_[i]) {
@@ -111,6 +134,11 @@ std::vector<std::shared_ptr<SerializedPage>> DestinationBuffer::acknowledge(
 
 std::vector<std::shared_ptr<SerializedPage>>
 DestinationBuffer::deleteResults() {
+  if (broadcastPages_ != nullptr) {
+    // Stops reading the broadcast pages. The owner frees them.
+    broadcastPages_ = nullptr;
+    return {};
+  }
   std::vector<std::shared_ptr<SerializedPage>> freed;
   for (auto i = 0; i < data_.size(); ++i) {
     if (!data_[i]) {
@@ -125,7 +153,7 @@ DestinationBuffer::deleteResults() {
 
 std::string DestinationBuffer::toString() {
   std::stringstream out;
-  out << "[available: " << data_.size() << ", "
+  out << "[available: " << numPages() << ", "
       << "sequence: " << sequence_ << ", "
       << (notify_ ? "notify registered, " : "") << this << "]";
   return out.str();
@@ -159,8 +187,16 @@ PartitionedOutputBuffer::PartitionedOutputBuffer(
       continueSize_((maxSize_ * kContinuePct) / 100) {
   buffers_.reserve(numDestinations);
   for (int i = 0; i < numDestinations; i++) {
-    buffers_.push_back(std::make_unique<DestinationBuffer>());
+    buffers_.push_back(newDestinationBuffer());
+  }
+}
+
+std::unique_ptr<DestinationBuffer>
+PartitionedOutputBuffer::newDestinationBuffer() const {
+  if (broadcast_) {
+    return std::make_unique<DestinationBuffer>(&broadcastPages_);
   }
+  return std::make_unique<DestinationBuffer>();
 }
 
 void PartitionedOutputBuffer::updateBroadcastOutputBuffers(
@@ -168,6 +204,7 @@ void PartitionedOutputBuffer::updateBroadcastOutputBuffers(
     bool noMoreBuffers) {
   VELOX_CHECK(broadcast_);
 
+  std::vector<std::shared_ptr<SerializedPage>> freed;
   std::vector<ContinuePromise> promises;
   bool isFinished;
   {
@@ -183,10 +220,11 @@ void PartitionedOutputBuffer::updateBroadcastOutputBuffers(
 
     noMoreBroadcastBuffers_ = true;
     isFinished = isFinishedLocked();
-    updateAfterAcknowledgeLocked(dataToBroadcast_, promises);
+    evictBroadcastPagesLocked(freed);
+    updateAfterAcknowledgeLocked(freed, promises);
   }
 
-  releaseAfterAcknowledge(dataToBroadcast_, promises);
+  releaseAfterAcknowledge(freed, promises);
   if (isFinished) {
     task_->setAllOutputConsumed();
   }
@@ -210,15 +248,30 @@ void PartitionedOutputBuffer::updateNumDrivers(uint32_t newNumDrivers) {
 void PartitionedOutputBuffer::addBroadcastOutputBuffersLocked(int numBuffers) {
   VELOX_CHECK(!noMoreBroadcastBuffers_)
   buffers_.reserve(numBuffers);
+  VELOX_CHECK_EQ(broadcastPages_.firstSequence, 0);
   for (auto i = buffers_.size(); i < numBuffers; i++) {
-    auto buffer = std::make_unique<DestinationBuffer>();
-    for (const auto& data : dataToBroadcast_) {
-      buffer->enqueue(data);
-    }
-    if (atEnd_) {
-      buffer->enqueue(nullptr);
+    buffers_.emplace_back(newDestinationBuffer());
+  }
+}
+
+void PartitionedOutputBuffer::evictBroadcastPagesLocked(
+    std::vector<std::shared_ptr<SerializedPage>>& freed) {
+  if (!broadcast_ || !noMoreBroadcastBuffers_) {
+    return;
+  }
+  auto minSequence = std::numeric_limits<int64_t>::max();
+  for (const auto& buffer : buffers_) {
+    if (buffer) {
+      minSequence = std::min(minSequence, buffer->sequence());
     }
-    buffers_.emplace_back(std::move(buffer));
+  }
+  auto& pages = broadcastPages_.pages;
+  // The end marker is kept, it is not accounted for.
+  while (!pages.empty() && pages.front() != nullptr &&
+         broadcastPages_.firstSequence < minSequence) {
+    freed.push_back(std::move(pages.front()));
+    pages.pop_front();
+    ++broadcastPages_.firstSequence;
   }
 }
 
@@ -237,17 +290,12 @@ BlockingReason PartitionedOutputBuffer::enqueue(
 
     totalSize_ += data->size();
     if (broadcast_) {
-      std::shared_ptr<SerializedPage> sharedData(data.release());
+      broadcastPages_.pages.emplace_back(data.release());
       for (auto& buffer : buffers_) {
         if (buffer) {
-          buffer->enqueue(sharedData);
           dataAvailableCallbacks.emplace_back(buffer->getAndClearNotify());
         }
       }
-
-      if (!noMoreBroadcastBuffers_) {
-        dataToBroadcast_.emplace_back(sharedData);
-      }
     } else {
       if (auto buffer = buffers_[destination].get()) {
         buffer->enqueue(std::move(data));
@@ -296,9 +344,16 @@ void PartitionedOutputBuffer::checkIfDone(bool oneDriverFinished) {
         "Each driver should call noMoreData exactly once");
     atEnd_ = numFinished_ == numDrivers_;
     if (atEnd_) {
+      auto& broadcastPages = broadcastPages_.pages;
+      if (broadcast_ &&
+          (broadcastPages.empty() || broadcastPages.back() != nullptr)) {
+        broadcastPages.push_back(nullptr);
+      }
       for (auto& buffer : buffers_) {
         if (buffer) {
-          buffer->enqueue(nullptr);
+          if (!broadcast_) {
+            buffer->enqueue(nullptr);
+          }
           finished.push_back(buffer->getAndClearNotify());
         }
       }
@@ -341,6 +396,7 @@ void PartitionedOutputBuffer::acknowledge(int destination, int64_t sequence) {
       return;
     }
     freed = buffer->acknowledge(sequence, false);
+    evictBroadcastPagesLocked(freed);
     updateAfterAcknowledgeLocked(freed, promises);
   }
   releaseAfterAcknowledge(freed, promises);
@@ -389,6 +445,7 @@ bool PartitionedOutputBuffer::deleteResults(int destination) {
     buffers_[destination] = nullptr;
     ++numFinalAcknowledges_;
     isFinished = isFinishedLocked();
+    evictBroadcastPagesLocked(freed);
     updateAfterAcknowledgeLocked(freed, promises);
   }
 
@@ -429,6 +486,7 @@ void PartitionedOutputBuffer::getData(
         destination,
         sequence);
     freed = destinationBuffer->acknowledge(sequence, true);
+    evictBroadcastPagesLocked(freed);
     updateAfterAcknowledgeLocked(freed, promises);
     data = destinationBuffer->getData(maxBytes, sequence, notify);
   }
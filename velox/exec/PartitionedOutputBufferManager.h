@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <deque>
+
 #include "velox/exec/Exchange.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/Task.h"
@@ -40,9 +42,28 @@ struct DataAvailable {
   }
 };
 
+// The pages of a broadcast PartitionedOutputBuffer. Each page is kept once
+// for all destinations and is freed after all destinations have acknowledged
+// it.
+struct BroadcastPages {
+  std::deque<std::shared_ptr<SerializedPage>> pages;
+  // The sequence number of the first page in 'pages'.
+  int64_t firstSequence{0};
+};
+
 class DestinationBuffer {
  public:
+  DestinationBuffer() = default;
+
+  // Creates a buffer that reads the pages of 'broadcastPages' from its own
+  // sequence number on instead of keeping its own pages. enqueue() is not
+  // used and acknowledge() only advances the sequence number, the owner of
+  // 'broadcastPages' frees the pages all destinations are past.
+  explicit DestinationBuffer(const BroadcastPages* broadcastPages)
+      : broadcastPages_(broadcastPages) {}
+
   void enqueue(std::shared_ptr<SerializedPage> data) {
+    VELOX_CHECK_NULL(broadcastPages_);
     // drop duplicate end markers
     if (data == nullptr && !data_.empty() && data_.back() == nullptr) {
       return;
@@ -74,7 +95,21 @@ class DestinationBuffer {
 
   std::string toString();
 
+  // The sequence number of the first page not acknowledged.
+  int64_t sequence() const {
+    return sequence_;
+  }
+
  private:
+  // The number of pages from 'sequence_' on.
+  int64_t numPages() const;
+
+  // Returns the page at 'index' from 'sequence_'.
+  const std::shared_ptr<SerializedPage>& page(int64_t index) const;
+
+  // The shared pages of a broadcast buffer. Not owned. If nullptr the
+  // pages are in 'data_'.
+  const BroadcastPages* broadcastPages_{nullptr};
   std::vector<std::shared_ptr<SerializedPage>> data_;
   // The sequence number of the first in 'data_'.
   int64_t sequence_ = 0;
@@ -150,10 +185,17 @@ class PartitionedOutputBuffer {
       const std::vector<std::shared_ptr<SerializedPage>>& freed,
       std::vector<ContinuePromise>& promises);
 
-  /// Given an updated total number of broadcast buffers, add any missing ones
-  /// and enqueue data that has been produced so far (e.g. dataToBroadcast_).
+  /// Given an updated total number of broadcast buffers, add any missing ones.
+  /// The new buffers read the broadcast pages from the first one on.
   void addBroadcastOutputBuffersLocked(int numBuffers);
 
+  std::unique_ptr<DestinationBuffer> newDestinationBuffer() const;
+
+  /// Moves the broadcast pages that all destinations have acknowledged to
+  /// 'freed'. Pages are kept while more destinations may be added.
+  void evictBroadcastPagesLocked(
+      std::vector<std::shared_ptr<SerializedPage>>& freed);
+
   const std::shared_ptr<Task> task_;
   const bool broadcast_;
   /// Total number of drivers expected to produce results. This number will
@@ -168,10 +210,11 @@ class PartitionedOutputBuffer {
 
   bool noMoreBroadcastBuffers_ = false;
 
-  // While noMoreBroadcastBuffers_ is false, stores the enqueued data to
-  // broadcast to destinations that have not yet been initialized. Cleared
-  // after receiving no-more-broadcast-buffers signal.
-  std::vector<std::shared_ptr<SerializedPage>> dataToBroadcast_;
+  // The pages read by all destinations if 'broadcast_' is true. Each page is
+  // serialized and accounted for once. While noMoreBroadcastBuffers_ is
+  // false, all pages are kept for the destinations that have not yet been
+  // initialized.
+  BroadcastPages broadcastPages_;
 
   std::mutex mutex_;
   // Actual data size in 'buffers_'.
@@ -248,6 +291,12 @@ class PartitionedOutputBufferManager {
 
   void removeTask(const std::string& taskId);
 
+  /// Returns true if the output buffer of 'taskId' is in this manager, i.e.
+  /// the task runs in this process.
+  bool hasTask(const std::string& taskId) {
+    return getBufferIfExists(taskId) != nullptr;
+  }
+
   static std::weak_ptr<PartitionedOutputBufferManager> getInstance();
 
   uint64_t numBuffers() const;
@@ -160,6 +160,43 @@ folly::dynamic toPlanStatsJson(const facebook::velox::exec::TaskStats& stats) {
   return jsonStats;
 }
 
+namespace {
+std::string timelineEventName(const DriverTimelineEvent& event) {
+  switch (event.kind) {
+    case DriverTimelineEvent::Kind::kQueued:
+      return "queued";
+    case DriverTimelineEvent::Kind::kRun:
+      return "run";
+    case DriverTimelineEvent::Kind::kBlocked:
+      // Named by the reason so that the dominant reasons stand out.
+      return blockingReasonToString(event.blockingReason).substr(1);
+  }
+  VELOX_UNREACHABLE();
+}
+} // namespace
+
+folly::dynamic toDriverTimelineTrace(const TaskStats& stats) {
+  folly::dynamic traceEvents = folly::dynamic::array;
+  for (const auto& event : stats.driverTimeline) {
+    folly::dynamic traceEvent = folly::dynamic::object;
+    traceEvent["name"] = timelineEventName(event);
+    traceEvent["cat"] = "driver";
+    // A complete event with a start and a duration.
+    traceEvent["ph"] = "X";
+    traceEvent["ts"] = event.startMicros;
+    traceEvent["dur"] = event.durationMicros;
+    traceEvent["pid"] = event.pipelineId;
+    traceEvent["tid"] = event.driverId;
+    if (event.kind == DriverTimelineEvent::Kind::kRun) {
+      traceEvent["args"] = folly::dynamic::object(
+          "stopReason", stopReasonString(event.stopReason));
+    }
+    traceEvents.push_back(std::move(traceEvent));
+  }
+  return folly::dynamic::object("traceEvents", std::move(traceEvents))(
+      "displayTimeUnit", "ms");
+}
+
 namespace {
 void printCustomStats(
     const std::unordered_map<std::string, RuntimeMetric>& stats,
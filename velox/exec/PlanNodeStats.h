@@ -129,6 +129,12 @@ std::unordered_map<core::PlanNodeId, PlanNodeStats> toPlanStats(
 
 folly::dynamic toPlanStatsJson(const facebook::velox::exec::TaskStats& stats);
 
+/// Returns the sampled Driver timelines in 'stats' in the Chrome trace event
+/// format that chrome://tracing and Perfetto load, once serialized with
+/// folly::toJson. The Drivers of a pipeline show as the threads of one
+/// process. See QueryConfig::kDriverTimelineSamplePct.
+folly::dynamic toDriverTimelineTrace(const TaskStats& stats);
+
 /// Returns human-friendly representation of the plan augmented with runtime
 /// statistics. The result has the same plan representation as in
 /// PlanNode::toString(true, true), but each plan node includes an additional
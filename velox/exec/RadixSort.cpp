@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/RadixSort.h"
+
+#include <array>
+#include <utility>
+
+namespace facebook::velox::exec {
+
+void radixSort(
+    std::vector<RadixSortEntry>& entries,
+    std::vector<RadixSortEntry>& scratch) {
+  constexpr int32_t kNumDigits = sizeof(uint64_t);
+  constexpr int32_t kNumBuckets = 256;
+  const auto numEntries = entries.size();
+  if (numEntries < 2) {
+    return;
+  }
+
+  // Counts the values of all the digits in a single pass over the keys.
+  std::vector<std::array<size_t, kNumBuckets>> counts(kNumDigits);
+  for (const auto& entry : entries) {
+    for (auto digit = 0; digit < kNumDigits; ++digit) {
+      ++counts[digit][(entry.key >> (8 * digit)) & 0xff];
+    }
+  }
+
+  scratch.resize(numEntries);
+  auto* source = &entries;
+  auto* target = &scratch;
+  for (auto digit = 0; digit < kNumDigits; ++digit) {
+    auto& offsets = counts[digit];
+    const auto shift = 8 * digit;
+    if (offsets[(entries[0].key >> shift) & 0xff] == numEntries) {
+      // All the keys have the same value of this digit.
+      continue;
+    }
+    size_t offset = 0;
+    for (auto& count : offsets) {
+      const auto bucketSize = count;
+      count = offset;
+      offset += bucketSize;
+    }
+    for (const auto& entry : *source) {
+      (*target)[offsets[(entry.key >> shift) & 0xff]++] = entry;
+    }
+    std::swap(source, target);
+  }
+  if (source != &entries) {
+    entries.swap(scratch);
+  }
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace facebook::velox::exec {
+
+/// A row with the unsigned key to sort it on, e.g. a SortKeyPrefix.
+struct RadixSortEntry {
+  uint64_t key;
+  char* row;
+};
+
+/// Sorts 'entries' in ascending order of their keys with a least significant
+/// digit first radix sort on the bytes of the keys. The sort is stable. The
+/// bytes that are the same in all the keys, e.g. the unused low bytes of a
+/// SortKeyPrefix, cost a single counting pass. 'scratch' is resized to the
+/// size of 'entries' and used as the second buffer.
+void radixSort(
+    std::vector<RadixSortEntry>& entries,
+    std::vector<RadixSortEntry>& scratch);
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/RangeJoinBuild.h"
+#include "velox/exec/Task.h"
+
+namespace facebook::velox::exec {
+
+void RangeJoinBridge::setTable(std::shared_ptr<const RangeJoinTable> table) {
+  VELOX_CHECK_NOT_NULL(table);
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK_NULL(table_, "setTable may be called only once");
+    table_ = std::move(table);
+    promises = std::move(promises_);
+  }
+  notify(std::move(promises));
+}
+
+std::shared_ptr<const RangeJoinTable> RangeJoinBridge::tableOrFuture(
+    ContinueFuture* future) {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(!cancelled_, "Getting data after the build side is aborted");
+  if (table_) {
+    return table_;
+  }
+  promises_.emplace_back("RangeJoinBridge::tableOrFuture");
+  *future = promises_.back().getSemiFuture();
+  return nullptr;
+}
+
+RangeJoinBuild::RangeJoinBuild(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    std::shared_ptr<const core::RangeJoinNode> joinNode)
+    : Operator(
+          driverCtx,
+          nullptr,
+          operatorId,
+          joinNode->id(),
+          "RangeJoinBuild"),
+      inputType_(joinNode->sources()[1]->outputType()),
+      lowerChannel_(inputType_->getChildIdx(joinNode->lowerKey()->name())),
+      upperChannel_(inputType_->getChildIdx(joinNode->upperKey()->name())) {}
+
+void RangeJoinBuild::addInput(RowVectorPtr input) {
+  if (input->size() > 0) {
+    // Load lazy vectors before storing.
+    for (auto& child : input->children()) {
+      child->loadedVector();
+    }
+    data_.emplace_back(std::move(input));
+  }
+}
+
+std::shared_ptr<const RangeJoinTable> RangeJoinBuild::makeTable() {
+  auto table = std::make_shared<RangeJoinTable>();
+  table->lowerChannel = lowerChannel_;
+  table->upperChannel = upperChannel_;
+
+  RowVectorPtr input;
+  if (data_.size() == 1) {
+    input = std::move(data_.front());
+  } else {
+    vector_size_t numRows = 0;
+    for (const auto& vector : data_) {
+      numRows += vector->size();
+    }
+    input = BaseVector::create<RowVector>(inputType_, numRows, pool());
+    vector_size_t offset = 0;
+    for (const auto& vector : data_) {
+      input->copy(vector.get(), offset, 0, vector->size());
+      offset += vector->size();
+    }
+  }
+  data_.clear();
+
+  // Sort the rows with non-null bounds on the lower bound.
+  const auto& lower = input->childAt(lowerChannel_);
+  const auto& upper = input->childAt(upperChannel_);
+  std::vector<vector_size_t> indices;
+  indices.reserve(input->size());
+  for (auto i = 0; i < input->size(); ++i) {
+    if (!lower->isNullAt(i) && !upper->isNullAt(i)) {
+      indices.push_back(i);
+    }
+  }
+  lower->sortIndices(indices, CompareFlags());
+
+  // Copy the sorted rows, a run of consecutive input rows at a time.
+  std::vector<BaseVector::CopyRange> ranges;
+  for (auto i = 0; i < indices.size(); ++i) {
+    if (!ranges.empty() &&
+        ranges.back().sourceIndex + ranges.back().count == indices[i]) {
+      ++ranges.back().count;
+    } else {
+      ranges.push_back({indices[i], i, 1});
+    }
+  }
+  table->rows = BaseVector::create<RowVector>(
+      inputType_, static_cast<vector_size_t>(indices.size()), pool());
+  table->rows->copyRanges(
+      input.get(), folly::Range(ranges.data(), ranges.size()));
+
+  const auto& sortedUpper = table->rows->childAt(upperChannel_);
+  table->maxUpperRows.resize(table->size());
+  vector_size_t maxUpperRow = 0;
+  for (auto i = 0; i < table->size(); ++i) {
+    if (sortedUpper->compare(sortedUpper.get(), i, maxUpperRow) > 0) {
+      maxUpperRow = i;
+    }
+    table->maxUpperRows[i] = maxUpperRow;
+  }
+  return table;
+}
+
+BlockingReason RangeJoinBuild::isBlocked(ContinueFuture* future) {
+  if (!future_.valid()) {
+    return BlockingReason::kNotBlocked;
+  }
+  *future = std::move(future_);
+  return BlockingReason::kWaitForJoinBuild;
+}
+
+void RangeJoinBuild::noMoreInput() {
+  Operator::noMoreInput();
+  std::vector<ContinuePromise> promises;
+  std::vector<std::shared_ptr<Driver>> peers;
+  // The last Driver to finish gathers the data from all build Drivers, sorts
+  // it and hands it over to the probe side.
+  if (!operatorCtx_->task()->allPeersFinished(
+          planNodeId(), operatorCtx_->driver(), &future_, promises, peers)) {
+    return;
+  }
+
+  for (auto& peer : peers) {
+    auto op = peer->findOperator(planNodeId());
+    auto* build = dynamic_cast<RangeJoinBuild*>(op);
+    VELOX_CHECK(build);
+    data_.insert(data_.end(), build->data_.begin(), build->data_.end());
+    build->data_.clear();
+  }
+
+  // Realize the promises so that the other Drivers (which were not
+  // the last to finish) can continue from the barrier and finish.
+  peers.clear();
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+
+  operatorCtx_->task()
+      ->getRangeJoinBridge(
+          operatorCtx_->driverCtx()->splitGroupId, planNodeId())
+      ->setTable(makeTable());
+}
+
+bool RangeJoinBuild::isFinished() {
+  return !future_.valid() && noMoreInput_;
+}
+} // namespace facebook::velox::exec
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/JoinBridge.h"
+#include "velox/exec/Operator.h"
+
+namespace facebook::velox::exec {
+
+/// The build side of a range join: the right side rows sorted on the lower
+/// bound, without the rows with a null bound.
+struct RangeJoinTable {
+  RowVectorPtr rows;
+
+  /// Channels of the lower and upper bounds in 'rows'.
+  column_index_t lowerChannel;
+  column_index_t upperChannel;
+
+  /// The row with the largest upper bound among rows [0, i] for each i. A
+  /// probe key larger than the upper bound at maxUpperRows[i] has no match in
+  /// rows [0, i].
+  std::vector<vector_size_t> maxUpperRows;
+
+  vector_size_t size() const {
+    return rows->size();
+  }
+};
+
+class RangeJoinBridge : public JoinBridge {
+ public:
+  void setTable(std::shared_ptr<const RangeJoinTable> table);
+
+  std::shared_ptr<const RangeJoinTable> tableOrFuture(ContinueFuture* future);
+
+ private:
+  std::shared_ptr<const RangeJoinTable> table_;
+};
+
+class RangeJoinBuild : public Operator {
+ public:
+  RangeJoinBuild(
+      int32_t operatorId,
+      DriverCtx* driverCtx,
+      std::shared_ptr<const core::RangeJoinNode> joinNode);
+
+  void addInput(RowVectorPtr input) override;
+
+  RowVectorPtr getOutput() override {
+    return nullptr;
+  }
+
+  bool needsInput() const override {
+    return !noMoreInput_;
+  }
+
+  void noMoreInput() override;
+
+  BlockingReason isBlocked(ContinueFuture* future) override;
+
+  bool isFinished() override;
+
+  void close() override {
+    data_.clear();
+    Operator::close();
+  }
+
+ private:
+  // Sorts the rows in 'data_' on the lower bound into a single vector.
+  std::shared_ptr<const RangeJoinTable> makeTable();
+
+  const RowTypePtr inputType_;
+  const column_index_t lowerChannel_;
+  const column_index_t upperChannel_;
+
+  std::vector<RowVectorPtr> data_;
+
+  // Future for synchronizing with other Drivers of the same pipeline. All build
+  // Drivers must be completed before making data available for the probe side.
+  ContinueFuture future_{ContinueFuture::makeEmpty()};
+};
+
+} // namespace facebook::velox::exec
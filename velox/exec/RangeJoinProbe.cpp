@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/RangeJoinProbe.h"
+#include "velox/exec/Task.h"
+
+namespace facebook::velox::exec {
+
+RangeJoinProbe::RangeJoinProbe(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    const std::shared_ptr<const core::RangeJoinNode>& joinNode)
+    : Operator(
+          driverCtx,
+          joinNode->outputType(),
+          operatorId,
+          joinNode->id(),
+          "RangeJoinProbe"),
+      outputBatchSize_{static_cast<vector_size_t>(
+          driverCtx->queryConfig().preferredOutputBatchSize())},
+      joinType_{joinNode->joinType()} {
+  auto probeType = joinNode->sources()[0]->outputType();
+  probeKeyChannel_ = probeType->getChildIdx(joinNode->probeKey()->name());
+  for (auto i = 0; i < probeType->size(); ++i) {
+    auto outIndex = outputType_->getChildIdxIfExists(probeType->nameOf(i));
+    if (outIndex.has_value()) {
+      identityProjections_.emplace_back(i, outIndex.value());
+    }
+  }
+
+  auto buildType = joinNode->sources()[1]->outputType();
+  for (auto i = 0; i < outputType_->size(); ++i) {
+    auto tableChannel = buildType->getChildIdxIfExists(outputType_->nameOf(i));
+    if (tableChannel.has_value()) {
+      buildProjections_.emplace_back(tableChannel.value(), i);
+    }
+  }
+}
+
+BlockingReason RangeJoinProbe::isBlocked(ContinueFuture* future) {
+  if (table_) {
+    return BlockingReason::kNotBlocked;
+  }
+
+  auto table =
+      operatorCtx_->task()
+          ->getRangeJoinBridge(
+              operatorCtx_->driverCtx()->splitGroupId, planNodeId())
+          ->tableOrFuture(future);
+  if (!table) {
+    return BlockingReason::kWaitForJoinBuild;
+  }
+
+  table_ = std::move(table);
+  if (table_->size() == 0) {
+    // Build side is empty. An inner join returns no rows and terminates the
+    // pipeline early. A left join returns the probe rows with nulls.
+    buildSideEmpty_ = true;
+  }
+  return BlockingReason::kNotBlocked;
+}
+
+void RangeJoinProbe::addInput(RowVectorPtr input) {
+  // The output wraps the input in dictionaries a batch at a time. Since lazy
+  // vectors cannot be wrapped in different dictionaries, load them here.
+  for (auto& child : input->children()) {
+    child->loadedVector();
+  }
+  input_ = std::move(input);
+  probeRow_ = 0;
+  probeRowStarted_ = false;
+}
+
+vector_size_t RangeJoinProbe::numCandidates(vector_size_t row) const {
+  const auto& key = input_->childAt(probeKeyChannel_);
+  const auto& lower = table_->rows->childAt(table_->lowerChannel);
+  vector_size_t begin = 0;
+  vector_size_t end = table_->size();
+  while (begin < end) {
+    const auto mid = begin + (end - begin) / 2;
+    if (lower->compare(key.get(), mid, row) <= 0) {
+      begin = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+  return begin;
+}
+
+RowVectorPtr RangeJoinProbe::getOutput() {
+  if (!input_) {
+    return nullptr;
+  }
+
+  if (buildSideEmpty_) {
+    RowVectorPtr output;
+    if (!isInnerJoin()) {
+      output = fillMissOutput();
+    }
+    input_.reset();
+    return output;
+  }
+
+  const auto numInput = input_->size();
+  const auto& key = input_->childAt(probeKeyChannel_);
+  const auto& upper = table_->rows->childAt(table_->upperChannel);
+
+  auto probeIndices = allocateIndices(outputBatchSize_, pool());
+  auto* rawProbeIndices = probeIndices->asMutable<vector_size_t>();
+  auto buildIndices = allocateIndices(outputBatchSize_, pool());
+  auto* rawBuildIndices = buildIndices->asMutable<vector_size_t>();
+  BufferPtr buildNulls;
+  uint64_t* rawBuildNulls = nullptr;
+
+  vector_size_t numOutput = 0;
+  while (probeRow_ < numInput && numOutput < outputBatchSize_) {
+    if (!probeRowStarted_) {
+      probeRowStarted_ = true;
+      probeRowMatched_ = false;
+      buildRow_ = key->isNullAt(probeRow_) ? 0 : numCandidates(probeRow_);
+    }
+
+    // Check the candidates from the largest lower bound down. Stop at the
+    // first row at or below which all upper bounds are less than the key.
+    while (buildRow_ > 0 && numOutput < outputBatchSize_) {
+      const auto row = buildRow_ - 1;
+      if (upper->compare(key.get(), table_->maxUpperRows[row], probeRow_) <
+          0) {
+        buildRow_ = 0;
+        break;
+      }
+      if (upper->compare(key.get(), row, probeRow_) >= 0) {
+        rawProbeIndices[numOutput] = probeRow_;
+        rawBuildIndices[numOutput] = row;
+        ++numOutput;
+        probeRowMatched_ = true;
+      }
+      --buildRow_;
+    }
+
+    if (buildRow_ > 0) {
+      // The output batch is full. Continue with 'probeRow_' on the next call.
+      break;
+    }
+
+    if (!probeRowMatched_ && !isInnerJoin()) {
+      if (!buildNulls) {
+        buildNulls = allocateNulls(outputBatchSize_, pool(), bits::kNotNull);
+        rawBuildNulls = buildNulls->asMutable<uint64_t>();
+      }
+      bits::setNull(rawBuildNulls, numOutput);
+      rawProbeIndices[numOutput] = probeRow_;
+      rawBuildIndices[numOutput] = 0;
+      ++numOutput;
+    }
+    probeRowStarted_ = false;
+    ++probeRow_;
+  }
+
+  RowVectorPtr output;
+  if (numOutput > 0) {
+    output = makeOutput(
+        numOutput,
+        std::move(probeIndices),
+        std::move(buildIndices),
+        std::move(buildNulls));
+  }
+  if (probeRow_ == numInput) {
+    input_.reset();
+  }
+  return output;
+}
+
+RowVectorPtr RangeJoinProbe::makeOutput(
+    vector_size_t size,
+    BufferPtr probeIndices,
+    BufferPtr buildIndices,
+    BufferPtr buildNulls) {
+  auto output = fillOutput(size, std::move(probeIndices));
+  for (const auto& projection : buildProjections_) {
+    output->childAt(projection.outputChannel) = BaseVector::wrapInDictionary(
+        buildNulls,
+        buildIndices,
+        size,
+        table_->rows->childAt(projection.inputChannel));
+  }
+  return output;
+}
+
+RowVectorPtr RangeJoinProbe::fillMissOutput() {
+  const auto size = input_->size();
+  auto output = fillOutput(size, nullptr);
+  for (const auto& projection : buildProjections_) {
+    output->childAt(projection.outputChannel) = BaseVector::createNullConstant(
+        outputType_->childAt(projection.outputChannel), size, pool());
+  }
+  return output;
+}
+
+bool RangeJoinProbe::isFinished() {
+  return (buildSideEmpty_ && isInnerJoin()) ||
+      (noMoreInput_ && input_ == nullptr);
+}
+} // namespace facebook::velox::exec
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/Operator.h"
+#include "velox/exec/RangeJoinBuild.h"
+
+namespace facebook::velox::exec {
+
+/// Finds the build side ranges containing the key of each probe row by binary
+/// search over the build rows sorted on the lower bound. Produces the output
+/// by wrapping the probe and build vectors in dictionaries.
+class RangeJoinProbe : public Operator {
+ public:
+  RangeJoinProbe(
+      int32_t operatorId,
+      DriverCtx* driverCtx,
+      const std::shared_ptr<const core::RangeJoinNode>& joinNode);
+
+  void addInput(RowVectorPtr input) override;
+
+  RowVectorPtr getOutput() override;
+
+  bool needsInput() const override {
+    return !noMoreInput_ && !input_ && !(buildSideEmpty_ && isInnerJoin());
+  }
+
+  BlockingReason isBlocked(ContinueFuture* future) override;
+
+  bool isFinished() override;
+
+  void close() override {
+    table_.reset();
+    Operator::close();
+  }
+
+ private:
+  bool isInnerJoin() const {
+    return core::isInnerJoin(joinType_);
+  }
+
+  // Returns the number of build rows with a lower bound <= the key of probe
+  // row 'row'. Only these rows can match.
+  vector_size_t numCandidates(vector_size_t row) const;
+
+  // Returns the output for 'size' pairs of probe rows in 'probeIndices' and
+  // build rows in 'buildIndices'. 'buildNulls' marks the probe rows without a
+  // match in a left join. Null if there are no such rows.
+  RowVectorPtr makeOutput(
+      vector_size_t size,
+      BufferPtr probeIndices,
+      BufferPtr buildIndices,
+      BufferPtr buildNulls);
+
+  // Returns 'input_' with nulls in the build side columns. Used for a left
+  // join with an empty build side.
+  RowVectorPtr fillMissOutput();
+
+  // Maximum number of rows in the output batch.
+  const vector_size_t outputBatchSize_;
+
+  const core::JoinType joinType_;
+
+  column_index_t probeKeyChannel_;
+
+  std::vector<IdentityProjection> buildProjections_;
+
+  std::shared_ptr<const RangeJoinTable> table_;
+
+  bool buildSideEmpty_{false};
+
+  // The next probe row of 'input_' to find the matches for.
+  vector_size_t probeRow_{0};
+
+  // True if the candidates of 'probeRow_' have been found.
+  bool probeRowStarted_{false};
+
+  // True if 'probeRow_' has at least one match so far.
+  bool probeRowMatched_{false};
+
+  // The candidates of 'probeRow_' left to check are build rows [0,
+  // 'buildRow_'). Checked from the largest lower bound down.
+  vector_size_t buildRow_{0};
+};
+
+} // namespace facebook::velox::exec
@@ -16,6 +16,8 @@
 
 #include "velox/exec/RowContainer.h"
 
+#include <numeric>
+
 #include "velox/exec/ContainerRowSerde.h"
 
 namespace facebook::velox::exec {
@@ -55,14 +57,16 @@ RowContainer::RowContainer(
     bool hasProbedFlag,
     bool hasNormalizedKeys,
     memory::MemoryPool* pool,
-    const RowSerde& serde)
+    const RowSerde& serde,
+    bool appendOnlyStrings,
+    bool compactLayout)
     : keyTypes_(keyTypes),
       nullableKeys_(nullableKeys),
       aggregates_(aggregates),
       isJoinBuild_(isJoinBuild),
       hasNormalizedKeys_(hasNormalizedKeys),
       rows_(pool),
-      stringAllocator_(pool),
+      stringAllocator_(pool, appendOnlyStrings),
       serde_(serde) {
   // Compute the layout of the payload row.  The row has keys, null
   // flags, accumulators, dependent fields. All fields are fixed
@@ -104,8 +108,11 @@ RowContainer::RowContainer(
     }
   }
   // Make offset at least sizeof pointer so that there is space for a
-  // free list next pointer below the bit at 'freeFlagOffset_'.
-  offset = std::max<int32_t>(offset, sizeof(void*));
+  // free list next pointer below the bit at 'freeFlagOffset_'. A compact
+  // layout places the pointer after the flags instead.
+  if (!compactLayout) {
+    offset = std::max<int32_t>(offset, sizeof(void*));
+  }
   int32_t firstAggregate = offsets_.size();
   int32_t firstAggregateOffset = offset;
   for (auto& aggregate : aggregates) {
@@ -138,12 +145,31 @@ RowContainer::RowContainer(
   }
   int32_t nullBytes = bits::nbytes(nullOffsets_.size());
   offset += nullBytes;
-  for (auto& aggregate : aggregates) {
+  if (compactLayout) {
+    nextFreeOffset_ = offset;
+  }
+  // A compact layout places the accumulators with the largest alignment
+  // first so that fewer bytes are lost to alignment padding.
+  std::vector<int32_t> aggregateOrder(aggregates.size());
+  std::iota(aggregateOrder.begin(), aggregateOrder.end(), 0);
+  if (compactLayout) {
+    std::stable_sort(
+        aggregateOrder.begin(),
+        aggregateOrder.end(),
+        [&](int32_t left, int32_t right) {
+          return aggregates[left]->accumulatorAlignmentSize() >
+              aggregates[right]->accumulatorAlignmentSize();
+        });
+  }
+  std::vector<int32_t> aggregateOffsets(aggregates.size());
+  for (auto i : aggregateOrder) {
     // Accumulator offset must be aligned by their alignment size.
-    offset = bits::roundUp(offset, aggregate->accumulatorAlignmentSize());
-    offsets_.push_back(offset);
-    offset += aggregate->accumulatorFixedWidthSize();
+    offset = bits::roundUp(offset, aggregates[i]->accumulatorAlignmentSize());
+    aggregateOffsets[i] = offset;
+    offset += aggregates[i]->accumulatorFixedWidthSize();
   }
+  offsets_.insert(
+      offsets_.end(), aggregateOffsets.begin(), aggregateOffsets.end());
   for (auto& type : dependentTypes) {
     offsets_.push_back(offset);
     offset += typeKindSize(type->kind());
@@ -156,6 +182,7 @@ RowContainer::RowContainer(
     nextOffset_ = offset;
     offset += sizeof(void*);
   }
+  offset = std::max<int32_t>(offset, nextFreeOffset_ + sizeof(void*));
   fixedRowSize_ = bits::roundUp(offset, alignment_);
   for (int i = 0; i < aggregates_.size(); ++i) {
     nullOffset = nullOffsets_[i + firstAggregate];
@@ -514,6 +541,70 @@ void RowContainer::clear() {
   firstFreeRow_ = nullptr;
 }
 
+bool RowContainer::compactStrings(double minFreeFraction) {
+  // Below this size there are too few runs in the string allocator for
+  // compaction to pay off.
+  constexpr int64_t kMinCompactBytes = 1 << 20;
+  const int64_t retainedBytes = stringAllocator_.retainedSize();
+  if (usesExternalMemory_ || retainedBytes < kMinCompactBytes ||
+      stringAllocator_.freeSpace() < retainedBytes * minFreeFraction) {
+    return false;
+  }
+  std::vector<RowColumn> columns;
+  for (auto i = 0; i < types_.size(); ++i) {
+    switch (typeKinds_[i]) {
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+      case TypeKind::ROW:
+      case TypeKind::ARRAY:
+      case TypeKind::MAP:
+        columns.push_back(columnAt(i));
+        break;
+      default:;
+    }
+  }
+  if (columns.empty()) {
+    return false;
+  }
+
+  // Visits the non-inline values of the variable width columns of the live
+  // rows in the same order on each call.
+  constexpr int32_t kBatch = 1000;
+  std::vector<char*> rows(kBatch);
+  auto forEachString = [&](auto func) {
+    RowContainerIterator iter;
+    while (auto numRows = listRows(&iter, kBatch, rows.data())) {
+      for (auto i = 0; i < numRows; ++i) {
+        for (const auto& column : columns) {
+          if (isNullAt(rows[i], column.nullByte(), column.nullMask())) {
+            continue;
+          }
+          auto& view = valueAt<StringView>(rows[i], column.offset());
+          if (!view.isInline()) {
+            func(rows[i], column.offset(), view);
+          }
+        }
+      }
+    }
+  };
+
+  std::string buffer;
+  std::string storage;
+  forEachString([&](char* /*row*/, int32_t /*offset*/, StringView view) {
+    auto contiguous = HashStringAllocator::contiguousString(view, storage);
+    buffer.append(contiguous.data(), contiguous.size());
+  });
+  stringAllocator_.clear();
+  int64_t bufferOffset = 0;
+  forEachString([&](char* row, int32_t offset, StringView& view) {
+    view = StringView(buffer.data() + bufferOffset, view.size());
+    bufferOffset += view.size();
+    stringAllocator_.copyMultipart(row, offset);
+  });
+  VELOX_CHECK_EQ(bufferOffset, buffer.size());
+  return true;
+}
+
 void RowContainer::setProbedFlag(char** rows, int32_t numRows) {
   for (auto i = 0; i < numRows; i++) {
     // Row may be null in case of a FULL join.
@@ -137,6 +137,15 @@ class RowContainer {
       const std::vector<TypePtr>& keyTypes,
       const std::vector<TypePtr>& dependentTypes,
       memory::MemoryPool* FOLLY_NONNULL pool)
+      : RowContainer(keyTypes, dependentTypes, false, pool) {}
+
+  // An order by or top n container may reserve a normalized key word
+  // below each row for a SortKeyPrefix.
+  RowContainer(
+      const std::vector<TypePtr>& keyTypes,
+      const std::vector<TypePtr>& dependentTypes,
+      bool hasNormalizedKey,
+      memory::MemoryPool* FOLLY_NONNULL pool)
       : RowContainer(
             keyTypes,
             true, // nullableKeys
@@ -145,7 +154,7 @@ class RowContainer {
             false, // hasNext
             false, // isJoinBuild
             false, // hasProbedFlag
-            false, // hasNormalizedKey
+            hasNormalizedKey,
             pool,
             ContainerRowSerde::instance()) {}
 
@@ -164,7 +173,14 @@ class RowContainer {
   // below each row for a normalized key that collapses all parts
   // into one word for faster comparison. The bulk allocation is done
   // from 'allocator'.  'serde_' is used for serializing complex
-  // type values into the container.
+  // type values into the container. If 'appendOnlyStrings' is true, the
+  // variable length data and the accumulator memory is allocated
+  // append-only and is freed only by clear(). See
+  // HashStringAllocator. If 'compactLayout' is true, the null flags follow
+  // the keys without padding, accumulators are placed in decreasing order of
+  // alignment and the pointer to the next free row of a free row is placed
+  // after the flags. This shortens rows with small keys or accumulators of
+  // mixed alignment.
   RowContainer(
       const std::vector<TypePtr>& keyTypes,
       bool nullableKeys,
@@ -175,7 +191,9 @@ class RowContainer {
       bool hasProbedFlag,
       bool hasNormalizedKey,
       memory::MemoryPool* FOLLY_NONNULL pool,
-      const RowSerde& serde);
+      const RowSerde& serde,
+      bool appendOnlyStrings = false,
+      bool compactLayout = false);
 
   // Allocates a new row and initializes possible aggregates to null.
   char* FOLLY_NONNULL newRow();
@@ -477,6 +495,11 @@ class RowContainer {
     return reinterpret_cast<normalized_key_t*>(group)[-1];
   }
 
+  static inline normalized_key_t normalizedKey(
+      const char* FOLLY_NONNULL group) {
+    return reinterpret_cast<const normalized_key_t*>(group)[-1];
+  }
+
   void disableNormalizedKeys() {
     normalizedKeySize_ = 0;
   }
@@ -533,6 +556,16 @@ class RowContainer {
   // Resets the state to be as after construction. Frees memory for payload.
   void clear();
 
+  // Moves the out of line data of the variable width columns of the live rows
+  // to new storage and frees the storage of the string allocator, including
+  // the runs that erased rows left sparse. The rows stay in place. Does
+  // nothing and returns false if less than 'minFreeFraction' of the retained
+  // size of the string allocator is free, or if the accumulators keep data in
+  // the string allocator since that data can't be moved. The live data is
+  // staged in a temporary buffer. Must not be called while StringViews
+  // pointing into the container are in use, e.g. between batches.
+  bool compactStrings(double minFreeFraction = 0.5);
+
   int32_t compareRows(
       const char* FOLLY_NONNULL left,
       const char* FOLLY_NONNULL right,
@@ -625,9 +658,6 @@ class RowContainer {
   void skip(RowContainerIterator& iterator, int32_t numRows);
 
  private:
-  // Offset of the pointer to the next free row on a free row.
-  static constexpr int32_t kNextFreeOffset = 0;
-
   template <typename T>
   static inline T valueAt(const char* FOLLY_NONNULL group, int32_t offset) {
     return *reinterpret_cast<const T*>(group + offset);
@@ -693,7 +723,7 @@ class RowContainer {
   }
 
   char* FOLLY_NULLABLE& nextFree(char* FOLLY_NONNULL row) {
-    return *reinterpret_cast<char**>(row + kNextFreeOffset);
+    return *reinterpret_cast<char**>(row + nextFreeOffset_);
   }
 
   uint32_t& variableRowSize(char* FOLLY_NONNULL row) {
@@ -1054,6 +1084,11 @@ class RowContainer {
   int32_t freeFlagOffset_ = 0;
   int32_t rowSizeOffset_ = 0;
 
+  // Offset of the pointer to the next free row on a free row. The pointer
+  // overwrites the keys or the fields after the flags. It never overlaps the
+  // free flag.
+  int32_t nextFreeOffset_ = 0;
+
   int32_t fixedRowSize_;
   // True if normalized keys are enabled in initial state.
   const bool hasNormalizedKeys_;
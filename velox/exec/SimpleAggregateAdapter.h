@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/exec/Aggregate.h"
+#include "velox/expression/FunctionSignature.h"
+#include "velox/vector/DecodedVector.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::exec {
+
+/// Adapts a simple aggregate function written over a typed accumulator to the
+/// vectorized Aggregate interface. The adapter decodes the arguments, handles
+/// nulls and provides the grouped and single group loops for the raw input and
+/// the intermediate results. 'TFunc' only defines how one accumulator is
+/// updated, e.g.:
+///
+///   struct SumFunction {
+///     using InputType = int64_t;
+///     using IntermediateType = int64_t;
+///     using OutputType = int64_t;
+///
+///     // True if a group without non-null input produces null.
+///     static constexpr bool kNullOnEmpty = true;
+///
+///     struct Accumulator {
+///       int64_t sum{0};
+///     };
+///
+///     static void addInput(Accumulator& acc, int64_t value) {
+///       acc.sum += value;
+///     }
+///     static void combine(Accumulator& acc, int64_t other) {
+///       acc.sum += other;
+///     }
+///     static int64_t toIntermediate(const Accumulator& acc) {
+///       return acc.sum;
+///     }
+///     static int64_t finalize(const Accumulator& acc) {
+///       return acc.sum;
+///     }
+///   };
+///
+/// The input, intermediate and output types are the C++ types of fixed width
+/// scalar Velox types, e.g. bool, int64_t or double. The accumulator is stored
+/// in the group row. It is value initialized for each new group and must be
+/// trivially destructible. Null input rows and null intermediate results are
+/// skipped. Functions with a single argument are supported.
+template <typename TFunc>
+class SimpleAggregateAdapter : public Aggregate {
+ public:
+  using Accumulator = typename TFunc::Accumulator;
+  using InputType = typename TFunc::InputType;
+  using IntermediateType = typename TFunc::IntermediateType;
+  using OutputType = typename TFunc::OutputType;
+
+  static_assert(
+      std::is_trivially_destructible_v<Accumulator>,
+      "The accumulator of a simple aggregate must be trivially destructible");
+
+  explicit SimpleAggregateAdapter(TypePtr resultType)
+      : Aggregate(std::move(resultType)) {}
+
+  int32_t accumulatorFixedWidthSize() const override {
+    return sizeof(Accumulator);
+  }
+
+  int32_t accumulatorAlignmentSize() const override {
+    // Accumulators of up to 8 bytes alignment are accessed unaligned like
+    // those of the other fixed width aggregates.
+    return alignof(Accumulator) > 8 ? alignof(Accumulator) : 1;
+  }
+
+  void initializeNewGroups(
+      char** groups,
+      folly::Range<const vector_size_t*> indices) override {
+    if constexpr (TFunc::kNullOnEmpty) {
+      setAllNulls(groups, indices);
+    }
+    for (auto i : indices) {
+      new (value<Accumulator>(groups[i])) Accumulator{};
+    }
+  }
+
+  void addRawInput(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decoded_.decode(*args[0], rows);
+    updateGroups<InputType>(
+        groups, rows, [](Accumulator& accumulator, InputType input) {
+          TFunc::addInput(accumulator, input);
+        });
+  }
+
+  void addIntermediateResults(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decoded_.decode(*args[0], rows);
+    updateGroups<IntermediateType>(
+        groups,
+        rows,
+        [](Accumulator& accumulator, IntermediateType intermediate) {
+          TFunc::combine(accumulator, intermediate);
+        });
+  }
+
+  void addSingleGroupRawInput(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decoded_.decode(*args[0], rows);
+    updateOneGroup<InputType>(
+        group, rows, [](Accumulator& accumulator, InputType input) {
+          TFunc::addInput(accumulator, input);
+        });
+  }
+
+  void addSingleGroupIntermediateResults(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decoded_.decode(*args[0], rows);
+    updateOneGroup<IntermediateType>(
+        group,
+        rows,
+        [](Accumulator& accumulator, IntermediateType intermediate) {
+          TFunc::combine(accumulator, intermediate);
+        });
+  }
+
+  void extractValues(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    extract<OutputType>(
+        groups, numGroups, result, [](const Accumulator& accumulator) {
+          return TFunc::finalize(accumulator);
+        });
+  }
+
+  void extractAccumulators(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    extract<IntermediateType>(
+        groups, numGroups, result, [](const Accumulator& accumulator) {
+          return TFunc::toIntermediate(accumulator);
+        });
+  }
+
+ private:
+  // The number of rows whose group rows are prefetched before any of them is
+  // updated.
+  static constexpr vector_size_t kPrefetchBatchSize = 64;
+
+  // Returns the accumulator of 'group' for an update and clears its null flag.
+  Accumulator& accumulatorForUpdate(char* group) {
+    if constexpr (TFunc::kNullOnEmpty) {
+      clearNull(group);
+    }
+    return *value<Accumulator>(group);
+  }
+
+  // Updates the accumulators of 'groups' with the values of 'decoded_' at the
+  // selected 'rows'.
+  template <typename T, typename Update>
+  void updateGroups(
+      char** groups,
+      const SelectivityVector& rows,
+      Update update) {
+    if (decoded_.isConstantMapping()) {
+      if (decoded_.isNullAt(0)) {
+        return;
+      }
+      const auto constant = decoded_.valueAt<T>(0);
+      rows.applyToSelected([&](vector_size_t i) {
+        update(accumulatorForUpdate(groups[i]), constant);
+      });
+    } else if (decoded_.mayHaveNulls()) {
+      rows.applyToSelected([&](vector_size_t i) {
+        if (!decoded_.isNullAt(i)) {
+          update(accumulatorForUpdate(groups[i]), decoded_.valueAt<T>(i));
+        }
+      });
+    } else if (
+        decoded_.isIdentityMapping() && !std::is_same_v<T, bool> &&
+        rows.isAllSelected()) {
+      updateFlatGroups(groups, rows, decoded_.data<T>(), update);
+    } else {
+      rows.applyToSelected([&](vector_size_t i) {
+        update(accumulatorForUpdate(groups[i]), decoded_.valueAt<T>(i));
+      });
+    }
+  }
+
+  // Updates the groups of the contiguous 'rows' from flat 'data' in batches.
+  // The group rows of a batch are prefetched before updating any of them so
+  // that the cache misses on the randomly accessed groups overlap.
+  template <typename T, typename Update>
+  void updateFlatGroups(
+      char** groups,
+      const SelectivityVector& rows,
+      const T* data,
+      Update update) {
+    for (auto begin = rows.begin(); begin < rows.end();
+         begin += kPrefetchBatchSize) {
+      const auto end = std::min(rows.end(), begin + kPrefetchBatchSize);
+      for (auto i = begin; i < end; ++i) {
+        __builtin_prefetch(groups[i] + offset_);
+      }
+      for (auto i = begin; i < end; ++i) {
+        update(accumulatorForUpdate(groups[i]), data[i]);
+      }
+    }
+  }
+
+  // Updates the accumulator of 'group' with the values of 'decoded_' at the
+  // selected 'rows'. Accumulates into a local copy that is written back once.
+  template <typename T, typename Update>
+  void
+  updateOneGroup(char* group, const SelectivityVector& rows, Update update) {
+    auto accumulator = *value<Accumulator>(group);
+    bool updated = false;
+    if (decoded_.isConstantMapping()) {
+      if (decoded_.isNullAt(0)) {
+        return;
+      }
+      const auto constant = decoded_.valueAt<T>(0);
+      rows.applyToSelected(
+          [&](vector_size_t /*i*/) { update(accumulator, constant); });
+      updated = true;
+    } else if (decoded_.mayHaveNulls()) {
+      rows.applyToSelected([&](vector_size_t i) {
+        if (!decoded_.isNullAt(i)) {
+          update(accumulator, decoded_.valueAt<T>(i));
+          updated = true;
+        }
+      });
+    } else if (decoded_.isIdentityMapping() && !std::is_same_v<T, bool>) {
+      const auto* data = decoded_.data<T>();
+      rows.applyToSelected(
+          [&](vector_size_t i) { update(accumulator, data[i]); });
+      updated = true;
+    } else {
+      rows.applyToSelected([&](vector_size_t i) {
+        update(accumulator, decoded_.valueAt<T>(i));
+      });
+      updated = true;
+    }
+    if (updated) {
+      accumulatorForUpdate(group) = accumulator;
+    }
+  }
+
+  template <typename T, typename ExtractOne>
+  void extract(
+      char** groups,
+      int32_t numGroups,
+      VectorPtr* result,
+      ExtractOne extractOne) {
+    auto* vector = (*result)->as<FlatVector<T>>();
+    VELOX_CHECK(
+        vector,
+        "Unexpected type of the result vector: {}",
+        (*result)->type()->toString());
+    vector->resize(numGroups);
+    for (auto i = 0; i < numGroups; ++i) {
+      char* group = groups[i];
+      if (isNull(group)) {
+        vector->setNull(i, true);
+      } else {
+        vector->set(i, extractOne(*value<Accumulator>(group)));
+      }
+    }
+  }
+
+  DecodedVector decoded_;
+};
+
+/// Registers 'TFunc' adapted by SimpleAggregateAdapter as the aggregate
+/// function 'name'. The types of 'signatures' must match the input,
+/// intermediate and output types of 'TFunc'.
+template <typename TFunc>
+bool registerSimpleAggregateFunction(
+    const std::string& name,
+    std::vector<std::shared_ptr<AggregateFunctionSignature>> signatures) {
+  return registerAggregateFunction(
+      name,
+      std::move(signatures),
+      [name](
+          core::AggregationNode::Step /*step*/,
+          const std::vector<TypePtr>& argTypes,
+          const TypePtr& resultType) -> std::unique_ptr<Aggregate> {
+        VELOX_CHECK_EQ(argTypes.size(), 1, "{} takes one argument", name);
+        return std::make_unique<SimpleAggregateAdapter<TFunc>>(resultType);
+      });
+}
+
+} // namespace facebook::velox::exec
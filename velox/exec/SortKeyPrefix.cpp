@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/SortKeyPrefix.h"
+
+#include <cmath>
+
+#include <folly/lang/Bits.h>
+
+#include "velox/exec/RowContainer.h"
+
+namespace facebook::velox::exec {
+namespace {
+// Returns the number of bytes of the order-preserving encoding of a key of
+// 'kind', or 0 if the kind is not supported.
+int32_t valueWidth(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+      return 1;
+    case TypeKind::SMALLINT:
+      return 2;
+    case TypeKind::INTEGER:
+    case TypeKind::REAL:
+    case TypeKind::DATE:
+      return 4;
+    case TypeKind::BIGINT:
+    case TypeKind::DOUBLE:
+    case TypeKind::SHORT_DECIMAL:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return SortKeyPrefix::kPrefixBytes;
+    default:
+      return 0;
+  }
+}
+
+bool isString(TypeKind kind) {
+  return kind == TypeKind::VARCHAR || kind == TypeKind::VARBINARY;
+}
+
+// Returns a mask of the low 'numBytes' bytes.
+uint64_t lowBytesMask(int32_t numBytes) {
+  return numBytes == sizeof(uint64_t) ? ~0ULL : (1ULL << (8 * numBytes)) - 1;
+}
+
+// Shifts 'prefix' left by 'numBytes' and sets the low bytes to 'value'.
+uint64_t append(uint64_t prefix, uint64_t value, int32_t numBytes) {
+  if (numBytes == sizeof(uint64_t)) {
+    return value;
+  }
+  return (prefix << (8 * numBytes)) | value;
+}
+
+// Maps a signed value to an unsigned one of the same width with the same
+// order.
+template <typename T>
+uint64_t flipSign(T value) {
+  using U = std::make_unsigned_t<T>;
+  return static_cast<U>(static_cast<U>(value) ^ (U(1) << (sizeof(T) * 8 - 1)));
+}
+
+// Maps a floating point value to an unsigned one of the same width with the
+// same order. Like RowContainer::compare(), orders all NaNs as equal and
+// larger than any other value and -0.0 as equal to 0.0.
+template <typename T, typename U>
+uint64_t flipFloatingPoint(T value) {
+  if (std::isnan(value)) {
+    value = std::numeric_limits<T>::quiet_NaN();
+  } else if (value == 0) {
+    value = 0;
+  }
+  U bits;
+  memcpy(&bits, &value, sizeof(bits));
+  constexpr U kSignBit = U(1) << (sizeof(U) * 8 - 1);
+  return (bits & kSignBit) ? static_cast<U>(~bits) : bits ^ kSignBit;
+}
+
+template <typename T>
+uint64_t orderedUnsigned(const T& /*value*/) {
+  VELOX_UNREACHABLE();
+}
+
+uint64_t orderedUnsigned(bool value) {
+  return value ? 1 : 0;
+}
+
+uint64_t orderedUnsigned(int8_t value) {
+  return flipSign(value);
+}
+
+uint64_t orderedUnsigned(int16_t value) {
+  return flipSign(value);
+}
+
+uint64_t orderedUnsigned(int32_t value) {
+  return flipSign(value);
+}
+
+uint64_t orderedUnsigned(int64_t value) {
+  return flipSign(value);
+}
+
+uint64_t orderedUnsigned(float value) {
+  return flipFloatingPoint<float, uint32_t>(value);
+}
+
+uint64_t orderedUnsigned(double value) {
+  return flipFloatingPoint<double, uint64_t>(value);
+}
+
+uint64_t orderedUnsigned(const Date& value) {
+  return flipSign(value.days());
+}
+
+uint64_t orderedUnsigned(const UnscaledShortDecimal& value) {
+  return flipSign(value.unscaledValue());
+}
+
+// Returns the leading bytes of 'value' as a big-endian integer padded with
+// zeros. This orders like comparing the strings with memcmp, except for ties.
+uint64_t orderedUnsigned(const StringView& value) {
+  uint64_t prefix = 0;
+  memcpy(
+      &prefix, value.data(), std::min<size_t>(value.size(), sizeof(prefix)));
+  return folly::Endian::big(prefix);
+}
+} // namespace
+
+// static
+bool SortKeyPrefix::isSupported(const TypePtr& type) {
+  return valueWidth(type->kind()) != 0;
+}
+
+SortKeyPrefix::SortKeyPrefix(
+    const std::vector<TypePtr>& keyTypes,
+    const std::vector<column_index_t>& channels,
+    const std::vector<CompareFlags>& flags) {
+  VELOX_CHECK_EQ(keyTypes.size(), channels.size());
+  VELOX_CHECK_EQ(keyTypes.size(), flags.size());
+  VELOX_CHECK(!keyTypes.empty() && isSupported(keyTypes[0]));
+  int32_t remainingBytes = kPrefixBytes;
+  for (auto i = 0; i < keyTypes.size() && remainingBytes > 0; ++i) {
+    const auto kind = keyTypes[i]->kind();
+    const auto width = valueWidth(kind);
+    if (width == 0) {
+      break;
+    }
+    Part part{
+        channels[i],
+        kind,
+        flags[i],
+        width,
+        std::min(width, remainingBytes),
+        false};
+    if (!isString(kind) && width < remainingBytes) {
+      // The key is encoded exactly and the next key may follow it.
+      part.hasNullByte = true;
+      remainingBytes -= width + 1;
+      parts_.push_back(part);
+      continue;
+    }
+    remainingBytes -= part.numBytes;
+    parts_.push_back(part);
+    break;
+  }
+  unusedBytes_ = remainingBytes;
+  isComplete_ = parts_.size() == keyTypes.size() && parts_.back().hasNullByte;
+}
+
+template <TypeKind Kind>
+uint64_t SortKeyPrefix::encodeRowValue(
+    const Part& part,
+    const char* row,
+    int32_t offset) {
+  using T = typename KindToFlatVector<Kind>::HashRowType;
+  return finishValue(
+      part, orderedUnsigned(*reinterpret_cast<const T*>(row + offset)));
+}
+
+template <TypeKind Kind>
+uint64_t SortKeyPrefix::encodeDecodedValue(
+    const Part& part,
+    const DecodedVector& decoded,
+    vector_size_t index) {
+  using T = typename KindToFlatVector<Kind>::HashRowType;
+  return finishValue(part, orderedUnsigned(decoded.valueAt<T>(index)));
+}
+
+// static
+uint64_t SortKeyPrefix::finishValue(const Part& part, uint64_t encoded) {
+  if (!part.flags.ascending) {
+    encoded = ~encoded & lowBytesMask(part.width);
+  }
+  return encoded >> (8 * (part.width - part.numBytes));
+}
+
+// static
+uint64_t SortKeyPrefix::appendPart(
+    uint64_t prefix,
+    const Part& part,
+    bool isNull,
+    uint64_t encoded) {
+  if (part.hasNullByte) {
+    // Sorts the nulls before or after all the non-null values.
+    const uint64_t nullByte = isNull ? (part.flags.nullsFirst ? 0 : 2) : 1;
+    prefix = append(prefix, nullByte, 1);
+    return append(prefix, isNull ? 0 : encoded, part.numBytes);
+  }
+  if (isNull) {
+    // A null ties with the lowest or the highest values. The keys are
+    // compared to break the tie.
+    encoded = part.flags.nullsFirst ? 0 : lowBytesMask(part.numBytes);
+  }
+  return append(prefix, encoded, part.numBytes);
+}
+
+uint64_t SortKeyPrefix::encode(const RowContainer& rows, const char* row)
+    const {
+  uint64_t prefix = 0;
+  for (const auto& part : parts_) {
+    const auto column = rows.columnAt(part.channel);
+    const bool isNull =
+        RowContainer::isNullAt(row, column.nullByte(), column.nullMask());
+    const uint64_t encoded = isNull
+        ? 0
+        : VELOX_DYNAMIC_TYPE_DISPATCH(
+              encodeRowValue, part.kind, part, row, column.offset());
+    prefix = appendPart(prefix, part, isNull, encoded);
+  }
+  return prefix << (8 * unusedBytes_);
+}
+
+uint64_t SortKeyPrefix::encode(
+    const std::vector<DecodedVector>& decoded,
+    vector_size_t index) const {
+  uint64_t prefix = 0;
+  for (const auto& part : parts_) {
+    const auto& keys = decoded[part.channel];
+    const bool isNull = keys.isNullAt(index);
+    const uint64_t encoded = isNull
+        ? 0
+        : VELOX_DYNAMIC_TYPE_DISPATCH(
+              encodeDecodedValue, part.kind, part, keys, index);
+    prefix = appendPart(prefix, part, isNull, encoded);
+  }
+  return prefix << (8 * unusedBytes_);
+}
+
+void SortKeyPrefix::encode(
+    const RowVector& input,
+    std::vector<uint64_t>& prefixes) {
+  const auto numRows = input.size();
+  rows_.resizeFill(numRows, true);
+  decoded_.resize(input.childrenSize());
+  for (const auto& part : parts_) {
+    decoded_[part.channel].decode(*input.childAt(part.channel), rows_);
+  }
+  prefixes.resize(numRows);
+  for (auto i = 0; i < numRows; ++i) {
+    prefixes[i] = encode(decoded_, i);
+  }
+}
+} // namespace facebook::velox::exec
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#pragma once
+
+#include "velox/common/base/CompareFlags.h"
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::exec {
+
+class RowContainer;
+
+/// Encodes the leading sorting keys of a row into a 64-bit prefix. Comparing
+/// the prefixes of two rows as unsigned integers, which is the same as
+/// comparing their big-endian bytes with memcmp, orders the rows like
+/// comparing their keys with the given CompareFlags, except that rows with
+/// different keys may have equal prefixes. A sort or merge compares the
+/// prefixes first and compares the keys one by one only if the prefixes are
+/// equal.
+///
+/// Boolean, integer, floating point, date and short decimal keys that fit in
+/// the remaining bytes are encoded as a null byte followed by the value bytes,
+/// so that the prefix can go on with the next key. A key that does not fit is
+/// truncated to the remaining bytes and ends the prefix, as does a string key,
+/// which contributes its leading bytes. Other key types end the prefix before
+/// them.
+class SortKeyPrefix {
+ public:
+  static constexpr int32_t kPrefixBytes = sizeof(uint64_t);
+
+  /// Returns true if a key of 'type' can start a prefix.
+  static bool isSupported(const TypePtr& type);
+
+  /// 'keyTypes', 'channels' and 'flags' give the type, the column and the
+  /// sort order of each sorting key. The columns are the same in the
+  /// RowContainers and the vectors to encode. The first key must be
+  /// supported.
+  SortKeyPrefix(
+      const std::vector<TypePtr>& keyTypes,
+      const std::vector<column_index_t>& channels,
+      const std::vector<CompareFlags>& flags);
+
+  /// Returns the prefix of 'row' in 'rows'.
+  uint64_t encode(const RowContainer& rows, const char* FOLLY_NONNULL row)
+      const;
+
+  /// Returns the prefix of row 'index' in 'decoded', which has one decoded
+  /// vector per column.
+  uint64_t encode(
+      const std::vector<DecodedVector>& decoded,
+      vector_size_t index) const;
+
+  /// Sets 'prefixes' to the prefix of each row in 'input'.
+  void encode(const RowVector& input, std::vector<uint64_t>& prefixes);
+
+  /// Returns the number of keys that contribute to the prefix.
+  int32_t numKeys() const {
+    return parts_.size();
+  }
+
+  /// Returns true if the prefix encodes all the keys exactly, so that rows
+  /// with equal prefixes have equal keys.
+  bool isComplete() const {
+    return isComplete_;
+  }
+
+ private:
+  struct Part {
+    column_index_t channel;
+    TypeKind kind;
+    CompareFlags flags;
+    // The number of bytes of the order-preserving encoding of the value.
+    int32_t width;
+    // The number of leading bytes of the encoding in the prefix.
+    int32_t numBytes;
+    // True if the value is preceded by a null byte and is not truncated.
+    bool hasNullByte;
+  };
+
+  template <TypeKind Kind>
+  static uint64_t encodeRowValue(
+      const Part& part,
+      const char* FOLLY_NONNULL row,
+      int32_t offset);
+
+  template <TypeKind Kind>
+  static uint64_t encodeDecodedValue(
+      const Part& part,
+      const DecodedVector& decoded,
+      vector_size_t index);
+
+  // Applies the sort order of 'part' to the 'width' bytes 'encoded' and
+  // returns the leading 'numBytes' of these.
+  static uint64_t finishValue(const Part& part, uint64_t encoded);
+
+  // Appends the bytes of 'part' to 'prefix'. 'encoded' is the result of
+  // finishValue() and is ignored if 'isNull' is true.
+  static uint64_t
+  appendPart(uint64_t prefix, const Part& part, bool isNull, uint64_t encoded);
+
+  std::vector<Part> parts_;
+
+  // The number of unused low bytes of the prefix.
+  int32_t unusedBytes_;
+
+  bool isComplete_;
+
+  // Reusable decoded key columns for encoding vectors.
+  std::vector<DecodedVector> decoded_;
+  SelectivityVector rows_;
+};
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/SortedAggregate.h"
+
+#include "velox/exec/ContainerRowSerde.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+CompareFlags toCompareFlags(const core::SortOrder& sortOrder) {
+  return {sortOrder.isNullsFirst(), sortOrder.isAscending(), false, false};
+}
+} // namespace
+
+SortedAggregate::SortedAggregate(
+    std::unique_ptr<Aggregate> aggregate,
+    const std::vector<TypePtr>& inputTypes,
+    const std::vector<TypePtr>& sortingKeyTypes,
+    const std::vector<core::SortOrder>& sortingOrders,
+    memory::MemoryPool* pool)
+    : Aggregate(aggregate->resultType()),
+      aggregate_(std::move(aggregate)),
+      numInputs_(inputTypes.size()),
+      pool_(pool) {
+  VELOX_CHECK(!sortingKeyTypes.empty());
+  VELOX_CHECK_EQ(sortingKeyTypes.size(), sortingOrders.size());
+  for (const auto& sortOrder : sortingOrders) {
+    compareFlags_.push_back(toCompareFlags(sortOrder));
+  }
+  static const std::vector<std::unique_ptr<Aggregate>> kNoAggregates;
+  data_ = std::make_unique<RowContainer>(
+      sortingKeyTypes,
+      true, // nullableKeys
+      kNoAggregates,
+      inputTypes,
+      true, // hasNext
+      false, // isJoinBuild
+      false, // hasProbedFlag
+      false, // hasNormalizedKey
+      pool,
+      ContainerRowSerde::instance());
+  decodedArgs_.resize(numInputs_ + sortingKeyTypes.size());
+}
+
+void SortedAggregate::initializeNewGroups(
+    char** groups,
+    folly::Range<const vector_size_t*> indices) {
+  // The wrapped aggregate shares the null flag of 'this' and keeps its
+  // accumulator after the RowList.
+  aggregate_->setAllocator(allocator_);
+  aggregate_->setOffsets(
+      offset_ + aggregateOffset(), nullByte_, nullMask_, rowSizeOffset_);
+  for (auto index : indices) {
+    new (value<RowList>(groups[index])) RowList{nullptr, nullptr};
+  }
+  aggregate_->initializeNewGroups(groups, indices);
+}
+
+void SortedAggregate::decodeArgs(
+    const SelectivityVector& rows,
+    const std::vector<VectorPtr>& args) {
+  VELOX_CHECK_EQ(args.size(), decodedArgs_.size());
+  for (auto i = 0; i < args.size(); ++i) {
+    decodedArgs_[i].decode(*args[i], rows);
+  }
+}
+
+void SortedAggregate::addRow(char* group, vector_size_t index) {
+  const auto numKeys = compareFlags_.size();
+  auto* row = data_->newRow();
+  for (auto i = 0; i < numKeys; ++i) {
+    data_->store(decodedArgs_[numInputs_ + i], index, row, i);
+  }
+  for (auto i = 0; i < numInputs_; ++i) {
+    data_->store(decodedArgs_[i], index, row, numKeys + i);
+  }
+  nextRow(row) = nullptr;
+
+  auto* list = value<RowList>(group);
+  if (list->last == nullptr) {
+    list->first = row;
+  } else {
+    nextRow(list->last) = row;
+  }
+  list->last = row;
+}
+
+void SortedAggregate::addRawInput(
+    char** groups,
+    const SelectivityVector& rows,
+    const std::vector<VectorPtr>& args,
+    bool /*mayPushdown*/) {
+  decodeArgs(rows, args);
+  rows.applyToSelected([&](auto row) { addRow(groups[row], row); });
+}
+
+void SortedAggregate::addSingleGroupRawInput(
+    char* group,
+    const SelectivityVector& rows,
+    const std::vector<VectorPtr>& args,
+    bool /*mayPushdown*/) {
+  decodeArgs(rows, args);
+  rows.applyToSelected([&](auto row) { addRow(group, row); });
+}
+
+void SortedAggregate::addIntermediateResults(
+    char** /*groups*/,
+    const SelectivityVector& /*rows*/,
+    const std::vector<VectorPtr>& /*args*/,
+    bool /*mayPushdown*/) {
+  VELOX_UNSUPPORTED("Ordered aggregates have no intermediate results");
+}
+
+void SortedAggregate::addSingleGroupIntermediateResults(
+    char* /*group*/,
+    const SelectivityVector& /*rows*/,
+    const std::vector<VectorPtr>& /*args*/,
+    bool /*mayPushdown*/) {
+  VELOX_UNSUPPORTED("Ordered aggregates have no intermediate results");
+}
+
+void SortedAggregate::sortGroup(char* group) {
+  auto* list = value<RowList>(group);
+  const auto begin = sortedRows_.size();
+  for (auto* row = list->first; row != nullptr; row = nextRow(row)) {
+    sortedRows_.push_back(row);
+  }
+  *list = RowList{nullptr, nullptr};
+
+  // Rows with equal sorting keys stay in arrival order.
+  std::stable_sort(
+      sortedRows_.begin() + begin,
+      sortedRows_.end(),
+      [&](const char* left, const char* right) {
+        for (auto i = 0; i < compareFlags_.size(); ++i) {
+          if (auto result = data_->compare(left, right, i, compareFlags_[i])) {
+            return result < 0;
+          }
+        }
+        return false;
+      });
+}
+
+void SortedAggregate::extractValues(
+    char** groups,
+    int32_t numGroups,
+    VectorPtr* result) {
+  sortedRows_.clear();
+  sortedGroups_.clear();
+  for (auto i = 0; i < numGroups; ++i) {
+    sortGroup(groups[i]);
+    sortedGroups_.resize(sortedRows_.size(), groups[i]);
+  }
+
+  if (!sortedRows_.empty()) {
+    // Adds the sorted rows of all groups in one batch. The rows of each group
+    // are contiguous and in sort order.
+    const auto numKeys = compareFlags_.size();
+    const auto numRows = sortedRows_.size();
+    std::vector<VectorPtr> inputs(numInputs_);
+    for (auto i = 0; i < numInputs_; ++i) {
+      inputs[i] =
+          BaseVector::create(data_->columnTypes()[numKeys + i], 0, pool_);
+      data_->extractColumn(sortedRows_.data(), numRows, numKeys + i, inputs[i]);
+    }
+    SelectivityVector rows(numRows);
+    aggregate_->addRawInput(sortedGroups_.data(), rows, inputs, false);
+    data_->eraseRows(folly::Range<char**>(sortedRows_.data(), numRows));
+  }
+
+  aggregate_->extractValues(groups, numGroups, result);
+}
+
+void SortedAggregate::extractAccumulators(
+    char** /*groups*/,
+    int32_t /*numGroups*/,
+    VectorPtr* /*result*/) {
+  VELOX_UNSUPPORTED("Ordered aggregates have no intermediate results");
+}
+
+void SortedAggregate::destroy(folly::Range<char**> groups) {
+  aggregate_->destroy(groups);
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/core/PlanNode.h"
+#include "velox/exec/Aggregate.h"
+#include "velox/exec/RowContainer.h"
+
+namespace facebook::velox::exec {
+
+/// Adapts an aggregate to receive the input of each group in the order of an
+/// ORDER BY clause, e.g. array_agg(a ORDER BY b). The raw input rows of each
+/// group are buffered in a RowContainer together with the sorting keys and
+/// are sorted per group when extracting the results. The sorted rows are then
+/// added to the wrapped aggregate in one batch per output batch, so that
+/// order-sensitive aggregates like array_agg see them in order.
+///
+/// The buffered input has no intermediate form, hence SortedAggregate is only
+/// used in single step aggregations and does not support spilling.
+class SortedAggregate : public Aggregate {
+ public:
+  /// @param aggregate The wrapped aggregate.
+  /// @param inputTypes The types of the inputs of 'aggregate'.
+  /// @param sortingKeyTypes The types of the sorting keys. The inputs of
+  /// SortedAggregate are the inputs of 'aggregate' followed by the sorting
+  /// keys.
+  /// @param sortingOrders The sort order of each sorting key.
+  SortedAggregate(
+      std::unique_ptr<Aggregate> aggregate,
+      const std::vector<TypePtr>& inputTypes,
+      const std::vector<TypePtr>& sortingKeyTypes,
+      const std::vector<core::SortOrder>& sortingOrders,
+      memory::MemoryPool* FOLLY_NONNULL pool);
+
+  int32_t accumulatorFixedWidthSize() const override {
+    return aggregateOffset() + aggregate_->accumulatorFixedWidthSize();
+  }
+
+  int32_t accumulatorAlignmentSize() const override {
+    return std::max<int32_t>(
+        alignof(RowList), aggregate_->accumulatorAlignmentSize());
+  }
+
+  bool accumulatorUsesExternalMemory() const override {
+    return aggregate_->accumulatorUsesExternalMemory();
+  }
+
+  bool isFixedSize() const override {
+    return aggregate_->isFixedSize();
+  }
+
+  void initializeNewGroups(
+      char** groups,
+      folly::Range<const vector_size_t*> indices) override;
+
+  void addRawInput(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool mayPushdown) override;
+
+  void addSingleGroupRawInput(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool mayPushdown) override;
+
+  void addIntermediateResults(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool mayPushdown) override;
+
+  void addSingleGroupIntermediateResults(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool mayPushdown) override;
+
+  void extractValues(char** groups, int32_t numGroups, VectorPtr* result)
+      override;
+
+  void extractAccumulators(char** groups, int32_t numGroups, VectorPtr* result)
+      override;
+
+  void destroy(folly::Range<char**> groups) override;
+
+ private:
+  // The buffered rows of a group, linked through the next row pointer of the
+  // rows in 'data_' in arrival order.
+  struct RowList {
+    char* first;
+    char* last;
+  };
+
+  // Offset of the accumulator of 'aggregate_' from the RowList of a group.
+  int32_t aggregateOffset() const {
+    return bits::roundUp(
+        sizeof(RowList), aggregate_->accumulatorAlignmentSize());
+  }
+
+  char*& nextRow(char* row) const {
+    return *reinterpret_cast<char**>(row + data_->nextOffset());
+  }
+
+  void decodeArgs(
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args);
+
+  // Copies the row 'index' of 'decodedArgs_' into a new row appended to the
+  // list of 'group'.
+  void addRow(char* group, vector_size_t index);
+
+  // Appends the buffered rows of 'group' to 'sortedRows_' in sort order and
+  // empties the list of 'group'.
+  void sortGroup(char* group);
+
+  const std::unique_ptr<Aggregate> aggregate_;
+  const int32_t numInputs_;
+  std::vector<CompareFlags> compareFlags_;
+  // Sorting keys followed by the inputs of 'aggregate_' as dependent columns.
+  std::unique_ptr<RowContainer> data_;
+
+  std::vector<DecodedVector> decodedArgs_;
+  std::vector<char*> sortedRows_;
+  std::vector<char*> sortedGroups_;
+  memory::MemoryPool* const pool_;
+};
+
+} // namespace facebook::velox::exec
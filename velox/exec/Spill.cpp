@@ -15,28 +15,167 @@
  */
 
 #include "velox/exec/Spill.h"
+#include <gflags/gflags.h>
+#include <algorithm>
+#include "velox/common/file/DirectWriteFile.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/time/Timer.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/serializers/PrestoSerializer.h"
 
+DEFINE_bool(
+    spill_direct_io,
+    false,
+    "Write local spill files with O_DIRECT, bypassing the page cache");
+
+DEFINE_uint64(
+    spill_read_ahead_bytes,
+    64 << 20,
+    "Memory budget for the read buffers of the spill files merged by one "
+    "spill merge with read ahead");
+
+DEFINE_uint64(
+    spill_write_buffer_bytes,
+    1 << 20,
+    "The serialized pages of a spill file are written in blocks of at least "
+    "this size. 0 writes each page as it is serialized");
+
 namespace facebook::velox::exec {
 
+std::atomic<int32_t> SpillFile::ordinalCounter_;
+
+namespace {
 // Spilling currently uses the default PrestoSerializer which by default
 // serializes timestamp with millisecond precision to maintain compatibility
 // with presto. Since velox's native timestamp implementation supports
 // nanosecond precision, we use this serde option to ensure the serializer
 // preserves precision.
-static const serializer::presto::PrestoVectorSerde::PrestoOptions
-    kDefaultSerdeOptions(/*useLosslessTimestamp*/ true);
+serializer::presto::PrestoVectorSerde::PrestoOptions spillSerdeOptions(
+    folly::io::CodecType compressionKind) {
+  return serializer::presto::PrestoVectorSerde::PrestoOptions(
+      /*useLosslessTimestamp*/ true, compressionKind);
+}
 
-std::atomic<int32_t> SpillFile::ordinalCounter_;
+std::unique_ptr<SpillInput> openSpillInput(
+    const std::string& path,
+    uint64_t fileSize,
+    memory::MemoryPool& pool,
+    folly::Executor* executor = nullptr,
+    uint64_t readBufferSize = SpillFile::kMaxReadBufferSize) {
+  auto fs = filesystems::getFileSystem(path, nullptr);
+  auto file = fs->openFileForRead(path);
+  const auto bufferSize = std::min<uint64_t>(fileSize, readBufferSize);
+  auto buffer = AlignedBuffer::allocate<char>(bufferSize, &pool);
+  // There is nothing to read ahead if the file fits in one buffer.
+  BufferPtr readAheadBuffer;
+  if (executor != nullptr && fileSize > bufferSize) {
+    readAheadBuffer = AlignedBuffer::allocate<char>(bufferSize, &pool);
+  } else {
+    executor = nullptr;
+  }
+  return std::make_unique<SpillInput>(
+      std::move(file), std::move(buffer), std::move(readAheadBuffer), executor);
+}
+
+// Reads the spilled batches of a spill file from its first row.
+class SpillFileReader : public BatchStream {
+ public:
+  SpillFileReader(
+      std::unique_ptr<SpillInput> input,
+      RowTypePtr type,
+      folly::io::CodecType compressionKind,
+      memory::MemoryPool& pool)
+      : input_(std::move(input)),
+        type_(std::move(type)),
+        serdeOptions_(spillSerdeOptions(compressionKind)),
+        pool_(pool) {}
+
+  bool nextBatch(RowVectorPtr& batch) override {
+    if (input_->atEnd()) {
+      return false;
+    }
+    input_->readVector(pool_, type_, batch, &serdeOptions_);
+    return true;
+  }
+
+ private:
+  const std::unique_ptr<SpillInput> input_;
+  const RowTypePtr type_;
+  const serializer::presto::PrestoVectorSerde::PrestoOptions serdeOptions_;
+  memory::MemoryPool& pool_;
+};
+} // namespace
+
+SpillInput::~SpillInput() {
+  addThreadLocalRuntimeStat(
+      "spillReadNanos",
+      RuntimeCounter(readNanos_, RuntimeCounter::Unit::kNanos));
+  addThreadLocalRuntimeStat(
+      "spillDeserializationNanos",
+      RuntimeCounter(deserializationNanos_, RuntimeCounter::Unit::kNanos));
+  if (readAhead_ == nullptr) {
+    return;
+  }
+  closed_ = true;
+  // Waits for a running read ahead to stop using 'input_' and
+  // 'readAheadBuffer_'.
+  try {
+    readAhead_->move();
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Spill file read ahead failed: " << e.what();
+  }
+}
 
 void SpillInput::next(bool /*throwIfPastEnd*/) {
-  int32_t readBytes = std::min(input_->size() - offset_, buffer_->capacity());
-  VELOX_CHECK_LT(0, readBytes, "Reading past end of spill file");
+  NanosecondTimer timer(&readNanos_);
+  int32_t readBytes;
+  if (readAhead_ != nullptr) {
+    auto readAhead = std::move(readAhead_);
+    auto bytes = readAhead->move();
+    VELOX_CHECK_NOT_NULL(bytes);
+    readBytes = *bytes;
+    std::swap(buffer_, readAheadBuffer_);
+  } else {
+    readBytes = std::min(input_->size() - offset_, buffer_->capacity());
+    VELOX_CHECK_LT(0, readBytes, "Reading past end of spill file");
+    input_->pread(offset_, readBytes, buffer_->asMutable<char>());
+  }
   setRange({buffer_->asMutable<uint8_t>(), readBytes, 0});
-  input_->pread(offset_, readBytes, buffer_->asMutable<char>());
   offset_ += readBytes;
+  startReadAhead();
+}
+
+void SpillInput::readVector(
+    memory::MemoryPool& pool,
+    const RowTypePtr& type,
+    RowVectorPtr& result,
+    const VectorSerde::Options* options) {
+  // The reads of the following pages by next() are not deserialization.
+  const auto readNanos = readNanos_;
+  uint64_t nanos = 0;
+  {
+    NanosecondTimer timer(&nanos);
+    VectorStreamGroup::read(this, &pool, type, &result, options);
+  }
+  deserializationNanos_ += nanos - (readNanos_ - readNanos);
+}
+
+void SpillInput::startReadAhead() {
+  if (executor_ == nullptr || offset_ >= size_) {
+    return;
+  }
+  const uint64_t offset = offset_;
+  const int32_t readBytes =
+      std::min(size_ - offset, readAheadBuffer_->capacity());
+  char* buffer = readAheadBuffer_->asMutable<char>();
+  readAhead_ = std::make_shared<AsyncSource<int32_t>>(
+      [this, offset, readBytes, buffer]() {
+        if (!closed_) {
+          input_->pread(offset, readBytes, buffer);
+        }
+        return std::make_unique<int32_t>(readBytes);
+      });
+  executor_->add([readAhead = readAhead_]() { readAhead->prepare(); });
 }
 
 void SpillMergeStream::pop() {
@@ -45,7 +184,37 @@ void SpillMergeStream::pop() {
   }
 }
 
+void SpillMergeStream::encodeSortKeyPrefixes() {
+  if (!sortKeyPrefixInitialized_) {
+    sortKeyPrefixInitialized_ = true;
+    if (size_ == 0 || numSortingKeys() == 0) {
+      return;
+    }
+    const auto& type = rowVector_->type()->asRow();
+    std::vector<TypePtr> keyTypes;
+    std::vector<column_index_t> keyChannels;
+    std::vector<CompareFlags> keyCompareFlags;
+    for (auto i = 0; i < numSortingKeys(); ++i) {
+      keyTypes.push_back(type.childAt(i));
+      keyChannels.push_back(i);
+      keyCompareFlags.push_back(
+          sortCompareFlags().empty() ? CompareFlags() : sortCompareFlags()[i]);
+    }
+    if (SortKeyPrefix::isSupported(keyTypes[0])) {
+      sortKeyPrefix_.emplace(keyTypes, keyChannels, keyCompareFlags);
+    }
+  }
+  if (!sortKeyPrefix_.has_value() || size_ == 0) {
+    prefixes_.clear();
+    return;
+  }
+  sortKeyPrefix_->encode(*rowVector_, prefixes_);
+}
+
 WriteFile& SpillFile::output() {
+  if (!output_ && FLAGS_spill_direct_io && path_.find('/') == 0) {
+    output_ = std::make_unique<DirectWriteFile>(path_);
+  }
   if (!output_) {
     auto fs = filesystems::getFileSystem(path_, nullptr);
     output_ = fs->openFileForWrite(path_);
@@ -53,31 +222,34 @@ WriteFile& SpillFile::output() {
   return *output_;
 }
 
-void SpillFile::startRead() {
-  constexpr uint64_t kMaxReadBufferSize =
-      (1 << 20) - AlignedBuffer::kPaddedSize; // 1MB - padding.
+void SpillFile::startRead(folly::Executor* executor, uint64_t readBufferSize) {
   VELOX_CHECK(!output_);
   VELOX_CHECK(!input_);
-  auto fs = filesystems::getFileSystem(path_, nullptr);
-  auto file = fs->openFileForRead(path_);
-  auto buffer = AlignedBuffer::allocate<char>(
-      std::min<uint64_t>(fileSize_, kMaxReadBufferSize), &pool_);
-  input_ = std::make_unique<SpillInput>(std::move(file), std::move(buffer));
+  input_ = openSpillInput(path_, fileSize_, pool_, executor, readBufferSize);
 }
 
 bool SpillFile::nextBatch(RowVectorPtr& rowVector) {
   if (input_->atEnd()) {
     return false;
   }
-  VectorStreamGroup::read(
-      input_.get(), &pool_, type_, &rowVector, &kDefaultSerdeOptions);
+  const auto options = spillSerdeOptions(compressionKind_);
+  input_->readVector(pool_, type_, rowVector, &options);
   return true;
 }
 
+std::unique_ptr<BatchStream> SpillFile::makeReader(
+    memory::MemoryPool& pool) const {
+  VELOX_CHECK(!output_);
+  return std::make_unique<SpillFileReader>(
+      openSpillInput(path_, fileSize_, pool), type_, compressionKind_, pool);
+}
+
 WriteFile& SpillFileList::currentOutput() {
   if (files_.empty() || !files_.back()->isWritable() ||
-      files_.back()->size() > targetFileSize_) {
+      files_.back()->size() + writeBufferBytes_ > targetFileSize_) {
     if (!files_.empty() && files_.back()->isWritable()) {
+      writeBuffered();
+      NanosecondTimer timer(&writeNanos_);
       files_.back()->finishWrite();
     }
     files_.push_back(std::make_unique<SpillFile>(
@@ -85,8 +257,10 @@ WriteFile& SpillFileList::currentOutput() {
         numSortingKeys_,
         sortCompareFlags_,
         fmt::format("{}-{}", path_, files_.size()),
-        pool_));
+        pool_,
+        compressionKind_));
   }
+  NanosecondTimer timer(&writeNanos_);
   return files_.back()->output();
 }
 
@@ -94,44 +268,92 @@ void SpillFileList::flush() {
   if (batch_) {
     IOBufOutputStream out(
         pool_, nullptr, std::max<int64_t>(64 * 1024, batch_->size()));
-    batch_->flush(&out);
+    {
+      NanosecondTimer timer(&serializationNanos_);
+      batch_->flush(&out);
+    }
+    // 'batch_' is flushed as a single page. If the page is compressed, it is
+    // accounted with its uncompressed size.
+    const auto serdeStats = batch_->runtimeStats();
+    const auto statValue = [&](const char* name) -> uint64_t {
+      auto it = serdeStats.find(name);
+      return it == serdeStats.end() ? 0 : it->second.value;
+    };
     batch_.reset();
     auto iobuf = out.getIOBuf();
-    auto& file = currentOutput();
-    for (auto& range : *iobuf) {
-      file.append(std::string_view(
-          reinterpret_cast<const char*>(range.data()), range.size()));
+    const uint64_t pageBytes = iobuf->computeChainDataLength();
+    using serializer::presto::PrestoVectorSerde;
+    uncompressedBytes_ += pageBytes;
+    if (statValue(PrestoVectorSerde::kCompressionSkippedBytes) == 0) {
+      uncompressedBytes_ +=
+          statValue(PrestoVectorSerde::kCompressionInputBytes) -
+          statValue(PrestoVectorSerde::kCompressedBytes);
+    }
+    if (writeCallback_ != nullptr) {
+      writeCallback_(pageBytes);
+    }
+    // Opens the file for the page if there is none. This writes out the
+    // buffered pages if the page goes to a new file.
+    currentOutput();
+    if (writeBuffer_ == nullptr) {
+      writeBuffer_ = std::move(iobuf);
+    } else {
+      writeBuffer_->prependChain(std::move(iobuf));
+    }
+    writeBufferBytes_ += pageBytes;
+    if (writeBufferBytes_ >=
+        std::min<uint64_t>(FLAGS_spill_write_buffer_bytes, targetFileSize_)) {
+      writeBuffered();
     }
   }
 }
 
+void SpillFileList::writeBuffered() {
+  if (writeBuffer_ == nullptr) {
+    return;
+  }
+  VELOX_CHECK(!files_.empty() && files_.back()->isWritable());
+  auto buffer = std::move(writeBuffer_);
+  writeBufferBytes_ = 0;
+  NanosecondTimer timer(&writeNanos_);
+  if (buffer->isChained()) {
+    buffer->coalesce();
+  }
+  files_.back()->output().append(std::string_view(
+      reinterpret_cast<const char*>(buffer->data()), buffer->length()));
+}
+
 void SpillFileList::write(
     const RowVectorPtr& rows,
     const folly::Range<IndexRange*>& indices) {
   if (!batch_) {
+    const auto options = spillSerdeOptions(compressionKind_);
     batch_ = std::make_unique<VectorStreamGroup>(&pool_);
     batch_->createStreamTree(
-        std::static_pointer_cast<const RowType>(rows->type()),
-        1000,
-        &kDefaultSerdeOptions);
+        std::static_pointer_cast<const RowType>(rows->type()), 1000, &options);
+  }
+  {
+    NanosecondTimer timer(&serializationNanos_);
+    batch_->append(rows, indices);
   }
-  batch_->append(rows, indices);
 
   flush();
 }
 
 void SpillFileList::finishFile() {
   flush();
+  writeBuffered();
   if (files_.empty()) {
     return;
   }
   if (files_.back()->isWritable()) {
+    NanosecondTimer timer(&writeNanos_);
     files_.back()->finishWrite();
   }
 }
 
 uint64_t SpillFileList::spilledBytes() const {
-  uint64_t bytes = 0;
+  uint64_t bytes = writeBufferBytes_;
   for (auto& file : files_) {
     bytes += file->size();
   }
@@ -144,6 +366,11 @@ void SpillFileList::recordRuntimeStats() {
         "spillFileSize",
         RuntimeCounter(file->size(), RuntimeCounter::Unit::kBytes));
   }
+  if (compressionKind_ != folly::io::CodecType::NO_COMPRESSION) {
+    addThreadLocalRuntimeStat(
+        "spillUncompressedBytes",
+        RuntimeCounter(uncompressedBytes_, RuntimeCounter::Unit::kBytes));
+  }
 }
 
 std::vector<std::string> SpillFileList::testingSpilledFilePaths() const {
@@ -173,7 +400,9 @@ void SpillState::appendToPartition(
         sortCompareFlags_,
         fmt::format("{}-spill-{}", path_, partition),
         targetFileSize_,
-        pool_);
+        pool_,
+        compressionKind_,
+        writeCallback_);
   }
 
   IndexRange range{0, rows->size()};
@@ -182,12 +411,24 @@ void SpillState::appendToPartition(
 
 std::unique_ptr<TreeOfLosers<SpillMergeStream>> SpillState::startMerge(
     int32_t partition,
-    std::unique_ptr<SpillMergeStream>&& extra) {
+    std::unique_ptr<SpillMergeStream>&& extra,
+    folly::Executor* executor) {
   VELOX_CHECK_LT(partition, files_.size());
   std::vector<std::unique_ptr<SpillMergeStream>> result;
   if (auto list = std::move(files_[partition]); list) {
-    for (auto& file : list->files()) {
-      result.push_back(FileSpillMergeStream::create(std::move(file)));
+    auto files = list->files();
+    uint64_t readBufferSize = SpillFile::kMaxReadBufferSize;
+    if (executor != nullptr) {
+      // Each file takes two read buffers with read ahead.
+      constexpr uint64_t kMinReadBufferSize = 64 << 10;
+      readBufferSize = std::clamp<uint64_t>(
+          FLAGS_spill_read_ahead_bytes / (2 * files.size()),
+          kMinReadBufferSize,
+          SpillFile::kMaxReadBufferSize);
+    }
+    for (auto& file : files) {
+      result.push_back(FileSpillMergeStream::create(
+          std::move(file), executor, readBufferSize));
     }
   }
   VELOX_DCHECK_EQ(!result.empty(), isPartitionSpilled(partition));
@@ -221,6 +462,36 @@ uint64_t SpillState::spilledBytes() const {
   return bytes;
 }
 
+uint64_t SpillState::spilledUncompressedBytes() const {
+  uint64_t bytes = 0;
+  for (auto& list : files_) {
+    if (list) {
+      bytes += list->spilledUncompressedBytes();
+    }
+  }
+  return bytes;
+}
+
+uint64_t SpillState::spillSerializationNanos() const {
+  uint64_t nanos = 0;
+  for (auto& list : files_) {
+    if (list) {
+      nanos += list->serializationNanos();
+    }
+  }
+  return nanos;
+}
+
+uint64_t SpillState::spillWriteNanos() const {
+  uint64_t nanos = 0;
+  for (auto& list : files_) {
+    if (list) {
+      nanos += list->writeNanos();
+    }
+  }
+  return nanos;
+}
+
 uint32_t SpillState::spilledPartitions() const {
   return spilledPartitionSet_.size();
 }
@@ -16,9 +16,12 @@
 
 #pragma once
 
+#include <folly/compression/Compression.h>
 #include <folly/container/F14Set.h>
 
+#include "velox/common/base/AsyncSource.h"
 #include "velox/common/file/File.h"
+#include "velox/exec/SortKeyPrefix.h"
 #include "velox/exec/TreeOfLosers.h"
 #include "velox/exec/UnorderedStreamReader.h"
 #include "velox/vector/ComplexVector.h"
@@ -27,17 +30,37 @@
 
 namespace facebook::velox::exec {
 
+/// Invoked with the byte size of each serialized page before it is written to
+/// a spill file. Throws to fail the spill, e.g. if the query runs out of its
+/// spill quota.
+using SpillWriteCallback = std::function<void(uint64_t bytes)>;
+
 // Input stream backed by spill file.
 class SpillInput : public ByteStream {
  public:
-  // Reads from 'input' using 'buffer' for buffering reads.
-  SpillInput(std::unique_ptr<ReadFile>&& input, BufferPtr buffer)
+  // Reads from 'input' using 'buffer' for buffering reads. If 'executor' is
+  // set, the next range of the file is read ahead into 'readAheadBuffer' on
+  // 'executor' while the current one is consumed. The two buffers must have
+  // the same capacity.
+  SpillInput(
+      std::unique_ptr<ReadFile>&& input,
+      BufferPtr buffer,
+      BufferPtr readAheadBuffer = nullptr,
+      folly::Executor* FOLLY_NULLABLE executor = nullptr)
       : input_(std::move(input)),
         buffer_(std::move(buffer)),
-        size_(input_->size()) {
+        size_(input_->size()),
+        readAheadBuffer_(std::move(readAheadBuffer)),
+        executor_(executor) {
+    VELOX_CHECK_EQ(executor_ == nullptr, readAheadBuffer_ == nullptr);
+    VELOX_CHECK(
+        readAheadBuffer_ == nullptr ||
+        readAheadBuffer_->capacity() == buffer_->capacity());
     next(true);
   }
 
+  ~SpillInput() override;
+
   void next(bool throwIfPastEnd) override;
 
   // True if all of the file has been read into vectors.
@@ -45,12 +68,40 @@ class SpillInput : public ByteStream {
     return offset_ >= size_ && ranges()[0].position >= ranges()[0].size;
   }
 
+  // Deserializes the next page of 'this' into 'result'.
+  void readVector(
+      memory::MemoryPool& pool,
+      const RowTypePtr& type,
+      RowVectorPtr& result,
+      const VectorSerde::Options* FOLLY_NULLABLE options);
+
  private:
+  // Starts reading the range after 'offset_' into 'readAheadBuffer_' on
+  // 'executor_'. No-op if there is no 'executor_' or nothing left to read.
+  void startReadAhead();
+
   std::unique_ptr<ReadFile> input_;
   BufferPtr buffer_;
   const uint64_t size_;
   // Offset of first byte not in 'buffer_'
   uint64_t offset_ = 0;
+
+  // Receives the range after 'buffer_' while 'buffer_' is consumed. Swapped
+  // with 'buffer_' on next().
+  BufferPtr readAheadBuffer_;
+  folly::Executor* FOLLY_NULLABLE const executor_;
+  // Returns the byte size of the range read into 'readAheadBuffer_'. Set
+  // while a read ahead is pending.
+  std::shared_ptr<AsyncSource<int32_t>> readAhead_;
+  // Set on destruction so that a read ahead that has not started yet doesn't
+  // read.
+  std::atomic_bool closed_{false};
+  // The time spent in next() reading or waiting for a read ahead, and the
+  // time spent in readVector() outside of next(). Recorded as
+  // 'spillReadNanos' and 'spillDeserializationNanos' runtime stats of the
+  // operator that destroys 'this'.
+  uint64_t readNanos_{0};
+  uint64_t deserializationNanos_{0};
 };
 
 /// Represents a spill file that is first in write mode and then
@@ -68,11 +119,14 @@ class SpillFile {
       int32_t numSortingKeys,
       const std::vector<CompareFlags>& sortCompareFlags,
       const std::string& path,
-      memory::MemoryPool& pool)
+      memory::MemoryPool& pool,
+      folly::io::CodecType compressionKind =
+          folly::io::CodecType::NO_COMPRESSION)
       : type_(std::move(type)),
         numSortingKeys_(numSortingKeys),
         sortCompareFlags_(sortCompareFlags),
         pool_(pool),
+        compressionKind_(compressionKind),
         ordinal_(ordinalCounter_++),
         path_(fmt::format("{}-{}", path, ordinal_)) {
     // NOTE: if the spilling operator has specified the sort comparison flags,
@@ -90,6 +144,11 @@ class SpillFile {
     return sortCompareFlags_;
   }
 
+  /// The codec the serialized pages of 'this' are compressed with.
+  folly::io::CodecType compressionKind() const {
+    return compressionKind_;
+  }
+
   /// Returns a file for writing spilled data. The caller constructs
   /// this, then calls output() and writes serialized data to the file
   /// and calls finishWrite when the file has reached its final
@@ -108,12 +167,28 @@ class SpillFile {
     output_ = nullptr;
   }
 
+  /// The max byte size of the read buffer of a spill file.
+  static constexpr uint64_t kMaxReadBufferSize =
+      (1 << 20) - AlignedBuffer::kPaddedSize; // 1MB - padding.
+
   /// Prepares 'this' for reading. Positions the read at the first row of
   /// content. The caller must call output() and finishWrite() before this.
-  void startRead();
+  /// The file is read in ranges of up to 'readBufferSize' bytes. If
+  /// 'executor' is set, the next range is read ahead on 'executor', which
+  /// takes another buffer of the same size.
+  void startRead(
+      folly::Executor* FOLLY_NULLABLE executor = nullptr,
+      uint64_t readBufferSize = kMaxReadBufferSize);
 
   bool nextBatch(RowVectorPtr& rowVector);
 
+  /// Returns a stream that reads the content of 'this' from the first row,
+  /// independently of startRead() and of the other streams. This is used to
+  /// read the same spilled data several times. The caller must call output()
+  /// and finishWrite() before this. 'pool' is used for buffering and for
+  /// constructing the read data.
+  std::unique_ptr<BatchStream> makeReader(memory::MemoryPool& pool) const;
+
   /// Returns the file size in bytes. During the writing phase this is
   /// the current size of the file, during reading this is the final
   // size.
@@ -140,6 +215,7 @@ class SpillFile {
   const int32_t numSortingKeys_;
   const std::vector<CompareFlags> sortCompareFlags_;
   memory::MemoryPool& pool_;
+  const folly::io::CodecType compressionKind_;
 
   // Ordinal number used for making a label for debugging.
   const int32_t ordinal_;
@@ -163,6 +239,9 @@ class SpillFileList {
   /// data is sorted. 'path' is a file path prefix. ' 'targetFileSize' is the
   /// target byte size of a single file in the file set. 'pool' is used for
   /// buffering and constructing the result data read from 'this'.
+  /// 'compressionKind' is the codec to compress the serialized pages with. A
+  /// page that doesn't compress well is written uncompressed. 'writeCallback'
+  /// is invoked on each page before it is written if set.
   ///
   /// When writing sorted spill runs, the caller is responsible for buffering
   /// and sorting the data. write is called multiple times, followed by flush().
@@ -172,13 +251,18 @@ class SpillFileList {
       const std::vector<CompareFlags>& sortCompareFlags,
       const std::string& path,
       uint64_t targetFileSize,
-      memory::MemoryPool& pool)
+      memory::MemoryPool& pool,
+      folly::io::CodecType compressionKind =
+          folly::io::CodecType::NO_COMPRESSION,
+      SpillWriteCallback writeCallback = nullptr)
       : type_(type),
         numSortingKeys_(numSortingKeys),
         sortCompareFlags_(sortCompareFlags),
         path_(path),
         targetFileSize_(targetFileSize),
-        pool_(pool) {
+        pool_(pool),
+        compressionKind_(compressionKind),
+        writeCallback_(std::move(writeCallback)) {
     // NOTE: if the associated spilling operator has specified the sort
     // comparison flags, then it must match the number of sorting keys.
     VELOX_CHECK(
@@ -207,19 +291,40 @@ class SpillFileList {
 
   uint64_t spilledBytes() const;
 
+  /// Returns the serialized bytes written before compression. This is the
+  /// same as spilledBytes() if the pages are not compressed.
+  uint64_t spilledUncompressedBytes() const {
+    return uncompressedBytes_;
+  }
+
   uint64_t spilledFiles() const {
     return files_.size();
   }
 
+  /// Returns the time spent serializing the spilled rows into pages.
+  uint64_t serializationNanos() const {
+    return serializationNanos_;
+  }
+
+  /// Returns the time spent writing the serialized pages to the files,
+  /// including opening and closing the files.
+  uint64_t writeNanos() const {
+    return writeNanos_;
+  }
+
   std::vector<std::string> testingSpilledFilePaths() const;
 
  private:
   // Returns the current file to write to and creates one if needed.
   WriteFile& currentOutput();
 
-  // Writes data from 'batch_' to the current output file.
+  // Serializes 'batch_' and buffers it for writing to the current output
+  // file.
   void flush();
 
+  // Writes 'writeBuffer_' to the last file of 'files_' in one append.
+  void writeBuffered();
+
   // Invoked by 'files()' to record stats when finish writing all the spill
   // files.
   void recordRuntimeStats();
@@ -230,8 +335,18 @@ class SpillFileList {
   const std::string path_;
   const uint64_t targetFileSize_;
   memory::MemoryPool& pool_;
+  const folly::io::CodecType compressionKind_;
+  const SpillWriteCallback writeCallback_;
   std::unique_ptr<VectorStreamGroup> batch_;
+  // The serialized pages not yet written to the current output file. Remote
+  // file systems write in multipart blocks, so the pages are written in
+  // blocks of 'spill_write_buffer_bytes' rather than one at a time.
+  std::unique_ptr<folly::IOBuf> writeBuffer_;
+  uint64_t writeBufferBytes_{0};
   SpillFiles files_;
+  uint64_t uncompressedBytes_{0};
+  uint64_t serializationNanos_{0};
+  uint64_t writeNanos_{0};
 };
 
 // A source of sorted spilled RowVectors coming either from a file or memory.
@@ -250,6 +365,13 @@ class SpillMergeStream : public MergeStream {
 
   int32_t compare(const MergeStream& other) const override {
     auto& otherStream = static_cast<const SpillMergeStream&>(other);
+    if (!prefixes_.empty() && !otherStream.prefixes_.empty()) {
+      const auto prefix = prefixes_[index_];
+      const auto otherPrefix = otherStream.prefixes_[otherStream.index_];
+      if (prefix != otherPrefix) {
+        return prefix < otherPrefix ? -1 : 1;
+      }
+    }
     auto& children = rowVector_->children();
     auto& otherChildren = otherStream.current().children();
     int32_t key = 0;
@@ -322,8 +444,13 @@ class SpillMergeStream : public MergeStream {
         decoded_[i].decode(*rowVector_->childAt(i), rows_);
       }
     }
+    encodeSortKeyPrefixes();
   }
 
+  // Sets 'prefixes_' for the rows of 'rowVector_' if the leading sorting key
+  // allows a sort key prefix.
+  void encodeSortKeyPrefixes();
+
   void ensureDecodedValid(int32_t index) {
     int32_t oldSize = decoded_.size();
     if (index < oldSize) {
@@ -357,16 +484,28 @@ class SpillMergeStream : public MergeStream {
 
   // Covers all rows inn 'rowVector_' Set if 'decoded_' is non-empty.
   SelectivityVector rows_;
+
+  // Encodes the sort key prefixes of the sorting keys. Set on the first batch
+  // if the leading sorting key type is supported.
+  std::optional<SortKeyPrefix> sortKeyPrefix_;
+  bool sortKeyPrefixInitialized_{false};
+
+  // The sort key prefix of each row in 'rowVector_'. Empty if there is no
+  // 'sortKeyPrefix_'. Compared before the sorting keys.
+  std::vector<uint64_t> prefixes_;
 };
 
 // A source of spilled RowVectors coming from a file.
 class FileSpillMergeStream : public SpillMergeStream {
  public:
+  /// 'executor' and 'readBufferSize' are passed to SpillFile::startRead().
   static std::unique_ptr<SpillMergeStream> create(
-      std::unique_ptr<SpillFile> spillFile) {
-    spillFile->startRead();
+      std::unique_ptr<SpillFile> spillFile,
+      folly::Executor* FOLLY_NULLABLE executor = nullptr,
+      uint64_t readBufferSize = SpillFile::kMaxReadBufferSize) {
+    spillFile->startRead(executor, readBufferSize);
     auto* spillStream = new FileSpillMergeStream(std::move(spillFile));
-    spillStream->nextBatch();
+    spillStream->setNextBatch();
     return std::unique_ptr<SpillMergeStream>(spillStream);
   }
 
@@ -549,20 +688,26 @@ class SpillState {
   /// 'numSortingKeys' is the number of leading columns on which the data is
   /// sorted, 0 if only hash partitioning is used. 'targetFileSize' is the
   /// target size of a single file.  'pool' owns the memory for state and
-  /// results.
+  /// results. 'compressionKind' is the codec for the spilled pages.
+  /// 'writeCallback' is invoked on each spilled page before it is written.
   SpillState(
       const std::string& path,
       int32_t maxPartitions,
       int32_t numSortingKeys,
       const std::vector<CompareFlags>& sortCompareFlags,
       uint64_t targetFileSize,
-      memory::MemoryPool& pool)
+      memory::MemoryPool& pool,
+      folly::io::CodecType compressionKind =
+          folly::io::CodecType::NO_COMPRESSION,
+      SpillWriteCallback writeCallback = nullptr)
       : path_(path),
         maxPartitions_(maxPartitions),
         numSortingKeys_(numSortingKeys),
         sortCompareFlags_(sortCompareFlags),
         targetFileSize_(targetFileSize),
         pool_(pool),
+        compressionKind_(compressionKind),
+        writeCallback_(std::move(writeCallback)),
         files_(maxPartitions_) {}
 
   /// Indicates if a given 'partition' has been spilled or not.
@@ -617,10 +762,13 @@ class SpillState {
 
   // Starts reading values for 'partition'. If 'extra' is non-null, it can be
   // a stream of rows from a RowContainer so as to merge unspilled data with
-  // spilled data.
+  // spilled data. If 'executor' is set, each spill file is read ahead on
+  // 'executor' and the read buffers of all the merged files are sized to
+  // stay within the 'spill_read_ahead_bytes' budget.
   std::unique_ptr<TreeOfLosers<SpillMergeStream>> startMerge(
       int32_t partition,
-      std::unique_ptr<SpillMergeStream>&& extra);
+      std::unique_ptr<SpillMergeStream>&& extra,
+      folly::Executor* FOLLY_NULLABLE executor = nullptr);
 
   bool hasFiles(int32_t partition) const {
     return partition < files_.size() && files_[partition];
@@ -628,6 +776,15 @@ class SpillState {
 
   uint64_t spilledBytes() const;
 
+  /// Returns the spilled bytes before compression.
+  uint64_t spilledUncompressedBytes() const;
+
+  /// Returns the time spent serializing the spilled rows of all partitions.
+  uint64_t spillSerializationNanos() const;
+
+  /// Returns the time spent writing the spill files of all partitions.
+  uint64_t spillWriteNanos() const;
+
   /// Return the number of spilled partitions.
   uint32_t spilledPartitions() const;
 
@@ -648,6 +805,8 @@ class SpillState {
   const uint64_t targetFileSize_;
 
   memory::MemoryPool& pool_;
+  const folly::io::CodecType compressionKind_;
+  const SpillWriteCallback writeCallback_;
 
   // A set of spilled partition numbers.
   SpillPartitionNumSet spilledPartitionSet_;
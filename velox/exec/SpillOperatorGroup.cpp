@@ -24,6 +24,11 @@ SpillOperatorGroup::State SpillOperatorGroup::state() {
   return state_;
 }
 
+std::vector<Operator*> SpillOperatorGroup::operators() {
+  std::lock_guard<std::mutex> l(mutex_);
+  return operators_;
+}
+
 std::string SpillOperatorGroup::stateName(State state) {
   switch (state) {
     case State::kInit:
@@ -93,6 +93,9 @@ class SpillOperatorGroup {
   /// no more memory consumption after that.
   void restart();
 
+  /// Returns the operators added to this group.
+  std::vector<Operator*> operators();
+
   /// Indicates if this group needs spill or not.
   bool needSpill() const {
     return needSpill_;
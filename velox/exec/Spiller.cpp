@@ -18,6 +18,7 @@
 #include <folly/ScopeGuard.h>
 #include "velox/common/base/AsyncSource.h"
 #include "velox/common/testutil/TestValue.h"
+#include "velox/common/time/Timer.h"
 
 using facebook::velox::common::testutil::TestValue;
 
@@ -26,6 +27,18 @@ namespace {
 constexpr int32_t kLogEveryN = 32;
 }
 
+void Spiller::Stats::setRuntimeStats(
+    std::unordered_map<std::string, RuntimeMetric>& runtimeStats) const {
+  const auto setNanos = [&](const char* name, uint64_t nanos) {
+    if (nanos != 0) {
+      runtimeStats[name] = RuntimeMetric(nanos, RuntimeCounter::Unit::kNanos);
+    }
+  };
+  setNanos("spillSortNanos", spillSortNanos);
+  setNanos("spillSerializationNanos", spillSerializationNanos);
+  setNanos("spillWriteNanos", spillWriteNanos);
+}
+
 Spiller::Spiller(
     Type type,
     RowContainer* container,
@@ -37,7 +50,9 @@ Spiller::Spiller(
     uint64_t targetFileSize,
     uint64_t minSpillRunSize,
     memory::MemoryPool& pool,
-    folly::Executor* executor)
+    folly::Executor* executor,
+    folly::io::CodecType compressionKind,
+    SpillWriteCallback writeCallback)
     : Spiller(
           type,
           container,
@@ -50,8 +65,13 @@ Spiller::Spiller(
           targetFileSize,
           minSpillRunSize,
           pool,
-          executor) {
-  VELOX_CHECK_EQ(type_, Type::kOrderBy);
+          executor,
+          compressionKind,
+          std::move(writeCallback)) {
+  VELOX_CHECK(
+      type_ == Type::kOrderBy || type_ == Type::kWindow,
+      "Unexpected spiller type: {}",
+      typeName(type_));
 }
 
 Spiller::Spiller(
@@ -62,7 +82,9 @@ Spiller::Spiller(
     uint64_t targetFileSize,
     uint64_t minSpillRunSize,
     memory::MemoryPool& pool,
-    folly::Executor* FOLLY_NULLABLE executor)
+    folly::Executor* FOLLY_NULLABLE executor,
+    folly::io::CodecType compressionKind,
+    SpillWriteCallback writeCallback)
     : Spiller(
           type,
           nullptr,
@@ -75,7 +97,9 @@ Spiller::Spiller(
           targetFileSize,
           minSpillRunSize,
           pool,
-          executor) {
+          executor,
+          compressionKind,
+          std::move(writeCallback)) {
   VELOX_CHECK_EQ(type_, Type::kHashJoinProbe);
 }
 
@@ -91,7 +115,9 @@ Spiller::Spiller(
     uint64_t targetFileSize,
     uint64_t minSpillRunSize,
     memory::MemoryPool& pool,
-    folly::Executor* executor)
+    folly::Executor* executor,
+    folly::io::CodecType compressionKind,
+    SpillWriteCallback writeCallback)
     : type_(type),
       container_(container),
       eraser_(eraser),
@@ -104,21 +130,34 @@ Spiller::Spiller(
           numSortingKeys,
           sortCompareFlags,
           targetFileSize,
-          pool),
+          pool,
+          compressionKind,
+          std::move(writeCallback)),
       pool_(pool),
       executor_(executor) {
   TestValue::adjust(
       "facebook::velox::exec::Spiller", const_cast<HashBitRange*>(&bits_));
 
   VELOX_CHECK_EQ(container_ == nullptr, type_ == Type::kHashJoinProbe);
-  // kOrderBy spiller type must only have one partition.
-  VELOX_CHECK((type_ != Type::kOrderBy) || (state_.maxPartitions() == 1));
+  // kOrderBy and kWindow spiller types must only have one partition.
+  VELOX_CHECK(
+      (type_ != Type::kOrderBy && type_ != Type::kWindow) ||
+      (state_.maxPartitions() == 1));
   spillRuns_.reserve(state_.maxPartitions());
   for (int i = 0; i < state_.maxPartitions(); ++i) {
     spillRuns_.emplace_back(pool_);
   }
 }
 
+Spiller::~Spiller() {
+  // The pending writes reference 'this' and must finish before it goes away.
+  // Their results are dropped.
+  ContinueFuture future;
+  if (!asyncSpillFinished(&future)) {
+    future.wait();
+  }
+}
+
 void Spiller::extractSpill(folly::Range<char**> rows, RowVectorPtr& resultPtr) {
   if (!resultPtr) {
     resultPtr =
@@ -184,7 +223,7 @@ class RowContainerSpillMergeStream : public SpillMergeStream {
         rows_(std::move(rows)),
         spiller_(spiller) {
     if (!rows_.empty()) {
-      nextBatch();
+      setNextBatch();
     }
   }
 
@@ -242,18 +281,25 @@ std::unique_ptr<SpillMergeStream> Spiller::spillMergeStreamOverRows(
 void Spiller::ensureSorted(SpillRun& run) {
   // The spill data of a hash join doesn't need to be sorted.
   if (!run.sorted && needSort()) {
-    std::sort(
-        run.rows.begin(),
-        run.rows.end(),
-        [&](const char* left, const char* right) {
-          return container_->compareRows(
-                     left, right, state_.sortCompareFlags()) < 0;
-        });
+    uint64_t nanos = 0;
+    {
+      NanosecondTimer timer(&nanos);
+      std::sort(
+          run.rows.begin(),
+          run.rows.end(),
+          [&](const char* left, const char* right) {
+            return container_->compareRows(
+                       left, right, state_.sortCompareFlags()) < 0;
+          });
+    }
+    sortNanos_ += nanos;
     run.sorted = true;
   }
 }
 
-std::unique_ptr<Spiller::SpillStatus> Spiller::writeSpill(int32_t partition) {
+std::unique_ptr<Spiller::SpillStatus> Spiller::writeSpill(
+    int32_t partition,
+    uint64_t maxBytes) {
   VELOX_CHECK_NE(type_, Type::kHashJoinProbe);
   VELOX_CHECK_EQ(pendingSpillPartitions_.count(partition), 1);
   // Target size of a single vector of spilled content. One of
@@ -272,7 +318,7 @@ std::unique_ptr<Spiller::SpillStatus> Spiller::writeSpill(int32_t partition) {
       totalBytes += extractSpillVector(
           run.rows, kTargetBatchRows, kTargetBatchBytes, spillVector, written);
       state_.appendToPartition(partition, spillVector);
-      if (totalBytes > state_.targetFileSize()) {
+      if (totalBytes > maxBytes) {
         break;
       }
     }
@@ -292,7 +338,9 @@ void Spiller::advanceSpill() {
       continue;
     }
     writes.push_back(std::make_shared<AsyncSource<SpillStatus>>(
-        [partition, this]() { return writeSpill(partition); }));
+        [partition, this]() {
+          return writeSpill(partition, state_.targetFileSize());
+        }));
     if (executor_) {
       executor_->add([source = writes.back()]() { source->prepare(); });
     }
@@ -318,25 +366,113 @@ void Spiller::advanceSpill() {
     if (result->error) {
       std::rethrow_exception(result->error);
     }
-    auto numWritten = result->rowsWritten;
-    spilledRows_ += numWritten;
-    auto partition = result->partition;
-    auto& run = spillRuns_[partition];
-    auto spilled = folly::Range<char**>(run.rows.data(), numWritten);
-    eraser_(spilled);
-    if (!container_->numRows()) {
-      // If the container became empty, free its memory.
-      container_->clear();
+    eraseSpilledRows(*result);
+  }
+}
+
+void Spiller::eraseSpilledRows(const SpillStatus& result) {
+  const auto numWritten = result.rowsWritten;
+  spilledRows_ += numWritten;
+  const auto partition = result.partition;
+  auto& run = spillRuns_[partition];
+  auto spilled = folly::Range<char**>(run.rows.data(), numWritten);
+  eraser_(spilled);
+  if (!container_->numRows()) {
+    // If the container became empty, free its memory.
+    container_->clear();
+  }
+  run.rows.erase(run.rows.begin(), run.rows.begin() + numWritten);
+  if (run.rows.empty()) {
+    // Run ends, start with a new file next time.
+    run.clear();
+    if (needSort()) {
+      state_.finishWrite(partition);
     }
-    run.rows.erase(run.rows.begin(), run.rows.begin() + numWritten);
-    if (run.rows.empty()) {
-      // Run ends, start with a new file next time.
-      run.clear();
-      if (needSort()) {
-        state_.finishWrite(partition);
+    pendingSpillPartitions_.erase(partition);
+  }
+}
+
+void Spiller::spillAsync(uint64_t maxBytes) {
+  VELOX_CHECK(!spillFinalized_);
+  VELOX_CHECK(
+      type_ == Type::kOrderBy,
+      "Don't support async spill on type: {}",
+      typeName(type_));
+  VELOX_CHECK(!isAsyncSpillPending(), "Async spill is already pending");
+
+  if (pendingSpillPartitions_.empty()) {
+    if (container_->numRows() == 0) {
+      return;
+    }
+    // The rows added after this are not in the spill run and get spilled by
+    // the next run.
+    fillSpillRuns();
+    // There is only one partition for kOrderBy.
+    if (!state_.isPartitionSpilled(0)) {
+      state_.setPartitionSpilled(0);
+    }
+    pendingSpillPartitions_.insert(0);
+  }
+  for (const auto partition : pendingSpillPartitions_) {
+    asyncWrites_.push_back(std::make_shared<AsyncSource<SpillStatus>>(
+        [partition, maxBytes, this]() {
+          return writeSpill(partition, maxBytes);
+        }));
+  }
+  if (executor_ == nullptr) {
+    finishAsyncSpill();
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> l(asyncMutex_);
+    numRunningAsyncWrites_ = asyncWrites_.size();
+  }
+  for (auto& write : asyncWrites_) {
+    executor_->add([source = write, this]() {
+      source->prepare();
+      std::vector<ContinuePromise> promises;
+      {
+        std::lock_guard<std::mutex> l(asyncMutex_);
+        if (--numRunningAsyncWrites_ == 0) {
+          promises.swap(asyncWritePromises_);
+        }
+      }
+      for (auto& promise : promises) {
+        promise.setValue();
       }
-      pendingSpillPartitions_.erase(partition);
+    });
+  }
+}
+
+bool Spiller::asyncSpillFinished(ContinueFuture* future) {
+  std::lock_guard<std::mutex> l(asyncMutex_);
+  if (numRunningAsyncWrites_ == 0) {
+    return true;
+  }
+  if (future != nullptr) {
+    asyncWritePromises_.emplace_back("Spiller::asyncSpillFinished");
+    *future = asyncWritePromises_.back().getSemiFuture();
+  }
+  return false;
+}
+
+void Spiller::finishAsyncSpill() {
+  ContinueFuture future;
+  if (!asyncSpillFinished(&future)) {
+    future.wait();
+  }
+  auto writes = std::move(asyncWrites_);
+  asyncWrites_.clear();
+  std::vector<std::unique_ptr<SpillStatus>> results;
+  results.reserve(writes.size());
+  for (auto& write : writes) {
+    results.push_back(write->move());
+  }
+  for (auto& result : results) {
+    if (result->error) {
+      std::rethrow_exception(result->error);
     }
+    eraseSpilledRows(*result);
   }
 }
 
@@ -346,6 +482,9 @@ bool Spiller::needSort() const {
 
 void Spiller::spill(uint64_t targetRows, uint64_t targetBytes) {
   VELOX_CHECK(!spillFinalized_);
+  if (isAsyncSpillPending()) {
+    finishAsyncSpill();
+  }
 
   if (type_ == Type::kHashJoinBuild || type_ == Type::kHashJoinProbe) {
     VELOX_FAIL("Don't support incremental spill on type: {}", typeName(type_));
@@ -494,6 +633,9 @@ int32_t Spiller::pickNextPartitionToSpill() {
 
 Spiller::SpillRows Spiller::finishSpill() {
   VELOX_CHECK(!spillFinalized_);
+  if (isAsyncSpillPending()) {
+    finishAsyncSpill();
+  }
   spillFinalized_ = true;
 
   SpillRows rowsFromNonSpillingPartitions(
@@ -548,7 +690,7 @@ void Spiller::fillSpillRuns(SpillRows* rowsFromNonSpillingPartitions) {
     for (auto i = 0; i < numRows; ++i) {
       // TODO: consider to cache the hash bits in row container so we only need
       // to calculate them once.
-      const auto partition = (type_ == Type::kOrderBy)
+      const auto partition = (type_ == Type::kOrderBy || type_ == Type::kWindow)
           ? 0
           : bits_.partition(hashes[i], state_.maxPartitions());
       VELOX_DCHECK_GE(partition, 0);
@@ -626,6 +768,8 @@ std::string Spiller::typeName(Type type) {
       return "HASH_JOIN_PROBE";
     case Type::kAggregate:
       return "AGGREGATE";
+    case Type::kWindow:
+      return "WINDOW";
     default:
       VELOX_UNREACHABLE("Unknown type: {}", static_cast<int>(type));
       return fmt::format("UNKNOWN TYPE: {}", static_cast<int>(type));
@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include "velox/common/base/AsyncSource.h"
+#include "velox/common/base/RuntimeMetrics.h"
 #include "velox/exec/HashBitRange.h"
 #include "velox/exec/RowContainer.h"
 
@@ -33,8 +35,10 @@ class Spiller {
     kHashJoinProbe = 2,
     // Used for order by.
     kOrderBy = 3,
+    // Used for window.
+    kWindow = 4,
   };
-  static constexpr int kNumTypes = 4;
+  static constexpr int kNumTypes = 5;
   static std::string typeName(Type);
 
   // Specifies the config for spilling.
@@ -47,7 +51,10 @@ class Spiller {
         int32_t _spillableReservationGrowthPct,
         const HashBitRange& _hashBitRange,
         int32_t _maxSpillLevel,
-        int32_t _testSpillPct)
+        int32_t _testSpillPct,
+        folly::io::CodecType _compressionKind =
+            folly::io::CodecType::NO_COMPRESSION,
+        SpillWriteCallback _writeCallback = nullptr)
         : filePath(_filePath),
           maxFileSize(
               _maxFileSize == 0 ? std::numeric_limits<int64_t>::max()
@@ -57,7 +64,9 @@ class Spiller {
           spillableReservationGrowthPct(_spillableReservationGrowthPct),
           hashBitRange(_hashBitRange),
           maxSpillLevel(_maxSpillLevel),
-          testSpillPct(_testSpillPct) {}
+          testSpillPct(_testSpillPct),
+          compressionKind(_compressionKind),
+          writeCallback(std::move(_writeCallback)) {}
 
     /// Returns the spilling level with given 'startBitOffset'.
     ///
@@ -68,7 +77,8 @@ class Spiller {
     /// Checks if the given 'startBitOffset' has exceeded the max spill limit.
     bool exceedSpillLevelLimit(uint8_t startBitOffset) const;
 
-    /// Filesystem path for spill files.
+    /// Filesystem path for spill files. This can be on any file system
+    /// registered with the FileSystems registry, e.g. on remote storage.
     std::string filePath;
 
     /// The max spill file size. If it is zero, there is no limit on the spill
@@ -104,12 +114,21 @@ class Spiller {
     // Percentage of input batches to be spilled for testing. 0 means no
     // spilling for test.
     int32_t testSpillPct;
+
+    // The codec to compress the spilled pages with. The pages are compressed
+    // when they are written, so on 'executor' if that is set.
+    folly::io::CodecType compressionKind;
+
+    // Invoked on each spilled page before it is written. Used to account the
+    // spilled bytes against the spill quota of the query.
+    SpillWriteCallback writeCallback;
   };
 
   using SpillRows = std::vector<char*, memory::StlAllocator<char*>>;
 
   // The constructor without specifying hash bits which will only use one
-  // partition by default. It is only used by kOrderBy spiller type as for now.
+  // partition by default. It is only used by kOrderBy and kWindow spiller types
+  // as for now.
   Spiller(
       Type type,
       RowContainer* FOLLY_NONNULL container,
@@ -121,7 +140,10 @@ class Spiller {
       uint64_t targetFileSize,
       uint64_t minSpillRunSize,
       memory::MemoryPool& pool,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      folly::io::CodecType compressionKind =
+          folly::io::CodecType::NO_COMPRESSION,
+      SpillWriteCallback writeCallback = nullptr);
 
   Spiller(
       Type type,
@@ -131,7 +153,10 @@ class Spiller {
       uint64_t targetFileSize,
       uint64_t minSpillRunSize,
       memory::MemoryPool& pool,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      folly::io::CodecType compressionKind =
+          folly::io::CodecType::NO_COMPRESSION,
+      SpillWriteCallback writeCallback = nullptr);
 
   Spiller(
       Type type,
@@ -145,7 +170,13 @@ class Spiller {
       uint64_t targetFileSize,
       uint64_t minSpillRunSize,
       memory::MemoryPool& pool,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      folly::io::CodecType compressionKind =
+          folly::io::CodecType::NO_COMPRESSION,
+      SpillWriteCallback writeCallback = nullptr);
+
+  /// Waits for the writes started by spillAsync() if any.
+  ~Spiller();
 
   /// Spills rows from 'this' until there are under 'targetRows' rows
   /// and 'targetBytes' of allocated variable length space in use. spill()
@@ -156,6 +187,30 @@ class Spiller {
   /// all data to be spilled and 'container_' to become empty.
   void spill(uint64_t targetRows, uint64_t targetBytes);
 
+  /// Starts writing up to 'maxBytes' of the spillable rows on the spill
+  /// executor and returns without waiting for the writes. The caller can keep
+  /// adding rows to the container while the writes run, as the rows being
+  /// written are not modified until finishAsyncSpill() erases them. This is
+  /// only supported for kOrderBy, whose rows are never updated after insert.
+  /// The writes run synchronously if there is no spill executor. Must not be
+  /// called while a previous async spill is pending.
+  void spillAsync(uint64_t maxBytes);
+
+  /// Returns true if spillAsync() has started writes that are not consumed by
+  /// finishAsyncSpill() yet.
+  bool isAsyncSpillPending() const {
+    return !asyncWrites_.empty();
+  }
+
+  /// Returns true if all the writes started by spillAsync() have completed.
+  /// Otherwise sets 'future' if not null to get notified on completion.
+  bool asyncSpillFinished(ContinueFuture* FOLLY_NULLABLE future = nullptr);
+
+  /// Waits for the writes started by spillAsync(), erases the written rows
+  /// from the container and rethrows the first write error if any. spill()
+  /// and finishSpill() call this for a pending async spill.
+  void finishAsyncSpill();
+
   /// Spills all the spillable rows collected in 'spillRuns_' from specified
   /// 'partitions'. It is now only used by spilling operator which needs
   /// spilling coordination across multiple drivers such as hash build. One of
@@ -201,7 +256,8 @@ class Spiller {
     if (FOLLY_UNLIKELY(!needSort())) {
       VELOX_FAIL("Can't sort merge the unsorted spill data: {}", toString());
     }
-    return state_.startMerge(partition, spillMergeStreamOverRows(partition));
+    return state_.startMerge(
+        partition, spillMergeStreamOverRows(partition), executor_);
   }
 
   // Extracts up to 'maxRows' or 'maxBytes' from 'rows' into
@@ -255,22 +311,45 @@ class Spiller {
 
   /// Define the spiller stats.
   struct Stats {
+    /// The bytes written to the spill files, after compression.
     uint64_t spilledBytes{0};
     uint64_t spilledRows{0};
     /// NOTE: when we sum up the stats from a group of spill operators, it is
     /// the total number of spilled partitions X number of operators.
     uint32_t spilledPartitions{0};
     uint64_t spilledFiles{0};
+    /// The serialized bytes before compression. This is the same as
+    /// 'spilledBytes' if the spilled pages are not compressed.
+    uint64_t spilledUncompressedBytes{0};
+    /// The max spilling level with zero being the initial spilling level. Only
+    /// hash join build spilling goes beyond the initial level, by spilling
+    /// the restored spill partitions again at the next hash bits.
+    int32_t maxSpillLevel{0};
+    /// The number of restored spill partitions which could not be spilled
+    /// again as that would exceed the max spill level. NOTE: as for
+    /// 'spilledPartitions', this counts a partition once per operator.
+    uint32_t numMaxSpillLevelExceeded{0};
+    /// The time spent in each phase of writing the spilled data: sorting the
+    /// spilled rows, serializing them into pages and writing the pages to the
+    /// spill files. This tells whether a slow spill is bound by CPU or by the
+    /// file system. The time spent on reading the spilled data back is
+    /// recorded by the spill files in the 'spillReadNanos' and
+    /// 'spillDeserializationNanos' runtime stats of the reading operator.
+    uint64_t spillSortNanos{0};
+    uint64_t spillSerializationNanos{0};
+    uint64_t spillWriteNanos{0};
 
     Stats(
         uint64_t _spilledBytes,
         uint64_t _spilledRows,
         uint32_t _spilledPartitions,
-        uint64_t _spilledFiles)
+        uint64_t _spilledFiles,
+        uint64_t _spilledUncompressedBytes = 0)
         : spilledBytes(_spilledBytes),
           spilledRows(_spilledRows),
           spilledPartitions(_spilledPartitions),
-          spilledFiles(_spilledFiles) {}
+          spilledFiles(_spilledFiles),
+          spilledUncompressedBytes(_spilledUncompressedBytes) {}
 
     Stats() = default;
 
@@ -279,16 +358,32 @@ class Spiller {
       spilledRows += other.spilledRows;
       spilledPartitions += other.spilledPartitions;
       spilledFiles += other.spilledFiles;
+      spilledUncompressedBytes += other.spilledUncompressedBytes;
+      maxSpillLevel = std::max(maxSpillLevel, other.maxSpillLevel);
+      numMaxSpillLevelExceeded += other.numMaxSpillLevelExceeded;
+      spillSortNanos += other.spillSortNanos;
+      spillSerializationNanos += other.spillSerializationNanos;
+      spillWriteNanos += other.spillWriteNanos;
       return *this;
     }
+
+    /// Sets the non-zero phase timings in 'runtimeStats' under their field
+    /// names.
+    void setRuntimeStats(
+        std::unordered_map<std::string, RuntimeMetric>& runtimeStats) const;
   };
 
   Stats stats() const {
-    return Stats{
+    Stats stats{
         state_.spilledBytes(),
         spilledRows_,
         state_.spilledPartitions(),
-        spilledFiles()};
+        spilledFiles(),
+        state_.spilledUncompressedBytes()};
+    stats.spillSortNanos = sortNanos_;
+    stats.spillSerializationNanos = state_.spillSerializationNanos();
+    stats.spillWriteNanos = state_.spillWriteNanos();
+    return stats;
   }
 
   /// Return the number of spilled files we have.
@@ -389,13 +484,17 @@ class Spiller {
 
   // Function for writing a spill partition on an executor. Writes to
   // 'partition' until all rows in spillRuns_[partition] are written
-  // or spill file size limit is exceeded. Returns the number of rows
+  // or more than 'maxBytes' are written. Returns the number of rows
   // written.
-  std::unique_ptr<SpillStatus> writeSpill(int32_t partition);
+  std::unique_ptr<SpillStatus> writeSpill(int32_t partition, uint64_t maxBytes);
 
   // Writes out and erases rows marked for spilling.
   void advanceSpill();
 
+  // Erases the rows written by a spill write from the container and its spill
+  // run. Finishes the spill file of the run if the run is fully written.
+  void eraseSpilledRows(const SpillStatus& result);
+
   // Indicates if the spill data needs to be sorted before write to file. It is
   // based on the spiller type. As for now, we need to sort spill data for any
   // non hash join types of spilling.
@@ -429,6 +528,19 @@ class Spiller {
   folly::Executor* FOLLY_NULLABLE const executor_;
 
   uint64_t spilledRows_{0};
+
+  // The time spent sorting spill runs. Runs are sorted on the spill executor.
+  std::atomic<uint64_t> sortNanos_{0};
+
+  // The writes started by spillAsync() and not yet consumed by
+  // finishAsyncSpill().
+  std::vector<std::shared_ptr<AsyncSource<SpillStatus>>> asyncWrites_;
+
+  std::mutex asyncMutex_;
+  // The number of 'asyncWrites_' still running on the executor.
+  int32_t numRunningAsyncWrites_{0};
+  // Fulfilled when 'numRunningAsyncWrites_' drops to zero.
+  std::vector<ContinuePromise> asyncWritePromises_;
 };
 
 } // namespace facebook::velox::exec
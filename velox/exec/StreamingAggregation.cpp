@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/exec/StreamingAggregation.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/exec/Aggregate.h"
 #include "velox/exec/RowContainer.h"
 
@@ -88,6 +89,16 @@ StreamingAggregation::StreamingAggregation(
     VELOX_NYI("Streaming aggregation doesn't support ignoring null keys yet");
   }
 
+  for (auto i = 0; i < numAggregates; ++i) {
+    if (aggregationNode->isDistinctAggregate(i)) {
+      VELOX_NYI(
+          "Streaming aggregation doesn't support distinct aggregates yet");
+    }
+    if (aggregationNode->isOrderedAggregate(i)) {
+      VELOX_NYI("Streaming aggregation doesn't support ordered aggregates yet");
+    }
+  }
+
   masks_ = std::make_unique<AggregationMasks>(std::move(maskChannels));
 
   rows_ = std::make_unique<RowContainer>(
@@ -134,8 +145,86 @@ bool equalKeys(
 
   return true;
 }
+
+// Sets the bits in 'boundaries' for the rows in 'values' that differ from the
+// previous row. Compares a SIMD width of adjacent values at a time.
+template <typename T>
+void setBoundaries(const T* values, vector_size_t size, uint64_t* boundaries) {
+  using Batch = xsimd::batch<T>;
+  constexpr int32_t kLanes = Batch::size;
+  vector_size_t row = 1;
+  for (; row + kLanes <= size; row += kLanes) {
+    uint64_t mask = simd::toBitMask(
+        Batch::load_unaligned(values + row) !=
+        Batch::load_unaligned(values + row - 1));
+    if constexpr (kLanes < 64) {
+      mask &= bits::lowMask(kLanes);
+    }
+    if (mask == 0) {
+      continue;
+    }
+    const auto shift = row % 64;
+    boundaries[row / 64] |= mask << shift;
+    if (shift + kLanes > 64) {
+      boundaries[row / 64 + 1] |= mask >> (64 - shift);
+    }
+  }
+  for (; row < size; ++row) {
+    if (values[row] != values[row - 1]) {
+      bits::setBit(boundaries, row);
+    }
+  }
+}
+
+template <TypeKind Kind>
+bool setFlatBoundaries(const BaseVector& keys, uint64_t* boundaries) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  setBoundaries(
+      keys.asUnchecked<FlatVector<T>>()->rawValues(), keys.size(), boundaries);
+  return true;
+}
+
+// Sets the boundaries for 'keys' if these are flat integers without nulls.
+// Returns false for other keys.
+bool setFastBoundaries(const BaseVector& keys, uint64_t* boundaries) {
+  if (keys.encoding() != VectorEncoding::Simple::FLAT || keys.mayHaveNulls()) {
+    return false;
+  }
+  switch (keys.typeKind()) {
+    case TypeKind::TINYINT:
+      return setFlatBoundaries<TypeKind::TINYINT>(keys, boundaries);
+    case TypeKind::SMALLINT:
+      return setFlatBoundaries<TypeKind::SMALLINT>(keys, boundaries);
+    case TypeKind::INTEGER:
+      return setFlatBoundaries<TypeKind::INTEGER>(keys, boundaries);
+    case TypeKind::BIGINT:
+      return setFlatBoundaries<TypeKind::BIGINT>(keys, boundaries);
+    default:
+      return false;
+  }
+}
 } // namespace
 
+void StreamingAggregation::findGroupBoundaries() {
+  const auto numInput = input_->size();
+  // One extra word for the bits that setBoundaries() writes past the last
+  // row.
+  groupBoundaries_.resize(bits::nwords(numInput) + 1);
+  std::fill(groupBoundaries_.begin(), groupBoundaries_.end(), 0);
+  for (auto key : groupingKeys_) {
+    const auto& keys = *input_->childAt(key);
+    if (setFastBoundaries(keys, groupBoundaries_.data())) {
+      continue;
+    }
+    for (auto row = 1; row < numInput; ++row) {
+      if (!bits::isBitSet(groupBoundaries_.data(), row) &&
+          !keys.equalValueAt(&keys, row, row - 1)) {
+        bits::setBit(groupBoundaries_.data(), row);
+      }
+    }
+  }
+}
+
 char* StreamingAggregation::startNewGroup(vector_size_t index) {
   if (numGroups_ < groups_.size()) {
     auto group = groups_[numGroups_++];
@@ -183,38 +272,34 @@ void StreamingAggregation::assignGroups() {
   auto numInput = input_->size();
 
   inputGroups_.resize(numInput);
-
-  // Look for the end of the last group.
-  vector_size_t index = 0;
-  if (prevInput_) {
-    auto prevIndex = prevInput_->size() - 1;
-    auto* prevGroup = groups_[numGroups_ - 1];
-    for (; index < numInput; ++index) {
-      if (equalKeys(groupingKeys_, prevInput_, prevIndex, input_, index)) {
-        inputGroups_[index] = prevGroup;
-      } else {
-        break;
-      }
-    }
-  }
-
-  if (index < numInput) {
+  findGroupBoundaries();
+
+  // The rows before the first boundary continue the last group of the
+  // previous batch if their keys match.
+  const bool continuesGroup = prevInput_ && numInput > 0 &&
+      equalKeys(groupingKeys_, prevInput_, prevInput_->size() - 1, input_, 0);
+  bits::setBit(groupBoundaries_.data(), 0);
+  groupStarts_.clear();
+  bits::forEachSetBit(
+      groupBoundaries_.data(), 0, numInput, [&](vector_size_t row) {
+        groupStarts_.push_back(row);
+      });
+
+  if (!continuesGroup || groupStarts_.size() > 1) {
     for (auto i = 0; i < groupingKeys_.size(); ++i) {
       decodedKeys_[i].decode(*input_->childAt(groupingKeys_[i]), inputRows_);
     }
+    groups_.reserve(numGroups_ + groupStarts_.size());
+  }
 
-    auto* newGroup = startNewGroup(index);
-    inputGroups_[index] = newGroup;
-
-    for (auto i = index + 1; i < numInput; ++i) {
-      if (equalKeys(groupingKeys_, input_, index, input_, i)) {
-        inputGroups_[i] = inputGroups_[index];
-      } else {
-        newGroup = startNewGroup(i);
-        inputGroups_[i] = newGroup;
-        index = i;
-      }
-    }
+  for (auto i = 0; i < groupStarts_.size(); ++i) {
+    const auto start = groupStarts_[i];
+    const auto end =
+        i + 1 < groupStarts_.size() ? groupStarts_[i + 1] : numInput;
+    auto* group = (i == 0 && continuesGroup) ? groups_[numGroups_ - 1]
+                                             : startNewGroup(start);
+    std::fill(
+        inputGroups_.begin() + start, inputGroups_.begin() + end, group);
   }
 }
 
@@ -227,6 +312,15 @@ const SelectivityVector& StreamingAggregation::getSelectivityVector(
 }
 
 void StreamingAggregation::evaluateAggregates() {
+  // Sorted input usually has long runs of rows of the same group. These are
+  // added one run at a time, which avoids the per row indirection to the
+  // accumulator.
+  const bool addByGroup =
+      groupStarts_.size() * kMinRowsPerGroupRun <= input_->size();
+  if (addByGroup) {
+    groupRows_.resizeFill(input_->size(), false);
+  }
+
   for (auto i = 0; i < aggregates_.size(); ++i) {
     auto& aggregate = aggregates_[i];
 
@@ -241,7 +335,9 @@ void StreamingAggregation::evaluateAggregates() {
 
     const auto& rows = getSelectivityVector(i);
 
-    if (isRawInput(step_)) {
+    if (addByGroup) {
+      addGroupRuns(*aggregate, rows, args);
+    } else if (isRawInput(step_)) {
       aggregate->addRawInput(inputGroups_.data(), rows, args, false);
     } else {
       aggregate->addIntermediateResults(inputGroups_.data(), rows, args, false);
@@ -249,6 +345,31 @@ void StreamingAggregation::evaluateAggregates() {
   }
 }
 
+void StreamingAggregation::addGroupRuns(
+    Aggregate& aggregate,
+    const SelectivityVector& rows,
+    const std::vector<VectorPtr>& args) {
+  const auto numInput = input_->size();
+  auto* groupBits = groupRows_.asMutableRange().bits();
+  for (auto i = 0; i < groupStarts_.size(); ++i) {
+    const auto start = groupStarts_[i];
+    const auto end =
+        i + 1 < groupStarts_.size() ? groupStarts_[i + 1] : numInput;
+    bits::copyBits(rows.asRange().bits(), start, groupBits, start, end - start);
+    groupRows_.updateBounds();
+    if (groupRows_.hasSelections()) {
+      if (isRawInput(step_)) {
+        aggregate.addSingleGroupRawInput(
+            inputGroups_[start], groupRows_, args, false);
+      } else {
+        aggregate.addSingleGroupIntermediateResults(
+            inputGroups_[start], groupRows_, args, false);
+      }
+    }
+    groupRows_.setValidRange(start, end, false);
+  }
+}
+
 bool StreamingAggregation::isFinished() {
   return noMoreInput_ && input_ == nullptr && numGroups_ == 0;
 }
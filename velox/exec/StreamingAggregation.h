@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "velox/common/base/RawVector.h"
 #include "velox/exec/AggregationMasks.h"
 #include "velox/exec/Operator.h"
 
@@ -61,13 +62,29 @@ class StreamingAggregation : public Operator {
   // of the groups_ vector.
   RowVectorPtr createOutput(size_t numGroups);
 
+  // Sets a bit in groupBoundaries_ for each input row whose grouping keys
+  // differ from the previous row. The first row is not compared.
+  void findGroupBoundaries();
+
   // Assign input rows to groups based on values of the grouping keys. Store the
-  // assignments in inputGroups_.
+  // assignments in inputGroups_ and the first row of each run of rows of the
+  // same group in groupStarts_.
   void assignGroups();
 
   // Add input data to accumulators.
   void evaluateAggregates();
 
+  // Adds the rows of each run in groupStarts_ to the accumulator of its group
+  // with one call per group.
+  void addGroupRuns(
+      Aggregate& aggregate,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args);
+
+  // The minimum average number of rows per group in an input batch for adding
+  // the input to each group separately instead of row by row.
+  static constexpr int32_t kMinRowsPerGroupRun = 32;
+
   /// Maximum number of rows in the output batch.
   const uint32_t outputBatchSize_;
 
@@ -99,6 +116,15 @@ class StreamingAggregation : public Operator {
   // Pointers to groups for all input rows.
   std::vector<char*> inputGroups_;
 
+  // Bit mask of rows that start a group. See findGroupBoundaries().
+  raw_vector<uint64_t> groupBoundaries_;
+
+  // The first row of each run of rows of the same group in the input batch.
+  std::vector<vector_size_t> groupStarts_;
+
+  // Rows of one group run. Used by addGroupRuns().
+  SelectivityVector groupRows_;
+
   // A subset of input rows to evaluate the aggregate function on. Rows
   // where aggregation mask is false are excluded.
   SelectivityVector inputRows_;
@@ -15,6 +15,7 @@
  */
 #include "velox/exec/TableScan.h"
 #include "velox/common/time/Timer.h"
+#include "velox/exec/LocalPartition.h"
 #include "velox/exec/Task.h"
 #include "velox/expression/Expr.h"
 
@@ -36,7 +37,12 @@ TableScan::TableScan(
           "TableScan"),
       tableHandle_(tableScanNode->tableHandle()),
       columnHandles_(tableScanNode->assignments()),
-      driverCtx_(driverCtx) {
+      driverCtx_(driverCtx),
+      splitStealing_(driverCtx->queryConfig().tableScanSplitStealing()),
+      adaptiveDrivers_(driverCtx->queryConfig().adaptiveScanDrivers()),
+      preferredBatchRows_(driverCtx->queryConfig().preferredOutputBatchSize()),
+      preferredBatchBytes_(
+          driverCtx->queryConfig().preferredOutputBatchBytes()) {
   connector_ = connector::getConnector(tableHandle_->connectorId());
 }
 
@@ -54,13 +60,18 @@ RowVectorPtr TableScan::getOutput() {
           split,
           blockingFuture_,
           maxPreloadedSplits_,
-          splitPreloader_);
+          splitPreloader_,
+          splitStealing_);
       if (blockingReason_ != BlockingReason::kNotBlocked) {
         return nullptr;
       }
 
       if (!split.hasConnectorSplit()) {
         noMoreSplits_ = true;
+        if (adaptiveDrivers_) {
+          // The held back Drivers find no split and finish.
+          startDeferredDrivers(true);
+        }
         if (dataSource_) {
           auto connectorStats = dataSource_->runtimeStats();
           auto lockedStats = stats_.wlock();
@@ -84,6 +95,9 @@ RowVectorPtr TableScan::getOutput() {
 
       const auto& connectorSplit = split.connectorSplit;
       needNewSplit_ = false;
+      if (adaptiveDrivers_) {
+        startDeferredDrivers(false);
+      }
 
       VELOX_CHECK_EQ(
           connector_->connectorId(),
@@ -147,7 +161,7 @@ RowVectorPtr TableScan::getOutput() {
          },
          &debugString_});
 
-    auto dataOptional = dataSource_->next(readBatchSize_, blockingFuture_);
+    auto dataOptional = dataSource_->next(batchSize(), blockingFuture_);
     checkPreload();
     if (!dataOptional.has_value()) {
       blockingReason_ = BlockingReason::kWaitForConnector;
@@ -166,7 +180,13 @@ RowVectorPtr TableScan::getOutput() {
       auto data = dataOptional.value();
       if (data) {
         if (data->size() > 0) {
-          lockedStats->addInputVector(data->estimateFlatSize(), data->size());
+          const auto bytes = data->estimateFlatSize();
+          lockedStats->addInputVector(bytes, data->size());
+          observedBytes_ += bytes;
+          observedRows_ += data->size();
+          if (splitStealing_) {
+            checkSplitSteal();
+          }
           return data;
         }
         continue;
@@ -184,11 +204,69 @@ RowVectorPtr TableScan::getOutput() {
           RuntimeCounter(
               numReadyPreloadedSplits_, RuntimeCounter::Unit::kNone));
       numReadyPreloadedSplits_ = 0;
+      if (numThrottledPreloads_ > 0) {
+        lockedStats->addRuntimeStat(
+            "throttledPreloads",
+            RuntimeCounter(numThrottledPreloads_, RuntimeCounter::Unit::kNone));
+        numThrottledPreloads_ = 0;
+      }
+      if (numStolenSplits_ > 0) {
+        lockedStats->addRuntimeStat(
+            "stolenSplits",
+            RuntimeCounter(numStolenSplits_, RuntimeCounter::Unit::kNone));
+        numStolenSplits_ = 0;
+      }
     }
 
-    driverCtx_->task->splitFinished();
+    finishSplit();
+  }
+}
+
+void TableScan::checkSplitSteal() {
+  if (driverCtx_->task->numSplitStealWaiters() == 0) {
+    return;
+  }
+  auto remaining = dataSource_->splitRemaining();
+  if (remaining == nullptr) {
+    return;
+  }
+  ++numStolenSplits_;
+  driverCtx_->task->addStolenSplit(
+      driverCtx_->splitGroupId, planNodeId(), std::move(remaining));
+}
+
+void TableScan::finishSplit() {
+  driverCtx_->task->splitFinished();
+  if (splitStealing_) {
+    driverCtx_->task->stealableSplitFinished(
+        driverCtx_->splitGroupId, planNodeId());
+  }
+  needNewSplit_ = true;
+}
+
+void TableScan::startDeferredDrivers(bool all) {
+  if (driverCtx_->task->numDeferredDrivers() > 0) {
+    driverCtx_->task->startDeferredDrivers(
+        driverCtx_->pipelineId, planNodeId(), all);
+  }
+}
+
+void TableScan::close() {
+  if (!needNewSplit_ && splitStealing_) {
+    // Do not leave the drivers waiting for a stolen split from 'this'.
+    driverCtx_->task->stealableSplitFinished(
+        driverCtx_->splitGroupId, planNodeId());
     needNewSplit_ = true;
   }
+  if (adaptiveDrivers_) {
+    // Do not leave the held back Drivers of the pipeline unstarted.
+    startDeferredDrivers(true);
+  }
+  // Release the reader of the current split. If the scan closes before the
+  // split is done, e.g. after a downstream Limit finished, this cancels the
+  // pending coalesced loads of the split instead of letting them complete.
+  dataSource_.reset();
+  SourceOperator::close();
 }
 
 void TableScan::preload(std::shared_ptr<connector::ConnectorSplit> split) {
@@ -235,6 +313,13 @@ void TableScan::checkPreload() {
     return;
   }
   if (dataSource_->allPrefetchIssued()) {
+    if (!dataSource_->canPrefetch()) {
+      // The splits already preloaded stay preloaded but no new preloads are
+      // started before the prefetched data gets consumed.
+      maxPreloadedSplits_ = 0;
+      ++numThrottledPreloads_;
+      return;
+    }
     maxPreloadedSplits_ = driverCtx_->task->numDrivers(driverCtx_->driver) *
         FLAGS_split_preload_per_driver;
     if (!splitPreloader_) {
@@ -252,17 +337,47 @@ bool TableScan::isFinished() {
 }
 
 void TableScan::setBatchSize() {
-  constexpr int64_t kMB = 1 << 20;
-  auto estimate = dataSource_->estimatedRowSize();
-  if (estimate == connector::DataSource::kUnknownRowSize) {
-    readBatchSize_ = kDefaultBatchSize;
-    return;
+  estimatedRowSize_ = dataSource_->estimatedRowSize();
+}
+
+vector_size_t TableScan::batchSize() {
+  // The rows already read tell the width better than the estimate of the
+  // file, which does not see the rows dropped by filters or the sizes of
+  // strings and collections.
+  const int64_t rowSize = observedRows_ > 0
+      ? std::max<int64_t>(1, observedBytes_ / observedRows_)
+      : estimatedRowSize_;
+  if (rowSize == connector::DataSource::kUnknownRowSize) {
+    return preferredBatchRows_;
   }
-  if (estimate < 1024) {
-    readBatchSize_ = 10000; // No more than 10MB of data per batch.
-    return;
+  int64_t targetBytes = preferredBatchBytes_;
+  if (auto* exchangeMemory = downstreamExchangeMemory()) {
+    // A quarter of the space left in the exchange, so that a batch of wide
+    // rows does not overshoot its limit while the consumers fall behind.
+    const auto freeBytes =
+        exchangeMemory->maxBufferSize() - exchangeMemory->bufferedBytes();
+    targetBytes = std::min<int64_t>(targetBytes, freeBytes / 4);
+  }
+  return std::clamp<int64_t>(
+      targetBytes / std::max<int64_t>(1, rowSize), 1, kMaxBatchSize);
+}
+
+LocalExchangeMemoryManager* TableScan::downstreamExchangeMemory() {
+  if (!exchangeMemoryChecked_) {
+    exchangeMemoryChecked_ = true;
+    // The operators of the driver are all made by the first getOutput().
+    if (driverCtx_->driver != nullptr) {
+      auto operators = driverCtx_->driver->operators();
+      if (auto* localPartition =
+              dynamic_cast<LocalPartition*>(operators.back())) {
+        exchangeMemory_ = localPartition->memoryManager();
+      }
+    }
+  }
+  if (exchangeMemory_ == nullptr || exchangeMemory_->maxBufferSize() <= 0) {
+    return nullptr;
   }
-  readBatchSize_ = std::min<int64_t>(100, 10 * kMB / estimate);
+  return exchangeMemory_;
 }
 
 void TableScan::addDynamicFilter(
@@ -22,6 +22,8 @@ DECLARE_int32(split_preload_per_driver);
 
 namespace facebook::velox::exec {
 
+class LocalExchangeMemoryManager;
+
 class TableScan : public SourceOperator {
  public:
   TableScan(
@@ -41,6 +43,8 @@ class TableScan : public SourceOperator {
 
   bool isFinished() override;
 
+  void close() override;
+
   bool canAddDynamicFilter() const override {
     return connector_->canAddDynamicFilter();
   }
@@ -57,12 +61,14 @@ class TableScan : public SourceOperator {
   }
 
  private:
-  static constexpr int32_t kDefaultBatchSize = 1024;
+  // Upper bound of rows read per batch however narrow the rows are.
+  static constexpr int32_t kMaxBatchSize = 10'000;
 
   // Sets 'maxPreloadSplits' and 'splitPreloader' if prefetching
   // splits is appropriate. The preloader will be applied to the
   // 'first 'maxPreloadSplits' of the Tasks's split queue for 'this'
-  // when getting splits.
+  // when getting splits. Preloading pauses while the data source has
+  // no memory budget for prefetch.
   void checkPreload();
 
   // Sets 'split->dataSource' to be a Asyncsource that makes a
@@ -71,14 +77,41 @@ class TableScan : public SourceOperator {
   // needed before prepare is done, it will be made when needed.
   void preload(std::shared_ptr<connector::ConnectorSplit> split);
 
-  // Adjust batch size according to split information.
+  // Takes the estimated row size of the new split for sizing the batches
+  // until rows are read.
   void setBatchSize();
 
+  // Returns the number of rows to read for a batch of about
+  // 'preferredBatchBytes_', or less while the downstream local exchange is
+  // filling up.
+  vector_size_t batchSize();
+
+  // Returns the memory manager of the local exchange the driver of 'this'
+  // produces into, or nullptr if there is none.
+  LocalExchangeMemoryManager* downstreamExchangeMemory();
+
+  // Gives the unread part of the current split to the drivers waiting for a
+  // stolen split if there are any.
+  void checkSplitSteal();
+
+  // Signals the end of the current split to the Task.
+  void finishSplit();
+
+  // Starts a held back Driver of the pipeline of 'this' if splits are
+  // queued, or all of them if 'all' is true.
+  void startDeferredDrivers(bool all);
+
   const std::shared_ptr<connector::ConnectorTableHandle> tableHandle_;
   const std::
       unordered_map<std::string, std::shared_ptr<connector::ColumnHandle>>
           columnHandles_;
   DriverCtx* driverCtx_;
+  // True if idle drivers of the scan may take over the unread parts of the
+  // splits of 'this' and the other drivers.
+  const bool splitStealing_;
+  // True if the Task holds back Drivers of the pipeline of 'this' until
+  // splits queue up. See QueryConfig::kAdaptiveScanDrivers.
+  const bool adaptiveDrivers_;
   ContinueFuture blockingFuture_{ContinueFuture::makeEmpty()};
   BlockingReason blockingReason_;
   bool needNewSplit_ = true;
@@ -106,7 +139,27 @@ class TableScan : public SourceOperator {
   // Count of splits that finished preloading before being read.
   int32_t numReadyPreloadedSplits_{0};
 
-  int32_t readBatchSize_{kDefaultBatchSize};
+  // Count of checks for preloading splits that found no memory budget for
+  // prefetch.
+  int32_t numThrottledPreloads_{0};
+
+  // Count of splits whose unread part was given to another driver.
+  int32_t numStolenSplits_{0};
+
+  // Rows per batch when the row size is unknown.
+  const vector_size_t preferredBatchRows_;
+
+  const uint64_t preferredBatchBytes_;
+
+  // Row size estimated by the data source for the current split.
+  int64_t estimatedRowSize_{connector::DataSource::kUnknownRowSize};
+
+  // Bytes and rows of the batches produced so far.
+  int64_t observedBytes_{0};
+  int64_t observedRows_{0};
+
+  bool exchangeMemoryChecked_{false};
+  LocalExchangeMemoryManager* exchangeMemory_{nullptr};
 
   // String shown in ExceptionContext inside DataSource and LazyVector loading.
   std::string debugString_;
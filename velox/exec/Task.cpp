@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <array>
 #include <boost/lexical_cast.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
@@ -28,6 +29,7 @@
 #include "velox/exec/LocalPlanner.h"
 #include "velox/exec/Merge.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
+#include "velox/exec/RangeJoinBuild.h"
 #include "velox/exec/Task.h"
 #if CODEGEN_ENABLED == 1
 #include "velox/experimental/codegen/CodegenLogger.h"
@@ -165,6 +167,23 @@ Task::Task(
                     : ConsumerSupplier{}),
           std::move(onError)} {}
 
+Task::Task(
+    const std::string& taskId,
+    std::shared_ptr<const PlannedFragment> plannedFragment,
+    int destination,
+    std::shared_ptr<core::QueryCtx> queryCtx,
+    ConsumerSupplier consumerSupplier,
+    std::function<void(std::exception_ptr)> onError)
+    : Task{
+          taskId,
+          plannedFragment->planFragment(),
+          destination,
+          std::move(queryCtx),
+          std::move(consumerSupplier),
+          std::move(onError)} {
+  plannedFragment_ = std::move(plannedFragment);
+}
+
 namespace {
 std::string makeUuid() {
   return boost::lexical_cast<std::string>(boost::uuids::random_generator()());
@@ -198,6 +217,9 @@ Task::Task(
           return this->getErrorMsgOnMemCapExceeded(tracker);
         });
   }
+  if (queryCtx_->queryConfig().exprShareVectorFunctions()) {
+    vectorFunctionCache_ = std::make_unique<exec::VectorFunctionCache>();
+  }
 }
 
 Task::~Task() {
@@ -320,6 +342,22 @@ velox::memory::MemoryPool* Task::addExchangeClientPool(
   return childPools_.back().get();
 }
 
+void Task::planDriverFactories(
+    ConsumerSupplier consumerSupplier,
+    std::vector<std::unique_ptr<DriverFactory>>* driverFactories,
+    uint32_t maxDrivers) const {
+  if (plannedFragment_) {
+    plannedFragment_->instantiate(
+        std::move(consumerSupplier), driverFactories, maxDrivers);
+  } else {
+    LocalPlanner::plan(
+        planFragment_,
+        std::move(consumerSupplier),
+        driverFactories,
+        maxDrivers);
+  }
+}
+
 bool Task::supportsSingleThreadedExecution() const {
   std::vector<std::unique_ptr<DriverFactory>> driverFactories;
 
@@ -327,7 +365,7 @@ bool Task::supportsSingleThreadedExecution() const {
     return false;
   }
 
-  LocalPlanner::plan(planFragment_, nullptr, &driverFactories, 1);
+  planDriverFactories(nullptr, &driverFactories, 1);
 
   for (const auto& factory : driverFactories) {
     if (!factory->supportsSingleThreadedExecution()) {
@@ -364,7 +402,7 @@ RowVectorPtr Task::next(ContinueFuture* future) {
         "Single-threaded execution doesn't support delivering results to a "
         "callback");
 
-    LocalPlanner::plan(planFragment_, nullptr, &driverFactories_, 1);
+    planDriverFactories(nullptr, &driverFactories_, 1);
     exchangeClients_.resize(driverFactories_.size());
 
     // In Task::next() we always assume ungrouped execution.
@@ -448,6 +486,101 @@ RowVectorPtr Task::next(ContinueFuture* future) {
   }
 }
 
+class Task::MemoryReclaimer : public memory::MemoryReclaimer {
+ public:
+  explicit MemoryReclaimer(const std::shared_ptr<Task>& task) : task_(task) {}
+
+  int64_t reclaimableBytes() override {
+    auto task = task_.lock();
+    if (task == nullptr || pausePending_) {
+      return 0;
+    }
+    std::lock_guard<std::mutex> l(task->mutex_);
+    if (task->state_ != TaskState::kRunning) {
+      return 0;
+    }
+    // This is an estimate as the drivers might be running.
+    int64_t reclaimableBytes{0};
+    for (const auto& driver : task->drivers_) {
+      if (driver == nullptr || driver->state().isSuspended) {
+        continue;
+      }
+      for (auto* op : driver->operators()) {
+        reclaimableBytes += op->reclaimableBytes();
+      }
+    }
+    return reclaimableBytes;
+  }
+
+  int64_t reclaim(int64_t targetBytes) override {
+    auto task = task_.lock();
+    if (task == nullptr || pausePending_) {
+      return 0;
+    }
+    const auto& tracker = task->queryCtx_->pool()->getMemoryUsageTracker();
+    const int64_t reservedBytes = tracker->reservedBytes();
+
+    auto pauseFuture = task->requestPause();
+    pauseFuture.wait(std::chrono::milliseconds(kPauseTimeoutMs));
+    if (!pauseFuture.isReady()) {
+      // A driver of the task might be blocked on this arbitration. Resume the
+      // task after it has paused and skip it until then.
+      pausePending_ = true;
+      std::move(pauseFuture)
+          .via(task->queryCtx_->executor())
+          .thenValue([this, task](auto&& /* unused */) {
+            resume(task);
+            pausePending_ = false;
+          });
+      return 0;
+    }
+
+    {
+      std::lock_guard<std::mutex> l(task->mutex_);
+      if (task->state_ == TaskState::kRunning) {
+        for (const auto& driver : task->drivers_) {
+          // A driver in a suspended section is off thread but might still
+          // run the code of its operators.
+          if (driver == nullptr || driver->state().isSuspended) {
+            continue;
+          }
+          for (auto* op : driver->operators()) {
+            if (!op->canReclaim()) {
+              continue;
+            }
+            try {
+              op->reclaim(targetBytes);
+            } catch (const std::exception& e) {
+              LOG(WARNING) << "Failed to reclaim memory from " << op->toString()
+                           << " of task " << task->taskId() << ": "
+                           << e.what();
+            }
+          }
+        }
+      }
+    }
+    resume(task);
+    return std::max<int64_t>(0, reservedBytes - tracker->reservedBytes());
+  }
+
+ private:
+  static constexpr int32_t kPauseTimeoutMs = 1'000;
+
+  static void resume(const std::shared_ptr<Task>& task) {
+    try {
+      Task::resume(task);
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Failed to resume task " << task->taskId()
+                   << " after memory reclaim: " << e.what();
+    }
+  }
+
+  const std::weak_ptr<Task> task_;
+
+  // Set if a timed out pause has not been resumed yet.
+  std::atomic<bool> pausePending_{false};
+};
+
 /*static*/
 void Task::start(
     std::shared_ptr<Task> self,
@@ -469,7 +602,7 @@ void Task::start(
 
 #if CODEGEN_ENABLED == 1
     const auto& config = self->queryCtx()->queryConfig();
-    if (config.codegenEnabled() &&
+    if (!self->plannedFragment_ && config.codegenEnabled() &&
         config.codegenConfigurationFilePath().length() != 0) {
       auto codegenLogger =
           std::make_shared<codegen::DefaultLogger>(self->taskId_);
@@ -484,11 +617,8 @@ void Task::start(
 #endif
 
     // Here we create driver factories.
-    LocalPlanner::plan(
-        self->planFragment_,
-        self->consumerSupplier(),
-        &self->driverFactories_,
-        maxDrivers);
+    self->planDriverFactories(
+        self->consumerSupplier(), &self->driverFactories_, maxDrivers);
 
     // Keep one exchange client per pipeline (NULL if not used).
     numPipelines = self->driverFactories_.size();
@@ -554,6 +684,15 @@ void Task::start(
     }
   }
 
+  // Let the memory arbitrator reclaim the memory of this task if the query
+  // runs under a root memory pool.
+  auto* queryPool = self->queryCtx_->pool();
+  const auto& queryTracker = queryPool->getMemoryUsageTracker();
+  if (queryPool->parent() == nullptr && queryTracker != nullptr) {
+    self->memoryReclaimer_ = std::make_shared<MemoryReclaimer>(self);
+    queryTracker->addReclaimer(self->memoryReclaimer_);
+  }
+
   std::unique_lock<std::mutex> l(self->mutex_);
 
   // Preallocate a bunch of slots for max concurrent grouped execution
@@ -596,12 +735,22 @@ void Task::start(
     }
     // We might have first slots taken for grouped execution drivers, so need
     // only to enqueue the ungrouped execution drivers.
-    for (auto it = self->drivers_.end() - self->numDriversUngrouped_;
-         it != self->drivers_.end();
-         ++it) {
-      if (*it) {
+    if (self->queryCtx()->queryConfig().adaptiveScanDrivers()) {
+      self->deferredDriverSlots_.resize(numPipelines);
+    }
+    for (auto i = self->drivers_.size() - self->numDriversUngrouped_;
+         i < self->drivers_.size();
+         ++i) {
+      auto& driver = self->drivers_[i];
+      if (driver) {
+        if (self->isDeferredScanDriver(*driver)) {
+          self->deferredDriverSlots_[driver->driverCtx()->pipelineId]
+              .push_back(i);
+          ++self->numDeferredDrivers_;
+          continue;
+        }
         ++self->numRunningDrivers_;
-        Driver::enqueue(*it);
+        Driver::enqueue(driver);
       }
     }
   }
@@ -616,6 +765,55 @@ void Task::start(
   }
 }
 
+bool Task::isDeferredScanDriver(const Driver& driver) const {
+  if (deferredDriverSlots_.empty()) {
+    return false;
+  }
+  const auto* driverCtx = driver.driverCtx();
+  const auto& factory = driverFactories_[driverCtx->pipelineId];
+  // The first Driver of the pipeline starts right away. The others start
+  // while there are queued splits. See startDeferredDrivers().
+  return driverCtx->driverId > 0 && !factory->groupedExecution &&
+      std::dynamic_pointer_cast<const core::TableScanNode>(
+          factory->planNodes.front()) != nullptr;
+}
+
+void Task::startDeferredDrivers(
+    int pipelineId,
+    const core::PlanNodeId& planNodeId,
+    bool all) {
+  std::vector<std::shared_ptr<Driver>> drivers;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (!isRunningLocked() || deferredDriverSlots_.empty()) {
+      return;
+    }
+    auto& slots = deferredDriverSlots_[pipelineId];
+    if (slots.empty()) {
+      return;
+    }
+    if (!all &&
+        getPlanNodeSplitsStateLocked(planNodeId)
+            .groupSplitsStores[kUngroupedGroupId]
+            .splits.empty()) {
+      // The running Drivers keep up with the splits.
+      return;
+    }
+    while (!slots.empty() && (all || drivers.empty())) {
+      auto& driver = drivers_[slots.back()];
+      slots.pop_back();
+      --numDeferredDrivers_;
+      if (driver) {
+        ++numRunningDrivers_;
+        drivers.push_back(driver);
+      }
+    }
+  }
+  for (auto& driver : drivers) {
+    Driver::enqueue(driver);
+  }
+}
+
 // static
 void Task::resume(std::shared_ptr<Task> self) {
   VELOX_CHECK(!self->exception_, "Cannot resume failed task");
@@ -623,8 +821,14 @@ void Task::resume(std::shared_ptr<Task> self) {
   // Setting pause requested must be atomic with the resuming so that
   // suspended sections do not go back on thread during resume.
   self->pauseRequested_ = false;
-  for (auto& driver : self->drivers_) {
-    if (driver) {
+  // Drivers held back by adaptive scan drivers start on their own.
+  std::unordered_set<uint32_t> deferredSlots;
+  for (const auto& slots : self->deferredDriverSlots_) {
+    deferredSlots.insert(slots.begin(), slots.end());
+  }
+  for (auto i = 0; i < self->drivers_.size(); ++i) {
+    auto& driver = self->drivers_[i];
+    if (driver && deferredSlots.count(i) == 0) {
       if (driver->state().isSuspended) {
         // The Driver will come on thread in its own time as long as
         // the cancel flag is reset. This check needs to be inside 'mutex_'.
@@ -701,6 +905,7 @@ void Task::createSplitGroupStateLocked(uint32_t splitGroupId) {
 
     addHashJoinBridgesLocked(splitGroupId, factory->needsHashJoinBridges());
     addCrossJoinBridgesLocked(splitGroupId, factory->needsCrossJoinBridges());
+    addRangeJoinBridgesLocked(splitGroupId, factory->needsRangeJoinBridges());
     addCustomJoinBridgesLocked(splitGroupId, factory->planNodes);
   }
 }
@@ -919,6 +1124,33 @@ bool Task::addSplitWithSequence(
 }
 
 void Task::addSplit(const core::PlanNodeId& planNodeId, exec::Split&& split) {
+  // A split of a bucketed table goes to the split group of its bucket, so
+  // that the splits of matching buckets on both sides of a join are
+  // processed together. A table with a multiple of 'numSplitGroups' buckets
+  // maps several buckets to the same group.
+  if (!split.hasGroup() && split.hasConnectorSplit() &&
+      isGroupedExecution() &&
+      planFragment_.leafNodeRunsGroupedExecution(planNodeId)) {
+    if (auto bucket = split.connectorSplit->bucketNumber()) {
+      VELOX_CHECK_GT(planFragment_.numSplitGroups, 0);
+      split.groupId = bucket.value() % planFragment_.numSplitGroups;
+    }
+  }
+
+  if (split.hasConnectorSplit() &&
+      std::dynamic_pointer_cast<RemoteConnectorSplit>(split.connectorSplit) ==
+          nullptr) {
+    // The connector may divide a table scan split for different drivers to
+    // read its parts in parallel.
+    auto connectorSplits =
+        connector::getConnector(split.connectorSplit->connectorId)
+            ->divideSplit(split.connectorSplit);
+    if (connectorSplits.size() > 1) {
+      addDividedSplits(planNodeId, std::move(connectorSplits), split.groupId);
+      return;
+    }
+  }
+
   bool isTaskRunning;
   std::unique_ptr<ContinuePromise> promise;
   {
@@ -940,6 +1172,31 @@ void Task::addSplit(const core::PlanNodeId& planNodeId, exec::Split&& split) {
   }
 }
 
+void Task::addDividedSplits(
+    const core::PlanNodeId& planNodeId,
+    std::vector<std::shared_ptr<connector::ConnectorSplit>>&& connectorSplits,
+    int32_t groupId) {
+  std::vector<std::unique_ptr<ContinuePromise>> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (!isRunningLocked()) {
+      return;
+    }
+    auto& splitsState = getPlanNodeSplitsStateLocked(planNodeId);
+    for (auto& connectorSplit : connectorSplits) {
+      auto promise = addSplitLocked(
+          splitsState, exec::Split(std::move(connectorSplit), groupId));
+      if (promise) {
+        promises.push_back(std::move(promise));
+      }
+    }
+  }
+
+  for (auto& promise : promises) {
+    promise->setValue();
+  }
+}
+
 void Task::addRemoteSplit(
     const core::PlanNodeId& planNodeId,
     const exec::Split& split) {
@@ -1038,7 +1295,10 @@ void Task::noMoreSplits(const core::PlanNodeId& planNodeId) {
       // Mark all split stores as 'no more splits'.
       for (auto& it : splitsState.groupSplitsStores) {
         it.second.noMoreSplits = true;
-        splitPromises = std::move(it.second.splitPromises);
+        for (auto& promise : it.second.splitPromises) {
+          splitPromises.push_back(std::move(promise));
+        }
+        it.second.splitPromises.clear();
       }
     } else if (!planFragment_.leafNodeRunsGroupedExecution(planNodeId)) {
       // During ungrouped execution, in the unlikely case there are no split
@@ -1102,14 +1362,78 @@ BlockingReason Task::getSplitOrFuture(
     exec::Split& split,
     ContinueFuture& future,
     int32_t maxPreloadSplits,
-    std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload) {
+    std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload,
+    bool splitStealing) {
   std::lock_guard<std::mutex> l(mutex_);
-  return getSplitOrFutureLocked(
-      getPlanNodeSplitsStateLocked(planNodeId).groupSplitsStores[splitGroupId],
-      split,
-      future,
-      maxPreloadSplits,
-      preload);
+  auto& splitsStore =
+      getPlanNodeSplitsStateLocked(planNodeId).groupSplitsStores[splitGroupId];
+  if (splitStealing && splitsStore.splits.empty() &&
+      splitsStore.noMoreSplits && splitsStore.numStealableSplits > 0) {
+    // Wait for a driver reading a split to give up the unread part of it.
+    auto [splitPromise, splitFuture] = makeVeloxContinuePromiseContract(
+        fmt::format("Task::getSplitOrFuture stolen split {}", taskId_));
+    future = std::move(splitFuture);
+    splitsStore.splitPromises.push_back(std::move(splitPromise));
+    ++numSplitStealWaiters_;
+    return BlockingReason::kWaitForSplit;
+  }
+  auto reason = getSplitOrFutureLocked(
+      splitsStore, split, future, maxPreloadSplits, preload);
+  if (splitStealing && split.hasConnectorSplit()) {
+    ++splitsStore.numStealableSplits;
+  }
+  return reason;
+}
+
+void Task::stealableSplitFinished(
+    uint32_t splitGroupId,
+    const core::PlanNodeId& planNodeId) {
+  std::vector<ContinuePromise> promises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto& splitsStore = getPlanNodeSplitsStateLocked(planNodeId)
+                            .groupSplitsStores[splitGroupId];
+    VELOX_CHECK_GT(splitsStore.numStealableSplits, 0);
+    --splitsStore.numStealableSplits;
+    if (splitsStore.numStealableSplits == 0 && splitsStore.noMoreSplits &&
+        splitsStore.splits.empty()) {
+      // Nothing is left to steal. The waiting drivers get no split and finish.
+      numSplitStealWaiters_ -= splitsStore.splitPromises.size();
+      promises = std::move(splitsStore.splitPromises);
+      splitsStore.splitPromises.clear();
+    }
+  }
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
+void Task::addStolenSplit(
+    uint32_t splitGroupId,
+    const core::PlanNodeId& planNodeId,
+    std::shared_ptr<connector::ConnectorSplit> connectorSplit) {
+  std::unique_ptr<ContinuePromise> promise;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (!isRunningLocked()) {
+      return;
+    }
+    auto& splitsState = getPlanNodeSplitsStateLocked(planNodeId);
+    // After no-more-splits, all the waiting drivers wait for a stolen split.
+    const bool stealWaiter =
+        splitsState.groupSplitsStores[splitGroupId].noMoreSplits;
+    promise = addSplitLocked(
+        splitsState,
+        exec::Split(
+            std::move(connectorSplit),
+            isGroupedExecution() ? static_cast<int32_t>(splitGroupId) : -1));
+    if (promise && stealWaiter) {
+      --numSplitStealWaiters_;
+    }
+  }
+  if (promise) {
+    promise->setValue();
+  }
 }
 
 BlockingReason Task::getSplitOrFutureLocked(
@@ -1375,6 +1699,16 @@ void Task::addCrossJoinBridgesLocked(
   }
 }
 
+void Task::addRangeJoinBridgesLocked(
+    uint32_t splitGroupId,
+    const std::vector<core::PlanNodeId>& planNodeIds) {
+  auto& splitGroupState = splitGroupStates_[splitGroupId];
+  for (const auto& planNodeId : planNodeIds) {
+    splitGroupState.bridges.emplace(
+        planNodeId, std::make_shared<RangeJoinBridge>());
+  }
+}
+
 std::shared_ptr<HashJoinBridge> Task::getHashJoinBridge(
     uint32_t splitGroupId,
     const core::PlanNodeId& planNodeId) {
@@ -1393,6 +1727,12 @@ std::shared_ptr<CrossJoinBridge> Task::getCrossJoinBridge(
   return getJoinBridgeInternal<CrossJoinBridge>(splitGroupId, planNodeId);
 }
 
+std::shared_ptr<RangeJoinBridge> Task::getRangeJoinBridge(
+    uint32_t splitGroupId,
+    const core::PlanNodeId& planNodeId) {
+  return getJoinBridgeInternal<RangeJoinBridge>(splitGroupId, planNodeId);
+}
+
 template <class TBridgeType>
 std::shared_ptr<TBridgeType> Task::getJoinBridgeInternal(
     uint32_t splitGroupId,
@@ -1618,6 +1958,12 @@ void Task::addOperatorStats(OperatorStats& stats) {
       .add(stats);
 }
 
+void Task::addDriverTimeline(std::vector<DriverTimelineEvent> events) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto& timeline = taskStats_.driverTimeline;
+  timeline.insert(timeline.end(), events.begin(), events.end());
+}
+
 TaskStats Task::taskStats() const {
   std::lock_guard<std::mutex> l(mutex_);
 
@@ -1626,6 +1972,8 @@ TaskStats Task::taskStats() const {
   TaskStats taskStats = taskStats_;
 
   taskStats.numTotalDrivers = drivers_.size();
+  taskStats.onThreadNanos = onThreadNanos_;
+  taskStats.numTimeSliceYields = numTimeSliceYields_;
 
   // Add stats of the drivers (their operators) that are still running.
   for (const auto& driver : drivers_) {
@@ -1653,6 +2001,27 @@ TaskStats Task::taskStats() const {
   return taskStats;
 }
 
+memory::MemoryProfile Task::memoryProfile(
+    const memory::MemoryProfile* previous) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto profile = memory::MemoryProfile::create(*pool_, previous);
+  for (const auto& driver : drivers_) {
+    if (driver == nullptr) {
+      continue;
+    }
+    for (auto& op : driver->operators()) {
+      auto components = op->memoryComponents();
+      if (components.empty()) {
+        continue;
+      }
+      if (auto* opProfile = profile.find(op->pool()->name())) {
+        opProfile->components = std::move(components);
+      }
+    }
+  }
+  return profile;
+}
+
 uint64_t Task::timeSinceStartMs() const {
   std::lock_guard<std::mutex> l(mutex_);
   return timeSinceStartMsLocked();
@@ -1793,6 +2162,10 @@ void Task::createLocalExchangeQueuesLocked(
     exchange.queues.emplace_back(
         std::make_shared<LocalExchangeQueue>(exchange.memoryManager, i));
   }
+  exchange.scaleWriterState = std::make_shared<ScaleWriterState>(
+      exchange.memoryManager,
+      numPartitions,
+      queryCtx_->queryConfig().scaleWriterMinProcessedBytes());
 
   splitGroupState.localExchanges.insert({planNodeId, std::move(exchange)});
 }
@@ -1836,6 +2209,21 @@ Task::getLocalExchangeQueues(
   return it->second.queues;
 }
 
+const std::shared_ptr<ScaleWriterState>& Task::getScaleWriterState(
+    uint32_t splitGroupId,
+    const core::PlanNodeId& planNodeId) {
+  auto& splitGroupState = splitGroupStates_[splitGroupId];
+
+  auto it = splitGroupState.localExchanges.find(planNodeId);
+  VELOX_CHECK(
+      it != splitGroupState.localExchanges.end(),
+      "Incorrect local exchange ID {} for group {}, task {}",
+      planNodeId,
+      splitGroupId,
+      taskId());
+  return it->second.scaleWriterState;
+}
+
 void Task::setError(const std::exception_ptr& exception) {
   TestValue::adjust("facebook::velox::exec::Task::setError", this);
   {
@@ -2010,6 +2398,27 @@ StopReason Task::shouldStopLocked() {
   return StopReason::kNone;
 }
 
+int8_t Task::schedulingPriority(uint8_t numPriorities) const {
+  // Levels of accumulated on-thread time, like the multilevel split queue of
+  // Presto.
+  static constexpr std::array<uint64_t, 5> kLevelThresholdsMs = {
+      0, 1'000, 10'000, 60'000, 300'000};
+  if (numPriorities <= 1) {
+    return 0;
+  }
+  const uint64_t onThreadMs = onThreadNanos_ / 1'000'000;
+  int32_t level = 0;
+  while (level + 1 < kLevelThresholdsMs.size() &&
+         onThreadMs >= kLevelThresholdsMs[level + 1]) {
+    ++level;
+  }
+  level = std::min<int32_t>(level, numPriorities - 1);
+  // folly executors run the highest priority first. With n queues the
+  // priorities range from (n + 1) / 2 - 1 down to (n + 1) / 2 - n.
+  const int32_t highest = (numPriorities + 1) / 2 - 1;
+  return highest - level;
+}
+
 ContinueFuture Task::requestPause() {
   std::lock_guard<std::mutex> l(mutex_);
   pauseRequested_ = true;
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #pragma once
+#include "velox/common/memory/MemoryProfile.h"
 #include "velox/core/PlanFragment.h"
 #include "velox/core/QueryCtx.h"
 #include "velox/exec/Driver.h"
@@ -22,6 +23,7 @@
 #include "velox/exec/Split.h"
 #include "velox/exec/TaskStats.h"
 #include "velox/exec/TaskStructs.h"
+#include "velox/expression/VectorFunction.h"
 #include "velox/vector/ComplexVector.h"
 
 namespace facebook::velox::exec {
@@ -30,6 +32,8 @@ class PartitionedOutputBufferManager;
 
 class HashJoinBridge;
 class CrossJoinBridge;
+class RangeJoinBridge;
+class PlannedFragment;
 class Task : public std::enable_shared_from_this<Task> {
  public:
   /// Creates a task to execute a plan fragment, but doesn't start execution
@@ -64,6 +68,17 @@ class Task : public std::enable_shared_from_this<Task> {
       ConsumerSupplier consumerSupplier,
       std::function<void(std::exception_ptr)> onError = nullptr);
 
+  /// Creates a task that runs a fragment planned ahead of time. Tasks
+  /// repeatedly running the same fragment share 'plannedFragment' to skip
+  /// splitting the plan into pipelines.
+  Task(
+      const std::string& taskId,
+      std::shared_ptr<const PlannedFragment> plannedFragment,
+      int destination,
+      std::shared_ptr<core::QueryCtx> queryCtx,
+      ConsumerSupplier consumerSupplier,
+      std::function<void(std::exception_ptr)> onError = nullptr);
+
   ~Task();
 
   /// Specify directory to which data will be spilled if spilling is enabled and
@@ -103,6 +118,12 @@ class Task : public std::enable_shared_from_this<Task> {
     return pool_.get();
   }
 
+  /// Returns the cache of VectorFunctions shared by the Drivers or nullptr if
+  /// each Driver makes its own.
+  exec::VectorFunctionCache* FOLLY_NULLABLE vectorFunctionCache() const {
+    return vectorFunctionCache_.get();
+  }
+
   /// Returns ConsumerSupplier passed in the constructor.
   ConsumerSupplier consumerSupplier() const {
     return consumerSupplier_;
@@ -240,6 +261,13 @@ class Task : public std::enable_shared_from_this<Task> {
   /// structure.
   TaskStats taskStats() const;
 
+  /// Returns the memory profile of the pools of 'this' with the memory
+  /// components reported by the running operators attached to the pools of
+  /// the operators. If 'previous' is an earlier profile of 'this', sets the
+  /// allocation rates since then.
+  memory::MemoryProfile memoryProfile(
+      const memory::MemoryProfile* previous = nullptr) const;
+
   /// Returns time (ms) since the task execution started or zero, if not
   /// started.
   uint64_t timeSinceStartMs() const;
@@ -318,7 +346,11 @@ class Task : public std::enable_shared_from_this<Task> {
   /// that will complete when split becomes available or no-more-splits
   /// signal is received. If 'maxPreloadSplits' is given, ensures that
   /// so many of splits at the head of the queue are preloading. If
-  /// they are not, calls preload on them to start preload.
+  /// they are not, calls preload on them to start preload. If
+  /// 'splitStealing' is true, the returned split counts as stealable until
+  /// stealableSplitFinished() and, after no-more-splits, the caller waits
+  /// while other stealable splits are being read instead of getting a null
+  /// split.
   BlockingReason getSplitOrFuture(
       uint32_t splitGroupId,
       const core::PlanNodeId& planNodeId,
@@ -326,10 +358,44 @@ class Task : public std::enable_shared_from_this<Task> {
       ContinueFuture& future,
       int32_t maxPreloadSplits = 0,
       std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload =
-          nullptr);
+          nullptr,
+      bool splitStealing = false);
 
   void splitFinished();
 
+  /// Signals that the reader of a split returned by getSplitOrFuture() with
+  /// 'splitStealing' is done with it. Wakes up the drivers waiting for a
+  /// stolen split if there is nothing left to steal.
+  void stealableSplitFinished(
+      uint32_t splitGroupId,
+      const core::PlanNodeId& planNodeId);
+
+  /// Adds 'connectorSplit', the unread part of a stealable split, for the
+  /// drivers waiting for a stolen split.
+  void addStolenSplit(
+      uint32_t splitGroupId,
+      const core::PlanNodeId& planNodeId,
+      std::shared_ptr<connector::ConnectorSplit> connectorSplit);
+
+  /// Returns the number of drivers waiting for a stolen split. This is a
+  /// hint for the readers of stealable splits to give up a part of theirs.
+  int32_t numSplitStealWaiters() const {
+    return numSplitStealWaiters_;
+  }
+
+  /// Enqueues a Driver of pipeline 'pipelineId' that was held back by
+  /// adaptive scan drivers if splits are queued for the scan 'planNodeId'.
+  /// Enqueues all the held back Drivers of the pipeline if 'all' is true.
+  void startDeferredDrivers(
+      int pipelineId,
+      const core::PlanNodeId& planNodeId,
+      bool all);
+
+  /// Returns the number of Drivers held back by adaptive scan drivers.
+  int32_t numDeferredDrivers() const {
+    return numDeferredDrivers_;
+  }
+
   void multipleSplitsFinished(int32_t numSplits);
 
   /// Adds a MergeSource for the specified splitGroupId and planNodeId.
@@ -368,6 +434,12 @@ class Task : public std::enable_shared_from_this<Task> {
       uint32_t splitGroupId,
       const core::PlanNodeId& planNodeId);
 
+  /// Returns the state shared by the producers of local exchange
+  /// 'planNodeId' that scales the table writers it feeds.
+  const std::shared_ptr<ScaleWriterState>& getScaleWriterState(
+      uint32_t splitGroupId,
+      const core::PlanNodeId& planNodeId);
+
   void setError(const std::exception_ptr& exception);
 
   void setError(const std::string& message);
@@ -403,6 +475,11 @@ class Task : public std::enable_shared_from_this<Task> {
       uint32_t splitGroupId,
       const std::vector<core::PlanNodeId>& planNodeIds);
 
+  /// Adds RangeJoinBridge's for all the specified plan node IDs.
+  void addRangeJoinBridgesLocked(
+      uint32_t splitGroupId,
+      const std::vector<core::PlanNodeId>& planNodeIds);
+
   /// Adds custom join bridges for all the specified plan nodes.
   void addCustomJoinBridgesLocked(
       uint32_t splitGroupId,
@@ -425,6 +502,11 @@ class Task : public std::enable_shared_from_this<Task> {
       uint32_t splitGroupId,
       const core::PlanNodeId& planNodeId);
 
+  /// Returns a RangeJoinBridge for 'planNodeId'.
+  std::shared_ptr<RangeJoinBridge> getRangeJoinBridge(
+      uint32_t splitGroupId,
+      const core::PlanNodeId& planNodeId);
+
   /// Returns a custom join bridge for 'planNodeId'.
   std::shared_ptr<JoinBridge> getCustomJoinBridge(
       uint32_t splitGroupId,
@@ -511,6 +593,26 @@ class Task : public std::enable_shared_from_this<Task> {
     toYield_ = numThreads_;
   }
 
+  /// Adds the wall time a Driver of 'this' spent on a thread in one run.
+  void addOnThreadTime(uint64_t nanos) {
+    onThreadNanos_ += nanos;
+  }
+
+  /// Counts a Driver of 'this' yielding at the end of its time slice.
+  void addTimeSliceYield() {
+    ++numTimeSliceYields_;
+  }
+
+  /// Adds the timeline of a sampled Driver of 'this' to the Task stats.
+  void addDriverTimeline(std::vector<DriverTimelineEvent> events);
+
+  /// Returns the executor priority for the next run of a Driver of 'this'
+  /// on an executor with 'numPriorities' priority queues. A Task starts at
+  /// the highest priority and drops a level each time its accumulated
+  /// on-thread time crosses 1s, 10s, 60s and 300s, so that short queries
+  /// overtake long running ones.
+  int8_t schedulingPriority(uint8_t numPriorities) const;
+
   /// Once 'pauseRequested_' is set, it will not be cleared until
   /// task::resume(). It is therefore OK to read it without a mutex
   /// from a thread that this flag concerns.
@@ -566,6 +668,17 @@ class Task : public std::enable_shared_from_this<Task> {
   // Validate that the supplied grouped execution leaf nodes make sense.
   void validateGroupedExecutionLeafNodes();
 
+  // Fills 'driverFactories' from 'plannedFragment_' if set or by planning
+  // 'planFragment_' otherwise.
+  void planDriverFactories(
+      ConsumerSupplier consumerSupplier,
+      std::vector<std::unique_ptr<DriverFactory>>* driverFactories,
+      uint32_t maxDrivers) const;
+
+  // Returns true if 'driver' should not be enqueued on Task start because of
+  // adaptive scan drivers.
+  bool isDeferredScanDriver(const Driver& driver) const;
+
   // Returns true if all nodes expecting splits have received 'no more splits'
   // message.
   bool allNodesReceivedNoMoreSplitsMessageLocked() const;
@@ -622,6 +735,13 @@ class Task : public std::enable_shared_from_this<Task> {
       uint32_t splitGroupId,
       const core::PlanNodeId& planNodeId);
 
+  /// Adds the splits a connector divided a split of group 'groupId' into.
+  /// The splits are dropped if the task is not running.
+  void addDividedSplits(
+      const core::PlanNodeId& planNodeId,
+      std::vector<std::shared_ptr<connector::ConnectorSplit>>&& connectorSplits,
+      int32_t groupId);
+
   /// Add remote split to ExchangeClient for the specified plan node. Used to
   /// close remote sources that are added after the task completed early.
   void addRemoteSplit(
@@ -821,6 +941,10 @@ class Task : public std::enable_shared_from_this<Task> {
   };
   friend class Task::TaskCounter;
 
+  // Frees the memory of the query on memory arbitration by pausing the task
+  // and spilling its reclaimable operators. Defined in Task.cpp.
+  class MemoryReclaimer;
+
   // NOTE: keep 'taskCount_' the first member so that it will be the first
   // constructed member and the last destructed one. The purpose is to make
   // 'numCreatedTasks_' and 'numDeletedTasks_' counting more robust to the
@@ -836,6 +960,8 @@ class Task : public std::enable_shared_from_this<Task> {
   // unique or universally unique.
   const std::string taskId_;
   core::PlanFragment planFragment_;
+  // Set if the task was created from a fragment planned ahead of time.
+  std::shared_ptr<const PlannedFragment> plannedFragment_;
   const int destination_;
   const std::shared_ptr<core::QueryCtx> queryCtx_;
 
@@ -853,6 +979,11 @@ class Task : public std::enable_shared_from_this<Task> {
   // NOTE: 'childPools_' holds the ownerships of node memory pools.
   std::unordered_map<core::PlanNodeId, memory::MemoryPool*> nodePools_;
 
+  // The VectorFunctions shared by the expressions of the Drivers if
+  // QueryConfig::exprShareVectorFunctions() is true. The functions may hold
+  // constants allocated from 'childPools_'.
+  std::unique_ptr<exec::VectorFunctionCache> vectorFunctionCache_;
+
   // Set to true by PartitionedOutputBufferManager when all output is
   // acknowledged. If this happens before Drivers are at end, the last
   // Driver to finish will set state_ to kFinished. If Drivers have
@@ -887,6 +1018,11 @@ class Task : public std::enable_shared_from_this<Task> {
 
   std::vector<std::unique_ptr<DriverFactory>> driverFactories_;
   std::vector<std::shared_ptr<Driver>> drivers_;
+
+  // Added to the root memory usage tracker of the query on task start. The
+  // tracker only holds a weak reference.
+  std::shared_ptr<MemoryReclaimer> memoryReclaimer_;
+
   /// The total number of running drivers in all pipelines.
   /// This number changes over time as drivers finish their work and maybe new
   /// get created.
@@ -972,6 +1108,20 @@ class Task : public std::enable_shared_from_this<Task> {
   std::atomic<bool> terminateRequested_{false};
   std::atomic<int32_t> toYield_ = 0;
   int32_t numThreads_ = 0;
+
+  // Accumulated on-thread time and time slice yields of the Drivers.
+  std::atomic<uint64_t> onThreadNanos_{0};
+  std::atomic<uint64_t> numTimeSliceYields_{0};
+
+  // Number of drivers waiting for a stolen split.
+  std::atomic<int32_t> numSplitStealWaiters_{0};
+
+  // Slots in 'drivers_' of the ungrouped Drivers that are not enqueued yet,
+  // by pipeline. See QueryConfig::kAdaptiveScanDrivers.
+  std::vector<std::vector<uint32_t>> deferredDriverSlots_;
+
+  // Total size of 'deferredDriverSlots_'.
+  std::atomic<int32_t> numDeferredDrivers_{0};
   // Promises for the futures returned to callers of requestPause() or
   // terminate(). They are fulfilled when the last thread stops
   // running for 'this'.
@@ -85,6 +85,17 @@ struct TaskStats {
   uint64_t numRunningDrivers{0};
   /// Drivers blocked for various reasons. Based on enum BlockingReason.
   std::unordered_map<BlockingReason, uint64_t> numBlockedDrivers;
+
+  /// Total wall time the Drivers spent on threads.
+  uint64_t onThreadNanos{0};
+
+  /// The number of times a Driver yielded because its time slice expired.
+  /// See QueryConfig::kDriverTimeSliceMs.
+  uint64_t numTimeSliceYields{0};
+
+  /// Timeline events of the sampled Drivers that have finished. See
+  /// QueryConfig::kDriverTimelineSamplePct and toDriverTimelineTrace().
+  std::vector<DriverTimelineEvent> driverTimeline;
 };
 
 } // namespace facebook::velox::exec
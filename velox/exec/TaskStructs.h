@@ -26,6 +26,7 @@ class Driver;
 class JoinBridge;
 class LocalExchangeMemoryManager;
 class LocalExchangeSource;
+class ScaleWriterState;
 class MergeSource;
 class MergeJoinSource;
 class Split;
@@ -50,6 +51,9 @@ struct SplitsStore {
   bool noMoreSplits{false};
   /// Blocking promises given out when out of splits to distribute.
   std::vector<ContinuePromise> splitPromises;
+  /// Number of splits being read by table scans that can give up the unread
+  /// part of their split to a waiting driver. Used for split stealing.
+  int32_t numStealableSplits{0};
 };
 
 /// Structure contains the current info on splits for a particular plan node.
@@ -73,6 +77,8 @@ struct SplitsState {
 struct LocalExchangeState {
   std::shared_ptr<LocalExchangeMemoryManager> memoryManager;
   std::vector<std::shared_ptr<LocalExchangeQueue>> queues;
+  /// Used if the exchange scales the table writers it feeds.
+  std::shared_ptr<ScaleWriterState> scaleWriterState;
 };
 
 /// Stores inter-operator state (exchange, bridges) for split groups.
@@ -18,6 +18,62 @@
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::exec {
+namespace {
+std::optional<SortKeyPrefix> makeSortKeyPrefix(
+    const RowTypePtr& type,
+    const core::TopNNode& topNNode) {
+  std::vector<TypePtr> keyTypes;
+  std::vector<column_index_t> keyChannels;
+  std::vector<CompareFlags> keyCompareFlags;
+  for (auto i = 0; i < topNNode.sortingKeys().size(); ++i) {
+    const auto channel = exprToChannel(topNNode.sortingKeys()[i].get(), type);
+    if (channel == kConstantChannel) {
+      // Reported by the comparator.
+      return std::nullopt;
+    }
+    const auto& sortOrder = topNNode.sortingOrders()[i];
+    keyTypes.push_back(type->childAt(channel));
+    keyChannels.push_back(channel);
+    keyCompareFlags.push_back(
+        {sortOrder.isNullsFirst(), sortOrder.isAscending(), false});
+  }
+  if (!SortKeyPrefix::isSupported(keyTypes[0])) {
+    return std::nullopt;
+  }
+  return SortKeyPrefix(keyTypes, keyChannels, keyCompareFlags);
+}
+
+bool isThresholdKind(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+int64_t thresholdValue(
+    TypeKind kind,
+    const char* FOLLY_NONNULL row,
+    int32_t offset) {
+  switch (kind) {
+    case TypeKind::TINYINT:
+      return RowContainer::valueAt<int8_t>(row, offset);
+    case TypeKind::SMALLINT:
+      return RowContainer::valueAt<int16_t>(row, offset);
+    case TypeKind::INTEGER:
+      return RowContainer::valueAt<int32_t>(row, offset);
+    case TypeKind::BIGINT:
+      return RowContainer::valueAt<int64_t>(row, offset);
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+} // namespace
+
 TopN::TopN(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -29,22 +85,38 @@ TopN::TopN(
           topNNode->id(),
           "TopN"),
       count_(topNNode->count()),
-      data_(std::make_unique<RowContainer>(outputType_->children(), pool())),
+      sortKeyPrefix_(makeSortKeyPrefix(outputType_, *topNNode)),
+      data_(std::make_unique<RowContainer>(
+          outputType_->children(),
+          std::vector<TypePtr>{},
+          sortKeyPrefix_.has_value(),
+          pool())),
       comparator_(
           outputType_,
           topNNode->sortingKeys(),
           topNNode->sortingOrders(),
-          data_.get()),
+          data_.get(),
+          sortKeyPrefix_.has_value()),
       topRows_(comparator_),
-      decodedVectors_(outputType_->children().size()) {}
+      decodedVectors_(outputType_->children().size()) {
+  const auto channel =
+      exprToChannel(topNNode->sortingKeys()[0].get(), outputType_);
+  if (channel != kConstantChannel &&
+      isThresholdKind(outputType_->childAt(channel)->kind())) {
+    thresholdChannel_ = channel;
+    thresholdAscending_ = topNNode->sortingOrders()[0].isAscending();
+    thresholdNullsFirst_ = topNNode->sortingOrders()[0].isNullsFirst();
+  }
+}
 
 TopN::Comparator::Comparator(
     const RowTypePtr& type,
     const std::vector<std::shared_ptr<const core::FieldAccessTypedExpr>>&
         sortingKeys,
     const std::vector<core::SortOrder>& sortingOrders,
-    RowContainer* rowContainer)
-    : rowContainer_(rowContainer) {
+    RowContainer* rowContainer,
+    bool hasSortKeyPrefix)
+    : rowContainer_(rowContainer), hasSortKeyPrefix_(hasSortKeyPrefix) {
   auto numKeys = sortingKeys.size();
   for (int i = 0; i < numKeys; ++i) {
     auto channel = exprToChannel(sortingKeys[i].get(), type);
@@ -64,13 +136,16 @@ void TopN::addInput(RowVectorPtr input) {
   }
 
   for (int row = 0; row < input->size(); ++row) {
+    const uint64_t prefix = sortKeyPrefix_.has_value()
+        ? sortKeyPrefix_->encode(decodedVectors_, row)
+        : 0;
     char* newRow = nullptr;
     if (topRows_.size() < count_) {
       newRow = data_->newRow();
     } else {
       char* topRow = topRows_.top();
 
-      if (!comparator_(decodedVectors_, row, topRow)) {
+      if (!comparator_(decodedVectors_, row, prefix, topRow)) {
         continue;
       }
       topRows_.pop();
@@ -81,9 +156,51 @@ void TopN::addInput(RowVectorPtr input) {
     for (int col = 0; col < input->childrenSize(); ++col) {
       data_->store(decodedVectors_[col], row, newRow, col);
     }
+    if (sortKeyPrefix_.has_value()) {
+      RowContainer::normalizedKey(newRow) = prefix;
+    }
 
     topRows_.push(newRow);
   }
+  updateDynamicFilter();
+}
+
+void TopN::updateDynamicFilter() {
+  if (!thresholdChannel_.has_value() || topRows_.empty() ||
+      topRows_.size() < count_) {
+    return;
+  }
+  const auto channel = thresholdChannel_.value();
+  if (!thresholdPushdownChecked_) {
+    thresholdPushdownChecked_ = true;
+    const auto channels =
+        operatorCtx_->driverCtx()->driver->canPushdownFilters(this, {channel});
+    if (channels.empty()) {
+      thresholdChannel_.reset();
+      return;
+    }
+  }
+
+  const auto column = data_->columnAt(channel);
+  const char* topRow = topRows_.top();
+  if (RowContainer::isNullAt(topRow, column.nullByte(), column.nullMask())) {
+    // Either all the non-null keys sort before the null or only nulls can
+    // enter. Neither is worth a filter.
+    return;
+  }
+  const auto value = thresholdValue(
+      outputType_->childAt(channel)->kind(), topRow, column.offset());
+  if (threshold_ == value) {
+    return;
+  }
+  threshold_ = value;
+  // A key equal to the threshold may still enter on the following keys. A
+  // null enters if nulls sort first.
+  dynamicFilters_[channel] = thresholdAscending_
+      ? std::make_shared<common::BigintRange>(
+            std::numeric_limits<int64_t>::min(), value, thresholdNullsFirst_)
+      : std::make_shared<common::BigintRange>(
+            value, std::numeric_limits<int64_t>::max(), thresholdNullsFirst_);
 }
 
 RowVectorPtr TopN::getOutput() {
@@ -17,6 +17,7 @@
 
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/SortKeyPrefix.h"
 
 namespace facebook::velox::exec {
 
@@ -45,6 +46,12 @@ class TopN : public Operator {
 
  private:
   static constexpr size_t kMaxNumRowsToReturn = 1024;
+
+  // Publishes the leading sorting key of the current top row as a dynamic
+  // filter once 'topRows_' is full. A row with a leading key past it can't
+  // enter the top rows, so the filter lets an upstream table scan skip such
+  // rows. A new filter is published each time the threshold tightens.
+  void updateDynamicFilter();
   class Comparator {
    public:
     Comparator(
@@ -52,13 +59,21 @@ class TopN : public Operator {
         const std::vector<std::shared_ptr<const core::FieldAccessTypedExpr>>&
             sortingKeys,
         const std::vector<core::SortOrder>& sortingOrders,
-        RowContainer* rowContainer);
+        RowContainer* rowContainer,
+        bool hasSortKeyPrefix);
 
     // Returns true if lhs < rhs, false otherwise.
     bool operator()(const char* lhs, const char* rhs) {
       if (lhs == rhs) {
         return false;
       }
+      if (hasSortKeyPrefix_) {
+        const auto lhsPrefix = RowContainer::normalizedKey(lhs);
+        const auto rhsPrefix = RowContainer::normalizedKey(rhs);
+        if (lhsPrefix != rhsPrefix) {
+          return lhsPrefix < rhsPrefix;
+        }
+      }
       for (auto& key : keyInfo_) {
         if (auto result = rowContainer_->compare(
                 lhs,
@@ -71,11 +86,20 @@ class TopN : public Operator {
       return false;
     }
 
-    // Returns true if decodeVectors[index] < rhs, false otherwise.
+    // Returns true if decodeVectors[index] < rhs, false otherwise. 'prefix'
+    // is the sort key prefix of decodedVectors[index] and is ignored if the
+    // rows have no sort key prefix.
     bool operator()(
         const std::vector<DecodedVector>& decodedVectors,
         vector_size_t index,
+        uint64_t prefix,
         const char* rhs) {
+      if (hasSortKeyPrefix_) {
+        const auto rhsPrefix = RowContainer::normalizedKey(rhs);
+        if (prefix != rhsPrefix) {
+          return prefix < rhsPrefix;
+        }
+      }
       for (auto& key : keyInfo_) {
         if (auto result = rowContainer_->compare(
                 rhs,
@@ -92,6 +116,9 @@ class TopN : public Operator {
    private:
     std::vector<std::pair<column_index_t, core::SortOrder>> keyInfo_;
     RowContainer* rowContainer_;
+    // True if the rows in 'rowContainer_' have a sort key prefix in their
+    // normalized key word.
+    bool hasSortKeyPrefix_;
   };
 
   const int32_t count_;
@@ -108,11 +135,26 @@ class TopN : public Operator {
   // Once all inputs are available, we copy the final set of rows to the
   // vector (rows_) in correct order. We use this vector along with the
   // RowContainer to generate the TopN's output.
+  //
+  // If the leading sorting key allows, the rows in 'data_' store the sort key
+  // prefix encoded by 'sortKeyPrefix_' in their normalized key word.
+  std::optional<SortKeyPrefix> sortKeyPrefix_;
   std::unique_ptr<RowContainer> data_;
   Comparator comparator_;
   std::priority_queue<char*, std::vector<char*>, Comparator> topRows_;
   std::vector<char*> rows_;
 
   std::vector<DecodedVector> decodedVectors_;
+
+  // The channel of the leading sorting key if it is of an integer type whose
+  // threshold can be pushed down as a BigintRange. Reset if no upstream
+  // operator accepts the filter.
+  std::optional<column_index_t> thresholdChannel_;
+  bool thresholdAscending_{true};
+  bool thresholdNullsFirst_{false};
+  // True once the upstream operators are checked for accepting the filter.
+  bool thresholdPushdownChecked_{false};
+  // The last published threshold.
+  std::optional<int64_t> threshold_;
 };
 } // namespace facebook::velox::exec
@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/TopNRowNumber.h"
+
+#include <numeric>
+
+#include "velox/exec/OperatorUtils.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::exec {
+
+TopNRowNumber::Comparator::Comparator(
+    const RowTypePtr& inputType,
+    const std::vector<core::FieldAccessTypedExprPtr>& sortingKeys,
+    const std::vector<core::SortOrder>& sortingOrders,
+    RowContainer* rowContainer)
+    : rowContainer_(rowContainer) {
+  for (auto i = 0; i < sortingKeys.size(); ++i) {
+    const auto channel = exprToChannel(sortingKeys[i].get(), inputType);
+    VELOX_USER_CHECK_NE(
+        channel,
+        kConstantChannel,
+        "TopNRowNumber doesn't allow constant sorting keys");
+    keyInfo_.emplace_back(
+        channel,
+        CompareFlags{
+            sortingOrders[i].isNullsFirst(),
+            sortingOrders[i].isAscending(),
+            false});
+  }
+}
+
+bool TopNRowNumber::Comparator::operator()(const char* lhs, const char* rhs)
+    const {
+  if (lhs == rhs) {
+    return false;
+  }
+  for (const auto& [channel, flags] : keyInfo_) {
+    if (auto result = rowContainer_->compare(lhs, rhs, channel, flags)) {
+      return result < 0;
+    }
+  }
+  return false;
+}
+
+bool TopNRowNumber::Comparator::operator()(
+    const std::vector<DecodedVector>& decodedVectors,
+    vector_size_t index,
+    const char* rhs) const {
+  for (const auto& [channel, flags] : keyInfo_) {
+    if (auto result = rowContainer_->compare(
+            rhs,
+            rowContainer_->columnAt(channel),
+            decodedVectors[channel],
+            index,
+            flags)) {
+      return result > 0;
+    }
+  }
+  return false;
+}
+
+TopNRowNumber::TopNRowNumber(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    const std::shared_ptr<const core::TopNRowNumberNode>& node)
+    : Operator(
+          driverCtx,
+          node->outputType(),
+          operatorId,
+          node->id(),
+          "TopNRowNumber"),
+      limit_(node->limit()),
+      generateRowNumber_(node->generateRowNumber()),
+      numInputColumns_(node->sources()[0]->outputType()->size()),
+      outputBatchSize_(driverCtx->queryConfig().preferredOutputBatchSize()),
+      data_(std::make_unique<RowContainer>(
+          node->sources()[0]->outputType()->children(),
+          pool())),
+      comparator_(
+          node->sources()[0]->outputType(),
+          node->sortingKeys(),
+          node->sortingOrders(),
+          data_.get()),
+      decodedVectors_(numInputColumns_) {
+  const auto& inputType = node->sources()[0]->outputType();
+  if (node->partitionKeys().empty()) {
+    partitions_.emplace_back(comparator_);
+    return;
+  }
+
+  std::vector<std::unique_ptr<VectorHasher>> hashers;
+  for (const auto& key : node->partitionKeys()) {
+    const auto channel = exprToChannel(key.get(), inputType);
+    VELOX_USER_CHECK_NE(
+        channel,
+        kConstantChannel,
+        "TopNRowNumber doesn't allow constant partition keys");
+    hashers.push_back(VectorHasher::create(key->type(), channel));
+  }
+  numPartitionKeys_ = hashers.size();
+  // Nulls in the partition keys form partitions of their own.
+  table_ = HashTable<false>::createForGrouping(
+      std::move(hashers), {BIGINT()}, pool());
+  table_->forceGenericHashMode();
+  lookup_ = std::make_unique<HashLookup>(table_->hashers());
+}
+
+void TopNRowNumber::findPartitions(const RowVectorPtr& input) {
+  const auto numInput = input->size();
+  inputPartitions_.resize(numInput);
+  if (table_ == nullptr) {
+    std::fill(inputPartitions_.begin(), inputPartitions_.end(), 0);
+    return;
+  }
+
+  auto& hashers = lookup_->hashers;
+  lookup_->reset(numInput);
+  for (auto i = 0; i < hashers.size(); ++i) {
+    auto key = input->childAt(hashers[i]->channel())->loadedVector();
+    hashers[i]->decode(*key, allRows_);
+    hashers[i]->hash(allRows_, i > 0, lookup_->hashes);
+  }
+  std::iota(lookup_->rows.begin(), lookup_->rows.end(), 0);
+  table_->groupProbe(*lookup_);
+
+  const auto offset = table_->rows()->columnAt(numPartitionKeys_).offset();
+  for (auto row : lookup_->newGroups) {
+    RowContainer::valueAt<int64_t>(lookup_->hits[row], offset) =
+        partitions_.size();
+    partitions_.emplace_back(comparator_);
+  }
+  for (auto row = 0; row < numInput; ++row) {
+    inputPartitions_[row] =
+        RowContainer::valueAt<int64_t>(lookup_->hits[row], offset);
+  }
+}
+
+void TopNRowNumber::addInput(RowVectorPtr input) {
+  const auto numInput = input->size();
+  allRows_.resize(numInput);
+  allRows_.setAll();
+  findPartitions(input);
+
+  for (auto col = 0; col < numInputColumns_; ++col) {
+    decodedVectors_[col].decode(*input->childAt(col), allRows_);
+  }
+
+  for (auto row = 0; row < numInput; ++row) {
+    auto& topRows = partitions_[inputPartitions_[row]];
+    char* newRow = nullptr;
+    if (topRows.size() < limit_) {
+      newRow = data_->newRow();
+    } else {
+      char* topRow = topRows.top();
+      if (!comparator_(decodedVectors_, row, topRow)) {
+        continue;
+      }
+      topRows.pop();
+      // Reuse the topRow's memory.
+      newRow = data_->initializeRow(topRow, true /* reuse */);
+    }
+
+    for (auto col = 0; col < numInputColumns_; ++col) {
+      data_->store(decodedVectors_[col], row, newRow, col);
+    }
+    topRows.push(newRow);
+  }
+}
+
+void TopNRowNumber::noMoreInput() {
+  Operator::noMoreInput();
+
+  size_t numRows = 0;
+  for (const auto& topRows : partitions_) {
+    numRows += topRows.size();
+  }
+  if (numRows == 0) {
+    finished_ = true;
+    return;
+  }
+
+  outputRows_.resize(numRows);
+  rowNumbers_.resize(numRows);
+  size_t end = 0;
+  for (auto& topRows : partitions_) {
+    // The heap pops the rows of a partition in reverse order.
+    end += topRows.size();
+    for (auto next = end; !topRows.empty(); --next) {
+      outputRows_[next - 1] = topRows.top();
+      rowNumbers_[next - 1] = topRows.size();
+      topRows.pop();
+    }
+  }
+  partitions_.clear();
+}
+
+RowVectorPtr TopNRowNumber::getOutput() {
+  if (finished_ || !noMoreInput_) {
+    return nullptr;
+  }
+
+  const auto numOutput = std::min<size_t>(
+      outputBatchSize_, outputRows_.size() - numRowsReturned_);
+  auto output = BaseVector::create<RowVector>(outputType_, numOutput, pool());
+  for (auto i = 0; i < numInputColumns_; ++i) {
+    data_->extractColumn(
+        outputRows_.data() + numRowsReturned_,
+        numOutput,
+        i,
+        output->childAt(i));
+  }
+  if (generateRowNumber_) {
+    auto* rowNumbers =
+        output->childAt(numInputColumns_)->asFlatVector<int64_t>();
+    for (auto i = 0; i < numOutput; ++i) {
+      rowNumbers->set(i, rowNumbers_[numRowsReturned_ + i]);
+    }
+  }
+
+  numRowsReturned_ += numOutput;
+  finished_ = numRowsReturned_ == outputRows_.size();
+  return output;
+}
+} // namespace facebook::velox::exec
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#pragma once
+
+#include <queue>
+
+#include "velox/exec/HashTable.h"
+#include "velox/exec/Operator.h"
+#include "velox/exec/RowContainer.h"
+
+namespace facebook::velox::exec {
+
+/// Keeps the first 'limit' rows of each partition in the order of the sorting
+/// keys, optionally numbering them within their partition. A hash table on the
+/// partition keys maps each row to its partition, and each partition keeps a
+/// heap of at most 'limit' rows stored in a RowContainer, so the memory is
+/// bounded by the number of partitions times 'limit'. The output is produced
+/// after all the input is received, one partition after another.
+class TopNRowNumber : public Operator {
+ public:
+  TopNRowNumber(
+      int32_t operatorId,
+      DriverCtx* driverCtx,
+      const std::shared_ptr<const core::TopNRowNumberNode>& node);
+
+  bool needsInput() const override {
+    return !noMoreInput_;
+  }
+
+  void addInput(RowVectorPtr input) override;
+
+  RowVectorPtr getOutput() override;
+
+  void noMoreInput() override;
+
+  BlockingReason isBlocked(ContinueFuture* /*future*/) override {
+    return BlockingReason::kNotBlocked;
+  }
+
+  bool isFinished() override {
+    return finished_;
+  }
+
+  void close() override {
+    Operator::close();
+    partitions_.clear();
+    table_.reset();
+    data_.reset();
+  }
+
+ private:
+  // Compares rows in 'data_' by the sorting keys.
+  class Comparator {
+   public:
+    Comparator(
+        const RowTypePtr& inputType,
+        const std::vector<core::FieldAccessTypedExprPtr>& sortingKeys,
+        const std::vector<core::SortOrder>& sortingOrders,
+        RowContainer* rowContainer);
+
+    // Returns true if lhs < rhs, false otherwise.
+    bool operator()(const char* lhs, const char* rhs) const;
+
+    // Returns true if decodedVectors[index] < rhs, false otherwise.
+    bool operator()(
+        const std::vector<DecodedVector>& decodedVectors,
+        vector_size_t index,
+        const char* rhs) const;
+
+   private:
+    std::vector<std::pair<column_index_t, CompareFlags>> keyInfo_;
+    RowContainer* rowContainer_;
+  };
+
+  // The top rows of a partition. The top of the heap is the last row in the
+  // order of the sorting keys.
+  using TopRows = std::priority_queue<char*, std::vector<char*>, Comparator>;
+
+  // Sets 'inputPartitions_' to the index in 'partitions_' of the partition of
+  // each row of 'input', adding partitions for the new partition keys.
+  void findPartitions(const RowVectorPtr& input);
+
+  const int32_t limit_;
+
+  const bool generateRowNumber_;
+
+  const column_index_t numInputColumns_;
+
+  const vector_size_t outputBatchSize_;
+
+  // Stores the input rows that are in the top rows of their partition.
+  std::unique_ptr<RowContainer> data_;
+
+  Comparator comparator_;
+
+  // Groups the input rows by the partition keys. Each group row has the index
+  // of its partition in 'partitions_' in a BIGINT column after the keys. Not
+  // set if there are no partition keys, in which case all the rows are in a
+  // single partition.
+  std::unique_ptr<BaseHashTable> table_;
+  std::unique_ptr<HashLookup> lookup_;
+  column_index_t numPartitionKeys_{0};
+
+  std::vector<TopRows> partitions_;
+
+  // The partition of each input row.
+  std::vector<int64_t> inputPartitions_;
+
+  SelectivityVector allRows_;
+  std::vector<DecodedVector> decodedVectors_;
+
+  // The rows of all the partitions in output order with their row numbers.
+  // Set on noMoreInput().
+  std::vector<char*> outputRows_;
+  std::vector<int64_t> rowNumbers_;
+  size_t numRowsReturned_{0};
+
+  bool finished_{false};
+};
+} // namespace facebook::velox::exec
@@ -120,6 +120,32 @@ class TreeOfLosers {
     return lastIndex_ == kEmpty ? nullptr : streams_[lastIndex_].get();
   }
 
+  // Returns the stream with the lowest first element among the streams other
+  // than the one last returned by next(), or nullptr if there is no such
+  // stream. These are the losers on the path from the last winner to the
+  // root, so this takes at most log(number of streams) comparisons. Lets the
+  // caller take a run of elements from the winner up to the first element
+  // that is greater than the first element of the returned stream without
+  // going through the tree for each element.
+  Stream* runnerUp() const {
+    if (lastIndex_ == kEmpty || values_.empty()) {
+      return nullptr;
+    }
+    TIndex result = kEmpty;
+    for (auto node = parent(firstStream_ + lastIndex_);;
+         node = parent(node)) {
+      const auto value = values_[node];
+      if (value != kEmpty &&
+          (result == kEmpty || *streams_[value] < *streams_[result])) {
+        result = value;
+      }
+      if (node == 0) {
+        break;
+      }
+    }
+    return result == kEmpty ? nullptr : streams_[result].get();
+  }
+
   // Returns the stream with the lowest first element and a flag that
   // is true if there is another equal value to come from some other
   // stream. The streams should have ordered unique values when using
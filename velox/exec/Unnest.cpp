@@ -30,7 +30,8 @@ Unnest::Unnest(
           operatorId,
           unnestNode->id(),
           "Unnest"),
-      withOrdinality_(unnestNode->withOrdinality()) {
+      withOrdinality_(unnestNode->withOrdinality()),
+      maxOutputSize_(driverCtx->queryConfig().preferredOutputBatchSize()) {
   const auto& inputType = unnestNode->sources()[0]->outputType();
   const auto& unnestVariables = unnestNode->unnestVariables();
   for (const auto& variable : unnestVariables) {
@@ -58,51 +59,43 @@ Unnest::Unnest(
 
 void Unnest::addInput(RowVectorPtr input) {
   input_ = std::move(input);
-}
-
-RowVectorPtr Unnest::getOutput() {
-  if (!input_) {
-    return nullptr;
-  }
+  nextInputRow_ = 0;
+  nextElement_ = 0;
 
   auto size = input_->size();
   inputRows_.resize(size);
 
-  // The max number of elements at each row across all unnested columns.
-  auto maxSizes = AlignedBuffer::allocate<int64_t>(size, pool(), 0);
-  auto rawMaxSizes = maxSizes->asMutable<int64_t>();
+  maxSizes_ = allocateIndices(size, pool());
+  auto* rawMaxSizes = maxSizes_->asMutable<vector_size_t>();
+  rawMaxSizes_ = rawMaxSizes;
 
-  std::vector<const vector_size_t*> rawSizes;
-  std::vector<const vector_size_t*> rawOffsets;
-  std::vector<const vector_size_t*> rawIndices;
-
-  rawSizes.resize(unnestChannels_.size());
-  rawOffsets.resize(unnestChannels_.size());
-  rawIndices.resize(unnestChannels_.size());
+  rawSizes_.resize(unnestChannels_.size());
+  rawOffsets_.resize(unnestChannels_.size());
+  rawIndices_.resize(unnestChannels_.size());
 
   for (auto channel = 0; channel < unnestChannels_.size(); ++channel) {
     const auto& unnestVector = input_->childAt(unnestChannels_[channel]);
     unnestDecoded_[channel].decode(*unnestVector, inputRows_);
 
     auto& currentDecoded = unnestDecoded_[channel];
-    rawIndices[channel] = currentDecoded.indices();
+    rawIndices_[channel] = currentDecoded.indices();
 
     const ArrayVector* unnestBaseArray;
     const MapVector* unnestBaseMap;
     if (unnestVector->typeKind() == TypeKind::ARRAY) {
       unnestBaseArray = currentDecoded.base()->as<ArrayVector>();
-      rawSizes[channel] = unnestBaseArray->rawSizes();
-      rawOffsets[channel] = unnestBaseArray->rawOffsets();
+      rawSizes_[channel] = unnestBaseArray->rawSizes();
+      rawOffsets_[channel] = unnestBaseArray->rawOffsets();
     } else {
       VELOX_CHECK(unnestVector->typeKind() == TypeKind::MAP);
       unnestBaseMap = currentDecoded.base()->as<MapVector>();
-      rawSizes[channel] = unnestBaseMap->rawSizes();
-      rawOffsets[channel] = unnestBaseMap->rawOffsets();
+      rawSizes_[channel] = unnestBaseMap->rawSizes();
+      rawOffsets_[channel] = unnestBaseMap->rawOffsets();
     }
 
     // Count max number of elements per row.
-    auto currentSizes = rawSizes[channel];
-    auto currentIndices = rawIndices[channel];
+    auto currentSizes = rawSizes_[channel];
+    auto currentIndices = rawIndices_[channel];
     for (auto row = 0; row < size; ++row) {
       if (!currentDecoded.isNullAt(row)) {
         auto unnestSize = currentSizes[currentIndices[row]];
@@ -112,26 +105,53 @@ RowVectorPtr Unnest::getOutput() {
       }
     }
   }
+}
 
-  // Calculate the number of rows in the unnest result.
-  int numElements = 0;
-  for (auto row = 0; row < size; ++row) {
-    numElements += rawMaxSizes[row];
+RowVectorPtr Unnest::getOutput() {
+  if (!input_) {
+    return nullptr;
+  }
+
+  const auto size = input_->size();
+
+  // Find the input rows [firstRow, endRow) that make up the next output of
+  // at most 'maxOutputSize_' rows. The output starts at element
+  // 'firstElement' of 'firstRow' and ends at element 'lastRowEnd' of row
+  // endRow - 1, so that a large array may be split across outputs.
+  const auto firstRow = nextInputRow_;
+  const auto firstElement = nextElement_;
+  auto endRow = firstRow;
+  vector_size_t lastRowEnd = 0;
+  vector_size_t numElements = 0;
+  while (endRow < size && numElements < maxOutputSize_) {
+    auto begin = endRow == firstRow ? firstElement : 0;
+    auto end = std::min<vector_size_t>(
+        rawMaxSizes_[endRow], begin + (maxOutputSize_ - numElements));
+    numElements += end - begin;
+    lastRowEnd = end;
+    ++endRow;
   }
 
   if (numElements == 0) {
-    // All arrays/maps are null or empty.
+    // All remaining arrays/maps are null or empty.
     input_ = nullptr;
     return nullptr;
   }
 
+  auto rowBegin = [&](vector_size_t row) {
+    return row == firstRow ? firstElement : 0;
+  };
+  auto rowEnd = [&](vector_size_t row) {
+    return row == endRow - 1 ? lastRowEnd : rawMaxSizes_[row];
+  };
+
   // Create "indices" buffer to repeat rows as many times as there are elements
   // in the array (or map) in unnestDecoded.
   auto repeatedIndices = allocateIndices(numElements, pool());
   auto* rawRepeatedIndices = repeatedIndices->asMutable<vector_size_t>();
   vector_size_t index = 0;
-  for (auto row = 0; row < size; ++row) {
-    for (auto i = 0; i < rawMaxSizes[row]; i++) {
+  for (auto row = firstRow; row < endRow; ++row) {
+    for (auto i = rowBegin(row); i < rowEnd(row); i++) {
       rawRepeatedIndices[index++] = row;
     }
   }
@@ -147,9 +167,9 @@ RowVectorPtr Unnest::getOutput() {
   vector_size_t outputsIndex = identityProjections_.size();
   for (auto channel = 0; channel < unnestChannels_.size(); ++channel) {
     auto& currentDecoded = unnestDecoded_[channel];
-    auto currentSizes = rawSizes[channel];
-    auto currentOffsets = rawOffsets[channel];
-    auto currentIndices = rawIndices[channel];
+    auto currentSizes = rawSizes_[channel];
+    auto currentOffsets = rawOffsets_[channel];
+    auto currentIndices = rawIndices_[channel];
 
     BufferPtr elementIndices = allocateIndices(numElements, pool());
     auto* rawElementIndices = elementIndices->asMutable<vector_size_t>();
@@ -158,59 +178,64 @@ RowVectorPtr Unnest::getOutput() {
         AlignedBuffer::allocate<bool>(numElements, pool(), bits::kNotNull);
     auto rawNulls = nulls->asMutable<uint64_t>();
 
-    // Make dictionary index for elements column since they may be out of order.
+    // Make dictionary index for elements column since they may be out of
+    // order. If the elements are contiguous and not null, the unnest column
+    // is a slice of the elements starting at 'firstOffset'.
     index = 0;
-    bool identityMapping = true;
-    for (auto row = 0; row < size; ++row) {
-      auto maxSize = rawMaxSizes[row];
+    bool contiguous = true;
+    std::optional<vector_size_t> firstOffset;
+    for (auto row = firstRow; row < endRow; ++row) {
+      auto begin = rowBegin(row);
+      auto end = rowEnd(row);
+      if (begin == end) {
+        continue;
+      }
 
       if (!currentDecoded.isNullAt(row)) {
         auto offset = currentOffsets[currentIndices[row]];
         auto unnestSize = currentSizes[currentIndices[row]];
 
-        if (index != offset || unnestSize < maxSize) {
-          identityMapping = false;
+        if (!firstOffset.has_value()) {
+          firstOffset = offset + begin;
+        }
+        if (offset + begin != firstOffset.value() + index ||
+            unnestSize < end) {
+          contiguous = false;
         }
 
-        for (auto i = 0; i < unnestSize; i++) {
+        for (auto i = begin; i < std::min(unnestSize, end); i++) {
           rawElementIndices[index++] = offset + i;
         }
 
-        for (auto i = unnestSize; i < maxSize; ++i) {
+        for (auto i = std::max(unnestSize, begin); i < end; ++i) {
           bits::setNull(rawNulls, index++, true);
         }
-      } else if (maxSize > 0) {
-        identityMapping = false;
+      } else {
+        contiguous = false;
 
-        for (auto i = 0; i < maxSize; ++i) {
+        for (auto i = begin; i < end; ++i) {
           bits::setNull(rawNulls, index++, true);
         }
       }
     }
 
+    auto unnestColumn = [&](const VectorPtr& elements) {
+      return contiguous
+          ? elements->slice(firstOffset.value(), numElements)
+          : wrapChild(numElements, elementIndices, elements, nulls);
+    };
+
     if (currentDecoded.base()->typeKind() == TypeKind::ARRAY) {
       // Construct unnest column using Array elements wrapped using above
       // created dictionary.
       auto unnestBaseArray = currentDecoded.base()->as<ArrayVector>();
-      outputs[outputsIndex++] = identityMapping
-          ? unnestBaseArray->elements()
-          : wrapChild(
-                numElements,
-                elementIndices,
-                unnestBaseArray->elements(),
-                nulls);
+      outputs[outputsIndex++] = unnestColumn(unnestBaseArray->elements());
     } else {
       // Construct two unnest columns for Map keys and values vectors wrapped
       // using above created dictionary.
       auto unnestBaseMap = currentDecoded.base()->as<MapVector>();
-      outputs[outputsIndex++] = identityMapping
-          ? unnestBaseMap->mapKeys()
-          : wrapChild(
-                numElements, elementIndices, unnestBaseMap->mapKeys(), nulls);
-      outputs[outputsIndex++] = identityMapping
-          ? unnestBaseMap->mapValues()
-          : wrapChild(
-                numElements, elementIndices, unnestBaseMap->mapValues(), nulls);
+      outputs[outputsIndex++] = unnestColumn(unnestBaseMap->mapKeys());
+      outputs[outputsIndex++] = unnestColumn(unnestBaseMap->mapValues());
     }
   }
 
@@ -221,19 +246,31 @@ RowVectorPtr Unnest::getOutput() {
     // Set the ordinality at each result row to be the index of the element in
     // the original array (or map) plus one.
     auto rawOrdinality = ordinalityVector->mutableRawValues();
-    for (auto row = 0; row < size; ++row) {
-      auto maxSize = rawMaxSizes[row];
-      std::iota(rawOrdinality, rawOrdinality + maxSize, 1);
-      rawOrdinality += maxSize;
+    for (auto row = firstRow; row < endRow; ++row) {
+      auto begin = rowBegin(row);
+      auto end = rowEnd(row);
+      std::iota(rawOrdinality, rawOrdinality + (end - begin), begin + 1);
+      rawOrdinality += end - begin;
     }
 
     // Ordinality column is always at the end.
     outputs.back() = std::move(ordinalityVector);
   }
 
-  input_ = nullptr;
-  return std::make_shared<RowVector>(
+  auto output = std::make_shared<RowVector>(
       pool(), outputType_, BufferPtr(nullptr), numElements, std::move(outputs));
+
+  if (lastRowEnd < rawMaxSizes_[endRow - 1]) {
+    nextInputRow_ = endRow - 1;
+    nextElement_ = lastRowEnd;
+  } else {
+    nextInputRow_ = endRow;
+    nextElement_ = 0;
+  }
+  if (nextInputRow_ == size) {
+    input_ = nullptr;
+  }
+  return output;
 }
 
 bool Unnest::isFinished() {
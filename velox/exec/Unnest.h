@@ -29,7 +29,7 @@ class Unnest : public Operator {
   }
 
   bool needsInput() const override {
-    return true;
+    return input_ == nullptr;
   }
 
   void addInput(RowVectorPtr input) override;
@@ -45,5 +45,23 @@ class Unnest : public Operator {
   std::vector<DecodedVector> unnestDecoded_;
 
   const bool withOrdinality_;
+
+  // Max number of output rows. The elements of one input row may be split
+  // across several outputs.
+  const vector_size_t maxOutputSize_;
+
+  // The max number of elements at each row of 'input_' across all unnested
+  // columns.
+  BufferPtr maxSizes_;
+  const vector_size_t* rawMaxSizes_{nullptr};
+
+  std::vector<const vector_size_t*> rawSizes_;
+  std::vector<const vector_size_t*> rawOffsets_;
+  std::vector<const vector_size_t*> rawIndices_;
+
+  // The first row of 'input_' and the first element of that row not yet
+  // produced.
+  vector_size_t nextInputRow_{0};
+  vector_size_t nextElement_{0};
 };
 } // namespace facebook::velox::exec
@@ -93,24 +93,51 @@ void VectorHasher::hashValues(
       result[row] = mix ? bits::hashMix(result[row], hash) : hash;
     });
   } else {
-    cachedHashes_.resize(decoded_.base()->size());
-    std::fill(cachedHashes_.begin(), cachedHashes_.end(), kNullHash);
+    auto cachedHashes = prepareCachedHashes(CachedKind::kHashes, kNullHash);
     rows.applyToSelected([&](vector_size_t row) {
       if (decoded_.isNullAt(row)) {
         result[row] = mix ? bits::hashMix(result[row], kNullHash) : kNullHash;
         return;
       }
       auto baseIndex = decoded_.index(row);
-      uint64_t hash = cachedHashes_[baseIndex];
+      uint64_t hash = cachedHashes[baseIndex];
       if (hash == kNullHash) {
         hash = hashOne<Kind>(decoded_, row);
-        cachedHashes_[baseIndex] = hash;
+        cachedHashes[baseIndex] = hash;
       }
       result[row] = mix ? bits::hashMix(result[row], hash) : hash;
     });
   }
 }
 
+void VectorHasher::updateCachedBase(const BaseVector& vector) {
+  if (vector.encoding() == VectorEncoding::Simple::DICTIONARY &&
+      vector.valueVector().get() == decoded_.base() &&
+      decoded_.base()->encoding() == VectorEncoding::Simple::FLAT) {
+    if (cachedBase_ != vector.valueVector()) {
+      cachedBase_ = vector.valueVector();
+      cachedKind_ = CachedKind::kNone;
+    }
+    return;
+  }
+  cachedBase_ = nullptr;
+  cachedKind_ = CachedKind::kNone;
+}
+
+uint64_t* VectorHasher::prepareCachedHashes(
+    CachedKind kind,
+    uint64_t emptyValue) {
+  const auto size = decoded_.base()->size();
+  if (cachedKind_ != kind || cachedHashes_.size() != size) {
+    cachedHashes_.resize(size);
+    std::fill(cachedHashes_.begin(), cachedHashes_.end(), emptyValue);
+    // The entries can be reused by the next batch only if they are for a
+    // dictionary base vector that 'this' holds on to.
+    cachedKind_ = cachedBase_ ? kind : CachedKind::kNone;
+  }
+  return cachedHashes_.data();
+}
+
 template <TypeKind Kind>
 bool VectorHasher::makeValueIds(
     const SelectivityVector& rows,
@@ -246,8 +273,7 @@ template <typename T, bool mayHaveNulls>
 bool VectorHasher::makeValueIdsDecoded(
     const SelectivityVector& rows,
     uint64_t* result) {
-  cachedHashes_.resize(decoded_.base()->size());
-  std::fill(cachedHashes_.begin(), cachedHashes_.end(), 0);
+  auto cachedIds = prepareCachedHashes(CachedKind::kValueIds, 0);
 
   auto indices = decoded_.indices();
   auto values = decoded_.data<T>();
@@ -263,7 +289,7 @@ bool VectorHasher::makeValueIdsDecoded(
       }
     }
     auto baseIndex = indices[row];
-    uint64_t id = cachedHashes_[baseIndex];
+    uint64_t id = cachedIds[baseIndex];
     if (id == 0) {
       T value = values[baseIndex];
 
@@ -279,7 +305,7 @@ bool VectorHasher::makeValueIdsDecoded(
         success = false;
         return;
       }
-      cachedHashes_[baseIndex] = id;
+      cachedIds[baseIndex] = id;
     }
     result[row] = multiplier_ == 1 ? id : result[row] + multiplier_ * id;
   });
@@ -759,6 +785,7 @@ uint64_t VectorHasher::enableValueIds(uint64_t multiplier, int32_t reservePct) {
   multiplier_ = multiplier;
   rangeSize_ = addIdReserve(uniqueValues_.size(), reservePct) + 1;
   isRange_ = false;
+  cachedKind_ = CachedKind::kNone;
   uint64_t result;
   if (__builtin_mul_overflow(multiplier_, rangeSize_, &result)) {
     return kRangeTooLarge;
@@ -774,6 +801,7 @@ uint64_t VectorHasher::enableValueRange(
   VELOX_CHECK(hasRange_);
   extendRange(type_->kind(), reservePct, min_, max_);
   isRange_ = true;
+  cachedKind_ = CachedKind::kNone;
   // No overflow because max range is under 63 bits.
   if (typeKind_ == TypeKind::BOOLEAN) {
     rangeSize_ = 3;
@@ -795,6 +823,7 @@ void VectorHasher::copyStatsFrom(const VectorHasher& other) {
   min_ = other.min_;
   max_ = other.max_;
   uniqueValues_ = other.uniqueValues_;
+  cachedKind_ = CachedKind::kNone;
 }
 
 void VectorHasher::merge(const VectorHasher& other) {
@@ -177,15 +177,26 @@ class VectorHasher {
 
   // Decodes the 'vector' in preparation for calling hash() or
   // computeValueIds(). The decoded vector can be accessed via decodedVector()
-  // getter.
+  // getter. If 'vector' is a dictionary over the same base vector as in the
+  // previous call, e.g. a string column read from a dictionary encoded file,
+  // the hashes or value ids computed for the base values are reused.
   void decode(const BaseVector& vector, const SelectivityVector& rows) {
     decoded_.decode(vector, rows);
+    updateCachedBase(vector);
   }
 
   DecodedVector& decodedVector() {
     return decoded_;
   }
 
+  // Drops the reference to the dictionary base vector of the last decode().
+  // Called before 'this' outlives the operator that produced the vector, e.g.
+  // when a hash table is handed over from the build to the probe side.
+  void releaseCachedBase() {
+    cachedBase_ = nullptr;
+    cachedKind_ = CachedKind::kNone;
+  }
+
   // Computes a hash for 'rows' in the vector previously decoded via decode()
   // call and stores it in 'result'. If 'mix' is true, mixes the hash with
   // existing value in 'result'.
@@ -257,6 +268,7 @@ class VectorHasher {
   void resetStats() {
     uniqueValues_.clear();
     uniqueValuesStorage_.clear();
+    cachedKind_ = CachedKind::kNone;
   }
 
   // Sets 'this' to range mode and adds 'reservePct' values to the
@@ -539,6 +551,19 @@ class VectorHasher {
   template <TypeKind Kind>
   void hashValues(const SelectivityVector& rows, bool mix, uint64_t* result);
 
+  // What 'cachedHashes_' holds for the positions of the decoded base vector.
+  enum class CachedKind { kNone, kHashes, kValueIds };
+
+  // Keeps a reference to the base of 'vector' if it is a dictionary over a
+  // flat vector. Invalidates 'cachedHashes_' if the base is not the one
+  // 'cachedHashes_' was computed for.
+  void updateCachedBase(const BaseVector& vector);
+
+  // Returns 'cachedHashes_' sized for the decoded base vector. Keeps the
+  // cached entries if they are of 'kind' and for the same base vector,
+  // otherwise sets all entries to 'emptyValue'.
+  uint64_t* prepareCachedHashes(CachedKind kind, uint64_t emptyValue);
+
   const column_index_t channel_;
   const TypePtr type_;
   const TypeKind typeKind_;
@@ -546,6 +571,12 @@ class VectorHasher {
   DecodedVector decoded_;
   raw_vector<uint64_t> cachedHashes_;
 
+  // The dictionary base vector 'cachedHashes_' is computed for. Holding a
+  // reference keeps the vector from being changed in place, so that the
+  // entries stay valid across batches.
+  VectorPtr cachedBase_;
+  CachedKind cachedKind_{CachedKind::kNone};
+
   // Single precomputed hash for constant partition keys.
   uint64_t precomputedHash_{0};
 
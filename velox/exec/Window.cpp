@@ -55,9 +55,13 @@ Window::Window(
       outputBatchSizeInBytes_(
           driverCtx->queryConfig().preferredOutputBatchSize()),
       numInputColumns_(windowNode->sources()[0]->outputType()->size()),
-      data_(std::make_unique<RowContainer>(
-          windowNode->sources()[0]->outputType()->children(),
-          pool())),
+      inputsSorted_(windowNode->inputsSorted()),
+      spillMemoryThreshold_(
+          driverCtx->queryConfig().windowSpillMemoryThreshold()),
+      spillConfig_(
+          windowNode->canSpill(driverCtx->queryConfig())
+              ? operatorCtx_->makeSpillConfig(Spiller::Type::kWindow)
+              : std::nullopt),
       decodedInputVectors_(numInputColumns_),
       stringAllocator_(pool()) {
   auto inputType = windowNode->sources()[0]->outputType();
@@ -73,9 +77,53 @@ Window::Window(
   allKeyInfo_.insert(
       allKeyInfo_.cend(), sortKeyInfo_.begin(), sortKeyInfo_.end());
 
+  // Setup column projections to store the distinct key columns in 'data_'
+  // first. This enables sorting and spilling the rows by all keys.
+  std::vector<column_index_t> dataColumns(numInputColumns_, kConstantChannel);
+  std::vector<TypePtr> keyTypes;
+  std::vector<TypePtr> dependentTypes;
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  auto addColumn = [&](column_index_t channel) {
+    dataColumns[channel] = names.size();
+    columnMap_.emplace_back(names.size(), channel);
+    names.push_back(inputType->nameOf(channel));
+    types.push_back(inputType->childAt(channel));
+  };
+  auto addKeyColumns =
+      [&](const std::vector<std::pair<column_index_t, core::SortOrder>>&
+              keyInfo) {
+        for (const auto& [channel, sortOrder] : keyInfo) {
+          if (dataColumns[channel] == kConstantChannel) {
+            addColumn(channel);
+            keyTypes.push_back(types.back());
+            spillCompareFlags_.push_back(
+                {sortOrder.isNullsFirst(), sortOrder.isAscending(), false});
+          }
+        }
+      };
+  addKeyColumns(partitionKeyInfo_);
+  numPartitionKeyColumns_ = keyTypes.size();
+  addKeyColumns(sortKeyInfo_);
+  for (column_index_t channel = 0; channel < numInputColumns_; ++channel) {
+    if (dataColumns[channel] == kConstantChannel) {
+      addColumn(channel);
+      dependentTypes.push_back(types.back());
+    }
+  }
+  data_ = std::make_unique<RowContainer>(keyTypes, dependentTypes, pool());
+  internalStoreType_ = ROW(std::move(names), std::move(types));
+
+  // The keys are compared on the columns of 'data_'.
+  for (auto* keyInfo : {&partitionKeyInfo_, &sortKeyInfo_, &allKeyInfo_}) {
+    for (auto& key : *keyInfo) {
+      key.first = dataColumns[key.first];
+    }
+  }
+
   std::vector<exec::RowColumn> inputColumns;
   for (int i = 0; i < inputType->children().size(); i++) {
-    inputColumns.push_back(data_->columnAt(i));
+    inputColumns.push_back(data_->columnAt(dataColumns[i]));
   }
   // The WindowPartition is structured over all the input columns data.
   // Individual functions access its input argument column values from it.
@@ -85,6 +133,11 @@ Window::Window(
       std::make_unique<WindowPartition>(inputColumns, inputType->children());
 
   createWindowFunctions(windowNode, inputType);
+
+  if (inputsSorted_) {
+    // The partitions are output while receiving input.
+    createPeerAndFrameBuffers();
+  }
 }
 
 Window::WindowFrame Window::createWindowFrame(
@@ -151,21 +204,172 @@ void Window::createWindowFunctions(
 }
 
 void Window::addInput(RowVectorPtr input) {
+  ensureInputFits(input);
+
   inputRows_.resize(input->size());
 
   for (auto col = 0; col < input->childrenSize(); ++col) {
     decodedInputVectors_[col].decode(*input->childAt(col), inputRows_);
   }
 
+  const vector_size_t firstNewRow = sortedRows_.size();
   // Add all the rows into the RowContainer.
   for (auto row = 0; row < input->size(); ++row) {
     char* newRow = data_->newRow();
 
-    for (auto col = 0; col < input->childrenSize(); ++col) {
-      data_->store(decodedInputVectors_[col], row, newRow, col);
+    for (const auto& columnProjection : columnMap_) {
+      data_->store(
+          decodedInputVectors_[columnProjection.outputChannel],
+          row,
+          newRow,
+          columnProjection.inputChannel);
+    }
+    if (inputsSorted_) {
+      sortedRows_.push_back(newRow);
     }
   }
   numRows_ += inputRows_.size();
+
+  if (inputsSorted_) {
+    computeStreamingPartitionStartRows(firstNewRow);
+  }
+
+  recordSpillStats();
+}
+
+void Window::recordSpillStats() {
+  if (spiller_ == nullptr) {
+    return;
+  }
+  const auto spillStats = spiller_->stats();
+  auto lockedStats = stats_.wlock();
+  lockedStats->spilledBytes = spillStats.spilledBytes;
+  lockedStats->spilledRows = spillStats.spilledRows;
+  lockedStats->spilledPartitions = spillStats.spilledPartitions;
+  lockedStats->spilledFiles = spillStats.spilledFiles;
+  spillStats.setRuntimeStats(lockedStats->runtimeStats);
+}
+
+bool Window::canReclaim() const {
+  // The spilled runs are merged after the input is complete, so spill is only
+  // possible while the input is being received.
+  return spillConfig_.has_value() && !noMoreInput_;
+}
+
+void Window::reclaim(uint64_t /*targetBytes*/) {
+  VELOX_CHECK(canReclaim());
+  if (data_->numRows() == 0) {
+    return;
+  }
+  spill(0, 0);
+  recordSpillStats();
+  pool()->getMemoryUsageTracker()->release();
+}
+
+void Window::ensureInputFits(const RowVectorPtr& input) {
+  // Check if spilling is enabled or not.
+  if (!spillConfig_.has_value()) {
+    return;
+  }
+
+  const int64_t numRows = data_->numRows();
+  if (numRows == 0) {
+    // 'data_' is empty. Nothing to spill.
+    return;
+  }
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  const auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  const int64_t outOfLineBytesPerRow = outOfLineBytes / numRows;
+  const int64_t flatInputBytes = input->estimateFlatSize();
+
+  const auto& spillConfig = spillConfig_.value();
+  // Test-only spill path.
+  if (spillConfig.testSpillPct &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+          spillConfig.testSpillPct) {
+    const int64_t rowsToSpill = std::max<int64_t>(1, numRows / 10);
+    spill(
+        numRows - rowsToSpill,
+        std::max<int64_t>(
+            0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+    return;
+  }
+
+  auto tracker = pool()->getMemoryUsageTracker();
+  VELOX_CHECK_NOT_NULL(tracker);
+  const auto currentUsage = tracker->currentBytes();
+  if (spillMemoryThreshold_ != 0 && currentUsage > spillMemoryThreshold_) {
+    const int64_t bytesToSpill =
+        currentUsage * spillConfig.spillableReservationGrowthPct / 100;
+    auto rowsToSpill = std::max<int64_t>(
+        1, bytesToSpill / (data_->fixedRowSize() + outOfLineBytesPerRow));
+    spill(
+        std::max<int64_t>(0, numRows - rowsToSpill),
+        std::max<int64_t>(
+            0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+    return;
+  }
+
+  if (freeRows > input->size() &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatInputBytes)) {
+    // Enough free rows for input rows and enough variable length free
+    // space for the flat size of the whole vector. If outOfLineBytes
+    // is 0 there is no need for variable length space.
+    return;
+  }
+
+  // If there is variable length data we take the flat size of the input as a
+  // cap on the new variable length data needed.
+  const int64_t incrementBytes =
+      data_->sizeIncrement(input->size(), outOfLineBytes ? flatInputBytes : 0);
+
+  // There must be at least 2x the increment in reservation.
+  if (tracker->availableReservation() > 2 * incrementBytes) {
+    return;
+  }
+
+  // Check if can increase reservation. The increment is the larger of twice the
+  // maximum increment from this input and 'spillableReservationGrowthPct_' of
+  // the current reservation.
+  const auto targetIncrementBytes = std::max<int64_t>(
+      incrementBytes * 2,
+      currentUsage * spillConfig.spillableReservationGrowthPct / 100);
+  if (tracker->maybeReserve(targetIncrementBytes)) {
+    return;
+  }
+  const int64_t rowsToSpill = std::max<int64_t>(
+      1, targetIncrementBytes / (data_->fixedRowSize() + outOfLineBytesPerRow));
+  spill(
+      std::max<int64_t>(0, numRows - rowsToSpill),
+      std::max<int64_t>(
+          0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+}
+
+void Window::spill(int64_t targetRows, int64_t targetBytes) {
+  VELOX_CHECK_GE(targetRows, 0);
+  VELOX_CHECK_GE(targetBytes, 0);
+
+  if (spiller_ == nullptr) {
+    VELOX_DCHECK_NOT_NULL(pool()->getMemoryUsageTracker());
+    const auto& spillConfig = spillConfig_.value();
+    spiller_ = std::make_unique<Spiller>(
+        Spiller::Type::kWindow,
+        data_.get(),
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        internalStoreType_,
+        data_->keyTypes().size(),
+        spillCompareFlags_,
+        spillConfig.filePath,
+        spillConfig.maxFileSize,
+        spillConfig.minSpillRunSize,
+        Spiller::spillPool(),
+        spillConfig.executor,
+        spillConfig.compressionKind,
+        spillConfig.writeCallback);
+    VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
+  }
+  spiller_->spill(targetRows, targetBytes);
 }
 
 inline bool Window::compareRowsWithKeys(
@@ -215,7 +419,7 @@ void Window::createPeerAndFrameBuffers() {
 
 void Window::computePartitionStartRows() {
   // Randomly assuming that max 10000 partitions are in the data.
-  partitionStartRows_.reserve(numRows_);
+  partitionStartRows_.reserve(sortedRows_.size());
   auto partitionCompare = [&](const char* lhs, const char* rhs) -> bool {
     return compareRowsWithKeys(lhs, rhs, partitionKeyInfo_);
   };
@@ -239,6 +443,45 @@ void Window::computePartitionStartRows() {
   partitionStartRows_.push_back(sortedRows_.size());
 }
 
+void Window::computeStreamingPartitionStartRows(vector_size_t firstNewRow) {
+  VELOX_CHECK(partitionStartRows_.empty());
+  auto isSamePartition = [&](const char* lhs, const char* rhs) -> bool {
+    for (const auto& key : partitionKeyInfo_) {
+      if (data_->compare(lhs, rhs, key.first, CompareFlags()) != 0) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // The last partition is incomplete until the first row of the next
+  // partition or the end of input is seen. So its start row is the end of the
+  // rows that can be output.
+  const vector_size_t startRow = std::max<vector_size_t>(1, firstNewRow);
+  for (auto i = startRow; i < sortedRows_.size(); ++i) {
+    if (!isSamePartition(sortedRows_[i - 1], sortedRows_[i])) {
+      if (partitionStartRows_.empty()) {
+        partitionStartRows_.push_back(0);
+      }
+      partitionStartRows_.push_back(i);
+    }
+  }
+  currentPartition_ = 0;
+}
+
+void Window::releaseProcessedPartitions() {
+  const auto numReleasedRows = numOutputReadyRows();
+  VELOX_CHECK_EQ(numProcessedRows_, numReleasedRows);
+  data_->eraseRows(folly::Range(sortedRows_.data(), numReleasedRows));
+  sortedRows_.erase(sortedRows_.begin(), sortedRows_.begin() + numReleasedRows);
+  partitionStartRows_.clear();
+  numProcessedRows_ = 0;
+  currentPartition_ = 0;
+  // The erased rows leave holes in the out of line data of a long running
+  // streaming window. Compact it when it gets sparse.
+  data_->compactStrings();
+}
+
 void Window::sortPartitions() {
   // This is a very inefficient but easy implementation to order the input rows
   // by partition keys + sort keys.
@@ -268,13 +511,142 @@ void Window::noMoreInput() {
     return;
   }
 
+  if (inputsSorted_) {
+    // All the rows after the last partition start are now a complete
+    // partition.
+    if (sortedRows_.empty()) {
+      finished_ = true;
+    } else {
+      if (partitionStartRows_.empty()) {
+        partitionStartRows_.push_back(0);
+      }
+      partitionStartRows_.push_back(sortedRows_.size());
+    }
+    return;
+  }
+
+  createPeerAndFrameBuffers();
+
+  if (spiller_ != nullptr) {
+    // Spill the remaining rows so that 'data_' can be reused for loading the
+    // partitions back from the sorted spill runs.
+    spiller_->spill(0, 0);
+    // There is only one spill partition, so there are no non-spilled rows.
+    VELOX_CHECK(spiller_->finishSpill().empty());
+    spillMerge_ = spiller_->startMerge(0);
+    spillBatch_ = std::static_pointer_cast<RowVector>(
+        BaseVector::create(internalStoreType_, numRowsPerOutput_, pool()));
+    spillSources_.resize(numRowsPerOutput_);
+    spillSourceRows_.resize(numRowsPerOutput_);
+    std::vector<TypePtr> partitionKeyTypes(
+        internalStoreType_->children().begin(),
+        internalStoreType_->children().begin() + numPartitionKeyColumns_);
+    lastPartitionKeys_ = std::static_pointer_cast<RowVector>(BaseVector::create(
+        ROW(std::move(partitionKeyTypes)), 1, pool()));
+    loadSpilledPartitions();
+    return;
+  }
+
   // At this point we have seen all the input rows. We can start
   // outputting rows now.
   // However, some preparation is needed. The rows should be
   // separated into partitions and sort by ORDER BY keys within
   // the partition. This will order the rows for getOutput().
   sortPartitions();
-  createPeerAndFrameBuffers();
+}
+
+bool Window::isNewPartition(const RowVector& source, vector_size_t index)
+    const {
+  for (auto i = 0; i < numPartitionKeyColumns_; ++i) {
+    if (source.childAt(i)
+            ->compare(
+                lastPartitionKeys_->childAt(i).get(), index, 0, CompareFlags())
+            .value() != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Window::addSpilledRows(vector_size_t numRows) {
+  if (numRows == 0) {
+    return;
+  }
+  VectorPtr batch = std::move(spillBatch_);
+  BaseVector::prepareForReuse(batch, numRows);
+  spillBatch_ = std::static_pointer_cast<RowVector>(batch);
+  for (auto& child : spillBatch_->children()) {
+    child->resize(numRows);
+  }
+  gatherCopy(spillBatch_.get(), 0, numRows, spillSources_, spillSourceRows_);
+
+  inputRows_.resize(numRows);
+  for (auto col = 0; col < spillBatch_->childrenSize(); ++col) {
+    decodedInputVectors_[col].decode(*spillBatch_->childAt(col), inputRows_);
+  }
+  for (auto row = 0; row < numRows; ++row) {
+    char* newRow = data_->newRow();
+    for (auto col = 0; col < spillBatch_->childrenSize(); ++col) {
+      data_->store(decodedInputVectors_[col], row, newRow, col);
+    }
+    sortedRows_.push_back(newRow);
+  }
+}
+
+void Window::loadSpilledPartitions() {
+  VELOX_CHECK_NOT_NULL(spillMerge_);
+  data_->clear();
+  sortedRows_.clear();
+  partitionStartRows_.clear();
+  numProcessedRows_ = 0;
+  currentPartition_ = 0;
+
+  vector_size_t numPendingRows = 0;
+  bool capturedPartitionKeys = false;
+  for (;;) {
+    SpillMergeStream* stream = spillMerge_->next();
+    if (stream == nullptr) {
+      break;
+    }
+
+    const auto& source = stream->current();
+    bool isEndOfBatch = false;
+    const auto index = stream->currentIndex(&isEndOfBatch);
+    // Stop at the first row of the next partition once enough rows are
+    // loaded. Such a row stays at the top of 'spillMerge_' for the next load.
+    if (capturedPartitionKeys && isNewPartition(source, index)) {
+      break;
+    }
+
+    spillSources_[numPendingRows] = &source;
+    spillSourceRows_[numPendingRows] = index;
+    ++numPendingRows;
+    if (!capturedPartitionKeys &&
+        sortedRows_.size() + numPendingRows >= numRowsPerOutput_) {
+      for (auto i = 0; i < numPartitionKeyColumns_; ++i) {
+        lastPartitionKeys_->childAt(i)->copy(
+            source.childAt(i).get(), 0, index, 1);
+      }
+      capturedPartitionKeys = true;
+    }
+
+    // The stream is at end of input batch. Need to copy out the rows before
+    // fetching next batch in 'pop'.
+    if (isEndOfBatch || numPendingRows == spillSources_.size()) {
+      addSpilledRows(numPendingRows);
+      numPendingRows = 0;
+    }
+    stream->pop();
+  }
+  addSpilledRows(numPendingRows);
+
+  if (!sortedRows_.empty()) {
+    computePartitionStartRows();
+  }
+}
+
+bool Window::hasSpilledRows() {
+  return spillMerge_ != nullptr && spillMerge_->next() != nullptr;
 }
 
 void Window::callResetPartition(vector_size_t partitionNumber) {
@@ -581,22 +953,33 @@ void Window::callApplyLoop(
 }
 
 RowVectorPtr Window::getOutput() {
-  if (finished_ || !noMoreInput_) {
+  if (finished_ || (!noMoreInput_ && !inputsSorted_)) {
     return nullptr;
   }
 
-  auto numRowsLeft = numRows_ - numProcessedRows_;
+  if (spillMerge_ != nullptr && numProcessedRows_ == sortedRows_.size()) {
+    // All the loaded partitions have been output. The remaining rows are in
+    // the spilled data.
+    loadSpilledPartitions();
+  }
+
+  const vector_size_t numRowsLeft = numOutputReadyRows() - numProcessedRows_;
+  if (numRowsLeft == 0) {
+    // No complete partitions to output yet.
+    VELOX_CHECK(inputsSorted_);
+    return nullptr;
+  }
   auto numOutputRows = std::min(numRowsPerOutput_, numRowsLeft);
   auto result = std::dynamic_pointer_cast<RowVector>(
       BaseVector::create(outputType_, numOutputRows, operatorCtx_->pool()));
 
   // Set all passthrough input columns.
-  for (int i = 0; i < numInputColumns_; ++i) {
+  for (const auto& columnProjection : columnMap_) {
     data_->extractColumn(
         sortedRows_.data() + numProcessedRows_,
         numOutputRows,
-        i,
-        result->childAt(i));
+        columnProjection.inputChannel,
+        result->childAt(columnProjection.outputChannel));
   }
 
   // Construct vectors for the window function output columns.
@@ -615,7 +998,18 @@ RowVectorPtr Window::getOutput() {
     result->childAt(j) = windowOutputs[j - numInputColumns_];
   }
 
-  finished_ = (numProcessedRows_ == sortedRows_.size());
+  if (inputsSorted_) {
+    if (numProcessedRows_ == numOutputReadyRows()) {
+      if (noMoreInput_) {
+        finished_ = true;
+      } else {
+        releaseProcessedPartitions();
+      }
+    }
+    return result;
+  }
+
+  finished_ = (numProcessedRows_ == sortedRows_.size()) && !hasSpilledRows();
   return result;
 }
 
@@ -17,6 +17,7 @@
 
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
 #include "velox/exec/WindowFunction.h"
 #include "velox/exec/WindowPartition.h"
 
@@ -34,6 +35,18 @@ namespace facebook::velox::exec {
 ///
 /// We will revise this algorithm in the future using a HashTable based
 /// approach pending some profiling results.
+///
+/// If spilling is enabled and the window has partition keys, the input rows
+/// are spilled in runs sorted by (partition_by keys + order_by keys) when
+/// memory runs short. After all input has been received, the sorted runs are
+/// merged and the rows are loaded back one batch of complete partitions at a
+/// time. The memory used is then bounded by the largest partition instead of
+/// the whole input.
+///
+/// If the input is already sorted by (partition_by keys + order_by keys), the
+/// operator doesn't sort. It outputs each partition as soon as the first row
+/// of the next partition is received, and releases the rows of the output
+/// partitions. The memory used is then bounded by the largest partition.
 class Window : public Operator {
  public:
   Window(
@@ -46,7 +59,10 @@ class Window : public Operator {
   RowVectorPtr getOutput() override;
 
   bool needsInput() const override {
-    return !noMoreInput_;
+    // Over sorted input, the complete partitions are output before accepting
+    // more input.
+    return !noMoreInput_ &&
+        (!inputsSorted_ || numProcessedRows_ == numOutputReadyRows());
   }
 
   void noMoreInput() override;
@@ -59,6 +75,10 @@ class Window : public Operator {
     return finished_;
   }
 
+  bool canReclaim() const override;
+
+  void reclaim(uint64_t targetBytes) override;
+
  private:
   // Used for k preceding/following frames. Index is the column index if k is a
   // column. value is used to read column values from the column index when k
@@ -106,6 +126,52 @@ class Window : public Operator {
   // ORDER BY clause.
   void sortPartitions();
 
+  // Used over sorted input after new rows were appended to 'sortedRows_'
+  // starting at 'firstNewRow'. All the rows before 'firstNewRow' belong to a
+  // single partition. Computes 'partitionStartRows_' for the partitions that
+  // are complete, i.e. all but the last one.
+  void computeStreamingPartitionStartRows(vector_size_t firstNewRow);
+
+  // Used over sorted input after all the complete partitions have been
+  // output. Erases their rows from 'data_' and keeps only the rows of the
+  // last, incomplete, partition in 'sortedRows_'.
+  void releaseProcessedPartitions();
+
+  // Returns the number of rows in 'sortedRows_' that belong to complete
+  // partitions and can be output.
+  vector_size_t numOutputReadyRows() const {
+    return partitionStartRows_.empty() ? 0 : partitionStartRows_.back();
+  }
+
+  // Checks if 'input' will fit in the existing memory and increases the
+  // reservation if not. If the reservation cannot be increased, spills enough
+  // to make 'input' fit.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Spills content until under 'targetRows' and under 'targetBytes' of out of
+  // line data are left. If 'targetRows' is 0, spills everything.
+  void spill(int64_t targetRows, int64_t targetBytes);
+
+  // Updates the operator stats with the spiller stats.
+  void recordSpillStats();
+
+  // Clears 'data_' and loads the next rows from 'spillMerge_' into it. Loads
+  // complete partitions until at least 'numRowsPerOutput_' rows are loaded or
+  // the spilled data is exhausted. The loaded rows are already sorted, so
+  // this only needs to compute 'partitionStartRows_' for them.
+  void loadSpilledPartitions();
+
+  // Copies the pending 'spillSources_' rows into 'data_' and appends them to
+  // 'sortedRows_'.
+  void addSpilledRows(vector_size_t numRows);
+
+  // Returns true if the partition keys of 'index' in 'source' differ from
+  // 'lastPartitionKeys_'.
+  bool isNewPartition(const RowVector& source, vector_size_t index) const;
+
+  // Returns true if there are spilled rows that have not been loaded yet.
+  bool hasSpilledRows();
+
   // Helper function to call WindowFunction::resetPartition() for
   // all WindowFunctions.
   void callResetPartition(vector_size_t partitionNumber);
@@ -162,11 +228,61 @@ class Window : public Operator {
   const vector_size_t outputBatchSizeInBytes_;
   const vector_size_t numInputColumns_;
 
+  // True if the input is sorted by (partition_by keys + order_by keys) and
+  // the partitions are output as they are completed.
+  const bool inputsSorted_;
+
+  // The maximum memory usage that a window can hold before spilling. If it is
+  // zero, then there is no such limit.
+  const uint64_t spillMemoryThreshold_;
+
+  // The disk spilling related configs if spilling is enabled, otherwise null.
+  const std::optional<Spiller::Config> spillConfig_;
+
   // The Window operator needs to see all the input rows before starting
   // any function computation. As the Window operators gets input rows
-  // we store the rows in the RowContainer (data_).
+  // we store the rows in the RowContainer (data_). The distinct partition
+  // and sort key columns are stored first as the keys of 'data_', followed by
+  // the other input columns as dependents.
   std::unique_ptr<RowContainer> data_;
 
+  // The map from the input column channel to the corresponding column in
+  // 'data_'.
+  std::vector<IdentityProjection> columnMap_;
+
+  // The row type used to store input data in 'data_' and for spilling.
+  RowTypePtr internalStoreType_;
+
+  // The number of distinct partition key columns. These are the first
+  // columns of 'data_'.
+  column_index_t numPartitionKeyColumns_{0};
+
+  // Compare flags for the key columns of 'data_' used for spilling.
+  std::vector<CompareFlags> spillCompareFlags_;
+
+  std::unique_ptr<Spiller> spiller_;
+
+  // Counts input batches and triggers spilling if folly hash of this % 100 <=
+  // 'testSpillPct'.
+  uint64_t spillTestCounter_{0};
+
+  // Set to read back spilled data if disk spilling has been triggered.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerge_;
+
+  // The source rows to copy to 'spillBatch_' in order when loading spilled
+  // partitions.
+  std::vector<const RowVector*> spillSources_;
+  std::vector<vector_size_t> spillSourceRows_;
+
+  // Reusable vector to copy the spilled rows into before storing them in
+  // 'data_'.
+  RowVectorPtr spillBatch_;
+
+  // Partition keys of the row that completed the batch of spilled rows
+  // being loaded. The following rows are loaded until a row with different
+  // partition keys is seen.
+  RowVectorPtr lastPartitionKeys_;
+
   // The decodedInputVectors_ are reused across addInput() calls to decode
   // the partition and sort keys for the above RowContainer.
   std::vector<DecodedVector> decodedInputVectors_;
@@ -204,7 +320,10 @@ class Window : public Operator {
   // Vector of pointers to each input row in the data_ RowContainer.
   // The rows are sorted by partitionKeys + sortKeys. This total
   // ordering can be used to split partitions (with the correct
-  // order by) for the processing.
+  // order by) for the processing. If the input was spilled, these are
+  // the rows of the partitions currently loaded from the spilled data. If
+  // the input is sorted, these are the rows stored in arrival order that
+  // have not been released yet.
   std::vector<char*> sortedRows_;
 
   // Window partition object used to provide per-partition
@@ -244,8 +363,8 @@ class Window : public Operator {
   // There is one SelectivityVector per window function.
   std::vector<SelectivityVector> validFrames_;
 
-  // Number of rows output from the WindowOperator so far. The rows
-  // are output in the same order of the pointers in sortedRows. This
+  // Number of rows of 'sortedRows_' output from the WindowOperator so far.
+  // The rows are output in the same order of the pointers in sortedRows. This
   // value is updated as the WindowFunction::apply() function is
   // called on the partition blocks.
   vector_size_t numProcessedRows_ = 0;
@@ -0,0 +1,381 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/String.h>
+#include <folly/init/Init.h>
+#include <folly/json.h>
+#include <gflags/gflags.h>
+
+#include <fstream>
+#include <random>
+
+#include "velox/common/time/Timer.h"
+#include "velox/exec/Exchange.h"
+#include "velox/exec/tests/utils/Cursor.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/QueryAssertions.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+#include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+#include "velox/functions/prestosql/window/WindowFunctionsRegistration.h"
+#include "velox/parse/TypeResolver.h"
+#include "velox/serializers/PrestoSerializer.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+DEFINE_string(
+    workloads,
+    "",
+    "Comma separated workloads to run, all if empty. One of hashJoin, "
+    "hashAggregation, orderBy, topN, window, orderBySpill and "
+    "partitionedOutput");
+DEFINE_int32(num_rows, 1'000'000, "Number of input rows");
+DEFINE_int32(batch_size, 10'000, "Number of rows in an input vector");
+DEFINE_int32(cardinality, 10'000, "Number of distinct keys");
+DEFINE_double(
+    skew,
+    0,
+    "Fraction of the rows, 0 to 1, that have the same key. The other rows "
+    "have uniformly distributed keys");
+DEFINE_string(
+    key_type,
+    "BIGINT",
+    "Type of the key: INTEGER, BIGINT or VARCHAR");
+DEFINE_int32(
+    num_payload_columns,
+    2,
+    "Number of non-key columns, alternating BIGINT, DOUBLE and VARCHAR");
+DEFINE_int32(num_partitions, 16, "Number of partitions of partitionedOutput");
+DEFINE_int64(
+    spill_threshold_bytes,
+    16 << 20,
+    "Memory an OrderBy uses before spilling in orderBySpill");
+DEFINE_int32(
+    repeats,
+    3,
+    "Number of runs of each workload. The fastest is reported");
+DEFINE_string(
+    json_output,
+    "",
+    "File to write the results to as JSON. Written to stdout if empty");
+
+/// Runs the operators that have no benchmark of their own on generated input
+/// and reports wall time, throughput, CPU time and peak memory as JSON, so
+/// that the results of different builds can be compared. The input has a key
+/// column, k0, of --key_type with --cardinality distinct values and payload
+/// columns c0, c1, ... from VectorFuzzer. Each workload runs in a single
+/// thread.
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+using namespace facebook::velox::test;
+
+namespace {
+
+struct RunResult {
+  uint64_t wallNanos{0};
+  std::vector<std::shared_ptr<Task>> tasks;
+};
+
+class OperatorBenchmark : public VectorTestBase {
+ public:
+  OperatorBenchmark() {
+    VELOX_USER_CHECK_GE(FLAGS_num_payload_columns, 1);
+    VELOX_USER_CHECK_GT(FLAGS_cardinality, 0);
+    VELOX_USER_CHECK_GE(FLAGS_repeats, 1);
+    input_ = makeInput();
+    build_ = makeBuild();
+  }
+
+  // Returns the names of all workloads in the order they run.
+  static std::vector<std::string> workloadNames() {
+    return {
+        "hashJoin",
+        "hashAggregation",
+        "orderBy",
+        "topN",
+        "window",
+        "orderBySpill",
+        "partitionedOutput"};
+  }
+
+  // Runs 'workload' --repeats times and returns the stats of the fastest run.
+  folly::dynamic run(const std::string& workload) {
+    std::optional<RunResult> fastest;
+    for (auto i = 0; i < FLAGS_repeats; ++i) {
+      auto result = runOnce(workload);
+      if (!fastest.has_value() || result.wallNanos < fastest->wallNanos) {
+        fastest = std::move(result);
+      }
+    }
+    return toJson(workload, *fastest);
+  }
+
+ private:
+  VectorPtr makeKeys(vector_size_t size, std::function<int64_t(int32_t)> key) {
+    switch (mapNameToTypeKind(FLAGS_key_type)) {
+      case TypeKind::INTEGER:
+        return makeFlatVector<int32_t>(size, key);
+      case TypeKind::BIGINT:
+        return makeFlatVector<int64_t>(size, key);
+      case TypeKind::VARCHAR:
+        return makeFlatVector<std::string>(size, [&](auto row) {
+          return fmt::format("key-longer-than-inline-{}", key(row));
+        });
+      default:
+        VELOX_USER_FAIL("Unsupported key type: {}", FLAGS_key_type);
+    }
+  }
+
+  std::vector<RowVectorPtr> makeInput() {
+    VectorFuzzer::Options options;
+    options.vectorSize = FLAGS_batch_size;
+    options.stringLength = 20;
+    VectorFuzzer fuzzer(options, pool_.get());
+    const std::vector<TypePtr> payloadTypes = {BIGINT(), DOUBLE(), VARCHAR()};
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<> skewed(0, 1);
+    std::uniform_int_distribution<int32_t> uniform(0, FLAGS_cardinality - 1);
+
+    std::vector<RowVectorPtr> vectors;
+    for (auto start = 0; start < FLAGS_num_rows; start += FLAGS_batch_size) {
+      const auto size = std::min(FLAGS_batch_size, FLAGS_num_rows - start);
+      std::vector<std::string> names = {"k0"};
+      std::vector<VectorPtr> columns = {makeKeys(size, [&](auto /*row*/) {
+        return skewed(rng) < FLAGS_skew ? 0 : uniform(rng);
+      })};
+      for (auto i = 0; i < FLAGS_num_payload_columns; ++i) {
+        names.push_back(fmt::format("c{}", i));
+        columns.push_back(fuzzer.fuzzFlatNotNull(
+            payloadTypes[i % payloadTypes.size()], size));
+      }
+      vectors.push_back(makeRowVector(names, columns));
+    }
+    return vectors;
+  }
+
+  // Makes the build side of hashJoin with one row for each key.
+  RowVectorPtr makeBuild() {
+    return makeRowVector(
+        {"b_k0", "b_c0"},
+        {makeKeys(FLAGS_cardinality, [](auto row) { return row; }),
+         makeFlatVector<int64_t>(FLAGS_cardinality, [](auto row) {
+           return row * 3;
+         })});
+  }
+
+  std::shared_ptr<core::QueryCtx> makeQueryCtx(
+      std::unordered_map<std::string, std::string> config = {}) {
+    return std::make_shared<core::QueryCtx>(
+        executor_.get(), std::make_shared<core::MemConfig>(std::move(config)));
+  }
+
+  RunResult runOnce(const std::string& workload) {
+    if (workload == "partitionedOutput") {
+      return runPartitionedOutput();
+    }
+    CursorParameters params;
+    params.queryCtx = makeQueryCtx();
+    std::shared_ptr<TempDirectoryPath> spillDirectory;
+    if (workload == "hashJoin") {
+      auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+      params.planNode =
+          PlanBuilder(planNodeIdGenerator)
+              .values(input_)
+              .hashJoin(
+                  {"k0"},
+                  {"b_k0"},
+                  PlanBuilder(planNodeIdGenerator).values({build_}).planNode(),
+                  "",
+                  {"c0", "b_c0"})
+              .planNode();
+    } else if (workload == "hashAggregation") {
+      params.planNode = PlanBuilder()
+                            .values(input_)
+                            .singleAggregation({"k0"}, {"sum(c0)", "count(1)"})
+                            .planNode();
+    } else if (workload == "orderBy" || workload == "orderBySpill") {
+      params.planNode =
+          PlanBuilder().values(input_).orderBy({"k0", "c0"}, false).planNode();
+      if (workload == "orderBySpill") {
+        spillDirectory = TempDirectoryPath::create();
+        params.spillDirectory = spillDirectory->path;
+        params.queryCtx = makeQueryCtx(
+            {{core::QueryConfig::kSpillEnabled, "true"},
+             {core::QueryConfig::kOrderBySpillEnabled, "true"},
+             {core::QueryConfig::kOrderBySpillMemoryThreshold,
+              std::to_string(FLAGS_spill_threshold_bytes)}});
+      }
+    } else if (workload == "topN") {
+      params.planNode = PlanBuilder()
+                            .values(input_)
+                            .topN({"k0", "c0"}, 100, false)
+                            .planNode();
+    } else if (workload == "window") {
+      params.planNode =
+          PlanBuilder()
+              .values(input_)
+              .window({"row_number() over (partition by k0 order by c0) as rn"})
+              .planNode();
+    } else {
+      VELOX_USER_FAIL("Unknown workload: {}", workload);
+    }
+
+    const auto startMicros = getCurrentTimeMicro();
+    auto cursor = std::make_unique<TaskCursor>(params);
+    while (cursor->moveNext()) {
+    }
+    auto task = cursor->task();
+    VELOX_CHECK(waitForTaskCompletion(task.get(), 10'000'000));
+    return {(getCurrentTimeMicro() - startMicros) * 1'000, {task}};
+  }
+
+  // Partitions the input in a producer Task and reads each partition with an
+  // Exchange in a consumer Task that counts the rows.
+  RunResult runPartitionedOutput() {
+    static std::atomic<int32_t> serial{0};
+    const auto id = ++serial;
+    auto producerPlan = PlanBuilder()
+                            .values(input_)
+                            .partitionedOutput({"k0"}, FLAGS_num_partitions)
+                            .planNode();
+    auto consumerPlan = PlanBuilder()
+                            .exchange(producerPlan->outputType())
+                            .singleAggregation({}, {"count(1)"})
+                            .planNode();
+
+    const auto startMicros = getCurrentTimeMicro();
+    RunResult result;
+    const auto producerId = fmt::format("local://producer-{}", id);
+    auto producer = std::make_shared<Task>(
+        producerId, core::PlanFragment{producerPlan}, 0, makeQueryCtx());
+    Task::start(producer, 1);
+    result.tasks.push_back(producer);
+    for (auto i = 0; i < FLAGS_num_partitions; ++i) {
+      auto consumer = std::make_shared<Task>(
+          fmt::format("local://consumer-{}-{}", id, i),
+          core::PlanFragment{consumerPlan},
+          i,
+          makeQueryCtx(),
+          Consumer([](RowVectorPtr /*vector*/, ContinueFuture* /*future*/) {
+            return BlockingReason::kNotBlocked;
+          }));
+      Task::start(consumer, 1);
+      consumer->addSplit(
+          "0", Split(std::make_shared<RemoteConnectorSplit>(producerId)));
+      consumer->noMoreSplits("0");
+      result.tasks.push_back(consumer);
+    }
+    for (auto& task : result.tasks) {
+      VELOX_CHECK(waitForTaskCompletion(task.get(), 10'000'000));
+    }
+    result.wallNanos = (getCurrentTimeMicro() - startMicros) * 1'000;
+    return result;
+  }
+
+  folly::dynamic toJson(const std::string& workload, const RunResult& result) {
+    // Operator stats added up by operator type, in the order of first
+    // appearance.
+    std::vector<std::string> operatorTypes;
+    std::unordered_map<std::string, OperatorStats> operatorStats;
+    int64_t peakMemoryBytes = 0;
+    for (const auto& task : result.tasks) {
+      peakMemoryBytes += task->pool()->getMaxBytes();
+      for (const auto& pipeline : task->taskStats().pipelineStats) {
+        for (const auto& op : pipeline.operatorStats) {
+          auto it = operatorStats.find(op.operatorType);
+          if (it == operatorStats.end()) {
+            operatorTypes.push_back(op.operatorType);
+            operatorStats.emplace(op.operatorType, op);
+          } else {
+            it->second.add(op);
+          }
+        }
+      }
+    }
+
+    uint64_t totalCpuNanos = 0;
+    uint64_t spilledBytes = 0;
+    folly::dynamic operators = folly::dynamic::array;
+    for (const auto& type : operatorTypes) {
+      const auto& stats = operatorStats.at(type);
+      CpuWallTiming timing;
+      timing.add(stats.addInputTiming);
+      timing.add(stats.getOutputTiming);
+      timing.add(stats.finishTiming);
+      totalCpuNanos += timing.cpuNanos;
+      spilledBytes += stats.spilledBytes;
+      operators.push_back(folly::dynamic::object("operatorType", type)(
+          "cpuNanos", timing.cpuNanos)("wallNanos", timing.wallNanos)(
+          "peakMemoryBytes", stats.memoryStats.peakTotalMemoryReservation)(
+          "spilledBytes", stats.spilledBytes));
+    }
+
+    return folly::dynamic::object("workload", workload)(
+        "wallNanos", result.wallNanos)("cpuNanos", totalCpuNanos)(
+        "rowsPerSecond", FLAGS_num_rows * 1.0e9 / result.wallNanos)(
+        "peakMemoryBytes", peakMemoryBytes)("spilledBytes", spilledBytes)(
+        "operators", std::move(operators));
+  }
+
+  std::vector<RowVectorPtr> input_;
+  RowVectorPtr build_;
+};
+
+folly::dynamic parameters() {
+  return folly::dynamic::object("numRows", FLAGS_num_rows)(
+      "batchSize", FLAGS_batch_size)("cardinality", FLAGS_cardinality)(
+      "skew", FLAGS_skew)("keyType", FLAGS_key_type)(
+      "numPayloadColumns", FLAGS_num_payload_columns)(
+      "numPartitions", FLAGS_num_partitions)(
+      "spillThresholdBytes", FLAGS_spill_threshold_bytes)(
+      "repeats", FLAGS_repeats);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  functions::prestosql::registerAllScalarFunctions();
+  aggregate::prestosql::registerAllAggregateFunctions();
+  window::prestosql::registerAllWindowFunctions();
+  parse::registerTypeResolver();
+  serializer::presto::PrestoVectorSerde::registerVectorSerde();
+  exec::ExchangeSource::registerFactory();
+
+  std::vector<std::string> workloads;
+  if (FLAGS_workloads.empty()) {
+    workloads = OperatorBenchmark::workloadNames();
+  } else {
+    folly::split(',', FLAGS_workloads, workloads);
+  }
+
+  OperatorBenchmark benchmark;
+  folly::dynamic results = folly::dynamic::array;
+  for (const auto& workload : workloads) {
+    results.push_back(benchmark.run(workload));
+  }
+  const auto json = folly::toPrettyJson(folly::dynamic::object(
+      "parameters", parameters())("results", std::move(results)));
+  if (FLAGS_json_output.empty()) {
+    std::cout << json << std::endl;
+  } else {
+    std::ofstream out(FLAGS_json_output);
+    out << json << std::endl;
+  }
+  return 0;
+}
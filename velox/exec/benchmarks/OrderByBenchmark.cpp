@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include <gflags/gflags.h>
+
+#include "velox/exec/RadixSort.h"
+#include "velox/exec/RowContainer.h"
+#include "velox/exec/SortKeyPrefix.h"
+#include "velox/vector/tests/utils/VectorMaker.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::test;
+
+namespace {
+// Compares sorting the rows of a RowContainer with a comparator on the keys to
+// radix sorting them on their sort key prefixes, which is what OrderBy does
+// for fixed width leading keys.
+class SortBenchmark {
+ public:
+  SortBenchmark(const RowVectorPtr& data, std::vector<CompareFlags> flags)
+      : flags_(std::move(flags)) {
+    std::vector<TypePtr> keyTypes;
+    std::vector<column_index_t> channels;
+    for (auto i = 0; i < data->childrenSize(); ++i) {
+      keyTypes.push_back(data->childAt(i)->type());
+      channels.push_back(i);
+    }
+    container_ = std::make_unique<RowContainer>(
+        keyTypes, std::vector<TypePtr>{}, true, pool_.get());
+    SortKeyPrefix prefix(keyTypes, channels, flags_);
+    isComplete_ = prefix.isComplete();
+
+    SelectivityVector allRows(data->size());
+    rows_.resize(data->size());
+    for (auto i = 0; i < data->size(); ++i) {
+      rows_[i] = container_->newRow();
+    }
+    for (auto column = 0; column < data->childrenSize(); ++column) {
+      DecodedVector decoded(*data->childAt(column), allRows);
+      for (auto i = 0; i < data->size(); ++i) {
+        container_->store(decoded, i, rows_[i], column);
+      }
+    }
+    for (auto* row : rows_) {
+      RowContainer::normalizedKey(row) = prefix.encode(*container_, row);
+    }
+  }
+
+  void comparatorSort() {
+    folly::BenchmarkSuspender suspender;
+    auto rows = rows_;
+    suspender.dismiss();
+
+    std::sort(rows.begin(), rows.end(), [&](char* left, char* right) {
+      return lessThan(left, right);
+    });
+    folly::doNotOptimizeAway(rows);
+  }
+
+  void radixSort() {
+    folly::BenchmarkSuspender suspender;
+    auto rows = rows_;
+    suspender.dismiss();
+
+    std::vector<RadixSortEntry> entries(rows.size());
+    for (auto i = 0; i < rows.size(); ++i) {
+      entries[i] = {RowContainer::normalizedKey(rows[i]), rows[i]};
+    }
+    std::vector<RadixSortEntry> scratch;
+    exec::radixSort(entries, scratch);
+    for (auto i = 0; i < entries.size(); ++i) {
+      rows[i] = entries[i].row;
+    }
+    if (!isComplete_) {
+      for (size_t begin = 0; begin < entries.size();) {
+        auto end = begin + 1;
+        while (end < entries.size() &&
+               entries[end].key == entries[begin].key) {
+          ++end;
+        }
+        if (end - begin > 1) {
+          std::sort(
+              rows.begin() + begin,
+              rows.begin() + end,
+              [&](char* left, char* right) { return lessThan(left, right); });
+        }
+        begin = end;
+      }
+    }
+    folly::doNotOptimizeAway(rows);
+  }
+
+ private:
+  bool lessThan(const char* left, const char* right) const {
+    for (auto i = 0; i < flags_.size(); ++i) {
+      if (auto result = container_->compare(left, right, i, flags_[i])) {
+        return result < 0;
+      }
+    }
+    return false;
+  }
+
+  const std::vector<CompareFlags> flags_;
+  std::shared_ptr<memory::MemoryPool> pool_{memory::getDefaultMemoryPool()};
+  std::unique_ptr<RowContainer> container_;
+  std::vector<char*> rows_;
+  bool isComplete_;
+};
+
+constexpr vector_size_t kNumRows = 1'000'000;
+
+std::unique_ptr<SortBenchmark> bigintKey;
+std::unique_ptr<SortBenchmark> doubleKey;
+std::unique_ptr<SortBenchmark> dateAndIntegerKeys;
+std::unique_ptr<SortBenchmark> decimalAndBigintKeys;
+
+void makeBenchmarks() {
+  auto pool = memory::getDefaultMemoryPool();
+  VectorMaker maker(pool.get());
+  const CompareFlags asc{true, true, false, false};
+  const CompareFlags desc{false, false, false, false};
+
+  bigintKey = std::make_unique<SortBenchmark>(
+      maker.rowVector({maker.flatVector<int64_t>(
+          kNumRows,
+          [](auto row) { return folly::hasher<int64_t>()(row); },
+          VectorMaker::nullEvery(17))}),
+      std::vector<CompareFlags>{asc});
+
+  doubleKey = std::make_unique<SortBenchmark>(
+      maker.rowVector({maker.flatVector<double>(
+          kNumRows,
+          [](auto row) {
+            return (folly::hasher<int64_t>()(row) % 1'000'000) * 0.01 - 5'000;
+          })}),
+      std::vector<CompareFlags>{desc});
+
+  dateAndIntegerKeys = std::make_unique<SortBenchmark>(
+      maker.rowVector(
+          {maker.flatVector<Date>(
+               kNumRows,
+               [](auto row) {
+                 return Date(folly::hasher<int64_t>()(row) % 3'650);
+               }),
+           maker.flatVector<int32_t>(
+               kNumRows,
+               [](auto row) { return folly::hasher<int32_t>()(row); })}),
+      std::vector<CompareFlags>{asc, desc});
+
+  decimalAndBigintKeys = std::make_unique<SortBenchmark>(
+      maker.rowVector(
+          {maker.flatVector<UnscaledShortDecimal>(
+               kNumRows,
+               [](auto row) {
+                 return UnscaledShortDecimal(
+                     folly::hasher<int64_t>()(row) % 100'000);
+               },
+               nullptr,
+               SHORT_DECIMAL(10, 2)),
+           maker.flatVector<int64_t>(
+               kNumRows, [](auto row) { return row; })}),
+      std::vector<CompareFlags>{asc, asc});
+}
+
+BENCHMARK(bigintComparator) {
+  bigintKey->comparatorSort();
+}
+
+BENCHMARK_RELATIVE(bigintRadix) {
+  bigintKey->radixSort();
+}
+
+BENCHMARK(doubleComparator) {
+  doubleKey->comparatorSort();
+}
+
+BENCHMARK_RELATIVE(doubleRadix) {
+  doubleKey->radixSort();
+}
+
+BENCHMARK(dateAndIntegerComparator) {
+  dateAndIntegerKeys->comparatorSort();
+}
+
+BENCHMARK_RELATIVE(dateAndIntegerRadix) {
+  dateAndIntegerKeys->radixSort();
+}
+
+BENCHMARK(decimalAndBigintComparator) {
+  decimalAndBigintKeys->comparatorSort();
+}
+
+BENCHMARK_RELATIVE(decimalAndBigintRadix) {
+  decimalAndBigintKeys->radixSort();
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  makeBenchmarks();
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/String.h>
+#include <folly/init/Init.h>
+
+#include "velox/dwio/common/tests/utils/BatchMaker.h"
+#include "velox/exec/Exchange.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/QueryAssertions.h"
+#include "velox/serializers/PrestoSerializer.h"
+#include "velox/serializers/UnsafeRowSerializer.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+DEFINE_string(
+    serde,
+    "presto",
+    "Serde of the shuffled pages: presto or unsafe_row. The serde is global "
+    "to the process, so compare the two in separate runs");
+DEFINE_string(
+    partitions,
+    "1,16,256,1024,4096",
+    "Comma separated numbers of partitions to shuffle to");
+DEFINE_int32(num_batches, 10, "Number of input batches of the producer");
+DEFINE_int32(batch_size, 10'000, "Number of rows in each input batch");
+
+/// Benchmarks a shuffle of one producer task to as many consumer tasks as
+/// there are partitions. The producer partitions its input with a
+/// PartitionedOutput, either on a hash of the first column or round-robin, and
+/// the consumers read their partition with an Exchange. Each case runs for flat
+/// and for dictionary encoded input. After the timed runs, prints the
+/// serialized bytes per second and the CPU time per row of the
+/// PartitionedOutput, which partitions and serializes, and of the Exchanges,
+/// which deserialize.
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::test;
+
+namespace {
+
+struct Counters {
+  int64_t bytes{0};
+  int64_t rows{0};
+  int64_t usec{0};
+  // The CPU time of the PartitionedOutput and of all the Exchanges.
+  int64_t producerCpuNanos{0};
+  int64_t consumerCpuNanos{0};
+
+  std::string toString() const {
+    return fmt::format(
+        "{:.1f} MB/s, producer {:.1f} ns/row, consumer {:.1f} ns/row",
+        (bytes / (1024 * 1024.0)) / (usec / 1.0e6),
+        producerCpuNanos / static_cast<double>(rows),
+        consumerCpuNanos / static_cast<double>(rows));
+  }
+};
+
+struct ShuffleCase {
+  std::string name;
+  int32_t numPartitions;
+  bool roundRobin;
+  bool dictionary;
+  Counters counters;
+};
+
+class ShuffleBenchmark : public VectorTestBase {
+ public:
+  void makeData(const RowTypePtr& type) {
+    for (auto i = 0; i < FLAGS_num_batches; ++i) {
+      auto vector = std::dynamic_pointer_cast<RowVector>(
+          BatchMaker::createBatch(type, FLAGS_batch_size, *pool_));
+      flat_.push_back(vector);
+      // Wraps the columns in dictionaries that reverse the rows.
+      auto indices = makeIndicesInReverse(vector->size());
+      std::vector<VectorPtr> children;
+      for (const auto& child : vector->children()) {
+        children.push_back(BaseVector::wrapInDictionary(
+            nullptr, indices, vector->size(), child));
+      }
+      dictionary_.push_back(makeRowVector(type->names(), children));
+    }
+  }
+
+  void run(ShuffleCase& shuffleCase) {
+    auto& vectors = shuffleCase.dictionary ? dictionary_ : flat_;
+    const auto numPartitions = shuffleCase.numPartitions;
+    PlanBuilder builder;
+    builder.values(vectors);
+    if (numPartitions == 1) {
+      builder.partitionedOutput({}, 1);
+    } else if (shuffleCase.roundRobin) {
+      builder.partitionedOutputRoundRobin(numPartitions);
+    } else {
+      builder.partitionedOutput({"c0"}, numPartitions);
+    }
+    auto producerPlan = builder.planNode();
+    auto consumerPlan =
+        PlanBuilder().exchange(producerPlan->outputType()).planNode();
+
+    const auto prefix = fmt::format("{}-{}", shuffleCase.name, runCounter_++);
+    const auto producerTaskId = makeTaskId(prefix + "-producer", 0);
+    std::atomic<int64_t> numRows{0};
+
+    const auto startMicros = getCurrentTimeMicro();
+    std::vector<std::shared_ptr<Task>> tasks;
+    tasks.push_back(makeTask(producerTaskId, producerPlan, 0));
+    Task::start(tasks.back(), 1);
+    for (auto i = 0; i < numPartitions; ++i) {
+      tasks.push_back(makeTask(
+          makeTaskId(prefix + "-consumer", i),
+          consumerPlan,
+          i,
+          [&numRows](RowVectorPtr vector, ContinueFuture* /*future*/) {
+            if (vector != nullptr) {
+              numRows += vector->size();
+            }
+            return BlockingReason::kNotBlocked;
+          }));
+      Task::start(tasks.back(), 1);
+      tasks.back()->addSplit(
+          "0",
+          exec::Split(
+              std::make_shared<RemoteConnectorSplit>(producerTaskId), -1));
+      tasks.back()->noMoreSplits("0");
+    }
+    for (auto& task : tasks) {
+      VELOX_CHECK(waitForTaskCompletion(task.get(), 600'000'000));
+    }
+    const auto elapsed = getCurrentTimeMicro() - startMicros;
+    VELOX_CHECK_EQ(numRows.load(), FLAGS_num_batches * FLAGS_batch_size);
+
+    auto& counters = shuffleCase.counters;
+    for (auto& task : tasks) {
+      auto stats = task->taskStats();
+      for (auto& pipeline : stats.pipelineStats) {
+        for (auto& op : pipeline.operatorStats) {
+          const auto cpuNanos = op.addInputTiming.cpuNanos +
+              op.getOutputTiming.cpuNanos + op.finishTiming.cpuNanos;
+          if (op.operatorType == "PartitionedOutput") {
+            counters.producerCpuNanos += cpuNanos;
+          } else if (op.operatorType == "Exchange") {
+            counters.consumerCpuNanos += cpuNanos;
+            counters.bytes += op.rawInputBytes;
+          }
+        }
+      }
+    }
+    counters.rows += numRows;
+    counters.usec += elapsed;
+  }
+
+ private:
+  static constexpr int64_t kMaxMemory = 6UL << 30; // 6GB
+
+  static std::string makeTaskId(const std::string& prefix, int num) {
+    return fmt::format("local://{}-{}", prefix, num);
+  }
+
+  std::shared_ptr<Task> makeTask(
+      const std::string& taskId,
+      std::shared_ptr<const core::PlanNode> planNode,
+      int destination,
+      Consumer consumer = nullptr) {
+    auto queryCtx = std::make_shared<core::QueryCtx>(
+        executor_.get(), std::make_shared<core::MemConfig>(configSettings_));
+    queryCtx->testingOverrideMemoryPool(
+        memory::getProcessDefaultMemoryManager().getPool(
+            queryCtx->queryId(),
+            memory::MemoryPool::Kind::kAggregate,
+            kMaxMemory));
+    core::PlanFragment planFragment{planNode};
+    return std::make_shared<Task>(
+        taskId,
+        std::move(planFragment),
+        destination,
+        std::move(queryCtx),
+        std::move(consumer));
+  }
+
+  std::unordered_map<std::string, std::string> configSettings_;
+  std::vector<RowVectorPtr> flat_;
+  std::vector<RowVectorPtr> dictionary_;
+  int32_t runCounter_{0};
+};
+
+ShuffleBenchmark bm;
+
+std::vector<std::unique_ptr<ShuffleCase>> cases;
+
+void addCases() {
+  std::vector<int32_t> partitionCounts;
+  folly::split(',', FLAGS_partitions, partitionCounts);
+  for (auto numPartitions : partitionCounts) {
+    for (auto dictionary : {false, true}) {
+      for (auto roundRobin : {false, true}) {
+        // A single partition is not partitioned.
+        if (numPartitions == 1 && roundRobin) {
+          continue;
+        }
+        const char* partitioning = roundRobin ? "roundRobin" : "hash";
+        auto shuffleCase = std::make_unique<ShuffleCase>();
+        shuffleCase->name = fmt::format(
+            "{}{}{}",
+            numPartitions == 1 ? "gather" : partitioning,
+            dictionary ? "Dictionary" : "Flat",
+            numPartitions);
+        shuffleCase->numPartitions = numPartitions;
+        shuffleCase->roundRobin = roundRobin;
+        shuffleCase->dictionary = dictionary;
+        folly::addBenchmark(
+            __FILE__, shuffleCase->name, [shuffleCase = shuffleCase.get()]() {
+              bm.run(*shuffleCase);
+              return 1;
+            });
+        cases.push_back(std::move(shuffleCase));
+      }
+    }
+  }
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  if (FLAGS_serde == "unsafe_row") {
+    serializer::spark::UnsafeRowVectorSerde::registerVectorSerde();
+  } else {
+    VELOX_CHECK_EQ(FLAGS_serde, "presto", "Unknown serde");
+    serializer::presto::PrestoVectorSerde::registerVectorSerde();
+  }
+  exec::ExchangeSource::registerFactory();
+
+  bm.makeData(
+      ROW({"c0", "c1", "c2", "c3", "c4"},
+          {BIGINT(), INTEGER(), DOUBLE(), VARCHAR(), ARRAY(BIGINT())}));
+  addCases();
+  folly::runBenchmarks();
+  for (const auto& shuffleCase : cases) {
+    std::cout << shuffleCase->name << ": " << shuffleCase->counters.toString()
+              << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+
+#include <folly/Benchmark.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include "velox/common/base/RuntimeMetrics.h"
+#include "velox/common/file/FileSystems.h"
+#include "velox/common/time/Timer.h"
+#include "velox/exec/OperatorUtils.h"
+#include "velox/exec/Spiller.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+#include "velox/vector/tests/utils/VectorMaker.h"
+
+// Measures the throughput of spilling the rows of a RowContainer and of
+// merging them back from the spill files, for several row widths and
+// partition counts. After the timed runs, runs each case once more and prints
+// the time spent in each phase of the spill: sort, serialize and write on the
+// write side, read and deserialize on the read side. This tells whether a
+// slow spill is bound by CPU or by the file system.
+
+DEFINE_int32(spill_rows, 200'000, "Number of rows spilled in each case");
+DEFINE_int32(
+    spill_threads,
+    0,
+    "Number of spill executor threads. The spill runs are written inline if "
+    "0");
+DEFINE_bool(spill_compress, false, "Compresses the spilled pages with LZ4");
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::test;
+
+namespace {
+
+struct SpillCase {
+  const char* name;
+  // The number of BIGINT and VARCHAR columns after the BIGINT key.
+  int32_t numBigints;
+  int32_t numStrings;
+  int32_t stringSize;
+  // The number of hash bits for partitioning the spilled rows. The rows are
+  // spilled into a single partition, as in OrderBy, if 0.
+  int32_t numPartitionBits;
+};
+
+const std::vector<SpillCase>& spillCases() {
+  static const std::vector<SpillCase> kCases = {
+      {"narrow", 1, 0, 0, 0},
+      {"narrow8Partitions", 1, 0, 0, 3},
+      {"wide", 8, 4, 32, 0},
+      {"wide8Partitions", 8, 4, 32, 3},
+      {"longStrings", 0, 2, 512, 0}};
+  return kCases;
+}
+
+// Collects the runtime stats that the spill files record on the reading
+// thread.
+class StatWriter : public BaseRuntimeStatWriter {
+ public:
+  void addRuntimeStat(const std::string& name, const RuntimeCounter& value)
+      override {
+    addOperatorRuntimeStats(name, value, stats);
+  }
+
+  std::unordered_map<std::string, RuntimeMetric> stats;
+};
+
+struct SpillResult {
+  Spiller::Stats stats;
+  uint64_t spillNanos{0};
+  uint64_t readNanos{0};
+  uint64_t numReadRows{0};
+  std::unordered_map<std::string, RuntimeMetric> readStats;
+};
+
+class SpillBenchmark {
+ public:
+  explicit SpillBenchmark(const SpillCase& spillCase) : spillCase_(spillCase) {
+    VectorMaker maker(pool_.get());
+    std::vector<VectorPtr> columns;
+    columns.push_back(maker.flatVector<int64_t>(FLAGS_spill_rows, [](auto row) {
+      return folly::hasher<int64_t>()(row);
+    }));
+    for (auto i = 0; i < spillCase_.numBigints; ++i) {
+      columns.push_back(maker.flatVector<int64_t>(
+          FLAGS_spill_rows, [i](auto row) { return row * (i + 1); }));
+    }
+    const std::string chars(spillCase_.stringSize + 64, 'x');
+    for (auto i = 0; i < spillCase_.numStrings; ++i) {
+      columns.push_back(
+          maker.flatVector<StringView>(FLAGS_spill_rows, [&](auto row) {
+            return StringView(chars.data() + row % 64, spillCase_.stringSize);
+          }));
+    }
+    data_ = maker.rowVector(columns);
+    if (FLAGS_spill_threads > 0) {
+      executor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+          FLAGS_spill_threads);
+    }
+  }
+
+  // Spills all the rows of a RowContainer filled with 'data_' and reads them
+  // back in key order.
+  SpillResult run() {
+    SpillResult result;
+    folly::BenchmarkSuspender suspender;
+    auto tempDirectory = exec::test::TempDirectoryPath::create();
+    auto container = makeContainer();
+    auto spiller = makeSpiller(*container, tempDirectory->path);
+    suspender.dismiss();
+
+    {
+      NanosecondTimer timer(&result.spillNanos);
+      spiller->spill(0, 0);
+      spiller->finishSpill();
+    }
+    result.stats = spiller->stats();
+
+    StatWriter statWriter;
+    setThreadLocalRunTimeStatWriter(&statWriter);
+    {
+      NanosecondTimer timer(&result.readNanos);
+      const auto numPartitions = spiller->state().maxPartitions();
+      for (auto partition = 0; partition < numPartitions; ++partition) {
+        if (!spiller->isSpilled(partition)) {
+          continue;
+        }
+        auto merge = spiller->startMerge(partition);
+        while (auto* stream = merge->next()) {
+          ++result.numReadRows;
+          stream->pop();
+        }
+      }
+    }
+    setThreadLocalRunTimeStatWriter(nullptr);
+    result.readStats = std::move(statWriter.stats);
+
+    suspender.rehire();
+    spiller.reset();
+    container.reset();
+    return result;
+  }
+
+ private:
+  std::unique_ptr<RowContainer> makeContainer() {
+    const auto& types = asRowType(data_->type())->children();
+    auto container = std::make_unique<RowContainer>(
+        std::vector<TypePtr>{types[0]},
+        std::vector<TypePtr>(types.begin() + 1, types.end()),
+        pool_.get());
+    SelectivityVector allRows(data_->size());
+    std::vector<char*> rows(data_->size());
+    for (auto i = 0; i < data_->size(); ++i) {
+      rows[i] = container->newRow();
+    }
+    for (auto column = 0; column < data_->childrenSize(); ++column) {
+      DecodedVector decoded(*data_->childAt(column), allRows);
+      for (auto i = 0; i < data_->size(); ++i) {
+        container->store(decoded, i, rows[i], column);
+      }
+    }
+    return container;
+  }
+
+  std::unique_ptr<Spiller> makeSpiller(
+      RowContainer& container,
+      const std::string& path) {
+    constexpr uint64_t kTargetFileSize = 1L << 30;
+    const auto compressionKind = FLAGS_spill_compress
+        ? folly::io::CodecType::LZ4
+        : folly::io::CodecType::NO_COMPRESSION;
+    auto eraser = [&container](folly::Range<char**> rows) {
+      container.eraseRows(rows);
+    };
+    if (spillCase_.numPartitionBits == 0) {
+      return std::make_unique<Spiller>(
+          Spiller::Type::kOrderBy,
+          &container,
+          eraser,
+          asRowType(data_->type()),
+          1,
+          std::vector<CompareFlags>{},
+          path + "/spill",
+          kTargetFileSize,
+          0,
+          *pool_,
+          executor_.get(),
+          compressionKind);
+    }
+    return std::make_unique<Spiller>(
+        Spiller::Type::kAggregate,
+        &container,
+        eraser,
+        asRowType(data_->type()),
+        HashBitRange(0, spillCase_.numPartitionBits),
+        1,
+        std::vector<CompareFlags>{},
+        path + "/spill",
+        kTargetFileSize,
+        0,
+        *pool_,
+        executor_.get(),
+        compressionKind);
+  }
+
+  const SpillCase spillCase_;
+  std::shared_ptr<memory::MemoryPool> pool_{memory::getDefaultMemoryPool()};
+  RowVectorPtr data_;
+  std::unique_ptr<folly::CPUThreadPoolExecutor> executor_;
+};
+
+std::vector<std::unique_ptr<SpillBenchmark>> benchmarks;
+
+void makeBenchmarks() {
+  for (const auto& spillCase : spillCases()) {
+    benchmarks.push_back(std::make_unique<SpillBenchmark>(spillCase));
+  }
+}
+
+void runCase(int32_t index, uint32_t iters) {
+  for (auto i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(benchmarks[index]->run().numReadRows);
+  }
+}
+
+double millis(uint64_t nanos) {
+  return nanos / 1'000'000.0;
+}
+
+void printReport() {
+  for (auto i = 0; i < spillCases().size(); ++i) {
+    const auto result = benchmarks[i]->run();
+    const auto readStat = [&](const char* name) -> uint64_t {
+      auto it = result.readStats.find(name);
+      return it == result.readStats.end() ? 0 : it->second.sum;
+    };
+    const auto& stats = result.stats;
+    const double megabytes = stats.spilledUncompressedBytes / 1'048'576.0;
+    std::cout << spillCases()[i].name << ": " << stats.spilledRows
+              << " rows, " << stats.spilledPartitions << " partitions, "
+              << stats.spilledFiles << " files, " << stats.spilledBytes
+              << " bytes" << std::endl
+              << "  spill " << millis(result.spillNanos) << " ms ("
+              << megabytes * 1'000 / millis(result.spillNanos)
+              << " MB/s): sort " << millis(stats.spillSortNanos)
+              << " ms, serialize " << millis(stats.spillSerializationNanos)
+              << " ms, write " << millis(stats.spillWriteNanos) << " ms"
+              << std::endl
+              << "  merge " << millis(result.readNanos) << " ms ("
+              << megabytes * 1'000 / millis(result.readNanos)
+              << " MB/s): read " << millis(readStat("spillReadNanos"))
+              << " ms, deserialize "
+              << millis(readStat("spillDeserializationNanos")) << " ms"
+              << std::endl;
+  }
+}
+} // namespace
+
+BENCHMARK(narrow, iters) {
+  runCase(0, iters);
+}
+
+BENCHMARK(narrow8Partitions, iters) {
+  runCase(1, iters);
+}
+
+BENCHMARK(wide, iters) {
+  runCase(2, iters);
+}
+
+BENCHMARK(wide8Partitions, iters) {
+  runCase(3, iters);
+}
+
+BENCHMARK(longStrings, iters) {
+  runCase(4, iters);
+}
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv);
+  filesystems::registerLocalFileSystem();
+  makeBenchmarks();
+  folly::runBenchmarks();
+  printReport();
+  benchmarks.clear();
+  return 0;
+}
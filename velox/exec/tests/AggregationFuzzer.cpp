@@ -15,6 +15,8 @@
  */
 #include "velox/exec/tests/AggregationFuzzer.h"
 #include <boost/random/uniform_int_distribution.hpp>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/futures/Future.h>
 #include "velox/common/base/Fs.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
@@ -69,6 +71,20 @@ DEFINE_bool(
     "This is to rerun with the seed number and persist repro info upon a "
     "crash failure. Only effective if repro_persist_path is set.");
 
+DEFINE_double(
+    duck_verification_ratio,
+    1.0,
+    "Chance of verifying the results of an aggregation against DuckDB "
+    "(expressed as double from 0 to 1). Results are always verified by "
+    "comparing logically equivalent Velox plans, with and without spilling. "
+    "Window expressions are always verified against DuckDB.");
+
+DEFINE_int32(
+    num_verification_threads,
+    1,
+    "The number of threads to run the logically equivalent plans of an "
+    "iteration on.");
+
 using facebook::velox::test::CallableSignature;
 using facebook::velox::test::SignatureTemplate;
 
@@ -108,6 +124,10 @@ class AggregationFuzzer {
     // Number of iterations where results were verified against DuckDB,
     size_t numDuckVerified{0};
 
+    // Number of iterations where verification against DuckDB was skipped
+    // because of --duck_verification_ratio.
+    size_t numDuckSkipped{0};
+
     // Number of iterations where aggregation failed.
     size_t numFailed{0};
 
@@ -190,18 +210,24 @@ class AggregationFuzzer {
       const core::PlanNodePtr& plan,
       bool injectSpill);
 
+  // Returns true if the results of the current iteration should be verified
+  // against DuckDB. Doesn't consume randomness unless sampling is enabled so
+  // that seeds reproduce the same iterations as before.
+  bool sampleDuckVerification() {
+    if (FLAGS_duck_verification_ratio >= 1.0 ||
+        vectorFuzzer_.coinToss(FLAGS_duck_verification_ratio)) {
+      return true;
+    }
+    ++stats_.numDuckSkipped;
+    return false;
+  }
+
+  // Runs each plan with and without spilling and compares the results with
+  // 'expected'. Runs on 'verificationExecutor_' if set.
   void testPlans(
       const std::vector<core::PlanNodePtr>& plans,
       bool verifyResults,
-      const velox::test::ResultOrError& expected) {
-    for (auto i = 0; i < plans.size(); ++i) {
-      LOG(INFO) << "Testing plan #" << i;
-      testPlan(plans[i], false /*injectSpill*/, verifyResults, expected);
-
-      LOG(INFO) << "Testing plan #" << i << " with spilling";
-      testPlan(plans[i], true /*injectSpill*/, verifyResults, expected);
-    }
-  }
+      const velox::test::ResultOrError& expected);
 
   void testPlan(
       const core::PlanNodePtr& plan,
@@ -224,6 +250,9 @@ class AggregationFuzzer {
   std::shared_ptr<memory::MemoryPool> pool_{memory::getDefaultMemoryPool()};
   VectorFuzzer vectorFuzzer_;
 
+  // Set if --num_verification_threads is greater than 1.
+  std::unique_ptr<folly::CPUThreadPoolExecutor> verificationExecutor_;
+
   Stats stats_;
 };
 } // namespace
@@ -301,6 +330,11 @@ AggregationFuzzer::AggregationFuzzer(
 
   duckFunctionNames_ = getDuckFunctions();
 
+  if (FLAGS_num_verification_threads > 1) {
+    verificationExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+        FLAGS_num_verification_threads);
+  }
+
   size_t numFunctions = 0;
   size_t numSignatures = 0;
   size_t numSupportedFunctions = 0;
@@ -850,6 +884,40 @@ void makeStreamingPlans(
                       .planNode());
 }
 
+void AggregationFuzzer::testPlans(
+    const std::vector<core::PlanNodePtr>& plans,
+    bool verifyResults,
+    const velox::test::ResultOrError& expected) {
+  if (!verificationExecutor_) {
+    for (auto i = 0; i < plans.size(); ++i) {
+      LOG(INFO) << "Testing plan #" << i;
+      testPlan(plans[i], false /*injectSpill*/, verifyResults, expected);
+
+      LOG(INFO) << "Testing plan #" << i << " with spilling";
+      testPlan(plans[i], true /*injectSpill*/, verifyResults, expected);
+    }
+    return;
+  }
+
+  std::vector<folly::Future<folly::Unit>> futures;
+  futures.reserve(plans.size() * 2);
+  for (auto i = 0; i < plans.size(); ++i) {
+    for (auto injectSpill : {false, true}) {
+      futures.push_back(
+          folly::via(verificationExecutor_.get(), [&, i, injectSpill]() {
+            testPlan(plans[i], injectSpill, verifyResults, expected);
+          }));
+    }
+  }
+
+  // Wait for all plans before rethrowing the first failure, since the tasks
+  // reference 'plans' and 'expected'.
+  auto results = folly::collectAll(std::move(futures)).get();
+  for (auto& result : results) {
+    result.value();
+  }
+}
+
 void AggregationFuzzer::testPlan(
     const core::PlanNodePtr& plan,
     bool injectSpill,
@@ -996,7 +1064,7 @@ void AggregationFuzzer::verifyAggregation(
     const bool verifyResults = !orderDependent || !projections.empty();
 
     std::optional<MaterializedRowMultiset> expectedResult;
-    if (verifyResults) {
+    if (verifyResults && sampleDuckVerification()) {
       expectedResult = computeDuckAggregation(
           groupingKeys, aggregates, masks, projections, input, plan);
     }
@@ -1058,6 +1126,8 @@ void AggregationFuzzer::Stats::print(size_t numIterations) const {
             << printStat(numWindow, numIterations);
   LOG(INFO) << "Total aggregations verified against DuckDB: "
             << printStat(numDuckVerified, numIterations);
+  LOG(INFO) << "Total aggregations not sampled for DuckDB verification: "
+            << printStat(numDuckSkipped, numIterations);
   LOG(INFO) << "Total failed aggregations: "
             << printStat(numFailed, numIterations);
 }
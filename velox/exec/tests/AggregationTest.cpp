@@ -573,6 +573,118 @@ TEST_F(AggregationTest, rangeToDistinct) {
       " GROUP BY c0, c1, c2, c3, c4, c5");
 }
 
+TEST_F(AggregationTest, denseGroups) {
+  // The low cardinality key puts the hash table in array mode, where the
+  // numeric aggregates accumulate the input by dense group id.
+  auto vectors = makeVectors(rowType_, 1'000, 10);
+  createDuckDbTable(vectors);
+
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .project({"c0 % 11 AS k", "c1", "c2", "c3", "c4", "c5"})
+                  .singleAggregation(
+                      {"k"},
+                      {"sum(c1)",
+                       "sum(c4)",
+                       "count(c2)",
+                       "count(1)",
+                       "min(c3)",
+                       "max(c5)",
+                       "max(7)"})
+                  .planNode();
+  assertQuery(
+      plan,
+      "SELECT c0 % 11, sum(c1), sum(c4), count(c2), count(1), min(c3), "
+      "max(c5), max(7) FROM tmp GROUP BY 1");
+}
+
+TEST_F(AggregationTest, distinctAggregates) {
+  auto vectors = makeVectors(rowType_, 1'000, 10);
+  createDuckDbTable(vectors);
+
+  // Distinct and non-distinct aggregates run in the same aggregation.
+  core::PlanNodeId aggNodeId;
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .project({"c0 % 7 AS k", "c1 % 5 AS d", "c2", "c6"})
+                  .singleAggregation(
+                      {"k"},
+                      {"count(DISTINCT d)",
+                       "sum(c2)",
+                       "sum(DISTINCT d)",
+                       "count(DISTINCT c6)"})
+                  .capturePlanNodeId(aggNodeId)
+                  .planNode();
+  const std::string sql =
+      "SELECT c0 % 7, count(DISTINCT c1 % 5), sum(c2), sum(DISTINCT c1 % 5), "
+      "count(DISTINCT c6) FROM tmp GROUP BY 1";
+  assertQuery(plan, sql);
+
+  // The distinct sets stay in memory while the groups are spilled.
+  auto spillDirectory = exec::test::TempDirectoryPath::create();
+  auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                  .spillDirectory(spillDirectory->path)
+                  .config(QueryConfig::kSpillEnabled, "true")
+                  .config(QueryConfig::kAggregationSpillEnabled, "true")
+                  .config(QueryConfig::kTestingSpillPct, "100")
+                  .plan(plan)
+                  .assertResults(sql);
+  EXPECT_LT(0, toPlanStats(task->taskStats()).at(aggNodeId).spilledBytes);
+  OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+
+  plan = PlanBuilder()
+             .values(vectors)
+             .project({"c1 % 5 AS d"})
+             .singleAggregation({}, {"count(DISTINCT d)", "count(d)"})
+             .planNode();
+  assertQuery(plan, "SELECT count(DISTINCT c1 % 5), count(c1) FROM tmp");
+
+  VELOX_ASSERT_THROW(
+      PlanBuilder()
+          .values(vectors)
+          .partialAggregation({"c0"}, {"count(DISTINCT c1)"}),
+      "Distinct aggregates are only supported in a single step aggregation");
+}
+
+TEST_F(AggregationTest, orderedAggregates) {
+  // The sorting key c1 is unique, so the order of the arrays is deterministic.
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 4; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int32_t>(100, [](auto row) { return row % 7; }),
+        makeFlatVector<int64_t>(
+            100, [i](auto row) { return (i * 100 + row) * 919 % 1'000; }),
+        makeFlatVector<int32_t>(100, [i](auto row) { return i * 100 + row; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .singleAggregation(
+                      {"c0"},
+                      {"array_agg(c2 ORDER BY c1)",
+                       "array_agg(c2 ORDER BY c1 DESC)",
+                       "sum(c2)"})
+                  .planNode();
+  assertQuery(
+      plan,
+      "SELECT c0, array_agg(c2 ORDER BY c1), array_agg(c2 ORDER BY c1 DESC), "
+      "sum(c2) FROM tmp GROUP BY 1");
+
+  plan = PlanBuilder()
+             .values(vectors)
+             .singleAggregation({}, {"array_agg(c1 ORDER BY c1 DESC)"})
+             .planNode();
+  assertQuery(plan, "SELECT array_agg(c1 ORDER BY c1 DESC) FROM tmp");
+
+  VELOX_ASSERT_THROW(
+      PlanBuilder()
+          .values(vectors)
+          .partialAggregation({"c0"}, {"array_agg(c2 ORDER BY c1)"}),
+      "Ordered aggregates are only supported in a single step aggregation");
+}
+
 TEST_F(AggregationTest, allKeyTypes) {
   // Covers different key types. Unlike the integer/string tests, the
   // hash table begins life in the generic mode, not array or
@@ -880,6 +992,43 @@ TEST_F(AggregationTest, spillWithMemoryLimit) {
   }
 }
 
+TEST_F(AggregationTest, spillNearUniqueGroups) {
+  // Almost all keys are unique in the first 5 batches. The last 5 batches have
+  // few distinct keys.
+  std::vector<RowVectorPtr> batches;
+  for (int32_t i = 0; i < 10; ++i) {
+    batches.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000,
+            [&](auto row) { return i < 5 ? i * 1'000 + row : row % 10; }),
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+    }));
+  }
+  createDuckDbTable(batches);
+
+  for (const auto& [minGroups, expectSpill] :
+       std::vector<std::pair<std::string, bool>>{
+           {"0", false}, {"1500", true}, {"100000", false}}) {
+    SCOPED_TRACE(minGroups);
+    auto tempDirectory = exec::test::TempDirectoryPath::create();
+    auto task =
+        AssertQueryBuilder(duckDbQueryRunner_)
+            .plan(PlanBuilder()
+                      .values(batches)
+                      .singleAggregation({"c0"}, {"sum(c1)", "count(1)"})
+                      .planNode())
+            .spillDirectory(tempDirectory->path)
+            .config(QueryConfig::kSpillEnabled, "true")
+            .config(QueryConfig::kAggregationSpillEnabled, "true")
+            .config(QueryConfig::kAggregationSortBasedMinGroups, minGroups)
+            .assertResults("SELECT c0, sum(c1), count(1) FROM tmp GROUP BY 1");
+
+    auto stats = task->taskStats().pipelineStats;
+    ASSERT_EQ(expectSpill, stats[0].operatorStats[1].spilledBytes > 0);
+    OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+  }
+}
+
 DEBUG_ONLY_TEST_F(AggregationTest, spillWithEmptyPartition) {
   constexpr int32_t kNumDistinct = 100'000;
   constexpr int64_t kMaxBytes = 20LL << 20; // 20 MB
@@ -1248,6 +1397,66 @@ TEST_F(AggregationTest, groupingSets) {
       "SELECT k1, k2, count(1), sum(a), max(b) FROM tmp GROUP BY ROLLUP (k1, k2)");
 }
 
+TEST_F(AggregationTest, groupingSetsAggregation) {
+  vector_size_t size = 1'000;
+  auto data = makeRowVector(
+      {"k1", "k2", "a", "b"},
+      {
+          makeFlatVector<int64_t>(size, [](auto row) { return row % 11; }),
+          makeFlatVector<int64_t>(size, [](auto row) { return row % 17; }),
+          makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+          makeFlatVector<StringView>(
+              size,
+              [](auto row) {
+                auto str = std::string(row % 12, 'x');
+                return StringView(str);
+              }),
+      });
+
+  createDuckDbTable({data});
+
+  // Cube. GroupId receives the 11 * 17 pre-aggregated groups instead of the
+  // input rows.
+  auto plan = PlanBuilder()
+                  .values({data})
+                  .groupingSetsAggregation(
+                      {{"k1", "k2"}, {"k1"}, {"k2"}, {}},
+                      {"count(1) as count_1", "sum(a) as sum_a", "max(b)"})
+                  .project({"k1", "k2", "count_1", "sum_a", "a2"})
+                  .planNode();
+  auto groupIdNodeId = plan->sources()[0]->sources()[0]->id();
+
+  auto task = assertQuery(
+      plan,
+      "SELECT k1, k2, count(1), sum(a), max(b) FROM tmp GROUP BY CUBE (k1, k2)");
+  auto planStats = toPlanStats(task->taskStats());
+  ASSERT_EQ(11 * 17, planStats.at(groupIdNodeId).inputRows);
+
+  // Rollup.
+  plan = PlanBuilder()
+             .values({data})
+             .groupingSetsAggregation(
+                 {{"k1", "k2"}, {"k1"}, {}},
+                 {"count(1) as count_1", "avg(a) as avg_a", "max(b) as max_b"})
+             .project({"k1", "k2", "count_1", "avg_a", "max_b"})
+             .planNode();
+
+  assertQuery(
+      plan,
+      "SELECT k1, k2, count(1), avg(a), max(b) FROM tmp GROUP BY ROLLUP (k1, k2)");
+
+  // Disjoint grouping sets.
+  plan = PlanBuilder()
+             .values({data})
+             .groupingSetsAggregation({{"k1"}, {"k2"}}, {"sum(a) as sum_a"})
+             .project({"k1", "k2", "sum_a"})
+             .planNode();
+
+  assertQuery(
+      plan,
+      "SELECT k1, k2, sum(a) FROM tmp GROUP BY GROUPING SETS ((k1), (k2))");
+}
+
 TEST_F(AggregationTest, groupingSetsOutput) {
   vector_size_t size = 1'000;
   auto data = makeRowVector(
@@ -1379,6 +1588,124 @@ TEST_F(AggregationTest, distinctWithSpilling) {
   OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
 }
 
+TEST_F(AggregationTest, abandonPartialAggregation) {
+  const int32_t numBatches = 10;
+  const int32_t batchSize = 1'000;
+  const int32_t numRows = numBatches * batchSize;
+  for (const bool uniqueKeys : {true, false}) {
+    SCOPED_TRACE(fmt::format("uniqueKeys: {}", uniqueKeys));
+    std::vector<RowVectorPtr> vectors;
+    for (auto i = 0; i < numBatches; ++i) {
+      vectors.push_back(makeRowVector({
+          makeFlatVector<int64_t>(
+              batchSize,
+              [&](auto row) {
+                return uniqueKeys ? i * batchSize + row : row % 10;
+              }),
+          makeFlatVector<int64_t>(batchSize, [](auto row) { return row; }),
+      }));
+    }
+    createDuckDbTable(vectors);
+
+    core::PlanNodeId partialAggNodeId;
+    auto task = AssertQueryBuilder(duckDbQueryRunner_)
+                    .config(
+                        QueryConfig::kAbandonPartialAggregationMinRows,
+                        std::to_string(batchSize))
+                    .config(QueryConfig::kAbandonPartialAggregationMinPct, "80")
+                    .plan(PlanBuilder()
+                              .values(vectors)
+                              .partialAggregation({"c0"}, {"sum(c1)"})
+                              .capturePlanNodeId(partialAggNodeId)
+                              .finalAggregation()
+                              .planNode())
+                    .assertResults("SELECT c0, sum(c1) FROM tmp GROUP BY 1");
+    const auto stats = toPlanStats(task->taskStats()).at(partialAggNodeId);
+    EXPECT_EQ(1, stats.customStats.count("sampledDistinctKeys"));
+    if (uniqueKeys) {
+      EXPECT_EQ(1, stats.customStats.count("abandonedPartialAggregation"));
+      // The sampled rows and every row after them are separate groups.
+      EXPECT_EQ(numRows, stats.outputRows);
+    } else {
+      EXPECT_EQ(0, stats.customStats.count("abandonedPartialAggregation"));
+      EXPECT_EQ(10, stats.outputRows);
+    }
+  }
+}
+
+TEST_F(AggregationTest, appendOnlyStrings) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<std::string>(
+            1'000,
+            [&](auto row) {
+              return fmt::format("{}-key-longer-than-inline", (i + row) % 777);
+            }),
+        makeFlatVector<std::string>(
+            1'000,
+            [&](auto row) {
+              return fmt::format("value-longer-than-inline-{}", row);
+            }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  AssertQueryBuilder(duckDbQueryRunner_)
+      .config(QueryConfig::kAggregationAppendOnlyStrings, "true")
+      .plan(PlanBuilder()
+                .values(vectors)
+                .singleAggregation({"c0"}, {"count(1)", "max(c1)"})
+                .planNode())
+      .assertResults("SELECT c0, count(1), max(c1) FROM tmp GROUP BY 1");
+}
+
+TEST_F(AggregationTest, parallelMerge) {
+  auto vectors = makeVectors(rowType_, 10, 1'000);
+  createDuckDbTable(vectors);
+  for (const auto partitionBits : {0, 1, 4}) {
+    SCOPED_TRACE(fmt::format("partitionBits: {}", partitionBits));
+    core::PlanNodeId partialAggNodeId;
+    core::PlanNodeId finalAggNodeId;
+    auto task =
+        AssertQueryBuilder(duckDbQueryRunner_)
+            .config(
+                QueryConfig::kAggregationMergePartitionBits,
+                std::to_string(partitionBits))
+            .plan(PlanBuilder()
+                      .values(vectors)
+                      .partialAggregation(
+                          {"c0", "c6"}, {"sum(c1)", "max(c3)", "count(c5)"})
+                      .capturePlanNodeId(partialAggNodeId)
+                      .finalAggregation()
+                      .capturePlanNodeId(finalAggNodeId)
+                      .planNode())
+            .assertResults(
+                "SELECT c0, c6, sum(c1), max(c3), count(c5) FROM tmp GROUP BY 1, 2");
+    const auto planStats = toPlanStats(task->taskStats());
+    // The partial aggregation is never partitioned.
+    EXPECT_EQ(
+        0,
+        planStats.at(partialAggNodeId).customStats.count("numMergePartitions"));
+    const auto& runtimeStats = planStats.at(finalAggNodeId).customStats;
+    if (partitionBits == 0) {
+      EXPECT_EQ(0, runtimeStats.count("numMergePartitions"));
+    } else {
+      EXPECT_EQ(1 << partitionBits, runtimeStats.at("numMergePartitions").max);
+    }
+
+    AssertQueryBuilder(duckDbQueryRunner_)
+        .config(
+            QueryConfig::kAggregationMergePartitionBits,
+            std::to_string(partitionBits))
+        .plan(PlanBuilder()
+                  .values(vectors)
+                  .singleAggregation({"c6"}, {"sum(c2)", "min(c6)"})
+                  .planNode())
+        .assertResults("SELECT c6, sum(c2), min(c6) FROM tmp GROUP BY 1");
+  }
+}
+
 TEST_F(AggregationTest, preGroupedAggregationWithSpilling) {
   std::vector<RowVectorPtr> vectors;
   int64_t val = 0;
@@ -226,3 +226,52 @@ TEST_F(ArrowStreamTest, error) {
       AssertQueryBuilder(plan).copyResults(pool_.get()),
       "Failed to call get_schema on ArrowStream: get_schema failed.");
 }
+
+TEST_F(ArrowStreamTest, prefetch) {
+  vector_size_t size = 1'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector(
+        {makeFlatVector<int32_t>(
+             size, [&](auto row) { return size * i + row; }, nullEvery(5)),
+         makeFlatVector<int64_t>(size, [](auto row) { return row % 7; })}));
+  }
+  createDuckDbTable(vectors);
+  auto type = asRowType(vectors[0]->type());
+
+  for (const auto* prefetchBatches : {"1", "4", "100"}) {
+    SCOPED_TRACE(prefetchBatches);
+    struct ArrowArrayStream arrowStream;
+    exportArrowStream(
+        std::make_shared<ArrowReader>(pool_, vectors, type), &arrowStream);
+    auto plan = std::make_shared<core::ArrowStreamNode>(
+        "0", type, std::make_shared<ArrowArrayStream>(arrowStream));
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .config(core::QueryConfig::kArrowStreamPrefetchBatches, prefetchBatches)
+        .assertResults("SELECT * FROM tmp");
+  }
+
+  // The output type selects a subset of the columns of the stream by name.
+  struct ArrowArrayStream arrowStream;
+  exportArrowStream(
+      std::make_shared<ArrowReader>(pool_, vectors, type), &arrowStream);
+  auto plan = std::make_shared<core::ArrowStreamNode>(
+      "0",
+      ROW({"c1"}, {BIGINT()}),
+      std::make_shared<ArrowArrayStream>(arrowStream));
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .config(core::QueryConfig::kArrowStreamPrefetchBatches, "2")
+      .assertResults("SELECT c1 FROM tmp");
+
+  // Errors in a prefetch are thrown on the driver thread.
+  exportArrowStream(
+      std::make_shared<ArrowReader>(pool_, vectors, type, true, false),
+      &arrowStream);
+  plan = std::make_shared<core::ArrowStreamNode>(
+      "0", type, std::make_shared<ArrowArrayStream>(arrowStream));
+  VELOX_ASSERT_THROW(
+      AssertQueryBuilder(plan)
+          .config(core::QueryConfig::kArrowStreamPrefetchBatches, "2")
+          .copyResults(pool_.get()),
+      "Failed to call get_next on ArrowStream: get_next failed.");
+}
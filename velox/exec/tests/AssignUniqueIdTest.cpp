@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 #include "velox/exec/tests/utils/QueryAssertions.h"
@@ -103,6 +104,28 @@ TEST_F(AssignUniqueIdTest, exceedRequestLimit) {
   verifyUniqueId(plan, input);
 }
 
+TEST_F(AssignUniqueIdTest, batchesAcrossRequests) {
+  // The batches do not divide the ids of a request, so that some take their
+  // ids from two requests, which the threads make concurrently.
+  constexpr vector_size_t kBatchSize = 100'003;
+  constexpr int32_t kNumRepeats = 11;
+  constexpr int32_t kNumThreads = 2;
+  auto input = {makeRowVector(
+      {makeFlatVector<int32_t>(kBatchSize, [](auto row) { return row; })})};
+  auto plan = PlanBuilder()
+                  .values(input, true, kNumRepeats)
+                  .assignUniqueId()
+                  .planNode();
+  auto result =
+      AssertQueryBuilder(plan).maxDrivers(kNumThreads).copyResults(pool());
+  ASSERT_EQ(kNumThreads * kNumRepeats * kBatchSize, result->size());
+
+  auto* rawIds = result->childAt(1)->asFlatVector<int64_t>()->rawValues();
+  std::vector<int64_t> ids(rawIds, rawIds + result->size());
+  std::sort(ids.begin(), ids.end());
+  EXPECT_EQ(ids.end(), std::adjacent_find(ids.begin(), ids.end()));
+}
+
 TEST_F(AssignUniqueIdTest, multiThread) {
   for (int i = 0; i < 3; i++) {
     vector_size_t batchSize = 1000;
@@ -13,8 +13,11 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 using namespace facebook::velox;
 using namespace facebook::velox::exec;
@@ -152,6 +155,66 @@ TEST_F(CrossJoinTest, basic) {
       "SELECT * FROM t, (SELECT * FROM UNNEST (ARRAY[10, 17, 10, 17, 10, 17, 10, 17])) u");
 }
 
+TEST_F(CrossJoinTest, filter) {
+  // Range join: each left row falls into up to a few right-side ranges.
+  auto leftVectors = {
+      makeRowVector({"ts"}, {sequence<int32_t>(1'000)}),
+      makeRowVector({"ts"}, {sequence<int32_t>(234, 1'000)}),
+  };
+  auto rightVectors = {
+      makeRowVector(
+          {"r_start", "r_end"},
+          {makeFlatVector<int32_t>(300, [](auto row) { return row * 5; }),
+           makeFlatVector<int32_t>(300, [](auto row) { return row * 5 + 7; })}),
+  };
+
+  createDuckDbTable("t", {leftVectors});
+  createDuckDbTable("u", {rightVectors});
+
+  for (const auto batchSize : {"10", "1024"}) {
+    SCOPED_TRACE(batchSize);
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    auto plan = [&](core::JoinType joinType) {
+      return PlanBuilder(planNodeIdGenerator)
+          .values({leftVectors})
+          .crossJoin(
+              PlanBuilder(planNodeIdGenerator)
+                  .values({rightVectors})
+                  .planNode(),
+              "ts BETWEEN r_start AND r_end",
+              {"ts", "r_start"},
+              joinType)
+          .planNode();
+    };
+
+    AssertQueryBuilder(plan(core::JoinType::kInner), duckDbQueryRunner_)
+        .config(core::QueryConfig::kPreferredOutputBatchSize, batchSize)
+        .assertResults(
+            "SELECT ts, r_start FROM t, u WHERE ts BETWEEN r_start AND r_end");
+
+    // Left rows past the last range have no match.
+    AssertQueryBuilder(plan(core::JoinType::kLeft), duckDbQueryRunner_)
+        .config(core::QueryConfig::kPreferredOutputBatchSize, batchSize)
+        .assertResults(
+            "SELECT ts, r_start FROM t LEFT JOIN u ON ts BETWEEN r_start AND r_end");
+  }
+
+  // Left join with an empty build side returns all left rows.
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .values({leftVectors})
+                  .crossJoin(
+                      PlanBuilder(planNodeIdGenerator)
+                          .values({rightVectors})
+                          .filter("r_start < 0")
+                          .planNode(),
+                      "",
+                      {"ts", "r_start"},
+                      core::JoinType::kLeft)
+                  .planNode();
+  assertQuery(plan, "SELECT ts, null FROM t");
+}
+
 TEST_F(CrossJoinTest, lazyVectors) {
   auto leftVectors = {
       makeRowVector({lazySequence<int32_t>(10)}),
@@ -258,3 +321,51 @@ TEST_F(CrossJoinTest, parallelism) {
 
   OperatorTestBase::assertQuery(params, "VALUES (30), (30), (30), (30), (30)");
 }
+
+TEST_F(CrossJoinTest, spill) {
+  std::vector<RowVectorPtr> leftVectors;
+  std::vector<RowVectorPtr> rightVectors;
+  for (auto i = 0; i < 10; ++i) {
+    leftVectors.push_back(makeRowVector({sequence<int32_t>(20, i * 20)}));
+    rightVectors.push_back(
+        makeRowVector({"u_c0"}, {sequence<int32_t>(100, i * 100)}));
+  }
+  createDuckDbTable("t", leftVectors);
+  createDuckDbTable("u", rightVectors);
+
+  core::PlanNodeId joinNodeId;
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .values(leftVectors)
+                  .crossJoin(
+                      PlanBuilder(planNodeIdGenerator)
+                          .values(rightVectors)
+                          .planNode(),
+                      {"c0", "u_c0"})
+                  .capturePlanNodeId(joinNodeId)
+                  .planNode();
+
+  // A threshold of 1 byte spills all the build side. The larger one keeps
+  // some of the build side batches in memory.
+  for (const auto threshold : {1, 1'000}) {
+    SCOPED_TRACE(fmt::format("threshold: {}", threshold));
+    auto spillDirectory = TempDirectoryPath::create();
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .spillDirectory(spillDirectory->path)
+                    .config(core::QueryConfig::kSpillEnabled, "true")
+                    .config(core::QueryConfig::kJoinSpillEnabled, "true")
+                    .config(
+                        core::QueryConfig::kJoinSpillMemoryThreshold,
+                        std::to_string(threshold))
+                    .assertResults("SELECT * FROM t, u");
+    auto planStats = toPlanStats(task->taskStats());
+    const auto& joinStats = planStats.at(joinNodeId);
+    ASSERT_GT(joinStats.spilledRows, 0);
+    ASSERT_GT(joinStats.spilledFiles, 0);
+    if (threshold == 1) {
+      ASSERT_EQ(joinStats.spilledRows, 1'000);
+    } else {
+      ASSERT_LT(joinStats.spilledRows, 1'000);
+    }
+  }
+}
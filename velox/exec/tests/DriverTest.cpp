@@ -592,6 +592,51 @@ TEST_F(DriverTest, yield) {
   }
 }
 
+TEST_F(DriverTest, schedulingPriority) {
+  auto task = createAndStartTaskToReadValues(1);
+  ASSERT_TRUE(waitForTaskCompletion(task.get(), 1'000'000));
+
+  // A single priority queue has only priority 0.
+  EXPECT_EQ(task->schedulingPriority(1), 0);
+  // With 3 priorities, the highest is 1 and the lowest is -1.
+  EXPECT_EQ(task->schedulingPriority(3), 1);
+  task->addOnThreadTime(2'000'000'000);
+  EXPECT_EQ(task->schedulingPriority(3), 0);
+  task->addOnThreadTime(10'000'000'000);
+  EXPECT_EQ(task->schedulingPriority(3), -1);
+  // Levels beyond the number of priorities share the lowest priority.
+  task->addOnThreadTime(300'000'000'000);
+  EXPECT_EQ(task->schedulingPriority(3), -1);
+  EXPECT_EQ(task->schedulingPriority(8), -1);
+}
+
+DEBUG_ONLY_TEST_F(DriverTest, timeSliceYield) {
+  // Each batch takes longer than the time slice.
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::exec::Values::getOutput",
+      std::function<void(const exec::Values*)>([&](const exec::Values*) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2)); // NOLINT
+      }));
+
+  std::vector<RowVectorPtr> batches;
+  for (int i = 0; i < 10; ++i) {
+    batches.push_back(makeRowVector({makeFlatVector<int32_t>({1, 2, 3})}));
+  }
+  CursorParameters params;
+  params.planNode = PlanBuilder().values(batches).planNode();
+  params.queryCtx = std::make_shared<core::QueryCtx>(
+      executor_.get(),
+      std::make_shared<core::MemConfig>(
+          std::unordered_map<std::string, std::string>{
+              {core::QueryConfig::kDriverTimeSliceMs, "1"}}));
+  int32_t numRead = 0;
+  readResults(params, ResultOperation::kRead, 1'000'000, &numRead);
+  EXPECT_EQ(numRead, 30);
+  const auto taskStats = tasks_[0]->taskStats();
+  EXPECT_GT(taskStats.numTimeSliceYields, 0);
+  EXPECT_GT(taskStats.onThreadNanos, 0);
+}
+
 // A testing Operator that periodically does one of the following:
 //
 // 1. Blocks and registers a resume that continues the Driver after a timed
@@ -15,8 +15,10 @@
  */
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
 #include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/functions/Registerer.h"
 
 using namespace facebook::velox;
 using namespace facebook::velox::exec;
@@ -24,6 +26,21 @@ using namespace facebook::velox::exec::test;
 
 using facebook::velox::test::BatchMaker;
 
+namespace {
+int64_t numPlusOneCalls{0};
+
+// Adds one and counts the rows it is called for.
+template <typename T>
+struct CountingPlusOneFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  void call(int64_t& result, const int64_t& input) {
+    ++numPlusOneCalls;
+    result = input + 1;
+  }
+};
+} // namespace
+
 class FilterProjectTest : public OperatorTestBase {
  protected:
   void assertFilter(
@@ -298,6 +315,33 @@ TEST_F(FilterProjectTest, filterProjectFused) {
       "SELECT c0, c1, c0 %100 + c1 % 50, c0 % 100 FROM tmp WHERE c0 % 10 < 5");
 }
 
+TEST_F(FilterProjectTest, coalesceSmallBatches) {
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 20; ++i) {
+    vectors.push_back(makeRowVector({makeFlatVector<int64_t>(
+        100, [&](auto row) { return i * 100 + row; })}));
+  }
+  createDuckDbTable(vectors);
+
+  // Each batch has 2 rows after the filter. The 20 batches are copied into
+  // one.
+  auto plan = PlanBuilder().values(vectors).filter("c0 % 50 = 0").planNode();
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .config(core::QueryConfig::kCoalesceSmallBatches, "true")
+                  .assertResults("SELECT * FROM tmp WHERE c0 % 50 = 0");
+
+  const auto& operatorStats = task->taskStats().pipelineStats[0].operatorStats;
+  auto it = std::find_if(
+      operatorStats.begin(), operatorStats.end(), [](const auto& stats) {
+        return stats.operatorType == "CoalesceBatches";
+      });
+  ASSERT_NE(it, operatorStats.end());
+  ASSERT_EQ(it->inputVectors, 20);
+  ASSERT_EQ(it->outputVectors, 1);
+  ASSERT_EQ(it->outputPositions, 40);
+  ASSERT_EQ(it->runtimeStats.at("coalescedBatches").sum, 20);
+}
+
 TEST_F(FilterProjectTest, projectAndIdentityOverLazy) {
   // Verify that a lazy column which is a part of both an identity projection
   // and a regular projection is loaded correctly. This is done by running a
@@ -322,3 +366,59 @@ TEST_F(FilterProjectTest, projectAndIdentityOverLazy) {
                   .planNode();
   assertQuery(plan, "SELECT c0 < 10 AND c1 < 10, c1 FROM tmp");
 }
+
+TEST_F(FilterProjectTest, loadIdentityOverLazyAfterFilter) {
+  // c1 is referenced by an identity projection and a regular projection but
+  // not by the filter. It is loaded only for the rows that pass the filter.
+  vector_size_t size = 100;
+  auto valueAt = [](auto row) -> int32_t { return row; };
+  vector_size_t numLoadedRows = 0;
+  auto lazy = std::make_shared<LazyVector>(
+      pool(),
+      INTEGER(),
+      size,
+      std::make_unique<SimpleVectorLoader>([&](RowSet rows) {
+        numLoadedRows += rows.size();
+        return makeFlatVector<int32_t>(rows.back() + 1, valueAt);
+      }));
+  auto lazyVectors = makeRowVector({
+      makeFlatVector<int32_t>(size, valueAt),
+      lazy,
+  });
+
+  auto vectors = makeRowVector({
+      makeFlatVector<int32_t>(size, valueAt),
+      makeFlatVector<int32_t>(size, valueAt),
+  });
+  createDuckDbTable({vectors});
+
+  auto plan = PlanBuilder()
+                  .values({lazyVectors})
+                  .filter("c0 % 10 = 0")
+                  .project({"c1", "c1 + 1"})
+                  .planNode();
+  assertQuery(plan, "SELECT c1, c1 + 1 FROM tmp WHERE c0 % 10 = 0");
+  ASSERT_EQ(numLoadedRows, 10);
+}
+
+TEST_F(FilterProjectTest, commonSubexpressionAcrossFilterAndProject) {
+  registerFunction<CountingPlusOneFunction, int64_t, int64_t>(
+      {"counting_plus_one"});
+
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({makeFlatVector<int64_t>(
+        100, [&](auto row) { return i * 100 + row; })}));
+  }
+  createDuckDbTable(vectors);
+
+  // The projection reuses the values of the filter for the rows that passed.
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .filter("counting_plus_one(c0) % 3 = 0")
+                  .project({"counting_plus_one(c0) * 10"})
+                  .planNode();
+  numPlusOneCalls = 0;
+  assertQuery(plan, "SELECT (c0 + 1) * 10 FROM tmp WHERE (c0 + 1) % 3 = 0");
+  ASSERT_EQ(numPlusOneCalls, 1'000);
+}
@@ -337,6 +337,35 @@ TEST_P(HashJoinBridgeTest, withSpill) {
   }
 }
 
+TEST_P(HashJoinBridgeTest, buildSideHasNullKeys) {
+  auto joinBridge = createJoinBridge();
+  for (int32_t i = 0; i < numBuilders_; ++i) {
+    joinBridge->addBuilder();
+  }
+  joinBridge->start();
+  ASSERT_FALSE(joinBridge->buildSideHasNullKeys());
+
+  // Any builder may report a null key while others are still adding input.
+  std::vector<std::thread> builderThreads;
+  for (int32_t i = 0; i < numBuilders_; ++i) {
+    builderThreads.emplace_back([&, i]() {
+      if (i % 2 == 0) {
+        joinBridge->setBuildSideHasNullKeys();
+      }
+    });
+  }
+  for (auto& thread : builderThreads) {
+    thread.join();
+  }
+  ASSERT_TRUE(joinBridge->buildSideHasNullKeys());
+
+  joinBridge->setAntiJoinHasNullKeys();
+  ContinueFuture future;
+  auto tableOr = joinBridge->tableOrFuture(&future);
+  ASSERT_TRUE(tableOr.has_value());
+  ASSERT_TRUE(tableOr->hasNullKeys);
+}
+
 TEST_P(HashJoinBridgeTest, multiThreading) {
   for (int32_t iter = 0; iter < 10; ++iter) {
     std::vector<std::thread> builderThreads;
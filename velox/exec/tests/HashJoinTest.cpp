@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <folly/hash/Hash.h>
+
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/testutil/TestValue.h"
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
@@ -187,6 +189,21 @@ int32_t maxHashBuildSpillLevel(const exec::Task& task) {
   return maxSpillLevel;
 }
 
+// Returns the number of restored spill partitions which the hash builds of
+// 'task' could not spill again as that would exceed the max spill level.
+int64_t numMaxSpillLevelExceeded(const exec::Task& task) {
+  int64_t numExceeded = 0;
+  for (auto& pipelineStat : task.taskStats().pipelineStats) {
+    for (auto& operatorStat : pipelineStat.operatorStats) {
+      if (operatorStat.operatorType == "HashBuild" &&
+          operatorStat.runtimeStats.count("exceededMaxSpillLevel") != 0) {
+        numExceeded += operatorStat.runtimeStats["exceededMaxSpillLevel"].sum;
+      }
+    }
+  }
+  return numExceeded;
+}
+
 std::pair<int32_t, int32_t> numTaskSpillFiles(const exec::Task& task) {
   int32_t numBuildFiles = 0;
   int32_t numProbeFiles = 0;
@@ -608,6 +625,9 @@ class HashJoinBuilder {
         ASSERT_GT(spillStats.spilledFiles, 0);
         if (maxSpillLevel != -1) {
           ASSERT_EQ(maxHashBuildSpillLevel(*task), maxSpillLevel);
+          // The restored partitions of the max spill level are built without
+          // spilling.
+          ASSERT_GT(numMaxSpillLevelExceeded(*task), 0);
         }
       }
     } else {
@@ -1207,6 +1227,58 @@ TEST_P(MultiThreadedHashJoinTest, leftSemiJoinFilterWithEmptyBuild) {
       .run();
 }
 
+TEST_P(MultiThreadedHashJoinTest, leftSemiAndAntiJoinWithDuplicateBuildKeys) {
+  // Each build key repeats many times within and across batches. The build
+  // keeps one row per key. Small keys fit an array hash table, large keys
+  // need a hash mode table.
+  for (const int64_t multiplier : {1L, 1'000'000'007L}) {
+    SCOPED_TRACE(fmt::format("multiplier: {}", multiplier));
+    std::vector<RowVectorPtr> probeVectors =
+        makeBatches(5, [&](int32_t /*unused*/) {
+          return makeRowVector({
+              makeFlatVector<int64_t>(
+                  1'000,
+                  [&](auto row) { return (row % 97) * multiplier; },
+                  nullEvery(17)),
+              makeFlatVector<int32_t>(1'000, [](auto row) { return row; }),
+          });
+        });
+    std::vector<RowVectorPtr> buildVectors =
+        makeBatches(10, [&](int32_t batch) {
+          return makeRowVector({
+              makeFlatVector<int64_t>(
+                  1'000,
+                  [&](auto row) {
+                    return ((row + batch) % 50) * 2 * multiplier;
+                  }),
+          });
+        });
+
+    HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+        .numDrivers(numDrivers_)
+        .probeKeys({"c0"})
+        .probeVectors(std::vector<RowVectorPtr>(probeVectors))
+        .buildKeys({"c0"})
+        .buildVectors(std::vector<RowVectorPtr>(buildVectors))
+        .joinType(core::JoinType::kLeftSemiFilter)
+        .joinOutputLayout({"c1"})
+        .referenceQuery("SELECT t.c1 FROM t WHERE t.c0 IN (SELECT c0 FROM u)")
+        .run();
+
+    HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+        .numDrivers(numDrivers_)
+        .probeKeys({"c0"})
+        .probeVectors(std::move(probeVectors))
+        .buildKeys({"c0"})
+        .buildVectors(std::move(buildVectors))
+        .joinType(core::JoinType::kAnti)
+        .joinOutputLayout({"c1"})
+        .referenceQuery(
+            "SELECT t.c1 FROM t WHERE NOT EXISTS (SELECT * FROM u WHERE u.c0 = t.c0)")
+        .run();
+  }
+}
+
 TEST_P(MultiThreadedHashJoinTest, leftSemiJoinFilterWithExtraFilter) {
   std::vector<RowVectorPtr> probeVectors = makeBatches(5, [&](int32_t batch) {
     return makeRowVector(
@@ -4265,6 +4337,212 @@ TEST_F(HashJoinTest, dynamicFiltersWithSkippedSplits) {
 
 // Verify the size of the join output vectors when projecting build-side
 // variable-width column.
+TEST_F(HashJoinTest, bloomFilterDynamicFilters) {
+  const int32_t numSplits = 5;
+  const int32_t numRowsProbe = 4'000;
+  const int32_t numRowsBuild = 10'000;
+  const int32_t numKeys = 5;
+
+  // Random keys over the whole bigint domain make the hash table use kHash
+  // mode, so the keys can't be pushed down as ranges or value sets. The build
+  // side has the keys made from the even numbers in [0, 20'000), the probe
+  // side from all the numbers in [0, 20'000).
+  auto makeKey = [](int64_t value, int32_t column) -> int64_t {
+    return folly::hash::twang_mix64(value * numKeys + column);
+  };
+
+  std::vector<RowVectorPtr> probeVectors;
+  std::vector<std::shared_ptr<TempFilePath>> tempFiles;
+  std::vector<exec::Split> probeSplits;
+  for (int32_t i = 0; i < numSplits; ++i) {
+    std::vector<VectorPtr> columns;
+    for (auto column = 0; column < numKeys; ++column) {
+      columns.push_back(makeFlatVector<int64_t>(numRowsProbe, [&](auto row) {
+        return makeKey(i * numRowsProbe + row, column);
+      }));
+    }
+    probeVectors.push_back(makeRowVector(columns));
+    tempFiles.push_back(TempFilePath::create());
+    writeToFile(tempFiles.back()->path, probeVectors.back());
+    probeSplits.push_back(
+        exec::Split(makeHiveConnectorSplit(tempFiles.back()->path)));
+  }
+
+  std::vector<VectorPtr> buildColumns;
+  for (auto column = 0; column < numKeys; ++column) {
+    buildColumns.push_back(makeFlatVector<int64_t>(
+        numRowsBuild, [&](auto row) { return makeKey(2 * row, column); }));
+  }
+  std::vector<RowVectorPtr> buildVectors = {makeRowVector(buildColumns)};
+
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  auto probeType = asRowType(probeVectors[0]->type());
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto buildSide = PlanBuilder(planNodeIdGenerator)
+                       .values(buildVectors)
+                       .project(
+                           {"c0 AS u_c0",
+                            "c1 AS u_c1",
+                            "c2 AS u_c2",
+                            "c3 AS u_c3",
+                            "c4 AS u_c4"})
+                       .planNode();
+
+  // A single key is pushed down into the table scan.
+  {
+    core::PlanNodeId probeScanId;
+    auto op = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(probeType)
+                  .capturePlanNodeId(probeScanId)
+                  .hashJoin(
+                      {"c0"},
+                      {"u_c0"},
+                      buildSide,
+                      "",
+                      {"c0", "c1", "u_c1"},
+                      core::JoinType::kInner)
+                  .planNode();
+    SplitInput splits;
+    splits.emplace(probeScanId, probeSplits);
+
+    HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+        .planNode(std::move(op))
+        .inputSplits(splits)
+        .referenceQuery(
+            "SELECT t.c0, t.c1, u.c1 FROM t, u WHERE t.c0 = u.c0")
+        .verifier([&](const std::shared_ptr<Task>& task, bool hasSpill) {
+          SCOPED_TRACE(fmt::format("hasSpill:{}", hasSpill));
+          if (hasSpill) {
+            ASSERT_EQ(0, getFiltersProduced(task, 1).sum);
+            ASSERT_EQ(0, getFiltersAccepted(task, 0).sum);
+          } else {
+            ASSERT_EQ(1, getFiltersProduced(task, 1).sum);
+            ASSERT_EQ(1, getFiltersAccepted(task, 0).sum);
+            // The Bloom filter is not exact, so the join is not replaced.
+            ASSERT_EQ(0, getReplacedWithFilterRows(task, 1).sum);
+            ASSERT_LT(getInputPositions(task, 1), numRowsProbe * numSplits);
+          }
+        })
+        .run();
+  }
+
+  // Multiple keys are tested on the hash of the combined key before probing.
+  {
+    core::PlanNodeId probeScanId;
+    auto op = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(probeType)
+                  .capturePlanNodeId(probeScanId)
+                  .hashJoin(
+                      {"c0", "c1", "c2", "c3", "c4"},
+                      {"u_c0", "u_c1", "u_c2", "u_c3", "u_c4"},
+                      buildSide,
+                      "",
+                      {"c0", "c4", "u_c1"},
+                      core::JoinType::kInner)
+                  .planNode();
+    SplitInput splits;
+    splits.emplace(probeScanId, probeSplits);
+
+    HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+        .planNode(std::move(op))
+        .inputSplits(splits)
+        .referenceQuery(
+            "SELECT t.c0, t.c4, u.c1 FROM t, u WHERE t.c0 = u.c0 "
+            "AND t.c1 = u.c1 AND t.c2 = u.c2 AND t.c3 = u.c3 AND t.c4 = u.c4")
+        .verifier([&](const std::shared_ptr<Task>& task, bool /*hasSpill*/) {
+          ASSERT_EQ(0, getFiltersProduced(task, 1).sum);
+          // About half of the probe rows have no match.
+          ASSERT_GT(
+              getOperatorRuntimeStats(task, 1, "bloomFilterDroppedRows").sum,
+              numRowsProbe * numSplits / 4);
+        })
+        .run();
+  }
+}
+
+TEST_F(HashJoinTest, bucketedGroupedExecution) {
+  // Both sides are bucketed on the join key. Build bucket 'i' matches probe
+  // buckets 'i' and 'i + 2', so the join runs in two split groups, one per
+  // build bucket, without repartitioning.
+  constexpr int32_t kNumProbeBuckets = 4;
+  constexpr int32_t kNumBuildBuckets = 2;
+  std::vector<std::shared_ptr<TempFilePath>> tempFiles;
+  auto makeBucketSplits = [&](int32_t numBuckets,
+                              std::vector<RowVectorPtr>& vectors) {
+    std::vector<exec::Split> splits;
+    for (int32_t bucket = 0; bucket < numBuckets; ++bucket) {
+      vectors.push_back(makeRowVector({
+          makeFlatVector<int64_t>(
+              1'000, [&](auto row) { return row * numBuckets + bucket; }),
+          makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+      }));
+      tempFiles.push_back(TempFilePath::create());
+      writeToFile(tempFiles.back()->path, vectors.back());
+      splits.push_back(
+          exec::Split(HiveConnectorSplitBuilder(tempFiles.back()->path)
+                          .tableBucketNumber(bucket)
+                          .build()));
+    }
+    return splits;
+  };
+  std::vector<RowVectorPtr> probeVectors;
+  auto probeSplits = makeBucketSplits(kNumProbeBuckets, probeVectors);
+  std::vector<RowVectorPtr> buildVectors;
+  auto buildSplits = makeBucketSplits(kNumBuildBuckets, buildVectors);
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  auto rowType = ROW({"c0", "c1"}, {BIGINT(), BIGINT()});
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId probeScanId;
+  core::PlanNodeId buildScanId;
+  CursorParameters params;
+  params.planNode = PlanBuilder(planNodeIdGenerator)
+                        .tableScan(rowType)
+                        .capturePlanNodeId(probeScanId)
+                        .hashJoin(
+                            {"c0"},
+                            {"u0"},
+                            PlanBuilder(planNodeIdGenerator)
+                                .tableScan(rowType)
+                                .capturePlanNodeId(buildScanId)
+                                .project({"c0 AS u0", "c1 AS u1"})
+                                .planNode(),
+                            "",
+                            {"c0", "c1", "u1"})
+                        .planNode();
+  params.executionStrategy = core::ExecutionStrategy::kGrouped;
+  params.groupedExecutionLeafNodeIds = {probeScanId, buildScanId};
+  params.numSplitGroups = kNumBuildBuckets;
+  params.numConcurrentSplitGroups = 1;
+  params.maxDrivers = 2;
+
+  bool splitsAdded = false;
+  auto task = ::facebook::velox::exec::test::assertQuery(
+      params,
+      [&](Task* task) {
+        if (splitsAdded) {
+          return;
+        }
+        splitsAdded = true;
+        for (auto& split : probeSplits) {
+          task->addSplit(probeScanId, std::move(split));
+        }
+        for (auto& split : buildSplits) {
+          task->addSplit(buildScanId, std::move(split));
+        }
+        task->noMoreSplits(probeScanId);
+        task->noMoreSplits(buildScanId);
+      },
+      "SELECT t.c0, t.c1, u.c1 FROM t, u WHERE t.c0 = u.c0",
+      duckDbQueryRunner_);
+  EXPECT_EQ(
+      std::unordered_set<int32_t>({0, 1}),
+      task->taskStats().completedSplitGroups);
+}
+
 TEST_F(HashJoinTest, memoryUsage) {
   std::vector<RowVectorPtr> probeVectors =
       makeBatches(10, [&](int32_t /*unused*/) {
@@ -4366,6 +4644,86 @@ TEST_F(HashJoinTest, smallOutputBatchSize) {
       .run();
 }
 
+TEST_F(HashJoinTest, sharedBuild) {
+  std::vector<RowVectorPtr> probeVectors =
+      makeBatches(10, [&](int32_t /*unused*/) {
+        return makeRowVector(
+            {makeFlatVector<int32_t>(1'000, [](auto row) { return row % 5; })});
+      });
+  std::vector<RowVectorPtr> buildVectors =
+      makeBatches(2, [&](int32_t /*unused*/) {
+        return makeRowVector(
+            {"u_c0", "u_c1"},
+            {makeFlatVector<int32_t>({0, 1, 2}),
+             makeFlatVector<int32_t>({10, 20, 30})});
+      });
+  core::PlanNodeId joinNodeId;
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .values(probeVectors)
+                  .hashJoin(
+                      {"c0"},
+                      {"u_c0"},
+                      PlanBuilder(planNodeIdGenerator)
+                          .values(buildVectors)
+                          .planNode(),
+                      "",
+                      {"c0", "u_c1"})
+                  .capturePlanNodeId(joinNodeId)
+                  .singleAggregation({}, {"count(1)"})
+                  .planFragment();
+
+  auto queryCtx = std::make_shared<core::QueryCtx>(driverExecutor_.get());
+  queryCtx->setConfigOverridesUnsafe(
+      {{core::QueryConfig::kHashJoinBuildSharingEnabled, "true"}});
+
+  // Blocks the output of the first task until the second task has finished so
+  // that the first task is alive when the second task starts.
+  ContinuePromise outputPromise("HashJoinTest::sharedBuild");
+  auto outputFuture = outputPromise.getSemiFuture();
+  std::mutex mutex;
+  std::vector<RowVectorPtr> results;
+  auto makeTask = [&](const std::string& taskId, bool blockOutput) {
+    return std::make_shared<Task>(
+        taskId,
+        plan,
+        0,
+        queryCtx,
+        [&, blockOutput](RowVectorPtr output, ContinueFuture* future) {
+          if (output == nullptr) {
+            return BlockingReason::kNotBlocked;
+          }
+          {
+            std::lock_guard<std::mutex> l(mutex);
+            results.push_back(output);
+          }
+          if (blockOutput && outputFuture.valid()) {
+            *future = std::move(outputFuture);
+            return BlockingReason::kWaitForConsumer;
+          }
+          return BlockingReason::kNotBlocked;
+        });
+  };
+  auto builderTask = makeTask("sharedBuild.0", true);
+  auto task = makeTask("sharedBuild.1", false);
+  Task::start(builderTask, 1);
+  Task::start(task, 1);
+  ASSERT_TRUE(waitForTaskCompletion(task.get(), 5'000'000));
+  outputPromise.setValue();
+  ASSERT_TRUE(waitForTaskCompletion(builderTask.get(), 5'000'000));
+
+  ASSERT_EQ(results.size(), 2);
+  for (const auto& result : results) {
+    ASSERT_EQ(result->childAt(0)->asFlatVector<int64_t>()->valueAt(0), 12'000);
+  }
+  auto builderStats = toPlanStats(builderTask->taskStats());
+  ASSERT_EQ(
+      builderStats.at(joinNodeId).customStats.count("sharedHashTable"), 0);
+  auto planStats = toPlanStats(task->taskStats());
+  ASSERT_EQ(planStats.at(joinNodeId).customStats.at("sharedHashTable").sum, 1);
+}
+
 TEST_F(HashJoinTest, spillFileSize) {
   const std::vector<uint64_t> maxSpillFileSizes({0, 1, 1'000'000'000});
   for (const auto spillFileSize : maxSpillFileSizes) {
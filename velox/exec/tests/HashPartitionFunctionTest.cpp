@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <folly/Random.h>
+
 #include "velox/exec/HashPartitionFunction.h"
 #include "velox/vector/tests/utils/VectorTestBase.h"
 
@@ -114,3 +116,53 @@ TEST_F(HashPartitionFunctionTest, HashPartitionFunction) {
     EXPECT_EQ(4, functionWithBits2.numPartitions());
   }
 }
+
+TEST_F(HashPartitionFunctionTest, fastModulo) {
+  folly::Random::DefaultGenerator rng(1);
+  for (uint32_t divisor :
+       {1u, 2u, 3u, 7u, 64u, 1'000u, 1'023u, 65'537u, 0x7fffffffu, ~0u}) {
+    FastModulo modulo(divisor);
+    for (auto i = 0; i < 10'000; ++i) {
+      const uint64_t x = i < 100 ? ~0ULL - i : folly::Random::rand64(rng);
+      ASSERT_EQ(modulo(x), x % divisor) << x << " % " << divisor;
+    }
+  }
+}
+
+TEST_F(HashPartitionFunctionTest, spreadHeavyHitters) {
+  const int numRows = 10'000;
+  const int numPartitions = 4;
+  // Half the rows have key 7 and the other keys are unique.
+  RowVectorPtr vector = makeRowVector({makeFlatVector<int32_t>(
+      numRows, [](auto row) { return row % 2 == 0 ? 7 : row; })});
+  RowTypePtr rowType = asRowType(vector->type());
+
+  std::vector<uint32_t> partitions(numRows);
+  HashPartitionFunction function(numPartitions, rowType, {0});
+  function.partition(*vector, partitions);
+  EXPECT_EQ(0, function.numHeavyHitters());
+
+  std::vector<uint32_t> spreadPartitions(numRows);
+  HashPartitionFunction spreadFunction(numPartitions, rowType, {0}, {}, true);
+  spreadFunction.partition(*vector, spreadPartitions);
+  EXPECT_EQ(1, spreadFunction.numHeavyHitters());
+
+  std::vector<int32_t> heavyHitterCounts(numPartitions, 0);
+  for (auto i = 0; i < numRows; ++i) {
+    if (i % 2 == 0) {
+      ++heavyHitterCounts[spreadPartitions[i]];
+    } else {
+      EXPECT_EQ(partitions[i], spreadPartitions[i]);
+    }
+  }
+  for (auto count : heavyHitterCounts) {
+    EXPECT_EQ(numRows / 2 / numPartitions, count);
+  }
+
+  // No heavy hitters are detected before kNumSampleRows rows are sampled.
+  HashPartitionFunction smallFunction(numPartitions, rowType, {0}, {}, true);
+  auto smallVector = makeRowVector({makeFlatVector<int32_t>(
+      100, [](auto /*row*/) { return 7; })});
+  smallFunction.partition(*smallVector, spreadPartitions);
+  EXPECT_EQ(0, smallFunction.numHeavyHitters());
+}
@@ -92,6 +92,12 @@ class HashTableTest : public testing::TestWithParam<bool> {
       startOffset += size;
     }
     topTable_->prepareJoinTable(std::move(otherTables), executor_.get());
+    if (prefetchProbe_) {
+      topTable_->testingSetMinBytesForPrefetchProbe(0);
+    }
+    if (partitionedProbe_) {
+      topTable_->testingSetPartitionedProbe(0, 1024);
+    }
     EXPECT_EQ(topTable_->hashMode(), mode);
     LOG(INFO) << "Made table " << describeTable();
     testProbe();
@@ -454,6 +460,11 @@ class HashTableTest : public testing::TestWithParam<bool> {
   // Spacing between consecutive generated keys. Affects whether
   // Vectorhashers make ranges or ids of distinct values.
   int64_t keySpacing_ = 1;
+  // If true, the join probe prefetches regardless of the table size.
+  bool prefetchProbe_ = false;
+  // If true, the join probe partitions the rows by 1KB ranges of the table
+  // regardless of the table size.
+  bool partitionedProbe_ = false;
   std::unique_ptr<folly::CPUThreadPoolExecutor> executor_;
 };
 
@@ -506,6 +517,42 @@ TEST_P(HashTableTest, mixed6Sparse) {
   testCycle(BaseHashTable::HashMode::kHash, 100000, 9, type, 6);
 }
 
+TEST_P(HashTableTest, prefetchProbeNormalized) {
+  auto type = ROW({"k1", "k2"}, {BIGINT(), BIGINT()});
+  keySpacing_ = 1000;
+  insertPct_ = 50;
+  prefetchProbe_ = true;
+  testCycle(BaseHashTable::HashMode::kNormalizedKey, 10000, 2, type, 2);
+}
+
+TEST_P(HashTableTest, prefetchProbeHash) {
+  auto type =
+      ROW({"k1", "k2", "k3", "k4", "k5", "k6"},
+          {BIGINT(), BIGINT(), BIGINT(), BIGINT(), BIGINT(), VARCHAR()});
+  keySpacing_ = 1000;
+  insertPct_ = 50;
+  prefetchProbe_ = true;
+  testCycle(BaseHashTable::HashMode::kHash, 10000, 3, type, 6);
+}
+
+TEST_P(HashTableTest, partitionedProbeNormalized) {
+  auto type = ROW({"k1", "k2"}, {BIGINT(), BIGINT()});
+  keySpacing_ = 1000;
+  insertPct_ = 50;
+  partitionedProbe_ = true;
+  testCycle(BaseHashTable::HashMode::kNormalizedKey, 10000, 2, type, 2);
+}
+
+TEST_P(HashTableTest, partitionedProbeHash) {
+  auto type =
+      ROW({"k1", "k2", "k3", "k4", "k5", "k6"},
+          {BIGINT(), BIGINT(), BIGINT(), BIGINT(), BIGINT(), VARCHAR()});
+  keySpacing_ = 1000;
+  insertPct_ = 50;
+  partitionedProbe_ = true;
+  testCycle(BaseHashTable::HashMode::kHash, 10000, 3, type, 6);
+}
+
 // It should be safe to call clear() before we insert any data into HashTable
 TEST_P(HashTableTest, clear) {
   std::vector<std::unique_ptr<VectorHasher>> keyHashers;
@@ -717,6 +764,61 @@ TEST_P(HashTableTest, checkSizeValidation) {
   ASSERT_EQ(table->capacity(), 512 << 10);
 }
 
+TEST_P(HashTableTest, partitionedGroupBy) {
+  auto rowType = ROW({"a"}, {BIGINT()});
+  auto table = createHashTableForAggregation(rowType, 1);
+  table->testingSetMinBytesForPartitionedGroupBy(0);
+  auto lookup = std::make_unique<HashLookup>(table->hashers());
+
+  // Partitions of 2K entries each.
+  table->testingSetHashMode(BaseHashTable::HashMode::kHash, 0);
+  ASSERT_EQ(table->numGroupByPartitions(), 16);
+  ASSERT_EQ(table->capacity(), 32 << 10);
+
+  constexpr int32_t kBatchSize = 10'000;
+  constexpr int32_t kNumBatches = 20;
+  std::vector<RowVectorPtr> batches;
+  std::vector<char*> allInserted;
+  for (auto i = 0; i < kNumBatches; ++i) {
+    batches.push_back(
+        vectorMaker_->rowVector({vectorMaker_->flatVector<int64_t>(
+            kBatchSize, [&](auto row) { return i * kBatchSize + row; })}));
+    insertGroups(*batches.back(), *lookup, *table);
+    ASSERT_EQ(lookup->newGroups.size(), kBatchSize);
+    allInserted.insert(
+        allInserted.end(), lookup->hits.begin(), lookup->hits.end());
+  }
+  // Each partition grows by itself, so there is at least one rehash per
+  // partition.
+  ASSERT_EQ(table->numDistinct(), kBatchSize * kNumBatches);
+  ASSERT_GE(table->capacity(), table->numDistinct());
+  ASSERT_GE(table->stats().numRehashes, 16);
+  table->checkConsistency();
+
+  // Existing keys are found after the rehashes.
+  for (auto i = 0; i < kNumBatches; ++i) {
+    insertGroups(*batches[i], *lookup, *table);
+    ASSERT_TRUE(lookup->newGroups.empty());
+    for (auto row = 0; row < kBatchSize; ++row) {
+      ASSERT_EQ(lookup->hits[row], allInserted[i * kBatchSize + row]);
+    }
+  }
+
+  // Erases the first half of the groups and inserts them again.
+  const auto numErased = allInserted.size() / 2;
+  table->erase(folly::Range<char**>(allInserted.data(), numErased));
+  ASSERT_EQ(table->numDistinct(), allInserted.size() - numErased);
+  table->checkConsistency();
+  insertGroups(*batches[0], *lookup, *table);
+  ASSERT_EQ(lookup->newGroups.size(), kBatchSize);
+  table->checkConsistency();
+
+  table->clear();
+  ASSERT_EQ(table->numDistinct(), 0);
+  ASSERT_EQ(table->numGroupByPartitions(), 16);
+  table->checkConsistency();
+}
+
 VELOX_INSTANTIATE_TEST_SUITE_P(
     HashTableTests,
     HashTableTest,
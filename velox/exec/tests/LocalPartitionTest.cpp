@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/LocalPartition.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
@@ -367,6 +368,37 @@ TEST_F(LocalPartitionTest, earlyCompletion) {
   assertTaskReferenceCount(task, 1);
 }
 
+TEST_F(LocalPartitionTest, earlyCompletionStopsProducers) {
+  std::vector<RowVectorPtr> data = {
+      makeRowVector({makeFlatSequence(3, 100)}),
+  };
+  constexpr int32_t kRepeatTimes = 10'000;
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .localPartition(
+                      {},
+                      {PlanBuilder(planNodeIdGenerator)
+                           .values(data, false, kRepeatTimes)
+                           .planNode()})
+                  .limit(0, 2, false)
+                  .planNode();
+
+  // A low buffer limit makes the producer wait for the consumer, which
+  // closes the queue after the Limit is satisfied.
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .config(core::QueryConfig::kMaxLocalExchangeBufferSize, "100")
+                  .assertResults("VALUES (3), (4)");
+
+  // The producer finishes without producing all of its data.
+  const auto& producerStats =
+      task->taskStats().pipelineStats[1].operatorStats.front();
+  ASSERT_EQ(producerStats.operatorType, "Values");
+  ASSERT_LT(producerStats.outputPositions, 100 * kRepeatTimes);
+
+  assertTaskReferenceCount(task, 1);
+}
+
 TEST_F(LocalPartitionTest, earlyCancelation) {
   std::vector<RowVectorPtr> data = {
       makeRowVector({makeFlatSequence(3, 100)}),
@@ -509,3 +541,159 @@ TEST_F(LocalPartitionTest, unionAllLocalExchange) {
       "   SELECT * FROM (VALUES ('y')) as t2(c0)"
       ")");
 }
+
+TEST_F(LocalPartitionTest, spreadHeavyHitters) {
+  // Most probe rows have key 0.
+  std::vector<RowVectorPtr> probeVectors;
+  for (auto i = 0; i < 10; ++i) {
+    probeVectors.push_back(makeRowVector(
+        {"c0", "c1"},
+        {makeFlatVector<int32_t>(
+             1'000, [](auto row) { return row % 10 == 0 ? row : 0; }),
+         makeFlatSequence<int64_t>(i * 1'000, 1'000)}));
+  }
+  auto buildVector = makeRowVector(
+      {"u0", "u1"},
+      {makeFlatSequence<int32_t>(0, 100), makeFlatSequence<int64_t>(0, 100)});
+
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", {buildVector});
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto op = PlanBuilder(planNodeIdGenerator)
+                .values(probeVectors)
+                .localPartitionSpreadHeavyHitters({"c0"})
+                .hashJoin(
+                    {"c0"},
+                    {"u0"},
+                    PlanBuilder(planNodeIdGenerator)
+                        .values({buildVector})
+                        .planNode(),
+                    "",
+                    {"c0", "c1", "u1"})
+                .planNode();
+
+  AssertQueryBuilder(op, duckDbQueryRunner_)
+      .maxDrivers(4)
+      .assertResults("SELECT c0, c1, u1 FROM t, u WHERE c0 = u0");
+}
+
+TEST_F(LocalPartitionTest, memoryManager) {
+  exec::LocalExchangeMemoryManager manager(100);
+  auto future = ContinueFuture::makeEmpty();
+  ASSERT_FALSE(manager.increaseMemoryUsage(&future, 60));
+  ASSERT_TRUE(manager.increaseMemoryUsage(&future, 60));
+  ASSERT_FALSE(future.isReady());
+
+  // Staying at or over the limit keeps the producer blocked.
+  ASSERT_TRUE(manager.decreaseMemoryUsage(20).empty());
+  auto promises = manager.decreaseMemoryUsage(20);
+  ASSERT_EQ(promises.size(), 1);
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+  ASSERT_TRUE(future.isReady());
+  ASSERT_EQ(manager.bufferedBytes(), 80);
+
+  // Concurrent producers and consumers end up with no buffered bytes and no
+  // blocked producer.
+  constexpr int32_t kNumThreads = 8;
+  constexpr int32_t kNumUpdates = 10'000;
+  manager.decreaseMemoryUsage(80);
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&]() {
+      for (auto j = 0; j < kNumUpdates; ++j) {
+        auto blocked = ContinueFuture::makeEmpty();
+        manager.increaseMemoryUsage(&blocked, 30);
+        for (auto& promise : manager.decreaseMemoryUsage(30)) {
+          promise.setValue();
+        }
+        if (blocked.valid()) {
+          blocked.wait();
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(manager.bufferedBytes(), 0);
+}
+
+TEST_F(LocalPartitionTest, coalesceBatches) {
+  auto memoryManager = std::make_shared<exec::LocalExchangeMemoryManager>(
+      std::numeric_limits<int64_t>::max());
+  exec::LocalExchangeQueue queue(memoryManager, 0);
+  queue.addProducer();
+  queue.noMoreProducers();
+  ContinueFuture future;
+  for (auto i = 0; i < 3; ++i) {
+    ASSERT_EQ(
+        queue.enqueue(
+            makeRowVector({makeFlatSequence<int32_t>(i * 10, 10)}), &future),
+        exec::BlockingReason::kNotBlocked);
+  }
+
+  // Takes the queued vectors while they fit in the limit.
+  std::vector<RowVectorPtr> batches;
+  ASSERT_EQ(
+      queue.next(&future, 25, batches), exec::BlockingReason::kNotBlocked);
+  ASSERT_EQ(batches.size(), 2);
+  queue.noMoreData();
+  ASSERT_EQ(
+      queue.next(&future, 25, batches), exec::BlockingReason::kNotBlocked);
+  ASSERT_EQ(batches.size(), 1);
+  ASSERT_EQ(
+      queue.next(&future, 25, batches), exec::BlockingReason::kNotBlocked);
+  ASSERT_TRUE(batches.empty());
+  ASSERT_TRUE(queue.isFinished());
+  ASSERT_EQ(memoryManager->bufferedBytes(), 0);
+
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector(
+        {makeFlatSequence<int32_t>(i * 100, 100),
+         makeFlatVector<std::string>(
+             100, [](auto row) { return fmt::format("{}", row); })}));
+  }
+  createDuckDbTable(vectors);
+  auto plan = PlanBuilder()
+                  .values(vectors, true)
+                  .localPartition({"c0"})
+                  .planNode();
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .maxDrivers(4)
+      .config(core::QueryConfig::kLocalExchangeCoalesceBatches, "true")
+      .assertResults("SELECT * FROM tmp UNION ALL SELECT * FROM tmp "
+                     "UNION ALL SELECT * FROM tmp UNION ALL SELECT * FROM tmp");
+}
+
+TEST_F(LocalPartitionTest, scaleWriterState) {
+  auto memoryManager = std::make_shared<exec::LocalExchangeMemoryManager>(100);
+  exec::ScaleWriterState state(memoryManager, 3, 10);
+
+  // Nothing is buffered, so the single writer keeps up.
+  for (auto i = 0; i < 5; ++i) {
+    ASSERT_EQ(state.nextWriter(20), 0);
+  }
+  ASSERT_EQ(state.numActiveWriters(), 1);
+
+  // With half of the buffer used, a writer is added per 'minProcessedBytes'
+  // sent to each active writer.
+  auto future = ContinueFuture::makeEmpty();
+  ASSERT_FALSE(memoryManager->increaseMemoryUsage(&future, 50));
+  state.nextWriter(20);
+  ASSERT_EQ(state.numActiveWriters(), 2);
+  state.nextWriter(10);
+  ASSERT_EQ(state.numActiveWriters(), 2);
+  std::set<int> writers;
+  writers.insert(state.nextWriter(10));
+  ASSERT_EQ(state.numActiveWriters(), 3);
+  for (auto i = 0; i < 10; ++i) {
+    writers.insert(state.nextWriter(100));
+  }
+  ASSERT_EQ(state.numActiveWriters(), 3);
+  ASSERT_EQ(writers, std::set<int>({0, 1, 2}));
+  memoryManager->decreaseMemoryUsage(50);
+}
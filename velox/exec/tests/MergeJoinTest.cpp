@@ -203,6 +203,19 @@ TEST_F(MergeJoinTest, duplicateMatch) {
       [](auto row) { return row / 2; }, [](auto row) { return row / 3; });
 }
 
+TEST_F(MergeJoinTest, longNonMatchingRuns) {
+  // Stretches of 100 keys on each side that have no match on the other side
+  // alternate with stretches of 20 matching keys.
+  testJoin<int32_t>(
+      [](auto row) { return (row / 120) * 240 + row % 120; },
+      [](auto row) { return (row / 120) * 240 + 100 + row % 120; });
+}
+
+TEST_F(MergeJoinTest, manyToOneMatch) {
+  testJoin<int32_t>(
+      [](auto row) { return row / 37; }, [](auto row) { return row; });
+}
+
 TEST_F(MergeJoinTest, allRowsMatch) {
   std::vector<VectorPtr> leftKeys = {
       makeFlatVector<int32_t>(2, [](auto /* row */) { return 5; }),
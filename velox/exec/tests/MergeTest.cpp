@@ -182,3 +182,42 @@ TEST_F(MergeTest, offByOne) {
       {{core::QueryConfig::kPreferredOutputBatchSize, "6"}});
   assertQueryOrdered(params, "VALUES (0), (1), (2), (3), (4), (5), (10)", {0});
 }
+
+/// Verifies merging of sources whose rows come in long runs that are taken
+/// from one source at a time, including runs that cross output batches and
+/// runs that end on keys equal to the first key of another source.
+TEST_F(MergeTest, runs) {
+  constexpr vector_size_t kSize = 1'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 3; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            kSize,
+            [&](auto row) {
+              return i == 2 ? row * 3 / 7 * 10
+                            : (row / 50) * 100 + i * 50 + row % 50;
+            }),
+        makeFlatVector<int32_t>(kSize, [&](auto /*row*/) { return i; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  std::vector<std::shared_ptr<const core::PlanNode>> sources;
+  for (const auto& vector : vectors) {
+    sources.push_back(
+        PlanBuilder(planNodeIdGenerator).values({vector}).planNode());
+  }
+
+  for (const auto* batchSize : {"17", "1000"}) {
+    SCOPED_TRACE(batchSize);
+    CursorParameters params;
+    params.planNode = PlanBuilder(planNodeIdGenerator)
+                          .localMerge({"c0"}, sources)
+                          .planNode();
+    params.queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+    params.queryCtx->setConfigOverridesUnsafe(
+        {{core::QueryConfig::kPreferredOutputBatchSize, batchSize}});
+    assertQueryOrdered(params, "SELECT * FROM tmp ORDER BY c0", {0});
+  }
+}
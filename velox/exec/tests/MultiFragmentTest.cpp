@@ -26,6 +26,7 @@
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/serializers/PrestoSerializer.h"
 
 using namespace facebook::velox;
 using namespace facebook::velox::exec;
@@ -101,7 +102,7 @@ class MultiFragmentTest : public HiveConnectorTestBase {
     task->noMoreSplits("0");
   }
 
-  void assertQuery(
+  std::shared_ptr<Task> assertQuery(
       const std::shared_ptr<const core::PlanNode>& plan,
       const std::vector<std::string>& remoteTaskIds,
       const std::string& duckDbSql,
@@ -110,7 +111,7 @@ class MultiFragmentTest : public HiveConnectorTestBase {
     for (auto& taskId : remoteTaskIds) {
       splits.push_back(std::make_shared<RemoteConnectorSplit>(taskId));
     }
-    OperatorTestBase::assertQuery(plan, splits, duckDbSql, sortingKeys);
+    return OperatorTestBase::assertQuery(plan, splits, duckDbSql, sortingKeys);
   }
 
   void assertQueryOrdered(
@@ -454,6 +455,114 @@ TEST_F(MultiFragmentTest, partitionedOutput) {
   }
 }
 
+TEST_F(MultiFragmentTest, compression) {
+  setupSources(10, 1000);
+  for (const auto& codec : {"lz4", "zstd"}) {
+    SCOPED_TRACE(codec);
+    if (!folly::io::hasCodec(
+            serializer::presto::PrestoVectorSerde::compressionKindFromName(
+                codec))) {
+      continue;
+    }
+    configSettings_[core::QueryConfig::kExchangeCompressionCodec] = codec;
+
+    auto leafTaskId = makeTaskId("leaf", 0);
+    core::PlanNodeId partitionedOutputId;
+    auto leafPlan = PlanBuilder()
+                        .values(vectors_)
+                        .partitionedOutput({}, 1)
+                        .capturePlanNodeId(partitionedOutputId)
+                        .planNode();
+    auto leafTask = makeTask(leafTaskId, leafPlan, 0);
+    Task::start(leafTask, 4);
+
+    // The consumer must use the same codec to read the compressed pages.
+    CursorParameters params;
+    params.planNode =
+        PlanBuilder().exchange(leafPlan->outputType()).planNode();
+    params.queryCtx = std::make_shared<core::QueryCtx>(
+        executor_.get(), std::make_shared<core::MemConfig>(configSettings_));
+    test::assertQuery(
+        params,
+        [&](Task* task) {
+          task->addSplit(
+              "0",
+              exec::Split(
+                  std::make_shared<RemoteConnectorSplit>(leafTaskId), -1));
+          task->noMoreSplits("0");
+        },
+        "SELECT * FROM tmp",
+        duckDbQueryRunner_);
+    ASSERT_TRUE(waitForTaskCompletion(leafTask.get())) << leafTask->taskId();
+
+    const auto& customStats = toPlanStats(leafTask->taskStats())
+                                  .at(partitionedOutputId)
+                                  .customStats;
+    ASSERT_GT(
+        customStats
+            .at(serializer::presto::PrestoVectorSerde::kCompressionInputBytes)
+            .sum,
+        0);
+  }
+  configSettings_.clear();
+}
+
+TEST_F(MultiFragmentTest, exchangeFlowControlStats) {
+  setupSources(10, 1000);
+  std::vector<std::string> leafTaskIds;
+  for (int i = 0; i < 4; ++i) {
+    leafTaskIds.push_back(makeTaskId("leaf", i));
+    auto leafPlan =
+        PlanBuilder().values(vectors_).partitionedOutput({}, 1).planNode();
+    auto leafTask = makeTask(leafTaskIds.back(), leafPlan, i);
+    Task::start(leafTask, 1);
+  }
+
+  core::PlanNodeId exchangeId;
+  auto op = PlanBuilder()
+                .exchange(asRowType(vectors_[0]->type()))
+                .capturePlanNodeId(exchangeId)
+                .planNode();
+  auto task = assertQuery(
+      op,
+      leafTaskIds,
+      "SELECT * FROM tmp UNION ALL SELECT * FROM tmp "
+      "UNION ALL SELECT * FROM tmp UNION ALL SELECT * FROM tmp");
+
+  const auto& runtimeStats =
+      toPlanStats(task->taskStats()).at(exchangeId).customStats;
+  const auto& requestBytes = runtimeStats.at("exchangeRequestBytes");
+  ASSERT_GT(requestBytes.count, 0);
+  ASSERT_GE(requestBytes.min, ExchangeClient::kMinRequestBytes);
+  ASSERT_LE(requestBytes.max, ExchangeClient::kMaxRequestBytes);
+  ASSERT_EQ(runtimeStats.count("exchangePrefetchBytes"), 1);
+}
+
+TEST_F(MultiFragmentTest, colocatedTasks) {
+  setupSources(10, 1000);
+  // The producer ids are not 'local://' ids, so only the shortcut for tasks
+  // in the same process can serve them.
+  const std::string leafTaskId = "colocated-leaf-0";
+  auto leafPlan =
+      PlanBuilder().values(vectors_).partitionedOutput({}, 1).planNode();
+  auto leafTask = makeTask(leafTaskId, leafPlan, 0);
+  Task::start(leafTask, 1);
+
+  const std::string urlTaskId = "colocated-leaf-1";
+  auto urlLeafTask = makeTask(urlTaskId, leafPlan, 1);
+  Task::start(urlLeafTask, 1);
+
+  auto op = PlanBuilder().exchange(leafPlan->outputType()).planNode();
+  assertQuery(
+      op,
+      {leafTaskId,
+       fmt::format("http://localhost:8080/v1/task/{}/results", urlTaskId)},
+      "SELECT * FROM tmp UNION ALL SELECT * FROM tmp");
+  ASSERT_TRUE(waitForTaskCompletion(leafTask.get())) << leafTask->taskId();
+  ASSERT_TRUE(waitForTaskCompletion(urlLeafTask.get()))
+      << urlLeafTask->taskId();
+}
+
 TEST_F(MultiFragmentTest, broadcast) {
   auto data = makeRowVector(
       {makeFlatVector<int32_t>(1'000, [](auto row) { return row; })});
@@ -500,6 +609,47 @@ TEST_F(MultiFragmentTest, broadcast) {
   leafTask->updateBroadcastOutputBuffers(finalAggTaskIds.size(), true);
 }
 
+TEST_F(MultiFragmentTest, roundRobinPartitionedOutput) {
+  auto data = makeRowVector(
+      {makeFlatVector<int32_t>(1'000, [](auto row) { return row; })});
+
+  // Make leaf task: Values -> Repartitioning (3-way round-robin)
+  std::vector<std::shared_ptr<Task>> tasks;
+  auto leafTaskId = makeTaskId("leaf", 0);
+  auto leafPlan = PlanBuilder()
+                      .values({data})
+                      .partitionedOutputRoundRobin(3)
+                      .planNode();
+  auto leafTask = makeTask(leafTaskId, leafPlan, 0);
+  tasks.emplace_back(leafTask);
+  Task::start(leafTask, 1);
+
+  // Make next stage tasks to count the rows of each partition.
+  core::PlanNodePtr finalAggPlan;
+  std::vector<std::string> finalAggTaskIds;
+  for (int i = 0; i < 3; i++) {
+    finalAggPlan = PlanBuilder()
+                       .exchange(leafPlan->outputType())
+                       .singleAggregation({}, {"count(1)"})
+                       .partitionedOutput({}, 1)
+                       .planNode();
+
+    finalAggTaskIds.push_back(makeTaskId("final-agg", i));
+    auto task = makeTask(finalAggTaskIds.back(), finalAggPlan, i);
+    tasks.emplace_back(task);
+    Task::start(task, 1);
+    addRemoteSplits(task, {leafTaskId});
+  }
+
+  // The rows are spread evenly regardless of their values.
+  auto op = PlanBuilder().exchange(finalAggPlan->outputType()).planNode();
+  assertQuery(op, finalAggTaskIds, "SELECT UNNEST(array[334, 333, 333])");
+
+  for (auto& task : tasks) {
+    ASSERT_TRUE(waitForTaskCompletion(task.get())) << task->taskId();
+  }
+}
+
 TEST_F(MultiFragmentTest, replicateNullsAndAny) {
   auto data = makeRowVector({makeFlatVector<int32_t>(
       1'000, [](auto row) { return row; }, nullEvery(7))});
@@ -13,6 +13,9 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <folly/executors/CPUThreadPoolExecutor.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/file/FileSystems.h"
 #include "velox/core/QueryConfig.h"
 #include "velox/exec/PlanNodeStats.h"
@@ -289,6 +292,91 @@ TEST_F(OrderByTest, multipleKeys) {
       {0, 1});
 }
 
+TEST_F(OrderByTest, fixedWidthKeys) {
+  // Enough rows to radix sort on floating point and date keys with ties.
+  vector_size_t batchSize = 1000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 3; ++i) {
+    auto c0 = makeFlatVector<double>(
+        batchSize,
+        [](vector_size_t row) { return (row % 37) * -1.5 + 20; },
+        nullEvery(13));
+    auto c1 = makeFlatVector<Date>(
+        batchSize,
+        [](vector_size_t row) { return Date(row * 17 % 500 - 250); },
+        nullEvery(11));
+    auto c2 = makeFlatVector<int64_t>(
+        batchSize, [&](vector_size_t row) { return batchSize * i + row; });
+    vectors.push_back(makeRowVector({c0, c1, c2}));
+  }
+  createDuckDbTable(vectors);
+
+  testSingleKey(vectors, "c2");
+  testTwoKeys(vectors, "c0", "c2");
+  testTwoKeys(vectors, "c1", "c2");
+}
+
+TEST_F(OrderByTest, parallelSort) {
+  vector_size_t batchSize = 10'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 5; ++i) {
+    auto c0 = makeFlatVector<int64_t>(
+        batchSize, [](vector_size_t row) { return row % 1'001; }, nullEvery(7));
+    auto c1 = makeFlatVector<double>(
+        batchSize, [&](vector_size_t row) { return (row + i) * 0.1; });
+    auto c2 = makeFlatVector<StringView>(
+        batchSize,
+        [](vector_size_t row) {
+          return StringView::makeInline(std::to_string(row % 313));
+        },
+        nullEvery(11));
+    vectors.push_back(makeRowVector({c0, c1, c2}));
+  }
+  createDuckDbTable(vectors);
+
+  struct {
+    std::vector<std::string> keys;
+    std::string duckDbOrderBy;
+    std::vector<uint32_t> keyIndices;
+  } testSettings[] = {
+      {{"c0 ASC NULLS LAST", "c1 DESC NULLS FIRST"},
+       "c0 NULLS LAST, c1 DESC NULLS FIRST",
+       {0, 1}},
+      {{"c2 DESC NULLS LAST", "c1 ASC NULLS LAST"},
+       "c2 DESC NULLS LAST, c1 NULLS LAST",
+       {2, 1}}};
+  for (const auto& testData : testSettings) {
+    for (const auto numRuns : {0, 3, 64}) {
+      SCOPED_TRACE(fmt::format(
+          "keys: {} numRuns: {}", testData.duckDbOrderBy, numRuns));
+      core::PlanNodeId orderById;
+      auto task =
+          AssertQueryBuilder(duckDbQueryRunner_)
+              .config(
+                  QueryConfig::kOrderByParallelSortRuns,
+                  std::to_string(numRuns))
+              .plan(PlanBuilder()
+                        .values(vectors)
+                        .orderBy(testData.keys, false)
+                        .capturePlanNodeId(orderById)
+                        .planNode())
+              .assertResults(
+                  fmt::format(
+                      "SELECT * FROM tmp ORDER BY {}", testData.duckDbOrderBy),
+                  testData.keyIndices);
+      const auto& runtimeStats =
+          toPlanStats(task->taskStats()).at(orderById).customStats;
+      if (numRuns == 0) {
+        EXPECT_EQ(0, runtimeStats.count("numParallelSortRuns"));
+      } else {
+        // There are at most 5 runs of at least 10'000 rows each.
+        EXPECT_EQ(
+            std::min(numRuns, 5), runtimeStats.at("numParallelSortRuns").max);
+      }
+    }
+  }
+}
+
 TEST_F(OrderByTest, multiBatchResult) {
   vector_size_t batchSize = 5000;
   std::vector<RowVectorPtr> vectors;
@@ -457,6 +545,54 @@ TEST_F(OrderByTest, spill) {
   OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
 }
 
+TEST_F(OrderByTest, spillLimit) {
+  std::vector<RowVectorPtr> batches;
+  for (int i = 0; i < 10; ++i) {
+    batches.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(1'000, [&](auto row) { return row * 10 + i; }),
+         makeFlatVector<StringView>(1'000, [](auto row) {
+           return StringView::makeInline(std::to_string(row));
+         })}));
+  }
+  createDuckDbTable(batches);
+  auto plan = PlanBuilder()
+                  .values(batches)
+                  .orderBy({"c0 ASC NULLS LAST"}, false)
+                  .planNode();
+  const auto makeQueryCtx = [&](const std::string& maxSpillBytes) {
+    auto queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+    queryCtx->setConfigOverridesUnsafe({
+        {core::QueryConfig::kTestingSpillPct, "100"},
+        {core::QueryConfig::kSpillEnabled, "true"},
+        {core::QueryConfig::kOrderBySpillEnabled, "true"},
+        {core::QueryConfig::kMaxSpillBytes, maxSpillBytes},
+    });
+    return queryCtx;
+  };
+
+  {
+    auto spillDirectory = exec::test::TempDirectoryPath::create();
+    auto queryCtx = makeQueryCtx(std::to_string(1LL << 30));
+    CursorParameters params;
+    params.planNode = plan;
+    params.queryCtx = queryCtx;
+    params.spillDirectory = spillDirectory->path;
+    auto task = assertQueryOrdered(
+        params, "SELECT * FROM tmp ORDER BY c0 ASC NULLS LAST", {0});
+    ASSERT_LT(0, spilledStats(*task).spilledBytes);
+    ASSERT_EQ(queryCtx->spilledBytes(), spilledStats(*task).spilledBytes);
+    OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+  }
+
+  auto spillDirectory = exec::test::TempDirectoryPath::create();
+  VELOX_ASSERT_THROW(
+      AssertQueryBuilder(plan)
+          .queryCtx(makeQueryCtx("1024"))
+          .spillDirectory(spillDirectory->path)
+          .copyResults(pool()),
+      "Query exceeded its spill limit of 1.00KB");
+}
+
 TEST_F(OrderByTest, spillWithMemoryLimit) {
   constexpr int32_t kNumRows = 2000;
   constexpr int64_t kMaxBytes = 1LL << 30; // 1GB
@@ -518,3 +654,51 @@ TEST_F(OrderByTest, spillWithMemoryLimit) {
     OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
   }
 }
+
+TEST_F(OrderByTest, spillAsync) {
+  auto rowType = ROW({"c0", "c1", "c2"}, {INTEGER(), INTEGER(), VARCHAR()});
+  VectorFuzzer fuzzer({}, pool());
+  std::vector<RowVectorPtr> batches;
+  int64_t numRows = 0;
+  for (int32_t i = 0; i < 10; ++i) {
+    batches.push_back(fuzzer.fuzzRow(rowType));
+    numRows += batches.back()->size();
+  }
+  auto plan = PlanBuilder()
+                  .values(batches)
+                  .orderBy({"c0 ASC NULLS LAST", "c1 DESC"}, false)
+                  .planNode();
+  auto results = AssertQueryBuilder(plan).copyResults(pool());
+
+  // Without a spill executor the chunks are written on the driver thread.
+  for (const bool hasSpillExecutor : {true, false}) {
+    SCOPED_TRACE(fmt::format("hasSpillExecutor: {}", hasSpillExecutor));
+    std::shared_ptr<folly::Executor> spillExecutor;
+    if (hasSpillExecutor) {
+      spillExecutor = std::make_shared<folly::CPUThreadPoolExecutor>(2);
+    }
+    auto queryCtx = std::make_shared<core::QueryCtx>(
+        executor_.get(),
+        std::make_shared<core::MemConfig>(),
+        std::unordered_map<std::string, std::shared_ptr<Config>>{},
+        memory::MemoryAllocator::getInstance(),
+        nullptr,
+        spillExecutor);
+    auto spillDirectory = exec::test::TempDirectoryPath::create();
+    // The tiny threshold starts a new chunk on every input batch once the
+    // previous one is written.
+    auto task = AssertQueryBuilder(plan)
+                    .queryCtx(queryCtx)
+                    .spillDirectory(spillDirectory->path)
+                    .config(core::QueryConfig::kSpillEnabled, "true")
+                    .config(core::QueryConfig::kOrderBySpillEnabled, "true")
+                    .config(QueryConfig::kOrderBySpillMemoryThreshold, "1")
+                    .config(QueryConfig::kOrderBySpillAsync, "true")
+                    .assertResults(results);
+    const auto stats = spilledStats(*task);
+    ASSERT_LT(0, stats.spilledRows);
+    ASSERT_LE(stats.spilledRows, numRows);
+    ASSERT_EQ(1, stats.spilledPartitions);
+    OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+  }
+}
@@ -45,7 +45,8 @@ class PartitionedOutputBufferManagerTest : public testing::Test {
       const std::string& taskId,
       const RowTypePtr& rowType,
       int numDestinations,
-      int numDrivers) {
+      int numDrivers,
+      bool broadcast = false) {
     bufferManager_->removeTask(taskId);
 
     auto planFragment = exec::test::PlanBuilder()
@@ -58,7 +59,8 @@ class PartitionedOutputBufferManagerTest : public testing::Test {
         0,
         std::make_shared<core::QueryCtx>(executor_.get()));
 
-    bufferManager_->initializeTask(task, false, numDestinations, numDrivers);
+    bufferManager_->initializeTask(
+        task, broadcast, numDestinations, numDrivers);
     return task;
   }
 
@@ -298,6 +300,32 @@ TEST_F(PartitionedOutputBufferManagerTest, basic) {
   EXPECT_TRUE(task->isFinished());
 }
 
+TEST_F(PartitionedOutputBufferManagerTest, broadcast) {
+  auto rowType = ROW({"c0", "c1"}, {BIGINT(), VARCHAR()});
+  const std::string taskId = "t0";
+  auto task = initializeTask(taskId, rowType, 2, 1, true);
+
+  enqueue(taskId, 0, rowType, 100);
+  enqueue(taskId, 0, rowType, 100);
+
+  // The destinations read the same pages at their own pace.
+  fetch(taskId, 0, 0, std::numeric_limits<uint64_t>::max(), 2);
+  fetchOneAndAck(taskId, 1, 0);
+
+  // A destination added later reads all the pages.
+  bufferManager_->updateBroadcastOutputBuffers(taskId, 3, true);
+  fetch(taskId, 2, 0, std::numeric_limits<uint64_t>::max(), 2);
+
+  noMoreData(taskId);
+  fetchEndMarker(taskId, 0, 2);
+  fetchOneAndAck(taskId, 1, 1);
+  fetchEndMarker(taskId, 1, 2);
+  EXPECT_FALSE(bufferManager_->isFinished(taskId));
+  fetchEndMarker(taskId, 2, 2);
+  EXPECT_TRUE(bufferManager_->isFinished(taskId));
+  bufferManager_->removeTask(taskId);
+}
+
 TEST_F(PartitionedOutputBufferManagerTest, maxBytes) {
   std::vector<std::string> names = {"c0", "c1"};
   std::vector<TypePtr> types = {BIGINT(), VARCHAR()};
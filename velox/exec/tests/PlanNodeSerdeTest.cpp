@@ -65,6 +65,20 @@ TEST_F(PlanNodeSerdeTest, aggregation) {
                   .planNode();
 
   testSerde(plan);
+
+  plan = PlanBuilder()
+             .values({data_})
+             .singleAggregation({"c0"}, {"count(DISTINCT c1)", "sum(c1)"})
+             .planNode();
+
+  testSerde(plan);
+
+  plan = PlanBuilder()
+             .values({data_})
+             .singleAggregation({"c0"}, {"array_agg(c1 ORDER BY c2 DESC)"})
+             .planNode();
+
+  testSerde(plan);
 }
 
 TEST_F(PlanNodeSerdeTest, assignUniqueId) {
@@ -98,6 +112,41 @@ TEST_F(PlanNodeSerdeTest, crossJoin) {
               {"t0", "u1", "t2", "t1"})
           .planNode();
   testSerde(plan);
+
+  plan = PlanBuilder(planNodeIdGenerator)
+             .values({left})
+             .crossJoin(
+                 PlanBuilder(planNodeIdGenerator).values({right}).planNode(),
+                 "t1 < u1",
+                 {"t0", "u1", "t2"},
+                 core::JoinType::kLeft)
+             .planNode();
+  testSerde(plan);
+}
+
+TEST_F(PlanNodeSerdeTest, rangeJoin) {
+  auto left = makeRowVector(
+      {"t0", "t1"},
+      {makeFlatVector<int64_t>({1, 2, 3}), makeFlatVector<int32_t>({1, 2, 3})});
+  auto right = makeRowVector(
+      {"u0", "u1", "u2"},
+      {makeFlatVector<int64_t>({1, 2}),
+       makeFlatVector<int64_t>({2, 3}),
+       makeFlatVector<int32_t>({1, 2})});
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .values({left})
+          .rangeJoin(
+              "t0",
+              "u0",
+              "u1",
+              PlanBuilder(planNodeIdGenerator).values({right}).planNode(),
+              {"t0", "t1", "u2"},
+              core::JoinType::kLeft)
+          .planNode();
+  testSerde(plan);
 }
 
 TEST_F(PlanNodeSerdeTest, enforceSingleRow) {
@@ -315,6 +364,20 @@ TEST_F(PlanNodeSerdeTest, topN) {
   testSerde(plan);
 }
 
+TEST_F(PlanNodeSerdeTest, topNRowNumber) {
+  auto plan = PlanBuilder()
+                  .values({data_})
+                  .topNRowNumber({"c0"}, {"c1 DESC"}, 3, true)
+                  .planNode();
+  testSerde(plan);
+
+  plan = PlanBuilder()
+             .values({data_})
+             .topNRowNumber({}, {"c1", "c2 DESC NULLS FIRST"}, 10, false)
+             .planNode();
+  testSerde(plan);
+}
+
 TEST_F(PlanNodeSerdeTest, unnest) {
   auto data = makeRowVector({
       makeFlatVector<int64_t>({1, 2, 3}),
@@ -364,6 +427,13 @@ TEST_F(PlanNodeSerdeTest, window) {
              .planNode();
 
   testSerde(plan);
+
+  plan = PlanBuilder()
+             .values({data_})
+             .streamingWindow({"sum(c0) over (partition by c1 order by c2)"})
+             .planNode();
+
+  testSerde(plan);
 }
 
 } // namespace facebook::velox::exec::test
@@ -455,6 +455,29 @@ TEST_F(PlanNodeToStringTest, topN) {
       plan->toString(true, false));
 }
 
+TEST_F(PlanNodeToStringTest, topNRowNumber) {
+  auto plan = PlanBuilder()
+                  .values({data_})
+                  .topNRowNumber({"c0"}, {"c1 DESC"}, 3, true)
+                  .planNode();
+
+  ASSERT_EQ("-- TopNRowNumber\n", plan->toString());
+  ASSERT_EQ(
+      "-- TopNRowNumber[partition by [c0] order by [c1 DESC NULLS LAST] limit 3 row_number := row_number()] "
+      "-> c0:SMALLINT, c1:INTEGER, c2:BIGINT, row_number:BIGINT\n",
+      plan->toString(true, false));
+
+  plan = PlanBuilder()
+             .values({data_})
+             .topNRowNumber({}, {"c1 NULLS FIRST"}, 10, false)
+             .planNode();
+
+  ASSERT_EQ(
+      "-- TopNRowNumber[partition by [] order by [c1 ASC NULLS FIRST] limit 10] "
+      "-> c0:SMALLINT, c1:INTEGER, c2:BIGINT\n",
+      plan->toString(true, false));
+}
+
 TEST_F(PlanNodeToStringTest, enforceSingleRow) {
   auto plan = PlanBuilder().values({data_}).enforceSingleRow().planNode();
 
@@ -508,6 +531,12 @@ TEST_F(PlanNodeToStringTest, localPartition) {
   ASSERT_EQ(
       "-- LocalPartition[REPARTITION ROUND ROBIN] -> c0:SMALLINT, c1:INTEGER, c2:BIGINT\n",
       plan->toString(true, false));
+
+  plan = PlanBuilder().values({data_}).localPartitionScaleWriter().planNode();
+
+  ASSERT_EQ(
+      "-- LocalPartition[REPARTITION SCALE_WRITER] -> c0:SMALLINT, c1:INTEGER, c2:BIGINT\n",
+      plan->toString(true, false));
 }
 
 TEST_F(PlanNodeToStringTest, partitionedOutput) {
@@ -662,4 +691,16 @@ TEST_F(PlanNodeToStringTest, window) {
       "w0 := window1(ROW[\"c\"]) RANGE between CURRENT ROW and b FOLLOWING] "
       "-> a:VARCHAR, b:BIGINT, c:BIGINT, w0:BIGINT\n",
       plan->toString(true, false));
+
+  plan = PlanBuilder()
+             .tableScan(ROW({"a", "b", "c"}, {VARCHAR(), BIGINT(), BIGINT()}))
+             .streamingWindow({"window1(c) over (partition by a order by b) "
+                               "AS d"})
+             .planNode();
+  ASSERT_EQ("-- Window\n", plan->toString());
+  ASSERT_EQ(
+      "-- Window[partition by [a] order by [b ASC NULLS LAST] "
+      "d := window1(ROW[\"c\"]) RANGE between UNBOUNDED PRECEDING and CURRENT ROW inputsSorted] "
+      "-> a:VARCHAR, b:BIGINT, c:BIGINT, d:BIGINT\n",
+      plan->toString(true, false));
 }
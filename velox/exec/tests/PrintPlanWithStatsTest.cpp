@@ -155,6 +155,8 @@ TEST_F(PrintPlanWithStatsTest, innerJoinWithTableScan) {
       {{"-- Project\\[expressions: \\(c0:INTEGER, ROW\\[\"c0\"\\]\\), \\(p1:BIGINT, plus\\(ROW\\[\"c1\"\\],1\\)\\), \\(p2:BIGINT, plus\\(ROW\\[\"c1\"\\],ROW\\[\"u_c1\"\\]\\)\\)\\] -> c0:INTEGER, p1:BIGINT, p2:BIGINT"},
        {"   Output: 2000 rows \\(.+\\), Cpu time: .+, Blocked wall time: .+, Peak memory: 1\\.00MB, Memory allocations: .+, Threads: 1"},
        {"      dataSourceLazyWallNanos[ ]* sum: .+, count: 20, min: .+, max: .+"},
+       {"      expr\\.plus\\(BIGINT, BIGINT\\)\\.cpuNanos\\s+sum: .+, count: 1, min: .+, max: .+"},
+       {"      expr\\.plus\\(BIGINT, BIGINT\\)\\.rows\\s+sum: 4000, count: 1, min: 4000, max: 4000"},
        {"  -- HashJoin\\[INNER c0=u_c0\\] -> c0:INTEGER, c1:BIGINT, u_c1:BIGINT"},
        {"     Output: 2000 rows \\(.+\\), Cpu time: .+, Blocked wall time: .+, Peak memory: 2\\.00MB, Memory allocations: .+"},
        {"     HashBuild: Input: 100 rows \\(.+\\), Output: 0 rows \\(.+\\), Cpu time: .+, Blocked wall time: .+, Peak memory: 1\\.00MB, Memory allocations: .+, Threads: 1"},
@@ -173,24 +175,43 @@ TEST_F(PrintPlanWithStatsTest, innerJoinWithTableScan) {
                // HashProbe has to wait for the HashBuild construction.
        {"    -- TableScan\\[table: hive_table\\] -> c0:INTEGER, c1:BIGINT"},
        {"       Input: 2000 rows \\(.+\\), Raw Input: 20480 rows \\(.+\\), Output: 2000 rows \\(.+\\), Cpu time: .+, Blocked wall time: .+, Peak memory: 1\\.00MB, Memory allocations: .+, Threads: 1, Splits: 20"},
+       {"          cachePinWaitNanos\\s+sum: .+, count: .+, min: .+, max: .+"},
+       {"          coalescedLoadWaitNanos\\s+sum: .+, count: .+, min: .+, max: .+"},
        {"          dataSourceWallNanos [ ]* sum: .+, count: 40, min: .+, max: .+"},
        {"          dynamicFiltersAccepted[ ]* sum: 1, count: 1, min: 1, max: 1"},
        {"          ioWaitNanos      [ ]* sum: .+, count: .+ min: .+, max: .+"},
+       {"          lazyBytesNotLoaded\\s+sum: .+, count: 1, min: .+, max: .+"},
+       {"          lazyVectorsNotLoaded\\s+sum: .+, count: 1, min: .+, max: .+"},
        {"          localReadBytes      [ ]* sum: 0B, count: 1, min: 0B, max: 0B"},
        {"          numLocalRead        [ ]* sum: 0, count: 1, min: 0, max: 0"},
        {"          numPrefetch         [ ]* sum: .+, count: 1, min: .+, max: .+"},
+       {"          numPrefetchHit\\s+sum: .+, count: .+, min: .+, max: .+"},
        {"          numRamRead          [ ]* sum: 40, count: 1, min: 40, max: 40"},
        {"          numStorageRead      [ ]* sum: .+, count: 1, min: .+, max: .+"},
        {"          prefetchBytes       [ ]* sum: .+, count: 1, min: .+, max: .+"},
+       {"          prefetchHitBytes\\s+sum: .+, count: .+, min: .+, max: .+"},
        {"          preloadedSplits[ ]+sum: .+, count: .+, min: .+, max: .+",
         true},
        {"          ramReadBytes        [ ]* sum: .+, count: 1, min: .+, max: .+"},
        {"          readyPreloadedSplits[ ]+sum: .+, count: .+, min: .+, max: .+",
         true},
+       {"          skippedPageRows     [ ]* sum: 0, count: 1, min: 0, max: 0"},
        {"          skippedSplitBytes   [ ]* sum: 0B, count: 1, min: 0B, max: 0B"},
        {"          skippedSplits       [ ]* sum: 0, count: 1, min: 0, max: 0"},
        {"          skippedStrides      [ ]* sum: 0, count: 1, min: 0, max: 0"},
        {"          storageReadBytes    [ ]* sum: .+, count: 1, min: .+, max: .+"},
+       {"          storageReadsOver1s\\s+sum: .+, count: .+, min: .+, max: .+",
+        true},
+       {"          storageReadsUnder100ms\\s+sum: .+, count: .+, min: .+, max: .+",
+        true},
+       {"          storageReadsUnder100us\\s+sum: .+, count: .+, min: .+, max: .+",
+        true},
+       {"          storageReadsUnder10ms\\s+sum: .+, count: .+, min: .+, max: .+",
+        true},
+       {"          storageReadsUnder1ms\\s+sum: .+, count: .+, min: .+, max: .+",
+        true},
+       {"          storageReadsUnder1s\\s+sum: .+, count: .+, min: .+, max: .+",
+        true},
        {"          totalScanTime       [ ]* sum: .+, count: .+, min: .+, max: .+"},
        {"    -- Project\\[expressions: \\(u_c0:INTEGER, ROW\\[\"c0\"\\]\\), \\(u_c1:BIGINT, ROW\\[\"c1\"\\]\\)\\] -> u_c0:INTEGER, u_c1:BIGINT"},
        {"       Output: 100 rows \\(.+\\), Cpu time: .+, Blocked wall time: .+, Peak memory: 0B, Memory allocations: .+, Threads: 1"},
@@ -246,23 +267,42 @@ TEST_F(PrintPlanWithStatsTest, partialAggregateWithTableScan) {
          {"      loadedToValueHook\\s+sum: 50000, count: 5, min: 10000, max: 10000"},
          {"  -- TableScan\\[table: hive_table\\] -> c0:BIGINT, c1:INTEGER, c2:SMALLINT, c3:REAL, c4:DOUBLE, c5:VARCHAR"},
          {"     Input: 10000 rows \\(.+\\), Output: 10000 rows \\(.+\\), Cpu time: .+, Blocked wall time: .+, Peak memory: 1\\.00MB, Memory allocations: .+, Threads: 1, Splits: 1"},
+         {"        cachePinWaitNanos\\s+sum: .+, count: .+, min: .+, max: .+"},
+         {"        coalescedLoadWaitNanos\\s+sum: .+, count: .+, min: .+, max: .+"},
          {"        dataSourceWallNanos[ ]* sum: .+, count: 2, min: .+, max: .+"},
          {"        ioWaitNanos      [ ]* sum: .+, count: .+ min: .+, max: .+"},
+         {"        lazyBytesNotLoaded\\s+sum: .+, count: 1, min: .+, max: .+"},
+         {"        lazyVectorsNotLoaded\\s+sum: .+, count: 1, min: .+, max: .+"},
          {"        localReadBytes   [ ]* sum: 0B, count: 1, min: 0B, max: 0B"},
          {"        numLocalRead     [ ]* sum: 0, count: 1, min: 0, max: 0"},
          {"        numPrefetch      [ ]* sum: .+, count: .+, min: .+, max: .+"},
+         {"        numPrefetchHit\\s+sum: .+, count: .+, min: .+, max: .+"},
          {"        numRamRead       [ ]* sum: 6, count: 1, min: 6, max: 6"},
          {"        numStorageRead   [ ]* sum: .+, count: 1, min: .+, max: .+"},
          {"        prefetchBytes    [ ]* sum: .+, count: 1, min: .+, max: .+"},
+         {"        prefetchHitBytes\\s+sum: .+, count: .+, min: .+, max: .+"},
          {"        preloadedSplits[ ]+sum: .+, count: .+, min: .+, max: .+",
           true},
          {"        ramReadBytes     [ ]* sum: .+, count: 1, min: .+, max: .+"},
          {"        readyPreloadedSplits[ ]+sum: .+, count: .+, min: .+, max: .+",
           true},
+         {"        skippedPageRows  [ ]* sum: 0, count: 1, min: 0, max: 0"},
          {"        skippedSplitBytes[ ]* sum: 0B, count: 1, min: 0B, max: 0B"},
          {"        skippedSplits    [ ]* sum: 0, count: 1, min: 0, max: 0"},
          {"        skippedStrides   [ ]* sum: 0, count: 1, min: 0, max: 0"},
          {"        storageReadBytes [ ]* sum: .+, count: 1, min: .+, max: .+"},
+         {"        storageReadsOver1s\\s+sum: .+, count: .+, min: .+, max: .+",
+          true},
+         {"        storageReadsUnder100ms\\s+sum: .+, count: .+, min: .+, max: .+",
+          true},
+         {"        storageReadsUnder100us\\s+sum: .+, count: .+, min: .+, max: .+",
+          true},
+         {"        storageReadsUnder10ms\\s+sum: .+, count: .+, min: .+, max: .+",
+          true},
+         {"        storageReadsUnder1ms\\s+sum: .+, count: .+, min: .+, max: .+",
+          true},
+         {"        storageReadsUnder1s\\s+sum: .+, count: .+, min: .+, max: .+",
+          true},
          {"        totalScanTime    [ ]* sum: .+, count: .+, min: .+, max: .+"}});
   }
 }
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+class RangeJoinTest : public OperatorTestBase {
+ protected:
+  // With 'parallelizable' set, each Driver of the build and probe pipelines
+  // produces all of 'left' and 'right'.
+  core::PlanNodePtr makePlan(
+      const std::vector<RowVectorPtr>& left,
+      const std::vector<RowVectorPtr>& right,
+      core::JoinType joinType,
+      bool parallelizable = false) {
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    return PlanBuilder(planNodeIdGenerator)
+        .values(left, parallelizable)
+        .rangeJoin(
+            "ts",
+            "r_start",
+            "r_end",
+            PlanBuilder(planNodeIdGenerator)
+                .values(right, parallelizable)
+                .planNode(),
+            {"ts", "r_start", "r_end"},
+            joinType)
+        .planNode();
+  }
+};
+
+TEST_F(RangeJoinTest, basic) {
+  std::vector<RowVectorPtr> left = {
+      makeRowVector(
+          {"ts"},
+          {makeFlatVector<int64_t>(
+              1'000, [](auto row) { return row; }, nullEvery(97))}),
+      makeRowVector(
+          {"ts"},
+          {makeFlatVector<int64_t>(
+              321, [](auto row) { return (row * 7) % 1'500; })}),
+  };
+
+  // Unsorted, overlapping ranges with a few long ones and some null bounds.
+  std::vector<RowVectorPtr> right = {
+      makeRowVector(
+          {"r_start", "r_end"},
+          {makeFlatVector<int64_t>(
+               200, [](auto row) { return (row * 37) % 1'000; }, nullEvery(31)),
+           makeFlatVector<int64_t>(
+               200,
+               [](auto row) {
+                 return (row * 37) % 1'000 + (row % 10 == 0 ? 300 : row % 5);
+               },
+               nullEvery(43))}),
+      makeRowVector(
+          {"r_start", "r_end"},
+          {makeFlatVector<int64_t>(50, [](auto row) { return row * 20; }),
+           makeFlatVector<int64_t>(50, [](auto row) { return row * 20; })}),
+  };
+
+  createDuckDbTable("t", left);
+  createDuckDbTable("u", right);
+
+  for (const auto batchSize : {"1", "10", "1024"}) {
+    SCOPED_TRACE(batchSize);
+    AssertQueryBuilder(
+        makePlan(left, right, core::JoinType::kInner), duckDbQueryRunner_)
+        .config(core::QueryConfig::kPreferredOutputBatchSize, batchSize)
+        .assertResults(
+            "SELECT ts, r_start, r_end FROM t, u WHERE ts BETWEEN r_start AND r_end");
+
+    AssertQueryBuilder(
+        makePlan(left, right, core::JoinType::kLeft), duckDbQueryRunner_)
+        .config(core::QueryConfig::kPreferredOutputBatchSize, batchSize)
+        .assertResults(
+            "SELECT ts, r_start, r_end FROM t LEFT JOIN u ON ts BETWEEN r_start AND r_end");
+  }
+
+  // Multiple build and probe Drivers. Each Driver produces all the rows.
+  createDuckDbTable("t", {left[0], left[1], left[0], left[1]});
+  createDuckDbTable("u", {right[0], right[1], right[0], right[1]});
+  AssertQueryBuilder(
+      makePlan(left, right, core::JoinType::kLeft, true), duckDbQueryRunner_)
+      .maxDrivers(2)
+      .assertResults(
+          "SELECT ts, r_start, r_end FROM t LEFT JOIN u ON ts BETWEEN r_start AND r_end");
+}
+
+TEST_F(RangeJoinTest, emptyBuild) {
+  std::vector<RowVectorPtr> left = {
+      makeRowVector({"ts"}, {makeFlatVector<int64_t>({1, 2, 3})}),
+  };
+  std::vector<RowVectorPtr> right = {
+      makeRowVector(
+          {"r_start", "r_end"},
+          {makeNullableFlatVector<int64_t>({std::nullopt, 1}),
+           makeNullableFlatVector<int64_t>({3, std::nullopt})}),
+  };
+
+  createDuckDbTable("t", left);
+
+  // Rows with a null bound are dropped, leaving the build side empty.
+  AssertQueryBuilder(makePlan(left, right, core::JoinType::kInner))
+      .assertEmptyResults();
+  assertQuery(
+      makePlan(left, right, core::JoinType::kLeft),
+      "SELECT ts, null, null FROM t");
+}
+
+TEST_F(RangeJoinTest, invalidKeyType) {
+  auto left = makeRowVector({"ts"}, {makeFlatVector<int32_t>({1})});
+  auto right = makeRowVector(
+      {"r_start", "r_end"},
+      {makeFlatVector<int64_t>({1}), makeFlatVector<int64_t>({1})});
+  VELOX_ASSERT_THROW(
+      makePlan({left}, {right}, core::JoinType::kInner),
+      "Range join bounds must be of the same type as the key");
+}
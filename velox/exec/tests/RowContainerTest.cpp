@@ -717,6 +717,116 @@ TEST_F(RowContainerTest, rowSize) {
   EXPECT_EQ(rows, rowsFromContainer);
 }
 
+TEST_F(RowContainerTest, compactLayout) {
+  constexpr int32_t kNumRows = 100;
+  auto data = makeRowContainer({SMALLINT()}, {VARCHAR()}, true, true);
+
+  // The layout is expected to be smallint - 1 byte of bits - StringView -
+  // rowSize - next pointer. A free row keeps the pointer to the next free row
+  // after the bits.
+  EXPECT_EQ(19, data->rowSizeOffset());
+  EXPECT_EQ(23, data->nextOffset());
+  EXPECT_EQ(31, data->fixedRowSize());
+  EXPECT_EQ(data->probedFlagOffset(), 2 * 8 + 1);
+  EXPECT_LT(
+      data->fixedRowSize(),
+      makeRowContainer({SMALLINT()}, {VARCHAR()})->fixedRowSize());
+
+  auto keys = makeFlatVector<int16_t>(kNumRows, [](auto row) { return row; });
+  auto values = makeFlatVector<std::string>(kNumRows, [](auto row) {
+    return fmt::format("value not inlined in a StringView {}", row);
+  });
+  DecodedVector decodedKeys(*keys);
+  DecodedVector decodedValues(*values);
+  std::vector<char*> rows;
+  for (int i = 0; i < kNumRows; ++i) {
+    rows.push_back(data->newRow());
+    data->store(decodedKeys, i, rows.back(), 0);
+    data->store(decodedValues, i, rows.back(), 1);
+  }
+
+  std::vector<char*> erased;
+  for (auto i = 0; i < rows.size(); i += 2) {
+    erased.push_back(rows[i]);
+  }
+  data->eraseRows(folly::Range<char**>(erased.data(), erased.size()));
+  data->checkConsistency();
+
+  // The erased rows are reused and the remaining rows are intact.
+  for (auto i = 0; i < erased.size(); ++i) {
+    auto* row = data->newRow();
+    ASSERT_EQ(erased[erased.size() - 1 - i], row);
+    data->store(decodedKeys, (erased.size() - 1 - i) * 2, row, 0);
+    data->store(decodedValues, (erased.size() - 1 - i) * 2, row, 1);
+  }
+  data->checkConsistency();
+  testExtractColumn(*data, rows, 0, keys);
+  testExtractColumn(*data, rows, 1, values);
+}
+
+TEST_F(RowContainerTest, compactStrings) {
+  constexpr int32_t kNumRows = 20'000;
+  auto data = makeRowContainer({BIGINT()}, {VARCHAR(), ARRAY(BIGINT())});
+  std::vector<std::string> strings;
+  for (auto i = 0; i < kNumRows; ++i) {
+    strings.push_back(std::string(100, 'a' + i % 26) + std::to_string(i));
+  }
+  auto input = makeRowVector({
+      makeFlatVector<int64_t>(kNumRows, [](auto row) { return row; }),
+      makeFlatVector<StringView>(
+          kNumRows, [&](auto row) { return StringView(strings[row]); }),
+      makeArrayVector<int64_t>(
+          kNumRows,
+          [](auto row) { return row % 10; },
+          [](auto row, auto index) { return row + index; }),
+  });
+  SelectivityVector allRows(kNumRows);
+  std::vector<DecodedVector> decoded;
+  for (auto& child : input->children()) {
+    decoded.emplace_back(*child, allRows);
+  }
+  std::vector<char*> rows;
+  for (auto i = 0; i < kNumRows; ++i) {
+    rows.push_back(data->newRow());
+    for (auto column = 0; column < decoded.size(); ++column) {
+      data->store(decoded[column], i, rows.back(), column);
+    }
+  }
+  // There is no free space to compact.
+  EXPECT_FALSE(data->compactStrings());
+
+  // Keeps every 10th row.
+  std::vector<char*> erased;
+  std::vector<vector_size_t> kept;
+  for (auto i = 0; i < kNumRows; ++i) {
+    if (i % 10 == 0) {
+      kept.push_back(i);
+    } else {
+      erased.push_back(rows[i]);
+    }
+  }
+  data->eraseRows(folly::Range<char**>(erased.data(), erased.size()));
+  const auto retainedSize = data->stringAllocator().retainedSize();
+  EXPECT_TRUE(data->compactStrings());
+  EXPECT_LT(data->stringAllocator().retainedSize(), retainedSize / 4);
+  data->checkConsistency();
+
+  std::vector<char*> remaining(kept.size());
+  for (auto i = 0; i < kept.size(); ++i) {
+    remaining[i] = rows[kept[i]];
+  }
+  for (auto column = 0; column < decoded.size(); ++column) {
+    auto result = BaseVector::create(
+        input->childAt(column)->type(), kept.size(), pool_.get());
+    data->extractColumn(
+        remaining.data(), remaining.size(), data->columnAt(column), result);
+    for (auto i = 0; i < kept.size(); ++i) {
+      ASSERT_TRUE(
+          result->equalValueAt(input->childAt(column).get(), i, kept[i]));
+    }
+  }
+}
+
 TEST_F(RowContainerTest, rowSizeWithNormalizedKey) {
   auto data = makeRowContainer({SMALLINT()}, {VARCHAR()});
   data->newRow();
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/SortKeyPrefix.h"
+
+#include <gtest/gtest.h>
+
+#include "velox/exec/RowContainer.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+class SortKeyPrefixTest : public testing::Test,
+                          public test::VectorTestBase {
+ protected:
+  // Checks that the prefixes of the rows of 'data' order the rows like
+  // comparing the keys in the leading 'numKeys' columns for all combinations
+  // of sort orders, and that the prefixes encoded from a RowContainer match
+  // the ones encoded from 'data'. 'numPrefixKeys' is the expected number of
+  // keys in the prefix.
+  void testPrefixes(
+      const RowVectorPtr& data,
+      int32_t numKeys,
+      int32_t numPrefixKeys) {
+    const auto& rowType = data->type()->asRow();
+    std::vector<TypePtr> keyTypes;
+    std::vector<TypePtr> dependentTypes;
+    std::vector<column_index_t> keyChannels;
+    for (auto i = 0; i < rowType.size(); ++i) {
+      if (i < numKeys) {
+        keyTypes.push_back(rowType.childAt(i));
+        keyChannels.push_back(i);
+      } else {
+        dependentTypes.push_back(rowType.childAt(i));
+      }
+    }
+    RowContainer rowContainer(keyTypes, dependentTypes, true, pool());
+    SelectivityVector allRows(data->size());
+    std::vector<char*> rows(data->size());
+    for (auto i = 0; i < data->size(); ++i) {
+      rows[i] = rowContainer.newRow();
+    }
+    for (auto column = 0; column < rowType.size(); ++column) {
+      DecodedVector decoded(*data->childAt(column), allRows);
+      for (auto i = 0; i < data->size(); ++i) {
+        rowContainer.store(decoded, i, rows[i], column);
+      }
+    }
+
+    for (auto order = 0; order < 4; ++order) {
+      std::vector<CompareFlags> flags;
+      for (auto i = 0; i < numKeys; ++i) {
+        // Alternate the sort orders between the keys.
+        const auto keyOrder = (order + i) % 4;
+        flags.push_back({keyOrder < 2, keyOrder % 2 == 0, false, false});
+      }
+      SortKeyPrefix sortKeyPrefix(keyTypes, keyChannels, flags);
+      ASSERT_EQ(numPrefixKeys, sortKeyPrefix.numKeys());
+      std::vector<uint64_t> prefixes;
+      sortKeyPrefix.encode(*data, prefixes);
+      ASSERT_EQ(data->size(), prefixes.size());
+      for (auto i = 0; i < data->size(); ++i) {
+        ASSERT_EQ(prefixes[i], sortKeyPrefix.encode(rowContainer, rows[i]));
+      }
+
+      for (auto i = 0; i < data->size(); ++i) {
+        for (auto j = 0; j < data->size(); ++j) {
+          int32_t result = 0;
+          for (auto key = 0; key < numKeys && result == 0; ++key) {
+            result = data->childAt(key)
+                         ->compare(data->childAt(key).get(), i, j, flags[key])
+                         .value();
+          }
+          if (prefixes[i] < prefixes[j]) {
+            ASSERT_LT(result, 0) << "rows " << i << " and " << j;
+          } else if (prefixes[i] > prefixes[j]) {
+            ASSERT_GT(result, 0) << "rows " << i << " and " << j;
+          }
+        }
+      }
+    }
+  }
+};
+
+TEST_F(SortKeyPrefixTest, isSupported) {
+  EXPECT_TRUE(SortKeyPrefix::isSupported(BOOLEAN()));
+  EXPECT_TRUE(SortKeyPrefix::isSupported(TINYINT()));
+  EXPECT_TRUE(SortKeyPrefix::isSupported(SMALLINT()));
+  EXPECT_TRUE(SortKeyPrefix::isSupported(INTEGER()));
+  EXPECT_TRUE(SortKeyPrefix::isSupported(BIGINT()));
+  EXPECT_TRUE(SortKeyPrefix::isSupported(REAL()));
+  EXPECT_TRUE(SortKeyPrefix::isSupported(DOUBLE()));
+  EXPECT_TRUE(SortKeyPrefix::isSupported(DATE()));
+  EXPECT_TRUE(SortKeyPrefix::isSupported(SHORT_DECIMAL(10, 2)));
+  EXPECT_TRUE(SortKeyPrefix::isSupported(VARCHAR()));
+  EXPECT_TRUE(SortKeyPrefix::isSupported(VARBINARY()));
+  EXPECT_FALSE(SortKeyPrefix::isSupported(TIMESTAMP()));
+  EXPECT_FALSE(SortKeyPrefix::isSupported(LONG_DECIMAL(20, 2)));
+  EXPECT_FALSE(SortKeyPrefix::isSupported(ARRAY(BIGINT())));
+}
+
+TEST_F(SortKeyPrefixTest, integers) {
+  const vector_size_t size = 200;
+  auto data = makeRowVector({
+      makeFlatVector<int32_t>(
+          size,
+          [](auto row) { return (row % 7 - 3) * 1'000'003; },
+          nullEvery(11)),
+      makeFlatVector<int16_t>(
+          size, [](auto row) { return row % 5 - 2; }, nullEvery(13)),
+      makeFlatVector<int8_t>(size, [](auto row) { return row % 3 - 1; }),
+  });
+  // The prefix has 1 + 4 bytes of the integer and 1 + 2 bytes of the
+  // smallint.
+  testPrefixes(data, 3, 2);
+
+  data = makeRowVector({
+      makeFlatVector<int64_t>(
+          size,
+          [](auto row) { return (row % 17 - 8) * (1LL << 40) + row % 3; },
+          nullEvery(7)),
+      makeFlatVector<int64_t>(size, [](auto row) { return row % 4; }),
+  });
+  // A bigint is truncated and ends the prefix.
+  testPrefixes(data, 2, 1);
+
+  data = makeRowVector({
+      makeFlatVector<bool>(
+          size, [](auto row) { return row % 3 == 0; }, nullEvery(5)),
+      makeFlatVector<Date>(
+          size, [](auto row) { return Date(row % 9 - 4); }, nullEvery(6)),
+      makeFlatVector<UnscaledShortDecimal>(
+          size,
+          [](auto row) { return UnscaledShortDecimal(row % 8 - 3); },
+          nullEvery(4),
+          SHORT_DECIMAL(10, 2)),
+  });
+  testPrefixes(data, 3, 3);
+}
+
+TEST_F(SortKeyPrefixTest, floatingPoint) {
+  const vector_size_t size = 200;
+  std::vector<double> doubles = {
+      -std::numeric_limits<double>::infinity(),
+      -1.5,
+      -0.0,
+      0.0,
+      std::numeric_limits<double>::min(),
+      2.5,
+      std::numeric_limits<double>::infinity(),
+      std::numeric_limits<double>::quiet_NaN(),
+      -std::numeric_limits<double>::quiet_NaN()};
+  auto data = makeRowVector({
+      makeFlatVector<float>(
+          size,
+          [&](auto row) { return doubles[row % doubles.size()]; },
+          nullEvery(11)),
+      makeFlatVector<int16_t>(size, [](auto row) { return row % 3; }),
+  });
+  testPrefixes(data, 2, 2);
+
+  data = makeRowVector({
+      makeFlatVector<double>(
+          size,
+          [&](auto row) { return doubles[row % doubles.size()]; },
+          nullEvery(7)),
+      makeFlatVector<int16_t>(size, [](auto row) { return row % 3; }),
+  });
+  testPrefixes(data, 2, 1);
+}
+
+TEST_F(SortKeyPrefixTest, isComplete) {
+  auto flags = std::vector<CompareFlags>(2);
+  EXPECT_TRUE(SortKeyPrefix({INTEGER()}, {0}, {flags[0]}).isComplete());
+  EXPECT_TRUE(
+      SortKeyPrefix({SMALLINT(), INTEGER()}, {0, 1}, flags).isComplete());
+  EXPECT_FALSE(SortKeyPrefix({BIGINT()}, {0}, {flags[0]}).isComplete());
+  EXPECT_FALSE(
+      SortKeyPrefix({INTEGER(), INTEGER()}, {0, 1}, flags).isComplete());
+  EXPECT_FALSE(
+      SortKeyPrefix({INTEGER(), DOUBLE()}, {0, 1}, flags).isComplete());
+  EXPECT_FALSE(SortKeyPrefix({VARCHAR()}, {0}, {flags[0]}).isComplete());
+}
+
+TEST_F(SortKeyPrefixTest, strings) {
+  const vector_size_t size = 200;
+  std::vector<std::string> strings = {
+      "",
+      "a",
+      std::string("a\0", 2),
+      "ab",
+      "abcdefgh",
+      "abcdefghi",
+      "abcdefghj",
+      "b",
+      "\xff\xff",
+      "zzzzzzzzzzzzzzzzzzzz"};
+  auto data = makeRowVector({
+      makeFlatVector<StringView>(
+          size,
+          [&](auto row) { return StringView(strings[row % strings.size()]); },
+          nullEvery(9)),
+      makeFlatVector<int32_t>(size, [](auto row) { return row % 3; }),
+  });
+  testPrefixes(data, 2, 1);
+
+  // A string key after a smallint gets the 5 remaining bytes.
+  data = makeRowVector({
+      makeFlatVector<int16_t>(size, [](auto row) { return row % 2; }),
+      makeFlatVector<StringView>(
+          size,
+          [&](auto row) { return StringView(strings[row % strings.size()]); },
+          nullEvery(7)),
+  });
+  testPrefixes(data, 2, 2);
+}
+
+TEST_F(SortKeyPrefixTest, unsupportedKey) {
+  const vector_size_t size = 100;
+  auto data = makeRowVector({
+      makeFlatVector<int32_t>(size, [](auto row) { return row % 5; }),
+      makeFlatVector<Timestamp>(
+          size, [](auto row) { return Timestamp(row % 3, row % 2); }),
+      makeFlatVector<int16_t>(size, [](auto row) { return row % 7; }),
+  });
+  // The prefix ends before the timestamp.
+  testPrefixes(data, 3, 1);
+}
@@ -14,10 +14,13 @@
  * limitations under the License.
  */
 #include "velox/exec/Spill.h"
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <memory>
 #include "velox/common/base/RuntimeMetrics.h"
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/file/FileSystems.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
@@ -29,6 +32,8 @@ using namespace facebook::velox::exec;
 using namespace facebook::velox::filesystems;
 using facebook::velox::exec::test::TempDirectoryPath;
 
+DECLARE_uint64(spill_read_ahead_bytes);
+
 namespace {
 static const int64_t kGB = 1'000'000'000;
 
@@ -227,7 +232,8 @@ class SpillTest : public testing::Test,
       int numBatches,
       int numDuplicates,
       const std::vector<CompareFlags>& compareFlags,
-      uint64_t expectedNumSpilledFiles) {
+      uint64_t expectedNumSpilledFiles,
+      folly::Executor* executor = nullptr) {
     const int numRowsPerBatch = 20'000;
     SCOPED_TRACE(fmt::format(
         "targetFileSize: {}, numPartitions: {}, numBatches: {}, numDuplicates: {}, nullsFirst: {}, ascending: {}",
@@ -261,7 +267,7 @@ class SpillTest : public testing::Test,
 
     for (auto partition = 0; partition < state_->maxPartitions(); ++partition) {
       int numReadBatches = 0;
-      auto merge = state_->startMerge(partition, nullptr);
+      auto merge = state_->startMerge(partition, nullptr, executor);
       // We expect all the rows in dense increasing order.
       for (auto i = 0; i < numBatches * numRowsPerBatch; ++i) {
         auto stream = merge->next();
@@ -337,6 +343,23 @@ TEST_F(SpillTest, spillState) {
   spillStateTest(kGB, 2, 10, 10, {}, 10);
 }
 
+TEST_F(SpillTest, spillStateWithReadAhead) {
+  auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(4);
+  const auto savedReadAheadBytes = FLAGS_spill_read_ahead_bytes;
+  // A zero budget reads each spill file in the smallest buffers so that a
+  // file is read ahead multiple times.
+  for (const uint64_t readAheadBytes : {0, 64 << 20}) {
+    SCOPED_TRACE(fmt::format("readAheadBytes: {}", readAheadBytes));
+    FLAGS_spill_read_ahead_bytes = readAheadBytes;
+    spillStateTest(
+        kGB, 2, 10, 1, {CompareFlags{true, true}}, 10, executor.get());
+    spillStateTest(
+        kGB, 2, 10, 10, {CompareFlags{false, false}}, 10, executor.get());
+    spillStateTest(1, 2, 10, 1, {}, 10 * 2, executor.get());
+  }
+  FLAGS_spill_read_ahead_bytes = savedReadAheadBytes;
+}
+
 TEST_F(SpillTest, spillTimestamp) {
   // Verify that timestamp type retains it nanosecond precision when spilled and
   // read back.
@@ -372,6 +395,91 @@ TEST_F(SpillTest, spillTimestamp) {
   ASSERT_EQ(nullptr, merge->next());
 }
 
+TEST_F(SpillTest, spillCompression) {
+  // Low cardinality keys with long strings compress well, random doubles
+  // don't and are written uncompressed.
+  auto compressible = makeRowVector({
+      makeFlatVector<int64_t>(10'000, [](auto row) { return row / 100; }),
+      makeFlatVector<std::string>(
+          10'000,
+          [](auto row) { return std::string(40, 'a' + row % 3); },
+          nullEvery(11)),
+  });
+  auto incompressible = makeRowVector({
+      makeFlatVector<int64_t>(
+          10'000, [](auto /*row*/) { return folly::Random::rand64(); }),
+      makeFlatVector<double>(
+          10'000, [](auto /*row*/) { return folly::Random::randDouble01(); }),
+  });
+  for (const auto kind :
+       {folly::io::CodecType::NO_COMPRESSION,
+        folly::io::CodecType::LZ4,
+        folly::io::CodecType::ZSTD}) {
+    SCOPED_TRACE(static_cast<int>(kind));
+    for (const auto& data : {compressible, incompressible}) {
+      auto tempDirectory = exec::test::TempDirectoryPath::create();
+      SpillState state(
+          tempDirectory->path + "/test", 1, 1, {}, kGB, *pool(), kind);
+      state.setPartitionSpilled(0);
+      state.appendToPartition(0, data);
+      state.finishWrite(0);
+      if (kind == folly::io::CodecType::NO_COMPRESSION ||
+          data == incompressible) {
+        ASSERT_EQ(state.spilledUncompressedBytes(), state.spilledBytes());
+      } else {
+        ASSERT_LT(2 * state.spilledBytes(), state.spilledUncompressedBytes());
+      }
+
+      auto files = state.files(0);
+      ASSERT_EQ(files.size(), 1);
+      ASSERT_EQ(files[0]->compressionKind(), kind);
+      auto reader = files[0]->makeReader(*pool());
+      RowVectorPtr result;
+      ASSERT_TRUE(reader->nextBatch(result));
+      facebook::velox::test::assertEqualVectors(data, result);
+      ASSERT_FALSE(reader->nextBatch(result));
+    }
+  }
+}
+
+TEST_F(SpillTest, spillWriteCallback) {
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(1'000, [](auto row) { return row; }),
+  });
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  uint64_t writtenBytes = 0;
+  SpillState state(
+      tempDirectory->path + "/test",
+      1,
+      1,
+      {},
+      kGB,
+      *pool(),
+      folly::io::CodecType::NO_COMPRESSION,
+      [&](uint64_t bytes) {
+        writtenBytes += bytes;
+        VELOX_USER_CHECK_LE(writtenBytes, 3 * 8'000, "Spill quota exceeded");
+      });
+  state.setPartitionSpilled(0);
+  state.appendToPartition(0, data);
+  // The pages are buffered and accounted before they are written.
+  ASSERT_EQ(state.spilledBytes(), writtenBytes);
+  state.appendToPartition(0, data);
+  VELOX_ASSERT_THROW(
+      state.appendToPartition(0, data), "Spill quota exceeded");
+  state.finishWrite(0);
+  auto files = state.files(0);
+  ASSERT_EQ(files.size(), 1);
+  ASSERT_LT(files[0]->size(), writtenBytes);
+  auto reader = files[0]->makeReader(*pool());
+  RowVectorPtr result;
+  for (auto i = 0; i < 2; ++i) {
+    ASSERT_TRUE(reader->nextBatch(result));
+    facebook::velox::test::assertEqualVectors(data, result);
+  }
+  ASSERT_FALSE(reader->nextBatch(result));
+}
+
 TEST_F(SpillTest, spillStateWithSmallTargetFileSize) {
   // Set the target file size to a small value to open a new file on each batch
   // write.
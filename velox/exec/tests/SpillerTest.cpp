@@ -90,6 +90,11 @@ void setSequentialValue(
   }
 }
 
+// Returns true if 'type' spills all the data into a single partition.
+bool isSinglePartitionType(Spiller::Type type) {
+  return type == Spiller::Type::kOrderBy || type == Spiller::Type::kWindow;
+}
+
 void resizeVector(RowVector& vector, vector_size_t size) {
   vector.prepareForReuse();
   vector.resize(size);
@@ -109,7 +114,7 @@ class SpillerTest : public exec::test::RowContainerTestBase {
       : param_(param),
         type_(param.type),
         executorPoolSize_(param.poolSize),
-        hashBits_(0, type_ == Spiller::Type::kOrderBy ? 0 : 2),
+        hashBits_(0, isSinglePartitionType(type_) ? 0 : 2),
         numPartitions_(hashBits_.numPartitions()),
         statWriter_(std::make_unique<TestRuntimeStatWriter>(stats_)) {
     setThreadLocalRunTimeStatWriter(statWriter_.get());
@@ -183,6 +188,10 @@ class SpillerTest : public exec::test::RowContainerTestBase {
     EXPECT_GT(numSpilledFiles, 0);
     const auto spilledFileSet = spiller_->state().testingSpilledFilePaths();
     EXPECT_EQ(numSpilledFiles, spilledFileSet.size());
+    const auto stats = spiller_->stats();
+    EXPECT_LT(0, stats.spillSortNanos);
+    EXPECT_LT(0, stats.spillSerializationNanos);
+    EXPECT_LT(0, stats.spillWriteNanos);
 
     for (auto spilledFile : spilledFileSet) {
       auto readFile = fs_->openFileForRead(spilledFile);
@@ -217,6 +226,9 @@ class SpillerTest : public exec::test::RowContainerTestBase {
     ASSERT_ANY_THROW(spiller_->spill(100, 100));
 
     verifySortedSpillData(outputBatchSize);
+    // The spill files record their read timings when the merge is done.
+    ASSERT_EQ(1, stats_.count("spillReadNanos"));
+    ASSERT_EQ(1, stats_.count("spillDeserializationNanos"));
 
     spiller_.reset();
     // Verify the spilled files are still there after spiller destruction.
@@ -402,9 +414,9 @@ class SpillerTest : public exec::test::RowContainerTestBase {
           minSpillRunSize,
           *pool_,
           executor());
-    } else if (type_ == Spiller::Type::kOrderBy) {
-      // We spill 'data' in one partition in type of kOrderBy, otherwise in 4
-      // partitions.
+    } else if (isSinglePartitionType(type_)) {
+      // We spill 'data' in one partition in type of kOrderBy and kWindow,
+      // otherwise in 4 partitions.
       spiller_ = std::make_unique<Spiller>(
           type_,
           rowContainer_.get(),
@@ -432,7 +444,7 @@ class SpillerTest : public exec::test::RowContainerTestBase {
           *pool_,
           executor());
     }
-    if (type_ == Spiller::Type::kOrderBy) {
+    if (isSinglePartitionType(type_)) {
       ASSERT_EQ(spiller_->state().maxPartitions(), 1);
     } else {
       ASSERT_EQ(spiller_->state().maxPartitions(), numPartitions_);
@@ -829,7 +841,8 @@ class NoHashJoinNoOrderBy : public SpillerTest,
         .typesToExclude =
             {Spiller::Type::kHashJoinProbe,
              Spiller::Type::kHashJoinBuild,
-             Spiller::Type::kOrderBy}}
+             Spiller::Type::kOrderBy,
+             Spiller::Type::kWindow}}
         .getTestParams();
   }
 };
@@ -1013,7 +1026,7 @@ TEST_P(NoHashJoinNoOrderBy, spillWithNonSpillingPartitions) {
 }
 
 TEST_P(AllTypes, nonSortedSpillFunctions) {
-  if (type_ == Spiller::Type::kOrderBy || type_ == Spiller::Type::kAggregate) {
+  if (isSinglePartitionType(type_) || type_ == Spiller::Type::kAggregate) {
     setupSpillData(rowType_, numKeys_, 1'000, 1, nullptr, {});
     sortSpillData();
     setupSpiller(100'000, 0, false);
@@ -236,6 +236,36 @@ TEST_F(StreamingAggregationTest, regularSizeInputBatches) {
   testAggregation(keys, 100);
 }
 
+TEST_F(StreamingAggregationTest, longGroupRuns) {
+  // Runs of more than kMinRowsPerGroupRun rows per group are added to the
+  // accumulators one group at a time. The runs span batches and the keys have
+  // different SIMD widths.
+  auto size = 1'024;
+  std::vector<VectorPtr> keys;
+  for (auto i = 0; i < 3; ++i) {
+    keys.push_back(makeFlatVector<int64_t>(
+        size, [&](auto row) { return (i * size + row) / 100; }));
+  }
+  testAggregation(keys);
+  testAggregation(keys, 10);
+
+  keys.clear();
+  for (auto i = 0; i < 3; ++i) {
+    keys.push_back(makeFlatVector<int16_t>(
+        size, [&](auto row) { return (i * size + row) / 37; }));
+  }
+  testAggregation(keys);
+
+  std::vector<RowVectorPtr> multiKeys;
+  for (auto i = 0; i < 3; ++i) {
+    multiKeys.push_back(makeRowVector({
+        makeFlatVector<int8_t>(size, [&](auto row) { return i; }),
+        makeFlatVector<int32_t>(size, [&](auto row) { return row / 50; }),
+    }));
+  }
+  testMultiKeyAggregation(multiKeys);
+}
+
 TEST_F(StreamingAggregationTest, uniqueKeys) {
   auto size = 1'024;
 
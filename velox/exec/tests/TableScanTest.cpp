@@ -17,8 +17,11 @@
 #include <velox/type/Timestamp.h>
 #include "velox/common/base/Fs.h"
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/connectors/hive/HiveConfig.h"
 #include "velox/connectors/hive/HiveConnector.h"
 #include "velox/connectors/hive/HiveConnectorSplit.h"
+#include "velox/connectors/hive/HiveSplitUtil.h"
+#include "velox/dwio/common/FileMetadataCache.h"
 #include "velox/dwio/common/tests/utils/DataFiles.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/exec/PlanNodeStats.h"
@@ -31,6 +34,7 @@
 #include "velox/type/tests/SubfieldFiltersBuilder.h"
 
 DECLARE_int32(split_preload_per_driver);
+DECLARE_int32(hive_decoded_data_cache_mb);
 
 using namespace facebook::velox;
 using namespace facebook::velox::connector::hive;
@@ -252,6 +256,76 @@ TEST_F(TableScanTest, connectorStats) {
   EXPECT_EQ(99, cacheStats.numLookups);
 }
 
+TEST_F(TableScanTest, fileMetadataCache) {
+  auto& metadataCache = dwio::common::FileMetadataCache::instance();
+  metadataCache.setCapacity(64 << 20);
+
+  auto vectors = makeVectors(10, 1'000);
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+  createDuckDbTable(vectors);
+
+  auto plan = tableScanNode();
+  assertQuery(plan, {filePath}, "SELECT * FROM tmp");
+  auto stats = metadataCache.stats();
+  EXPECT_EQ(1, stats.numElements);
+  EXPECT_EQ(0, stats.numHits);
+
+  // The second query reuses the footer parsed by the first.
+  assertQuery(plan, {filePath}, "SELECT * FROM tmp");
+  stats = metadataCache.stats();
+  EXPECT_EQ(1, stats.numElements);
+  EXPECT_EQ(1, stats.numHits);
+
+  metadataCache.setCapacity(0);
+}
+
+TEST_F(TableScanTest, decodedDataCache) {
+  // Replace the connector with one caching decoded data.
+  connector::unregisterConnector(kHiveConnectorId);
+  FLAGS_hive_decoded_data_cache_mb = 64;
+  auto hiveConnector =
+      std::dynamic_pointer_cast<connector::hive::HiveConnector>(
+          connector::getConnectorFactory(
+              connector::hive::HiveConnectorFactory::kHiveConnectorName)
+              ->newConnector(kHiveConnectorId, nullptr, ioExecutor_.get()));
+  FLAGS_hive_decoded_data_cache_mb = 0;
+  connector::registerConnector(hiveConnector);
+  auto* cache = hiveConnector->decodedDataCache();
+  ASSERT_NE(cache, nullptr);
+
+  auto vectors = makeVectors(10, 1'000);
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+  createDuckDbTable(vectors);
+
+  auto rowType = ROW({"c0", "c2"}, {BIGINT(), DOUBLE()});
+  auto plan = tableScanNode(rowType);
+  auto task = assertQuery(plan, {filePath}, "SELECT c0, c2 FROM tmp");
+  EXPECT_EQ(0, getTableScanRuntimeStats(task).count("decodedCacheHits"));
+  EXPECT_EQ(2, cache->stats().numInserts);
+
+  task = assertQuery(plan, {filePath}, "SELECT c0, c2 FROM tmp");
+  EXPECT_EQ(1, getTableScanRuntimeStats(task)["decodedCacheHits"].sum);
+  EXPECT_EQ(2, cache->stats().numHits);
+
+  // A different set of columns reads the split from the file and caches the
+  // missing column.
+  task = assertQuery(
+      tableScanNode(ROW({"c0", "c1"}, {BIGINT(), INTEGER()})),
+      {filePath},
+      "SELECT c0, c1 FROM tmp");
+  EXPECT_EQ(0, getTableScanRuntimeStats(task).count("decodedCacheHits"));
+  EXPECT_EQ(3, cache->stats().numInserts);
+
+  // Scans with filters are not cached.
+  auto filterPlan = PlanBuilder().tableScan(rowType, {"c0 < 0"}).planNode();
+  task = assertQuery(
+      filterPlan, {filePath}, "SELECT c0, c2 FROM tmp WHERE c0 < 0");
+  EXPECT_EQ(0, getTableScanRuntimeStats(task).count("decodedCacheHits"));
+  EXPECT_EQ(3, cache->stats().numInserts);
+}
+
 TEST_F(TableScanTest, columnAliases) {
   auto vectors = makeVectors(1, 1'000);
   auto filePath = TempFilePath::create();
@@ -781,6 +855,128 @@ TEST_F(TableScanTest, splitOffsetAndLength) {
       "SELECT * FROM tmp LIMIT 0");
 }
 
+TEST_F(TableScanTest, divideSplits) {
+  auto vectors = makeVectors(10, 1'000);
+  auto filePath = TempFilePath::create();
+  // Write a stripe per vector.
+  auto config = std::make_shared<dwrf::Config>();
+  config->set<uint64_t>(dwrf::Config::STRIPE_SIZE, 1);
+  writeToFile(filePath->path, vectors, config);
+  createDuckDbTable(vectors);
+
+  // Replace the connector with one dividing the splits into 4 parts.
+  connector::unregisterConnector(kHiveConnectorId);
+  const uint64_t maxSplitSize =
+      bits::roundUp(fs::file_size(filePath->path), 4) / 4;
+  auto properties = std::make_shared<const core::MemConfig>(
+      std::unordered_map<std::string, std::string>{
+          {connector::hive::HiveConfig::kMaxSplitSize,
+           std::to_string(maxSplitSize)}});
+  connector::registerConnector(
+      connector::getConnectorFactory(
+          connector::hive::HiveConnectorFactory::kHiveConnectorName)
+          ->newConnector(kHiveConnectorId, properties, ioExecutor_.get()));
+
+  auto task = AssertQueryBuilder(tableScanNode(), duckDbQueryRunner_)
+                  .split(makeHiveConnectorSplit(filePath->path))
+                  .maxDrivers(4)
+                  .assertResults("SELECT * FROM tmp");
+  ASSERT_EQ(task->taskStats().numTotalSplits, 4);
+  ASSERT_EQ(getTableScanStats(task).numSplits, 4);
+}
+
+TEST_F(TableScanTest, alignedSplits) {
+  auto vectors = makeVectors(10, 1'000);
+  auto filePath = TempFilePath::create();
+  // Write a stripe per vector.
+  auto config = std::make_shared<dwrf::Config>();
+  config->set<uint64_t>(dwrf::Config::STRIPE_SIZE, 1);
+  writeToFile(filePath->path, vectors, config);
+  createDuckDbTable(vectors);
+
+  auto file = std::make_shared<LocalReadFile>(filePath->path);
+  auto ranges = connector::hive::makeAlignedSplitRanges(
+      file, dwio::common::FileFormat::DWRF, *pool(), file->size() / 3);
+  ASSERT_GE(ranges.size(), 3);
+  ASSERT_LE(ranges.size(), 4);
+  std::vector<std::shared_ptr<connector::ConnectorSplit>> splits;
+  uint64_t numRows = 0;
+  for (auto& range : ranges) {
+    // Every split starts at a stripe and has rows to read.
+    ASSERT_GT(range.numRows, 0);
+    numRows += range.numRows;
+    splits.push_back(
+        makeHiveConnectorSplit(filePath->path, range.start, range.length));
+  }
+  ASSERT_EQ(numRows, 10'000);
+
+  auto task = AssertQueryBuilder(tableScanNode(), duckDbQueryRunner_)
+                  .splits(splits)
+                  .assertResults("SELECT * FROM tmp");
+  ASSERT_EQ(getTableScanStats(task).numSplits, ranges.size());
+  ASSERT_EQ(getTableScanStats(task).rawInputRows, 10'000);
+}
+
+TEST_F(TableScanTest, splitStealing) {
+  auto vectors = makeVectors(10, 1'000);
+  auto filePath = TempFilePath::create();
+  // Write a stripe per vector.
+  auto config = std::make_shared<dwrf::Config>();
+  config->set<uint64_t>(dwrf::Config::STRIPE_SIZE, 1);
+  writeToFile(filePath->path, vectors, config);
+  createDuckDbTable(vectors);
+
+  // The drivers without a split take over stripes of the single split. How
+  // many parts the split ends up in depends on timing.
+  auto task = AssertQueryBuilder(tableScanNode(), duckDbQueryRunner_)
+                  .split(makeHiveConnectorSplit(filePath->path))
+                  .config(core::QueryConfig::kTableScanSplitStealing, "true")
+                  .maxDrivers(4)
+                  .assertResults("SELECT * FROM tmp");
+  const auto numSplits = task->taskStats().numTotalSplits;
+  ASSERT_GE(numSplits, 1);
+  ASSERT_LE(numSplits, 10);
+  ASSERT_EQ(getTableScanStats(task).numSplits, numSplits);
+  ASSERT_EQ(task->taskStats().numFinishedSplits, numSplits);
+
+  // A limit closes the scan with its split unread. This must not leave the
+  // drivers waiting for a stolen split.
+  auto plan = PlanBuilder().tableScan(rowType_).limit(0, 10, true).planNode();
+  auto result = AssertQueryBuilder(plan)
+                    .split(makeHiveConnectorSplit(filePath->path))
+                    .config(core::QueryConfig::kTableScanSplitStealing, "true")
+                    .maxDrivers(4)
+                    .copyResults(pool());
+  ASSERT_GE(result->size(), 10);
+}
+
+TEST_F(TableScanTest, adaptiveScanDrivers) {
+  auto filePaths = makeFilePaths(10);
+  auto vectors = makeVectors(10, 1'000);
+  for (int32_t i = 0; i < vectors.size(); i++) {
+    writeToFile(filePaths[i]->path, vectors[i]);
+  }
+  createDuckDbTable(vectors);
+
+  // The Drivers held back at the start of the Task either start while the
+  // splits are queued or at the end, so that they all finish.
+  auto task = AssertQueryBuilder(tableScanNode(), duckDbQueryRunner_)
+                  .splits(makeHiveConnectorSplits(filePaths))
+                  .config(core::QueryConfig::kAdaptiveScanDrivers, "true")
+                  .maxDrivers(4)
+                  .assertResults("SELECT * FROM tmp");
+  ASSERT_EQ(task->numFinishedDrivers(), 4);
+  ASSERT_EQ(getTableScanStats(task).numSplits, 10);
+
+  // With a single split, the other Drivers start only to finish.
+  task = AssertQueryBuilder(tableScanNode())
+             .split(makeHiveConnectorSplit(filePaths[0]->path))
+             .config(core::QueryConfig::kAdaptiveScanDrivers, "true")
+             .maxDrivers(4)
+             .assertResults(vectors[0]);
+  ASSERT_EQ(task->numFinishedDrivers(), 4);
+}
+
 TEST_F(TableScanTest, fileNotFound) {
   CursorParameters params;
   params.planNode = tableScanNode();
@@ -893,6 +1089,235 @@ TEST_F(TableScanTest, partitionedTableDoubleKey) {
   testPartitionedTable(filePath->path, DOUBLE(), "3.5");
 }
 
+TEST_F(TableScanTest, partitionKeyFilter) {
+  auto rowType = ROW({"c0", "c1"}, {BIGINT(), DOUBLE()});
+  auto vectors = makeVectors(1, 1'000, rowType);
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+  createDuckDbTable(vectors);
+
+  auto outputType = ROW({"pkey", "c0"}, {BIGINT(), BIGINT()});
+  ColumnHandleMap assignments = {
+      {"pkey", partitionKey("pkey", BIGINT())},
+      {"c0", regularColumn("c0", BIGINT())}};
+  auto tableHandle = makeTableHandle(singleSubfieldFilter("pkey", equal(1)));
+  auto op = PlanBuilder()
+                .tableScan(outputType, tableHandle, assignments)
+                .planNode();
+
+  auto task = assertQuery(
+      op,
+      HiveConnectorSplitBuilder(filePath->path)
+          .partitionKey("pkey", "1")
+          .build(),
+      "SELECT '1', c0 FROM tmp");
+  EXPECT_EQ(getSkippedSplitsStat(task), 0);
+
+  // The splits of other partitions are skipped without opening their files,
+  // which don't exist.
+  for (const auto& value : {std::optional<std::string>("2"),
+                            std::optional<std::string>()}) {
+    task = assertQuery(
+        op,
+        HiveConnectorSplitBuilder("/path/to/nowhere.orc")
+            .partitionKey("pkey", value)
+            .build(),
+        "");
+    EXPECT_EQ(getSkippedSplitsStat(task), 1);
+    EXPECT_EQ(
+        getTableScanRuntimeStats(task)["skippedPartitionSplits"].sum, 1);
+  }
+}
+
+TEST_F(TableScanTest, splitStatistics) {
+  auto vector = makeRowVector({
+      makeFlatVector<int64_t>(100, [](auto row) { return row; }),
+      makeFlatVector<double>(100, [](auto row) { return row; }),
+  });
+  auto rowType = asRowType(vector->type());
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vector);
+  createDuckDbTable({vector});
+
+  auto statistics = std::make_shared<HiveSplitStatistics>();
+  statistics->numRows = 100;
+  statistics->columns["c0"] = {
+      BIGINT(),
+      std::make_shared<dwio::common::IntegerColumnStatistics>(
+          100, false, std::nullopt, std::nullopt, 0, 99, std::nullopt)};
+  statistics->columns["c1"] = {
+      DOUBLE(),
+      std::make_shared<dwio::common::DoubleColumnStatistics>(
+          100, false, std::nullopt, std::nullopt, 0, 99, std::nullopt)};
+  auto makeSplit = [&](const std::string& path) {
+    return HiveConnectorSplitBuilder(path).statistics(statistics).build();
+  };
+
+  auto task = assertQuery(
+      PlanBuilder().tableScan(rowType, {"c0 <= 50"}).planNode(),
+      makeSplit(filePath->path),
+      "SELECT * FROM tmp WHERE c0 <= 50");
+  EXPECT_EQ(getSkippedSplitsStat(task), 0);
+
+  // The splits excluded by the statistics are skipped without opening their
+  // files, which don't exist.
+  task = assertQuery(
+      PlanBuilder().tableScan(rowType, {"c0 > 100"}).planNode(),
+      makeSplit("/path/to/nowhere.orc"),
+      "");
+  EXPECT_EQ(getSkippedSplitsStat(task), 1);
+  EXPECT_EQ(getTableScanRuntimeStats(task)["skippedSplitsByMetadata"].sum, 1);
+
+  // The remaining filter is evaluated on the statistics through the metadata
+  // filter.
+  task = assertQuery(
+      PlanBuilder()
+          .tableScan(rowType, {}, "c0 > 100 OR c1 < -1.0")
+          .planNode(),
+      makeSplit("/path/to/nowhere.orc"),
+      "");
+  EXPECT_EQ(getTableScanRuntimeStats(task)["skippedSplitsByMetadata"].sum, 1);
+}
+
+TEST_F(TableScanTest, positionalDeletes) {
+  // 3 stripes of 10'000 rows.
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 3; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            10'000, [i](auto row) { return i * 10'000 + row; }),
+        makeFlatVector<double>(10'000, [](auto row) { return row % 10; }),
+    }));
+  }
+  auto rowType = asRowType(vectors[0]->type());
+  auto filePath = TempFilePath::create();
+  auto config = std::make_shared<dwrf::Config>();
+  config->set<uint64_t>(dwrf::Config::STRIPE_SIZE, 1);
+  writeToFile(filePath->path, vectors, config);
+  createDuckDbTable(vectors);
+
+  // Deletes every 7th row and rows 12'000 to 12'999 in 2 files, and a row of
+  // another data file.
+  const std::string splitPath = "file:" + filePath->path;
+  const std::string otherPath = "file:/other/file.orc";
+  auto makeDeleteFile = [&](const std::vector<int64_t>& positions,
+                            const std::string& path) {
+    auto deleteFile = TempFilePath::create();
+    writeToFile(
+        deleteFile->path,
+        makeRowVector(
+            {"file_path", "pos"},
+            {makeFlatVector<StringView>(
+                 positions.size(),
+                 [&](auto /*row*/) { return StringView(path); }),
+             makeFlatVector(positions)}));
+    return deleteFile;
+  };
+  std::vector<int64_t> sevenths;
+  for (int64_t row = 0; row < 30'000; row += 7) {
+    sevenths.push_back(row);
+  }
+  std::vector<int64_t> range;
+  for (int64_t row = 12'999; row >= 12'000; --row) {
+    range.push_back(row);
+  }
+  auto deleteFile1 = makeDeleteFile(sevenths, splitPath);
+  auto deleteFile2 = makeDeleteFile(range, splitPath);
+  auto otherDeleteFile = makeDeleteFile({1}, otherPath);
+  auto split = HiveConnectorSplitBuilder(filePath->path)
+                   .deleteFile(
+                       {HiveDeleteFile::Content::kPositionalDeletes,
+                        "file:" + deleteFile1->path,
+                        dwio::common::FileFormat::DWRF})
+                   .deleteFile(
+                       {HiveDeleteFile::Content::kPositionalDeletes,
+                        "file:" + deleteFile2->path,
+                        dwio::common::FileFormat::DWRF})
+                   .deleteFile(
+                       {HiveDeleteFile::Content::kPositionalDeletes,
+                        "file:" + otherDeleteFile->path,
+                        dwio::common::FileFormat::DWRF})
+                   .build();
+
+  const std::string notDeleted =
+      "c0 % 7 <> 0 AND (c0 < 12000 OR c0 >= 13000)";
+  assertQuery(
+      tableScanNode(rowType), split, "SELECT * FROM tmp WHERE " + notDeleted);
+
+  // The row numbers stay aligned with the deletes when filters drop rows.
+  assertQuery(
+      PlanBuilder().tableScan(rowType, {"c1 > 4.0"}).planNode(),
+      split,
+      "SELECT * FROM tmp WHERE c1 > 4.0 AND " + notDeleted);
+
+  // No column read.
+  assertQuery(
+      PlanBuilder()
+          .tableScan(ROW({}, {}))
+          .singleAggregation({}, {"count(1)"})
+          .planNode(),
+      split,
+      "SELECT count(*) FROM tmp WHERE " + notDeleted);
+}
+
+TEST_F(TableScanTest, equalityDeletes) {
+  auto vector = makeRowVector({
+      makeFlatVector<int64_t>(10'000, [](auto row) { return row; }),
+      makeFlatVector<StringView>(
+          10'000,
+          [](auto row) {
+            return StringView::makeInline(fmt::format("{}", row % 100));
+          },
+          [](auto row) { return row % 100 == 99; }),
+  });
+  auto rowType = asRowType(vector->type());
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vector);
+  createDuckDbTable({vector});
+
+  // Deletes the rows with c1 equal to '3', '42' or null and with c0 equal to
+  // 0, 1 or 2.
+  auto c1DeleteFile = TempFilePath::create();
+  writeToFile(
+      c1DeleteFile->path,
+      makeRowVector(
+          {"c1"},
+          {makeNullableFlatVector<StringView>({"3", "42", std::nullopt})}));
+  auto c0DeleteFile = TempFilePath::create();
+  writeToFile(
+      c0DeleteFile->path,
+      makeRowVector({"c0"}, {makeFlatVector<int64_t>({0, 1, 2})}));
+  auto split = HiveConnectorSplitBuilder(filePath->path)
+                   .deleteFile(
+                       {HiveDeleteFile::Content::kEqualityDeletes,
+                        "file:" + c1DeleteFile->path,
+                        dwio::common::FileFormat::DWRF,
+                        {"c1"}})
+                   .deleteFile(
+                       {HiveDeleteFile::Content::kEqualityDeletes,
+                        "file:" + c0DeleteFile->path,
+                        dwio::common::FileFormat::DWRF,
+                        {"c0"}})
+                   .build();
+
+  const std::string notDeleted =
+      "c1 IS NOT NULL AND c1 NOT IN ('3', '42') AND c0 > 2";
+  assertQuery(
+      tableScanNode(rowType), split, "SELECT * FROM tmp WHERE " + notDeleted);
+  assertQuery(
+      PlanBuilder().tableScan(rowType, {}, "c0 % 2 = 0").planNode(),
+      split,
+      "SELECT * FROM tmp WHERE c0 % 2 = 0 AND " + notDeleted);
+
+  // The equality columns must be read by the scan.
+  VELOX_ASSERT_THROW(
+      AssertQueryBuilder(
+          PlanBuilder().tableScan(ROW({"c0"}, {BIGINT()})).planNode())
+          .split(split)
+          .copyResults(pool()),
+      "Equality delete column c1 is not read by the scan");
+}
+
 std::vector<StringView> toStringViews(const std::vector<std::string>& values) {
   std::vector<StringView> views;
   views.reserve(values.size());
@@ -1583,6 +2008,63 @@ TEST_F(TableScanTest, filterPushdown) {
       "SELECT count(*) FROM tmp");
 }
 
+TEST_F(TableScanTest, topNDynamicFilter) {
+  // c0 is increasing across the files, c1 has many ties.
+  auto filePaths = makeFilePaths(10);
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < filePaths.size(); ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return i * 1'000 + row; }, nullEvery(23)),
+        makeFlatVector<int32_t>(1'000, [](auto row) { return row % 100; }),
+    }));
+    writeToFile(filePaths[i]->path, vectors.back());
+  }
+  createDuckDbTable(vectors);
+  auto rowType = asRowType(vectors[0]->type());
+
+  // The TopN on c0 filters out all the files after the first one.
+  auto task = assertQuery(
+      PlanBuilder().tableScan(rowType).topN({"c0"}, 10, false).planNode(),
+      filePaths,
+      "SELECT * FROM tmp ORDER BY c0 NULLS LAST LIMIT 10");
+  EXPECT_LE(getTableScanStats(task).outputRows, 1'000);
+  EXPECT_LT(0, getTableScanRuntimeStats(task)["dynamicFiltersAccepted"].sum);
+
+  // Nulls first pass the filter.
+  task = assertQuery(
+      PlanBuilder()
+          .tableScan(rowType)
+          .topN({"c0 DESC NULLS FIRST"}, 500, false)
+          .planNode(),
+      filePaths,
+      "SELECT * FROM tmp ORDER BY c0 DESC NULLS FIRST LIMIT 500");
+  EXPECT_LT(0, getTableScanRuntimeStats(task)["dynamicFiltersAccepted"].sum);
+
+  // Rows with a leading key equal to the threshold still enter on the next
+  // key.
+  task = assertQuery(
+      PlanBuilder()
+          .tableScan(rowType)
+          .topN({"c1 DESC", "c0 DESC"}, 50, false)
+          .planNode(),
+      filePaths,
+      "SELECT * FROM tmp ORDER BY c1 DESC, c0 DESC NULLS LAST LIMIT 50");
+  EXPECT_LT(0, getTableScanRuntimeStats(task)["dynamicFiltersAccepted"].sum);
+
+  // A projected key can't be filtered in the scan.
+  task = assertQuery(
+      PlanBuilder()
+          .tableScan(rowType)
+          .project({"c0 + 1 AS c0", "c1"})
+          .topN({"c0"}, 10, false)
+          .planNode(),
+      filePaths,
+      "SELECT c0 + 1, c1 FROM tmp ORDER BY 1 NULLS LAST LIMIT 10");
+  EXPECT_EQ(0, getTableScanRuntimeStats(task).count("dynamicFiltersAccepted"));
+  EXPECT_EQ(getTableScanStats(task).outputRows, 10'000);
+}
+
 TEST_F(TableScanTest, path) {
   auto rowType = ROW({"a"}, {BIGINT()});
   auto filePath = makeFilePaths(1)[0];
@@ -2112,6 +2594,196 @@ TEST_F(TableScanTest, aggregationPushdown) {
   EXPECT_EQ(0, loadedToValueHook(task));
 }
 
+TEST_F(TableScanTest, countAndGlobalAggregationPushdown) {
+  constexpr vector_size_t kSize = 10'000;
+  auto vector = makeRowVector(
+      {makeFlatVector<int64_t>(kSize, [](auto row) { return row % 10; }),
+       makeFlatVector<int64_t>(
+           kSize, [](auto row) { return row; }, nullEvery(7)),
+       makeFlatVector<bool>(
+           kSize, [](auto row) { return row % 3 == 0; }, nullEvery(11)),
+       makeFlatVector<StringView>(
+           kSize,
+           [](auto row) { return StringView(fmt::format("s{}", row % 17)); },
+           nullEvery(5))});
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vector);
+  createDuckDbTable({vector});
+  auto rowType = asRowType(vector->type());
+
+  auto loadedToValueHook = [](const std::shared_ptr<Task>& task,
+                              const core::PlanNodeId& aggregationId) {
+    auto stats = toPlanStats(task->taskStats()).at(aggregationId).customStats;
+    auto it = stats.find("loadedToValueHook");
+    return it != stats.end() ? it->second.sum : 0;
+  };
+
+  core::PlanNodeId aggregationId;
+  auto op = PlanBuilder()
+                .tableScan(rowType)
+                .singleAggregation(
+                    {"c0"}, {"count(c1)", "count_if(c2)", "count(c3)"})
+                .capturePlanNodeId(aggregationId)
+                .planNode();
+  auto task = assertQuery(
+      op,
+      {filePath},
+      "SELECT c0, count(c1), count_if(c2), count(c3) FROM tmp GROUP BY c0");
+  EXPECT_EQ(3 * kSize, loadedToValueHook(task, aggregationId));
+
+  // Aggregations without grouping keys are pushed down as well.
+  op = PlanBuilder()
+           .tableScan(rowType)
+           .singleAggregation(
+               {}, {"sum(c0)", "max(c1)", "count_if(c2)", "count(c3)"})
+           .capturePlanNodeId(aggregationId)
+           .planNode();
+  task = assertQuery(
+      op,
+      {filePath},
+      "SELECT sum(c0), max(c1), count_if(c2), count(c3) FROM tmp");
+  EXPECT_EQ(4 * kSize, loadedToValueHook(task, aggregationId));
+}
+
+TEST_F(TableScanTest, promoteRemainingFilters) {
+  constexpr vector_size_t kSize = 10'000;
+  auto vector = makeRowVector(
+      {makeFlatVector<int64_t>(kSize, [](auto row) { return row; }),
+       makeFlatVector<int64_t>(kSize, [](auto row) { return row % 7; }),
+       makeFlatVector<int64_t>(kSize, [](auto row) { return row; })});
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vector);
+  createDuckDbTable({vector});
+
+  core::PlanNodeId aggregationId;
+  auto plan = PlanBuilder()
+                  .tableScan(
+                      asRowType(vector->type()),
+                      {},
+                      "c0 >= 5000 AND c1 IS NOT NULL")
+                  .singleAggregation({"c1"}, {"sum(c2)"})
+                  .capturePlanNodeId(aggregationId)
+                  .planNode();
+  auto loadedToValueHook = [&](const std::shared_ptr<Task>& task) {
+    auto stats = toPlanStats(task->taskStats()).at(aggregationId).customStats;
+    auto it = stats.find("loadedToValueHook");
+    return it != stats.end() ? it->second.sum : 0;
+  };
+  const std::string sql =
+      "SELECT c1, sum(c2) FROM tmp WHERE c0 >= 5000 GROUP BY c1";
+
+  // The remaining filter wraps the lazy vectors of c2 in dictionaries.
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .split(makeHiveConnectorSplit(filePath->path))
+                  .assertResults(sql);
+  EXPECT_EQ(0, loadedToValueHook(task));
+
+  // Both conjuncts are evaluated by the column readers and c2 is aggregated
+  // as it is loaded.
+  task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+             .connectorConfig(
+                 kHiveConnectorId,
+                 connector::hive::HiveConfig::kPromoteRemainingFilters,
+                 "true")
+             .split(makeHiveConnectorSplit(filePath->path))
+             .assertResults(sql);
+  EXPECT_EQ(kSize / 2, loadedToValueHook(task));
+}
+
+TEST_F(TableScanTest, aggregationPushdownThroughJoin) {
+  constexpr vector_size_t kSize = 10'000;
+  auto probeVector = makeRowVector(
+      {"c0", "c1"},
+      {makeFlatVector<int64_t>(kSize, [](auto row) { return row % 100; }),
+       makeFlatVector<int64_t>(kSize, [](auto row) { return row; })});
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, {probeVector});
+  createDuckDbTable("t", {probeVector});
+
+  auto loadedToValueHook = [](const std::shared_ptr<Task>& task,
+                              const core::PlanNodeId& aggregationId) {
+    auto stats = toPlanStats(task->taskStats()).at(aggregationId).customStats;
+    auto it = stats.find("loadedToValueHook");
+    return it != stats.end() ? it->second.sum : 0;
+  };
+
+  auto makePlan = [&](const RowVectorPtr& buildVector,
+                      core::PlanNodeId& aggregationId) {
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    return PlanBuilder(planNodeIdGenerator)
+        .tableScan(asRowType(probeVector->type()))
+        .hashJoin(
+            {"c0"},
+            {"u0"},
+            PlanBuilder(planNodeIdGenerator).values({buildVector}).planNode(),
+            "",
+            {"c0", "c1", "u1"})
+        .singleAggregation({"c0"}, {"sum(c1)"})
+        .capturePlanNodeId(aggregationId)
+        .planNode();
+  };
+
+  // Each probe row matches at most once. The aggregation is pushed down into
+  // the LazyVectors the join passes through from the scan. The build side
+  // column 'u1' in the output keeps the join from being replaced by a dynamic
+  // filter.
+  auto buildVector = makeRowVector(
+      {"u0", "u1"},
+      {makeFlatVector<int64_t>(50, [](auto row) { return row * 2; }),
+       makeFlatVector<int64_t>(50, [](auto row) { return row; })});
+  createDuckDbTable("u", {buildVector});
+  core::PlanNodeId aggregationId;
+  auto task = assertQuery(
+      makePlan(buildVector, aggregationId),
+      {filePath},
+      "SELECT c0, sum(c1) FROM t, u WHERE c0 = u0 GROUP BY c0");
+  EXPECT_EQ(kSize / 2, loadedToValueHook(task, aggregationId));
+
+  // Each matching probe row repeats once per match. The aggregation loads the
+  // LazyVectors instead.
+  buildVector = makeRowVector(
+      {"u0", "u1"},
+      {makeFlatVector<int64_t>(100, [](auto row) { return row % 50 * 2; }),
+       makeFlatVector<int64_t>(100, [](auto row) { return row; })});
+  createDuckDbTable("u", {buildVector});
+  task = assertQuery(
+      makePlan(buildVector, aggregationId),
+      {filePath},
+      "SELECT c0, sum(c1) FROM t, u WHERE c0 = u0 GROUP BY c0");
+  EXPECT_EQ(0, loadedToValueHook(task, aggregationId));
+}
+
+TEST_F(TableScanTest, lazyVectorsNotLoaded) {
+  auto vectors = makeVectors(10, 1'000);
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->path, vectors);
+  createDuckDbTable(vectors);
+  auto rowType = ROW({"c0", "c1"}, {BIGINT(), INTEGER()});
+
+  // The filter drops all rows, so 'c1' is never loaded.
+  auto plan = PlanBuilder()
+                  .tableScan(rowType)
+                  .filter("c0 < 0 AND c0 > 0")
+                  .project({"c1"})
+                  .planNode();
+  auto task = assertQuery(
+      plan, {filePath}, "SELECT c1 FROM tmp WHERE c0 < 0 AND c0 > 0");
+  auto stats = getTableScanRuntimeStats(task);
+  EXPECT_GT(stats["lazyVectorsNotLoaded"].sum, 0);
+  // 4 bytes for each INTEGER value.
+  EXPECT_EQ(40'000, stats["lazyBytesNotLoaded"].sum);
+
+  plan = PlanBuilder()
+             .tableScan(rowType)
+             .filter("c0 % 2 = 0")
+             .project({"c1"})
+             .planNode();
+  task = assertQuery(plan, {filePath}, "SELECT c1 FROM tmp WHERE c0 % 2 = 0");
+  stats = getTableScanRuntimeStats(task);
+  EXPECT_EQ(0, stats["lazyVectorsNotLoaded"].sum);
+  EXPECT_EQ(0, stats["lazyBytesNotLoaded"].sum);
+}
+
 TEST_F(TableScanTest, bitwiseAggregationPushdown) {
   auto vectors = makeVectors(10, 1'000);
   auto filePath = TempFilePath::create();
@@ -2658,3 +3330,39 @@ TEST_F(TableScanTest, parallelPrepare) {
   }
   AssertQueryBuilder(plan).splits(splits).copyResults(pool_.get());
 }
+
+TEST_F(TableScanTest, batchSizeByBytes) {
+  // 2'000 rows of about 10KB each.
+  std::vector<std::string> values;
+  for (auto i = 0; i < 2'000; ++i) {
+    values.push_back(fmt::format("{}{}", i, std::string(10'000, 'a')));
+  }
+  auto wide = makeRowVector({makeFlatVector<StringView>(
+      2'000, [&](auto row) { return StringView(values[row]); })});
+  auto narrow = makeRowVector(
+      {makeFlatVector<int64_t>(20'000, [](auto row) { return row; })});
+
+  auto numBatches = [&](const RowVectorPtr& data, const std::string& bytes) {
+    auto filePath = TempFilePath::create();
+    writeToFile(filePath->path, {data});
+    core::PlanNodeId scanId;
+    auto plan = PlanBuilder()
+                    .tableScan(asRowType(data->type()))
+                    .capturePlanNodeId(scanId)
+                    .planNode();
+    auto task =
+        AssertQueryBuilder(plan)
+            .split(makeHiveSplit(filePath->path))
+            .config(core::QueryConfig::kPreferredOutputBatchBytes, bytes)
+            .assertResults(data);
+    return toPlanStats(task->taskStats()).at(scanId).outputVectors;
+  };
+
+  // About 100 rows per 1MB batch.
+  EXPECT_GE(numBatches(wide, "1000000"), 15);
+  EXPECT_LE(numBatches(wide, "100000000"), 2);
+
+  // Narrow rows fill batches of up to 10'000 rows instead of 1'024.
+  EXPECT_LE(numBatches(narrow, "100000000"), 3);
+  EXPECT_GE(numBatches(narrow, "1000"), 20);
+}
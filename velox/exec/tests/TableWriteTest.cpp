@@ -580,6 +580,119 @@ TEST_F(TableWriteTest, maxPartitions) {
       fmt::format("Exceeded limit of {} distinct partitions.", maxPartitions));
 }
 
+TEST_F(TableWriteTest, maxOpenWriters) {
+  const int32_t numPartitions = 4;
+  const int32_t numBatches = 3;
+
+  auto rowType = ROW({"c0", "p0"}, {BIGINT(), INTEGER()});
+  std::vector<std::string> partitionKeys = {"p0"};
+
+  auto vectors = makeBatches(numBatches, [&](auto batch) {
+    return makeRowVector(
+        rowType->names(),
+        {makeFlatVector<int64_t>(
+             100, [&](auto row) { return batch * 100 + row; }),
+         makeFlatVector<int32_t>(
+             100, [&](auto row) { return row % numPartitions; })});
+  });
+  createDuckDbTable(vectors);
+
+  // Returns the number of files written to each partition with a single
+  // open writer, checking the written data.
+  auto writeWithOneOpenWriter = [&](uint64_t sortByPartitionBufferBytes) {
+    auto outputDirectory = TempDirectoryPath::create();
+    auto plan = PlanBuilder()
+                    .values(vectors)
+                    .tableWrite(
+                        rowType->names(),
+                        std::make_shared<core::InsertTableHandle>(
+                            kHiveConnectorId,
+                            makeHiveInsertTableHandle(
+                                rowType->names(),
+                                rowType->children(),
+                                partitionKeys,
+                                makeLocationHandle(outputDirectory->path))),
+                        CommitStrategy::kNoCommit,
+                        "rows")
+                    .project({"rows"})
+                    .planNode();
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .connectorConfig(kHiveConnectorId, HiveConfig::kMaxOpenWriters, "1")
+        .connectorConfig(
+            kHiveConnectorId,
+            HiveConfig::kSortByPartitionBufferBytes,
+            folly::to<std::string>(sortByPartitionBufferBytes))
+        .assertResults("SELECT count(*) FROM tmp");
+
+    assertQuery(
+        PlanBuilder().tableScan(rowType).planNode(),
+        makeHiveConnectorSplits(outputDirectory),
+        "SELECT * FROM tmp");
+
+    auto partitionDirectories = getLeafSubdirectories(outputDirectory->path);
+    EXPECT_EQ(partitionDirectories.size(), numPartitions);
+    std::set<uint32_t> numFiles;
+    for (const auto& directory : partitionDirectories) {
+      numFiles.insert(countRecursiveFiles(directory));
+    }
+    EXPECT_EQ(numFiles.size(), 1);
+    return *numFiles.begin();
+  };
+
+  // Every input writes to all partitions, so that each write closes the
+  // writer of the previous partition and the partitions get a file per input.
+  EXPECT_EQ(writeWithOneOpenWriter(0), numBatches);
+
+  // With the inputs buffered and written one partition after the other, the
+  // partitions get a single file.
+  EXPECT_EQ(writeWithOneOpenWriter(1 << 30), 1);
+}
+
+TEST_F(TableWriteTest, scaleWriters) {
+  auto vectors = makeVectors(rowType_, 10, 1'000);
+  createDuckDbTable(vectors);
+
+  // Returns the number of files written by 4 writer drivers.
+  auto write = [&](const std::string& minProcessedBytes) {
+    auto outputDirectory = TempDirectoryPath::create();
+    auto plan = PlanBuilder()
+                    .values(vectors)
+                    .localPartitionScaleWriter()
+                    .tableWrite(
+                        rowType_->names(),
+                        std::make_shared<core::InsertTableHandle>(
+                            kHiveConnectorId,
+                            makeHiveInsertTableHandle(
+                                rowType_->names(),
+                                rowType_->children(),
+                                {},
+                                makeLocationHandle(outputDirectory->path))),
+                        CommitStrategy::kNoCommit,
+                        "rows")
+                    .planNode();
+    AssertQueryBuilder(plan)
+        .maxDrivers(4)
+        .config(
+            core::QueryConfig::kScaleWriterMinProcessedBytes, minProcessedBytes)
+        .copyResults(pool());
+
+    assertQuery(
+        PlanBuilder().tableScan(rowType_).planNode(),
+        makeHiveConnectorSplits(outputDirectory),
+        "SELECT * FROM tmp");
+    return countRecursiveFiles(outputDirectory->path);
+  };
+
+  // A small write stays on one writer and makes one file.
+  ASSERT_EQ(write("1073741824"), 1);
+
+  // Additional writers get data only if the active ones fall behind, which
+  // depends on timing.
+  const auto numFiles = write("0");
+  ASSERT_GE(numFiles, 1);
+  ASSERT_LE(numFiles, 4);
+}
+
 // Test TableWriter does not create a file if input is empty.
 TEST_F(TableWriteTest, writeNoFile) {
   auto outputDirectory = TempDirectoryPath::create();
@@ -13,6 +13,9 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <folly/json.h>
+
+#include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
@@ -147,3 +150,52 @@ TEST_F(TaskListenerTest, multipleListeners) {
   ASSERT_TRUE(exec::unregisterTaskListener(listener1));
   ASSERT_TRUE(exec::unregisterTaskListener(listener2));
 }
+
+TEST_F(TaskListenerTest, driverTimeline) {
+  auto data = makeRowVector({makeFlatVector<int32_t>({0, 1, 2, 3, 4})});
+  auto plan = PlanBuilder().values({data, data}).planNode();
+
+  auto listener = std::make_shared<TestTaskListener>();
+  auto& events = listener->events();
+  ASSERT_TRUE(exec::registerTaskListener(listener));
+
+  for (const auto samplePct : {0, 100}) {
+    SCOPED_TRACE(fmt::format("samplePct: {}", samplePct));
+    events.clear();
+    CursorParameters params;
+    params.planNode = plan;
+    params.queryCtx = std::make_shared<core::QueryCtx>(
+        executor_.get(),
+        std::make_shared<core::MemConfig>(
+            std::unordered_map<std::string, std::string>{
+                {core::QueryConfig::kDriverTimelineSamplePct,
+                 std::to_string(samplePct)}}));
+    readCursor(params, [](auto) {});
+    ASSERT_EQ(1, events.size());
+
+    const auto& timeline = events.back().stats.driverTimeline;
+    if (samplePct == 0) {
+      ASSERT_TRUE(timeline.empty());
+      continue;
+    }
+    // Each Driver waits in the queue before it runs.
+    std::unordered_set<int32_t> runningDrivers;
+    std::unordered_set<int32_t> queuedDrivers;
+    for (const auto& event : timeline) {
+      if (event.kind == exec::DriverTimelineEvent::Kind::kRun) {
+        runningDrivers.insert(event.driverId);
+      } else if (event.kind == exec::DriverTimelineEvent::Kind::kQueued) {
+        queuedDrivers.insert(event.driverId);
+      }
+    }
+    ASSERT_FALSE(runningDrivers.empty());
+    ASSERT_EQ(runningDrivers, queuedDrivers);
+
+    const auto trace = folly::parseJson(
+        folly::toJson(exec::toDriverTimelineTrace(events.back().stats)));
+    ASSERT_EQ(timeline.size(), trace["traceEvents"].size());
+    ASSERT_EQ("X", trace["traceEvents"][0]["ph"].asString());
+  }
+
+  ASSERT_TRUE(exec::unregisterTaskListener(listener));
+}
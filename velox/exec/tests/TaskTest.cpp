@@ -19,6 +19,7 @@
 #include "velox/common/future/VeloxPromise.h"
 #include "velox/common/testutil/TestValue.h"
 #include "velox/connectors/hive/HiveConnector.h"
+#include "velox/exec/LocalPlanner.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/Values.h"
@@ -829,6 +830,76 @@ TEST_F(TaskTest, supportsSingleThreadedExecution) {
   ASSERT_FALSE(task->supportsSingleThreadedExecution());
 }
 
+TEST_F(TaskTest, plannedFragment) {
+  std::vector<RowVectorPtr> data;
+  std::vector<std::shared_ptr<TempFilePath>> files;
+  for (auto i = 0; i < 3; ++i) {
+    data.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [i](auto row) { return row + i * 1'000; }),
+    }));
+    files.push_back(TempFilePath::create());
+    writeToFile(files.back()->path, {data.back()});
+  }
+
+  core::PlanNodeId scanId;
+  auto planned = PlannedFragment::create(
+      PlanBuilder()
+          .tableScan(asRowType(data[0]->type()))
+          .capturePlanNodeId(scanId)
+          .filter("c0 % 10 = 0")
+          .project({"c0 + 1"})
+          .planFragment());
+
+  auto expected = [&](auto i) {
+    return makeRowVector({
+        makeFlatVector<int64_t>(
+            100, [i](auto row) { return row * 10 + i * 1'000 + 1; }),
+    });
+  };
+
+  // Each task runs the same planned fragment over its own split.
+  for (auto i = 0; i < files.size(); ++i) {
+    std::mutex mutex;
+    std::vector<RowVectorPtr> results;
+    auto task = std::make_shared<exec::Task>(
+        fmt::format("planned.task.{}", i),
+        planned,
+        0,
+        std::make_shared<core::QueryCtx>(driverExecutor_.get()),
+        [&]() -> Consumer {
+          return [&](RowVectorPtr vector, ContinueFuture* /*future*/) {
+            if (vector) {
+              std::lock_guard<std::mutex> l(mutex);
+              results.push_back(vector);
+            }
+            return BlockingReason::kNotBlocked;
+          };
+        });
+    Task::start(task, 2);
+    task->addSplit(scanId, exec::Split(makeHiveConnectorSplit(files[i]->path)));
+    task->noMoreSplits(scanId);
+    ASSERT_TRUE(waitForTaskCompletion(task.get()));
+    assertEqualResults({expected(i)}, results);
+  }
+
+  // Single-threaded execution.
+  auto task = std::make_shared<exec::Task>(
+      "planned.task.single",
+      planned,
+      0,
+      std::make_shared<core::QueryCtx>(),
+      ConsumerSupplier{});
+  task->addSplit(scanId, exec::Split(makeHiveConnectorSplit(files[0]->path)));
+  task->noMoreSplits(scanId);
+  ASSERT_TRUE(task->supportsSingleThreadedExecution());
+  std::vector<RowVectorPtr> results;
+  while (auto result = task->next()) {
+    results.push_back(result);
+  }
+  assertEqualResults({expected(0)}, results);
+}
+
 TEST_F(TaskTest, updateBroadCastOutputBuffers) {
   auto plan = PlanBuilder()
                   .tableScan(ROW({"c0"}, {BIGINT()}))
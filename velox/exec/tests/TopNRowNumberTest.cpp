@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec::test;
+
+class TopNRowNumberTest : public OperatorTestBase {
+ protected:
+  // Returns 4 batches of 1'000 rows. c0 has 17 distinct values and nulls, c1
+  // is unique, c2 has many ties and nulls.
+  std::vector<RowVectorPtr> makeVectors() {
+    std::vector<RowVectorPtr> vectors;
+    for (int32_t i = 0; i < 4; ++i) {
+      vectors.push_back(makeRowVector({
+          makeFlatVector<int32_t>(
+              1'000, [](auto row) { return row % 17; }, nullEvery(23)),
+          makeFlatVector<int64_t>(
+              1'000, [&](auto row) { return i * 1'000 + row * 7 % 1'000; }),
+          makeFlatVector<StringView>(
+              1'000,
+              [](auto row) {
+                return StringView::makeInline(std::to_string(row % 5));
+              },
+              nullEvery(7)),
+      }));
+    }
+    return vectors;
+  }
+
+  // Returns the DuckDB query that filters the row numbers of the
+  // 'partitionBy' and 'orderBy' window on 'limit'.
+  static std::string rowNumberSql(
+      const std::string& partitionBy,
+      const std::string& orderBy,
+      int32_t limit,
+      bool generateRowNumber) {
+    return fmt::format(
+        "SELECT {} FROM (SELECT *, row_number() OVER ({} ORDER BY {}) AS rn "
+        "FROM tmp) t WHERE rn <= {}",
+        generateRowNumber ? "*" : "c0, c1, c2",
+        partitionBy.empty() ? "" : "PARTITION BY " + partitionBy,
+        orderBy,
+        limit);
+  }
+};
+
+TEST_F(TopNRowNumberTest, basic) {
+  auto vectors = makeVectors();
+  createDuckDbTable(vectors);
+
+  for (const auto limit : {1, 3, 100, 1'000}) {
+    for (const auto generateRowNumber : {true, false}) {
+      SCOPED_TRACE(fmt::format(
+          "limit: {} generateRowNumber: {}", limit, generateRowNumber));
+      auto plan =
+          PlanBuilder()
+              .values(vectors)
+              .topNRowNumber({"c0"}, {"c1"}, limit, generateRowNumber)
+              .planNode();
+      assertQuery(
+          plan, rowNumberSql("c0", "c1 NULLS LAST", limit, generateRowNumber));
+
+      plan = PlanBuilder()
+                 .values(vectors)
+                 .topNRowNumber(
+                     {"c0", "c2"}, {"c1 DESC"}, limit, generateRowNumber)
+                 .planNode();
+      assertQuery(
+          plan,
+          rowNumberSql(
+              "c0, c2", "c1 DESC NULLS LAST", limit, generateRowNumber));
+    }
+  }
+}
+
+TEST_F(TopNRowNumberTest, noPartitionKeys) {
+  auto vectors = makeVectors();
+  createDuckDbTable(vectors);
+
+  for (const auto limit : {1, 10, 5'000}) {
+    SCOPED_TRACE(fmt::format("limit: {}", limit));
+    auto plan = PlanBuilder()
+                    .values(vectors)
+                    .topNRowNumber({}, {"c1 DESC"}, limit, true)
+                    .planNode();
+    assertQuery(plan, rowNumberSql("", "c1 DESC NULLS LAST", limit, true));
+  }
+}
+
+TEST_F(TopNRowNumberTest, multipleSortingKeys) {
+  auto vectors = makeVectors();
+  createDuckDbTable(vectors);
+
+  // The rows are unique by c2 and c1.
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .topNRowNumber({"c0"}, {"c2 NULLS FIRST", "c1 DESC"}, 5, true)
+                  .planNode();
+  assertQuery(
+      plan, rowNumberSql("c0", "c2 NULLS FIRST, c1 DESC NULLS LAST", 5, true));
+}
+
+TEST_F(TopNRowNumberTest, partialAndFinal) {
+  auto vectors = makeVectors();
+  createDuckDbTable(vectors);
+
+  // The partial step keeps the top rows of each partition without numbering
+  // them, the final step keeps the top rows of the partial results.
+  core::PlanNodeId partialId;
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .topNRowNumber({"c0"}, {"c1"}, 3, false)
+                  .capturePlanNodeId(partialId)
+                  .topNRowNumber({"c0"}, {"c1"}, 3, true)
+                  .planNode();
+  auto task = assertQuery(plan, rowNumberSql("c0", "c1 NULLS LAST", 3, true));
+  // 17 partitions and the nulls.
+  EXPECT_EQ(
+      18 * 3, toPlanStats(task->taskStats()).at(partialId).outputRows);
+}
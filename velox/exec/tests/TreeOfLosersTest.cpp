@@ -241,3 +241,38 @@ TEST_F(TreeOfLosersTest, randomWithDuplicates) {
     }
   }
 }
+
+TEST_F(TreeOfLosersTest, runnerUp) {
+  constexpr int32_t kNumStreams = 11;
+  std::vector<std::unique_ptr<TestingStream>> mergeStreams;
+  std::vector<TestingStream*> streams;
+  for (auto i = 0; i < kNumStreams; ++i) {
+    std::vector<uint32_t> numbers;
+    for (auto j = 0; j < 100; ++j) {
+      numbers.push_back(folly::Random::rand32(rng_) % 1000);
+    }
+    // TestingStream produces reverse order.
+    std::sort(numbers.begin(), numbers.end(), std::greater<uint32_t>());
+    mergeStreams.push_back(std::make_unique<TestingStream>(std::move(numbers)));
+    streams.push_back(mergeStreams.back().get());
+  }
+  TreeOfLosers<TestingStream> merge(std::move(mergeStreams));
+  while (auto stream = merge.next()) {
+    std::optional<uint32_t> expected;
+    for (auto other : streams) {
+      if (other != stream && other->hasData()) {
+        auto value = other->current()->value();
+        expected = expected.has_value() ? std::min(*expected, value) : value;
+      }
+    }
+    auto runnerUp = merge.runnerUp();
+    if (!expected.has_value()) {
+      ASSERT_EQ(runnerUp, nullptr);
+    } else {
+      ASSERT_NE(runnerUp, nullptr);
+      ASSERT_NE(runnerUp, stream);
+      ASSERT_EQ(runnerUp->current()->value(), *expected);
+    }
+    stream->pop();
+  }
+}
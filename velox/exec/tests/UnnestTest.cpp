@@ -13,6 +13,8 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 
@@ -403,3 +405,38 @@ TEST_F(UnnestTest, allEmptyOrNullMaps) {
            .planNode();
   assertQueryReturnsEmptyResult(op);
 }
+
+TEST_F(UnnestTest, splitLargeArrays) {
+  // Row i has an array of 10 * i elements and a map of 5 * i entries. The
+  // array of row 7 is null, making 415 output rows in batches of 17.
+  auto vector = makeRowVector({
+      makeFlatVector<int64_t>(10, [](auto row) { return row; }),
+      makeArrayVector<int32_t>(
+          10,
+          [](auto row) { return row * 10; },
+          [](auto row, auto index) { return row * 100 + index; },
+          nullEvery(7)),
+      makeMapVector<int32_t, int64_t>(
+          10,
+          [](auto row) { return row * 5; },
+          [](auto row) { return row; },
+          [](auto row) { return row * 2; }),
+  });
+
+  core::PlanNodeId unnestId;
+  auto op = PlanBuilder()
+                .values({vector})
+                .unnest({"c0"}, {"c1", "c2"}, "ordinal")
+                .capturePlanNodeId(unnestId)
+                .planNode();
+  auto expected = AssertQueryBuilder(op).copyResults(pool());
+  ASSERT_EQ(expected->size(), 415);
+
+  auto task =
+      AssertQueryBuilder(op)
+          .config(core::QueryConfig::kPreferredOutputBatchSize, "17")
+          .assertResults(expected);
+  auto stats = toPlanStats(task->taskStats()).at(unnestId);
+  ASSERT_EQ(stats.outputRows, 415);
+  ASSERT_EQ(stats.outputVectors, 25);
+}
@@ -17,6 +17,7 @@
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/QueryAssertions.h"
 
 using namespace facebook::velox;
 using exec::test::AssertQueryBuilder;
@@ -109,4 +110,54 @@ TEST_F(ValuesTest, valuesWithRepeatAndParallelism) {
           {input_, input2_, input_, input2_, input_, input2_, input_, input2_});
 }
 
+TEST_F(ValuesTest, generatorSource) {
+  auto rowType = ROW({"a", "b", "c"}, {BIGINT(), VARCHAR(), ARRAY(INTEGER())});
+  VectorFuzzer::Options options;
+  options.vectorSize = 100;
+  options.nullRatio = 0.1;
+
+  // A single driver makes the same batches as VectorFuzzer with the seed.
+  VectorFuzzer fuzzer(options, pool(), 7);
+  std::vector<RowVectorPtr> expected;
+  for (auto i = 0; i < 3; ++i) {
+    expected.push_back(fuzzer.fuzzInputRow(rowType));
+  }
+  auto plan = PlanBuilder().generatorSource(rowType, 3, options, 7).planNode();
+  AssertQueryBuilder(plan).assertResults(expected);
+
+  // Each driver makes its own batches, the same in every run.
+  auto first = AssertQueryBuilder(plan).maxDrivers(4).copyResults(pool());
+  EXPECT_EQ(4 * 3 * 100, first->size());
+  auto second = AssertQueryBuilder(plan).maxDrivers(4).copyResults(pool());
+  assertEqualResults({first}, {second});
+
+  // Zero batches.
+  AssertQueryBuilder(PlanBuilder().generatorSource(rowType, 0).planNode())
+      .assertEmptyResults();
+}
+
+TEST_F(ValuesTest, generatorSourceWithSpec) {
+  using namespace generator_spec_maker;
+  auto rowType = ROW({"a", "b"}, {BIGINT(), DOUBLE()});
+  auto spec = RANDOM_ROW(
+      {RANDOM_BIGINT(std::uniform_int_distribution<int64_t>(10, 20)),
+       RANDOM_DOUBLE(std::uniform_real_distribution<double>(0, 1))});
+  VectorFuzzer::Options options;
+  options.vectorSize = 1'000;
+  auto plan =
+      PlanBuilder().generatorSource(rowType, 5, options, 1, spec).planNode();
+  auto result = AssertQueryBuilder(plan).maxDrivers(2).copyResults(pool());
+  EXPECT_EQ(2 * 5 * 1'000, result->size());
+  EXPECT_EQ(*rowType, *result->type());
+
+  // All the values are in the ranges of the distributions.
+  AssertQueryBuilder(
+      PlanBuilder()
+          .generatorSource(rowType, 5, options, 1, spec)
+          .filter("a < 10 or a > 20 or b < 0 or b >= 1")
+          .planNode())
+      .maxDrivers(2)
+      .assertEmptyResults();
+}
+
 } // namespace facebook::velox::exec::test
@@ -302,6 +302,63 @@ TEST_F(VectorHasherTest, dictionary) {
   }
 }
 
+// Tests that hashes and value ids computed for the base of a dictionary are
+// reused for the next dictionary over the same base and not for others.
+TEST_F(VectorHasherTest, dictionaryAcrossBatches) {
+  auto hasher = exec::VectorHasher::create(BIGINT(), 1);
+  auto base = vectorMaker_->flatVector<int64_t>(
+      10, [](vector_size_t row) { return row + 3; });
+  auto otherBase = vectorMaker_->flatVector<int64_t>(
+      10, [](vector_size_t row) { return row * 100; });
+  auto makeDictionary = [&](const VectorPtr& values, int32_t shift) {
+    BufferPtr indices =
+        AlignedBuffer::allocate<vector_size_t>(100, pool_.get());
+    auto rawIndices = indices->asMutable<vector_size_t>();
+    for (int32_t i = 0; i < 100; i++) {
+      rawIndices[i] = (i + shift) % 10;
+    }
+    return BaseVector::wrapInDictionary(
+        BufferPtr(nullptr), indices, 100, values);
+  };
+
+  raw_vector<uint64_t> hashes(100);
+  for (auto shift = 0; shift < 3; ++shift) {
+    auto dictionary = makeDictionary(shift == 2 ? otherBase : base, shift);
+    hasher->decode(*dictionary, allRows_);
+    hasher->hash(allRows_, false, hashes);
+    for (int32_t i = 0; i < 100; i++) {
+      int64_t value =
+          shift == 2 ? (i + shift) % 10 * 100 : (i + shift) % 10 + 3;
+      ASSERT_EQ(hashes[i], folly::hasher<int64_t>()(value)) << "at " << i;
+    }
+  }
+
+  hasher->decode(*makeDictionary(base, 0), allRows_);
+  ASSERT_FALSE(hasher->computeValueIds(allRows_, hashes));
+  hasher->enableValueIds(1, 0);
+  for (auto shift = 0; shift < 2; ++shift) {
+    hasher->decode(*makeDictionary(base, shift), allRows_);
+    ASSERT_TRUE(hasher->computeValueIds(allRows_, hashes));
+    for (int32_t i = 0; i < 100; i++) {
+      // The ids are assigned in the order the values were first seen.
+      ASSERT_EQ(hashes[i], (i + shift) % 10 + 1) << "at " << i;
+    }
+  }
+
+  // The value ids change with the mode of the hasher.
+  hasher->enableValueRange(1, 50);
+  hasher->decode(*makeDictionary(base, 0), allRows_);
+  ASSERT_TRUE(hasher->computeValueIds(allRows_, hashes));
+  SelectivityVector baseRows(base->size());
+  raw_vector<uint64_t> baseIds(base->size());
+  hasher->decode(*base, baseRows);
+  ASSERT_TRUE(hasher->computeValueIds(baseRows, baseIds));
+  for (int32_t i = 0; i < 100; i++) {
+    ASSERT_EQ(hashes[i], baseIds[i % 10]) << "at " << i;
+  }
+  ASSERT_NE(baseIds[0], 1);
+}
+
 // Tests how strings are mapped to uint64_t (if they fit) and to
 // consecutive ids of distinct values for the general case.
 TEST_F(VectorHasherTest, stringIds) {
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/tests/utils/GeneratorSource.h"
+
+#include <mutex>
+
+namespace facebook::velox::exec::test {
+
+namespace {
+const std::vector<core::PlanNodePtr> kEmptySources;
+
+class GeneratorSourceTranslator : public Operator::PlanNodeTranslator {
+ public:
+  std::unique_ptr<Operator> toOperator(
+      DriverCtx* ctx,
+      int32_t id,
+      const core::PlanNodePtr& node) override {
+    if (auto generatorNode =
+            std::dynamic_pointer_cast<const GeneratorSourceNode>(node)) {
+      return std::make_unique<GeneratorSource>(id, ctx, generatorNode);
+    }
+    return nullptr;
+  }
+};
+} // namespace
+
+const std::vector<core::PlanNodePtr>& GeneratorSourceNode::sources() const {
+  return kEmptySources;
+}
+
+void GeneratorSourceNode::addDetails(std::stringstream& stream) const {
+  stream << numBatches_ << " batches of " << options_.vectorSize
+         << " rows per driver, seed " << seed_;
+}
+
+GeneratorSource::GeneratorSource(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    std::shared_ptr<const GeneratorSourceNode> node)
+    : SourceOperator(
+          driverCtx,
+          node->outputType(),
+          operatorId,
+          node->id(),
+          "GeneratorSource"),
+      generatorSpec_(node->generatorSpec()),
+      batchSize_(node->options().vectorSize),
+      numBatchesLeft_(batchSize_ > 0 ? node->numBatches() : 0),
+      fuzzer_(node->options(), pool(), node->seed() + driverCtx->driverId),
+      rng_(node->seed() + driverCtx->driverId) {}
+
+RowVectorPtr GeneratorSource::getOutput() {
+  if (numBatchesLeft_ == 0) {
+    return nullptr;
+  }
+  --numBatchesLeft_;
+  if (generatorSpec_ != nullptr) {
+    // Takes the column names of the node.
+    auto data = std::static_pointer_cast<RowVector>(
+        generatorSpec_->generateData(rng_, pool(), batchSize_));
+    return std::make_shared<RowVector>(
+        pool(), outputType_, data->nulls(), data->size(), data->children());
+  }
+  return fuzzer_.fuzzInputRow(outputType_);
+}
+
+void registerGeneratorSource() {
+  static std::once_flag registered;
+  std::call_once(registered, []() {
+    Operator::registerOperator(std::make_unique<GeneratorSourceTranslator>());
+  });
+}
+
+} // namespace facebook::velox::exec::test
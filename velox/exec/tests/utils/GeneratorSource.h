@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/core/PlanNode.h"
+#include "velox/exec/Operator.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+
+namespace facebook::velox::exec::test {
+
+/// Source plan node that produces 'numBatches' batches of random data on each
+/// driver for benchmarks and load tests. Unlike a parallelizable ValuesNode,
+/// the batches are generated by the operator when asked for, so that no input
+/// is made before the query runs and the drivers do not share vectors. The
+/// data of a driver is deterministic for a 'seed' and depends only on the
+/// driver id. By default, the batches come from VectorFuzzer::fuzzInputRow
+/// with 'options'. If 'generatorSpec' is set, they come from it instead, with
+/// 'options.vectorSize' rows each. The drivers use it concurrently, so its
+/// distributions must not keep state between calls.
+class GeneratorSourceNode : public core::PlanNode {
+ public:
+  GeneratorSourceNode(
+      const core::PlanNodeId& id,
+      RowTypePtr outputType,
+      int32_t numBatches,
+      VectorFuzzer::Options options,
+      size_t seed,
+      GeneratorSpecPtr generatorSpec = nullptr)
+      : PlanNode(id),
+        outputType_(std::move(outputType)),
+        numBatches_(numBatches),
+        options_(std::move(options)),
+        seed_(seed),
+        generatorSpec_(std::move(generatorSpec)) {
+    VELOX_CHECK_GE(numBatches_, 0);
+    VELOX_CHECK(
+        generatorSpec_ == nullptr ||
+        generatorSpec_->type()->equivalent(*outputType_));
+  }
+
+  const RowTypePtr& outputType() const override {
+    return outputType_;
+  }
+
+  const std::vector<core::PlanNodePtr>& sources() const override;
+
+  std::string_view name() const override {
+    return "GeneratorSource";
+  }
+
+  int32_t numBatches() const {
+    return numBatches_;
+  }
+
+  const VectorFuzzer::Options& options() const {
+    return options_;
+  }
+
+  size_t seed() const {
+    return seed_;
+  }
+
+  const GeneratorSpecPtr& generatorSpec() const {
+    return generatorSpec_;
+  }
+
+ private:
+  void addDetails(std::stringstream& stream) const override;
+
+  const RowTypePtr outputType_;
+  const int32_t numBatches_;
+  const VectorFuzzer::Options options_;
+  const size_t seed_;
+  const GeneratorSpecPtr generatorSpec_;
+};
+
+class GeneratorSource : public SourceOperator {
+ public:
+  GeneratorSource(
+      int32_t operatorId,
+      DriverCtx* driverCtx,
+      std::shared_ptr<const GeneratorSourceNode> node);
+
+  RowVectorPtr getOutput() override;
+
+  BlockingReason isBlocked(ContinueFuture* /* unused */) override {
+    return BlockingReason::kNotBlocked;
+  }
+
+  bool isFinished() override {
+    return numBatchesLeft_ == 0;
+  }
+
+  void close() override {
+    numBatchesLeft_ = 0;
+    SourceOperator::close();
+  }
+
+ private:
+  const GeneratorSpecPtr generatorSpec_;
+  const vector_size_t batchSize_;
+  int32_t numBatchesLeft_;
+  VectorFuzzer fuzzer_;
+  // Used with 'generatorSpec_'.
+  FuzzerGenerator rng_;
+};
+
+/// Registers the translation of GeneratorSourceNode to GeneratorSource.
+/// Repeated calls have no effect.
+void registerGeneratorSource();
+
+} // namespace facebook::velox::exec::test
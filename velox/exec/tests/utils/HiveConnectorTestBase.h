@@ -171,6 +171,18 @@ class HiveConnectorSplitBuilder {
     return *this;
   }
 
+  HiveConnectorSplitBuilder& statistics(
+      std::shared_ptr<const connector::hive::HiveSplitStatistics> statistics) {
+    statistics_ = std::move(statistics);
+    return *this;
+  }
+
+  HiveConnectorSplitBuilder& deleteFile(
+      connector::hive::HiveDeleteFile deleteFile) {
+    deleteFiles_.push_back(std::move(deleteFile));
+    return *this;
+  }
+
   std::shared_ptr<connector::hive::HiveConnectorSplit> build() const {
     return std::make_shared<connector::hive::HiveConnectorSplit>(
         kHiveConnectorId,
@@ -179,7 +191,9 @@ class HiveConnectorSplitBuilder {
         start_,
         length_,
         partitionKeys_,
-        tableBucketNumber_);
+        tableBucketNumber_,
+        statistics_,
+        deleteFiles_);
   }
 
  private:
@@ -189,6 +203,8 @@ class HiveConnectorSplitBuilder {
   uint64_t length_{std::numeric_limits<uint64_t>::max()};
   std::unordered_map<std::string, std::optional<std::string>> partitionKeys_;
   std::optional<int32_t> tableBucketNumber_;
+  std::shared_ptr<const connector::hive::HiveSplitStatistics> statistics_;
+  std::vector<connector::hive::HiveDeleteFile> deleteFiles_;
 };
 
 } // namespace facebook::velox::exec::test
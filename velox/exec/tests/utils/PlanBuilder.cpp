@@ -24,6 +24,7 @@
 #include "velox/exec/HashPartitionFunction.h"
 #include "velox/exec/RoundRobinPartitionFunction.h"
 #include "velox/exec/WindowFunction.h"
+#include "velox/exec/tests/utils/GeneratorSource.h"
 #include "velox/expression/ExprToSubfieldFilter.h"
 #include "velox/expression/SignatureBinder.h"
 #include "velox/parse/Expressions.h"
@@ -171,6 +172,24 @@ PlanBuilder& PlanBuilder::values(
   return *this;
 }
 
+PlanBuilder& PlanBuilder::generatorSource(
+    const RowTypePtr& outputType,
+    int32_t numBatches,
+    const VectorFuzzer::Options& options,
+    size_t seed,
+    GeneratorSpecPtr generatorSpec) {
+  VELOX_CHECK_NULL(planNode_, "generatorSource() must be the first call");
+  registerGeneratorSource();
+  planNode_ = std::make_shared<GeneratorSourceNode>(
+      nextPlanNodeId(),
+      outputType,
+      numBatches,
+      options,
+      seed,
+      std::move(generatorSpec));
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::exchange(const RowTypePtr& outputType) {
   VELOX_CHECK_NULL(planNode_, "exchange() must be the first call");
   planNode_ =
@@ -544,15 +563,34 @@ PlanBuilder::createAggregateExpressionsAndNames(
   AggregateTypeResolver resolver(step);
   std::vector<std::shared_ptr<const core::CallTypedExpr>> exprs;
   std::vector<std::string> names;
+  std::vector<bool> distinct;
+  std::vector<core::AggregationNode::AggregateOrderBy> orderBy;
   exprs.reserve(aggregates.size());
   names.reserve(aggregates.size());
+  distinct.reserve(aggregates.size());
+  orderBy.reserve(aggregates.size());
   for (auto i = 0; i < aggregates.size(); i++) {
     auto& agg = aggregates[i];
     if (i < resultTypes.size()) {
       resolver.setResultType(resultTypes[i]);
     }
 
-    auto untypedExpr = parse::parseExpr(agg, options_);
+    auto aggregateExpr = parse::parseAggregateExpr(agg, options_);
+    const auto& untypedExpr = aggregateExpr.expr;
+    distinct.push_back(aggregateExpr.distinct);
+
+    auto& aggregateOrderBy = orderBy.emplace_back();
+    for (const auto& [untypedKey, sortOrder] : aggregateExpr.orderBy) {
+      auto sortingKey = std::dynamic_pointer_cast<
+          const core::FieldAccessTypedExpr>(core::Expressions::inferTypes(
+          untypedKey, planNode_->outputType(), pool_));
+      VELOX_CHECK_NOT_NULL(
+          sortingKey,
+          "ORDER BY clause must use a column name, not an expression: {}",
+          agg);
+      aggregateOrderBy.sortingKeys.push_back(sortingKey);
+      aggregateOrderBy.sortingOrders.push_back(sortOrder);
+    }
 
     auto expr = std::dynamic_pointer_cast<const core::CallTypedExpr>(
         inferTypes(untypedExpr));
@@ -565,7 +603,7 @@ PlanBuilder::createAggregateExpressionsAndNames(
     }
   }
 
-  return {exprs, names};
+  return {exprs, names, distinct, orderBy};
 }
 
 std::vector<std::shared_ptr<const core::FieldAccessTypedExpr>>
@@ -607,6 +645,8 @@ PlanBuilder& PlanBuilder::aggregation(
       aggregatesAndNames.names,
       aggregatesAndNames.expressions,
       createAggregateMasks(numAggregates, masks),
+      aggregatesAndNames.distinct,
+      aggregatesAndNames.orderBy,
       ignoreNullKeys,
       planNode_);
   return *this;
@@ -630,6 +670,8 @@ PlanBuilder& PlanBuilder::streamingAggregation(
       aggregatesAndNames.names,
       aggregatesAndNames.expressions,
       createAggregateMasks(numAggregates, masks),
+      aggregatesAndNames.distinct,
+      aggregatesAndNames.orderBy,
       ignoreNullKeys,
       planNode_);
   return *this;
@@ -671,6 +713,62 @@ PlanBuilder& PlanBuilder::groupId(
   return *this;
 }
 
+PlanBuilder& PlanBuilder::groupingSetsAggregation(
+    const std::vector<std::vector<std::string>>& groupingSets,
+    const std::vector<std::string>& aggregates,
+    std::string groupIdName) {
+  // The finest grouping set is the union of all grouping keys. Coarser sets
+  // are derived by re-aggregating its intermediate results.
+  std::vector<std::string> allKeys;
+  std::set<std::string> names;
+  for (const auto& groupingSet : groupingSets) {
+    for (const auto& key : groupingSet) {
+      if (names.insert(key).second) {
+        allKeys.push_back(key);
+      }
+    }
+  }
+
+  partialAggregation(allKeys, aggregates);
+  auto partialAggNode =
+      std::dynamic_pointer_cast<const core::AggregationNode>(planNode_);
+  const auto& partialAggregates = partialAggNode->aggregates();
+  const auto& aggregateNames = partialAggNode->aggregateNames();
+
+  groupId(groupingSets, aggregateNames, groupIdName);
+
+  auto groupingKeys = fields(allKeys);
+  groupingKeys.push_back(field(groupIdName));
+
+  auto numAggregates = partialAggregates.size();
+  std::vector<std::shared_ptr<const core::CallTypedExpr>> finalAggregates;
+  finalAggregates.reserve(numAggregates);
+  for (auto i = 0; i < numAggregates; ++i) {
+    const auto& name = partialAggregates[i]->name();
+    std::vector<TypePtr> rawInputTypes;
+    for (const auto& rawInput : partialAggregates[i]->inputs()) {
+      rawInputTypes.push_back(rawInput->type());
+    }
+    auto type = resolveAggregateType(
+        name, core::AggregationNode::Step::kFinal, rawInputTypes, false);
+    std::vector<core::TypedExprPtr> inputs = {field(aggregateNames[i])};
+    finalAggregates.push_back(
+        std::make_shared<core::CallTypedExpr>(type, std::move(inputs), name));
+  }
+
+  planNode_ = std::make_shared<core::AggregationNode>(
+      nextPlanNodeId(),
+      core::AggregationNode::Step::kFinal,
+      groupingKeys,
+      std::vector<core::FieldAccessTypedExprPtr>{},
+      aggregateNames,
+      finalAggregates,
+      std::vector<core::FieldAccessTypedExprPtr>(numAggregates),
+      false,
+      planNode_);
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::localMerge(
     const std::vector<std::string>& keys,
     std::vector<core::PlanNodePtr> sources) {
@@ -716,6 +814,28 @@ PlanBuilder& PlanBuilder::topN(
   return *this;
 }
 
+PlanBuilder& PlanBuilder::topNRowNumber(
+    const std::vector<std::string>& partitionKeys,
+    const std::vector<std::string>& sortingKeys,
+    int32_t limit,
+    bool generateRowNumber) {
+  auto [sortingFields, sortingOrders] =
+      parseOrderByClauses(sortingKeys, planNode_->outputType(), pool_);
+  std::optional<std::string> rowNumberColumnName;
+  if (generateRowNumber) {
+    rowNumberColumnName = "row_number";
+  }
+  planNode_ = std::make_shared<core::TopNRowNumberNode>(
+      nextPlanNodeId(),
+      fields(partitionKeys),
+      sortingFields,
+      sortingOrders,
+      rowNumberColumnName,
+      limit,
+      planNode_);
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::limit(int32_t offset, int32_t count, bool isPartial) {
   planNode_ = std::make_shared<core::LimitNode>(
       nextPlanNodeId(), offset, count, isPartial, planNode_);
@@ -741,17 +861,27 @@ class HashPartitionFunctionSpec : public core::PartitionFunctionSpec {
  public:
   HashPartitionFunctionSpec(
       RowTypePtr inputType,
-      std::vector<column_index_t> keys)
-      : inputType_{inputType}, keys_{keys} {}
+      std::vector<column_index_t> keys,
+      bool spreadHeavyHitters = false)
+      : inputType_{inputType},
+        keys_{keys},
+        spreadHeavyHitters_{spreadHeavyHitters} {}
 
   std::unique_ptr<core::PartitionFunction> create(
       int numPartitions) const override {
     return std::make_unique<exec::HashPartitionFunction>(
-        numPartitions, inputType_, keys_);
+        numPartitions,
+        inputType_,
+        keys_,
+        std::vector<VectorPtr>{},
+        spreadHeavyHitters_);
   }
 
   std::string toString() const override {
-    return fmt::format("HASH({})", folly::join(", ", keys_));
+    return fmt::format(
+        "HASH({}){}",
+        folly::join(", ", keys_),
+        spreadHeavyHitters_ ? " SPREAD HEAVY HITTERS" : "");
   }
 
   folly::dynamic serialize() const override {
@@ -759,6 +889,7 @@ class HashPartitionFunctionSpec : public core::PartitionFunctionSpec {
     obj["name"] = "HashPartitionFunctionSpec";
     obj["inputType"] = inputType_->serialize();
     obj["keys"] = ISerializable::serialize(keys_);
+    obj["spreadHeavyHitters"] = spreadHeavyHitters_;
     return obj;
   }
 
@@ -767,17 +898,20 @@ class HashPartitionFunctionSpec : public core::PartitionFunctionSpec {
       void* /* context */) {
     return std::make_shared<HashPartitionFunctionSpec>(
         ISerializable::deserialize<RowType>(obj["inputType"]),
-        ISerializable::deserialize<std::vector<column_index_t>>(obj["keys"]));
+        ISerializable::deserialize<std::vector<column_index_t>>(obj["keys"]),
+        obj.getDefault("spreadHeavyHitters", false).asBool());
   }
 
  private:
   const RowTypePtr inputType_;
   const std::vector<column_index_t> keys_;
+  const bool spreadHeavyHitters_;
 };
 
 core::PartitionFunctionSpecPtr createPartitionFunctionSpec(
     const RowTypePtr& inputType,
-    const std::vector<std::string>& keys) {
+    const std::vector<std::string>& keys,
+    bool spreadHeavyHitters = false) {
   if (keys.empty()) {
     return std::make_shared<core::GatherPartitionFunctionSpec>();
   } else {
@@ -787,7 +921,7 @@ core::PartitionFunctionSpecPtr createPartitionFunctionSpec(
       keyIndices.push_back(inputType->getChildIdx(key));
     }
     return std::make_shared<HashPartitionFunctionSpec>(
-        inputType, std::move(keyIndices));
+        inputType, std::move(keyIndices), spreadHeavyHitters);
   }
 }
 
@@ -828,9 +962,10 @@ RowTypePtr rename(
 core::PlanNodePtr createLocalPartitionNode(
     const core::PlanNodeId& planNodeId,
     const std::vector<std::string>& keys,
-    const std::vector<core::PlanNodePtr>& sources) {
-  auto partitionFunctionFactory =
-      createPartitionFunctionSpec(sources[0]->outputType(), keys);
+    const std::vector<core::PlanNodePtr>& sources,
+    bool spreadHeavyHitters = false) {
+  auto partitionFunctionFactory = createPartitionFunctionSpec(
+      sources[0]->outputType(), keys, spreadHeavyHitters);
   return std::make_shared<core::LocalPartitionNode>(
       planNodeId,
       keys.empty() ? core::LocalPartitionNode::Type::kGather
@@ -892,6 +1027,14 @@ PlanBuilder& PlanBuilder::localPartition(const std::vector<std::string>& keys) {
   return *this;
 }
 
+PlanBuilder& PlanBuilder::localPartitionSpreadHeavyHitters(
+    const std::vector<std::string>& keys) {
+  VELOX_CHECK(!keys.empty(), "Heavy hitters are spread only for hash keys");
+  planNode_ =
+      createLocalPartitionNode(nextPlanNodeId(), keys, {planNode_}, true);
+  return *this;
+}
+
 namespace {
 
 class RoundRobinPartitionFunctionSpec : public core::PartitionFunctionSpec {
@@ -938,11 +1081,39 @@ PlanBuilder& PlanBuilder::localPartitionRoundRobin(
   return *this;
 }
 
+PlanBuilder& PlanBuilder::partitionedOutputRoundRobin(
+    int numPartitions,
+    const std::vector<std::string>& outputLayout) {
+  auto outputType = outputLayout.empty()
+      ? planNode_->outputType()
+      : extract(planNode_->outputType(), outputLayout);
+  planNode_ = std::make_shared<core::PartitionedOutputNode>(
+      nextPlanNodeId(),
+      std::vector<core::TypedExprPtr>{},
+      numPartitions,
+      false,
+      false,
+      std::make_shared<RoundRobinPartitionFunctionSpec>(),
+      outputType,
+      planNode_);
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::localPartitionRoundRobin() {
   planNode_ = createLocalPartitionRoundRobinNode(nextPlanNodeId(), {planNode_});
   return *this;
 }
 
+PlanBuilder& PlanBuilder::localPartitionScaleWriter() {
+  planNode_ = std::make_shared<core::LocalPartitionNode>(
+      nextPlanNodeId(),
+      core::LocalPartitionNode::Type::kRepartition,
+      std::make_shared<RoundRobinPartitionFunctionSpec>(),
+      std::vector<core::PlanNodePtr>{planNode_},
+      true);
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::hashJoin(
     const std::vector<std::string>& leftKeys,
     const std::vector<std::string>& rightKeys,
@@ -1037,6 +1208,52 @@ PlanBuilder& PlanBuilder::crossJoin(
   return *this;
 }
 
+PlanBuilder& PlanBuilder::crossJoin(
+    const core::PlanNodePtr& right,
+    const std::string& filter,
+    const std::vector<std::string>& outputLayout,
+    core::JoinType joinType) {
+  auto resultType = concat(planNode_->outputType(), right->outputType());
+  auto outputType = extract(resultType, outputLayout);
+
+  core::TypedExprPtr filterExpr;
+  if (!filter.empty()) {
+    filterExpr = parseExpr(filter, resultType, options_, pool_);
+  }
+
+  planNode_ = std::make_shared<core::CrossJoinNode>(
+      nextPlanNodeId(),
+      std::move(planNode_),
+      right,
+      outputType,
+      joinType,
+      std::move(filterExpr));
+  return *this;
+}
+
+PlanBuilder& PlanBuilder::rangeJoin(
+    const std::string& probeKey,
+    const std::string& lowerKey,
+    const std::string& upperKey,
+    const core::PlanNodePtr& right,
+    const std::vector<std::string>& outputLayout,
+    core::JoinType joinType) {
+  auto leftType = planNode_->outputType();
+  auto rightType = right->outputType();
+  auto outputType = extract(concat(leftType, rightType), outputLayout);
+
+  planNode_ = std::make_shared<core::RangeJoinNode>(
+      nextPlanNodeId(),
+      joinType,
+      field(leftType, probeKey),
+      field(rightType, lowerKey),
+      field(rightType, upperKey),
+      std::move(planNode_),
+      right,
+      outputType);
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::unnest(
     const std::vector<std::string>& replicateColumns,
     const std::vector<std::string>& unnestColumns,
@@ -1283,6 +1500,17 @@ bool equalSortOrderList(
 
 PlanBuilder& PlanBuilder::window(
     const std::vector<std::string>& windowFunctions) {
+  return window(windowFunctions, false);
+}
+
+PlanBuilder& PlanBuilder::streamingWindow(
+    const std::vector<std::string>& windowFunctions) {
+  return window(windowFunctions, true);
+}
+
+PlanBuilder& PlanBuilder::window(
+    const std::vector<std::string>& windowFunctions,
+    bool inputsSorted) {
   VELOX_CHECK_GT(
       windowFunctions.size(),
       0,
@@ -1361,6 +1589,7 @@ PlanBuilder& PlanBuilder::window(
       sortingOrders,
       windowNames,
       windowNodeFunctions,
+      inputsSorted,
       planNode_);
   return *this;
 }
@@ -21,6 +21,7 @@
 #include "velox/common/memory/Memory.h"
 #include "velox/parse/ExpressionsParser.h"
 #include "velox/parse/PlanNodeIdGenerator.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
 
 namespace facebook::velox::core {
 class IExpr;
@@ -172,6 +173,22 @@ class PlanBuilder {
       bool parallelizable = false,
       size_t repeatTimes = 1);
 
+  /// Add a GeneratorSourceNode that makes 'numBatches' batches of random data
+  /// of 'outputType' on each driver as they are asked for. Unlike a
+  /// parallelizable values(), no data is made upfront and the drivers do not
+  /// share vectors, so that the source does not dominate benchmarks. The data
+  /// of each driver is deterministic for a given 'seed'.
+  ///
+  /// @param options The VectorFuzzer options of the batches, including the
+  /// number of rows in 'options.vectorSize'.
+  /// @param generatorSpec If set, makes the batches instead of VectorFuzzer.
+  PlanBuilder& generatorSource(
+      const RowTypePtr& outputType,
+      int32_t numBatches,
+      const VectorFuzzer::Options& options = {},
+      size_t seed = 1,
+      GeneratorSpecPtr generatorSpec = nullptr);
+
   /// Add an ExchangeNode.
   ///
   /// Use capturePlanNodeId method to capture the node ID needed for adding
@@ -343,7 +360,9 @@ class PlanBuilder {
 
   /// Add a single aggregation plan node using specified grouping keys and
   /// aggregate expressions. See 'partialAggregation' method for the supported
-  /// types of aggregate expressions.
+  /// types of aggregate expressions. Aggregates of a single aggregation may
+  /// also be distinct, e.g. "count(DISTINCT a)", or ordered, e.g.
+  /// "array_agg(a ORDER BY b DESC)".
   PlanBuilder& singleAggregation(
       const std::vector<std::string>& groupingKeys,
       const std::vector<std::string>& aggregates,
@@ -449,6 +468,29 @@ class PlanBuilder {
       const std::vector<std::string>& aggregationInputs,
       std::string groupIdName = "group_id");
 
+  /// Add a plan that computes 'aggregates' for each of the 'groupingSets'
+  /// without replicating the input once per grouping set. Aggregates the input
+  /// once by the union of the grouping keys using partial aggregation, then
+  /// replicates only the much smaller set of pre-aggregated groups with a
+  /// GroupIdNode and derives the result of each grouping set from these with
+  /// a final aggregation grouped by the grouping keys and 'groupIdName'.
+  ///
+  /// The output contains the grouping keys in the order they appear in
+  /// 'groupingSets', followed by 'groupIdName' and the aggregates. Aggregates
+  /// are specified as in partialAggregation(). Distinct and ordered aggregates
+  /// are not supported as these cannot be computed from intermediate results.
+  ///
+  /// For example,
+  ///
+  ///     groupingSetsAggregation(
+  ///         {{"k1", "k2"}, {"k1"}, {}}, {"count(1) AS cnt", "sum(a)"})
+  ///
+  /// computes GROUP BY ROLLUP (k1, k2).
+  PlanBuilder& groupingSetsAggregation(
+      const std::vector<std::vector<std::string>>& groupingSets,
+      const std::vector<std::string>& aggregates,
+      std::string groupIdName = "group_id");
+
   /// Add a LocalMergeNode using specified ORDER BY clauses.
   ///
   /// For example,
@@ -544,6 +586,15 @@ class PlanBuilder {
   PlanBuilder& partitionedOutputBroadcast(
       const std::vector<std::string>& outputLayout = {});
 
+  /// Add a PartitionedOutputNode to partition the input using row-wise
+  /// round-robin.
+  ///
+  /// @param outputLayout Optional output layout in case it is different then
+  /// the input.
+  PlanBuilder& partitionedOutputRoundRobin(
+      int numPartitions,
+      const std::vector<std::string>& outputLayout = {});
+
   /// Add a LocalPartitionNode to hash-partition the input on the specified
   /// keys using exec::HashPartitionFunction. Number of partitions is determined
   /// at runtime based on parallelism of the downstream pipeline.
@@ -559,6 +610,15 @@ class PlanBuilder {
   /// current plan node).
   PlanBuilder& localPartition(const std::vector<std::string>& keys);
 
+  /// Add a LocalPartitionNode to hash-partition the input on the specified
+  /// keys with the rows of the heavy hitter keys spread round-robin over all
+  /// the partitions. Meant for the probe side of a hash join, whose drivers
+  /// share a single hash table. See exec::HashPartitionFunction.
+  ///
+  /// @param keys Partitioning keys. Must not be empty.
+  PlanBuilder& localPartitionSpreadHeavyHitters(
+      const std::vector<std::string>& keys);
+
   /// Add a LocalPartitionNode to partition the input using row-wise
   /// round-robin. Number of partitions is determined at runtime based on
   /// parallelism of the downstream pipeline.
@@ -571,6 +631,11 @@ class PlanBuilder {
   /// current plan node).
   PlanBuilder& localPartitionRoundRobin();
 
+  /// Add a LocalPartitionNode that feeds table writers and sends its input to
+  /// a growing number of them as the amount of data calls for. See
+  /// exec::ScaleWriterState.
+  PlanBuilder& localPartitionScaleWriter();
+
   /// Add a HashJoinNode to join two inputs using one or more join keys and an
   /// optional filter.
   ///
@@ -623,6 +688,33 @@ class PlanBuilder {
       const core::PlanNodePtr& right,
       const std::vector<std::string>& outputLayout);
 
+  /// Add a CrossJoinNode that returns only the pairs of rows passing 'filter'.
+  ///
+  /// @param filter SQL expression over the columns of both sides. Empty for
+  /// no filter.
+  /// @param joinType kInner or kLeft. A left join also returns the left-side
+  /// rows without a passing pair, with nulls in the right-side columns.
+  PlanBuilder& crossJoin(
+      const core::PlanNodePtr& right,
+      const std::string& filter,
+      const std::vector<std::string>& outputLayout,
+      core::JoinType joinType = core::JoinType::kInner);
+
+  /// Add a RangeJoinNode to join each left row with the right rows where
+  /// 'probeKey' BETWEEN 'lowerKey' AND 'upperKey'.
+  ///
+  /// @param probeKey Left-side column.
+  /// @param lowerKey Right-side column with the inclusive lower bound.
+  /// @param upperKey Right-side column with the inclusive upper bound.
+  /// @param joinType kInner or kLeft.
+  PlanBuilder& rangeJoin(
+      const std::string& probeKey,
+      const std::string& lowerKey,
+      const std::string& upperKey,
+      const core::PlanNodePtr& right,
+      const std::vector<std::string>& outputLayout,
+      core::JoinType joinType = core::JoinType::kInner);
+
   /// Add an UnnestNode to unnest one or more columns of type array or map.
   ///
   /// The output will contain 'replicatedColumns' followed by unnested columns,
@@ -668,6 +760,30 @@ class PlanBuilder {
   ///  rows between a + 10 preceding and 10 following)"
   PlanBuilder& window(const std::vector<std::string>& windowFunctions);
 
+  /// Add a WindowNode to compute one or more windowFunctions over input that
+  /// is already sorted by the partition keys followed by the sorting keys.
+  /// The window functions are computed in a streaming fashion without
+  /// sorting the input. The windowFunctions use the same format as in
+  /// window().
+  PlanBuilder& streamingWindow(const std::vector<std::string>& windowFunctions);
+
+  /// Add a TopNRowNumberNode to keep the first 'limit' rows of each partition
+  /// by the ORDER BY clauses. 'sortingKeys' use the same format as in topN().
+  /// If 'generateRowNumber' is true, appends a BIGINT 'row_number' column with
+  /// the row number of each row within its partition.
+  ///
+  /// For example,
+  ///
+  ///     .topNRowNumber({"a"}, {"b DESC"}, 3, true)
+  ///
+  /// is the same as filtering "row_number() over (partition by a order by b
+  /// desc) as row_number" on row_number <= 3.
+  PlanBuilder& topNRowNumber(
+      const std::vector<std::string>& partitionKeys,
+      const std::vector<std::string>& sortingKeys,
+      int32_t limit,
+      bool generateRowNumber);
+
   /// Stores the latest plan node ID into the specified variable. Useful for
   /// capturing IDs of the leaf plan nodes (table scans, exchanges, etc.) to use
   /// when adding splits at runtime.
@@ -760,6 +876,10 @@ class PlanBuilder {
   struct ExpressionsAndNames {
     std::vector<std::shared_ptr<const core::CallTypedExpr>> expressions;
     std::vector<std::string> names;
+    // True for each aggregate specified with the DISTINCT modifier.
+    std::vector<bool> distinct;
+    // The ORDER BY clause of each aggregate. Empty if not specified.
+    std::vector<core::AggregationNode::AggregateOrderBy> orderBy;
   };
 
   ExpressionsAndNames createAggregateExpressionsAndNames(
@@ -772,6 +892,10 @@ class PlanBuilder {
       size_t numAggregates,
       const std::vector<std::string>& masks);
 
+  PlanBuilder& window(
+      const std::vector<std::string>& windowFunctions,
+      bool inputsSorted);
+
  protected:
   core::PlanNodePtr planNode_;
   parse::ParseOptions options_;
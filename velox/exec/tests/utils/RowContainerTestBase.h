@@ -56,7 +56,8 @@ class RowContainerTestBase : public testing::Test,
   std::unique_ptr<RowContainer> makeRowContainer(
       const std::vector<TypePtr>& keyTypes,
       const std::vector<TypePtr>& dependentTypes,
-      bool isJoinBuild = true) {
+      bool isJoinBuild = true,
+      bool compactLayout = false) {
     static const std::vector<std::unique_ptr<Aggregate>> kEmptyAggregates;
     return std::make_unique<RowContainer>(
         keyTypes,
@@ -68,7 +69,9 @@ class RowContainerTestBase : public testing::Test,
         true,
         true,
         pool_.get(),
-        ContainerRowSerde::instance());
+        ContainerRowSerde::instance(),
+        false, // appendOnlyStrings
+        compactLayout);
   }
 
   std::shared_ptr<memory::MemoryPool> pool_;
@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <mutex>
+#include <unordered_map>
 #include "velox/experimental/codegen/compiler_utils/Compiler.h"
 #include "velox/experimental/codegen/compiler_utils/CompilerOptions.h"
 #include "velox/experimental/codegen/library_loader/NativeLibraryLoader.h"
@@ -45,7 +47,54 @@ class CodeManager {
     return loader_;
   }
 
+  /// Compiles and links 'cppContent' into a dynamic library and returns its
+  /// path. Libraries are cached for the lifetime of the process by source and
+  /// compiler arguments, so a plan that repeats an expression, or a query that
+  /// runs again, does not launch the external compiler again.
+  std::filesystem::path compileAndLink(const std::string& cppContent) {
+    auto key = cacheKey(cppContent);
+    {
+      std::lock_guard<std::mutex> l(cacheMutex());
+      auto it = libraryCache().find(key);
+      if (it != libraryCache().end() && std::filesystem::exists(it->second)) {
+        return it->second;
+      }
+    }
+    auto compiledObject = compiler_.compileString({}, cppContent);
+    auto dynamicObject = compiler_.link({}, {compiledObject});
+    std::lock_guard<std::mutex> l(cacheMutex());
+    libraryCache()[key] = dynamicObject;
+    return dynamicObject;
+  }
+
  private:
+  std::string cacheKey(const std::string& cppContent) {
+    std::string key;
+    for (const auto& arg : compiler_.defaultCompilationArgs()) {
+      key += arg;
+      key += ' ';
+    }
+    key += '\n';
+    for (const auto& arg : compiler_.defaultLinkingArgs()) {
+      key += arg;
+      key += ' ';
+    }
+    key += '\n';
+    key += cppContent;
+    return key;
+  }
+
+  static std::mutex& cacheMutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  static std::unordered_map<std::string, std::filesystem::path>&
+  libraryCache() {
+    static std::unordered_map<std::string, std::filesystem::path> cache;
+    return cache;
+  }
+
   Compiler compiler_;
   NativeLibraryLoader loader_;
   DefaultScopedTimer::EventSequence eventSequence_;
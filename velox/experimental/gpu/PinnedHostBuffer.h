@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+
+#include "velox/common/memory/MemoryPool.h"
+#include "velox/experimental/gpu/Common.h"
+
+namespace facebook::velox::gpu {
+
+/// Page-locked host memory for staging host<->device copies. Copies from
+/// pinned memory can run asynchronously on a stream and overlap with kernels
+/// working on another buffer. The bytes are not allocated from 'pool_' but
+/// are reported to it with reserve() and release(). That way pinned staging
+/// buffers count against the memory limits of the query that uses them.
+class PinnedHostBuffer {
+ public:
+  PinnedHostBuffer(memory::MemoryPool* pool, size_t size)
+      : pool_(pool), size_(size) {
+    pool_->reserve(size_);
+    if (cudaMallocHost(&data_, size_) != cudaSuccess) {
+      pool_->release(size_);
+      VELOX_FAIL("Failed to allocate {} bytes of pinned host memory", size_);
+    }
+  }
+
+  ~PinnedHostBuffer() {
+    if (data_) {
+      CUDA_CHECK_LOG(cudaFreeHost(data_));
+      pool_->release(size_);
+    }
+  }
+
+  PinnedHostBuffer(const PinnedHostBuffer&) = delete;
+  PinnedHostBuffer& operator=(const PinnedHostBuffer&) = delete;
+
+  PinnedHostBuffer(PinnedHostBuffer&& other) noexcept
+      : pool_(other.pool_), data_(other.data_), size_(other.size_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+
+  template <typename T>
+  T* as() const {
+    return reinterpret_cast<T*>(data_);
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  /// Starts an asynchronous copy of the first 'bytes' bytes to 'device' on
+  /// 'stream'. The buffer must not be modified before the copy completes.
+  void copyToDevice(void* device, size_t bytes, cudaStream_t stream) const {
+    VELOX_CHECK_LE(bytes, size_);
+    CUDA_CHECK_FATAL(cudaMemcpyAsync(
+        device, data_, bytes, cudaMemcpyHostToDevice, stream));
+  }
+
+  /// Starts an asynchronous copy of 'bytes' bytes from 'device' to the start
+  /// of the buffer on 'stream'.
+  void copyFromDevice(const void* device, size_t bytes, cudaStream_t stream) {
+    VELOX_CHECK_LE(bytes, size_);
+    CUDA_CHECK_FATAL(cudaMemcpyAsync(
+        data_, device, bytes, cudaMemcpyDeviceToHost, stream));
+  }
+
+ private:
+  memory::MemoryPool* const pool_;
+  void* data_{nullptr};
+  size_t size_;
+};
+
+} // namespace facebook::velox::gpu
@@ -26,6 +26,7 @@
 #include "velox/expression/StringWriter.h"
 #include "velox/external/date/tz.h"
 #include "velox/functions/lib/RowsTranslationUtil.h"
+#include "velox/type/tz/TimeZoneOffsets.h"
 #include "velox/vector/ComplexVector.h"
 #include "velox/vector/FunctionVector.h"
 #include "velox/vector/SelectivityVector.h"
@@ -207,11 +208,12 @@ void CastExpr::applyCastWithTry(
       if (!sessionTzName.empty()) {
         // locate_zone throws runtime_error if the timezone couldn't be found
         // (so we're safe to dereference the pointer).
-        auto* timeZone = date::locate_zone(sessionTzName);
+        const auto& offsets =
+            util::TimeZoneOffsets::get(*date::locate_zone(sessionTzName));
         auto rawTimestamps = resultFlatVector->mutableRawValues();
 
         rows.applyToSelected(
-            [&](int row) { rawTimestamps[row].toGMT(*timeZone); });
+            [&](int row) { rawTimestamps[row].toGMT(offsets); });
       }
     }
   }
@@ -21,6 +21,25 @@ namespace facebook::velox::exec {
 
 namespace {
 
+// Number of evaluations after which the selectivity history of the inputs is
+// halved so that the order of the inputs follows changes in the data.
+constexpr int32_t kDecayInterval = 100;
+
+struct StaticCost {
+  bool hasVariableWidth{false};
+  int32_t numNodes{0};
+};
+
+void addStaticCost(const Expr& expr, StaticCost& cost) {
+  ++cost.numNodes;
+  if (!expr.type()->isFixedWidth()) {
+    cost.hasVariableWidth = true;
+  }
+  for (const auto& input : expr.inputs()) {
+    addStaticCost(*input, cost);
+  }
+}
+
 uint64_t* rowsWithError(
     const SelectivityVector& rows,
     const SelectivityVector& activeRows,
@@ -95,6 +114,17 @@ void ConjunctExpr::evalSpecialForm(
     const SelectivityVector& rows,
     EvalCtx& context,
     VectorPtr& result) {
+  if (!reorderEnabledChecked_) {
+    reorderEnabled_ = context.execCtx()
+                          ->queryCtx()
+                          ->queryConfig()
+                          .adaptiveFilterReorderingEnabled();
+    reorderEnabledChecked_ = true;
+    if (reorderEnabled_) {
+      orderInputsByStaticCost();
+    }
+  }
+
   // TODO Revisit error handling
   bool throwOnError = *context.mutableThrowOnError();
   ScopedVarSetter saveError(context.mutableThrowOnError(), false);
@@ -159,19 +189,35 @@ void ConjunctExpr::evalSpecialForm(
   }
   // Clear errors for 'rows' that are not in 'activeRows'.
   finalizeErrors(rows, *activeRows, throwOnError, context);
-  if (!reorderEnabledChecked_) {
-    reorderEnabled_ = context.execCtx()
-                          ->queryCtx()
-                          ->queryConfig()
-                          .adaptiveFilterReorderingEnabled();
-    reorderEnabledChecked_ = true;
-  }
   if (reorderEnabled_) {
     maybeReorderInputs();
   }
 }
 
+void ConjunctExpr::orderInputsByStaticCost() {
+  std::vector<StaticCost> costs(inputs_.size());
+  for (auto i = 0; i < inputs_.size(); ++i) {
+    addStaticCost(*inputs_[i], costs[i]);
+  }
+  std::stable_sort(
+      inputOrder_.begin(),
+      inputOrder_.end(),
+      [&](int32_t left, int32_t right) {
+        if (costs[left].hasVariableWidth != costs[right].hasVariableWidth) {
+          return costs[right].hasVariableWidth;
+        }
+        return costs[left].numNodes < costs[right].numNodes;
+      });
+}
+
 void ConjunctExpr::maybeReorderInputs() {
+  if (++numEvalsSinceDecay_ >= kDecayInterval) {
+    for (auto& selectivity : selectivity_) {
+      selectivity.decay();
+    }
+    numEvalsSinceDecay_ = 0;
+  }
+
   bool reorder = false;
   for (auto i = 1; i < inputs_.size(); ++i) {
     if (selectivity_[inputOrder_[i - 1]].timeToDropValue() >
@@ -181,7 +227,7 @@ void ConjunctExpr::maybeReorderInputs() {
     }
   }
   if (reorder) {
-    std::sort(
+    std::stable_sort(
         inputOrder_.begin(),
         inputOrder_.end(),
         [this](size_t left, size_t right) {
@@ -74,6 +74,11 @@ class ConjunctExpr : public SpecialForm {
  private:
   static TypePtr resolveType(const std::vector<TypePtr>& argTypes);
 
+  // Orders the inputs by a static cost estimate before there is any runtime
+  // history. Inputs over fixed-width values only go first, then the inputs
+  // with fewer expression nodes.
+  void orderInputsByStaticCost();
+
   void maybeReorderInputs();
   void updateResult(
       BaseVector* inputResult,
@@ -93,6 +98,8 @@ class ConjunctExpr : public SpecialForm {
   bool reorderEnabled_;
   std::vector<SelectivityInfo> selectivity_;
   std::vector<int32_t> inputOrder_;
+  // Number of evaluations since the selectivity history was last decayed.
+  int32_t numEvalsSinceDecay_{0};
 
   friend class ConjunctCallToSpecialForm;
 };
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/expression/ConstantStateCache.h"
+
+namespace facebook::velox::exec {
+
+// static
+ConstantStateCache& ConstantStateCache::instance() {
+  static ConstantStateCache cache;
+  return cache;
+}
+
+std::shared_ptr<const void> ConstantStateCache::getOrCreateImpl(
+    const VectorPtr& constant,
+    std::type_index type,
+    const std::function<std::shared_ptr<const void>()>& create) {
+  VELOX_CHECK_NOT_NULL(constant);
+  const Key key{constant.get(), type};
+  {
+    auto entries = entries_.rlock();
+    auto it = entries->find(key);
+    // An expired entry may be for an earlier vector at the same address.
+    if (it != entries->end() && !it->second.constant.expired()) {
+      return it->second.state;
+    }
+  }
+
+  auto state = create();
+  auto entries = entries_.wlock();
+  auto& entry = (*entries)[key];
+  if (entry.state != nullptr && !entry.constant.expired()) {
+    return entry.state;
+  }
+  entry.constant = constant;
+  entry.state = std::move(state);
+  auto result = entry.state;
+  if (entries->size() >= nextSweepSize_) {
+    removeExpiredLocked(*entries);
+    nextSweepSize_ = std::max(kMinSweepSize, 2 * entries->size());
+  }
+  return result;
+}
+
+void ConstantStateCache::removeExpired() {
+  removeExpiredLocked(*entries_.wlock());
+}
+
+// static
+void ConstantStateCache::removeExpiredLocked(EntryMap& entries) {
+  for (auto it = entries.begin(); it != entries.end();) {
+    if (it->second.constant.expired()) {
+      it = entries.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <typeindex>
+#include <unordered_map>
+
+#include <folly/Synchronized.h>
+
+#include "velox/vector/BaseVector.h"
+
+namespace facebook::velox::exec {
+
+/// Shares immutable state derived from a constant argument of a function,
+/// e.g. the filter made from the IN list of an IN predicate, between all
+/// compilations of the same expression. Each Driver compiles its own ExprSet,
+/// but a vector valued core::ConstantTypedExpr passes the same vector to all
+/// of them. The state is keyed on that vector and the type of the state, and
+/// is dropped after the vector is freed.
+class ConstantStateCache {
+ public:
+  static ConstantStateCache& instance();
+
+  /// Returns the state of type T for 'constant', calling 'create' to make it
+  /// on first use. 'create' runs without holding a lock. If two threads make
+  /// the state at the same time, both get the state made first.
+  template <typename T>
+  std::shared_ptr<const T> getOrCreate(
+      const VectorPtr& constant,
+      const std::function<std::shared_ptr<const T>()>& create) {
+    return std::static_pointer_cast<const T>(getOrCreateImpl(
+        constant, std::type_index(typeid(T)), [&]() { return create(); }));
+  }
+
+  /// Returns the number of entries, including the ones whose constant is
+  /// freed but not yet dropped.
+  size_t size() const {
+    return entries_.rlock()->size();
+  }
+
+  /// Drops the entries whose constant is freed.
+  void removeExpired();
+
+ private:
+  // Sweeps expired entries when the number of entries reaches this.
+  static constexpr size_t kMinSweepSize = 1024;
+
+  struct Key {
+    const BaseVector* constant;
+    std::type_index type;
+
+    bool operator==(const Key& other) const {
+      return constant == other.constant && type == other.type;
+    }
+  };
+
+  struct KeyHasher {
+    size_t operator()(const Key& key) const {
+      return bits::hashMix(
+          std::hash<const BaseVector*>()(key.constant), key.type.hash_code());
+    }
+  };
+
+  struct Entry {
+    std::weak_ptr<const BaseVector> constant;
+    std::shared_ptr<const void> state;
+  };
+
+  using EntryMap = std::unordered_map<Key, Entry, KeyHasher>;
+
+  std::shared_ptr<const void> getOrCreateImpl(
+      const VectorPtr& constant,
+      std::type_index type,
+      const std::function<std::shared_ptr<const void>()>& create);
+
+  static void removeExpiredLocked(EntryMap& entries);
+
+  folly::Synchronized<EntryMap> entries_;
+  size_t nextSweepSize_{kMinSweepSize};
+};
+
+} // namespace facebook::velox::exec
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <functional>
+#include <typeindex>
 
 #include "velox/common/base/Portability.h"
 #include "velox/core/QueryCtx.h"
@@ -263,7 +264,33 @@ class EvalCtx {
   /// new elements to null.
   void ensureErrorsVectorSize(ErrorVectorPtr& vector, vector_size_t size) const;
 
+  /// Returns the state of type T derived from 'vector', calling 'create' to
+  /// make it on first use in this evaluation. Lets the functions that take the
+  /// same input share work, e.g. the subscripts m['a'] and m['b'] share an
+  /// index of the keys of 'm'. Holds a reference to 'vector' so that it is
+  /// neither freed nor reused while the state exists.
+  template <typename T>
+  std::shared_ptr<T> getOrCreateVectorState(
+      const VectorPtr& vector,
+      const std::function<std::shared_ptr<T>()>& create) {
+    const std::type_index type(typeid(T));
+    for (const auto& entry : vectorStates_) {
+      if (entry.vector.get() == vector.get() && entry.type == type) {
+        return std::static_pointer_cast<T>(entry.state);
+      }
+    }
+    auto state = create();
+    vectorStates_.push_back({vector, type, state});
+    return state;
+  }
+
  private:
+  struct VectorState {
+    VectorPtr vector;
+    std::type_index type;
+    std::shared_ptr<void> state;
+  };
+
   core::ExecCtx* const FOLLY_NONNULL execCtx_;
   ExprSet* FOLLY_NULLABLE const exprSet_;
   const RowVector* FOLLY_NULLABLE row_;
@@ -294,6 +321,9 @@ class EvalCtx {
   // in a opaque flat vector, which will translate to a
   // std::shared_ptr<std::exception_ptr>.
   ErrorVectorPtr errors_;
+
+  // See getOrCreateVectorState().
+  std::vector<VectorState> vectorStates_;
 };
 
 /// Utility wrapper struct that is used to temporarily reset the value of the an
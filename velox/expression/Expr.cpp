@@ -17,6 +17,7 @@
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
 #include <fstream>
+#include <folly/String.h>
 
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/Fs.h"
@@ -1535,10 +1536,127 @@ void Expr::applyFunction(
     const SelectivityVector& rows,
     EvalCtx& context,
     VectorPtr& result) {
+  const auto numRows = rows.countSelected();
   stats_.numProcessedVectors += 1;
-  stats_.numProcessedRows += rows.countSelected();
-  auto timer = cpuWallTimer();
+  stats_.numProcessedRows += numRows;
+  auto timer = cpuWallTimer(numRows);
 
+  if (valueMemoMaxEntries_ > 0) {
+    if (auto inputIndex = valueMemoInput()) {
+      applyFunctionWithValueMemo(rows, inputIndex.value(), context, result);
+      return;
+    }
+  }
+  applyVectorFunction(rows, context, result);
+}
+
+std::optional<column_index_t> Expr::valueMemoInput() const {
+  if (!deterministic_ || !type()->isPrimitiveType()) {
+    return std::nullopt;
+  }
+  std::optional<column_index_t> inputIndex;
+  for (column_index_t i = 0; i < inputValues_.size(); ++i) {
+    if (inputValues_[i]->isConstantEncoding()) {
+      continue;
+    }
+    if (inputIndex.has_value()) {
+      return std::nullopt;
+    }
+    inputIndex = i;
+  }
+  if (!inputIndex.has_value()) {
+    return std::nullopt;
+  }
+  auto kind = inputValues_[inputIndex.value()]->typeKind();
+  if (kind != TypeKind::VARCHAR && kind != TypeKind::VARBINARY) {
+    return std::nullopt;
+  }
+  return inputIndex;
+}
+
+namespace {
+// Values longer than this are not added to the value memo.
+constexpr size_t kMaxValueMemoKeySize = 1'024;
+
+// The value memo is disabled for an expression that finds fewer than one in
+// this many looked up rows in the memo after kMinValueMemoLookups lookups.
+constexpr uint64_t kMinValueMemoHitRatio = 2;
+constexpr uint64_t kMinValueMemoLookups = 10'000;
+} // namespace
+
+void Expr::applyFunctionWithValueMemo(
+    const SelectivityVector& rows,
+    column_index_t inputIndex,
+    EvalCtx& context,
+    VectorPtr& result) {
+  LocalDecodedVector decodedHolder(context, *inputValues_[inputIndex], rows);
+  auto* decoded = decodedHolder.get();
+  context.ensureWritable(rows, type(), result);
+
+  // Copy the results of the values in the memo and call the function for the
+  // rest.
+  LocalSelectivityVector missesHolder(context, rows);
+  auto* misses = missesHolder.get();
+  uint64_t numHits = 0;
+  rows.applyToSelected([&](vector_size_t row) {
+    if (decoded->isNullAt(row)) {
+      return;
+    }
+    auto value = decoded->valueAt<StringView>(row);
+    auto it = valueMemoIndices_.find(folly::StringPiece(value));
+    if (it != valueMemoIndices_.end()) {
+      result->copy(valueMemo_.get(), row, it->second, 1);
+      misses->setValid(row, false);
+      ++numHits;
+    }
+  });
+  misses->updateBounds();
+  stats_.numValueMemoLookups += rows.countSelected();
+  stats_.numValueMemoHits += numHits;
+
+  if (misses->hasSelections()) {
+    VectorPtr missResults;
+    applyVectorFunction(*misses, context, missResults);
+    result->copy(missResults.get(), *misses, nullptr);
+
+    if (!valueMemo_) {
+      valueMemo_ = BaseVector::create(type(), 0, context.pool());
+    }
+    auto* errors = context.errors();
+    misses->applyToSelected([&](vector_size_t row) {
+      if (valueMemoIndices_.size() >= valueMemoMaxEntries_ ||
+          decoded->isNullAt(row) ||
+          (errors && row < errors->size() && !errors->isNullAt(row))) {
+        return;
+      }
+      auto value = decoded->valueAt<StringView>(row);
+      if (value.size() > kMaxValueMemoKeySize) {
+        return;
+      }
+      auto [it, inserted] = valueMemoIndices_.emplace(
+          std::string(value.data(), value.size()), valueMemo_->size());
+      if (inserted) {
+        valueMemo_->resize(it->second + 1);
+        valueMemo_->copy(missResults.get(), it->second, row, 1);
+      }
+    });
+    context.releaseVector(missResults);
+  }
+
+  // Stop looking up values that are rarely repeated.
+  if (stats_.numValueMemoLookups >= kMinValueMemoLookups &&
+      stats_.numValueMemoHits * kMinValueMemoHitRatio <
+          stats_.numValueMemoLookups) {
+    valueMemoMaxEntries_ = 0;
+    valueMemoIndices_.clear();
+    valueMemo_ = nullptr;
+  }
+}
+
+void Expr::applyVectorFunction(
+    const SelectivityVector& rows,
+    EvalCtx& context,
+    VectorPtr& result) {
   computeIsAsciiForInputs(vectorFunction_.get(), inputValues_, rows);
   auto isAscii = type()->isVarchar()
       ? computeIsAsciiForResult(vectorFunction_.get(), inputValues_, rows)
@@ -1583,9 +1701,10 @@ void Expr::evalSpecialFormWithStats(
     const SelectivityVector& rows,
     EvalCtx& context,
     VectorPtr& result) {
+  const auto numRows = rows.countSelected();
   stats_.numProcessedVectors += 1;
-  stats_.numProcessedRows += rows.countSelected();
-  auto timer = cpuWallTimer();
+  stats_.numProcessedRows += numRows;
+  auto timer = cpuWallTimer(numRows);
 
   evalSpecialForm(rows, context, result);
 }
@@ -1703,7 +1822,8 @@ namespace {
 void addStats(
     const exec::Expr& expr,
     std::unordered_map<std::string, exec::ExprStats>& stats,
-    std::unordered_set<const exec::Expr*>& uniqueExprs) {
+    std::unordered_set<const exec::Expr*>& uniqueExprs,
+    bool bySignature = false) {
   auto it = uniqueExprs.find(&expr);
   if (it != uniqueExprs.end()) {
     // Common sub-expression. Skip to avoid double counting.
@@ -1714,11 +1834,21 @@ void addStats(
 
   // Do not aggregate empty stats.
   if (expr.stats().numProcessedRows) {
-    stats[expr.name()].add(expr.stats());
+    if (!bySignature) {
+      stats[expr.name()].add(expr.stats());
+    } else if (!expr.inputs().empty()) {
+      std::vector<std::string> inputTypes;
+      inputTypes.reserve(expr.inputs().size());
+      for (const auto& input : expr.inputs()) {
+        inputTypes.push_back(input->type()->toString());
+      }
+      stats[fmt::format("{}({})", expr.name(), folly::join(", ", inputTypes))]
+          .add(expr.stats());
+    }
   }
 
   for (const auto& input : expr.inputs()) {
-    addStats(*input, stats, uniqueExprs);
+    addStats(*input, stats, uniqueExprs, bySignature);
   }
 }
 
@@ -1737,6 +1867,17 @@ std::unordered_map<std::string, exec::ExprStats> ExprSet::stats() const {
   return stats;
 }
 
+std::unordered_map<std::string, exec::ExprStats> ExprSet::statsBySignature()
+    const {
+  std::unordered_map<std::string, exec::ExprStats> stats;
+  std::unordered_set<const exec::Expr*> uniqueExprs;
+  for (const auto& expr : exprs()) {
+    addStats(*expr, stats, uniqueExprs, true);
+  }
+
+  return stats;
+}
+
 ExprSet::~ExprSet() {
   exprSetListeners().withRLock([&](auto& listeners) {
     if (!listeners.empty()) {
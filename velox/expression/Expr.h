@@ -56,10 +56,38 @@ struct ExprStats {
   /// size.
   uint64_t numProcessedVectors{0};
 
+  /// Number of rows looked up in the value memo and the number of them found
+  /// there. See QueryConfig::kExprValueMemoMaxEntries.
+  uint64_t numValueMemoLookups{0};
+  uint64_t numValueMemoHits{0};
+
+  /// Timing of the sampled batches and the number of rows in these. Filled in
+  /// for every QueryConfig.exprSampleCpuEvery()-th batch when
+  /// QueryConfig.exprTrackCpuUsage() is 'false'. Allows to estimate the CPU
+  /// time of all batches as sampledTiming.cpuNanos * numProcessedRows /
+  /// numSampledRows.
+  CpuWallTiming sampledTiming;
+  uint64_t numSampledRows{0};
+
   void add(const ExprStats& other) {
     timing.add(other.timing);
     numProcessedRows += other.numProcessedRows;
     numProcessedVectors += other.numProcessedVectors;
+    numValueMemoLookups += other.numValueMemoLookups;
+    numValueMemoHits += other.numValueMemoHits;
+    sampledTiming.add(other.sampledTiming);
+    numSampledRows += other.numSampledRows;
+  }
+
+  /// Returns the CPU time of all processed rows, measured or extrapolated
+  /// from the sampled batches.
+  uint64_t estimatedCpuNanos() const {
+    if (timing.count > 0 || numSampledRows == 0) {
+      return timing.cpuNanos;
+    }
+    return static_cast<uint64_t>(
+        static_cast<double>(sampledTiming.cpuNanos) * numProcessedRows /
+        numSampledRows);
   }
 
   std::string toString() const {
@@ -174,6 +202,23 @@ class Expr {
     baseDictionary_ = nullptr;
     dictionaryCache_ = nullptr;
     cachedDictionaryIndices_ = nullptr;
+    valueMemoIndices_.clear();
+    valueMemo_ = nullptr;
+  }
+
+  /// Enables remembering the results of this function call for up to
+  /// 'maxEntries' distinct values of its argument across batches. Applies
+  /// only to deterministic calls with a single non-constant argument of type
+  /// VARCHAR or VARBINARY and a primitive result.
+  void setValueMemoMaxEntries(uint32_t maxEntries) {
+    valueMemoMaxEntries_ = maxEntries;
+  }
+
+  /// Times every 'every'-th evaluation of this expression into
+  /// ExprStats::sampledTiming unless all evaluations are timed. 0 disables
+  /// sampling.
+  void setCpuSampleEvery(uint32_t every) {
+    cpuSampleEvery_ = every;
   }
 
   const TypePtr& type() const {
@@ -346,6 +391,26 @@ class Expr {
       EvalCtx& context,
       VectorPtr& result);
 
+  // Calls 'vectorFunction_' on 'inputValues_' for 'rows'. Does not
+  // update 'stats_'.
+  void applyVectorFunction(
+      const SelectivityVector& rows,
+      EvalCtx& context,
+      VectorPtr& result);
+
+  // Returns the index in 'inputValues_' of the argument to look up in
+  // 'valueMemo_' or std::nullopt if the value memo does not apply.
+  std::optional<column_index_t> valueMemoInput() const;
+
+  // Copies the results for the values found in 'valueMemo_' into 'result'
+  // and calls the function on the other 'rows'. Adds their results to
+  // 'valueMemo_' while it has room.
+  void applyFunctionWithValueMemo(
+      const SelectivityVector& rows,
+      column_index_t inputIndex,
+      EvalCtx& context,
+      VectorPtr& result);
+
   // Returns true if values in 'distinctFields_' have nulls that are
   // worth skipping. If so, the rows in 'rows' with at least one sure
   // null are deselected in 'nullHolder->get()'.
@@ -397,11 +462,19 @@ class Expr {
   /// reused.
   void releaseInputValues(EvalCtx& evalCtx);
 
-  /// Returns an instance of CpuWallTimer if cpu usage tracking is enabled. Null
-  /// otherwise.
-  std::unique_ptr<CpuWallTimer> cpuWallTimer() {
-    return trackCpuUsage_ ? std::make_unique<CpuWallTimer>(stats_.timing)
-                          : nullptr;
+  /// Returns an instance of CpuWallTimer if cpu usage tracking is enabled or
+  /// the current batch of 'numRows' rows is sampled. Null otherwise. Expects
+  /// 'stats_.numProcessedVectors' to include the current batch.
+  std::unique_ptr<CpuWallTimer> cpuWallTimer(vector_size_t numRows) {
+    if (trackCpuUsage_) {
+      return std::make_unique<CpuWallTimer>(stats_.timing);
+    }
+    if (cpuSampleEvery_ > 0 &&
+        (stats_.numProcessedVectors - 1) % cpuSampleEvery_ == 0) {
+      stats_.numSampledRows += numRows;
+      return std::make_unique<CpuWallTimer>(stats_.sampledTiming);
+    }
+    return nullptr;
   }
 
   const TypePtr type_;
@@ -463,6 +536,20 @@ class Expr {
   // Count of times the cacheable vector is seen for a non-first time.
   int32_t numCacheableRepeats_{0};
 
+  // Maximum number of entries in 'valueMemo_'. 0 if disabled.
+  uint32_t valueMemoMaxEntries_{0};
+
+  // Interval in batches between timed evaluations. 0 if disabled.
+  uint32_t cpuSampleEvery_{0};
+
+  // Maps a value of the argument of a single argument function to the
+  // position of its result in 'valueMemo_'. Unlike 'dictionaryCache_', this
+  // is kept across batches with different vectors and encodings.
+  folly::F14FastMap<std::string, vector_size_t> valueMemoIndices_;
+
+  // Results for the values in 'valueMemoIndices_'.
+  VectorPtr valueMemo_;
+
   /// Runtime statistics. CPU time, wall time and number of processed rows.
   ExprStats stats_;
 };
@@ -561,6 +648,11 @@ class ExprSet {
   /// evaluated.
   std::unordered_map<std::string, exec::ExprStats> stats() const;
 
+  /// Same as stats() but keyed on the function name and the input types, e.g.
+  /// "plus(BIGINT, BIGINT)", and limited to the functions and special forms
+  /// with inputs.
+  std::unordered_map<std::string, exec::ExprStats> statsBySignature() const;
+
  protected:
   void clearSharedSubexprs();
 
@@ -21,7 +21,9 @@
 #include "velox/expression/ConstantExpr.h"
 #include "velox/expression/Expr.h"
 #include "velox/expression/FieldReference.h"
+#include "velox/expression/FusedArithmeticExpr.h"
 #include "velox/expression/LambdaExpr.h"
+#include "velox/expression/LazyFunctionRegistry.h"
 #include "velox/expression/SimpleFunctionRegistry.h"
 #include "velox/expression/SwitchExpr.h"
 #include "velox/expression/TryExpr.h"
@@ -185,6 +187,21 @@ std::vector<ExprPtr> compileInputs(
   return compiledInputs;
 }
 
+// Returns the VectorFunction from the cache of the ExecCtx of 'exprSet' if
+// the cache is set.
+std::shared_ptr<VectorFunction> getOrCreateVectorFunction(
+    const std::string& name,
+    const std::vector<TypePtr>& inputTypes,
+    const std::vector<VectorPtr>& constantInputs,
+    const ExprSet* exprSet) {
+  auto* execCtx = exprSet != nullptr ? exprSet->execCtx() : nullptr;
+  if (execCtx != nullptr && execCtx->vectorFunctionCache() != nullptr) {
+    return execCtx->vectorFunctionCache()->getOrCreate(
+        name, inputTypes, constantInputs);
+  }
+  return getVectorFunction(name, inputTypes, constantInputs);
+}
+
 std::vector<TypePtr> getTypes(const std::vector<ExprPtr>& exprs) {
   std::vector<TypePtr> types;
   types.reserve(exprs.size());
@@ -384,6 +401,7 @@ ExprPtr compileExpression(
       result = castExpr;
     }
   } else if (auto call = dynamic_cast<const core::CallTypedExpr*>(expr.get())) {
+    lazyScalarFunctions().ensureRegistered(call->name());
     if (auto specialForm = getSpecialForm(
             call->name(),
             resultType,
@@ -391,14 +409,18 @@ ExprPtr compileExpression(
             trackCpuUsage)) {
       result = specialForm;
     } else if (
-        auto func = getVectorFunction(
-            call->name(), inputTypes, getConstantInputs(compiledInputs))) {
+        auto func = getOrCreateVectorFunction(
+            call->name(),
+            inputTypes,
+            getConstantInputs(compiledInputs),
+            scope->exprSet)) {
       result = std::make_shared<Expr>(
           resultType,
           std::move(compiledInputs),
           func,
           call->name(),
           trackCpuUsage);
+      result->setValueMemoMaxEntries(config.exprValueMemoMaxEntries());
     } else if (
         auto simpleFunctionEntry =
             SimpleFunctions().resolveFunction(call->name(), inputTypes)) {
@@ -418,6 +440,7 @@ ExprPtr compileExpression(
           std::move(func),
           call->name(),
           trackCpuUsage);
+      result->setValueMemoMaxEntries(config.exprValueMemoMaxEntries());
     } else {
       const auto& functionName = call->name();
       auto vectorFunctionSignatures = getVectorFunctionSignatures(functionName);
@@ -483,6 +506,12 @@ ExprPtr compileExpression(
 
   auto folded =
       enableConstantFolding ? tryFoldIfConstant(result, scope) : result;
+  if (config.exprFuseArithmetic()) {
+    folded = FusedArithmeticExpr::tryFuse(folded);
+  }
+  if (!folded->inputs().empty()) {
+    folded->setCpuSampleEvery(config.exprSampleCpuEvery());
+  }
   scope->visited[expr.get()] = folded;
   return folded;
 }
@@ -404,8 +404,136 @@ std::unique_ptr<common::Filter> makeBetweenFilter(
       return nullptr;
   }
 }
+
+// Returns the subscript for the constant 'key' into a map or array of 'type',
+// or nullptr if 'key' is not a constant that a subfield can express. Array
+// subfields are 1-based like the subscripts.
+std::unique_ptr<common::Subfield::PathElement> toSubscript(
+    const Type& type,
+    const core::TypedExprPtr& key) {
+  auto queryCtx = std::make_shared<core::QueryCtx>();
+  auto value = toConstant(key, queryCtx);
+  if (!value || value->isNullAt(0)) {
+    return nullptr;
+  }
+  int64_t index;
+  switch (value->typeKind()) {
+    case TypeKind::TINYINT:
+      index = singleValue<int8_t>(value);
+      break;
+    case TypeKind::SMALLINT:
+      index = singleValue<int16_t>(value);
+      break;
+    case TypeKind::INTEGER:
+      index = singleValue<int32_t>(value);
+      break;
+    case TypeKind::BIGINT:
+      index = singleValue<int64_t>(value);
+      break;
+    case TypeKind::VARCHAR:
+      if (type.kind() != TypeKind::MAP) {
+        return nullptr;
+      }
+      return std::make_unique<common::Subfield::StringSubscript>(
+          std::string(singleValue<StringView>(value)));
+    default:
+      return nullptr;
+  }
+  if (type.kind() == TypeKind::ARRAY && index <= 0) {
+    return nullptr;
+  }
+  return std::make_unique<common::Subfield::LongSubscript>(index);
+}
+
+// Appends to 'path' the subfield that 'expr' accesses and returns the name of
+// its column. Returns nullptr if 'expr' is not a chain of struct member
+// accesses and subscripts with constant keys over a column.
+const std::string* toSubfieldPath(
+    const core::ITypedExpr* expr,
+    std::vector<std::unique_ptr<common::Subfield::PathElement>>& path) {
+  if (auto* field = dynamic_cast<const core::FieldAccessTypedExpr*>(expr)) {
+    const std::string* column = &field->name();
+    if (!field->isInputColumn()) {
+      column = toSubfieldPath(field->inputs()[0].get(), path);
+      if (!column) {
+        return nullptr;
+      }
+    }
+    path.push_back(
+        std::make_unique<common::Subfield::NestedField>(field->name()));
+    return column;
+  }
+  auto* call = asCall(expr);
+  if (!call || call->inputs().size() != 2 ||
+      (call->name() != "subscript" && call->name() != "element_at")) {
+    return nullptr;
+  }
+  const auto& container = call->inputs()[0];
+  auto* column = toSubfieldPath(container.get(), path);
+  if (!column) {
+    return nullptr;
+  }
+  auto subscript = toSubscript(*container->type(), call->inputs()[1]);
+  if (!subscript) {
+    return nullptr;
+  }
+  path.push_back(std::move(subscript));
+  return column;
+}
+
+// Adds the subfields of the columns that 'expr' accesses to 'subfields' and
+// the columns it uses as a whole to 'wholeColumns'. The names in 'lambdaArgs'
+// refer to arguments of enclosing lambdas, not columns.
+void collectSubfields(
+    const core::ITypedExpr* expr,
+    const std::unordered_set<std::string>& lambdaArgs,
+    std::unordered_map<std::string, std::vector<common::Subfield>>& subfields,
+    std::unordered_set<std::string>& wholeColumns) {
+  std::vector<std::unique_ptr<common::Subfield::PathElement>> path;
+  if (auto* column = toSubfieldPath(expr, path)) {
+    if (lambdaArgs.count(*column)) {
+      return;
+    }
+    if (path.size() == 1) {
+      wholeColumns.insert(*column);
+      return;
+    }
+    common::Subfield subfield(std::move(path));
+    auto& columnSubfields = subfields[*column];
+    if (std::find(columnSubfields.begin(), columnSubfields.end(), subfield) ==
+        columnSubfields.end()) {
+      columnSubfields.push_back(std::move(subfield));
+    }
+    return;
+  }
+  if (auto* lambda = dynamic_cast<const core::LambdaTypedExpr*>(expr)) {
+    auto innerLambdaArgs = lambdaArgs;
+    for (const auto& name : lambda->signature()->names()) {
+      innerLambdaArgs.insert(name);
+    }
+    collectSubfields(
+        lambda->body().get(), innerLambdaArgs, subfields, wholeColumns);
+    return;
+  }
+  for (const auto& input : expr->inputs()) {
+    collectSubfields(input.get(), lambdaArgs, subfields, wholeColumns);
+  }
+}
 } // namespace
 
+std::unordered_map<std::string, std::vector<common::Subfield>>
+extractRequiredSubfields(const std::vector<core::TypedExprPtr>& exprs) {
+  std::unordered_map<std::string, std::vector<common::Subfield>> subfields;
+  std::unordered_set<std::string> wholeColumns;
+  for (const auto& expr : exprs) {
+    collectSubfields(expr.get(), {}, subfields, wholeColumns);
+  }
+  for (const auto& column : wholeColumns) {
+    subfields[column].clear();
+  }
+  return subfields;
+}
+
 std::unique_ptr<common::Filter> leafCallToSubfieldFilter(
     const core::CallTypedExpr& call,
     common::Subfield& subfield) {
@@ -343,4 +343,13 @@ std::unique_ptr<common::Filter> leafCallToSubfieldFilter(
     const core::CallTypedExpr&,
     common::Subfield&);
 
+/// Returns the subfields of the input columns that 'exprs' access, keyed on
+/// column name. Struct member accesses and map and array subscripts with
+/// constant keys make subfields, e.g. c0['a'].x. The list of a column that
+/// some expression uses other than through such an access is empty, meaning
+/// that all of the column is required. Unreferenced columns are not in the
+/// result.
+std::unordered_map<std::string, std::vector<common::Subfield>>
+extractRequiredSubfields(const std::vector<core::TypedExprPtr>& exprs);
+
 } // namespace facebook::velox::exec
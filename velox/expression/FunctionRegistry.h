@@ -15,6 +15,9 @@
  */
 #pragma once
 
+#include <folly/Synchronized.h>
+
+#include "velox/expression/FunctionResolutionCache.h"
 #include "velox/expression/SignatureBinder.h"
 #include "velox/type/Type.h"
 
@@ -72,32 +75,39 @@ class FunctionRegistry {
   }
 
   std::vector<std::string> getFunctionNames() const {
-    std::vector<std::string> result;
-    result.reserve(registeredFunctions_.size());
+    return registeredFunctions_.withRLock([](const auto& functions) {
+      std::vector<std::string> result;
+      result.reserve(functions.size());
 
-    for (const auto& entry : registeredFunctions_) {
-      result.push_back(entry.first);
-    }
+      for (const auto& entry : functions) {
+        result.push_back(entry.first);
+      }
 
-    return result;
+      return result;
+    });
   }
 
   /// Used only in the unit tests.
   void testingClear() {
-    registeredFunctions_.clear();
+    registeredFunctions_.withWLock([&](auto& functions) {
+      functions.clear();
+      resolutions_.clear();
+    });
   }
 
   std::vector<const FunctionSignature*> getFunctionSignatures(
       const std::string& name) const {
-    std::vector<const FunctionSignature*> signatures;
-    if (const auto* signatureMap = getSignatureMap(name)) {
-      signatures.reserve(signatureMap->size());
-      for (const auto& pair : *signatureMap) {
-        signatures.emplace_back(&pair.first);
+    return registeredFunctions_.withRLock([&](const auto& functions) {
+      std::vector<const FunctionSignature*> signatures;
+      if (const auto* signatureMap = getSignatureMap(functions, name)) {
+        signatures.reserve(signatureMap->size());
+        for (const auto& pair : *signatureMap) {
+          signatures.emplace_back(&pair.first);
+        }
       }
-    }
 
-    return signatures;
+      return signatures;
+    });
   }
 
   class ResolvedSimpleFunction {
@@ -127,22 +137,37 @@ class FunctionRegistry {
   std::optional<ResolvedSimpleFunction> resolveFunction(
       const std::string& name,
       const std::vector<TypePtr>& argTypes) const {
+    const auto sanitizedName = sanitizeName(name);
+    if (auto cached = resolutions_.get(sanitizedName, argTypes)) {
+      return cached->entry ? std::optional<ResolvedSimpleFunction>(
+                                 ResolvedSimpleFunction(
+                                     *cached->entry, cached->type))
+                           : std::nullopt;
+    }
+
     const FunctionEntry<Function, Metadata>* selectedCandidate = nullptr;
     TypePtr selectedCandidateType = nullptr;
-    if (const auto* signatureMap = getSignatureMap(name)) {
-      for (const auto& [candidateSignature, functionEntry] : *signatureMap) {
-        SignatureBinder binder(candidateSignature, argTypes);
-        if (binder.tryBind()) {
-          auto* currentCandidate = functionEntry.get();
-          if (!selectedCandidate ||
-              currentCandidate->getMetadata().priority() <
-                  selectedCandidate->getMetadata().priority()) {
-            selectedCandidate = currentCandidate;
-            selectedCandidateType = binder.tryResolveReturnType();
+    registeredFunctions_.withRLock([&](const auto& functions) {
+      if (const auto* signatureMap =
+              getSignatureMap(functions, sanitizedName)) {
+        for (const auto& [candidateSignature, functionEntry] : *signatureMap) {
+          SignatureBinder binder(candidateSignature, argTypes);
+          if (binder.tryBind()) {
+            auto* currentCandidate = functionEntry.get();
+            if (!selectedCandidate ||
+                currentCandidate->getMetadata().priority() <
+                    selectedCandidate->getMetadata().priority()) {
+              selectedCandidate = currentCandidate;
+              selectedCandidateType = binder.tryResolveReturnType();
+            }
           }
         }
       }
-    }
+      // Cache under the lock so that a concurrent registration, which clears
+      // the cache, does not leave a stale result behind.
+      resolutions_.put(
+          sanitizedName, argTypes, {selectedCandidate, selectedCandidateType});
+    });
 
     VELOX_DCHECK(!selectedCandidate || selectedCandidateType);
 
@@ -164,18 +189,34 @@ class FunctionRegistry {
       const typename FunctionEntry<Function, Metadata>::FunctionFactory&
           factory) {
     const auto sanitizedName = sanitizeName(name);
-    SignatureMap& signatureMap = registeredFunctions_[sanitizedName];
+    auto functions = registeredFunctions_.wlock();
+    SignatureMap& signatureMap = (*functions)[sanitizedName];
     signatureMap[*metadata->signature()] =
         std::make_unique<const FunctionEntry<Function, Metadata>>(
             metadata, factory);
+    resolutions_.clear();
   }
 
-  const SignatureMap* getSignatureMap(const std::string& name) const {
+  static const SignatureMap* getSignatureMap(
+      const FunctionMap& functions,
+      const std::string& name) {
     const auto sanitizedName = sanitizeName(name);
-    const auto it = registeredFunctions_.find(sanitizedName);
-    return it != registeredFunctions_.end() ? &it->second : nullptr;
+    const auto it = functions.find(sanitizedName);
+    return it != functions.end() ? &it->second : nullptr;
   }
 
-  FunctionMap registeredFunctions_;
+  // Guarded so that functions can be registered lazily while other functions
+  // are being resolved. The entries are never removed outside of tests, so
+  // pointers to them stay valid after the lock is released.
+  folly::Synchronized<FunctionMap> registeredFunctions_;
+
+  struct CachedResolution {
+    // Null if no signature binds to the argument types.
+    const FunctionEntry<Function, Metadata>* entry;
+    TypePtr type;
+  };
+
+  // Results of resolveFunction(). Cleared on registration.
+  mutable FunctionResolutionCache<CachedResolution> resolutions_;
 };
 } // namespace facebook::velox::exec
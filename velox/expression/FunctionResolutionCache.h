@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/concurrency/ConcurrentHashMap.h>
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/type/Type.h"
+
+namespace facebook::velox::exec {
+
+/// Caches the results of resolving a function by name and argument types, so
+/// that compiling the same call many times binds the signatures only once.
+/// Lookups do not take locks. The owning registry must clear the cache
+/// whenever it registers or removes functions.
+template <typename Value>
+class FunctionResolutionCache {
+ public:
+  /// Returns the cached result for 'name' and 'argTypes' or std::nullopt if
+  /// there is none. 'name' must be sanitized.
+  std::optional<Value> get(
+      const std::string& name,
+      const std::vector<TypePtr>& argTypes) const {
+    auto it = entries_.find(Key{name, argTypes});
+    if (it == entries_.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  void put(
+      const std::string& name,
+      const std::vector<TypePtr>& argTypes,
+      Value value) {
+    if (entries_.size() >= kMaxEntries) {
+      // Bound the memory used by plans with a very large number of distinct
+      // calls.
+      entries_.clear();
+    }
+    entries_.insert_or_assign(Key{name, argTypes}, std::move(value));
+  }
+
+  void clear() {
+    entries_.clear();
+  }
+
+  size_t size() const {
+    return entries_.size();
+  }
+
+ private:
+  static constexpr size_t kMaxEntries = 100'000;
+
+  struct Key {
+    std::string name;
+    std::vector<TypePtr> argTypes;
+
+    bool operator==(const Key& other) const {
+      if (name != other.name || argTypes.size() != other.argTypes.size()) {
+        return false;
+      }
+      for (auto i = 0; i < argTypes.size(); ++i) {
+        if (*argTypes[i] != *other.argTypes[i]) {
+          return false;
+        }
+      }
+      return true;
+    }
+  };
+
+  struct KeyHasher {
+    size_t operator()(const Key& key) const {
+      auto hash = std::hash<std::string>()(key.name);
+      for (const auto& type : key.argTypes) {
+        hash = bits::hashMix(hash, type->hashKind());
+      }
+      return hash;
+    }
+  };
+
+  folly::ConcurrentHashMap<Key, Value, KeyHasher> entries_;
+};
+
+} // namespace facebook::velox::exec
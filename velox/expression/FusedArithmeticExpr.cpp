@@ -0,0 +1,422 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/expression/FusedArithmeticExpr.h"
+
+#include <optional>
+#include <unordered_map>
+
+#include "velox/expression/ConstantExpr.h"
+#include "velox/expression/FieldReference.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+
+using Op = FusedArithmeticExpr::Op;
+using Instruction = FusedArithmeticExpr::Instruction;
+
+// Number of rows processed by each pass of the program. The intermediate
+// results of a chunk stay in the L1 cache.
+constexpr int32_t kChunkSize = 256;
+
+std::optional<Op> arithmeticOp(const std::string& name) {
+  if (name == "plus") {
+    return Op::kPlus;
+  }
+  if (name == "minus") {
+    return Op::kMinus;
+  }
+  if (name == "multiply") {
+    return Op::kMultiply;
+  }
+  return std::nullopt;
+}
+
+std::optional<Op> comparisonOp(const std::string& name) {
+  static const std::unordered_map<std::string, Op> kComparisons = {
+      {"eq", Op::kEq},
+      {"neq", Op::kNeq},
+      {"lt", Op::kLt},
+      {"lte", Op::kLte},
+      {"gt", Op::kGt},
+      {"gte", Op::kGte},
+  };
+  auto it = kComparisons.find(name);
+  if (it == kComparisons.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+bool isOperandKind(TypeKind kind) {
+  return kind == TypeKind::REAL || kind == TypeKind::DOUBLE;
+}
+
+// Returns the binary function call 'expr' is, or nullptr.
+const Expr* binaryCall(const ExprPtr& expr) {
+  if (expr->isSpecialForm() || !expr->vectorFunction() ||
+      expr->inputs().size() != 2) {
+    return nullptr;
+  }
+  return expr.get();
+}
+
+// Appends 'expr' to 'program' in postfix order. Returns false if 'expr' is
+// not a tree of arithmetic over 'kind' with field and constant leaves.
+bool addToProgram(
+    ExprPtr expr,
+    TypeKind kind,
+    std::vector<ExprPtr>& leaves,
+    std::vector<Instruction>& program,
+    int32_t& numCalls) {
+  if (auto fused = std::dynamic_pointer_cast<FusedArithmeticExpr>(expr)) {
+    expr = fused->fallback();
+  }
+  if (expr->type()->kind() != kind) {
+    return false;
+  }
+  if (auto constant = std::dynamic_pointer_cast<ConstantExpr>(expr)) {
+    if (constant->value()->isNullAt(0)) {
+      return false;
+    }
+    program.push_back({Op::kLoad, static_cast<int32_t>(leaves.size())});
+    leaves.push_back(expr);
+    return true;
+  }
+  if (std::dynamic_pointer_cast<FieldReference>(expr)) {
+    program.push_back({Op::kLoad, static_cast<int32_t>(leaves.size())});
+    leaves.push_back(expr);
+    return true;
+  }
+  auto* call = binaryCall(expr);
+  if (!call) {
+    return false;
+  }
+  auto op = arithmeticOp(call->name());
+  if (!op.has_value()) {
+    return false;
+  }
+  for (const auto& input : call->inputs()) {
+    if (!addToProgram(input, kind, leaves, program, numCalls)) {
+      return false;
+    }
+  }
+  program.push_back({op.value()});
+  ++numCalls;
+  return true;
+}
+
+int32_t maxStackDepth(const std::vector<Instruction>& program) {
+  int32_t depth = 0;
+  int32_t maxDepth = 0;
+  for (const auto& instruction : program) {
+    if (instruction.op == Op::kLoad) {
+      maxDepth = std::max(maxDepth, ++depth);
+    } else {
+      --depth;
+    }
+  }
+  return maxDepth;
+}
+
+bool isComparison(Op op) {
+  return op >= Op::kEq;
+}
+
+template <typename T>
+struct Operand {
+  // Values of the rows of the current chunk. Not used if 'isConstant'.
+  const T* values;
+  T constant;
+  bool isConstant;
+};
+
+template <typename T, typename TOut, typename F>
+void applyBinary(
+    const Operand<T>& lhs,
+    const Operand<T>& rhs,
+    int32_t numRows,
+    TOut* out,
+    F func) {
+  if (lhs.isConstant && rhs.isConstant) {
+    std::fill(out, out + numRows, func(lhs.constant, rhs.constant));
+  } else if (lhs.isConstant) {
+    const auto constant = lhs.constant;
+    const auto* values = rhs.values;
+    for (auto i = 0; i < numRows; ++i) {
+      out[i] = func(constant, values[i]);
+    }
+  } else if (rhs.isConstant) {
+    const auto* values = lhs.values;
+    const auto constant = rhs.constant;
+    for (auto i = 0; i < numRows; ++i) {
+      out[i] = func(values[i], constant);
+    }
+  } else {
+    const auto* left = lhs.values;
+    const auto* right = rhs.values;
+    for (auto i = 0; i < numRows; ++i) {
+      out[i] = func(left[i], right[i]);
+    }
+  }
+}
+
+template <typename T>
+void applyArithmetic(
+    Op op,
+    const Operand<T>& lhs,
+    const Operand<T>& rhs,
+    int32_t numRows,
+    T* out) {
+  switch (op) {
+    case Op::kPlus:
+      applyBinary(lhs, rhs, numRows, out, [](T a, T b) { return a + b; });
+      break;
+    case Op::kMinus:
+      applyBinary(lhs, rhs, numRows, out, [](T a, T b) { return a - b; });
+      break;
+    case Op::kMultiply:
+      applyBinary(lhs, rhs, numRows, out, [](T a, T b) { return a * b; });
+      break;
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+template <typename T>
+void applyComparison(
+    Op op,
+    const Operand<T>& lhs,
+    const Operand<T>& rhs,
+    int32_t numRows,
+    uint8_t* out) {
+  switch (op) {
+    case Op::kEq:
+      applyBinary(lhs, rhs, numRows, out, [](T a, T b) { return a == b; });
+      break;
+    case Op::kNeq:
+      applyBinary(lhs, rhs, numRows, out, [](T a, T b) { return a != b; });
+      break;
+    case Op::kLt:
+      applyBinary(lhs, rhs, numRows, out, [](T a, T b) { return a < b; });
+      break;
+    case Op::kLte:
+      applyBinary(lhs, rhs, numRows, out, [](T a, T b) { return a <= b; });
+      break;
+    case Op::kGt:
+      applyBinary(lhs, rhs, numRows, out, [](T a, T b) { return a > b; });
+      break;
+    case Op::kGte:
+      applyBinary(lhs, rhs, numRows, out, [](T a, T b) { return a >= b; });
+      break;
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+} // namespace
+
+FusedArithmeticExpr::FusedArithmeticExpr(
+    ExprPtr fallback,
+    std::vector<ExprPtr> leaves,
+    std::vector<Instruction> program,
+    TypeKind operandKind,
+    int32_t maxDepth)
+    : SpecialForm(
+          fallback->type(),
+          std::vector<ExprPtr>{fallback},
+          "fused_arithmetic",
+          fallback->supportsFlatNoNullsFastPath(),
+          false /* trackCpuUsage */),
+      fallback_(std::move(fallback)),
+      leaves_(std::move(leaves)),
+      program_(std::move(program)),
+      operandKind_(operandKind),
+      maxDepth_(maxDepth) {}
+
+// static
+ExprPtr FusedArithmeticExpr::tryFuse(const ExprPtr& expr) {
+  if (std::dynamic_pointer_cast<FusedArithmeticExpr>(expr)) {
+    return expr;
+  }
+  auto* call = binaryCall(expr);
+  if (!call) {
+    return expr;
+  }
+
+  std::vector<ExprPtr> leaves;
+  std::vector<Instruction> program;
+  int32_t numCalls = 0;
+  TypeKind kind;
+  if (auto op = comparisonOp(call->name())) {
+    kind = call->inputs()[0]->type()->kind();
+    if (!isOperandKind(kind)) {
+      return expr;
+    }
+    for (const auto& input : call->inputs()) {
+      if (!addToProgram(input, kind, leaves, program, numCalls)) {
+        return expr;
+      }
+    }
+    program.push_back({op.value()});
+    ++numCalls;
+  } else {
+    kind = expr->type()->kind();
+    if (!isOperandKind(kind) ||
+        !addToProgram(expr, kind, leaves, program, numCalls)) {
+      return expr;
+    }
+  }
+  if (numCalls < 2) {
+    return expr;
+  }
+
+  auto maxDepth = maxStackDepth(program);
+  std::shared_ptr<FusedArithmeticExpr> fused(new FusedArithmeticExpr(
+      expr, std::move(leaves), std::move(program), kind, maxDepth));
+  fused->computeMetadata();
+  return fused;
+}
+
+void FusedArithmeticExpr::evalSpecialForm(
+    const SelectivityVector& rows,
+    EvalCtx& context,
+    VectorPtr& result) {
+  std::vector<VectorPtr> leafValues(leaves_.size());
+  bool canFuse = true;
+  for (auto i = 0; i < leaves_.size(); ++i) {
+    if (auto constant = std::dynamic_pointer_cast<ConstantExpr>(leaves_[i])) {
+      leafValues[i] = constant->value();
+      continue;
+    }
+    leaves_[i]->eval(rows, context, leafValues[i]);
+    if (!leafValues[i]->isFlatEncoding() ||
+        leafValues[i]->size() < rows.end()) {
+      canFuse = false;
+      break;
+    }
+  }
+  if (!canFuse) {
+    context.releaseVectors(leafValues);
+    fallback_->eval(rows, context, result);
+    return;
+  }
+
+  context.ensureWritable(rows, type(), result);
+  result->clearNulls(rows);
+  if (operandKind_ == TypeKind::REAL) {
+    evalChunks<float>(rows, leafValues, *result);
+  } else {
+    evalChunks<double>(rows, leafValues, *result);
+  }
+
+  // Null leaves make the result null.
+  for (const auto& values : leafValues) {
+    if (values->isConstantEncoding() || !values->mayHaveNulls()) {
+      continue;
+    }
+    const auto* leafNulls = values->rawNulls();
+    rows.applyToSelected([&](auto row) {
+      if (bits::isBitNull(leafNulls, row)) {
+        result->setNull(row, true);
+      }
+    });
+  }
+  context.releaseVectors(leafValues);
+}
+
+void FusedArithmeticExpr::evalSpecialFormSimplified(
+    const SelectivityVector& rows,
+    EvalCtx& context,
+    VectorPtr& result) {
+  fallback_->evalSimplified(rows, context, result);
+}
+
+template <typename T>
+void FusedArithmeticExpr::evalChunks(
+    const SelectivityVector& rows,
+    const std::vector<VectorPtr>& leafValues,
+    BaseVector& result) {
+  std::vector<Operand<T>> leafOperands(leafValues.size());
+  for (auto i = 0; i < leafValues.size(); ++i) {
+    if (leafValues[i]->isConstantEncoding()) {
+      leafOperands[i] = {
+          nullptr,
+          leafValues[i]->as<ConstantVector<T>>()->valueAt(0),
+          true};
+    } else {
+      leafOperands[i] = {
+          leafValues[i]->asUnchecked<FlatVector<T>>()->rawValues(), T(), false};
+    }
+  }
+
+  const bool isComparisonRoot = isComparison(program_.back().op);
+  std::vector<T> registers(maxDepth_ * kChunkSize);
+  std::vector<Operand<T>> stack(maxDepth_);
+  uint8_t flags[kChunkSize];
+  const auto* selectedBits = rows.asRange().bits();
+  const bool allSelected = rows.isAllSelected();
+
+  for (auto begin = rows.begin(); begin < rows.end(); begin += kChunkSize) {
+    const auto end = std::min<vector_size_t>(begin + kChunkSize, rows.end());
+    const auto numRows = end - begin;
+    if (!allSelected && bits::countBits(selectedBits, begin, end) == 0) {
+      continue;
+    }
+
+    int32_t depth = 0;
+    for (const auto& instruction : program_) {
+      if (instruction.op == Op::kLoad) {
+        auto operand = leafOperands[instruction.leaf];
+        if (!operand.isConstant) {
+          operand.values += begin;
+        }
+        stack[depth++] = operand;
+        continue;
+      }
+      const auto& lhs = stack[depth - 2];
+      const auto& rhs = stack[depth - 1];
+      if (isComparison(instruction.op)) {
+        applyComparison(instruction.op, lhs, rhs, numRows, flags);
+      } else {
+        auto* out = registers.data() + (depth - 2) * kChunkSize;
+        applyArithmetic(instruction.op, lhs, rhs, numRows, out);
+        stack[depth - 2] = {out, T(), false};
+      }
+      --depth;
+    }
+
+    if (isComparisonRoot) {
+      auto* rawResult =
+          result.asUnchecked<FlatVector<bool>>()->mutableRawValues<uint64_t>();
+      bits::forEachSetBit(selectedBits, begin, end, [&](auto row) {
+        bits::setBit(rawResult, row, flags[row - begin]);
+      });
+    } else {
+      auto* rawResult = result.asUnchecked<FlatVector<T>>()->mutableRawValues();
+      const auto* values = stack[0].values;
+      if (allSelected) {
+        std::copy(values, values + numRows, rawResult + begin);
+      } else {
+        bits::forEachSetBit(selectedBits, begin, end, [&](auto row) {
+          rawResult[row] = values[row - begin];
+        });
+      }
+    }
+  }
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/expression/SpecialForm.h"
+
+namespace facebook::velox::exec {
+
+/// Evaluates a tree of plus, minus and multiply calls over REAL or DOUBLE
+/// values, optionally topped by a comparison, in one pass over chunks of a
+/// few hundred rows. The intermediate results of a chunk stay in small
+/// buffers that fit in the L1 cache instead of a vector per node. The leaves
+/// are field references and constants. If a leaf is neither flat nor
+/// constant, the original tree is evaluated instead.
+class FusedArithmeticExpr : public SpecialForm {
+ public:
+  enum class Op : uint8_t {
+    kLoad,
+    kPlus,
+    kMinus,
+    kMultiply,
+    kEq,
+    kNeq,
+    kLt,
+    kLte,
+    kGt,
+    kGte,
+  };
+
+  /// One step of the postfix program. kLoad pushes the leaf at 'leaf'. The
+  /// other ops pop two operands and push the result.
+  struct Instruction {
+    Op op;
+    int32_t leaf{-1};
+  };
+
+  /// Returns a FusedArithmeticExpr that computes 'expr' if 'expr' is a
+  /// fusable tree with at least 2 calls, otherwise returns 'expr'.
+  static ExprPtr tryFuse(const ExprPtr& expr);
+
+  void evalSpecialForm(
+      const SelectivityVector& rows,
+      EvalCtx& context,
+      VectorPtr& result) override;
+
+  void evalSpecialFormSimplified(
+      const SelectivityVector& rows,
+      EvalCtx& context,
+      VectorPtr& result) override;
+
+  bool propagatesNulls() const override {
+    return true;
+  }
+
+  std::string toString(bool recursive = true) const override {
+    return fallback_->toString(recursive);
+  }
+
+  std::string toSql(
+      std::vector<VectorPtr>* complexConstants = nullptr) const override {
+    return fallback_->toSql(complexConstants);
+  }
+
+  const ExprPtr& fallback() const {
+    return fallback_;
+  }
+
+ private:
+  FusedArithmeticExpr(
+      ExprPtr fallback,
+      std::vector<ExprPtr> leaves,
+      std::vector<Instruction> program,
+      TypeKind operandKind,
+      int32_t maxDepth);
+
+  template <typename T>
+  void evalChunks(
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& leafValues,
+      BaseVector& result);
+
+  // The unfused tree. This is also the only input, so that metadata, stats
+  // and the fallback path see the original expressions.
+  const ExprPtr fallback_;
+
+  // Field references or constants, in the order of the kLoad instructions
+  // that refer to them.
+  const std::vector<ExprPtr> leaves_;
+
+  const std::vector<Instruction> program_;
+
+  // REAL or DOUBLE.
+  const TypeKind operandKind_;
+
+  // Maximum number of operands on the stack while running 'program_'.
+  const int32_t maxDepth_;
+};
+
+} // namespace facebook::velox::exec
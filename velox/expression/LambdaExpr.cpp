@@ -41,6 +41,14 @@ class ExprCallable : public Callable {
     return capture_->childrenSize() > signature_->size();
   }
 
+  const Expr* body() const override {
+    return body_.get();
+  }
+
+  RowTypePtr signature() const override {
+    return signature_;
+  }
+
   void apply(
       const SelectivityVector& rows,
       const SelectivityVector& finalSelection,
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/expression/LazyFunctionRegistry.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "velox/expression/FunctionSignature.h"
+
+namespace facebook::velox::exec {
+
+void LazyFunctionRegistry::add(
+    const std::vector<std::string>& names,
+    std::function<void()> registrar) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto group = std::make_shared<Group>();
+  group->registrars.emplace_back(nextSequence_++, std::move(registrar));
+
+  // Merge the groups of the registrars sharing a name with 'registrar'.
+  std::unordered_set<Group*> merged;
+  for (const auto& name : names) {
+    auto sanitizedName = sanitizeName(name);
+    auto it = groups_.find(sanitizedName);
+    if (it == groups_.end()) {
+      group->names.push_back(std::move(sanitizedName));
+      continue;
+    }
+    auto other = it->second;
+    if (!merged.insert(other.get()).second) {
+      continue;
+    }
+    for (auto& entry : other->registrars) {
+      group->registrars.push_back(std::move(entry));
+    }
+    for (auto& otherName : other->names) {
+      group->names.push_back(std::move(otherName));
+    }
+  }
+  std::sort(
+      group->registrars.begin(),
+      group->registrars.end(),
+      [](const auto& left, const auto& right) {
+        return left.first < right.first;
+      });
+
+  for (const auto& name : group->names) {
+    groups_[name] = group;
+  }
+  hasPending_.store(true, std::memory_order_release);
+}
+
+void LazyFunctionRegistry::runLocked(const std::shared_ptr<Group>& group) {
+  for (const auto& name : group->names) {
+    groups_.erase(name);
+  }
+  for (const auto& entry : group->registrars) {
+    entry.second();
+  }
+  if (groups_.empty()) {
+    hasPending_.store(false, std::memory_order_release);
+  }
+}
+
+void LazyFunctionRegistry::ensureRegistered(const std::string& name) {
+  if (!hasPending()) {
+    return;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = groups_.find(sanitizeName(name));
+  if (it == groups_.end()) {
+    return;
+  }
+  // Copy as 'runLocked' erases the map entry.
+  auto group = it->second;
+  runLocked(group);
+}
+
+void LazyFunctionRegistry::ensureAllRegistered() {
+  if (!hasPending()) {
+    return;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  while (!groups_.empty()) {
+    auto group = groups_.begin()->second;
+    runLocked(group);
+  }
+}
+
+LazyFunctionRegistry& lazyScalarFunctions() {
+  static LazyFunctionRegistry registry;
+  return registry;
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace facebook::velox::exec {
+
+/// Defers function registration until a function is first resolved, so that
+/// a process pays only for the functions it uses. Each registrar comes with
+/// the names of the functions it registers. Resolving a name runs the pending
+/// registrars for that name and nothing else. Registrars sharing a name run
+/// together in the order they were added, so that overloads of the same
+/// function end up as they would with eager registration.
+class LazyFunctionRegistry {
+ public:
+  /// Adds 'registrar' which registers functions named 'names'. 'names' must
+  /// cover all the functions registered by 'registrar'.
+  void add(
+      const std::vector<std::string>& names,
+      std::function<void()> registrar);
+
+  /// Runs the pending registrars for the function 'name'. No-op if there are
+  /// none. Blocks while another thread runs them.
+  void ensureRegistered(const std::string& name);
+
+  /// Runs all pending registrars.
+  void ensureAllRegistered();
+
+  /// Returns true if there are registrars that have not run yet.
+  bool hasPending() const {
+    return hasPending_.load(std::memory_order_acquire);
+  }
+
+ private:
+  struct Group {
+    // Registrars in the order they were added, by sequence number.
+    std::vector<std::pair<int64_t, std::function<void()>>> registrars;
+    std::vector<std::string> names;
+  };
+
+  // Removes 'group' from 'groups_' and runs its registrars.
+  void runLocked(const std::shared_ptr<Group>& group);
+
+  std::atomic_bool hasPending_{false};
+
+  // Held while running registrars so that concurrent resolutions of the same
+  // names wait for them to finish.
+  std::mutex mutex_;
+
+  int64_t nextSequence_{0};
+
+  // Maps sanitized function names to the group of registrars for them.
+  std::unordered_map<std::string, std::shared_ptr<Group>> groups_;
+};
+
+/// Pending registrations of scalar simple and vector functions. Consulted on
+/// resolving a function by name.
+LazyFunctionRegistry& lazyScalarFunctions();
+
+} // namespace facebook::velox::exec
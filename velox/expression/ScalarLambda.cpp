@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "velox/expression/ScalarLambda.h"
+
+#include <optional>
+
+#include "velox/expression/ConstantExpr.h"
+#include "velox/expression/FieldReference.h"
+#include "velox/expression/FusedArithmeticExpr.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+
+using Op = ScalarLambda::Op;
+using Instruction = ScalarLambda::Instruction;
+
+std::optional<Op> arithmeticOp(const std::string& name) {
+  if (name == "plus") {
+    return Op::kPlus;
+  }
+  if (name == "minus") {
+    return Op::kMinus;
+  }
+  if (name == "multiply") {
+    return Op::kMultiply;
+  }
+  return std::nullopt;
+}
+
+bool isOperandKind(TypeKind kind) {
+  return kind == TypeKind::BIGINT || kind == TypeKind::INTEGER ||
+      kind == TypeKind::DOUBLE || kind == TypeKind::REAL;
+}
+
+template <typename T>
+Instruction makeConstant(const BaseVector& value) {
+  const auto constant = value.as<SimpleVector<T>>()->valueAt(0);
+  Instruction instruction{Op::kConstant};
+  if constexpr (std::is_integral_v<T>) {
+    instruction.intConstant = constant;
+  } else {
+    instruction.doubleConstant = constant;
+  }
+  return instruction;
+}
+
+Instruction makeConstant(TypeKind kind, const BaseVector& value) {
+  switch (kind) {
+    case TypeKind::BIGINT:
+      return makeConstant<int64_t>(value);
+    case TypeKind::INTEGER:
+      return makeConstant<int32_t>(value);
+    case TypeKind::DOUBLE:
+      return makeConstant<double>(value);
+    case TypeKind::REAL:
+      return makeConstant<float>(value);
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+// Appends 'expr' to 'program' in postfix order. Returns false if 'expr' is
+// not a tree of arithmetic over 'kind' with parameter and constant leaves.
+bool addToProgram(
+    const Expr* expr,
+    TypeKind kind,
+    const RowType& signature,
+    std::vector<Instruction>& program) {
+  if (auto* fused = dynamic_cast<const FusedArithmeticExpr*>(expr)) {
+    expr = fused->fallback().get();
+  }
+  if (expr->type()->kind() != kind) {
+    return false;
+  }
+  if (auto* constant = dynamic_cast<const ConstantExpr*>(expr)) {
+    if (constant->value()->isNullAt(0)) {
+      return false;
+    }
+    program.push_back(makeConstant(kind, *constant->value()));
+    return true;
+  }
+  if (auto* field = dynamic_cast<const FieldReference*>(expr)) {
+    auto index = signature.getChildIdxIfExists(field->field());
+    if (!field->inputs().empty() || !index.has_value()) {
+      // A struct field access or a capture.
+      return false;
+    }
+    program.push_back({Op::kArgument, static_cast<int32_t>(index.value())});
+    return true;
+  }
+  if (expr->isSpecialForm() || !expr->vectorFunction() ||
+      expr->inputs().size() != 2) {
+    return false;
+  }
+  auto op = arithmeticOp(expr->name());
+  if (!op.has_value()) {
+    return false;
+  }
+  for (const auto& input : expr->inputs()) {
+    if (!addToProgram(input.get(), kind, signature, program)) {
+      return false;
+    }
+  }
+  program.push_back({op.value()});
+  return true;
+}
+
+int32_t maxStackDepth(const std::vector<Instruction>& program) {
+  int32_t depth = 0;
+  int32_t maxDepth = 0;
+  for (const auto& instruction : program) {
+    if (instruction.op == Op::kArgument || instruction.op == Op::kConstant) {
+      maxDepth = std::max(maxDepth, ++depth);
+    } else {
+      --depth;
+    }
+  }
+  return maxDepth;
+}
+
+} // namespace
+
+// static
+std::unique_ptr<ScalarLambda> ScalarLambda::tryCreate(
+    const Callable& callable) {
+  const auto* body = callable.body();
+  const auto signature = callable.signature();
+  if (!body || !signature) {
+    return nullptr;
+  }
+  const auto kind = body->type()->kind();
+  if (!isOperandKind(kind)) {
+    return nullptr;
+  }
+  for (const auto& type : signature->children()) {
+    if (type->kind() != kind) {
+      return nullptr;
+    }
+  }
+  std::vector<Instruction> program;
+  if (!addToProgram(body, kind, *signature, program) ||
+      maxStackDepth(program) > kMaxDepth) {
+    return nullptr;
+  }
+  return std::unique_ptr<ScalarLambda>(
+      new ScalarLambda(kind, std::move(program)));
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "velox/type/Type.h"
+#include "velox/vector/FunctionVector.h"
+
+namespace facebook::velox::exec {
+
+/// Interprets a lambda whose body is a tree of plus, minus and multiply calls
+/// over the lambda parameters and constants of a single BIGINT, INTEGER,
+/// DOUBLE or REAL type. Functions that apply a lambda element by element,
+/// such as reduce, use it to run the body in a tight loop over scalars
+/// instead of evaluating the body on a vector per step.
+class ScalarLambda {
+ public:
+  enum class Op : uint8_t {
+    kArgument,
+    kConstant,
+    kPlus,
+    kMinus,
+    kMultiply,
+  };
+
+  /// One step of the postfix program. kArgument pushes the parameter at
+  /// 'index'. kConstant pushes 'intConstant' or 'doubleConstant'. The other
+  /// ops pop two operands and push the result.
+  struct Instruction {
+    Op op;
+    int32_t index{-1};
+    int64_t intConstant{0};
+    double doubleConstant{0};
+  };
+
+  /// Maximum number of operands on the stack of a program.
+  static constexpr int32_t kMaxDepth = 16;
+
+  /// Returns nullptr if 'callable' is not an interpreted lambda or its body
+  /// is not a tree of arithmetic over the parameters and non-null constants
+  /// of one supported type. A body that references captures is not
+  /// supported.
+  static std::unique_ptr<ScalarLambda> tryCreate(const Callable& callable);
+
+  /// The type of the parameters, the constants and the result.
+  TypeKind kind() const {
+    return kind_;
+  }
+
+  /// Computes the body with 'args' as the parameter values. Integer
+  /// arithmetic is checked. Returns false on overflow, in which case the
+  /// caller evaluates the lambda as an expression to report the error.
+  template <typename T>
+  bool evaluate(const T* args, T& result) const {
+    T stack[kMaxDepth];
+    int32_t top = 0;
+    bool overflow = false;
+    for (const auto& instruction : program_) {
+      switch (instruction.op) {
+        case Op::kArgument:
+          stack[top++] = args[instruction.index];
+          break;
+        case Op::kConstant:
+          if constexpr (std::is_integral_v<T>) {
+            stack[top++] = instruction.intConstant;
+          } else {
+            stack[top++] = instruction.doubleConstant;
+          }
+          break;
+        case Op::kPlus:
+          --top;
+          overflow |= add(stack[top - 1], stack[top]);
+          break;
+        case Op::kMinus:
+          --top;
+          overflow |= subtract(stack[top - 1], stack[top]);
+          break;
+        case Op::kMultiply:
+          --top;
+          overflow |= multiply(stack[top - 1], stack[top]);
+          break;
+      }
+    }
+    result = stack[0];
+    return !overflow;
+  }
+
+ private:
+  ScalarLambda(TypeKind kind, std::vector<Instruction> program)
+      : kind_(kind), program_(std::move(program)) {}
+
+  // The operations below store the result in 'a' and return true on
+  // integer overflow.
+  template <typename T>
+  static bool add(T& a, T b) {
+    if constexpr (std::is_integral_v<T>) {
+      return __builtin_add_overflow(a, b, &a);
+    } else {
+      a += b;
+      return false;
+    }
+  }
+
+  template <typename T>
+  static bool subtract(T& a, T b) {
+    if constexpr (std::is_integral_v<T>) {
+      return __builtin_sub_overflow(a, b, &a);
+    } else {
+      a -= b;
+      return false;
+    }
+  }
+
+  template <typename T>
+  static bool multiply(T& a, T b) {
+    if constexpr (std::is_integral_v<T>) {
+      return __builtin_mul_overflow(a, b, &a);
+    } else {
+      a *= b;
+      return false;
+    }
+  }
+
+  const TypeKind kind_;
+  const std::vector<Instruction> program_;
+};
+
+} // namespace facebook::velox::exec
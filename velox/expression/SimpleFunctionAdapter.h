@@ -88,6 +88,34 @@ class SimpleFunctionAdapter : public VectorFunction {
       SimpleTypeTrait<arg_at<POSITION>>::isPrimitiveType&&
           SimpleTypeTrait<arg_at<POSITION>>::typeKind != TypeKind::BOOLEAN;
 
+  // Whether the function provides callBatch() and the result and all
+  // arguments are fixed-width types other than BOOLEAN, so that flat vectors
+  // have their values in contiguous arrays.
+  constexpr bool static batchIterationEligible() {
+    if constexpr (
+        FUNC::udf_has_callBatch && fastPathIteration &&
+        return_type_traits::typeKind != TypeKind::BOOLEAN) {
+      return allArgsFixedWidthNonBooleanImpl(
+          std::make_index_sequence<FUNC::num_args>());
+    }
+    return false;
+  }
+
+  template <size_t... Is>
+  constexpr bool static allArgsFixedWidthNonBooleanImpl(
+      std::index_sequence<Is...>) {
+    return ([&]() {
+      if constexpr (isVariadicType<arg_at<Is>>::value) {
+        return false;
+      } else if constexpr (!SimpleTypeTrait<arg_at<Is>>::isPrimitiveType) {
+        return false;
+      } else {
+        return SimpleTypeTrait<arg_at<Is>>::isFixedWidth &&
+            SimpleTypeTrait<arg_at<Is>>::typeKind != TypeKind::BOOLEAN;
+      }
+    }() && ...);
+  }
+
   constexpr int32_t reuseStringsFromArgValue() const {
     return udf_reuse_strings_from_arg<typename FUNC::udf_struct_t>();
   }
@@ -331,7 +359,14 @@ class SimpleFunctionAdapter : public VectorFunction {
     }
 
     std::vector<std::optional<LocalDecodedVector>> decoded;
-    if (allPrimitiveArgsFlatConstant(args)) {
+    bool calledBatch = false;
+    if constexpr (batchIterationEligible()) {
+      calledBatch = tryCallBatch(
+          applyContext, args, std::make_index_sequence<FUNC::num_args>());
+    }
+    if (calledBatch) {
+      // All rows are computed.
+    } else if (allPrimitiveArgsFlatConstant(args)) {
       if constexpr (
           allArgsFlatConstantFastPathEligible() && specializeForAllEncodings) {
         unpackSpecializeForAllEncodings<0>(applyContext, args);
@@ -376,6 +411,32 @@ class SimpleFunctionAdapter : public VectorFunction {
     }
   }
 
+  // Calls callBatch() on the whole range of 'rows' if all rows are selected
+  // and all arguments are flat without nulls. Returns false if the rows must
+  // be computed one by one.
+  template <size_t... Is>
+  bool tryCallBatch(
+      ApplyContext& applyContext,
+      const std::vector<VectorPtr>& args,
+      std::index_sequence<Is...>) const {
+    const auto& rows = *applyContext.rows;
+    if (!rows.isAllSelected()) {
+      return false;
+    }
+    for (const auto& arg : args) {
+      if (!arg->isFlatEncoding() || arg->mayHaveNulls()) {
+        return false;
+      }
+    }
+    (*fn_).callBatch(
+        applyContext.result->mutableRawValues() + rows.begin(),
+        rows.end() - rows.begin(),
+        (args[Is]->template asUnchecked<FlatVector<exec_arg_at<Is>>>()
+             ->rawValues() +
+         rows.begin())...);
+    return true;
+  }
+
   // Acquire string buffer from source if vector is a string flat vector.
   void tryAcquireStringBuffer(BaseVector* vector, const BaseVector* source)
       const {
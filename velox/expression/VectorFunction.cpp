@@ -17,6 +17,7 @@
 #include <unordered_map>
 #include "folly/Singleton.h"
 #include "folly/Synchronized.h"
+#include "velox/expression/FunctionResolutionCache.h"
 #include "velox/expression/SignatureBinder.h"
 
 namespace facebook::velox::exec {
@@ -26,6 +27,36 @@ VectorFunctionMap& vectorFunctionFactories() {
   return factories;
 }
 
+namespace {
+// Return types resolved by resolveVectorFunction(). Null for argument types
+// no signature binds to. Cleared on registration.
+FunctionResolutionCache<TypePtr>& vectorFunctionResolutions() {
+  static FunctionResolutionCache<TypePtr> resolutions;
+  return resolutions;
+}
+
+// Resolves the return type of 'sanitizedName' for 'argTypes' with the lock on
+// 'functions' held.
+TypePtr resolveVectorFunctionLocked(
+    const std::unordered_map<std::string, VectorFunctionEntry>& functions,
+    const std::string& sanitizedName,
+    const std::vector<TypePtr>& argTypes) {
+  TypePtr returnType;
+  auto it = functions.find(sanitizedName);
+  if (it != functions.end()) {
+    for (const auto& signature : it->second.signatures) {
+      exec::SignatureBinder binder(*signature, argTypes);
+      if (binder.tryBind()) {
+        returnType = binder.tryResolveReturnType();
+        break;
+      }
+    }
+  }
+  vectorFunctionResolutions().put(sanitizedName, argTypes, returnType);
+  return returnType;
+}
+} // namespace
+
 std::optional<std::vector<FunctionSignaturePtr>> getVectorFunctionSignatures(
     const std::string& name) {
   auto sanitizedName = sanitizeName(name);
@@ -41,17 +72,13 @@ std::optional<std::vector<FunctionSignaturePtr>> getVectorFunctionSignatures(
 std::shared_ptr<const Type> resolveVectorFunction(
     const std::string& functionName,
     const std::vector<TypePtr>& argTypes) {
-  if (auto vectorFunctionSignatures =
-          exec::getVectorFunctionSignatures(functionName)) {
-    for (const auto& signature : vectorFunctionSignatures.value()) {
-      exec::SignatureBinder binder(*signature, argTypes);
-      if (binder.tryBind()) {
-        return binder.tryResolveReturnType();
-      }
-    }
+  auto sanitizedName = sanitizeName(functionName);
+  if (auto cached = vectorFunctionResolutions().get(sanitizedName, argTypes)) {
+    return cached.value();
   }
-
-  return nullptr;
+  return vectorFunctionFactories().withRLock([&](const auto& functions) {
+    return resolveVectorFunctionLocked(functions, sanitizedName, argTypes);
+  });
 }
 
 std::shared_ptr<VectorFunction> getVectorFunction(
@@ -79,14 +106,81 @@ std::shared_ptr<VectorFunction> getVectorFunction(
   return vectorFunctionFactories().withRLock(
       [&sanitizedName, &inputArgs, &inputTypes](
           auto& functionMap) -> std::shared_ptr<VectorFunction> {
-        if (resolveVectorFunction(sanitizedName, inputTypes)) {
-          auto functionIterator = functionMap.find(sanitizedName);
+        auto functionIterator = functionMap.find(sanitizedName);
+        if (functionIterator == functionMap.end()) {
+          return nullptr;
+        }
+        auto cached =
+            vectorFunctionResolutions().get(sanitizedName, inputTypes);
+        auto returnType = cached.has_value()
+            ? cached.value()
+            : resolveVectorFunctionLocked(
+                  functionMap, sanitizedName, inputTypes);
+        if (returnType) {
           return functionIterator->second.factory(sanitizedName, inputArgs);
         }
         return nullptr;
       });
 }
 
+bool VectorFunctionCache::Key::operator==(const Key& other) const {
+  if (name != other.name || inputTypes.size() != other.inputTypes.size() ||
+      constantInputs.size() != other.constantInputs.size()) {
+    return false;
+  }
+  for (auto i = 0; i < inputTypes.size(); ++i) {
+    if (*inputTypes[i] != *other.inputTypes[i]) {
+      return false;
+    }
+  }
+  for (auto i = 0; i < constantInputs.size(); ++i) {
+    const auto& constant = constantInputs[i];
+    const auto& otherConstant = other.constantInputs[i];
+    if ((constant == nullptr) != (otherConstant == nullptr)) {
+      return false;
+    }
+    if (constant != nullptr &&
+        !constant->equalValueAt(otherConstant.get(), 0, 0)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t VectorFunctionCache::KeyHasher::operator()(const Key& key) const {
+  auto hash = std::hash<std::string>()(key.name);
+  for (const auto& type : key.inputTypes) {
+    hash = bits::hashMix(hash, type->hashKind());
+  }
+  for (const auto& constant : key.constantInputs) {
+    if (constant != nullptr) {
+      hash = bits::hashMix(hash, constant->hashValueAt(0));
+    }
+  }
+  return hash;
+}
+
+std::shared_ptr<VectorFunction> VectorFunctionCache::getOrCreate(
+    const std::string& name,
+    const std::vector<TypePtr>& inputTypes,
+    const std::vector<VectorPtr>& constantInputs) {
+  Key key{sanitizeName(name), inputTypes, constantInputs};
+  {
+    auto functions = functions_.rlock();
+    auto it = functions->find(key);
+    if (it != functions->end()) {
+      return it->second;
+    }
+  }
+  auto function = getVectorFunction(name, inputTypes, constantInputs);
+  if (function == nullptr) {
+    return nullptr;
+  }
+  return functions_.wlock()
+      ->emplace(std::move(key), std::move(function))
+      .first->second;
+}
+
 /// Registers a new vector function. When overwrite = true, previous functions
 /// with the given name will be replaced.
 /// Returns true iff an insertion actually happened
@@ -103,6 +197,7 @@ bool registerStatefulVectorFunction(
       // Insert/overwrite.
       functionMap[sanitizedName] = {
           std::move(signatures), std::move(factory), std::move(metadata)};
+      vectorFunctionResolutions().clear();
     });
     return true;
   }
@@ -111,6 +206,7 @@ bool registerStatefulVectorFunction(
     auto [iterator, inserted] = functionMap.insert(
         {sanitizedName,
          {std::move(signatures), std::move(factory), std::move(metadata)}});
+    vectorFunctionResolutions().clear();
     return inserted;
   });
 }
@@ -182,6 +182,45 @@ std::shared_ptr<VectorFunction> getVectorFunction(
     const std::vector<TypePtr>& inputTypes,
     const std::vector<VectorPtr>& constantInputs);
 
+/// Holds the VectorFunctions made by getVectorFunction() for reuse by later
+/// compilations of calls with the same name, input types and constant input
+/// values. Saves resolving the signature and running the factory of a
+/// stateful function, e.g. compiling a regular expression, in each Driver
+/// that compiles the same expression. An instance is owned by a Task, so that
+/// the functions and the constants they may hold do not outlive the memory
+/// pools of the Task. Use only with functions whose apply() does not modify
+/// the function, since the Drivers use it at the same time.
+class VectorFunctionCache {
+ public:
+  /// Returns the VectorFunction like getVectorFunction(). Returns the same
+  /// instance for the same arguments.
+  std::shared_ptr<VectorFunction> getOrCreate(
+      const std::string& name,
+      const std::vector<TypePtr>& inputTypes,
+      const std::vector<VectorPtr>& constantInputs);
+
+  size_t size() const {
+    return functions_.rlock()->size();
+  }
+
+ private:
+  struct Key {
+    std::string name;
+    std::vector<TypePtr> inputTypes;
+    std::vector<VectorPtr> constantInputs;
+
+    bool operator==(const Key& other) const;
+  };
+
+  struct KeyHasher {
+    size_t operator()(const Key& key) const;
+  };
+
+  folly::Synchronized<
+      std::unordered_map<Key, std::shared_ptr<VectorFunction>, KeyHasher>>
+      functions_;
+};
+
 struct VectorFunctionMetadata {
   /// Boolean indicating whether this function supports flattening, i.e.
   /// converting a set of nested calls into a single call.
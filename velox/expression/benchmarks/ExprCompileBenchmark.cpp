@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+
+// Measures compilation of wide projections, which is dominated by function
+// resolution when the same functions are called many times.
+
+using namespace facebook::velox;
+
+namespace {
+class ExprCompileBenchmark : public functions::test::FunctionBenchmarkBase {
+ public:
+  ExprCompileBenchmark() : FunctionBenchmarkBase() {
+    functions::prestosql::registerAllScalarFunctions();
+    rowType_ = ROW({"c0", "c1", "c2"}, {BIGINT(), DOUBLE(), VARCHAR()});
+  }
+
+  size_t run(const std::string& expression, int32_t width) {
+    folly::BenchmarkSuspender suspender;
+    auto untyped = parse::parseExpr(expression, options_);
+    std::vector<core::TypedExprPtr> exprs;
+    exprs.reserve(width);
+    for (auto i = 0; i < width; ++i) {
+      exprs.push_back(core::Expressions::inferTypes(untyped, rowType_, pool()));
+    }
+    suspender.dismiss();
+
+    exec::ExprSet exprSet(std::move(exprs), &execCtx_);
+    return exprSet.size();
+  }
+
+ private:
+  RowTypePtr rowType_;
+};
+
+std::unique_ptr<ExprCompileBenchmark> benchmark;
+
+BENCHMARK_MULTI(arithmetic100) {
+  return benchmark->run("c0 + 1 > c1 * 2.0", 100);
+}
+
+BENCHMARK_MULTI(arithmetic1000) {
+  return benchmark->run("c0 + 1 > c1 * 2.0", 1'000);
+}
+
+BENCHMARK_MULTI(string1000) {
+  return benchmark->run("concat(upper(c2), substr(c2, 1, 3))", 1'000);
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<ExprCompileBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+
+// Compares evaluating trees of arithmetic over DOUBLE columns with one vector
+// per node against the fused loop enabled by
+// 'expression.fuse_arithmetic'.
+
+using namespace facebook::velox;
+
+namespace {
+class FusedArithmeticBenchmark : public functions::test::FunctionBenchmarkBase {
+ public:
+  FusedArithmeticBenchmark() : FunctionBenchmarkBase() {
+    functions::prestosql::registerAllScalarFunctions();
+
+    const vector_size_t size = 10'000;
+    std::vector<VectorPtr> columns;
+    for (auto i = 0; i < 4; ++i) {
+      columns.emplace_back(vectorMaker_.flatVector<double>(
+          size, [i](auto row) { return (row % 100) * 0.1 + i; }));
+    }
+    data_ = vectorMaker_.rowVector(columns);
+  }
+
+  size_t run(const std::string& expression, bool fuse) {
+    folly::BenchmarkSuspender suspender;
+    queryCtx_->setConfigOverridesUnsafe({
+        {core::QueryConfig::kExprFuseArithmetic, fuse ? "true" : "false"},
+    });
+    auto exprSet = compileExpression(expression, asRowType(data_->type()));
+    suspender.dismiss();
+
+    size_t count = 0;
+    for (auto i = 0; i < 100; ++i) {
+      count += evaluate(exprSet, data_)->size();
+    }
+    return count;
+  }
+
+ private:
+  RowVectorPtr data_;
+};
+
+std::unique_ptr<FusedArithmeticBenchmark> benchmark;
+
+const std::string kProject = "c0 * c1 + c2 * c3 - c0";
+const std::string kFilter = "c0 * c1 + c2 > c3";
+
+BENCHMARK_MULTI(project) {
+  return benchmark->run(kProject, false);
+}
+
+BENCHMARK_RELATIVE_MULTI(projectFused) {
+  return benchmark->run(kProject, true);
+}
+
+BENCHMARK_MULTI(filter) {
+  return benchmark->run(kFilter, false);
+}
+
+BENCHMARK_RELATIVE_MULTI(filterFused) {
+  return benchmark->run(kFilter, true);
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<FusedArithmeticBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "velox/expression/ConstantStateCache.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+namespace facebook::velox::exec {
+namespace {
+
+class ConstantStateCacheTest : public testing::Test,
+                               public test::VectorTestBase {};
+
+struct State {
+  int64_t value;
+};
+
+TEST_F(ConstantStateCacheTest, basic) {
+  auto& cache = ConstantStateCache::instance();
+  cache.removeExpired();
+  const auto initialSize = cache.size();
+
+  VectorPtr constant = makeConstant<int64_t>(11, 1);
+  int32_t numCreates = 0;
+  auto create = [&]() {
+    ++numCreates;
+    return std::make_shared<const State>(State{numCreates});
+  };
+  auto state = cache.getOrCreate<State>(constant, create);
+  ASSERT_EQ(state->value, 1);
+  ASSERT_EQ(cache.getOrCreate<State>(constant, create), state);
+  ASSERT_EQ(numCreates, 1);
+
+  // Another constant with the same value has its own state.
+  VectorPtr otherConstant = makeConstant<int64_t>(11, 1);
+  ASSERT_EQ(cache.getOrCreate<State>(otherConstant, create)->value, 2);
+
+  // The state of another type is separate.
+  auto stringState = cache.getOrCreate<std::string>(
+      constant, []() { return std::make_shared<const std::string>("s"); });
+  ASSERT_EQ(*stringState, "s");
+  ASSERT_EQ(cache.size(), initialSize + 3);
+
+  // The entries expire with their constant. The state stays valid for its
+  // users.
+  constant.reset();
+  ASSERT_EQ(cache.getOrCreate<State>(otherConstant, create)->value, 2);
+  cache.removeExpired();
+  ASSERT_EQ(cache.size(), initialSize + 1);
+  ASSERT_EQ(state->value, 1);
+  ASSERT_EQ(numCreates, 2);
+}
+
+} // namespace
+} // namespace facebook::velox::exec
@@ -16,6 +16,7 @@
 #include "gtest/gtest.h"
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/expression/Expr.h"
+#include "velox/expression/FusedArithmeticExpr.h"
 #include "velox/functions/prestosql/registration/RegistrationFunctions.h"
 #include "velox/functions/prestosql/types/JsonType.h"
 #include "velox/parse/TypeResolver.h"
@@ -65,6 +66,10 @@ class ExprCompilerTest : public testing::Test,
     return std::make_shared<core::ConstantTypedExpr>(BIGINT(), value);
   }
 
+  core::TypedExprPtr doubleLiteral(double value) {
+    return std::make_shared<core::ConstantTypedExpr>(DOUBLE(), value);
+  }
+
   core::TypedExprPtr varchar(const std::string& value) {
     return std::make_shared<core::ConstantTypedExpr>(VARCHAR(), variant(value));
   }
@@ -224,4 +229,119 @@ TEST_F(ExprCompilerTest, customTypeConstant) {
   ASSERT_EQ("[1, 2, 3]:JSON", compile(expression)->toString());
 }
 
+TEST_F(ExprCompilerTest, fuseArithmetic) {
+  auto rowType = ROW({"a", "b", "c"}, {DOUBLE(), DOUBLE(), DOUBLE()});
+  auto field = makeField(rowType);
+
+  // a * b + c > 1.5
+  auto expression = call(
+      "gt",
+      {call("plus", {call("multiply", {field("a"), field("b")}), field("c")}),
+       doubleLiteral(1.5)});
+  // a * b - c * 2.0
+  auto arithmetic = call(
+      "minus",
+      {call("multiply", {field("a"), field("b")}),
+       call("multiply", {field("c"), doubleLiteral(2.0)})});
+
+  auto evaluate = [&](const core::TypedExprPtr& expr,
+                      const RowVectorPtr& input,
+                      const SelectivityVector& rows) {
+    auto exprSet = compile(expr);
+    EvalCtx context(execCtx_.get(), exprSet.get(), input.get());
+    std::vector<VectorPtr> result(1);
+    exprSet->eval(rows, context, result);
+    return result[0];
+  };
+
+  vector_size_t size = 1'000;
+  auto data = makeRowVector({
+      makeFlatVector<double>(size, [](auto row) { return row * 0.01; }),
+      makeFlatVector<double>(
+          size, [](auto row) { return row % 7 - 3; }, nullEvery(11)),
+      makeFlatVector<double>(size, [](auto row) { return row % 5 * 0.5; }),
+  });
+  auto dictionaryData = makeRowVector({
+      data->childAt(0),
+      wrapInDictionary(makeIndicesInReverse(size), size, data->childAt(1)),
+      data->childAt(2),
+  });
+  SelectivityVector allRows(size);
+  SelectivityVector someRows(size);
+  for (auto i = 0; i < size; i += 3) {
+    someRows.setValid(i, false);
+  }
+  someRows.updateBounds();
+
+  std::vector<VectorPtr> expected;
+  for (const auto& expr : {expression, arithmetic}) {
+    for (const auto& input : {data, dictionaryData}) {
+      for (const auto* rows : {&allRows, &someRows}) {
+        expected.push_back(evaluate(expr, input, *rows));
+      }
+    }
+  }
+
+  queryCtx_->setConfigOverridesUnsafe({
+      {core::QueryConfig::kExprFuseArithmetic, "true"},
+  });
+  for (const auto& expr : {expression, arithmetic}) {
+    auto exprSet = compile(expr);
+    ASSERT_TRUE(
+        std::dynamic_pointer_cast<FusedArithmeticExpr>(exprSet->expr(0)));
+  }
+  ASSERT_EQ(
+      "gt(plus(multiply(a, b), c), 1.5:DOUBLE)",
+      compile(expression)->toString());
+
+  // Results match the unfused trees for the fused path, the fallback for
+  // dictionary inputs and for partial selections.
+  auto it = expected.begin();
+  for (const auto& expr : {expression, arithmetic}) {
+    for (const auto& input : {data, dictionaryData}) {
+      for (const auto* rows : {&allRows, &someRows}) {
+        auto result = evaluate(expr, input, *rows);
+        rows->applyToSelected([&](auto row) {
+          ASSERT_TRUE((*it)->equalValueAt(result.get(), row, row))
+              << "at " << row << ": " << (*it)->toString(row) << " vs. "
+              << result->toString(row);
+        });
+        ++it;
+      }
+    }
+  }
+
+  // A single call is not fused.
+  auto exprSet = compile(call("plus", {field("a"), field("b")}));
+  ASSERT_FALSE(
+      std::dynamic_pointer_cast<FusedArithmeticExpr>(exprSet->expr(0)));
+}
+
+TEST_F(ExprCompilerTest, sharedVectorFunctions) {
+  auto rowType = ROW({"a"}, {VARCHAR()});
+  auto field = makeField(rowType);
+  auto expression = call("regexp_like", {field("a"), varchar("a.*b")});
+
+  // Without a cache each compilation makes its own function.
+  auto first = compile(expression);
+  auto second = compile(expression);
+  ASSERT_NE(
+      first->expr(0)->vectorFunction(), second->expr(0)->vectorFunction());
+
+  VectorFunctionCache cache;
+  execCtx_->setVectorFunctionCache(&cache);
+  first = compile(expression);
+  second = compile(expression);
+  ASSERT_EQ(
+      first->expr(0)->vectorFunction(), second->expr(0)->vectorFunction());
+  ASSERT_EQ(cache.size(), 1);
+
+  // A different constant makes a different function.
+  auto other = compile(call("regexp_like", {field("a"), varchar("a.*c")}));
+  ASSERT_NE(
+      first->expr(0)->vectorFunction(), other->expr(0)->vectorFunction());
+  ASSERT_EQ(cache.size(), 2);
+  execCtx_->setVectorFunctionCache(nullptr);
+}
+
 } // namespace facebook::velox::exec::test
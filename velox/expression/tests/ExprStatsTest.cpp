@@ -363,6 +363,42 @@ TEST_F(ExprStatsTest, specialForms) {
   ASSERT_TRUE(exec::unregisterExprSetListener(listener));
 }
 
+TEST_F(ExprStatsTest, sampledCpuUsage) {
+  queryCtx_->setConfigOverridesUnsafe({
+      {core::QueryConfig::kExprTrackCpuUsage, "false"},
+      {core::QueryConfig::kExprSampleCpuEvery, "2"},
+  });
+
+  vector_size_t size = 1'024;
+  auto data = makeRowVector({
+      makeFlatVector<int32_t>(size, [](auto row) { return row; }),
+      makeFlatVector<int32_t>(size, [](auto row) { return row % 7; }),
+  });
+
+  auto exprSet = compileExpressions({"(c0 + 3) * c1"}, asRowType(data->type()));
+  for (auto i = 0; i < 3; ++i) {
+    evaluate(*exprSet, data);
+  }
+
+  // The first and the third batches are timed.
+  auto stats = exprSet->statsBySignature();
+  for (const auto& signature :
+       {"multiply(BIGINT, BIGINT)", "plus(BIGINT, BIGINT)"}) {
+    SCOPED_TRACE(signature);
+    const auto& exprStats = stats.at(signature);
+    ASSERT_EQ(3, exprStats.numProcessedVectors);
+    ASSERT_EQ(1024 * 3, exprStats.numProcessedRows);
+    ASSERT_EQ(0, exprStats.timing.count);
+    ASSERT_EQ(2, exprStats.sampledTiming.count);
+    ASSERT_EQ(1024 * 2, exprStats.numSampledRows);
+    ASSERT_GE(exprStats.estimatedCpuNanos(), exprStats.sampledTiming.cpuNanos);
+  }
+
+  // Field references and constants are not reported.
+  ASSERT_EQ(0, stats.count("c0"));
+  ASSERT_EQ(0, stats.count("3:BIGINT"));
+}
+
 TEST_F(ExprStatsTest, errorLog) {
   // Register a listener to log exceptions.
   std::vector<Event> events;
@@ -448,3 +484,69 @@ TEST_F(ExprStatsTest, exceptionPreparingStatsForListener) {
   evaluate(*exprSet, makeRowVector({varbinaryData}));
   ASSERT_TRUE(exec::unregisterExprSetListener(listener));
 }
+
+TEST_F(ExprStatsTest, valueMemo) {
+  queryCtx_->setConfigOverridesUnsafe({
+      {core::QueryConfig::kExprValueMemoMaxEntries, "100"},
+  });
+
+  vector_size_t size = 1'024;
+  auto makeData = [&](int32_t offset) {
+    return makeRowVector({makeFlatVector<std::string>(
+        size,
+        [&](auto row) {
+          return fmt::format("value number {}", (row + offset) % 10);
+        },
+        nullEvery(7))});
+  };
+  auto rowType = asRowType(makeData(0)->type());
+  auto numNonNull = size - (size + 6) / 7;
+
+  // The first batch adds the 10 distinct values to the memo. The second batch
+  // finds all of them there.
+  auto exprSet = compileExpressions({"upper(c0)"}, rowType);
+  for (auto offset : {0, 3}) {
+    auto result = evaluate(*exprSet, makeData(offset));
+    assertEqualVectors(
+        makeFlatVector<std::string>(
+            size,
+            [&](auto row) {
+              return fmt::format("VALUE NUMBER {}", (row + offset) % 10);
+            },
+            nullEvery(7)),
+        result);
+  }
+  EXPECT_EQ(2 * size, exprSet->stats().at("upper").numValueMemoLookups);
+  EXPECT_EQ(numNonNull, exprSet->stats().at("upper").numValueMemoHits);
+
+  exprSet = compileExpressions({"regexp_like(c0, '[1-3]$')"}, rowType);
+  for (auto offset : {0, 3}) {
+    auto result = evaluate(*exprSet, makeData(offset));
+    assertEqualVectors(
+        makeFlatVector<bool>(
+            size,
+            [&](auto row) {
+              auto digit = (row + offset) % 10;
+              return digit >= 1 && digit <= 3;
+            },
+            nullEvery(7)),
+        result);
+  }
+  EXPECT_EQ(numNonNull, exprSet->stats().at("regexp_like").numValueMemoHits);
+
+  // Only the first 5 distinct values fit in the memo.
+  queryCtx_->setConfigOverridesUnsafe({
+      {core::QueryConfig::kExprValueMemoMaxEntries, "5"},
+  });
+  exprSet = compileExpressions({"upper(c0)"}, rowType);
+  evaluate(*exprSet, makeData(0));
+  evaluate(*exprSet, makeData(0));
+  EXPECT_GT(exprSet->stats().at("upper").numValueMemoHits, 0);
+  EXPECT_LT(exprSet->stats().at("upper").numValueMemoHits, numNonNull);
+
+  // Disabled by default.
+  queryCtx_->setConfigOverridesUnsafe({});
+  exprSet = compileExpressions({"upper(c0)"}, rowType);
+  evaluate(*exprSet, makeData(0));
+  EXPECT_EQ(0, exprSet->stats().at("upper").numValueMemoLookups);
+}
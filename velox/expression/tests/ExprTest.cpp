@@ -381,6 +381,34 @@ TEST_F(ExprTest, reorder) {
   }
 }
 
+TEST_F(ExprTest, reorderByStaticCost) {
+  constexpr int32_t kTestSize = 1'000;
+
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(kTestSize, [](auto row) { return row; }),
+      makeFlatVector<std::string>(
+          kTestSize, [](auto row) { return fmt::format("value {}", row); }),
+  });
+  auto exprSet = compileExpression(
+      "regexp_like(c1, '[0-4]$') and c0 < 10", asRowType(data->type()));
+  auto result = evaluate(exprSet.get(), data);
+
+  auto expectedResult = makeFlatVector<bool>(
+      kTestSize, [](auto row) { return row < 10 && row % 10 < 5; });
+  assertEqualVectors(expectedResult, result);
+
+  // Without history, the comparison over integers runs first, so the regular
+  // expression only sees the 10 rows that pass it.
+  auto condition =
+      std::dynamic_pointer_cast<exec::ConjunctExpr>(exprSet->expr(0));
+  ASSERT_TRUE(condition != nullptr);
+  std::vector<uint64_t> numIn = {
+      condition->selectivityAt(0).numIn(),
+      condition->selectivityAt(1).numIn()};
+  std::sort(numIn.begin(), numIn.end());
+  EXPECT_EQ(numIn, (std::vector<uint64_t>{10, kTestSize}));
+}
+
 TEST_F(ExprTest, constant) {
   auto exprSet = compileExpression("1 + 2 + 3 + 4", ROW({}));
   auto constExpr = dynamic_cast<exec::ConstantExpr*>(exprSet->expr(0).get());
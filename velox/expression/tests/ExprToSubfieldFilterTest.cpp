@@ -223,5 +223,51 @@ TEST_F(ExprToSubfieldFilterTest, userError) {
   ASSERT_FALSE(filter);
 }
 
+TEST_F(ExprToSubfieldFilterTest, requiredSubfields) {
+  auto rowType =
+      ROW({"m", "a", "s", "w", "b", "c"},
+          {MAP(VARCHAR(), BIGINT()),
+           ARRAY(BIGINT()),
+           ROW({"x", "y"}, {BIGINT(), MAP(BIGINT(), DOUBLE())}),
+           MAP(VARCHAR(), BIGINT()),
+           BIGINT(),
+           ARRAY(BIGINT())});
+  std::vector<core::TypedExprPtr> exprs;
+  for (const auto& sql :
+       {"m['a'] + m['b'] + m['a']",
+        "element_at(a, 3) + s.x",
+        "s.y[5] > 1.0",
+        "cardinality(w) > 2 AND w['k'] > 0",
+        "b > 1",
+        "element_at(c, -1) > 0"}) {
+    exprs.push_back(parseExpr(sql, rowType));
+  }
+  auto subfields = extractRequiredSubfields(exprs);
+
+  auto toStrings = [&](const std::string& column) {
+    std::vector<std::string> paths;
+    for (const auto& subfield : subfields.at(column)) {
+      paths.push_back(subfield.toString());
+    }
+    return paths;
+  };
+  ASSERT_EQ(subfields.size(), 6);
+  EXPECT_EQ(toStrings("m"), (std::vector<std::string>{"m[\"a\"]", "m[\"b\"]"}));
+  EXPECT_EQ(toStrings("a"), std::vector<std::string>{"a[3]"});
+  EXPECT_EQ(toStrings("s"), (std::vector<std::string>{"s.x", "s.y[5]"}));
+  // Whole columns and columns accessed with keys that subfields can't
+  // express.
+  EXPECT_TRUE(subfields.at("w").empty());
+  EXPECT_TRUE(subfields.at("b").empty());
+  EXPECT_TRUE(subfields.at("c").empty());
+
+  // Fields of lambda arguments are not columns.
+  subfields = extractRequiredSubfields(
+      {parseExpr("transform(a, x -> x + m['k'])", rowType)});
+  ASSERT_EQ(subfields.size(), 2);
+  EXPECT_TRUE(subfields.at("a").empty());
+  EXPECT_EQ(toStrings("m"), std::vector<std::string>{"m[\"k\"]"});
+}
+
 } // namespace
 } // namespace facebook::velox::exec
@@ -1085,4 +1085,65 @@ TEST_F(SimpleFunctionTest, evalGenericOutput) {
   assertEqualVectors(expected, result);
 }
 
+// Counts the rows computed by call() and callBatch().
+template <typename T>
+struct BatchPlusFunction {
+  static inline int32_t numRowCalls = 0;
+  static inline int32_t numBatchRows = 0;
+
+  FOLLY_ALWAYS_INLINE void
+  call(int64_t& result, const int64_t& a, const int64_t& b) {
+    ++numRowCalls;
+    result = a + b;
+  }
+
+  FOLLY_ALWAYS_INLINE void callBatch(
+      int64_t* result,
+      int32_t numRows,
+      const int64_t* a,
+      const int64_t* b) {
+    numBatchRows += numRows;
+    for (auto i = 0; i < numRows; ++i) {
+      result[i] = a[i] + b[i];
+    }
+  }
+};
+
+TEST_F(SimpleFunctionTest, callBatch) {
+  registerFunction<BatchPlusFunction, int64_t, int64_t, int64_t>(
+      {"batch_plus"});
+  using Function = BatchPlusFunction<exec::VectorExec>;
+
+  const vector_size_t size = 1'000;
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(size, [](auto row) { return row * 2; }),
+  });
+  auto expected =
+      makeFlatVector<int64_t>(size, [](auto row) { return row * 3; });
+
+  // Flat inputs without nulls use callBatch().
+  auto result = evaluate("batch_plus(c0, c1)", data);
+  assertEqualVectors(expected, result);
+  EXPECT_EQ(size, Function::numBatchRows);
+  EXPECT_EQ(0, Function::numRowCalls);
+
+  // Inputs with nulls and constant inputs are computed one row at a time.
+  Function::numBatchRows = 0;
+  auto dataWithNulls = makeRowVector({
+      makeFlatVector<int64_t>(size, [](auto row) { return row; }, nullEvery(5)),
+      data->childAt(1),
+  });
+  result = evaluate("batch_plus(c0, c1)", dataWithNulls);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row * 3; }, nullEvery(5)),
+      result);
+  result = evaluate("batch_plus(c0, 1)", data);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(size, [](auto row) { return row + 1; }), result);
+  EXPECT_EQ(0, Function::numBatchRows);
+  EXPECT_EQ(size - size / 5 + size, Function::numRowCalls);
+}
+
 } // namespace
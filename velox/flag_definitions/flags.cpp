@@ -72,6 +72,15 @@ DEFINE_bool(avx2, true, "Enables use of AVX2 when available");
 
 DEFINE_bool(bmi2, true, "Enables use of BMI2 when available");
 
+// Used in exec/Exchange.cpp
+
+DEFINE_bool(
+    velox_exchange_colocated_tasks_shortcut,
+    true,
+    "Read the output of a producer task that runs in the same process "
+    "directly from its output buffer instead of through the exchange source "
+    "registered for its location");
+
 // Used in exec/Expr.cpp
 
 DEFINE_string(
@@ -24,6 +24,7 @@
 #include "velox/core/SimpleFunctionMetadata.h"
 #include "velox/expression/FunctionCallToSpecialForm.h"
 #include "velox/expression/FunctionSignature.h"
+#include "velox/expression/LazyFunctionRegistry.h"
 #include "velox/expression/SignatureBinder.h"
 #include "velox/expression/SimpleFunctionRegistry.h"
 #include "velox/expression/VectorFunction.h"
@@ -71,6 +72,7 @@ void populateVectorFunctionSignatures(FunctionSignatureMap& map) {
 } // namespace
 
 FunctionSignatureMap getFunctionSignatures() {
+  exec::lazyScalarFunctions().ensureAllRegistered();
   FunctionSignatureMap result;
   populateSimpleFunctionSignatures(result);
   populateVectorFunctionSignatures(result);
@@ -120,6 +122,7 @@ std::shared_ptr<const Type> resolveCallableSpecialForm(
 std::shared_ptr<const Type> resolveSimpleFunction(
     const std::string& functionName,
     const std::vector<TypePtr>& argTypes) {
+  exec::lazyScalarFunctions().ensureRegistered(functionName);
   if (auto resolvedFunction =
           exec::SimpleFunctions().resolveFunction(functionName, argTypes)) {
     return resolvedFunction->type();
@@ -131,6 +134,7 @@ std::shared_ptr<const Type> resolveSimpleFunction(
 std::shared_ptr<const Type> resolveVectorFunction(
     const std::string& functionName,
     const std::vector<TypePtr>& argTypes) {
+  exec::lazyScalarFunctions().ensureRegistered(functionName);
   return exec::resolveVectorFunction(functionName, argTypes);
 }
 
@@ -18,6 +18,7 @@
 #include <folly/String.h>
 #include <velox/common/base/Exceptions.h>
 #include <velox/type/Date.h>
+#include <algorithm>
 #include <cstring>
 #include <stdexcept>
 #include "velox/external/date/date.h"
@@ -180,37 +181,55 @@ static std::
         };
 constexpr int monthsFullLength[] = {7, 8, 5, 5, 3, 4, 4, 6, 9, 7, 8, 8};
 
-/// Pads the content with desired padding characters. E.g. if we need to pad 999
-/// with three 0s in front, the result will be '000999'
-/// \param content the content that is going to be padded.
-/// \param padding the padding that is going to be used to pad the content.
-/// \param totalDigits the total number of digits the padded result is desired
-/// to be. If totalDigits is already smaller than content length, the original
-/// content will be returned with no padding
-/// \param padFront if the padding is in front of the content or back of the
-/// content.
-template <typename T>
-std::string padContent(
-    const T& content,
-    char padding,
-    size_t totalDigits,
-    bool padFront = true) {
-  std::string strContent = folly::to<std::string>(content);
-  auto contentLength = strContent.size();
-  if (contentLength == 0) {
-    return std::string(totalDigits, padding);
+/// Writes 'value' in decimal to 'out', padded with leading zeros after the
+/// sign to at least 'minDigits' digits. E.g. 7 with 'minDigits' 3 is written
+/// as 007 and -7 as -007. Returns the number of bytes written.
+size_t writeNumber(int64_t value, size_t minDigits, char* out) {
+  char* start = out;
+  uint64_t absValue = value;
+  if (value < 0) {
+    *out++ = '-';
+    absValue = -absValue;
   }
-
-  bool isNegative = strContent[0] == '-';
-  auto digitLength = contentLength - (isNegative ? 1 : 0);
-  if (digitLength >= totalDigits) {
-    return strContent;
+  char digits[20];
+  size_t numDigits = 0;
+  do {
+    digits[numDigits++] = '0' + absValue % 10;
+    absValue /= 10;
+  } while (absValue != 0);
+  if (numDigits < minDigits) {
+    std::memset(out, '0', minDigits - numDigits);
+    out += minDigits - numDigits;
   }
-  std::string paddingStr(totalDigits - digitLength, padding);
-  if (padFront) {
-    return strContent.insert((isNegative ? 1 : 0), paddingStr);
-  } else {
-    return strContent.append(paddingStr);
+  while (numDigits > 0) {
+    *out++ = digits[--numDigits];
+  }
+  return out - start;
+}
+
+size_t writeString(std::string_view value, char* out) {
+  std::memcpy(out, value.data(), value.size());
+  return value.size();
+}
+
+/// Upper bound on the number of bytes written for 'pattern', not counting
+/// time zone names.
+size_t maxPatternSize(const FormatPattern& pattern) {
+  switch (pattern.specifier) {
+    case DateTimeFormatSpecifier::ERA:
+    case DateTimeFormatSpecifier::HALFDAY_OF_DAY:
+      return 2;
+    case DateTimeFormatSpecifier::DAY_OF_WEEK_TEXT:
+    case DateTimeFormatSpecifier::MONTH_OF_YEAR_TEXT:
+      // "Wednesday" and "September".
+      return 9;
+    case DateTimeFormatSpecifier::FRACTION_OF_SECOND:
+      return pattern.minRepresentDigits;
+    case DateTimeFormatSpecifier::TIMEZONE:
+      return 0;
+    default:
+      // A sign and the digits of an int64_t or the padding.
+      return std::max<size_t>(pattern.minRepresentDigits, 19) + 1;
   }
 }
 
@@ -484,31 +503,22 @@ int64_t parseHalfDayOfDay(const char* cur, const char* end, Date& date) {
   }
 }
 
-std::string formatFractionOfSecond(
+/// Writes the 'minRepresentDigits' leading digits of the milliseconds
+/// 'subseconds', padded with trailing zeros. Returns the number of bytes
+/// written.
+size_t writeFractionOfSecond(
     uint16_t subseconds,
-    size_t minRepresentDigits) {
-  char toAdd[minRepresentDigits > 3 ? minRepresentDigits + 1 : 4];
-
-  if (subseconds < 10) {
-    toAdd[0] = '0';
-    toAdd[1] = '0';
-    toAdd[2] = char(subseconds + '0');
-  } else if (subseconds < 100) {
-    toAdd[2] = char(subseconds % 10 + '0');
-    toAdd[1] = char((subseconds / 10) % 10 + '0');
-    toAdd[0] = '0';
-  } else {
-    toAdd[2] = char(subseconds % 10 + '0');
-    toAdd[1] = char((subseconds / 10) % 10 + '0');
-    toAdd[0] = char((subseconds / 100) % 10 + '0');
-  }
-
+    size_t minRepresentDigits,
+    char* out) {
+  const char digits[3] = {
+      char((subseconds / 100) % 10 + '0'),
+      char((subseconds / 10) % 10 + '0'),
+      char(subseconds % 10 + '0')};
+  std::memcpy(out, digits, std::min<size_t>(minRepresentDigits, 3));
   if (minRepresentDigits > 3) {
-    memset(toAdd + 3, '0', minRepresentDigits - 3);
+    std::memset(out + 3, '0', minRepresentDigits - 3);
   }
-
-  toAdd[minRepresentDigits] = '\0';
-  return toAdd;
+  return minRepresentDigits;
 }
 
 // According to DateTimeFormatSpecifier enum class
@@ -616,6 +626,70 @@ int getMaxDigitConsume(
   }
 }
 
+/// Returns the number of leading decimal digits in the 8 bytes of 'word',
+/// the first byte being the lowest one.
+inline int32_t countLeadingDigits(uint64_t word) {
+  constexpr uint64_t kHighNibbles = 0xF0F0F0F0F0F0F0F0ULL;
+  constexpr uint64_t kZeros = 0x3030303030303030ULL;
+  // A byte is a digit if its high nibble is 3 and adding 6 keeps it there.
+  // Carries out of non-digit bytes only affect the bytes after them.
+  const uint64_t nonDigits = ((word & kHighNibbles) ^ kZeros) |
+      (((word + 0x0606060606060606ULL) & kHighNibbles) ^ kZeros);
+  if (nonDigits == 0) {
+    return 8;
+  }
+  return __builtin_ctzll(nonDigits) / 8;
+}
+
+/// Returns the value of the 8 digits in 'word', the first byte being the most
+/// significant digit.
+inline uint64_t parseEightDigits(uint64_t word) {
+  word -= 0x3030303030303030ULL;
+  word = (word * 10) + (word >> 8);
+  return (((word & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+          (((word >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >>
+      32;
+}
+
+/// Reads at most 'maxDigits' leading digits of [cur, end) and accumulates them
+/// into 'number'. Returns the number of digits read. Scans and converts 8
+/// bytes at a time when there is room for a full word.
+int32_t scanDigits(
+    const char* cur,
+    const char* end,
+    int32_t maxDigits,
+    int64_t& number) {
+  static constexpr uint64_t kPowersOfTen[] = {
+      1, 10, 100, 1'000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000};
+  int32_t count = 0;
+  while (count < maxDigits && end - cur >= 8) {
+    uint64_t word;
+    std::memcpy(&word, cur, sizeof(word));
+    const auto numDigits =
+        std::min(countLeadingDigits(word), maxDigits - count);
+    if (numDigits == 0) {
+      return count;
+    }
+    // Shift out the bytes after the digits and fill in leading zeros.
+    const auto digits = numDigits == 8
+        ? word
+        : (word << (8 * (8 - numDigits))) |
+            (0x3030303030303030ULL >> (8 * numDigits));
+    number = number * kPowersOfTen[numDigits] + parseEightDigits(digits);
+    cur += numDigits;
+    count += numDigits;
+    if (numDigits < 8) {
+      return count;
+    }
+  }
+  while (count < maxDigits && cur < end && characterIsDigit(*cur)) {
+    number = number * 10 + (*cur - '0');
+    ++cur;
+    ++count;
+  }
+  return count;
+}
+
 void parseFromPattern(
     FormatPattern curPattern,
     const std::string_view& input,
@@ -712,13 +786,8 @@ void parseFromPattern(
       //                                  [70, 99] -> [1970, 1999]
       // If more than two digits are provided, then simply read in full year
       // normally without conversion
-      int count = 0;
-      while (cur < end && cur < startPos + maxDigitConsume &&
-             characterIsDigit(*cur)) {
-        number = number * 10 + (*cur - '0');
-        ++cur;
-        ++count;
-      }
+      const int count = scanDigits(cur, end, maxDigitConsume, number);
+      cur += count;
       if (count == 2) {
         if (number >= 70) {
           number += 1900;
@@ -737,11 +806,7 @@ void parseFromPattern(
         }
       }
     } else {
-      while (cur < end && cur < startPos + maxDigitConsume &&
-             characterIsDigit(*cur)) {
-        number = number * 10 + (*cur - '0');
-        ++cur;
-      }
+      cur += scanDigits(cur, end, maxDigitConsume, number);
     }
 
     // Need to have read at least one digit.
@@ -949,9 +1014,10 @@ void parseFromPattern(
 
 } // namespace
 
-std::string DateTimeFormatter::format(
+int32_t DateTimeFormatter::format(
     const Timestamp& timestamp,
-    const date::time_zone* timezone) const {
+    const date::time_zone* timezone,
+    char* result) const {
   const std::chrono::
       time_point<std::chrono::system_clock, std::chrono::milliseconds>
           timePoint(std::chrono::milliseconds(timestamp.toMillis()));
@@ -962,30 +1028,31 @@ std::string DateTimeFormatter::format(
   const date::year_month_day calDate(daysTimePoint);
   const date::weekday weekday(daysTimePoint);
 
-  std::string result;
+  char* out = result;
   for (auto& token : tokens_) {
     if (token.type == DateTimeToken::Type::kLiteral) {
-      result += token.literal;
+      out += writeString(token.literal, out);
     } else {
       switch (token.pattern.specifier) {
         case DateTimeFormatSpecifier::ERA:
-          result += static_cast<signed>(calDate.year()) > 0 ? "AD" : "BC";
+          out += writeString(
+              static_cast<signed>(calDate.year()) > 0 ? "AD" : "BC", out);
           break;
 
         case DateTimeFormatSpecifier::CENTURY_OF_ERA: {
           auto year = static_cast<signed>(calDate.year());
           year = (year < 0 ? -year : year);
           auto century = year / 100;
-          result += padContent(century, '0', token.pattern.minRepresentDigits);
+          out += writeNumber(century, token.pattern.minRepresentDigits, out);
         } break;
 
         case DateTimeFormatSpecifier::YEAR_OF_ERA: {
           auto year = static_cast<signed>(calDate.year());
           if (token.pattern.minRepresentDigits == 2) {
-            result += padContent(std::abs(year) % 100, '0', 2);
+            out += writeNumber(std::abs(year) % 100, 2, out);
           } else {
             year = year <= 0 ? std::abs(year - 1) : year;
-            result += padContent(year, '0', token.pattern.minRepresentDigits);
+            out += writeNumber(year, token.pattern.minRepresentDigits, out);
           }
         } break;
 
@@ -997,16 +1064,16 @@ std::string DateTimeFormatter::format(
                   DateTimeFormatSpecifier::DAY_OF_WEEK_1_BASED) {
             weekdayNum = 7;
           }
-          result +=
-              padContent(weekdayNum, '0', token.pattern.minRepresentDigits);
+          out +=
+              writeNumber(weekdayNum, token.pattern.minRepresentDigits, out);
         } break;
 
         case DateTimeFormatSpecifier::DAY_OF_WEEK_TEXT: {
           auto weekdayNum = weekday.c_encoding();
           if (token.pattern.minRepresentDigits <= 3) {
-            result += weekdaysShort[weekdayNum];
+            out += writeString(weekdaysShort[weekdayNum], out);
           } else {
-            result += weekdaysFull[weekdayNum];
+            out += writeString(weekdaysFull[weekdayNum], out);
           }
         } break;
 
@@ -1015,13 +1082,13 @@ std::string DateTimeFormatter::format(
           if (token.pattern.minRepresentDigits == 2) {
             year = std::abs(year);
             auto twoDigitYear = year % 100;
-            result +=
-                padContent(twoDigitYear, '0', token.pattern.minRepresentDigits);
+            out += writeNumber(
+                twoDigitYear, token.pattern.minRepresentDigits, out);
           } else {
-            result += padContent(
+            out += writeNumber(
                 static_cast<signed>(calDate.year()),
-                '0',
-                token.pattern.minRepresentDigits);
+                token.pattern.minRepresentDigits,
+                out);
           }
         } break;
 
@@ -1032,33 +1099,36 @@ std::string DateTimeFormatter::format(
               (date::sys_days{calDate} - date::sys_days{firstDayOfTheYear})
                   .count();
           delta += 1;
-          result += padContent(delta, '0', token.pattern.minRepresentDigits);
+          out += writeNumber(delta, token.pattern.minRepresentDigits, out);
         } break;
 
         case DateTimeFormatSpecifier::MONTH_OF_YEAR:
-          result += padContent(
+          out += writeNumber(
               static_cast<unsigned>(calDate.month()),
-              '0',
-              token.pattern.minRepresentDigits);
+              token.pattern.minRepresentDigits,
+              out);
           break;
 
         case DateTimeFormatSpecifier::MONTH_OF_YEAR_TEXT:
           if (token.pattern.minRepresentDigits <= 3) {
-            result += monthsShort[static_cast<unsigned>(calDate.month()) - 1];
+            out += writeString(
+                monthsShort[static_cast<unsigned>(calDate.month()) - 1], out);
           } else {
-            result += monthsFull[static_cast<unsigned>(calDate.month()) - 1];
+            out += writeString(
+                monthsFull[static_cast<unsigned>(calDate.month()) - 1], out);
           }
           break;
 
         case DateTimeFormatSpecifier::DAY_OF_MONTH:
-          result += padContent(
+          out += writeNumber(
               static_cast<unsigned>(calDate.day()),
-              '0',
-              token.pattern.minRepresentDigits);
+              token.pattern.minRepresentDigits,
+              out);
           break;
 
         case DateTimeFormatSpecifier::HALFDAY_OF_DAY:
-          result += durationInTheDay.hours().count() < 12 ? "AM" : "PM";
+          out += writeString(
+              durationInTheDay.hours().count() < 12 ? "AM" : "PM", out);
           break;
 
         case DateTimeFormatSpecifier::HOUR_OF_HALFDAY:
@@ -1078,27 +1148,28 @@ std::string DateTimeFormatter::format(
               DateTimeFormatSpecifier::CLOCK_HOUR_OF_DAY) {
             hourNum = (hourNum + 23) % 24 + 1;
           }
-          result += padContent(hourNum, '0', token.pattern.minRepresentDigits);
+          out += writeNumber(hourNum, token.pattern.minRepresentDigits, out);
         } break;
 
         case DateTimeFormatSpecifier::MINUTE_OF_HOUR:
-          result += padContent(
+          out += writeNumber(
               durationInTheDay.minutes().count() % 60,
-              '0',
-              token.pattern.minRepresentDigits);
+              token.pattern.minRepresentDigits,
+              out);
           break;
 
         case DateTimeFormatSpecifier::SECOND_OF_MINUTE:
-          result += padContent(
+          out += writeNumber(
               durationInTheDay.seconds().count() % 60,
-              '0',
-              token.pattern.minRepresentDigits);
+              token.pattern.minRepresentDigits,
+              out);
           break;
 
         case DateTimeFormatSpecifier::FRACTION_OF_SECOND: {
-          result += formatFractionOfSecond(
+          out += writeFractionOfSecond(
               durationInTheDay.subseconds().count(),
-              token.pattern.minRepresentDigits);
+              token.pattern.minRepresentDigits,
+              out);
           break;
         }
 
@@ -1111,7 +1182,7 @@ std::string DateTimeFormatter::format(
           if (timezone == nullptr) {
             VELOX_USER_FAIL("Timezone unknown")
           }
-          result += timezone->name();
+          out += writeString(timezone->name(), out);
           break;
 
         case DateTimeFormatSpecifier::TIMEZONE_OFFSET_ID:
@@ -1126,9 +1197,39 @@ std::string DateTimeFormatter::format(
       }
     }
   }
+  return out - result;
+}
+
+std::string DateTimeFormatter::format(
+    const Timestamp& timestamp,
+    const date::time_zone* timezone) const {
+  std::string result(maxResultSize(timezone), '\0');
+  result.resize(format(timestamp, timezone, result.data()));
   return result;
 }
 
+size_t DateTimeFormatter::maxResultSize(
+    const date::time_zone* timezone) const {
+  if (numTimezoneNames_ == 0 || timezone == nullptr) {
+    return maxResultSize_;
+  }
+  return maxResultSize_ + numTimezoneNames_ * timezone->name().size();
+}
+
+void DateTimeFormatter::initMaxResultSize() {
+  maxResultSize_ = 0;
+  numTimezoneNames_ = 0;
+  for (const auto& token : tokens_) {
+    if (token.type == DateTimeToken::Type::kLiteral) {
+      maxResultSize_ += token.literal.size();
+    } else if (token.pattern.specifier == DateTimeFormatSpecifier::TIMEZONE) {
+      ++numTimezoneNames_;
+    } else {
+      maxResultSize_ += maxPatternSize(token.pattern);
+    }
+  }
+}
+
 DateTimeResult DateTimeFormatter::parse(const std::string_view& input) const {
   Date date;
   const char* cur = input.data();
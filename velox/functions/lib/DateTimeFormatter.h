@@ -159,7 +159,9 @@ class DateTimeFormatter {
       : literalBuf_(std::move(literalBuf)),
         bufSize_(bufSize),
         tokens_(std::move(tokens)),
-        type_(type) {}
+        type_(type) {
+    initMaxResultSize();
+  }
 
   const std::unique_ptr<char[]>& literalBuf() const {
     return literalBuf_;
@@ -179,11 +181,31 @@ class DateTimeFormatter {
       const Timestamp& timestamp,
       const date::time_zone* timezone) const;
 
+  /// Returns an upper bound on the number of bytes written by format() with
+  /// 'timezone'.
+  size_t maxResultSize(const date::time_zone* timezone) const;
+
+  /// Formats 'timestamp' into 'result', which must have room for
+  /// maxResultSize(timezone) bytes. Digits are written directly into 'result'
+  /// without intermediate strings. Returns the number of bytes written.
+  int32_t format(
+      const Timestamp& timestamp,
+      const date::time_zone* timezone,
+      char* result) const;
+
  private:
+  void initMaxResultSize();
+
   std::unique_ptr<char[]> literalBuf_;
   size_t bufSize_;
   std::vector<DateTimeToken> tokens_;
   DateTimeFormatterType type_;
+
+  // Bytes written for the tokens other than time zone names at most.
+  size_t maxResultSize_;
+
+  // Number of time zone name tokens.
+  size_t numTimezoneNames_;
 };
 
 std::shared_ptr<DateTimeFormatter> buildMysqlDateTimeFormatter(
@@ -300,6 +300,12 @@ void KllSketch<T, A, C>::doInsert(T value) {
   if (items_.size() < k_ && numLevels() == 1) {
     // Do not allocate all k elements in the beginning because in some group-by
     // aggregation most of the group size is small and won't use all k spaces.
+    // The growth is capped at k so that a full level zero does not hold the
+    // doubled capacity of the vector.
+    if (items_.size() == items_.capacity()) {
+      items_.reserve(std::min<size_t>(
+          k_, std::max<size_t>(kMinItemsCapacity, 2 * items_.capacity())));
+    }
     items_.push_back(value);
     ++levels_[1];
   } else {
@@ -167,6 +167,9 @@ struct KllSketch {
   View toView() const;
 
  private:
+  // The initial capacity of the items of a sketch on first insert.
+  static constexpr size_t kMinItemsCapacity = 8;
+
   KllSketch(const Allocator&, uint32_t seed);
   void doInsert(T);
   uint32_t insertPosition();
@@ -18,6 +18,7 @@
 #include <re2/re2.h>
 #include <optional>
 #include <string>
+#include <string_view>
 
 #include "velox/expression/VectorWriters.h"
 
@@ -89,6 +90,93 @@ bool re2PartialMatch(StringView str, const RE2& re) {
   return RE2::PartialMatch(toStringPiece(str), re);
 }
 
+// Returns false if 'input' does not contain 'literal'. An empty 'literal' is
+// contained in every input.
+bool containsLiteral(StringView input, const std::string& literal) {
+  return literal.empty() ||
+      std::string_view(input.data(), input.size()).find(literal) !=
+      std::string_view::npos;
+}
+
+// Returns the longest string of literal characters that every match of the
+// regular expression 'pattern' contains, or an empty string if there is no
+// such string or the pattern is too complex to tell, e.g. has alternations,
+// flags or escapes. Rows that do not contain the string can be rejected with
+// memcmp, which is much faster than RE2 at rejecting. RE2 itself already
+// rejects with its DFA before extracting capture groups.
+std::string requiredLiteral(StringView pattern) {
+  std::string_view patternView(pattern.data(), pattern.size());
+  if (patternView.find_first_of("|\\") != std::string_view::npos ||
+      patternView.find("(?") != std::string_view::npos ||
+      patternView.find("[:") != std::string_view::npos) {
+    return "";
+  }
+  std::string_view longest;
+  size_t start = 0;
+  int32_t depth = 0;
+  auto addRun = [&](size_t end) {
+    if (depth == 0 && end > start && end - start > longest.size()) {
+      longest = patternView.substr(start, end - start);
+    }
+  };
+  for (size_t i = 0; i < patternView.size(); ++i) {
+    switch (patternView[i]) {
+      case '?':
+      case '*':
+      case '{': {
+        // The quantifier makes the preceding character, which may take
+        // several bytes in UTF-8, optional.
+        auto end = i;
+        if (end > start) {
+          --end;
+          while (end > start && (patternView[end] & 0xC0) == 0x80) {
+            --end;
+          }
+        }
+        addRun(end);
+        if (patternView[i] == '{') {
+          i = patternView.find('}', i);
+          if (i == std::string_view::npos) {
+            return "";
+          }
+        }
+        break;
+      }
+      case '[': {
+        addRun(i);
+        // The first character of a class after an optional '^' can be ']'.
+        auto classStart = i + 1;
+        if (classStart < patternView.size() && patternView[classStart] == '^') {
+          ++classStart;
+        }
+        i = patternView.find(']', classStart + 1);
+        if (i == std::string_view::npos) {
+          return "";
+        }
+        break;
+      }
+      case '(':
+        addRun(i);
+        ++depth;
+        break;
+      case ')':
+        --depth;
+        break;
+      case '^':
+      case '$':
+      case '.':
+      case '+':
+        addRun(i);
+        break;
+      default:
+        continue;
+    }
+    start = i + 1;
+  }
+  addRun(patternView.size());
+  return std::string(longest);
+}
+
 bool re2Extract(
     FlatVector<StringView>& result,
     int row,
@@ -96,10 +184,12 @@ bool re2Extract(
     const exec::LocalDecodedVector& strs,
     std::vector<re2::StringPiece>& groups,
     int32_t groupId,
-    bool emptyNoMatch) {
+    bool emptyNoMatch,
+    const std::string& requiredLiteral = {}) {
   const StringView str = strs->valueAt<StringView>(row);
   DCHECK_GT(groups.size(), groupId);
-  if (!re.Match(
+  if (!containsLiteral(str, requiredLiteral) ||
+      !re.Match(
           toStringPiece(str),
           0,
           str.size(),
@@ -181,7 +271,11 @@ template <bool (*Fn)(StringView, const RE2&)>
 class Re2MatchConstantPattern final : public VectorFunction {
  public:
   explicit Re2MatchConstantPattern(StringView pattern)
-      : re_(toStringPiece(pattern), RE2::Quiet) {}
+      : re_(toStringPiece(pattern), RE2::Quiet),
+        requiredLiteral_(requiredLiteral(pattern)),
+        isLiteral_(
+            !requiredLiteral_.empty() &&
+            requiredLiteral_.size() == pattern.size()) {}
 
   void apply(
       const SelectivityVector& rows,
@@ -200,12 +294,26 @@ class Re2MatchConstantPattern final : public VectorFunction {
     }
 
     context.applyToSelectedNoThrow(rows, [&](vector_size_t i) {
-      result.set(i, Fn(toSearch->valueAt<StringView>(i), re_));
+      result.set(i, match(toSearch->valueAt<StringView>(i)));
     });
   }
 
  private:
+  bool match(StringView input) const {
+    if (!containsLiteral(input, requiredLiteral_)) {
+      return false;
+    }
+    // A search for a pattern without special characters is a substring
+    // search.
+    if (isLiteral_ && Fn == re2PartialMatch) {
+      return true;
+    }
+    return Fn(input, re_);
+  }
+
   RE2 re_;
+  const std::string requiredLiteral_;
+  const bool isLiteral_;
 };
 
 template <bool (*Fn)(StringView, const RE2&)>
@@ -247,7 +355,9 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
   explicit Re2SearchAndExtractConstantPattern(
       StringView pattern,
       bool emptyNoMatch)
-      : re_(toStringPiece(pattern), RE2::Quiet), emptyNoMatch_(emptyNoMatch) {}
+      : re_(toStringPiece(pattern), RE2::Quiet),
+        requiredLiteral_(requiredLiteral(pattern)),
+        emptyNoMatch_(emptyNoMatch) {}
 
   void apply(
       const SelectivityVector& rows,
@@ -275,8 +385,15 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
     if (args.size() == 2) {
       groups.resize(1);
       context.applyToSelectedNoThrow(rows, [&](vector_size_t i) {
-        mustRefSourceStrings |=
-            re2Extract(result, i, re_, toSearch, groups, 0, emptyNoMatch_);
+        mustRefSourceStrings |= re2Extract(
+            result,
+            i,
+            re_,
+            toSearch,
+            groups,
+            0,
+            emptyNoMatch_,
+            requiredLiteral_);
       });
       if (mustRefSourceStrings) {
         result.acquireSharedStringBuffers(toSearch->base());
@@ -295,7 +412,14 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
       groups.resize(*groupId + 1);
       context.applyToSelectedNoThrow(rows, [&](vector_size_t i) {
         mustRefSourceStrings |= re2Extract(
-            result, i, re_, toSearch, groups, *groupId, emptyNoMatch_);
+            result,
+            i,
+            re_,
+            toSearch,
+            groups,
+            *groupId,
+            emptyNoMatch_,
+            requiredLiteral_);
       });
       if (mustRefSourceStrings) {
         result.acquireSharedStringBuffers(toSearch->base());
@@ -311,8 +435,15 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
     context.applyToSelectedNoThrow(rows, [&](vector_size_t i) {
       T group = groupIds->valueAt<T>(i);
       checkForBadGroupId(group, re_);
-      mustRefSourceStrings |=
-          re2Extract(result, i, re_, toSearch, groups, group, emptyNoMatch_);
+      mustRefSourceStrings |= re2Extract(
+          result,
+          i,
+          re_,
+          toSearch,
+          groups,
+          group,
+          emptyNoMatch_,
+          requiredLiteral_);
     });
     if (mustRefSourceStrings) {
       result.acquireSharedStringBuffers(toSearch->base());
@@ -321,6 +452,7 @@ class Re2SearchAndExtractConstantPattern final : public VectorFunction {
 
  private:
   RE2 re_;
+  const std::string requiredLiteral_;
   const bool emptyNoMatch_;
 }; // namespace
 
@@ -412,6 +544,58 @@ bool matchSuffixPattern(
           length) == 0;
 }
 
+// Match string 'input' with a fixed pattern preceded and followed by '%'.
+// 'pattern' is the fixed pattern without the wildcards.
+bool matchSubstringPattern(StringView input, StringView pattern) {
+  return std::string_view(input.data(), input.size())
+             .find(std::string_view(pattern.data(), pattern.size())) !=
+      std::string_view::npos;
+}
+
+// Returns true if 'pattern' has only '%' characters from 'start' to the end.
+bool isTrailingAnyCharacterWildcards(StringView pattern, vector_size_t start) {
+  for (auto i = start; i < pattern.size(); ++i) {
+    if (pattern.data()[i] != '%') {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Sets 'resultRef' to the result of 'match' for the strings in the first of
+// 'args'. The other arguments of LIKE are constant.
+template <typename Match>
+void applyLikeMatch(
+    const SelectivityVector& rows,
+    std::vector<VectorPtr>& args,
+    EvalCtx& context,
+    VectorPtr& resultRef,
+    Match match) {
+  VELOX_CHECK(args.size() == 2 || args.size() == 3);
+  FlatVector<bool>& result = ensureWritableBool(rows, context, resultRef);
+  exec::DecodedArgs decodedArgs(rows, args, context);
+  auto toSearch = decodedArgs.at(0);
+
+  if (toSearch->isIdentityMapping()) {
+    auto input = toSearch->data<StringView>();
+    context.applyToSelectedNoThrow(
+        rows, [&](vector_size_t i) { result.set(i, match(input[i])); });
+    return;
+  }
+  if (toSearch->isConstantMapping()) {
+    auto input = toSearch->valueAt<StringView>(0);
+    bool matchResult = match(input);
+    context.applyToSelectedNoThrow(
+        rows, [&](vector_size_t i) { result.set(i, matchResult); });
+    return;
+  }
+
+  // Since the likePattern and escapeChar (2nd and 3rd args) are both
+  // constants, so the first arg is expected to be either of flat or constant
+  // vector only. This code path is unreachable.
+  VELOX_UNREACHABLE();
+}
+
 template <PatternKind P>
 class OptimizedLikeWithMemcmp final : public VectorFunction {
  public:
@@ -432,6 +616,8 @@ class OptimizedLikeWithMemcmp final : public VectorFunction {
         return matchPrefixPattern(input, pattern_, reducedPatternLength_);
       case PatternKind::kSuffix:
         return matchSuffixPattern(input, pattern_, reducedPatternLength_);
+      case PatternKind::kSubstring:
+        return matchSubstringPattern(input, pattern_);
     }
   }
 
@@ -441,34 +627,91 @@ class OptimizedLikeWithMemcmp final : public VectorFunction {
       const TypePtr& /* outputType */,
       EvalCtx& context,
       VectorPtr& resultRef) const final {
-    VELOX_CHECK(args.size() == 2 || args.size() == 3);
-    FlatVector<bool>& result = ensureWritableBool(rows, context, resultRef);
-    exec::DecodedArgs decodedArgs(rows, args, context);
-    auto toSearch = decodedArgs.at(0);
+    applyLikeMatch(rows, args, context, resultRef, [&](StringView input) {
+      return match(input);
+    });
+  }
 
-    if (toSearch->isIdentityMapping()) {
-      auto input = toSearch->data<StringView>();
-      context.applyToSelectedNoThrow(
-          rows, [&](vector_size_t i) { result.set(i, match(input[i])); });
-      return;
+ private:
+  StringView pattern_;
+  vector_size_t reducedPatternLength_;
+};
+
+// Matches a generic pattern without '_' wildcards, i.e. fixed strings
+// separated by '%', such as '%special%requests%' or 'foo%bar%', without RE2.
+// The fixed strings are searched in order. Taking the leftmost occurrence of
+// each leaves the most room for the ones after it, so this finds a match if
+// there is one.
+class LikeWithSegments final : public VectorFunction {
+ public:
+  explicit LikeWithSegments(StringView pattern) {
+    std::string_view patternView(pattern.data(), pattern.size());
+    anchoredStart_ = !patternView.empty() && patternView.front() != '%';
+    anchoredEnd_ = !patternView.empty() && patternView.back() != '%';
+    size_t start = 0;
+    while (start < patternView.size()) {
+      auto end = patternView.find('%', start);
+      if (end == std::string_view::npos) {
+        end = patternView.size();
+      }
+      if (end > start) {
+        segments_.emplace_back(patternView.substr(start, end - start));
+      }
+      start = end + 1;
     }
-    if (toSearch->isConstantMapping()) {
-      auto input = toSearch->valueAt<StringView>(0);
-      bool matchResult = match(input);
-      context.applyToSelectedNoThrow(
-          rows, [&](vector_size_t i) { result.set(i, matchResult); });
-      return;
+    // A pattern without '%' is a fixed pattern and does not come here, so an
+    // anchored start and end are different segments.
+    VELOX_CHECK_GE(segments_.size(), anchoredStart_ + anchoredEnd_);
+  }
+
+  bool match(StringView input) const {
+    std::string_view str(input.data(), input.size());
+    size_t begin = 0;
+    size_t end = str.size();
+    auto first = segments_.begin();
+    auto last = segments_.end();
+    if (anchoredEnd_) {
+      const auto& suffix = segments_.back();
+      if (end < suffix.size() ||
+          str.compare(end - suffix.size(), suffix.size(), suffix) != 0) {
+        return false;
+      }
+      end -= suffix.size();
+      --last;
+    }
+    if (anchoredStart_) {
+      if (end < first->size() || str.compare(0, first->size(), *first) != 0) {
+        return false;
+      }
+      begin = first->size();
+      ++first;
+    }
+    str = str.substr(0, end);
+    for (; first != last; ++first) {
+      auto pos = str.find(*first, begin);
+      if (pos == std::string_view::npos) {
+        return false;
+      }
+      begin = pos + first->size();
     }
+    return true;
+  }
 
-    // Since the likePattern and escapeChar (2nd and 3rd args) are both
-    // constants, so the first arg is expected to be either of flat or constant
-    // vector only. This code path is unreachable.
-    VELOX_UNREACHABLE();
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& /* outputType */,
+      EvalCtx& context,
+      VectorPtr& resultRef) const final {
+    applyLikeMatch(rows, args, context, resultRef, [&](StringView input) {
+      return match(input);
+    });
   }
 
  private:
-  StringView pattern_;
-  vector_size_t reducedPatternLength_;
+  bool anchoredStart_;
+  bool anchoredEnd_;
+  std::vector<std::string> segments_;
 };
 
 class LikeWithRe2 final : public VectorFunction {
@@ -479,6 +722,9 @@ class LikeWithRe2 final : public VectorFunction {
     re_.emplace(
         toStringPiece(likePatternToRe2(pattern, escapeChar, validPattern_)),
         opt);
+    if (!escapeChar.has_value()) {
+      requiredString_ = longestFixedString(pattern);
+    }
   }
 
   void apply(
@@ -511,15 +757,15 @@ class LikeWithRe2 final : public VectorFunction {
     if (toSearch->isIdentityMapping()) {
       auto rawStrings = toSearch->data<StringView>();
       context.applyToSelectedNoThrow(rows, [&](vector_size_t i) {
-        result.set(i, re2FullMatch(rawStrings[i], *re_));
+        result.set(i, match(rawStrings[i]));
       });
       return;
     }
 
     if (toSearch->isConstantMapping()) {
-      bool match = re2FullMatch(toSearch->valueAt<StringView>(0), *re_);
+      bool matchResult = match(toSearch->valueAt<StringView>(0));
       context.applyToSelectedNoThrow(
-          rows, [&](vector_size_t i) { result.set(i, match); });
+          rows, [&](vector_size_t i) { result.set(i, matchResult); });
       return;
     }
 
@@ -530,8 +776,35 @@ class LikeWithRe2 final : public VectorFunction {
   }
 
  private:
+  // Returns the longest string of the pattern without wildcards. Each match
+  // contains it.
+  static std::string longestFixedString(StringView pattern) {
+    std::string_view patternView(pattern.data(), pattern.size());
+    std::string_view longest;
+    size_t start = 0;
+    while (start < patternView.size()) {
+      auto end = patternView.find_first_of("%_", start);
+      if (end == std::string_view::npos) {
+        end = patternView.size();
+      }
+      if (end - start > longest.size()) {
+        longest = patternView.substr(start, end - start);
+      }
+      start = end + 1;
+    }
+    return std::string(longest);
+  }
+
+  // Checks for 'requiredString_' with memcmp before running RE2, which is
+  // much slower at rejecting the strings that do not contain it.
+  bool match(StringView input) const {
+    return containsLiteral(input, requiredString_) &&
+        re2FullMatch(input, *re_);
+  }
+
   std::optional<RE2> re_;
   bool validPattern_;
+  std::string requiredString_;
 };
 
 void re2ExtractAll(
@@ -540,17 +813,25 @@ void re2ExtractAll(
     const exec::LocalDecodedVector& inputStrs,
     const int row,
     std::vector<re2::StringPiece>& groups,
-    int32_t groupId) {
+    int32_t groupId,
+    const std::string& requiredLiteral = {}) {
   resultWriter.setOffset(row);
 
   auto& arrayWriter = resultWriter.current();
 
   const StringView str = inputStrs->valueAt<StringView>(row);
   const re2::StringPiece input = toStringPiece(str);
-  size_t pos = 0;
-
-  while (re.Match(
-      input, pos, input.size(), RE2::UNANCHORED, groups.data(), groupId + 1)) {
+  // An input without the required literal has no matches.
+  size_t pos = containsLiteral(str, requiredLiteral) ? 0 : input.size() + 1;
+
+  while (pos <= input.size() &&
+         re.Match(
+             input,
+             pos,
+             input.size(),
+             RE2::UNANCHORED,
+             groups.data(),
+             groupId + 1)) {
     DCHECK_GT(groups.size(), groupId);
 
     const re2::StringPiece fullMatch = groups[0];
@@ -571,7 +852,8 @@ template <typename T>
 class Re2ExtractAllConstantPattern final : public VectorFunction {
  public:
   explicit Re2ExtractAllConstantPattern(StringView pattern)
-      : re_(toStringPiece(pattern), RE2::Quiet) {}
+      : re_(toStringPiece(pattern), RE2::Quiet),
+        requiredLiteral_(requiredLiteral(pattern)) {}
 
   void apply(
       const SelectivityVector& rows,
@@ -600,7 +882,8 @@ class Re2ExtractAllConstantPattern final : public VectorFunction {
       //
       groups.resize(1);
       context.applyToSelectedNoThrow(rows, [&](vector_size_t row) {
-        re2ExtractAll(resultWriter, re_, inputStrs, row, groups, 0);
+        re2ExtractAll(
+            resultWriter, re_, inputStrs, row, groups, 0, requiredLiteral_);
       });
     } else if (const auto _groupId = getIfConstant<T>(*args[2])) {
       // Case 2: Constant groupId
@@ -614,7 +897,14 @@ class Re2ExtractAllConstantPattern final : public VectorFunction {
 
       groups.resize(*_groupId + 1);
       context.applyToSelectedNoThrow(rows, [&](vector_size_t row) {
-        re2ExtractAll(resultWriter, re_, inputStrs, row, groups, *_groupId);
+        re2ExtractAll(
+            resultWriter,
+            re_,
+            inputStrs,
+            row,
+            groups,
+            *_groupId,
+            requiredLiteral_);
       });
     } else {
       // Case 3: Variable groupId, so resize the groups vector to accommodate
@@ -625,7 +915,14 @@ class Re2ExtractAllConstantPattern final : public VectorFunction {
       context.applyToSelectedNoThrow(rows, [&](vector_size_t row) {
         const T groupId = groupIds->valueAt<T>(row);
         checkForBadGroupId(groupId, re_);
-        re2ExtractAll(resultWriter, re_, inputStrs, row, groups, groupId);
+        re2ExtractAll(
+            resultWriter,
+            re_,
+            inputStrs,
+            row,
+            groups,
+            groupId,
+            requiredLiteral_);
       });
     }
 
@@ -639,6 +936,7 @@ class Re2ExtractAllConstantPattern final : public VectorFunction {
 
  private:
   RE2 re_;
+  const std::string requiredLiteral_;
 };
 
 template <typename T>
@@ -855,8 +1153,13 @@ std::pair<PatternKind, vector_size_t> determinePatternKind(StringView pattern) {
   while (i < patternLength) {
     if (patternStr[i] == '%' || patternStr[i] == '_') {
       // Ensures that pattern has a single contiguous stream of wildcard
-      // characters.
+      // characters, except for a substring pattern, which ends with a second
+      // stream of '%' characters.
       if (wildcardStart != -1) {
+        if (singleCharacterWildcardCount == 0 && wildcardStart == 0 &&
+            isTrailingAnyCharacterWildcards(pattern, i)) {
+          return {PatternKind::kSubstring, i - fixedPatternStart};
+        }
         return std::make_pair(PatternKind::kGeneric, 0);
       }
       // Look till the last contiguous wildcard character, starting from this
@@ -987,7 +1290,21 @@ std::shared_ptr<exec::VectorFunction> makeLike(
       case PatternKind::kSuffix:
         return std::make_shared<OptimizedLikeWithMemcmp<PatternKind::kSuffix>>(
             pattern, reducedLength);
+      case PatternKind::kSubstring: {
+        vector_size_t fixedPatternStart = 0;
+        while (pattern.data()[fixedPatternStart] == '%') {
+          ++fixedPatternStart;
+        }
+        return std::make_shared<
+            OptimizedLikeWithMemcmp<PatternKind::kSubstring>>(
+            StringView(pattern.data() + fixedPatternStart, reducedLength),
+            reducedLength);
+      }
       default:
+        if (std::string_view(pattern.data(), pattern.size()).find('_') ==
+            std::string_view::npos) {
+          return std::make_shared<LikeWithSegments>(pattern);
+        }
         return std::make_shared<LikeWithRe2>(pattern, escapeChar);
     }
   }
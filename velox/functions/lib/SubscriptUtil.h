@@ -16,12 +16,93 @@
 
 #pragma once
 
+#include <folly/container/F14Map.h>
+
 #include "velox/expression/VectorFunction.h"
 #include "velox/type/Type.h"
 #include "velox/vector/NullsBuilder.h"
 
 namespace facebook::velox::functions {
 
+/// Finds keys in the maps of one MapVector. A map with at least
+/// kMinIndexedMapSize keys is scanned the first time it is probed and gets a
+/// hash table from key to offset the second time. The index is shared by all
+/// the subscripts into the same map vector in one evaluation, see
+/// EvalCtx::getOrCreateVectorState().
+template <typename TKey>
+class MapKeyIndex {
+ public:
+  static constexpr vector_size_t kMinIndexedMapSize = 32;
+
+  explicit MapKeyIndex(vector_size_t numMaps)
+      : probed_(numMaps, false), tables_(numMaps) {}
+
+  /// Returns the offset of 'key' in 'keys' within [offset, offset + size),
+  /// the keys of the map at 'mapIndex', or -1 if not found.
+  vector_size_t find(
+      vector_size_t mapIndex,
+      vector_size_t offset,
+      vector_size_t size,
+      const DecodedVector& keys,
+      TKey key) {
+    auto& table = tables_[mapIndex];
+    if (!table) {
+      if (!probed_[mapIndex]) {
+        probed_[mapIndex] = true;
+        return scan(offset, size, keys, key);
+      }
+      table = std::make_unique<folly::F14FastMap<TKey, vector_size_t>>();
+      table->reserve(size);
+      for (auto i = offset; i < offset + size; ++i) {
+        // Keeps the first of duplicate keys, like scan().
+        table->emplace(keys.valueAt<TKey>(i), i);
+      }
+    }
+    auto it = table->find(key);
+    return it == table->end() ? -1 : it->second;
+  }
+
+  /// Returns the offset of the first 'key' in 'keys' within
+  /// [offset, offset + size), or -1 if not found.
+  static vector_size_t scan(
+      vector_size_t offset,
+      vector_size_t size,
+      const DecodedVector& keys,
+      TKey key) {
+    for (auto i = offset; i < offset + size; ++i) {
+      if (keys.valueAt<TKey>(i) == key) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  /// Same as scan() for keys in ascending order.
+  static vector_size_t binarySearch(
+      vector_size_t offset,
+      vector_size_t size,
+      const DecodedVector& keys,
+      TKey key) {
+    auto begin = offset;
+    auto end = offset + size;
+    while (begin < end) {
+      const auto middle = begin + (end - begin) / 2;
+      if (keys.valueAt<TKey>(middle) < key) {
+        begin = middle + 1;
+      } else {
+        end = middle;
+      }
+    }
+    return begin < offset + size && keys.valueAt<TKey>(begin) == key ? begin
+                                                                     : -1;
+  }
+
+ private:
+  std::vector<bool> probed_;
+  std::vector<std::unique_ptr<folly::F14FastMap<TKey, vector_size_t>>>
+      tables_;
+};
+
 /// Generic subscript/element_at implementation for both array and map data
 /// types.
 ///
@@ -317,32 +398,44 @@ class SubscriptImpl : public exec::VectorFunction {
     auto rawSizes = baseMap->rawSizes();
     auto rawOffsets = baseMap->rawOffsets();
 
+    // Made on first probe of a large map with unsorted keys.
+    std::shared_ptr<MapKeyIndex<TKey>> keyIndex;
+
     // Lambda that does the search for a key, for each row.
     auto processRow = [&](vector_size_t row, TKey searchKey) {
-      size_t mapIndex = mapIndices[row];
-      size_t offsetStart = rawOffsets[mapIndex];
-      size_t offsetEnd = offsetStart + rawSizes[mapIndex];
-      bool found = false;
-
-      // Sequentially check each key on this map for a match. We use a
-      // sequential scan over the keys because it's easier to express (and
-      // likely has good memory locality), but if we find that this is slow
-      // for large maps we could try to canonicalize the whole vector and binary
-      // search `searchKey`.
-      for (size_t offset = offsetStart; offset < offsetEnd; ++offset) {
-        if (decodedMapKeys->valueAt<TKey>(offset) == searchKey) {
-          rawIndices[row] = offset;
-          found = true;
-          break;
+      const auto mapIndex = mapIndices[row];
+      const auto offset = rawOffsets[mapIndex];
+      const auto size = rawSizes[mapIndex];
+      vector_size_t keyOffset;
+
+      // Small maps are scanned sequentially. Large maps are searched with
+      // binary search if the keys are sorted, otherwise through an index
+      // shared with the other subscripts into the same maps.
+      if (size < MapKeyIndex<TKey>::kMinIndexedMapSize) {
+        keyOffset =
+            MapKeyIndex<TKey>::scan(offset, size, *decodedMapKeys, searchKey);
+      } else if (baseMap->hasSortedKeys()) {
+        keyOffset = MapKeyIndex<TKey>::binarySearch(
+            offset, size, *decodedMapKeys, searchKey);
+      } else {
+        if (!keyIndex) {
+          keyIndex = context.getOrCreateVectorState<MapKeyIndex<TKey>>(
+              mapArg, [&]() {
+                return std::make_shared<MapKeyIndex<TKey>>(baseMap->size());
+              });
         }
+        keyOffset = keyIndex->find(
+            mapIndex, offset, size, *decodedMapKeys, searchKey);
       }
 
       // NB: We still allow non-existent map keys, even if out of bounds is
       // disabled for arrays.
 
       // Handle NULLs.
-      if (!found) {
+      if (keyOffset == -1) {
         nullsBuilder.setNull(row);
+      } else {
+        rawIndices[row] = keyOffset;
       }
     };
 
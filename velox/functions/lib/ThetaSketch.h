@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <folly/lang/Bits.h>
+
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::functions::theta {
+
+constexpr uint32_t kDefaultK = 4096;
+
+/// Theta sketch for estimating the number of distinct values of a set, and of
+/// unions and intersections of sets.
+///
+/// The sketch keeps the distinct hashes that are below a threshold 'theta',
+/// where theta is the (k + 1)-th smallest hash seen so far. The estimate is
+/// the number of retained hashes divided by theta as a fraction of the hash
+/// space. Unlike HyperLogLog, two sketches can be intersected by intersecting
+/// their retained hashes below the smaller of the 2 thetas.
+///
+/// The relative standard error is about 1 / sqrt(k), 1.6% for the default k
+/// of 4096.
+///
+/// The serialized form is a 1-byte version, a 4-byte k, an 8-byte theta, a
+/// 4-byte number of hashes and then the hashes in ascending order. Serialized
+/// sketches are merged without deserializing them, see View.
+///
+/// See https://datasketches.apache.org/docs/Theta/ThetaSketchFramework.html
+/// for more details.
+template <typename Allocator = std::allocator<uint64_t>>
+class ThetaSketch {
+ public:
+  static constexpr uint64_t kMaxTheta = std::numeric_limits<uint64_t>::max();
+
+  /// Read-only view over a serialized sketch.
+  struct View {
+    uint32_t k;
+    uint64_t theta;
+    uint32_t numHashes;
+
+    /// Unaligned array of 'numHashes' hashes in ascending order.
+    const char* hashes;
+
+    uint64_t hashAt(uint32_t index) const {
+      return folly::loadUnaligned<uint64_t>(hashes + index * sizeof(uint64_t));
+    }
+
+    double estimate() const {
+      return ThetaSketch::estimate(numHashes, theta);
+    }
+  };
+
+  explicit ThetaSketch(uint32_t k = kDefaultK, const Allocator& = Allocator());
+
+  /// Cannot be called after insertHash() or merge().
+  void setK(uint32_t k);
+
+  /// Adds a 64-bit hash of a value to the sketch.
+  void insertHash(uint64_t hash) {
+    if (hash < theta_) {
+      hashes_.push_back(hash);
+      if (hashes_.size() >= 2 * k_) {
+        compact();
+      }
+    }
+  }
+
+  /// Replaces this sketch with the union of this sketch and 'other'.
+  void merge(const View& other);
+
+  /// Replaces this sketch with the intersection of this sketch and 'other'.
+  void intersect(const View& other);
+
+  /// Replaces the content of this sketch with 'other'.
+  void assign(const View& other);
+
+  /// Sorts the retained hashes, removes duplicates and keeps only the k
+  /// smallest. Must be called before toView(), serialize() and estimate().
+  void compact();
+
+  /// Returns the estimated number of distinct values.
+  double estimate() const {
+    VELOX_DCHECK(isCompact());
+    return estimate(hashes_.size(), theta_);
+  }
+
+  size_t serializedByteSize() const {
+    VELOX_DCHECK(isCompact());
+    return kHeaderSize + hashes_.size() * sizeof(uint64_t);
+  }
+
+  /// Serializes the sketch into 'out' that has at least serializedByteSize()
+  /// bytes.
+  void serialize(char* out) const;
+
+  /// Returns a view over a serialized sketch of 'size' bytes.
+  static View view(const char* data, size_t size);
+
+  /// Returns the estimate of a sketch with 'numHashes' hashes below 'theta'.
+  static double estimate(size_t numHashes, uint64_t theta) {
+    if (theta == kMaxTheta) {
+      return numHashes;
+    }
+    // 2^64 as a double.
+    constexpr double kHashSpace = 18446744073709551616.0;
+    return numHashes / (theta / kHashSpace);
+  }
+
+  uint64_t theta() const {
+    return theta_;
+  }
+
+  size_t numHashes() const {
+    return hashes_.size();
+  }
+
+ private:
+  static constexpr int8_t kVersion = 1;
+  static constexpr size_t kHeaderSize = sizeof(int8_t) + sizeof(uint32_t) +
+      sizeof(uint64_t) + sizeof(uint32_t);
+
+  bool isCompact() const {
+    return hashes_.size() == numCompacted_;
+  }
+
+  // Keeps the k smallest of the sorted unique hashes and lowers theta
+  // accordingly.
+  void trim();
+
+  uint32_t k_;
+  uint64_t theta_{kMaxTheta};
+  std::vector<uint64_t, Allocator> hashes_;
+
+  // Number of leading hashes in 'hashes_' that are sorted and unique.
+  size_t numCompacted_{0};
+};
+
+template <typename A>
+ThetaSketch<A>::ThetaSketch(uint32_t k, const A& allocator)
+    : k_(k), hashes_(allocator) {
+  VELOX_CHECK_GT(k, 0);
+}
+
+template <typename A>
+void ThetaSketch<A>::setK(uint32_t k) {
+  VELOX_CHECK_GT(k, 0);
+  VELOX_CHECK(hashes_.empty() && theta_ == kMaxTheta);
+  k_ = k;
+}
+
+template <typename A>
+void ThetaSketch<A>::compact() {
+  if (isCompact()) {
+    return;
+  }
+  std::sort(hashes_.begin() + numCompacted_, hashes_.end());
+  std::inplace_merge(
+      hashes_.begin(), hashes_.begin() + numCompacted_, hashes_.end());
+  hashes_.erase(std::unique(hashes_.begin(), hashes_.end()), hashes_.end());
+  trim();
+}
+
+template <typename A>
+void ThetaSketch<A>::trim() {
+  if (hashes_.size() > k_) {
+    theta_ = hashes_[k_];
+    hashes_.resize(k_);
+  }
+  numCompacted_ = hashes_.size();
+}
+
+template <typename A>
+void ThetaSketch<A>::merge(const View& other) {
+  compact();
+  theta_ = std::min(theta_, other.theta);
+  const auto size = std::lower_bound(hashes_.begin(), hashes_.end(), theta_) -
+      hashes_.begin();
+
+  // Merge the other hashes below theta in place, from the back.
+  uint32_t otherSize = 0;
+  while (otherSize < other.numHashes && other.hashAt(otherSize) < theta_) {
+    ++otherSize;
+  }
+  hashes_.resize(size + otherSize);
+  auto left = static_cast<int64_t>(size) - 1;
+  auto right = static_cast<int64_t>(otherSize) - 1;
+  auto out = static_cast<int64_t>(hashes_.size()) - 1;
+  while (right >= 0) {
+    const auto otherHash = other.hashAt(right);
+    if (left >= 0 && hashes_[left] > otherHash) {
+      hashes_[out--] = hashes_[left--];
+    } else if (left >= 0 && hashes_[left] == otherHash) {
+      hashes_[out--] = hashes_[left--];
+      --right;
+    } else {
+      hashes_[out--] = otherHash;
+      --right;
+    }
+  }
+  // Close the gap left by the duplicates.
+  const auto numDuplicates = out - left;
+  if (numDuplicates > 0) {
+    hashes_.erase(
+        hashes_.begin() + left + 1, hashes_.begin() + left + 1 + numDuplicates);
+  }
+  trim();
+}
+
+template <typename A>
+void ThetaSketch<A>::intersect(const View& other) {
+  compact();
+  theta_ = std::min(theta_, other.theta);
+  size_t size = 0;
+  uint32_t right = 0;
+  for (size_t left = 0; left < hashes_.size() && hashes_[left] < theta_;
+       ++left) {
+    while (right < other.numHashes && other.hashAt(right) < hashes_[left]) {
+      ++right;
+    }
+    if (right == other.numHashes) {
+      break;
+    }
+    if (other.hashAt(right) == hashes_[left]) {
+      hashes_[size++] = hashes_[left];
+    }
+  }
+  hashes_.resize(size);
+  numCompacted_ = size;
+}
+
+template <typename A>
+void ThetaSketch<A>::assign(const View& other) {
+  theta_ = other.theta;
+  hashes_.resize(other.numHashes);
+  if (other.numHashes > 0) {
+    memcpy(hashes_.data(), other.hashes, other.numHashes * sizeof(uint64_t));
+  }
+  trim();
+}
+
+template <typename A>
+void ThetaSketch<A>::serialize(char* out) const {
+  VELOX_DCHECK(isCompact());
+  *out = kVersion;
+  ++out;
+  memcpy(out, &k_, sizeof(k_));
+  out += sizeof(k_);
+  memcpy(out, &theta_, sizeof(theta_));
+  out += sizeof(theta_);
+  const uint32_t numHashes = hashes_.size();
+  memcpy(out, &numHashes, sizeof(numHashes));
+  out += sizeof(numHashes);
+  if (numHashes > 0) {
+    memcpy(out, hashes_.data(), numHashes * sizeof(uint64_t));
+  }
+}
+
+// static
+template <typename A>
+typename ThetaSketch<A>::View ThetaSketch<A>::view(
+    const char* data,
+    size_t size) {
+  VELOX_USER_CHECK_GE(size, kHeaderSize, "Invalid theta sketch");
+  VELOX_USER_CHECK_EQ(*data, kVersion, "Unsupported theta sketch version");
+  View view;
+  const char* pos = data + 1;
+  memcpy(&view.k, pos, sizeof(view.k));
+  pos += sizeof(view.k);
+  memcpy(&view.theta, pos, sizeof(view.theta));
+  pos += sizeof(view.theta);
+  memcpy(&view.numHashes, pos, sizeof(view.numHashes));
+  pos += sizeof(view.numHashes);
+  VELOX_USER_CHECK_EQ(
+      size,
+      kHeaderSize + static_cast<size_t>(view.numHashes) * sizeof(uint64_t),
+      "Invalid theta sketch");
+  view.hashes = pos;
+  return view;
+}
+
+} // namespace facebook::velox::functions::theta
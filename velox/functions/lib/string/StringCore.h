@@ -19,7 +19,9 @@
 #include <string>
 #include <string_view>
 #include "folly/CPortability.h"
+#include "velox/common/base/BitUtil.h"
 #include "velox/common/base/Exceptions.h"
+#include "velox/common/base/SimdUtil.h"
 #include "velox/external/utf8proc/utf8procImpl.h"
 
 #if (ENABLE_VECTORIZATION > 0) && !defined(_DEBUG) && !defined(DEBUG)
@@ -48,7 +50,19 @@ namespace stringCore {
 static bool isAscii(const char* str, size_t length);
 
 FOLLY_ALWAYS_INLINE bool isAscii(const char* str, size_t length) {
-  for (auto i = 0; i < length; i++) {
+  using Batch = xsimd::batch<int8_t>;
+  size_t i = 0;
+  if (length >= Batch::size) {
+    // OR all full batches together and test the high bit once at the end.
+    auto bytes = Batch(static_cast<int8_t>(0));
+    for (; i + Batch::size <= length; i += Batch::size) {
+      bytes |= Batch::load_unaligned(reinterpret_cast<const int8_t*>(str) + i);
+    }
+    if (simd::toBitMask(bytes < Batch(static_cast<int8_t>(0))) != 0) {
+      return false;
+    }
+  }
+  for (; i < length; i++) {
     if (str[i] & 0x80) {
       return false;
     }
@@ -56,6 +70,106 @@ FOLLY_ALWAYS_INLINE bool isAscii(const char* str, size_t length) {
   return true;
 }
 
+namespace detail {
+/// Number of bytes classified at a time by the UTF-8 block kernels.
+constexpr int32_t kUtf8BlockSize = 64;
+
+/// Returns true if the 16 bytes at 'str' are all ascii.
+FOLLY_ALWAYS_INLINE bool isAscii16(const char* str) {
+  uint64_t words[2];
+  std::memcpy(words, str, sizeof(words));
+  return ((words[0] | words[1]) & 0x8080808080808080ULL) == 0;
+}
+
+/// Classifies the kUtf8BlockSize bytes at 'str'. 'carry' has a bit set for
+/// each leading byte of the block that must be a continuation byte of a
+/// character started in the previous block. Returns true if every
+/// continuation byte of the block belongs to a leading byte in the block or
+/// in 'carry' and vice versa, and the block has no byte that can not appear
+/// in UTF-8. In that case, 'continuation' is set to the mask of continuation
+/// bytes in the block and 'carry' to the carry for the next block. Otherwise
+/// the arguments are not changed and the caller must fall back to per
+/// character processing at the start of the block after the carried bytes.
+FOLLY_ALWAYS_INLINE bool
+classifyUtf8Block(const char* str, uint64_t& carry, uint64_t& continuation) {
+  using Batch = xsimd::batch<uint8_t>;
+  auto toMask = [](xsimd::batch_bool<uint8_t> mask, int32_t offset) {
+    return static_cast<uint64_t>(
+               static_cast<uint32_t>(simd::toBitMask(mask)))
+        << offset;
+  };
+  uint64_t follow = 0;
+  uint64_t lead2 = 0;
+  uint64_t lead3 = 0;
+  uint64_t lead4 = 0;
+  uint64_t invalid = 0;
+  for (int32_t i = 0; i < kUtf8BlockSize; i += Batch::size) {
+    auto bytes =
+        Batch::load_unaligned(reinterpret_cast<const uint8_t*>(str) + i);
+    follow |= toMask((bytes & Batch(0xC0)) == Batch(0x80), i);
+    lead2 |= toMask((bytes & Batch(0xE0)) == Batch(0xC0), i);
+    lead3 |= toMask((bytes & Batch(0xF0)) == Batch(0xE0), i);
+    lead4 |= toMask((bytes & Batch(0xF8)) == Batch(0xF0), i);
+    invalid |= toMask((bytes & Batch(0xF8)) == Batch(0xF8), i);
+  }
+  const uint64_t leads = lead2 | lead3 | lead4;
+  const uint64_t lead3Plus = lead3 | lead4;
+  const uint64_t expected =
+      carry | (leads << 1) | (lead3Plus << 2) | (lead4 << 3);
+  if (invalid != 0 || expected != follow) {
+    return false;
+  }
+  continuation = follow;
+  carry = (leads >> 63) | (lead3Plus >> 62) | (lead4 >> 61);
+  return true;
+}
+
+/// Returns the byte offset reached by stepping over 'numChars' characters
+/// one at a time starting at byte 'offset'. Bytes that can not start a
+/// character are stepped over one byte at a time.
+FOLLY_ALWAYS_INLINE size_t skipCharsScalar(
+    const char* str,
+    size_t size,
+    size_t offset,
+    size_t numChars) {
+  for (; numChars > 0 && offset < size; --numChars) {
+    auto charLength = utf8proc_char_length(&str[offset]);
+    offset += UNLIKELY(charLength < 0) ? 1 : charLength;
+  }
+  return std::min(offset, size);
+}
+} // namespace detail
+
+/// Returns the byte offset of the character 'numChars' characters after the
+/// one starting at byte 'start' of the utf8 string 'str' of 'size' bytes.
+/// Returns 'size' if the string has fewer characters. Well-formed runs are
+/// skipped kUtf8BlockSize bytes at a time.
+FOLLY_ALWAYS_INLINE size_t skipCharsUnicode(
+    const char* str,
+    size_t size,
+    size_t start,
+    size_t numChars) {
+  size_t offset = start;
+  uint64_t carry = 0;
+  uint64_t continuation;
+  while (offset + detail::kUtf8BlockSize <= size) {
+    auto nextCarry = carry;
+    if (!detail::classifyUtf8Block(str + offset, nextCarry, continuation)) {
+      break;
+    }
+    const size_t blockChars =
+        detail::kUtf8BlockSize - __builtin_popcountll(continuation);
+    if (blockChars >= numChars) {
+      break;
+    }
+    numChars -= blockChars;
+    offset += detail::kUtf8BlockSize;
+    carry = nextCarry;
+  }
+  return detail::skipCharsScalar(
+      str, size, offset + __builtin_popcountll(carry), numChars);
+}
+
 /// Perform reverse for ascii string input
 FOLLY_ALWAYS_INLINE static void
 reverseAscii(char* output, const char* input, size_t length) {
@@ -71,6 +185,12 @@ reverseUnicode(char* output, const char* input, size_t length) {
   auto inputIdx = 0;
   auto outputIdx = length;
   while (inputIdx < length) {
+    if (inputIdx + 16 <= length && detail::isAscii16(&input[inputIdx])) {
+      outputIdx -= 16;
+      reverseAscii(&output[outputIdx], &input[inputIdx], 16);
+      inputIdx += 16;
+      continue;
+    }
     int size = 1;
     utf8proc_codepoint(&input[inputIdx], size);
     // invalid utf8 gets byte sequence with nextCodePoint==-1 and size==1,
@@ -123,6 +243,14 @@ FOLLY_ALWAYS_INLINE size_t upperUnicode(
   auto outputIdx = 0;
 
   while (inputIdx < inputLength) {
+    // Basic Latin maps to itself in one byte, so all-ascii runs are mapped
+    // in place of code points.
+    if (inputIdx + 16 <= inputLength && detail::isAscii16(&input[inputIdx])) {
+      upperAscii(&output[outputIdx], &input[inputIdx], 16);
+      inputIdx += 16;
+      outputIdx += 16;
+      continue;
+    }
     utf8proc_int32_t nextCodePoint;
     int size;
     nextCodePoint = utf8proc_codepoint(&input[inputIdx], size);
@@ -162,6 +290,14 @@ FOLLY_ALWAYS_INLINE size_t lowerUnicode(
   auto outputIdx = 0;
 
   while (inputIdx < inputLength) {
+    // Basic Latin maps to itself in one byte, so all-ascii runs are mapped
+    // in place of code points.
+    if (inputIdx + 16 <= inputLength && detail::isAscii16(&input[inputIdx])) {
+      lowerAscii(&output[outputIdx], &input[inputIdx], 16);
+      inputIdx += 16;
+      outputIdx += 16;
+      continue;
+    }
     utf8proc_int32_t nextCodePoint;
     int size;
     nextCodePoint = utf8proc_codepoint(&input[inputIdx], size);
@@ -216,6 +352,16 @@ lengthUnicode(const char* inputBuffer, size_t bufferLength) {
   auto buffEndAddress = inputBuffer + bufferLength;
   auto currentChar = inputBuffer;
   int64_t size = 0;
+  uint64_t carry = 0;
+  uint64_t continuation;
+  while (currentChar + detail::kUtf8BlockSize <= buffEndAddress &&
+         detail::classifyUtf8Block(currentChar, carry, continuation)) {
+    size += detail::kUtf8BlockSize - __builtin_popcountll(continuation);
+    currentChar += detail::kUtf8BlockSize;
+  }
+  // The carried continuation bytes belong to a character counted in the
+  // previous block.
+  currentChar += __builtin_popcountll(carry);
   while (currentChar < buffEndAddress) {
     auto chrOffset = utf8proc_char_length(currentChar);
     // Skip bad byte if we get utf length < 0.
@@ -423,5 +569,28 @@ getByteRange(const char* str, size_t startCharPosition, size_t length) {
     return std::make_pair(startByteIndex, nextCharOffset);
   }
 }
+
+/// Same as above for a string of 'size' bytes. The non-ascii byte range is
+/// found with skipCharsUnicode and is clamped to 'size'.
+template <bool isAscii>
+static inline std::pair<size_t, size_t> getByteRange(
+    const char* str,
+    size_t size,
+    size_t startCharPosition,
+    size_t length) {
+  if (startCharPosition < 1 && length > 0) {
+    throw std::invalid_argument(
+        "start position must be >= 1 and length must be > 0");
+  }
+  if constexpr (isAscii) {
+    return std::make_pair(
+        startCharPosition - 1, startCharPosition + length - 1);
+  } else {
+    const auto startByteIndex =
+        skipCharsUnicode(str, size, 0, startCharPosition - 1);
+    return std::make_pair(
+        startByteIndex, skipCharsUnicode(str, size, startByteIndex, length));
+  }
+}
 } // namespace stringCore
 } // namespace facebook::velox::functions
@@ -700,7 +700,8 @@ FOLLY_ALWAYS_INLINE void pad(
   // and return it as the result.
   if (UNLIKELY(stringCharLength >= size)) {
     size_t prefixByteSize =
-        stringCore::getByteRange<isAscii>(string.data(), 1, size).second;
+        stringCore::getByteRange<isAscii>(string.data(), string.size(), 1, size)
+            .second;
     output.resize(prefixByteSize);
     if (LIKELY(prefixByteSize > 0)) {
       std::memcpy(output.data(), string.data(), prefixByteSize);
@@ -718,7 +719,10 @@ FOLLY_ALWAYS_INLINE void pad(
   // added at the end of the padding.  Will be 0 if it is evenly divisible.
   size_t padPrefixByteLength =
       stringCore::getByteRange<isAscii>(
-          padString.data(), 1, fullPaddingCharLength % padStringCharLength)
+          padString.data(),
+          padString.size(),
+          1,
+          fullPaddingCharLength % padStringCharLength)
           .second;
   int64_t fullPaddingByteLength =
       padString.size() * fullPadCopies + padPrefixByteLength;
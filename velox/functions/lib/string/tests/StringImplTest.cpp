@@ -20,6 +20,7 @@
 
 #include <gtest/gtest.h>
 #include <memory>
+#include <random>
 #include <vector>
 
 using namespace facebook::velox;
@@ -196,6 +197,84 @@ TEST_F(StringImplTest, badUnicodeLength) {
   ASSERT_EQ(2, len);
 }
 
+TEST_F(StringImplTest, longUnicode) {
+  // Steps one character at a time like the original scalar loops.
+  auto lengthRef = [](const std::string& input) {
+    int64_t numChars = 0;
+    size_t offset = 0;
+    while (offset < input.size()) {
+      auto charLength = utf8proc_char_length(&input[offset]);
+      offset += charLength < 0 ? 1 : charLength;
+      ++numChars;
+    }
+    return numChars;
+  };
+
+  std::vector<std::string> validPieces = {
+      "àáâãäåæçèéêëìíîïðñòóôõöøùúûüýþ",
+      "αβγδεζηθικλμνξοπρςστυφχψ",
+      "\uFE3D\uFE4B\uFF05",
+      "\U0001D437\U000E002F"};
+  std::vector<std::string> invalidPieces = {"\xFF", "\x80", "\xE0", "\xF8"};
+  const auto asciiPieces = getUpperAsciiTestData();
+
+  std::mt19937 rng(1);
+  for (auto iter = 0; iter < 200; ++iter) {
+    // Strings long enough for several blocks of the vectorized kernels, with
+    // an invalid byte in some of them.
+    std::string input;
+    std::string expectedUpper;
+    std::vector<std::string> pieces;
+    while (input.size() < 300) {
+      const auto& [piece, upperPiece] = asciiPieces[rng() % asciiPieces.size()];
+      input += piece;
+      expectedUpper += upperPiece;
+      pieces.push_back(piece);
+      if (rng() % 2) {
+        const auto& unicodePiece = validPieces[rng() % validPieces.size()];
+        std::string upperUnicodePiece;
+        upper</*ascii*/ false>(upperUnicodePiece, StringView(unicodePiece));
+        input += unicodePiece;
+        expectedUpper += upperUnicodePiece;
+        pieces.push_back(unicodePiece);
+      }
+    }
+
+    std::string output;
+    upper</*ascii*/ false>(output, StringView(input));
+    ASSERT_EQ(output, expectedUpper);
+
+    std::string expectedReverse;
+    for (auto it = pieces.rbegin(); it != pieces.rend(); ++it) {
+      std::string reversedPiece;
+      reverse</*ascii*/ false>(reversedPiece, StringView(*it));
+      expectedReverse += reversedPiece;
+    }
+    output.clear();
+    reverse</*ascii*/ false>(output, StringView(input));
+    ASSERT_EQ(output, expectedReverse);
+
+    if (iter % 2) {
+      input.insert(rng() % input.size(), invalidPieces[iter % 4]);
+    }
+    const auto numChars = lengthRef(input);
+    ASSERT_EQ(length</*isAscii*/ false>(input), numChars);
+
+    for (auto i = 0; i < 10; ++i) {
+      const size_t start = 1 + rng() % numChars;
+      const size_t count = rng() % (numChars + 2);
+      auto expectedStart =
+          detail::skipCharsScalar(input.data(), input.size(), 0, start - 1);
+      auto expectedEnd = detail::skipCharsScalar(
+          input.data(), input.size(), expectedStart, count);
+      auto range = getByteRange</*isAscii*/ false>(
+          input.data(), input.size(), start, count);
+      ASSERT_EQ(range.first, expectedStart);
+      ASSERT_EQ(range.second, expectedEnd);
+    }
+  }
+}
+
 TEST_F(StringImplTest, codePointToString) {
   auto testValidInput = [](const int64_t codePoint,
                            const std::string& expectedString) {
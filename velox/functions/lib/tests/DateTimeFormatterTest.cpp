@@ -1353,6 +1353,17 @@ TEST_F(JodaDateTimeFormatterTest, parseConsecutiveSpecifiers) {
       util::fromTimestampString("2012-01-01 12:00:00"),
       parseJoda("1212", "yyH").timestamp);
   EXPECT_THROW(parseJoda("12312", "yyH"), VeloxUserError);
+
+  // Runs of digits longer than a field.
+  EXPECT_EQ(
+      util::fromTimestampString("2023-01-15 12:34:56"),
+      parseJoda("20230115123456", "yyyyMMddHHmmss").timestamp);
+  EXPECT_EQ(
+      util::fromTimestampString("2023-01-15 12:34:56"),
+      parseJoda("2023-01-15 12:34:56", "yyyy-MM-dd HH:mm:ss").timestamp);
+  EXPECT_EQ(
+      util::fromTimestampString("123456-01-01"),
+      parseJoda("123456", "yyyy").timestamp);
 }
 
 class MysqlDateTimeTest : public DateTimeFormatterTest {};
@@ -1799,6 +1810,27 @@ TEST_F(MysqlDateTimeTest, formatCompositeTime) {
       "23:59:59");
 }
 
+TEST_F(MysqlDateTimeTest, formatIntoBuffer) {
+  auto* timezone = date::locate_zone("GMT");
+  auto formatter = buildMysqlDateTimeFormatter("%Y-%m-%d %H:%i:%s.%f %W");
+  for (const auto* timestamp :
+       {"2000-01-01 00:00:00",
+        "1999-12-31 23:59:59.999",
+        "-0012-02-28 01:02:03.004",
+        "12345-09-10 11:12:13.140"}) {
+    const auto value = util::fromTimestampString(timestamp);
+    const auto expected = formatter->format(value, timezone);
+    std::vector<char> buffer(formatter->maxResultSize(timezone));
+    const auto size = formatter->format(value, timezone, buffer.data());
+    ASSERT_LE(size, buffer.size());
+    EXPECT_EQ(std::string_view(buffer.data(), size), expected);
+  }
+  EXPECT_EQ(
+      formatter->format(
+          util::fromTimestampString("2023-09-13 08:05:01.020"), timezone),
+      "2023-09-13 08:05:01.020000 Wednesday");
+}
+
 // Same semantic as YEAR_OF_ERA, except that it accepts zero and negative years.
 TEST_F(MysqlDateTimeTest, parseFourDigitYear) {
   EXPECT_EQ(util::fromTimestampString("123-01-01"), parseMysql("123", "%Y"));
@@ -270,6 +270,70 @@ TEST_F(Re2FunctionsTest, regexSearchBatch) {
   re2Search.testBatchAll();
 }
 
+TEST_F(Re2FunctionsTest, regexRequiredLiteral) {
+  // Constant patterns reject the inputs without the literal that every match
+  // contains before running RE2. Checks that this matches running RE2 on
+  // every input.
+  const std::vector<std::string> patterns = {
+      "abc",
+      "ab?c",
+      "abc*d",
+      "ab{2}c",
+      "(xy)?abc",
+      "a[bc]+d",
+      "[]a]bc",
+      "[[:alpha:]]]x",
+      "\u00e9?x",
+      "^abc$",
+      "a.c",
+      "abc|xyz",
+      "x+yz",
+      "(?i)abc",
+      "\\.abc",
+  };
+  const std::vector<std::string> inputs = {
+      "",
+      "abc",
+      "ac",
+      "xabcx",
+      "abd",
+      "abbc",
+      "xyabc",
+      "abcd",
+      "]bc",
+      "a]x",
+      "x",
+      "xyz",
+      "ABC",
+      ".abc",
+      "aXc",
+      "\u00c3x",
+  };
+  for (const auto& pattern : patterns) {
+    for (const auto& input : inputs) {
+      const auto expected = evaluateOnce<bool>(
+          "re2_search(c0, c1)",
+          std::optional<std::string>(input),
+          std::optional<std::string>(pattern));
+      EXPECT_EQ(
+          evaluateOnce<bool>(
+              fmt::format("re2_search(c0, '{}')", pattern),
+              std::optional<std::string>(input)),
+          expected)
+          << pattern << " " << input;
+      EXPECT_EQ(
+          evaluateOnce<std::string>(
+              fmt::format("re2_extract(c0, '{}')", pattern),
+              std::optional<std::string>(input)),
+          evaluateOnce<std::string>(
+              "re2_extract(c0, c1)",
+              std::optional<std::string>(input),
+              std::optional<std::string>(pattern)))
+          << pattern << " " << input;
+    }
+  }
+}
+
 template <typename F>
 void testRe2Extract(F&& regexExtract) {
   // Regex with no subgroup matches.
@@ -439,6 +503,13 @@ TEST_F(Re2FunctionsTest, likeDeterminePatternKind) {
   testPattern("%%_%aBcD", PatternKind::kGeneric, 0);
   testPattern("%%a%%BcD", PatternKind::kGeneric, 0);
   testPattern("foo%bar", PatternKind::kGeneric, 0);
+
+  testPattern("%presto%", PatternKind::kSubstring, 6);
+  testPattern("%%hello%%%", PatternKind::kSubstring, 5);
+  testPattern("%a%", PatternKind::kSubstring, 1);
+  testPattern("%a_%", PatternKind::kGeneric, 0);
+  testPattern("%_a%", PatternKind::kGeneric, 0);
+  testPattern("%a%b%", PatternKind::kGeneric, 0);
 }
 
 TEST_F(Re2FunctionsTest, likePatternWildcard) {
@@ -592,6 +663,59 @@ TEST_F(Re2FunctionsTest, likePatternSuffix) {
   EXPECT_TRUE(like(input, generateString(kAnyWildcardCharacter) + input));
 }
 
+TEST_F(Re2FunctionsTest, likePatternSubstring) {
+  auto like = [&](std::string str, std::string pattern) {
+    auto likeResult = evaluateOnce<bool>(
+        fmt::format("like(c0, '{}')", pattern), std::make_optional(str));
+    VELOX_CHECK(likeResult, "Like operator evaluation failed");
+    return *likeResult;
+  };
+
+  EXPECT_TRUE(like("abcde", "%abcde%"));
+  EXPECT_TRUE(like("abcde", "%bcd%"));
+  EXPECT_TRUE(like("abcde", "%%a%%"));
+  EXPECT_TRUE(like("abcde", "%e%"));
+  EXPECT_TRUE(like("\nab\tc\n", "%\tc%"));
+  EXPECT_FALSE(like("", "%a%"));
+  EXPECT_FALSE(like("abcde", "%abcdef%"));
+  EXPECT_FALSE(like("abcde", "%bd%"));
+  EXPECT_FALSE(like("ABCDE", "%bcd%"));
+}
+
+TEST_F(Re2FunctionsTest, likePatternSegments) {
+  auto like = [&](std::string str, std::string pattern) {
+    auto likeResult = evaluateOnce<bool>(
+        fmt::format("like(c0, '{}')", pattern), std::make_optional(str));
+    VELOX_CHECK(likeResult, "Like operator evaluation failed");
+    return *likeResult;
+  };
+
+  // Only '%' wildcards between the fixed strings.
+  EXPECT_TRUE(like("foobar", "foo%bar"));
+  EXPECT_TRUE(like("foo bar", "foo%bar"));
+  EXPECT_TRUE(like("foobarbar", "foo%bar"));
+  EXPECT_FALSE(like("foobarx", "foo%bar"));
+  EXPECT_FALSE(like("fobar", "foo%bar"));
+  // The prefix and the suffix must not overlap.
+  EXPECT_FALSE(like("aba", "ab%ba"));
+  EXPECT_TRUE(like("abba", "ab%ba"));
+  EXPECT_TRUE(like("special requests", "%special%requests%"));
+  EXPECT_TRUE(like("x special y requests z", "%special%requests%"));
+  EXPECT_FALSE(like("requests special", "%special%requests%"));
+  EXPECT_TRUE(like("abcabc", "a%c%c"));
+  EXPECT_TRUE(like("abcbc", "%b%bc"));
+  EXPECT_FALSE(like("abc", "%b%bc"));
+  EXPECT_TRUE(like("aXbXc", "a%b%c%"));
+  EXPECT_FALSE(like("aXcXb", "a%b%c%"));
+
+  // Generic patterns with '_' check for the longest fixed string before
+  // running RE2.
+  EXPECT_TRUE(like("hello_world", "hello_world"));
+  EXPECT_TRUE(like("hello world", "%lo_wor%"));
+  EXPECT_FALSE(like("hello there", "%lo_wor%"));
+  EXPECT_FALSE(like("wor lo", "%lo_wor%"));
+}
+
 TEST_F(Re2FunctionsTest, likePatternAndEscape) {
   auto like = ([&](std::optional<std::string> str,
                    std::optional<std::string> pattern,
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/memory/HashStringAllocator.h"
+#include "velox/functions/lib/ThetaSketch.h"
+
+namespace facebook::velox::functions::theta::test {
+namespace {
+
+uint64_t hashOne(int64_t value) {
+  return XXH64(&value, sizeof(value), 0);
+}
+
+// Returns a sketch of the values in [begin, end).
+ThetaSketch<> makeSketch(int64_t begin, int64_t end, uint32_t k = kDefaultK) {
+  ThetaSketch<> sketch(k);
+  for (auto i = begin; i < end; ++i) {
+    sketch.insertHash(hashOne(i));
+  }
+  sketch.compact();
+  return sketch;
+}
+
+std::string serialize(const ThetaSketch<>& sketch) {
+  std::string data(sketch.serializedByteSize(), '\0');
+  sketch.serialize(data.data());
+  return data;
+}
+
+ThetaSketch<>::View toView(const std::string& data) {
+  return ThetaSketch<>::view(data.data(), data.size());
+}
+
+void assertEstimate(double estimate, double expected, double error = 0.05) {
+  ASSERT_NEAR(estimate, expected, expected * error);
+}
+
+TEST(ThetaSketchTest, exact) {
+  auto sketch = makeSketch(0, 1'000);
+  ASSERT_EQ(sketch.theta(), ThetaSketch<>::kMaxTheta);
+  ASSERT_EQ(sketch.estimate(), 1'000);
+
+  // Duplicates are not counted.
+  for (auto i = 0; i < 1'000; ++i) {
+    sketch.insertHash(hashOne(i % 100));
+  }
+  sketch.compact();
+  ASSERT_EQ(sketch.estimate(), 1'000);
+
+  auto empty = makeSketch(0, 0);
+  ASSERT_EQ(empty.estimate(), 0);
+  ASSERT_EQ(toView(serialize(empty)).estimate(), 0);
+}
+
+TEST(ThetaSketchTest, estimate) {
+  auto sketch = makeSketch(0, 1'000'000);
+  ASSERT_LT(sketch.theta(), ThetaSketch<>::kMaxTheta);
+  ASSERT_EQ(sketch.numHashes(), kDefaultK);
+  assertEstimate(sketch.estimate(), 1'000'000);
+
+  auto data = serialize(sketch);
+  ASSERT_EQ(data.size(), sketch.serializedByteSize());
+  ASSERT_EQ(toView(data).estimate(), sketch.estimate());
+}
+
+TEST(ThetaSketchTest, merge) {
+  // Exact.
+  auto sketch = makeSketch(0, 1'000);
+  sketch.merge(toView(serialize(makeSketch(500, 1'500))));
+  ASSERT_EQ(sketch.estimate(), 1'500);
+
+  // Estimated.
+  sketch = makeSketch(0, 600'000);
+  sketch.merge(toView(serialize(makeSketch(400'000, 1'000'000))));
+  ASSERT_EQ(sketch.numHashes(), kDefaultK);
+  assertEstimate(sketch.estimate(), 1'000'000);
+
+  // Same as building one sketch from all values.
+  auto expected = makeSketch(0, 1'000'000);
+  ASSERT_EQ(sketch.theta(), expected.theta());
+  ASSERT_EQ(serialize(sketch), serialize(expected));
+
+  // Merging into an empty sketch.
+  ThetaSketch<> empty;
+  empty.merge(toView(serialize(expected)));
+  ASSERT_EQ(serialize(empty), serialize(expected));
+}
+
+TEST(ThetaSketchTest, intersect) {
+  // Exact.
+  auto sketch = makeSketch(0, 1'000);
+  sketch.intersect(toView(serialize(makeSketch(500, 1'500))));
+  ASSERT_EQ(sketch.estimate(), 500);
+
+  // Estimated.
+  sketch = makeSketch(0, 600'000);
+  sketch.intersect(toView(serialize(makeSketch(200'000, 1'000'000))));
+  assertEstimate(sketch.estimate(), 400'000, 0.1);
+
+  // Disjoint.
+  sketch = makeSketch(0, 1'000);
+  sketch.intersect(toView(serialize(makeSketch(1'000, 2'000))));
+  ASSERT_EQ(sketch.estimate(), 0);
+}
+
+TEST(ThetaSketchTest, assign) {
+  auto expected = makeSketch(0, 100'000);
+  ThetaSketch<> sketch;
+  sketch.assign(toView(serialize(expected)));
+  ASSERT_EQ(serialize(sketch), serialize(expected));
+
+  // A sketch with a smaller k keeps fewer hashes.
+  ThetaSketch<> small(1'024);
+  small.assign(toView(serialize(expected)));
+  ASSERT_EQ(small.numHashes(), 1'024);
+  ASSERT_EQ(serialize(small), serialize(makeSketch(0, 100'000, 1'024)));
+}
+
+TEST(ThetaSketchTest, hashStringAllocator) {
+  auto pool = memory::getDefaultMemoryPool();
+  HashStringAllocator allocator(pool.get());
+  ThetaSketch<StlAllocator<uint64_t>> sketch(
+      kDefaultK, StlAllocator<uint64_t>(&allocator));
+  for (auto i = 0; i < 100'000; ++i) {
+    sketch.insertHash(hashOne(i));
+  }
+  sketch.compact();
+  std::string data(sketch.serializedByteSize(), '\0');
+  sketch.serialize(data.data());
+  ASSERT_EQ(data, serialize(makeSketch(0, 100'000)));
+}
+
+TEST(ThetaSketchTest, invalid) {
+  std::string data = serialize(makeSketch(0, 10));
+  VELOX_ASSERT_THROW(
+      ThetaSketch<>::view(data.data(), 3), "Invalid theta sketch");
+  VELOX_ASSERT_THROW(
+      ThetaSketch<>::view(data.data(), data.size() - 1),
+      "Invalid theta sketch");
+  data[0] = 2;
+  VELOX_ASSERT_THROW(
+      ThetaSketch<>::view(data.data(), data.size()),
+      "Unsupported theta sketch version");
+}
+
+} // namespace
+} // namespace facebook::velox::functions::theta::test
@@ -24,6 +24,10 @@
 namespace facebook::velox::functions {
 namespace {
 
+// Arrays of up to this many elements are deduplicated by comparing each element
+// with the distinct elements found so far instead of using a hash set.
+constexpr vector_size_t kMaxLinearScanSize = 16;
+
 /// See documentation at https://prestodb.io/docs/current/functions/array.html
 ///
 /// array_distinct SQL function.
@@ -96,8 +100,10 @@ class ArrayDistinctFunction : public exec::VectorFunction {
     auto* rawSizes = newLengths->asMutable<vector_size_t>();
     auto* rawOffsets = newOffsets->asMutable<vector_size_t>();
 
-    // Process the rows: store unique values in the hash table.
+    // Process the rows: store unique values in the hash table, or for small
+    // arrays in 'distinctValues'.
     folly::F14FastSet<T> uniqueSet;
+    T distinctValues[kMaxLinearScanSize];
 
     rows.applyToSelected([&](vector_size_t row) {
       auto size = arrayVector->sizeAt(row);
@@ -105,6 +111,8 @@ class ArrayDistinctFunction : public exec::VectorFunction {
 
       rawOffsets[row] = indicesCursor;
       bool hasNulls = false;
+      const bool linearScan = size <= kMaxLinearScanSize;
+      vector_size_t numDistinct = 0;
       for (vector_size_t i = offset; i < offset + size; ++i) {
         if (elements->isNullAt(i)) {
           if (!hasNulls) {
@@ -114,13 +122,25 @@ class ArrayDistinctFunction : public exec::VectorFunction {
         } else {
           auto value = elements->valueAt<T>(i);
 
-          if (uniqueSet.insert(value).second) {
+          bool isNew;
+          if (linearScan) {
+            auto* end = distinctValues + numDistinct;
+            isNew = std::find(distinctValues, end, value) == end;
+            if (isNew) {
+              distinctValues[numDistinct++] = value;
+            }
+          } else {
+            isNew = uniqueSet.insert(value).second;
+          }
+          if (isNew) {
             rawNewIndices[indicesCursor++] = i;
           }
         }
       }
 
-      uniqueSet.clear();
+      if (!linearScan) {
+        uniqueSet.clear();
+      }
       rawSizes[row] = indicesCursor - rawOffsets[row];
     });
 
@@ -73,6 +73,62 @@ void applyComplexType(
   resultElements = BaseVector::transpose(indices, std::move(inputElements));
 }
 
+// Integer arrays of up to this many elements are sorted with a sorting network
+// instead of std::sort.
+constexpr vector_size_t kMaxNetworkSortSize = 32;
+
+// Sorts 'kSize' values in place with Batcher's odd-even merge sort. The loops
+// unroll for a constant 'kSize' into compare-exchanges that do not branch on
+// the values.
+template <int32_t kSize, typename T>
+void networkSort(T* values) {
+  for (int32_t p = 1; p < kSize; p <<= 1) {
+    for (int32_t k = p; k >= 1; k >>= 1) {
+      for (int32_t j = k % p; j + k < kSize; j += 2 * k) {
+        for (int32_t i = 0; i < std::min(k, kSize - j - k); ++i) {
+          if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+            const auto a = values[i + j];
+            const auto b = values[i + j + k];
+            values[i + j] = std::min(a, b);
+            values[i + j + k] = std::max(a, b);
+          }
+        }
+      }
+    }
+  }
+}
+
+// Sorts 2 to kMaxNetworkSortSize integers. The values are padded with the
+// largest T up to the next power of two network size.
+template <typename T>
+void sortSmall(T* values, vector_size_t size) {
+  const auto networkSize = bits::nextPowerOfTwo(size);
+  T buffer[kMaxNetworkSortSize];
+  std::copy(values, values + size, buffer);
+  std::fill(
+      buffer + size, buffer + networkSize, std::numeric_limits<T>::max());
+  switch (networkSize) {
+    case 2:
+      networkSort<2>(buffer);
+      break;
+    case 4:
+      networkSort<4>(buffer);
+      break;
+    case 8:
+      networkSort<8>(buffer);
+      break;
+    case 16:
+      networkSort<16>(buffer);
+      break;
+    case 32:
+      networkSort<32>(buffer);
+      break;
+    default:
+      VELOX_UNREACHABLE();
+  }
+  std::copy(buffer, buffer + size, values);
+}
+
 template <typename T>
 inline void swapWithNull(
     FlatVector<T>* vector,
@@ -121,10 +177,13 @@ void applyScalarType(
     }
     vector_size_t numNulls = 0;
     // Move nulls to end of array.
-    for (vector_size_t i = size - 1; i >= 0; --i) {
-      if (flatResults->isNullAt(offset + i)) {
-        swapWithNull<T>(flatResults, offset + size - numNulls - 1, offset + i);
-        ++numNulls;
+    if (flatResults->mayHaveNulls()) {
+      for (vector_size_t i = size - 1; i >= 0; --i) {
+        if (flatResults->isNullAt(offset + i)) {
+          swapWithNull<T>(
+              flatResults, offset + size - numNulls - 1, offset + i);
+          ++numNulls;
+        }
       }
     }
     // Exclude null values while sorting.
@@ -139,6 +198,15 @@ void applyScalarType(
       bits::fillBits(rawBits, endZeroRow, endRow, bits::kNotNull);
     } else {
       T* resultRawValues = flatResults->mutableRawValues();
+      const auto numValues = endRow - startRow;
+      if constexpr (std::is_integral_v<T>) {
+        if (numValues <= kMaxNetworkSortSize) {
+          if (numValues > 1) {
+            sortSmall(resultRawValues + startRow, numValues);
+          }
+          return;
+        }
+      }
       std::sort(resultRawValues + startRow, resultRawValues + endRow);
     }
   };
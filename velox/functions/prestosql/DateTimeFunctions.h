@@ -893,12 +893,10 @@ struct DateFormatFunction : public TimestampWithTimezoneSupport<T> {
           std::string_view(formatString.data(), formatString.size()));
     }
 
-    auto formattedResult = mysqlDateTime_->format(timestamp, sessionTimeZone_);
-    auto resultSize = formattedResult.size();
+    result.reserve(mysqlDateTime_->maxResultSize(sessionTimeZone_));
+    const auto resultSize =
+        mysqlDateTime_->format(timestamp, sessionTimeZone_, result.data());
     result.resize(resultSize);
-    if (resultSize != 0) {
-      std::memcpy(result.data(), formattedResult.data(), resultSize);
-    }
     return true;
   }
 
@@ -985,12 +983,10 @@ struct FormatDateTimeFunction {
           std::string_view(formatString.data(), formatString.size()));
     }
 
-    auto formattedResult = jodaDateTime_->format(timestamp, sessionTimeZone_);
-    auto resultSize = formattedResult.size();
+    result.reserve(jodaDateTime_->maxResultSize(sessionTimeZone_));
+    const auto resultSize =
+        jodaDateTime_->format(timestamp, sessionTimeZone_, result.data());
     result.resize(resultSize);
-    if (resultSize != 0) {
-      std::memcpy(result.data(), formattedResult.data(), resultSize);
-    }
     return true;
   }
 };
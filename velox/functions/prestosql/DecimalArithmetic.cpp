@@ -43,6 +43,13 @@ class DecimalBaseFunction : public exec::VectorFunction {
       auto constant = args[0]->asUnchecked<SimpleVector<A>>()->valueAt(0);
       auto flatValues = args[1]->asUnchecked<FlatVector<B>>();
       auto rawValues = flatValues->mutableRawValues();
+      if (applyShortBatch(
+              rows,
+              rawResults,
+              [&](auto /*row*/) { return constant; },
+              [&](auto row) { return rawValues[row]; })) {
+        return;
+      }
       context.applyToSelectedNoThrow(rows, [&](auto row) {
         Operation::template apply<R, A, B>(
             rawResults[row], constant, rawValues[row], aRescale_, bRescale_);
@@ -52,6 +59,13 @@ class DecimalBaseFunction : public exec::VectorFunction {
       auto flatValues = args[0]->asUnchecked<FlatVector<A>>();
       auto constant = args[1]->asUnchecked<SimpleVector<B>>()->valueAt(0);
       auto rawValues = flatValues->mutableRawValues();
+      if (applyShortBatch(
+              rows,
+              rawResults,
+              [&](auto row) { return rawValues[row]; },
+              [&](auto /*row*/) { return constant; })) {
+        return;
+      }
       context.applyToSelectedNoThrow(rows, [&](auto row) {
         Operation::template apply<R, A, B>(
             rawResults[row], rawValues[row], constant, aRescale_, bRescale_);
@@ -62,6 +76,13 @@ class DecimalBaseFunction : public exec::VectorFunction {
       auto rawA = flatA->mutableRawValues();
       auto flatB = args[1]->asUnchecked<FlatVector<B>>();
       auto rawB = flatB->mutableRawValues();
+      if (applyShortBatch(
+              rows,
+              rawResults,
+              [&](auto row) { return rawA[row]; },
+              [&](auto row) { return rawB[row]; })) {
+        return;
+      }
       context.applyToSelectedNoThrow(rows, [&](auto row) {
         Operation::template apply<R, A, B>(
             rawResults[row], rawA[row], rawB[row], aRescale_, bRescale_);
@@ -83,6 +104,63 @@ class DecimalBaseFunction : public exec::VectorFunction {
   }
 
  private:
+  static constexpr bool kShortBatch = Operation::kSupportsShortBatch &&
+      std::is_same_v<R, UnscaledShortDecimal> &&
+      std::is_same_v<A, UnscaledShortDecimal> &&
+      std::is_same_v<B, UnscaledShortDecimal>;
+
+  // Computes short decimal results with 64-bit math when the result and
+  // both arguments are short decimals. Overflow and out of range flags are
+  // OR-ed across the batch instead of being checked per row. Specializes the
+  // common case of equal scales, which needs no rescaling. Returns false if
+  // the kernel doesn't apply or any row overflowed. In that case the caller
+  // recomputes all rows on the per-row path, which reports errors for the
+  // offending rows.
+  template <typename AValue, typename BValue>
+  bool applyShortBatch(
+      const SelectivityVector& rows,
+      R* rawResults,
+      AValue aValue,
+      BValue bValue) const {
+    if constexpr (kShortBatch) {
+      if (aRescale_ == 0 && bRescale_ == 0) {
+        return applyShortBatchImpl<false>(rows, rawResults, aValue, bValue);
+      }
+      if (std::max(aRescale_, bRescale_) <= kMaxShortRescale) {
+        return applyShortBatchImpl<true>(rows, rawResults, aValue, bValue);
+      }
+    }
+    return false;
+  }
+
+  template <bool kRescale, typename AValue, typename BValue>
+  bool applyShortBatchImpl(
+      const SelectivityVector& rows,
+      R* rawResults,
+      AValue aValue,
+      BValue bValue) const {
+    const int64_t aFactor = DecimalUtil::kPowersOfTen[aRescale_];
+    const int64_t bFactor = DecimalUtil::kPowersOfTen[bRescale_];
+    bool overflow = false;
+    rows.applyToSelected([&](auto row) {
+      int64_t value;
+      const bool rowOverflow =
+          Operation::template applyShort<kRescale>(
+              value,
+              aValue(row).unscaledValue(),
+              bValue(row).unscaledValue(),
+              aFactor,
+              bFactor) |
+          !UnscaledShortDecimal::valueInRange(value);
+      overflow |= rowOverflow;
+      rawResults[row] = UnscaledShortDecimal(rowOverflow ? 0 : value);
+    });
+    return !overflow;
+  }
+
+  // Largest rescale factor that fits in 64 bits.
+  static constexpr uint8_t kMaxShortRescale = 18;
+
   R* prepareResults(
       const SelectivityVector& rows,
       const TypePtr& resultType,
@@ -124,6 +202,26 @@ class Addition {
     r = checkedPlus<R>(R(aRescaled), R(bRescaled));
   }
 
+  static constexpr bool kSupportsShortBatch = true;
+
+  // Computes 'r' = 'a' * 'aFactor' + 'b' * 'bFactor' in 64 bits. Returns true
+  // on overflow. Used by the batched short decimal kernel.
+  template <bool kRescale>
+  inline static bool applyShort(
+      int64_t& r,
+      int64_t a,
+      int64_t b,
+      int64_t aFactor,
+      int64_t bFactor) {
+    if constexpr (kRescale) {
+      return __builtin_mul_overflow(a, aFactor, &a) |
+          __builtin_mul_overflow(b, bFactor, &b) |
+          __builtin_add_overflow(a, b, &r);
+    } else {
+      return __builtin_add_overflow(a, b, &r);
+    }
+  }
+
   inline static uint8_t
   computeRescaleFactor(uint8_t fromScale, uint8_t toScale, uint8_t rScale = 0) {
     return std::max(0, toScale - fromScale);
@@ -170,6 +268,24 @@ class Subtraction {
     r = checkedMinus<R>(R(aRescaled), R(bRescaled));
   }
 
+  static constexpr bool kSupportsShortBatch = true;
+
+  template <bool kRescale>
+  inline static bool applyShort(
+      int64_t& r,
+      int64_t a,
+      int64_t b,
+      int64_t aFactor,
+      int64_t bFactor) {
+    if constexpr (kRescale) {
+      return __builtin_mul_overflow(a, aFactor, &a) |
+          __builtin_mul_overflow(b, bFactor, &b) |
+          __builtin_sub_overflow(a, b, &r);
+    } else {
+      return __builtin_sub_overflow(a, b, &r);
+    }
+  }
+
   inline static uint8_t
   computeRescaleFactor(uint8_t fromScale, uint8_t toScale, uint8_t rScale = 0) {
     return std::max(0, toScale - fromScale);
@@ -195,6 +311,19 @@ class Multiply {
         R(DecimalUtil::kPowersOfTen[aRescale + bRescale]));
   }
 
+  static constexpr bool kSupportsShortBatch = true;
+
+  // The rescale factors of multiply are always 0.
+  template <bool kRescale>
+  inline static bool applyShort(
+      int64_t& r,
+      int64_t a,
+      int64_t b,
+      int64_t /*aFactor*/,
+      int64_t /*bFactor*/) {
+    return __builtin_mul_overflow(a, b, &r);
+  }
+
   inline static uint8_t
   computeRescaleFactor(uint8_t fromScale, uint8_t toScale, uint8_t rScale = 0) {
     return 0;
@@ -217,6 +346,9 @@ class Divide {
     DecimalUtil::divideWithRoundUp<R, A, B>(r, a, b, false, aRescale, 0);
   }
 
+  // Division rounds and checks for zero divisors per row.
+  static constexpr bool kSupportsShortBatch = false;
+
   inline static uint8_t
   computeRescaleFactor(uint8_t fromScale, uint8_t toScale, uint8_t rScale) {
     return rScale - fromScale + toScale;
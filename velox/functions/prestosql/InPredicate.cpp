@@ -13,12 +13,18 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/common/base/SimdUtil.h"
+#include "velox/expression/ConstantStateCache.h"
 #include "velox/expression/VectorFunction.h"
 #include "velox/type/Filter.h"
 
 namespace facebook::velox::functions {
 namespace {
 
+// IN lists with at most this many values are tested by comparing a batch of
+// input values with each list value instead of probing the filter.
+constexpr int32_t kMaxSmallInList = 16;
+
 template <typename T, typename U = T>
 std::optional<std::pair<std::vector<T>, bool>> toValues(
     const std::vector<exec::VectorFunctionArg>& inputArgs) {
@@ -58,10 +64,12 @@ std::optional<std::pair<std::vector<T>, bool>> toValues(
 
 // Creates a filter for constant values. A null filter means either
 // no values or only null values. The boolean is true if the list is
-// non-empty and consists of nulls only.
+// non-empty and consists of nulls only. Copies the values to 'smallValues' if
+// there are at most kMaxSmallInList of them.
 template <typename T>
 std::pair<std::unique_ptr<common::Filter>, bool> createBigintValuesFilter(
-    const std::vector<exec::VectorFunctionArg>& inputArgs) {
+    const std::vector<exec::VectorFunctionArg>& inputArgs,
+    std::vector<int64_t>& smallValues) {
   auto valuesPair = toValues<int64_t, T>(inputArgs);
   if (!valuesPair.has_value()) {
     return {nullptr, false};
@@ -76,6 +84,9 @@ std::pair<std::unique_ptr<common::Filter>, bool> createBigintValuesFilter(
   VELOX_USER_CHECK(
       !values.empty(),
       "IN predicate expects at least one non-null value in the in-list");
+  if (values.size() <= kMaxSmallInList) {
+    smallValues = values;
+  }
   if (values.size() == 1) {
     return {
         std::make_unique<common::BigintRange>(
@@ -113,31 +124,57 @@ std::pair<std::unique_ptr<common::Filter>, bool> createBytesValuesFilter(
   return {std::make_unique<common::BytesValues>(values, nullAllowed), false};
 }
 
+// The filter made from a constant IN list. Shared by all the InPredicates
+// made for the same constant, e.g. by the Drivers of a Task.
+struct InListFilter {
+  std::unique_ptr<common::Filter> filter;
+  bool alwaysNull;
+  // The non-null values of a small integer IN list. Empty if the list is large
+  // or not of an integer type.
+  std::vector<int64_t> smallValues;
+};
+
 class InPredicate : public exec::VectorFunction {
  public:
-  explicit InPredicate(std::unique_ptr<common::Filter> filter, bool alwaysNull)
-      : filter_{std::move(filter)}, alwaysNull_(alwaysNull) {}
+  explicit InPredicate(std::shared_ptr<const InListFilter> filter)
+      : inList_{std::move(filter)},
+        filter_{inList_->filter.get()},
+        alwaysNull_(inList_->alwaysNull) {}
 
   static std::shared_ptr<InPredicate> create(
       const std::string& /*name*/,
       const std::vector<exec::VectorFunctionArg>& inputArgs) {
     VELOX_CHECK_EQ(inputArgs.size(), 2);
+    if (inputArgs[1].constantValue == nullptr) {
+      return std::make_shared<InPredicate>(createFilter(inputArgs));
+    }
+    // A large IN list is costly to make into a filter. Make it once for all
+    // the compilations of the expression.
+    return std::make_shared<InPredicate>(
+        exec::ConstantStateCache::instance().getOrCreate<InListFilter>(
+            inputArgs[1].constantValue,
+            [&]() { return createFilter(inputArgs); }));
+  }
+
+  static std::shared_ptr<const InListFilter> createFilter(
+      const std::vector<exec::VectorFunctionArg>& inputArgs) {
     auto inListType = inputArgs[1].type;
     VELOX_CHECK_EQ(inListType->kind(), TypeKind::ARRAY);
     std::pair<std::unique_ptr<common::Filter>, bool> filter;
+    std::vector<int64_t> smallValues;
 
     switch (inListType->childAt(0)->kind()) {
       case TypeKind::BIGINT:
-        filter = createBigintValuesFilter<int64_t>(inputArgs);
+        filter = createBigintValuesFilter<int64_t>(inputArgs, smallValues);
         break;
       case TypeKind::INTEGER:
-        filter = createBigintValuesFilter<int32_t>(inputArgs);
+        filter = createBigintValuesFilter<int32_t>(inputArgs, smallValues);
         break;
       case TypeKind::SMALLINT:
-        filter = createBigintValuesFilter<int16_t>(inputArgs);
+        filter = createBigintValuesFilter<int16_t>(inputArgs, smallValues);
         break;
       case TypeKind::TINYINT:
-        filter = createBigintValuesFilter<int8_t>(inputArgs);
+        filter = createBigintValuesFilter<int8_t>(inputArgs, smallValues);
         break;
       case TypeKind::VARCHAR:
       case TypeKind::VARBINARY:
@@ -151,8 +188,9 @@ class InPredicate : public exec::VectorFunction {
             "Unsupported in-list type for IN predicate: {}",
             inListType->toString());
     }
-    return std::make_shared<InPredicate>(
-        std::move(filter.first), filter.second);
+    return std::make_shared<const InListFilter>(
+        InListFilter{
+            std::move(filter.first), filter.second, std::move(smallValues)});
   }
 
   // x IN (2, null) returns null when x != 2 and true when x == 2.
@@ -293,6 +331,10 @@ class InPredicate : public exec::VectorFunction {
           }
         }
       });
+    } else if constexpr (
+        std::is_same_v<T, int64_t> || std::is_same_v<T, int32_t> ||
+        std::is_same_v<T, int16_t>) {
+      applySimd(rows, rawValues, rawResults);
     } else {
       rows.applyToSelected([&](auto row) {
         bool pass = testFunction(rawValues[row]);
@@ -301,7 +343,62 @@ class InPredicate : public exec::VectorFunction {
     }
   }
 
-  const std::unique_ptr<common::Filter> filter_;
+  // Tests a batch of integer values against the IN list. Small lists compare
+  // the batch with each value. Larger lists probe the filter one batch at a
+  // time, which for a hash table filter gathers all the lanes at once.
+  template <typename T>
+  xsimd::batch_bool<T> testBatch(xsimd::batch<T> values) const {
+    const auto& smallValues = inList_->smallValues;
+    if (smallValues.empty()) {
+      return filter_->testValues(values);
+    }
+    auto result = values == xsimd::broadcast<T>(smallValues[0]);
+    for (auto i = 1; i < smallValues.size(); ++i) {
+      result = result | (values == xsimd::broadcast<T>(smallValues[i]));
+    }
+    return result;
+  }
+
+  // Sets the result bits for non-null integer values 'rawValues' at 'rows'.
+  // Fully selected words of 64 rows are tested a batch at a time, partial
+  // words row by row.
+  template <typename T>
+  void applySimd(
+      const SelectivityVector& rows,
+      const T* rawValues,
+      uint64_t* rawResults) const {
+    constexpr int32_t kBatchSize = xsimd::batch<T>::size;
+    static_assert(64 % kBatchSize == 0);
+    const auto* selected = rows.asRange().bits();
+    bits::forEachWord(
+        rows.begin(),
+        rows.end(),
+        [&](int32_t index, uint64_t mask) {
+          auto word = selected[index] & mask;
+          while (word) {
+            const auto row = index * 64 + __builtin_ctzll(word);
+            bits::setBit(rawResults, row, filter_->testInt64(rawValues[row]));
+            word &= word - 1;
+          }
+        },
+        [&](int32_t index) {
+          const auto word = selected[index];
+          if (!word) {
+            return;
+          }
+          const auto* values = rawValues + index * 64;
+          uint64_t pass = 0;
+          for (auto i = 0; i < 64; i += kBatchSize) {
+            const auto batchPass = static_cast<uint32_t>(simd::toBitMask(
+                testBatch<T>(xsimd::load_unaligned(values + i))));
+            pass |= static_cast<uint64_t>(batchPass) << i;
+          }
+          rawResults[index] = (rawResults[index] & ~word) | (pass & word);
+        });
+  }
+
+  const std::shared_ptr<const InListFilter> inList_;
+  const common::Filter* const filter_;
   const bool alwaysNull_;
 };
 } // namespace
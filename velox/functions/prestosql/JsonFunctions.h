@@ -13,6 +13,9 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <optional>
+
+#include "velox/core/QueryConfig.h"
 #include "velox/functions/Macros.h"
 #include "velox/functions/UDFOutputString.h"
 #include "velox/functions/prestosql/json/JsonExtractor.h"
@@ -40,14 +43,27 @@ template <typename T>
 struct JsonExtractScalarFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
+  // Set if the path is constant.
+  std::optional<JsonExtractor> extractor_;
+
+  FOLLY_ALWAYS_INLINE void initialize(
+      const core::QueryConfig& /*config*/,
+      const arg_type<Json>* /*json*/,
+      const arg_type<Varchar>* jsonPath) {
+    if (jsonPath != nullptr) {
+      extractor_.emplace(folly::StringPiece(*jsonPath));
+    }
+  }
+
   FOLLY_ALWAYS_INLINE bool call(
       out_type<Varchar>& result,
       const arg_type<Json>& json,
       const arg_type<Varchar>& jsonPath) {
     const folly::StringPiece& jsonStringPiece = json;
     const folly::StringPiece& jsonPathStringPiece = jsonPath;
-    auto extractResult =
-        jsonExtractScalar(jsonStringPiece, jsonPathStringPiece);
+    auto extractResult = extractor_
+        ? extractor_->extractScalar(jsonStringPiece)
+        : jsonExtractScalar(jsonStringPiece, jsonPathStringPiece);
     if (extractResult.hasValue()) {
       UDFOutputString::assign(result, *extractResult);
       return true;
@@ -117,24 +133,34 @@ template <typename T>
 struct JsonSizeFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
+  // Set if the path is constant.
+  std::optional<JsonExtractor> extractor_;
+
+  FOLLY_ALWAYS_INLINE void initialize(
+      const core::QueryConfig& /*config*/,
+      const arg_type<Json>* /*json*/,
+      const arg_type<Varchar>* jsonPath) {
+    if (jsonPath != nullptr) {
+      extractor_.emplace(folly::StringPiece(*jsonPath));
+    }
+  }
+
   FOLLY_ALWAYS_INLINE bool call(
       int64_t& result,
       const arg_type<Json>& json,
       const arg_type<Varchar>& jsonPath) {
     const folly::StringPiece& jsonStringPiece = json;
     const folly::StringPiece& jsonPathStringPiece = jsonPath;
-    auto extractResult = jsonExtract(jsonStringPiece, jsonPathStringPiece);
-    if (!extractResult.has_value()) {
+    // Counts the members without copying the object or array out of the
+    // parsed json.
+    auto size = extractor_
+        ? extractor_->extractSize(jsonStringPiece)
+        : JsonExtractor::getInstance(jsonPathStringPiece)
+              .extractSize(jsonStringPiece);
+    if (!size.has_value()) {
       return false;
     }
-    // The size of the object or array is the number of members, otherwise the
-    // size is zero
-    if (extractResult->isArray() || extractResult->isObject()) {
-      result = extractResult->size();
-    } else {
-      result = 0;
-    }
-
+    result = size.value();
     return true;
   }
 };
@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/expression/ScalarLambda.h"
 #include "velox/expression/VectorFunction.h"
 #include "velox/functions/lib/LambdaFunctionUtil.h"
 
@@ -52,6 +53,88 @@ bool toNthElementRows(
   return arrayRows.hasSelections();
 }
 
+/// Reduces the non-empty arrays in 'rows' by running 'lambda' on one state
+/// and one element at a time and writes the final states to
+/// 'partialResult'. Returns false if the lambda overflowed, in which case the
+/// reduction is evaluated as an expression to report the errors.
+template <typename T>
+bool reduceScalar(
+    const exec::ScalarLambda& lambda,
+    const ArrayVector& arrayVector,
+    const DecodedVector& initialState,
+    const SelectivityVector& rows,
+    BaseVector& partialResult) {
+  auto* rawSizes = arrayVector.rawSizes();
+  auto* rawOffsets = arrayVector.rawOffsets();
+  auto* rawNulls = arrayVector.rawNulls();
+  auto* rawElements =
+      arrayVector.elements()->asUnchecked<FlatVector<T>>()->rawValues();
+  auto* rawResults =
+      partialResult.asUnchecked<FlatVector<T>>()->mutableRawValues();
+  bool ok = true;
+  rows.testSelected([&](auto row) {
+    if ((rawNulls && bits::isBitNull(rawNulls, row)) || rawSizes[row] == 0) {
+      return true;
+    }
+    // args[0] is the state and args[1] is the element.
+    T args[2];
+    args[0] = initialState.valueAt<T>(row);
+    const auto end = rawOffsets[row] + rawSizes[row];
+    for (auto i = rawOffsets[row]; i < end; ++i) {
+      args[1] = rawElements[i];
+      if (!lambda.evaluate(args, args[0])) {
+        ok = false;
+        return false;
+      }
+    }
+    rawResults[row] = args[0];
+    return true;
+  });
+  return ok;
+}
+
+/// Runs the input function of reduce as an exec::ScalarLambda if it has a
+/// simple arithmetic body and the states and elements are non-null values of
+/// its type. Returns true if the states of 'rows' are in 'partialResult'.
+bool tryReduceScalar(
+    Callable& callable,
+    const ArrayVectorPtr& arrayVector,
+    const VectorPtr& initialState,
+    const SelectivityVector& rows,
+    exec::EvalCtx& context,
+    BaseVector& partialResult) {
+  auto lambda = exec::ScalarLambda::tryCreate(callable);
+  if (!lambda) {
+    return false;
+  }
+  const auto& elements = arrayVector->elements();
+  if (initialState->typeKind() != lambda->kind() ||
+      elements->typeKind() != lambda->kind() ||
+      !elements->isFlatEncoding() || elements->mayHaveNulls()) {
+    return false;
+  }
+  exec::LocalDecodedVector stateDecoder(context, *initialState, rows);
+  if (stateDecoder.get()->mayHaveNulls()) {
+    return false;
+  }
+  switch (lambda->kind()) {
+    case TypeKind::BIGINT:
+      return reduceScalar<int64_t>(
+          *lambda, *arrayVector, *stateDecoder.get(), rows, partialResult);
+    case TypeKind::INTEGER:
+      return reduceScalar<int32_t>(
+          *lambda, *arrayVector, *stateDecoder.get(), rows, partialResult);
+    case TypeKind::DOUBLE:
+      return reduceScalar<double>(
+          *lambda, *arrayVector, *stateDecoder.get(), rows, partialResult);
+    case TypeKind::REAL:
+      return reduceScalar<float>(
+          *lambda, *arrayVector, *stateDecoder.get(), rows, partialResult);
+    default:
+      return false;
+  }
+}
+
 /// See documentation at
 /// https://prestodb.io/docs/current/functions/array.html#reduce
 class ReduceFunction : public exec::VectorFunction {
@@ -112,6 +195,16 @@ class ReduceFunction : public exec::VectorFunction {
     // At each step the number of arrays being processed will get smaller as
     // some arrays will run out of elements.
     while (auto entry = inputFuncIt.next()) {
+      if (tryReduceScalar(
+              *entry.callable,
+              flatArray,
+              initialState,
+              *entry.rows,
+              context,
+              *partialResult)) {
+        continue;
+      }
+
       VectorPtr state = initialState;
 
       vector_size_t n = 0;
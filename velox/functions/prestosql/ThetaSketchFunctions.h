@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/functions/Macros.h"
+#include "velox/functions/lib/ThetaSketch.h"
+
+namespace facebook::velox::functions {
+
+/// theta_estimate(sketch) -> double. Returns the estimated number of distinct
+/// values of a theta sketch produced by theta_sketch_agg, theta_union or
+/// theta_intersect.
+template <typename T>
+struct ThetaEstimateFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  FOLLY_ALWAYS_INLINE bool call(
+      double& result,
+      const arg_type<Varbinary>& sketch) {
+    result =
+        theta::ThetaSketch<>::view(sketch.data(), sketch.size()).estimate();
+    return true;
+  }
+};
+
+} // namespace facebook::velox::functions
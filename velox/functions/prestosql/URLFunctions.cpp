@@ -13,44 +13,379 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/functions/prestosql/URLFunctions.h"
 
-#include "URLFunctions.h"
-#include "velox/type/Type.h"
+#include <folly/Conv.h>
+#include <algorithm>
+
+#include "velox/expression/DecodedArgs.h"
+#include "velox/expression/EvalCtx.h"
+#include "velox/expression/VectorFunction.h"
+#include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::functions {
+namespace {
+
+using Range = UrlComponents::Range;
+
+bool isAlpha(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+bool isDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+bool isSchemeChar(char c) {
+  return isAlpha(c) || isDigit(c) || c == '+' || c == '.' || c == '-';
+}
+
+Range makeRange(size_t begin, size_t end) {
+  return {static_cast<uint32_t>(begin), static_cast<uint32_t>(end - begin)};
+}
+
+// Matches [begin, end) of 'url' against host[:port], where host is either an
+// IP literal in square brackets or a run of characters other than '[' and
+// ':', and port is a possibly empty run of digits. Sets 'host' and 'port' and
+// returns true on success.
+bool parseHostAndPort(
+    std::string_view url,
+    size_t begin,
+    size_t end,
+    Range& host,
+    Range& port) {
+  size_t hostEnd = begin;
+  if (begin < end && url[begin] == '[') {
+    hostEnd = url.find(']', begin);
+    if (hostEnd == std::string_view::npos || hostEnd >= end) {
+      return false;
+    }
+    ++hostEnd;
+  } else {
+    while (hostEnd < end && url[hostEnd] != '[' && url[hostEnd] != ':') {
+      ++hostEnd;
+    }
+  }
 
-bool matchAuthorityAndPath(
-    const boost::cmatch& urlMatch,
-    boost::cmatch& authAndPathMatch,
-    boost::cmatch& authorityMatch,
-    bool& hasAuthority) {
-  static const boost::regex kAuthorityAndPathRegex("//([^/]*)(/.*)?");
-  auto authorityAndPath = submatch(urlMatch, 2);
-  if (!boost::regex_match(
-          authorityAndPath.begin(),
-          authorityAndPath.end(),
-          authAndPathMatch,
-          kAuthorityAndPathRegex)) {
-    // Does not start with //, doesn't have authority.
-    hasAuthority = false;
+  Range portRange;
+  if (hostEnd < end) {
+    if (url[hostEnd] != ':') {
+      return false;
+    }
+    for (auto i = hostEnd + 1; i < end; ++i) {
+      if (!isDigit(url[i])) {
+        return false;
+      }
+    }
+    portRange = makeRange(hostEnd + 1, end);
+  }
+  host = makeRange(begin, hostEnd);
+  port = portRange;
+  return true;
+}
+
+// Parses the [userinfo@]host[:port] authority in [begin, end) of 'url'. The
+// user info ends at the first '@'. If the rest is not a valid host and port,
+// the whole authority is taken as host and port, so the host may contain '@'.
+bool parseAuthority(
+    std::string_view url,
+    size_t begin,
+    size_t end,
+    UrlComponents& components) {
+  const auto at = url.substr(begin, end - begin).find('@');
+  if (at != std::string_view::npos &&
+      parseHostAndPort(
+          url, begin + at + 1, end, components.host, components.port)) {
     return true;
   }
+  return parseHostAndPort(url, begin, end, components.host, components.port);
+}
+
+} // namespace
 
-  static const boost::regex kAuthorityRegex(
-      "(?:([^@:]*)(?::([^@]*))?@)?" // username, password.
-      "(\\[[^\\]]*\\]|[^\\[:]*)" // host (IP-literal (e.g. '['+IPv6+']',
-      // dotted-IPv4, or named host).
-      "(?::(\\d*))?"); // port.
+bool parseUrl(std::string_view url, UrlComponents& components) {
+  components = UrlComponents();
 
-  const auto authority = authAndPathMatch[1];
-  if (!boost::regex_match(
-          authority.first, authority.second, authorityMatch, kAuthorityRegex)) {
-    return false; // Invalid URI Authority.
+  const auto colon = url.find(':');
+  if (colon == std::string_view::npos || colon == 0 || !isAlpha(url[0])) {
+    return false;
   }
+  for (size_t i = 1; i < colon; ++i) {
+    if (!isSchemeChar(url[i])) {
+      return false;
+    }
+  }
+  components.protocol = makeRange(0, colon);
 
-  hasAuthority = true;
+  // The authority and path end at the first '?' or '#', the query at the
+  // first '#' after that.
+  const auto fragmentStart = url.find('#', colon + 1);
+  const auto end = std::min(url.find('?', colon + 1), fragmentStart);
+  if (fragmentStart != std::string_view::npos) {
+    components.fragment = makeRange(fragmentStart + 1, url.size());
+  }
+  const auto pathEnd = std::min(end, url.size());
+  if (end != std::string_view::npos && url[end] == '?') {
+    components.query = makeRange(end + 1, std::min(fragmentStart, url.size()));
+  }
 
+  const auto pathBegin = colon + 1;
+  if (url.substr(pathBegin, 2) != "//") {
+    components.path = makeRange(pathBegin, pathEnd);
+    return true;
+  }
+
+  const auto authorityBegin = pathBegin + 2;
+  const auto authorityEnd = std::min(url.find('/', authorityBegin), pathEnd);
+  if (parseAuthority(url, authorityBegin, authorityEnd, components)) {
+    components.path = makeRange(authorityEnd, pathEnd);
+  }
   return true;
 }
 
+std::optional<std::string_view> extractUrlParameter(
+    std::string_view query,
+    std::string_view name) {
+  size_t begin = 0;
+  while (begin <= query.size()) {
+    auto end = query.find('&', begin);
+    if (end == std::string_view::npos) {
+      end = query.size();
+    }
+    const auto pair = query.substr(begin, end - begin);
+    const auto equals = pair.find('=');
+    const auto key = pair.substr(0, equals);
+    const auto value = equals == std::string_view::npos
+        ? std::string_view()
+        : pair.substr(equals + 1);
+    if (!key.empty() && key == name &&
+        value.find('=') == std::string_view::npos) {
+      return value;
+    }
+    begin = end + 1;
+  }
+  return std::nullopt;
+}
+
+namespace {
+
+// The components of the URLs in a vector, parsed on first use. Shared by all
+// the URL functions that take the same vector in one evaluation, so that
+// url_extract_host(c0), url_extract_path(c0) etc. parse each URL once.
+class ParsedUrls {
+ public:
+  static std::shared_ptr<ParsedUrls> get(
+      const VectorPtr& urls,
+      const SelectivityVector& rows,
+      exec::EvalCtx& context) {
+    auto parsedUrls = context.getOrCreateVectorState<ParsedUrls>(
+        urls, []() { return std::make_shared<ParsedUrls>(); });
+    parsedUrls->reserve(rows.end());
+    return parsedUrls;
+  }
+
+  const UrlComponents& components(vector_size_t row, StringView url) {
+    if (!parsed_[row]) {
+      parseUrl(std::string_view(url.data(), url.size()), components_[row]);
+      parsed_[row] = true;
+    }
+    return components_[row];
+  }
+
+ private:
+  // Makes room for rows below 'size'. The rows of a shared subexpression may
+  // be evaluated over several calls.
+  void reserve(vector_size_t size) {
+    if (components_.size() < size) {
+      components_.resize(size);
+      parsed_.resize(size, false);
+    }
+  }
+
+  std::vector<UrlComponents> components_;
+  std::vector<bool> parsed_;
+};
+
+// Returns the part of 'url' in 'range'. 'url' must be the string that
+// 'range' was parsed from. A result short enough to be inlined is copied, a
+// longer one refers to the string buffers of 'url'.
+StringView substring(StringView url, Range range) {
+  return StringView(url.data() + range.begin, range.size);
+}
+
+// url_extract_protocol, url_extract_host, url_extract_path,
+// url_extract_query and url_extract_fragment: Returns one component of the
+// URL, or an empty string if the URL does not have it or is invalid.
+class UrlExtractComponentFunction : public exec::VectorFunction {
+ public:
+  explicit UrlExtractComponentFunction(Range UrlComponents::*component)
+      : component_(component) {}
+
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& outputType,
+      exec::EvalCtx& context,
+      VectorPtr& result) const override {
+    exec::LocalDecodedVector urls(context, *args[0], rows);
+    auto parsedUrls = ParsedUrls::get(args[0], rows, context);
+
+    context.ensureWritable(rows, outputType, result);
+    result->clearNulls(rows);
+    auto* flatResult = result->asFlatVector<StringView>();
+    flatResult->acquireSharedStringBuffers(args[0].get());
+
+    rows.applyToSelected([&](auto row) {
+      const auto url = urls->valueAt<StringView>(row);
+      const auto& components = parsedUrls->components(row, url);
+      flatResult->setNoCopy(row, substring(url, components.*component_));
+    });
+  }
+
+  std::optional<std::vector<size_t>> propagateStringEncodingFrom()
+      const override {
+    return {{0}};
+  }
+
+  static std::vector<std::shared_ptr<exec::FunctionSignature>> signatures() {
+    // varchar -> varchar
+    return {exec::FunctionSignatureBuilder()
+                .returnType("varchar")
+                .argumentType("varchar")
+                .build()};
+  }
+
+ private:
+  const Range UrlComponents::*const component_;
+};
+
+// url_extract_port(url) -> bigint: Returns the port of the URL, or null if
+// the URL does not have one or is invalid.
+class UrlExtractPortFunction : public exec::VectorFunction {
+ public:
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& outputType,
+      exec::EvalCtx& context,
+      VectorPtr& result) const override {
+    exec::LocalDecodedVector urls(context, *args[0], rows);
+    auto parsedUrls = ParsedUrls::get(args[0], rows, context);
+
+    context.ensureWritable(rows, outputType, result);
+    result->clearNulls(rows);
+    auto* flatResult = result->asFlatVector<int64_t>();
+
+    rows.applyToSelected([&](auto row) {
+      const auto url = urls->valueAt<StringView>(row);
+      const auto range = parsedUrls->components(row, url).port;
+      if (range.size > 0) {
+        const auto port = folly::tryTo<int64_t>(
+            folly::StringPiece(url.data() + range.begin, range.size));
+        if (port.hasValue()) {
+          flatResult->set(row, port.value());
+          return;
+        }
+      }
+      flatResult->setNull(row, true);
+    });
+  }
+
+  static std::vector<std::shared_ptr<exec::FunctionSignature>> signatures() {
+    // varchar -> bigint
+    return {exec::FunctionSignatureBuilder()
+                .returnType("bigint")
+                .argumentType("varchar")
+                .build()};
+  }
+};
+
+// url_extract_parameter(url, name) -> varchar: Returns the value of the first
+// query parameter called 'name', or null if there is none or the URL is
+// invalid.
+class UrlExtractParameterFunction : public exec::VectorFunction {
+ public:
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& outputType,
+      exec::EvalCtx& context,
+      VectorPtr& result) const override {
+    exec::DecodedArgs decodedArgs(rows, args, context);
+    auto* urls = decodedArgs.at(0);
+    auto* names = decodedArgs.at(1);
+    auto parsedUrls = ParsedUrls::get(args[0], rows, context);
+
+    context.ensureWritable(rows, outputType, result);
+    result->clearNulls(rows);
+    auto* flatResult = result->asFlatVector<StringView>();
+    flatResult->acquireSharedStringBuffers(args[0].get());
+
+    rows.applyToSelected([&](auto row) {
+      const auto url = urls->valueAt<StringView>(row);
+      const auto name = names->valueAt<StringView>(row);
+      const auto query = parsedUrls->components(row, url).query;
+      const auto value = extractUrlParameter(
+          std::string_view(url.data() + query.begin, query.size),
+          std::string_view(name.data(), name.size()));
+      if (value.has_value()) {
+        flatResult->setNoCopy(row, StringView(value->data(), value->size()));
+      } else {
+        flatResult->setNull(row, true);
+      }
+    });
+  }
+
+  std::optional<std::vector<size_t>> propagateStringEncodingFrom()
+      const override {
+    return {{0}};
+  }
+
+  static std::vector<std::shared_ptr<exec::FunctionSignature>> signatures() {
+    // varchar, varchar -> varchar
+    return {exec::FunctionSignatureBuilder()
+                .returnType("varchar")
+                .argumentType("varchar")
+                .argumentType("varchar")
+                .build()};
+  }
+};
+
+} // namespace
+
+VELOX_DECLARE_VECTOR_FUNCTION(
+    udf_url_extract_protocol,
+    UrlExtractComponentFunction::signatures(),
+    std::make_unique<UrlExtractComponentFunction>(&UrlComponents::protocol));
+
+VELOX_DECLARE_VECTOR_FUNCTION(
+    udf_url_extract_host,
+    UrlExtractComponentFunction::signatures(),
+    std::make_unique<UrlExtractComponentFunction>(&UrlComponents::host));
+
+VELOX_DECLARE_VECTOR_FUNCTION(
+    udf_url_extract_path,
+    UrlExtractComponentFunction::signatures(),
+    std::make_unique<UrlExtractComponentFunction>(&UrlComponents::path));
+
+VELOX_DECLARE_VECTOR_FUNCTION(
+    udf_url_extract_query,
+    UrlExtractComponentFunction::signatures(),
+    std::make_unique<UrlExtractComponentFunction>(&UrlComponents::query));
+
+VELOX_DECLARE_VECTOR_FUNCTION(
+    udf_url_extract_fragment,
+    UrlExtractComponentFunction::signatures(),
+    std::make_unique<UrlExtractComponentFunction>(&UrlComponents::fragment));
+
+VELOX_DECLARE_VECTOR_FUNCTION(
+    udf_url_extract_port,
+    UrlExtractPortFunction::signatures(),
+    std::make_unique<UrlExtractPortFunction>());
+
+VELOX_DECLARE_VECTOR_FUNCTION(
+    udf_url_extract_parameter,
+    UrlExtractParameterFunction::signatures(),
+    std::make_unique<UrlExtractParameterFunction>());
+
 } // namespace facebook::velox::functions
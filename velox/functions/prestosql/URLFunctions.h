@@ -15,256 +15,40 @@
  */
 #pragma once
 
-#include <boost/regex.hpp>
-#include <cctype>
-#include "velox/functions/Macros.h"
+#include <cstdint>
+#include <optional>
+#include <string_view>
 
 namespace facebook::velox::functions {
 
-namespace {
-FOLLY_ALWAYS_INLINE StringView submatch(const boost::cmatch& match, int idx) {
-  const auto& sub = match[idx];
-  return StringView(sub.first, sub.length());
-}
-
-template <typename TInString>
-bool parse(const TInString& rawUrl, boost::cmatch& match) {
-  static const boost::regex kUriRegex(
-      "([a-zA-Z][a-zA-Z0-9+.-]*):" // scheme:
-      "([^?#]*)" // authority and path
-      "(?:\\?([^#]*))?" // ?query
-      "(?:#(.*))?"); // #fragment
-
-  return boost::regex_match(
-      rawUrl.data(), rawUrl.data() + rawUrl.size(), match, kUriRegex);
-}
-
-} // namespace
-
-bool matchAuthorityAndPath(
-    const boost::cmatch& urlMatch,
-    boost::cmatch& authAndPathMatch,
-    boost::cmatch& authorityMatch,
-    bool& hasAuthority);
-
-template <typename T>
-struct UrlExtractProtocolFunction {
-  VELOX_DEFINE_FUNCTION_TYPES(T);
-
-  // Results refer to strings in the first argument.
-  static constexpr int32_t reuse_strings_from_arg = 0;
-
-  // ASCII input always produces ASCII result.
-  static constexpr bool is_default_ascii_behavior = true;
-
-  FOLLY_ALWAYS_INLINE bool call(
-      out_type<Varchar>& result,
-      const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
-      result.setEmpty();
-    } else {
-      result.setNoCopy(submatch(match, 1));
-    }
-    return true;
-  }
-};
-
-template <typename T>
-struct UrlExtractFragmentFunction {
-  VELOX_DEFINE_FUNCTION_TYPES(T);
-
-  // Results refer to strings in the first argument.
-  static constexpr int32_t reuse_strings_from_arg = 0;
-
-  // ASCII input always produces ASCII result.
-  static constexpr bool is_default_ascii_behavior = true;
-
-  FOLLY_ALWAYS_INLINE bool call(
-      out_type<Varchar>& result,
-      const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
-      result.setEmpty();
-    } else {
-      result.setNoCopy(submatch(match, 4));
-    }
-    return true;
-  }
-};
-
-template <typename T>
-struct UrlExtractHostFunction {
-  VELOX_DEFINE_FUNCTION_TYPES(T);
-
-  // Results refer to strings in the first argument.
-  static constexpr int32_t reuse_strings_from_arg = 0;
-
-  // ASCII input always produces ASCII result.
-  static constexpr bool is_default_ascii_behavior = true;
-
-  FOLLY_ALWAYS_INLINE bool call(
-      out_type<Varchar>& result,
-      const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
-      result.setEmpty();
-      return true;
-    }
-    boost::cmatch authAndPathMatch;
-    boost::cmatch authorityMatch;
-    bool hasAuthority;
-
-    if (matchAuthorityAndPath(
-            match, authAndPathMatch, authorityMatch, hasAuthority) &&
-        hasAuthority) {
-      result.setNoCopy(submatch(authorityMatch, 3));
-    } else {
-      result.setEmpty();
-    }
-    return true;
-  }
-};
-
-template <typename T>
-struct UrlExtractPortFunction {
-  VELOX_DEFINE_FUNCTION_TYPES(T);
-
-  FOLLY_ALWAYS_INLINE bool call(int64_t& result, const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
-      return false;
-    }
-
-    boost::cmatch authAndPathMatch;
-    boost::cmatch authorityMatch;
-    bool hasAuthority;
-    if (matchAuthorityAndPath(
-            match, authAndPathMatch, authorityMatch, hasAuthority) &&
-        hasAuthority) {
-      auto port = submatch(authorityMatch, 4);
-      if (!port.empty()) {
-        try {
-          result = to<int64_t>(port);
-          return true;
-        } catch (folly::ConversionError const&) {
-        }
-      }
-    }
-    return false;
-  }
+/// Positions of the components of a URL of the form
+/// scheme:[//[userinfo@]host[:port]]path[?query][#fragment]. The positions
+/// are offsets into the parsed string rather than pointers so that they stay
+/// valid for copies of inlined StringViews. An absent component is empty.
+struct UrlComponents {
+  struct Range {
+    uint32_t begin{0};
+    uint32_t size{0};
+  };
+
+  Range protocol;
+  Range host;
+  Range port;
+  Range path;
+  Range query;
+  Range fragment;
 };
 
-template <typename T>
-struct UrlExtractPathFunction {
-  VELOX_DEFINE_FUNCTION_TYPES(T);
-
-  // Results refer to strings in the first argument.
-  static constexpr int32_t reuse_strings_from_arg = 0;
-
-  // ASCII input always produces ASCII result.
-  static constexpr bool is_default_ascii_behavior = true;
-
-  FOLLY_ALWAYS_INLINE bool call(
-      out_type<Varchar>& result,
-      const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
-      result.setEmpty();
-      return true;
-    }
-
-    boost::cmatch authAndPathMatch;
-    boost::cmatch authorityMatch;
-    bool hasAuthority;
-
-    if (matchAuthorityAndPath(
-            match, authAndPathMatch, authorityMatch, hasAuthority)) {
-      if (hasAuthority) {
-        result.setNoCopy(submatch(authAndPathMatch, 2));
-      } else {
-        result.setNoCopy(submatch(match, 2));
-      }
-    }
-
-    return true;
-  }
-};
-
-template <typename T>
-struct UrlExtractQueryFunction {
-  VELOX_DEFINE_FUNCTION_TYPES(T);
-
-  // Results refer to strings in the first argument.
-  static constexpr int32_t reuse_strings_from_arg = 0;
-
-  // ASCII input always produces ASCII result.
-  static constexpr bool is_default_ascii_behavior = true;
-
-  FOLLY_ALWAYS_INLINE bool call(
-      out_type<Varchar>& result,
-      const arg_type<Varchar>& url) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
-      result.setEmpty();
-      return true;
-    }
-
-    auto query = submatch(match, 3);
-    result.setNoCopy(query);
-    return true;
-  }
-};
-
-template <typename T>
-struct UrlExtractParameterFunction {
-  VELOX_DEFINE_FUNCTION_TYPES(T);
-
-  // Results refer to strings in the first argument.
-  static constexpr int32_t reuse_strings_from_arg = 0;
-
-  // ASCII input always produces ASCII result.
-  static constexpr bool is_default_ascii_behavior = true;
-
-  FOLLY_ALWAYS_INLINE bool call(
-      out_type<Varchar>& result,
-      const arg_type<Varchar>& url,
-      const arg_type<Varchar>& param) {
-    boost::cmatch match;
-    if (!parse(url, match)) {
-      result.setEmpty();
-      return false;
-    }
-
-    auto query = submatch(match, 3);
-    if (!query.empty()) {
-      // Parse query string.
-      static const boost::regex kQueryParamRegex(
-          "(^|&)" // start of query or start of parameter "&"
-          "([^=&]*)=?" // parameter name and "=" if value is expected
-          "([^=&]*)" // parameter value
-          "(?=(&|$))" // forward reference, next should be end of query or
-                      // start of next parameter
-      );
-
-      const boost::cregex_iterator begin(
-          query.data(), query.data() + query.size(), kQueryParamRegex);
-      boost::cregex_iterator end;
-
-      for (auto it = begin; it != end; ++it) {
-        if (it->length(2) != 0) { // key shouldnt be empty.
-          auto key = submatch((*it), 2);
-          if (param.compare(key) == 0) {
-            auto value = submatch((*it), 3);
-            result.setNoCopy(value);
-            return true;
-          }
-        }
-      }
-    }
-
-    return false;
-  }
-};
+/// Splits 'url' into its components in a single pass. Returns false and
+/// leaves all components empty if 'url' does not start with a valid scheme.
+/// If the authority is malformed, host, port and path are left empty.
+bool parseUrl(std::string_view url, UrlComponents& components);
+
+/// Returns the value of the first parameter called 'name' in 'query', a list
+/// of key=value pairs separated by '&'. A key without '=' has an empty value.
+/// Pairs with an empty key or more than one '=' are ignored.
+std::optional<std::string_view> extractUrlParameter(
+    std::string_view query,
+    std::string_view name);
 
 } // namespace facebook::velox::functions
@@ -54,6 +54,19 @@ struct HllAccumulator {
     }
   }
 
+  void append(const uint64_t* hashes, int32_t numHashes) {
+    if (isSparse_) {
+      auto numInserted = sparseHll_.insertHashes(hashes, numHashes);
+      if (numInserted == numHashes) {
+        return;
+      }
+      toDense();
+      hashes += numInserted;
+      numHashes -= numInserted;
+    }
+    denseHll_.insertHashes(hashes, numHashes);
+  }
+
   int64_t cardinality() const {
     return isSparse_ ? sparseHll_.cardinality() : denseHll_.cardinality();
   }
@@ -253,18 +266,22 @@ class ApproxDistinctAggregate : public exec::Aggregate {
     } else {
       decodeArguments(rows, args);
 
+      // Hash the whole batch first, then insert all hashes at once.
+      hashes_.clear();
       rows.applyToSelected([&](auto row) {
         if (decodedValue_.isNullAt(row)) {
           return;
         }
-
-        auto accumulator = value<HllAccumulator>(group);
-        clearNull(group);
-        accumulator->setIndexBitLength(indexBitLength_);
-
-        auto hash = hashOne(decodedValue_.valueAt<T>(row));
-        accumulator->append(hash);
+        hashes_.push_back(hashOne(decodedValue_.valueAt<T>(row)));
       });
+      if (hashes_.empty()) {
+        return;
+      }
+
+      auto accumulator = value<HllAccumulator>(group);
+      clearNull(group);
+      accumulator->setIndexBitLength(indexBitLength_);
+      accumulator->append(hashes_.data(), hashes_.size());
     }
   }
 
@@ -378,6 +395,9 @@ class ApproxDistinctAggregate : public exec::Aggregate {
   DecodedVector decodedValue_;
   DecodedVector decodedMaxStandardError_;
   DecodedVector decodedHll_;
+
+  // Hashes of the input values of a single group batch.
+  std::vector<uint64_t> hashes_;
 };
 
 template <TypeKind kind>
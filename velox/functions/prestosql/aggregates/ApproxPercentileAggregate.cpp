@@ -333,11 +333,13 @@ class ApproxPercentileAggregate : public exec::Aggregate {
             return;
           }
 
+          auto tracker = trackRowSize(groups[row]);
           auto accumulator = initRawAccumulator(groups[row]);
           accumulator->append(decodedValue_.valueAt<T>(row));
         });
       } else {
         rows.applyToSelected([&](auto row) {
+          auto tracker = trackRowSize(groups[row]);
           auto accumulator = initRawAccumulator(groups[row]);
           accumulator->append(decodedValue_.valueAt<T>(row));
         });
@@ -619,8 +621,7 @@ class ApproxPercentileAggregate : public exec::Aggregate {
       if constexpr (kSingleGroup) {
         views.push_back(v);
       } else {
-        auto tracker = trackRowSize(group[row]);
-        accumulator->append(v);
+        groupViews_.emplace_back(group[row], v);
       }
     });
     if constexpr (kSingleGroup) {
@@ -628,7 +629,35 @@ class ApproxPercentileAggregate : public exec::Aggregate {
         auto tracker = trackRowSize(group);
         accumulator->append(views);
       }
+    } else {
+      mergeGroupViews();
+    }
+  }
+
+  // Merges the sketches in 'groupViews_' into their groups. The sketches of
+  // each group are merged in one pass over all of them instead of one merge
+  // per sketch.
+  void mergeGroupViews() {
+    std::sort(
+        groupViews_.begin(),
+        groupViews_.end(),
+        [](const auto& left, const auto& right) {
+          return left.first < right.first;
+        });
+    std::vector<typename KllSketch<T>::View> views;
+    for (size_t begin = 0; begin < groupViews_.size();) {
+      char* group = groupViews_[begin].first;
+      views.clear();
+      auto end = begin;
+      for (; end < groupViews_.size() && groupViews_[end].first == group;
+           ++end) {
+        views.push_back(groupViews_[end].second);
+      }
+      auto tracker = trackRowSize(group);
+      value<KllSketchAccumulator<T>>(group)->append(views);
+      begin = end;
     }
+    groupViews_.clear();
   }
 
   struct Percentiles {
@@ -645,6 +674,9 @@ class ApproxPercentileAggregate : public exec::Aggregate {
   DecodedVector decodedWeight_;
   DecodedVector decodedAccuracy_;
   DecodedVector decodedDigest_;
+
+  // The intermediate sketches of a batch by group, see mergeGroupViews().
+  std::vector<std::pair<char*, typename KllSketch<T>::View>> groupViews_;
 };
 
 bool validPercentileType(const Type& type) {
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/hash/Hash.h>
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/memory/HashStringAllocator.h"
+
+namespace facebook::velox::aggregate {
+
+// A map from fixed-width keys to fixed-width values for per-group aggregate
+// state, e.g. the counts of a histogram. The keys and values are kept densely
+// in insertion order in one allocation from a HashStringAllocator. Maps of up
+// to kMaxLinearSize entries are searched linearly. Larger maps add an open
+// addressing index of entry numbers to the same allocation. The map itself
+// takes 16 bytes in the group row. Keys are compared with ==.
+template <typename K, typename V>
+class CompactHashMap {
+ public:
+  static_assert(std::is_trivially_copyable_v<K>);
+  static_assert(std::is_trivially_copyable_v<V>);
+
+  // Returns the hash number of 'key' to pass to findOrInsert(). Separate from
+  // findOrInsert() so that the hashes of a batch of keys can be computed in
+  // one loop.
+  static uint64_t hash(K key) {
+    return folly::hash::twang_mix64(std::hash<K>{}(key));
+  }
+
+  // Returns the value of 'key'. Adds 'key' with a value of V{} if it is not in
+  // the map. 'hash' is hash(key).
+  V& findOrInsert(K key, uint64_t hash, HashStringAllocator* allocator) {
+    if (!hasIndex(capacity_)) {
+      auto* keys = mutableKeys();
+      for (auto i = 0; i < size_; ++i) {
+        if (keys[i] == key) {
+          return mutableValues()[i];
+        }
+      }
+      if (size_ < capacity_) {
+        return append(key);
+      }
+      grow(allocator);
+      if (!hasIndex(capacity_)) {
+        return append(key);
+      }
+    }
+
+    for (;;) {
+      auto* slots = mutableSlots();
+      const uint64_t mask = numSlots(capacity_) - 1;
+      for (auto slot = hash & mask;; slot = (slot + 1) & mask) {
+        const auto entry = slots[slot];
+        if (entry == kEmptySlot) {
+          if (size_ == capacity_) {
+            break;
+          }
+          slots[slot] = size_;
+          return append(key);
+        }
+        if (keys()[entry] == key) {
+          return mutableValues()[entry];
+        }
+      }
+      grow(allocator);
+    }
+  }
+
+  int32_t size() const {
+    return size_;
+  }
+
+  // The keys in insertion order.
+  const K* keys() const {
+    return reinterpret_cast<const K*>(data_ + keysOffset(capacity_));
+  }
+
+  // The values of keys() in the same order.
+  const V* values() const {
+    return reinterpret_cast<const V*>(data_);
+  }
+
+  void free(HashStringAllocator* allocator) {
+    if (data_ != nullptr) {
+      AlignedStlAllocator<char, 16>(allocator).deallocate(
+          data_, totalBytes(capacity_));
+      data_ = nullptr;
+    }
+    size_ = 0;
+    capacity_ = 0;
+  }
+
+ private:
+  // Maps up to this many entries have no index.
+  static constexpr int32_t kMaxLinearSize = 8;
+  static constexpr int32_t kInitialCapacity = 4;
+  static constexpr int32_t kEmptySlot = -1;
+
+  static bool hasIndex(int32_t capacity) {
+    return capacity > kMaxLinearSize;
+  }
+
+  // The index has twice as many slots as entries, i.e. a load factor of at
+  // most 1/2.
+  static int32_t numSlots(int32_t capacity) {
+    return 2 * capacity;
+  }
+
+  // The layout of 'data_' is the values, the keys and the index.
+  static int64_t keysOffset(int32_t capacity) {
+    return bits::roundUp(capacity * sizeof(V), alignof(K));
+  }
+
+  static int64_t slotsOffset(int32_t capacity) {
+    return bits::roundUp(
+        keysOffset(capacity) + capacity * sizeof(K), alignof(int32_t));
+  }
+
+  static int64_t totalBytes(int32_t capacity) {
+    return slotsOffset(capacity) +
+        (hasIndex(capacity) ? numSlots(capacity) * sizeof(int32_t) : 0);
+  }
+
+  K* mutableKeys() {
+    return reinterpret_cast<K*>(data_ + keysOffset(capacity_));
+  }
+
+  V* mutableValues() {
+    return reinterpret_cast<V*>(data_);
+  }
+
+  int32_t* mutableSlots() {
+    return reinterpret_cast<int32_t*>(data_ + slotsOffset(capacity_));
+  }
+
+  V& append(K key) {
+    mutableKeys()[size_] = key;
+    auto& value = mutableValues()[size_++];
+    value = V{};
+    return value;
+  }
+
+  // Doubles the capacity. Builds the index when the map outgrows
+  // kMaxLinearSize.
+  void grow(HashStringAllocator* allocator) {
+    const auto newCapacity =
+        capacity_ == 0 ? kInitialCapacity : capacity_ * 2;
+    AlignedStlAllocator<char, 16> stlAllocator(allocator);
+    auto* newData = stlAllocator.allocate(totalBytes(newCapacity));
+    if (size_ > 0) {
+      memcpy(newData, data_, size_ * sizeof(V));
+      memcpy(
+          newData + keysOffset(newCapacity),
+          data_ + keysOffset(capacity_),
+          size_ * sizeof(K));
+    }
+    if (data_ != nullptr) {
+      stlAllocator.deallocate(data_, totalBytes(capacity_));
+    }
+    data_ = newData;
+    capacity_ = newCapacity;
+    if (!hasIndex(capacity_)) {
+      return;
+    }
+    auto* slots = mutableSlots();
+    std::fill(slots, slots + numSlots(capacity_), kEmptySlot);
+    const uint64_t mask = numSlots(capacity_) - 1;
+    const auto* keys = this->keys();
+    for (auto i = 0; i < size_; ++i) {
+      auto slot = hash(keys[i]) & mask;
+      while (slots[slot] != kEmptySlot) {
+        slot = (slot + 1) & mask;
+      }
+      slots[slot] = i;
+    }
+  }
+
+  char* data_{nullptr};
+  int32_t size_{0};
+  int32_t capacity_{0};
+};
+
+} // namespace facebook::velox::aggregate
@@ -52,12 +52,17 @@ class CountAggregate : public SimpleNumericAggregate<bool, int64_t, int64_t> {
       char** groups,
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
-      bool /*mayPushdown*/) override {
+      bool mayPushdown) override {
     if (args.empty()) {
       rows.applyToSelected([&](vector_size_t i) { addToGroup(groups[i], 1); });
       return;
     }
 
+    if (mayPushdown && canPushdown(*args[0]) &&
+        BaseAggregate::pushdown<CountHook>(groups, rows, args[0])) {
+      return;
+    }
+
     DecodedVector decoded(*args[0], rows);
     if (decoded.isConstantMapping()) {
       if (!decoded.isNullAt(0)) {
@@ -76,6 +81,42 @@ class CountAggregate : public SimpleNumericAggregate<bool, int64_t, int64_t> {
     }
   }
 
+  void addRawInputDense(
+      char** groups,
+      const uint64_t* groupIds,
+      uint64_t numGroupIds,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args) override {
+    auto* counts = prepareDenseGroups<int64_t>(numGroupIds, 0);
+    auto addRow = [&](vector_size_t i) {
+      const auto id = groupIds[i];
+      denseGroups_[id] = groups[i];
+      ++counts[id];
+    };
+    if (args.empty()) {
+      rows.applyToSelected(addRow);
+    } else {
+      DecodedVector decoded(*args[0], rows);
+      if (decoded.isConstantMapping()) {
+        if (!decoded.isNullAt(0)) {
+          rows.applyToSelected(addRow);
+        }
+      } else if (decoded.mayHaveNulls()) {
+        rows.applyToSelected([&](vector_size_t i) {
+          if (!decoded.isNullAt(i)) {
+            addRow(i);
+          }
+        });
+      } else {
+        rows.applyToSelected(addRow);
+      }
+    }
+    flushDenseGroups<int64_t>(
+        counts, numGroupIds, [](int64_t& result, int64_t count) {
+          result += count;
+        });
+  }
+
   void addIntermediateResults(
       char** groups,
       const SelectivityVector& rows,
@@ -91,12 +132,17 @@ class CountAggregate : public SimpleNumericAggregate<bool, int64_t, int64_t> {
       char* group,
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
-      bool /*mayPushdown*/) override {
+      bool mayPushdown) override {
     if (args.empty()) {
       addToGroup(group, rows.countSelected());
       return;
     }
 
+    if (mayPushdown && canPushdown(*args[0]) &&
+        BaseAggregate::pushdownOneGroup<CountHook>(group, rows, args[0])) {
+      return;
+    }
+
     DecodedVector decoded(*args[0], rows);
     if (decoded.isConstantMapping()) {
       if (!decoded.isNullAt(0)) {
@@ -139,6 +185,28 @@ class CountAggregate : public SimpleNumericAggregate<bool, int64_t, int64_t> {
   }
 
  private:
+  // Returns true if 'arg' is a LazyVector of a type whose readers pass the
+  // non-null values to a ValueHook.
+  static bool canPushdown(const BaseVector& arg) {
+    if (!isLazyNotLoaded(arg)) {
+      return false;
+    }
+    switch (arg.typeKind()) {
+      case TypeKind::BOOLEAN:
+      case TypeKind::TINYINT:
+      case TypeKind::SMALLINT:
+      case TypeKind::INTEGER:
+      case TypeKind::BIGINT:
+      case TypeKind::REAL:
+      case TypeKind::DOUBLE:
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+        return true;
+      default:
+        return false;
+    }
+  }
+
   inline void addToGroup(char* group, int64_t count) {
     *value<int64_t>(group) += count;
   }
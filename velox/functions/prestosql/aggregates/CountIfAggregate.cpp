@@ -14,9 +14,9 @@
  * limitations under the License.
  */
 
-#include "velox/exec/Aggregate.h"
 #include "velox/expression/FunctionSignature.h"
 #include "velox/functions/prestosql/aggregates/AggregateNames.h"
+#include "velox/functions/prestosql/aggregates/SimpleNumericAggregate.h"
 #include "velox/vector/DecodedVector.h"
 #include "velox/vector/FlatVector.h"
 #include "velox/vector/SimpleVector.h"
@@ -25,9 +25,12 @@ namespace facebook::velox::aggregate::prestosql {
 
 namespace {
 
-class CountIfAggregate : public exec::Aggregate {
+class CountIfAggregate
+    : public SimpleNumericAggregate<bool, int64_t, int64_t> {
+  using BaseAggregate = SimpleNumericAggregate<bool, int64_t, int64_t>;
+
  public:
-  explicit CountIfAggregate() : exec::Aggregate(BIGINT()) {}
+  explicit CountIfAggregate() : BaseAggregate(BIGINT()) {}
 
   int32_t accumulatorFixedWidthSize() const override {
     return sizeof(int64_t);
@@ -41,11 +44,6 @@ class CountIfAggregate : public exec::Aggregate {
     }
   }
 
-  void extractAccumulators(char** groups, int32_t numGroups, VectorPtr* result)
-      override {
-    extractValues(groups, numGroups, result);
-  }
-
   void extractValues(char** groups, int32_t numGroups, VectorPtr* result)
       override {
     auto* vector = (*result)->as<FlatVector<int64_t>>();
@@ -62,7 +60,12 @@ class CountIfAggregate : public exec::Aggregate {
       char** groups,
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
-      bool /*mayPushdown*/) override {
+      bool mayPushdown) override {
+    if (mayPushdown && isLazyNotLoaded(*args[0]) &&
+        BaseAggregate::pushdown<CountIfHook>(groups, rows, args[0])) {
+      return;
+    }
+
     DecodedVector decoded(*args[0], rows);
 
     if (decoded.isConstantMapping()) {
@@ -115,7 +118,12 @@ class CountIfAggregate : public exec::Aggregate {
       char* group,
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
-      bool /*mayPushdown*/) override {
+      bool mayPushdown) override {
+    if (mayPushdown && isLazyNotLoaded(*args[0]) &&
+        BaseAggregate::pushdownOneGroup<CountIfHook>(group, rows, args[0])) {
+      return;
+    }
+
     DecodedVector decoded(*args[0], rows);
 
     // Constant mapping - check once and add number of selected rows if true.
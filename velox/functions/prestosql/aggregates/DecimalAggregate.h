@@ -131,13 +131,19 @@ class DecimalAggregate : public exec::Aggregate {
     decodedRaw_.decode(*args[0], rows);
     if (decodedRaw_.isConstantMapping()) {
       if (!decodedRaw_.isNullAt(0)) {
-        const auto numRows = rows.countSelected();
-        int64_t overflow = 0;
-        int128_t totalSum{0};
         auto value = decodedRaw_.valueAt<TInputType>(0);
-        rows.template applyToSelected([&](vector_size_t i) {
-          updateNonNullValue(group, TResultType(value));
-        });
+        if constexpr (kShortInput) {
+          // The product of a 64-bit value and a row count fits in 128 bits.
+          const auto numRows = rows.countSelected();
+          if (numRows > 0) {
+            addToSingleGroup(
+                group, int128_t(value.unscaledValue()) * numRows, numRows);
+          }
+        } else {
+          rows.template applyToSelected([&](vector_size_t i) {
+            updateNonNullValue(group, TResultType(value));
+          });
+        }
       }
     } else if (decodedRaw_.mayHaveNulls()) {
       rows.applyToSelected([&](vector_size_t i) {
@@ -146,6 +152,18 @@ class DecimalAggregate : public exec::Aggregate {
               group, TResultType(decodedRaw_.valueAt<TInputType>(i)));
         }
       });
+    } else if (kShortInput && decodedRaw_.isIdentityMapping()) {
+      // Sums of 64-bit values over a single batch can't overflow 128 bits,
+      // so there is no per-row overflow check. The batch total is checked
+      // once when added to the accumulator.
+      const TInputType* data = decodedRaw_.data<TInputType>();
+      int128_t sum = 0;
+      rows.applyToSelected(
+          [&](vector_size_t i) { sum += data[i].unscaledValue(); });
+      const auto numRows = rows.countSelected();
+      if (numRows > 0) {
+        addToSingleGroup(group, sum, numRows);
+      }
     } else if (!exec::Aggregate::numNulls_ && decodedRaw_.isIdentityMapping()) {
       const TInputType* data = decodedRaw_.data<TInputType>();
       LongDecimalWithOverflowState accumulator;
@@ -330,6 +348,18 @@ class DecimalAggregate : public exec::Aggregate {
   }
 
  private:
+  static constexpr bool kShortInput =
+      std::is_same_v<TInputType, UnscaledShortDecimal>;
+
+  // Adds the 'sum' of 'count' non-null rows to the accumulator of 'group'.
+  void addToSingleGroup(char* group, int128_t sum, int64_t count) {
+    exec::Aggregate::clearNull(group);
+    auto accumulator = decimalAccumulator(group);
+    accumulator->overflow +=
+        DecimalUtil::addWithOverflow(accumulator->sum, sum, accumulator->sum);
+    accumulator->count += count;
+  }
+
   inline LongDecimalWithOverflowState* decimalAccumulator(char* group) {
     return exec::Aggregate::value<LongDecimalWithOverflowState>(group);
   }
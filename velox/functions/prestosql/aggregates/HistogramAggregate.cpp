@@ -13,13 +13,12 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
-#include "folly/container/F14Map.h"
-
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/memory/HashStringAllocator.h"
 #include "velox/exec/Aggregate.h"
 #include "velox/expression/FunctionSignature.h"
 #include "velox/functions/prestosql/aggregates/AggregateNames.h"
+#include "velox/functions/prestosql/aggregates/CompactHashMap.h"
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::aggregate::prestosql {
@@ -27,28 +26,70 @@ namespace facebook::velox::aggregate::prestosql {
 namespace {
 
 template <typename T>
-using ValueMap = folly::F14FastMap<
-    T,
-    int64_t,
-    std::hash<T>,
-    std::equal_to<T>,
-    AlignedStlAllocator<std::pair<const T, int64_t>, 16>>;
+using ValueMap = CompactHashMap<T, int64_t>;
+
+// Computes ValueMap<T>::hash() of the non-null keys at 'rows' of 'keys'. Flat
+// keys without nulls are hashed in a single loop over the whole range of
+// 'rows'.
+template <typename T>
+void hashKeys(
+    const DecodedVector& keys,
+    const SelectivityVector& rows,
+    raw_vector<uint64_t>& hashes) {
+  hashes.resize(rows.end());
+  if constexpr (!std::is_same_v<T, bool>) {
+    if (keys.isIdentityMapping() && !keys.mayHaveNulls()) {
+      const auto* rawKeys = keys.data<T>();
+      for (auto row = rows.begin(); row < rows.end(); ++row) {
+        hashes[row] = ValueMap<T>::hash(rawKeys[row]);
+      }
+      return;
+    }
+  }
+  rows.applyToSelected([&](auto row) {
+    if (!keys.isNullAt(row)) {
+      hashes[row] = ValueMap<T>::hash(keys.valueAt<T>(row));
+    }
+  });
+}
+
+// Computes ValueMap<T>::hash() of all elements of 'mapKeys'.
+template <typename T>
+void hashMapKeys(const FlatVector<T>& mapKeys, raw_vector<uint64_t>& hashes) {
+  const auto size = mapKeys.size();
+  hashes.resize(size);
+  if constexpr (!std::is_same_v<T, bool>) {
+    const auto* rawKeys = mapKeys.rawValues();
+    for (auto i = 0; i < size; ++i) {
+      hashes[i] = ValueMap<T>::hash(rawKeys[i]);
+    }
+  } else {
+    for (auto i = 0; i < size; ++i) {
+      hashes[i] = ValueMap<T>::hash(mapKeys.valueAt(i));
+    }
+  }
+}
 
 // Combines a partial aggregation represented by the key-value pair at row in
-// mapKeys and mapValues into groupMap.
+// mapKeys and mapValues into groupMap. 'keyHashes' are the hashes of
+// 'mapKeys'.
 template <typename T>
 FOLLY_ALWAYS_INLINE void addToFinalAggregation(
     const FlatVector<T>* mapKeys,
     const FlatVector<int64_t>* mapValues,
+    const uint64_t* keyHashes,
     const vector_size_t* indices,
     const vector_size_t* rawSizes,
     const vector_size_t* rawOffsets,
     vector_size_t row,
-    ValueMap<T>* groupMap) {
+    ValueMap<T>* groupMap,
+    HashStringAllocator* allocator) {
   auto size = rawSizes[indices[row]];
   auto offset = rawOffsets[indices[row]];
   for (int i = 0; i < size; ++i) {
-    (*groupMap)[mapKeys->valueAt(offset + i)] += mapValues->valueAt(offset + i);
+    groupMap->findOrInsert(
+        mapKeys->valueAt(offset + i), keyHashes[offset + i], allocator) +=
+        mapValues->valueAt(offset + i);
   }
 }
 
@@ -66,8 +107,7 @@ class HistogramAggregate : public exec::Aggregate {
       char** groups,
       folly::Range<const vector_size_t*> indices) override {
     for (auto index : indices) {
-      new (groups[index] + offset_) ValueMap<T>{
-          AlignedStlAllocator<std::pair<const T, int64_t>, 16>(allocator_)};
+      new (groups[index] + offset_) ValueMap<T>();
     }
   }
 
@@ -97,9 +137,11 @@ class HistogramAggregate : public exec::Aggregate {
         bits::setNull(rawNulls, i, true);
       } else {
         clearNull(rawNulls, i);
-        for (auto it = groupMap->begin(); it != groupMap->end(); ++it) {
-          mapKeys->set(index, it->first);
-          mapValues->set(index, it->second);
+        const auto* keys = groupMap->keys();
+        const auto* counts = groupMap->values();
+        for (auto j = 0; j < mapSize; ++j) {
+          mapKeys->set(index, keys[j]);
+          mapValues->set(index, counts[j]);
 
           ++index;
         }
@@ -119,6 +161,7 @@ class HistogramAggregate : public exec::Aggregate {
       const std::vector<VectorPtr>& args,
       bool /*mayPushdown*/) override {
     decodedKeys_.decode(*args[0], rows);
+    hashKeys<T>(decodedKeys_, rows, hashes_);
 
     rows.applyToSelected([&](auto row) {
       // Nulls among the values being aggregated are ignored.
@@ -126,7 +169,8 @@ class HistogramAggregate : public exec::Aggregate {
         auto group = groups[row];
         auto groupMap = value<ValueMap<T>>(group);
 
-        (*groupMap)[decodedKeys_.valueAt<T>(row)]++;
+        groupMap->findOrInsert(
+            decodedKeys_.valueAt<T>(row), hashes_[row], allocator_)++;
       }
     });
   }
@@ -137,11 +181,13 @@ class HistogramAggregate : public exec::Aggregate {
       const std::vector<VectorPtr>& args,
       bool /* mayPushdown */) override {
     decodedKeys_.decode(*args[0], rows);
+    hashKeys<T>(decodedKeys_, rows, hashes_);
     auto groupMap = value<ValueMap<T>>(group);
     rows.applyToSelected([&](auto row) {
       // Nulls among the values being aggregated are ignored.
       if (!decodedKeys_.isNullAt(row)) {
-        (*groupMap)[decodedKeys_.valueAt<T>(row)]++;
+        groupMap->findOrInsert(
+            decodedKeys_.valueAt<T>(row), hashes_[row], allocator_)++;
       }
     });
   }
@@ -160,6 +206,7 @@ class HistogramAggregate : public exec::Aggregate {
         mapVector->mapValues()->template asUnchecked<FlatVector<int64_t>>();
     VELOX_CHECK_NOT_NULL(mapKeys);
     VELOX_CHECK_NOT_NULL(mapValues);
+    hashMapKeys(*mapKeys, hashes_);
 
     auto rawSizes = mapVector->rawSizes();
     auto rawOffsets = mapVector->rawOffsets();
@@ -169,7 +216,15 @@ class HistogramAggregate : public exec::Aggregate {
         auto groupMap = value<ValueMap<T>>(group);
 
         addToFinalAggregation<T>(
-            mapKeys, mapValues, indices, rawSizes, rawOffsets, row, groupMap);
+            mapKeys,
+            mapValues,
+            hashes_.data(),
+            indices,
+            rawSizes,
+            rawOffsets,
+            row,
+            groupMap,
+            allocator_);
       }
     });
   }
@@ -188,6 +243,7 @@ class HistogramAggregate : public exec::Aggregate {
         mapVector->mapValues()->template asUnchecked<FlatVector<int64_t>>();
     VELOX_CHECK_NOT_NULL(mapKeys);
     VELOX_CHECK_NOT_NULL(mapValues);
+    hashMapKeys(*mapKeys, hashes_);
 
     auto groupMap = value<ValueMap<T>>(group);
 
@@ -196,15 +252,22 @@ class HistogramAggregate : public exec::Aggregate {
     rows.applyToSelected([&](vector_size_t row) {
       if (!decodedIntermediate_.isNullAt(row)) {
         addToFinalAggregation<T>(
-            mapKeys, mapValues, indices, rawSizes, rawOffsets, row, groupMap);
+            mapKeys,
+            mapValues,
+            hashes_.data(),
+            indices,
+            rawSizes,
+            rawOffsets,
+            row,
+            groupMap,
+            allocator_);
       }
     });
   }
 
   void destroy(folly::Range<char**> groups) override {
     for (auto group : groups) {
-      auto groupMap = value<ValueMap<T>>(group);
-      std::destroy_at(groupMap);
+      value<ValueMap<T>>(group)->free(allocator_);
     }
   }
 
@@ -219,6 +282,9 @@ class HistogramAggregate : public exec::Aggregate {
 
   DecodedVector decodedKeys_;
   DecodedVector decodedIntermediate_;
+
+  // Hashes of the keys of the current input batch.
+  raw_vector<uint64_t> hashes_;
 };
 
 bool registerHistogram(const std::string& name) {
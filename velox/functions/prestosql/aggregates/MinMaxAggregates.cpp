@@ -138,9 +138,9 @@ class MaxAggregate : public MinMaxAggregate<T> {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool mayPushdown) override {
-    if (mayPushdown && args[0]->isLazy()) {
-      BaseAggregate::template pushdown<MinMaxHook<T, false>>(
-          groups, rows, args[0]);
+    if (mayPushdown && isLazyNotLoaded(*args[0]) &&
+        BaseAggregate::template pushdown<MinMaxHook<T, false>>(
+            groups, rows, args[0])) {
       return;
     }
     BaseAggregate::template updateGroups<true, T>(
@@ -155,6 +155,30 @@ class MaxAggregate : public MinMaxAggregate<T> {
         mayPushdown);
   }
 
+  void addRawInputDense(
+      char** groups,
+      const uint64_t* groupIds,
+      uint64_t numGroupIds,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args) override {
+    if constexpr (sizeof(T) > sizeof(int64_t)) {
+      addRawInput(groups, rows, args, false);
+    } else {
+      BaseAggregate::template updateDenseGroups<T>(
+          groups,
+          groupIds,
+          numGroupIds,
+          rows,
+          args[0],
+          [](T& result, T value) {
+            if (result < value) {
+              result = value;
+            }
+          },
+          kInitialValue_);
+    }
+  }
+
   void addIntermediateResults(
       char** groups,
       const SelectivityVector& rows,
@@ -218,9 +242,9 @@ class MinAggregate : public MinMaxAggregate<T> {
       const SelectivityVector& rows,
       const std::vector<VectorPtr>& args,
       bool mayPushdown) override {
-    if (mayPushdown && args[0]->isLazy()) {
-      BaseAggregate::template pushdown<MinMaxHook<T, true>>(
-          groups, rows, args[0]);
+    if (mayPushdown && isLazyNotLoaded(*args[0]) &&
+        BaseAggregate::template pushdown<MinMaxHook<T, true>>(
+            groups, rows, args[0])) {
       return;
     }
     BaseAggregate::template updateGroups<true, T>(
@@ -235,6 +259,30 @@ class MinAggregate : public MinMaxAggregate<T> {
         mayPushdown);
   }
 
+  void addRawInputDense(
+      char** groups,
+      const uint64_t* groupIds,
+      uint64_t numGroupIds,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args) override {
+    if constexpr (sizeof(T) > sizeof(int64_t)) {
+      addRawInput(groups, rows, args, false);
+    } else {
+      BaseAggregate::template updateDenseGroups<T>(
+          groups,
+          groupIds,
+          numGroupIds,
+          rows,
+          args[0],
+          [](T& result, T value) {
+            if (result > value) {
+              result = value;
+            }
+          },
+          kInitialValue_);
+    }
+  }
+
   void addIntermediateResults(
       char** groups,
       const SelectivityVector& rows,
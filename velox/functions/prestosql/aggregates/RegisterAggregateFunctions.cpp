@@ -36,6 +36,7 @@ extern void registerMaxSizeForStatsAggregate(const std::string& prefix);
 extern void registerMinMaxAggregates(const std::string& prefix);
 extern void registerMinMaxByAggregates(const std::string& prefix);
 extern void registerSumAggregate(const std::string& prefix);
+extern void registerThetaSketchAggregates(const std::string& prefix);
 extern void registerVarianceAggregates(const std::string& prefix);
 
 void registerAllAggregateFunctions(const std::string& prefix) {
@@ -58,6 +59,7 @@ void registerAllAggregateFunctions(const std::string& prefix) {
   registerMinMaxAggregates(prefix);
   registerMinMaxByAggregates(prefix);
   registerSumAggregate(prefix);
+  registerThetaSketchAggregates(prefix);
   registerVarianceAggregates(prefix);
 }
 
@@ -96,18 +96,20 @@ class SimpleNumericAggregate : public exec::Aggregate {
     DecodedVector decoded(*arg, rows, !mayPushdown);
     auto encoding = decoded.base()->encoding();
     if (encoding == VectorEncoding::Simple::LAZY) {
-      SimpleCallableHook<TValue, TData, UpdateSingleValue> hook(
-          exec::Aggregate::offset_,
-          exec::Aggregate::nullByte_,
-          exec::Aggregate::nullMask_,
-          groups,
-          &this->exec::Aggregate::numNulls_,
-          updateSingleValue);
-
-      auto indices = decoded.indices();
-      decoded.base()->as<const LazyVector>()->load(
-          RowSet(indices, arg->size()), &hook);
-      return;
+      char** hookGroups = groups;
+      RowSet lazyRows;
+      if (preparePushdown(decoded, rows, hookGroups, lazyRows)) {
+        SimpleCallableHook<TValue, TData, UpdateSingleValue> hook(
+            exec::Aggregate::offset_,
+            exec::Aggregate::nullByte_,
+            exec::Aggregate::nullMask_,
+            hookGroups,
+            &this->exec::Aggregate::numNulls_,
+            updateSingleValue);
+        decoded.base()->as<const LazyVector>()->load(lazyRows, &hook);
+        return;
+      }
+      decoded.decode(*arg, rows);
     }
 
     if (decoded.isConstantMapping()) {
@@ -156,8 +158,18 @@ class SimpleNumericAggregate : public exec::Aggregate {
       const VectorPtr& arg,
       UpdateSingle updateSingleValue,
       UpdateDuplicate updateDuplicateValues,
-      bool /*mayPushdown*/,
+      bool mayPushdown,
       TData initialValue) {
+    // Only the readers of numeric and boolean columns are known to pass the
+    // values to a ValueHook.
+    if constexpr (std::is_arithmetic_v<TValue>) {
+      if (mayPushdown && isLazyNotLoaded(*arg) &&
+          pushdownOneGroup<SimpleCallableHook<TValue, TData, UpdateSingle>>(
+              group, rows, arg, updateSingleValue)) {
+        return;
+      }
+    }
+
     DecodedVector decoded(*arg, rows);
 
     // Do row by row if not all rows are selected.
@@ -169,6 +181,16 @@ class SimpleNumericAggregate : public exec::Aggregate {
             rows.countSelected());
         updateNonNullValue<true, TData>(group, initialValue, updateSingleValue);
       }
+    } else if (
+        !decoded.isIdentityMapping() &&
+        updateRuns<TData, TValue>(
+            group,
+            rows,
+            decoded,
+            updateSingleValue,
+            updateDuplicateValues,
+            initialValue)) {
+      return;
     } else if (decoded.mayHaveNulls()) {
       rows.applyToSelected([&](vector_size_t i) {
         if (decoded.isNullAt(i)) {
@@ -191,37 +213,196 @@ class SimpleNumericAggregate : public exec::Aggregate {
     }
   }
 
-  template <typename THook>
+  // Updates 'group' once per run of rows with the same base row in
+  // 'decoded', like the constant case of updateOneGroup(). Returns false
+  // without updating if the runs are too short to be worth it.
+  template <
+      typename TData,
+      typename TValue,
+      typename UpdateSingle,
+      typename UpdateDuplicate>
+  bool updateRuns(
+      char* group,
+      const SelectivityVector& rows,
+      DecodedVector& decoded,
+      UpdateSingle updateSingleValue,
+      UpdateDuplicate updateDuplicateValues,
+      TData initialValue) {
+    // Runs shorter than this on average cost more to find than they save.
+    constexpr vector_size_t kMinAverageRunLength = 4;
+    const auto& runs = decoded.runs(rows);
+    if (runs.size() * kMinAverageRunLength >
+        static_cast<size_t>(rows.countSelected())) {
+      return false;
+    }
+    for (const auto& run : runs) {
+      if (decoded.isNullAt(run.begin)) {
+        continue;
+      }
+      TData value = initialValue;
+      updateDuplicateValues(
+          value, TData(decoded.valueAt<TValue>(run.begin)), run.size);
+      updateNonNullValue<true, TData>(group, value, updateSingleValue);
+    }
+    return true;
+  }
+
+  // Same as updateGroups() for addRawInputDense(). Accumulates the values of
+  // each group in an array indexed by 'groupIds' and then updates each group
+  // row once. 'updateSingleValue' must be commutative and associative and
+  // 'identity' must leave any value it is combined with unchanged, e.g. 0 for
+  // a sum.
+  template <
+      typename TData = TResult,
+      typename TValue = TInput,
+      typename UpdateSingleValue>
+  void updateDenseGroups(
+      char** groups,
+      const uint64_t* groupIds,
+      uint64_t numGroupIds,
+      const SelectivityVector& rows,
+      const VectorPtr& arg,
+      UpdateSingleValue updateSingleValue,
+      TData identity) {
+    DecodedVector decoded(*arg, rows);
+    auto* values = prepareDenseGroups<TData>(numGroupIds, identity);
+    auto update = [&](vector_size_t i, TData value) {
+      const auto id = groupIds[i];
+      denseGroups_[id] = groups[i];
+      updateSingleValue(values[id], value);
+    };
+    if (decoded.isConstantMapping()) {
+      if (decoded.isNullAt(0)) {
+        return;
+      }
+      const TData value(decoded.valueAt<TValue>(0));
+      rows.applyToSelected([&](vector_size_t i) { update(i, value); });
+    } else if (decoded.mayHaveNulls()) {
+      rows.applyToSelected([&](vector_size_t i) {
+        if (!decoded.isNullAt(i)) {
+          update(i, TData(decoded.valueAt<TValue>(i)));
+        }
+      });
+    } else if (decoded.isIdentityMapping() && !std::is_same_v<TValue, bool>) {
+      auto data = decoded.data<TValue>();
+      rows.applyToSelected([&](vector_size_t i) { update(i, TData(data[i])); });
+    } else {
+      rows.applyToSelected([&](vector_size_t i) {
+        update(i, TData(decoded.valueAt<TValue>(i)));
+      });
+    }
+    flushDenseGroups<TData>(values, numGroupIds, updateSingleValue);
+  }
+
+  // Returns an array of 'numGroupIds' values set to 'identity' for
+  // accumulating the input of a batch by dense group id, see
+  // updateDenseGroups(). Clears 'denseGroups_'.
+  template <typename TData>
+  TData* prepareDenseGroups(uint64_t numGroupIds, TData identity) {
+    static_assert(sizeof(TData) <= sizeof(int64_t));
+    denseValues_.resize(numGroupIds);
+    denseGroups_.assign(numGroupIds, nullptr);
+    auto* values = reinterpret_cast<TData*>(denseValues_.data());
+    std::fill(values, values + numGroupIds, identity);
+    return values;
+  }
+
+  // Combines the accumulated 'values' into the group rows recorded in
+  // 'denseGroups_' with 'update'.
+  template <typename TData, typename Update>
   void
-  pushdown(char** groups, const SelectivityVector& rows, const VectorPtr& arg) {
+  flushDenseGroups(const TData* values, uint64_t numGroupIds, Update update) {
+    for (auto id = 0; id < numGroupIds; ++id) {
+      if (denseGroups_[id] != nullptr) {
+        updateNonNullValue<true, TData>(denseGroups_[id], values[id], update);
+      }
+    }
+  }
+
+  // The group row of each dense group id that got input in the current batch
+  // of addRawInputDense(), nullptr for the other ids.
+  std::vector<char*> denseGroups_;
+
+  // Pushes down the aggregation into the LazyVector 'arg', possibly wrapped
+  // in dictionaries, without loading it. Returns false if this is not
+  // possible, see preparePushdown(). The caller must then aggregate the
+  // loaded values of 'arg'. 'hookArgs' are passed to the constructor of
+  // THook after the standard AggregationHook arguments.
+  template <typename THook, typename... THookArgs>
+  bool pushdown(
+      char** groups,
+      const SelectivityVector& rows,
+      const VectorPtr& arg,
+      THookArgs... hookArgs) {
     DecodedVector decoded(*arg, rows, false);
-    const vector_size_t* indices = decoded.indices();
+    RowSet lazyRows;
+    if (!preparePushdown(decoded, rows, groups, lazyRows)) {
+      return false;
+    }
     THook hook(
         exec::Aggregate::offset_,
         exec::Aggregate::nullByte_,
         exec::Aggregate::nullMask_,
         groups,
-        &this->exec::Aggregate::numNulls_);
-    // The decoded vector does not really keep the info from the 'rows', except
-    // for the 'upper bound' of it. In case not all rows are selected we need to
-    // generate proper indices, which we 'indirect' through the ones we got from
-    // the decoded vector.
-    vector_size_t numIndices{arg->size()};
-    if (not rows.isAllSelected()) {
-      const auto numSelected = rows.countSelected();
-      if (numSelected != arg->size()) {
-        pushdownCustomIndices_.resize(numSelected);
-        vector_size_t tgtIndex{0};
-        rows.template applyToSelected([&](vector_size_t i) {
-          pushdownCustomIndices_[tgtIndex++] = indices[i];
-        });
-        indices = pushdownCustomIndices_.data();
-        numIndices = numSelected;
+        &this->exec::Aggregate::numNulls_,
+        hookArgs...);
+    decoded.base()->as<const LazyVector>()->load(lazyRows, &hook);
+    return true;
+  }
+
+  // Same as pushdown() for aggregating all selected 'rows' into 'group'.
+  template <typename THook, typename... THookArgs>
+  bool pushdownOneGroup(
+      char* group,
+      const SelectivityVector& rows,
+      const VectorPtr& arg,
+      THookArgs... hookArgs) {
+    oneGroupPushdownGroups_.assign(rows.end(), group);
+    return pushdown<THook>(
+        oneGroupPushdownGroups_.data(), rows, arg, hookArgs...);
+  }
+
+  // Sets 'lazyRows' to the rows of the LazyVector at the base of 'decoded'
+  // that the selected 'rows' refer to. The ValueHook is called with the
+  // positions in 'lazyRows', so 'groups' is set to the groups of the selected
+  // 'rows' in the same order. Returns false if the wrappers of the LazyVector
+  // add nulls or do not refer to strictly increasing rows of it, e.g. when a
+  // join repeats a probe row once per match.
+  bool preparePushdown(
+      const DecodedVector& decoded,
+      const SelectivityVector& rows,
+      char**& groups,
+      RowSet& lazyRows) {
+    if (decoded.isConstantMapping() || decoded.mayHaveNulls()) {
+      return false;
+    }
+    const vector_size_t* indices = decoded.indices();
+    vector_size_t numIndices = rows.size();
+    // The decoded vector does not really keep the info from the 'rows',
+    // except for the 'upper bound' of it. In case not all rows are selected
+    // we need to generate proper indices, which we 'indirect' through the ones
+    // we got from the decoded vector.
+    if (!rows.isAllSelected()) {
+      numIndices = rows.countSelected();
+      pushdownCustomIndices_.resize(numIndices);
+      pushdownCustomGroups_.resize(numIndices);
+      vector_size_t tgtIndex{0};
+      rows.applyToSelected([&](vector_size_t i) {
+        pushdownCustomIndices_[tgtIndex] = indices[i];
+        pushdownCustomGroups_[tgtIndex++] = groups[i];
+      });
+      indices = pushdownCustomIndices_.data();
+      groups = pushdownCustomGroups_.data();
+    }
+    if (!decoded.isIdentityMapping()) {
+      for (auto i = 1; i < numIndices; ++i) {
+        if (indices[i] <= indices[i - 1]) {
+          return false;
+        }
       }
     }
-
-    decoded.base()->as<const LazyVector>()->load(
-        RowSet(indices, numIndices), &hook);
+    lazyRows = RowSet(indices, numIndices);
+    return true;
   }
 
  private:
@@ -238,6 +419,12 @@ class SimpleNumericAggregate : public exec::Aggregate {
     }
     updateValue(*exec::Aggregate::value<TDataType>(group), value);
   }
+
+  // The group of each row for pushdownOneGroup(). All elements are the same.
+  std::vector<char*> oneGroupPushdownGroups_;
+
+  // Backs the per group values of prepareDenseGroups().
+  std::vector<int64_t> denseValues_;
 };
 
 } // namespace facebook::velox::aggregate
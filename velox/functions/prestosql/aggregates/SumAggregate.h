@@ -75,6 +75,26 @@ class SumAggregate
     updateInternal<TAccumulator>(groups, rows, args, mayPushdown);
   }
 
+  void addRawInputDense(
+      char** groups,
+      const uint64_t* groupIds,
+      uint64_t numGroupIds,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args) override {
+    if constexpr (sizeof(TAccumulator) > sizeof(int64_t)) {
+      addRawInput(groups, rows, args, false);
+    } else {
+      BaseAggregate::template updateDenseGroups<TAccumulator>(
+          groups,
+          groupIds,
+          numGroupIds,
+          rows,
+          args[0],
+          &updateSingleValue<TAccumulator>,
+          TAccumulator(0));
+    }
+  }
+
   void addIntermediateResults(
       char** groups,
       const SelectivityVector& rows,
@@ -127,9 +147,9 @@ class SumAggregate
       bool mayPushdown) {
     const auto& arg = args[0];
 
-    if (mayPushdown && arg->isLazy()) {
-      BaseAggregate::template pushdown<SumHook<TValue, TData>>(
-          groups, rows, arg);
+    if (mayPushdown && isLazyNotLoaded(*arg) &&
+        BaseAggregate::template pushdown<SumHook<TValue, TData>>(
+            groups, rows, arg)) {
       return;
     }
 
@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
+#include "velox/common/memory/HashStringAllocator.h"
+#include "velox/exec/Aggregate.h"
+#include "velox/expression/FunctionSignature.h"
+#include "velox/functions/lib/ThetaSketch.h"
+#include "velox/functions/prestosql/aggregates/AggregateNames.h"
+#include "velox/vector/DecodedVector.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::aggregate::prestosql {
+
+namespace {
+
+using ThetaSketch = functions::theta::ThetaSketch<StlAllocator<uint64_t>>;
+
+struct ThetaSketchAccumulator {
+  explicit ThetaSketchAccumulator(HashStringAllocator* allocator)
+      : sketch{functions::theta::kDefaultK, StlAllocator<uint64_t>(allocator)} {
+  }
+
+  ThetaSketch sketch;
+};
+
+template <typename T>
+inline uint64_t hashOne(T value) {
+  return XXH64(&value, sizeof(T), 0);
+}
+
+template <>
+inline uint64_t hashOne<StringView>(StringView value) {
+  return XXH64(value.data(), value.size(), 0);
+}
+
+/// Builds theta sketches from values (theta_sketch_agg), or computes the union
+/// (theta_union) or the intersection (theta_intersect) of theta sketches. The
+/// intermediate and final results are serialized sketches. Groups without
+/// non-null input produce null.
+template <typename T>
+class ThetaSketchAggregate : public exec::Aggregate {
+ public:
+  ThetaSketchAggregate(
+      const TypePtr& resultType,
+      bool sketchAsRawInput,
+      bool intersect)
+      : exec::Aggregate(resultType),
+        sketchAsRawInput_{sketchAsRawInput},
+        intersect_{intersect} {}
+
+  int32_t accumulatorFixedWidthSize() const override {
+    return sizeof(ThetaSketchAccumulator);
+  }
+
+  bool isFixedSize() const override {
+    return false;
+  }
+
+  void initializeNewGroups(
+      char** groups,
+      folly::Range<const vector_size_t*> indices) override {
+    setAllNulls(groups, indices);
+    for (auto i : indices) {
+      new (groups[i] + offset_) ThetaSketchAccumulator(allocator_);
+    }
+  }
+
+  void destroy(folly::Range<char**> groups) override {
+    for (auto group : groups) {
+      std::destroy_at(value<ThetaSketchAccumulator>(group));
+    }
+  }
+
+  void extractValues(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    extractAccumulators(groups, numGroups, result);
+  }
+
+  void extractAccumulators(char** groups, int32_t numGroups, VectorPtr* result)
+      override {
+    VELOX_CHECK(result);
+    auto flatResult = (*result)->asFlatVector<StringView>();
+    VELOX_CHECK(flatResult);
+    flatResult->resize(numGroups);
+
+    for (auto i = 0; i < numGroups; ++i) {
+      char* group = groups[i];
+      if (isNull(group)) {
+        flatResult->setNull(i, true);
+        continue;
+      }
+      flatResult->setNull(i, false);
+
+      auto& sketch = value<ThetaSketchAccumulator>(group)->sketch;
+      sketch.compact();
+      auto size = sketch.serializedByteSize();
+      Buffer* buffer = flatResult->getBufferWithSpace(size);
+      char* ptr = buffer->asMutable<char>() + buffer->size();
+      sketch.serialize(ptr);
+      buffer->setSize(buffer->size() + size);
+      flatResult->setNoCopy(i, StringView(ptr, size));
+    }
+  }
+
+  void addRawInput(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    if (sketchAsRawInput_) {
+      addIntermediateResults(groups, rows, args, false /*unused*/);
+      return;
+    }
+
+    decodedValue_.decode(*args[0], rows, true);
+    rows.applyToSelected([&](auto row) {
+      if (decodedValue_.isNullAt(row)) {
+        return;
+      }
+      auto group = groups[row];
+      auto tracker = trackRowSize(group);
+      clearNull(group);
+      value<ThetaSketchAccumulator>(group)->sketch.insertHash(
+          hashOne(decodedValue_.valueAt<T>(row)));
+    });
+  }
+
+  void addIntermediateResults(
+      char** groups,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decodedSketch_.decode(*args[0], rows, true);
+    rows.applyToSelected([&](auto row) {
+      if (decodedSketch_.isNullAt(row)) {
+        return;
+      }
+      auto group = groups[row];
+      auto tracker = trackRowSize(group);
+      mergeSketch(group, decodedSketch_.valueAt<StringView>(row));
+    });
+  }
+
+  void addSingleGroupRawInput(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    if (sketchAsRawInput_) {
+      addSingleGroupIntermediateResults(group, rows, args, false /*unused*/);
+      return;
+    }
+
+    decodedValue_.decode(*args[0], rows, true);
+    auto tracker = trackRowSize(group);
+    auto& sketch = value<ThetaSketchAccumulator>(group)->sketch;
+    rows.applyToSelected([&](auto row) {
+      if (decodedValue_.isNullAt(row)) {
+        return;
+      }
+      clearNull(group);
+      sketch.insertHash(hashOne(decodedValue_.valueAt<T>(row)));
+    });
+  }
+
+  void addSingleGroupIntermediateResults(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args,
+      bool /*mayPushdown*/) override {
+    decodedSketch_.decode(*args[0], rows, true);
+    auto tracker = trackRowSize(group);
+    rows.applyToSelected([&](auto row) {
+      if (decodedSketch_.isNullAt(row)) {
+        return;
+      }
+      mergeSketch(group, decodedSketch_.valueAt<StringView>(row));
+    });
+  }
+
+ private:
+  // Merges the serialized sketch into the sketch of 'group'. The serialized
+  // sketch is read in place.
+  void mergeSketch(char* group, StringView serialized) {
+    auto view = ThetaSketch::view(serialized.data(), serialized.size());
+    auto& sketch = value<ThetaSketchAccumulator>(group)->sketch;
+    if (isNull(group)) {
+      clearNull(group);
+      sketch.assign(view);
+    } else if (intersect_) {
+      sketch.intersect(view);
+    } else {
+      sketch.merge(view);
+    }
+  }
+
+  // Whether the raw input is serialized sketches rather than values.
+  const bool sketchAsRawInput_;
+
+  // Whether to intersect rather than union the sketches.
+  const bool intersect_;
+
+  DecodedVector decodedValue_;
+  DecodedVector decodedSketch_;
+};
+
+template <TypeKind kind>
+std::unique_ptr<exec::Aggregate> createThetaSketchAggregate(
+    const TypePtr& resultType,
+    bool sketchAsRawInput,
+    bool intersect) {
+  using T = typename TypeTraits<kind>::NativeType;
+  return std::make_unique<ThetaSketchAggregate<T>>(
+      resultType, sketchAsRawInput, intersect);
+}
+
+bool registerThetaSketchAggregate(
+    const std::string& name,
+    bool sketchAsRawInput,
+    bool intersect) {
+  std::vector<std::shared_ptr<exec::AggregateFunctionSignature>> signatures;
+  if (sketchAsRawInput) {
+    signatures.push_back(exec::AggregateFunctionSignatureBuilder()
+                             .returnType("varbinary")
+                             .intermediateType("varbinary")
+                             .argumentType("varbinary")
+                             .build());
+  } else {
+    for (const auto& inputType :
+         {"boolean",
+          "tinyint",
+          "smallint",
+          "integer",
+          "bigint",
+          "real",
+          "double",
+          "varchar",
+          "timestamp",
+          "date"}) {
+      signatures.push_back(exec::AggregateFunctionSignatureBuilder()
+                               .returnType("varbinary")
+                               .intermediateType("varbinary")
+                               .argumentType(inputType)
+                               .build());
+    }
+  }
+
+  exec::registerAggregateFunction(
+      name,
+      std::move(signatures),
+      [name, sketchAsRawInput, intersect](
+          core::AggregationNode::Step /*step*/,
+          const std::vector<TypePtr>& argTypes,
+          const TypePtr& resultType) -> std::unique_ptr<exec::Aggregate> {
+        VELOX_CHECK_EQ(argTypes.size(), 1, "{} takes one argument", name);
+        TypePtr type = argTypes[0]->isVarbinary() ? BIGINT() : argTypes[0];
+        return VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+            createThetaSketchAggregate,
+            type->kind(),
+            resultType,
+            sketchAsRawInput,
+            intersect);
+      });
+  return true;
+}
+
+} // namespace
+
+void registerThetaSketchAggregates(const std::string& prefix) {
+  registerThetaSketchAggregate(prefix + kThetaSketchAgg, false, false);
+  registerThetaSketchAggregate(prefix + kThetaUnion, true, false);
+  registerThetaSketchAggregate(prefix + kThetaIntersect, true, true);
+}
+
+} // namespace facebook::velox::aggregate::prestosql
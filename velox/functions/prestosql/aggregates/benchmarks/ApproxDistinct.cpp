@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
+#include "velox/common/hyperloglog/DenseHll.h"
+#include "velox/common/hyperloglog/SparseHll.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::common::hll;
+
+namespace {
+
+constexpr int8_t kIndexBitLength = 11;
+
+std::vector<uint64_t> makeHashes(int32_t numHashes, int32_t seed) {
+  std::vector<uint64_t> hashes(numHashes);
+  for (auto i = 0; i < numHashes; ++i) {
+    auto value = i + seed * numHashes;
+    hashes[i] = XXH64(&value, sizeof(value), 0);
+  }
+  return hashes;
+}
+
+std::shared_ptr<memory::MemoryPool> pool;
+std::unique_ptr<HashStringAllocator> allocator;
+
+void sparseInsertHash(uint32_t iterations, int32_t numHashes) {
+  folly::BenchmarkSuspender suspender;
+  auto hashes = makeHashes(numHashes, 0);
+  suspender.dismiss();
+
+  for (auto i = 0; i < iterations; ++i) {
+    SparseHll hll{allocator.get()};
+    hll.setSoftMemoryLimit(
+        DenseHll::estimateInMemorySize(kIndexBitLength) * 16);
+    for (auto hash : hashes) {
+      hll.insertHash(hash);
+    }
+    folly::doNotOptimizeAway(hll.cardinality());
+  }
+}
+
+void sparseInsertHashes(uint32_t iterations, int32_t numHashes) {
+  folly::BenchmarkSuspender suspender;
+  auto hashes = makeHashes(numHashes, 0);
+  suspender.dismiss();
+
+  for (auto i = 0; i < iterations; ++i) {
+    SparseHll hll{allocator.get()};
+    hll.setSoftMemoryLimit(
+        DenseHll::estimateInMemorySize(kIndexBitLength) * 16);
+    hll.insertHashes(hashes.data(), hashes.size());
+    folly::doNotOptimizeAway(hll.cardinality());
+  }
+}
+
+void denseMerge(uint32_t iterations, int32_t numHashes) {
+  folly::BenchmarkSuspender suspender;
+  DenseHll hll{kIndexBitLength, allocator.get()};
+  hll.insertHashes(makeHashes(numHashes, 0).data(), numHashes);
+  std::vector<std::string> others;
+  for (auto i = 0; i < 100; ++i) {
+    DenseHll other{kIndexBitLength, allocator.get()};
+    other.insertHashes(makeHashes(numHashes, i + 1).data(), numHashes);
+    others.emplace_back(other.serializedSize(), '\0');
+    other.serialize(others.back().data());
+  }
+  suspender.dismiss();
+
+  for (auto i = 0; i < iterations; ++i) {
+    hll.mergeWith(others[i % others.size()].data());
+  }
+  folly::doNotOptimizeAway(hll.cardinality());
+}
+
+BENCHMARK_NAMED_PARAM(sparseInsertHash, 100, 100);
+BENCHMARK_RELATIVE_NAMED_PARAM(sparseInsertHashes, 100, 100);
+BENCHMARK_NAMED_PARAM(sparseInsertHash, 1k, 1'000);
+BENCHMARK_RELATIVE_NAMED_PARAM(sparseInsertHashes, 1k, 1'000);
+BENCHMARK_NAMED_PARAM(sparseInsertHash, 10k, 10'000);
+BENCHMARK_RELATIVE_NAMED_PARAM(sparseInsertHashes, 10k, 10'000);
+BENCHMARK_DRAW_LINE();
+
+// Merges serialized dense HLLs into one, as the final aggregation does.
+BENCHMARK_NAMED_PARAM(denseMerge, 1k, 1'000);
+BENCHMARK_NAMED_PARAM(denseMerge, 100k, 100'000);
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+
+  pool = memory::getDefaultMemoryPool();
+  allocator = std::make_unique<HashStringAllocator>(pool.get());
+  folly::runBenchmarks();
+  allocator.reset();
+  pool.reset();
+  return 0;
+}
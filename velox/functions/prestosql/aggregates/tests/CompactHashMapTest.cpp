@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/functions/prestosql/aggregates/CompactHashMap.h"
+
+#include <folly/Random.h>
+#include <gtest/gtest.h>
+
+#include <unordered_map>
+
+#include "velox/type/Timestamp.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::aggregate;
+
+class CompactHashMapTest : public testing::Test {
+ protected:
+  // Adds 'keys' to 'map' with a count of 1 each and checks the result
+  // against std::unordered_map.
+  template <typename K>
+  void testCounts(const std::vector<K>& keys) {
+    CompactHashMap<K, int64_t> map;
+    std::unordered_map<K, int64_t> expected;
+    std::vector<K> expectedOrder;
+    for (auto key : keys) {
+      ++map.findOrInsert(key, map.hash(key), allocator_.get());
+      if (expected[key]++ == 0) {
+        expectedOrder.push_back(key);
+      }
+    }
+
+    ASSERT_EQ(map.size(), expected.size());
+    for (auto i = 0; i < map.size(); ++i) {
+      // Entries are in insertion order.
+      ASSERT_EQ(map.keys()[i], expectedOrder[i]);
+      ASSERT_EQ(map.values()[i], expected[map.keys()[i]]);
+    }
+    map.free(allocator_.get());
+    ASSERT_EQ(map.size(), 0);
+  }
+
+  std::shared_ptr<memory::MemoryPool> pool_{memory::getDefaultMemoryPool()};
+  std::unique_ptr<HashStringAllocator> allocator_{
+      std::make_unique<HashStringAllocator>(pool_.get())};
+};
+
+TEST_F(CompactHashMapTest, empty) {
+  CompactHashMap<int64_t, int64_t> map;
+  ASSERT_EQ(map.size(), 0);
+  map.free(allocator_.get());
+}
+
+TEST_F(CompactHashMapTest, linear) {
+  // Up to 8 distinct keys stay in the linearly searched arrays.
+  testCounts<int32_t>({1, 2, 1, 3, 3, 3, 4, 5, 6, 7, 8, 1});
+  testCounts<int8_t>({-1, 0, -1, 0, 5});
+}
+
+TEST_F(CompactHashMapTest, indexed) {
+  folly::Random::DefaultGenerator rng;
+  rng.seed(1);
+  for (auto numDistinct : {9, 100, 10'000}) {
+    std::vector<int64_t> keys;
+    for (auto i = 0; i < numDistinct * 5; ++i) {
+      keys.push_back(folly::Random::rand32(numDistinct, rng) * 1'000'000'007L);
+    }
+    testCounts(keys);
+  }
+
+  std::vector<int16_t> shortKeys;
+  for (auto i = 0; i < 100'000; ++i) {
+    shortKeys.push_back(i % 30'000);
+  }
+  testCounts(shortKeys);
+}
+
+TEST_F(CompactHashMapTest, timestamp) {
+  std::vector<Timestamp> keys;
+  for (auto i = 0; i < 1'000; ++i) {
+    keys.push_back(Timestamp(i % 77, (i % 13) * 1'000));
+  }
+  testCounts(keys);
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <limits>
+
+#include "velox/exec/SimpleAggregateAdapter.h"
+#include "velox/functions/prestosql/aggregates/tests/AggregationTestBase.h"
+
+using namespace facebook::velox::exec::test;
+
+namespace facebook::velox::aggregate::test {
+
+namespace {
+
+struct SumFunction {
+  using InputType = int64_t;
+  using IntermediateType = int64_t;
+  using OutputType = int64_t;
+
+  static constexpr bool kNullOnEmpty = true;
+
+  struct Accumulator {
+    int64_t sum{0};
+  };
+
+  static void addInput(Accumulator& accumulator, int64_t value) {
+    accumulator.sum += value;
+  }
+
+  static void combine(Accumulator& accumulator, int64_t other) {
+    accumulator.sum += other;
+  }
+
+  static int64_t toIntermediate(const Accumulator& accumulator) {
+    return accumulator.sum;
+  }
+
+  static int64_t finalize(const Accumulator& accumulator) {
+    return accumulator.sum;
+  }
+};
+
+struct CountIfFunction {
+  using InputType = bool;
+  using IntermediateType = int64_t;
+  using OutputType = int64_t;
+
+  static constexpr bool kNullOnEmpty = false;
+
+  struct Accumulator {
+    int64_t count{0};
+  };
+
+  static void addInput(Accumulator& accumulator, bool value) {
+    accumulator.count += value;
+  }
+
+  static void combine(Accumulator& accumulator, int64_t other) {
+    accumulator.count += other;
+  }
+
+  static int64_t toIntermediate(const Accumulator& accumulator) {
+    return accumulator.count;
+  }
+
+  static int64_t finalize(const Accumulator& accumulator) {
+    return accumulator.count;
+  }
+};
+
+struct MaxFunction {
+  using InputType = double;
+  using IntermediateType = double;
+  using OutputType = double;
+
+  static constexpr bool kNullOnEmpty = true;
+
+  struct Accumulator {
+    double max{-std::numeric_limits<double>::infinity()};
+  };
+
+  static void addInput(Accumulator& accumulator, double value) {
+    accumulator.max = std::max(accumulator.max, value);
+  }
+
+  static void combine(Accumulator& accumulator, double other) {
+    addInput(accumulator, other);
+  }
+
+  static double toIntermediate(const Accumulator& accumulator) {
+    return accumulator.max;
+  }
+
+  static double finalize(const Accumulator& accumulator) {
+    return accumulator.max;
+  }
+};
+
+std::shared_ptr<exec::AggregateFunctionSignature> makeSignature(
+    const std::string& inputType,
+    const std::string& intermediateType,
+    const std::string& outputType) {
+  return exec::AggregateFunctionSignatureBuilder()
+      .returnType(outputType)
+      .intermediateType(intermediateType)
+      .argumentType(inputType)
+      .build();
+}
+
+class SimpleAggregateAdapterTest : public AggregationTestBase {
+ protected:
+  static void SetUpTestCase() {
+    AggregationTestBase::SetUpTestCase();
+    exec::registerSimpleAggregateFunction<SumFunction>(
+        "simple_sum", {makeSignature("bigint", "bigint", "bigint")});
+    exec::registerSimpleAggregateFunction<CountIfFunction>(
+        "simple_count_if", {makeSignature("boolean", "bigint", "bigint")});
+    exec::registerSimpleAggregateFunction<MaxFunction>(
+        "simple_max", {makeSignature("double", "double", "double")});
+  }
+
+  void SetUp() override {
+    AggregationTestBase::SetUp();
+    allowInputShuffle();
+  }
+
+  const RowTypePtr rowType_{
+      ROW({"c0", "c1", "c2", "c3"},
+          {INTEGER(), BIGINT(), BOOLEAN(), DOUBLE()})};
+};
+
+TEST_F(SimpleAggregateAdapterTest, groupBy) {
+  auto vectors = makeVectors(rowType_, 100, 10);
+  createDuckDbTable(vectors);
+
+  testAggregations(
+      vectors,
+      {"c0"},
+      {"simple_sum(c1)", "simple_count_if(c2)", "simple_max(c3)"},
+      "SELECT c0, sum(c1), sum(if(c2, 1, 0)), max(c3) FROM tmp GROUP BY c0");
+}
+
+TEST_F(SimpleAggregateAdapterTest, global) {
+  auto vectors = makeVectors(rowType_, 100, 10);
+  createDuckDbTable(vectors);
+
+  testAggregations(
+      vectors,
+      {},
+      {"simple_sum(c1)", "simple_count_if(c2)", "simple_max(c3)"},
+      "SELECT sum(c1), sum(if(c2, 1, 0)), max(c3) FROM tmp");
+}
+
+TEST_F(SimpleAggregateAdapterTest, constantAndNullInput) {
+  auto vectors = {
+      makeRowVector({
+          makeFlatVector<int32_t>(10, [](auto row) { return row % 3; }),
+          makeConstant<int64_t>(7, 10),
+          makeConstant(true, 10),
+          makeNullConstant(TypeKind::DOUBLE, 10),
+      }),
+      makeRowVector({
+          makeFlatVector<int32_t>(10, [](auto row) { return row % 3; }),
+          makeFlatVector<int64_t>(
+              10, [](auto row) { return row; }, nullEvery(2)),
+          makeFlatVector<bool>(
+              10, [](auto row) { return row % 4 == 0; }, nullEvery(3)),
+          makeNullConstant(TypeKind::DOUBLE, 10),
+      }),
+  };
+  createDuckDbTable(vectors);
+
+  // simple_max(c3) has no non-null input and is null, while
+  // simple_count_if() of a group without true input is 0.
+  testAggregations(
+      vectors,
+      {"c0"},
+      {"simple_sum(c1)", "simple_count_if(c2)", "simple_max(c3)"},
+      "SELECT c0, sum(c1), sum(if(c2, 1, 0)), max(c3) FROM tmp GROUP BY c0");
+  testAggregations(
+      vectors,
+      {},
+      {"simple_sum(c1)", "simple_count_if(c2)", "simple_max(c3)"},
+      "SELECT sum(c1), sum(if(c2, 1, 0)), max(c3) FROM tmp");
+}
+
+} // namespace
+} // namespace facebook::velox::aggregate::test
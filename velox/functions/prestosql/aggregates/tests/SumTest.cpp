@@ -523,6 +523,30 @@ TEST_F(SumTest, nulls) {
       "SELECT c0, sum(c1) as sum_c1 FROM tmp GROUP BY 1");
 }
 
+/// Test global aggregation over dictionaries with long runs of the same value,
+/// which are added once per run.
+TEST_F(SumTest, runs) {
+  vector_size_t size = 10'000;
+
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 5; ++i) {
+    auto base = makeFlatVector<int64_t>(
+        size / 100, [i](auto row) { return i * 1'000 + row; }, nullEvery(7));
+    vectors.push_back(makeRowVector({wrapInDictionary(
+        makeIndices(size, [](auto row) { return row / 100; }),
+        size,
+        base)}));
+  }
+
+  createDuckDbTable(vectors);
+
+  testAggregations(
+      vectors,
+      {},
+      {"sum(c0)", "min(c0)", "max(c0)"},
+      "SELECT sum(c0), min(c0), max(c0) FROM tmp");
+}
+
 template <typename Type>
 struct SumRow {
   char nulls;
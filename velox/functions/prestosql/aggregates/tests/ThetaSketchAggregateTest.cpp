@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/functions/lib/ThetaSketch.h"
+#include "velox/functions/prestosql/aggregates/tests/AggregationTestBase.h"
+
+using namespace facebook::velox::exec::test;
+using facebook::velox::functions::theta::ThetaSketch;
+
+namespace facebook::velox::aggregate::test {
+namespace {
+
+class ThetaSketchAggregateTest : public AggregationTestBase {
+ protected:
+  // Returns a serialized sketch of the BIGINT values in [begin, end).
+  static std::string makeSketch(int64_t begin, int64_t end) {
+    ThetaSketch<> sketch;
+    for (auto i = begin; i < end; ++i) {
+      sketch.insertHash(XXH64(&i, sizeof(i), 0));
+    }
+    sketch.compact();
+    std::string serialized(sketch.serializedByteSize(), '\0');
+    sketch.serialize(serialized.data());
+    return serialized;
+  }
+
+  static ThetaSketch<>::View toView(const std::string& sketch) {
+    return ThetaSketch<>::view(sketch.data(), sketch.size());
+  }
+
+  static double estimate(const std::string& sketch) {
+    return toView(sketch).estimate();
+  }
+
+  static double estimateIntersection(
+      const std::string& left,
+      const std::string& right) {
+    ThetaSketch<> sketch;
+    sketch.assign(toView(left));
+    sketch.intersect(toView(right));
+    return sketch.estimate();
+  }
+
+  VectorPtr makeSketches(const std::vector<std::string>& sketches) {
+    return makeFlatVector<StringView>(
+        sketches.size(),
+        [&](auto row) { return StringView(sketches[row]); },
+        nullptr,
+        VARBINARY());
+  }
+};
+
+TEST_F(ThetaSketchAggregateTest, globalAgg) {
+  std::vector<std::string> strings;
+  for (auto i = 0; i < 300; ++i) {
+    strings.push_back(fmt::format("string value {}", i));
+  }
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(
+          10'000, [](auto row) { return row % 1'000; }, nullEvery(7)),
+      makeFlatVector<StringView>(
+          10'000, [&](auto row) { return StringView(strings[row % 300]); }),
+  });
+
+  testAggregations(
+      {data},
+      {},
+      {"theta_sketch_agg(c0)", "theta_sketch_agg(c1)"},
+      {"theta_estimate(a0)", "theta_estimate(a1)"},
+      {makeRowVector({
+          makeFlatVector<double>(std::vector<double>{1'000}),
+          makeFlatVector<double>(std::vector<double>{300}),
+      })});
+
+  // The estimate of a large set is independent of the order the values are
+  // added and the partial results merged.
+  data = makeRowVector({
+      makeFlatVector<int64_t>(200'000, [](auto row) { return row; }),
+  });
+  testAggregations(
+      {data},
+      {},
+      {"theta_sketch_agg(c0)"},
+      {"theta_estimate(a0)"},
+      {makeRowVector({makeFlatVector<double>(
+          std::vector<double>{estimate(makeSketch(0, 200'000))})})});
+}
+
+TEST_F(ThetaSketchAggregateTest, groupBy) {
+  auto data = makeRowVector({
+      makeFlatVector<int32_t>(10'000, [](auto row) { return row % 3; }),
+      makeFlatVector<int64_t>(
+          10'000, [](auto row) { return row % 3 == 2 ? row % 10 : row; }),
+  });
+
+  testAggregations(
+      {data},
+      {"c0"},
+      {"theta_sketch_agg(c1)"},
+      {"c0", "theta_estimate(a0)"},
+      {makeRowVector({
+          makeFlatVector<int32_t>({0, 1, 2}),
+          makeFlatVector<double>({3'334, 3'333, 10}),
+      })});
+}
+
+TEST_F(ThetaSketchAggregateTest, unionAndIntersect) {
+  std::vector<std::string> sketches = {
+      makeSketch(0, 100'000),
+      makeSketch(50'000, 150'000),
+      makeSketch(0, 1'000),
+      makeSketch(500, 2'500),
+  };
+  auto data = makeRowVector({
+      makeFlatVector<int32_t>({0, 0, 1, 1}),
+      makeSketches(sketches),
+  });
+
+  // The union of the sketches is the sketch of the union of the values. The
+  // union and intersection of the small sketches are exact.
+  testAggregations(
+      {data},
+      {"c0"},
+      {"theta_union(c1)", "theta_intersect(c1)"},
+      {"c0", "theta_estimate(a0)", "theta_estimate(a1)"},
+      {makeRowVector({
+          makeFlatVector<int32_t>({0, 1}),
+          makeFlatVector<double>({estimate(makeSketch(0, 150'000)), 2'500}),
+          makeFlatVector<double>(
+              {estimateIntersection(sketches[0], sketches[1]), 500}),
+      })});
+}
+
+TEST_F(ThetaSketchAggregateTest, nulls) {
+  auto data = makeRowVector({
+      makeFlatVector<int32_t>({0, 0, 1}),
+      makeNullableFlatVector<int64_t>({std::nullopt, std::nullopt, 1}),
+  });
+
+  testAggregations(
+      {data},
+      {"c0"},
+      {"theta_sketch_agg(c1)"},
+      {"c0", "theta_estimate(a0)"},
+      {makeRowVector({
+          makeFlatVector<int32_t>({0, 1}),
+          makeNullableFlatVector<double>({std::nullopt, 1}),
+      })});
+}
+
+TEST_F(ThetaSketchAggregateTest, invalidSketch) {
+  auto data = makeRowVector({makeSketches({"abc"})});
+  auto plan = PlanBuilder()
+                  .values({data})
+                  .singleAggregation({}, {"theta_union(c0)"})
+                  .planNode();
+  VELOX_ASSERT_THROW(
+      AssertQueryBuilder(plan).copyResults(pool()), "Invalid theta sketch");
+}
+
+} // namespace
+} // namespace facebook::velox::aggregate::test
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include "velox/functions/Registerer.h"
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+
+// Compares plus, minus and multiply, which compute flat inputs without nulls
+// with callBatch(), against the same functions computed one row at a time.
+
+namespace {
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::functions;
+
+template <typename T>
+struct PlusRowFunction {
+  template <typename TInput>
+  FOLLY_ALWAYS_INLINE void
+  call(TInput& result, const TInput& a, const TInput& b) {
+    result = a + b;
+  }
+};
+
+template <typename T>
+struct MultiplyRowFunction {
+  template <typename TInput>
+  FOLLY_ALWAYS_INLINE void
+  call(TInput& result, const TInput& a, const TInput& b) {
+    result = a * b;
+  }
+};
+
+class ArithmeticBenchmark : public functions::test::FunctionBenchmarkBase {
+ public:
+  ArithmeticBenchmark() : FunctionBenchmarkBase() {
+    functions::prestosql::registerArithmeticFunctions();
+    registerFunction<PlusRowFunction, double, double, double>({"plus_row"});
+    registerFunction<PlusRowFunction, float, float, float>({"plus_row"});
+    registerFunction<MultiplyRowFunction, double, double, double>(
+        {"multiply_row"});
+
+    const vector_size_t size = 10'000;
+    data_ = vectorMaker_.rowVector({
+        vectorMaker_.flatVector<double>(
+            size, [](auto row) { return row * 0.1; }),
+        vectorMaker_.flatVector<double>(
+            size, [](auto row) { return row % 17 * 0.5; }),
+        vectorMaker_.flatVector<float>(size, [](auto row) { return row; }),
+        vectorMaker_.flatVector<float>(
+            size, [](auto row) { return row % 13; }),
+    });
+  }
+
+  size_t run(const std::string& expression) {
+    folly::BenchmarkSuspender suspender;
+    auto exprSet = compileExpression(expression, asRowType(data_->type()));
+    suspender.dismiss();
+
+    size_t count = 0;
+    for (auto i = 0; i < 100; ++i) {
+      count += evaluate(exprSet, data_)->size();
+    }
+    return count;
+  }
+
+ private:
+  RowVectorPtr data_;
+};
+
+std::unique_ptr<ArithmeticBenchmark> benchmark;
+
+BENCHMARK_MULTI(plusDoubleRow) {
+  return benchmark->run("plus_row(c0, c1)");
+}
+
+BENCHMARK_RELATIVE_MULTI(plusDoubleBatch) {
+  return benchmark->run("plus(c0, c1)");
+}
+
+BENCHMARK_MULTI(plusRealRow) {
+  return benchmark->run("plus_row(c2, c3)");
+}
+
+BENCHMARK_RELATIVE_MULTI(plusRealBatch) {
+  return benchmark->run("plus(c2, c3)");
+}
+
+BENCHMARK_MULTI(multiplyPlusDoubleRow) {
+  return benchmark->run("plus_row(multiply_row(c0, c1), c0)");
+}
+
+BENCHMARK_RELATIVE_MULTI(multiplyPlusDoubleBatch) {
+  return benchmark->run("plus(multiply(c0, c1), c0)");
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  benchmark = std::make_unique<ArithmeticBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
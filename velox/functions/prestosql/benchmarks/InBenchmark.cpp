@@ -116,6 +116,17 @@ BENCHMARK_RELATIVE(in) {
   benchmark.run(10);
 }
 
+// The largest IN list compared lane by lane without probing the filter.
+BENCHMARK(fastIn16) {
+  InBenchmark benchmark;
+  benchmark.runFast(16);
+}
+
+BENCHMARK_RELATIVE(in16) {
+  InBenchmark benchmark;
+  benchmark.run(16);
+}
+
 BENCHMARK(fastIn1K) {
   InBenchmark benchmark;
   benchmark.runFast(1'000);
@@ -126,6 +137,16 @@ BENCHMARK_RELATIVE(in1K) {
   benchmark.run(1'000);
 }
 
+BENCHMARK(fastIn10K) {
+  InBenchmark benchmark;
+  benchmark.runFast(10'000);
+}
+
+BENCHMARK_RELATIVE(in10K) {
+  InBenchmark benchmark;
+  benchmark.run(10'000);
+}
+
 } // namespace
 
 int main(int argc, char** argv) {
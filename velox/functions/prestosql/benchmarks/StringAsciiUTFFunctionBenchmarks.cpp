@@ -114,6 +114,28 @@ class StringAsciiUTFFunctionBenchmark
     doRun(exprSet, rowVector);
   }
 
+  // Runs 'expression' over strings that mix ascii with multi-byte
+  // characters, so that the ascii fast paths only cover part of each string.
+  void runMixed(const std::string& expression) {
+    folly::BenchmarkSuspender suspender;
+
+    VectorFuzzer::Options opts;
+    opts.charEncodings = {
+        UTF8CharList::ASCII,
+        UTF8CharList::UNICODE_CASE_SENSITIVE,
+        UTF8CharList::EXTENDED_UNICODE};
+    opts.stringLength = 200;
+    opts.vectorSize = 10'000;
+    VectorFuzzer fuzzer(opts, execCtx_.pool());
+    auto vector = fuzzer.fuzzFlat(VARCHAR());
+
+    auto rowVector = vectorMaker_.rowVector({vector});
+    auto exprSet = compileExpression(expression, rowVector->type());
+
+    suspender.dismiss();
+    doRun(exprSet, rowVector);
+  }
+
   void doRun(ExprSet& exprSet, const RowVectorPtr& rowVector) {
     uint32_t cnt = 0;
     for (auto i = 0; i < 100; i++) {
@@ -172,6 +194,31 @@ BENCHMARK_RELATIVE(aciiRPad) {
   StringAsciiUTFFunctionBenchmark benchmark;
   benchmark.runLPadRPad("rpad", false);
 }
+
+BENCHMARK(mixedLower) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runMixed("lower(c0)");
+}
+
+BENCHMARK(mixedUpper) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runMixed("upper(c0)");
+}
+
+BENCHMARK(mixedReverse) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runMixed("reverse(c0)");
+}
+
+BENCHMARK(mixedLength) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runMixed("length(c0)");
+}
+
+BENCHMARK(mixedSubStr) {
+  StringAsciiUTFFunctionBenchmark benchmark;
+  benchmark.runMixed("substr(c0, 100, 50)");
+}
 } // namespace
 
 // Preliminary release run, before ascii optimization.
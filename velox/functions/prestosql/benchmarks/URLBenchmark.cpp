@@ -165,6 +165,7 @@ class UrlBenchmark : public functions::test::FunctionBenchmarkBase {
  public:
   UrlBenchmark() : FunctionBenchmarkBase() {
     functions::prestosql::registerURLFunctions();
+    functions::prestosql::registerStringFunctions();
 
     // Register folly based implementations.
     registerFunction<FollyUrlExtractFragmentFunction, Varchar, Varchar>(
@@ -187,6 +188,20 @@ class UrlBenchmark : public functions::test::FunctionBenchmarkBase {
   }
 
   void runUrlExtract(const std::string& fnName, bool isParameter = false) {
+    auto queryString = isParameter ? "{}(c0, c1)" : "{}(c0)";
+    runExpression(fmt::format(fmt::runtime(queryString), fnName));
+  }
+
+  // Extracts the host, path and a parameter of the same URLs in one
+  // expression. 'prefix' selects the folly or the velox implementations.
+  void runUrlExtractMultiple(const std::string& prefix) {
+    runExpression(fmt::format(
+        "concat({0}url_extract_host(c0), {0}url_extract_path(c0), "
+        "coalesce({0}url_extract_parameter(c0, c1), ''))",
+        prefix));
+  }
+
+  void runExpression(const std::string& expression) {
     folly::BenchmarkSuspender suspender;
 
     size_t size = 1000;
@@ -205,13 +220,8 @@ class UrlBenchmark : public functions::test::FunctionBenchmarkBase {
         nullptr);
     auto constVector =
         BaseVector::createConstant(VARCHAR(), "k1", size, pool());
-    auto rowVector = isParameter
-        ? vectorMaker_.rowVector({vectorUrls, constVector})
-        : vectorMaker_.rowVector({vectorUrls});
-
-    auto queryString = isParameter ? "{}(c0, c1)" : "{}(c0)";
-    auto exprSet = compileExpression(
-        fmt::format(fmt::runtime(queryString), fnName), rowVector->type());
+    auto rowVector = vectorMaker_.rowVector({vectorUrls, constVector});
+    auto exprSet = compileExpression(expression, rowVector->type());
 
     suspender.dismiss();
 
@@ -297,6 +307,16 @@ BENCHMARK_RELATIVE(velox_param) {
   benchmark.runUrlExtract("url_extract_parameter", true);
 }
 
+BENCHMARK(folly_multiple) {
+  UrlBenchmark benchmark;
+  benchmark.runUrlExtractMultiple("folly_");
+}
+
+BENCHMARK_RELATIVE(velox_multiple) {
+  UrlBenchmark benchmark;
+  benchmark.runUrlExtractMultiple("");
+}
+
 } // namespace
 
 int main(int argc, char** argv) {
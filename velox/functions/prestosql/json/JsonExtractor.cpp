@@ -32,72 +32,14 @@ namespace {
 
 using JsonVector = std::vector<const folly::dynamic*>;
 
-class JsonExtractor {
- public:
-  // Use this method to get an instance of JsonExtractor given a json path.
-  static JsonExtractor& getInstance(folly::StringPiece path) {
-    // Pre-process
-    auto trimedPath = folly::trimWhitespace(path).str();
-
-    std::shared_ptr<JsonExtractor> op;
-    if (kExtractorCache.count(trimedPath)) {
-      op = kExtractorCache.at(trimedPath);
-    } else {
-      if (kExtractorCache.size() == kMaxCacheNum) {
-        // TODO: Blindly evict the first one, use better policy
-        kExtractorCache.erase(kExtractorCache.begin());
-      }
-      op = std::make_shared<JsonExtractor>(trimedPath);
-      kExtractorCache[trimedPath] = op;
-    }
-    return *op;
-  }
-
-  folly::Optional<folly::dynamic> extract(const folly::dynamic& json);
-
-  // Shouldn't instantiate directly - use getInstance().
-  explicit JsonExtractor(const std::string& path) {
-    if (!tokenize(path)) {
-      VELOX_USER_FAIL("Invalid JSON path: {}", path);
-    }
-  }
-
- private:
-  bool tokenize(const std::string& path) {
-    if (path.empty()) {
-      return false;
-    }
-    if (!kTokenizer.reset(path)) {
-      return false;
-    }
-
-    while (kTokenizer.hasNext()) {
-      if (auto token = kTokenizer.getNext()) {
-        tokens_.push_back(token.value());
-      } else {
-        tokens_.clear();
-        return false;
-      }
-    }
-    return true;
-  }
-
-  // Cache tokenize operations in JsonExtractor across invocations in the same
-  // thread for the same JsonPath.
-  thread_local static std::
-      unordered_map<std::string, std::shared_ptr<JsonExtractor>>
-          kExtractorCache;
-  thread_local static JsonPathTokenizer kTokenizer;
-
-  // Max extractor number in extractor cache
-  static const uint32_t kMaxCacheNum{32};
-
-  std::vector<std::string> tokens_;
-};
-
+// Cache tokenize operations in JsonExtractor across invocations in the same
+// thread for the same JsonPath.
 thread_local std::unordered_map<std::string, std::shared_ptr<JsonExtractor>>
-    JsonExtractor::kExtractorCache;
-thread_local JsonPathTokenizer JsonExtractor::kTokenizer;
+    kExtractorCache;
+thread_local JsonPathTokenizer kTokenizer;
+
+// Max extractor number in extractor cache
+const uint32_t kMaxCacheNum{32};
 
 void extractObject(
     const folly::dynamic* jsonObj,
@@ -129,12 +71,64 @@ void extractArray(
   }
 }
 
-folly::Optional<folly::dynamic> JsonExtractor::extract(
-    const folly::dynamic& json) {
-  JsonVector input;
+bool isScalarType(const folly::dynamic& json) {
+  return !json.isObject() && !json.isArray() && !json.isNull();
+}
+
+} // namespace
+
+// static
+JsonExtractor& JsonExtractor::getInstance(folly::StringPiece path) {
+  // Pre-process
+  auto trimedPath = folly::trimWhitespace(path).str();
+
+  std::shared_ptr<JsonExtractor> op;
+  if (kExtractorCache.count(trimedPath)) {
+    op = kExtractorCache.at(trimedPath);
+  } else {
+    if (kExtractorCache.size() == kMaxCacheNum) {
+      // TODO: Blindly evict the first one, use better policy
+      kExtractorCache.erase(kExtractorCache.begin());
+    }
+    op = std::make_shared<JsonExtractor>(trimedPath);
+    kExtractorCache[trimedPath] = op;
+  }
+  return *op;
+}
+
+JsonExtractor::JsonExtractor(folly::StringPiece path) {
+  auto trimedPath = folly::trimWhitespace(path).str();
+  if (!tokenize(trimedPath)) {
+    VELOX_USER_FAIL("Invalid JSON path: {}", trimedPath);
+  }
+}
+
+bool JsonExtractor::tokenize(const std::string& path) {
+  if (path.empty()) {
+    return false;
+  }
+  if (!kTokenizer.reset(path)) {
+    return false;
+  }
+
+  while (kTokenizer.hasNext()) {
+    if (auto token = kTokenizer.getNext()) {
+      tokens_.push_back(token.value());
+    } else {
+      tokens_.clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+void JsonExtractor::extractPointers(
+    const folly::dynamic& json,
+    std::vector<const folly::dynamic*>& input) const {
   // Temporary extraction result holder, swap with input after
   // each iteration.
   JsonVector result;
+  input.clear();
   input.push_back(&json);
 
   for (auto& token : tokens_) {
@@ -145,12 +139,18 @@ folly::Optional<folly::dynamic> JsonExtractor::extract(
         extractArray(jsonObj, token, result);
       }
     }
+    input.clear();
     if (result.empty()) {
-      return folly::none;
+      return;
     }
-    input.clear();
     result.swap(input);
   }
+}
+
+folly::Optional<folly::dynamic> JsonExtractor::extract(
+    const folly::dynamic& json) const {
+  JsonVector input;
+  extractPointers(json, input);
 
   auto len = input.size();
   if (0 == len) {
@@ -166,31 +166,72 @@ folly::Optional<folly::dynamic> JsonExtractor::extract(
   }
 }
 
-bool isScalarType(const folly::Optional<folly::dynamic>& json) {
-  return json.has_value() && !json->isObject() && !json->isArray() &&
-      !json->isNull();
+folly::Optional<folly::dynamic> JsonExtractor::extract(
+    folly::StringPiece json) const {
+  try {
+    return extract(folly::parseJson(json));
+  } catch (const folly::json::parse_error&) {
+  } catch (const folly::ConversionError&) {
+    // Folly might throw a conversion error while parsing the input json. In
+    // this case, let it return null.
+  }
+  return folly::none;
 }
 
-} // namespace
+folly::Optional<std::string> JsonExtractor::extractScalar(
+    folly::StringPiece json) const {
+  try {
+    auto parsed = folly::parseJson(json);
+    JsonVector input;
+    extractPointers(parsed, input);
+    // Several matches make an array, which is not a scalar.
+    if (input.size() == 1 && isScalarType(*input.front())) {
+      const auto& value = *input.front();
+      if (value.isBool()) {
+        return value.asBool() ? std::string{"true"} : std::string{"false"};
+      } else {
+        return value.asString();
+      }
+    }
+  } catch (const folly::json::parse_error&) {
+  } catch (const folly::ConversionError&) {
+  }
+  return folly::none;
+}
 
-folly::Optional<folly::dynamic> jsonExtract(
-    folly::StringPiece json,
-    folly::StringPiece path) {
+folly::Optional<int64_t> JsonExtractor::extractSize(
+    folly::StringPiece json) const {
   try {
-    // If extractor fails to parse the path, this will throw a VeloxUserError,
-    // and we want to let this exception bubble up to the client. We only catch
-    // json parsing failures (in which cases we return folly::none instead of
-    // throw).
-    auto& extractor = JsonExtractor::getInstance(path);
-    return extractor.extract(folly::parseJson(json));
+    auto parsed = folly::parseJson(json);
+    JsonVector input;
+    extractPointers(parsed, input);
+    if (input.empty()) {
+      return folly::none;
+    }
+    // Several matches make an array with one element per match.
+    if (input.size() > 1) {
+      return input.size();
+    }
+    // The size of the object or array is the number of members, otherwise the
+    // size is zero
+    const auto& value = *input.front();
+    return value.isArray() || value.isObject() ? value.size() : 0;
   } catch (const folly::json::parse_error&) {
   } catch (const folly::ConversionError&) {
-    // Folly might throw a conversion error while parsing the input json. In
-    // this case, let it return null.
   }
   return folly::none;
 }
 
+folly::Optional<folly::dynamic> jsonExtract(
+    folly::StringPiece json,
+    folly::StringPiece path) {
+  // If extractor fails to parse the path, this will throw a VeloxUserError,
+  // and we want to let this exception bubble up to the client. We only catch
+  // json parsing failures (in which cases we return folly::none instead of
+  // throw).
+  return JsonExtractor::getInstance(path).extract(json);
+}
+
 folly::Optional<folly::dynamic> jsonExtract(
     const std::string& json,
     const std::string& path) {
@@ -210,16 +251,7 @@ folly::Optional<folly::dynamic> jsonExtract(
 folly::Optional<std::string> jsonExtractScalar(
     folly::StringPiece json,
     folly::StringPiece path) {
-  auto res = jsonExtract(json, path);
-  // Not a scalar value
-  if (isScalarType(res)) {
-    if (res->isBool()) {
-      return res->asBool() ? std::string{"true"} : std::string{"false"};
-    } else {
-      return res->asString();
-    }
-  }
-  return folly::none;
+  return JsonExtractor::getInstance(path).extractScalar(json);
 }
 
 folly::Optional<std::string> jsonExtractScalar(
@@ -17,12 +17,48 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "folly/Range.h"
 #include "folly/dynamic.h"
 
 namespace facebook::velox::functions {
 
+// Extracts the values a json path refers to from json documents. The path is
+// tokenized once on construction, so a function with a constant path argument
+// can keep one JsonExtractor instead of looking up the path for each row. See
+// jsonExtract() below for the supported paths.
+class JsonExtractor {
+ public:
+  // Returns an extractor for 'path' from a per-thread cache.
+  static JsonExtractor& getInstance(folly::StringPiece path);
+
+  // Throws VeloxUserError if 'path' is not a valid json path.
+  explicit JsonExtractor(folly::StringPiece path);
+
+  folly::Optional<folly::dynamic> extract(const folly::dynamic& json) const;
+
+  // Returns folly::none if 'json' can't be parsed.
+  folly::Optional<folly::dynamic> extract(folly::StringPiece json) const;
+
+  // Returns the value as a string if it is a scalar, folly::none otherwise.
+  folly::Optional<std::string> extractScalar(folly::StringPiece json) const;
+
+  // Returns the number of members of the object or array, 0 for a scalar.
+  folly::Optional<int64_t> extractSize(folly::StringPiece json) const;
+
+ private:
+  bool tokenize(const std::string& path);
+
+  // Sets 'result' to the values in 'json' the path refers to. Unlike
+  // extract(), does not copy the values.
+  void extractPointers(
+      const folly::dynamic& json,
+      std::vector<const folly::dynamic*>& result) const;
+
+  std::vector<std::string> tokens_;
+};
+
 /**
  * Extract a json object from path
  * @param json: A json object
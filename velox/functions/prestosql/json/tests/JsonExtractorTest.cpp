@@ -21,6 +21,7 @@
 #include "velox/common/base/VeloxException.h"
 
 using facebook::velox::VeloxUserError;
+using facebook::velox::functions::JsonExtractor;
 using facebook::velox::functions::jsonExtract;
 using facebook::velox::functions::jsonExtractScalar;
 using folly::json::parse_error;
@@ -501,3 +502,20 @@ TEST(JsonExtractorTest, jsonMultipleExtractsTest) {
   ASSERT_TRUE(extract2.hasValue());
   EXPECT_EQ(jsonExtract(json, "$.store.fruit").value(), extract2.value());
 }
+
+TEST(JsonExtractorTest, reuseExtractor) {
+  JsonExtractor extractor(" $.a[1] ");
+  EXPECT_EQ(extractor.extractScalar(R"({"a": [1, 2]})").value(), "2");
+  EXPECT_EQ(extractor.extractScalar(R"({"a": [true, false]})").value(), "false");
+  EXPECT_FALSE(extractor.extractScalar(R"({"a": [1, [2]]})").hasValue());
+  EXPECT_FALSE(extractor.extractScalar(R"({"a": [1, 2)").hasValue());
+  EXPECT_EQ(extractor.extractSize(R"({"a": [1, [2, 3]]})").value(), 2);
+  EXPECT_EQ(extractor.extractSize(R"({"a": [1, 2]})").value(), 0);
+  EXPECT_FALSE(extractor.extractSize(R"({"a": [1]})").hasValue());
+  EXPECT_EQ(
+      folly::toJson(
+          extractor.extract(folly::StringPiece(R"({"a": [1, {"b": 2}]})"))
+              .value()),
+      R"({"b":2})");
+  EXPECT_THROW(JsonExtractor("$.a."), VeloxUserError);
+}
@@ -15,6 +15,12 @@
  */
 #include <string>
 
+#include "velox/expression/LazyFunctionRegistry.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+#include "velox/functions/prestosql/types/HyperLogLogType.h"
+#include "velox/functions/prestosql/types/JsonType.h"
+#include "velox/functions/prestosql/types/TimestampWithTimeZoneType.h"
+
 namespace facebook::velox::functions {
 
 extern void registerArithmeticFunctions(const std::string& prefix);
@@ -28,6 +34,7 @@ extern void registerHyperLogFunctions(const std::string& prefix);
 extern void registerJsonFunctions(const std::string& prefix);
 extern void registerMapFunctions(const std::string& prefix);
 extern void registerStringFunctions(const std::string& prefix);
+extern void registerThetaSketchFunctions(const std::string& prefix);
 extern void registerURLFunctions(const std::string& prefix);
 extern void registerMapAllowingDuplicates(
     const std::string& name,
@@ -82,6 +89,115 @@ void registerBitwiseFunctions(const std::string& prefix) {
   functions::registerBitwiseFunctions(prefix);
 }
 
+void registerThetaSketchFunctions(const std::string& prefix) {
+  functions::registerThetaSketchFunctions(prefix);
+}
+
+namespace {
+struct FunctionGroup {
+  void (*registrar)(const std::string& prefix);
+
+  // Names of the functions registered by 'registrar', without the prefix.
+  std::vector<const char*> names;
+
+  // Names registered without the prefix, e.g. special form functions.
+  std::vector<const char*> unprefixedNames = {};
+};
+
+// Index of the functions registered by registerAllScalarFunctions, in the
+// same order. Must be kept in sync with the registration functions.
+const std::vector<FunctionGroup>& functionGroups() {
+  static const std::vector<FunctionGroup> kGroups = {
+      {registerArithmeticFunctions,
+       {
+           "abs", "acos", "asin", "atan", "atan2", "cbrt", "ceil", "ceiling",
+           "clamp", "cos", "cosh", "degrees", "divide", "e", "exp", "floor",
+           "from_base", "infinity", "is_finite", "is_infinite", "is_nan", "ln",
+           "log10", "log2", "minus", "mod", "multiply", "nan", "negate", "not",
+           "pi", "plus", "pow", "power", "radians", "rand", "random", "round",
+           "sign", "sin", "sqrt", "tan", "tanh", "to_base", "truncate",
+           "width_bucket",
+       }},
+      {registerCheckedArithmeticFunctions,
+       {
+           "divide", "minus", "mod", "multiply", "negate", "plus",
+       }},
+      {registerComparisonFunctions,
+       {
+           "between", "distinct_from", "eq", "gt", "gte", "lt", "lte", "neq",
+       }},
+      {registerMapFunctions,
+       {
+           "map", "map_concat", "map_entries", "map_filter", "map_keys",
+           "map_values", "map_zip_with", "transform_keys", "transform_values",
+       }},
+      {registerArrayFunctions,
+       {
+           "all_match", "any_match", "array_average", "array_constructor",
+           "array_distinct", "array_duplicates", "array_except",
+           "array_frequency", "array_has_duplicates", "array_intersect",
+           "array_join", "array_max", "array_min", "array_normalize",
+           "array_position", "array_sort", "array_sum", "arrays_overlap",
+           "combinations", "contains", "none_match", "repeat", "shuffle",
+           "slice", "width_bucket", "zip", "zip_with",
+       }},
+      {registerJsonFunctions,
+       {
+           "is_json_scalar", "json_array_contains", "json_array_length",
+           "json_extract_scalar", "json_format", "json_parse", "json_size",
+       }},
+      {registerHyperLogFunctions,
+       {
+           "cardinality", "empty_approx_set",
+       }},
+      {registerGeneralFunctions,
+       {
+           "cardinality", "element_at", "filter", "greatest", "least", "reduce",
+           "subscript", "transform",
+       },
+       {"in", "row_constructor", "is_null"}},
+      {registerDateTimeFunctions,
+       {
+           "date_add", "date_diff", "date_format", "date_parse", "date_trunc",
+           "day", "day_of_month", "day_of_week", "day_of_year", "dow", "doy",
+           "format_datetime", "from_unixtime", "hour", "millisecond", "minus",
+           "minute", "month", "parse_datetime", "plus", "quarter", "second",
+           "to_unixtime", "week", "week_of_year", "year", "year_of_week", "yow",
+       }},
+      {registerURLFunctions,
+       {
+           "url_decode", "url_encode", "url_extract_fragment",
+           "url_extract_host", "url_extract_parameter", "url_extract_path",
+           "url_extract_port", "url_extract_protocol", "url_extract_query",
+       }},
+      {registerStringFunctions,
+       {
+           "chr", "codepoint", "concat", "crc32", "from_base64", "from_hex",
+           "hmac_md5", "hmac_sha1", "hmac_sha256", "hmac_sha512", "length",
+           "like", "lower", "lpad", "ltrim", "md5", "regexp_extract",
+           "regexp_extract_all", "regexp_like", "regexp_replace", "replace",
+           "reverse", "rpad", "rtrim", "sha1", "sha256", "sha512", "split",
+           "split_part", "spooky_hash_v2_32", "spooky_hash_v2_64", "strpos",
+           "strrpos", "substr", "to_base64", "to_base64url", "to_hex",
+           "to_utf8", "trim", "upper", "xxhash64",
+       }},
+      {registerBitwiseFunctions,
+       {
+           "bit_count", "bitwise_and", "bitwise_arithmetic_shift_right",
+           "bitwise_left_shift", "bitwise_logical_shift_right", "bitwise_not",
+           "bitwise_or", "bitwise_right_shift",
+           "bitwise_right_shift_arithmetic", "bitwise_shift_left",
+           "bitwise_xor",
+       }},
+      {registerThetaSketchFunctions,
+       {
+           "theta_estimate",
+       }},
+  };
+  return kGroups;
+}
+} // namespace
+
 void registerAllScalarFunctions(const std::string& prefix) {
   registerArithmeticFunctions(prefix);
   registerCheckedArithmeticFunctions(prefix);
@@ -95,6 +211,27 @@ void registerAllScalarFunctions(const std::string& prefix) {
   registerURLFunctions(prefix);
   registerStringFunctions(prefix);
   registerBitwiseFunctions(prefix);
+  registerThetaSketchFunctions(prefix);
+}
+
+void registerAllScalarFunctionsLazily(const std::string& prefix) {
+  // Types are cheap to register and may be used before any function.
+  registerTimestampWithTimeZoneType();
+  registerHyperLogLogType();
+  registerJsonType();
+
+  for (const auto& group : functionGroups()) {
+    std::vector<std::string> names;
+    names.reserve(group.names.size() + group.unprefixedNames.size());
+    for (const auto* name : group.names) {
+      names.push_back(prefix + name);
+    }
+    for (const auto* name : group.unprefixedNames) {
+      names.push_back(name);
+    }
+    exec::lazyScalarFunctions().add(
+        names, [registrar = group.registrar, prefix]() { registrar(prefix); });
+  }
 }
 
 void registerMapAllowingDuplicates(
@@ -41,8 +41,16 @@ void registerStringFunctions(const std::string& prefix = "");
 
 void registerBitwiseFunctions(const std::string& prefix = "");
 
+void registerThetaSketchFunctions(const std::string& prefix = "");
+
 void registerAllScalarFunctions(const std::string& prefix = "");
 
+/// Same as registerAllScalarFunctions, but defers registering each group of
+/// functions until one of its functions is first resolved. Avoids the startup
+/// cost of building the signatures of all functions in short-lived
+/// processes.
+void registerAllScalarFunctionsLazily(const std::string& prefix = "");
+
 void registerMapAllowingDuplicates(
     const std::string& name,
     const std::string& prefix = "");
@@ -16,25 +16,24 @@
 
 #include "velox/functions/Registerer.h"
 #include "velox/functions/prestosql/StringFunctions.h"
-#include "velox/functions/prestosql/URLFunctions.h"
 
 namespace facebook::velox::functions {
 
 void registerURLFunctions(const std::string& prefix) {
-  registerFunction<UrlExtractHostFunction, Varchar, Varchar>(
-      {prefix + "url_extract_host"});
-  registerFunction<UrlExtractFragmentFunction, Varchar, Varchar>(
-      {prefix + "url_extract_fragment"});
-  registerFunction<UrlExtractPathFunction, Varchar, Varchar>(
-      {prefix + "url_extract_path"});
-  registerFunction<UrlExtractParameterFunction, Varchar, Varchar, Varchar>(
-      {prefix + "url_extract_parameter"});
-  registerFunction<UrlExtractProtocolFunction, Varchar, Varchar>(
-      {prefix + "url_extract_protocol"});
-  registerFunction<UrlExtractPortFunction, int64_t, Varchar>(
-      {prefix + "url_extract_port"});
-  registerFunction<UrlExtractQueryFunction, Varchar, Varchar>(
-      {prefix + "url_extract_query"});
+  VELOX_REGISTER_VECTOR_FUNCTION(
+      udf_url_extract_host, prefix + "url_extract_host");
+  VELOX_REGISTER_VECTOR_FUNCTION(
+      udf_url_extract_fragment, prefix + "url_extract_fragment");
+  VELOX_REGISTER_VECTOR_FUNCTION(
+      udf_url_extract_path, prefix + "url_extract_path");
+  VELOX_REGISTER_VECTOR_FUNCTION(
+      udf_url_extract_parameter, prefix + "url_extract_parameter");
+  VELOX_REGISTER_VECTOR_FUNCTION(
+      udf_url_extract_protocol, prefix + "url_extract_protocol");
+  VELOX_REGISTER_VECTOR_FUNCTION(
+      udf_url_extract_port, prefix + "url_extract_port");
+  VELOX_REGISTER_VECTOR_FUNCTION(
+      udf_url_extract_query, prefix + "url_extract_query");
   registerFunction<UrlEncodeFunction, Varchar, Varchar>(
       {prefix + "url_encode"});
   registerFunction<UrlDecodeFunction, Varchar, Varchar>(
@@ -15,6 +15,7 @@
  */
 
 #include <optional>
+#include <random>
 #include "velox/functions/prestosql/tests/utils/FunctionBaseTest.h"
 
 using namespace facebook::velox;
@@ -306,6 +307,36 @@ TEST_F(ArrayDistinctTest, nonContiguousRows) {
   assertEqualVectors(expected, result);
 }
 
+// Test arrays at and around the size up to which duplicates are found without a
+// hash set.
+TEST_F(ArrayDistinctTest, arraySizes) {
+  std::mt19937 rng(1);
+  std::vector<std::vector<std::optional<int32_t>>> data;
+  std::vector<std::vector<std::optional<int32_t>>> expected;
+  for (auto size = 0; size < 40; ++size) {
+    std::vector<std::optional<int32_t>> array;
+    std::vector<std::optional<int32_t>> distinct;
+    for (auto i = 0; i < size; ++i) {
+      std::optional<int32_t> value;
+      if (rng() % 8 != 0) {
+        value = rng() % (size / 2 + 1);
+      }
+      array.push_back(value);
+      if (std::find(distinct.begin(), distinct.end(), value) ==
+          distinct.end()) {
+        distinct.push_back(value);
+      }
+    }
+    data.push_back(std::move(array));
+    expected.push_back(std::move(distinct));
+  }
+
+  testExpr(
+      makeNullableArrayVector(expected),
+      "array_distinct(c0)",
+      {makeNullableArrayVector(data)});
+}
+
 TEST_F(ArrayDistinctTest, constant) {
   vector_size_t size = 1'000;
   auto data =
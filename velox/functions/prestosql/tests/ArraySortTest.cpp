@@ -17,6 +17,7 @@
 #include "velox/functions/prestosql/tests/utils/FunctionBaseTest.h"
 
 #include <fmt/format.h>
+#include <random>
 
 using namespace facebook::velox;
 using namespace facebook::velox::test;
@@ -81,6 +82,43 @@ class ArraySortTest : public FunctionBaseTest,
     return makeNullableArrayVector<T>(inputVectors);
   }
 
+  // Sorts arrays of every size up to a few times the sorting network size,
+  // with and without nulls.
+  template <typename T>
+  void testArraySizes() {
+    std::mt19937 rng(1);
+    std::vector<std::vector<std::optional<T>>> data;
+    std::vector<std::vector<std::optional<T>>> expected;
+    for (auto withNulls : {false, true}) {
+      for (auto size = 0; size < 70; ++size) {
+        std::vector<std::optional<T>> array;
+        std::vector<T> values;
+        vector_size_t numNulls = 0;
+        for (auto i = 0; i < size; ++i) {
+          if (withNulls && rng() % 4 == 0) {
+            array.push_back(std::nullopt);
+            ++numNulls;
+          } else {
+            // Include the largest value the network pads with.
+            const T value = rng() % 8 == 0
+                ? std::numeric_limits<T>::max()
+                : static_cast<T>(static_cast<int32_t>(rng() % 100) - 50);
+            array.push_back(value);
+            values.push_back(value);
+          }
+        }
+        std::sort(values.begin(), values.end());
+        std::vector<std::optional<T>> sorted(values.begin(), values.end());
+        sorted.resize(sorted.size() + numNulls, std::nullopt);
+        data.push_back(std::move(array));
+        expected.push_back(std::move(sorted));
+      }
+    }
+    auto result = evaluate(
+        "array_sort(c0)", makeRowVector({makeNullableArrayVector(data)}));
+    assertEqualVectors(makeNullableArrayVector(expected), result);
+  }
+
   MapVectorPtr buildMapVector() {
     return makeMapVector<int32_t, int32_t>(
         numValues_,
@@ -401,6 +439,14 @@ TEST_F(ArraySortTest, constant) {
   assertEqualVectors(expected, result);
 }
 
+TEST_F(ArraySortTest, arraySizes) {
+  testArraySizes<int8_t>();
+  testArraySizes<int16_t>();
+  testArraySizes<int32_t>();
+  testArraySizes<int64_t>();
+  testArraySizes<double>();
+}
+
 TEST_F(ArraySortTest, dictionaryEncodedElements) {
   auto elementVector = makeNullableFlatVector<int64_t>({3, 1, 2, 4, 5});
   auto dictionaryVector = BaseVector::wrapInDictionary(
@@ -285,6 +285,40 @@ TEST_F(DecimalArithmeticTest, multiply) {
       "Decimal overflow: 11963051962064242856134263542523101183 * 10");
 }
 
+TEST_F(DecimalArithmeticTest, shortDecimalBatch) {
+  // Short results from short arguments with different scales.
+  auto a = makeShortDecimalFlatVector({1, -2, 30}, DECIMAL(10, 1));
+  auto b = makeShortDecimalFlatVector({1000, 2, -3}, DECIMAL(10, 3));
+  testDecimalExpr<TypeKind::SHORT_DECIMAL>(
+      makeShortDecimalFlatVector({1100, -198, 2997}, DECIMAL(12, 3)),
+      "c0 + c1",
+      {a, b});
+  testDecimalExpr<TypeKind::SHORT_DECIMAL>(
+      makeShortDecimalFlatVector({-900, -202, 3003}, DECIMAL(12, 3)),
+      "c0 - c1",
+      {a, b});
+  testDecimalExpr<TypeKind::SHORT_DECIMAL>(
+      makeShortDecimalFlatVector({1000, -4, -90}, DECIMAL(12, 4)),
+      "c0 * c1",
+      {makeShortDecimalFlatVector({1, -2, 30}, DECIMAL(6, 1)),
+       makeShortDecimalFlatVector({1000, 2, -3}, DECIMAL(6, 3))});
+
+  // An overflow in one row makes the batch fall back to per-row evaluation,
+  // which reports the error for that row only.
+  auto limits = makeShortDecimalFlatVector(
+      {1, UnscaledShortDecimal::max().unscaledValue(), 2}, DECIMAL(17, 0));
+  auto ones = makeShortDecimalFlatVector({1, 1, 1}, DECIMAL(17, 0));
+  VELOX_ASSERT_THROW(
+      evaluate<SimpleVector<UnscaledShortDecimal>>(
+          "c0 + c1", makeRowVector({limits, ones})),
+      "Decimal overflow: 999999999999999999 + 1");
+  auto result = evaluate<SimpleVector<UnscaledShortDecimal>>(
+      "try(c0 + c1)", makeRowVector({limits, ones}));
+  assertEqualVectors(
+      makeNullableShortDecimalFlatVector({2, std::nullopt, 3}, DECIMAL(18, 0)),
+      result);
+}
+
 TEST_F(DecimalArithmeticTest, decimalDivTest) {
   auto shortFlat = makeShortDecimalFlatVector({1000, 2000}, DECIMAL(17, 3));
   // Divide short and short, returning long.
@@ -773,3 +773,69 @@ TEST_F(ElementAtTest, errorStatesArray) {
       expectedValueAt,
       [](auto row) { return row == 40; });
 }
+
+// Maps with enough keys to be searched through a key index, or with sorted
+// keys through binary search.
+TEST_F(ElementAtTest, wideMaps) {
+  constexpr vector_size_t kMapSize = 200;
+  constexpr vector_size_t kNumMaps = 100;
+  auto sizeAt = [](vector_size_t /* row */) { return kMapSize; };
+  auto valueAt = [](vector_size_t idx) { return idx; };
+
+  // Keys in descending order: 597, 594,... 0.
+  auto mapVector = makeMapVector<int64_t, int64_t>(
+      kNumMaps,
+      sizeAt,
+      [](vector_size_t idx) { return (kMapSize - 1 - idx % kMapSize) * 3; },
+      valueAt);
+
+  // The subscripts share the index of the map keys.
+  testElementAt<int64_t>(
+      "C0[0] + C0[30] + element_at(C0, 597)",
+      {mapVector},
+      [](vector_size_t row) { return row * kMapSize * 3 + 199 + 189 + 0; });
+  testElementAt<int64_t>(
+      "C0[3] + element_at(C0, 1)",
+      {mapVector},
+      [](vector_size_t /* row */) { return 0; },
+      [](vector_size_t /* row */) { return true; });
+
+  // Many rows probe the same maps with variable keys.
+  auto dictionaryMap = wrapInDictionary(
+      makeIndices(kVectorSize, [](auto row) { return row % 10; }),
+      kVectorSize,
+      mapVector);
+  auto keys = makeFlatVector<int64_t>(
+      kVectorSize, [](vector_size_t row) { return (row % kMapSize) * 3; });
+  testElementAt<int64_t>(
+      "element_at(C0, C1)", {dictionaryMap, keys}, [](vector_size_t row) {
+        return (row % 10) * kMapSize + kMapSize - 1 - row % kMapSize;
+      });
+
+  // Keys in ascending order: 0, 3,... 597.
+  auto sortedMap = makeMapVector<int64_t, int64_t>(
+      kNumMaps,
+      sizeAt,
+      [](vector_size_t idx) { return (idx % kMapSize) * 3; },
+      valueAt);
+  sortedMap = std::make_shared<MapVector>(
+      pool(),
+      sortedMap->type(),
+      nullptr,
+      kNumMaps,
+      sortedMap->offsets(),
+      sortedMap->sizes(),
+      sortedMap->mapKeys(),
+      sortedMap->mapValues(),
+      0,
+      /*sortedKeys=*/true);
+  testElementAt<int64_t>(
+      "C0[30] + C0[597]", {sortedMap}, [](vector_size_t row) {
+        return row * kMapSize * 2 + 10 + 199;
+      });
+  testElementAt<int64_t>(
+      "C0[31]",
+      {sortedMap},
+      [](vector_size_t /* row */) { return 0; },
+      [](vector_size_t /* row */) { return true; });
+}
@@ -166,21 +166,65 @@ class InPredicateTest : public FunctionBaseTest {
     result = evaluate<SimpleVector<bool>>("c1 IN (1, 3, 5)", rowVector);
     assertEqualVectors(constNull, result);
   }
+
+  // Tests IN lists of 'numValues' values over batches of rows, with all and
+  // with some of the rows selected.
+  template <typename T>
+  void testIntegerLists(int32_t numValues) {
+    const vector_size_t size = 1'000;
+    auto rowVector = makeRowVector(
+        {makeFlatVector<T>(size, [](auto row) { return row % 200; })});
+
+    std::ostringstream inList;
+    inList << "0";
+    for (auto i = 1; i < numValues; ++i) {
+      inList << ", " << i * 3;
+    }
+    const auto sql = fmt::format("c0 IN ({})", inList.str());
+    auto isIn = [&](auto row) {
+      return (row % 200) % 3 == 0 && (row % 200) / 3 < numValues;
+    };
+
+    auto result = evaluate<SimpleVector<bool>>(sql, rowVector);
+    assertEqualVectors(makeFlatVector<bool>(size, isIn), result);
+
+    // The rows that are not selected keep their values.
+    SelectivityVector rows(size);
+    rows.setValidRange(0, 10, false);
+    rows.setValidRange(990, size, false);
+    for (auto i = 0; i < size; i += 5) {
+      rows.setValid(i, false);
+    }
+    rows.updateBounds();
+    VectorPtr partialResult =
+        makeFlatVector<bool>(size, [](auto /*row*/) { return true; });
+    evaluate<SimpleVector<bool>>(sql, rowVector, rows, partialResult);
+    assertEqualVectors(
+        makeFlatVector<bool>(
+            size, [&](auto row) { return !rows.isValid(row) || isIn(row); }),
+        partialResult);
+  }
 };
 
 TEST_F(InPredicateTest, bigint) {
   testIntegers<int64_t>();
   testsIntegerConstant<int64_t>();
+  testIntegerLists<int64_t>(16);
+  testIntegerLists<int64_t>(50);
 }
 
 TEST_F(InPredicateTest, integer) {
   testIntegers<int32_t>();
   testsIntegerConstant<int32_t>();
+  testIntegerLists<int32_t>(16);
+  testIntegerLists<int32_t>(50);
 }
 
 TEST_F(InPredicateTest, smallint) {
   testIntegers<int16_t>();
   testsIntegerConstant<int16_t>();
+  testIntegerLists<int16_t>(16);
+  testIntegerLists<int16_t>(50);
 }
 
 TEST_F(InPredicateTest, tinyint) {
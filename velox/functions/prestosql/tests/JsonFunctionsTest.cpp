@@ -432,6 +432,20 @@ TEST_F(JsonFunctionsTest, jsonSize) {
       jsonSize(
           R"({"k1":{"k2": 999, "k3": [{"k4": [1, 2, 3]}]}})", "$.k1.k3[0].k4"),
       3);
+  // Several matches make an array.
+  EXPECT_EQ(jsonSize(R"({"k1": [[1, 2], [3]]})", "$.k1[*]"), 2);
+
+  // Constant path.
+  EXPECT_EQ(
+      evaluateOnce<int64_t>(
+          "json_size(c0, '$.k1')",
+          makeRowVector({makeJsonVector(R"({"k1": [1, 2, 3]})")})),
+      3);
+  VELOX_ASSERT_THROW(
+      evaluateOnce<int64_t>(
+          "json_size(c0, '$.k1.')",
+          makeRowVector({makeJsonVector(R"({"k1": [1, 2, 3]})")})),
+      "Invalid JSON path");
 }
 
 TEST_F(JsonFunctionsTest, invalidPath) {
@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/functions/prestosql/tests/utils/FunctionBaseTest.h"
 
 using namespace facebook::velox;
@@ -180,3 +181,51 @@ TEST_F(ReduceTest, try) {
       makeNullableFlatVector<int64_t>({std::nullopt, std::nullopt, 0});
   assertEqualVectors(expectedResult, result);
 }
+
+// Input functions with arithmetic bodies over non-null elements run one
+// element at a time without vectors. Other bodies and inputs fall back to
+// expression evaluation.
+TEST_F(ReduceTest, scalarLambda) {
+  vector_size_t size = 1'000;
+  auto inputArray = makeArrayVector<double>(
+      size,
+      modN(7),
+      [](auto row, auto index) { return row * 0.5 + index; },
+      nullEvery(13));
+  auto input = makeRowVector({inputArray});
+
+  auto result = evaluate<SimpleVector<double>>(
+      "reduce(c0, 1.0, (s, x) -> s * 0.5 + x * 2.0 - 1.0, s -> s)", input);
+  auto expectedResult = makeFlatVector<double>(
+      size,
+      [](auto row) {
+        double state = 1.0;
+        for (auto i = 0; i < row % 7; i++) {
+          state = state * 0.5 + (row * 0.5 + i) * 2.0 - 1.0;
+        }
+        return state;
+      },
+      nullEvery(13));
+  assertEqualVectors(expectedResult, result);
+
+  // Captures and null elements are evaluated as expressions.
+  input = makeRowVector({
+      makeNullableArrayVector<int64_t>({{1, 2}, {3, std::nullopt}, {5}}),
+      makeFlatVector<int64_t>({10, 20, 30}),
+  });
+  assertEqualVectors(
+      makeNullableFlatVector<int64_t>({30, std::nullopt, 150}),
+      evaluate("reduce(c0, 0, (s, x) -> s + x * c1, s -> s)", input));
+
+  // Overflows are reported by expression evaluation.
+  input = makeRowVector({
+      makeArrayVector<int64_t>(
+          {{1, 2}, {std::numeric_limits<int64_t>::max(), 1}, {3}}),
+  });
+  VELOX_ASSERT_THROW(
+      evaluate("reduce(c0, 0, (s, x) -> s + x, s -> s)", input),
+      "integer overflow");
+  assertEqualVectors(
+      makeNullableFlatVector<int64_t>({3, std::nullopt, 3}),
+      evaluate("try(reduce(c0, 0, (s, x) -> s + x, s -> s))", input));
+}
@@ -16,13 +16,31 @@
 
 #include <gtest/gtest.h>
 
+#include "velox/expression/LazyFunctionRegistry.h"
 #include "velox/expression/SimpleFunctionRegistry.h"
 #include "velox/expression/VectorFunction.h"
 #include "velox/functions/prestosql/registration/RegistrationFunctions.h"
 
 namespace facebook::velox::functions::test {
 
-class ScalarFunctionRegTest : public testing::Test {};
+class ScalarFunctionRegTest : public testing::Test {
+ protected:
+  static void clearFunctions() {
+    exec::vectorFunctionFactories().wlock()->clear();
+    exec::SimpleFunctions().testingClear();
+  }
+
+  static std::unordered_set<std::string> registeredNames() {
+    std::unordered_set<std::string> names;
+    for (const auto& entry : *exec::vectorFunctionFactories().rlock()) {
+      names.insert(entry.first);
+    }
+    for (const auto& name : exec::SimpleFunctions().getFunctionNames()) {
+      names.insert(name);
+    }
+    return names;
+  }
+};
 
 TEST_F(ScalarFunctionRegTest, prefix) {
   // Remove all functions and check for no entries.
@@ -69,4 +87,32 @@ TEST_F(ScalarFunctionRegTest, prefix) {
   }
 }
 
+TEST_F(ScalarFunctionRegTest, lazy) {
+  const std::string prefix{"test.lazy."};
+  clearFunctions();
+  prestosql::registerAllScalarFunctions(prefix);
+  const auto eagerNames = registeredNames();
+
+  clearFunctions();
+  prestosql::registerAllScalarFunctionsLazily(prefix);
+  EXPECT_TRUE(registeredNames().empty());
+
+  // Resolving a function registers its group only.
+  exec::lazyScalarFunctions().ensureRegistered(prefix + "bitwise_and");
+  ASSERT_TRUE(exec::SimpleFunctions().resolveFunction(
+      prefix + "bitwise_and", {BIGINT(), BIGINT()}));
+  auto names = registeredNames();
+  EXPECT_EQ(1, names.count(prefix + "bitwise_xor"));
+  EXPECT_EQ(0, names.count(prefix + "upper"));
+
+  // Every eagerly registered function is in the index of its group and all the
+  // groups are reached through the names of their functions.
+  for (const auto& name : eagerNames) {
+    exec::lazyScalarFunctions().ensureRegistered(name);
+    EXPECT_EQ(1, registeredNames().count(name)) << name;
+  }
+  EXPECT_FALSE(exec::lazyScalarFunctions().hasPending());
+  EXPECT_EQ(eagerNames, registeredNames());
+}
+
 } // namespace facebook::velox::functions::test
@@ -99,6 +99,52 @@ TEST_F(URLFunctionsTest, validateURL) {
       "",
       std::nullopt);
   validate("foo", "", "", "", "", "", std::nullopt);
+  validate(
+      "http://user:pass@[::1]:80/a?b#c", "http", "[::1]", "/a", "c", "b", 80);
+  validate("http://a@b@c/p", "http", "b@c", "/p", "", "", std::nullopt);
+  validate("mailto:x@y.com", "mailto", "", "x@y.com", "", "", std::nullopt);
+  validate("a:b#c?d", "a", "", "b", "c?d", "", std::nullopt);
+  // An invalid authority leaves host, port and path empty.
+  validate("http://a:b/p?q#f", "http", "", "", "f", "q", std::nullopt);
+  validate("http://[::1/p", "http", "", "", "", "", std::nullopt);
+  // A port that does not fit in a bigint is null.
+  validate(
+      "http://a:99999999999999999999/", "http", "a", "/", "", "", std::nullopt);
+  validate("1http://a.com", "", "", "", "", "", std::nullopt);
+  validate("ht tp://a.com", "", "", "", "", "", std::nullopt);
+}
+
+TEST_F(URLFunctionsTest, multipleFunctions) {
+  // All the URL functions in one expression share the parsed URLs.
+  auto data = makeRowVector({
+      makeNullableFlatVector<std::string>(
+          {"http://example.com:8080/path1/p.php?k1=v1&k2=v2#Ref1",
+           std::nullopt,
+           "https://username@example.com/a/very/long/path?k2=some%20value",
+           "foo",
+           "http://a.b/c?k1"}),
+      makeFlatVector<std::string>({"k1", "k1", "k2", "k1", "k1"}),
+  });
+
+  auto result = evaluate<RowVector>(
+      "row_constructor(url_extract_host(c0), url_extract_path(c0), "
+      "url_extract_port(c0), url_extract_parameter(c0, c1), "
+      "url_extract_parameter(c0, 'k2'))",
+      data);
+
+  auto expected = makeRowVector({
+      makeNullableFlatVector<std::string>(
+          {"example.com", std::nullopt, "example.com", "", "a.b"}),
+      makeNullableFlatVector<std::string>(
+          {"/path1/p.php", std::nullopt, "/a/very/long/path", "", "/c"}),
+      makeNullableFlatVector<int64_t>(
+          {8080, std::nullopt, std::nullopt, std::nullopt, std::nullopt}),
+      makeNullableFlatVector<std::string>(
+          {"v1", std::nullopt, "some%20value", std::nullopt, ""}),
+      makeNullableFlatVector<std::string>(
+          {"v2", std::nullopt, "some%20value", std::nullopt, std::nullopt}),
+  });
+  assertEqualVectors(expected, result);
 }
 
 TEST_F(URLFunctionsTest, extractParameter) {
@@ -123,6 +169,10 @@ TEST_F(URLFunctionsTest, extractParameter) {
           "http://example.com/path1/p.php?k1=v1&k2=v2&k3&k4#Ref1", "k6"),
       std::nullopt);
   EXPECT_EQ(extractParam("foo", ""), std::nullopt);
+  EXPECT_EQ(extractParam("http://a.com/?k1=v1=x&k1=v2", "k1"), "v2");
+  EXPECT_EQ(extractParam("http://a.com/?=v0&&k1=v1", "k1"), "v1");
+  EXPECT_EQ(extractParam("http://a.com/?=v0", ""), std::nullopt);
+  EXPECT_EQ(extractParam("http://a.com/?k1=v1#k2=v2", "k2"), std::nullopt);
 }
 
 } // namespace
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+
 #include "velox/common/base/Exceptions.h"
 #include "velox/exec/WindowFunction.h"
 #include "velox/expression/FunctionSignature.h"
@@ -37,53 +39,64 @@ class RankFunction : public exec::WindowFunction {
       : WindowFunction(resultType, nullptr, nullptr) {}
 
   void resetPartition(const exec::WindowPartition* partition) override {
-    rank_ = 1;
+    denseRank_ = 1;
     currentPeerGroupStart_ = 0;
-    previousPeerCount_ = 0;
+    partitionOffset_ = 0;
     numPartitionRows_ = partition->numRows();
   }
 
   void apply(
       const BufferPtr& peerGroupStarts,
-      const BufferPtr& /*peerGroupEnds*/,
+      const BufferPtr& peerGroupEnds,
       const BufferPtr& /*frameStarts*/,
       const BufferPtr& /*frameEnds*/,
       const SelectivityVector& /*validRows*/,
       vector_size_t resultOffset,
       const VectorPtr& result) override {
-    int numRows = peerGroupStarts->size() / sizeof(vector_size_t);
+    const vector_size_t numRows =
+        peerGroupStarts->size() / sizeof(vector_size_t);
     auto* rawPeerStarts = peerGroupStarts->as<vector_size_t>();
-    auto rawValues = result->asFlatVector<TResult>()->mutableRawValues();
+    auto* rawPeerEnds = peerGroupEnds->as<vector_size_t>();
+    auto* rawValues =
+        result->asFlatVector<TResult>()->mutableRawValues() + resultOffset;
 
-    for (int i = 0; i < numRows; i++) {
-      auto start = rawPeerStarts[i];
-      if (start != currentPeerGroupStart_) {
-        currentPeerGroupStart_ = start;
-        if constexpr (TRank == RankType::kDenseRank) {
-          if (previousPeerCount_ > 0) {
-            ++rank_;
-          }
-        } else {
-          rank_ += previousPeerCount_;
+    // All the rows of a peer group have the same rank, so the rank is
+    // computed once per group and filled in for the rows of the group in this
+    // batch. The peer group boundaries are offsets in the partition, while
+    // 'partitionOffset_' is the offset of the first row of this batch.
+    vector_size_t row = 0;
+    while (row < numRows) {
+      const auto start = rawPeerStarts[row];
+      const auto end = std::min<vector_size_t>(
+          rawPeerEnds[row] + 1 - partitionOffset_, numRows);
+      VELOX_DCHECK_GT(end, row);
+      TResult value;
+      if constexpr (TRank == RankType::kDenseRank) {
+        if (start != currentPeerGroupStart_) {
+          currentPeerGroupStart_ = start;
+          ++denseRank_;
         }
-        previousPeerCount_ = 0;
-      }
-
-      if constexpr (TRank == RankType::kPercentRank) {
-        rawValues[resultOffset + i] = (numPartitionRows_ == 1)
+        value = denseRank_;
+      } else if constexpr (TRank == RankType::kPercentRank) {
+        value = numPartitionRows_ == 1
             ? 0
-            : double(rank_ - 1) / (numPartitionRows_ - 1);
+            : double(start) / (numPartitionRows_ - 1);
       } else {
-        rawValues[resultOffset + i] = rank_;
+        value = start + 1;
       }
-      previousPeerCount_ += 1;
+      std::fill(rawValues + row, rawValues + end, value);
+      row = end;
     }
+    partitionOffset_ += numRows;
   }
 
  private:
-  int32_t currentPeerGroupStart_ = 0;
-  int32_t previousPeerCount_ = 0;
-  int64_t rank_ = 1;
+  // Start of the peer group of the last row seen. Used by dense_rank, which
+  // counts the groups.
+  vector_size_t currentPeerGroupStart_ = 0;
+  int64_t denseRank_ = 1;
+  // Offset in the partition of the first row of the next apply().
+  vector_size_t partitionOffset_ = 0;
   vector_size_t numPartitionRows_ = 1;
 };
 
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <numeric>
+
 #include "velox/common/base/Exceptions.h"
 #include "velox/exec/WindowFunction.h"
 #include "velox/expression/FunctionSignature.h"
@@ -39,11 +41,12 @@ class RowNumberFunction : public exec::WindowFunction {
       const SelectivityVector& /*validRows*/,
       vector_size_t resultOffset,
       const VectorPtr& result) override {
-    int numRows = peerGroupStarts->size() / sizeof(vector_size_t);
-    auto* rawValues = result->asFlatVector<int64_t>()->mutableRawValues();
-    for (int i = 0; i < numRows; i++) {
-      rawValues[resultOffset + i] = rowNumber_++;
-    }
+    const vector_size_t numRows =
+        peerGroupStarts->size() / sizeof(vector_size_t);
+    auto* rawValues =
+        result->asFlatVector<int64_t>()->mutableRawValues() + resultOffset;
+    std::iota(rawValues, rawValues + numRows, rowNumber_);
+    rowNumber_ += numRows;
   }
 
  private:
@@ -96,6 +96,18 @@ TEST_P(RankTest, randomInput) {
   testWindowFunction({makeRandomInputVector(20), makeRandomInputVector(30)});
 }
 
+// Tests all functions with large peer groups in partitions that span several
+// output batches, so that the peer groups continue across batches.
+TEST_P(RankTest, peerGroupsAcrossBatches) {
+  constexpr vector_size_t kSize = 6'000;
+  testWindowFunction({makeRowVector({
+      makeFlatVector<int32_t>(kSize, [](auto row) { return row % 2; }),
+      makeFlatVector<int32_t>(kSize, [](auto row) { return row % 3; }),
+      makeFlatVector<int64_t>(kSize, [](auto row) { return row % 5 + 1; }),
+      makeFlatVector<int64_t>(kSize, [](auto /*row*/) { return 1; }),
+  })});
+}
+
 // Run above tests for all combinations of rank function and over clauses.
 VELOX_INSTANTIATE_TEST_SUITE_P(
     RankTestInstantiation,
@@ -122,5 +122,34 @@ TEST_F(StringAggregatesTest, nonFixedWidthAggregate) {
   testWindowFunction(input, "max(c2)", kOverClauses);
 }
 
+// Tests sliding frames over a large partition. These frames span several
+// levels of the segment tree used to compute the aggregates.
+TEST_F(StringAggregatesTest, largeSlidingFrames) {
+  auto input = {makeSinglePartitionVector(3'000)};
+  const std::vector<std::string> overClauses = {
+      "partition by c0 order by c1, c2, c3"};
+  const std::vector<std::string> frameClauses = {
+      "rows between 100 preceding and current row",
+      "rows between 300 preceding and 50 following",
+      "rows between c2 preceding and 500 following",
+      "rows between 1000 preceding and 1000 following",
+  };
+
+  for (const auto& function : kAggregateFunctions) {
+    testWindowFunction(input, function, overClauses, frameClauses);
+  }
+  testWindowFunction(
+      {makeRowVector({
+          makeFlatVector<int32_t>(3'000, [](auto /* row */) { return 1; }),
+          makeFlatVector<int32_t>(3'000, [](auto row) { return row; }),
+          makeRandomInputVector(VARCHAR(), 3'000, 0.3),
+          makeFlatVector<int64_t>(3'000, [](auto row) { return row; }),
+      })},
+      "min(c2)",
+      {"partition by c0 order by c1, c3"},
+      {"rows between 100 preceding and current row",
+       "rows between 300 preceding and 50 following"});
+}
+
 }; // namespace
 }; // namespace facebook::velox::window::test
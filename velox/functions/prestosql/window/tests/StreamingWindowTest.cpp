@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/functions/prestosql/window/tests/WindowTestBase.h"
+
+using namespace facebook::velox::exec::test;
+
+namespace facebook::velox::window::test {
+
+namespace {
+
+class StreamingWindowTest : public WindowTestBase {
+ protected:
+  // Sorts 'input' by 'sortingKeys', computes the window functions in
+  // 'functionSqls' over the sorted rows in streaming mode and verifies the
+  // results against DuckDB.
+  void testStreamingWindow(
+      const std::vector<RowVectorPtr>& input,
+      const std::vector<std::string>& sortingKeys,
+      const std::vector<std::string>& functionSqls) {
+    createDuckDbTable(input);
+
+    auto plan = PlanBuilder()
+                    .values(input)
+                    .orderBy(sortingKeys, false)
+                    .streamingWindow(functionSqls)
+                    .planNode();
+    assertQuery(
+        plan,
+        fmt::format("SELECT *, {} FROM tmp", folly::join(", ", functionSqls)));
+  }
+
+  // Returns 'numBatches' batches of 'batchSize' rows sorted by c0, c1. c0 is
+  // the partition key and each partition has 'partitionSize' rows, so the
+  // partitions span batches when 'partitionSize' > 'batchSize'.
+  std::vector<RowVectorPtr> makeSortedInput(
+      vector_size_t numBatches,
+      vector_size_t batchSize,
+      vector_size_t partitionSize) {
+    std::vector<RowVectorPtr> input;
+    for (auto i = 0; i < numBatches; ++i) {
+      const auto offset = i * batchSize;
+      input.push_back(makeRowVector({
+          makeFlatVector<int32_t>(
+              batchSize,
+              [&](auto row) { return (offset + row) / partitionSize; }),
+          makeFlatVector<int32_t>(
+              batchSize,
+              [&](auto row) { return (offset + row) % partitionSize; }),
+          makeFlatVector<int64_t>(
+              batchSize, [&](auto row) { return (offset + row) % 7; }),
+      }));
+    }
+    return input;
+  }
+};
+
+TEST_F(StreamingWindowTest, basic) {
+  std::vector<RowVectorPtr> input;
+  for (auto i = 0; i < 10; ++i) {
+    input.push_back(makeSimpleVector(1'000));
+  }
+
+  testStreamingWindow(
+      input,
+      {"c0", "c1", "c2", "c3"},
+      {"rank() over (partition by c0 order by c1, c2, c3)",
+       "sum(c2) over (partition by c0 order by c1, c2, c3 "
+       "rows between 5 preceding and current row)"});
+
+  testStreamingWindow(
+      input,
+      {"c0 DESC", "c1", "c2 DESC"},
+      {"row_number() over (partition by c0 order by c1, c2 desc)",
+       "max(c3) over (partition by c0 order by c1, c2 desc)"});
+}
+
+TEST_F(StreamingWindowTest, randomInput) {
+  std::vector<RowVectorPtr> input;
+  for (auto i = 0; i < 5; ++i) {
+    input.push_back(makeRandomInputVector(500));
+  }
+
+  testStreamingWindow(
+      input,
+      {"c0", "c1", "c2 NULLS FIRST", "c3"},
+      {"count(c3) over (partition by c0, c1 order by c2 nulls first, c3)"});
+}
+
+TEST_F(StreamingWindowTest, singleRowPartitions) {
+  std::vector<RowVectorPtr> input;
+  for (auto i = 0; i < 5; ++i) {
+    input.push_back(makeSingleRowPartitionsVector(200));
+  }
+
+  testStreamingWindow(
+      input, {"c0", "c1"}, {"rank() over (partition by c0 order by c1)"});
+}
+
+TEST_F(StreamingWindowTest, noPartitionKeys) {
+  std::vector<RowVectorPtr> input;
+  for (auto i = 0; i < 5; ++i) {
+    input.push_back(makeSimpleVector(200));
+  }
+
+  testStreamingWindow(
+      input,
+      {"c0", "c1", "c2", "c3"},
+      {"rank() over (order by c0, c1, c2, c3)",
+       "sum(c2) over (order by c0, c1, c2, c3)"});
+}
+
+// Pre-sorted input without an OrderBy, with partitions both smaller than and
+// spanning the input batches.
+TEST_F(StreamingWindowTest, presortedInput) {
+  for (const auto partitionSize : {1, 3, 100, 250, 2'000}) {
+    SCOPED_TRACE(fmt::format("partitionSize: {}", partitionSize));
+    auto input = makeSortedInput(10, 100, partitionSize);
+    createDuckDbTable(input);
+
+    const std::vector<std::string> functionSqls = {
+        "row_number() over (partition by c0 order by c1)",
+        "sum(c2) over (partition by c0 order by c1 "
+        "rows between 2 preceding and 1 following)",
+        "max(c2) over (partition by c0)"};
+    auto plan =
+        PlanBuilder().values(input).streamingWindow(functionSqls).planNode();
+    assertQuery(
+        plan,
+        fmt::format("SELECT *, {} FROM tmp", folly::join(", ", functionSqls)));
+  }
+}
+
+TEST_F(StreamingWindowTest, emptyInput) {
+  auto input = makeSortedInput(1, 0, 1);
+  createDuckDbTable(input);
+
+  const std::string functionSql = "rank() over (partition by c0 order by c1)";
+  auto plan =
+      PlanBuilder().values(input).streamingWindow({functionSql}).planNode();
+  assertQuery(plan, fmt::format("SELECT *, {} FROM tmp", functionSql));
+}
+
+} // namespace
+} // namespace facebook::velox::window::test
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+#include "velox/functions/prestosql/window/tests/WindowTestBase.h"
+
+using namespace facebook::velox::exec::test;
+
+namespace facebook::velox::window::test {
+
+namespace {
+
+class WindowSpillTest : public WindowTestBase {
+ protected:
+  // Runs the window functions in 'functionSqls' over 'input' with spilling
+  // forced on every input batch and verifies the results against DuckDB.
+  void testSpill(
+      const std::vector<RowVectorPtr>& input,
+      const std::vector<std::string>& functionSqls,
+      bool expectSpill = true) {
+    createDuckDbTable(input);
+
+    core::PlanNodeId windowId;
+    auto plan = PlanBuilder()
+                    .values(input)
+                    .window(functionSqls)
+                    .capturePlanNodeId(windowId)
+                    .planNode();
+    auto spillDirectory = TempDirectoryPath::create();
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .config(core::QueryConfig::kTestingSpillPct, "100")
+            .config(core::QueryConfig::kSpillEnabled, "true")
+            .config(core::QueryConfig::kWindowSpillEnabled, "true")
+            .spillDirectory(spillDirectory->path)
+            .assertResults(fmt::format(
+                "SELECT *, {} FROM tmp", folly::join(", ", functionSqls)));
+
+    const auto stats = toPlanStats(task->taskStats()).at(windowId);
+    if (expectSpill) {
+      EXPECT_LT(0, stats.spilledBytes);
+      EXPECT_LT(0, stats.spilledRows);
+      EXPECT_EQ(1, stats.spilledPartitions);
+      EXPECT_LT(0, stats.spilledFiles);
+    } else {
+      EXPECT_EQ(0, stats.spilledBytes);
+    }
+    OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+  }
+};
+
+TEST_F(WindowSpillTest, basic) {
+  std::vector<RowVectorPtr> input;
+  for (auto i = 0; i < 10; ++i) {
+    input.push_back(makeSimpleVector(1'000));
+  }
+
+  testSpill(
+      input,
+      {"rank() over (partition by c0 order by c1, c2, c3)",
+       "sum(c2) over (partition by c0 order by c1, c2, c3 "
+       "rows between 5 preceding and current row)",
+       "max(c3) over (partition by c0, c1 order by c2 desc, c3)"});
+}
+
+TEST_F(WindowSpillTest, manyPartitions) {
+  std::vector<RowVectorPtr> input;
+  for (auto i = 0; i < 5; ++i) {
+    input.push_back(makeRandomInputVector(500));
+  }
+
+  testSpill(
+      input,
+      {"row_number() over (partition by c0 order by c1, c2, c3)",
+       "count(c1) over (partition by c0, c2 order by c1 nulls first, c3)"});
+}
+
+TEST_F(WindowSpillTest, singleRowPartitions) {
+  std::vector<RowVectorPtr> input;
+  for (auto i = 0; i < 5; ++i) {
+    input.push_back(makeSingleRowPartitionsVector(200));
+  }
+
+  testSpill(input, {"rank() over (partition by c0 order by c1)"});
+}
+
+// Spilling is not used without partition keys as all the input rows are in a
+// single partition.
+TEST_F(WindowSpillTest, noPartitionKeys) {
+  std::vector<RowVectorPtr> input;
+  for (auto i = 0; i < 5; ++i) {
+    input.push_back(makeSimpleVector(200));
+  }
+
+  testSpill(input, {"rank() over (order by c0, c1, c2, c3)"}, false);
+}
+
+} // namespace
+} // namespace facebook::velox::window::test
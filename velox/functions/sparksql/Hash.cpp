@@ -16,6 +16,7 @@
 #include "velox/functions/sparksql/Hash.h"
 
 #include <folly/CPortability.h>
+#include <xsimd/xsimd.hpp>
 
 #include "velox/common/base/BitUtil.h"
 #include "velox/expression/DecodedArgs.h"
@@ -24,6 +25,35 @@
 namespace facebook::velox::functions::sparksql {
 namespace {
 
+// True if 'rows' is a contiguous range of rows of a flat column, so that
+// the values can be read directly from the column's buffer.
+bool isFlatRange(const SelectivityVector& rows, const DecodedVector& decoded) {
+  return decoded.isIdentityMapping() && rows.isAllSelected();
+}
+
+// Updates 'hashes' of 'rows' with the hash of the value of the row in
+// 'decoded', a column at a time. 'hashes' are the seeds on entry.
+template <typename T, typename ReturnType, typename HashFn>
+void hashColumn(
+    const SelectivityVector& rows,
+    const DecodedVector& decoded,
+    HashFn hashFn,
+    ReturnType* hashes) {
+  // Booleans are bit packed.
+  if constexpr (!std::is_same_v<T, bool>) {
+    if (isFlatRange(rows, decoded)) {
+      const auto* values = decoded.data<T>();
+      for (auto row = rows.begin(); row < rows.end(); ++row) {
+        hashes[row] = hashFn(values[row], hashes[row]);
+      }
+      return;
+    }
+  }
+  rows.applyToSelected([&](vector_size_t row) {
+    hashes[row] = hashFn(decoded.valueAt<T>(row), hashes[row]);
+  });
+}
+
 // ReturnType can be either int32_t or int64_t
 // HashClass contains the function like hashInt32
 template <typename ReturnType, typename HashClass, typename SeedType>
@@ -36,7 +66,9 @@ void applyWithType(
   HashClass hash;
 
   auto& result = *resultRef->as<FlatVector<ReturnType>>();
-  rows.applyToSelected([&](int row) { result.set(row, kSeed); });
+  result.clearNulls(rows);
+  auto* rawResults = result.mutableRawValues();
+  rows.applyToSelected([&](vector_size_t row) { rawResults[row] = kSeed; });
 
   exec::LocalSelectivityVector selectedMinusNulls(context);
 
@@ -53,23 +85,37 @@ void applyWithType(
     switch (args[i]->type()->kind()) {
 // Derived from InterpretedHashFunction.hash:
 // https://github.com/apache/spark/blob/382b66e/sql/catalyst/src/main/scala/org/apache/spark/sql/catalyst/expressions/hash.scala#L532
-#define CASE(typeEnum, hashFn, inputType)                                      \
-  case TypeKind::typeEnum:                                                     \
-    selected->applyToSelected([&](int row) {                                   \
-      result.set(                                                              \
-          row, hashFn(decoded->valueAt<inputType>(row), result.valueAt(row))); \
-    });                                                                        \
+#define CASE(typeEnum, hashFn, inputType)                                \
+  case TypeKind::typeEnum:                                               \
+    hashColumn<inputType>(                                               \
+        *selected,                                                       \
+        *decoded,                                                        \
+        [&](auto value, SeedType seed) { return hashFn(value, seed); }, \
+        rawResults);                                                     \
     break;
       CASE(BOOLEAN, hash.hashInt32, bool);
       CASE(TINYINT, hash.hashInt32, int8_t);
       CASE(SMALLINT, hash.hashInt32, int16_t);
-      CASE(INTEGER, hash.hashInt32, int32_t);
       CASE(BIGINT, hash.hashInt64, int64_t);
       CASE(VARCHAR, hash.hashBytes, StringView);
       CASE(VARBINARY, hash.hashBytes, StringView);
       CASE(REAL, hash.hashFloat, float);
       CASE(DOUBLE, hash.hashDouble, double);
 #undef CASE
+      case TypeKind::INTEGER:
+        if (isFlatRange(*selected, *decoded)) {
+          hash.hashInt32s(
+              decoded->data<int32_t>(), rows.begin(), rows.end(), rawResults);
+        } else {
+          hashColumn<int32_t>(
+              *selected,
+              *decoded,
+              [&](int32_t value, SeedType seed) {
+                return hash.hashInt32(value, seed);
+              },
+              rawResults);
+        }
+        break;
       default:
         VELOX_NYI(
             "Unsupported type for HASH(): {}", args[i]->type()->toString());
@@ -95,6 +141,28 @@ class Murmur3Hash final {
     return fmix(h1, 4);
   }
 
+  // Same as hashInt32() for the rows in [begin, end) of 'values', with the
+  // seeds in 'hashes'. Hashes a SIMD batch of rows at a time.
+  void hashInt32s(
+      const int32_t* values,
+      vector_size_t begin,
+      vector_size_t end,
+      int32_t* hashes) {
+    using Batch = xsimd::batch<uint32_t>;
+    auto row = begin;
+    for (; row + Batch::size <= end; row += Batch::size) {
+      const auto input = Batch::load_unaligned(
+          reinterpret_cast<const uint32_t*>(values + row));
+      const auto seed = Batch::load_unaligned(
+          reinterpret_cast<const uint32_t*>(hashes + row));
+      fmix(mixH1(seed, mixK1(input)), 4)
+          .store_unaligned(reinterpret_cast<uint32_t*>(hashes + row));
+    }
+    for (; row < end; ++row) {
+      hashes[row] = hashInt32(values[row], hashes[row]);
+    }
+  }
+
   uint32_t hashInt64(uint64_t input, uint32_t seed) {
     uint32_t low = input;
     uint32_t high = input >> 32;
@@ -136,27 +204,37 @@ class Murmur3Hash final {
   }
 
  private:
-  uint32_t mixK1(uint32_t k1) {
-    k1 *= 0xcc9e2d51;
-    k1 = bits::rotateLeft(k1, 15);
-    k1 *= 0x1b873593;
+  // The mixing steps are templates so that they apply to a uint32_t as well
+  // as to each lane of a SIMD batch of uint32_t.
+  template <typename T>
+  static T rotateLeft(T x, int shift) {
+    return (x << shift) | (x >> (32 - shift));
+  }
+
+  template <typename T>
+  T mixK1(T k1) {
+    k1 *= T(0xcc9e2d51);
+    k1 = rotateLeft(k1, 15);
+    k1 *= T(0x1b873593);
     return k1;
   }
 
-  uint32_t mixH1(uint32_t h1, uint32_t k1) {
+  template <typename T>
+  T mixH1(T h1, T k1) {
     h1 ^= k1;
-    h1 = bits::rotateLeft(h1, 13);
-    h1 = h1 * 5 + 0xe6546b64;
+    h1 = rotateLeft(h1, 13);
+    h1 = h1 * T(5) + T(0xe6546b64);
     return h1;
   }
 
   // Finalization mix - force all bits of a hash block to avalanche
-  uint32_t fmix(uint32_t h1, uint32_t length) {
-    h1 ^= length;
+  template <typename T>
+  T fmix(T h1, uint32_t length) {
+    h1 ^= T(length);
     h1 ^= h1 >> 16;
-    h1 *= 0x85ebca6b;
+    h1 *= T(0x85ebca6b);
     h1 ^= h1 >> 13;
-    h1 *= 0xc2b2ae35;
+    h1 *= T(0xc2b2ae35);
     h1 ^= h1 >> 16;
     return h1;
   }
@@ -194,6 +272,18 @@ class XxHash64 final {
     return fmix(hash);
   }
 
+  // Same as hashInt32() for the rows in [begin, end) of 'values', with the
+  // seeds in 'hashes'.
+  void hashInt32s(
+      const int32_t* values,
+      vector_size_t begin,
+      vector_size_t end,
+      int64_t* hashes) {
+    for (auto row = begin; row < end; ++row) {
+      hashes[row] = hashInt32(values[row], hashes[row]);
+    }
+  }
+
   int64_t hashInt64(int64_t input, uint64_t seed) {
     int64_t hash = seed + PRIME64_5 + 8L;
     hash ^= bits::rotateLeft64(input * PRIME64_2, 31) * PRIME64_1;
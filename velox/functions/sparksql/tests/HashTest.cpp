@@ -113,5 +113,47 @@ TEST_F(HashTest, Float) {
   EXPECT_EQ(hash<float>(-limits::infinity()), 427440766);
 }
 
+TEST_F(HashTest, manyRows) {
+  // Columns are hashed a batch of rows at a time. Checks that the result
+  // matches hashing one row at a time for flat, null and dictionary encoded
+  // inputs and for a row count that is not a multiple of the batch size.
+  constexpr vector_size_t kSize = 1'001;
+  auto ints = makeFlatVector<int32_t>(kSize, [](auto row) { return row * 7; });
+  auto bigints = makeFlatVector<int64_t>(
+      kSize, [](auto row) { return row * 1'000'003; }, nullEvery(5));
+  auto strings = makeFlatVector<std::string>(
+      kSize, [](auto row) { return std::string(row % 40, 'a' + row % 26); });
+  auto data = makeRowVector({
+      ints,
+      bigints,
+      strings,
+      wrapInDictionary(makeIndicesInReverse(kSize), kSize, ints),
+  });
+
+  auto result = evaluate<SimpleVector<int32_t>>("hash(c0, c1, c2)", data);
+  auto dictionaryResult =
+      evaluate<SimpleVector<int32_t>>("hash(c3, c1)", data);
+  for (auto row = 0; row < kSize; ++row) {
+    const auto bigint = bigints->isNullAt(row)
+        ? std::nullopt
+        : std::optional<int64_t>(bigints->valueAt(row));
+    ASSERT_EQ(
+        result->valueAt(row),
+        evaluateOnce<int32_t>(
+            "hash(c0, c1, c2)",
+            std::optional<int32_t>(ints->valueAt(row)),
+            bigint,
+            std::optional<std::string>(strings->valueAt(row).str())))
+        << row;
+    ASSERT_EQ(
+        dictionaryResult->valueAt(row),
+        evaluateOnce<int32_t>(
+            "hash(c0, c1)",
+            std::optional<int32_t>(ints->valueAt(kSize - 1 - row)),
+            bigint))
+        << row;
+  }
+}
+
 } // namespace
 } // namespace facebook::velox::functions::sparksql::test
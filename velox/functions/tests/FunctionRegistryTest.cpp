@@ -449,6 +449,25 @@ TEST_F(FunctionRegistryTest, registerFunctionTwice) {
   ASSERT_EQ(signatures.size(), 1);
 }
 
+TEST_F(FunctionRegistryTest, resolutionCache) {
+  // Repeated resolutions return the cached result.
+  for (auto i = 0; i < 3; ++i) {
+    checkEqual(resolveFunction("func_two", {BIGINT(), SMALLINT()}), BIGINT());
+    checkEqual(resolveFunction("func_two", {BIGINT(), BIGINT()}), nullptr);
+    testResolveVectorFunction("vector_func_one", {VARCHAR()}, BIGINT());
+  }
+
+  // Registration invalidates the cached results, including the misses.
+  checkEqual(resolveFunction("func_cached", {BIGINT()}), nullptr);
+  checkEqual(resolveVectorFunction("vector_func_cached", {VARCHAR()}), nullptr);
+
+  registerFunction<FuncFive, int64_t, int64_t>({"func_cached"});
+  VELOX_REGISTER_VECTOR_FUNCTION(udf_vector_func_one, "vector_func_cached");
+
+  checkEqual(resolveFunction("func_cached", {BIGINT()}), BIGINT());
+  testResolveVectorFunction("vector_func_cached", {VARCHAR()}, BIGINT());
+}
+
 TEST_F(FunctionRegistryTest, functionNameInMixedCase) {
   auto result = resolveFunction("funC_onE", {VARCHAR()});
   ASSERT_EQ(*result, *VARCHAR());
@@ -38,6 +38,20 @@ std::vector<std::shared_ptr<const core::IExpr>> parseMultipleExpressions(
       expr, duckConversionOptions);
 }
 
+AggregateExpr parseAggregateExpr(
+    const std::string& expr,
+    const ParseOptions& options) {
+  facebook::velox::duckdb::ParseOptions duckConversionOptions;
+  duckConversionOptions.parseDecimalAsDouble = options.parseDecimalAsDouble;
+  duckConversionOptions.parseIntegerAsBigint = options.parseIntegerAsBigint;
+  auto aggregateExpr =
+      facebook::velox::duckdb::parseAggregateExpr(expr, duckConversionOptions);
+  return {
+      std::move(aggregateExpr.expr),
+      aggregateExpr.distinct,
+      std::move(aggregateExpr.orderBy)};
+}
+
 std::pair<std::shared_ptr<const core::IExpr>, core::SortOrder> parseOrderByExpr(
     const std::string& expr) {
   return facebook::velox::duckdb::parseOrderByExpr(expr);
@@ -40,4 +40,18 @@ std::vector<std::shared_ptr<const core::IExpr>> parseMultipleExpressions(
     const std::string& expr,
     const ParseOptions& options);
 
+/// An aggregate function call and its DISTINCT and ORDER BY modifiers.
+struct AggregateExpr {
+  std::shared_ptr<const core::IExpr> expr;
+  bool distinct{false};
+  std::vector<std::pair<std::shared_ptr<const core::IExpr>, core::SortOrder>>
+      orderBy;
+};
+
+/// Parses a single aggregate function call, e.g. "count(DISTINCT a)" or
+/// "array_agg(a ORDER BY b)".
+AggregateExpr parseAggregateExpr(
+    const std::string& expr,
+    const ParseOptions& options);
+
 } // namespace facebook::velox::parse
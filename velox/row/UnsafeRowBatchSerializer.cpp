@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/row/UnsafeRowBatchSerializer.h"
+#include "velox/row/UnsafeRowDynamicSerializer.h"
+
+namespace facebook::velox::row {
+namespace {
+
+bool isStringKind(TypeKind kind) {
+  return kind == TypeKind::VARCHAR || kind == TypeKind::VARBINARY;
+}
+
+void checkSupported(const TypePtr& type) {
+  switch (type->kind()) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE:
+    case TypeKind::TIMESTAMP:
+    case TypeKind::DATE:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+    case TypeKind::ARRAY:
+    case TypeKind::MAP:
+    case TypeKind::ROW:
+      return;
+    default:
+      VELOX_UNSUPPORTED("Unsupported type: {}", type->toString());
+  }
+}
+
+// Writes 'value' in the fixed-width field at 'location'. Timestamps are
+// written as microseconds as in Spark.
+template <TypeKind Kind>
+FOLLY_ALWAYS_INLINE void writeFixedWidth(
+    const typename TypeTraits<Kind>::NativeType& value,
+    char* location) {
+  if constexpr (Kind == TypeKind::TIMESTAMP) {
+    *reinterpret_cast<int64_t*>(location) = value.toMicros();
+  } else {
+    *reinterpret_cast<typename TypeTraits<Kind>::NativeType*>(location) =
+        value;
+  }
+}
+
+template <TypeKind Kind>
+void serializeFixedWidthColumn(
+    const DecodedVector& decoded,
+    column_index_t column,
+    size_t fieldOffset,
+    const std::vector<size_t>& offsets,
+    char* buffer) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  const vector_size_t numRows = offsets.size() - 1;
+  if (!decoded.mayHaveNulls()) {
+    for (vector_size_t row = 0; row < numRows; ++row) {
+      writeFixedWidth<Kind>(
+          decoded.valueAt<T>(row), buffer + offsets[row] + fieldOffset);
+    }
+    return;
+  }
+  for (vector_size_t row = 0; row < numRows; ++row) {
+    char* rowStart = buffer + offsets[row];
+    if (decoded.isNullAt(row)) {
+      bits::setBit(rowStart, column);
+      continue;
+    }
+    writeFixedWidth<Kind>(decoded.valueAt<T>(row), rowStart + fieldOffset);
+  }
+}
+} // namespace
+
+UnsafeRowBatchSerializer::UnsafeRowBatchSerializer(const RowVectorPtr& data)
+    : data_(data),
+      numFields_(data->childrenSize()),
+      nullLength_(UnsafeRow::getNullLength(numFields_)),
+      fixedRowSize_(nullLength_ + numFields_ * UnsafeRow::kFieldWidthBytes),
+      decoded_(numFields_) {
+  const auto numRows = data_->size();
+  SelectivityVector rows(numRows);
+  std::vector<size_t> rowSizes(numRows, fixedRowSize_);
+  for (column_index_t i = 0; i < numFields_; ++i) {
+    const auto& child = data_->childAt(i);
+    const auto& type = data_->type()->childAt(i);
+    checkSupported(type);
+    if (type->isFixedWidth()) {
+      decoded_[i].decode(*child, rows);
+      continue;
+    }
+    if (isStringKind(type->kind())) {
+      decoded_[i].decode(*child, rows);
+      for (vector_size_t row = 0; row < numRows; ++row) {
+        if (!decoded_[i].isNullAt(row)) {
+          rowSizes[row] += UnsafeRow::alignToFieldWidth(
+              decoded_[i].valueAt<StringView>(row).size());
+        }
+      }
+      continue;
+    }
+    UnsafeRowDynamicSerializer::preloadVector(child);
+    for (vector_size_t row = 0; row < numRows; ++row) {
+      rowSizes[row] += UnsafeRow::alignToFieldWidth(
+          UnsafeRowDynamicSerializer::getSize(type, child, row));
+    }
+  }
+
+  offsets_.resize(numRows + 1);
+  offsets_[0] = 0;
+  for (vector_size_t row = 0; row < numRows; ++row) {
+    offsets_[row + 1] = offsets_[row] + rowSizes[row];
+  }
+}
+
+size_t UnsafeRowBatchSerializer::fieldOffset(column_index_t column) const {
+  return nullLength_ + column * UnsafeRow::kFieldWidthBytes;
+}
+
+void UnsafeRowBatchSerializer::serialize(char* buffer) const {
+  // The null bits, the unused bytes of narrow fields and the padding of
+  // variable-width values must be 0.
+  std::memset(buffer, 0, totalSize());
+
+  std::vector<size_t> variableOffsets(numRows(), fixedRowSize_);
+  for (column_index_t i = 0; i < numFields_; ++i) {
+    if (data_->type()->childAt(i)->isFixedWidth()) {
+      serializeFixedWidth(i, buffer);
+    }
+  }
+  for (column_index_t i = 0; i < numFields_; ++i) {
+    if (!data_->type()->childAt(i)->isFixedWidth()) {
+      serializeVariableWidth(i, buffer, variableOffsets);
+    }
+  }
+}
+
+void UnsafeRowBatchSerializer::serializeFixedWidth(
+    column_index_t column,
+    char* buffer) const {
+  const auto kind = data_->type()->childAt(column)->kind();
+  VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+      serializeFixedWidthColumn,
+      kind,
+      decoded_[column],
+      column,
+      fieldOffset(column),
+      offsets_,
+      buffer);
+}
+
+void UnsafeRowBatchSerializer::serializeVariableWidth(
+    column_index_t column,
+    char* buffer,
+    std::vector<size_t>& variableOffsets) const {
+  const auto& type = data_->type()->childAt(column);
+  const auto offset = fieldOffset(column);
+  const bool isString = isStringKind(type->kind());
+  for (vector_size_t row = 0; row < numRows(); ++row) {
+    char* rowStart = buffer + offsets_[row];
+    auto& variableOffset = variableOffsets[row];
+    std::optional<size_t> size;
+    if (isString) {
+      if (!decoded_[column].isNullAt(row)) {
+        const auto value = decoded_[column].valueAt<StringView>(row);
+        std::memcpy(rowStart + variableOffset, value.data(), value.size());
+        size = value.size();
+      }
+    } else {
+      size = UnsafeRowDynamicSerializer::serialize(
+          type, data_->childAt(column), rowStart + variableOffset, row);
+    }
+    if (!size.has_value()) {
+      bits::setBit(rowStart, column);
+      continue;
+    }
+    *reinterpret_cast<uint64_t*>(rowStart + offset) =
+        variableOffset << 32 | size.value();
+    variableOffset += UnsafeRow::alignToFieldWidth(size.value());
+    VELOX_DCHECK_LE(variableOffset, rowSize(row));
+  }
+}
+
+} // namespace facebook::velox::row
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::row {
+
+/// Converts a RowVector to UnsafeRows a batch at a time. The sizes of all
+/// rows are computed up front. The fixed-width fields are then written a
+/// column at a time and the variable-width fields in a second pass, instead
+/// of dispatching on the type of each field of each row. The rows are written
+/// back to back, each padded to a multiple of 8 bytes. The reverse direction
+/// is UnsafeRow24Deserializer, which decodes a batch of rows column by column.
+class UnsafeRowBatchSerializer {
+ public:
+  /// 'data' must stay alive while 'this' is used and must not have null rows.
+  explicit UnsafeRowBatchSerializer(const RowVectorPtr& data);
+
+  vector_size_t numRows() const {
+    return offsets_.size() - 1;
+  }
+
+  /// Returns the number of bytes serialize() writes.
+  size_t totalSize() const {
+    return offsets_.back();
+  }
+
+  /// Returns the offset of 'row' from the start of the serialized rows.
+  size_t rowOffset(vector_size_t row) const {
+    return offsets_[row];
+  }
+
+  size_t rowSize(vector_size_t row) const {
+    return offsets_[row + 1] - offsets_[row];
+  }
+
+  /// Writes all rows to 'buffer', which must have space for totalSize()
+  /// bytes.
+  void serialize(char* buffer) const;
+
+ private:
+  // Returns the offset of the field of 'column' in a row.
+  size_t fieldOffset(column_index_t column) const;
+
+  void serializeFixedWidth(column_index_t column, char* buffer) const;
+
+  void serializeVariableWidth(
+      column_index_t column,
+      char* buffer,
+      std::vector<size_t>& variableOffsets) const;
+
+  const RowVectorPtr data_;
+  const column_index_t numFields_;
+  // Size of the null bits of a row.
+  const size_t nullLength_;
+  // Size of the null bits and fixed-width fields of a row.
+  const size_t fixedRowSize_;
+
+  // The decoded scalar columns. Complex type columns are not decoded.
+  std::vector<DecodedVector> decoded_;
+
+  // The start of each row followed by the end of the last one.
+  std::vector<size_t> offsets_;
+};
+
+} // namespace facebook::velox::row
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/row/UnsafeRow24Deserializer.h"
+#include "velox/row/UnsafeRowBatchSerializer.h"
+#include "velox/row/UnsafeRowDeserializer.h"
+#include "velox/row/UnsafeRowDynamicSerializer.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+
+namespace facebook::spark::benchmarks {
+namespace {
+using namespace facebook::velox;
+using namespace facebook::velox::row;
+
+// Compares converting a batch of rows between a RowVector and UnsafeRows a row
+// at a time and a batch at a time.
+class BenchmarkHelper {
+ public:
+  RowVectorPtr makeData(int nFields, int nRows, bool stringOnly) {
+    std::vector<std::string> names;
+    std::vector<TypePtr> types;
+    for (int32_t i = 0; i < nFields; ++i) {
+      names.push_back(fmt::format("c{}", i));
+      types.push_back(
+          stringOnly ? VARCHAR()
+                     : allTypes_[folly::Random::rand32() % allTypes_.size()]);
+    }
+
+    VectorFuzzer::Options opts;
+    opts.vectorSize = nRows;
+    opts.nullRatio = 0.1;
+    opts.stringVariableLength = true;
+    opts.stringLength = 20;
+    opts.timestampPrecision =
+        VectorFuzzer::Options::TimestampPrecision::kMicroSeconds;
+    VectorFuzzer fuzzer(opts, pool_.get(), folly::Random::rand32());
+    return fuzzer.fuzzInputRow(ROW(std::move(names), std::move(types)));
+  }
+
+  memory::MemoryPool* pool() {
+    return pool_.get();
+  }
+
+ private:
+  std::vector<TypePtr> allTypes_{
+      BOOLEAN(),
+      TINYINT(),
+      SMALLINT(),
+      INTEGER(),
+      BIGINT(),
+      REAL(),
+      DOUBLE(),
+      VARCHAR(),
+      TIMESTAMP(),
+      ARRAY(INTEGER()),
+      MAP(VARCHAR(), ARRAY(INTEGER())),
+      ROW({INTEGER()})};
+
+  std::shared_ptr<memory::MemoryPool> pool_ = memory::getDefaultMemoryPool();
+};
+
+int serializeRows(int nIters, int nFields, int nRows, bool stringOnly) {
+  folly::BenchmarkSuspender suspender;
+  BenchmarkHelper helper;
+  auto data = helper.makeData(nFields, nRows, stringOnly);
+  const auto& rowType = data->type();
+  UnsafeRowDynamicSerializer::preloadVector(data);
+  suspender.dismiss();
+
+  for (int i = 0; i < nIters; ++i) {
+    std::vector<size_t> rowSizes(nRows);
+    size_t totalSize = 0;
+    for (auto row = 0; row < nRows; ++row) {
+      rowSizes[row] = UnsafeRow::alignToFieldWidth(
+          UnsafeRowDynamicSerializer::getSizeRow(rowType, data.get(), row));
+      totalSize += rowSizes[row];
+    }
+    std::vector<char> buffer(totalSize);
+    size_t offset = 0;
+    for (auto row = 0; row < nRows; ++row) {
+      UnsafeRowDynamicSerializer::serialize(
+          rowType, data, buffer.data() + offset, row);
+      offset += rowSizes[row];
+    }
+    folly::doNotOptimizeAway(buffer);
+  }
+  return nIters * nFields * nRows;
+}
+
+int serializeBatch(int nIters, int nFields, int nRows, bool stringOnly) {
+  folly::BenchmarkSuspender suspender;
+  BenchmarkHelper helper;
+  auto data = helper.makeData(nFields, nRows, stringOnly);
+  suspender.dismiss();
+
+  for (int i = 0; i < nIters; ++i) {
+    UnsafeRowBatchSerializer serializer(data);
+    std::vector<char> buffer(serializer.totalSize());
+    serializer.serialize(buffer.data());
+    folly::doNotOptimizeAway(buffer);
+  }
+  return nIters * nFields * nRows;
+}
+
+int deserialize(
+    int nIters,
+    int nFields,
+    int nRows,
+    bool stringOnly,
+    bool batch) {
+  folly::BenchmarkSuspender suspender;
+  BenchmarkHelper helper;
+  auto data = helper.makeData(nFields, nRows, stringOnly);
+  auto rowType = asRowType(data->type());
+  UnsafeRowBatchSerializer serializer(data);
+  std::vector<char> buffer(serializer.totalSize());
+  serializer.serialize(buffer.data());
+  std::vector<std::optional<std::string_view>> rows;
+  std::vector<const char*> rowPointers;
+  for (auto row = 0; row < nRows; ++row) {
+    rows.emplace_back(std::string_view(
+        buffer.data() + serializer.rowOffset(row), serializer.rowSize(row)));
+    rowPointers.push_back(buffer.data() + serializer.rowOffset(row));
+  }
+  auto deserializer = UnsafeRow24Deserializer::Create(rowType);
+  suspender.dismiss();
+
+  for (int i = 0; i < nIters; ++i) {
+    if (batch) {
+      folly::doNotOptimizeAway(
+          deserializer->DeserializeRows(helper.pool(), rowPointers));
+    } else {
+      folly::doNotOptimizeAway(
+          UnsafeRowDynamicVectorDeserializer::deserializeComplex(
+              rows, rowType, helper.pool()));
+    }
+  }
+  return nIters * nFields * nRows;
+}
+
+BENCHMARK_NAMED_PARAM_MULTI(
+    serializeRows,
+    row_10_100k_string_only,
+    10,
+    100000,
+    true);
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    serializeBatch,
+    batch_10_100k_string_only,
+    10,
+    100000,
+    true);
+
+BENCHMARK_NAMED_PARAM_MULTI(
+    serializeRows,
+    row_100_100k_string_only,
+    100,
+    100000,
+    true);
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    serializeBatch,
+    batch_100_100k_string_only,
+    100,
+    100000,
+    true);
+
+BENCHMARK_NAMED_PARAM_MULTI(
+    serializeRows,
+    row_10_100k_all_types,
+    10,
+    100000,
+    false);
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    serializeBatch,
+    batch_10_100k_all_types,
+    10,
+    100000,
+    false);
+
+BENCHMARK_NAMED_PARAM_MULTI(
+    serializeRows,
+    row_100_100k_all_types,
+    100,
+    100000,
+    false);
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    serializeBatch,
+    batch_100_100k_all_types,
+    100,
+    100000,
+    false);
+
+BENCHMARK_NAMED_PARAM_MULTI(
+    deserialize,
+    deserialize_row_10_100k_string_only,
+    10,
+    100000,
+    true,
+    false);
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    deserialize,
+    deserialize_batch_10_100k_string_only,
+    10,
+    100000,
+    true,
+    true);
+
+BENCHMARK_NAMED_PARAM_MULTI(
+    deserialize,
+    deserialize_row_10_100k_all_types,
+    10,
+    100000,
+    false,
+    false);
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(
+    deserialize,
+    deserialize_batch_10_100k_all_types,
+    10,
+    100000,
+    false,
+    true);
+
+} // namespace
+} // namespace facebook::spark::benchmarks
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -19,7 +19,9 @@
 #include <folly/Random.h>
 #include <folly/init/Init.h>
 
+#include "velox/row/UnsafeRow24Deserializer.h"
 #include "velox/row/UnsafeRowBatchDeserializer.h"
+#include "velox/row/UnsafeRowBatchSerializer.h"
 #include "velox/row/UnsafeRowDynamicSerializer.h"
 #include "velox/type/Type.h"
 #include "velox/vector/BaseVector.h"
@@ -107,5 +109,69 @@ TEST_F(UnsafeRowFuzzTests, simpleTypeRoundTripTest) {
   }
 }
 
+TEST_F(UnsafeRowFuzzTests, batchSerializer) {
+  auto rowType = ROW(
+      {BOOLEAN(),
+       TINYINT(),
+       SMALLINT(),
+       INTEGER(),
+       BIGINT(),
+       REAL(),
+       DOUBLE(),
+       VARCHAR(),
+       TIMESTAMP(),
+       DATE(),
+       ROW({VARCHAR(), INTEGER()}),
+       ARRAY(INTEGER()),
+       MAP(VARCHAR(), ARRAY(INTEGER()))});
+
+  VectorFuzzer::Options opts;
+  opts.vectorSize = 100;
+  opts.nullRatio = 0.1;
+  opts.containerHasNulls = false;
+  opts.dictionaryHasNulls = false;
+  opts.stringVariableLength = true;
+  opts.stringLength = 20;
+  opts.containerLength = 10;
+  opts.timestampPrecision =
+      VectorFuzzer::Options::TimestampPrecision::kMicroSeconds;
+
+  auto seed = folly::Random::rand32();
+  LOG(INFO) << "seed: " << seed;
+  SCOPED_TRACE(fmt::format("seed: {}", seed));
+  VectorFuzzer fuzzer(opts, pool_.get(), seed);
+
+  for (auto i = 0; i < 20; ++i) {
+    auto data = fuzzer.fuzzInputRow(rowType);
+    UnsafeRowBatchSerializer serializer(data);
+    ASSERT_EQ(serializer.numRows(), data->size());
+    std::vector<char> serialized(serializer.totalSize());
+    serializer.serialize(serialized.data());
+
+    // Each row is the same as the row written by the row at a time
+    // serializer, padded to a multiple of 8 bytes.
+    std::vector<const char*> rows;
+    for (vector_size_t row = 0; row < data->size(); ++row) {
+      clearBuffer();
+      auto rowSize =
+          UnsafeRowDynamicSerializer::serialize(rowType, data, buffer_, row);
+      const auto offset = serializer.rowOffset(row);
+      ASSERT_EQ(
+          serializer.rowSize(row),
+          UnsafeRow::alignToFieldWidth(rowSize.value()));
+      ASSERT_EQ(
+          std::memcmp(
+              buffer_, serialized.data() + offset, serializer.rowSize(row)),
+          0);
+      rows.push_back(serialized.data() + offset);
+    }
+
+    auto deserialized =
+        UnsafeRow24Deserializer::Create(rowType)->DeserializeRows(
+            pool_.get(), rows);
+    assertEqualVectors(data, deserialized);
+  }
+}
+
 } // namespace
 } // namespace facebook::velox::row
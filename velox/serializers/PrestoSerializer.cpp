@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/serializers/PrestoSerializer.h"
+#include <folly/Random.h>
 #include "velox/common/base/Crc.h"
 #include "velox/common/memory/ByteStream.h"
 #include "velox/functions/prestosql/types/TimestampWithTimeZoneType.h"
@@ -30,6 +31,7 @@ constexpr int8_t kCompressedBitMask = 1;
 constexpr int8_t kEncryptedBitMask = 2;
 constexpr int8_t kCheckSumBitMask = 4;
 constexpr folly::StringPiece kRLE{"RLE"};
+constexpr folly::StringPiece kDictionary{"DICTIONARY"};
 
 int64_t computeChecksum(
     PrestoOutputStreamListener* listener,
@@ -47,11 +49,12 @@ int64_t computeChecksum(
     ByteStream* source,
     int codecMarker,
     int numRows,
-    int uncompressedSize) {
+    int uncompressedSize,
+    int sizeInBytes) {
   auto offset = source->tellp();
   bits::Crc32 crc32;
 
-  auto remainingBytes = uncompressedSize;
+  auto remainingBytes = sizeInBytes;
   while (remainingBytes > 0) {
     auto data = source->nextView(remainingBytes);
     crc32.process_bytes(data.data(), data.size());
@@ -86,6 +89,20 @@ bool isChecksumBitSet(int8_t codec) {
   return (codec & kCheckSumBitMask) == kCheckSumBitMask;
 }
 
+std::unique_ptr<folly::io::Codec> makeCodec(
+    const VectorSerde::Options* options) {
+  if (options == nullptr) {
+    return nullptr;
+  }
+  const auto kind =
+      static_cast<const PrestoVectorSerde::PrestoOptions*>(options)
+          ->compressionKind;
+  if (kind == folly::io::CodecType::NO_COMPRESSION) {
+    return nullptr;
+  }
+  return folly::io::getCodec(kind);
+}
+
 std::string typeToEncodingName(const TypePtr& type) {
   switch (type->kind()) {
     case TypeKind::BOOLEAN:
@@ -464,6 +481,25 @@ void readConstantVector(
   *result = BaseVector::wrapInConstant(size, 0, children[0]);
 }
 
+void readDictionaryVector(
+    ByteStream* source,
+    const TypePtr& type,
+    velox::memory::MemoryPool* pool,
+    VectorPtr* result,
+    bool useLosslessTimestamp) {
+  auto size = source->read<int32_t>();
+  std::vector<TypePtr> childTypes = {type};
+  std::vector<VectorPtr> children(1);
+  readColumns(source, pool, childTypes, &children, useLosslessTimestamp);
+
+  BufferPtr indices = allocateIndices(size, pool);
+  source->readBytes(
+      indices->asMutable<uint8_t>(), size * sizeof(vector_size_t));
+  // Skip the dictionary id.
+  source->skip(3 * sizeof(int64_t));
+  *result = BaseVector::wrapInDictionary(nullptr, indices, size, children[0]);
+}
+
 void readArrayVector(
     ByteStream* source,
     std::shared_ptr<const Type> type,
@@ -738,6 +774,9 @@ void readColumns(
     if (encoding == kRLE) {
       readConstantVector(
           source, types[i], pool, &(*result)[i], useLosslessTimestamp);
+    } else if (encoding == kDictionary) {
+      readDictionaryVector(
+          source, types[i], pool, &(*result)[i], useLosslessTimestamp);
     } else {
       checkTypeEncoding(encoding, types[i]);
       auto it = readers.find(types[i]->kind());
@@ -1617,7 +1656,14 @@ class PrestoVectorSerializer : public VectorSerializer {
       std::shared_ptr<const RowType> rowType,
       int32_t numRows,
       StreamArena* streamArena,
-      bool useLosslessTimestamp) {
+      bool useLosslessTimestamp,
+      std::unique_ptr<folly::io::Codec> codec,
+      double minCompressionRatio)
+      : pool_(streamArena->pool()),
+        streamArena_(streamArena),
+        useLosslessTimestamp_(useLosslessTimestamp),
+        codec_(std::move(codec)),
+        minCompressionRatio_(minCompressionRatio) {
     auto types = rowType->children();
     auto numTypes = types.size();
     streams_.resize(numTypes);
@@ -1655,6 +1701,31 @@ class PrestoVectorSerializer : public VectorSerializer {
     flushInternal(vector->size(), true /*rle*/, out);
   }
 
+  void flushEncoded(const RowVectorPtr& vector, OutputStream* out) {
+    VELOX_CHECK_EQ(0, numRows_);
+    encodedInput_ = vector.get();
+    flushInternal(vector->size(), false /*rle*/, out);
+    encodedInput_ = nullptr;
+  }
+
+  std::unordered_map<std::string, RuntimeCounter> runtimeStats() override {
+    std::unordered_map<std::string, RuntimeCounter> stats;
+    if (codec_ == nullptr) {
+      return stats;
+    }
+    stats.emplace(
+        PrestoVectorSerde::kCompressionInputBytes,
+        RuntimeCounter(compressionInputBytes_, RuntimeCounter::Unit::kBytes));
+    stats.emplace(
+        PrestoVectorSerde::kCompressedBytes,
+        RuntimeCounter(compressedBytes_, RuntimeCounter::Unit::kBytes));
+    stats.emplace(
+        PrestoVectorSerde::kCompressionSkippedBytes,
+        RuntimeCounter(
+            compressionSkippedBytes_, RuntimeCounter::Unit::kBytes));
+    return stats;
+  }
+
   // Writes the contents to 'stream' in wire format
   void flushInternal(int32_t numRows, bool rle, OutputStream* out) {
     auto listener = dynamic_cast<PrestoOutputStreamListener*>(out->listener());
@@ -1663,6 +1734,11 @@ class PrestoVectorSerializer : public VectorSerializer {
       listener->reset();
     }
 
+    if (codec_ != nullptr) {
+      flushCompressed(numRows, rle, listener, out);
+      return;
+    }
+
     char codec = 0;
     if (listener) {
       codec = getCodecMarker();
@@ -1687,19 +1763,7 @@ class PrestoVectorSerializer : public VectorSerializer {
     if (listener) {
       listener->resume();
     }
-    writeInt32(out, streams_.size());
-
-    if (rle) {
-      // Write RLE encoding marker.
-      writeInt32(out, kRLE.size());
-      out->write(kRLE.data(), kRLE.size());
-      // Write number of RLE values.
-      writeInt32(out, numRows);
-    }
-
-    for (auto& stream : streams_) {
-      stream->flush(out);
-    }
+    writeColumns(numRows, rle, out);
 
     // Pause CRC computation
     if (listener) {
@@ -1725,8 +1789,153 @@ class PrestoVectorSerializer : public VectorSerializer {
   static const int32_t kSizeInBytesOffset{4 + 1};
   static const int32_t kHeaderSize{kSizeInBytesOffset + 4 + 4 + 8};
 
+  // Writes the number of columns and the column streams.
+  void writeColumns(int32_t numRows, bool rle, OutputStream* out) {
+    writeInt32(out, streams_.size());
+
+    if (encodedInput_ != nullptr) {
+      for (auto& child : encodedInput_->children()) {
+        writeEncodedColumn(child.get(), out);
+      }
+      return;
+    }
+
+    if (rle) {
+      // Write RLE encoding marker.
+      writeInt32(out, kRLE.size());
+      out->write(kRLE.data(), kRLE.size());
+      // Write number of RLE values.
+      writeInt32(out, numRows);
+    }
+
+    for (auto& stream : streams_) {
+      stream->flush(out);
+    }
+  }
+
+  // Writes all rows of 'vector' as one column. Constant vectors are written
+  // as RLE blocks and dictionaries that add no nulls as DICTIONARY blocks
+  // over their encoded base. Other encodings are flattened.
+  void writeEncodedColumn(const BaseVector* vector, OutputStream* out) {
+    const auto size = vector->size();
+    switch (vector->encoding()) {
+      case VectorEncoding::Simple::CONSTANT:
+        if (size > 0) {
+          writeInt32(out, kRLE.size());
+          out->write(kRLE.data(), kRLE.size());
+          writeInt32(out, size);
+          writeFlatColumn(vector, 1, out);
+          return;
+        }
+        break;
+      case VectorEncoding::Simple::DICTIONARY:
+        if (vector->rawNulls() == nullptr) {
+          writeInt32(out, kDictionary.size());
+          out->write(kDictionary.data(), kDictionary.size());
+          writeInt32(out, size);
+          writeEncodedColumn(vector->valueVector().get(), out);
+          out->write(
+              vector->wrapInfo()->as<char>(), size * sizeof(vector_size_t));
+          // Presto tells dictionaries apart by a random id.
+          writeInt64(out, folly::Random::rand64());
+          writeInt64(out, folly::Random::rand64());
+          writeInt64(out, 0);
+          return;
+        }
+        break;
+      case VectorEncoding::Simple::LAZY:
+        writeEncodedColumn(vector->loadedVector(), out);
+        return;
+      default:
+        break;
+    }
+    writeFlatColumn(vector, size, out);
+  }
+
+  // Writes the first 'numRows' rows of 'vector' as a flat column.
+  void writeFlatColumn(
+      const BaseVector* vector,
+      vector_size_t numRows,
+      OutputStream* out) {
+    VectorStream stream(
+        vector->type(), streamArena_, numRows, useLosslessTimestamp_);
+    IndexRange range{0, numRows};
+    serializeColumn(vector, folly::Range(&range, 1), &stream);
+    stream.flush(out);
+  }
+
+  // Serializes the columns to a buffer and compresses it with 'codec_'. The
+  // page is written compressed if the compression ratio is good enough,
+  // otherwise uncompressed. The checksum covers the written payload.
+  void flushCompressed(
+      int32_t numRows,
+      bool rle,
+      PrestoOutputStreamListener* listener,
+      OutputStream* out) {
+    IOBufOutputStream columns(*pool_);
+    writeColumns(numRows, rle, &columns);
+    auto uncompressed = columns.getIOBuf();
+    const int32_t uncompressedSize = uncompressed->computeChainDataLength();
+
+    auto compressed = codec_->compress(uncompressed.get());
+    const int32_t compressedSize = compressed->computeChainDataLength();
+    compressionInputBytes_ += uncompressedSize;
+    compressedBytes_ += compressedSize;
+    const bool useCompressed =
+        compressedSize <= uncompressedSize * minCompressionRatio_;
+    if (!useCompressed) {
+      compressionSkippedBytes_ += uncompressedSize;
+    }
+    const auto& payload = useCompressed ? compressed : uncompressed;
+    const int32_t sizeInBytes =
+        useCompressed ? compressedSize : uncompressedSize;
+
+    char codec = 0;
+    if (listener) {
+      codec = getCodecMarker();
+      listener->pause();
+    }
+    if (useCompressed) {
+      codec |= kCompressedBitMask;
+    }
+    const int32_t offset = out->tellp();
+    writeInt32(out, numRows);
+    out->write(&codec, 1);
+    writeInt32(out, uncompressedSize);
+    writeInt32(out, sizeInBytes);
+    writeInt64(out, 0); // Write zero checksum
+
+    if (listener) {
+      listener->resume();
+    }
+    for (const auto range : *payload) {
+      out->write(reinterpret_cast<const char*>(range.data()), range.size());
+    }
+    if (listener) {
+      listener->pause();
+      const int64_t crc =
+          computeChecksum(listener, codec, numRows, uncompressedSize);
+      out->seekp(offset + kSizeInBytesOffset + 4 + 4);
+      writeInt64(out, crc);
+      out->seekp(offset + kHeaderSize + sizeInBytes);
+    }
+  }
+
+  memory::MemoryPool* const pool_;
+  StreamArena* const streamArena_;
+  const bool useLosslessTimestamp_;
+  const std::unique_ptr<folly::io::Codec> codec_;
+  const double minCompressionRatio_;
+
   int32_t numRows_{0};
   std::vector<std::unique_ptr<VectorStream>> streams_;
+
+  // The vector whose column encodings are written by flushEncoded().
+  const RowVector* encodedInput_{nullptr};
+
+  int64_t compressionInputBytes_{0};
+  int64_t compressedBytes_{0};
+  int64_t compressionSkippedBytes_{0};
 };
 } // namespace
 
@@ -1745,8 +1954,16 @@ std::unique_ptr<VectorSerializer> PrestoVectorSerde::createSerializer(
   bool useLosslessTimestamp = options != nullptr
       ? static_cast<const PrestoOptions*>(options)->useLosslessTimestamp
       : false;
+  const double minCompressionRatio = options != nullptr
+      ? static_cast<const PrestoOptions*>(options)->minCompressionRatio
+      : PrestoOptions().minCompressionRatio;
   return std::make_unique<PrestoVectorSerializer>(
-      type, numRows, streamArena, useLosslessTimestamp);
+      type,
+      numRows,
+      streamArena,
+      useLosslessTimestamp,
+      makeCodec(options),
+      minCompressionRatio);
 }
 
 void PrestoVectorSerde::serializeConstants(
@@ -1760,6 +1977,18 @@ void PrestoVectorSerde::serializeConstants(
   static_cast<PrestoVectorSerializer*>(serializer.get())->flushRle(vector, out);
 }
 
+void PrestoVectorSerde::serializeEncoded(
+    const RowVectorPtr& vector,
+    StreamArena* streamArena,
+    const Options* options,
+    OutputStream* out) {
+  auto serializer = createSerializer(
+      asRowType(vector->type()), vector->size(), streamArena, options);
+
+  static_cast<PrestoVectorSerializer*>(serializer.get())
+      ->flushEncoded(vector, out);
+}
+
 void PrestoVectorSerde::deserialize(
     ByteStream* source,
     velox::memory::MemoryPool* pool,
@@ -1779,25 +2008,59 @@ void PrestoVectorSerde::deserialize(
 
   auto pageCodecMarker = source->read<int8_t>();
   auto uncompressedSize = source->read<int32_t>();
-  // skip size in bytes
-  source->skip(4);
+  auto sizeInBytes = source->read<int32_t>();
   auto checksum = source->read<int64_t>();
 
   int64_t actualCheckSum = 0;
   if (isChecksumBitSet(pageCodecMarker)) {
-    actualCheckSum =
-        computeChecksum(source, pageCodecMarker, numRows, uncompressedSize);
+    actualCheckSum = computeChecksum(
+        source, pageCodecMarker, numRows, uncompressedSize, sizeInBytes);
   }
 
   VELOX_CHECK_EQ(
       checksum, actualCheckSum, "Received corrupted serialized page.");
 
-  // skip number of columns
-  source->skip(4);
-
   auto children = &(*result)->children();
   auto childTypes = type->as<TypeKind::ROW>().children();
-  readColumns(source, pool, childTypes, children, useLosslessTimestamp);
+  if (!isCompressedBitSet(pageCodecMarker)) {
+    // skip number of columns
+    source->skip(4);
+    readColumns(source, pool, childTypes, children, useLosslessTimestamp);
+    return;
+  }
+
+  auto codec = makeCodec(options);
+  VELOX_CHECK_NOT_NULL(
+      codec, "Compressed page received without a configured codec");
+  auto compressed = folly::IOBuf::create(sizeInBytes);
+  source->readBytes(compressed->writableData(), sizeInBytes);
+  compressed->append(sizeInBytes);
+  auto uncompressed = codec->uncompress(compressed.get(), uncompressedSize);
+  uncompressed->coalesce();
+  VELOX_CHECK_EQ(uncompressed->length(), uncompressedSize);
+
+  ByteStream uncompressedSource;
+  uncompressedSource.resetInput({ByteRange{
+      uncompressed->writableData(), (int32_t)uncompressed->length(), 0}});
+  // skip number of columns
+  uncompressedSource.skip(4);
+  readColumns(
+      &uncompressedSource, pool, childTypes, children, useLosslessTimestamp);
+}
+
+// static
+folly::io::CodecType PrestoVectorSerde::compressionKindFromName(
+    const std::string& name) {
+  if (name == "none") {
+    return folly::io::CodecType::NO_COMPRESSION;
+  }
+  if (name == "lz4") {
+    return folly::io::CodecType::LZ4;
+  }
+  if (name == "zstd") {
+    return folly::io::CodecType::ZSTD;
+  }
+  VELOX_USER_FAIL("Unsupported page compression codec: {}", name);
 }
 
 // static
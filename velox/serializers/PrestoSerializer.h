@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 #pragma once
+#include <folly/compression/Compression.h>
+
 #include "velox/common/base/Crc.h"
 #include "velox/vector/VectorStream.h"
 
@@ -22,15 +24,47 @@ class PrestoVectorSerde : public VectorSerde {
  public:
   // Input options that the serializer recognizes.
   struct PrestoOptions : VectorSerde::Options {
-    explicit PrestoOptions(bool useLosslessTimestamp)
-        : useLosslessTimestamp(useLosslessTimestamp) {}
+    PrestoOptions() = default;
+
+    explicit PrestoOptions(
+        bool useLosslessTimestamp,
+        folly::io::CodecType compressionKind =
+            folly::io::CodecType::NO_COMPRESSION)
+        : useLosslessTimestamp(useLosslessTimestamp),
+          compressionKind(compressionKind) {}
+
     // Currently presto only supports millisecond precision and the serializer
     // converts velox native timestamp to that resulting in loss of precision.
     // This option allows it to serialize with nanosecond precision and is
     // currently used for spilling. Is false by default.
     bool useLosslessTimestamp{false};
+
+    // The codec the pages are compressed with. As in Presto, a compressed
+    // page only sets the compressed bit of its codec marker, so the reader
+    // must be configured with the same codec. LZ4 pages are raw LZ4 blocks
+    // and ZSTD pages are ZSTD frames, which is what Presto writes.
+    folly::io::CodecType compressionKind{folly::io::CodecType::NO_COMPRESSION};
+
+    // A page is written uncompressed if compression doesn't shrink it to at
+    // most this fraction of its uncompressed size.
+    double minCompressionRatio{0.8};
   };
 
+  // Names of the serializer runtime stats.
+  //
+  // The uncompressed bytes of the pages that have been compressed.
+  static constexpr const char* kCompressionInputBytes = "compressionInputBytes";
+  // The compressed bytes of the pages that have been compressed.
+  static constexpr const char* kCompressedBytes = "compressedBytes";
+  // The uncompressed bytes of the pages that are written uncompressed as the
+  // compression ratio is poor.
+  static constexpr const char* kCompressionSkippedBytes =
+      "compressionSkippedBytes";
+
+  // Returns the page codec for 'name' which is one of 'none', 'lz4' or
+  // 'zstd'. Throws if 'name' is unknown.
+  static folly::io::CodecType compressionKindFromName(const std::string& name);
+
   void estimateSerializedSize(
       std::shared_ptr<BaseVector> vector,
       const folly::Range<const IndexRange*>& ranges,
@@ -49,6 +83,16 @@ class PrestoVectorSerde : public VectorSerde {
       const Options* options,
       OutputStream* out);
 
+  /// Serializes 'vector' as one page that keeps the encodings of its
+  /// children. Constant children are written as RLE blocks and dictionaries
+  /// that add no nulls as DICTIONARY blocks, which deserialize() reads back
+  /// as constant and dictionary vectors. Other children are flattened.
+  void serializeEncoded(
+      const RowVectorPtr& vector,
+      StreamArena* streamArena,
+      const Options* options,
+      OutputStream* out);
+
   void deserialize(
       ByteStream* source,
       velox::memory::MemoryPool* pool,
@@ -20,10 +20,23 @@
 namespace facebook::velox::serializer::spark {
 
 void UnsafeRowVectorSerde::estimateSerializedSize(
-    VectorPtr /* vector */,
-    const folly::Range<const IndexRange*>& /* ranges */,
-    vector_size_t** /* sizes */) {
-  VELOX_UNSUPPORTED();
+    VectorPtr vector,
+    const folly::Range<const IndexRange*>& ranges,
+    vector_size_t** sizes) {
+  const auto& type = vector->type();
+  // A variable width value takes a field width slot in the row and its data
+  // aligned to field width after the fixed width part of the row.
+  const size_t slotSize =
+      type->isFixedWidth() ? 0 : velox::row::UnsafeRow::kFieldWidthBytes;
+  for (auto i = 0; i < ranges.size(); ++i) {
+    const auto end = ranges[i].begin + ranges[i].size;
+    for (auto row = ranges[i].begin; row < end; ++row) {
+      *sizes[i] += slotSize +
+          velox::row::UnsafeRow::alignToFieldWidth(
+                       velox::row::UnsafeRowDynamicSerializer::getSize(
+                           type, vector, row));
+    }
+  }
 }
 
 namespace {
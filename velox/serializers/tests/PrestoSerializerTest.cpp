@@ -368,6 +368,61 @@ TEST_F(PrestoSerializerTest, rle) {
       MAP(VARCHAR(), INTEGER()), 17, pool_.get()));
 }
 
+TEST_F(PrestoSerializerTest, encodings) {
+  constexpr vector_size_t kSize = 100;
+  auto base = vectorMaker_->flatVector<StringView>(
+      {"apple", "banana", "cherry", "a string longer than inline"});
+  BufferPtr indices = allocateIndices(kSize, pool_.get());
+  auto rawIndices = indices->asMutable<vector_size_t>();
+  for (auto i = 0; i < kSize; ++i) {
+    rawIndices[i] = i % base->size();
+  }
+  auto dictionary = BaseVector::wrapInDictionary(nullptr, indices, kSize, base);
+  auto nestedDictionary = BaseVector::wrapInDictionary(
+      nullptr,
+      indices,
+      kSize,
+      BaseVector::wrapInDictionary(
+          nullptr,
+          indices,
+          kSize,
+          vectorMaker_->arrayVector<int64_t>({{1, 2}, {}, {3}, {4, 5, 6}})));
+  auto constant =
+      BaseVector::createConstant(VARCHAR(), "constant", kSize, pool_.get());
+  auto flat = vectorMaker_->flatVector<int64_t>(
+      kSize, [](auto row) { return row; }, VectorMaker::nullEvery(7));
+
+  BufferPtr nulls = allocateNulls(kSize, pool_.get());
+  bits::setNull(nulls->asMutable<uint64_t>(), 3);
+  auto dictionaryWithNulls =
+      BaseVector::wrapInDictionary(nulls, indices, kSize, base);
+
+  auto rowVector = vectorMaker_->rowVector(
+      {dictionary, nestedDictionary, constant, flat, dictionaryWithNulls});
+  std::ostringstream output;
+  serializer::presto::PrestoOutputStreamListener listener;
+  OStreamOutputStream out(&output, &listener);
+  auto arena = std::make_unique<StreamArena>(pool_.get());
+  serde_->serializeEncoded(rowVector, arena.get(), nullptr, &out);
+
+  auto deserialized =
+      deserialize(asRowType(rowVector->type()), output.str(), nullptr);
+  assertEqualVectors(rowVector, deserialized);
+
+  ASSERT_EQ(
+      deserialized->childAt(0)->encoding(),
+      VectorEncoding::Simple::DICTIONARY);
+  ASSERT_EQ(deserialized->childAt(0)->valueVector()->size(), base->size());
+  ASSERT_EQ(
+      deserialized->childAt(1)->valueVector()->encoding(),
+      VectorEncoding::Simple::DICTIONARY);
+  ASSERT_EQ(
+      deserialized->childAt(2)->encoding(), VectorEncoding::Simple::CONSTANT);
+  ASSERT_EQ(deserialized->childAt(3)->encoding(), VectorEncoding::Simple::FLAT);
+  // A dictionary that adds nulls is flattened.
+  ASSERT_EQ(deserialized->childAt(4)->encoding(), VectorEncoding::Simple::FLAT);
+}
+
 TEST_F(PrestoSerializerTest, lazy) {
   constexpr int kSize = 1000;
   auto rowVector = makeTestVector(kSize);
@@ -378,3 +433,77 @@ TEST_F(PrestoSerializerTest, lazy) {
       std::make_unique<SimpleVectorLoader>([&](auto) { return rowVector; }));
   testRoundTrip(lazyVector);
 }
+
+TEST_F(PrestoSerializerTest, compression) {
+  using PrestoOptions = serializer::presto::PrestoVectorSerde::PrestoOptions;
+  for (auto kind : {folly::io::CodecType::LZ4, folly::io::CodecType::ZSTD}) {
+    if (!folly::io::hasCodec(kind)) {
+      continue;
+    }
+    SCOPED_TRACE(folly::io::getCodec(kind)->name());
+    PrestoOptions options(false, kind);
+    // A run of small integers compresses well.
+    auto rowVector = makeTestVector(10'000);
+    std::ostringstream out;
+    serialize(rowVector, &out, &options);
+    const auto serialized = out.str();
+    // The compressed bit of the page codec marker is set.
+    ASSERT_EQ(serialized[4] & 1, 1);
+    assertEqualVectors(
+        deserialize(asRowType(rowVector->type()), serialized, &options),
+        rowVector);
+
+    // A compressed page can't be read without the codec.
+    VELOX_ASSERT_THROW(
+        deserialize(asRowType(rowVector->type()), serialized, nullptr),
+        "Compressed page received without a configured codec");
+
+    // The page is written uncompressed if the compression ratio is poor.
+    options.minCompressionRatio = 0;
+    std::ostringstream uncompressedOut;
+    serialize(rowVector, &uncompressedOut, &options);
+    const auto uncompressed = uncompressedOut.str();
+    ASSERT_EQ(uncompressed[4] & 1, 0);
+    ASSERT_GT(uncompressed.size(), serialized.size());
+    assertEqualVectors(
+        deserialize(asRowType(rowVector->type()), uncompressed, &options),
+        rowVector);
+  }
+}
+
+TEST_F(PrestoSerializerTest, compressionStats) {
+  using PrestoVectorSerde = serializer::presto::PrestoVectorSerde;
+  if (!folly::io::hasCodec(folly::io::CodecType::ZSTD)) {
+    return;
+  }
+  PrestoVectorSerde::PrestoOptions options(false, folly::io::CodecType::ZSTD);
+  auto rowVector = makeTestVector(1'000);
+  std::vector<IndexRange> rows{{0, rowVector->size()}};
+  auto arena = std::make_unique<StreamArena>(pool_.get());
+  auto serializer = serde_->createSerializer(
+      asRowType(rowVector->type()), rowVector->size(), arena.get(), &options);
+  serializer->append(rowVector, folly::Range(rows.data(), rows.size()));
+  std::ostringstream output;
+  OStreamOutputStream out(&output, nullptr);
+  serializer->flush(&out);
+
+  auto stats = serializer->runtimeStats();
+  const auto inputBytes =
+      stats.at(PrestoVectorSerde::kCompressionInputBytes).value;
+  const auto compressedBytes =
+      stats.at(PrestoVectorSerde::kCompressedBytes).value;
+  ASSERT_GT(inputBytes, compressedBytes);
+  ASSERT_EQ(stats.at(PrestoVectorSerde::kCompressionSkippedBytes).value, 0);
+  // The page is the header followed by the compressed columns.
+  ASSERT_EQ(output.str().size(), compressedBytes + 21);
+
+  ASSERT_EQ(
+      PrestoVectorSerde::compressionKindFromName("zstd"),
+      folly::io::CodecType::ZSTD);
+  ASSERT_EQ(
+      PrestoVectorSerde::compressionKindFromName("none"),
+      folly::io::CodecType::NO_COMPRESSION);
+  VELOX_ASSERT_THROW(
+      PrestoVectorSerde::compressionKindFromName("gzip"),
+      "Unsupported page compression codec: gzip");
+}
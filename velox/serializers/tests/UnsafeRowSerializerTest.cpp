@@ -116,3 +116,24 @@ TEST_F(UnsafeRowSerializerTest, types) {
   auto data = fuzzer.fuzzRow(rowType);
   testRoundTrip(data);
 }
+
+TEST_F(UnsafeRowSerializerTest, estimateSerializedSize) {
+  test::VectorMaker maker(pool_.get());
+  auto data = maker.rowVector(
+      {maker.flatVector<int64_t>({1, 2, 3}),
+       maker.flatVector<std::string>({"a", "a string longer than 8", ""})});
+  std::vector<IndexRange> ranges{{0, 1}, {1, 2}};
+  std::vector<vector_size_t> sizes(ranges.size(), 0);
+  std::vector<vector_size_t*> sizePointers{&sizes[0], &sizes[1]};
+  for (const auto& child : data->children()) {
+    serde_->estimateSerializedSize(
+        child, folly::Range(ranges.data(), ranges.size()), sizePointers.data());
+  }
+  ASSERT_EQ(sizes[0], 8 + 8 + 8);
+  ASSERT_EQ(sizes[1], 8 + 8 + 24 + 8 + 8);
+
+  // Each serialized row also has its size and its null flags.
+  std::ostringstream out;
+  serialize(data, &out);
+  ASSERT_EQ(sizes[0] + sizes[1] + 3 * (8 + 8), out.str().size());
+}
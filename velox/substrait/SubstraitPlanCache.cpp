@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/substrait/SubstraitPlanCache.h"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+namespace facebook::velox::substrait {
+
+// static
+std::string SubstraitPlanCache::fingerprint(
+    const ::substrait::Plan& substraitPlan) {
+  // The default serialization does not guarantee the order of map entries,
+  // which would give equal plans different keys.
+  std::string serialized;
+  {
+    google::protobuf::io::StringOutputStream stringStream(&serialized);
+    google::protobuf::io::CodedOutputStream codedStream(&stringStream);
+    codedStream.SetSerializationDeterministic(true);
+    VELOX_CHECK(
+        substraitPlan.SerializeToCodedStream(&codedStream),
+        "Failed to serialize Substrait plan");
+  }
+  return serialized;
+}
+
+std::shared_ptr<const SubstraitPlanCache::ConvertedPlan>
+SubstraitPlanCache::toVeloxPlan(const ::substrait::Plan& substraitPlan) {
+  auto key = fingerprint(substraitPlan);
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (auto* cached = cache_.get(key)) {
+      auto result = *cached;
+      cache_.release(key);
+      return result;
+    }
+  }
+
+  // Convert outside of the lock. Concurrent misses on the same plan may
+  // convert it more than once, in which case the first result is kept.
+  SubstraitVeloxPlanConverter converter(pool_);
+  auto converted = std::make_shared<ConvertedPlan>();
+  converted->plan = converter.toVeloxPlan(substraitPlan);
+  converted->splitInfos = converter.splitInfos();
+  std::shared_ptr<const ConvertedPlan> result = std::move(converted);
+
+  std::lock_guard<std::mutex> l(mutex_);
+  if (auto* cached = cache_.get(key)) {
+    result = *cached;
+    cache_.release(key);
+    return result;
+  }
+  auto value = std::make_unique<std::shared_ptr<const ConvertedPlan>>(result);
+  if (cache_.add(std::move(key), value.get(), 1)) {
+    value.release();
+  }
+  return result;
+}
+
+} // namespace facebook::velox::substrait
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <mutex>
+
+#include "velox/common/caching/SimpleLRUCache.h"
+#include "velox/substrait/SubstraitToVeloxPlan.h"
+
+namespace facebook::velox::substrait {
+
+/// Caches the result of converting Substrait plans into Velox plans. Engines
+/// such as Gluten send the same plan fragment for many tasks that differ only
+/// in their splits. Converting the fragment once and sharing the immutable
+/// plan tree removes the conversion from the per-task setup. Splits and other
+/// per-task parameters must be passed to the task separately, since they are
+/// not part of a cached plan.
+///
+/// Plans are keyed by a fingerprint of their deterministic serialization, so
+/// two plans hit the same entry only if they are identical. Constants in the
+/// converted plans are allocated from the pool passed to the constructor,
+/// which must outlive the cache and all plans returned from it. Thread-safe.
+class SubstraitPlanCache {
+ public:
+  struct ConvertedPlan {
+    core::PlanNodePtr plan;
+
+    /// Mapping from leaf plan node ID to the splits found in the plan.
+    std::unordered_map<
+        core::PlanNodeId,
+        std::shared_ptr<SubstraitVeloxPlanConverter::SplitInfo>>
+        splitInfos;
+  };
+
+  /// Keeps up to 'maxEntries' converted plans, evicting the least recently
+  /// used ones.
+  explicit SubstraitPlanCache(
+      memory::MemoryPool* pool,
+      size_t maxEntries = 1'000)
+      : pool_(pool), cache_(maxEntries) {}
+
+  /// Returns the Velox plan for 'substraitPlan', converting it on a miss.
+  std::shared_ptr<const ConvertedPlan> toVeloxPlan(
+      const ::substrait::Plan& substraitPlan);
+
+  SimpleLRUCacheStats stats() const {
+    std::lock_guard<std::mutex> l(mutex_);
+    return cache_.getStats();
+  }
+
+  /// Returns the key under which 'substraitPlan' is cached.
+  static std::string fingerprint(const ::substrait::Plan& substraitPlan);
+
+ private:
+  memory::MemoryPool* const pool_;
+
+  mutable std::mutex mutex_;
+
+  SimpleLRUCache<std::string, std::shared_ptr<const ConvertedPlan>> cache_;
+};
+
+} // namespace facebook::velox::substrait
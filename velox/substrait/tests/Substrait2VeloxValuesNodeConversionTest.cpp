@@ -22,6 +22,7 @@
 #include "velox/exec/tests/utils/PlanBuilder.h"
 #include "velox/vector/tests/utils/VectorTestBase.h"
 
+#include "velox/substrait/SubstraitPlanCache.h"
 #include "velox/substrait/SubstraitToVeloxPlan.h"
 
 using namespace facebook::velox;
@@ -60,3 +61,43 @@ TEST_F(Substrait2VeloxValuesNodeConversionTest, valuesNode) {
   createDuckDbTable({expectedData});
   assertQuery(veloxPlan, "SELECT * FROM tmp");
 }
+
+TEST_F(Substrait2VeloxValuesNodeConversionTest, planCache) {
+  auto readPlan = [](const std::string& fileName) {
+    ::substrait::Plan substraitPlan;
+    JsonToProtoConverter::readFromFile(
+        getDataFilePath("velox/substrait/tests", "data/" + fileName),
+        substraitPlan);
+    return substraitPlan;
+  };
+  auto valuesPlan = readPlan("substrait_virtualTable.json");
+  auto q6Plan = readPlan("q6_first_stage.json");
+
+  SubstraitPlanCache cache(pool_.get(), 1);
+  auto first = cache.toVeloxPlan(valuesPlan);
+  auto second = cache.toVeloxPlan(valuesPlan);
+  ASSERT_EQ(first, second);
+  ASSERT_EQ(cache.stats().numHits, 1);
+
+  // A different plan evicts the only entry.
+  auto q6 = cache.toVeloxPlan(q6Plan);
+  ASSERT_NE(q6->plan, first->plan);
+  ASSERT_EQ(q6->splitInfos.size(), 1);
+  auto third = cache.toVeloxPlan(valuesPlan);
+  ASSERT_NE(third, first);
+  ASSERT_EQ(cache.stats().numHits, 1);
+  ASSERT_EQ(cache.stats().numElements, 1);
+
+  // An evicted plan remains usable.
+  auto expectedData = makeRowVector(
+      {makeFlatVector<int64_t>(
+           {2499109626526694126, 2342493223442167775, 4077358421272316858}),
+       makeFlatVector<int32_t>({581869302, -708632711, -133711905}),
+       makeFlatVector<double>(
+           {0.90579193414549275, 0.96886777112423139, 0.63235925003444637}),
+       makeFlatVector<bool>({true, false, false}),
+       makeFlatVector<int32_t>(3, nullptr, nullEvery(1))});
+  createDuckDbTable({expectedData});
+  assertQuery(first->plan, "SELECT * FROM tmp");
+  assertQuery(third->plan, "SELECT * FROM tmp");
+}
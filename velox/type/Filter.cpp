@@ -86,6 +86,9 @@ std::string Filter::toString() const {
     case FilterKind::kMultiRange:
       strKind = "MultiRange";
       break;
+    case FilterKind::kHashBloomFilter:
+      strKind = "HashBloomFilter";
+      break;
   };
 
   return fmt::format(
@@ -560,6 +563,28 @@ bool BytesRange::testBytesRange(
   return true;
 }
 
+xsimd::batch_bool<int32_t> BytesValues::testLengths(
+    xsimd::batch<int32_t> lengths) const {
+  auto small = lengths < xsimd::broadcast<int32_t>(kNumSmallLengths);
+  auto result = simd::maskGather(
+      xsimd::broadcast<int32_t>(0), small, smallLengths_.data(), lengths);
+  uint16_t large = simd::allSetBitMask<int32_t>() ^ simd::toBitMask(small);
+  if (LIKELY(!large)) {
+    return result != xsimd::broadcast<int32_t>(0);
+  }
+  auto resultBits = simd::toBitMask(result != xsimd::broadcast<int32_t>(0));
+  constexpr int kAlign = xsimd::default_arch::alignment();
+  alignas(kAlign) int32_t lengthsArray[xsimd::batch<int32_t>::size];
+  lengths.store_aligned(lengthsArray);
+  while (large) {
+    auto lane = bits::getAndClearLastSetBit(large);
+    if (lengths_.contains(lengthsArray[lane])) {
+      resultBits |= 1 << lane;
+    }
+  }
+  return simd::fromBitMask<int32_t>(resultBits);
+}
+
 bool BytesValues::testBytesRange(
     std::optional<std::string_view> min,
     std::optional<std::string_view> max,
@@ -816,6 +841,7 @@ std::unique_ptr<Filter> MultiRange::mergeWith(const Filter* other) const {
     // =>MultiRange(nullAllowed=false)
     case FilterKind::kAlwaysTrue:
     case FilterKind::kAlwaysFalse:
+    case FilterKind::kHashBloomFilter:
     case FilterKind::kIsNull:
     case FilterKind::kNegatedBytesRange:
       return other->mergeWith(this);
@@ -1095,6 +1121,7 @@ std::unique_ptr<Filter> BigintRange::mergeWith(const Filter* other) const {
   switch (other->kind()) {
     case FilterKind::kAlwaysTrue:
     case FilterKind::kAlwaysFalse:
+    case FilterKind::kHashBloomFilter:
     case FilterKind::kIsNull:
       return other->mergeWith(this);
     case FilterKind::kIsNotNull:
@@ -1163,6 +1190,7 @@ std::unique_ptr<Filter> NegatedBigintRange::mergeWith(
   switch (other->kind()) {
     case FilterKind::kAlwaysTrue:
     case FilterKind::kAlwaysFalse:
+    case FilterKind::kHashBloomFilter:
     case FilterKind::kIsNull:
       return other->mergeWith(this);
     case FilterKind::kIsNotNull:
@@ -1256,6 +1284,7 @@ std::unique_ptr<Filter> BigintValuesUsingHashTable::mergeWith(
   switch (other->kind()) {
     case FilterKind::kAlwaysTrue:
     case FilterKind::kAlwaysFalse:
+    case FilterKind::kHashBloomFilter:
     case FilterKind::kIsNull:
       return other->mergeWith(this);
     case FilterKind::kIsNotNull:
@@ -1347,6 +1376,7 @@ std::unique_ptr<Filter> BigintValuesUsingBitmask::mergeWith(
   switch (other->kind()) {
     case FilterKind::kAlwaysTrue:
     case FilterKind::kAlwaysFalse:
+    case FilterKind::kHashBloomFilter:
     case FilterKind::kIsNull:
       return other->mergeWith(this);
     case FilterKind::kIsNotNull:
@@ -1430,6 +1460,7 @@ std::unique_ptr<Filter> NegatedBigintValuesUsingHashTable::mergeWith(
   switch (other->kind()) {
     case FilterKind::kAlwaysTrue:
     case FilterKind::kAlwaysFalse:
+    case FilterKind::kHashBloomFilter:
     case FilterKind::kIsNull:
       return other->mergeWith(this);
     case FilterKind::kIsNotNull:
@@ -1469,6 +1500,7 @@ std::unique_ptr<Filter> NegatedBigintValuesUsingBitmask::mergeWith(
   switch (other->kind()) {
     case FilterKind::kAlwaysTrue:
     case FilterKind::kAlwaysFalse:
+    case FilterKind::kHashBloomFilter:
     case FilterKind::kIsNull:
       return other->mergeWith(this);
     case FilterKind::kIsNotNull:
@@ -1504,6 +1536,7 @@ std::unique_ptr<Filter> BigintMultiRange::mergeWith(const Filter* other) const {
   switch (other->kind()) {
     case FilterKind::kAlwaysTrue:
     case FilterKind::kAlwaysFalse:
+    case FilterKind::kHashBloomFilter:
     case FilterKind::kIsNull:
       return other->mergeWith(this);
     case FilterKind::kIsNotNull: {
@@ -1585,6 +1618,7 @@ std::unique_ptr<Filter> BytesRange::mergeWith(const Filter* other) const {
   switch (other->kind()) {
     case FilterKind::kAlwaysTrue:
     case FilterKind::kAlwaysFalse:
+    case FilterKind::kHashBloomFilter:
     case FilterKind::kIsNull:
       return other->mergeWith(this);
     case FilterKind::kIsNotNull:
@@ -1664,6 +1698,7 @@ std::unique_ptr<Filter> NegatedBytesRange::mergeWith(
   switch (other->kind()) {
     case FilterKind::kAlwaysTrue:
     case FilterKind::kAlwaysFalse:
+    case FilterKind::kHashBloomFilter:
     case FilterKind::kIsNull:
       return other->mergeWith(this);
     case FilterKind::kIsNotNull:
@@ -1686,6 +1721,7 @@ std::unique_ptr<Filter> BytesValues::mergeWith(const Filter* other) const {
   switch (other->kind()) {
     case FilterKind::kAlwaysTrue:
     case FilterKind::kAlwaysFalse:
+    case FilterKind::kHashBloomFilter:
     case FilterKind::kIsNull:
     case FilterKind::kMultiRange:
       return other->mergeWith(this);
@@ -1798,6 +1834,7 @@ std::unique_ptr<Filter> NegatedBytesValues::mergeWith(
   switch (other->kind()) {
     case FilterKind::kAlwaysTrue:
     case FilterKind::kAlwaysFalse:
+    case FilterKind::kHashBloomFilter:
     case FilterKind::kIsNull:
     case FilterKind::kBytesValues:
     case FilterKind::kNegatedBytesRange:
@@ -1894,4 +1931,28 @@ std::unique_ptr<Filter> NegatedBytesValues::mergeWith(
       VELOX_UNREACHABLE();
   }
 }
+
+std::unique_ptr<Filter> HashBloomFilter::mergeWith(const Filter* other) const {
+  switch (other->kind()) {
+    case FilterKind::kAlwaysTrue:
+    case FilterKind::kAlwaysFalse:
+    case FilterKind::kIsNull:
+      return other->mergeWith(this);
+    case FilterKind::kIsNotNull:
+      return this->clone(false);
+    default: {
+      // The Bloom filter can't be combined with other filters, so the values
+      // are tested against both this filter and a merged base filter.
+      const bool bothNullAllowed = nullAllowed_ && other->testNull();
+      std::unique_ptr<Filter> merged =
+          baseFilter_ ? baseFilter_->mergeWith(other) : other->clone();
+      if (merged->kind() == FilterKind::kAlwaysFalse ||
+          merged->kind() == FilterKind::kIsNull) {
+        return merged;
+      }
+      return std::make_unique<HashBloomFilter>(
+          bloomFilter_, hashKind_, bothNullAllowed, std::move(merged));
+    }
+  }
+}
 } // namespace facebook::velox::common
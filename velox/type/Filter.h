@@ -16,6 +16,7 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <memory>
 #include <sstream>
@@ -25,9 +26,11 @@
 #include <folly/Range.h>
 #include <folly/container/F14Set.h>
 
+#include "velox/common/base/BloomFilter.h"
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/SimdUtil.h"
 #include "velox/type/StringView.h"
+#include "velox/type/Type.h"
 #include "velox/type/UnscaledShortDecimal.h"
 
 namespace facebook::velox::common {
@@ -52,6 +55,7 @@ enum class FilterKind {
   kNegatedBytesValues,
   kBigintMultiRange,
   kMultiRange,
+  kHashBloomFilter,
 };
 
 /**
@@ -1479,7 +1483,11 @@ class BytesValues final : public Filter {
     VELOX_CHECK(!values.empty(), "values must not be empty");
 
     for (const auto& value : values) {
-      lengths_.insert(value.size());
+      if (value.size() < kNumSmallLengths) {
+        smallLengths_[value.size()] = -1;
+      } else {
+        lengths_.insert(value.size());
+      }
       values_.insert(value);
     }
 
@@ -1492,7 +1500,8 @@ class BytesValues final : public Filter {
         lower_(other.lower_),
         upper_(other.upper_),
         values_(other.values_),
-        lengths_(other.lengths_) {}
+        lengths_(other.lengths_),
+        smallLengths_(other.smallLengths_) {}
 
   std::unique_ptr<Filter> clone(
       std::optional<bool> nullAllowed = std::nullopt) const final {
@@ -1503,13 +1512,24 @@ class BytesValues final : public Filter {
     }
   }
 
+  bool hasTestLength() const final {
+    return true;
+  }
+
   bool testLength(int32_t length) const final {
+    if (length < kNumSmallLengths) {
+      return smallLengths_[length];
+    }
     return lengths_.contains(length);
   }
 
+  xsimd::batch_bool<int32_t> testLengths(
+      xsimd::batch<int32_t> lengths) const final;
+
   bool testBytes(const char* value, int32_t length) const final {
-    return lengths_.contains(length) &&
-        values_.contains(std::string(value, length));
+    // Looks up the value without copying it to a std::string.
+    return testLength(length) &&
+        values_.contains(std::string_view(value, length));
   }
 
   bool testBytesRange(
@@ -1526,8 +1546,15 @@ class BytesValues final : public Filter {
  private:
   std::string lower_;
   std::string upper_;
+  // Lengths below this are looked up in 'smallLengths_'.
+  static constexpr int32_t kNumSmallLengths = 64;
+
   folly::F14FastSet<std::string> values_;
+  // The lengths of the values of at least kNumSmallLengths bytes.
   folly::F14FastSet<uint32_t> lengths_;
+  // -1 at the lengths of the values of less than kNumSmallLengths bytes, 0
+  // elsewhere. This is gathered from for testing a batch of lengths at a time.
+  std::array<int32_t, kNumSmallLengths> smallLengths_{};
 };
 
 /// Represents a combination of two of more range filters on integral types with
@@ -1672,6 +1699,145 @@ class MultiRange final : public Filter {
   const bool nanAllowed_;
 };
 
+/// Tests whether the hash of a value may be in a set of hashes represented by
+/// a Bloom filter. Used for dynamic filters on join keys that don't map to
+/// ranges or value sets, e.g. join keys of high cardinality. The filter has
+/// false positives, so it can only be used where passing extra values is
+/// harmless. Values are hashed with folly::hasher of 'hashKind' to match the
+/// hashes computed by the hash join. Supports integral and string data
+/// types. A filter on the same values can be combined with this filter by
+/// mergeWith().
+class HashBloomFilter final : public Filter {
+ public:
+  /// @param bloomFilter The Bloom filter over the hashes of the values that
+  /// pass.
+  /// @param hashKind The type the values are hashed as. One of the integral
+  /// types, VARCHAR or VARBINARY.
+  /// @param nullAllowed Null values are passing the filter if true.
+  /// @param baseFilter Optional filter the values must also pass.
+  HashBloomFilter(
+      std::shared_ptr<const BloomFilter<>> bloomFilter,
+      TypeKind hashKind,
+      bool nullAllowed,
+      std::shared_ptr<const Filter> baseFilter = nullptr)
+      : Filter(true, nullAllowed, FilterKind::kHashBloomFilter),
+        bloomFilter_(std::move(bloomFilter)),
+        hashKind_(hashKind),
+        baseFilter_(std::move(baseFilter)) {
+    VELOX_CHECK_NOT_NULL(bloomFilter_);
+    VELOX_CHECK(
+        isSupportedKind(hashKind_),
+        "Unsupported type for HashBloomFilter: {}",
+        mapTypeKindToName(hashKind_));
+  }
+
+  HashBloomFilter(const HashBloomFilter& other, bool nullAllowed)
+      : HashBloomFilter(
+            other.bloomFilter_,
+            other.hashKind_,
+            nullAllowed,
+            other.baseFilter_) {}
+
+  /// Returns true if values of 'kind' can be tested by this filter.
+  static bool isSupportedKind(TypeKind kind) {
+    switch (kind) {
+      case TypeKind::TINYINT:
+      case TypeKind::SMALLINT:
+      case TypeKind::INTEGER:
+      case TypeKind::BIGINT:
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  std::unique_ptr<Filter> clone(
+      std::optional<bool> nullAllowed = std::nullopt) const final {
+    return std::make_unique<HashBloomFilter>(
+        *this, nullAllowed.value_or(nullAllowed_));
+  }
+
+  bool testInt64(int64_t value) const final {
+    if (baseFilter_ && !baseFilter_->testInt64(value)) {
+      return false;
+    }
+    return bloomFilter_->mayContain(hashInt64(value));
+  }
+
+  bool testBytes(const char* value, int32_t length) const final {
+    if (baseFilter_ && !baseFilter_->testBytes(value, length)) {
+      return false;
+    }
+    return bloomFilter_->mayContain(
+        folly::hasher<StringView>()(StringView(value, length)));
+  }
+
+  bool hasTestLength() const final {
+    return baseFilter_ && baseFilter_->hasTestLength();
+  }
+
+  bool testLength(int32_t length) const final {
+    return !baseFilter_ || baseFilter_->testLength(length);
+  }
+
+  bool testInt64Range(int64_t min, int64_t max, bool hasNull) const final {
+    if (hasNull && nullAllowed_) {
+      return true;
+    }
+    return !baseFilter_ || baseFilter_->testInt64Range(min, max, hasNull);
+  }
+
+  bool testBytesRange(
+      std::optional<std::string_view> min,
+      std::optional<std::string_view> max,
+      bool hasNull) const final {
+    if (hasNull && nullAllowed_) {
+      return true;
+    }
+    return !baseFilter_ || baseFilter_->testBytesRange(min, max, hasNull);
+  }
+
+  std::unique_ptr<Filter> mergeWith(const Filter* other) const final;
+
+  std::string toString() const final {
+    return fmt::format(
+        "HashBloomFilter: {} {}{}",
+        mapTypeKindToName(hashKind_),
+        nullAllowed_ ? "with nulls" : "no nulls",
+        baseFilter_ ? " AND " + baseFilter_->toString() : "");
+  }
+
+  const std::shared_ptr<const BloomFilter<>>& bloomFilter() const {
+    return bloomFilter_;
+  }
+
+  TypeKind hashKind() const {
+    return hashKind_;
+  }
+
+ private:
+  uint64_t hashInt64(int64_t value) const {
+    switch (hashKind_) {
+      case TypeKind::TINYINT:
+        return folly::hasher<int8_t>()(static_cast<int8_t>(value));
+      case TypeKind::SMALLINT:
+        return folly::hasher<int16_t>()(static_cast<int16_t>(value));
+      case TypeKind::INTEGER:
+        return folly::hasher<int32_t>()(static_cast<int32_t>(value));
+      case TypeKind::BIGINT:
+        return folly::hasher<int64_t>()(value);
+      default:
+        VELOX_UNSUPPORTED("{}: testInt64() is not supported.", toString());
+    }
+  }
+
+  const std::shared_ptr<const BloomFilter<>> bloomFilter_;
+  const TypeKind hashKind_;
+  const std::shared_ptr<const Filter> baseFilter_;
+};
+
 // Helper for applying filters to different types
 template <typename TFilter, typename T>
 static inline bool applyFilter(TFilter& filter, T value) {
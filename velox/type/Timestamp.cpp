@@ -18,6 +18,7 @@
 #include "velox/common/base/Exceptions.h"
 #include "velox/external/date/tz.h"
 #include "velox/type/tz/TimeZoneMap.h"
+#include "velox/type/tz/TimeZoneOffsets.h"
 
 namespace facebook::velox {
 namespace {
@@ -36,17 +37,17 @@ inline int64_t getPrestoTZOffsetInSeconds(int16_t tzID) {
 } // namespace
 
 void Timestamp::toGMT(const date::time_zone& zone) {
+  toGMT(util::TimeZoneOffsets::get(zone));
+}
+
+void Timestamp::toGMT(const util::TimeZoneOffsets& offsets) {
   // Magic number -2^39 + 24*3600. This number and any number lower than that
   // will cause time_zone::to_sys() to SIGABRT. We don't want that to happen.
   if (seconds_ <= (-1096193779200l + 86400l)) {
     VELOX_UNSUPPORTED(
         "Timestamp out of bound for time zone adjustment {} seconds", seconds_);
   }
-  date::local_time<std::chrono::seconds> localTime{
-      std::chrono::seconds(seconds_)};
-  std::chrono::time_point<std::chrono::system_clock, std::chrono::seconds>
-      sysTime = zone.to_sys(localTime, date::choose::latest);
-  seconds_ = sysTime.time_since_epoch().count();
+  seconds_ = offsets.toGMT(seconds_);
 }
 
 void Timestamp::toGMT(int16_t tzID) {
@@ -56,15 +57,32 @@ void Timestamp::toGMT(int16_t tzID) {
     seconds_ -= getPrestoTZOffsetInSeconds(tzID);
   } else {
     // Other ids go this path.
-    toGMT(*date::locate_zone(util::getTimeZoneName(tzID)));
+    toGMT(util::TimeZoneOffsets::get(tzID));
   }
 }
 
 void Timestamp::toTimezone(const date::time_zone& zone) {
-  auto tp = std::chrono::time_point<std::chrono::system_clock>(
-      std::chrono::seconds(seconds_));
-  auto epoch = zone.to_local(tp).time_since_epoch();
-  seconds_ = std::chrono::duration_cast<std::chrono::seconds>(epoch).count();
+  toTimezone(util::TimeZoneOffsets::get(zone));
+}
+
+void Timestamp::toTimezone(const util::TimeZoneOffsets& offsets) {
+  seconds_ = offsets.toLocal(seconds_);
+}
+
+// static
+void Timestamp::toTimezone(
+    const util::TimeZoneOffsets& offsets,
+    Timestamp* timestamps,
+    int32_t size) {
+  // Empty until the first lookup.
+  util::TimeZoneOffsets::Interval interval{0, 0, 0};
+  for (auto i = 0; i < size; ++i) {
+    const auto seconds = timestamps[i].seconds_;
+    if (seconds < interval.begin || seconds >= interval.end) {
+      interval = offsets.intervalAt(seconds);
+    }
+    timestamps[i].seconds_ = seconds + interval.offset;
+  }
 }
 
 void Timestamp::toTimezone(int16_t tzID) {
@@ -74,7 +92,7 @@ void Timestamp::toTimezone(int16_t tzID) {
     seconds_ += getPrestoTZOffsetInSeconds(tzID);
   } else {
     // Other ids go this path.
-    toTimezone(*date::locate_zone(util::getTimeZoneName(tzID)));
+    toTimezone(util::TimeZoneOffsets::get(tzID));
   }
 }
 
@@ -30,6 +30,10 @@ class time_zone;
 
 namespace facebook::velox {
 
+namespace util {
+class TimeZoneOffsets;
+}
+
 struct Timestamp {
  public:
   constexpr Timestamp() : seconds_(0), nanos_(0) {}
@@ -100,6 +104,9 @@ struct Timestamp {
   // Same as above, but accepts PrestoDB time zone ID.
   void toGMT(int16_t tzID);
 
+  // Same as above, but uses the precomputed offsets of the zone.
+  void toGMT(const util::TimeZoneOffsets& offsets);
+
   // Assuming the timestamp represents a GMT time, converts it to the time at
   // the same moment at zone.
   // Example: Timestamp ts{0, 0};
@@ -110,6 +117,17 @@ struct Timestamp {
   // Same as above, but accepts PrestoDB time zone ID.
   void toTimezone(int16_t tzID);
 
+  // Same as above, but uses the precomputed offsets of the zone.
+  void toTimezone(const util::TimeZoneOffsets& offsets);
+
+  // Converts 'size' GMT timestamps in place to the time at the same moment at
+  // the zone of 'offsets'. Runs of timestamps between the same two
+  // transitions are adjusted without further lookups.
+  static void toTimezone(
+      const util::TimeZoneOffsets& offsets,
+      Timestamp* timestamps,
+      int32_t size);
+
   bool operator==(const Timestamp& b) const {
     return seconds_ == b.seconds_ && nanos_ == b.nanos_;
   }
@@ -21,6 +21,7 @@
 #include <optional>
 
 #include <velox/type/Filter.h>
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/expression/ExprToSubfieldFilter.h"
 #include "velox/type/Filter.h"
 
@@ -946,6 +947,36 @@ TEST(FilterTest, bytesValues) {
   EXPECT_FALSE(filter->testBytesRange(std::nullopt, "Banana", false));
 }
 
+TEST(FilterTest, bytesValuesLengths) {
+  // Lengths of 64 bytes and more are not in the lookup table of small lengths.
+  const std::string longValue(100, 'x');
+  auto filter = in({"", "ab", longValue});
+  EXPECT_TRUE(filter->hasTestLength());
+  EXPECT_TRUE(filter->testLength(0));
+  EXPECT_TRUE(filter->testLength(2));
+  EXPECT_TRUE(filter->testLength(100));
+  EXPECT_FALSE(filter->testLength(63));
+  EXPECT_FALSE(filter->testLength(64));
+  EXPECT_TRUE(filter->testBytes(longValue.data(), longValue.size()));
+  EXPECT_FALSE(filter->testBytes(std::string(100, 'y').data(), 100));
+
+  auto expectLengths = [&](std::vector<int32_t> lengths) {
+    lengths.resize(xsimd::batch<int32_t>::size);
+    int32_t expected = 0;
+    for (auto i = 0; i < lengths.size(); ++i) {
+      if (filter->testLength(lengths[i])) {
+        expected |= 1 << i;
+      }
+    }
+    EXPECT_EQ(
+        expected,
+        simd::toBitMask(filter->testLengths(
+            xsimd::load_unaligned(lengths.data()))));
+  };
+  expectLengths({0, 1, 2, 3, 63, 0, 2, 5});
+  expectLengths({100, 2, 64, 99, 1000, 0, 100, 2});
+}
+
 TEST(FilterTest, negatedBytesValues) {
   // create a filter
   std::vector<std::string> values(
@@ -1729,3 +1760,70 @@ TEST(FilterTest, mergeWithBytesMultiRange) {
     }
   }
 }
+
+TEST(FilterTest, hashBloomFilter) {
+  auto bigints = std::make_shared<BloomFilter<>>();
+  bigints->reset(100);
+  auto strings = std::make_shared<BloomFilter<>>();
+  strings->reset(100);
+  for (int64_t i = 0; i < 100; ++i) {
+    bigints->insert(folly::hasher<int64_t>()(i * 2));
+    auto value = std::to_string(i * 2);
+    strings->insert(folly::hasher<StringView>()(StringView(value)));
+  }
+
+  HashBloomFilter bigintFilter(bigints, TypeKind::BIGINT, false);
+  HashBloomFilter stringFilter(strings, TypeKind::VARCHAR, false);
+  int32_t numFalsePositives = 0;
+  for (int64_t i = 0; i < 200; ++i) {
+    auto value = std::to_string(i);
+    if (i % 2 == 0) {
+      EXPECT_TRUE(bigintFilter.testInt64(i));
+      EXPECT_TRUE(stringFilter.testBytes(value.data(), value.size()));
+    } else {
+      numFalsePositives += bigintFilter.testInt64(i);
+      numFalsePositives += stringFilter.testBytes(value.data(), value.size());
+    }
+  }
+  EXPECT_LT(numFalsePositives, 10);
+  EXPECT_FALSE(bigintFilter.testNull());
+  EXPECT_TRUE(bigintFilter.clone(true)->testNull());
+  EXPECT_TRUE(bigintFilter.testInt64Range(1, 1, false));
+
+  // The values are hashed as the type of the key.
+  auto integers = std::make_shared<BloomFilter<>>();
+  integers->reset(1);
+  integers->insert(folly::hasher<int32_t>()(1234));
+  EXPECT_TRUE(
+      HashBloomFilter(integers, TypeKind::INTEGER, false).testInt64(1234));
+
+  VELOX_ASSERT_THROW(
+      HashBloomFilter(bigints, TypeKind::DOUBLE, false),
+      "Unsupported type for HashBloomFilter: DOUBLE");
+
+  // Merging keeps testing the Bloom filter and the other filter.
+  auto range = between(10, 20);
+  for (const auto& merged :
+       {bigintFilter.mergeWith(range.get()),
+        range->mergeWith(&bigintFilter)}) {
+    ASSERT_EQ(merged->kind(), FilterKind::kHashBloomFilter);
+    EXPECT_TRUE(merged->testInt64(10));
+    EXPECT_FALSE(merged->testInt64(40));
+    EXPECT_FALSE(merged->testInt64Range(30, 40, false));
+    EXPECT_TRUE(merged->testInt64Range(15, 40, false));
+  }
+  EXPECT_EQ(
+      bigintFilter.mergeWith(std::make_unique<IsNull>().get())->kind(),
+      FilterKind::kAlwaysFalse);
+  EXPECT_EQ(
+      bigintFilter.mergeWith(std::make_unique<IsNotNull>().get())->kind(),
+      FilterKind::kHashBloomFilter);
+
+  auto bytesValues = in(std::vector<std::string>{"10", "11"});
+  auto merged = bytesValues->mergeWith(&stringFilter);
+  ASSERT_EQ(merged->kind(), FilterKind::kHashBloomFilter);
+  EXPECT_TRUE(merged->testLength(2));
+  EXPECT_FALSE(merged->testLength(3));
+  EXPECT_TRUE(merged->testBytes("10", 2));
+  EXPECT_FALSE(merged->testBytes("12", 2));
+}
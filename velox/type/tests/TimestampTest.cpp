@@ -17,7 +17,9 @@
 #include <gtest/gtest.h>
 
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/external/date/tz.h"
 #include "velox/type/Timestamp.h"
+#include "velox/type/tz/TimeZoneOffsets.h"
 
 namespace facebook::velox {
 namespace {
@@ -91,5 +93,33 @@ TEST(TimestampTest, arithmeticOverflow) {
       ts2.toNanos(), "integer overflow: -9223372036854776 * 1000000000");
 }
 
+TEST(TimestampTest, toTimezoneBatch) {
+  const auto& offsets =
+      util::TimeZoneOffsets::get(*date::locate_zone("America/Los_Angeles"));
+
+  // Hourly values across the 2022 transitions, then a few far apart ones.
+  std::vector<Timestamp> timestamps;
+  for (int64_t seconds = 1'640'995'200; seconds < 1'672'531'200;
+       seconds += 3'600) {
+    timestamps.emplace_back(seconds, 7);
+  }
+  timestamps.emplace_back(-3'000'000'000, 0);
+  timestamps.emplace_back(0, 0);
+  timestamps.emplace_back(5'000'000'000, 0);
+
+  auto expected = timestamps;
+  for (auto& timestamp : expected) {
+    timestamp.toTimezone(offsets);
+  }
+  Timestamp::toTimezone(offsets, timestamps.data(), timestamps.size());
+  ASSERT_EQ(timestamps, expected);
+
+  Timestamp timestamp(1'647'165'600, 0);
+  timestamp.toTimezone(offsets);
+  ASSERT_EQ(timestamp.getSeconds(), 1'647'165'600 - 7 * 3'600);
+  timestamp.toGMT(offsets);
+  ASSERT_EQ(timestamp.getSeconds(), 1'647'165'600);
+}
+
 } // namespace
 } // namespace facebook::velox
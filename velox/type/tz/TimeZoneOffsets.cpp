@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/type/tz/TimeZoneOffsets.h"
+
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "velox/external/date/tz.h"
+#include "velox/type/tz/TimeZoneMap.h"
+
+namespace facebook::velox::util {
+
+// Defined on TimeZoneDatabase.cpp
+extern const std::unordered_map<int64_t, std::string>& getTimeZoneDB();
+
+namespace {
+constexpr int64_t kSecondsInDay = 86'400;
+
+int64_t maxTimeZoneID() {
+  int64_t maxID = 0;
+  for (const auto& entry : getTimeZoneDB()) {
+    maxID = std::max(maxID, entry.first);
+  }
+  return maxID;
+}
+} // namespace
+
+TimeZoneOffsets::TimeZoneOffsets(const date::time_zone& zone) : zone_(zone) {
+  int64_t seconds = kBeginSeconds;
+  while (seconds < kEndSeconds) {
+    const auto info =
+        zone.get_info(date::sys_seconds(std::chrono::seconds(seconds)));
+    const int64_t end =
+        std::min<int64_t>(info.end.time_since_epoch().count(), kEndSeconds);
+    const int32_t offset = info.offset.count();
+    // Transitions that only change the abbreviation or the split between
+    // standard and daylight time keep the offset.
+    if (!offsets_.empty() && offsets_.back() == offset) {
+      ends_.back() = end;
+    } else {
+      ends_.push_back(end);
+      offsets_.push_back(offset);
+    }
+    seconds = end;
+  }
+
+  const auto numBuckets =
+      ((kEndSeconds - kBeginSeconds - 1) >> kBucketShift) + 1;
+  buckets_.resize(numBuckets);
+  uint32_t index = 0;
+  for (auto i = 0; i < numBuckets; ++i) {
+    const int64_t bucketBegin =
+        kBeginSeconds + (static_cast<int64_t>(i) << kBucketShift);
+    while (bucketBegin >= ends_[index]) {
+      ++index;
+    }
+    buckets_[i] = index;
+  }
+}
+
+// static
+const TimeZoneOffsets& TimeZoneOffsets::get(const date::time_zone& zone) {
+  // Most callers convert many values in a single session time zone, so the
+  // last zone seen by each thread is found without taking the lock.
+  thread_local const date::time_zone* lastZone = nullptr;
+  thread_local const TimeZoneOffsets* lastOffsets = nullptr;
+  if (lastZone == &zone) {
+    return *lastOffsets;
+  }
+
+  // Zones live in the time zone database, which is never reloaded, and their
+  // offsets are kept for the lifetime of the process.
+  static folly::Synchronized<folly::F14FastMap<
+      const date::time_zone*,
+      std::unique_ptr<TimeZoneOffsets>>>
+      cache;
+  const TimeZoneOffsets* offsets = nullptr;
+  {
+    auto cached = cache.rlock();
+    auto it = cached->find(&zone);
+    if (it != cached->end()) {
+      offsets = it->second.get();
+    }
+  }
+  if (offsets == nullptr) {
+    auto newOffsets = std::make_unique<TimeZoneOffsets>(zone);
+    auto cached = cache.wlock();
+    offsets = cached->emplace(&zone, std::move(newOffsets)).first->second.get();
+  }
+  lastZone = &zone;
+  lastOffsets = offsets;
+  return *offsets;
+}
+
+// static
+const TimeZoneOffsets& TimeZoneOffsets::get(int64_t timeZoneID) {
+  static const int64_t numIDs = maxTimeZoneID() + 1;
+  static std::vector<std::atomic<const TimeZoneOffsets*>> cache(numIDs);
+  if (timeZoneID < 0 || timeZoneID >= numIDs) {
+    // Throws for the unknown ID.
+    return get(*date::locate_zone(getTimeZoneName(timeZoneID)));
+  }
+
+  auto& slot = cache[timeZoneID];
+  auto* offsets = slot.load(std::memory_order_acquire);
+  if (offsets == nullptr) {
+    offsets = &get(*date::locate_zone(getTimeZoneName(timeZoneID)));
+    slot.store(offsets, std::memory_order_release);
+  }
+  return *offsets;
+}
+
+int64_t TimeZoneOffsets::toGMT(int64_t seconds) const {
+  // Offsets are less than a day, so only intervals that overlap a day on
+  // either side of 'seconds' can contain it in local time.
+  if (seconds - kSecondsInDay < kBeginSeconds ||
+      seconds + kSecondsInDay >= kEndSeconds) {
+    return toGMTFromDatabase(seconds);
+  }
+
+  bool found = false;
+  int64_t offset = 0;
+  int64_t transition = 0;
+  for (auto index = intervalIndex(seconds - kSecondsInDay);
+       index < ends_.size();
+       ++index) {
+    const int64_t begin = index == 0 ? kBeginSeconds : ends_[index - 1];
+    if (begin > seconds + kSecondsInDay) {
+      break;
+    }
+    const int64_t localBegin = begin + offsets_[index];
+    const int64_t localEnd = ends_[index] + offsets_[index];
+    if (seconds >= localBegin && seconds < localEnd) {
+      // A later interval wins for ambiguous local times.
+      found = true;
+      offset = offsets_[index];
+    } else if (seconds >= localEnd) {
+      transition = ends_[index];
+    }
+  }
+  // A local time in the gap of a forward transition maps to the transition.
+  return found ? seconds - offset : transition;
+}
+
+TimeZoneOffsets::Interval TimeZoneOffsets::intervalFromDatabase(
+    int64_t seconds) const {
+  const auto info =
+      zone_.get_info(date::sys_seconds(std::chrono::seconds(seconds)));
+  return {
+      info.begin.time_since_epoch().count(),
+      info.end.time_since_epoch().count(),
+      info.offset.count()};
+}
+
+int64_t TimeZoneOffsets::toGMTFromDatabase(int64_t seconds) const {
+  date::local_time<std::chrono::seconds> localTime{
+      std::chrono::seconds(seconds)};
+  return zone_.to_sys(localTime, date::choose::latest)
+      .time_since_epoch()
+      .count();
+}
+
+} // namespace facebook::velox::util
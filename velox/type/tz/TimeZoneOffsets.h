@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace date {
+class time_zone;
+}
+
+namespace facebook::velox::util {
+
+// Precomputed GMT offsets of one time zone. The offset at a GMT time in
+// [kBeginSeconds, kEndSeconds) is found with one bucket lookup followed by a
+// short forward scan over the zone's transitions instead of a binary search in
+// the time zone database. Times outside of the range go to the database.
+class TimeZoneOffsets {
+ public:
+  // 1900-01-01 00:00:00 and 2100-01-01 00:00:00 GMT.
+  static constexpr int64_t kBeginSeconds = -2'208'988'800;
+  static constexpr int64_t kEndSeconds = 4'102'444'800;
+
+  // A GMT time range [begin, end) with the same 'offset' to local time.
+  struct Interval {
+    int64_t begin;
+    int64_t end;
+    int64_t offset;
+  };
+
+  explicit TimeZoneOffsets(const date::time_zone& zone);
+
+  // Returns the offsets of 'zone'. These are computed on first use and shared
+  // by all threads for the lifetime of the process.
+  static const TimeZoneOffsets& get(const date::time_zone& zone);
+
+  // Same as above, but accepts a PrestoDB time zone ID of a named zone.
+  static const TimeZoneOffsets& get(int64_t timeZoneID);
+
+  const date::time_zone& zone() const {
+    return zone_;
+  }
+
+  // Returns the interval containing the GMT time 'seconds'. The begin and end
+  // of the first and last cached intervals are clamped to the cached range.
+  Interval intervalAt(int64_t seconds) const {
+    if (seconds >= kBeginSeconds && seconds < kEndSeconds) {
+      const auto index = intervalIndex(seconds);
+      return {
+          index == 0 ? kBeginSeconds : ends_[index - 1],
+          ends_[index],
+          offsets_[index]};
+    }
+    return intervalFromDatabase(seconds);
+  }
+
+  // Returns the local time in the zone at the GMT time 'seconds'.
+  int64_t toLocal(int64_t seconds) const {
+    if (seconds >= kBeginSeconds && seconds < kEndSeconds) {
+      return seconds + offsets_[intervalIndex(seconds)];
+    }
+    return seconds + intervalFromDatabase(seconds).offset;
+  }
+
+  // Returns the GMT time of the local time 'seconds' in the zone. Same as
+  // date::time_zone::to_sys with date::choose::latest: an ambiguous local time
+  // resolves to the later GMT time and a local time skipped by a transition
+  // resolves to the transition.
+  int64_t toGMT(int64_t seconds) const;
+
+ private:
+  // Each bucket covers 2^21 seconds, a little over 24 days. Transitions are
+  // rarely that close together, so the scan from the bucket's first interval
+  // is almost always at most one step.
+  static constexpr int32_t kBucketShift = 21;
+
+  uint32_t intervalIndex(int64_t seconds) const {
+    auto index = buckets_[(seconds - kBeginSeconds) >> kBucketShift];
+    while (seconds >= ends_[index]) {
+      ++index;
+    }
+    return index;
+  }
+
+  Interval intervalFromDatabase(int64_t seconds) const;
+
+  int64_t toGMTFromDatabase(int64_t seconds) const;
+
+  const date::time_zone& zone_;
+
+  // End of each interval in the cached range in GMT seconds. The last one is
+  // kEndSeconds.
+  std::vector<int64_t> ends_;
+
+  // Offset of local time from GMT in seconds for each interval.
+  std::vector<int32_t> offsets_;
+
+  // Index of the interval containing the start of each bucket.
+  std::vector<uint32_t> buckets_;
+};
+
+} // namespace facebook::velox::util
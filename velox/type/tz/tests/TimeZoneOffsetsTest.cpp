@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "velox/external/date/tz.h"
+#include "velox/type/tz/TimeZoneMap.h"
+#include "velox/type/tz/TimeZoneOffsets.h"
+
+namespace facebook::velox::util {
+namespace {
+
+int64_t toLocalFromDatabase(const date::time_zone& zone, int64_t seconds) {
+  return zone.to_local(date::sys_seconds(std::chrono::seconds(seconds)))
+      .time_since_epoch()
+      .count();
+}
+
+int64_t toGMTFromDatabase(const date::time_zone& zone, int64_t seconds) {
+  return zone
+      .to_sys(
+          date::local_seconds(std::chrono::seconds(seconds)),
+          date::choose::latest)
+      .time_since_epoch()
+      .count();
+}
+
+TEST(TimeZoneOffsetsTest, matchesDatabase) {
+  // Zones with daylight saving time, half hour offsets and skipped days.
+  for (const auto* name :
+       {"America/Los_Angeles",
+        "Europe/London",
+        "Asia/Kolkata",
+        "Australia/Lord_Howe",
+        "Pacific/Apia",
+        "America/Sao_Paulo"}) {
+    SCOPED_TRACE(name);
+    const auto* zone = date::locate_zone(name);
+    const auto& offsets = TimeZoneOffsets::get(*zone);
+    ASSERT_EQ(&offsets, &TimeZoneOffsets::get(*zone));
+    ASSERT_EQ(&offsets.zone(), zone);
+
+    // Every 7 hours and 13 seconds, so that all times of day are covered, from
+    // before the cached range to after it.
+    for (int64_t seconds = TimeZoneOffsets::kBeginSeconds - 86'400 * 10;
+         seconds < TimeZoneOffsets::kEndSeconds + 86'400 * 10;
+         seconds += 7 * 3'600 + 13) {
+      ASSERT_EQ(offsets.toLocal(seconds), toLocalFromDatabase(*zone, seconds))
+          << seconds;
+      ASSERT_EQ(offsets.toGMT(seconds), toGMTFromDatabase(*zone, seconds))
+          << seconds;
+    }
+
+    // Around each transition, where local times are skipped or repeated.
+    auto interval = offsets.intervalAt(0);
+    for (auto i = 0; i < 20 && interval.end < TimeZoneOffsets::kEndSeconds;
+         ++i) {
+      const auto transition = interval.end;
+      for (int64_t delta = -2 * 3'600; delta <= 2 * 3'600; delta += 60) {
+        const auto seconds = transition + delta;
+        ASSERT_EQ(offsets.toLocal(seconds), toLocalFromDatabase(*zone, seconds))
+            << seconds;
+        ASSERT_EQ(offsets.toGMT(seconds), toGMTFromDatabase(*zone, seconds))
+            << seconds;
+      }
+      interval = offsets.intervalAt(transition);
+      ASSERT_EQ(interval.begin, transition);
+    }
+  }
+}
+
+TEST(TimeZoneOffsetsTest, timeZoneID) {
+  const auto& offsets = TimeZoneOffsets::get(getTimeZoneID("Europe/Moscow"));
+  ASSERT_EQ(
+      &offsets, &TimeZoneOffsets::get(*date::locate_zone("Europe/Moscow")));
+  ASSERT_EQ(&offsets, &TimeZoneOffsets::get(getTimeZoneID("Europe/Moscow")));
+  EXPECT_THROW(TimeZoneOffsets::get(99999999), std::runtime_error);
+}
+
+} // namespace
+} // namespace facebook::velox::util
@@ -318,6 +318,56 @@ VectorPtr BaseVector::createInternal(
   }
 }
 
+namespace {
+// Adds the copy of 'sourceIndex' into 'targetIndex' to 'ranges', extending
+// the last range if both indices follow it.
+void addCopyRange(
+    std::vector<BaseVector::CopyRange>& ranges,
+    vector_size_t sourceIndex,
+    vector_size_t targetIndex) {
+  if (!ranges.empty()) {
+    auto& last = ranges.back();
+    if (last.sourceIndex + last.count == sourceIndex &&
+        last.targetIndex + last.count == targetIndex) {
+      ++last.count;
+      return;
+    }
+  }
+  ranges.push_back({sourceIndex, targetIndex, 1});
+}
+} // namespace
+
+void BaseVector::copy(
+    const BaseVector* source,
+    const SelectivityVector& rows,
+    const vector_size_t* toSourceRow) {
+  std::vector<CopyRange> ranges;
+  rows.applyToSelected([&](vector_size_t row) {
+    auto sourceRow = toSourceRow ? toSourceRow[row] : row;
+    if (sourceRow >= source->size()) {
+      return;
+    }
+    addCopyRange(ranges, sourceRow, row);
+  });
+  if (!ranges.empty()) {
+    copyRanges(source, ranges);
+  }
+}
+
+void BaseVector::gather(
+    const BaseVector* source,
+    vector_size_t targetIndex,
+    const vector_size_t* sourceIndices,
+    vector_size_t count) {
+  std::vector<CopyRange> ranges;
+  for (vector_size_t i = 0; i < count; ++i) {
+    addCopyRange(ranges, sourceIndices[i], targetIndex + i);
+  }
+  if (!ranges.empty()) {
+    copyRanges(source, ranges);
+  }
+}
+
 void BaseVector::addNulls(const uint64_t* bits, const SelectivityVector& rows) {
   VELOX_CHECK(isNullsWritable());
   VELOX_CHECK(length_ >= rows.end());
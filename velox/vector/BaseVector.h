@@ -371,23 +371,12 @@ class BaseVector {
 
   // Sets the rows of 'this' given by 'rows' to
   // 'source.valueAt(toSourceRow ? toSourceRow[row] : row)', where
-  // 'row' iterates over 'rows'.
+  // 'row' iterates over 'rows'. The default implementation merges
+  // consecutive rows into ranges and makes a single call to copyRanges.
   virtual void copy(
       const BaseVector* source,
       const SelectivityVector& rows,
-      const vector_size_t* toSourceRow) {
-    rows.applyToSelected([&](vector_size_t row) {
-      auto sourceRow = toSourceRow ? toSourceRow[row] : row;
-      if (sourceRow >= source->size()) {
-        return;
-      }
-      if (source->isNullAt(sourceRow)) {
-        setNull(row, true);
-      } else {
-        copy(source, row, sourceRow, 1);
-      }
-    });
-  }
+      const vector_size_t* toSourceRow);
 
   // Utility for making a deep copy of a whole vector.
   static std::shared_ptr<BaseVector> copy(const BaseVector& vector) {
@@ -423,6 +412,17 @@ class BaseVector {
     VELOX_UNSUPPORTED("Can only copy into flat or complex vectors");
   }
 
+  /// Sets rows [targetIndex, targetIndex + count) of 'this' to
+  /// 'source[sourceIndices[i]]'. Runs of consecutive source indices become a
+  /// single CopyRange, so that ARRAY, MAP and ROW vectors copy their children
+  /// in bulk instead of once per row. 'this' must have at least targetIndex +
+  /// count rows.
+  void gather(
+      const BaseVector* source,
+      vector_size_t targetIndex,
+      const vector_size_t* sourceIndices,
+      vector_size_t count);
+
   // Construct a zero-copy slice of the vector with the indicated offset and
   // length.
   virtual std::shared_ptr<BaseVector> slice(
@@ -145,5 +145,95 @@ xsimd::batch<T> BiasVector<T>::loadSIMDValueBufferAt(size_t index) const {
   }
 }
 
+template <typename T>
+VectorPtr BiasVector<T>::slice(vector_size_t offset, vector_size_t length)
+    const {
+  return std::make_shared<BiasVector<T>>(
+      this->pool_,
+      this->sliceNulls(offset, length),
+      length,
+      valueType_,
+      BaseVector::sliceBuffer(
+          *createScalarType(valueType_), values_, offset, length, this->pool_),
+      bias_);
+}
+
+namespace detail {
+template <typename T, typename TValue>
+BufferPtr makeBiasedValues(const FlatVector<T>& flat, T bias) {
+  const auto size = flat.size();
+  auto values = AlignedBuffer::allocate<TValue>(size, flat.pool());
+  auto* rawValues = values->template asMutable<TValue>();
+  const auto* rawFlatValues = flat.rawValues();
+  for (vector_size_t i = 0; i < size; ++i) {
+    // Subtracts in unsigned space, the values at null positions are undefined.
+    rawValues[i] = flat.isNullAt(i)
+        ? 0
+        : static_cast<TValue>(
+              static_cast<uint64_t>(rawFlatValues[i]) -
+              static_cast<uint64_t>(bias));
+  }
+  return values;
+}
+} // namespace detail
+
+template <typename T>
+BiasVectorPtr<T> encodeBias(const FlatVector<T>& flat) {
+  if constexpr (!admitsBias<T>()) {
+    return nullptr;
+  } else {
+    std::optional<T> min;
+    std::optional<T> max;
+    const auto* rawValues = flat.rawValues();
+    for (vector_size_t i = 0; i < flat.size(); ++i) {
+      if (flat.isNullAt(i)) {
+        continue;
+      }
+      if (!min.has_value() || rawValues[i] < min.value()) {
+        min = rawValues[i];
+      }
+      if (!max.has_value() || rawValues[i] > max.value()) {
+        max = rawValues[i];
+      }
+    }
+    if (!min.has_value()) {
+      return nullptr;
+    }
+
+    // Two's complement subtraction gives the delta for any 'min' <= 'max'.
+    uint64_t delta = static_cast<uint64_t>(max.value()) -
+        static_cast<uint64_t>(min.value());
+    if (!deltaAllowsBias<T>(delta)) {
+      return nullptr;
+    }
+
+    // Check the BiasVector comment for the choice of bias.
+    T bias = min.value() + static_cast<T>((delta + 1) / 2);
+
+    BufferPtr values;
+    TypeKind valueType;
+    if (delta <= std::numeric_limits<uint8_t>::max()) {
+      values = detail::makeBiasedValues<T, int8_t>(flat, bias);
+      valueType = TypeKind::TINYINT;
+    } else if (delta <= std::numeric_limits<uint16_t>::max()) {
+      values = detail::makeBiasedValues<T, int16_t>(flat, bias);
+      valueType = TypeKind::SMALLINT;
+    } else {
+      values = detail::makeBiasedValues<T, int32_t>(flat, bias);
+      valueType = TypeKind::INTEGER;
+    }
+    return std::make_shared<BiasVector<T>>(
+        flat.pool(),
+        flat.nulls(),
+        flat.size(),
+        valueType,
+        std::move(values),
+        bias,
+        SimpleVectorStats<T>{min, max},
+        std::nullopt /*distinctCount*/,
+        flat.getNullCount());
+  }
+}
+
 } // namespace velox
 } // namespace facebook
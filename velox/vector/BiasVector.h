@@ -155,9 +155,7 @@ class BiasVector : public SimpleVector<T> {
     return true;
   }
 
-  VectorPtr slice(vector_size_t, vector_size_t) const override {
-    VELOX_NYI();
-  }
+  VectorPtr slice(vector_size_t offset, vector_size_t length) const override;
 
  private:
   template <typename U>
@@ -182,6 +180,17 @@ class BiasVector : public SimpleVector<T> {
 template <typename T>
 using BiasVectorPtr = std::shared_ptr<BiasVector<T>>;
 
+template <typename T>
+class FlatVector;
+
+/// Returns a BiasVector with the values and nulls of 'flat' if the difference
+/// between its largest and smallest non-null values fits in a narrower
+/// integer type, e.g. BIGINT values within a range of 2^32. Returns nullptr
+/// if the range is too wide, if all values are null or if T does not admit
+/// bias.
+template <typename T>
+BiasVectorPtr<T> encodeBias(const FlatVector<T>& flat);
+
 } // namespace facebook::velox
 
 #include "velox/vector/BiasVector-inl.h"
@@ -35,6 +35,24 @@ std::vector<vector_size_t> makeConsecutiveIndices(size_t size) {
 }
 } // namespace
 
+const std::vector<DecodedVector::Run>& DecodedVector::runs(
+    const SelectivityVector& rows) {
+  runs_.clear();
+  rows.applyToSelected([&](vector_size_t row) {
+    const auto baseIndex = index(row);
+    if (!runs_.empty()) {
+      auto& last = runs_.back();
+      if (last.begin + last.size == row && last.baseIndex == baseIndex &&
+          isNullAt(last.begin) == isNullAt(row)) {
+        ++last.size;
+        return;
+      }
+    }
+    runs_.push_back({row, 1, baseIndex});
+  });
+  return runs_;
+}
+
 const std::vector<vector_size_t>& DecodedVector::consecutiveIndices() {
   static std::vector<vector_size_t> consecutiveIndices =
       makeConsecutiveIndices(10'000);
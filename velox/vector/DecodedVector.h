@@ -249,6 +249,21 @@ class DecodedVector {
     return isConstantMapping_;
   }
 
+  /// A run of consecutive top-level rows that map to the same row of the base
+  /// vector and are either all null or all not null.
+  struct Run {
+    vector_size_t begin;
+    vector_size_t size;
+    vector_size_t baseIndex;
+  };
+
+  /// Returns the runs of 'rows', which must be a subset of the decoded rows.
+  /// A SequenceVector or a dictionary over sorted data, e.g. from a sorted
+  /// ORC file, decodes into few long runs, so that kernels can process each
+  /// run once instead of each row. Computed in one pass over the indices on
+  /// each call. The result is valid until the next call.
+  const std::vector<Run>& runs(const SelectivityVector& rows);
+
   /// Wraps a vector with the same wrapping as another. 'wrapper' must
   /// have been previously decoded by 'this'. This is used when 'data'
   /// is a component of the base vector of 'wrapper' and must be used
@@ -428,6 +443,9 @@ class DecodedVector {
   // dictionary and base values.
   std::vector<uint64_t> copiedNulls_;
 
+  // The result of runs().
+  std::vector<Run> runs_;
+
   // Used as 'nulls_' for a null constant vector.
   static uint64_t constantNullMask_;
 };
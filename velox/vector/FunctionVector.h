@@ -22,6 +22,7 @@ namespace facebook::velox {
 
 namespace exec {
 class EvalCtx;
+class Expr;
 } // namespace exec
 
 // Represents a function with possible captures.
@@ -31,6 +32,19 @@ class Callable {
 
   virtual bool hasCapture() const = 0;
 
+  /// Returns the body of an interpreted lambda, or nullptr. Lets functions
+  /// recognize simple bodies and evaluate them without vectors, see
+  /// exec::ScalarLambda.
+  virtual const exec::Expr* body() const {
+    return nullptr;
+  }
+
+  /// Returns the names and types of the lambda parameters if body() is not
+  /// nullptr.
+  virtual RowTypePtr signature() const {
+    return nullptr;
+  }
+
   /// Applies 'this' to 'args' for 'rows' and returns the result in
   /// '*result'.
   /// @param rows The rows that this callable applies to. It is the element rows
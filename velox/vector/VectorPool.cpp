@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/vector/VectorPool.h"
+#include "velox/vector/ComplexVector.h"
 
 namespace facebook::velox {
 
@@ -48,13 +49,41 @@ FOLLY_ALWAYS_INLINE int32_t toCacheIndex(const TypePtr& type) {
 
   return -1;
 }
+
+FOLLY_ALWAYS_INLINE bool isComplexType(const TypePtr& type) {
+  return type->kind() == TypeKind::ARRAY || type->kind() == TypeKind::MAP ||
+      type->kind() == TypeKind::ROW;
+}
+
+/// Returns true if 'vector' has the encoding of a flat or complex vector of
+/// its type, e.g. an ArrayVector of an ARRAY type.
+bool isRecyclableEncoding(const BaseVector& vector) {
+  switch (vector.typeKind()) {
+    case TypeKind::ARRAY:
+      return vector.encoding() == VectorEncoding::Simple::ARRAY;
+    case TypeKind::MAP:
+      return vector.encoding() == VectorEncoding::Simple::MAP;
+    case TypeKind::ROW:
+      return vector.encoding() == VectorEncoding::Simple::ROW;
+    default:
+      return vector.isFlatEncoding() && vector.values() != nullptr;
+  }
+}
 } // namespace
 
 VectorPtr VectorPool::get(const TypePtr& type, vector_size_t size) {
+  if (size > kMaxRecycleSize) {
+    return BaseVector::create(type, size, pool_);
+  }
   auto cacheIndex = toCacheIndex(type);
-  if (cacheIndex >= 0 && size <= kMaxRecycleSize) {
+  if (cacheIndex >= 0) {
     return vectors_[cacheIndex].pop(type, size, *pool_);
   }
+  if (isComplexType(type)) {
+    if (auto* typePool = complexTypePool(type, false)) {
+      return typePool->pop(type, size, *pool_);
+    }
+  }
   return BaseVector::create(type, size, pool_);
 }
 
@@ -67,10 +96,30 @@ bool VectorPool::release(VectorPtr& vector) {
   }
 
   auto cacheIndex = toCacheIndex(vector->type());
-  if (cacheIndex < 0) {
-    return false;
+  if (cacheIndex >= 0) {
+    return vectors_[cacheIndex].maybePushBack(vector);
+  }
+  if (isComplexType(vector->type())) {
+    if (auto* typePool = complexTypePool(vector->type(), true)) {
+      return typePool->maybePushBack(vector);
+    }
   }
-  return vectors_[cacheIndex].maybePushBack(vector);
+  return false;
+}
+
+VectorPool::TypePool* VectorPool::complexTypePool(
+    const TypePtr& type,
+    bool create) {
+  for (auto& [poolType, typePool] : complexVectors_) {
+    if (poolType.get() == type.get() || *poolType == *type) {
+      return &typePool;
+    }
+  }
+  if (!create || complexVectors_.size() >= kMaxComplexTypes) {
+    return nullptr;
+  }
+  complexVectors_.emplace_back(type, TypePool{});
+  return &complexVectors_.back().second;
 }
 
 size_t VectorPool::release(std::vector<VectorPtr>& vectors) {
@@ -87,16 +136,23 @@ size_t VectorPool::release(std::vector<VectorPtr>& vectors) {
 
 bool VectorPool::TypePool::maybePushBack(VectorPtr& vector) {
   // Check that this is a Flat Vector with an initialized, unique, and mutable
-  // values Buffer and an uninitialized or unique and mutable nulls Buffer.
-  if (!vector->isWritable() || !vector->isFlatEncoding() || !vector->values()) {
+  // values Buffer, or a complex vector with unique and mutable offsets, sizes
+  // and children, and an uninitialized or unique and mutable nulls Buffer.
+  if (!isRecyclableEncoding(*vector) || !vector->isWritable()) {
     return false;
   }
-  if (size >= kNumPerType) {
+  if (size >= capacity) {
+    full = true;
     return false;
   }
 
   vector->prepareForReuse();
-  vectors[size++] = std::move(vector);
+  if (size == vectors.size()) {
+    vectors.push_back(std::move(vector));
+  } else {
+    vectors[size] = std::move(vector);
+  }
+  ++size;
   return true;
 }
 
@@ -124,8 +180,20 @@ VectorPtr VectorPool::TypePool::pop(
     if (result->size() != vectorSize) {
       result->resize(vectorSize);
     }
+    if (result->typeKind() == TypeKind::ROW) {
+      // prepareForReuse() leaves the children empty. Size them like
+      // BaseVector::create() does.
+      for (auto& child : result->asUnchecked<RowVector>()->children()) {
+        child->resize(vectorSize);
+      }
+    }
     return result;
   }
+  if (full && capacity < kMaxNumPerType) {
+    // The vectors in use outnumber 'capacity'. Keep more of them next time.
+    capacity = std::min(2 * capacity, kMaxNumPerType);
+    full = false;
+  }
   return BaseVector::create(type, vectorSize, &pool);
 }
 } // namespace facebook::velox
@@ -20,24 +20,29 @@
 
 namespace facebook::velox {
 
-/// A thread-level cache of pre-allocated flat vectors of different types.
-/// Keeps up to 10 recyclable vectors of each type. A vector is
-/// recyclable if it is flat and recursively singly-referenced.
-/// Only singleton built-in types are supported. Decimal types, fixed-size array
-/// type, complex and custom types are not supported. Calling 'get' for an
-/// unsupported type already returns a newly allocated vector. Calling 'release'
-/// for an unsupported type is a no-op.
+/// A thread-level cache of pre-allocated vectors of different types.
+/// Keeps up to 10 recyclable vectors of each type at first and up to 64 if the
+/// pool of a type repeatedly runs empty after it had to drop released vectors.
+/// A vector is recyclable if it is flat, or an array, map or row vector, and
+/// recursively singly-referenced. Complex vectors keep their offsets and sizes
+/// buffers and their child vectors. String vectors keep one string buffer of
+/// up to FlatVector<StringView>::kMaxStringSizeForReuse bytes.
+/// Singleton built-in types and array, map and row types are supported.
+/// Decimal types, fixed-size array type and custom types are not supported.
+/// Calling 'get' for an unsupported type already returns a newly allocated
+/// vector. Calling 'release' for an unsupported type is a no-op.
 class VectorPool {
  public:
   explicit VectorPool(memory::MemoryPool* pool) : pool_{pool} {}
 
   /// Gets a possibly recycled vector of 'type and 'size'. Allocates from
-  /// 'pool_' if no pre-allocated vector or type is a complex type.
+  /// 'pool_' if no pre-allocated vector or type is not supported.
   VectorPtr get(const TypePtr& type, vector_size_t size);
 
-  /// Moves vector into 'this' if it is flat, recursively singly referenced and
-  /// there is space. The function returns true if 'vector' is not null and has
-  /// been returned back to this pool, otherwise returns false.
+  /// Moves vector into 'this' if it is flat or complex, recursively singly
+  /// referenced and there is space. The function returns true if 'vector' is
+  /// not null and has been returned back to this pool, otherwise returns
+  /// false.
   bool release(VectorPtr& vector);
 
   size_t release(std::vector<VectorPtr>& vectors);
@@ -48,9 +53,20 @@ class VectorPool {
   static constexpr vector_size_t kMaxRecycleSize = 64 * 1024;
   static constexpr int32_t kNumPerType = 10;
 
+  /// Max number of vectors of one type after growing the pool of the type.
+  static constexpr int32_t kMaxNumPerType = 64;
+
+  /// Max number of distinct complex types with recycled vectors.
+  static constexpr int32_t kMaxComplexTypes = 8;
+
   struct TypePool {
     int32_t size{0};
-    std::array<VectorPtr, kNumPerType> vectors;
+    int32_t capacity{kNumPerType};
+    std::vector<VectorPtr> vectors;
+
+    /// True if a released vector was dropped because the pool was full. A
+    /// later 'pop' on an empty pool then doubles 'capacity'.
+    bool full{false};
 
     bool maybePushBack(VectorPtr& vector);
 
@@ -65,8 +81,16 @@ class VectorPool {
   static constexpr int32_t kNumCachedVectorTypes =
       static_cast<int32_t>(TypeKind::INTERVAL_DAY_TIME) + 1;
 
+  /// Returns the pool of vectors of complex 'type'. Adds a pool if 'create'
+  /// is true and there are less than kMaxComplexTypes. Returns nullptr if
+  /// there is no pool.
+  TypePool* complexTypePool(const TypePtr& type, bool create);
+
   /// Caches of pre-allocated vectors indexed by typeKind.
   std::array<TypePool, kNumCachedVectorTypes> vectors_;
+
+  /// Caches of pre-allocated complex vectors and their types.
+  std::vector<std::pair<TypePtr, TypePool>> complexVectors_;
 };
 
 /// A simple vector ptr wrapper with an associated vector pool. It releases
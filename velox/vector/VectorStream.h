@@ -16,6 +16,7 @@
 #pragma once
 
 #include "velox/buffer/Buffer.h"
+#include "velox/common/base/RuntimeMetrics.h"
 #include "velox/common/memory/ByteStream.h"
 #include "velox/common/memory/Memory.h"
 #include "velox/common/memory/MemoryAllocator.h"
@@ -41,6 +42,12 @@ class VectorSerializer {
 
   // Writes the contents to 'stream' in wire format
   virtual void flush(OutputStream* stream) = 0;
+
+  // Returns serializer specific stats of the flushed contents, e.g. the
+  // compressed bytes, keyed by stat name.
+  virtual std::unordered_map<std::string, RuntimeCounter> runtimeStats() {
+    return {};
+  }
 };
 
 class VectorSerde {
@@ -99,6 +106,11 @@ class VectorStreamGroup : public StreamArena {
   // Writes the contents to 'stream' in wire format.
   void flush(OutputStream* stream);
 
+  // Returns the serializer runtime stats of the flushed contents.
+  std::unordered_map<std::string, RuntimeCounter> runtimeStats() {
+    return serializer_->runtimeStats();
+  }
+
   // Reads data in wire format. Returns the RowVector in 'result'.
   static void read(
       ByteStream* source,
@@ -16,6 +16,9 @@
 
 #include "velox/vector/arrow/Bridge.h"
 
+#include <algorithm>
+#include <numeric>
+
 #include "velox/buffer/Buffer.h"
 #include "velox/common/base/BitUtil.h"
 #include "velox/common/base/CheckedArithmetic.h"
@@ -29,7 +32,8 @@ namespace facebook::velox {
 namespace {
 
 // The supported conversions use one buffer for nulls (0), one for values (1),
-// and one for offsets (2).
+// and one for offsets (2). String views use one buffer for nulls, one for the
+// views, one per data buffer and one for the sizes of the data buffers.
 static constexpr size_t kMaxBuffers{3};
 
 // Structure that will hold the buffers needed by ArrowArray. This is opaquely
@@ -37,9 +41,13 @@ static constexpr size_t kMaxBuffers{3};
 class VeloxToArrowBridgeHolder {
  public:
   VeloxToArrowBridgeHolder() {
-    for (size_t i = 0; i < kMaxBuffers; ++i) {
-      buffers_[i] = nullptr;
-    }
+    resizeBuffers(kMaxBuffers);
+  }
+
+  // Sets the number of buffers. Invalidates the result of getArrowBuffers().
+  void resizeBuffers(size_t numBuffers) {
+    buffers_.resize(numBuffers, nullptr);
+    bufferPtrs_.resize(numBuffers);
   }
 
   // Acquires a buffer at index `idx`.
@@ -56,7 +64,7 @@ class VeloxToArrowBridgeHolder {
   }
 
   const void** getArrowBuffers() {
-    return buffers_;
+    return buffers_.data();
   }
 
   // Allocates space for `numChildren` ArrowArray pointers.
@@ -87,11 +95,11 @@ class VeloxToArrowBridgeHolder {
 
  private:
   // Holds the pointers to the arrow buffers.
-  const void* buffers_[kMaxBuffers];
+  std::vector<const void*> buffers_;
 
   // Holds ownership over the Buffers being referenced by the buffers vector
   // above.
-  BufferPtr bufferPtrs_[kMaxBuffers];
+  std::vector<BufferPtr> bufferPtrs_;
 
   // Auxiliary buffers to hold ownership over ArrowArray children structures.
   std::vector<std::unique_ptr<ArrowArray>> childrenPtrs_;
@@ -209,6 +217,7 @@ static void releaseArrowSchema(ArrowSchema* arrowSchema) {
 // Returns the Arrow C data interface format type for a given Velox type.
 const char* exportArrowFormatStr(
     const TypePtr& type,
+    const ArrowOptions& options,
     std::string& formatBuffer) {
   switch (type->kind()) {
     // Scalar types.
@@ -233,12 +242,12 @@ const char* exportArrowFormatStr(
       formatBuffer = fmt::format("d:{},{}", precision, scale);
       return formatBuffer.c_str();
     }
-    // We always map VARCHAR and VARBINARY to the "small" version (lower case
-    // format string), which uses 32 bit offsets.
+    // We map VARCHAR and VARBINARY to the "small" version (lower case format
+    // string), which uses 32 bit offsets, unless they are exported as views.
     case TypeKind::VARCHAR:
-      return "u"; // utf-8 string
+      return options.exportToView ? "vu" : "u"; // utf-8 string
     case TypeKind::VARBINARY:
-      return "z"; // binary
+      return options.exportToView ? "vz" : "z"; // binary
 
     case TypeKind::TIMESTAMP:
       // TODO: need to figure out how we'll map this since in Velox we currently
@@ -412,11 +421,163 @@ void exportStrings(
   VELOX_DCHECK_EQ(bufSize, *rawOffsets);
 }
 
+// Size of an Arrow binary view and of a StringView.
+constexpr size_t kViewSize = 16;
+static_assert(sizeof(StringView) == kViewSize);
+
+// Arrow view of a string that is not inlined. Inlined strings have the same
+// layout in Arrow and in StringView.
+struct ArrowNonInlineView {
+  int32_t size;
+  char prefix[StringView::kPrefixSize];
+  int32_t bufferIndex;
+  int32_t offset;
+};
+static_assert(sizeof(ArrowNonInlineView) == kViewSize);
+
+// Exports strings in the Arrow binary view layout. The string buffers of
+// 'vec' become the data buffers of the view array without copying. Only the
+// views of strings that are not inlined are rewritten to refer to a buffer
+// index and an offset instead of a pointer. If all strings are inlined and
+// all rows are exported, the values of 'vec' are exported as is.
+void exportStringViews(
+    const FlatVector<StringView>& vec,
+    const Selection& rows,
+    ArrowArray& out,
+    memory::MemoryPool* pool,
+    VeloxToArrowBridgeHolder& holder) {
+  const auto* rawValues = vec.rawValues();
+  const auto& stringBuffers = vec.stringBuffers();
+
+  // The indices of 'stringBuffers' in the order of their addresses.
+  std::vector<int32_t> bufferOrder(stringBuffers.size());
+  std::iota(bufferOrder.begin(), bufferOrder.end(), 0);
+  std::sort(bufferOrder.begin(), bufferOrder.end(), [&](auto left, auto right) {
+    return stringBuffers[left]->as<char>() < stringBuffers[right]->as<char>();
+  });
+  // Returns the index of the string buffer 'value' is in or -1.
+  auto findBuffer = [&](const StringView& value) -> int32_t {
+    auto it = std::upper_bound(
+        bufferOrder.begin(),
+        bufferOrder.end(),
+        value.data(),
+        [&](const char* data, int32_t index) {
+          return data < stringBuffers[index]->as<char>();
+        });
+    if (it == bufferOrder.begin()) {
+      return -1;
+    }
+    const auto& buffer = stringBuffers[*(--it)];
+    return value.data() + value.size() <= buffer->as<char>() + buffer->size()
+        ? *it
+        : -1;
+  };
+
+  // Strings that are not in a string buffer, e.g. ones that point to memory
+  // the vector doesn't own, are copied to an extra data buffer.
+  bool allInline = true;
+  size_t extraSize = 0;
+  rows.apply([&](vector_size_t i) {
+    if (vec.isNullAt(i) || rawValues[i].isInline()) {
+      return;
+    }
+    allInline = false;
+    if (findBuffer(rawValues[i]) < 0) {
+      extraSize += rawValues[i].size();
+    }
+  });
+
+  if (allInline) {
+    out.n_buffers = 3;
+    holder.resizeBuffers(out.n_buffers);
+    out.buffers = holder.getArrowBuffers();
+    bool exportValues = !rows.changed();
+    if (exportValues) {
+      // The views of null rows must be valid as well.
+      for (auto i = 0; i < vec.size() && exportValues; ++i) {
+        exportValues = rawValues[i].isInline();
+      }
+    }
+    if (exportValues) {
+      holder.setBuffer(1, vec.values());
+    } else {
+      auto views = AlignedBuffer::allocate<StringView>(out.length, pool);
+      auto* rawViews = views->asMutable<StringView>();
+      vector_size_t j = 0;
+      rows.apply([&](vector_size_t i) {
+        rawViews[j++] = vec.isNullAt(i) ? StringView() : rawValues[i];
+      });
+      holder.setBuffer(1, views);
+    }
+    holder.setBuffer(2, AlignedBuffer::allocate<int64_t>(0, pool));
+    return;
+  }
+
+  BufferPtr extraBuffer;
+  char* rawExtra = nullptr;
+  if (extraSize > 0) {
+    VELOX_CHECK_LE(extraSize, std::numeric_limits<int32_t>::max());
+    extraBuffer = AlignedBuffer::allocate<char>(extraSize, pool);
+    rawExtra = extraBuffer->asMutable<char>();
+  }
+  const int32_t numDataBuffers = stringBuffers.size() + (extraBuffer ? 1 : 0);
+  out.n_buffers = 2 + numDataBuffers + 1;
+  holder.resizeBuffers(out.n_buffers);
+  out.buffers = holder.getArrowBuffers();
+
+  auto views = AlignedBuffer::allocate<StringView>(out.length, pool);
+  auto* rawViews = views->asMutable<StringView>();
+  const int32_t extraIndex = stringBuffers.size();
+  int32_t extraOffset = 0;
+  vector_size_t j = 0;
+  rows.apply([&](vector_size_t i) {
+    auto& view = rawViews[j++];
+    if (vec.isNullAt(i)) {
+      view = StringView();
+      return;
+    }
+    const auto& value = rawValues[i];
+    if (value.isInline()) {
+      view = value;
+      return;
+    }
+    auto* nonInline = reinterpret_cast<ArrowNonInlineView*>(&view);
+    nonInline->size = value.size();
+    memcpy(nonInline->prefix, value.data(), StringView::kPrefixSize);
+    const auto index = findBuffer(value);
+    if (index >= 0) {
+      const auto offset = value.data() - stringBuffers[index]->as<char>();
+      VELOX_CHECK_LE(offset, std::numeric_limits<int32_t>::max());
+      nonInline->bufferIndex = index;
+      nonInline->offset = offset;
+    } else {
+      memcpy(rawExtra + extraOffset, value.data(), value.size());
+      nonInline->bufferIndex = extraIndex;
+      nonInline->offset = extraOffset;
+      extraOffset += value.size();
+    }
+  });
+  holder.setBuffer(1, views);
+
+  auto sizes = AlignedBuffer::allocate<int64_t>(numDataBuffers, pool);
+  auto* rawSizes = sizes->asMutable<int64_t>();
+  for (auto i = 0; i < stringBuffers.size(); ++i) {
+    holder.setBuffer(2 + i, stringBuffers[i]);
+    rawSizes[i] = stringBuffers[i]->size();
+  }
+  if (extraBuffer) {
+    holder.setBuffer(2 + extraIndex, extraBuffer);
+    rawSizes[extraIndex] = extraSize;
+  }
+  holder.setBuffer(2 + numDataBuffers, sizes);
+}
+
 void exportFlat(
     const BaseVector& vec,
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
+    const ArrowOptions& options,
     VeloxToArrowBridgeHolder& holder) {
   out.n_children = 0;
   out.children = nullptr;
@@ -435,8 +596,21 @@ void exportFlat(
       break;
     case TypeKind::VARCHAR:
     case TypeKind::VARBINARY:
-      exportStrings(
-          *vec.asUnchecked<FlatVector<StringView>>(), rows, out, pool, holder);
+      if (options.exportToView) {
+        exportStringViews(
+            *vec.asUnchecked<FlatVector<StringView>>(),
+            rows,
+            out,
+            pool,
+            holder);
+      } else {
+        exportStrings(
+            *vec.asUnchecked<FlatVector<StringView>>(),
+            rows,
+            out,
+            pool,
+            holder);
+      }
       break;
     default:
       VELOX_NYI(
@@ -449,13 +623,15 @@ void exportBase(
     const BaseVector&,
     const Selection&,
     ArrowArray&,
-    memory::MemoryPool*);
+    memory::MemoryPool*,
+    const ArrowOptions&);
 
 void exportRows(
     const RowVector& vec,
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
+    const ArrowOptions& options,
     VeloxToArrowBridgeHolder& holder) {
   out.n_buffers = 1;
   holder.resizeChildren(vec.childrenSize());
@@ -467,7 +643,8 @@ void exportRows(
           *vec.childAt(i)->loadedVector(),
           rows,
           *holder.allocateChild(i),
-          pool);
+          pool,
+          options);
     } catch (const VeloxException&) {
       for (column_index_t j = 0; j < i; ++j) {
         // When exception is thrown, i th child is guaranteed unset.
@@ -528,6 +705,7 @@ void exportArrays(
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
+    const ArrowOptions& options,
     VeloxToArrowBridgeHolder& holder) {
   Selection childRows(vec.elements()->size());
   exportOffsets(vec, rows, out, pool, holder, childRows);
@@ -536,7 +714,8 @@ void exportArrays(
       *vec.elements()->loadedVector(),
       childRows,
       *holder.allocateChild(0),
-      pool);
+      pool,
+      options);
   out.n_children = 1;
   out.children = holder.getChildrenArrays();
 }
@@ -546,6 +725,7 @@ void exportMaps(
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
+    const ArrowOptions& options,
     VeloxToArrowBridgeHolder& holder) {
   RowVector child(
       pool,
@@ -556,7 +736,7 @@ void exportMaps(
   Selection childRows(child.size());
   exportOffsets(vec, rows, out, pool, holder, childRows);
   holder.resizeChildren(1);
-  exportBase(child, childRows, *holder.allocateChild(0), pool);
+  exportBase(child, childRows, *holder.allocateChild(0), pool, options);
   out.n_children = 1;
   out.children = holder.getChildrenArrays();
 }
@@ -566,6 +746,7 @@ void exportDictionary(
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
+    const ArrowOptions& options,
     VeloxToArrowBridgeHolder& holder) {
   out.n_buffers = 2;
   out.n_children = 0;
@@ -578,14 +759,16 @@ void exportDictionary(
   }
   auto& values = *vec.valueVector()->loadedVector();
   out.dictionary = holder.allocateDictionary();
-  exportBase(values, Selection(values.size()), *out.dictionary, pool);
+  exportBase(
+      values, Selection(values.size()), *out.dictionary, pool, options);
 }
 
 void exportBase(
     const BaseVector& vec,
     const Selection& rows,
     ArrowArray& out,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    const ArrowOptions& options) {
   auto holder = std::make_unique<VeloxToArrowBridgeHolder>();
   out.buffers = holder->getArrowBuffers();
   out.length = rows.count();
@@ -594,19 +777,22 @@ void exportBase(
   exportNulls(vec, rows, out, pool, *holder);
   switch (vec.encoding()) {
     case VectorEncoding::Simple::FLAT:
-      exportFlat(vec, rows, out, pool, *holder);
+      exportFlat(vec, rows, out, pool, options, *holder);
       break;
     case VectorEncoding::Simple::ROW:
-      exportRows(*vec.asUnchecked<RowVector>(), rows, out, pool, *holder);
+      exportRows(
+          *vec.asUnchecked<RowVector>(), rows, out, pool, options, *holder);
       break;
     case VectorEncoding::Simple::ARRAY:
-      exportArrays(*vec.asUnchecked<ArrayVector>(), rows, out, pool, *holder);
+      exportArrays(
+          *vec.asUnchecked<ArrayVector>(), rows, out, pool, options, *holder);
       break;
     case VectorEncoding::Simple::MAP:
-      exportMaps(*vec.asUnchecked<MapVector>(), rows, out, pool, *holder);
+      exportMaps(
+          *vec.asUnchecked<MapVector>(), rows, out, pool, options, *holder);
       break;
     case VectorEncoding::Simple::DICTIONARY:
-      exportDictionary(vec, rows, out, pool, *holder);
+      exportDictionary(vec, rows, out, pool, options, *holder);
       break;
     default:
       VELOX_NYI("{} cannot be exported to Arrow yet.", vec.encoding());
@@ -620,11 +806,15 @@ void exportBase(
 void exportToArrow(
     const VectorPtr& vector,
     ArrowArray& arrowArray,
-    memory::MemoryPool* pool) {
-  exportBase(*vector, Selection(vector->size()), arrowArray, pool);
+    memory::MemoryPool* pool,
+    const ArrowOptions& options) {
+  exportBase(*vector, Selection(vector->size()), arrowArray, pool, options);
 }
 
-void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
+void exportToArrow(
+    const VectorPtr& vec,
+    ArrowSchema& arrowSchema,
+    const ArrowOptions& options) {
   auto& type = vec->type();
 
   arrowSchema.name = nullptr;
@@ -644,10 +834,11 @@ void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
     arrowSchema.format = "i";
     bridgeHolder->dictionary = std::make_unique<ArrowSchema>();
     arrowSchema.dictionary = bridgeHolder->dictionary.get();
-    exportToArrow(vec->valueVector(), *arrowSchema.dictionary);
+    exportToArrow(vec->valueVector(), *arrowSchema.dictionary, options);
 
   } else {
-    arrowSchema.format = exportArrowFormatStr(type, bridgeHolder->formatBuffer);
+    arrowSchema.format =
+        exportArrowFormatStr(type, options, bridgeHolder->formatBuffer);
     arrowSchema.dictionary = nullptr;
 
     if (type->kind() == TypeKind::MAP) {
@@ -662,14 +853,14 @@ void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
           0,
           std::vector<VectorPtr>{maps.mapKeys(), maps.mapValues()},
           maps.getNullCount());
-      exportToArrow(rows, *child);
+      exportToArrow(rows, *child, options);
       child->name = "entries";
       setUniqueChild(std::move(child), *bridgeHolder, arrowSchema);
 
     } else if (type->kind() == TypeKind::ARRAY) {
       auto child = std::make_unique<ArrowSchema>();
       auto& arrays = *vec->asUnchecked<ArrayVector>();
-      exportToArrow(arrays.elements(), *child);
+      exportToArrow(arrays.elements(), *child, options);
       // Name is required, and "item" is the default name used in arrow itself.
       child->name = "item";
       setUniqueChild(std::move(child), *bridgeHolder, arrowSchema);
@@ -702,7 +893,7 @@ void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
         try {
           auto& currentSchema = bridgeHolder->childrenOwned[i];
           currentSchema = std::make_unique<ArrowSchema>();
-          exportToArrow(rows.childAt(i), *currentSchema);
+          exportToArrow(rows.childAt(i), *currentSchema, options);
           currentSchema->name = bridgeHolder->rowType->nameOf(i).data();
           arrowSchema.children[i] = currentSchema.get();
         } catch (const VeloxException& e) {
@@ -757,6 +948,16 @@ TypePtr importFromArrow(const ArrowSchema& arrowSchema) {
     case 'Z':
       return VARBINARY();
 
+    // String and binary views.
+    case 'v':
+      if (format[1] == 'u') {
+        return VARCHAR();
+      }
+      if (format[1] == 'z') {
+        return VARBINARY();
+      }
+      break;
+
     case 't': // temporal types.
       // Mapping it to ttn for now.
       if (format[1] == 't' && format[2] == 'n') {
@@ -948,6 +1149,78 @@ VectorPtr createStringFlatVector(
       optionalNullCount(nullCount));
 }
 
+// Creates a vector of strings from an Arrow string or binary view array. The
+// data buffers become the string buffers of the vector. If all strings are
+// inlined, the views are used as the StringViews of the vector as is.
+VectorPtr createStringViewFlatVector(
+    memory::MemoryPool* pool,
+    const TypePtr& type,
+    BufferPtr nulls,
+    const ArrowArray& arrowArray,
+    WrapInBufferViewFunc wrapInBufferView) {
+  VELOX_USER_CHECK_GE(
+      arrowArray.n_buffers,
+      3,
+      "Expecting at least three buffers as input for string views.");
+  const auto length = arrowArray.length;
+  const auto numDataBuffers = arrowArray.n_buffers - 3;
+  const auto* views = static_cast<const StringView*>(arrowArray.buffers[1]);
+  const auto* dataSizes =
+      static_cast<const int64_t*>(arrowArray.buffers[arrowArray.n_buffers - 1]);
+  const auto* rawNulls = nulls ? nulls->as<uint64_t>() : nullptr;
+  auto isNullAt = [&](int64_t i) {
+    return rawNulls && bits::isBitNull(rawNulls, i);
+  };
+
+  std::vector<BufferPtr> stringBuffers;
+  stringBuffers.reserve(numDataBuffers);
+  for (auto i = 0; i < numDataBuffers; ++i) {
+    stringBuffers.push_back(
+        wrapInBufferView(arrowArray.buffers[2 + i], dataSizes[i]));
+  }
+
+  // The views of null rows are used as well, so they must be inlined too.
+  bool allInline = true;
+  for (int64_t i = 0; i < length && allInline; ++i) {
+    allInline = views[i].isInline();
+  }
+  BufferPtr stringViews;
+  if (allInline) {
+    stringViews = wrapInBufferView(views, length * sizeof(StringView));
+  } else {
+    stringViews = AlignedBuffer::allocate<StringView>(length, pool);
+    auto* rawStringViews = stringViews->asMutable<StringView>();
+    for (int64_t i = 0; i < length; ++i) {
+      if (isNullAt(i)) {
+        rawStringViews[i] = StringView();
+      } else if (views[i].isInline()) {
+        rawStringViews[i] = views[i];
+      } else {
+        const auto* view =
+            reinterpret_cast<const ArrowNonInlineView*>(&views[i]);
+        VELOX_USER_CHECK_LT(view->bufferIndex, numDataBuffers);
+        VELOX_USER_CHECK_LE(
+            view->offset + static_cast<int64_t>(view->size),
+            dataSizes[view->bufferIndex]);
+        const auto* data =
+            static_cast<const char*>(arrowArray.buffers[2 + view->bufferIndex]);
+        rawStringViews[i] = StringView(data + view->offset, view->size);
+      }
+    }
+  }
+
+  return std::make_shared<FlatVector<StringView>>(
+      pool,
+      type,
+      nulls,
+      length,
+      std::move(stringViews),
+      std::move(stringBuffers),
+      SimpleVectorStats<StringView>{},
+      std::nullopt,
+      optionalNullCount(arrowArray.null_count));
+}
+
 VectorPtr importFromArrowImpl(
     ArrowSchema& arrowSchema,
     ArrowArray& arrowArray,
@@ -1121,6 +1394,11 @@ VectorPtr importFromArrowImpl(
   }
 
   // String data types (VARCHAR and VARBINARY).
+  if ((type->isVarchar() || type->isVarbinary()) &&
+      arrowSchema.format[0] == 'v') {
+    return createStringViewFlatVector(
+        pool, type, nulls, arrowArray, wrapInBufferView);
+  }
   if (type->isVarchar() || type->isVarbinary()) {
     VELOX_USER_CHECK_EQ(
         arrowArray.n_buffers,
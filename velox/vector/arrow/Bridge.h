@@ -27,6 +27,16 @@ struct ArrowSchema;
 
 namespace facebook::velox {
 
+/// Options for exporting Velox vectors to Arrow.
+struct ArrowOptions {
+  /// Exports VARCHAR and VARBINARY as Arrow string and binary views ("vu" and
+  /// "vz"), which use the same 16 byte layout as StringView for strings of up
+  /// to 12 bytes. The string buffers are then exported without copying
+  /// instead of being compacted into an offsets and a values buffer. The
+  /// options for an array and its schema must be the same.
+  bool exportToView{false};
+};
+
 /// Export a generic Velox Vector to an ArrowArray, as defined by Arrow's C data
 /// interface:
 ///
@@ -57,7 +67,8 @@ namespace facebook::velox {
 void exportToArrow(
     const VectorPtr& vector,
     ArrowArray& arrowArray,
-    memory::MemoryPool* pool);
+    memory::MemoryPool* pool,
+    const ArrowOptions& options = ArrowOptions{});
 
 /// Export the type of a Velox vector to an ArrowSchema.
 ///
@@ -78,7 +89,10 @@ void exportToArrow(
 ///
 /// NOTE: Since Arrow couples type and encoding, we need both Velox type and
 /// actual data (containing encoding) to create an ArrowSchema.
-void exportToArrow(const VectorPtr&, ArrowSchema&);
+void exportToArrow(
+    const VectorPtr&,
+    ArrowSchema&,
+    const ArrowOptions& options = ArrowOptions{});
 
 /// Import an ArrowSchema into a Velox Type object.
 ///
@@ -107,7 +121,9 @@ TypePtr importFromArrow(const ArrowSchema& arrowSchema);
 /// carry a pointer to it, but not really used in most cases - unless the
 /// conversion itself requires a new allocation. In most cases no new
 /// allocations are required, unless for arrays of varchars (or varbinaries) and
-/// complex types written out of order.
+/// complex types written out of order. Arrow string and binary views are
+/// imported without copying the strings. Only the views of strings longer
+/// than 12 bytes are rewritten as StringViews.
 ///
 /// The new Velox vector returned contains only references to the underlying
 /// buffers, so it's the client's responsibility to ensure the buffer's
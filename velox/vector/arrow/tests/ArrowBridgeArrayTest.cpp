@@ -336,6 +336,72 @@ TEST_F(ArrowBridgeArrayExportTest, flatString) {
   testFlatVector<std::string>({});
 }
 
+TEST_F(ArrowBridgeArrayExportTest, flatStringView) {
+  ArrowOptions options;
+  options.exportToView = true;
+  auto roundTrip = [&](const VectorPtr& vector) {
+    ArrowSchema arrowSchema;
+    ArrowArray arrowArray;
+    exportToArrow(vector, arrowSchema, options);
+    exportToArrow(vector, arrowArray, pool_.get(), options);
+    if (vector->encoding() == VectorEncoding::Simple::FLAT) {
+      EXPECT_STREQ("vu", arrowSchema.format);
+    }
+
+    auto imported =
+        importFromArrowAsViewer(arrowSchema, arrowArray, pool_.get());
+    EXPECT_EQ(vector->size(), imported->size());
+    for (auto i = 0; i < vector->size(); ++i) {
+      EXPECT_TRUE(vector->equalValueAt(imported.get(), i, i));
+    }
+    imported.reset();
+    arrowArray.release(&arrowArray);
+    arrowSchema.release(&arrowSchema);
+  };
+
+  auto strings = vectorMaker_.flatVectorNullable<std::string>({
+      "short",
+      "a string that is too long to be inlined",
+      std::nullopt,
+      "",
+      "another string that is too long to be inlined",
+  });
+  ArrowArray arrowArray;
+  exportToArrow(strings, arrowArray, pool_.get(), options);
+  // The string buffer is exported as is after the nulls and the views, and
+  // followed by the buffer sizes.
+  const auto& stringBuffers =
+      strings->asFlatVector<StringView>()->stringBuffers();
+  ASSERT_EQ(1, stringBuffers.size());
+  EXPECT_EQ(4, arrowArray.n_buffers);
+  EXPECT_EQ(stringBuffers[0]->as<void>(), arrowArray.buffers[2]);
+  EXPECT_EQ(
+      stringBuffers[0]->size(),
+      static_cast<const int64_t*>(arrowArray.buffers[3])[0]);
+  arrowArray.release(&arrowArray);
+  roundTrip(strings);
+
+  // The views of inlined strings are exported as is.
+  auto inlined = vectorMaker_.flatVector<std::string>({"a", "bb", "ccc"});
+  exportToArrow(inlined, arrowArray, pool_.get(), options);
+  EXPECT_EQ(3, arrowArray.n_buffers);
+  EXPECT_EQ(inlined->values()->as<void>(), arrowArray.buffers[1]);
+  arrowArray.release(&arrowArray);
+  roundTrip(inlined);
+
+  // Strings that are not in a string buffer of the vector are copied.
+  std::string external = "a string that is not in a string buffer";
+  auto externalStrings = std::dynamic_pointer_cast<FlatVector<StringView>>(
+      BaseVector::create(VARCHAR(), 2, pool_.get()));
+  externalStrings->setNoCopy(0, StringView(external));
+  externalStrings->setNoCopy(1, StringView("inlined"));
+  roundTrip(externalStrings);
+
+  // Dictionaries of string views.
+  roundTrip(BaseVector::wrapInDictionary(
+      nullptr, makeBuffer<vector_size_t>({1, 1, 0, 4}), 4, strings));
+}
+
 TEST_F(ArrowBridgeArrayExportTest, rowVector) {
   std::vector<std::optional<int64_t>> col1 = {1, 2, 3, 4};
   std::vector<std::optional<double>> col2 = {99.9, 88.8, 77.7, std::nullopt};
@@ -17,6 +17,7 @@
 #include <gtest/gtest.h>
 
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/vector/DecodedVector.h"
 #include "velox/vector/SimpleVector.h"
 #include "velox/vector/tests/utils/VectorMaker.h"
 
@@ -97,6 +98,58 @@ class BiasVectorOverflowTest : public BiasVectorTestBase {
   }
 };
 
+class EncodeBiasTest : public BiasVectorTestBase {};
+
+TEST_F(EncodeBiasTest, narrowRange) {
+  auto flat = vectorMaker_.flatVector<int64_t>(
+      1'000,
+      [](auto row) { return 1'000'000'000'000 + row * 3; },
+      [](auto row) { return row % 7 == 0; });
+  auto biased = encodeBias(*flat);
+  ASSERT_NE(biased, nullptr);
+  ASSERT_EQ(biased->valueType(), TypeKind::SMALLINT);
+  ASSERT_EQ(biased->size(), flat->size());
+  SelectivityVector rows(flat->size());
+  DecodedVector decoded(*biased, rows);
+  for (auto i = 0; i < flat->size(); ++i) {
+    ASSERT_EQ(biased->isNullAt(i), flat->isNullAt(i));
+    ASSERT_TRUE(biased->equalValueAt(flat.get(), i, i));
+    if (!flat->isNullAt(i)) {
+      ASSERT_EQ(decoded.valueAt<int64_t>(i), flat->valueAt(i));
+    }
+  }
+
+  auto slice = biased->slice(100, 50);
+  ASSERT_EQ(slice->encoding(), VectorEncoding::Simple::BIASED);
+  for (auto i = 0; i < slice->size(); ++i) {
+    ASSERT_TRUE(slice->equalValueAt(flat.get(), i, 100 + i));
+  }
+
+  auto small = vectorMaker_.flatVector<int32_t>({-5, 250, 7});
+  biased = encodeBias(*small);
+  ASSERT_NE(biased, nullptr);
+  ASSERT_EQ(biased->valueType(), TypeKind::TINYINT);
+  for (auto i = 0; i < small->size(); ++i) {
+    ASSERT_EQ(biased->valueAt(i), small->valueAt(i));
+  }
+}
+
+TEST_F(EncodeBiasTest, notEncodable) {
+  // The range does not fit in 32 bits.
+  ASSERT_EQ(
+      encodeBias(*vectorMaker_.flatVector<int64_t>({0, 1LL << 40})), nullptr);
+  // The range of SMALLINT values does not fit in 8 bits.
+  ASSERT_EQ(
+      encodeBias(*vectorMaker_.flatVector<int16_t>({-200, 200})), nullptr);
+  // All values are null.
+  ASSERT_EQ(
+      encodeBias(*vectorMaker_.flatVectorNullable<int64_t>(
+          {std::nullopt, std::nullopt})),
+      nullptr);
+  // TINYINT does not admit bias.
+  ASSERT_EQ(encodeBias(*vectorMaker_.flatVector<int8_t>({1, 2})), nullptr);
+}
+
 using inputTypes = ::testing::Types<int16_t, int32_t, int64_t>;
 VELOX_TYPED_TEST_SUITE(BiasVectorOverflowTest, inputTypes);
 
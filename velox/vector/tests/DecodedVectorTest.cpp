@@ -581,6 +581,54 @@ TEST_F(DecodedVectorTest, dictionary) {
       1000, [](vector_size_t i) { return std::make_shared<int>(i % 5); });
 }
 
+TEST_F(DecodedVectorTest, runs) {
+  auto base = makeNullableFlatVector<int64_t>({10, 20, std::nullopt});
+  auto dictionary = wrapInDictionary(
+      makeIndices({0, 0, 0, 1, 1, 2, 2, 2, 2, 0}), 10, base);
+  SelectivityVector rows(10);
+  DecodedVector decoded(*dictionary, rows);
+  auto toTuples = [](const std::vector<DecodedVector::Run>& runs) {
+    std::vector<std::tuple<vector_size_t, vector_size_t, vector_size_t>>
+        tuples;
+    for (const auto& run : runs) {
+      tuples.emplace_back(run.begin, run.size, run.baseIndex);
+    }
+    return tuples;
+  };
+  using Tuples =
+      std::vector<std::tuple<vector_size_t, vector_size_t, vector_size_t>>;
+  EXPECT_EQ(
+      toTuples(decoded.runs(rows)),
+      (Tuples{{0, 3, 0}, {3, 2, 1}, {5, 4, 2}, {9, 1, 0}}));
+
+  // Unselected rows break runs.
+  rows.setValid(1, false);
+  rows.setValid(6, false);
+  rows.updateBounds();
+  EXPECT_EQ(
+      toTuples(decoded.runs(rows)),
+      (Tuples{
+          {0, 1, 0}, {2, 1, 0}, {3, 2, 1}, {5, 1, 2}, {7, 2, 2}, {9, 1, 0}}));
+
+  // Nulls added by the dictionary break runs.
+  auto nulls = makeNulls(10, [](auto row) { return row == 1; });
+  dictionary = BaseVector::wrapInDictionary(
+      nulls, makeIndices({0, 0, 0, 1, 1, 2, 2, 2, 2, 0}), 10, base);
+  rows.setAll();
+  decoded.decode(*dictionary, rows);
+  EXPECT_EQ(
+      toTuples(decoded.runs(rows)),
+      (Tuples{
+          {0, 1, 0}, {1, 1, 0}, {2, 1, 0}, {3, 2, 1}, {5, 4, 2}, {9, 1, 0}}));
+
+  // A sequence decodes into one run per sequence.
+  auto lengths = makeIndices({4, 6});
+  auto sequence = BaseVector::wrapInSequence(
+      lengths, 10, makeFlatVector<int64_t>({1, 2}));
+  decoded.decode(*sequence, rows);
+  EXPECT_EQ(toTuples(decoded.runs(rows)), (Tuples{{0, 4, 0}, {4, 6, 1}}));
+}
+
 TEST_F(DecodedVectorTest, dictionaryOverLazy) {
   constexpr vector_size_t size = 1000;
   auto lazyVector = vectorMaker_.lazyFlatVector<int32_t>(
@@ -99,6 +99,64 @@ TEST_F(VectorPoolTest, limit) {
   ASSERT_EQ(vectorPool.release(vectors), 10);
 }
 
+TEST_F(VectorPoolTest, adaptiveLimit) {
+  VectorPool vectorPool(pool());
+
+  // More vectors in use than the pool keeps make the pool grow.
+  std::vector<VectorPtr> vectors(20);
+  for (auto i = 0; i < 20; ++i) {
+    vectors[i] = vectorPool.get(BIGINT(), 1'000);
+  }
+  ASSERT_EQ(vectorPool.release(vectors), 10);
+  for (auto i = 0; i < 20; ++i) {
+    vectors[i] = vectorPool.get(BIGINT(), 1'000);
+  }
+  ASSERT_EQ(vectorPool.release(vectors), 20);
+}
+
+TEST_F(VectorPoolTest, complexTypes) {
+  VectorPool vectorPool(pool());
+
+  const auto arrayType = ARRAY(BIGINT());
+  auto vector = vectorPool.get(arrayType, 1'000);
+  ASSERT_EQ(1'000, vector->size());
+  vector->as<ArrayVector>()->elements()->resize(1'000);
+  auto* rawVector = vector.get();
+  ASSERT_TRUE(vectorPool.release(vector));
+
+  // An equal type that is a different object gets the recycled vector.
+  vector = vectorPool.get(ARRAY(BIGINT()), 100);
+  ASSERT_EQ(rawVector, vector.get());
+  ASSERT_EQ(100, vector->size());
+  auto* arrayVector = vector->as<ArrayVector>();
+  ASSERT_EQ(0, arrayVector->elements()->size());
+  for (auto i = 0; i < 100; ++i) {
+    ASSERT_EQ(0, arrayVector->sizeAt(i));
+    ASSERT_FALSE(arrayVector->isNullAt(i));
+  }
+
+  const auto rowType = ROW({"a", "b"}, {BIGINT(), MAP(INTEGER(), VARCHAR())});
+  auto row = vectorPool.get(rowType, 1'000);
+  auto* rawRow = row.get();
+  ASSERT_TRUE(vectorPool.release(row));
+  row = vectorPool.get(rowType, 500);
+  ASSERT_EQ(rawRow, row.get());
+  ASSERT_EQ(500, row->size());
+  for (const auto& child : row->as<RowVector>()->children()) {
+    ASSERT_EQ(500, child->size());
+  }
+
+  // A row type with different names does not get the recycled vector.
+  ASSERT_TRUE(vectorPool.release(row));
+  auto otherRow = vectorPool.get(
+      ROW({"x", "y"}, {BIGINT(), MAP(INTEGER(), VARCHAR())}), 500);
+  ASSERT_NE(rawRow, otherRow.get());
+
+  // A vector with a shared child is not recyclable.
+  auto child = otherRow->as<RowVector>()->childAt(0);
+  ASSERT_FALSE(vectorPool.release(otherRow));
+}
+
 TEST_F(VectorPoolTest, vectorRecycler) {
   VectorPool vectorPool(pool());
 
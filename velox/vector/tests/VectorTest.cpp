@@ -496,6 +496,18 @@ class VectorTest : public testing::Test, public test::VectorTestBase {
       EXPECT_TRUE(source->equalValueAt(target.get(), i, sourceSize + i));
     }
 
+    // Gather source in reverse order into the first half of target and in
+    // order into the second half.
+    std::vector<vector_size_t> sourceIndices(2 * sourceSize);
+    for (int32_t i = 0; i < sourceSize; ++i) {
+      sourceIndices[i] = sourceSize - 1 - i;
+      sourceIndices[sourceSize + i] = i;
+    }
+    target->gather(source.get(), 0, sourceIndices.data(), 2 * sourceSize);
+    for (int32_t i = 0; i < 2 * sourceSize; ++i) {
+      EXPECT_TRUE(target->equalValueAt(source.get(), i, sourceIndices[i]));
+    }
+
     // Check that uninitialized is copyable.
     target->resize(target->size() + 100);
     target->copy(target.get(), target->size() - 50, target->size() - 100, 50);